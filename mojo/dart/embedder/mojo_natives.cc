@@ -33,7 +33,9 @@ namespace dart {
   V(MojoDataPipe_EndReadData, 2)           \
   V(MojoMessagePipe_Create, 1)             \
   V(MojoMessagePipe_Write, 5)              \
+  V(MojoMessagePipe_WriteBatch, 5)         \
   V(MojoMessagePipe_Read, 5)               \
+  V(MojoMessagePipe_QueryAndRead, 2)       \
   V(Mojo_GetTimeTicksNow, 0)               \
   V(MojoHandle_Close, 1)                   \
   V(MojoHandle_Wait, 3)                    \
@@ -647,6 +649,113 @@ void MojoMessagePipe_Write(Dart_NativeArguments arguments) {
   Dart_SetIntegerReturnValue(arguments, static_cast<int64_t>(res));
 }
 
+static bool DartListToMojoHandles(Dart_Handle list,
+                                  std::vector<MojoHandle>* handles) {
+  handles->clear();
+  if (Dart_IsNull(list))
+    return true;
+  intptr_t length = 0;
+  if (Dart_IsError(Dart_ListLength(list, &length)))
+    return false;
+  handles->reserve(length);
+  for (intptr_t i = 0; i < length; i++) {
+    int64_t mojo_handle = 0;
+    if (Dart_IsError(Dart_IntegerToInt64(Dart_ListGetAt(list, i),
+                                         &mojo_handle))) {
+      return false;
+    }
+    handles->push_back(static_cast<MojoHandle>(mojo_handle));
+  }
+  return true;
+}
+
+// Writes a list of messages to the same pipe in one native call, which is
+// most of the cost of sending many small messages. Message i is made of the
+// first numBytes[i] bytes of data[i] and the handles in handles[i]; |handles|
+// itself may be null when none of the messages carry handles. Writing stops
+// at the first message that fails.
+//
+// The return value is structured as a list of length 2:
+// [0] MojoResult of the last write
+// [1] the number of messages written
+void MojoMessagePipe_WriteBatch(Dart_NativeArguments arguments) {
+  int64_t handle = 0;
+  CHECK_INTEGER_ARGUMENT(arguments, 0, &handle, Null);
+
+  Dart_Handle data_list = Dart_GetNativeArgument(arguments, 1);
+  Dart_Handle num_bytes_list = Dart_GetNativeArgument(arguments, 2);
+  Dart_Handle handles_list = Dart_GetNativeArgument(arguments, 3);
+  intptr_t count = 0;
+  intptr_t num_bytes_count = 0;
+  intptr_t handles_count = 0;
+  if (!Dart_IsList(data_list) || !Dart_IsList(num_bytes_list) ||
+      (!Dart_IsList(handles_list) && !Dart_IsNull(handles_list))) {
+    SetNullReturn(arguments);
+    return;
+  }
+  Dart_ListLength(data_list, &count);
+  Dart_ListLength(num_bytes_list, &num_bytes_count);
+  if (!Dart_IsNull(handles_list))
+    Dart_ListLength(handles_list, &handles_count);
+  if (num_bytes_count != count ||
+      (!Dart_IsNull(handles_list) && handles_count != count)) {
+    SetNullReturn(arguments);
+    return;
+  }
+
+  int64_t flags = 0;
+  CHECK_INTEGER_ARGUMENT(arguments, 4, &flags, Null);
+
+  MojoResult res = MOJO_RESULT_OK;
+  intptr_t written = 0;
+  std::vector<MojoHandle> mojo_handles;
+  for (; written < count; written++) {
+    Dart_Handle typed_data = Dart_ListGetAt(data_list, written);
+    int64_t num_bytes = 0;
+    bool valid = !Dart_IsError(Dart_IntegerToInt64(
+        Dart_ListGetAt(num_bytes_list, written), &num_bytes));
+    if (Dart_IsTypedData(typed_data))
+      valid = valid && num_bytes > 0;
+    else
+      valid = valid && Dart_IsNull(typed_data) && num_bytes == 0;
+    if (valid && !Dart_IsNull(handles_list)) {
+      valid = DartListToMojoHandles(Dart_ListGetAt(handles_list, written),
+                                    &mojo_handles);
+    } else {
+      mojo_handles.clear();
+    }
+    if (!valid) {
+      res = MOJO_RESULT_INVALID_ARGUMENT;
+      break;
+    }
+
+    Dart_TypedData_Type type;
+    void* bytes = nullptr;
+    intptr_t byte_data_len = 0;
+    if (!Dart_IsNull(typed_data))
+      Dart_TypedDataAcquireData(typed_data, &type, &bytes, &byte_data_len);
+    if (num_bytes > byte_data_len) {
+      res = MOJO_RESULT_INVALID_ARGUMENT;
+    } else {
+      res = MojoWriteMessage(
+          static_cast<MojoHandle>(handle), bytes,
+          static_cast<uint32_t>(num_bytes),
+          mojo_handles.empty() ? nullptr : mojo_handles.data(),
+          static_cast<uint32_t>(mojo_handles.size()),
+          static_cast<MojoWriteMessageFlags>(flags));
+    }
+    if (bytes)
+      Dart_TypedDataReleaseData(typed_data);
+    if (res != MOJO_RESULT_OK)
+      break;
+  }
+
+  Dart_Handle list = Dart_NewList(2);
+  Dart_ListSetAt(list, 0, Dart_NewInteger(res));
+  Dart_ListSetAt(list, 1, Dart_NewInteger(written));
+  Dart_SetReturnValue(arguments, list);
+}
+
 void MojoMessagePipe_Read(Dart_NativeArguments arguments) {
   int64_t handle = 0;
   CHECK_INTEGER_ARGUMENT(arguments, 0, &handle, Null);
@@ -720,6 +829,62 @@ void MojoMessagePipe_Read(Dart_NativeArguments arguments) {
   Dart_SetReturnValue(arguments, list);
 }
 
+// Reads the next message in a single call. The size of the message is
+// queried first and its bytes are read straight into a ByteData of that
+// size, so the caller needs neither a separate size probe nor a buffer of
+// its own to copy from.
+//
+// The return value is structured as a list of length 3:
+// [0] MojoResult
+// [1] ByteData with the bytes of the message (null if there are none)
+// [2] List of the handles in the message (null if there are none)
+void MojoMessagePipe_QueryAndRead(Dart_NativeArguments arguments) {
+  int64_t handle = 0;
+  int64_t flags = 0;
+  CHECK_INTEGER_ARGUMENT(arguments, 0, &handle, Null);
+  CHECK_INTEGER_ARGUMENT(arguments, 1, &flags, Null);
+
+  // The query never discards the message. It does read a message that has
+  // neither bytes nor handles, in which case there is nothing left to do.
+  uint32_t num_bytes = 0;
+  uint32_t num_handles = 0;
+  MojoResult res = MojoReadMessage(static_cast<MojoHandle>(handle), nullptr,
+                                   &num_bytes, nullptr, &num_handles,
+                                   MOJO_READ_MESSAGE_FLAG_NONE);
+
+  Dart_Handle typed_data = Dart_Null();
+  std::vector<MojoHandle> mojo_handles(num_handles);
+  if (res == MOJO_RESULT_RESOURCE_EXHAUSTED) {
+    void* bytes = nullptr;
+    if (num_bytes) {
+      typed_data = Dart_NewTypedData(Dart_TypedData_kByteData, num_bytes);
+      Dart_TypedData_Type type;
+      intptr_t length = 0;
+      Dart_TypedDataAcquireData(typed_data, &type, &bytes, &length);
+    }
+
+    res = MojoReadMessage(static_cast<MojoHandle>(handle), bytes, &num_bytes,
+                          mojo_handles.data(), &num_handles,
+                          static_cast<MojoReadMessageFlags>(flags));
+
+    if (bytes)
+      Dart_TypedDataReleaseData(typed_data);
+  }
+
+  Dart_Handle list = Dart_NewList(3);
+  Dart_ListSetAt(list, 0, Dart_NewInteger(res));
+  if (res == MOJO_RESULT_OK) {
+    Dart_ListSetAt(list, 1, typed_data);
+    if (num_handles) {
+      Dart_Handle handles = Dart_NewList(num_handles);
+      for (uint32_t i = 0; i < num_handles; i++)
+        Dart_ListSetAt(handles, i, Dart_NewInteger(mojo_handles[i]));
+      Dart_ListSetAt(list, 2, handles);
+    }
+  }
+  Dart_SetReturnValue(arguments, list);
+}
+
 struct ControlData {
   int64_t handle;
   Dart_Port port;
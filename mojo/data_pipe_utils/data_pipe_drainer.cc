@@ -19,20 +19,27 @@ DataPipeDrainer::DataPipeDrainer(Client* client,
 DataPipeDrainer::~DataPipeDrainer() {}
 
 void DataPipeDrainer::ReadData() {
-  const void* buffer = nullptr;
-  uint32_t num_bytes = 0;
-  MojoResult rv = BeginReadDataRaw(source_.get(), &buffer, &num_bytes,
-                                   MOJO_READ_DATA_FLAG_NONE);
-  if (rv == MOJO_RESULT_OK) {
-    client_->OnDataAvailable(buffer, num_bytes);
-    EndReadDataRaw(source_.get(), num_bytes);
-    WaitForData();
-  } else if (rv == MOJO_RESULT_SHOULD_WAIT) {
-    WaitForData();
-  } else if (rv == MOJO_RESULT_FAILED_PRECONDITION) {
-    client_->OnDataComplete();
-  } else {
-    DCHECK(false) << "Unhandled MojoResult: " << rv;
+  // Hand out everything that's already in the pipe before going back to the
+  // watcher: a two-phase read only returns the contiguous part of the pipe's
+  // buffer, so a full pipe usually takes two reads to drain.
+  for (;;) {
+    const void* buffer = nullptr;
+    uint32_t num_bytes = 0;
+    MojoResult rv = BeginReadDataRaw(source_.get(), &buffer, &num_bytes,
+                                     MOJO_READ_DATA_FLAG_NONE);
+    if (rv == MOJO_RESULT_OK) {
+      client_->OnDataAvailable(buffer, num_bytes);
+      EndReadDataRaw(source_.get(), num_bytes);
+    } else if (rv == MOJO_RESULT_SHOULD_WAIT) {
+      WaitForData();
+      return;
+    } else if (rv == MOJO_RESULT_FAILED_PRECONDITION) {
+      client_->OnDataComplete();
+      return;
+    } else {
+      DCHECK(false) << "Unhandled MojoResult: " << rv;
+      return;
+    }
   }
 }
 
@@ -16,6 +16,10 @@ class DataPipeDrainer {
  public:
   class Client {
    public:
+    // |data| points into the pipe's own buffer (the drainer uses two-phase
+    // reads) and is only valid for the duration of the call, so clients
+    // should consume or copy it before returning. The client must not
+    // destroy the drainer from this call.
     virtual void OnDataAvailable(const void* data, size_t num_bytes) = 0;
     virtual void OnDataComplete() = 0;
 
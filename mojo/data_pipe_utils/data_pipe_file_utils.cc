@@ -8,6 +8,12 @@
 
 #include <limits>
 
+#include "build/build_config.h"
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <fcntl.h>
+#endif
+
 #include "base/files/file.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
@@ -35,6 +41,7 @@ class CopyToFileHandler {
   void OpenFile();
   void OnHandleReady(MojoResult result);
   void WriteToFile();
+  bool WriteChunk();
 
   ScopedDataPipeConsumerHandle source_;
   const base::FilePath destination_;
@@ -128,8 +135,27 @@ void CopyToFileHandler::OnHandleReady(MojoResult result) {
   SendCallback(false);
 }
 
+// Data pipes can be read on any thread, so the data that is already in the
+// pipe is written out without going back to the main thread in between. Only
+// waiting for more data has to happen there.
 void CopyToFileHandler::WriteToFile() {
   DCHECK(file_task_runner_->RunsTasksOnCurrentThread());
+  while (WriteChunk()) {
+    MojoResult result = BeginReadDataRaw(source_.get(), &buffer_,
+                                         &buffer_size_,
+                                         MOJO_READ_DATA_FLAG_NONE);
+    if (result != MOJO_RESULT_OK) {
+      main_runner_->PostTask(FROM_HERE,
+                             base::Bind(&CopyToFileHandler::OnHandleReady,
+                                        base::Unretained(this), result));
+      return;
+    }
+  }
+}
+
+// Writes the chunk the pipe handed out and returns whether to go on. Posts
+// the callback to the main thread if not.
+bool CopyToFileHandler::WriteChunk() {
   uint32_t num_bytes = buffer_size_;
   size_t num_bytes_written =
       file_.WriteAtCurrentPos(static_cast<const char*>(buffer_), num_bytes);
@@ -143,17 +169,16 @@ void CopyToFileHandler::WriteToFile() {
     main_runner_->PostTask(FROM_HERE,
                            base::Bind(&CopyToFileHandler::SendCallback,
                                       base::Unretained(this), false));
-    return;
+    return false;
   }
   if (result != MOJO_RESULT_OK) {
     LOG(ERROR) << "EndReadDataRaw error (" << result << ")";
     main_runner_->PostTask(FROM_HERE,
                            base::Bind(&CopyToFileHandler::SendCallback,
                                       base::Unretained(this), false));
+    return false;
   }
-  main_runner_->PostTask(FROM_HERE,
-                         base::Bind(&CopyToFileHandler::OnHandleReady,
-                                    base::Unretained(this), result));
+  return true;
 }
 
 class CopyFromFileHandler {
@@ -171,6 +196,7 @@ class CopyFromFileHandler {
   void OpenFile();
   void OnHandleReady(MojoResult result);
   void ReadFromFile();
+  bool ReadChunk();
 
   const base::FilePath source_;
   ScopedDataPipeProducerHandle destination_;
@@ -244,6 +270,10 @@ void CopyFromFileHandler::OpenFile() {
                                       base::Unretained(this), false));
     return;
   }
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+  // Assets and snapshots are read once from front to back.
+  posix_fadvise(file_.GetPlatformFile(), skip_, 0, POSIX_FADV_SEQUENTIAL);
+#endif
   main_runner_->PostTask(FROM_HERE,
                          base::Bind(&CopyFromFileHandler::OnHandleReady,
                                     base::Unretained(this), MOJO_RESULT_OK));
@@ -272,8 +302,26 @@ void CopyFromFileHandler::OnHandleReady(MojoResult result) {
   SendCallback(false);
 }
 
+// The file is read straight into the pipe's buffer, for as long as the pipe
+// has room, before going back to the main thread to wait for more.
 void CopyFromFileHandler::ReadFromFile() {
   DCHECK(file_task_runner_->RunsTasksOnCurrentThread());
+  while (ReadChunk()) {
+    MojoResult result = BeginWriteDataRaw(destination_.get(), &buffer_,
+                                          &buffer_size_,
+                                          MOJO_WRITE_DATA_FLAG_NONE);
+    if (result != MOJO_RESULT_OK) {
+      main_runner_->PostTask(FROM_HERE,
+                             base::Bind(&CopyFromFileHandler::OnHandleReady,
+                                        base::Unretained(this), result));
+      return;
+    }
+  }
+}
+
+// Fills the buffer the pipe handed out and returns whether to go on. Posts
+// the callback to the main thread if not.
+bool CopyFromFileHandler::ReadChunk() {
   DCHECK_LT(buffer_size_,
             static_cast<uint32_t>(std::numeric_limits<int>::max()));
   int num_bytes = buffer_size_;
@@ -288,25 +336,23 @@ void CopyFromFileHandler::ReadFromFile() {
     main_runner_->PostTask(FROM_HERE,
                            base::Bind(&CopyFromFileHandler::SendCallback,
                                       base::Unretained(this), false));
-    return;
+    return false;
   }
   if (result != MOJO_RESULT_OK) {
     LOG(ERROR) << "EndWriteDataRaw error (" << result << ")";
     main_runner_->PostTask(FROM_HERE,
                            base::Bind(&CopyFromFileHandler::SendCallback,
                                       base::Unretained(this), false));
-    return;
+    return false;
   }
   if (num_bytes_read != num_bytes) {
     // Reached EOF. Stop the process.
     main_runner_->PostTask(FROM_HERE,
                            base::Bind(&CopyFromFileHandler::SendCallback,
                                       base::Unretained(this), true));
-    return;
+    return false;
   }
-  main_runner_->PostTask(FROM_HERE,
-                         base::Bind(&CopyFromFileHandler::OnHandleReady,
-                                    base::Unretained(this), result));
+  return true;
 }
 
 size_t CopyToFileHelper(FILE* fp, const void* buffer, uint32_t num_bytes) {
@@ -8,6 +8,7 @@
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/threading/sequenced_worker_pool.h"
 #include "base/time/time.h"
@@ -59,6 +60,49 @@ TEST(DataPipeUtilsTest, AsyncFileTransfer) {
   blocking_pool->Shutdown();
 }
 
+// A file many times the pipe's capacity is copied in chunks, waiting for the
+// pipe to drain in between.
+TEST(DataPipeUtilsTest, AsyncLargeFileTransfer) {
+  std::string data;
+  for (int i = 0; data.size() < 256 * 1024; ++i)
+    data += base::IntToString(i) + "\n";
+  base::ScopedTempDir temp_dir;
+  ASSERT_TRUE(temp_dir.CreateUniqueTempDir());
+  base::FilePath input;
+  base::FilePath output;
+  ASSERT_TRUE(base::CreateTemporaryFileInDir(temp_dir.path(), &input));
+  ASSERT_TRUE(base::CreateTemporaryFileInDir(temp_dir.path(), &output));
+  ASSERT_EQ(static_cast<int>(data.size()),
+            base::WriteFile(input, data.data(), data.size()));
+  base::MessageLoop loop;
+  scoped_refptr<base::SequencedWorkerPool> blocking_pool =
+      new base::SequencedWorkerPool(2, "blocking_pool");
+
+  bool write_succeded = false;
+  bool read_succeded = false;
+
+  MojoCreateDataPipeOptions options;
+  options.struct_size = sizeof(options);
+  options.flags = MOJO_CREATE_DATA_PIPE_OPTIONS_FLAG_NONE;
+  options.element_num_bytes = 1;
+  options.capacity_num_bytes = 4096;
+  DataPipe pipes(options);
+  CopyFromFile(input, pipes.producer_handle.Pass(), 0, blocking_pool.get(),
+               base::Bind(&TransferBooleanValueAndExecute, base::Closure(),
+                          base::Unretained(&write_succeded)));
+  CopyToFile(pipes.consumer_handle.Pass(), output, blocking_pool.get(),
+             base::Bind(&TransferBooleanValueAndExecute,
+                        base::MessageLoop::QuitClosure(),
+                        base::Unretained(&read_succeded)));
+  loop.Run();
+
+  EXPECT_TRUE(write_succeded);
+  EXPECT_TRUE(read_succeded);
+  EXPECT_TRUE(base::ContentsEqual(input, output));
+
+  blocking_pool->Shutdown();
+}
+
 }  // namespace
 }  // namespace common
 }  // namespace mojo
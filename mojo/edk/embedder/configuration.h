@@ -38,6 +38,12 @@ struct Configuration {
   // message pipes. The default is 10,000.
   size_t max_message_num_handles;
 
+  // Minimum data size of messages sent over channels (to other processes) for
+  // which the data is moved through a shared buffer, instead of being copied
+  // through the channel itself, in bytes. Zero disables this. The default is
+  // 256KB.
+  size_t min_shared_buffer_message_num_bytes;
+
   // Maximum capacity of a data pipe, in bytes. The default is 256MB. This value
   // must fit into a |uint32_t|. WARNING: If you bump it closer to 2^32, you
   // must audit all the code to check that we don't overflow (2^31 would
@@ -60,6 +66,12 @@ struct Configuration {
   // (This will also entail some auditing to make sure I'm not messing up my
   // checks anywhere.)
   size_t max_shared_memory_num_bytes;
+
+  // Longest time a waiter spins (checking whether it has been woken) before
+  // blocking, in microseconds. Waiters spin for less (or not at all) unless
+  // recent waits have ended within about this long. Zero disables spinning.
+  // The default is 50 microseconds.
+  size_t max_waiter_spin_microseconds;
 };
 
 }  // namespace embedder
@@ -118,6 +118,21 @@ MojoResult CreatePlatformHandleWrapper(
   return MOJO_RESULT_OK;
 }
 
+MojoResult SetMessagePipeLatencySensitive(MojoHandle message_pipe_handle,
+                                          bool latency_sensitive) {
+  DCHECK(internal::g_core);
+  scoped_refptr<system::Dispatcher> dispatcher(
+      internal::g_core->GetDispatcher(message_pipe_handle));
+  if (!dispatcher)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  if (dispatcher->GetType() != system::Dispatcher::Type::MESSAGE_PIPE)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  return static_cast<system::MessagePipeDispatcher*>(dispatcher.get())
+      ->SetLatencySensitive(latency_sensitive);
+}
+
 MojoResult PassWrappedPlatformHandle(MojoHandle platform_handle_wrapper_handle,
                                      ScopedPlatformHandle* platform_handle) {
   DCHECK(platform_handle);
@@ -68,6 +68,16 @@ MOJO_SYSTEM_IMPL_EXPORT MojoResult
 PassWrappedPlatformHandle(MojoHandle platform_handle_wrapper_handle,
                           ScopedPlatformHandle* platform_handle);
 
+// Marks messages written to the given message pipe handle as latency sensitive
+// (e.g., input or vsync traffic), so that once the pipe goes through a channel
+// they are written ahead of bulk messages already queued on it. Ordering among
+// the pipe's own messages is preserved. Messages carrying handles are never
+// reordered. The setting applies to this process only (it isn't carried along
+// if the handle is sent to another process).
+MOJO_SYSTEM_IMPL_EXPORT MojoResult
+SetMessagePipeLatencySensitive(MojoHandle message_pipe_handle,
+                               bool latency_sensitive);
+
 // Initialialization/shutdown for interprocess communication (IPC) -------------
 
 // |InitIPCSupport()| sets up the subsystem for interprocess communication,
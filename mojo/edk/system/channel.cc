@@ -196,7 +196,8 @@ scoped_refptr<ChannelEndpoint> Channel::SerializeEndpointWithLocalPeer(
 void Channel::SerializeEndpointWithRemotePeer(
     void* destination,
     MessageInTransitQueue* message_queue,
-    scoped_refptr<ChannelEndpoint> peer_endpoint) {
+    scoped_refptr<ChannelEndpoint> peer_endpoint,
+    scoped_ptr<EndpointRelayer::Filter> filter) {
   DCHECK(destination);
   DCHECK(peer_endpoint);
 
@@ -210,6 +211,8 @@ void Channel::SerializeEndpointWithRemotePeer(
   scoped_refptr<ChannelEndpoint> endpoint(
       new ChannelEndpoint(relayer.get(), 0, message_queue));
   relayer->Init(endpoint.get(), peer_endpoint.get());
+  if (filter)
+    relayer->SetFilter(filter.Pass());
   peer_endpoint->ReplaceClient(relayer.get(), 1);
 
   SerializedEndpoint* s = static_cast<SerializedEndpoint*>(destination);
@@ -14,6 +14,7 @@
 #include "mojo/edk/embedder/scoped_platform_handle.h"
 #include "mojo/edk/system/channel_endpoint.h"
 #include "mojo/edk/system/channel_endpoint_id.h"
+#include "mojo/edk/system/endpoint_relayer.h"
 #include "mojo/edk/system/incoming_endpoint.h"
 #include "mojo/edk/system/message_in_transit.h"
 #include "mojo/edk/system/mutex.h"
@@ -145,7 +146,8 @@ class MOJO_SYSTEM_IMPL_EXPORT Channel final
   //
   // Case 3: The endpoint's peer is remote (i.e., it has a peer
   // |ChannelEndpoint|). (This has two subcases: the peer endpoint may be on
-  // this |Channel| or another |Channel|.)
+  // this |Channel| or another |Channel|.) Messages are then relayed by an
+  // |EndpointRelayer|, with |filter| (which may be null) as its filter.
   void SerializeEndpointWithClosedPeer(void* destination,
                                        MessageInTransitQueue* message_queue);
   // This one returns the |ChannelEndpoint| for the serialized endpoint (which
@@ -158,7 +160,8 @@ class MOJO_SYSTEM_IMPL_EXPORT Channel final
   void SerializeEndpointWithRemotePeer(
       void* destination,
       MessageInTransitQueue* message_queue,
-      scoped_refptr<ChannelEndpoint> peer_endpoint);
+      scoped_refptr<ChannelEndpoint> peer_endpoint,
+      scoped_ptr<EndpointRelayer::Filter> filter);
 
   // Deserializes an endpoint that was sent from the peer |Channel| (using
   // |SerializeEndpoint...()|. |source| should be (a copy of) the data that
@@ -4,14 +4,131 @@
 
 #include "mojo/edk/system/channel_endpoint.h"
 
+#include <string.h>
+
 #include "base/logging.h"
 #include "base/threading/platform_thread.h"
+#include "build/build_config.h"
+#include "mojo/edk/embedder/platform_shared_buffer.h"
 #include "mojo/edk/system/channel.h"
 #include "mojo/edk/system/channel_endpoint_client.h"
+#include "mojo/edk/system/configuration.h"
+#include "mojo/edk/system/shared_buffer_dispatcher.h"
 #include "mojo/public/cpp/system/macros.h"
 
 namespace mojo {
 namespace system {
+namespace {
+
+// Payload of |MessageInTransit::Subtype::ENDPOINT_CLIENT_SHARED_BUFFER_DATA|
+// messages.
+struct SharedBufferMessageData {
+  uint32_t num_bytes;
+  uint32_t unused;
+};
+
+bool ShouldMoveDataToSharedBuffer(MessageInTransit* message) {
+#if defined(OS_POSIX)
+  size_t min_num_bytes = GetConfiguration().min_shared_buffer_message_num_bytes;
+  if (!min_num_bytes || message->num_bytes() < min_num_bytes)
+    return false;
+  if (message->type() != MessageInTransit::Type::ENDPOINT_CLIENT ||
+      message->subtype() != MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA)
+    return false;
+  // There must be room for one more handle.
+  return !message->dispatchers() ||
+         message->dispatchers()->size() <
+             GetConfiguration().max_message_num_handles;
+#else
+  // Passing shared buffers isn't implemented on Windows yet.
+  return false;
+#endif
+}
+
+// Copies the data of |message| to a new shared buffer, and returns a message
+// that has the shared buffer attached after the dispatchers taken from
+// |message|. This saves copying large amounts of data through the channel
+// (and the kernel) twice. Returns null, leaving |message| alone, on failure.
+scoped_ptr<MessageInTransit> MoveDataToSharedBuffer(
+    embedder::PlatformSupport* platform_support,
+    MessageInTransit* message) {
+  scoped_refptr<SharedBufferDispatcher> shared_buffer;
+  if (SharedBufferDispatcher::Create(
+          platform_support, SharedBufferDispatcher::kDefaultCreateOptions,
+          message->num_bytes(), &shared_buffer) != MOJO_RESULT_OK)
+    return nullptr;
+
+  scoped_ptr<embedder::PlatformSharedBufferMapping> mapping;
+  if (shared_buffer->MapBuffer(0, message->num_bytes(),
+                               MOJO_MAP_BUFFER_FLAG_NONE,
+                               &mapping) != MOJO_RESULT_OK) {
+    shared_buffer->Close();
+    return nullptr;
+  }
+  memcpy(mapping->GetBase(), message->bytes(), message->num_bytes());
+  mapping.reset();
+
+  SharedBufferMessageData data = {message->num_bytes(), 0};
+  scoped_ptr<MessageInTransit> shared_buffer_message(new MessageInTransit(
+      MessageInTransit::Type::ENDPOINT_CLIENT,
+      MessageInTransit::Subtype::ENDPOINT_CLIENT_SHARED_BUFFER_DATA,
+      static_cast<uint32_t>(sizeof(data)), &data));
+
+  scoped_ptr<DispatcherVector> dispatchers(new DispatcherVector());
+  if (message->dispatchers())
+    dispatchers->swap(*message->dispatchers());
+  dispatchers->push_back(shared_buffer);
+  // The message must hold the only reference.
+  shared_buffer = nullptr;
+  shared_buffer_message->SetDispatchers(dispatchers.Pass());
+  return shared_buffer_message.Pass();
+}
+
+// The reverse of |MoveDataToSharedBuffer()|. Returns null if |message| is not
+// a valid shared buffer message (the other side may be buggy or hostile).
+scoped_ptr<MessageInTransit> RestoreDataFromSharedBuffer(
+    MessageInTransit* message) {
+  if (message->num_bytes() != sizeof(SharedBufferMessageData) ||
+      !message->has_dispatchers())
+    return nullptr;
+
+  SharedBufferMessageData data;
+  memcpy(&data, message->bytes(), sizeof(data));
+  if (!data.num_bytes ||
+      data.num_bytes > GetConfiguration().max_message_num_bytes)
+    return nullptr;
+
+  DispatcherVector* dispatchers = message->dispatchers();
+  scoped_refptr<Dispatcher> shared_buffer = dispatchers->back();
+  if (!shared_buffer ||
+      shared_buffer->GetType() != Dispatcher::Type::SHARED_BUFFER)
+    return nullptr;
+
+  // This fails if the shared buffer is too small.
+  scoped_ptr<embedder::PlatformSharedBufferMapping> mapping;
+  if (shared_buffer->MapBuffer(0, data.num_bytes, MOJO_MAP_BUFFER_FLAG_NONE,
+                               &mapping) != MOJO_RESULT_OK)
+    return nullptr;
+
+  scoped_ptr<MessageInTransit> data_message(new MessageInTransit(
+      MessageInTransit::Type::ENDPOINT_CLIENT,
+      MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA, data.num_bytes,
+      mapping->GetBase()));
+  mapping.reset();
+  data_message->set_source_id(message->source_id());
+  data_message->set_destination_id(message->destination_id());
+
+  dispatchers->pop_back();
+  shared_buffer->Close();
+  if (!dispatchers->empty()) {
+    scoped_ptr<DispatcherVector> remaining_dispatchers(new DispatcherVector());
+    remaining_dispatchers->swap(*dispatchers);
+    data_message->SetDispatchers(remaining_dispatchers.Pass());
+  }
+  return data_message.Pass();
+}
+
+}  // namespace
 
 ChannelEndpoint::ChannelEndpoint(ChannelEndpointClient* client,
                                  unsigned client_port,
@@ -98,6 +215,15 @@ void ChannelEndpoint::AttachAndRun(Channel* channel,
 
 void ChannelEndpoint::OnReadMessage(scoped_ptr<MessageInTransit> message) {
   if (message->type() == MessageInTransit::Type::ENDPOINT_CLIENT) {
+    if (message->subtype() ==
+        MessageInTransit::Subtype::ENDPOINT_CLIENT_SHARED_BUFFER_DATA) {
+      message = RestoreDataFromSharedBuffer(message.get());
+      if (!message) {
+        // As below, dropping the message is safe.
+        LOG(ERROR) << "Received invalid shared buffer data message";
+        return;
+      }
+    }
     OnReadMessageForClient(message.Pass());
     return;
   }
@@ -157,6 +283,16 @@ bool ChannelEndpoint::WriteMessageNoLock(scoped_ptr<MessageInTransit> message) {
   DCHECK(local_id_.is_valid());
   DCHECK(remote_id_.is_valid());
 
+  if (ShouldMoveDataToSharedBuffer(message.get())) {
+    scoped_ptr<MessageInTransit> shared_buffer_message =
+        MoveDataToSharedBuffer(channel_->platform_support(), message.get());
+    if (shared_buffer_message) {
+      shared_buffer_message->set_latency_sensitive(
+          message->is_latency_sensitive());
+      message = shared_buffer_message.Pass();
+    }
+  }
+
   message->SerializeAndCloseDispatchers(channel_);
   message->set_source_id(local_id_);
   message->set_destination_id(remote_id_);
@@ -16,10 +16,12 @@ embedder::Configuration g_configuration = {
     1000000,              // max_wait_many_num_handles
     4 * 1024 * 1024,      // max_message_num_bytes
     10000,                // max_message_num_handles
+    256 * 1024,           // min_shared_buffer_message_num_bytes
     256 * 1024 * 1024,    // max_data_pipe_capacity_bytes
     1024 * 1024,          // default_data_pipe_capacity_bytes
     16,                   // data_pipe_buffer_alignment_bytes
-    1024 * 1024 * 1024};  // max_shared_memory_num_bytes
+    1024 * 1024 * 1024,   // max_shared_memory_num_bytes
+    50};                  // max_waiter_spin_microseconds
 
 }  // namespace internal
 }  // namespace system
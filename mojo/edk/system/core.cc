@@ -4,6 +4,7 @@
 
 #include "mojo/edk/system/core.h"
 
+#include <limits>
 #include <vector>
 
 #include "base/logging.h"
@@ -21,6 +22,7 @@
 #include "mojo/edk/system/message_pipe.h"
 #include "mojo/edk/system/message_pipe_dispatcher.h"
 #include "mojo/edk/system/shared_buffer_dispatcher.h"
+#include "mojo/edk/system/wait_set_dispatcher.h"
 #include "mojo/edk/system/waiter.h"
 #include "mojo/public/c/system/macros.h"
 #include "mojo/public/cpp/system/macros.h"
@@ -28,6 +30,35 @@
 namespace mojo {
 namespace system {
 
+namespace {
+
+// The part of |Core::WaitManyInternal()| for a zero deadline. Returns
+// |MOJO_RESULT_UNIMPLEMENTED| if one of |dispatchers| needs a waiter to tell.
+MojoResult PollDispatchers(const DispatcherVector& dispatchers,
+                           const MojoHandleSignals* signals,
+                           uint32_t* result_index,
+                           HandleSignalsState* signals_states) {
+  for (uint32_t i = 0; i < dispatchers.size(); i++) {
+    MojoResult rv = dispatchers[i]->CheckSignals(
+        signals[i], signals_states ? &signals_states[i] : nullptr);
+    if (rv == MOJO_RESULT_UNIMPLEMENTED)
+      return rv;
+    if (rv == MOJO_RESULT_OK)
+      continue;
+
+    // As with a waiter, the first handle that is done decides the result.
+    *result_index = i;
+    if (signals_states) {
+      for (uint32_t j = i + 1; j < dispatchers.size(); j++)
+        signals_states[j] = dispatchers[j]->GetHandleSignalsState();
+    }
+    return rv == MOJO_RESULT_ALREADY_EXISTS ? MOJO_RESULT_OK : rv;
+  }
+  return MOJO_RESULT_DEADLINE_EXCEEDED;
+}
+
+}  // namespace
+
 // Implementation notes
 //
 // Mojo primitives are implemented by the singleton |Core| object. Most calls
@@ -86,7 +117,7 @@ Core::~Core() {
 }
 
 MojoHandle Core::AddDispatcher(const scoped_refptr<Dispatcher>& dispatcher) {
-  MutexLocker locker(&handle_table_mutex_);
+  WriterMutexLocker locker(&handle_table_mutex_);
   return handle_table_.AddDispatcher(dispatcher);
 }
 
@@ -94,7 +125,7 @@ scoped_refptr<Dispatcher> Core::GetDispatcher(MojoHandle handle) {
   if (handle == MOJO_HANDLE_INVALID)
     return nullptr;
 
-  MutexLocker locker(&handle_table_mutex_);
+  ReaderMutexLocker locker(&handle_table_mutex_);
   return handle_table_.GetDispatcher(handle);
 }
 
@@ -103,7 +134,7 @@ MojoResult Core::GetAndRemoveDispatcher(MojoHandle handle,
   if (handle == MOJO_HANDLE_INVALID)
     return MOJO_RESULT_INVALID_ARGUMENT;
 
-  MutexLocker locker(&handle_table_mutex_);
+  WriterMutexLocker locker(&handle_table_mutex_);
   return handle_table_.GetAndRemoveDispatcher(handle, dispatcher);
 }
 
@@ -130,7 +161,7 @@ MojoResult Core::Close(MojoHandle handle) {
 
   scoped_refptr<Dispatcher> dispatcher;
   {
-    MutexLocker locker(&handle_table_mutex_);
+    WriterMutexLocker locker(&handle_table_mutex_);
     MojoResult result =
         handle_table_.GetAndRemoveDispatcher(handle, &dispatcher);
     if (result != MOJO_RESULT_OK)
@@ -211,7 +242,7 @@ MojoResult Core::CreateMessagePipe(
 
   std::pair<MojoHandle, MojoHandle> handle_pair;
   {
-    MutexLocker locker(&handle_table_mutex_);
+    WriterMutexLocker locker(&handle_table_mutex_);
     handle_pair = handle_table_.AddDispatcherPair(dispatcher0, dispatcher1);
   }
   if (handle_pair.first == MOJO_HANDLE_INVALID) {
@@ -276,7 +307,7 @@ MojoResult Core::WriteMessage(MojoHandle message_pipe_handle,
   // and mark the handles as busy. If the call succeeds, we then remove the
   // handles from the handle table.
   {
-    MutexLocker locker(&handle_table_mutex_);
+    WriterMutexLocker locker(&handle_table_mutex_);
     MojoResult result = handle_table_.MarkBusyAndStartTransport(
         message_pipe_handle, handles_reader.GetPointer(), num_handles,
         &transports);
@@ -293,7 +324,7 @@ MojoResult Core::WriteMessage(MojoHandle message_pipe_handle,
     transports[i].End();
 
   {
-    MutexLocker locker(&handle_table_mutex_);
+    WriterMutexLocker locker(&handle_table_mutex_);
     if (rv == MOJO_RESULT_OK) {
       handle_table_.RemoveBusyHandles(handles_reader.GetPointer(), num_handles);
     } else {
@@ -335,7 +366,7 @@ MojoResult Core::ReadMessage(MojoHandle message_pipe_handle,
       UserPointer<MojoHandle>::Writer handles_writer(handles,
                                                      dispatchers.size());
       {
-        MutexLocker locker(&handle_table_mutex_);
+        WriterMutexLocker locker(&handle_table_mutex_);
         success = handle_table_.AddDispatcherVector(
             dispatchers, handles_writer.GetPointer());
       }
@@ -377,7 +408,7 @@ MojoResult Core::CreateDataPipe(
 
   std::pair<MojoHandle, MojoHandle> handle_pair;
   {
-    MutexLocker locker(&handle_table_mutex_);
+    WriterMutexLocker locker(&handle_table_mutex_);
     handle_pair = handle_table_.AddDispatcherPair(producer_dispatcher,
                                                   consumer_dispatcher);
   }
@@ -554,6 +585,128 @@ MojoResult Core::UnmapBuffer(UserPointer<void> buffer) {
   return mapping_table_.RemoveMapping(buffer.GetPointerValue());
 }
 
+MojoResult Core::CreateWaitSet(UserPointer<MojoHandle> wait_set_handle) {
+  scoped_refptr<WaitSetDispatcher> dispatcher = WaitSetDispatcher::Create();
+  MojoHandle h = AddDispatcher(dispatcher);
+  if (h == MOJO_HANDLE_INVALID) {
+    LOG(ERROR) << "Handle table full";
+    dispatcher->Close();
+    return MOJO_RESULT_RESOURCE_EXHAUSTED;
+  }
+
+  wait_set_handle.Put(h);
+  return MOJO_RESULT_OK;
+}
+
+MojoResult Core::AddToWaitSet(MojoHandle wait_set_handle,
+                              MojoHandle handle,
+                              MojoHandleSignals signals,
+                              uint64_t cookie) {
+  scoped_refptr<Dispatcher> wait_set(GetDispatcher(wait_set_handle));
+  if (!wait_set || wait_set->GetType() != Dispatcher::Type::WAIT_SET)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+  scoped_refptr<Dispatcher> dispatcher(GetDispatcher(handle));
+  if (!dispatcher)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  return static_cast<WaitSetDispatcher*>(wait_set.get())
+      ->Add(dispatcher, signals, cookie);
+}
+
+MojoResult Core::RemoveFromWaitSet(MojoHandle wait_set_handle,
+                                   MojoHandle handle) {
+  scoped_refptr<Dispatcher> wait_set(GetDispatcher(wait_set_handle));
+  if (!wait_set || wait_set->GetType() != Dispatcher::Type::WAIT_SET)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+  scoped_refptr<Dispatcher> dispatcher(GetDispatcher(handle));
+  if (!dispatcher)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  return static_cast<WaitSetDispatcher*>(wait_set.get())
+      ->Remove(dispatcher.get());
+}
+
+MojoResult Core::WaitSetWait(
+    MojoHandle wait_set_handle,
+    MojoDeadline deadline,
+    UserPointer<uint32_t> num_results,
+    UserPointer<uint64_t> cookies,
+    UserPointer<MojoResult> results,
+    UserPointer<MojoHandleSignalsState> signals_states) {
+  scoped_refptr<Dispatcher> dispatcher(GetDispatcher(wait_set_handle));
+  if (!dispatcher || dispatcher->GetType() != Dispatcher::Type::WAIT_SET)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+  WaitSetDispatcher* wait_set =
+      static_cast<WaitSetDispatcher*>(dispatcher.get());
+
+  uint32_t max_results = num_results.Get();
+  if (max_results < 1)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  // |MojoDeadline| is a |uint64_t|; anything that doesn't fit into an |int64_t|
+  // is "forever" (as in |Waiter::Wait()|).
+  const bool indefinite =
+      deadline > static_cast<uint64_t>(std::numeric_limits<int64_t>::max());
+  const base::TimeTicks end_time =
+      indefinite ? base::TimeTicks()
+                 : base::TimeTicks::Now() + base::TimeDelta::FromMicroseconds(
+                                                static_cast<int64_t>(deadline));
+
+  std::vector<WaitSetDispatcher::Result> ready;
+  for (;;) {
+    MojoResult rv = wait_set->GetReady(max_results, &ready);
+    if (rv != MOJO_RESULT_OK)
+      return rv;
+    if (!ready.empty())
+      break;
+
+    // The wait set is readable when something may be ready. (It may turn out
+    // not to be, in which case we wait again.)
+    Waiter waiter;
+    waiter.Init();
+    rv = wait_set->AddAwakable(&waiter, MOJO_HANDLE_SIGNAL_READABLE, 0,
+                               nullptr);
+    if (rv == MOJO_RESULT_ALREADY_EXISTS)
+      continue;
+    if (rv != MOJO_RESULT_OK)
+      return rv;
+
+    MojoDeadline remaining = MOJO_DEADLINE_INDEFINITE;
+    if (!indefinite) {
+      base::TimeTicks now = base::TimeTicks::Now();
+      remaining = now < end_time
+                      ? static_cast<MojoDeadline>(
+                            (end_time - now).InMicroseconds())
+                      : 0;
+    }
+    rv = waiter.Wait(remaining, nullptr);
+    wait_set->RemoveAwakable(&waiter, nullptr);
+    if (rv != MOJO_RESULT_OK)
+      return rv;
+  }
+
+  const uint32_t num_ready = static_cast<uint32_t>(ready.size());
+  UserPointer<uint64_t>::Writer cookies_writer(cookies, num_ready);
+  for (uint32_t i = 0; i < num_ready; i++)
+    cookies_writer.GetPointer()[i] = ready[i].cookie;
+  cookies_writer.Commit();
+  if (!results.IsNull()) {
+    UserPointer<MojoResult>::Writer results_writer(results, num_ready);
+    for (uint32_t i = 0; i < num_ready; i++)
+      results_writer.GetPointer()[i] = ready[i].result;
+    results_writer.Commit();
+  }
+  if (!signals_states.IsNull()) {
+    UserPointer<MojoHandleSignalsState>::Writer signals_states_writer(
+        signals_states, num_ready);
+    for (uint32_t i = 0; i < num_ready; i++)
+      signals_states_writer.GetPointer()[i] = ready[i].signals_state;
+    signals_states_writer.Commit();
+  }
+  num_results.Put(num_ready);
+  return MOJO_RESULT_OK;
+}
+
 // Note: We allow |handles| to repeat the same handle multiple times, since
 // different flags may be specified.
 // TODO(vtl): This incurs a performance cost in |Remove()|. Analyze this
@@ -578,6 +731,17 @@ MojoResult Core::WaitManyInternal(const MojoHandle* handles,
     dispatchers.push_back(dispatcher);
   }
 
+  // Message loops poll their handles between tasks, which for pipes whose
+  // ends are both on the loop's thread is most of the time. When every
+  // dispatcher can check its signals itself, that needs no waiter and no
+  // adding and removing of awakables.
+  if (deadline == 0) {
+    MojoResult rv = PollDispatchers(dispatchers, signals, result_index,
+                                    signals_states);
+    if (rv != MOJO_RESULT_UNIMPLEMENTED)
+      return rv;
+  }
+
   // TODO(vtl): Should make the waiter live (permanently) in TLS.
   Waiter waiter;
   waiter.Init();
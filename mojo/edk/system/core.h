@@ -159,6 +159,31 @@ class MOJO_SYSTEM_IMPL_EXPORT Core {
                        MojoMapBufferFlags flags);
   MojoResult UnmapBuffer(UserPointer<void> buffer);
 
+  // These methods implement wait sets (see |WaitSetDispatcher|), which don't
+  // have public API functions yet. Unlike |WaitMany()|, the cost of
+  // |WaitSetWait()| doesn't grow with the number of handles in the set.
+  MojoResult CreateWaitSet(UserPointer<MojoHandle> wait_set_handle);
+  // |handle| must not be a wait set. |cookie| identifies it in the results of
+  // |WaitSetWait()|.
+  MojoResult AddToWaitSet(MojoHandle wait_set_handle,
+                          MojoHandle handle,
+                          MojoHandleSignals signals,
+                          uint64_t cookie);
+  MojoResult RemoveFromWaitSet(MojoHandle wait_set_handle, MojoHandle handle);
+  // Waits until at least one handle in the set is ready (i.e., its signals are
+  // satisfied or can never be, or it has been closed), and gets up to
+  // |*num_results| of them. On success, |*num_results| is set to the number
+  // gotten, and for each, |cookies| gets its cookie and |results| (if non-null)
+  // gets |MOJO_RESULT_OK|, |MOJO_RESULT_FAILED_PRECONDITION| or
+  // |MOJO_RESULT_CANCELLED| respectively. |signals_states| may be null.
+  // Returns |MOJO_RESULT_DEADLINE_EXCEEDED| if nothing is ready in time.
+  MojoResult WaitSetWait(MojoHandle wait_set_handle,
+                         MojoDeadline deadline,
+                         UserPointer<uint32_t> num_results,
+                         UserPointer<uint64_t> cookies,
+                         UserPointer<MojoResult> results,
+                         UserPointer<MojoHandleSignalsState> signals_states);
+
  private:
   friend bool internal::ShutdownCheckNoLeaks(Core*);
 
@@ -175,9 +200,10 @@ class MOJO_SYSTEM_IMPL_EXPORT Core {
 
   embedder::PlatformSupport* const platform_support_;
 
-  // TODO(vtl): |handle_table_mutex_| should be a reader-writer lock (if only we
-  // had them).
-  Mutex handle_table_mutex_;
+  // Looking up a dispatcher, which every message pipe and data pipe operation
+  // does, only needs a shared lock, so that threads using different handles do
+  // not serialize on it.
+  RWMutex handle_table_mutex_;
   HandleTable handle_table_ MOJO_GUARDED_BY(handle_table_mutex_);
 
   Mutex mapping_table_mutex_;
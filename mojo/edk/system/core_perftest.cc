@@ -0,0 +1,252 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "mojo/edk/embedder/simple_platform_support.h"
+#include "mojo/edk/system/core.h"
+#include "mojo/edk/system/memory.h"
+#include "mojo/edk/system/perftest_utils.h"
+#include "mojo/public/cpp/system/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+class CorePerfTest : public testing::Test {
+ public:
+  CorePerfTest() : core_(&platform_support_) {}
+  ~CorePerfTest() override {}
+
+ protected:
+  Core* core() { return &core_; }
+
+  void CreateMessagePipe(MojoHandle* h0, MojoHandle* h1) {
+    CHECK_EQ(core_.CreateMessagePipe(NullUserPointer(), MakeUserPointer(h0),
+                                     MakeUserPointer(h1)),
+             MOJO_RESULT_OK);
+  }
+
+  void WriteMessage(MojoHandle h, const MojoHandle* handles,
+                    uint32_t num_handles) {
+    const char kByte = 'x';
+    CHECK_EQ(core_.WriteMessage(h, UserPointer<const void>(&kByte), 1u,
+                                MakeUserPointer(handles), num_handles,
+                                MOJO_WRITE_MESSAGE_FLAG_NONE),
+             MOJO_RESULT_OK);
+  }
+
+  // Reads a message that is known to have arrived, returning the number of
+  // handles it carried (in |handles|, which must have room for one).
+  uint32_t ReadMessage(MojoHandle h, MojoHandle* handles) {
+    char byte = 0;
+    uint32_t num_bytes = 1;
+    uint32_t num_handles = handles ? 1 : 0;
+    CHECK_EQ(core_.ReadMessage(h, UserPointer<void>(&byte),
+                               MakeUserPointer(&num_bytes),
+                               MakeUserPointer(handles),
+                               MakeUserPointer(&num_handles),
+                               MOJO_READ_MESSAGE_FLAG_NONE),
+             MOJO_RESULT_OK);
+    return num_handles;
+  }
+
+  void WaitReadable(MojoHandle h) {
+    CHECK_EQ(core_.Wait(h, MOJO_HANDLE_SIGNAL_READABLE,
+                        MOJO_DEADLINE_INDEFINITE, NullUserPointer()),
+             MOJO_RESULT_OK);
+  }
+
+ private:
+  embedder::SimplePlatformSupport platform_support_;
+  Core core_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(CorePerfTest);
+};
+
+double MicrosecondsPerIteration(base::TimeTicks start_time, int iterations) {
+  return (base::TimeTicks::Now() - start_time).InMicrosecondsF() / iterations;
+}
+
+TEST_F(CorePerfTest, MapUnmapBuffer) {
+  const int kIterations = 10000;
+  const uint64_t kSizes[] = {4096u, 1024u * 1024u, 16u * 1024u * 1024u};
+  for (uint64_t size : kSizes) {
+    MojoHandle h = MOJO_HANDLE_INVALID;
+    CHECK_EQ(core()->CreateSharedBuffer(NullUserPointer(), size,
+                                        MakeUserPointer(&h)),
+             MOJO_RESULT_OK);
+
+    base::TimeTicks start_time = base::TimeTicks::Now();
+    for (int i = 0; i < kIterations; i++) {
+      void* address = nullptr;
+      CHECK_EQ(core()->MapBuffer(h, 0, size, MakeUserPointer(&address),
+                                 MOJO_MAP_BUFFER_FLAG_NONE),
+               MOJO_RESULT_OK);
+      CHECK_EQ(core()->UnmapBuffer(MakeUserPointer(address)), MOJO_RESULT_OK);
+    }
+    test::PrintPerfResult(
+        "SharedBuffer_MapUnmap",
+        base::StringPrintf("%u_bytes", static_cast<unsigned>(size)),
+        MicrosecondsPerIteration(start_time, kIterations), "us");
+
+    EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h));
+  }
+}
+
+// Waits on |n| message pipes, only the last of which is readable, first with
+// |WaitMany()| and then with a wait set containing the same handles.
+TEST_F(CorePerfTest, WaitManyScaling) {
+  const int kIterations = 2000;
+  const uint32_t kHandleCounts[] = {1u, 16u, 128u, 1024u};
+  for (uint32_t n : kHandleCounts) {
+    std::vector<MojoHandle> handles(n);
+    std::vector<MojoHandle> peers(n);
+    for (uint32_t i = 0; i < n; i++)
+      CreateMessagePipe(&handles[i], &peers[i]);
+    WriteMessage(peers[n - 1], nullptr, 0);
+
+    std::vector<MojoHandleSignals> signals(n, MOJO_HANDLE_SIGNAL_READABLE);
+    base::TimeTicks start_time = base::TimeTicks::Now();
+    for (int i = 0; i < kIterations; i++) {
+      uint32_t result_index = static_cast<uint32_t>(-1);
+      CHECK_EQ(core()->WaitMany(MakeUserPointer(&handles[0]),
+                                MakeUserPointer(&signals[0]), n,
+                                MOJO_DEADLINE_INDEFINITE,
+                                MakeUserPointer(&result_index),
+                                NullUserPointer()),
+               MOJO_RESULT_OK);
+      CHECK_EQ(result_index, n - 1);
+    }
+    test::PrintPerfResult("WaitMany", base::StringPrintf("%u_handles", n),
+                          MicrosecondsPerIteration(start_time, kIterations),
+                          "us");
+
+    MojoHandle wait_set = MOJO_HANDLE_INVALID;
+    CHECK_EQ(core()->CreateWaitSet(MakeUserPointer(&wait_set)),
+             MOJO_RESULT_OK);
+    for (uint32_t i = 0; i < n; i++) {
+      CHECK_EQ(core()->AddToWaitSet(wait_set, handles[i],
+                                    MOJO_HANDLE_SIGNAL_READABLE, i),
+               MOJO_RESULT_OK);
+    }
+    start_time = base::TimeTicks::Now();
+    for (int i = 0; i < kIterations; i++) {
+      uint32_t num_results = 1;
+      uint64_t cookie = 0;
+      CHECK_EQ(core()->WaitSetWait(wait_set, MOJO_DEADLINE_INDEFINITE,
+                                   MakeUserPointer(&num_results),
+                                   MakeUserPointer(&cookie), NullUserPointer(),
+                                   NullUserPointer()),
+               MOJO_RESULT_OK);
+      CHECK_EQ(cookie, n - 1);
+    }
+    test::PrintPerfResult("WaitSetWait", base::StringPrintf("%u_handles", n),
+                          MicrosecondsPerIteration(start_time, kIterations),
+                          "us");
+
+    EXPECT_EQ(MOJO_RESULT_OK, core()->Close(wait_set));
+    for (uint32_t i = 0; i < n; i++) {
+      EXPECT_EQ(MOJO_RESULT_OK, core()->Close(handles[i]));
+      EXPECT_EQ(MOJO_RESULT_OK, core()->Close(peers[i]));
+    }
+  }
+}
+
+// Passes a message pipe handle back and forth over another message pipe.
+TEST_F(CorePerfTest, HandleTransfer) {
+  const int kIterations = 20000;
+  MojoHandle h0 = MOJO_HANDLE_INVALID;
+  MojoHandle h1 = MOJO_HANDLE_INVALID;
+  CreateMessagePipe(&h0, &h1);
+  MojoHandle transferred = MOJO_HANDLE_INVALID;
+  MojoHandle transferred_peer = MOJO_HANDLE_INVALID;
+  CreateMessagePipe(&transferred, &transferred_peer);
+
+  base::TimeTicks start_time = base::TimeTicks::Now();
+  for (int i = 0; i < kIterations; i++) {
+    WriteMessage(i % 2 ? h1 : h0, &transferred, 1);
+    CHECK_EQ(ReadMessage(i % 2 ? h0 : h1, &transferred), 1u);
+  }
+  test::PrintPerfResult("MessagePipe_HandleTransfer", "local",
+                        MicrosecondsPerIteration(start_time, kIterations),
+                        "us");
+
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(transferred));
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(transferred_peer));
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h0));
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h1));
+}
+
+// Echoes every message it reads until its handle's peer is closed.
+class EchoThread : public base::SimpleThread {
+ public:
+  EchoThread(Core* core, MojoHandle h)
+      : base::SimpleThread("echo_thread"), core_(core), h_(h) {}
+  ~EchoThread() override { Join(); }
+
+  void Run() override {
+    for (;;) {
+      if (core_->Wait(h_, MOJO_HANDLE_SIGNAL_READABLE, MOJO_DEADLINE_INDEFINITE,
+                      NullUserPointer()) != MOJO_RESULT_OK) {
+        break;
+      }
+      char byte = 0;
+      uint32_t num_bytes = 1;
+      CHECK_EQ(core_->ReadMessage(h_, UserPointer<void>(&byte),
+                                  MakeUserPointer(&num_bytes),
+                                  NullUserPointer(), NullUserPointer(),
+                                  MOJO_READ_MESSAGE_FLAG_NONE),
+               MOJO_RESULT_OK);
+      CHECK_EQ(core_->WriteMessage(h_, UserPointer<const void>(&byte), 1u,
+                                   NullUserPointer(), 0u,
+                                   MOJO_WRITE_MESSAGE_FLAG_NONE),
+               MOJO_RESULT_OK);
+    }
+  }
+
+ private:
+  Core* const core_;
+  const MojoHandle h_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(EchoThread);
+};
+
+TEST_F(CorePerfTest, CrossThreadPingPong) {
+  const int kIterations = 20000;
+  MojoHandle h0 = MOJO_HANDLE_INVALID;
+  MojoHandle h1 = MOJO_HANDLE_INVALID;
+  CreateMessagePipe(&h0, &h1);
+
+  {
+    EchoThread thread(core(), h1);
+    thread.Start();
+
+    base::TimeTicks start_time = base::TimeTicks::Now();
+    for (int i = 0; i < kIterations; i++) {
+      WriteMessage(h0, nullptr, 0);
+      WaitReadable(h0);
+      ReadMessage(h0, nullptr);
+    }
+    test::PrintPerfResult("MessagePipe_PingPong", "cross_thread",
+                          MicrosecondsPerIteration(start_time, kIterations),
+                          "us");
+
+    EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h0));
+  }
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h1));
+}
+
+}  // namespace
+}  // namespace system
+}  // namespace mojo
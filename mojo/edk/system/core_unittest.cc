@@ -701,6 +701,81 @@ TEST_F(CoreTest, MessagePipe) {
   EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h[1]));
 }
 
+// Tests polling message pipes with a zero deadline, which doesn't need a
+// waiter, alone and together with a handle whose dispatcher needs one.
+TEST_F(CoreTest, MessagePipePoll) {
+  MojoHandle h[3];
+  MojoHandleSignalsState hss[3];
+  uint32_t result_index;
+
+  EXPECT_EQ(MOJO_RESULT_OK,
+            core()->CreateMessagePipe(NullUserPointer(), MakeUserPointer(&h[0]),
+                                      MakeUserPointer(&h[1])));
+  MockHandleInfo info;
+  info.AllowAddAwakable(true);
+  h[2] = CreateMockHandle(&info);
+
+  MojoHandleSignals signals[3] = {MOJO_HANDLE_SIGNAL_READABLE,
+                                  MOJO_HANDLE_SIGNAL_READABLE,
+                                  MOJO_HANDLE_SIGNAL_READABLE};
+  result_index = static_cast<uint32_t>(-1);
+  hss[0] = kEmptyMojoHandleSignalsState;
+  hss[1] = kEmptyMojoHandleSignalsState;
+  EXPECT_EQ(
+      MOJO_RESULT_DEADLINE_EXCEEDED,
+      core()->WaitMany(MakeUserPointer(h), MakeUserPointer(signals), 2, 0,
+                       MakeUserPointer(&result_index), MakeUserPointer(hss)));
+  EXPECT_EQ(static_cast<uint32_t>(-1), result_index);
+  EXPECT_EQ(MOJO_HANDLE_SIGNAL_WRITABLE, hss[0].satisfied_signals);
+  EXPECT_EQ(kAllSignals, hss[0].satisfiable_signals);
+  EXPECT_EQ(MOJO_HANDLE_SIGNAL_WRITABLE, hss[1].satisfied_signals);
+  EXPECT_EQ(kAllSignals, hss[1].satisfiable_signals);
+
+  // The pipes' dispatchers can tell by themselves, but the mock can't.
+  EXPECT_EQ(
+      MOJO_RESULT_DEADLINE_EXCEEDED,
+      core()->WaitMany(MakeUserPointer(h), MakeUserPointer(signals), 3, 0,
+                       MakeUserPointer(&result_index), MakeUserPointer(hss)));
+  EXPECT_EQ(1u, info.GetAddAwakableCallCount());
+
+  char buffer[1] = {'a'};
+  EXPECT_EQ(
+      MOJO_RESULT_OK,
+      core()->WriteMessage(h[0], UserPointer<const void>(buffer), 1,
+                           NullUserPointer(), 0, MOJO_WRITE_MESSAGE_FLAG_NONE));
+
+  // The first handle that is ready decides, and the states of the handles
+  // after it are still reported.
+  result_index = static_cast<uint32_t>(-1);
+  hss[0] = kEmptyMojoHandleSignalsState;
+  hss[1] = kEmptyMojoHandleSignalsState;
+  EXPECT_EQ(
+      MOJO_RESULT_OK,
+      core()->WaitMany(MakeUserPointer(h), MakeUserPointer(signals), 2, 0,
+                       MakeUserPointer(&result_index), MakeUserPointer(hss)));
+  EXPECT_EQ(1u, result_index);
+  EXPECT_EQ(MOJO_HANDLE_SIGNAL_WRITABLE, hss[0].satisfied_signals);
+  EXPECT_EQ(kAllSignals, hss[0].satisfiable_signals);
+  EXPECT_EQ(MOJO_HANDLE_SIGNAL_READABLE | MOJO_HANDLE_SIGNAL_WRITABLE,
+            hss[1].satisfied_signals);
+  EXPECT_EQ(kAllSignals, hss[1].satisfiable_signals);
+
+  // Once the peer is closed, an unreadable end can never become readable.
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h[1]));
+  result_index = static_cast<uint32_t>(-1);
+  hss[0] = kFullMojoHandleSignalsState;
+  EXPECT_EQ(
+      MOJO_RESULT_FAILED_PRECONDITION,
+      core()->WaitMany(MakeUserPointer(h), MakeUserPointer(signals), 1, 0,
+                       MakeUserPointer(&result_index), MakeUserPointer(hss)));
+  EXPECT_EQ(0u, result_index);
+  EXPECT_EQ(MOJO_HANDLE_SIGNAL_PEER_CLOSED, hss[0].satisfied_signals);
+  EXPECT_EQ(MOJO_HANDLE_SIGNAL_PEER_CLOSED, hss[0].satisfiable_signals);
+
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h[0]));
+  EXPECT_EQ(MOJO_RESULT_OK, core()->Close(h[2]));
+}
+
 // Tests passing a message pipe handle.
 TEST_F(CoreTest, MessagePipeBasicLocalHandlePassing1) {
   const char kHello[] = "hello";
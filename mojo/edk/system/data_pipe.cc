@@ -133,7 +133,8 @@ DataPipe* DataPipe::CreateRemoteConsumerFromExisting(
     const MojoCreateDataPipeOptions& validated_options,
     size_t consumer_num_bytes,
     MessageInTransitQueue* message_queue,
-    ChannelEndpoint* channel_endpoint) {
+    ChannelEndpoint* channel_endpoint,
+    embedder::PlatformSupport* platform_support) {
   if (!RemoteConsumerDataPipeImpl::ProcessMessagesFromIncomingEndpoint(
           validated_options, &consumer_num_bytes, message_queue))
     return nullptr;
@@ -148,7 +149,8 @@ DataPipe* DataPipe::CreateRemoteConsumerFromExisting(
   DataPipe* data_pipe =
       new DataPipe(true, false, validated_options,
                    make_scoped_ptr(new RemoteConsumerDataPipeImpl(
-                       channel_endpoint, consumer_num_bytes)));
+                       channel_endpoint, consumer_num_bytes,
+                       platform_support)));
   if (channel_endpoint) {
     if (!channel_endpoint->ReplaceClient(data_pipe, 0))
       data_pipe->OnDetachFromChannel(0);
@@ -195,7 +197,7 @@ bool DataPipe::ProducerDeserialize(Channel* channel,
 
     *data_pipe = new DataPipe(
         true, false, revalidated_options,
-        make_scoped_ptr(new RemoteConsumerDataPipeImpl(nullptr, 0)));
+        make_scoped_ptr(new RemoteConsumerDataPipeImpl(nullptr, 0, nullptr)));
     (*data_pipe)->SetConsumerClosed();
 
     return true;
@@ -216,7 +218,7 @@ bool DataPipe::ProducerDeserialize(Channel* channel,
     return false;
 
   *data_pipe = incoming_endpoint->ConvertToDataPipeProducer(
-      revalidated_options, s->consumer_num_bytes);
+      revalidated_options, s->consumer_num_bytes, channel->platform_support());
   if (!*data_pipe)
     return false;
 
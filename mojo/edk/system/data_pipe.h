@@ -20,6 +20,11 @@
 #include "mojo/public/cpp/system/macros.h"
 
 namespace mojo {
+
+namespace embedder {
+class PlatformSupport;
+}
+
 namespace system {
 
 class Awakable;
@@ -75,12 +80,14 @@ class MOJO_SYSTEM_IMPL_EXPORT DataPipe final : public ChannelEndpointClient {
   // |message_queue|'s contents as already-received incoming messages
   // (|message_queue| may be null). If |channel_endpoint| is null, this will
   // create a "half-open" data pipe (with only the producer open). Note that
-  // this may fail, in which case it returns null.
+  // this may fail, in which case it returns null. |platform_support| (which may
+  // be null) is used to set up a buffer shared with the consumer.
   static DataPipe* CreateRemoteConsumerFromExisting(
       const MojoCreateDataPipeOptions& validated_options,
       size_t consumer_num_bytes,
       MessageInTransitQueue* message_queue,
-      ChannelEndpoint* channel_endpoint);
+      ChannelEndpoint* channel_endpoint,
+      embedder::PlatformSupport* platform_support);
 
   // Used by |DataPipeProducerDispatcher::Deserialize()|. Returns true on
   // success (in which case, |*data_pipe| is set appropriately) and false on
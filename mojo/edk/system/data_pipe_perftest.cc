@@ -0,0 +1,150 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "base/logging.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/threading/simple_thread.h"
+#include "base/time/time.h"
+#include "mojo/edk/system/data_pipe.h"
+#include "mojo/edk/system/data_pipe_consumer_dispatcher.h"
+#include "mojo/edk/system/data_pipe_producer_dispatcher.h"
+#include "mojo/edk/system/memory.h"
+#include "mojo/edk/system/perftest_utils.h"
+#include "mojo/public/cpp/system/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+const uint32_t kTotalNumBytes = 64 * 1024 * 1024;
+// The most that is written or read per call.
+const uint32_t kMaxChunkNumBytes = 64 * 1024;
+
+// Reads |kTotalNumBytes| from the consumer, waiting whenever it runs dry.
+class ConsumerThread : public base::SimpleThread {
+ public:
+  explicit ConsumerThread(Dispatcher* consumer)
+      : base::SimpleThread("consumer_thread"), consumer_(consumer) {}
+  ~ConsumerThread() override { Join(); }
+
+  void Run() override {
+    std::vector<char> buffer(kMaxChunkNumBytes);
+    uint32_t total_read = 0;
+    while (total_read < kTotalNumBytes) {
+      uint32_t num_bytes = kMaxChunkNumBytes;
+      MojoResult result =
+          consumer_->ReadData(UserPointer<void>(&buffer[0]),
+                              MakeUserPointer(&num_bytes),
+                              MOJO_READ_DATA_FLAG_NONE);
+      if (result == MOJO_RESULT_SHOULD_WAIT) {
+        CHECK_EQ(test::WaitForSignals(consumer_, MOJO_HANDLE_SIGNAL_READABLE),
+                 MOJO_RESULT_OK);
+        continue;
+      }
+      CHECK_EQ(result, MOJO_RESULT_OK);
+      total_read += num_bytes;
+    }
+  }
+
+ private:
+  Dispatcher* const consumer_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(ConsumerThread);
+};
+
+// Measures the throughput of a data pipe with the given element size and
+// capacity. If |remote| is set, the consumer is first sent over a
+// |test::RemoteMessagePipe|, so that the data goes through a |Channel|.
+void MeasureThroughput(uint32_t element_num_bytes,
+                       uint32_t capacity_num_bytes,
+                       bool remote) {
+  const MojoCreateDataPipeOptions options = {
+      static_cast<uint32_t>(sizeof(MojoCreateDataPipeOptions)),
+      MOJO_CREATE_DATA_PIPE_OPTIONS_FLAG_NONE, element_num_bytes,
+      capacity_num_bytes};
+  scoped_refptr<DataPipe> dp(DataPipe::CreateLocal(options));
+  scoped_refptr<DataPipeProducerDispatcher> producer =
+      DataPipeProducerDispatcher::Create();
+  producer->Init(dp);
+  scoped_refptr<Dispatcher> consumer;
+  {
+    scoped_refptr<DataPipeConsumerDispatcher> local_consumer =
+        DataPipeConsumerDispatcher::Create();
+    local_consumer->Init(dp);
+    consumer = local_consumer;
+  }
+  dp = nullptr;
+
+  scoped_ptr<test::RemoteMessagePipe> mp;
+  if (remote) {
+    mp.reset(new test::RemoteMessagePipe());
+    consumer = mp->SendDispatcher(consumer);
+  }
+
+  // Write in whole elements.
+  const uint32_t chunk_num_bytes =
+      kMaxChunkNumBytes - kMaxChunkNumBytes % element_num_bytes;
+  std::vector<char> buffer(chunk_num_bytes, 'x');
+  base::TimeTicks start_time;
+  {
+    ConsumerThread thread(consumer.get());
+    start_time = base::TimeTicks::Now();
+    thread.Start();
+
+    uint32_t total_written = 0;
+    while (total_written < kTotalNumBytes) {
+      uint32_t num_bytes = std::min(chunk_num_bytes,
+                                    kTotalNumBytes - total_written);
+      MojoResult result = producer->WriteData(
+          UserPointer<const void>(&buffer[0]), MakeUserPointer(&num_bytes),
+          MOJO_WRITE_DATA_FLAG_NONE);
+      if (result == MOJO_RESULT_SHOULD_WAIT) {
+        CHECK_EQ(
+            test::WaitForSignals(producer.get(), MOJO_HANDLE_SIGNAL_WRITABLE),
+            MOJO_RESULT_OK);
+        continue;
+      }
+      CHECK_EQ(result, MOJO_RESULT_OK);
+      total_written += num_bytes;
+    }
+  }
+  double seconds = (base::TimeTicks::Now() - start_time).InSecondsF();
+
+  test::PrintPerfResult(
+      "DataPipe_Throughput",
+      base::StringPrintf("%s_element_%u_capacity_%u",
+                         remote ? "remote" : "local", element_num_bytes,
+                         capacity_num_bytes),
+      kTotalNumBytes / seconds / (1024 * 1024), "MB/s");
+
+  EXPECT_EQ(MOJO_RESULT_OK, producer->Close());
+  EXPECT_EQ(MOJO_RESULT_OK, consumer->Close());
+}
+
+TEST(DataPipePerfTest, LocalThroughput) {
+  MeasureThroughput(1, 64 * 1024, false);
+  MeasureThroughput(1, 1024 * 1024, false);
+  MeasureThroughput(16, 64 * 1024, false);
+  MeasureThroughput(16, 1024 * 1024, false);
+}
+
+TEST(DataPipePerfTest, RemoteThroughput) {
+  MeasureThroughput(1, 64 * 1024, true);
+  MeasureThroughput(1, 1024 * 1024, true);
+  MeasureThroughput(16, 64 * 1024, true);
+  MeasureThroughput(16, 1024 * 1024, true);
+}
+
+}  // namespace
+}  // namespace system
+}  // namespace mojo
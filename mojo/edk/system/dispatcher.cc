@@ -92,6 +92,9 @@ scoped_refptr<Dispatcher> Dispatcher::TransportDataAccess::Deserialize(
     case Type::PLATFORM_HANDLE:
       return scoped_refptr<Dispatcher>(PlatformHandleDispatcher::Deserialize(
           channel, source, size, platform_handles));
+    case Type::WAIT_SET:
+      // Wait sets are never serialized.
+      break;
   }
   LOG(WARNING) << "Unknown dispatcher type " << type;
   return nullptr;
@@ -238,6 +241,18 @@ MojoResult Dispatcher::AddAwakable(Awakable* awakable,
   return AddAwakableImplNoLock(awakable, signals, context, signals_state);
 }
 
+MojoResult Dispatcher::CheckSignals(MojoHandleSignals signals,
+                                    HandleSignalsState* signals_state) const {
+  MutexLocker locker(&mutex_);
+  if (is_closed_) {
+    if (signals_state)
+      *signals_state = HandleSignalsState();
+    return MOJO_RESULT_INVALID_ARGUMENT;
+  }
+
+  return CheckSignalsImplNoLock(signals, signals_state);
+}
+
 void Dispatcher::RemoveAwakable(Awakable* awakable,
                                 HandleSignalsState* handle_signals_state) {
   MutexLocker locker(&mutex_);
@@ -399,6 +414,15 @@ void Dispatcher::RemoveAwakableImplNoLock(Awakable* /*awakable*/,
     *signals_state = HandleSignalsState();
 }
 
+MojoResult Dispatcher::CheckSignalsImplNoLock(
+    MojoHandleSignals /*signals*/,
+    HandleSignalsState* /*signals_state*/) const {
+  mutex_.AssertHeld();
+  DCHECK(!is_closed_);
+  // By default, it's up to |AddAwakableImplNoLock()| to say what a wait does.
+  return MOJO_RESULT_UNIMPLEMENTED;
+}
+
 void Dispatcher::StartSerializeImplNoLock(Channel* /*channel*/,
                                           size_t* max_size,
                                           size_t* max_platform_handles) {
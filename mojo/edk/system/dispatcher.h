@@ -68,7 +68,8 @@ class MOJO_SYSTEM_IMPL_EXPORT Dispatcher
     SHARED_BUFFER,
 
     // "Private" types (not exposed via the public interface):
-    PLATFORM_HANDLE = -1
+    PLATFORM_HANDLE = -1,
+    WAIT_SET = -2
   };
   virtual Type GetType() const = 0;
 
@@ -152,6 +153,15 @@ class MOJO_SYSTEM_IMPL_EXPORT Dispatcher
   // |AddAwakable()| was called at most once.) If |signals_state| is non-null,
   // |*signals_state| will be set to the current handle signals state.
   void RemoveAwakable(Awakable* awakable, HandleSignalsState* signals_state);
+  // Checks |signals| against the current state the way |AddAwakable()| would,
+  // but without adding an awakable, for waits with a zero deadline. Returns
+  // |MOJO_RESULT_OK| if |signals| is not satisfied but may be later, and
+  // otherwise what |AddAwakable()| would return (setting |*signals_state| in
+  // every case); or |MOJO_RESULT_UNIMPLEMENTED| if the dispatcher can't tell
+  // without an awakable (the default), in which case the caller should add
+  // one instead.
+  MojoResult CheckSignals(MojoHandleSignals signals,
+                          HandleSignalsState* signals_state) const;
 
   // A dispatcher must be put into a special state in order to be sent across a
   // message pipe. Outside of tests, only |HandleTableAccess| is allowed to do
@@ -284,6 +294,10 @@ class MOJO_SYSTEM_IMPL_EXPORT Dispatcher
   virtual void RemoveAwakableImplNoLock(Awakable* awakable,
                                         HandleSignalsState* signals_state)
       MOJO_EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+  virtual MojoResult CheckSignalsImplNoLock(
+      MojoHandleSignals signals,
+      HandleSignalsState* signals_state) const
+      MOJO_SHARED_LOCKS_REQUIRED(mutex_);
 
   // These implement the API used to serialize dispatchers to a |Channel|
   // (described below). They will only be called on a dispatcher that's attached
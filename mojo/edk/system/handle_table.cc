@@ -32,10 +32,10 @@ HandleTable::~HandleTable() {
   // the singleton |Core|, which lives forever), except in tests.
 }
 
-Dispatcher* HandleTable::GetDispatcher(MojoHandle handle) {
+Dispatcher* HandleTable::GetDispatcher(MojoHandle handle) const {
   DCHECK_NE(handle, MOJO_HANDLE_INVALID);
 
-  HandleToEntryMap::iterator it = handle_to_entry_map_.find(handle);
+  HandleToEntryMap::const_iterator it = handle_to_entry_map_.find(handle);
   if (it == handle_to_entry_map_.end())
     return nullptr;
   return it->second.dispatcher.get();
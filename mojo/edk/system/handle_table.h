@@ -35,7 +35,9 @@ bool ShutdownCheckNoLeaks(Core*);
 //
 // This class is NOT thread-safe; locking is left to |Core| (since it may need
 // to make several changes -- "atomically" or in rapid successsion, in which
-// case the extra locking/unlocking would be unnecessary overhead).
+// case the extra locking/unlocking would be unnecessary overhead). Only
+// |GetDispatcher()| may be called concurrently (with itself), which lets |Core|
+// use a reader lock for it.
 
 class MOJO_SYSTEM_IMPL_EXPORT HandleTable {
  public:
@@ -48,7 +50,7 @@ class MOJO_SYSTEM_IMPL_EXPORT HandleTable {
   // WARNING: For efficiency, this returns a dumb pointer. If you're going to
   // use the result outside |Core|'s lock, you MUST take a reference (e.g., by
   // storing the result inside a |scoped_refptr|).
-  Dispatcher* GetDispatcher(MojoHandle handle);
+  Dispatcher* GetDispatcher(MojoHandle handle) const;
 
   // On success, gets the dispatcher for a given handle (which should not be
   // |MOJO_HANDLE_INVALID|) and removes it. (On failure, returns an appropriate
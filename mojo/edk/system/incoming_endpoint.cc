@@ -34,10 +34,12 @@ scoped_refptr<MessagePipe> IncomingEndpoint::ConvertToMessagePipe() {
 
 scoped_refptr<DataPipe> IncomingEndpoint::ConvertToDataPipeProducer(
     const MojoCreateDataPipeOptions& validated_options,
-    size_t consumer_num_bytes) {
+    size_t consumer_num_bytes,
+    embedder::PlatformSupport* platform_support) {
   MutexLocker locker(&mutex_);
   scoped_refptr<DataPipe> data_pipe(DataPipe::CreateRemoteConsumerFromExisting(
-      validated_options, consumer_num_bytes, &message_queue_, endpoint_.get()));
+      validated_options, consumer_num_bytes, &message_queue_, endpoint_.get(),
+      platform_support));
   DCHECK(message_queue_.IsEmpty());
   endpoint_ = nullptr;
   return data_pipe;
@@ -17,6 +17,11 @@
 struct MojoCreateDataPipeOptions;
 
 namespace mojo {
+
+namespace embedder {
+class PlatformSupport;
+}
+
 namespace system {
 
 class ChannelEndpoint;
@@ -37,7 +42,8 @@ class MOJO_SYSTEM_IMPL_EXPORT IncomingEndpoint final
   scoped_refptr<MessagePipe> ConvertToMessagePipe();
   scoped_refptr<DataPipe> ConvertToDataPipeProducer(
       const MojoCreateDataPipeOptions& validated_options,
-      size_t consumer_num_bytes);
+      size_t consumer_num_bytes,
+      embedder::PlatformSupport* platform_support);
   scoped_refptr<DataPipe> ConvertToDataPipeConsumer(
       const MojoCreateDataPipeOptions& validated_options);
 
@@ -379,7 +379,8 @@ bool LocalDataPipeImpl::ConsumerEndSerialize(
   // Note: Keep |*this| alive until the end of this method, to make things
   // slightly easier on ourselves.
   scoped_ptr<DataPipeImpl> self(owner()->ReplaceImplNoLock(make_scoped_ptr(
-      new RemoteConsumerDataPipeImpl(channel_endpoint.get(), old_num_bytes))));
+      new RemoteConsumerDataPipeImpl(channel_endpoint.get(), old_num_bytes,
+                                     channel->platform_support()))));
 
   *actual_size = sizeof(SerializedDataPipeConsumerDispatcher) +
                  channel->GetSerializedEndpointSize();
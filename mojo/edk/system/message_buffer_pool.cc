@@ -0,0 +1,136 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/edk/system/message_buffer_pool.h"
+
+#include <vector>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/memory/aligned_memory.h"
+#include "base/threading/thread_local_storage.h"
+#include "mojo/edk/system/message_in_transit.h"
+#include "mojo/public/cpp/system/macros.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+// Each buffer is preceded by a prefix recording its size class (so that it can
+// be freed without knowing its size). The prefix keeps the buffer aligned.
+const size_t kPrefixSize = MessageInTransit::kMessageAlignment;
+static_assert(kPrefixSize >= sizeof(uint32_t), "Prefix too small");
+
+// Size classes are powers of two (including the prefix), from 64 bytes to
+// 4 KiB. Larger buffers aren't pooled.
+const size_t kMinSizeClassBytes = 64;
+const uint32_t kNumSizeClasses = 7;
+const uint32_t kUnpooledSizeClass = kNumSizeClasses;
+
+// Enough to absorb a burst of messages without holding on to much memory per
+// thread.
+const size_t kMaxFreeBuffersPerSizeClass = 64;
+
+uint32_t SizeClassForSize(size_t size) {
+  size_t class_bytes = kMinSizeClassBytes;
+  for (uint32_t size_class = 0; size_class < kNumSizeClasses; size_class++) {
+    if (size + kPrefixSize <= class_bytes)
+      return size_class;
+    class_bytes *= 2;
+  }
+  return kUnpooledSizeClass;
+}
+
+size_t AllocationSizeForSizeClass(uint32_t size_class) {
+  DCHECK_LT(size_class, kNumSizeClasses);
+  return kMinSizeClassBytes << size_class;
+}
+
+struct ThreadPool {
+  // Each free list holds allocations (i.e., pointers to prefixes).
+  std::vector<void*> free_lists[kNumSizeClasses];
+  MessageBufferPoolStats stats;
+};
+
+void DestroyThreadPool(void* value) {
+  ThreadPool* pool = static_cast<ThreadPool*>(value);
+  for (uint32_t i = 0; i < kNumSizeClasses; i++) {
+    for (void* allocation : pool->free_lists[i])
+      base::AlignedFree(allocation);
+  }
+  delete pool;
+}
+
+class ThreadPoolSlot {
+ public:
+  ThreadPoolSlot() : slot_(&DestroyThreadPool) {}
+
+  ThreadPool* Get() {
+    ThreadPool* pool = static_cast<ThreadPool*>(slot_.Get());
+    if (!pool) {
+      pool = new ThreadPool();
+      slot_.Set(pool);
+    }
+    return pool;
+  }
+
+ private:
+  base::ThreadLocalStorage::Slot slot_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(ThreadPoolSlot);
+};
+
+base::LazyInstance<ThreadPoolSlot>::Leaky g_thread_pool_slot =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+void* AllocMessageBuffer(size_t size) {
+  ThreadPool* pool = g_thread_pool_slot.Get().Get();
+  pool->stats.allocations++;
+
+  uint32_t size_class = SizeClassForSize(size);
+  void* allocation = nullptr;
+  if (size_class == kUnpooledSizeClass) {
+    allocation = base::AlignedAlloc(size + kPrefixSize,
+                                    MessageInTransit::kMessageAlignment);
+  } else if (!pool->free_lists[size_class].empty()) {
+    allocation = pool->free_lists[size_class].back();
+    pool->free_lists[size_class].pop_back();
+    pool->stats.pooled_allocations++;
+  } else {
+    allocation = base::AlignedAlloc(AllocationSizeForSizeClass(size_class),
+                                    MessageInTransit::kMessageAlignment);
+  }
+
+  *static_cast<uint32_t*>(allocation) = size_class;
+  return static_cast<char*>(allocation) + kPrefixSize;
+}
+
+void FreeMessageBuffer(void* buffer) {
+  if (!buffer)
+    return;
+
+  ThreadPool* pool = g_thread_pool_slot.Get().Get();
+  pool->stats.frees++;
+
+  void* allocation = static_cast<char*>(buffer) - kPrefixSize;
+  uint32_t size_class = *static_cast<uint32_t*>(allocation);
+  DCHECK_LE(size_class, kUnpooledSizeClass);
+  if (size_class == kUnpooledSizeClass ||
+      pool->free_lists[size_class].size() >= kMaxFreeBuffersPerSizeClass) {
+    base::AlignedFree(allocation);
+    return;
+  }
+
+  pool->free_lists[size_class].push_back(allocation);
+  pool->stats.pooled_frees++;
+}
+
+MessageBufferPoolStats GetMessageBufferPoolStatsForCurrentThread() {
+  return g_thread_pool_slot.Get().Get()->stats;
+}
+
+}  // namespace system
+}  // namespace mojo
@@ -0,0 +1,53 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Allocation of the buffers of |MessageInTransit|s (and their
+// |TransportData|s). Small buffers are recycled through per-thread free lists
+// of a few size classes instead of going back to the heap, since most messages
+// are small and short-lived: a message is typically allocated on the thread
+// that writes it and freed on the I/O thread once it has been written, and
+// vice versa for incoming messages.
+
+#ifndef MOJO_EDK_SYSTEM_MESSAGE_BUFFER_POOL_H_
+#define MOJO_EDK_SYSTEM_MESSAGE_BUFFER_POOL_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mojo/edk/system/system_impl_export.h"
+
+namespace mojo {
+namespace system {
+
+// Allocates a buffer of at least |size| bytes, aligned to
+// |MessageInTransit::kMessageAlignment|. Its contents are undefined. It must
+// be freed with |FreeMessageBuffer()|, on any thread.
+MOJO_SYSTEM_IMPL_EXPORT void* AllocMessageBuffer(size_t size);
+MOJO_SYSTEM_IMPL_EXPORT void FreeMessageBuffer(void* buffer);
+
+// For use with |scoped_ptr|.
+struct MessageBufferDeleter {
+  inline void operator()(void* buffer) const { FreeMessageBuffer(buffer); }
+};
+
+// Counts of the calls made on the current thread, for tests.
+struct MessageBufferPoolStats {
+  MessageBufferPoolStats()
+      : allocations(0), pooled_allocations(0), frees(0), pooled_frees(0) {}
+
+  uint64_t allocations;
+  // Allocations that were served from a free list.
+  uint64_t pooled_allocations;
+  uint64_t frees;
+  // Frees that put the buffer on a free list.
+  uint64_t pooled_frees;
+};
+
+MOJO_SYSTEM_IMPL_EXPORT MessageBufferPoolStats
+GetMessageBufferPoolStatsForCurrentThread();
+
+}  // namespace system
+}  // namespace mojo
+
+#endif  // MOJO_EDK_SYSTEM_MESSAGE_BUFFER_POOL_H_
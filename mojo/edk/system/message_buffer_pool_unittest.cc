@@ -0,0 +1,93 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/edk/system/message_buffer_pool.h"
+
+#include <stdint.h>
+#include <string.h>
+
+#include "mojo/edk/system/message_in_transit.h"
+#include "mojo/public/cpp/system/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+TEST(MessageBufferPoolTest, Alignment) {
+  static const size_t kSizes[] = {1, 8, 56, 57, 100, 4000, 5000, 100000};
+  for (size_t i = 0; i < MOJO_ARRAYSIZE(kSizes); i++) {
+    void* buffer = AllocMessageBuffer(kSizes[i]);
+    ASSERT_TRUE(buffer);
+    EXPECT_EQ(0u, reinterpret_cast<uintptr_t>(buffer) %
+                      MessageInTransit::kMessageAlignment);
+    // It should be entirely writable.
+    memset(buffer, 'x', kSizes[i]);
+    FreeMessageBuffer(buffer);
+  }
+}
+
+TEST(MessageBufferPoolTest, ReusesFreedBuffers) {
+  MessageBufferPoolStats before = GetMessageBufferPoolStatsForCurrentThread();
+
+  void* buffer1 = AllocMessageBuffer(100);
+  FreeMessageBuffer(buffer1);
+  // A buffer of the same size class should be the one just freed.
+  void* buffer2 = AllocMessageBuffer(80);
+  EXPECT_EQ(buffer1, buffer2);
+  FreeMessageBuffer(buffer2);
+
+  MessageBufferPoolStats after = GetMessageBufferPoolStatsForCurrentThread();
+  EXPECT_EQ(2u, after.allocations - before.allocations);
+  EXPECT_LE(1u, after.pooled_allocations - before.pooled_allocations);
+  EXPECT_EQ(2u, after.frees - before.frees);
+  EXPECT_EQ(2u, after.pooled_frees - before.pooled_frees);
+}
+
+TEST(MessageBufferPoolTest, LargeBuffersAreNotPooled) {
+  MessageBufferPoolStats before = GetMessageBufferPoolStatsForCurrentThread();
+
+  FreeMessageBuffer(AllocMessageBuffer(64 * 1024));
+  FreeMessageBuffer(AllocMessageBuffer(64 * 1024));
+
+  MessageBufferPoolStats after = GetMessageBufferPoolStatsForCurrentThread();
+  EXPECT_EQ(2u, after.allocations - before.allocations);
+  EXPECT_EQ(0u, after.pooled_allocations - before.pooled_allocations);
+  EXPECT_EQ(2u, after.frees - before.frees);
+  EXPECT_EQ(0u, after.pooled_frees - before.pooled_frees);
+}
+
+TEST(MessageBufferPoolTest, FreeListsAreBounded) {
+  static const size_t kNumBuffers = 1000;
+  void* buffers[kNumBuffers];
+  for (size_t i = 0; i < kNumBuffers; i++)
+    buffers[i] = AllocMessageBuffer(200);
+
+  MessageBufferPoolStats before = GetMessageBufferPoolStatsForCurrentThread();
+  for (size_t i = 0; i < kNumBuffers; i++)
+    FreeMessageBuffer(buffers[i]);
+  MessageBufferPoolStats after = GetMessageBufferPoolStatsForCurrentThread();
+
+  EXPECT_EQ(kNumBuffers, after.frees - before.frees);
+  EXPECT_LT(after.pooled_frees - before.pooled_frees, kNumBuffers);
+}
+
+TEST(MessageBufferPoolTest, Messages) {
+  MessageBufferPoolStats before = GetMessageBufferPoolStatsForCurrentThread();
+
+  for (int i = 0; i < 10; i++) {
+    MessageInTransit message(MessageInTransit::Type::ENDPOINT_CLIENT,
+                             MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA,
+                             16, "0123456789abcdef");
+    EXPECT_EQ(0, memcmp(message.bytes(), "0123456789abcdef", 16));
+  }
+
+  MessageBufferPoolStats after = GetMessageBufferPoolStatsForCurrentThread();
+  EXPECT_EQ(10u, after.allocations - before.allocations);
+  EXPECT_LE(9u, after.pooled_allocations - before.pooled_allocations);
+}
+
+}  // namespace
+}  // namespace system
+}  // namespace mojo
@@ -74,7 +74,8 @@ MessageInTransit::MessageInTransit(Type type,
                                    const void* bytes)
     : main_buffer_size_(RoundUpMessageAlignment(sizeof(Header) + num_bytes)),
       main_buffer_(static_cast<char*>(
-          base::AlignedAlloc(main_buffer_size_, kMessageAlignment))) {
+          AllocMessageBuffer(main_buffer_size_))),
+      is_latency_sensitive_(false) {
   ConstructorHelper(type, subtype, num_bytes);
   if (bytes) {
     memcpy(MessageInTransit::bytes(), bytes, num_bytes);
@@ -91,7 +92,8 @@ MessageInTransit::MessageInTransit(Type type,
                                    UserPointer<const void> bytes)
     : main_buffer_size_(RoundUpMessageAlignment(sizeof(Header) + num_bytes)),
       main_buffer_(static_cast<char*>(
-          base::AlignedAlloc(main_buffer_size_, kMessageAlignment))) {
+          AllocMessageBuffer(main_buffer_size_))),
+      is_latency_sensitive_(false) {
   ConstructorHelper(type, subtype, num_bytes);
   bytes.GetArray(MessageInTransit::bytes(), num_bytes);
   memset(static_cast<char*>(MessageInTransit::bytes()) + num_bytes, 0,
@@ -101,7 +103,8 @@ MessageInTransit::MessageInTransit(Type type,
 MessageInTransit::MessageInTransit(const View& message_view)
     : main_buffer_size_(message_view.main_buffer_size()),
       main_buffer_(static_cast<char*>(
-          base::AlignedAlloc(main_buffer_size_, kMessageAlignment))) {
+          AllocMessageBuffer(main_buffer_size_))),
+      is_latency_sensitive_(false) {
   DCHECK_GE(main_buffer_size_, sizeof(Header));
   DCHECK_EQ(main_buffer_size_ % kMessageAlignment, 0u);
 
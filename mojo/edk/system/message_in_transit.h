@@ -11,11 +11,11 @@
 #include <ostream>
 #include <vector>
 
-#include "base/memory/aligned_memory.h"
 #include "base/memory/scoped_ptr.h"
 #include "mojo/edk/system/channel_endpoint_id.h"
 #include "mojo/edk/system/dispatcher.h"
 #include "mojo/edk/system/memory.h"
+#include "mojo/edk/system/message_buffer_pool.h"
 #include "mojo/edk/system/system_impl_export.h"
 #include "mojo/public/cpp/system/macros.h"
 
@@ -67,6 +67,17 @@ class MOJO_SYSTEM_IMPL_EXPORT MessageInTransit {
     // Data pipe: consumer -> producer message that data was consumed. Payload
     // is |RemoteDataPipeAck|.
     ENDPOINT_CLIENT_DATA_PIPE_ACK = 1,
+    // Message pipe or data pipe data that was moved to a shared buffer, which
+    // is attached after any other dispatchers. Payload is the number of bytes
+    // of data (as a |uint32_t|, plus padding). Only seen by |ChannelEndpoint|,
+    // which turns it back into |ENDPOINT_CLIENT_DATA|.
+    ENDPOINT_CLIENT_SHARED_BUFFER_DATA = 2,
+    // Data pipe: producer -> consumer message that sets up a shared ring
+    // buffer, which is attached. Payload is |RemoteDataPipeRing|.
+    ENDPOINT_CLIENT_DATA_PIPE_RING = 3,
+    // Data pipe: producer -> consumer message that data was written to the
+    // shared ring buffer. Payload is |RemoteDataPipeRingData|.
+    ENDPOINT_CLIENT_DATA_PIPE_RING_DATA = 4,
     // Subtypes for type |Type::ENDPOINT|:
     // TODO(vtl): Nothing yet.
     // Subtypes for type |Type::CHANNEL|:
@@ -240,6 +251,14 @@ class MOJO_SYSTEM_IMPL_EXPORT MessageInTransit {
     return dispatchers_ && !dispatchers_->empty();
   }
 
+  // Latency-sensitive messages may be written ahead of other messages already
+  // queued on a |RawChannel| (see |RawChannel::EnqueueMessageNoLock()|). This
+  // isn't part of the message's serialized form.
+  bool is_latency_sensitive() const { return is_latency_sensitive_; }
+  void set_latency_sensitive(bool latency_sensitive) {
+    is_latency_sensitive_ = latency_sensitive;
+  }
+
   // Rounds |n| up to a multiple of |kMessageAlignment|.
   static inline size_t RoundUpMessageAlignment(size_t n) {
     return (n + kMessageAlignment - 1) & ~(kMessageAlignment - 1);
@@ -276,7 +295,7 @@ class MOJO_SYSTEM_IMPL_EXPORT MessageInTransit {
   void UpdateTotalSize();
 
   const size_t main_buffer_size_;
-  const scoped_ptr<char, base::AlignedFreeDeleter> main_buffer_;  // Never null.
+  const scoped_ptr<char, MessageBufferDeleter> main_buffer_;  // Never null.
 
   scoped_ptr<TransportData> transport_data_;  // May be null.
 
@@ -286,6 +305,8 @@ class MOJO_SYSTEM_IMPL_EXPORT MessageInTransit {
   // some reason.)
   scoped_ptr<DispatcherVector> dispatchers_;
 
+  bool is_latency_sensitive_;
+
   MOJO_DISALLOW_COPY_AND_ASSIGN(MessageInTransit);
 };
 
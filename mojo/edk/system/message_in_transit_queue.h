@@ -28,6 +28,10 @@ class MOJO_SYSTEM_IMPL_EXPORT MessageInTransitQueue {
   void AddMessage(scoped_ptr<MessageInTransit> message) {
     queue_.push_back(message.release());
   }
+  // |index| must be at most |Size()|; the message ends up at that index.
+  void InsertMessageAt(size_t index, scoped_ptr<MessageInTransit> message) {
+    queue_.insert(queue_.begin() + index, message.release());
+  }
 
   scoped_ptr<MessageInTransit> GetMessage() {
     MessageInTransit* rv = queue_.front();
@@ -37,6 +41,10 @@ class MOJO_SYSTEM_IMPL_EXPORT MessageInTransitQueue {
 
   const MessageInTransit* PeekMessage() const { return queue_.front(); }
   MessageInTransit* PeekMessage() { return queue_.front(); }
+  // |index| must be less than |Size()|; index 0 is the front message.
+  const MessageInTransit* PeekMessageAt(size_t index) const {
+    return queue_[index];
+  }
 
   void DiscardMessage() {
     delete queue_.front();
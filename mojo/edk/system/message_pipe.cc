@@ -149,12 +149,11 @@ MojoResult MessagePipe::WriteMessage(
   DCHECK(port == 0 || port == 1);
 
   base::AutoLock locker(lock_);
-  return EnqueueMessageNoLock(
-      GetPeerPort(port),
-      make_scoped_ptr(new MessageInTransit(
-          MessageInTransit::Type::ENDPOINT_CLIENT,
-          MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA, num_bytes, bytes)),
-      transports);
+  scoped_ptr<MessageInTransit> message(new MessageInTransit(
+      MessageInTransit::Type::ENDPOINT_CLIENT,
+      MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA, num_bytes, bytes));
+  message->set_latency_sensitive(latency_sensitive_[port]);
+  return EnqueueMessageNoLock(GetPeerPort(port), message.Pass(), transports);
 }
 
 MojoResult MessagePipe::ReadMessage(unsigned port,
@@ -172,6 +171,13 @@ MojoResult MessagePipe::ReadMessage(unsigned port,
                                        num_dispatchers, flags);
 }
 
+void MessagePipe::SetLatencySensitive(unsigned port, bool latency_sensitive) {
+  DCHECK(port == 0 || port == 1);
+
+  base::AutoLock locker(lock_);
+  latency_sensitive_[port] = latency_sensitive;
+}
+
 HandleSignalsState MessagePipe::GetHandleSignalsState(unsigned port) const {
   DCHECK(port == 0 || port == 1);
 
@@ -261,7 +267,7 @@ bool MessagePipe::EndSerialize(
     scoped_refptr<ChannelEndpoint> peer_channel_endpoint =
         peer_endpoint->ReleaseChannelEndpoint();
     channel->SerializeEndpointWithRemotePeer(destination, message_queue,
-                                             peer_channel_endpoint);
+                                             peer_channel_endpoint, nullptr);
     // No need to call |Close()| after |ReleaseChannelEndpoint()|.
     endpoints_[peer_port].reset();
   }
@@ -301,6 +307,8 @@ void MessagePipe::OnDetachFromChannel(unsigned port) {
 }
 
 MessagePipe::MessagePipe() {
+  latency_sensitive_[0] = false;
+  latency_sensitive_[1] = false;
 }
 
 MessagePipe::~MessagePipe() {
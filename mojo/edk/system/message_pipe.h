@@ -96,6 +96,10 @@ class MOJO_SYSTEM_IMPL_EXPORT MessagePipe final : public ChannelEndpointClient {
                          DispatcherVector* dispatchers,
                          uint32_t* num_dispatchers,
                          MojoReadMessageFlags flags);
+  // Marks messages written to |port| from now on as latency sensitive (see
+  // |MessageInTransit::is_latency_sensitive()|). This only matters once the
+  // peer is proxied through a channel.
+  void SetLatencySensitive(unsigned port, bool latency_sensitive);
   HandleSignalsState GetHandleSignalsState(unsigned port) const;
   MojoResult AddAwakable(unsigned port,
                          Awakable* awakable,
@@ -138,6 +142,7 @@ class MOJO_SYSTEM_IMPL_EXPORT MessagePipe final : public ChannelEndpointClient {
 
   base::Lock lock_;  // Protects the following members.
   scoped_ptr<MessagePipeEndpoint> endpoints_[2];
+  bool latency_sensitive_[2];
 
   MOJO_DISALLOW_COPY_AND_ASSIGN(MessagePipe);
 };
@@ -66,6 +66,14 @@ Dispatcher::Type MessagePipeDispatcher::GetType() const {
   return Type::MESSAGE_PIPE;
 }
 
+MojoResult MessagePipeDispatcher::SetLatencySensitive(bool latency_sensitive) {
+  MutexLocker locker(&mutex());
+  if (!message_pipe_)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+  message_pipe_->SetLatencySensitive(port_, latency_sensitive);
+  return MOJO_RESULT_OK;
+}
+
 // static
 scoped_refptr<MessagePipeDispatcher>
 MessagePipeDispatcher::CreateRemoteMessagePipe(
@@ -192,6 +200,23 @@ void MessagePipeDispatcher::RemoveAwakableImplNoLock(
   message_pipe_->RemoveAwakable(port_, awakable, signals_state);
 }
 
+MojoResult MessagePipeDispatcher::CheckSignalsImplNoLock(
+    MojoHandleSignals signals,
+    HandleSignalsState* signals_state) const {
+  mutex().AssertHeld();
+  // The endpoint of our port is always local, and a local endpoint adds an
+  // awakable exactly when its state neither satisfies |signals| nor rules
+  // them out.
+  HandleSignalsState state = message_pipe_->GetHandleSignalsState(port_);
+  if (signals_state)
+    *signals_state = state;
+  if (state.satisfies(signals))
+    return MOJO_RESULT_ALREADY_EXISTS;
+  if (!state.can_satisfy(signals))
+    return MOJO_RESULT_FAILED_PRECONDITION;
+  return MOJO_RESULT_OK;
+}
+
 void MessagePipeDispatcher::StartSerializeImplNoLock(
     Channel* channel,
     size_t* max_size,
@@ -48,6 +48,10 @@ class MOJO_SYSTEM_IMPL_EXPORT MessagePipeDispatcher final : public Dispatcher {
   // |Dispatcher| public methods:
   Type GetType() const override;
 
+  // See |MessagePipe::SetLatencySensitive()|. Returns
+  // |MOJO_RESULT_INVALID_ARGUMENT| if this dispatcher has been closed.
+  MojoResult SetLatencySensitive(bool latency_sensitive);
+
   // Creates a |MessagePipe| with a local endpoint (at port 0) and a proxy
   // endpoint, and creates/initializes a |MessagePipeDispatcher| (attached to
   // the message pipe, port 0).
@@ -98,6 +102,9 @@ class MOJO_SYSTEM_IMPL_EXPORT MessagePipeDispatcher final : public Dispatcher {
                                    HandleSignalsState* signals_state) override;
   void RemoveAwakableImplNoLock(Awakable* awakable,
                                 HandleSignalsState* signals_state) override;
+  MojoResult CheckSignalsImplNoLock(
+      MojoHandleSignals signals,
+      HandleSignalsState* signals_state) const override;
   void StartSerializeImplNoLock(Channel* channel,
                                 size_t* max_size,
                                 size_t* max_platform_handles) override
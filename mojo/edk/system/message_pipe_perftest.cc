@@ -17,6 +17,7 @@
 #include "mojo/edk/embedder/scoped_platform_handle.h"
 #include "mojo/edk/system/channel.h"
 #include "mojo/edk/system/local_message_pipe_endpoint.h"
+#include "mojo/edk/system/message_buffer_pool.h"
 #include "mojo/edk/system/message_pipe.h"
 #include "mojo/edk/system/message_pipe_test_utils.h"
 #include "mojo/edk/system/proxy_message_pipe_endpoint.h"
@@ -71,12 +72,21 @@ class MultiprocessMessagePipePerfTest
     std::string test_name =
         base::StringPrintf("IPC_Perf_%dx_%u", message_count_,
                            static_cast<unsigned>(message_size_));
+    MessageBufferPoolStats before = GetMessageBufferPoolStatsForCurrentThread();
     base::PerfTimeLogger logger(test_name.c_str());
 
     for (int i = 0; i < message_count_; ++i)
       WriteWaitThenRead(mp);
 
     logger.Done();
+
+    // Outgoing messages are allocated on this thread and incoming ones are
+    // freed on it, so nearly all allocations should come from the pool.
+    MessageBufferPoolStats after = GetMessageBufferPoolStatsForCurrentThread();
+    printf("%s: %u of %u message buffers pooled\n", test_name.c_str(),
+           static_cast<unsigned>(after.pooled_allocations -
+                                 before.pooled_allocations),
+           static_cast<unsigned>(after.allocations - before.allocations));
   }
 
  private:
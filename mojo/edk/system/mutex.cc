@@ -1,16 +1,22 @@
-// Copyright 2014 The Chromium Authors. All rights reserved.
+// Copyright 2015 The Chromium Authors. All rights reserved.
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
 #include "mojo/edk/system/mutex.h"
 
-#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+#if !defined(OS_WIN)
+#include <string.h>
+#endif
 
 #include "base/logging.h"
 
 namespace mojo {
 namespace system {
 
+// Mutex -----------------------------------------------------------------------
+
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+
 Mutex::Mutex() : lock_() {
 }
 
@@ -32,7 +38,97 @@ void Mutex::CheckUnheldAndMark() {
   owning_thread_ref_ = base::PlatformThread::CurrentRef();
 }
 
-}  // namespace system
-}  // namespace mojo
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+
+// RWMutex ---------------------------------------------------------------------
+
+#if defined(OS_WIN)
+
+RWMutex::RWMutex() {
+  InitializeSRWLock(&lock_);
+}
+
+RWMutex::~RWMutex() {
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+  DCHECK(owning_thread_ref_.is_null());
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+  // SRW locks need no cleanup.
+}
 
+void RWMutex::Lock() {
+  AcquireSRWLockExclusive(&lock_);
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+  DCHECK(owning_thread_ref_.is_null());
+  owning_thread_ref_ = base::PlatformThread::CurrentRef();
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+}
+
+void RWMutex::Unlock() {
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+  DCHECK(owning_thread_ref_ == base::PlatformThread::CurrentRef());
+  owning_thread_ref_ = base::PlatformThreadRef();
 #endif  // !NDEBUG || DCHECK_ALWAYS_ON
+  ReleaseSRWLockExclusive(&lock_);
+}
+
+void RWMutex::LockShared() {
+  AcquireSRWLockShared(&lock_);
+}
+
+void RWMutex::UnlockShared() {
+  ReleaseSRWLockShared(&lock_);
+}
+
+#else  // !defined(OS_WIN)
+
+RWMutex::RWMutex() {
+  int rv = pthread_rwlock_init(&lock_, nullptr);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+RWMutex::~RWMutex() {
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+  DCHECK(owning_thread_ref_.is_null());
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+  int rv = pthread_rwlock_destroy(&lock_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+void RWMutex::Lock() {
+  int rv = pthread_rwlock_wrlock(&lock_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+  DCHECK(owning_thread_ref_.is_null());
+  owning_thread_ref_ = base::PlatformThread::CurrentRef();
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+}
+
+void RWMutex::Unlock() {
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+  DCHECK(owning_thread_ref_ == base::PlatformThread::CurrentRef());
+  owning_thread_ref_ = base::PlatformThreadRef();
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+  int rv = pthread_rwlock_unlock(&lock_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+void RWMutex::LockShared() {
+  int rv = pthread_rwlock_rdlock(&lock_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+void RWMutex::UnlockShared() {
+  int rv = pthread_rwlock_unlock(&lock_);
+  DCHECK_EQ(rv, 0) << ". " << strerror(rv);
+}
+
+#endif  // defined(OS_WIN)
+
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+void RWMutex::AssertHeld() const {
+  DCHECK(owning_thread_ref_ == base::PlatformThread::CurrentRef());
+}
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+
+}  // namespace system
+}  // namespace mojo
@@ -2,16 +2,24 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-// A mutex class, with support for thread annotations.
+// Mutex classes, with support for thread annotations.
 //
-// TODO(vtl): Currently, this is a fork of Chromium's
+// TODO(vtl): Currently, |Mutex| is a fork of Chromium's
 // base/synchronization/lock.h (with names changed and minor modifications; it
 // still cheats and uses Chromium's lock_impl.*), but eventually we'll want our
-// own and, e.g., add support for non-exclusive (reader) locks.
+// own.
 
 #ifndef MOJO_EDK_SYSTEM_MUTEX_H_
 #define MOJO_EDK_SYSTEM_MUTEX_H_
 
+#include "build/build_config.h"
+
+#if defined(OS_WIN)
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
 #include "base/synchronization/lock_impl.h"
 #include "base/threading/platform_thread.h"
 #include "mojo/edk/system/system_impl_export.h"
@@ -71,6 +79,44 @@ class MOJO_SYSTEM_IMPL_EXPORT MOJO_LOCKABLE Mutex {
   MOJO_DISALLOW_COPY_AND_ASSIGN(Mutex);
 };
 
+// RWMutex ---------------------------------------------------------------------
+
+// A reader-writer mutex: it may be held by any number of readers at once
+// (|LockShared()|), or by a single writer (|Lock()|). It is not recursive, and
+// a reader may not upgrade to a writer.
+class MOJO_SYSTEM_IMPL_EXPORT MOJO_LOCKABLE RWMutex {
+ public:
+  RWMutex();
+  ~RWMutex();
+
+  void Lock() MOJO_EXCLUSIVE_LOCK_FUNCTION();
+  void Unlock() MOJO_UNLOCK_FUNCTION();
+
+  void LockShared() MOJO_SHARED_LOCK_FUNCTION();
+  void UnlockShared() MOJO_UNLOCK_FUNCTION();
+
+#if defined(NDEBUG) && !defined(DCHECK_ALWAYS_ON)
+  void AssertHeld() const MOJO_ASSERT_EXCLUSIVE_LOCK() {}
+#else
+  // Only checks that the current thread holds the mutex when it holds it
+  // exclusively; readers are not tracked.
+  void AssertHeld() const MOJO_ASSERT_EXCLUSIVE_LOCK();
+#endif  // NDEBUG && !DCHECK_ALWAYS_ON
+
+ private:
+#if !defined(NDEBUG) || defined(DCHECK_ALWAYS_ON)
+  base::PlatformThreadRef owning_thread_ref_;
+#endif  // !NDEBUG || DCHECK_ALWAYS_ON
+
+#if defined(OS_WIN)
+  SRWLOCK lock_;
+#else
+  pthread_rwlock_t lock_;
+#endif
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(RWMutex);
+};
+
 // MutexLocker -----------------------------------------------------------------
 
 class MOJO_SYSTEM_IMPL_EXPORT MOJO_SCOPED_LOCKABLE MutexLocker {
@@ -87,6 +133,39 @@ class MOJO_SYSTEM_IMPL_EXPORT MOJO_SCOPED_LOCKABLE MutexLocker {
   MOJO_DISALLOW_COPY_AND_ASSIGN(MutexLocker);
 };
 
+// WriterMutexLocker and ReaderMutexLocker -------------------------------------
+
+class MOJO_SYSTEM_IMPL_EXPORT MOJO_SCOPED_LOCKABLE WriterMutexLocker {
+ public:
+  explicit WriterMutexLocker(RWMutex* mutex)
+      MOJO_EXCLUSIVE_LOCK_FUNCTION(mutex)
+      : mutex_(mutex) {
+    this->mutex_->Lock();
+  }
+  ~WriterMutexLocker() MOJO_UNLOCK_FUNCTION() { this->mutex_->Unlock(); }
+
+ private:
+  RWMutex* const mutex_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(WriterMutexLocker);
+};
+
+class MOJO_SYSTEM_IMPL_EXPORT MOJO_SCOPED_LOCKABLE ReaderMutexLocker {
+ public:
+  explicit ReaderMutexLocker(RWMutex* mutex) MOJO_SHARED_LOCK_FUNCTION(mutex)
+      : mutex_(mutex) {
+    this->mutex_->LockShared();
+  }
+  ~ReaderMutexLocker() MOJO_UNLOCK_FUNCTION() {
+    this->mutex_->UnlockShared();
+  }
+
+ private:
+  RWMutex* const mutex_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(ReaderMutexLocker);
+};
+
 }  // namespace system
 }  // namespace mojo
 
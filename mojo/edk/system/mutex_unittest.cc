@@ -245,6 +245,116 @@ TEST(MutexTest, MutexLocker) {
   mutex.Unlock();
 }
 
+// Tests that writers exclude each other ---------------------------------------
+
+class RWMutexWriterTestThread : public base::PlatformThread::Delegate {
+ public:
+  RWMutexWriterTestThread(RWMutex* mutex, int* value)
+      : mutex_(mutex), value_(value) {}
+
+  // Static helper which can also be called from the main thread.
+  static void DoStuff(RWMutex* mutex, int* value) {
+    for (int i = 0; i < 40; i++) {
+      WriterMutexLocker locker(mutex);
+      mutex->AssertHeld();
+      int v = *value;
+      EpsilonRandomSleep();
+      *value = v + 1;
+    }
+  }
+
+  void ThreadMain() override { DoStuff(mutex_, value_); }
+
+ private:
+  RWMutex* mutex_;
+  int* value_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(RWMutexWriterTestThread);
+};
+
+TEST(MutexTest, RWMutexFourWriters) {
+  RWMutex mutex;
+  int value = 0;
+
+  RWMutexWriterTestThread thread1(&mutex, &value);
+  RWMutexWriterTestThread thread2(&mutex, &value);
+  RWMutexWriterTestThread thread3(&mutex, &value);
+  base::PlatformThreadHandle handle1;
+  base::PlatformThreadHandle handle2;
+  base::PlatformThreadHandle handle3;
+
+  ASSERT_TRUE(base::PlatformThread::Create(0, &thread1, &handle1));
+  ASSERT_TRUE(base::PlatformThread::Create(0, &thread2, &handle2));
+  ASSERT_TRUE(base::PlatformThread::Create(0, &thread3, &handle3));
+
+  RWMutexWriterTestThread::DoStuff(&mutex, &value);
+
+  base::PlatformThread::Join(handle1);
+  base::PlatformThread::Join(handle2);
+  base::PlatformThread::Join(handle3);
+
+  EXPECT_EQ(4 * 40, value);
+}
+
+// Tests that readers share ----------------------------------------------------
+
+class RWMutexReaderTestThread : public base::PlatformThread::Delegate {
+ public:
+  RWMutexReaderTestThread(RWMutex* mutex, const int* value)
+      : mutex_(mutex), value_(value), read_value_(-1) {}
+
+  void ThreadMain() override {
+    ReaderMutexLocker locker(mutex_);
+    read_value_ = *value_;
+  }
+
+  int read_value() const { return read_value_; }
+
+ private:
+  RWMutex* mutex_;
+  const int* value_;
+  int read_value_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(RWMutexReaderTestThread);
+};
+
+TEST(MutexTest, RWMutexReadersShare) {
+  RWMutex mutex;
+  int value = 123;
+
+  // With the main thread holding the mutex shared, another reader can still
+  // get it (otherwise joining it would deadlock).
+  ReaderMutexLocker locker(&mutex);
+  RWMutexReaderTestThread thread(&mutex, &value);
+  base::PlatformThreadHandle handle;
+
+  ASSERT_TRUE(base::PlatformThread::Create(0, &thread, &handle));
+
+  base::PlatformThread::Join(handle);
+
+  EXPECT_EQ(123, thread.read_value());
+}
+
+TEST(MutexTest, RWMutexLockers) {
+  RWMutex mutex;
+
+  {
+    WriterMutexLocker locker(&mutex);
+    mutex.AssertHeld();
+  }
+
+  // The destruction of |locker| should unlock |mutex|, for readers...
+  {
+    ReaderMutexLocker locker1(&mutex);
+    ReaderMutexLocker locker2(&mutex);
+  }
+
+  // ... and for writers.
+  mutex.Lock();
+  mutex.AssertHeld();
+  mutex.Unlock();
+}
+
 }  // namespace
 }  // namespace system
 }  // namespace mojo
@@ -0,0 +1,124 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/edk/system/perftest_utils.h"
+
+#include <vector>
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "mojo/edk/embedder/platform_channel_pair.h"
+#include "mojo/edk/system/channel.h"
+#include "mojo/edk/system/channel_endpoint.h"
+#include "mojo/edk/system/dispatcher.h"
+#include "mojo/edk/system/message_pipe.h"
+#include "mojo/edk/system/raw_channel.h"
+#include "mojo/edk/system/test_utils.h"
+#include "mojo/edk/system/waiter.h"
+#include "testing/perf/perf_test.h"
+
+namespace mojo {
+namespace system {
+namespace test {
+
+void PrintPerfResult(const std::string& benchmark,
+                     const std::string& variant,
+                     double value,
+                     const std::string& units) {
+  perf_test::PrintResult(benchmark, std::string(), variant, value, units, true);
+}
+
+MojoResult WaitForSignals(Dispatcher* dispatcher, MojoHandleSignals signals) {
+  Waiter waiter;
+  waiter.Init();
+  MojoResult rv = dispatcher->AddAwakable(&waiter, signals, 0, nullptr);
+  if (rv == MOJO_RESULT_ALREADY_EXISTS)
+    return MOJO_RESULT_OK;
+  if (rv != MOJO_RESULT_OK)
+    return rv;
+  rv = waiter.Wait(MOJO_DEADLINE_INDEFINITE, nullptr);
+  dispatcher->RemoveAwakable(&waiter, nullptr);
+  return rv;
+}
+
+RemoteMessagePipe::RemoteMessagePipe()
+    : io_thread_(base::TestIOThread::kAutoStart) {
+  scoped_refptr<ChannelEndpoint> ep[2];
+  message_pipes_[0] = MessagePipe::CreateLocalProxy(&ep[0]);
+  message_pipes_[1] = MessagePipe::CreateLocalProxy(&ep[1]);
+  io_thread_.PostTaskAndWait(
+      FROM_HERE, base::Bind(&RemoteMessagePipe::SetUpOnIOThread,
+                            base::Unretained(this), ep[0], ep[1]));
+}
+
+RemoteMessagePipe::~RemoteMessagePipe() {
+  message_pipes_[0]->Close(0);
+  message_pipes_[1]->Close(0);
+  io_thread_.PostTaskAndWait(
+      FROM_HERE, base::Bind(&RemoteMessagePipe::TearDownOnIOThread,
+                            base::Unretained(this)));
+}
+
+scoped_refptr<Dispatcher> RemoteMessagePipe::SendDispatcher(
+    scoped_refptr<Dispatcher> dispatcher) {
+  {
+    DispatcherTransport transport(
+        test::DispatcherTryStartTransport(dispatcher.get()));
+    CHECK(transport.is_valid());
+    std::vector<DispatcherTransport> transports;
+    transports.push_back(transport);
+    CHECK_EQ(message_pipes_[0]->WriteMessage(0, NullUserPointer(), 0,
+                                             &transports,
+                                             MOJO_WRITE_MESSAGE_FLAG_NONE),
+             MOJO_RESULT_OK);
+    transport.End();
+  }
+  dispatcher = nullptr;
+
+  Waiter waiter;
+  waiter.Init();
+  if (message_pipes_[1]->AddAwakable(0, &waiter, MOJO_HANDLE_SIGNAL_READABLE,
+                                     0, nullptr) == MOJO_RESULT_OK) {
+    CHECK_EQ(waiter.Wait(MOJO_DEADLINE_INDEFINITE, nullptr), MOJO_RESULT_OK);
+    message_pipes_[1]->RemoveAwakable(0, &waiter, nullptr);
+  }
+
+  uint32_t num_bytes = 0;
+  DispatcherVector dispatchers;
+  uint32_t num_dispatchers = 1;
+  CHECK_EQ(message_pipes_[1]->ReadMessage(
+               0, NullUserPointer(), MakeUserPointer(&num_bytes), &dispatchers,
+               &num_dispatchers, MOJO_READ_MESSAGE_FLAG_NONE),
+           MOJO_RESULT_OK);
+  CHECK_EQ(dispatchers.size(), 1u);
+  return dispatchers[0];
+}
+
+void RemoteMessagePipe::SetUpOnIOThread(scoped_refptr<ChannelEndpoint> ep0,
+                                        scoped_refptr<ChannelEndpoint> ep1) {
+  CHECK_EQ(base::MessageLoop::current(), io_thread_.message_loop());
+
+  embedder::PlatformChannelPair channel_pair;
+  channels_[0] = new Channel(&platform_support_);
+  channels_[0]->Init(RawChannel::Create(channel_pair.PassServerHandle()));
+  channels_[0]->SetBootstrapEndpoint(ep0);
+  channels_[1] = new Channel(&platform_support_);
+  channels_[1]->Init(RawChannel::Create(channel_pair.PassClientHandle()));
+  channels_[1]->SetBootstrapEndpoint(ep1);
+}
+
+void RemoteMessagePipe::TearDownOnIOThread() {
+  CHECK_EQ(base::MessageLoop::current(), io_thread_.message_loop());
+
+  channels_[0]->Shutdown();
+  channels_[0] = nullptr;
+  channels_[1]->Shutdown();
+  channels_[1] = nullptr;
+}
+
+}  // namespace test
+}  // namespace system
+}  // namespace mojo
@@ -0,0 +1,72 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MOJO_EDK_SYSTEM_PERFTEST_UTILS_H_
+#define MOJO_EDK_SYSTEM_PERFTEST_UTILS_H_
+
+#include <string>
+
+#include "base/memory/ref_counted.h"
+#include "base/test/test_io_thread.h"
+#include "mojo/edk/embedder/simple_platform_support.h"
+#include "mojo/public/c/system/types.h"
+#include "mojo/public/cpp/system/macros.h"
+
+namespace mojo {
+namespace system {
+
+class Channel;
+class ChannelEndpoint;
+class Dispatcher;
+class MessagePipe;
+
+namespace test {
+
+// Prints a result in the "*RESULT" format that the performance dashboards
+// parse, e.g., "*RESULT DataPipe_Throughput: local_e1_c65536= 1234 MB/s".
+void PrintPerfResult(const std::string& benchmark,
+                     const std::string& variant,
+                     double value,
+                     const std::string& units);
+
+// Waits until |dispatcher| satisfies |signals|, or never can. Returns the
+// result of the wait (e.g., |MOJO_RESULT_OK| or
+// |MOJO_RESULT_FAILED_PRECONDITION|).
+MojoResult WaitForSignals(Dispatcher* dispatcher, MojoHandleSignals signals);
+
+// A message pipe that goes through a pair of |Channel|s (connected within the
+// process), so that what is sent over it is treated as though it were going
+// to another process.
+class RemoteMessagePipe {
+ public:
+  RemoteMessagePipe();
+  ~RemoteMessagePipe();
+
+  // Sends |dispatcher| (which must have no other references) over the message
+  // pipe and returns what arrives at the other end.
+  scoped_refptr<Dispatcher> SendDispatcher(
+      scoped_refptr<Dispatcher> dispatcher);
+
+  scoped_refptr<MessagePipe> message_pipe(unsigned i) {
+    return message_pipes_[i];
+  }
+
+ private:
+  void SetUpOnIOThread(scoped_refptr<ChannelEndpoint> ep0,
+                       scoped_refptr<ChannelEndpoint> ep1);
+  void TearDownOnIOThread();
+
+  embedder::SimplePlatformSupport platform_support_;
+  base::TestIOThread io_thread_;
+  scoped_refptr<Channel> channels_[2];
+  scoped_refptr<MessagePipe> message_pipes_[2];
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(RemoteMessagePipe);
+};
+
+}  // namespace test
+}  // namespace system
+}  // namespace mojo
+
+#endif  // MOJO_EDK_SYSTEM_PERFTEST_UTILS_H_
@@ -18,28 +18,120 @@
 namespace mojo {
 namespace system {
 
-const size_t kReadSize = 4096;
+namespace {
+
+// Reads start out at |kMinReadSize| bytes, and double (up to |kMaxReadSize|
+// bytes) each time a read fills the area it was given.
+const size_t kMinReadSize = 4096;
+const size_t kMaxReadSize = 64 * 1024;
+
+// The number of reads that |OnReadCompleted()| may do before it goes back to
+// the message loop, so that one busy channel doesn't starve the others.
+const int kMaxReadsPerWakeUp = 4;
+
+// Messages after the front one are only added to a write while the write is
+// smaller than this.
+const size_t kMaxBytesToGather = 64 * 1024;
+
+// Returns true if the latency-sensitive |message| may be written before
+// |queued|. It may only overtake other pipes' bulk data: messages for the same
+// endpoint keep their order, and control messages and messages carrying
+// handles can set up endpoints that later messages depend on.
+bool CanOvertake(const MessageInTransit* message,
+                 const MessageInTransit* queued) {
+  return !queued->is_latency_sensitive() &&
+         queued->type() == MessageInTransit::Type::ENDPOINT_CLIENT &&
+         !queued->transport_data() &&
+         queued->source_id() != message->source_id();
+}
+
+// Appends the buffers for the part of |message| from |offset| on.
+void AppendMessageBuffers(const MessageInTransit* message,
+                          size_t offset,
+                          std::vector<RawChannel::WriteBuffer::Buffer>* buffers) {
+  DCHECK_LT(offset, message->total_size());
+  size_t bytes_to_write = message->total_size() - offset;
+
+  size_t transport_data_buffer_size =
+      message->transport_data() ? message->transport_data()->buffer_size() : 0;
+
+  if (!transport_data_buffer_size) {
+    // Only write from the main buffer.
+    DCHECK_LT(offset, message->main_buffer_size());
+    DCHECK_LE(bytes_to_write, message->main_buffer_size());
+    RawChannel::WriteBuffer::Buffer buffer = {
+        static_cast<const char*>(message->main_buffer()) + offset,
+        bytes_to_write};
+    buffers->push_back(buffer);
+    return;
+  }
+
+  if (offset >= message->main_buffer_size()) {
+    // Only write from the transport data buffer.
+    DCHECK_LT(offset - message->main_buffer_size(),
+              transport_data_buffer_size);
+    DCHECK_LE(bytes_to_write, transport_data_buffer_size);
+    RawChannel::WriteBuffer::Buffer buffer = {
+        static_cast<const char*>(message->transport_data()->buffer()) +
+            (offset - message->main_buffer_size()),
+        bytes_to_write};
+    buffers->push_back(buffer);
+    return;
+  }
+
+  // Write from both buffers.
+  DCHECK_EQ(bytes_to_write, message->main_buffer_size() - offset +
+                                transport_data_buffer_size);
+  RawChannel::WriteBuffer::Buffer buffer1 = {
+      static_cast<const char*>(message->main_buffer()) + offset,
+      message->main_buffer_size() - offset};
+  buffers->push_back(buffer1);
+  RawChannel::WriteBuffer::Buffer buffer2 = {
+      static_cast<const char*>(message->transport_data()->buffer()),
+      transport_data_buffer_size};
+  buffers->push_back(buffer2);
+}
+
+bool HasPlatformHandles(const MessageInTransit* message) {
+  const TransportData* transport_data = message->transport_data();
+  return transport_data && transport_data->platform_handles() &&
+         !transport_data->platform_handles()->empty();
+}
+
+}  // namespace
 
 // RawChannel::ReadBuffer ------------------------------------------------------
 
-RawChannel::ReadBuffer::ReadBuffer() : buffer_(kReadSize), num_valid_bytes_(0) {
+RawChannel::ReadBuffer::ReadBuffer()
+    : buffer_(kMinReadSize), num_valid_bytes_(0), read_size_(kMinReadSize) {
 }
 
 RawChannel::ReadBuffer::~ReadBuffer() {
 }
 
 void RawChannel::ReadBuffer::GetBuffer(char** addr, size_t* size) {
-  DCHECK_GE(buffer_.size(), num_valid_bytes_ + kReadSize);
+  DCHECK_GE(buffer_.size(), num_valid_bytes_ + read_size_);
   *addr = &buffer_[0] + num_valid_bytes_;
-  *size = kReadSize;
+  *size = read_size_;
+}
+
+void RawChannel::ReadBuffer::DidRead(size_t bytes_read) {
+  // Only grow: a channel that was busy once is likely to be busy again, and
+  // the buffer's memory is kept around anyway.
+  if (bytes_read >= read_size_)
+    read_size_ = std::min(read_size_ * 2, kMaxReadSize);
 }
 
 // RawChannel::WriteBuffer -----------------------------------------------------
 
+// static
+const size_t RawChannel::WriteBuffer::kMaxBufferCount;
+
 RawChannel::WriteBuffer::WriteBuffer(size_t serialized_platform_handle_size)
     : serialized_platform_handle_size_(serialized_platform_handle_size),
       platform_handles_offset_(0),
-      data_offset_(0) {
+      data_offset_(0),
+      num_messages_in_write_(0) {
 }
 
 RawChannel::WriteBuffer::~WriteBuffer() {
@@ -95,58 +187,30 @@ void RawChannel::WriteBuffer::GetPlatformHandlesToSend(
   }
 }
 
-void RawChannel::WriteBuffer::GetBuffers(std::vector<Buffer>* buffers) const {
+void RawChannel::WriteBuffer::GetBuffers(std::vector<Buffer>* buffers) {
   buffers->clear();
+  num_messages_in_write_ = 0;
 
   if (message_queue_.IsEmpty())
     return;
 
   const MessageInTransit* message = message_queue_.PeekMessage();
-  DCHECK_LT(data_offset_, message->total_size());
+  AppendMessageBuffers(message, data_offset_, buffers);
   size_t bytes_to_write = message->total_size() - data_offset_;
-
-  size_t transport_data_buffer_size =
-      message->transport_data() ? message->transport_data()->buffer_size() : 0;
-
-  if (!transport_data_buffer_size) {
-    // Only write from the main buffer.
-    DCHECK_LT(data_offset_, message->main_buffer_size());
-    DCHECK_LE(bytes_to_write, message->main_buffer_size());
-    Buffer buffer = {
-        static_cast<const char*>(message->main_buffer()) + data_offset_,
-        bytes_to_write};
-    buffers->push_back(buffer);
-    return;
-  }
-
-  if (data_offset_ >= message->main_buffer_size()) {
-    // Only write from the transport data buffer.
-    DCHECK_LT(data_offset_ - message->main_buffer_size(),
-              transport_data_buffer_size);
-    DCHECK_LE(bytes_to_write, transport_data_buffer_size);
-    Buffer buffer = {
-        static_cast<const char*>(message->transport_data()->buffer()) +
-            (data_offset_ - message->main_buffer_size()),
-        bytes_to_write};
-    buffers->push_back(buffer);
-    return;
+  num_messages_in_write_ = 1;
+
+  // Each message takes at most two buffers.
+  for (size_t i = 1; i < message_queue_.Size() &&
+                     buffers->size() + 2 <= kMaxBufferCount &&
+                     bytes_to_write < kMaxBytesToGather;
+       i++) {
+    message = message_queue_.PeekMessageAt(i);
+    if (HasPlatformHandles(message))
+      break;
+    AppendMessageBuffers(message, 0, buffers);
+    bytes_to_write += message->total_size();
+    num_messages_in_write_++;
   }
-
-  // TODO(vtl): We could actually send out buffers from multiple messages, with
-  // the "stopping" condition being reaching a message with platform handles
-  // attached.
-
-  // Write from both buffers.
-  DCHECK_EQ(bytes_to_write, message->main_buffer_size() - data_offset_ +
-                                transport_data_buffer_size);
-  Buffer buffer1 = {
-      static_cast<const char*>(message->main_buffer()) + data_offset_,
-      message->main_buffer_size() - data_offset_};
-  buffers->push_back(buffer1);
-  Buffer buffer2 = {
-      static_cast<const char*>(message->transport_data()->buffer()),
-      transport_data_buffer_size};
-  buffers->push_back(buffer2);
 }
 
 // RawChannel ------------------------------------------------------------------
@@ -267,9 +331,10 @@ void RawChannel::OnReadCompleted(IOResult io_result, size_t bytes_read) {
 
   // Keep reading data in a loop, and dispatch messages if enough data is
   // received. Exit the loop if any of the following happens:
-  //   - one or more messages were dispatched;
+  //   - |kMaxReadsPerWakeUp| reads were done;
   //   - the last read failed, was a partial read or would block;
   //   - |Shutdown()| was called.
+  int reads = 0;
   do {
     switch (io_result) {
       case IO_SUCCEEDED:
@@ -285,9 +350,11 @@ void RawChannel::OnReadCompleted(IOResult io_result, size_t bytes_read) {
     }
 
     read_buffer_->num_valid_bytes_ += bytes_read;
+    const bool filled_read_buffer = bytes_read >= read_buffer_->read_size_;
+    read_buffer_->DidRead(bytes_read);
+    reads++;
 
     // Dispatch all the messages that we can.
-    bool did_dispatch_message = false;
     // Tracks the offset of the first undispatched message in |read_buffer_|.
     // Currently, we copy data to ensure that this is zero at the beginning.
     size_t read_buffer_start = 0;
@@ -359,8 +426,6 @@ void RawChannel::OnReadCompleted(IOResult io_result, size_t bytes_read) {
         set_on_shutdown_ = nullptr;
       }
 
-      did_dispatch_message = true;
-
       // Update our state.
       read_buffer_start += message_size;
       remaining_bytes -= message_size;
@@ -376,29 +441,31 @@ void RawChannel::OnReadCompleted(IOResult io_result, size_t bytes_read) {
       read_buffer_start = 0;
     }
 
+    const size_t read_size = read_buffer_->read_size_;
     if (read_buffer_->buffer_.size() - read_buffer_->num_valid_bytes_ <
-        kReadSize) {
+        read_size) {
       // Use power-of-2 buffer sizes.
       // TODO(vtl): Make sure the buffer doesn't get too large (and enforce the
       // maximum message size to whatever extent necessary).
       // TODO(vtl): We may often be able to peek at the header and get the real
-      // required extra space (which may be much bigger than |kReadSize|).
-      size_t new_size = std::max(read_buffer_->buffer_.size(), kReadSize);
-      while (new_size < read_buffer_->num_valid_bytes_ + kReadSize)
+      // required extra space (which may be much bigger than |read_size|).
+      size_t new_size = std::max(read_buffer_->buffer_.size(), read_size);
+      while (new_size < read_buffer_->num_valid_bytes_ + read_size)
         new_size *= 2;
 
       // TODO(vtl): It's suboptimal to zero out the fresh memory.
       read_buffer_->buffer_.resize(new_size, 0);
     }
 
-    // (1) If we dispatched any messages, stop reading for now (and let the
-    // message loop do its thing for another round).
-    // TODO(vtl): Is this the behavior we want? (Alternatives: i. Dispatch only
-    // a single message. Risks: slower, more complex if we want to avoid lots of
-    // copying. ii. Keep reading until there's no more data and dispatch all the
-    // messages we can. Risks: starvation of other users of the message loop.)
-    // (2) If we didn't max out |kReadSize|, stop reading for now.
-    bool schedule_for_later = did_dispatch_message || bytes_read < kReadSize;
+    // (1) If we've done |kMaxReadsPerWakeUp| reads, stop reading for now (and
+    // let the message loop do its thing for another round). Reading on after
+    // dispatching saves a trip through the message loop per read when the
+    // other end is sending a burst, while the bound keeps one busy channel
+    // from starving the other users of the message loop.
+    // (2) If the read didn't fill the area it was given, there's likely
+    // nothing more to read, so stop reading for now.
+    bool schedule_for_later =
+        reads >= kMaxReadsPerWakeUp || !filled_read_buffer;
     bytes_read = 0;
     io_result = schedule_for_later ? ScheduleRead() : Read(&bytes_read);
   } while (io_result != IO_PENDING);
@@ -432,7 +499,25 @@ void RawChannel::OnWriteCompleted(IOResult io_result,
 
 void RawChannel::EnqueueMessageNoLock(scoped_ptr<MessageInTransit> message) {
   write_lock_.AssertAcquired();
-  write_buffer_->message_queue_.AddMessage(message.Pass());
+  WriteBuffer* write_buffer = write_buffer_.get();
+  MessageInTransitQueue* queue = &write_buffer->message_queue_;
+  if (!message->is_latency_sensitive() || message->transport_data()) {
+    queue->AddMessage(message.Pass());
+    return;
+  }
+
+  // Messages that are (partly) written, or in a write that's in progress, stay
+  // where they are.
+  size_t min_index = write_buffer->num_messages_in_write_;
+  if (write_buffer->data_offset_ > 0 ||
+      write_buffer->platform_handles_offset_ > 0)
+    min_index = std::max<size_t>(min_index, 1);
+
+  size_t index = queue->Size();
+  while (index > min_index &&
+         CanOvertake(message.get(), queue->PeekMessageAt(index - 1)))
+    index--;
+  queue->InsertMessageAt(index, message.Pass());
 }
 
 bool RawChannel::OnReadMessageForRawChannel(
@@ -482,16 +567,21 @@ bool RawChannel::OnWriteCompletedNoLock(IOResult io_result,
     write_buffer_->platform_handles_offset_ += platform_handles_written;
     write_buffer_->data_offset_ += bytes_written;
 
-    MessageInTransit* message = write_buffer_->message_queue_.PeekMessage();
-    if (write_buffer_->data_offset_ >= message->total_size()) {
+    // A write may complete several messages (see |WriteBuffer::GetBuffers()|).
+    while (!write_buffer_->message_queue_.IsEmpty()) {
+      MessageInTransit* message = write_buffer_->message_queue_.PeekMessage();
+      if (write_buffer_->data_offset_ < message->total_size())
+        break;
       // Complete write.
-      CHECK_EQ(write_buffer_->data_offset_, message->total_size());
+      write_buffer_->data_offset_ -= message->total_size();
       write_buffer_->message_queue_.DiscardMessage();
       write_buffer_->platform_handles_offset_ = 0;
-      write_buffer_->data_offset_ = 0;
-
-      if (write_buffer_->message_queue_.IsEmpty())
-        return true;
+      if (write_buffer_->num_messages_in_write_ > 0)
+        write_buffer_->num_messages_in_write_--;
+    }
+    if (write_buffer_->message_queue_.IsEmpty()) {
+      CHECK_EQ(write_buffer_->data_offset_, 0u);
+      return true;
     }
 
     // Schedule the next write.
@@ -505,6 +595,7 @@ bool RawChannel::OnWriteCompletedNoLock(IOResult io_result,
   write_buffer_->message_queue_.Clear();
   write_buffer_->platform_handles_offset_ = 0;
   write_buffer_->data_offset_ = 0;
+  write_buffer_->num_messages_in_write_ = 0;
   return false;
 }
 
@@ -130,17 +130,24 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
     ReadBuffer();
     ~ReadBuffer();
 
+    // Gets the area to read into next. Its size grows while reads keep filling
+    // it, so that a busy channel drains more messages per read.
     void GetBuffer(char** addr, size_t* size);
 
    private:
     friend class RawChannel;
 
+    // Adjusts |read_size_| after a read of |bytes_read| bytes.
+    void DidRead(size_t bytes_read);
+
     // We store data from |[Schedule]Read()|s in |buffer_|. The start of
     // |buffer_| is always aligned with a message boundary (we will copy memory
     // to ensure this), but |buffer_| may be larger than the actual number of
     // bytes we have.
     std::vector<char> buffer_;
     size_t num_valid_bytes_;
+    // The number of bytes |GetBuffer()| asks for.
+    size_t read_size_;
 
     MOJO_DISALLOW_COPY_AND_ASSIGN(ReadBuffer);
   };
@@ -173,11 +180,18 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
                                   embedder::PlatformHandle** platform_handles,
                                   void** serialization_data);
 
-    // Gets buffers to be written. These buffers will always come from the front
-    // of |message_queue_|. Once they are completely written, the front
-    // |MessageInTransit| should be popped (and destroyed); this is done in
-    // |OnWriteCompletedNoLock()|.
-    void GetBuffers(std::vector<Buffer>* buffers) const;
+    // The most buffers |GetBuffers()| returns.
+    static const size_t kMaxBufferCount = 16;
+
+    // Gets buffers to be written. These buffers will always start with the
+    // rest of the front message of |message_queue_|, and may be followed by
+    // the buffers of the messages after it (up to a total size of about
+    // |kMaxBytesToGather|), so that bursts of small messages go out in a
+    // single write. A message with platform handles attached is only ever
+    // written as the front message, since its handles must be sent first.
+    // Once messages are completely written, they are popped (and destroyed);
+    // this is done in |OnWriteCompletedNoLock()|.
+    void GetBuffers(std::vector<Buffer>* buffers);
 
    private:
     friend class RawChannel;
@@ -193,6 +207,11 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
     // indicates the position in the first message's data to start the next
     // write.
     size_t data_offset_;
+    // The number of messages (from the front of |message_queue_|) that the
+    // last |GetBuffers()| returned buffers for and that haven't been completely
+    // written yet. The write may still be in progress, so messages must not be
+    // inserted ahead of these.
+    size_t num_messages_in_write_;
 
     MOJO_DISALLOW_COPY_AND_ASSIGN(WriteBuffer);
   };
@@ -220,9 +239,12 @@ class MOJO_SYSTEM_IMPL_EXPORT RawChannel {
     return write_buffer_.get();
   }
 
-  // Adds |message| to the write message queue. Implementation subclasses may
-  // override this to add any additional "control" messages needed. This is
-  // called (on any thread) with |write_lock_| held.
+  // Adds |message| to the write message queue. A latency-sensitive message
+  // without transport data is placed ahead of queued messages it can safely
+  // overtake (see |MessageInTransit::is_latency_sensitive()|); everything else
+  // goes at the back. Implementation subclasses may override this to add any
+  // additional "control" messages needed. This is called (on any thread) with
+  // |write_lock_| held.
   virtual void EnqueueMessageNoLock(scoped_ptr<MessageInTransit> message);
 
   // Handles any control messages targeted to the |RawChannel| (or
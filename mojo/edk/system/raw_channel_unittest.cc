@@ -215,6 +215,61 @@ TEST_F(RawChannelTest, WriteMessage) {
       FROM_HERE, base::Bind(&RawChannel::Shutdown, base::Unretained(rc.get())));
 }
 
+// Tests that a burst of small messages, which queue up behind each other and
+// are then written several at a time, arrives intact and in order.
+TEST_F(RawChannelTest, WriteManySmallMessages) {
+  static const uint32_t kNumMessages = 10000;
+
+  WriteOnlyRawChannelDelegate delegate;
+  scoped_ptr<RawChannel> rc(RawChannel::Create(handles[0].Pass()));
+  TestMessageReaderAndChecker checker(handles[1].get());
+  io_thread()->PostTaskAndWait(
+      FROM_HERE,
+      base::Bind(&InitOnIOThread, rc.get(), base::Unretained(&delegate)));
+
+  for (uint32_t i = 0; i < kNumMessages; i++)
+    EXPECT_TRUE(rc->WriteMessage(MakeTestMessage(i % 100 + 1)));
+  for (uint32_t i = 0; i < kNumMessages; i++)
+    EXPECT_TRUE(checker.ReadAndCheckNextMessage(i % 100 + 1)) << i;
+
+  io_thread()->PostTaskAndWait(
+      FROM_HERE, base::Bind(&RawChannel::Shutdown, base::Unretained(rc.get())));
+}
+
+// Tests that a latency-sensitive message is written ahead of bulk messages
+// that are queued behind a partly-written one, but not ahead of that one.
+TEST_F(RawChannelTest, WriteLatencySensitiveMessage) {
+  // Each of these is far bigger than the socket buffer, so nothing after the
+  // first gets written until the reader catches up.
+  static const uint32_t kBulkSize = 4 * 1000 * 1000;
+  static const uint32_t kNumBulkMessages = 3;
+  static const uint32_t kLatencySensitiveSize = 7;
+
+  WriteOnlyRawChannelDelegate delegate;
+  scoped_ptr<RawChannel> rc(RawChannel::Create(handles[0].Pass()));
+  TestMessageReaderAndChecker checker(handles[1].get());
+  io_thread()->PostTaskAndWait(
+      FROM_HERE,
+      base::Bind(&InitOnIOThread, rc.get(), base::Unretained(&delegate)));
+
+  for (uint32_t i = 0; i < kNumBulkMessages; i++) {
+    scoped_ptr<MessageInTransit> message(MakeTestMessage(kBulkSize));
+    message->set_source_id(ChannelEndpointId::GetBootstrap());
+    EXPECT_TRUE(rc->WriteMessage(message.Pass()));
+  }
+  scoped_ptr<MessageInTransit> message(MakeTestMessage(kLatencySensitiveSize));
+  message->set_latency_sensitive(true);
+  EXPECT_TRUE(rc->WriteMessage(message.Pass()));
+
+  EXPECT_TRUE(checker.ReadAndCheckNextMessage(kBulkSize));
+  EXPECT_TRUE(checker.ReadAndCheckNextMessage(kLatencySensitiveSize));
+  for (uint32_t i = 1; i < kNumBulkMessages; i++)
+    EXPECT_TRUE(checker.ReadAndCheckNextMessage(kBulkSize)) << i;
+
+  io_thread()->PostTaskAndWait(
+      FROM_HERE, base::Bind(&RawChannel::Shutdown, base::Unretained(rc.get())));
+}
+
 // RawChannelTest.OnReadMessage ------------------------------------------------
 
 class ReadCheckerRawChannelDelegate : public RawChannel::Delegate {
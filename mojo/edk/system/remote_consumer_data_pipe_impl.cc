@@ -10,18 +10,23 @@
 
 #include "base/logging.h"
 #include "base/memory/scoped_ptr.h"
+#include "build/build_config.h"
 #include "mojo/edk/system/channel.h"
 #include "mojo/edk/system/channel_endpoint.h"
 #include "mojo/edk/system/configuration.h"
 #include "mojo/edk/system/data_pipe.h"
 #include "mojo/edk/system/message_in_transit.h"
 #include "mojo/edk/system/remote_data_pipe_ack.h"
+#include "mojo/edk/system/shared_buffer_dispatcher.h"
 
 namespace mojo {
 namespace system {
 
 namespace {
 
+// Smaller data pipes aren't worth setting up a shared ring buffer for.
+const size_t kMinRingCapacityNumBytes = 64 * 1024;
+
 bool ValidateIncomingMessage(size_t element_num_bytes,
                              size_t capacity_num_bytes,
                              size_t consumer_num_bytes,
@@ -68,10 +73,14 @@ bool ValidateIncomingMessage(size_t element_num_bytes,
 
 RemoteConsumerDataPipeImpl::RemoteConsumerDataPipeImpl(
     ChannelEndpoint* channel_endpoint,
-    size_t consumer_num_bytes)
+    size_t consumer_num_bytes,
+    embedder::PlatformSupport* platform_support)
     : channel_endpoint_(channel_endpoint),
-      consumer_num_bytes_(consumer_num_bytes) {
-  // Note: |buffer_| is lazily allocated.
+      consumer_num_bytes_(consumer_num_bytes),
+      platform_support_(platform_support),
+      consumer_acknowledged_(false),
+      ring_write_index_(0) {
+  // Note: |buffer_| and |ring_| are lazily allocated.
 }
 
 RemoteConsumerDataPipeImpl::~RemoteConsumerDataPipeImpl() {
@@ -137,6 +146,25 @@ MojoResult RemoteConsumerDataPipeImpl::ProducerWriteData(
   if (num_bytes_to_write == 0)
     return MOJO_RESULT_SHOULD_WAIT;
 
+  if (!MaybeSetUpRing())
+    return MOJO_RESULT_FAILED_PRECONDITION;
+  if (ring_) {
+    char* ring = static_cast<char*>(ring_->GetBase());
+    // The amount we can write in our first copy.
+    size_t num_bytes_to_write_first =
+        std::min(num_bytes_to_write, capacity_num_bytes() - ring_write_index_);
+    elements.GetArray(ring + ring_write_index_, num_bytes_to_write_first);
+    if (num_bytes_to_write_first < num_bytes_to_write) {
+      // The "second write index" is zero.
+      elements.At(num_bytes_to_write_first)
+          .GetArray(ring, num_bytes_to_write - num_bytes_to_write_first);
+    }
+    // As below, report success even if the consumer was disconnected.
+    SendRingData(num_bytes_to_write);
+    num_bytes.Put(static_cast<uint32_t>(num_bytes_to_write));
+    return MOJO_RESULT_OK;
+  }
+
   // The maximum amount of data to send per message (make it a multiple of the
   // element size.
   // TODO(vtl): Copied from |LocalDataPipeImpl::ConvertDataToMessages()|.
@@ -191,6 +219,22 @@ MojoResult RemoteConsumerDataPipeImpl::ProducerBeginWriteData(
   if (max_num_bytes_to_write == 0)
     return MOJO_RESULT_SHOULD_WAIT;
 
+  if (!MaybeSetUpRing())
+    return MOJO_RESULT_FAILED_PRECONDITION;
+  if (ring_) {
+    // Only the part up to the end of the ring can be written in one go.
+    max_num_bytes_to_write = std::min(max_num_bytes_to_write,
+                                      capacity_num_bytes() - ring_write_index_);
+    if (min_num_bytes_to_write > max_num_bytes_to_write)
+      return MOJO_RESULT_OUT_OF_RANGE;
+
+    buffer.Put(static_cast<char*>(ring_->GetBase()) + ring_write_index_);
+    buffer_num_bytes.Put(static_cast<uint32_t>(max_num_bytes_to_write));
+    set_producer_two_phase_max_num_bytes_written(
+        static_cast<uint32_t>(max_num_bytes_to_write));
+    return MOJO_RESULT_OK;
+  }
+
   EnsureBuffer();
   buffer.Put(buffer_.get());
   buffer_num_bytes.Put(static_cast<uint32_t>(max_num_bytes_to_write));
@@ -206,12 +250,19 @@ MojoResult RemoteConsumerDataPipeImpl::ProducerEndWriteData(
   DCHECK_LE(num_bytes_written, capacity_num_bytes() - consumer_num_bytes_);
 
   if (!consumer_open()) {
-    DCHECK(buffer_);
+    DCHECK(buffer_ || ring_);
     set_producer_two_phase_max_num_bytes_written(0);
     DestroyBuffer();
     return MOJO_RESULT_OK;
   }
 
+  if (ring_) {
+    set_producer_two_phase_max_num_bytes_written(0);
+    if (num_bytes_written > 0)
+      SendRingData(num_bytes_written);
+    return MOJO_RESULT_OK;
+  }
+
   // TODO(vtl): The following code is copied almost verbatim from
   // |ProducerWriteData()| (it's touchy to factor it out since it uses a
   // |UserPointer| while we have a plain pointer.
@@ -298,7 +349,7 @@ bool RemoteConsumerDataPipeImpl::ProducerEndSerialize(
   scoped_refptr<ChannelEndpoint> channel_endpoint;
   channel_endpoint.swap(channel_endpoint_);
   channel->SerializeEndpointWithRemotePeer(destination_for_endpoint, nullptr,
-                                           channel_endpoint);
+                                           channel_endpoint, nullptr);
   owner()->SetConsumerClosedNoLock();
 
   *actual_size = sizeof(SerializedDataPipeProducerDispatcher) +
@@ -385,6 +436,7 @@ bool RemoteConsumerDataPipeImpl::OnReadMessage(unsigned /*port*/,
       static_cast<const RemoteDataPipeAck*>(msg->bytes());
   size_t num_bytes_consumed = ack->num_bytes_consumed;
   consumer_num_bytes_ -= num_bytes_consumed;
+  consumer_acknowledged_ = true;
   return true;
 }
 
@@ -399,6 +451,7 @@ void RemoteConsumerDataPipeImpl::OnDetachFromChannel(unsigned /*port*/) {
 
 void RemoteConsumerDataPipeImpl::EnsureBuffer() {
   DCHECK(producer_open());
+  DCHECK(!ring_);
   if (buffer_)
     return;
   buffer_.reset(static_cast<char*>(
@@ -414,6 +467,77 @@ void RemoteConsumerDataPipeImpl::DestroyBuffer() {
     memset(buffer_.get(), 0xcd, capacity_num_bytes());
 #endif
   buffer_.reset();
+  // The consumer may still be reading from its mapping of the ring, so don't
+  // scribble on it.
+  ring_.reset();
+}
+
+bool RemoteConsumerDataPipeImpl::MaybeSetUpRing() {
+  DCHECK(consumer_open());
+  DCHECK(channel_endpoint_);
+
+#if defined(OS_POSIX)
+  if (ring_ || !platform_support_ || !consumer_acknowledged_ ||
+      capacity_num_bytes() < kMinRingCapacityNumBytes)
+    return true;
+
+  // Only try once (even on failure).
+  embedder::PlatformSupport* platform_support = platform_support_;
+  platform_support_ = nullptr;
+
+  scoped_refptr<SharedBufferDispatcher> ring_buffer;
+  if (SharedBufferDispatcher::Create(
+          platform_support, SharedBufferDispatcher::kDefaultCreateOptions,
+          capacity_num_bytes(), &ring_buffer) != MOJO_RESULT_OK)
+    return true;
+  scoped_ptr<embedder::PlatformSharedBufferMapping> ring;
+  if (ring_buffer->MapBuffer(0, capacity_num_bytes(), MOJO_MAP_BUFFER_FLAG_NONE,
+                             &ring) != MOJO_RESULT_OK) {
+    ring_buffer->Close();
+    return true;
+  }
+
+  RemoteDataPipeRing ring_data = {};
+  ring_data.consumer_num_bytes = static_cast<uint32_t>(consumer_num_bytes_);
+  scoped_ptr<MessageInTransit> message(new MessageInTransit(
+      MessageInTransit::Type::ENDPOINT_CLIENT,
+      MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING,
+      static_cast<uint32_t>(sizeof(ring_data)), &ring_data));
+  scoped_ptr<DispatcherVector> dispatchers(new DispatcherVector());
+  dispatchers->push_back(ring_buffer);
+  // The message must hold the only reference.
+  ring_buffer = nullptr;
+  message->SetDispatchers(dispatchers.Pass());
+  if (!channel_endpoint_->EnqueueMessage(message.Pass())) {
+    Disconnect();
+    return false;
+  }
+
+  ring_ = ring.Pass();
+  ring_write_index_ = consumer_num_bytes_ % capacity_num_bytes();
+#endif
+  return true;
+}
+
+bool RemoteConsumerDataPipeImpl::SendRingData(size_t num_bytes) {
+  DCHECK(ring_);
+  DCHECK_GT(num_bytes, 0u);
+  DCHECK_LE(num_bytes, capacity_num_bytes() - consumer_num_bytes_);
+
+  RemoteDataPipeRingData ring_data = {};
+  ring_data.num_bytes = static_cast<uint32_t>(num_bytes);
+  scoped_ptr<MessageInTransit> message(new MessageInTransit(
+      MessageInTransit::Type::ENDPOINT_CLIENT,
+      MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING_DATA,
+      static_cast<uint32_t>(sizeof(ring_data)), &ring_data));
+  if (!channel_endpoint_->EnqueueMessage(message.Pass())) {
+    Disconnect();
+    return false;
+  }
+
+  ring_write_index_ = (ring_write_index_ + num_bytes) % capacity_num_bytes();
+  consumer_num_bytes_ += num_bytes;
+  return true;
 }
 
 void RemoteConsumerDataPipeImpl::Disconnect() {
@@ -8,22 +8,34 @@
 #include "base/memory/aligned_memory.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "mojo/edk/embedder/platform_shared_buffer.h"
 #include "mojo/edk/system/channel_endpoint.h"
 #include "mojo/edk/system/data_pipe_impl.h"
 #include "mojo/edk/system/system_impl_export.h"
 #include "mojo/public/cpp/system/macros.h"
 
 namespace mojo {
+
+namespace embedder {
+class PlatformSupport;
+}
+
 namespace system {
 
 // |RemoteConsumerDataPipeImpl| is a subclass that "implements" |DataPipe| for
 // data pipes whose producer is local and whose consumer is remote. See
 // |DataPipeImpl| for more details.
+//
+// Once the consumer has acknowledged some data, the data pipe's buffer is
+// moved to a buffer shared with the consumer (if |platform_support| is
+// non-null). After that, data is written directly to that ring buffer, and
+// only the positions are sent in messages.
 class MOJO_SYSTEM_IMPL_EXPORT RemoteConsumerDataPipeImpl final
     : public DataPipeImpl {
  public:
   RemoteConsumerDataPipeImpl(ChannelEndpoint* channel_endpoint,
-                             size_t consumer_num_bytes);
+                             size_t consumer_num_bytes,
+                             embedder::PlatformSupport* platform_support);
   ~RemoteConsumerDataPipeImpl() override;
 
   // Processes messages that were received and queued by an |IncomingEndpoint|.
@@ -87,6 +99,13 @@ class MOJO_SYSTEM_IMPL_EXPORT RemoteConsumerDataPipeImpl final
   void EnsureBuffer();
   void DestroyBuffer();
 
+  // Sets up |ring_| if it should be used and isn't yet. Returns false if the
+  // consumer was disconnected.
+  bool MaybeSetUpRing();
+  // Tells the consumer that |num_bytes| were written to |ring_| at
+  // |ring_write_index_|. Returns false if the consumer was disconnected.
+  bool SendRingData(size_t num_bytes);
+
   void Disconnect();
 
   // Should be valid if and only if |consumer_open()| returns true.
@@ -96,9 +115,21 @@ class MOJO_SYSTEM_IMPL_EXPORT RemoteConsumerDataPipeImpl final
   // consumed.
   size_t consumer_num_bytes_;
 
-  // Used for two-phase writes.
+  // Used for two-phase writes (if there's no |ring_|).
   scoped_ptr<char, base::AlignedFreeDeleter> buffer_;
 
+  // May be null, in which case a ring buffer is never set up. (It's reset once
+  // the ring buffer has been set up, or failed to be.)
+  embedder::PlatformSupport* platform_support_;
+  // Set once an acknowledgement has been received (which shows that the
+  // consumer is no longer waiting in an |IncomingEndpoint|, and so that it'll
+  // handle the ring buffer set-up itself).
+  bool consumer_acknowledged_;
+  // The ring buffer shared with the consumer, and the index at which the next
+  // data will be written to it.
+  scoped_ptr<embedder::PlatformSharedBufferMapping> ring_;
+  size_t ring_write_index_;
+
   MOJO_DISALLOW_COPY_AND_ASSIGN(RemoteConsumerDataPipeImpl);
 };
 
@@ -16,6 +16,26 @@ struct RemoteDataPipeAck {
   uint32_t num_bytes_consumed;
 };
 
+// Data payload for |MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING|
+// messages. The attached shared buffer has the data pipe's capacity, and the
+// producer writes to it starting at index |consumer_num_bytes| (modulo the
+// capacity). The consumer moves the data it already has to end at that index.
+// (This works since the data the consumer has is at most the data the producer
+// has sent but not yet had acknowledged.)
+struct RemoteDataPipeRing {
+  // The number of bytes sent to the consumer, but not acknowledged, at the time
+  // the ring was set up.
+  uint32_t consumer_num_bytes;
+};
+
+// Data payload for
+// |MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING_DATA| messages:
+// |num_bytes| of data were written to the shared ring buffer, following the
+// previous data.
+struct RemoteDataPipeRingData {
+  uint32_t num_bytes;
+};
+
 }  // namespace system
 }  // namespace mojo
 
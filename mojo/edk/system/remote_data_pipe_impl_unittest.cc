@@ -7,6 +7,8 @@
 
 #include <stdint.h>
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/location.h"
 #include "base/logging.h"
@@ -277,6 +279,110 @@ TEST_F(RemoteDataPipeImplTest, SendConsumerWithClosedProducer) {
   consumer->Close();
 }
 
+// Streams more data than fits through a data pipe whose consumer has been sent
+// over a remote message pipe. Pipes this large switch to a shared ring buffer
+// once the consumer has acknowledged some data (on platforms where that is
+// supported), so this checks that no data is lost or reordered when that
+// happens.
+TEST_F(RemoteDataPipeImplTest, StreamLargeAmountOfData) {
+  static const size_t kCapacity = 256 * 1024;
+  static const size_t kTotalNumBytes = 4 * kCapacity;
+  static const size_t kChunkNumBytes = 48 * 1024;
+  char buffer[kChunkNumBytes];
+  uint32_t read_buffer_size = 0;
+  DispatcherVector read_dispatchers;
+  uint32_t read_num_dispatchers = 10;  // Maximum to get.
+  Waiter waiter;
+  HandleSignalsState hss;
+  uint32_t context = 0;
+
+  scoped_refptr<DataPipe> dp(CreateLocal(1, kCapacity));
+  scoped_refptr<DataPipeConsumerDispatcher> consumer =
+      DataPipeConsumerDispatcher::Create();
+  consumer->Init(dp);
+
+  // Write the consumer to MP 0 (port 0). Wait and receive on MP 1 (port 0).
+  waiter.Init();
+  ASSERT_EQ(MOJO_RESULT_OK,
+            message_pipe(1)->AddAwakable(
+                0, &waiter, MOJO_HANDLE_SIGNAL_READABLE, 123, nullptr));
+  {
+    DispatcherTransport transport(
+        test::DispatcherTryStartTransport(consumer.get()));
+    EXPECT_TRUE(transport.is_valid());
+
+    std::vector<DispatcherTransport> transports;
+    transports.push_back(transport);
+    EXPECT_EQ(MOJO_RESULT_OK, message_pipe(0)->WriteMessage(
+                                  0, NullUserPointer(), 0, &transports,
+                                  MOJO_WRITE_MESSAGE_FLAG_NONE));
+    transport.End();
+    EXPECT_TRUE(consumer->HasOneRef());
+    consumer = nullptr;
+  }
+  EXPECT_EQ(MOJO_RESULT_OK, waiter.Wait(test::ActionDeadline(), &context));
+  EXPECT_EQ(123u, context);
+  message_pipe(1)->RemoveAwakable(0, &waiter, nullptr);
+  EXPECT_EQ(MOJO_RESULT_OK,
+            message_pipe(1)->ReadMessage(
+                0, NullUserPointer(), MakeUserPointer(&read_buffer_size),
+                &read_dispatchers, &read_num_dispatchers,
+                MOJO_READ_MESSAGE_FLAG_NONE));
+  ASSERT_EQ(1u, read_dispatchers.size());
+  ASSERT_EQ(Dispatcher::Type::DATA_PIPE_CONSUMER,
+            read_dispatchers[0]->GetType());
+  consumer =
+      static_cast<DataPipeConsumerDispatcher*>(read_dispatchers[0].get());
+  read_dispatchers.clear();
+
+  size_t num_bytes_written = 0;
+  size_t num_bytes_read = 0;
+  while (num_bytes_read < kTotalNumBytes) {
+    // Write as much as fits (the producer is local, so this never blocks).
+    if (num_bytes_written < kTotalNumBytes) {
+      uint32_t num_bytes = static_cast<uint32_t>(
+          std::min(kChunkNumBytes, kTotalNumBytes - num_bytes_written));
+      for (uint32_t i = 0; i < num_bytes; i++)
+        buffer[i] = static_cast<char>((num_bytes_written + i) % 251);
+      MojoResult result = dp->ProducerWriteData(
+          UserPointer<const void>(buffer), MakeUserPointer(&num_bytes), false);
+      if (result == MOJO_RESULT_OK)
+        num_bytes_written += num_bytes;
+      else
+        ASSERT_EQ(MOJO_RESULT_SHOULD_WAIT, result);
+    }
+
+    uint32_t num_bytes = static_cast<uint32_t>(sizeof(buffer));
+    MojoResult result =
+        consumer->ReadData(UserPointer<void>(buffer),
+                           MakeUserPointer(&num_bytes), MOJO_READ_DATA_FLAG_NONE);
+    if (result == MOJO_RESULT_OK) {
+      for (uint32_t i = 0; i < num_bytes; i++) {
+        ASSERT_EQ(static_cast<char>((num_bytes_read + i) % 251), buffer[i])
+            << "at byte " << (num_bytes_read + i);
+      }
+      num_bytes_read += num_bytes;
+      continue;
+    }
+    ASSERT_EQ(MOJO_RESULT_SHOULD_WAIT, result);
+
+    // Anything written is on its way, so wait for it.
+    waiter.Init();
+    result =
+        consumer->AddAwakable(&waiter, MOJO_HANDLE_SIGNAL_READABLE, 456, &hss);
+    if (result == MOJO_RESULT_OK) {
+      EXPECT_EQ(MOJO_RESULT_OK, waiter.Wait(test::ActionDeadline(), &context));
+      consumer->RemoveAwakable(&waiter, &hss);
+    } else {
+      ASSERT_EQ(MOJO_RESULT_ALREADY_EXISTS, result);
+    }
+  }
+  EXPECT_EQ(kTotalNumBytes, num_bytes_written);
+
+  dp->ProducerClose();
+  consumer->Close();
+}
+
 }  // namespace
 }  // namespace system
 }  // namespace mojo
@@ -25,6 +25,7 @@
 #include "mojo/edk/system/channel.h"
 #include "mojo/edk/system/channel_endpoint.h"
 #include "mojo/edk/system/channel_endpoint_id.h"
+#include "mojo/edk/system/configuration.h"
 #include "mojo/edk/system/incoming_endpoint.h"
 #include "mojo/edk/system/message_pipe.h"
 #include "mojo/edk/system/message_pipe_dispatcher.h"
@@ -1017,6 +1018,75 @@ TEST_F(RemoteMessagePipeTest, MAYBE_SharedBufferPassing) {
   EXPECT_EQ('x', static_cast<char*>(mapping1->GetBase())[1]);
 }
 
+// Tests that messages whose data is moved through a shared buffer arrive
+// intact and in order.
+TEST_F(RemoteMessagePipeTest, LargeMessage) {
+  static const char kHello[] = "hello";
+  const size_t kLargeNumBytes =
+      GetConfiguration().min_shared_buffer_message_num_bytes + 100;
+  std::vector<char> large_message(kLargeNumBytes);
+  for (size_t i = 0; i < kLargeNumBytes; i++)
+    large_message[i] = static_cast<char>(i % 251);
+  Waiter waiter;
+  uint32_t context = 0;
+
+  scoped_refptr<ChannelEndpoint> ep0;
+  scoped_refptr<MessagePipe> mp0(MessagePipe::CreateLocalProxy(&ep0));
+  scoped_refptr<ChannelEndpoint> ep1;
+  scoped_refptr<MessagePipe> mp1(MessagePipe::CreateProxyLocal(&ep1));
+  BootstrapChannelEndpoints(ep0, ep1);
+
+  waiter.Init();
+  ASSERT_EQ(
+      MOJO_RESULT_OK,
+      mp1->AddAwakable(1, &waiter, MOJO_HANDLE_SIGNAL_READABLE, 123, nullptr));
+
+  // Write a large message followed by a small one to MP 0, port 0.
+  EXPECT_EQ(MOJO_RESULT_OK,
+            mp0->WriteMessage(0, UserPointer<const void>(&large_message[0]),
+                              static_cast<uint32_t>(kLargeNumBytes), nullptr,
+                              MOJO_WRITE_MESSAGE_FLAG_NONE));
+  EXPECT_EQ(
+      MOJO_RESULT_OK,
+      mp0->WriteMessage(0, UserPointer<const void>(kHello), sizeof(kHello),
+                        nullptr, MOJO_WRITE_MESSAGE_FLAG_NONE));
+
+  EXPECT_EQ(MOJO_RESULT_OK, waiter.Wait(MOJO_DEADLINE_INDEFINITE, &context));
+  EXPECT_EQ(123u, context);
+  mp1->RemoveAwakable(1, &waiter, nullptr);
+
+  // Read the large message from MP 1, port 1.
+  std::vector<char> read_buffer(kLargeNumBytes + 1);
+  uint32_t read_buffer_size = static_cast<uint32_t>(read_buffer.size());
+  EXPECT_EQ(MOJO_RESULT_OK,
+            mp1->ReadMessage(1, UserPointer<void>(&read_buffer[0]),
+                             MakeUserPointer(&read_buffer_size), nullptr,
+                             nullptr, MOJO_READ_MESSAGE_FLAG_NONE));
+  EXPECT_EQ(kLargeNumBytes, static_cast<size_t>(read_buffer_size));
+  EXPECT_EQ(0, memcmp(&large_message[0], &read_buffer[0], kLargeNumBytes));
+
+  // The small message is written after the large one, so if it hasn't arrived
+  // yet, wait for it.
+  waiter.Init();
+  if (mp1->AddAwakable(1, &waiter, MOJO_HANDLE_SIGNAL_READABLE, 456,
+                       nullptr) == MOJO_RESULT_OK) {
+    EXPECT_EQ(MOJO_RESULT_OK, waiter.Wait(MOJO_DEADLINE_INDEFINITE, &context));
+    EXPECT_EQ(456u, context);
+    mp1->RemoveAwakable(1, &waiter, nullptr);
+  }
+
+  read_buffer_size = static_cast<uint32_t>(read_buffer.size());
+  EXPECT_EQ(MOJO_RESULT_OK,
+            mp1->ReadMessage(1, UserPointer<void>(&read_buffer[0]),
+                             MakeUserPointer(&read_buffer_size), nullptr,
+                             nullptr, MOJO_READ_MESSAGE_FLAG_NONE));
+  EXPECT_EQ(sizeof(kHello), static_cast<size_t>(read_buffer_size));
+  EXPECT_STREQ(kHello, &read_buffer[0]);
+
+  mp0->Close(0);
+  mp1->Close(1);
+}
+
 #if defined(OS_POSIX)
 #define MAYBE_PlatformHandlePassing PlatformHandlePassing
 #else
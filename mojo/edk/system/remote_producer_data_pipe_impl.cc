@@ -14,6 +14,8 @@
 #include "mojo/edk/system/channel_endpoint.h"
 #include "mojo/edk/system/configuration.h"
 #include "mojo/edk/system/data_pipe.h"
+#include "mojo/edk/system/dispatcher.h"
+#include "mojo/edk/system/endpoint_relayer.h"
 #include "mojo/edk/system/message_in_transit.h"
 #include "mojo/edk/system/message_in_transit_queue.h"
 #include "mojo/edk/system/remote_consumer_data_pipe_impl.h"
@@ -56,6 +58,135 @@ bool ValidateIncomingMessage(size_t element_num_bytes,
   return true;
 }
 
+// Maps the ring buffer attached to an |ENDPOINT_CLIENT_DATA_PIPE_RING| message
+// and gets the producer's position from it. Returns false if the message is
+// invalid.
+bool MapIncomingRing(size_t element_num_bytes,
+                     size_t capacity_num_bytes,
+                     MessageInTransit* message,
+                     scoped_ptr<embedder::PlatformSharedBufferMapping>* ring,
+                     size_t* consumer_num_bytes) {
+  if (message->num_bytes() != sizeof(RemoteDataPipeRing)) {
+    LOG(WARNING) << "Incorrect message size for ring buffer set-up";
+    return false;
+  }
+
+  const RemoteDataPipeRing* ring_data =
+      static_cast<const RemoteDataPipeRing*>(message->bytes());
+  if (ring_data->consumer_num_bytes % element_num_bytes != 0) {
+    LOG(WARNING) << "Ring buffer position not a multiple of element size: "
+                 << ring_data->consumer_num_bytes;
+    return false;
+  }
+
+  DispatcherVector* dispatchers = message->dispatchers();
+  if (!dispatchers || dispatchers->size() != 1 || !(*dispatchers)[0] ||
+      (*dispatchers)[0]->GetType() != Dispatcher::Type::SHARED_BUFFER) {
+    LOG(WARNING) << "Ring buffer set-up without a shared buffer";
+    return false;
+  }
+
+  if ((*dispatchers)[0]->MapBuffer(0, capacity_num_bytes,
+                                   MOJO_MAP_BUFFER_FLAG_NONE,
+                                   ring) != MOJO_RESULT_OK) {
+    LOG(WARNING) << "Failed to map ring buffer";
+    return false;
+  }
+
+  *consumer_num_bytes = ring_data->consumer_num_bytes;
+  return true;
+}
+
+// Installed on the |EndpointRelayer| that relays messages from the producer
+// once the consumer has been sent elsewhere. The consumer there can't see the
+// ring buffer, so data written to it is turned back into data messages. (The
+// producer may also set up a ring buffer after the consumer was sent, which is
+// handled in the same way.)
+class RingBufferRelayFilter : public EndpointRelayer::Filter {
+ public:
+  RingBufferRelayFilter(size_t element_num_bytes,
+                        size_t capacity_num_bytes,
+                        scoped_ptr<embedder::PlatformSharedBufferMapping> ring,
+                        size_t read_index)
+      : element_num_bytes_(element_num_bytes),
+        capacity_num_bytes_(capacity_num_bytes),
+        ring_(ring.Pass()),
+        read_index_(read_index) {}
+  ~RingBufferRelayFilter() override {}
+
+  // |EndpointRelayer::Filter| implementation:
+  bool OnReadMessage(ChannelEndpoint* /*endpoint*/,
+                     ChannelEndpoint* peer_endpoint,
+                     MessageInTransit* message) override {
+    // Invalid messages are relayed as they are, for the consumer to reject.
+    switch (message->subtype()) {
+      case MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING: {
+        scoped_ptr<embedder::PlatformSharedBufferMapping> ring;
+        size_t consumer_num_bytes = 0;
+        if (!MapIncomingRing(element_num_bytes_, capacity_num_bytes_, message,
+                             &ring, &consumer_num_bytes) ||
+            consumer_num_bytes > capacity_num_bytes_)
+          return false;
+        delete message;
+        ring_ = ring.Pass();
+        read_index_ = consumer_num_bytes % capacity_num_bytes_;
+        return true;
+      }
+      case MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING_DATA: {
+        if (!ring_ || message->num_bytes() != sizeof(RemoteDataPipeRingData))
+          return false;
+        size_t num_bytes =
+            static_cast<const RemoteDataPipeRingData*>(message->bytes())
+                ->num_bytes;
+        if (num_bytes > capacity_num_bytes_ ||
+            num_bytes % element_num_bytes_ != 0)
+          return false;
+        delete message;
+        RelayData(peer_endpoint, num_bytes);
+        return true;
+      }
+      default:
+        return false;
+    }
+  }
+
+ private:
+  void RelayData(ChannelEndpoint* peer_endpoint, size_t num_bytes) {
+    const char* ring = static_cast<const char*>(ring_->GetBase());
+    const size_t max_message_num_bytes =
+        GetConfiguration().max_message_num_bytes;
+    const size_t max_chunk_num_bytes =
+        max_message_num_bytes - max_message_num_bytes % element_num_bytes_;
+    while (num_bytes > 0) {
+      size_t chunk_num_bytes = std::min(num_bytes, max_chunk_num_bytes);
+      scoped_ptr<MessageInTransit> message(new MessageInTransit(
+          MessageInTransit::Type::ENDPOINT_CLIENT,
+          MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA,
+          static_cast<uint32_t>(chunk_num_bytes), nullptr));
+      char* bytes = static_cast<char*>(message->bytes());
+      size_t first_num_bytes =
+          std::min(chunk_num_bytes, capacity_num_bytes_ - read_index_);
+      memcpy(bytes, ring + read_index_, first_num_bytes);
+      memcpy(bytes + first_num_bytes, ring, chunk_num_bytes - first_num_bytes);
+      read_index_ = (read_index_ + chunk_num_bytes) % capacity_num_bytes_;
+      num_bytes -= chunk_num_bytes;
+
+      // If the consumer has gone away, the data is dropped (as it would be
+      // without the filter).
+      if (peer_endpoint)
+        peer_endpoint->EnqueueMessage(message.Pass());
+    }
+  }
+
+  const size_t element_num_bytes_;
+  const size_t capacity_num_bytes_;
+  scoped_ptr<embedder::PlatformSharedBufferMapping> ring_;
+  // Where the producer will write next.
+  size_t read_index_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(RingBufferRelayFilter);
+};
+
 }  // namespace
 
 RemoteProducerDataPipeImpl::RemoteProducerDataPipeImpl(
@@ -166,6 +297,7 @@ bool RemoteProducerDataPipeImpl::ProducerEndSerialize(
 }
 
 void RemoteProducerDataPipeImpl::ConsumerClose() {
+  pending_messages_.Clear();
   if (producer_open())
     Disconnect();
   current_num_bytes_ = 0;
@@ -198,12 +330,12 @@ MojoResult RemoteProducerDataPipeImpl::ConsumerReadData(
   // The amount we can read in our first |memcpy()|.
   size_t num_bytes_to_read_first =
       std::min(num_bytes_to_read, GetMaxNumBytesToRead());
-  elements.PutArray(buffer_.get() + start_index_, num_bytes_to_read_first);
+  elements.PutArray(buffer() + start_index_, num_bytes_to_read_first);
 
   if (num_bytes_to_read_first < num_bytes_to_read) {
     // The "second read index" is zero.
     elements.At(num_bytes_to_read_first)
-        .PutArray(buffer_.get(), num_bytes_to_read - num_bytes_to_read_first);
+        .PutArray(buffer(), num_bytes_to_read - num_bytes_to_read_first);
   }
 
   if (!peek)
@@ -265,7 +397,7 @@ MojoResult RemoteProducerDataPipeImpl::ConsumerBeginReadData(
                            : MOJO_RESULT_FAILED_PRECONDITION;
   }
 
-  buffer.Put(buffer_.get() + start_index_);
+  buffer.Put(this->buffer() + start_index_);
   buffer_num_bytes.Put(static_cast<uint32_t>(max_num_bytes_to_read));
   set_consumer_two_phase_max_num_bytes_read(
       static_cast<uint32_t>(max_num_bytes_to_read));
@@ -279,6 +411,7 @@ MojoResult RemoteProducerDataPipeImpl::ConsumerEndReadData(
   DCHECK_LE(start_index_ + num_bytes_read, capacity_num_bytes());
   MarkDataAsConsumed(num_bytes_read);
   set_consumer_two_phase_max_num_bytes_read(0);
+  ProcessPendingMessages();
   return MOJO_RESULT_OK;
 }
 
@@ -318,8 +451,14 @@ bool RemoteProducerDataPipeImpl::ConsumerEndSerialize(
   void* destination_for_endpoint = static_cast<char*>(destination) +
                                    sizeof(SerializedDataPipeConsumerDispatcher);
 
+  // Messages are only held back during two-phase reads.
+  DCHECK(pending_messages_.IsEmpty());
+
+  // Where the producer will write next, if there's a ring buffer.
+  size_t ring_write_index =
+      (start_index_ + current_num_bytes_) % capacity_num_bytes();
   MessageInTransitQueue message_queue;
-  ConvertDataToMessages(buffer_.get(), &start_index_, &current_num_bytes_,
+  ConvertDataToMessages(buffer(), &start_index_, &current_num_bytes_,
                         &message_queue);
 
   if (!producer_open()) {
@@ -337,8 +476,11 @@ bool RemoteProducerDataPipeImpl::ConsumerEndSerialize(
   // Note: We don't use |port|.
   scoped_refptr<ChannelEndpoint> channel_endpoint;
   channel_endpoint.swap(channel_endpoint_);
-  channel->SerializeEndpointWithRemotePeer(destination_for_endpoint,
-                                           &message_queue, channel_endpoint);
+  channel->SerializeEndpointWithRemotePeer(
+      destination_for_endpoint, &message_queue, channel_endpoint,
+      make_scoped_ptr(new RingBufferRelayFilter(
+          element_num_bytes(), capacity_num_bytes(), ring_.Pass(),
+          ring_write_index)));
   owner()->SetProducerClosedNoLock();
 
   *actual_size = sizeof(SerializedDataPipeConsumerDispatcher) +
@@ -362,26 +504,59 @@ bool RemoteProducerDataPipeImpl::OnReadMessage(unsigned /*port*/,
   // always return true below.)
   scoped_ptr<MessageInTransit> msg(message);
 
-  if (!ValidateIncomingMessage(element_num_bytes(), capacity_num_bytes(),
-                               current_num_bytes_, msg.get())) {
-    Disconnect();
+  // Setting up a ring buffer moves the data, which we can't do while the
+  // consumer is reading it in place. Messages have to be processed in order, so
+  // everything after it waits too.
+  if (!pending_messages_.IsEmpty() ||
+      (consumer_in_two_phase_read() &&
+       msg->subtype() ==
+           MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING)) {
+    pending_messages_.AddMessage(msg.Pass());
     return true;
   }
 
-  size_t num_bytes = msg->num_bytes();
+  if (!ProcessMessage(msg.get()))
+    Disconnect();
+  return true;
+}
+
+void RemoteProducerDataPipeImpl::OnDetachFromChannel(unsigned /*port*/) {
+  if (!producer_open()) {
+    DCHECK(!channel_endpoint_);
+    return;
+  }
+
+  Disconnect();
+}
+
+bool RemoteProducerDataPipeImpl::ProcessMessage(MessageInTransit* message) {
+  switch (message->subtype()) {
+    case MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING:
+      return ProcessRingMessage(message);
+    case MessageInTransit::Subtype::ENDPOINT_CLIENT_DATA_PIPE_RING_DATA:
+      return ProcessRingDataMessage(message);
+    default:
+      break;
+  }
+
+  if (!ValidateIncomingMessage(element_num_bytes(), capacity_num_bytes(),
+                               current_num_bytes_, message))
+    return false;
+
+  size_t num_bytes = message->num_bytes();
   // The amount we can write in our first copy.
   size_t num_bytes_to_copy_first = std::min(num_bytes, GetMaxNumBytesToWrite());
   // Do the first (and possibly only) copy.
   size_t first_write_index =
       (start_index_ + current_num_bytes_) % capacity_num_bytes();
   EnsureBuffer();
-  memcpy(buffer_.get() + first_write_index, msg->bytes(),
+  memcpy(buffer() + first_write_index, message->bytes(),
          num_bytes_to_copy_first);
 
   if (num_bytes_to_copy_first < num_bytes) {
     // The "second write index" is zero.
-    memcpy(buffer_.get(),
-           static_cast<const char*>(msg->bytes()) + num_bytes_to_copy_first,
+    memcpy(buffer(),
+           static_cast<const char*>(message->bytes()) + num_bytes_to_copy_first,
            num_bytes - num_bytes_to_copy_first);
   }
 
@@ -390,19 +565,86 @@ bool RemoteProducerDataPipeImpl::OnReadMessage(unsigned /*port*/,
   return true;
 }
 
-void RemoteProducerDataPipeImpl::OnDetachFromChannel(unsigned /*port*/) {
-  if (!producer_open()) {
-    DCHECK(!channel_endpoint_);
-    return;
+bool RemoteProducerDataPipeImpl::ProcessRingMessage(MessageInTransit* message) {
+  DCHECK(!consumer_in_two_phase_read());
+
+  scoped_ptr<embedder::PlatformSharedBufferMapping> ring;
+  size_t consumer_num_bytes = 0;
+  if (!MapIncomingRing(element_num_bytes(), capacity_num_bytes(), message,
+                       &ring, &consumer_num_bytes))
+    return false;
+
+  // The producer has been told about everything we've consumed, so it can't
+  // think we have less data than we do.
+  if (consumer_num_bytes < current_num_bytes_ ||
+      consumer_num_bytes > capacity_num_bytes()) {
+    LOG(WARNING) << "Invalid ring buffer position: " << consumer_num_bytes
+                 << " bytes (current: " << current_num_bytes_ << " bytes)";
+    return false;
   }
 
-  Disconnect();
+  // The producer continues writing at |consumer_num_bytes % capacity|, so move
+  // the data we have to end there.
+  size_t ring_start_index =
+      (consumer_num_bytes - current_num_bytes_) % capacity_num_bytes();
+  char* ring_base = static_cast<char*>(ring->GetBase());
+  for (size_t copied = 0; copied < current_num_bytes_;) {
+    size_t from = (start_index_ + copied) % capacity_num_bytes();
+    size_t to = (ring_start_index + copied) % capacity_num_bytes();
+    size_t num_bytes = std::min(current_num_bytes_ - copied,
+                                capacity_num_bytes() - std::max(from, to));
+    memcpy(ring_base + to, buffer() + from, num_bytes);
+    copied += num_bytes;
+  }
+
+  DestroyBuffer();
+  ring_ = ring.Pass();
+  start_index_ = ring_start_index;
+  return true;
+}
+
+bool RemoteProducerDataPipeImpl::ProcessRingDataMessage(
+    const MessageInTransit* message) {
+  if (!ring_) {
+    LOG(WARNING) << "Received ring buffer data without a ring buffer";
+    return false;
+  }
+
+  if (message->num_bytes() != sizeof(RemoteDataPipeRingData)) {
+    LOG(WARNING) << "Incorrect message size for ring buffer data";
+    return false;
+  }
+
+  size_t num_bytes =
+      static_cast<const RemoteDataPipeRingData*>(message->bytes())->num_bytes;
+  const size_t max_num_bytes = capacity_num_bytes() - current_num_bytes_;
+  if (num_bytes > max_num_bytes || num_bytes % element_num_bytes() != 0) {
+    LOG(WARNING) << "Received invalid amount of ring buffer data: "
+                 << num_bytes << " bytes (maximum: " << max_num_bytes
+                 << " bytes)";
+    return false;
+  }
+
+  current_num_bytes_ += num_bytes;
+  return true;
+}
+
+void RemoteProducerDataPipeImpl::ProcessPendingMessages() {
+  while (!pending_messages_.IsEmpty()) {
+    scoped_ptr<MessageInTransit> message(pending_messages_.GetMessage());
+    if (!ProcessMessage(message.get())) {
+      pending_messages_.Clear();
+      if (producer_open())
+        Disconnect();
+      return;
+    }
+  }
 }
 
 void RemoteProducerDataPipeImpl::EnsureBuffer() {
-  DCHECK(producer_open());
-  if (buffer_)
+  if (buffer_ || ring_)
     return;
+  DCHECK(producer_open());
   buffer_.reset(static_cast<char*>(
       base::AlignedAlloc(capacity_num_bytes(),
                          GetConfiguration().data_pipe_buffer_alignment_bytes)));
@@ -416,6 +658,9 @@ void RemoteProducerDataPipeImpl::DestroyBuffer() {
     memset(buffer_.get(), 0xcd, capacity_num_bytes());
 #endif
   buffer_.reset();
+  // The producer may still have the ring buffer mapped, so don't scribble on
+  // it.
+  ring_.reset();
 }
 
 size_t RemoteProducerDataPipeImpl::GetMaxNumBytesToWrite() {
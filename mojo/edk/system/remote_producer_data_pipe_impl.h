@@ -8,19 +8,22 @@
 #include "base/memory/aligned_memory.h"
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
+#include "mojo/edk/embedder/platform_shared_buffer.h"
 #include "mojo/edk/system/channel_endpoint.h"
 #include "mojo/edk/system/data_pipe_impl.h"
+#include "mojo/edk/system/message_in_transit_queue.h"
 #include "mojo/edk/system/system_impl_export.h"
 #include "mojo/public/cpp/system/macros.h"
 
 namespace mojo {
 namespace system {
 
-class MessageInTransitQueue;
-
 // |RemoteProducerDataPipeImpl| is a subclass that "implements" |DataPipe| for
 // data pipes whose producer is remote and whose consumer is local. See
 // |DataPipeImpl| for more details.
+//
+// The producer may set up a ring buffer shared with us (see
+// |RemoteConsumerDataPipeImpl|), which then replaces |buffer_|.
 class MOJO_SYSTEM_IMPL_EXPORT RemoteProducerDataPipeImpl final
     : public DataPipeImpl {
  public:
@@ -92,6 +95,18 @@ class MOJO_SYSTEM_IMPL_EXPORT RemoteProducerDataPipeImpl final
   void EnsureBuffer();
   void DestroyBuffer();
 
+  // The circular buffer: |ring_|'s if there is one, otherwise |buffer_|.
+  char* buffer() const {
+    return ring_ ? static_cast<char*>(ring_->GetBase()) : buffer_.get();
+  }
+
+  // Handles a message from the producer. Returns false if it is invalid.
+  bool ProcessMessage(MessageInTransit* message);
+  bool ProcessRingMessage(MessageInTransit* message);
+  bool ProcessRingDataMessage(const MessageInTransit* message);
+  // Processes the messages held back during a two-phase read.
+  void ProcessPendingMessages();
+
   // Get the maximum (single) write/read size right now (in number of elements);
   // result fits in a |uint32_t|.
   size_t GetMaxNumBytesToWrite();
@@ -108,10 +123,16 @@ class MOJO_SYSTEM_IMPL_EXPORT RemoteProducerDataPipeImpl final
   scoped_refptr<ChannelEndpoint> channel_endpoint_;
 
   scoped_ptr<char, base::AlignedFreeDeleter> buffer_;
+  scoped_ptr<embedder::PlatformSharedBufferMapping> ring_;
   // Circular buffer.
   size_t start_index_;
   size_t current_num_bytes_;
 
+  // Setting up a ring buffer moves the data, so it can't be done during a
+  // two-phase read. Messages received from then on are held here until the
+  // two-phase read ends.
+  MessageInTransitQueue pending_messages_;
+
   MOJO_DISALLOW_COPY_AND_ASSIGN(RemoteProducerDataPipeImpl);
 };
 
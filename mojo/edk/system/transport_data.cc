@@ -113,8 +113,7 @@ TransportData::TransportData(scoped_ptr<DispatcherVector> dispatchers,
     DCHECK_LE(estimated_size, GetMaxBufferSize());
   }
 
-  buffer_.reset(static_cast<char*>(
-      base::AlignedAlloc(estimated_size, MessageInTransit::kMessageAlignment)));
+  buffer_.reset(static_cast<char*>(AllocMessageBuffer(estimated_size)));
   // Entirely clear out the secondary buffer, since then we won't have to worry
   // about clearing padding or unused space (e.g., if a dispatcher fails to
   // serialize).
@@ -198,8 +197,7 @@ TransportData::TransportData(
   buffer_size_ = MessageInTransit::RoundUpMessageAlignment(
       sizeof(Header) +
       platform_handles_->size() * serialized_platform_handle_size);
-  buffer_.reset(static_cast<char*>(
-      base::AlignedAlloc(buffer_size_, MessageInTransit::kMessageAlignment)));
+  buffer_.reset(static_cast<char*>(AllocMessageBuffer(buffer_size_)));
   memset(buffer_.get(), 0, buffer_size_);
 
   Header* header = reinterpret_cast<Header*>(buffer_.get());
@@ -9,12 +9,12 @@
 
 #include <vector>
 
-#include "base/memory/aligned_memory.h"
 #include "base/memory/scoped_ptr.h"
 #include "build/build_config.h"
 #include "mojo/edk/embedder/platform_handle.h"
 #include "mojo/edk/embedder/platform_handle_vector.h"
 #include "mojo/edk/system/dispatcher.h"
+#include "mojo/edk/system/message_buffer_pool.h"
 #include "mojo/edk/system/system_impl_export.h"
 #include "mojo/public/cpp/system/macros.h"
 
@@ -174,7 +174,7 @@ class MOJO_SYSTEM_IMPL_EXPORT TransportData {
   }
 
   size_t buffer_size_;
-  scoped_ptr<char, base::AlignedFreeDeleter> buffer_;  // Never null.
+  scoped_ptr<char, MessageBufferDeleter> buffer_;  // Never null.
 
   // Any platform-specific handles attached to this message (for inter-process
   // transport). The vector (if any) owns the handles that it contains (and is
@@ -0,0 +1,236 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/edk/system/wait_set_dispatcher.h"
+
+#include "base/logging.h"
+
+namespace mojo {
+namespace system {
+
+Dispatcher::Type WaitSetDispatcher::GetType() const {
+  return Type::WAIT_SET;
+}
+
+MojoResult WaitSetDispatcher::Add(const scoped_refptr<Dispatcher>& dispatcher,
+                                  MojoHandleSignals signals,
+                                  uint64_t cookie) {
+  // This also catches adding a wait set to itself.
+  if (dispatcher->GetType() == Type::WAIT_SET)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  MutexLocker locker(&mutex());
+  if (closed_)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+  if (ids_.find(dispatcher.get()) != ids_.end())
+    return MOJO_RESULT_ALREADY_EXISTS;
+
+  uint32_t id = next_id_++;
+  MojoResult result = dispatcher->AddAwakable(this, signals, id, nullptr);
+  if (result == MOJO_RESULT_INVALID_ARGUMENT)
+    return result;  // |dispatcher| was closed.
+
+  Entry& entry = entries_[id];
+  entry.dispatcher = dispatcher;
+  entry.signals = signals;
+  entry.cookie = cookie;
+  ids_[dispatcher.get()] = id;
+
+  // If it's already ready (or never can be), it'll be reported by the next
+  // |GetReady()|.
+  if (result != MOJO_RESULT_OK) {
+    MutexLocker ready_locker(&ready_mutex_);
+    AddReadyNoLock(id);
+  }
+  return MOJO_RESULT_OK;
+}
+
+MojoResult WaitSetDispatcher::Remove(Dispatcher* dispatcher) {
+  MutexLocker locker(&mutex());
+  if (closed_)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  auto it = ids_.find(dispatcher);
+  if (it == ids_.end())
+    return MOJO_RESULT_NOT_FOUND;
+
+  // Its ID may be left in |ready_|; |GetReady()| will skip it.
+  dispatcher->RemoveAwakable(this, nullptr);
+  entries_.erase(it->second);
+  ids_.erase(it);
+  return MOJO_RESULT_OK;
+}
+
+MojoResult WaitSetDispatcher::GetReady(uint32_t max_results,
+                                       std::vector<Result>* results) {
+  MutexLocker locker(&mutex());
+  if (closed_)
+    return MOJO_RESULT_INVALID_ARGUMENT;
+
+  // Re-registering with the dispatchers can't be done under |ready_mutex_|
+  // (see the class comment), so work on a copy.
+  std::deque<uint32_t> ready;
+  {
+    MutexLocker ready_locker(&ready_mutex_);
+    ready.swap(ready_);
+  }
+
+  std::deque<uint32_t> still_ready;
+  uint32_t num_results = 0;
+  while (!ready.empty() && num_results < max_results) {
+    uint32_t id = ready.front();
+    ready.pop_front();
+    auto it = entries_.find(id);
+    if (it == entries_.end())
+      continue;  // Removed.
+
+    const Entry& entry = it->second;
+    Result result;
+    result.cookie = entry.cookie;
+    switch (entry.dispatcher->AddAwakable(this, entry.signals, id,
+                                          &result.signals_state)) {
+      case MOJO_RESULT_OK:
+        // No longer ready, and registered again.
+        continue;
+      case MOJO_RESULT_ALREADY_EXISTS:
+        result.result = MOJO_RESULT_OK;
+        break;
+      case MOJO_RESULT_FAILED_PRECONDITION:
+        result.result = MOJO_RESULT_FAILED_PRECONDITION;
+        break;
+      default:
+        // |MOJO_RESULT_INVALID_ARGUMENT|: the dispatcher has been closed.
+        result.result = MOJO_RESULT_CANCELLED;
+        break;
+    }
+    results->push_back(result);
+    num_results++;
+    still_ready.push_back(id);
+  }
+
+  // Put back what's still (possibly) ready. Those not looked at go first, and
+  // those just reported last, so that all ready dispatchers get reported even
+  // if there are more than |max_results| of them.
+  MutexLocker ready_locker(&ready_mutex_);
+  ready.insert(ready.end(), ready_.begin(), ready_.end());
+  ready.insert(ready.end(), still_ready.begin(), still_ready.end());
+  ready_.swap(ready);
+  // Waiters may have seen |ready_| empty meanwhile.
+  if (!ready_.empty())
+    awakable_list_.AwakeForStateChange(GetHandleSignalsStateNoLock());
+  return MOJO_RESULT_OK;
+}
+
+bool WaitSetDispatcher::Awake(MojoResult /*result*/, uintptr_t context) {
+  // The result is worked out again by |GetReady()|, since it may have changed
+  // by then anyway.
+  MutexLocker locker(&ready_mutex_);
+  AddReadyNoLock(static_cast<uint32_t>(context));
+  // Don't stay registered; |GetReady()| registers again if necessary.
+  return false;
+}
+
+WaitSetDispatcher::WaitSetDispatcher() : closed_(false), next_id_(0) {
+}
+
+WaitSetDispatcher::~WaitSetDispatcher() {
+  DCHECK(entries_.empty());
+}
+
+void WaitSetDispatcher::RemoveAllNoLock() {
+  mutex().AssertHeld();
+  for (auto& it : entries_)
+    it.second.dispatcher->RemoveAwakable(this, nullptr);
+  entries_.clear();
+  ids_.clear();
+
+  MutexLocker locker(&ready_mutex_);
+  ready_.clear();
+}
+
+void WaitSetDispatcher::AddReadyNoLock(uint32_t id) {
+  ready_mutex_.AssertHeld();
+  ready_.push_back(id);
+  if (ready_.size() == 1)
+    awakable_list_.AwakeForStateChange(GetHandleSignalsStateNoLock());
+}
+
+HandleSignalsState WaitSetDispatcher::GetHandleSignalsStateNoLock() const {
+  ready_mutex_.AssertHeld();
+  HandleSignalsState rv;
+  rv.satisfiable_signals = MOJO_HANDLE_SIGNAL_READABLE;
+  if (!ready_.empty())
+    rv.satisfied_signals = MOJO_HANDLE_SIGNAL_READABLE;
+  return rv;
+}
+
+void WaitSetDispatcher::CancelAllAwakablesNoLock() {
+  mutex().AssertHeld();
+  MutexLocker locker(&ready_mutex_);
+  awakable_list_.CancelAll();
+}
+
+void WaitSetDispatcher::CloseImplNoLock() {
+  mutex().AssertHeld();
+  closed_ = true;
+  RemoveAllNoLock();
+}
+
+scoped_refptr<Dispatcher>
+WaitSetDispatcher::CreateEquivalentDispatcherAndCloseImplNoLock() {
+  mutex().AssertHeld();
+  closed_ = true;
+
+  std::vector<Entry> entries;
+  for (const auto& it : entries_)
+    entries.push_back(it.second);
+  RemoveAllNoLock();
+
+  scoped_refptr<WaitSetDispatcher> rv = Create();
+  for (const Entry& entry : entries)
+    rv->Add(entry.dispatcher, entry.signals, entry.cookie);
+  return scoped_refptr<Dispatcher>(rv.get());
+}
+
+HandleSignalsState WaitSetDispatcher::GetHandleSignalsStateImplNoLock() const {
+  mutex().AssertHeld();
+  MutexLocker locker(&ready_mutex_);
+  return GetHandleSignalsStateNoLock();
+}
+
+MojoResult WaitSetDispatcher::AddAwakableImplNoLock(
+    Awakable* awakable,
+    MojoHandleSignals signals,
+    uint32_t context,
+    HandleSignalsState* signals_state) {
+  mutex().AssertHeld();
+  MutexLocker locker(&ready_mutex_);
+  HandleSignalsState state(GetHandleSignalsStateNoLock());
+  if (state.satisfies(signals)) {
+    if (signals_state)
+      *signals_state = state;
+    return MOJO_RESULT_ALREADY_EXISTS;
+  }
+  if (!state.can_satisfy(signals)) {
+    if (signals_state)
+      *signals_state = state;
+    return MOJO_RESULT_FAILED_PRECONDITION;
+  }
+
+  awakable_list_.Add(awakable, signals, context);
+  return MOJO_RESULT_OK;
+}
+
+void WaitSetDispatcher::RemoveAwakableImplNoLock(
+    Awakable* awakable,
+    HandleSignalsState* signals_state) {
+  mutex().AssertHeld();
+  MutexLocker locker(&ready_mutex_);
+  awakable_list_.Remove(awakable);
+  if (signals_state)
+    *signals_state = GetHandleSignalsStateNoLock();
+}
+
+}  // namespace system
+}  // namespace mojo
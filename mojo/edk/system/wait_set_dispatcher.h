@@ -0,0 +1,137 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef MOJO_EDK_SYSTEM_WAIT_SET_DISPATCHER_H_
+#define MOJO_EDK_SYSTEM_WAIT_SET_DISPATCHER_H_
+
+#include <stdint.h>
+
+#include <deque>
+#include <vector>
+
+#include "base/containers/hash_tables.h"
+#include "mojo/edk/system/awakable.h"
+#include "mojo/edk/system/awakable_list.h"
+#include "mojo/edk/system/dispatcher.h"
+#include "mojo/edk/system/handle_signals_state.h"
+#include "mojo/edk/system/mutex.h"
+#include "mojo/edk/system/system_impl_export.h"
+#include "mojo/public/cpp/system/macros.h"
+
+namespace mojo {
+namespace system {
+
+// A dispatcher for a "wait set": a set of handles (dispatchers), each with
+// signals to wait for. Unlike |Core::WaitMany()|, which adds an awakable to
+// every dispatcher and removes it again on each call, a wait set stays
+// registered with its dispatchers between waits, so getting the ready ones
+// costs time proportional to the number of ready dispatchers, not the size of
+// the set.
+//
+// Once a dispatcher has woken the wait set, it is no longer registered with
+// it; |GetReady()| registers it again if it turns out to no longer be ready.
+// Otherwise it is reported as ready (again) every time, until it is removed.
+//
+// The wait set is itself readable when some dispatcher in it may be ready, so
+// it can be waited on like any other handle (see |Core::WaitSetWait()|).
+//
+// Locking: |GetReady()|, |Add()| and |Remove()| call into the dispatchers in
+// the set under |mutex()|. |Awake()| is called under those dispatchers' locks,
+// so it only takes |ready_mutex_|. Wait sets can't be added to wait sets, which
+// keeps this acyclic.
+class MOJO_SYSTEM_IMPL_EXPORT WaitSetDispatcher final : public Dispatcher,
+                                                        public Awakable {
+ public:
+  static scoped_refptr<WaitSetDispatcher> Create() {
+    return make_scoped_refptr(new WaitSetDispatcher());
+  }
+
+  // A dispatcher that is ready, as reported by |GetReady()|.
+  struct Result {
+    // The cookie given to |Add()|.
+    uint64_t cookie;
+    // |MOJO_RESULT_OK| if the signals are satisfied,
+    // |MOJO_RESULT_FAILED_PRECONDITION| if they never can be, and
+    // |MOJO_RESULT_CANCELLED| if the dispatcher was closed (e.g., because its
+    // handle was closed or sent over a message pipe).
+    MojoResult result;
+    HandleSignalsState signals_state;
+  };
+
+  // |Dispatcher| public methods:
+  Type GetType() const override;
+
+  // Adds |dispatcher| to the set, waiting for |signals|. Returns
+  // |MOJO_RESULT_ALREADY_EXISTS| if it is in the set already, and
+  // |MOJO_RESULT_INVALID_ARGUMENT| if it (or this wait set) is closed or if it
+  // is a wait set.
+  MojoResult Add(const scoped_refptr<Dispatcher>& dispatcher,
+                 MojoHandleSignals signals,
+                 uint64_t cookie);
+
+  // Removes |dispatcher| from the set. Returns |MOJO_RESULT_NOT_FOUND| if it
+  // isn't in the set, and |MOJO_RESULT_INVALID_ARGUMENT| if this wait set is
+  // closed.
+  MojoResult Remove(Dispatcher* dispatcher);
+
+  // Appends up to |max_results| ready dispatchers to |*results|, without
+  // waiting. Returns |MOJO_RESULT_INVALID_ARGUMENT| if this wait set is closed.
+  MojoResult GetReady(uint32_t max_results, std::vector<Result>* results);
+
+  // |Awakable| implementation:
+  bool Awake(MojoResult result, uintptr_t context) override;
+
+ private:
+  struct Entry {
+    scoped_refptr<Dispatcher> dispatcher;
+    MojoHandleSignals signals;
+    uint64_t cookie;
+  };
+
+  WaitSetDispatcher();
+  ~WaitSetDispatcher() override;
+
+  // Unregisters from all the dispatchers in the set and empties it.
+  void RemoveAllNoLock() MOJO_EXCLUSIVE_LOCKS_REQUIRED(mutex());
+  // Marks the entry with the given ID as (possibly) ready.
+  void AddReadyNoLock(uint32_t id) MOJO_EXCLUSIVE_LOCKS_REQUIRED(ready_mutex_);
+  HandleSignalsState GetHandleSignalsStateNoLock() const
+      MOJO_SHARED_LOCKS_REQUIRED(ready_mutex_);
+
+  // |Dispatcher| protected methods:
+  void CancelAllAwakablesNoLock() override;
+  void CloseImplNoLock() override;
+  scoped_refptr<Dispatcher> CreateEquivalentDispatcherAndCloseImplNoLock()
+      override;
+  HandleSignalsState GetHandleSignalsStateImplNoLock() const override;
+  MojoResult AddAwakableImplNoLock(Awakable* awakable,
+                                   MojoHandleSignals signals,
+                                   uint32_t context,
+                                   HandleSignalsState* signals_state) override;
+  void RemoveAwakableImplNoLock(Awakable* awakable,
+                                HandleSignalsState* signals_state) override;
+
+  // Set by |CloseImplNoLock()|, since |Add()| and friends aren't called via
+  // |Dispatcher| (which otherwise checks this).
+  bool closed_ MOJO_GUARDED_BY(mutex());
+  // Entries are keyed by an ID (used as the awakable context), which is never
+  // reused, so stale IDs in |ready_| are simply skipped.
+  uint32_t next_id_ MOJO_GUARDED_BY(mutex());
+  base::hash_map<uint32_t, Entry> entries_ MOJO_GUARDED_BY(mutex());
+  base::hash_map<Dispatcher*, uint32_t> ids_ MOJO_GUARDED_BY(mutex());
+
+  mutable Mutex ready_mutex_;
+  // IDs of entries that have woken us (or were ready when added) and are no
+  // longer registered with their dispatchers.
+  std::deque<uint32_t> ready_ MOJO_GUARDED_BY(ready_mutex_);
+  // Awakables waiting on this wait set itself.
+  AwakableList awakable_list_ MOJO_GUARDED_BY(ready_mutex_);
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(WaitSetDispatcher);
+};
+
+}  // namespace system
+}  // namespace mojo
+
+#endif  // MOJO_EDK_SYSTEM_WAIT_SET_DISPATCHER_H_
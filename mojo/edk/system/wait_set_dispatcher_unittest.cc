@@ -0,0 +1,166 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "mojo/edk/system/wait_set_dispatcher.h"
+
+#include <stdint.h>
+
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "mojo/edk/system/message_pipe.h"
+#include "mojo/edk/system/message_pipe_dispatcher.h"
+#include "mojo/edk/system/waiter.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+void CreateMessagePipe(scoped_refptr<MessagePipeDispatcher>* d0,
+                       scoped_refptr<MessagePipeDispatcher>* d1) {
+  *d0 = MessagePipeDispatcher::Create(
+      MessagePipeDispatcher::kDefaultCreateOptions);
+  *d1 = MessagePipeDispatcher::Create(
+      MessagePipeDispatcher::kDefaultCreateOptions);
+  scoped_refptr<MessagePipe> mp(MessagePipe::CreateLocalLocal());
+  (*d0)->Init(mp, 0);
+  (*d1)->Init(mp, 1);
+}
+
+void WriteByte(MessagePipeDispatcher* d) {
+  static const char kByte = 'x';
+  EXPECT_EQ(MOJO_RESULT_OK,
+            d->WriteMessage(UserPointer<const void>(&kByte), 1, nullptr,
+                            MOJO_WRITE_MESSAGE_FLAG_NONE));
+}
+
+void ReadByte(MessagePipeDispatcher* d) {
+  char byte = 0;
+  uint32_t num_bytes = 1;
+  EXPECT_EQ(MOJO_RESULT_OK,
+            d->ReadMessage(UserPointer<void>(&byte),
+                           MakeUserPointer(&num_bytes), nullptr, nullptr,
+                           MOJO_READ_MESSAGE_FLAG_NONE));
+}
+
+TEST(WaitSetDispatcherTest, Basic) {
+  scoped_refptr<WaitSetDispatcher> wait_set = WaitSetDispatcher::Create();
+  EXPECT_EQ(Dispatcher::Type::WAIT_SET, wait_set->GetType());
+
+  scoped_refptr<MessagePipeDispatcher> a0, a1, b0, b1;
+  CreateMessagePipe(&a0, &a1);
+  CreateMessagePipe(&b0, &b1);
+
+  EXPECT_EQ(MOJO_RESULT_OK,
+            wait_set->Add(a0, MOJO_HANDLE_SIGNAL_READABLE, 100));
+  EXPECT_EQ(MOJO_RESULT_OK,
+            wait_set->Add(b0, MOJO_HANDLE_SIGNAL_READABLE, 200));
+  EXPECT_EQ(MOJO_RESULT_ALREADY_EXISTS,
+            wait_set->Add(a0, MOJO_HANDLE_SIGNAL_WRITABLE, 300));
+  EXPECT_EQ(MOJO_RESULT_INVALID_ARGUMENT,
+            wait_set->Add(wait_set, MOJO_HANDLE_SIGNAL_READABLE, 400));
+
+  // Nothing is ready.
+  std::vector<WaitSetDispatcher::Result> results;
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  EXPECT_TRUE(results.empty());
+  EXPECT_FALSE(wait_set->GetHandleSignalsState().satisfied_signals &
+               MOJO_HANDLE_SIGNAL_READABLE);
+
+  // Waiting on the wait set is woken when a handle in it becomes ready.
+  Waiter waiter;
+  waiter.Init();
+  ASSERT_EQ(MOJO_RESULT_OK, wait_set->AddAwakable(
+                                &waiter, MOJO_HANDLE_SIGNAL_READABLE, 1,
+                                nullptr));
+  WriteByte(b1.get());
+  uint32_t context = 0;
+  EXPECT_EQ(MOJO_RESULT_OK, waiter.Wait(MOJO_DEADLINE_INDEFINITE, &context));
+  EXPECT_EQ(1u, context);
+  wait_set->RemoveAwakable(&waiter, nullptr);
+
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(200u, results[0].cookie);
+  EXPECT_EQ(MOJO_RESULT_OK, results[0].result);
+  EXPECT_TRUE(results[0].signals_state.satisfied_signals &
+              MOJO_HANDLE_SIGNAL_READABLE);
+
+  // It stays ready until the message is read.
+  results.clear();
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(200u, results[0].cookie);
+  ReadByte(b0.get());
+  results.clear();
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  EXPECT_TRUE(results.empty());
+
+  // Both ready; |max_results| limits how many are reported at once, and the
+  // rest are reported next.
+  WriteByte(a1.get());
+  WriteByte(b1.get());
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(1, &results));
+  ASSERT_EQ(1u, results.size());
+  uint64_t first_cookie = results[0].cookie;
+  results.clear();
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(1, &results));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_NE(first_cookie, results[0].cookie);
+  ReadByte(a0.get());
+  ReadByte(b0.get());
+
+  // Removed handles aren't reported.
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->Remove(a0.get()));
+  EXPECT_EQ(MOJO_RESULT_NOT_FOUND, wait_set->Remove(a0.get()));
+  WriteByte(a1.get());
+  results.clear();
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  EXPECT_TRUE(results.empty());
+
+  // Closing the peer makes the signals unsatisfiable.
+  EXPECT_EQ(MOJO_RESULT_OK, b1->Close());
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(200u, results[0].cookie);
+  EXPECT_EQ(MOJO_RESULT_FAILED_PRECONDITION, results[0].result);
+
+  // Closing a handle in the set reports it as cancelled.
+  EXPECT_EQ(MOJO_RESULT_OK, b0->Close());
+  results.clear();
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(200u, results[0].cookie);
+  EXPECT_EQ(MOJO_RESULT_CANCELLED, results[0].result);
+
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->Close());
+  EXPECT_EQ(MOJO_RESULT_INVALID_ARGUMENT, wait_set->GetReady(10, &results));
+  EXPECT_EQ(MOJO_RESULT_OK, a0->Close());
+  EXPECT_EQ(MOJO_RESULT_OK, a1->Close());
+}
+
+TEST(WaitSetDispatcherTest, ReadyWhenAdded) {
+  scoped_refptr<WaitSetDispatcher> wait_set = WaitSetDispatcher::Create();
+  scoped_refptr<MessagePipeDispatcher> d0, d1;
+  CreateMessagePipe(&d0, &d1);
+
+  EXPECT_EQ(MOJO_RESULT_OK,
+            wait_set->Add(d0, MOJO_HANDLE_SIGNAL_WRITABLE, 1));
+  EXPECT_TRUE(wait_set->GetHandleSignalsState().satisfied_signals &
+              MOJO_HANDLE_SIGNAL_READABLE);
+  std::vector<WaitSetDispatcher::Result> results;
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->GetReady(10, &results));
+  ASSERT_EQ(1u, results.size());
+  EXPECT_EQ(1u, results[0].cookie);
+  EXPECT_EQ(MOJO_RESULT_OK, results[0].result);
+
+  EXPECT_EQ(MOJO_RESULT_OK, wait_set->Close());
+  EXPECT_EQ(MOJO_RESULT_OK, d0->Close());
+  EXPECT_EQ(MOJO_RESULT_OK, d1->Close());
+}
+
+}  // namespace
+}  // namespace system
+}  // namespace mojo
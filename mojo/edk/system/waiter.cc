@@ -4,14 +4,44 @@
 
 #include "mojo/edk/system/waiter.h"
 
+#include <algorithm>
 #include <limits>
 
 #include "base/logging.h"
-#include "base/time/time.h"
+#include "base/sys_info.h"
+#include "base/threading/platform_thread.h"
+#include "mojo/edk/system/configuration.h"
 
 namespace mojo {
 namespace system {
 
+namespace {
+
+// How long waiters spin before blocking, in microseconds. This is shared by all
+// waiters and follows (twice) the duration of recent waits that ended within
+// |Configuration::max_waiter_spin_microseconds|, decaying to zero while waits
+// take longer than that. Updates race, which is fine for a heuristic.
+base::subtle::Atomic32 g_spin_microseconds = 0;
+
+// While spinning, the number of checks between reads of the clock doubles up
+// to this; after that, each round also yields.
+const int kMaxSpinChecksPerRound = 64;
+
+void UpdateSpinMicroseconds(int64_t wait_microseconds) {
+  const int64_t max_spin_microseconds =
+      static_cast<int64_t>(GetConfiguration().max_waiter_spin_microseconds);
+  const int64_t target =
+      wait_microseconds <= max_spin_microseconds
+          ? std::min(max_spin_microseconds, 2 * wait_microseconds)
+          : 0;
+  const int64_t current = base::subtle::NoBarrier_Load(&g_spin_microseconds);
+  base::subtle::NoBarrier_Store(
+      &g_spin_microseconds,
+      static_cast<base::subtle::Atomic32>((3 * current + target) / 4));
+}
+
+}  // namespace
+
 Waiter::Waiter()
     : cv_(&lock_),
 #ifndef NDEBUG
@@ -19,7 +49,8 @@ Waiter::Waiter()
 #endif
       awoken_(false),
       awake_result_(MOJO_RESULT_INTERNAL),
-      awake_context_(static_cast<uint32_t>(-1)) {
+      awake_context_(static_cast<uint32_t>(-1)),
+      awoken_for_spin_(0) {
 }
 
 Waiter::~Waiter() {
@@ -30,6 +61,7 @@ void Waiter::Init() {
   initialized_ = true;
 #endif
   awoken_ = false;
+  base::subtle::NoBarrier_Store(&awoken_for_spin_, 0);
   // NOTE(vtl): If performance ever becomes an issue, we can disable the setting
   // of |awake_result_| (except the first one in |Awake()|) in Release builds.
   awake_result_ = MOJO_RESULT_INTERNAL;
@@ -53,28 +85,41 @@ MojoResult Waiter::Wait(MojoDeadline deadline, uint32_t* context) {
     return awake_result_;
   }
 
+  const base::TimeTicks start_time = base::TimeTicks::Now();
+
+  // Spin briefly before blocking. (That's pointless on a single processor,
+  // since whatever would wake us can't run meanwhile.)
+  const uint64_t spin_microseconds =
+      std::min(deadline, static_cast<uint64_t>(base::subtle::NoBarrier_Load(
+                             &g_spin_microseconds)));
+  if (spin_microseconds > 0 && base::SysInfo::NumberOfProcessors() > 1) {
+    base::AutoUnlock unlocker(lock_);
+    SpinUntil(start_time + base::TimeDelta::FromMicroseconds(
+                               static_cast<int64_t>(spin_microseconds)));
+  }
+
   // |MojoDeadline| is actually a |uint64_t|, but we need a signed quantity.
   // Treat any out-of-range deadline as "forever" (which is wrong, but okay
   // since 2^63 microseconds is ~300000 years). Note that this also takes care
   // of the |MOJO_DEADLINE_INDEFINITE| (= 2^64 - 1) case.
   if (deadline > static_cast<uint64_t>(std::numeric_limits<int64_t>::max())) {
-    do {
+    while (!awoken_)
       cv_.Wait();
-    } while (!awoken_);
   } else {
     // NOTE(vtl): This is very inefficient on POSIX, since pthreads condition
     // variables take an absolute deadline.
     const base::TimeTicks end_time =
-        base::TimeTicks::Now() +
+        start_time +
         base::TimeDelta::FromMicroseconds(static_cast<int64_t>(deadline));
-    do {
+    while (!awoken_) {
       base::TimeTicks now_time = base::TimeTicks::Now();
       if (now_time >= end_time)
         return MOJO_RESULT_DEADLINE_EXCEEDED;
 
       cv_.TimedWait(end_time - now_time);
-    } while (!awoken_);
+    }
   }
+  UpdateSpinMicroseconds((base::TimeTicks::Now() - start_time).InMicroseconds());
 
   DCHECK_NE(awake_result_, MOJO_RESULT_INTERNAL);
   if (context)
@@ -91,10 +136,27 @@ bool Waiter::Awake(MojoResult result, uintptr_t context) {
   awoken_ = true;
   awake_result_ = result;
   awake_context_ = context;
+  base::subtle::Release_Store(&awoken_for_spin_, 1);
   cv_.Signal();
   // |cv_.Wait()|/|cv_.TimedWait()| will return after |lock_| is released.
   return true;
 }
 
+void Waiter::SpinUntil(base::TimeTicks end_time) {
+  int num_checks = 1;
+  for (;;) {
+    for (int i = 0; i < num_checks; i++) {
+      if (base::subtle::Acquire_Load(&awoken_for_spin_))
+        return;
+    }
+    if (base::TimeTicks::Now() >= end_time)
+      return;
+    if (num_checks < kMaxSpinChecksPerRound)
+      num_checks *= 2;
+    else
+      base::PlatformThread::YieldCurrentThread();
+  }
+}
+
 }  // namespace system
 }  // namespace mojo
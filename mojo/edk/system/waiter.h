@@ -7,8 +7,10 @@
 
 #include <stdint.h>
 
+#include "base/atomicops.h"
 #include "base/synchronization/condition_variable.h"
 #include "base/synchronization/lock.h"
+#include "base/time/time.h"
 #include "mojo/edk/system/awakable.h"
 #include "mojo/edk/system/system_impl_export.h"
 #include "mojo/public/c/system/types.h"
@@ -21,6 +23,12 @@ namespace system {
 // under other locks, in particular, |Dispatcher::lock_|s, so |Waiter| methods
 // must never call out to other objects (in particular, |Dispatcher|s). This
 // class is thread-safe.
+//
+// On machines with more than one processor, |Wait()| spins for a short while
+// before blocking, since a wake-up that comes within microseconds is much
+// cheaper to catch that way than by sleeping on the condition variable. How
+// long it spins is adapted (process-wide) to how long recent waits took; see
+// |Configuration::max_waiter_spin_microseconds|.
 class MOJO_SYSTEM_IMPL_EXPORT Waiter final : public Awakable {
  public:
   Waiter();
@@ -61,6 +69,9 @@ class MOJO_SYSTEM_IMPL_EXPORT Waiter final : public Awakable {
   bool Awake(MojoResult result, uintptr_t context) override;
 
  private:
+  // Spins (without |lock_|) until awoken or until |end_time|.
+  void SpinUntil(base::TimeTicks end_time);
+
   base::ConditionVariable cv_;  // Associated to |lock_|.
   base::Lock lock_;             // Protects the following members.
 #ifndef NDEBUG
@@ -69,6 +80,9 @@ class MOJO_SYSTEM_IMPL_EXPORT Waiter final : public Awakable {
   bool awoken_;
   MojoResult awake_result_;
   uintptr_t awake_context_;
+  // Mirrors |awoken_|, so that |SpinUntil()| can check it without |lock_|. Only
+  // written under |lock_|.
+  base::subtle::Atomic32 awoken_for_spin_;
 
   MOJO_DISALLOW_COPY_AND_ASSIGN(Waiter);
 };
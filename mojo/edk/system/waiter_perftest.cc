@@ -0,0 +1,93 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <string>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/stringprintf.h"
+#include "base/test/perf_time_logger.h"
+#include "base/threading/simple_thread.h"
+#include "mojo/edk/system/configuration.h"
+#include "mojo/edk/system/waiter.h"
+#include "mojo/public/cpp/system/macros.h"
+#include "testing/gtest/include/gtest/gtest.h"
+
+namespace mojo {
+namespace system {
+namespace {
+
+const int kRoundTripCount = 20000;
+
+// Waits for each "ping" and immediately answers it with a "pong".
+class PongThread : public base::SimpleThread {
+ public:
+  PongThread(Waiter* pings, Waiter* pongs)
+      : base::SimpleThread("pong_thread"), pings_(pings), pongs_(pongs) {}
+  ~PongThread() override { Join(); }
+
+  void Run() override {
+    for (int i = 0; i < kRoundTripCount; i++) {
+      CHECK_EQ(pings_[i].Wait(MOJO_DEADLINE_INDEFINITE, nullptr),
+               MOJO_RESULT_OK);
+      pongs_[i].Awake(MOJO_RESULT_OK, 0);
+    }
+  }
+
+ private:
+  Waiter* const pings_;
+  Waiter* const pongs_;
+
+  MOJO_DISALLOW_COPY_AND_ASSIGN(PongThread);
+};
+
+// Measures round trips between two threads that wake each other through
+// |Waiter|s, which is what a request/response over local message pipes comes
+// down to.
+void MeasureRoundTrips(size_t max_waiter_spin_microseconds) {
+  embedder::Configuration* configuration = GetMutableConfiguration();
+  const size_t old_max_waiter_spin_microseconds =
+      configuration->max_waiter_spin_microseconds;
+  configuration->max_waiter_spin_microseconds = max_waiter_spin_microseconds;
+
+  scoped_ptr<Waiter[]> pings(new Waiter[kRoundTripCount]);
+  scoped_ptr<Waiter[]> pongs(new Waiter[kRoundTripCount]);
+  for (int i = 0; i < kRoundTripCount; i++) {
+    pings[i].Init();
+    pongs[i].Init();
+  }
+
+  std::string test_name =
+      base::StringPrintf("Waiter_RoundTrip_%dx_spin_%uus", kRoundTripCount,
+                         static_cast<unsigned>(max_waiter_spin_microseconds));
+  {
+    PongThread thread(pings.get(), pongs.get());
+    thread.Start();
+
+    base::PerfTimeLogger logger(test_name.c_str());
+    for (int i = 0; i < kRoundTripCount; i++) {
+      pings[i].Awake(MOJO_RESULT_OK, 0);
+      CHECK_EQ(pongs[i].Wait(MOJO_DEADLINE_INDEFINITE, nullptr),
+               MOJO_RESULT_OK);
+    }
+    logger.Done();
+  }
+
+  configuration->max_waiter_spin_microseconds =
+      old_max_waiter_spin_microseconds;
+}
+
+TEST(WaiterPerfTest, RoundTripWithoutSpinning) {
+  MeasureRoundTrips(0);
+}
+
+TEST(WaiterPerfTest, RoundTripWithSpinning) {
+  MeasureRoundTrips(GetConfiguration().max_waiter_spin_microseconds);
+}
+
+}  // namespace
+}  // namespace system
+}  // namespace mojo
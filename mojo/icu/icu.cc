@@ -4,6 +4,7 @@
 
 #include "mojo/icu/icu.h"
 
+#include "base/logging.h"
 #include "mojo/icu/constants.h"
 #include "mojo/public/cpp/application/application_impl.h"
 #include "mojo/services/icu_data/public/interfaces/icu_data.mojom.h"
@@ -20,12 +21,23 @@ namespace {
 
 class Callback {
  public:
+  // The service hands out the same buffer to every process, so the data is
+  // mapped rather than copied and its pages are shared.
   void Run(mojo::ScopedSharedBufferHandle handle) const {
+    if (!handle.is_valid()) {
+      LOG(ERROR) << "The ICU data service has no data for " << kDataHash;
+      return;
+    }
     void* ptr = nullptr;
-    mojo::MapBuffer(handle.get(), 0, kDataSize, &ptr,
-                    MOJO_MAP_BUFFER_FLAG_NONE);
+    if (mojo::MapBuffer(handle.get(), 0, kDataSize, &ptr,
+                        MOJO_MAP_BUFFER_FLAG_NONE) != MOJO_RESULT_OK) {
+      LOG(ERROR) << "Could not map the ICU data";
+      return;
+    }
     UErrorCode err = U_ZERO_ERROR;
     udata_setCommonData(ptr, &err);
+    if (U_FAILURE(err))
+      LOG(ERROR) << "Invalid ICU data: " << u_errorName(err);
     // Leak the handle because we never unmap the buffer.
     (void)handle.release();
   };
@@ -7,6 +7,7 @@
 #include "base/files/file_util.h"
 #include "base/files/scoped_temp_dir.h"
 #include "base/run_loop.h"
+#include "base/strings/string_number_conversions.h"
 #include "mojo/data_pipe_utils/data_pipe_utils.h"
 #include "mojo/public/cpp/application/application_impl.h"
 #include "mojo/public/cpp/application/application_test_base.h"
@@ -92,4 +93,147 @@ TEST_F(AssetBundleAppTest, CanGetText) {
       << "Traversing outside of bundle is treated as an empty data stream";
 }
 
+TEST_F(AssetBundleAppTest, CanGetNestedLargeAsset) {
+  // Larger than a data pipe's default capacity, so the asset is copied in
+  // more than one piece.
+  std::string large_content;
+  for (int i = 0; large_content.size() < 1024 * 1024; ++i)
+    large_content += base::IntToString(i);
+
+  base::ScopedTempDir zip_dir;
+  ASSERT_TRUE(zip_dir.CreateUniqueTempDir());
+
+  base::FilePath nested_dir = zip_dir.path().Append("nested");
+  ASSERT_TRUE(base::CreateDirectory(nested_dir));
+  base::FilePath large_path = nested_dir.Append("large.txt");
+  base::WriteFile(large_path, large_content.data(), large_content.size());
+
+  base::FilePath zip_path;
+  ASSERT_TRUE(base::CreateTemporaryFile(&zip_path));
+
+  zip::Zip(zip_dir.path(), zip_path, false);
+  std::string zip_contents;
+  ASSERT_TRUE(base::ReadFileToString(zip_path, &zip_contents));
+  ASSERT_TRUE(base::DeleteFile(zip_path, false));
+
+  mojo::DataPipe zip_pipe;
+  mojo::asset_bundle::AssetBundlePtr asset_bundle;
+  asset_unpacker_->UnpackZipStream(zip_pipe.consumer_handle.Pass(),
+                                   GetProxy(&asset_bundle));
+
+  EXPECT_TRUE(mojo::common::BlockingCopyFromString(
+      zip_contents, zip_pipe.producer_handle));
+  zip_pipe.producer_handle.reset();
+
+  std::string asset_content;
+  asset_bundle->GetAsStream("nested/large.txt",
+      [&](mojo::ScopedDataPipeConsumerHandle asset_pipe) {
+    mojo::common::BlockingCopyToString(asset_pipe.Pass(), &asset_content);
+  });
+  ASSERT_TRUE(asset_bundle.WaitForIncomingResponse());
+
+  EXPECT_EQ(large_content, asset_content)
+      << "Failed to get the correct contents of a nested asset";
+
+  std::string directory_content;
+  asset_bundle->GetAsStream("nested/",
+      [&](mojo::ScopedDataPipeConsumerHandle asset_pipe) {
+    mojo::common::BlockingCopyToString(asset_pipe.Pass(), &directory_content);
+  });
+  ASSERT_TRUE(asset_bundle.WaitForIncomingResponse());
+
+  EXPECT_EQ("", directory_content)
+      << "Directories are treated as empty data streams";
+
+  mojo::ScopedSharedBufferHandle asset_buffer;
+  uint64_t asset_size = 0;
+  asset_bundle->GetAsBuffer("nested/large.txt",
+      [&](mojo::ScopedSharedBufferHandle buffer, uint64_t size) {
+    asset_buffer = buffer.Pass();
+    asset_size = size;
+  });
+  ASSERT_TRUE(asset_bundle.WaitForIncomingResponse());
+  ASSERT_TRUE(asset_buffer.is_valid());
+  ASSERT_EQ(large_content.size(), asset_size);
+
+  void* data = nullptr;
+  ASSERT_EQ(MOJO_RESULT_OK,
+            mojo::MapBuffer(asset_buffer.get(), 0, asset_size, &data,
+                            MOJO_MAP_BUFFER_FLAG_NONE));
+  EXPECT_EQ(large_content,
+            std::string(static_cast<const char*>(data), asset_size))
+      << "Failed to get the correct contents of an asset as a buffer";
+  mojo::UnmapBuffer(data);
+
+  bool got_missing_buffer = false;
+  asset_bundle->GetAsBuffer("missing.txt",
+      [&](mojo::ScopedSharedBufferHandle buffer, uint64_t size) {
+    got_missing_buffer = buffer.is_valid();
+  });
+  ASSERT_TRUE(asset_bundle.WaitForIncomingResponse());
+  EXPECT_FALSE(got_missing_buffer)
+      << "Missing asset keys have no buffer";
+}
+
+TEST_F(AssetBundleAppTest, CanGetBrotliAsset) {
+  // "Hello, Brotli!" in an uncompressed Brotli meta-block.
+  const unsigned char kBrotliContent[] = {
+      0xd0, 0x00, 0x10, 0x48, 0x65, 0x6c, 0x6c, 0x6f, 0x2c,
+      0x20, 0x42, 0x72, 0x6f, 0x74, 0x6c, 0x69, 0x21, 0x03,
+  };
+
+  base::ScopedTempDir zip_dir;
+  ASSERT_TRUE(zip_dir.CreateUniqueTempDir());
+
+  base::FilePath brotli_path = zip_dir.path().Append("greeting.txt.br");
+  base::WriteFile(brotli_path, reinterpret_cast<const char*>(kBrotliContent),
+                  sizeof(kBrotliContent));
+
+  base::FilePath zip_path;
+  ASSERT_TRUE(base::CreateTemporaryFile(&zip_path));
+
+  zip::Zip(zip_dir.path(), zip_path, false);
+  std::string zip_contents;
+  ASSERT_TRUE(base::ReadFileToString(zip_path, &zip_contents));
+  ASSERT_TRUE(base::DeleteFile(zip_path, false));
+
+  mojo::DataPipe zip_pipe;
+  mojo::asset_bundle::AssetBundlePtr asset_bundle;
+  asset_unpacker_->UnpackZipStream(zip_pipe.consumer_handle.Pass(),
+                                   GetProxy(&asset_bundle));
+
+  EXPECT_TRUE(mojo::common::BlockingCopyFromString(
+      zip_contents, zip_pipe.producer_handle));
+  zip_pipe.producer_handle.reset();
+
+  std::string asset_content;
+  asset_bundle->GetAsStream("greeting.txt",
+      [&](mojo::ScopedDataPipeConsumerHandle asset_pipe) {
+    mojo::common::BlockingCopyToString(asset_pipe.Pass(), &asset_content);
+  });
+  ASSERT_TRUE(asset_bundle.WaitForIncomingResponse());
+
+  EXPECT_EQ("Hello, Brotli!", asset_content)
+      << "Brotli assets are decoded under the name without .br";
+
+  mojo::ScopedSharedBufferHandle asset_buffer;
+  uint64_t asset_size = 0;
+  asset_bundle->GetAsBuffer("greeting.txt",
+      [&](mojo::ScopedSharedBufferHandle buffer, uint64_t size) {
+    asset_buffer = buffer.Pass();
+    asset_size = size;
+  });
+  ASSERT_TRUE(asset_bundle.WaitForIncomingResponse());
+  ASSERT_TRUE(asset_buffer.is_valid());
+  ASSERT_EQ(strlen("Hello, Brotli!"), asset_size);
+
+  void* data = nullptr;
+  ASSERT_EQ(MOJO_RESULT_OK,
+            mojo::MapBuffer(asset_buffer.get(), 0, asset_size, &data,
+                            MOJO_MAP_BUFFER_FLAG_NONE));
+  EXPECT_EQ("Hello, Brotli!",
+            std::string(static_cast<const char*>(data), asset_size));
+  mojo::UnmapBuffer(data);
+}
+
 }  // namespace asset_bundle
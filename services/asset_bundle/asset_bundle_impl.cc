@@ -4,30 +4,345 @@
 
 #include "services/asset_bundle/asset_bundle_impl.h"
 
+#include <algorithm>
+#include <limits>
+
 #include "base/bind.h"
+#include "base/bind_helpers.h"
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
-#include "mojo/data_pipe_utils/data_pipe_utils.h"
+#include "base/message_loop/message_loop.h"
+#include "base/single_thread_task_runner.h"
+#include "base/strings/string_split.h"
+#include "base/task_runner_util.h"
+#include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_synthetic_delay.h"
+#include "mojo/public/cpp/environment/async_waiter.h"
+#include "mojo/public/cpp/system/buffer.h"
+#include "services/asset_bundle/zip_entry_reader.h"
 
 namespace mojo {
 namespace asset_bundle {
 namespace {
 
-void Ignored(bool) {
+// The bundle's list of assets to read ahead of time, one name per line.
+const char kPrefetchManifestKey[] = "prefetch_manifest.txt";
+
+// Prefetched assets are held in memory until they are asked for, so only
+// this much is read ahead at a time.
+const uint64_t kMaxPrefetchBytes = 32 * 1024 * 1024;
+
+// Copies one entry of a zip into a data pipe. Like common::CopyFromFile, the
+// zip is read on the worker runner while waiting for room in the pipe happens
+// on the thread the copy was started on, and the copier deletes itself when
+// it is done. Entries that have been prefetched are copied from |data|
+// without going through the worker.
+class ZipEntryCopier {
+ public:
+  ZipEntryCopier(const base::FilePath& zip_path,
+                 const ZipAssetIndex::Entry& entry,
+                 ScopedDataPipeProducerHandle destination,
+                 scoped_refptr<base::TaskRunner> worker_runner,
+                 scoped_refptr<base::RefCountedString> data);
+  ~ZipEntryCopier();
+
+ private:
+  // Called on the worker runner.
+  void OpenEntry();
+  void ReadEntry();
+  void CloseEntry();
+
+  // Called on the thread the copy was started on.
+  void OnHandleReady(MojoResult result);
+  void CopyData();
+  void Finish();
+
+  void PostToMain(void (ZipEntryCopier::*method)());
+
+  base::FilePath zip_path_;
+  ZipAssetIndex::Entry entry_;
+  ScopedDataPipeProducerHandle destination_;
+  scoped_refptr<base::TaskRunner> worker_runner_;
+  scoped_refptr<base::SingleThreadTaskRunner> main_runner_;
+  scoped_ptr<AsyncWaiter> waiter_;
+  ZipEntryReader reader_;
+  scoped_refptr<base::RefCountedString> data_;
+  size_t data_offset_;
+
+  void* buffer_;
+  uint32_t buffer_size_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZipEntryCopier);
+};
+
+ZipEntryCopier::ZipEntryCopier(const base::FilePath& zip_path,
+                               const ZipAssetIndex::Entry& entry,
+                               ScopedDataPipeProducerHandle destination,
+                               scoped_refptr<base::TaskRunner> worker_runner,
+                               scoped_refptr<base::RefCountedString> data)
+    : zip_path_(zip_path),
+      entry_(entry),
+      destination_(destination.Pass()),
+      worker_runner_(worker_runner.Pass()),
+      main_runner_(base::MessageLoop::current()->task_runner()),
+      data_(data.Pass()),
+      data_offset_(0),
+      buffer_(nullptr),
+      buffer_size_(0u) {
+  TRACE_EVENT_ASYNC_BEGIN0("asset_bundle", "ZipEntryCopier", this);
+  if (data_) {
+    OnHandleReady(MOJO_RESULT_OK);
+    return;
+  }
+  worker_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&ZipEntryCopier::OpenEntry, base::Unretained(this)));
+}
+
+ZipEntryCopier::~ZipEntryCopier() {
+  TRACE_EVENT_ASYNC_END0("asset_bundle", "ZipEntryCopier", this);
+}
+
+void ZipEntryCopier::PostToMain(void (ZipEntryCopier::*method)()) {
+  main_runner_->PostTask(FROM_HERE, base::Bind(method, base::Unretained(this)));
+}
+
+void ZipEntryCopier::OpenEntry() {
+  DCHECK(worker_runner_->RunsTasksOnCurrentThread());
+  TRACE_EVENT_SYNTHETIC_DELAY("sky.AssetFetch");
+  if (!reader_.Open(zip_path_, entry_) || reader_.AtEnd()) {
+    PostToMain(&ZipEntryCopier::Finish);
+    return;
+  }
+  main_runner_->PostTask(FROM_HERE,
+                         base::Bind(&ZipEntryCopier::OnHandleReady,
+                                    base::Unretained(this), MOJO_RESULT_OK));
+}
+
+void ZipEntryCopier::OnHandleReady(MojoResult result) {
+  DCHECK(main_runner_->RunsTasksOnCurrentThread());
+  waiter_.reset();
+  if (result == MOJO_RESULT_OK) {
+    result = BeginWriteDataRaw(destination_.get(), &buffer_, &buffer_size_,
+                               MOJO_WRITE_DATA_FLAG_NONE);
+    if (result == MOJO_RESULT_OK && data_) {
+      CopyData();
+      return;
+    }
+    if (result == MOJO_RESULT_OK) {
+      worker_runner_->PostTask(
+          FROM_HERE,
+          base::Bind(&ZipEntryCopier::ReadEntry, base::Unretained(this)));
+      return;
+    }
+  }
+  if (result == MOJO_RESULT_SHOULD_WAIT) {
+    waiter_.reset(new AsyncWaiter(destination_.get(),
+                                  MOJO_HANDLE_SIGNAL_WRITABLE,
+                                  base::Bind(&ZipEntryCopier::OnHandleReady,
+                                             base::Unretained(this))));
+    return;
+  }
+  // The consumer went away.
+  Finish();
+}
+
+void ZipEntryCopier::CopyData() {
+  DCHECK(main_runner_->RunsTasksOnCurrentThread());
+  size_t num_bytes =
+      std::min<size_t>(buffer_size_, data_->size() - data_offset_);
+  memcpy(buffer_, data_->front() + data_offset_, num_bytes);
+  MojoResult result = EndWriteDataRaw(destination_.get(), num_bytes);
+  buffer_ = nullptr;
+  buffer_size_ = 0;
+  data_offset_ += num_bytes;
+
+  if (result != MOJO_RESULT_OK || data_offset_ == data_->size()) {
+    Finish();
+    return;
+  }
+  OnHandleReady(MOJO_RESULT_OK);
+}
+
+void ZipEntryCopier::ReadEntry() {
+  DCHECK(worker_runner_->RunsTasksOnCurrentThread());
+  int num_bytes_read = reader_.Read(
+      buffer_, static_cast<int>(std::min<uint32_t>(
+                   buffer_size_, std::numeric_limits<int>::max())));
+  MojoResult result =
+      EndWriteDataRaw(destination_.get(), std::max(0, num_bytes_read));
+  buffer_ = nullptr;
+  buffer_size_ = 0;
+
+  if (num_bytes_read < 0 || (!num_bytes_read && !reader_.AtEnd()) ||
+      result != MOJO_RESULT_OK) {
+    LOG(ERROR) << "Could not read an entry of '" << zip_path_.value() << "'.";
+    PostToMain(&ZipEntryCopier::Finish);
+    return;
+  }
+
+  if (reader_.AtEnd()) {
+    PostToMain(&ZipEntryCopier::Finish);
+    return;
+  }
+  main_runner_->PostTask(FROM_HERE,
+                         base::Bind(&ZipEntryCopier::OnHandleReady,
+                                    base::Unretained(this), MOJO_RESULT_OK));
+}
+
+void ZipEntryCopier::CloseEntry() {
+  DCHECK(worker_runner_->RunsTasksOnCurrentThread());
+  reader_.Close();
+}
+
+void ZipEntryCopier::Finish() {
+  DCHECK(main_runner_->RunsTasksOnCurrentThread());
+  // Close the pipe right away so that the consumer sees the end of the data
+  // without waiting for the worker.
+  destination_.reset();
+  worker_runner_->PostTaskAndReply(
+      FROM_HERE,
+      base::Bind(&ZipEntryCopier::CloseEntry, base::Unretained(this)),
+      base::Bind(&base::DeletePointer<ZipEntryCopier>,
+                 base::Unretained(this)));
+}
+
+// Called on the worker runner. Returns null if the entry could not be read.
+scoped_refptr<base::RefCountedString> ReadEntryToString(
+    const base::FilePath& zip_path,
+    const ZipAssetIndex::Entry& entry) {
+  TRACE_EVENT0("asset_bundle", "ReadEntryToString");
+  ZipEntryReader reader;
+  if (!reader.Open(zip_path, entry))
+    return nullptr;
+
+  // Brotli entries grow as they are decoded.
+  const size_t kChunkSize = 64 * 1024;
+  std::string data;
+  size_t offset = 0;
+  while (!reader.AtEnd()) {
+    size_t chunk_size = kChunkSize;
+    if (reader.size_known()) {
+      chunk_size = static_cast<size_t>(std::min<uint64_t>(
+          reader.remaining(), std::numeric_limits<int>::max()));
+    }
+    data.resize(offset + chunk_size);
+    int num_bytes_read =
+        reader.Read(&data[offset], static_cast<int>(chunk_size));
+    if (num_bytes_read < 0 || (!num_bytes_read && !reader.AtEnd())) {
+      LOG(ERROR) << "Could not read an entry of '" << zip_path.value()
+                 << "'.";
+      return nullptr;
+    }
+    offset += num_bytes_read;
+  }
+  data.resize(offset);
+  return base::RefCountedString::TakeString(&data);
+}
+
+void RunBufferCallback(
+    const Callback<void(ScopedSharedBufferHandle, uint64_t)>& callback,
+    ScopedSharedBufferHandle buffer,
+    uint64_t size) {
+  callback.Run(buffer.Pass(), size);
+}
+
+// Called on the worker runner. The whole entry is read into the buffer before
+// the buffer is handed out, so its consumer can use it in place without
+// copying it again.
+void ReadEntryIntoBuffer(
+    const base::FilePath& zip_path,
+    const ZipAssetIndex::Entry& entry,
+    scoped_refptr<base::TaskRunner> reply_runner,
+    const Callback<void(ScopedSharedBufferHandle, uint64_t)>& callback) {
+  TRACE_EVENT0("asset_bundle", "ReadEntryIntoBuffer");
+  TRACE_EVENT_SYNTHETIC_DELAY("sky.AssetFetch");
+  ScopedSharedBufferHandle buffer;
+  uint64_t size = 0;
+  if (entry.brotli) {
+    // The decoded size is only known once the entry has been decoded.
+    scoped_refptr<base::RefCountedString> data =
+        ReadEntryToString(zip_path, entry);
+    void* mapped = nullptr;
+    if (data && data->size() &&
+        CreateSharedBuffer(nullptr, data->size(), &buffer) == MOJO_RESULT_OK &&
+        MapBuffer(buffer.get(), 0, data->size(), &mapped,
+                  MOJO_MAP_BUFFER_FLAG_NONE) == MOJO_RESULT_OK) {
+      memcpy(mapped, data->front(), data->size());
+      UnmapBuffer(mapped);
+      size = data->size();
+    } else {
+      buffer.reset();
+    }
+    reply_runner->PostTask(FROM_HERE,
+                           base::Bind(&RunBufferCallback, callback,
+                                      base::Passed(buffer.Pass()), size));
+    return;
+  }
+  ZipEntryReader reader;
+  // Shared buffers cannot be empty, so empty assets come back without one.
+  if (reader.Open(zip_path, entry) && reader.remaining() &&
+      CreateSharedBuffer(nullptr, reader.remaining(), &buffer) ==
+          MOJO_RESULT_OK) {
+    void* data = nullptr;
+    if (MapBuffer(buffer.get(), 0, reader.remaining(), &data,
+                  MOJO_MAP_BUFFER_FLAG_NONE) == MOJO_RESULT_OK) {
+      uint64_t entry_size = reader.remaining();
+      char* cursor = static_cast<char*>(data);
+      while (reader.remaining()) {
+        int num_bytes_read = reader.Read(
+            cursor, static_cast<int>(std::min<uint64_t>(
+                        reader.remaining(), std::numeric_limits<int>::max())));
+        if (num_bytes_read <= 0)
+          break;
+        cursor += num_bytes_read;
+      }
+      UnmapBuffer(data);
+      if (!reader.remaining())
+        size = entry_size;
+    }
+    if (!size) {
+      LOG(ERROR) << "Could not read an entry of '" << zip_path.value()
+                 << "'.";
+      buffer.reset();
+    }
+  }
+  reply_runner->PostTask(FROM_HERE,
+                         base::Bind(&RunBufferCallback, callback,
+                                    base::Passed(buffer.Pass()), size));
 }
 
 }  // namespace
 
 AssetBundleImpl::AssetBundleImpl(InterfaceRequest<AssetBundle> request,
-                                 scoped_ptr<base::ScopedTempDir> asset_dir,
+                                 scoped_ptr<ZipAssetIndex> index,
                                  scoped_refptr<base::TaskRunner> worker_runner)
     : binding_(this, request.Pass()),
-      asset_dir_(asset_dir.Pass()),
-      worker_runner_(worker_runner.Pass()) {
+      index_(index.Pass()),
+      worker_runner_(worker_runner.Pass()),
+      prefetched_bytes_(0),
+      weak_factory_(this) {
+  if (const ZipAssetIndex::Entry* manifest =
+          index_->Find(kPrefetchManifestKey)) {
+    base::PostTaskAndReplyWithResult(
+        worker_runner_.get(), FROM_HERE,
+        base::Bind(&ReadEntryToString, index_->zip_path(), *manifest),
+        base::Bind(&AssetBundleImpl::OnPrefetchManifestAvailable,
+                   weak_factory_.GetWeakPtr()));
+  }
 }
 
 AssetBundleImpl::~AssetBundleImpl() {
+  for (const auto& prefetch : prefetches_) {
+    for (MojoHandle handle : prefetch.second.waiting_pipes)
+      MojoClose(handle);
+  }
+  // Copies that are still running keep the zip open, which is enough for
+  // them to finish on POSIX.
+  worker_runner_->PostTask(FROM_HERE,
+                           base::Bind(base::IgnoreResult(&base::DeleteFile),
+                                      index_->zip_path(), false));
 }
 
 void AssetBundleImpl::GetAsStream(
@@ -37,17 +352,111 @@ void AssetBundleImpl::GetAsStream(
   callback.Run(pipe.consumer_handle.Pass());
 
   std::string asset_string = asset_name.To<std::string>();
-  base::FilePath asset_path =
-      base::MakeAbsoluteFilePath(asset_dir_->path().Append(asset_string));
+  // The order assets are asked for at startup is what a prefetch manifest is
+  // made from.
+  TRACE_EVENT_INSTANT1("asset_bundle", "AssetBundleImpl::GetAsStream",
+                       TRACE_EVENT_SCOPE_THREAD, "asset", asset_string);
+  requested_assets_.insert(asset_string);
 
-  auto asset_dir_abs = base::MakeAbsoluteFilePath(asset_dir_->path());
-  if (!asset_dir_abs.IsParent(asset_path)) {
+  // Only the files in the zip can be found, so names that would traverse out
+  // of the bundle never match anything.
+  const ZipAssetIndex::Entry* entry = index_->Find(asset_string);
+  if (!entry) {
     LOG(WARNING) << "Requested asset '" << asset_string << "' does not exist.";
     return;
   }
 
-  common::CopyFromFile(asset_path, pipe.producer_handle.Pass(), 0,
-                       worker_runner_.get(), base::Bind(&Ignored));
+  auto it = prefetches_.find(asset_string);
+  if (it == prefetches_.end()) {
+    new ZipEntryCopier(index_->zip_path(), *entry, pipe.producer_handle.Pass(),
+                       worker_runner_, nullptr);
+    return;
+  }
+  if (!it->second.data) {
+    // Still being read, so the copy starts once it is done.
+    it->second.waiting_pipes.push_back(pipe.producer_handle.release());
+    return;
+  }
+  new ZipEntryCopier(index_->zip_path(), *entry, pipe.producer_handle.Pass(),
+                     worker_runner_, it->second.data);
+  prefetched_bytes_ -= entry->size;
+  prefetches_.erase(it);
+}
+
+void AssetBundleImpl::GetAsBuffer(
+    const String& asset_name,
+    const Callback<void(ScopedSharedBufferHandle, uint64_t)>& callback) {
+  std::string asset_string = asset_name.To<std::string>();
+  const ZipAssetIndex::Entry* entry = index_->Find(asset_string);
+  if (!entry) {
+    LOG(WARNING) << "Requested asset '" << asset_string << "' does not exist.";
+    callback.Run(ScopedSharedBufferHandle(), 0);
+    return;
+  }
+
+  worker_runner_->PostTask(
+      FROM_HERE,
+      base::Bind(&ReadEntryIntoBuffer, index_->zip_path(), *entry,
+                 base::MessageLoop::current()->task_runner(), callback));
+}
+
+AssetBundleImpl::Prefetch::Prefetch() {
+}
+
+AssetBundleImpl::Prefetch::~Prefetch() {
+}
+
+void AssetBundleImpl::OnPrefetchManifestAvailable(
+    scoped_refptr<base::RefCountedString> manifest) {
+  if (!manifest)
+    return;
+  std::vector<std::string> asset_names =
+      base::SplitString(manifest->data(), "\n", base::TRIM_WHITESPACE,
+                        base::SPLIT_WANT_NONEMPTY);
+  for (const std::string& asset_name : asset_names) {
+    // Assets that were asked for while the manifest was being read have
+    // already been served from the zip.
+    if (requested_assets_.count(asset_name) || prefetches_.count(asset_name))
+      continue;
+    const ZipAssetIndex::Entry* entry = index_->Find(asset_name);
+    if (!entry || prefetched_bytes_ + entry->size > kMaxPrefetchBytes)
+      continue;
+
+    prefetched_bytes_ += entry->size;
+    prefetches_[asset_name];
+    // The worker runner is usually a pool, so the entries are read in
+    // parallel with each other and with the isolate starting up.
+    base::PostTaskAndReplyWithResult(
+        worker_runner_.get(), FROM_HERE,
+        base::Bind(&ReadEntryToString, index_->zip_path(), *entry),
+        base::Bind(&AssetBundleImpl::OnPrefetchDone,
+                   weak_factory_.GetWeakPtr(), asset_name));
+  }
+}
+
+void AssetBundleImpl::OnPrefetchDone(
+    const std::string& asset_name,
+    scoped_refptr<base::RefCountedString> data) {
+  auto it = prefetches_.find(asset_name);
+  DCHECK(it != prefetches_.end());
+  const ZipAssetIndex::Entry* entry = index_->Find(asset_name);
+  std::vector<MojoHandle> waiting_pipes;
+  waiting_pipes.swap(it->second.waiting_pipes);
+
+  // Failed reads are retried from the zip by the requests that come later.
+  if (waiting_pipes.empty() && data) {
+    it->second.data = data;
+    return;
+  }
+  prefetched_bytes_ -= entry->size;
+  prefetches_.erase(it);
+
+  for (MojoHandle handle : waiting_pipes) {
+    new ZipEntryCopier(
+        index_->zip_path(), *entry,
+        ScopedDataPipeProducerHandle(DataPipeProducerHandle(handle)),
+        worker_runner_, data);
+  }
 }
 
 }  // namespace asset_bundle
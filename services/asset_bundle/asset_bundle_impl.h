@@ -5,22 +5,36 @@
 #ifndef SERVICES_ASSET_BUNDLE_ASSET_BUNDLE_IMPL_H_
 #define SERVICES_ASSET_BUNDLE_ASSET_BUNDLE_IMPL_H_
 
-#include "base/files/scoped_temp_dir.h"
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
 #include "base/macros.h"
+#include "base/memory/ref_counted_memory.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "base/task_runner.h"
 #include "mojo/public/cpp/bindings/interface_request.h"
 #include "mojo/public/cpp/bindings/strong_binding.h"
 #include "mojo/public/cpp/system/data_pipe.h"
 #include "mojo/services/asset_bundle/public/interfaces/asset_bundle.mojom.h"
+#include "services/asset_bundle/zip_asset_index.h"
 
 namespace mojo {
 namespace asset_bundle {
 
+// Serves assets straight out of a zip file. Each request only reads the entry
+// it asks for, so the cost of the first asset does not depend on the size of
+// the rest of the bundle. The zip is deleted along with the bundle.
+//
+// A bundle can list the assets its app needs at startup in a prefetch
+// manifest. Those are read into memory on the worker runner as soon as the
+// bundle arrives, instead of one at a time as the app gets to them.
 class AssetBundleImpl : public AssetBundle {
  public:
   AssetBundleImpl(InterfaceRequest<AssetBundle> request,
-                  scoped_ptr<base::ScopedTempDir> asset_dir,
+                  scoped_ptr<ZipAssetIndex> index,
                   scoped_refptr<base::TaskRunner> worker_runner);
   ~AssetBundleImpl() override;
 
@@ -28,12 +42,37 @@ class AssetBundleImpl : public AssetBundle {
   void GetAsStream(
       const String& asset_name,
       const Callback<void(ScopedDataPipeConsumerHandle)>& callback) override;
+  void GetAsBuffer(
+      const String& asset_name,
+      const Callback<void(ScopedSharedBufferHandle, uint64_t)>& callback)
+      override;
 
  private:
+  struct Prefetch {
+    Prefetch();
+    ~Prefetch();
+
+    // Null until the asset has been read.
+    scoped_refptr<base::RefCountedString> data;
+    // Producer handles of requests that came in before the read finished.
+    std::vector<MojoHandle> waiting_pipes;
+  };
+
+  void OnPrefetchManifestAvailable(
+      scoped_refptr<base::RefCountedString> manifest);
+  void OnPrefetchDone(const std::string& asset_name,
+                      scoped_refptr<base::RefCountedString> data);
+
   StrongBinding<AssetBundle> binding_;
-  scoped_ptr<base::ScopedTempDir> asset_dir_;
+  scoped_ptr<ZipAssetIndex> index_;
   scoped_refptr<base::TaskRunner> worker_runner_;
 
+  std::map<std::string, Prefetch> prefetches_;
+  uint64_t prefetched_bytes_;
+  std::set<std::string> requested_assets_;
+
+  base::WeakPtrFactory<AssetBundleImpl> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(AssetBundleImpl);
 };
 
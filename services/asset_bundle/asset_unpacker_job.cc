@@ -5,29 +5,24 @@
 #include "services/asset_bundle/asset_unpacker_job.h"
 
 #include "base/bind.h"
-#include "base/files/file_path.h"
 #include "base/files/file_util.h"
-#include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "services/asset_bundle/asset_bundle_impl.h"
-#include "third_party/zlib/google/zip.h"
+#include "services/asset_bundle/zip_asset_index.h"
 
 namespace mojo {
 namespace asset_bundle {
 namespace {
 
-void UnzipAssets(
-    const base::FilePath& zip_path,
-    scoped_ptr<base::ScopedTempDir> asset_dir,
-    scoped_refptr<base::TaskRunner> task_runner,
-    base::Callback<void(scoped_ptr<base::ScopedTempDir>)> callback) {
-  if (!zip::Unzip(zip_path, asset_dir->path())) {
-    task_runner->PostTask(FROM_HERE, base::Bind(callback, nullptr));
-  } else {
-    task_runner->PostTask(FROM_HERE,
-                          base::Bind(callback, base::Passed(asset_dir.Pass())));
-  }
-  base::DeleteFile(zip_path, false);
+void IndexAssets(const base::FilePath& zip_path,
+                 scoped_refptr<base::TaskRunner> task_runner,
+                 base::Callback<void(scoped_ptr<ZipAssetIndex>)> callback) {
+  scoped_ptr<ZipAssetIndex> index = ZipAssetIndex::Create(zip_path);
+  // Once there is an index the zip belongs to the bundle serving from it.
+  if (!index)
+    base::DeleteFile(zip_path, false);
+  task_runner->PostTask(FROM_HERE,
+                        base::Bind(callback, base::Passed(index.Pass())));
 }
 
 }  // namespace
@@ -57,26 +52,21 @@ void AssetUnpackerJob::Unpack(ScopedDataPipeConsumerHandle zipped_assets) {
 void AssetUnpackerJob::OnZippedAssetsAvailable(const base::FilePath& zip_path,
                                                bool success) {
   if (!success) {
-    delete this;
-    return;
-  }
-  scoped_ptr<base::ScopedTempDir> asset_dir(new base::ScopedTempDir());
-  if (!asset_dir->CreateUniqueTempDir()) {
+    base::DeleteFile(zip_path, false);
     delete this;
     return;
   }
   worker_runner_->PostTask(
       FROM_HERE,
-      base::Bind(&UnzipAssets, zip_path, base::Passed(asset_dir.Pass()),
+      base::Bind(&IndexAssets, zip_path,
                  base::MessageLoop::current()->task_runner(),
-                 base::Bind(&AssetUnpackerJob::OnUnzippedAssetsAvailable,
+                 base::Bind(&AssetUnpackerJob::OnIndexAvailable,
                             weak_factory_.GetWeakPtr())));
 }
 
-void AssetUnpackerJob::OnUnzippedAssetsAvailable(
-    scoped_ptr<base::ScopedTempDir> asset_dir) {
-  if (asset_dir)
-    new AssetBundleImpl(asset_bundle_.Pass(), asset_dir.Pass(), worker_runner_);
+void AssetUnpackerJob::OnIndexAvailable(scoped_ptr<ZipAssetIndex> index) {
+  if (index)
+    new AssetBundleImpl(asset_bundle_.Pass(), index.Pass(), worker_runner_);
 
   delete this;
 }
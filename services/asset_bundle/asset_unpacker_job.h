@@ -5,8 +5,9 @@
 #ifndef SERVICES_ASSET_BUNDLE_ASSET_UNPACKER_JOB_H_
 #define SERVICES_ASSET_BUNDLE_ASSET_UNPACKER_JOB_H_
 
-#include "base/files/scoped_temp_dir.h"
+#include "base/files/file_path.h"
 #include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/task_runner.h"
 #include "mojo/data_pipe_utils/data_pipe_utils.h"
@@ -15,7 +16,11 @@
 
 namespace mojo {
 namespace asset_bundle {
+class ZipAssetIndex;
 
+// Copies a zipped bundle to a temporary file and reads its index. The entries
+// are not unpacked; the resulting AssetBundleImpl reads them from the zip
+// when they are asked for.
 class AssetUnpackerJob {
  public:
   AssetUnpackerJob(InterfaceRequest<AssetBundle> asset_bundle,
@@ -26,7 +31,7 @@ class AssetUnpackerJob {
 
  private:
   void OnZippedAssetsAvailable(const base::FilePath& zip_path, bool success);
-  void OnUnzippedAssetsAvailable(scoped_ptr<base::ScopedTempDir> temp_dir);
+  void OnIndexAvailable(scoped_ptr<ZipAssetIndex> index);
 
   InterfaceRequest<AssetBundle> asset_bundle_;
   scoped_refptr<base::TaskRunner> worker_runner_;
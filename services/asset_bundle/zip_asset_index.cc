@@ -0,0 +1,89 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "services/asset_bundle/zip_asset_index.h"
+
+#include <string.h>
+
+#include "base/logging.h"
+#include "base/strings/string_util.h"
+#include "third_party/zlib/google/zip_internal.h"
+
+namespace mojo {
+namespace asset_bundle {
+namespace {
+
+// The compression method zip uses for entries that are not compressed.
+const uLong kStoredMethod = 0;
+
+const char kBrotliSuffix[] = ".br";
+
+}  // namespace
+
+ZipAssetIndex::ZipAssetIndex(const base::FilePath& zip_path)
+    : zip_path_(zip_path) {
+}
+
+ZipAssetIndex::~ZipAssetIndex() {
+}
+
+scoped_ptr<ZipAssetIndex> ZipAssetIndex::Create(
+    const base::FilePath& zip_path) {
+  unzFile zip_file = zip::internal::OpenForUnzipping(zip_path.AsUTF8Unsafe());
+  if (!zip_file) {
+    LOG(ERROR) << "Could not open asset bundle '" << zip_path.value() << "'.";
+    return nullptr;
+  }
+
+  scoped_ptr<ZipAssetIndex> index(new ZipAssetIndex(zip_path));
+  // unzGoToNextFile only walks the central directory, so building the index
+  // does not touch the entries' data.
+  int result = unzGoToFirstFile(zip_file);
+  for (; result == UNZ_OK; result = unzGoToNextFile(zip_file)) {
+    char name[zip::internal::kZipMaxPath] = {};
+    unz_file_info64 info;
+    if (unzGetCurrentFileInfo64(zip_file, &info, name, sizeof(name), nullptr,
+                                0, nullptr, 0) != UNZ_OK) {
+      break;
+    }
+    std::string asset_name(name);
+    if (asset_name.empty() || asset_name[asset_name.size() - 1] == '/')
+      continue;
+
+    Entry entry;
+    if (unzGetFilePos64(zip_file, &entry.position) != UNZ_OK)
+      break;
+    entry.stored = info.compression_method == kStoredMethod;
+    entry.brotli = asset_name.size() > strlen(kBrotliSuffix) &&
+                   base::EndsWith(asset_name, kBrotliSuffix,
+                                  base::CompareCase::SENSITIVE);
+    entry.size = info.uncompressed_size;
+    if (entry.brotli) {
+      // An entry that is in the bundle as it is takes precedence.
+      asset_name.resize(asset_name.size() - strlen(kBrotliSuffix));
+      index->entries_.insert(std::make_pair(asset_name, entry));
+      continue;
+    }
+    index->entries_[asset_name] = entry;
+  }
+  unzClose(zip_file);
+
+  if (result != UNZ_END_OF_LIST_OF_FILE) {
+    LOG(ERROR) << "Could not read the index of asset bundle '"
+               << zip_path.value() << "'.";
+    return nullptr;
+  }
+  return index.Pass();
+}
+
+const ZipAssetIndex::Entry* ZipAssetIndex::Find(
+    const std::string& asset_name) const {
+  auto it = entries_.find(asset_name);
+  if (it == entries_.end())
+    return nullptr;
+  return &it->second;
+}
+
+}  // namespace asset_bundle
+}  // namespace mojo
@@ -0,0 +1,66 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SERVICES_ASSET_BUNDLE_ZIP_ASSET_INDEX_H_
+#define SERVICES_ASSET_BUNDLE_ZIP_ASSET_INDEX_H_
+
+#include <map>
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "third_party/zlib/contrib/minizip/unzip.h"
+
+namespace mojo {
+namespace asset_bundle {
+
+// The central directory of a zipped asset bundle. It is read once when the
+// bundle arrives so that individual assets can be served straight from the
+// zip without unpacking the rest of it first.
+//
+// Zip has no compression method for Brotli, so a bundle holds Brotli
+// compressed assets under their name with ".br" appended, best stored rather
+// than deflated. They are found under the name without it.
+class ZipAssetIndex {
+ public:
+  struct Entry {
+    // Where the entry's central directory record is, for unzGoToFilePos64.
+    unz64_file_pos position;
+    // Stored entries are copied from their byte range in the zip, everything
+    // else is inflated by minizip.
+    bool stored;
+    // Whether the entry is a Brotli stream, which is decoded while it is
+    // read.
+    bool brotli;
+    // The size of the entry in the zip, which is the encoded size for Brotli
+    // entries.
+    uint64_t size;
+  };
+
+  ~ZipAssetIndex();
+
+  // Reads the central directory of the zip at |zip_path|, which has to stay
+  // around for as long as entries are read from it. Returns null if the file
+  // is not a zip.
+  static scoped_ptr<ZipAssetIndex> Create(const base::FilePath& zip_path);
+
+  const base::FilePath& zip_path() const { return zip_path_; }
+
+  // Returns null if there is no file called |asset_name| in the zip.
+  const Entry* Find(const std::string& asset_name) const;
+
+ private:
+  explicit ZipAssetIndex(const base::FilePath& zip_path);
+
+  base::FilePath zip_path_;
+  std::map<std::string, Entry> entries_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZipAssetIndex);
+};
+
+}  // namespace asset_bundle
+}  // namespace mojo
+
+#endif  // SERVICES_ASSET_BUNDLE_ZIP_ASSET_INDEX_H_
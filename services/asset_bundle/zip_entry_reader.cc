@@ -0,0 +1,154 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "services/asset_bundle/zip_entry_reader.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+#include "third_party/zlib/google/zip_internal.h"
+
+namespace mojo {
+namespace asset_bundle {
+namespace {
+
+// How much of a Brotli stream is read from the zip at a time.
+const size_t kBrotliInputSize = 16 * 1024;
+
+}  // namespace
+
+ZipEntryReader::ZipEntryReader()
+    : stored_(false),
+      brotli_(false),
+      brotli_result_(BROTLI_RESULT_NEEDS_MORE_INPUT),
+      input_offset_(0),
+      zip_file_(nullptr),
+      remaining_(0) {
+}
+
+ZipEntryReader::~ZipEntryReader() {
+  Close();
+}
+
+bool ZipEntryReader::Open(const base::FilePath& zip_path,
+                          const ZipAssetIndex::Entry& entry) {
+  DCHECK(!zip_file_ && !file_.IsValid());
+  unz64_file_pos position = entry.position;
+  unzFile zip_file = zip::internal::OpenForUnzipping(zip_path.AsUTF8Unsafe());
+  if (!zip_file || unzGoToFilePos64(zip_file, &position) != UNZ_OK ||
+      unzOpenCurrentFile(zip_file) != UNZ_OK) {
+    LOG(ERROR) << "Could not open an entry of '" << zip_path.value() << "'.";
+    if (zip_file)
+      unzClose(zip_file);
+    return false;
+  }
+
+  stored_ = entry.stored;
+  brotli_ = entry.brotli;
+  remaining_ = entry.size;
+  if (brotli_) {
+    BrotliStateInit(&brotli_state_);
+    brotli_result_ = BROTLI_RESULT_NEEDS_MORE_INPUT;
+    input_.clear();
+    input_offset_ = 0;
+  }
+  if (!stored_) {
+    zip_file_ = zip_file;
+    return true;
+  }
+
+  // The data starts after the entry's local header, whose length is only
+  // known once the entry has been opened.
+  int64 offset = unzGetCurrentFileZStreamPos64(zip_file);
+  unzCloseCurrentFile(zip_file);
+  unzClose(zip_file);
+  file_.Initialize(zip_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file_.IsValid() ||
+      file_.Seek(base::File::FROM_BEGIN, offset) != offset) {
+    LOG(ERROR) << "Could not seek in '" << zip_path.value() << "'.";
+    Close();
+    return false;
+  }
+  return true;
+}
+
+void ZipEntryReader::Close() {
+  if (zip_file_) {
+    unzCloseCurrentFile(zip_file_);
+    unzClose(zip_file_);
+    zip_file_ = nullptr;
+  }
+  file_.Close();
+  remaining_ = 0;
+  if (brotli_) {
+    BrotliStateCleanup(&brotli_state_);
+    brotli_ = false;
+  }
+}
+
+bool ZipEntryReader::AtEnd() const {
+  if (brotli_)
+    return brotli_result_ == BROTLI_RESULT_SUCCESS;
+  return !remaining_;
+}
+
+int ZipEntryReader::Read(void* buffer, int num_bytes) {
+  return brotli_ ? Decode(buffer, num_bytes) : ReadRaw(buffer, num_bytes);
+}
+
+int ZipEntryReader::Decode(void* buffer, int num_bytes) {
+  uint8_t* next_out = static_cast<uint8_t*>(buffer);
+  size_t available_out = std::max(0, num_bytes);
+  size_t total_out = 0;
+  while (available_out && brotli_result_ != BROTLI_RESULT_SUCCESS) {
+    if (brotli_result_ == BROTLI_RESULT_NEEDS_MORE_INPUT &&
+        input_offset_ == input_.size() && remaining_) {
+      input_.resize(std::min<uint64_t>(kBrotliInputSize, remaining_));
+      int num_bytes_read =
+          ReadRaw(input_.data(), static_cast<int>(input_.size()));
+      if (num_bytes_read <= 0)
+        return -1;
+      input_.resize(num_bytes_read);
+      input_offset_ = 0;
+    }
+
+    size_t available_in = input_.size() - input_offset_;
+    const uint8_t* next_in = input_.data() + input_offset_;
+    brotli_result_ = BrotliDecompressBufferStreaming(
+        &available_in, &next_in, !remaining_, &available_out, &next_out,
+        &total_out, &brotli_state_);
+    input_offset_ = input_.size() - available_in;
+
+    if (brotli_result_ == BROTLI_RESULT_ERROR ||
+        (brotli_result_ == BROTLI_RESULT_NEEDS_MORE_INPUT && !remaining_ &&
+         input_offset_ == input_.size())) {
+      LOG(ERROR) << "Could not decode a Brotli entry.";
+      return -1;
+    }
+    // Hand out what has been decoded rather than wait for more input.
+    if (total_out)
+      break;
+  }
+  return static_cast<int>(total_out);
+}
+
+int ZipEntryReader::ReadRaw(void* buffer, int num_bytes) {
+  num_bytes = static_cast<int>(
+      std::min<uint64_t>(std::max(0, num_bytes), remaining_));
+  if (!num_bytes)
+    return 0;
+
+  int num_bytes_read =
+      stored_ ? file_.ReadAtCurrentPos(static_cast<char*>(buffer), num_bytes)
+              : unzReadCurrentFile(zip_file_, buffer, num_bytes);
+  // The index said how long the entry is, so running out of data early means
+  // the zip is broken.
+  if (num_bytes_read <= 0)
+    return -1;
+  remaining_ -= num_bytes_read;
+  return num_bytes_read;
+}
+
+}  // namespace asset_bundle
+}  // namespace mojo
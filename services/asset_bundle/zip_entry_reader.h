@@ -0,0 +1,65 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SERVICES_ASSET_BUNDLE_ZIP_ENTRY_READER_H_
+#define SERVICES_ASSET_BUNDLE_ZIP_ENTRY_READER_H_
+
+#include <vector>
+
+#include "base/files/file.h"
+#include "base/macros.h"
+#include "services/asset_bundle/zip_asset_index.h"
+#include "third_party/brotli/dec/decode.h"
+
+namespace mojo {
+namespace asset_bundle {
+
+// Reads the contents of one entry of a zip. Stored entries are read from
+// their byte range in the zip, other entries are inflated through minizip.
+// Brotli entries are decoded as they are read, so the decoded asset is never
+// held in memory as a whole.
+// The reader does blocking file IO and may be used from any thread, but only
+// from one at a time.
+class ZipEntryReader {
+ public:
+  ZipEntryReader();
+  ~ZipEntryReader();
+
+  bool Open(const base::FilePath& zip_path, const ZipAssetIndex::Entry& entry);
+  void Close();
+
+  // Reads up to |num_bytes| into |buffer| and returns how many bytes were
+  // read, 0 once the whole entry has been read or -1 on error.
+  int Read(void* buffer, int num_bytes);
+
+  // Whether the whole entry has been read.
+  bool AtEnd() const;
+
+  // How many bytes of the entry are left. Only known up front for entries
+  // that are not Brotli streams.
+  bool size_known() const { return !brotli_; }
+  uint64_t remaining() const { return remaining_; }
+
+ private:
+  int ReadRaw(void* buffer, int num_bytes);
+  int Decode(void* buffer, int num_bytes);
+
+  bool stored_;
+  bool brotli_;
+  BrotliState brotli_state_;
+  BrotliResult brotli_result_;
+  // Encoded bytes that have been read but not decoded yet.
+  std::vector<uint8_t> input_;
+  size_t input_offset_;
+  base::File file_;
+  unzFile zip_file_;
+  uint64_t remaining_;
+
+  DISALLOW_COPY_AND_ASSIGN(ZipEntryReader);
+};
+
+}  // namespace asset_bundle
+}  // namespace mojo
+
+#endif  // SERVICES_ASSET_BUNDLE_ZIP_ENTRY_READER_H_
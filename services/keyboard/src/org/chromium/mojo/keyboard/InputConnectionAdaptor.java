@@ -4,8 +4,8 @@
 
 package org.chromium.mojo.keyboard;
 
-import java.lang.StringBuilder;
-
+import android.text.Editable;
+import android.text.Selection;
 import android.view.View;
 import android.view.KeyEvent;
 import android.view.inputmethod.BaseInputConnection;
@@ -15,64 +15,111 @@ import android.view.inputmethod.EditorInfo;
 
 import org.chromium.mojom.keyboard.CompletionData;
 import org.chromium.mojom.keyboard.CorrectionData;
+import org.chromium.mojom.keyboard.EditingState;
 import org.chromium.mojom.keyboard.KeyboardClient;
 
 /**
  * An adaptor between InputConnection and KeyboardClient.
+ *
+ * The edits the keyboard makes are applied to the Editable of the
+ * BaseInputConnection, and the resulting text, selection and composing region
+ * are sent to the client once per frame, however many edits a keystroke or
+ * an autocorrection makes.
  */
 public class InputConnectionAdaptor extends BaseInputConnection {
     private KeyboardClient mClient;
+    private View mView;
+    private boolean mStateUpdatePending;
+
+    private final Runnable mSendEditingState = new Runnable() {
+        @Override
+        public void run() {
+            mStateUpdatePending = false;
+            Editable editable = getEditable();
+            EditingState state = new EditingState();
+            state.text = editable.toString();
+            state.selectionBase = Selection.getSelectionStart(editable);
+            state.selectionExtent = Selection.getSelectionEnd(editable);
+            state.composingBase = BaseInputConnection.getComposingSpanStart(editable);
+            state.composingExtent = BaseInputConnection.getComposingSpanEnd(editable);
+            mClient.updateEditingState(state);
+        }
+    };
 
     public InputConnectionAdaptor(View view, KeyboardClient client, EditorInfo outAttrs) {
         super(view, true);
         assert client != null;
         mClient = client;
+        mView = view;
         outAttrs.initialSelStart = -1;
         outAttrs.initialSelEnd = -1;
     }
 
+    private void scheduleStateUpdate() {
+        if (mStateUpdatePending)
+            return;
+        mStateUpdatePending = true;
+        mView.postOnAnimation(mSendEditingState);
+    }
+
     @Override
     public boolean commitCompletion(CompletionInfo completion) {
         // TODO(abarth): Copy the data from |completion| to CompletionData.
         mClient.commitCompletion(new CompletionData());
-        return super.commitCompletion(completion);
+        boolean result = super.commitCompletion(completion);
+        scheduleStateUpdate();
+        return result;
     }
 
     @Override
     public boolean commitCorrection(CorrectionInfo correction) {
         // TODO(abarth): Copy the data from |correction| to CompletionData.
         mClient.commitCorrection(new CorrectionData());
-        return super.commitCorrection(correction);
+        boolean result = super.commitCorrection(correction);
+        scheduleStateUpdate();
+        return result;
     }
 
     @Override
     public boolean commitText(CharSequence text, int newCursorPosition) {
-        mClient.commitText(text.toString(), newCursorPosition);
-        return super.commitText(text, newCursorPosition);
+        boolean result = super.commitText(text, newCursorPosition);
+        scheduleStateUpdate();
+        return result;
     }
 
     @Override
     public boolean deleteSurroundingText(int beforeLength, int afterLength) {
-        mClient.deleteSurroundingText(beforeLength, afterLength);
-        return super.deleteSurroundingText(beforeLength, afterLength);
+        boolean result = super.deleteSurroundingText(beforeLength, afterLength);
+        scheduleStateUpdate();
+        return result;
     }
 
     @Override
     public boolean setComposingRegion(int start, int end) {
-        mClient.setComposingRegion(start, end);
-        return super.setComposingRegion(start, end);
+        boolean result = super.setComposingRegion(start, end);
+        scheduleStateUpdate();
+        return result;
     }
 
     @Override
     public boolean setComposingText(CharSequence text, int newCursorPosition) {
-        mClient.setComposingText(text.toString(), newCursorPosition);
-        return super.setComposingText(text, newCursorPosition);
+        boolean result = super.setComposingText(text, newCursorPosition);
+        scheduleStateUpdate();
+        return result;
+    }
+
+    @Override
+    public boolean finishComposingText() {
+        boolean result = super.finishComposingText();
+        scheduleStateUpdate();
+        return result;
     }
 
     @Override
     public boolean setSelection(int start, int end) {
-        mClient.setSelection(start, end);
-        return super.setSelection(start, end);
+        boolean result = super.setSelection(start, end);
+        scheduleStateUpdate();
+        return result;
     }
 
     // Number keys come through as key events instead of commitText!?
@@ -80,7 +127,7 @@ public class InputConnectionAdaptor extends BaseInputConnection {
     public boolean sendKeyEvent(KeyEvent event) {
         if (event.getAction() == KeyEvent.ACTION_UP) {
             // 1 appears to always be the value for newCursorPosition?
-            mClient.commitText(String.valueOf(event.getNumber()), 1);
+            commitText(String.valueOf(event.getNumber()), 1);
         }
         return super.sendKeyEvent(event);
     }
@@ -27,7 +27,7 @@ public class SensorForwarder implements ConnectionErrorHandler, SensorEventListe
     private SensorManager mManager;
     private Sensor mSensor;
 
-    private static int getAndroidTypeForSensor(int sensorType) {
+    static int getAndroidTypeForSensor(int sensorType) {
         switch (sensorType) {
             case SensorType.ACCELEROMETER:
                 return Sensor.TYPE_ACCELEROMETER;
@@ -6,18 +6,22 @@ package org.chromium.mojo.sensors;
 
 import android.content.Context;
 
+import org.chromium.mojo.system.Core;
 import org.chromium.mojo.system.MojoException;
 import org.chromium.mojom.sensors.SensorListener;
 import org.chromium.mojom.sensors.SensorService;
+import org.chromium.mojom.sensors.SensorStreamListener;
 
 /**
  * Android implementation of Senors.
  */
 public class SensorServiceImpl implements SensorService {
     private Context mContext;
+    private Core mCore;
 
-    public SensorServiceImpl(Context context) {
+    public SensorServiceImpl(Context context, Core core) {
         mContext = context;
+        mCore = core;
     }
 
     @Override
@@ -30,4 +34,11 @@ public class SensorServiceImpl implements SensorService {
     public void addListener(int sensorType, SensorListener listener) {
         new SensorForwarder(mContext, sensorType, (SensorListener.Proxy) listener);
     }
+
+    @Override
+    public void startStream(int sensorType, int samplingPeriodUs, int notificationPeriodMs,
+            int capacity, SensorStreamListener listener, StartStreamResponse callback) {
+        new SensorStreamer(mContext, mCore, sensorType, samplingPeriodUs, notificationPeriodMs,
+                capacity, (SensorStreamListener.Proxy) listener, callback);
+    }
 }
@@ -0,0 +1,153 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+package org.chromium.mojo.sensors;
+
+import android.content.Context;
+import android.hardware.Sensor;
+import android.hardware.SensorEvent;
+import android.hardware.SensorEventListener;
+import android.hardware.SensorManager;
+import android.os.Handler;
+import android.util.Log;
+
+import org.chromium.mojo.bindings.ConnectionErrorHandler;
+import org.chromium.mojo.system.Core;
+import org.chromium.mojo.system.MojoException;
+import org.chromium.mojo.system.SharedBufferHandle;
+import org.chromium.mojom.sensors.SensorService;
+import org.chromium.mojom.sensors.SensorsConstants;
+import org.chromium.mojom.sensors.SensorStreamListener;
+
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
+/**
+ * A class to write sensor data to a ring buffer in shared memory, and to tell a
+ * SensorStreamListener about new samples in batches.
+ */
+public class SensorStreamer implements ConnectionErrorHandler, SensorEventListener {
+    private static final String TAG = "SensorStreamer";
+
+    private static final int WRITE_COUNT_OFFSET = 0;
+    private static final int CAPACITY_OFFSET = 8;
+    private static final int TIME_STAMP_OFFSET = 0;
+    private static final int ACCURACY_OFFSET = 8;
+    private static final int VALUE_COUNT_OFFSET = 12;
+    private static final int VALUES_OFFSET = 16;
+
+    private static final int MAX_CAPACITY = 4096;
+
+    private final SensorStreamListener.Proxy mListener;
+    private final SensorManager mManager;
+    private final Handler mHandler = new Handler();
+    private Sensor mSensor;
+    private SharedBufferHandle mBuffer;
+    private ByteBuffer mMapping;
+    private int mCapacity;
+    private long mWriteCount;
+    private long mNotifiedWriteCount;
+    private int mNotificationPeriodMs;
+    private boolean mNotificationPending;
+
+    private final Runnable mNotify = new Runnable() {
+        @Override
+        public void run() {
+            mNotificationPending = false;
+            if (mMapping == null || mWriteCount == mNotifiedWriteCount) return;
+            mNotifiedWriteCount = mWriteCount;
+            mListener.onSamplesAvailable(mWriteCount);
+        }
+    };
+
+    public SensorStreamer(Context context, Core core, int mojoSensorType, int samplingPeriodUs,
+            int notificationPeriodMs, int capacity, SensorStreamListener.Proxy listener,
+            SensorService.StartStreamResponse callback) {
+        mListener = listener;
+        mManager = (SensorManager) context.getSystemService(Context.SENSOR_SERVICE);
+        mSensor = mManager.getDefaultSensor(SensorForwarder.getAndroidTypeForSensor(mojoSensorType));
+        mNotificationPeriodMs = Math.max(0, notificationPeriodMs);
+        mCapacity = Math.max(1, Math.min(capacity, MAX_CAPACITY));
+
+        if (mSensor == null) {
+            Log.e(TAG, "No default sensor for sensor type " + mojoSensorType);
+            callback.call(null);
+            mListener.close();
+            return;
+        }
+
+        long size = SensorsConstants.STREAM_HEADER_SIZE
+                + (long) mCapacity * SensorsConstants.STREAM_SLOT_SIZE;
+        SharedBufferHandle clientBuffer;
+        try {
+            mBuffer = core.createSharedBuffer(null, size);
+            mMapping = mBuffer.map(0, size, SharedBufferHandle.MapFlags.NONE);
+            clientBuffer = mBuffer.duplicate(null);
+        } catch (MojoException e) {
+            Log.e(TAG, "Could not create the sample buffer", e);
+            close();
+            callback.call(null);
+            mListener.close();
+            return;
+        }
+        mMapping.order(ByteOrder.LITTLE_ENDIAN);
+        mMapping.putLong(WRITE_COUNT_OFFSET, 0);
+        mMapping.putInt(CAPACITY_OFFSET, mCapacity);
+        callback.call(clientBuffer);
+
+        // Letting the sensor hub hold samples for as long as the listener is
+        // willing to wait for them is what saves power: the application
+        // processor is woken up once per batch rather than once per sample.
+        int maxReportLatencyUs = mNotificationPeriodMs * 1000;
+        mManager.registerListener(this, mSensor, samplingPeriodUs, maxReportLatencyUs);
+        mListener.getProxyHandler().setErrorHandler(this);
+    }
+
+    private void close() {
+        mHandler.removeCallbacks(mNotify);
+        if (mMapping != null) {
+            mBuffer.unmap(mMapping);
+            mMapping = null;
+        }
+        if (mBuffer != null) {
+            mBuffer.close();
+            mBuffer = null;
+        }
+    }
+
+    @Override
+    public void onConnectionError(MojoException e) {
+        mManager.unregisterListener(this);
+        close();
+    }
+
+    @Override
+    public void onAccuracyChanged(Sensor sensor, int accuracy) {
+        mListener.onAccuracyChanged(accuracy);
+    }
+
+    @Override
+    public void onSensorChanged(SensorEvent event) {
+        if (mMapping == null) return;
+
+        int slot = SensorsConstants.STREAM_HEADER_SIZE
+                + (int) (mWriteCount % mCapacity) * SensorsConstants.STREAM_SLOT_SIZE;
+        int valueCount = Math.min(event.values.length, SensorsConstants.STREAM_MAX_VALUES);
+        mMapping.putLong(slot + TIME_STAMP_OFFSET, event.timestamp);
+        mMapping.putInt(slot + ACCURACY_OFFSET, event.accuracy);
+        mMapping.putInt(slot + VALUE_COUNT_OFFSET, valueCount);
+        for (int i = 0; i < valueCount; ++i) {
+            mMapping.putFloat(slot + VALUES_OFFSET + i * 4, event.values[i]);
+        }
+
+        // The count is only published once the slot is complete.
+        ++mWriteCount;
+        mMapping.putLong(WRITE_COUNT_OFFSET, mWriteCount);
+
+        if (!mNotificationPending) {
+            mNotificationPending = true;
+            mHandler.postDelayed(mNotify, mNotificationPeriodMs);
+        }
+    }
+}
@@ -21,9 +21,11 @@ import org.chromium.mojom.sensors.SensorService;
  */
 public class Sensors implements ApplicationDelegate {
     private Context mContext;
+    private Core mCore;
 
-    public Sensors(Context context) {
+    public Sensors(Context context, Core core) {
         mContext = context;
+        mCore = core;
     }
 
     /**
@@ -40,7 +42,7 @@ public class Sensors implements ApplicationDelegate {
         connection.addService(new ServiceFactoryBinder<SensorService>() {
             @Override
             public void bind(InterfaceRequest<SensorService> request) {
-                SensorService.MANAGER.bind(new SensorServiceImpl(mContext), request);
+                SensorService.MANAGER.bind(new SensorServiceImpl(mContext, mCore), request);
             }
 
             @Override
@@ -59,6 +61,6 @@ public class Sensors implements ApplicationDelegate {
 
     public static void mojoMain(
             Context context, Core core, MessagePipeHandle applicationRequestHandle) {
-        ApplicationRunner.run(new Sensors(context), core, applicationRequestHandle);
+        ApplicationRunner.run(new Sensors(context, core), core, applicationRequestHandle);
     }
 }
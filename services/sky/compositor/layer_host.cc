@@ -19,8 +19,7 @@ LayerHost::LayerHost(LayerHostClient* client)
       state_(kReadyForFrame),
       frame_requested_(false),
       surface_holder_(this, client->GetShell()),
-      gl_context_owner_(client->GetShell()),
-      ganesh_context_(gl_context()),
+      shared_context_(SharedContext::Get(client->GetShell())),
       resource_manager_(gl_context()),
       weak_factory_(this) {
 }
@@ -78,8 +77,8 @@ void LayerHost::BeginFrame() {
   }
 
   {
-    mojo::GaneshContext::Scope scope(&ganesh_context_);
-    ganesh_context_.gr()->resetContext();
+    mojo::GaneshContext::Scope scope(ganesh_context());
+    ganesh_context()->gr()->resetContext();
     root_layer_->Display();
   }
 
@@ -8,10 +8,10 @@
 #include "base/memory/ref_counted.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
-#include "mojo/gpu/gl_context_owner.h"
 #include "mojo/skia/ganesh_context.h"
 #include "services/sky/compositor/layer_host_client.h"
 #include "services/sky/compositor/resource_manager.h"
+#include "services/sky/compositor/shared_context.h"
 #include "services/sky/compositor/surface_holder.h"
 
 namespace sky {
@@ -27,11 +27,11 @@ class LayerHost : public SurfaceHolder::Client {
   LayerHostClient* client() const { return client_; }
 
   const base::WeakPtr<mojo::GLContext>& gl_context() const {
-    return gl_context_owner_.context();
+    return shared_context_->gl_context();
   }
 
   mojo::GaneshContext* ganesh_context() const {
-    return const_cast<mojo::GaneshContext*>(&ganesh_context_);
+    return shared_context_->ganesh_context();
   }
 
   ResourceManager* resource_manager() const {
@@ -62,8 +62,7 @@ class LayerHost : public SurfaceHolder::Client {
   State state_;
   bool frame_requested_;
   SurfaceHolder surface_holder_;
-  mojo::GLContextOwner gl_context_owner_;
-  mojo::GaneshContext ganesh_context_;
+  scoped_refptr<SharedContext> shared_context_;
   ResourceManager resource_manager_;
   scoped_refptr<TextureLayer> root_layer_;
 
@@ -4,8 +4,22 @@
 
 #include "services/sky/compositor/rasterizer_bitmap.h"
 
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/sys_info.h"
+#include "base/threading/worker_pool.h"
+#include "base/trace_event/trace_event.h"
+#include "mojo/public/c/gpu/GLES2/gl2.h"
+#include "mojo/skia/ganesh_context.h"
 #include "services/sky/compositor/layer_client.h"
 #include "services/sky/compositor/layer_host.h"
+#include "skia/ext/refptr.h"
 #include "third_party/skia/include/core/SkBitmapDevice.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 #include "third_party/skia/include/core/SkPicture.h"
@@ -13,8 +27,83 @@
 #include "ui/gfx/geometry/rect.h"
 
 namespace sky {
+namespace {
+
+// The number of rows rasterized, compared and uploaded as a unit.
+const int kBandHeight = 64;
+
+int BandCount(int height) {
+  return (height + kBandHeight - 1) / kBandHeight;
+}
+
+// Rasterizes the bands of a single frame. Bands are handed out one at a
+// time to whichever thread asks next, including the one waiting for the
+// frame.
+class BandRasterizer : public base::RefCountedThreadSafe<BandRasterizer> {
+ public:
+  BandRasterizer(const SkBitmap& bitmap, SkPicture* picture)
+      : bitmap_(bitmap),
+        picture_(skia::SharePtr(picture)),
+        band_count_(BandCount(bitmap.height())),
+        next_band_(0),
+        completed_bands_(0),
+        done_(true, false) {}
+
+  int band_count() const { return band_count_; }
+
+  void Run() {
+    for (;;) {
+      const int band =
+          base::subtle::NoBarrier_AtomicIncrement(&next_band_, 1) - 1;
+      if (band >= band_count_)
+        return;
+      RasterizeBand(band);
+      if (base::subtle::Barrier_AtomicIncrement(&completed_bands_, 1) ==
+          band_count_) {
+        done_.Signal();
+      }
+    }
+  }
+
+  void Wait() { done_.Wait(); }
 
-RasterizerBitmap::RasterizerBitmap(LayerHost* host) : host_(host) {
+ private:
+  friend class base::RefCountedThreadSafe<BandRasterizer>;
+
+  ~BandRasterizer() {}
+
+  void RasterizeBand(int band) {
+    TRACE_EVENT1("sky", "RasterizerBitmap::RasterizeBand", "band", band);
+    const int top = band * kBandHeight;
+    const SkIRect rect = SkIRect::MakeLTRB(
+        0, top, bitmap_.width(), std::min(top + kBandHeight, bitmap_.height()));
+
+    // The subset shares its pixels with |bitmap_|.
+    SkBitmap subset;
+    bitmap_.extractSubset(&subset, rect);
+
+    SkBitmapDevice device(subset);
+    SkCanvas canvas(&device);
+    canvas.clear(SK_ColorBLACK);
+    canvas.translate(0, -top);
+    canvas.drawPicture(picture_.get());
+    canvas.flush();
+  }
+
+  const SkBitmap bitmap_;
+  const skia::RefPtr<SkPicture> picture_;
+  const int band_count_;
+  base::subtle::Atomic32 next_band_;
+  base::subtle::Atomic32 completed_bands_;
+  base::WaitableEvent done_;
+
+  DISALLOW_COPY_AND_ASSIGN(BandRasterizer);
+};
+
+}  // namespace
+
+RasterizerBitmap::RasterizerBitmap(LayerHost* host)
+    : host_(host), frame_count_(0) {
   DCHECK(host_);
 }
 
@@ -22,21 +111,117 @@ RasterizerBitmap::~RasterizerBitmap() {
 }
 
 void RasterizerBitmap::GetPixelsForTesting(std::vector<unsigned char>* pixels) {
-  gfx::PNGCodec::EncodeBGRASkBitmap(bitmap_, true, pixels);
+  SkAutoLockPixels lock(bitmap_);
+  gfx::PNGCodec::Encode(
+      reinterpret_cast<const unsigned char*>(bitmap_.getPixels()),
+      gfx::PNGCodec::FORMAT_RGBA, size_, bitmap_.rowBytes(), true,
+      std::vector<gfx::PNGCodec::Comment>(), pixels);
 }
 
 scoped_ptr<mojo::GLTexture> RasterizerBitmap::Rasterize(SkPicture* picture) {
-  auto size = picture->cullRect();
-  bitmap_.allocN32Pixels(size.width(), size.height());
+  TRACE_EVENT0("sky", "RasterizerBitmap::Rasterize");
+
+  auto cull_rect = picture->cullRect();
+  gfx::Size size(cull_rect.width(), cull_rect.height());
+
+  if (size != size_) {
+    size_ = size;
+    bitmap_.reset();
+    previous_bitmap_.reset();
+    band_changed_frame_.assign(BandCount(size.height()), 0);
+    texture_frames_.clear();
+  }
+
+  // The buffers are reused for as long as the size stays the same.
+  bitmap_.swap(previous_bitmap_);
+  if (bitmap_.isNull()) {
+    // Uploads take the pixels as they are, so they have to be in GL's byte
+    // order and tightly packed.
+    bitmap_.allocPixels(SkImageInfo::Make(size.width(), size.height(),
+                                          kRGBA_8888_SkColorType,
+                                          kPremul_SkAlphaType));
+  }
+
+  frame_count_++;
+  RasterizeBands(picture);
+  FindChangedBands();
+
+  scoped_ptr<mojo::GLTexture> texture =
+      host_->resource_manager()->CreateTexture(size);
+  Upload(texture.get());
+  return texture.Pass();
+}
+
+void RasterizerBitmap::RasterizeBands(SkPicture* picture) {
+  scoped_refptr<BandRasterizer> rasterizer =
+      new BandRasterizer(bitmap_, picture);
+
+  // The calling thread works on bands too, so it only needs helpers for the
+  // remaining cores.
+  const int helper_count =
+      std::min(rasterizer->band_count(),
+               base::SysInfo::NumberOfProcessors()) - 1;
+  for (int i = 0; i < helper_count; ++i) {
+    base::WorkerPool::PostTask(
+        FROM_HERE, base::Bind(&BandRasterizer::Run, rasterizer), false);
+  }
+
+  rasterizer->Run();
+  rasterizer->Wait();
+}
+
+void RasterizerBitmap::FindChangedBands() {
+  TRACE_EVENT0("sky", "RasterizerBitmap::FindChangedBands");
+
+  if (previous_bitmap_.isNull()) {
+    std::fill(band_changed_frame_.begin(), band_changed_frame_.end(),
+              frame_count_);
+    return;
+  }
+
+  DCHECK_EQ(bitmap_.rowBytes(), previous_bitmap_.rowBytes());
+  const size_t row_bytes = bitmap_.rowBytes();
+  for (size_t band = 0; band < band_changed_frame_.size(); ++band) {
+    const int top = band * kBandHeight;
+    const int rows = std::min(kBandHeight, bitmap_.height() - top);
+    if (memcmp(bitmap_.getAddr(0, top), previous_bitmap_.getAddr(0, top),
+               row_bytes * rows) != 0) {
+      band_changed_frame_[band] = frame_count_;
+    }
+  }
+}
+
+void RasterizerBitmap::Upload(mojo::GLTexture* texture) {
+  TRACE_EVENT0("sky", "RasterizerBitmap::Upload");
+
+  // Textures that are new to us have undefined contents and get every band.
+  uint64_t& texture_frame = texture_frames_[texture->texture_id()];
+
+  mojo::GaneshContext::Scope scope(host_->ganesh_context());
+  glBindTexture(GL_TEXTURE_2D, texture->texture_id());
+  glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+  // Runs of adjacent changed bands are uploaded with a single call.
+  const int band_count = band_changed_frame_.size();
+  for (int band = 0; band < band_count;) {
+    if (band_changed_frame_[band] <= texture_frame) {
+      ++band;
+      continue;
+    }
+    const int first_band = band;
+    while (band < band_count && band_changed_frame_[band] > texture_frame)
+      ++band;
+
+    const int top = first_band * kBandHeight;
+    const int bottom = std::min(band * kBandHeight, bitmap_.height());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, top, bitmap_.width(), bottom - top,
+                    GL_RGBA, GL_UNSIGNED_BYTE, bitmap_.getAddr(0, top));
+  }
 
-  SkBitmapDevice device(bitmap_);
-  SkCanvas canvas(&device);
-  canvas.clear(SK_ColorBLACK);
-  canvas.drawPicture(picture);
-  canvas.flush();
+  texture_frame = frame_count_;
 
-  return host_->resource_manager()->CreateTexture(
-      gfx::Size(size.width(), size.height()));
+  // Ganesh shares the GL context and caches the state changed above.
+  host_->ganesh_context()->gr()->resetContext();
 }
 
 }  // namespace sky
@@ -5,12 +5,19 @@
 #ifndef SKY_VIEWER_COMPOSITOR_DISPLAY_RASTERIZER_BITMAP_H_
 #define SKY_VIEWER_COMPOSITOR_DISPLAY_RASTERIZER_BITMAP_H_
 
+#include <vector>
+
+#include "base/containers/hash_tables.h"
 #include "services/sky/compositor/rasterizer.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "ui/gfx/geometry/size.h"
 
 namespace sky {
 class LayerHost;
 
+// RasterizerBitmap rasterizes on the CPU, splitting each frame into
+// horizontal bands that are rasterized in parallel. Only the bands that
+// changed since a texture was last filled are uploaded into it.
 class RasterizerBitmap : public Rasterizer {
  public:
   explicit RasterizerBitmap(LayerHost* host);
@@ -20,8 +27,25 @@ class RasterizerBitmap : public Rasterizer {
   void GetPixelsForTesting(std::vector<unsigned char>* pixels);
 
  private:
+  void RasterizeBands(SkPicture* picture);
+  void FindChangedBands();
+  void Upload(mojo::GLTexture* texture);
+
   LayerHost* host_;
+  gfx::Size size_;
+
+  // |bitmap_| holds the most recent frame and |previous_bitmap_| the one
+  // before it. The two are swapped at the start of every frame.
   SkBitmap bitmap_;
+  SkBitmap previous_bitmap_;
+
+  // Frames are numbered from 1.
+  uint64_t frame_count_;
+  // The frame in which the contents of each band last changed.
+  std::vector<uint64_t> band_changed_frame_;
+  // The frame whose contents each texture of the current size holds, by
+  // texture id.
+  base::hash_map<uint32_t, uint64_t> texture_frames_;
 
   DISALLOW_COPY_AND_ASSIGN(RasterizerBitmap);
 };
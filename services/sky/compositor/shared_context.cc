@@ -0,0 +1,32 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "services/sky/compositor/shared_context.h"
+
+#include "base/logging.h"
+
+namespace sky {
+namespace {
+
+// Views are created and destroyed on the main thread.
+SharedContext* g_shared_context = nullptr;
+
+}  // namespace
+
+scoped_refptr<SharedContext> SharedContext::Get(mojo::Shell* shell) {
+  if (!g_shared_context)
+    g_shared_context = new SharedContext(shell);
+  return g_shared_context;
+}
+
+SharedContext::SharedContext(mojo::Shell* shell)
+    : gl_context_owner_(shell), ganesh_context_(gl_context()) {
+}
+
+SharedContext::~SharedContext() {
+  DCHECK_EQ(g_shared_context, this);
+  g_shared_context = nullptr;
+}
+
+}  // namespace sky
@@ -0,0 +1,48 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_VIEWER_COMPOSITOR_SHARED_CONTEXT_H_
+#define SKY_VIEWER_COMPOSITOR_SHARED_CONTEXT_H_
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "mojo/gpu/gl_context_owner.h"
+#include "mojo/skia/ganesh_context.h"
+
+namespace mojo {
+class Shell;
+}
+
+namespace sky {
+
+// The GL and Ganesh contexts the views of the content handler draw with.
+// Views share them, along with Ganesh's glyph and resource caches, so that
+// every app after the first costs little more than its isolate. Views reset
+// the Ganesh context before they draw, since others leave their state in it.
+class SharedContext : public base::RefCounted<SharedContext> {
+ public:
+  // Returns the context of the live views, or creates one with |shell|.
+  static scoped_refptr<SharedContext> Get(mojo::Shell* shell);
+
+  const base::WeakPtr<mojo::GLContext>& gl_context() const {
+    return gl_context_owner_.context();
+  }
+
+  mojo::GaneshContext* ganesh_context() { return &ganesh_context_; }
+
+ private:
+  friend class base::RefCounted<SharedContext>;
+
+  explicit SharedContext(mojo::Shell* shell);
+  ~SharedContext();
+
+  mojo::GLContextOwner gl_context_owner_;
+  mojo::GaneshContext ganesh_context_;
+
+  DISALLOW_COPY_AND_ASSIGN(SharedContext);
+};
+
+}  // namespace sky
+
+#endif  // SKY_VIEWER_COMPOSITOR_SHARED_CONTEXT_H_
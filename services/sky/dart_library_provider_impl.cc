@@ -15,7 +15,7 @@ DartLibraryProviderImpl::PrefetchedLibrary::~PrefetchedLibrary() {
 DartLibraryProviderImpl::DartLibraryProviderImpl(
     mojo::NetworkService* network_service,
     scoped_ptr<PrefetchedLibrary> prefetched)
-    : shell::DartLibraryProviderNetwork(network_service),
+    : shell::DartLibraryProviderNetwork(network_service, base::FilePath()),
       prefetched_library_(prefetched.Pass()) {
 }
 
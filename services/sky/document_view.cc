@@ -210,7 +210,7 @@ mojo::Shell* DocumentView::GetShell() {
 
 void DocumentView::BeginFrame(base::TimeTicks frame_time) {
   if (sky_view_) {
-    std::unique_ptr<compositor::LayerTree> layer_tree = sky_view_->BeginFrame(frame_time);
+    std::unique_ptr<compositor::LayerTree> layer_tree = sky_view_->BeginFrame(frame_time, base::TimeTicks());
     if (layer_tree)
       current_layer_tree_ = std::move(layer_tree);
     root_layer_->SetSize(sky_view_->display_metrics().physical_size);
@@ -226,7 +226,7 @@ void DocumentView::PaintContents(SkCanvas* canvas, const gfx::Rect& clip) {
   if (current_layer_tree_) {
     compositor::PaintContext::ScopedFrame frame =
         paint_context_.AcquireFrame(*canvas, nullptr);
-    current_layer_tree_->root_layer()->Paint(frame);
+    current_layer_tree_->Raster(frame);
   }
 }
 
@@ -340,4 +340,24 @@ void DocumentView::ScheduleFrame() {
   layer_host_->SetNeedsAnimate();
 }
 
+void DocumentView::RasterizeToImage(
+    scoped_ptr<sky::compositor::LayerTree> layer_tree,
+    const ImageCallback& callback) {
+  // Frames are rasterized in software here, so there is no GPU image to
+  // hand out.
+  base::ThreadTaskRunnerHandle::Get()->PostTask(
+      FROM_HERE, base::Bind(callback, RefPtr<SkImage>(),
+                            scoped_refptr<base::SingleThreadTaskRunner>()));
+}
+
+sky::compositor::CompositorStatistics DocumentView::GetCompositorStatistics() {
+  // This embedder does not collect compositor statistics.
+  return sky::compositor::CompositorStatistics();
+}
+
+bool DocumentView::GetScrollOffset(uint32_t scroll_id, SkPoint* offset) {
+  // Nothing scrolls the scroll layers of this embedder's frames.
+  return false;
+}
+
 }  // namespace sky
@@ -81,6 +81,10 @@ class DocumentView : public blink::ServiceProvider,
  private:
   // SkyViewClient methods:
   void DidCreateIsolate(Dart_Isolate isolate) override;
+  void RasterizeToImage(scoped_ptr<sky::compositor::LayerTree> layer_tree,
+                        const ImageCallback& callback) override;
+  sky::compositor::CompositorStatistics GetCompositorStatistics() override;
+  bool GetScrollOffset(uint32_t scroll_id, SkPoint* offset) override;
 
   // Services methods:
   mojo::NavigatorHost* NavigatorHost() override;
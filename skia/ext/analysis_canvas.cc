@@ -95,6 +95,10 @@ void AnalysisCanvas::SetForceNotTransparent(bool flag) {
     is_transparent_ = false;
 }
 
+void AnalysisCanvas::SetMaxDrawOpCount(int count) {
+  max_draw_op_count_ = count;
+}
+
 void AnalysisCanvas::onDrawPaint(const SkPaint& paint) {
   SkRect rect;
   getClipBounds(&rect);
@@ -107,6 +111,7 @@ void AnalysisCanvas::onDrawPoints(SkCanvas::PointMode mode,
                                   const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -155,12 +160,14 @@ void AnalysisCanvas::onDrawRect(const SkRect& rect, const SkPaint& paint) {
   } else {
     is_solid_color_ = false;
   }
+  TrackOpaqueRect(rect, paint);
   ++draw_op_count_;
 }
 
 void AnalysisCanvas::onDrawOval(const SkRect& oval, const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -170,25 +177,28 @@ void AnalysisCanvas::onDrawRRect(const SkRRect& rr, const SkPaint& paint) {
   // do the same work here.
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
 void AnalysisCanvas::onDrawPath(const SkPath& path, const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
 void AnalysisCanvas::onDrawBitmap(const SkBitmap& bitmap,
                                   SkScalar left,
                                   SkScalar top,
-                                  const SkPaint*) {
+                                  const SkPaint* paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(paint);
   ++draw_op_count_;
 }
 
-void AnalysisCanvas::onDrawBitmapRect(const SkBitmap&,
+void AnalysisCanvas::onDrawBitmapRect(const SkBitmap& bitmap,
                                       const SkRect* src,
                                       const SkRect& dst,
                                       const SkPaint* paint,
@@ -198,8 +208,14 @@ void AnalysisCanvas::onDrawBitmapRect(const SkBitmap&,
   SkPaint tmpPaint;
   if (!paint)
     paint = &tmpPaint;
+  const SkIRect opaque_rect = opaque_rect_;
   drawRect(dst, *paint);
   is_solid_color_ = false;
+  // drawRect took the bitmap to be as opaque as the paint.
+  if (!bitmap.isOpaque()) {
+    opaque_rect_ = opaque_rect;
+    UntrackOpaqueRect(paint);
+  }
   ++draw_op_count_;
 }
 
@@ -209,6 +225,7 @@ void AnalysisCanvas::onDrawBitmapNine(const SkBitmap& bitmap,
                                       const SkPaint* paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(paint);
   ++draw_op_count_;
 }
 
@@ -218,6 +235,7 @@ void AnalysisCanvas::onDrawSprite(const SkBitmap& bitmap,
                                   const SkPaint* paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(paint);
   ++draw_op_count_;
 }
 
@@ -228,6 +246,7 @@ void AnalysisCanvas::onDrawText(const void* text,
                                 const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -237,6 +256,7 @@ void AnalysisCanvas::onDrawPosText(const void* text,
                                    const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -247,6 +267,7 @@ void AnalysisCanvas::onDrawPosTextH(const void* text,
                                     const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -257,6 +278,7 @@ void AnalysisCanvas::onDrawTextOnPath(const void* text,
                                       const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -266,6 +288,7 @@ void AnalysisCanvas::onDrawTextBlob(const SkTextBlob* blob,
                                     const SkPaint &paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -274,6 +297,7 @@ void AnalysisCanvas::onDrawDRRect(const SkRRect& outer,
                                   const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -288,6 +312,7 @@ void AnalysisCanvas::onDrawVertices(SkCanvas::VertexMode,
                                     const SkPaint& paint) {
   is_solid_color_ = false;
   is_transparent_ = false;
+  UntrackOpaqueRect(&paint);
   ++draw_op_count_;
 }
 
@@ -309,7 +334,9 @@ AnalysisCanvas::AnalysisCanvas(int width, int height)
       is_solid_color_(true),
       color_(SK_ColorTRANSPARENT),
       is_transparent_(true),
-      draw_op_count_(0) {
+      draw_op_count_(0),
+      max_draw_op_count_(1),
+      opaque_rect_(SkIRect::MakeEmpty()) {
 }
 
 AnalysisCanvas::~AnalysisCanvas() {}
@@ -326,16 +353,64 @@ bool AnalysisCanvas::GetColorIfSolid(SkColor* color) const {
   return false;
 }
 
+bool AnalysisCanvas::GetOpaqueRect(SkIRect* rect) const {
+  if (opaque_rect_.isEmpty())
+    return false;
+  *rect = opaque_rect_;
+  return true;
+}
+
+void AnalysisCanvas::TrackOpaqueRect(const SkRect& rect,
+                                     const SkPaint& paint) {
+  if (is_forced_not_solid_ || !IsSolidColorPaint(paint)) {
+    UntrackOpaqueRect(&paint);
+    return;
+  }
+
+  // Antialiased clips are only known to cover the pixels inside of them,
+  // so the rect is rounded in.
+  const SkMatrix& matrix = getTotalMatrix();
+  if (!isClipRect() || !matrix.rectStaysRect())
+    return;
+  SkRect device_rect;
+  matrix.mapRect(&device_rect, rect);
+  SkIRect clip_rect;
+  if (!getClipDeviceBounds(&clip_rect) ||
+      !device_rect.intersect(SkRect::Make(clip_rect))) {
+    return;
+  }
+  SkIRect opaque_rect;
+  device_rect.roundIn(&opaque_rect);
+  if (opaque_rect.isEmpty())
+    return;
+
+  const int64_t area =
+      static_cast<int64_t>(opaque_rect.width()) * opaque_rect.height();
+  const int64_t tracked_area =
+      static_cast<int64_t>(opaque_rect_.width()) * opaque_rect_.height();
+  if (area > tracked_area)
+    opaque_rect_ = opaque_rect;
+}
+
+void AnalysisCanvas::UntrackOpaqueRect(const SkPaint* paint) {
+  SkXfermode::Mode xfermode = SkXfermode::kSrcOver_Mode;
+  if (paint)
+    SkXfermode::AsMode(paint->getXfermode(), &xfermode);
+  if (xfermode != SkXfermode::kSrcOver_Mode)
+    opaque_rect_.setEmpty();
+}
+
 bool AnalysisCanvas::abort() {
-  // Early out as soon as we have more than one draw op.
-  // TODO(vmpstr): Investigate if 1 is the correct metric here. We need to
+  // Early out as soon as we have more than |max_draw_op_count_| draw ops.
+  // TODO(vmpstr): Investigate if 1 is the correct default here. We need to
   // balance the amount of time we spend analyzing vs how many tiles would be
   // solid if the number was higher.
-  if (draw_op_count_ > 1) {
+  if (draw_op_count_ > max_draw_op_count_) {
     // We have to reset solid/transparent state to false since we don't
     // know whether consequent operations will make this false.
     is_solid_color_ = false;
     is_transparent_ = false;
+    opaque_rect_.setEmpty();
     return true;
   }
   return false;
@@ -419,6 +494,8 @@ SkCanvas::SaveLayerStrategy AnalysisCanvas::willSaveLayer(
   SkXfermode::Mode xfermode = SkXfermode::kSrc_Mode;
   if (paint)
     SkXfermode::AsMode(paint->getXfermode(), &xfermode);
+  // The layer is composited with |paint| once it is restored.
+  UntrackOpaqueRect(paint);
   if (xfermode != SkXfermode::kDst_Mode) {
     if (force_not_transparent_stack_level_ == kNoLayer) {
       force_not_transparent_stack_level_ = saved_stack_size_;
@@ -27,6 +27,19 @@ class SK_API AnalysisCanvas : public SkCanvas,
   void SetForceNotSolid(bool flag);
   void SetForceNotTransparent(bool flag);
 
+  // Playback is aborted as soon as more than |count| draw ops have been seen.
+  // The default of 1 is all that is needed to answer GetColorIfSolid(). Raise
+  // it to use draw_op_count() as a bounded estimate of picture complexity.
+  void SetMaxDrawOpCount(int count);
+
+  int draw_op_count() const { return draw_op_count_; }
+
+  // Returns false if nothing drawn so far is known to be opaque. Otherwise
+  // sets |rect| to a device space rect that is covered with opaque pixels.
+  // It is the largest such rect drawn by a single op, which is not
+  // necessarily the largest opaque rect there is.
+  bool GetOpaqueRect(SkIRect* rect) const;
+
   // SkPicture::AbortCallback override.
   bool abort() override;
 
@@ -115,6 +128,12 @@ class SK_API AnalysisCanvas : public SkCanvas,
   void OnComplexClip();
 
  private:
+  // Called for rects filled with |paint|, in local coordinates.
+  void TrackOpaqueRect(const SkRect& rect, const SkPaint& paint);
+  // Called for the other ops. Drops the opaque rect if the op may make the
+  // pixels under it less opaque.
+  void UntrackOpaqueRect(const SkPaint* paint);
+
   typedef SkCanvas INHERITED;
 
   int saved_stack_size_;
@@ -127,6 +146,8 @@ class SK_API AnalysisCanvas : public SkCanvas,
   SkColor color_;
   bool is_transparent_;
   int draw_op_count_;
+  int max_draw_op_count_;
+  SkIRect opaque_rect_;
 };
 
 }  // namespace skia
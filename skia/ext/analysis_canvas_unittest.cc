@@ -360,6 +360,35 @@ TEST(AnalysisCanvasTest, EarlyOutNotSolid) {
 
 }
 
+TEST(AnalysisCanvasTest, MaxDrawOpCount) {
+  SkPictureRecorder recorder;
+  skia::RefPtr<SkCanvas> record_canvas =
+      skia::SharePtr(recorder.beginRecording(256, 256));
+
+  SkPaint paint;
+  paint.setColor(SkColorSetARGB(255, 255, 255, 255));
+
+  for (int i = 0; i < 5; ++i)
+    record_canvas->drawRect(SkRect::MakeXYWH(i * 10, 0, 5, 5), paint);
+
+  skia::RefPtr<SkPicture> picture = skia::AdoptRef(recorder.endRecording());
+
+  // A limit above the op count lets the whole picture play back.
+  skia::AnalysisCanvas full_canvas(256, 256);
+  full_canvas.SetMaxDrawOpCount(10);
+  picture->playback(&full_canvas, &full_canvas);
+  EXPECT_EQ(5, full_canvas.draw_op_count());
+
+  // Playback stops as soon as the limit is exceeded.
+  skia::AnalysisCanvas limited_canvas(256, 256);
+  limited_canvas.SetMaxDrawOpCount(2);
+  picture->playback(&limited_canvas, &limited_canvas);
+  EXPECT_EQ(3, limited_canvas.draw_op_count());
+
+  SkColor output_color;
+  EXPECT_FALSE(limited_canvas.GetColorIfSolid(&output_color));
+}
+
 TEST(AnalysisCanvasTest, ClipComplexRegion) {
   skia::AnalysisCanvas canvas(255, 255);
 
@@ -391,4 +420,62 @@ TEST(AnalysisCanvasTest, ClipComplexRegion) {
   EXPECT_FALSE(canvas.GetColorIfSolid(&outputColor));
 }
 
+TEST(AnalysisCanvasTest, OpaqueRect) {
+  skia::AnalysisCanvas canvas(255, 255);
+
+  SkIRect opaque_rect;
+  EXPECT_FALSE(canvas.GetOpaqueRect(&opaque_rect));
+
+  SkPaint paint;
+  paint.setColor(SkColorSetARGB(255, 11, 22, 33));
+  canvas.drawRect(SkRect::MakeXYWH(10, 10, 50, 50), paint);
+  EXPECT_TRUE(canvas.GetOpaqueRect(&opaque_rect));
+  EXPECT_EQ(SkIRect::MakeXYWH(10, 10, 50, 50), opaque_rect);
+
+  // Translucent paint keeps what is under it opaque, but adds nothing.
+  SkPaint translucent_paint;
+  translucent_paint.setColor(SkColorSetARGB(128, 11, 22, 33));
+  canvas.drawRect(SkRect::MakeWH(255, 255), translucent_paint);
+  EXPECT_TRUE(canvas.GetOpaqueRect(&opaque_rect));
+  EXPECT_EQ(SkIRect::MakeXYWH(10, 10, 50, 50), opaque_rect);
+
+  // The larger of two opaque rects wins. Fractional edges are rounded in.
+  canvas.save();
+  canvas.translate(0.5f, 100);
+  canvas.drawRect(SkRect::MakeWH(100, 100), paint);
+  canvas.restore();
+  EXPECT_TRUE(canvas.GetOpaqueRect(&opaque_rect));
+  EXPECT_EQ(SkIRect::MakeLTRB(1, 100, 100, 200), opaque_rect);
+
+  // Clipping to a path leaves it unclear which pixels are covered.
+  canvas.save();
+  SkPath path;
+  path.addCircle(128, 128, 128);
+  canvas.clipPath(path);
+  canvas.drawRect(SkRect::MakeWH(255, 255), paint);
+  canvas.restore();
+  EXPECT_TRUE(canvas.GetOpaqueRect(&opaque_rect));
+  EXPECT_EQ(SkIRect::MakeLTRB(1, 100, 100, 200), opaque_rect);
+
+  // Clearing may punch a hole into the opaque rect.
+  SkPaint clear_paint;
+  clear_paint.setXfermodeMode(SkXfermode::kClear_Mode);
+  canvas.drawRect(SkRect::MakeXYWH(0, 0, 5, 5), clear_paint);
+  EXPECT_FALSE(canvas.GetOpaqueRect(&opaque_rect));
+
+  // Bitmaps without alpha are as opaque as the rect they are drawn into.
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(8, 8, false);
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+  canvas.drawBitmapRect(bitmap, SkRect::MakeWH(200, 200), nullptr);
+  EXPECT_FALSE(canvas.GetOpaqueRect(&opaque_rect));
+
+  SkBitmap opaque_bitmap;
+  opaque_bitmap.allocN32Pixels(8, 8, true);
+  opaque_bitmap.eraseColor(SK_ColorWHITE);
+  canvas.drawBitmapRect(opaque_bitmap, SkRect::MakeWH(200, 200), nullptr);
+  EXPECT_TRUE(canvas.GetOpaqueRect(&opaque_rect));
+  EXPECT_EQ(SkIRect::MakeWH(200, 200), opaque_rect);
+}
+
 }  // namespace skia
@@ -4,10 +4,16 @@
 
 #include <algorithm>
 
+#include "base/atomic_ref_count.h"
+#include "base/bind.h"
+#include "base/location.h"
 #include "base/logging.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/worker_pool.h"
 #include "skia/ext/convolver.h"
 #include "skia/ext/convolver_SSE2.h"
 #include "skia/ext/convolver_mips_dspr2.h"
+#include "skia/ext/convolver_neon.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
@@ -36,6 +42,8 @@ inline unsigned char BringBackTo8(int a, bool take_absolute) {
   return ClampTo8(a);
 }
 
+}  // namespace
+
 // Stores a list of rows in a circular buffer. The usage is you write into it
 // by calling AdvanceRow. It will keep track of which row in the buffer it
 // should use next, and the total number of rows added.
@@ -123,6 +131,8 @@ class CircularRowBuffer {
   std::vector<unsigned char*> row_addresses_;
 };
 
+namespace {
+
 // Convolves horizontally along a single row. The row data is given in
 // |src_data| and continues for the num_values() of the filter.
 template<bool has_alpha>
@@ -370,25 +380,68 @@ void SetupSIMD(ConvolveProcs *procs) {
   procs->extra_horizontal_reads = 3;
   procs->convolve_vertically = &ConvolveVertically_mips_dspr2;
   procs->convolve_horizontally = &ConvolveHorizontally_mips_dspr2;
+#elif defined SIMD_NEON
+  procs->extra_horizontal_reads = 0;
+  procs->convolve_vertically = &ConvolveVertically_neon;
+  procs->convolve_horizontally = &ConvolveHorizontally_neon;
 #endif
 }
 
-void BGRAConvolve2D(const unsigned char* source_data,
-                    int source_byte_row_stride,
-                    bool source_has_alpha,
-                    const ConvolutionFilter1D& filter_x,
-                    const ConvolutionFilter1D& filter_y,
-                    int output_byte_row_stride,
-                    unsigned char* output,
-                    bool use_simd_if_possible) {
-  ConvolveProcs simd;
-  simd.extra_horizontal_reads = 0;
-  simd.convolve_vertically = NULL;
-  simd.convolve_4rows_horizontally = NULL;
-  simd.convolve_horizontally = NULL;
+namespace {
+
+void InitConvolveProcs(ConvolveProcs* procs, bool use_simd_if_possible) {
+  procs->extra_horizontal_reads = 0;
+  procs->convolve_vertically = NULL;
+  procs->convolve_4rows_horizontally = NULL;
+  procs->convolve_horizontally = NULL;
   if (use_simd_if_possible) {
-    SetupSIMD(&simd);
+    SetupSIMD(procs);
+  }
+}
+
+void ConvolveRowHorizontally(const ConvolveProcs& simd,
+                             bool use_simd,
+                             const unsigned char* source_row,
+                             bool source_has_alpha,
+                             const ConvolutionFilter1D& filter_x,
+                             unsigned char* out_row) {
+  if (use_simd && simd.convolve_horizontally) {
+    simd.convolve_horizontally(source_row, filter_x, out_row,
+                               source_has_alpha);
+  } else if (source_has_alpha) {
+    ConvolveHorizontally<true>(source_row, filter_x, out_row);
+  } else {
+    ConvolveHorizontally<false>(source_row, filter_x, out_row);
+  }
+}
+
+void ConvolveRowVertically(const ConvolveProcs& simd,
+                           const ConvolutionFilter1D::Fixed* filter_values,
+                           int filter_length,
+                           unsigned char* const* source_data_rows,
+                           int pixel_width,
+                           unsigned char* out_row,
+                           bool source_has_alpha) {
+  if (simd.convolve_vertically) {
+    simd.convolve_vertically(filter_values, filter_length, source_data_rows,
+                             pixel_width, out_row, source_has_alpha);
+  } else {
+    ConvolveVertically(filter_values, filter_length, source_data_rows,
+                       pixel_width, out_row, source_has_alpha);
   }
+}
+
+// Produces the output rows in [first_out_y, end_out_y).
+void BGRAConvolveRows(const ConvolveProcs& simd,
+                      const unsigned char* source_data,
+                      int source_byte_row_stride,
+                      bool source_has_alpha,
+                      const ConvolutionFilter1D& filter_x,
+                      const ConvolutionFilter1D& filter_y,
+                      int output_byte_row_stride,
+                      unsigned char* output,
+                      int first_out_y,
+                      int end_out_y) {
 
   int max_y_filter_size = filter_y.max_filter();
 
@@ -399,7 +452,7 @@ void BGRAConvolve2D(const unsigned char* source_data,
   // row for convolution as the first pixel for the first vertical filter.
   int filter_offset, filter_length;
   const ConvolutionFilter1D::Fixed* filter_values =
-      filter_y.FilterForValue(0, &filter_offset, &filter_length);
+      filter_y.FilterForValue(first_out_y, &filter_offset, &filter_length);
   int next_x_row = filter_offset;
 
   // We loop over each row in the input doing a horizontal convolution. This
@@ -443,7 +496,7 @@ void BGRAConvolve2D(const unsigned char* source_data,
   filter_y.FilterForValue(num_output_rows - 1, &last_filter_offset,
                           &last_filter_length);
 
-  for (int out_y = 0; out_y < num_output_rows; out_y++) {
+  for (int out_y = first_out_y; out_y < end_out_y; out_y++) {
     filter_values = filter_y.FilterForValue(out_y,
                                             &filter_offset, &filter_length);
 
@@ -462,23 +515,12 @@ void BGRAConvolve2D(const unsigned char* source_data,
         next_x_row += 4;
       } else {
         // Check if we need to avoid SSE2 for this row.
-        if (simd.convolve_horizontally &&
+        ConvolveRowHorizontally(
+            simd,
             next_x_row < last_filter_offset + last_filter_length -
-            avoid_simd_rows) {
-          simd.convolve_horizontally(
-              &source_data[next_x_row * source_byte_row_stride],
-              filter_x, row_buffer.AdvanceRow(), source_has_alpha);
-        } else {
-          if (source_has_alpha) {
-            ConvolveHorizontally<true>(
-                &source_data[next_x_row * source_byte_row_stride],
-                filter_x, row_buffer.AdvanceRow());
-          } else {
-            ConvolveHorizontally<false>(
-                &source_data[next_x_row * source_byte_row_stride],
-                filter_x, row_buffer.AdvanceRow());
-          }
-        }
+                avoid_simd_rows,
+            &source_data[next_x_row * source_byte_row_stride],
+            source_has_alpha, filter_x, row_buffer.AdvanceRow());
         next_x_row++;
       }
     }
@@ -496,17 +538,195 @@ void BGRAConvolve2D(const unsigned char* source_data,
     unsigned char* const* first_row_for_filter =
         &rows_to_convolve[filter_offset - first_row_in_circular_buffer];
 
-    if (simd.convolve_vertically) {
-      simd.convolve_vertically(filter_values, filter_length,
-                               first_row_for_filter,
-                               filter_x.num_values(), cur_output_row,
-                               source_has_alpha);
-    } else {
-      ConvolveVertically(filter_values, filter_length,
-                         first_row_for_filter,
-                         filter_x.num_values(), cur_output_row,
-                         source_has_alpha);
-    }
+    ConvolveRowVertically(simd, filter_values, filter_length,
+                          first_row_for_filter, filter_x.num_values(),
+                          cur_output_row, source_has_alpha);
+  }
+}
+
+struct ConvolveBand {
+  const ConvolveProcs* simd;
+  const unsigned char* source_data;
+  int source_byte_row_stride;
+  bool source_has_alpha;
+  const ConvolutionFilter1D* filter_x;
+  const ConvolutionFilter1D* filter_y;
+  int output_byte_row_stride;
+  unsigned char* output;
+  int first_out_y;
+  int end_out_y;
+};
+
+void RunConvolveBand(const ConvolveBand* band) {
+  BGRAConvolveRows(*band->simd, band->source_data,
+                   band->source_byte_row_stride, band->source_has_alpha,
+                   *band->filter_x, *band->filter_y,
+                   band->output_byte_row_stride, band->output,
+                   band->first_out_y, band->end_out_y);
+}
+
+// Runs on the worker pool. |pending| and |done| live on the stack of the
+// thread waiting in BGRAConvolve2DInParallel.
+void RunConvolveBandOnWorker(const ConvolveBand* band,
+                             base::AtomicRefCount* pending,
+                             base::WaitableEvent* done) {
+  RunConvolveBand(band);
+  if (!base::AtomicRefCountDec(pending))
+    done->Signal();
+}
+
+}  // namespace
+
+void BGRAConvolve2D(const unsigned char* source_data,
+                    int source_byte_row_stride,
+                    bool source_has_alpha,
+                    const ConvolutionFilter1D& filter_x,
+                    const ConvolutionFilter1D& filter_y,
+                    int output_byte_row_stride,
+                    unsigned char* output,
+                    bool use_simd_if_possible) {
+  ConvolveProcs simd;
+  InitConvolveProcs(&simd, use_simd_if_possible);
+  BGRAConvolveRows(simd, source_data, source_byte_row_stride,
+                   source_has_alpha, filter_x, filter_y,
+                   output_byte_row_stride, output, 0, filter_y.num_values());
+}
+
+void BGRAConvolve2DInParallel(const unsigned char* source_data,
+                              int source_byte_row_stride,
+                              bool source_has_alpha,
+                              const ConvolutionFilter1D& filter_x,
+                              const ConvolutionFilter1D& filter_y,
+                              int output_byte_row_stride,
+                              unsigned char* output,
+                              bool use_simd_if_possible,
+                              int thread_count) {
+  int num_output_rows = filter_y.num_values();
+  int band_count = std::max(1, std::min(thread_count, num_output_rows));
+  if (band_count == 1) {
+    BGRAConvolve2D(source_data, source_byte_row_stride, source_has_alpha,
+                   filter_x, filter_y, output_byte_row_stride, output,
+                   use_simd_if_possible);
+    return;
+  }
+
+  ConvolveProcs simd;
+  InitConvolveProcs(&simd, use_simd_if_possible);
+
+  std::vector<ConvolveBand> bands(band_count);
+  for (int i = 0; i < band_count; ++i) {
+    ConvolveBand& band = bands[i];
+    band.simd = &simd;
+    band.source_data = source_data;
+    band.source_byte_row_stride = source_byte_row_stride;
+    band.source_has_alpha = source_has_alpha;
+    band.filter_x = &filter_x;
+    band.filter_y = &filter_y;
+    band.output_byte_row_stride = output_byte_row_stride;
+    band.output = output;
+    band.first_out_y = num_output_rows * i / band_count;
+    band.end_out_y = num_output_rows * (i + 1) / band_count;
+  }
+
+  // The last band runs on this thread while the others are on the pool.
+  base::AtomicRefCount pending = band_count - 1;
+  base::WaitableEvent done(false, false);
+  for (int i = 0; i < band_count - 1; ++i) {
+    base::Closure task = base::Bind(&RunConvolveBandOnWorker, &bands[i],
+                                    &pending, &done);
+    if (!base::WorkerPool::PostTask(FROM_HERE, task, false))
+      task.Run();
+  }
+  RunConvolveBand(&bands[band_count - 1]);
+  done.Wait();
+}
+
+// BGRAStreamingConvolver ------------------------------------------------------
+
+BGRAStreamingConvolver::BGRAStreamingConvolver(
+    int source_width,
+    bool source_has_alpha,
+    const ConvolutionFilter1D& filter_x,
+    const ConvolutionFilter1D& filter_y,
+    int output_byte_row_stride,
+    unsigned char* output,
+    bool use_simd_if_possible)
+    : source_has_alpha_(source_has_alpha),
+      xfilter_(filter_x),
+      yfilter_(filter_y),
+      output_byte_row_stride_(output_byte_row_stride),
+      output_(output),
+      simd_(new ConvolveProcs),
+      use_simd_horizontally_(false),
+      next_source_row_(0),
+      next_x_row_(0),
+      end_x_row_(0),
+      next_output_row_(0) {
+  SkASSERT(output_byte_row_stride >= filter_x.num_values() * 4);
+  InitConvolveProcs(simd_.get(), use_simd_if_possible);
+
+  // Source rows may come from separate buffers, so unlike BGRAConvolve2D
+  // the SIMD code cannot read into the next row.
+  int filter_offset, filter_length;
+  filter_x.FilterForValue(filter_x.num_values() - 1, &filter_offset,
+                          &filter_length);
+  use_simd_horizontally_ = filter_offset + filter_length +
+      simd_->extra_horizontal_reads <= source_width;
+
+  filter_y.FilterForValue(filter_y.num_values() - 1, &filter_offset,
+                          &filter_length);
+  end_x_row_ = filter_offset + filter_length;
+  filter_y.FilterForValue(0, &filter_offset, &filter_length);
+  next_x_row_ = filter_offset;
+
+  int row_buffer_width = (filter_x.num_values() + 15) & ~0xF;
+  row_buffer_.reset(new CircularRowBuffer(row_buffer_width,
+                                          filter_y.max_filter(),
+                                          filter_offset));
+
+  // Filters that are all zeros do not depend on any row.
+  ConvolveReadyRows();
+}
+
+BGRAStreamingConvolver::~BGRAStreamingConvolver() {
+}
+
+int BGRAStreamingConvolver::AddSourceRow(const unsigned char* source_row) {
+  int source_y = next_source_row_++;
+  // Rows above or below the subset of the image being convolved are not
+  // needed.
+  if (source_y < next_x_row_ || source_y >= end_x_row_)
+    return next_output_row_;
+
+  DCHECK_EQ(source_y, next_x_row_);
+  ConvolveRowHorizontally(*simd_, use_simd_horizontally_, source_row,
+                          source_has_alpha_, xfilter_,
+                          row_buffer_->AdvanceRow());
+  next_x_row_++;
+  ConvolveReadyRows();
+  return next_output_row_;
+}
+
+void BGRAStreamingConvolver::ConvolveReadyRows() {
+  int num_output_rows = yfilter_.num_values();
+  while (next_output_row_ < num_output_rows) {
+    int filter_offset, filter_length;
+    const ConvolutionFilter1D::Fixed* filter_values =
+        yfilter_.FilterForValue(next_output_row_, &filter_offset,
+                                &filter_length);
+    if (next_x_row_ < filter_offset + filter_length)
+      return;
+
+    int first_row_in_circular_buffer;
+    unsigned char* const* rows_to_convolve =
+        row_buffer_->GetRowAddresses(&first_row_in_circular_buffer);
+    ConvolveRowVertically(
+        *simd_, filter_values, filter_length,
+        &rows_to_convolve[filter_offset - first_row_in_circular_buffer],
+        xfilter_.num_values(),
+        &output_[next_output_row_ * output_byte_row_stride_],
+        source_has_alpha_);
+    next_output_row_++;
   }
 }
 
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "third_party/skia/include/core/SkSize.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
@@ -23,6 +24,11 @@
     defined(__mips_dsp) && (__mips_dsp_rev >= 2)
 #define SIMD_MIPS_DSPR2 1
 #endif
+
+// Only used when the whole build targets NEON, there is no runtime check.
+#if defined(ARCH_CPU_ARM_FAMILY) && defined(__ARM_NEON__)
+#define SIMD_NEON 1
+#endif
 // avoid confusion with Mac OS X's math library (Carbon)
 #if defined(__APPLE__)
 #undef FloatToFixed
@@ -191,6 +197,78 @@ SK_API void BGRAConvolve2D(const unsigned char* source_data,
                            unsigned char* output,
                            bool use_simd_if_possible);
 
+// Same as BGRAConvolve2D, but splits the output rows into up to
+// |thread_count| bands and convolves them on the shared worker pool. The
+// calling thread convolves one of the bands and returns once all of them are
+// done. The rows at the edges of each band are convolved horizontally by both
+// bands that need them, so this only pays off for images with many rows.
+SK_API void BGRAConvolve2DInParallel(const unsigned char* source_data,
+                                     int source_byte_row_stride,
+                                     bool source_has_alpha,
+                                     const ConvolutionFilter1D& xfilter,
+                                     const ConvolutionFilter1D& yfilter,
+                                     int output_byte_row_stride,
+                                     unsigned char* output,
+                                     bool use_simd_if_possible,
+                                     int thread_count);
+
+class CircularRowBuffer;
+struct ConvolveProcs;
+
+// Does the same convolution as BGRAConvolve2D on an image whose rows arrive
+// one at a time, for example as they are decoded. Every output row is
+// written as soon as all of the source rows it depends on have been added,
+// and only as many horizontally convolved rows as the vertical filter needs
+// are kept, so the source image never has to be held in memory.
+//
+// The filters are not copied and have to outlive the convolver.
+class SK_API BGRAStreamingConvolver {
+ public:
+  // |source_width| is the number of pixels in each source row.
+  BGRAStreamingConvolver(int source_width,
+                         bool source_has_alpha,
+                         const ConvolutionFilter1D& xfilter,
+                         const ConvolutionFilter1D& yfilter,
+                         int output_byte_row_stride,
+                         unsigned char* output,
+                         bool use_simd_if_possible);
+  ~BGRAStreamingConvolver();
+
+  // Takes the next row of the source image, starting with row 0. Returns the
+  // number of output rows that are complete.
+  int AddSourceRow(const unsigned char* source_row);
+
+  int completed_rows() const { return next_output_row_; }
+  bool IsComplete() const {
+    return next_output_row_ == yfilter_.num_values();
+  }
+
+ private:
+  void ConvolveReadyRows();
+
+  const bool source_has_alpha_;
+  const ConvolutionFilter1D& xfilter_;
+  const ConvolutionFilter1D& yfilter_;
+  const int output_byte_row_stride_;
+  unsigned char* const output_;
+
+  scoped_ptr<ConvolveProcs> simd_;
+  // Whether the SIMD horizontal convolution can be used without reading past
+  // the end of the source rows.
+  bool use_simd_horizontally_;
+  scoped_ptr<CircularRowBuffer> row_buffer_;
+
+  // The index of the next source row passed to AddSourceRow().
+  int next_source_row_;
+  // The first source row that has not been convolved horizontally yet.
+  int next_x_row_;
+  // One past the last source row any output row depends on.
+  int end_x_row_;
+  int next_output_row_;
+
+  DISALLOW_COPY_AND_ASSIGN(BGRAStreamingConvolver);
+};
+
 // Does a 1D convolution of the given source image along the X dimension on
 // a single channel of the bitmap.
 //
@@ -0,0 +1,156 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "skia/ext/convolver_neon.h"
+
+#if SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+namespace skia {
+
+#if SIMD_NEON
+namespace {
+
+// Widens the four BGRA pixels in |pixels| to 16 bits per channel.
+inline int16x8_t LowPixels(uint8x16_t pixels) {
+  return vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(pixels)));
+}
+
+inline int16x8_t HighPixels(uint8x16_t pixels) {
+  return vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(pixels)));
+}
+
+// Loads the single BGRA pixel at |pixel| into the low half of the result.
+inline int16x4_t LoadPixel(const unsigned char* pixel) {
+  uint32x2_t word = vld1_lane_u32(reinterpret_cast<const uint32_t*>(pixel),
+                                  vdup_n_u32(0), 0);
+  return vget_low_s16(vreinterpretq_s16_u16(
+      vmovl_u8(vreinterpret_u8_u32(word))));
+}
+
+// Brings the fixed point sums of two pixels back to 8 bits per channel,
+// clamping to 0-255 like ClampTo8 does.
+inline uint8x8_t PackPixels(int32x4_t first, int32x4_t second) {
+  uint16x4_t first16 =
+      vqmovun_s32(vshrq_n_s32(first, ConvolutionFilter1D::kShiftBits));
+  uint16x4_t second16 =
+      vqmovun_s32(vshrq_n_s32(second, ConvolutionFilter1D::kShiftBits));
+  return vqmovn_u16(vcombine_u16(first16, second16));
+}
+
+// Makes sure that the alpha of each pixel is not smaller than any of its
+// color channels, see ConvolveVertically in convolver.cc.
+inline uint32x4_t FixAlpha(uint32x4_t pixels) {
+  const uint32x4_t mask = vdupq_n_u32(0xff);
+  uint32x4_t max_color = vmaxq_u32(
+      vandq_u32(pixels, mask),
+      vmaxq_u32(vandq_u32(vshrq_n_u32(pixels, 8), mask),
+                vandq_u32(vshrq_n_u32(pixels, 16), mask)));
+  uint32x4_t alpha = vmaxq_u32(vshrq_n_u32(pixels, 24), max_color);
+  return vorrq_u32(vandq_u32(pixels, vdupq_n_u32(0x00ffffff)),
+                   vshlq_n_u32(alpha, 24));
+}
+
+}  // namespace
+#endif
+
+// Convolves horizontally along a single row. The row data is given in
+// |src_data| and continues for the num_values() of the filter. No pixels
+// past the ones a filter covers are read.
+void ConvolveHorizontally_neon(const unsigned char* src_data,
+                               const ConvolutionFilter1D& filter,
+                               unsigned char* out_row,
+                               bool has_alpha) {
+#if SIMD_NEON
+  int num_values = filter.num_values();
+  for (int out_x = 0; out_x < num_values; out_x++) {
+    int filter_offset, filter_length;
+    const ConvolutionFilter1D::Fixed* filter_values =
+        filter.FilterForValue(out_x, &filter_offset, &filter_length);
+    const unsigned char* row_to_filter = &src_data[filter_offset * 4];
+
+    int32x4_t accum = vdupq_n_s32(0);
+    int filter_x = 0;
+    // Four pixels and their four coefficients at a time.
+    for (; filter_x + 4 <= filter_length; filter_x += 4) {
+      int16x4_t coeffs = vld1_s16(&filter_values[filter_x]);
+      uint8x16_t pixels = vld1q_u8(row_to_filter);
+      int16x8_t low = LowPixels(pixels);
+      int16x8_t high = HighPixels(pixels);
+      accum = vmlal_lane_s16(accum, vget_low_s16(low), coeffs, 0);
+      accum = vmlal_lane_s16(accum, vget_high_s16(low), coeffs, 1);
+      accum = vmlal_lane_s16(accum, vget_low_s16(high), coeffs, 2);
+      accum = vmlal_lane_s16(accum, vget_high_s16(high), coeffs, 3);
+      row_to_filter += 16;
+    }
+    for (; filter_x < filter_length; filter_x++) {
+      accum = vmlal_n_s16(accum, LoadPixel(row_to_filter),
+                          filter_values[filter_x]);
+      row_to_filter += 4;
+    }
+
+    // The alpha channel is computed even for opaque images, the vertical
+    // pass ignores it in that case.
+    uint8x8_t result = PackPixels(accum, accum);
+    vst1_lane_u32(reinterpret_cast<uint32_t*>(&out_row[out_x * 4]),
+                  vreinterpret_u32_u8(result), 0);
+  }
+#endif
+}
+
+// Does vertical convolution to produce one output row, four pixels at a time.
+void ConvolveVertically_neon(const ConvolutionFilter1D::Fixed* filter_values,
+                             int filter_length,
+                             unsigned char* const* source_data_rows,
+                             int pixel_width,
+                             unsigned char* out_row,
+                             bool has_alpha) {
+#if SIMD_NEON
+  const uint32x4_t opaque = vdupq_n_u32(0xff000000);
+  int out_x = 0;
+  for (; out_x + 4 <= pixel_width; out_x += 4) {
+    int byte_offset = out_x * 4;
+    int32x4_t accum0 = vdupq_n_s32(0);
+    int32x4_t accum1 = vdupq_n_s32(0);
+    int32x4_t accum2 = vdupq_n_s32(0);
+    int32x4_t accum3 = vdupq_n_s32(0);
+    for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+      int16_t coeff = filter_values[filter_y];
+      uint8x16_t pixels = vld1q_u8(&source_data_rows[filter_y][byte_offset]);
+      int16x8_t low = LowPixels(pixels);
+      int16x8_t high = HighPixels(pixels);
+      accum0 = vmlal_n_s16(accum0, vget_low_s16(low), coeff);
+      accum1 = vmlal_n_s16(accum1, vget_high_s16(low), coeff);
+      accum2 = vmlal_n_s16(accum2, vget_low_s16(high), coeff);
+      accum3 = vmlal_n_s16(accum3, vget_high_s16(high), coeff);
+    }
+
+    uint32x4_t result = vreinterpretq_u32_u8(
+        vcombine_u8(PackPixels(accum0, accum1), PackPixels(accum2, accum3)));
+    result = has_alpha ? FixAlpha(result) : vorrq_u32(result, opaque);
+    vst1q_u8(&out_row[byte_offset], vreinterpretq_u8_u32(result));
+  }
+
+  // The last few pixels of the row, one at a time.
+  for (; out_x < pixel_width; out_x++) {
+    int byte_offset = out_x * 4;
+    int32x4_t accum = vdupq_n_s32(0);
+    for (int filter_y = 0; filter_y < filter_length; filter_y++) {
+      accum = vmlal_n_s16(accum,
+                          LoadPixel(&source_data_rows[filter_y][byte_offset]),
+                          filter_values[filter_y]);
+    }
+
+    uint32x4_t result =
+        vreinterpretq_u32_u8(vcombine_u8(PackPixels(accum, accum),
+                                         PackPixels(accum, accum)));
+    result = has_alpha ? FixAlpha(result) : vorrq_u32(result, opaque);
+    vst1q_lane_u32(reinterpret_cast<uint32_t*>(&out_row[byte_offset]), result,
+                   0);
+  }
+#endif
+}
+
+}  // namespace skia
@@ -329,6 +329,94 @@ TEST(Convolver, VerifySIMDPrecision) {
   }
 }
 
+// Checks that convolving in bands on several threads and convolving one
+// source row at a time give the same result as BGRAConvolve2D.
+void VerifyParallelAndStreaming(int source_width,
+                                int source_height,
+                                int dest_width,
+                                int dest_height) {
+  float filter[] = { 0.05f, -0.15f, 0.6f, 0.6f, -0.15f, 0.05f };
+  ConvolutionFilter1D x_filter, y_filter;
+  for (int p = 0; p < dest_width; ++p) {
+    int offset = source_width * p / dest_width;
+    x_filter.AddFilter(offset, filter,
+                       std::min<int>(arraysize(filter),
+                                     source_width - offset));
+  }
+  x_filter.PaddingForSIMD();
+  for (int p = 0; p < dest_height; ++p) {
+    int offset = source_height * p / dest_height;
+    y_filter.AddFilter(offset, filter,
+                       std::min<int>(arraysize(filter),
+                                     source_height - offset));
+  }
+  y_filter.PaddingForSIMD();
+
+  SkBitmap source, expected, parallel, streaming;
+  source.allocN32Pixels(source_width, source_height);
+  expected.allocN32Pixels(dest_width, dest_height);
+  parallel.allocN32Pixels(dest_width, dest_height);
+  streaming.allocN32Pixels(dest_width, dest_height);
+
+  unsigned char* src_ptr = static_cast<unsigned char*>(source.getPixels());
+  for (int y = 0; y < source.height(); y++) {
+    for (unsigned int x = 0; x < source.rowBytes(); x++)
+      src_ptr[x] = rand() % 255;
+    src_ptr += source.rowBytes();
+  }
+
+  for (int alpha = 0; alpha < 2; alpha++) {
+    const uint8* source_pixels = static_cast<const uint8*>(source.getPixels());
+    unsigned char* r1 = static_cast<unsigned char*>(expected.getPixels());
+    unsigned char* r2 = static_cast<unsigned char*>(parallel.getPixels());
+    unsigned char* r3 = static_cast<unsigned char*>(streaming.getPixels());
+
+    BGRAConvolve2D(source_pixels, static_cast<int>(source.rowBytes()),
+                   (alpha != 0), x_filter, y_filter,
+                   static_cast<int>(expected.rowBytes()), r1, true);
+    BGRAConvolve2DInParallel(source_pixels,
+                             static_cast<int>(source.rowBytes()),
+                             (alpha != 0), x_filter, y_filter,
+                             static_cast<int>(parallel.rowBytes()), r2, true,
+                             3);
+
+    BGRAStreamingConvolver convolver(source_width, (alpha != 0), x_filter,
+                                     y_filter,
+                                     static_cast<int>(streaming.rowBytes()),
+                                     r3, true);
+    int completed_rows = 0;
+    for (int y = 0; y < source_height; y++) {
+      int rows = convolver.AddSourceRow(
+          source_pixels + y * source.rowBytes());
+      EXPECT_GE(rows, completed_rows);
+      completed_rows = rows;
+    }
+    EXPECT_TRUE(convolver.IsComplete());
+    EXPECT_EQ(dest_height, completed_rows);
+
+    for (int i = 0; i < dest_height; i++) {
+      EXPECT_FALSE(memcmp(r1, r2, dest_width * 4));
+      EXPECT_FALSE(memcmp(r1, r3, dest_width * 4));
+      r1 += expected.rowBytes();
+      r2 += parallel.rowBytes();
+      r3 += streaming.rowBytes();
+    }
+  }
+}
+
+TEST(Convolver, VerifyParallelAndStreaming) {
+  int sizes[][2] = { {1, 1}, {7, 3}, {325, 241}, {1377, 523} };
+
+  srand(static_cast<unsigned int>(time(0)));
+
+  for (unsigned int i = 0; i < arraysize(sizes); ++i) {
+    for (unsigned int j = 0; j < arraysize(sizes); ++j) {
+      VerifyParallelAndStreaming(sizes[i][0], sizes[i][1],
+                                 sizes[j][0], sizes[j][1]);
+    }
+  }
+}
+
 TEST(Convolver, SeparableSingleConvolution) {
   static const int kImgWidth = 1024;
   static const int kImgHeight = 1024;
@@ -13,6 +13,7 @@
 #include "base/containers/stack_container.h"
 #include "base/logging.h"
 #include "base/metrics/histogram.h"
+#include "base/sys_info.h"
 #include "base/time/time.h"
 #include "base/trace_event/trace_event.h"
 #include "build/build_config.h"
@@ -86,6 +87,21 @@ float EvalHamming(int filter_size, float x) {
           (0.54f + 0.46f * cos(xpi / filter_size)));  // hamming(x)
 }
 
+// Splitting smaller resizes between threads costs more than it saves.
+const int kMinPixelsPerResizeThread = 256 * 256;
+const int kMaxResizeThreads = 4;
+
+int ResizeThreadCount(const SkIRect& dest_subset) {
+  int64 dest_pixels = static_cast<int64>(dest_subset.width()) *
+      dest_subset.height();
+  int64 thread_count = std::min<int64>(
+      std::min(kMaxResizeThreads, base::SysInfo::NumberOfProcessors()),
+      dest_pixels / kMinPixelsPerResizeThread);
+  return std::max(1, static_cast<int>(thread_count));
+}
+
+}  // namespace
+
 // ResizeFilter ----------------------------------------------------------------
 
 // Encapsulates computation and storage of the filters required for one complete
@@ -302,6 +318,8 @@ void ResizeFilter::ComputeFilters(int src_size,
   output->PaddingForSIMD();
 }
 
+namespace {
+
 ImageOperations::ResizeMethod ResizeMethodToAlgorithmMethod(
     ImageOperations::ResizeMethod method) {
   // Convert any "Quality Method" into an "Algorithm Method"
@@ -341,6 +359,19 @@ SkBitmap ImageOperations::Resize(const SkBitmap& source,
                                  int dest_width, int dest_height,
                                  const SkIRect& dest_subset,
                                  SkBitmap::Allocator* allocator) {
+  return ResizeWithThreadCount(source, method, dest_width, dest_height,
+                               dest_subset, ResizeThreadCount(dest_subset),
+                               allocator);
+}
+
+// static
+SkBitmap ImageOperations::ResizeWithThreadCount(
+    const SkBitmap& source,
+    ResizeMethod method,
+    int dest_width, int dest_height,
+    const SkIRect& dest_subset,
+    int thread_count,
+    SkBitmap::Allocator* allocator) {
   TRACE_EVENT2("disabled-by-default-skia", "ImageOperations::Resize",
                "src_pixels", source.width() * source.height(), "dst_pixels",
                dest_width * dest_height);
@@ -388,11 +419,13 @@ SkBitmap ImageOperations::Resize(const SkBitmap& source,
   if (!result.readyToDraw())
     return SkBitmap();
 
-  BGRAConvolve2D(source_subset, static_cast<int>(source.rowBytes()),
-                 !source.isOpaque(), filter.x_filter(), filter.y_filter(),
-                 static_cast<int>(result.rowBytes()),
-                 static_cast<unsigned char*>(result.getPixels()),
-                 true);
+  BGRAConvolve2DInParallel(source_subset,
+                           static_cast<int>(source.rowBytes()),
+                           !source.isOpaque(), filter.x_filter(),
+                           filter.y_filter(),
+                           static_cast<int>(result.rowBytes()),
+                           static_cast<unsigned char*>(result.getPixels()),
+                           true, thread_count);
 
   base::TimeDelta delta = base::TimeTicks::Now() - resize_start;
   UMA_HISTOGRAM_TIMES("Image.ResampleMS", delta);
@@ -410,4 +443,55 @@ SkBitmap ImageOperations::Resize(const SkBitmap& source,
                 allocator);
 }
 
+// StreamingImageResizer -------------------------------------------------------
+
+StreamingImageResizer::StreamingImageResizer(
+    const SkImageInfo& source_info,
+    ImageOperations::ResizeMethod method,
+    int dest_width, int dest_height,
+    const SkIRect& dest_subset,
+    SkBitmap::Allocator* allocator) {
+  SkIRect dest = { 0, 0, dest_width, dest_height };
+  DCHECK(dest.contains(dest_subset)) <<
+      "The supplied subset does not fall within the destination image.";
+
+  if (source_info.width() < 1 || source_info.height() < 1 ||
+      dest_width < 1 || dest_height < 1 ||
+      source_info.colorType() != kN32_SkColorType)
+    return;
+
+  method = ResizeMethodToAlgorithmMethod(method);
+  filter_.reset(new ResizeFilter(method, source_info.width(),
+                                 source_info.height(), dest_width,
+                                 dest_height, dest_subset));
+
+  result_.setInfo(SkImageInfo::MakeN32(dest_subset.width(),
+                                       dest_subset.height(),
+                                       source_info.alphaType()));
+  result_.allocPixels(allocator, NULL);
+  if (!result_.readyToDraw()) {
+    result_.reset();
+    return;
+  }
+
+  convolver_.reset(new BGRAStreamingConvolver(
+      source_info.width(), source_info.alphaType() != kOpaque_SkAlphaType,
+      filter_->x_filter(), filter_->y_filter(),
+      static_cast<int>(result_.rowBytes()),
+      static_cast<unsigned char*>(result_.getPixels()), true));
+}
+
+StreamingImageResizer::~StreamingImageResizer() {
+}
+
+int StreamingImageResizer::AddSourceRow(const void* source_row) {
+  DCHECK(is_valid());
+  return convolver_->AddSourceRow(
+      static_cast<const unsigned char*>(source_row));
+}
+
+bool StreamingImageResizer::IsComplete() const {
+  return is_valid() && convolver_->IsComplete();
+}
+
 }  // namespace skia
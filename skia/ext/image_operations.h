@@ -5,13 +5,17 @@
 #ifndef SKIA_EXT_IMAGE_OPERATIONS_H_
 #define SKIA_EXT_IMAGE_OPERATIONS_H_
 
+#include "base/basictypes.h"
+#include "base/memory/scoped_ptr.h"
 #include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkRect.h"
 #include "third_party/skia/include/core/SkTypes.h"
 
-struct SkIRect;
-
 namespace skia {
 
+class BGRAStreamingConvolver;
+class ResizeFilter;
+
 class SK_API ImageOperations {
  public:
   enum ResizeMethod {
@@ -107,10 +111,59 @@ class SK_API ImageOperations {
                          int dest_width, int dest_height,
                          SkBitmap::Allocator* allocator = NULL);
 
+  // Same as the first version of Resize(), but splits the work between up to
+  // |thread_count| threads of the shared worker pool. Resize() picks the
+  // number of threads from the size of the destination subset, this is
+  // mostly useful for measuring how the resize scales.
+  static SkBitmap ResizeWithThreadCount(const SkBitmap& source,
+                                        ResizeMethod method,
+                                        int dest_width, int dest_height,
+                                        const SkIRect& dest_subset,
+                                        int thread_count,
+                                        SkBitmap::Allocator* allocator = NULL);
+
  private:
   ImageOperations();  // Class for scoping only.
 };
 
+// Resizes an image whose rows become available one at a time, for example
+// while it is being decoded, into the same pixels ImageOperations::Resize()
+// would produce. Only the rows the resize filters are currently working on
+// are kept, so the whole source image never has to be in memory.
+//
+// The source rows are in kN32_SkColorType, like the bitmaps Resize() takes.
+class SK_API StreamingImageResizer {
+ public:
+  StreamingImageResizer(const SkImageInfo& source_info,
+                        ImageOperations::ResizeMethod method,
+                        int dest_width, int dest_height,
+                        const SkIRect& dest_subset,
+                        SkBitmap::Allocator* allocator = NULL);
+  ~StreamingImageResizer();
+
+  // False if the sizes or the color type can not be resized, or if the
+  // result could not be allocated. AddSourceRow() must not be called then.
+  bool is_valid() const { return convolver_.get() != NULL; }
+
+  // Takes the next row of the source image, starting with row 0. Returns the
+  // number of rows at the top of result() that are complete.
+  int AddSourceRow(const void* source_row);
+
+  bool IsComplete() const;
+
+  // Has the size of the destination subset.
+  const SkBitmap& result() const { return result_; }
+
+ private:
+  scoped_ptr<ResizeFilter> filter_;
+  SkBitmap result_;
+  // Refers to the filters and the pixels of |result_|, so it is declared
+  // last to be destroyed first.
+  scoped_ptr<BGRAStreamingConvolver> convolver_;
+
+  DISALLOW_COPY_AND_ASSIGN(StreamingImageResizer);
+};
+
 }  // namespace skia
 
 #endif  // SKIA_EXT_IMAGE_OPERATIONS_H_
@@ -24,6 +24,7 @@
 #include "base/strings/string_util.h"
 #include "base/strings/utf_string_conversions.h"
 #include "base/time/time.h"
+#include "skia/ext/convolver.h"
 #include "skia/ext/image_operations.h"
 #include "third_party/skia/include/core/SkBitmap.h"
 #include "third_party/skia/include/core/SkRect.h"
@@ -88,6 +89,19 @@ void PrintMethods() {
 // getSize seemed to be a more accurate representation of the work done (even
 // though in terms of memory bandwidth that might be similar because of the
 // cache line size).
+// The convolver that resizes use on this build.
+const char* SimdName() {
+#if defined(SIMD_SSE2)
+  return "SSE2";
+#elif defined(SIMD_MIPS_DSPR2)
+  return "MIPS_DSPR2";
+#elif defined(SIMD_NEON)
+  return "NEON";
+#else
+  return "none";
+#endif
+}
+
 int GetBitmapSize(const SkBitmap* bitmap) {
   return bitmap->height() * bitmap->bytesPerPixel() * bitmap->width();
 }
@@ -140,7 +154,9 @@ class Benchmark {
 
   Benchmark()
       : num_iterations_(kDefaultNumberIterations),
-        method_(kDefaultResizeMethod) {}
+        method_(kDefaultResizeMethod),
+        num_threads_(0),
+        streaming_(false) {}
 
   // Returns true if command line parsing was successful, false otherwise.
   bool ParseArgs(const base::CommandLine* command_line);
@@ -150,8 +166,13 @@ class Benchmark {
 
   static void Usage();
  private:
+  SkBitmap Resize(const SkBitmap& source) const;
+
   int num_iterations_;
   skia::ImageOperations::ResizeMethod method_;
+  // 0 lets ImageOperations pick the number of threads.
+  int num_threads_;
+  bool streaming_;
   Dimensions source_;
   Dimensions dest_;
 };
@@ -164,7 +185,7 @@ const skia::ImageOperations::ResizeMethod Benchmark::kDefaultResizeMethod =
 // argument management
 void Benchmark::Usage() {
   printf("image_operations_bench -source wxh -destination wxh "
-         "[-iterations i] [-method m] [-help]\n"
+         "[-iterations i] [-method m] [-threads t] [-streaming] [-help]\n"
          "  -source wxh: specify source width and height\n"
          "  -destination wxh: specify destination width and height\n"
          "  -iter i: perform i iterations (default:%d)\n"
@@ -172,7 +193,12 @@ void Benchmark::Usage() {
          Benchmark::kDefaultNumberIterations,
          MethodToString(Benchmark::kDefaultResizeMethod));
   PrintMethods();
-  printf("\n  -help: prints this help and exits\n");
+  printf("\n  -threads t: resize with up to t threads (default: picked from"
+         " the destination size)\n"
+         "  -streaming: feed the source to a StreamingImageResizer row by"
+         " row\n"
+         "  -help: prints this help and exits\n"
+         "The resize uses the %s convolver.\n", SimdName());
 }
 
 bool Benchmark::ParseArgs(const base::CommandLine* command_line) {
@@ -197,6 +223,14 @@ bool Benchmark::ParseArgs(const base::CommandLine* command_line) {
       if (base::StringToInt(value, &num_iterations_) == false) {
         fNeedHelp = true;
       }
+    } else if (s == "threads") {
+      if (base::StringToInt(value, &num_threads_) == false ||
+          num_threads_ <= 0) {
+        printf("Invalid number of threads: %s\n", value.c_str());
+        fNeedHelp = true;
+      }
+    } else if (s == "streaming") {
+      streaming_ = true;
     } else if (s == "method") {
       if (!StringToMethod(value, &method_)) {
         printf("Invalid method '%s' specified\n", value.c_str());
@@ -219,12 +253,37 @@ bool Benchmark::ParseArgs(const base::CommandLine* command_line) {
     printf("Invalid dest dimensions specified\n");
     fNeedHelp = true;
   }
+  if (streaming_ && num_threads_) {
+    printf("Streaming resizes always run on one thread\n");
+    fNeedHelp = true;
+  }
   if (fNeedHelp == true) {
     return false;
   }
   return true;
 }
 
+SkBitmap Benchmark::Resize(const SkBitmap& source) const {
+  SkIRect dest_subset = { 0, 0, dest_.width(), dest_.height() };
+  if (streaming_) {
+    skia::StreamingImageResizer resizer(source.info(), method_,
+                                        dest_.width(), dest_.height(),
+                                        dest_subset);
+    if (!resizer.is_valid())
+      return SkBitmap();
+    for (int y = 0; y < source.height() && !resizer.IsComplete(); ++y)
+      resizer.AddSourceRow(source.getAddr32(0, y));
+    return resizer.result();
+  }
+  if (num_threads_) {
+    return skia::ImageOperations::ResizeWithThreadCount(
+        source, method_, dest_.width(), dest_.height(), dest_subset,
+        num_threads_);
+  }
+  return skia::ImageOperations::Resize(source, method_, dest_.width(),
+                                       dest_.height());
+}
+
 // actual benchmark.
 bool Benchmark::Run() const {
   SkBitmap source;
@@ -236,9 +295,7 @@ bool Benchmark::Run() const {
   const base::TimeTicks start = base::TimeTicks::Now();
 
   for (int i = 0; i < num_iterations_; ++i) {
-    dest = skia::ImageOperations::Resize(source,
-                                         method_,
-                                         dest_.width(), dest_.height());
+    dest = Resize(source);
   }
 
   const int64 elapsed_us = (base::TimeTicks::Now() - start).InMicroseconds();
@@ -246,10 +303,12 @@ bool Benchmark::Run() const {
   const uint64 num_bytes = static_cast<uint64>(num_iterations_) *
       (GetBitmapSize(&source) + GetBitmapSize(&dest));
 
-  printf("%" PRIu64 " MB/s,\telapsed = %" PRIu64 " source=%d dest=%d\n",
+  printf("%" PRIu64 " MB/s,\telapsed = %" PRIu64 " source=%d dest=%d"
+         " simd=%s threads=%d%s\n",
          static_cast<uint64>(elapsed_us == 0 ? 0 : num_bytes / elapsed_us),
          static_cast<uint64>(elapsed_us),
-         GetBitmapSize(&source), GetBitmapSize(&dest));
+         GetBitmapSize(&source), GetBitmapSize(&dest), SimdName(),
+         num_threads_, streaming_ ? " streaming" : "");
 
   return true;
 }
@@ -116,6 +116,12 @@
             'ext/convolver_mips_dspr2.h',
           ],
         }],
+        [ 'target_arch == "arm" and arm_neon == 1',{
+          'sources': [
+            'ext/convolver_neon.cc',
+            'ext/convolver_neon.h',
+          ],
+        }],
       ],
     },
     {
@@ -0,0 +1,58 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_BACKGROUND_RASTERIZER_H_
+#define SKY_COMPOSITOR_BACKGROUND_RASTERIZER_H_
+
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefPtr.h"
+
+#include <memory>
+
+class GrContext;
+
+namespace sky {
+namespace compositor {
+
+// Rasterizes pictures for the raster cache away from the thread that paints
+// frames. Implementations are provided by the embedder since they need a GPU
+// context that shares resources with the one used for painting.
+class BackgroundRasterizer {
+ public:
+  // A single pending rasterization. Jobs are only ever used on the painting
+  // thread, but may complete at any time on another thread.
+  class Job {
+   public:
+    virtual ~Job() {}
+
+    // Returns true once the rasterized contents are available to the
+    // painting thread.
+    virtual bool IsReady() const = 0;
+
+    // Returns the rasterized contents as an image usable with |gr_context|.
+    // May only be called once, after IsReady() has returned true. Returns
+    // nullptr if rasterization failed.
+    virtual RefPtr<SkImage> TakeImage(GrContext* gr_context) = 0;
+  };
+
+  virtual ~BackgroundRasterizer() {}
+
+  // Schedules |picture| to be rasterized with |matrix| into an image
+  // covering |device_bounds|. The image is cleared to transparent before the
+  // picture is drawn, and is overlaid with a checkerboard if |checkerboard|
+  // is set. Returns nullptr if the job could not be scheduled.
+  virtual std::shared_ptr<Job> Rasterize(PassRefPtr<SkPicture> picture,
+                                         const SkMatrix& matrix,
+                                         const SkIRect& device_bounds,
+                                         bool checkerboard) = 0;
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_BACKGROUND_RASTERIZER_H_
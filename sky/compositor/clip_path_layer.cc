@@ -4,21 +4,67 @@
 
 #include "sky/compositor/clip_path_layer.h"
 
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
 namespace sky {
 namespace compositor {
 
-ClipPathLayer::ClipPathLayer() {
+ClipPathLayer::ClipPathLayer() : anti_alias_(true) {
 }
 
 ClipPathLayer::~ClipPathLayer() {
 }
 
+void ClipPathLayer::Preroll(PrerollContext* context,
+                            const SkMatrix& matrix) {
+  SkRect clip_bounds;
+  matrix.mapRect(&clip_bounds, clip_path_.getBounds());
+  const SkRect parent_cull_rect = context->cull_rect;
+  if (!context->cull_rect.intersect(clip_bounds))
+    context->cull_rect.setEmpty();
+  // The cull rect only bounds the clip, so the children's opaque pixels
+  // may not all show.
+  const bool occlusion_enabled = context->occlusion_enabled;
+  context->occlusion_enabled = false;
+  PrerollChildren(context, matrix);
+  context->occlusion_enabled = occlusion_enabled;
+  context->cull_rect = parent_cull_rect;
+}
+
 void ClipPathLayer::Paint(PaintContext::ScopedFrame& frame) {
   SkCanvas& canvas = frame.canvas();
-  canvas.saveLayer(&clip_path_.getBounds(), nullptr);
-  canvas.clipPath(clip_path_);
+  const int save_count = canvas.save();
+  SkRect rect;
+  if (clip_path_.isRect(&rect) && ClipToPixelAlignedRect(canvas, rect)) {
+    // Edges on whole pixels have nothing to anti-alias.
+  } else if (anti_alias_) {
+    canvas.saveLayer(&clip_path_.getBounds(), nullptr);
+    canvas.clipPath(clip_path_, SkRegion::kIntersect_Op, true);
+  } else {
+    canvas.clipPath(clip_path_, SkRegion::kIntersect_Op, false);
+  }
   PaintChildren(frame);
-  canvas.restore();
+  canvas.restoreToCount(save_count);
+}
+
+void ClipPathLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::ClipPath);
+  signature->Add(clip_path_.getGenerationID());
+  signature->Add(static_cast<uint32_t>(anti_alias_));
+}
+
+void ClipPathLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::ClipPath, *this);
+  writer->Write(clip_path_);
+  writer->Write(static_cast<uint32_t>(anti_alias_));
+  SerializeChildren(writer);
+}
+
+void ClipPathLayer::Deserialize(LayerReader* reader) {
+  clip_path_ = reader->ReadPath();
+  anti_alias_ = reader->ReadUInt32() != 0;
+  DeserializeChildren(reader);
 }
 
 }  // namespace compositor
@@ -17,11 +17,25 @@ class ClipPathLayer : public ContainerLayer {
 
   void set_clip_path(const SkPath& clip_path) { clip_path_ = clip_path; }
 
+  // Whether the edges of the clip are anti-aliased, which they are by
+  // default. Without anti-aliasing the children are clipped in place rather
+  // than in a layer of their own.
+  void set_anti_alias(bool anti_alias) { anti_alias_ = anti_alias; }
+
  protected:
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext::ScopedFrame& frame) override;
 
+  void AppendStateSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
  private:
   SkPath clip_path_;
+  bool anti_alias_;
 
   DISALLOW_COPY_AND_ASSIGN(ClipPathLayer);
 };
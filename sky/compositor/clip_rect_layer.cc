@@ -4,6 +4,9 @@
 
 #include "sky/compositor/clip_rect_layer.h"
 
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
 namespace sky {
 namespace compositor {
 
@@ -13,13 +16,41 @@ ClipRectLayer::ClipRectLayer() {
 ClipRectLayer::~ClipRectLayer() {
 }
 
+void ClipRectLayer::Preroll(PrerollContext* context,
+                            const SkMatrix& matrix) {
+  SkRect clip_bounds;
+  matrix.mapRect(&clip_bounds, clip_rect_);
+  const SkRect parent_cull_rect = context->cull_rect;
+  if (!context->cull_rect.intersect(clip_bounds))
+    context->cull_rect.setEmpty();
+  PrerollChildren(context, matrix);
+  context->cull_rect = parent_cull_rect;
+}
+
 void ClipRectLayer::Paint(PaintContext::ScopedFrame& frame) {
   SkCanvas& canvas = frame.canvas();
   canvas.save();
-  canvas.clipRect(clip_rect_);
+  if (!ClipToPixelAlignedRect(canvas, clip_rect_))
+    canvas.clipRect(clip_rect_);
   PaintChildren(frame);
   canvas.restore();
 }
 
+void ClipRectLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::ClipRect);
+  signature->Add(clip_rect_);
+}
+
+void ClipRectLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::ClipRect, *this);
+  writer->Write(clip_rect_);
+  SerializeChildren(writer);
+}
+
+void ClipRectLayer::Deserialize(LayerReader* reader) {
+  clip_rect_ = reader->ReadRect();
+  DeserializeChildren(reader);
+}
+
 }  // namespace compositor
 }  // namespace sky
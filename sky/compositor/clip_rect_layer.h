@@ -18,8 +18,16 @@ class ClipRectLayer : public ContainerLayer {
   void set_clip_rect(const SkRect& clip_rect) { clip_rect_ = clip_rect; }
 
  protected:
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext::ScopedFrame& frame) override;
 
+  void AppendStateSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
  private:
   SkRect clip_rect_;
 
@@ -4,21 +4,67 @@
 
 #include "sky/compositor/clip_rrect_layer.h"
 
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
 namespace sky {
 namespace compositor {
 
-ClipRRectLayer::ClipRRectLayer() {
+ClipRRectLayer::ClipRRectLayer() : anti_alias_(true) {
 }
 
 ClipRRectLayer::~ClipRRectLayer() {
 }
 
+void ClipRRectLayer::Preroll(PrerollContext* context,
+                             const SkMatrix& matrix) {
+  SkRect clip_bounds;
+  matrix.mapRect(&clip_bounds, clip_rrect_.getBounds());
+  const SkRect parent_cull_rect = context->cull_rect;
+  if (!context->cull_rect.intersect(clip_bounds))
+    context->cull_rect.setEmpty();
+  // The cull rect only bounds the clip, so the children's opaque pixels
+  // may not all show.
+  const bool occlusion_enabled = context->occlusion_enabled;
+  context->occlusion_enabled = false;
+  PrerollChildren(context, matrix);
+  context->occlusion_enabled = occlusion_enabled;
+  context->cull_rect = parent_cull_rect;
+}
+
 void ClipRRectLayer::Paint(PaintContext::ScopedFrame& frame) {
   SkCanvas& canvas = frame.canvas();
-  canvas.saveLayer(&clip_rrect_.getBounds(), nullptr);
-  canvas.clipRRect(clip_rrect_);
+  const int save_count = canvas.save();
+  if (clip_rrect_.isRect() &&
+      ClipToPixelAlignedRect(canvas, clip_rrect_.rect())) {
+    // Edges on whole pixels have nothing to anti-alias.
+  } else if (anti_alias_) {
+    canvas.saveLayer(&clip_rrect_.getBounds(), nullptr);
+    canvas.clipRRect(clip_rrect_, SkRegion::kIntersect_Op, true);
+  } else {
+    canvas.clipRRect(clip_rrect_, SkRegion::kIntersect_Op, false);
+  }
   PaintChildren(frame);
-  canvas.restore();
+  canvas.restoreToCount(save_count);
+}
+
+void ClipRRectLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::ClipRRect);
+  signature->Add(clip_rrect_);
+  signature->Add(static_cast<uint32_t>(anti_alias_));
+}
+
+void ClipRRectLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::ClipRRect, *this);
+  writer->Write(clip_rrect_);
+  writer->Write(static_cast<uint32_t>(anti_alias_));
+  SerializeChildren(writer);
+}
+
+void ClipRRectLayer::Deserialize(LayerReader* reader) {
+  clip_rrect_ = reader->ReadRRect();
+  anti_alias_ = reader->ReadUInt32() != 0;
+  DeserializeChildren(reader);
 }
 
 }  // namespace compositor
@@ -17,10 +17,24 @@ class ClipRRectLayer : public ContainerLayer {
 
   void set_clip_rrect(const SkRRect& clip_rrect) { clip_rrect_ = clip_rrect; }
 
+  // Whether the edges of the clip are anti-aliased, which they are by
+  // default. Without anti-aliasing the children are clipped in place rather
+  // than in a layer of their own.
+  void set_anti_alias(bool anti_alias) { anti_alias_ = anti_alias; }
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext::ScopedFrame& frame) override;
 
+  void AppendStateSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
  private:
   SkRRect clip_rrect_;
+  bool anti_alias_;
 
   DISALLOW_COPY_AND_ASSIGN(ClipRRectLayer);
 };
@@ -4,6 +4,9 @@
 
 #include "sky/compositor/color_filter_layer.h"
 
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
 namespace sky {
 namespace compositor {
 
@@ -13,16 +16,48 @@ ColorFilterLayer::ColorFilterLayer() {
 ColorFilterLayer::~ColorFilterLayer() {
 }
 
+void ColorFilterLayer::Preroll(PrerollContext* context,
+                               const SkMatrix& matrix) {
+  PrerollChildrenWithRasterCache(context, matrix);
+}
+
 void ColorFilterLayer::Paint(PaintContext::ScopedFrame& frame) {
   RefPtr<SkColorFilter> color_filter =
       adoptRef(SkColorFilter::CreateModeFilter(color_, transfer_mode_));
   SkPaint paint;
   paint.setColorFilter(color_filter.get());
+
+  if (PaintCachedChildren(frame, paint))
+    return;
+
   SkCanvas& canvas = frame.canvas();
   canvas.saveLayer(&paint_bounds(), &paint);
   PaintChildren(frame);
   canvas.restore();
 }
 
+void ColorFilterLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::ColorFilter);
+  signature->Add(static_cast<uint32_t>(color_));
+  signature->Add(static_cast<uint32_t>(transfer_mode_));
+  signature->Add(paint_bounds());
+}
+
+void ColorFilterLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::ColorFilter, *this);
+  writer->Write(static_cast<uint32_t>(color_));
+  writer->Write(static_cast<uint32_t>(transfer_mode_));
+  SerializeChildren(writer);
+}
+
+void ColorFilterLayer::Deserialize(LayerReader* reader) {
+  color_ = reader->ReadUInt32();
+  const uint32_t transfer_mode = reader->ReadUInt32();
+  transfer_mode_ = transfer_mode <= SkXfermode::kLastMode
+                       ? static_cast<SkXfermode::Mode>(transfer_mode)
+                       : SkXfermode::kSrcOver_Mode;
+  DeserializeChildren(reader);
+}
+
 }  // namespace compositor
 }  // namespace sky
@@ -21,8 +21,16 @@ class ColorFilterLayer : public ContainerLayer {
     transfer_mode_ = transfer_mode;
   }
 
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext::ScopedFrame& frame) override;
 
+  void AppendStateSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
  private:
   SkColor color_;
   SkXfermode::Mode transfer_mode_;
@@ -4,10 +4,32 @@
 
 #include "sky/compositor/compositor_options.h"
 
+#include "build/build_config.h"
+
 namespace sky {
 namespace compositor {
 
-CompositorOptions::CompositorOptions() {
+// Enough for a couple of screenfuls of cached content on a 1080p display.
+static const size_t kDefaultRasterCacheByteBudget = 32 * 1024 * 1024;
+static const int kDefaultRasterCacheMinDrawOpCount = 5;
+static const int kDefaultRasterCacheStableFrameCount = 3;
+static const int kDefaultRasterCacheTileSize = 512;
+
+// Tiling GPUs resolve samples in tile memory, which makes 4x MSAA about as
+// cheap as no MSAA. Nearly all Android devices have one.
+#if defined(OS_ANDROID)
+static const int kDefaultMSAASampleCount = 4;
+#else
+static const int kDefaultMSAASampleCount = 0;
+#endif
+
+CompositorOptions::CompositorOptions()
+    : raster_cache_byte_budget_(kDefaultRasterCacheByteBudget),
+      raster_cache_min_draw_op_count_(kDefaultRasterCacheMinDrawOpCount),
+      raster_cache_stable_frame_count_(kDefaultRasterCacheStableFrameCount),
+      raster_cache_tile_size_(kDefaultRasterCacheTileSize),
+      msaa_sample_count_(kDefaultMSAASampleCount),
+      nv_path_rendering_enabled_(true) {
   static_assert(std::is_unsigned<OptionType>::value,
                 "OptionType must be unsigned");
   options_.resize(static_cast<OptionType>(Option::TerminationSentinel), false);
@@ -27,6 +49,28 @@ void CompositorOptions::setEnabled(Option option, bool enabled) {
   }
 }
 
+void CompositorOptions::setDebugFlags(uint32_t flags) {
+  setEnabled(Option::HightlightRasterizedImages,
+             (flags & kHighlightRasterizedImagesFlag) != 0);
+  setEnabled(Option::DisplayFrameStatistics,
+             (flags & kDisplayFrameStatisticsFlag) != 0);
+  setEnabled(Option::DisplayRasterizerStatistics,
+             (flags & kDisplayRasterizerStatisticsFlag) != 0);
+  setEnabled(Option::VisualizeOverdraw, (flags & kVisualizeOverdrawFlag) != 0);
+  setEnabled(Option::VisualizeLayerBounds,
+             (flags & kVisualizeLayerBoundsFlag) != 0);
+  setEnabled(Option::VisualizeRasterTime,
+             (flags & kVisualizeRasterTimeFlag) != 0);
+}
+
+bool CompositorOptions::hasFrameOverlays() const {
+  return isEnabled(Option::DisplayFrameStatistics) ||
+         isEnabled(Option::DisplayRasterizerStatistics) ||
+         isEnabled(Option::VisualizeOverdraw) ||
+         isEnabled(Option::VisualizeLayerBounds) ||
+         isEnabled(Option::VisualizeRasterTime);
+}
+
 CompositorOptions::~CompositorOptions() {
 }
 
@@ -6,6 +6,8 @@
 #define SKY_COMPOSITOR_COMPOSITOR_OPTIONS_H_
 
 #include "base/macros.h"
+#include <stddef.h>
+#include <stdint.h>
 #include <vector>
 
 namespace sky {
@@ -21,10 +23,33 @@ class CompositorOptions {
     HightlightRasterizedImages,
     DisplayFrameStatistics,
     DisplayRasterizerStatistics,
+    // Presents frames from a separate task on the GPU thread, so the UI thread
+    // does not wait for a swap that blocks before it starts the next frame.
+    PipelinedSwap,
+    // Tints every pixel by how many times it was drawn in the frame. Pixels
+    // drawn twice are tinted blue, three times green, four times pink and
+    // more often red. Save layers count as a single draw of their bounds.
+    VisualizeOverdraw,
+    // Outlines the bounds of every picture and shadow layer.
+    VisualizeLayerBounds,
+    // Tints every picture layer from green to red by how long it took to
+    // paint.
+    VisualizeRasterTime,
 
     TerminationSentinel,
   };
 
+  // The debugging options that can be turned on while the app runs, with
+  // SceneBuilder.setDebugOptions or --compositor-debug.
+  enum DebugFlag : uint32_t {
+    kHighlightRasterizedImagesFlag = 1 << 0,
+    kDisplayFrameStatisticsFlag = 1 << 1,
+    kDisplayRasterizerStatisticsFlag = 1 << 2,
+    kVisualizeOverdrawFlag = 1 << 3,
+    kVisualizeLayerBoundsFlag = 1 << 4,
+    kVisualizeRasterTimeFlag = 1 << 5,
+  };
+
   CompositorOptions();
   ~CompositorOptions();
 
@@ -32,8 +57,76 @@ class CompositorOptions {
 
   void setEnabled(Option option, bool enabled);
 
+  // Enables the debugging options whose DebugFlag is set in |flags| and
+  // disables the other ones.
+  void setDebugFlags(uint32_t flags);
+
+  // Whether anything is drawn over the layers, which has to be repainted
+  // along with the whole frame every time.
+  bool hasFrameOverlays() const;
+
+  // The number of bytes of GPU memory the picture rasterizer may hold on to
+  // across frames. Least recently used entries are evicted once the budget is
+  // exceeded.
+  size_t rasterCacheByteBudget() const { return raster_cache_byte_budget_; }
+
+  void setRasterCacheByteBudget(size_t budget) {
+    raster_cache_byte_budget_ = budget;
+  }
+
+  // Pictures with fewer draw ops than this are cheap enough to draw directly
+  // and are never rasterized into the cache. Zero admits every picture.
+  int rasterCacheMinDrawOpCount() const {
+    return raster_cache_min_draw_op_count_;
+  }
+
+  void setRasterCacheMinDrawOpCount(int count) {
+    raster_cache_min_draw_op_count_ = count;
+  }
+
+  // The number of consecutive frames a picture has to be painted in before it
+  // is rasterized into the cache.
+  int rasterCacheStableFrameCount() const {
+    return raster_cache_stable_frame_count_;
+  }
+
+  void setRasterCacheStableFrameCount(int count) {
+    raster_cache_stable_frame_count_ = count;
+  }
+
+  // Pictures more than two tiles wide or high are rasterized in tiles of
+  // this many device pixels on a side. Only the visible tiles and their
+  // immediate neighbours are rasterized. Zero disables tiling.
+  int rasterCacheTileSize() const { return raster_cache_tile_size_; }
+
+  void setRasterCacheTileSize(int size) { raster_cache_tile_size_ = size; }
+
+  // The number of samples per pixel of the window and of the surface frames
+  // are drawn into at a reduced resolution. With samples, Ganesh stencils and
+  // covers paths and the samples smooth their edges. Without, it computes the
+  // coverage of anti-aliased paths analytically, from distance fields or in
+  // software masks. Read when the window surface is created.
+  int msaaSampleCount() const { return msaa_sample_count_; }
+
+  void setMSAASampleCount(int count) { msaa_sample_count_ = count; }
+
+  // Whether paths in multisampled surfaces are stenciled with
+  // NV_path_rendering where the driver has it, instead of with triangle fans
+  // Ganesh tessellates. Read when the GL context is created.
+  bool nvPathRenderingEnabled() const { return nv_path_rendering_enabled_; }
+
+  void setNVPathRenderingEnabled(bool enabled) {
+    nv_path_rendering_enabled_ = enabled;
+  }
+
  private:
   std::vector<bool> options_;
+  size_t raster_cache_byte_budget_;
+  int raster_cache_min_draw_op_count_;
+  int raster_cache_stable_frame_count_;
+  int raster_cache_tile_size_;
+  int msaa_sample_count_;
+  bool nv_path_rendering_enabled_;
 
   DISALLOW_COPY_AND_ASSIGN(CompositorOptions);
 };
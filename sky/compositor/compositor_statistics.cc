@@ -0,0 +1,39 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/compositor_statistics.h"
+
+namespace sky {
+namespace compositor {
+
+CompositorStatistics::CompositorStatistics()
+    : frame_count(0),
+      missed_raster_frames(0),
+      raster_cache_hits(0),
+      raster_cache_fills(0),
+      raster_cache_evictions(0),
+      raster_cache_bytes(0),
+      texture_pool_bytes(0),
+      gpu_resource_bytes(0),
+      layer_count(0) {
+}
+
+CompositorStatisticsStore::CompositorStatisticsStore() {
+}
+
+CompositorStatisticsStore::~CompositorStatisticsStore() {
+}
+
+void CompositorStatisticsStore::Update(const CompositorStatistics& statistics) {
+  base::AutoLock lock(lock_);
+  statistics_ = statistics;
+}
+
+CompositorStatistics CompositorStatisticsStore::Get() const {
+  base::AutoLock lock(lock_);
+  return statistics_;
+}
+
+}  // namespace compositor
+}  // namespace sky
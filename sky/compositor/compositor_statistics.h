@@ -0,0 +1,63 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_COMPOSITOR_STATISTICS_H_
+#define SKY_COMPOSITOR_COMPOSITOR_STATISTICS_H_
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace sky {
+namespace compositor {
+
+// A summary of the compositor's instrumentation as of the last frame it
+// painted. Counts of the raster cache are totals since the compositor was
+// created.
+struct CompositorStatistics {
+  CompositorStatistics();
+
+  size_t frame_count;
+  base::TimeDelta last_raster_time;
+  base::TimeDelta raster_time_p90;
+  size_t missed_raster_frames;
+  base::TimeDelta build_time_p90;
+  base::TimeDelta presentation_latency_p90;
+
+  size_t raster_cache_hits;
+  size_t raster_cache_fills;
+  size_t raster_cache_evictions;
+  size_t raster_cache_bytes;
+  size_t texture_pool_bytes;
+  size_t gpu_resource_bytes;
+
+  // The layers visited by the last frame. Layers whose parent was drawn from
+  // the raster cache are not visited.
+  size_t layer_count;
+};
+
+// Hands the statistics of the thread that paints frames to other threads.
+class CompositorStatisticsStore
+    : public base::RefCountedThreadSafe<CompositorStatisticsStore> {
+ public:
+  CompositorStatisticsStore();
+
+  void Update(const CompositorStatistics& statistics);
+  CompositorStatistics Get() const;
+
+ private:
+  friend class base::RefCountedThreadSafe<CompositorStatisticsStore>;
+  ~CompositorStatisticsStore();
+
+  mutable base::Lock lock_;
+  CompositorStatistics statistics_;
+
+  DISALLOW_COPY_AND_ASSIGN(CompositorStatisticsStore);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_COMPOSITOR_STATISTICS_H_
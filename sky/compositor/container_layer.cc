@@ -4,18 +4,57 @@
 
 #include "sky/compositor/container_layer.h"
 
+#include "sky/compositor/damage_tracker.h"
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
 namespace sky {
 namespace compositor {
 
-ContainerLayer::ContainerLayer() {
+ContainerLayer::ContainerLayer()
+    : children_signature_valid_(false),
+      children_signature_(0),
+      children_occluded_(false) {
 }
 
 ContainerLayer::~ContainerLayer() {
 }
 
-void ContainerLayer::Add(std::unique_ptr<Layer> layer) {
+void ContainerLayer::Add(std::shared_ptr<Layer> layer) {
   layer->set_parent(this);
+  if (layer->has_animations())
+    SetHasAnimations();
   layers_.push_back(std::move(layer));
+  children_signature_valid_ = false;
+}
+
+void ContainerLayer::UseArena(const std::shared_ptr<LayerArena>& arena) {
+  DCHECK(layers_.empty());
+  layers_ = LayerList(LayerArenaAllocator<std::shared_ptr<Layer>>(arena));
+}
+
+void ContainerLayer::Preroll(PrerollContext* context,
+                             const SkMatrix& matrix) {
+  PrerollChildren(context, matrix);
+}
+
+void ContainerLayer::PrerollChildren(PrerollContext* context,
+                                     const SkMatrix& matrix) {
+  const uint64_t parent_state = context->ancestor_state;
+
+  LayerSignature state;
+  state.Add(parent_state);
+  state.Add(matrix);
+  AppendStateSignature(&state);
+  context->ancestor_state = state.value();
+  context->layer_count += layers_.size();
+
+  // Children are prerolled from the top down, so that each one knows which
+  // part of it the ones painted after it hide.
+  for (auto it = layers_.rbegin(); it != layers_.rend(); ++it)
+    (*it)->Preroll(context, matrix);
+
+  context->ancestor_state = parent_state;
 }
 
 void ContainerLayer::PaintChildren(PaintContext::ScopedFrame& frame) const {
@@ -23,5 +62,164 @@ void ContainerLayer::PaintChildren(PaintContext::ScopedFrame& frame) const {
     layer->Paint(frame);
 }
 
+void ContainerLayer::AppendSignature(LayerSignature* signature) const {
+  AppendStateSignature(signature);
+  AppendChildrenSignature(signature);
+}
+
+void ContainerLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::Container);
+}
+
+void ContainerLayer::AppendChildrenSignature(LayerSignature* signature) const {
+  // The signature of animated children changes from frame to frame.
+  if (!children_signature_valid_ || has_animations()) {
+    LayerSignature children_signature;
+    children_signature.Add(static_cast<uint32_t>(layers_.size()));
+    for (auto& layer : layers_)
+      layer->AppendSignature(&children_signature);
+    children_signature_ = children_signature.value();
+    children_signature_valid_ = true;
+  }
+  signature->Add(children_signature_);
+}
+
+void ContainerLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::Container, *this);
+  SerializeChildren(writer);
+}
+
+void ContainerLayer::Deserialize(LayerReader* reader) {
+  DeserializeChildren(reader);
+}
+
+void ContainerLayer::SerializeChildren(LayerWriter* writer) const {
+  writer->Write(static_cast<uint32_t>(layers_.size()));
+  for (auto& layer : layers_)
+    writer->WriteLayer(*layer);
+}
+
+void ContainerLayer::DeserializeChildren(LayerReader* reader) {
+  UseArena(reader->arena());
+  const uint32_t count = reader->ReadUInt32();
+  for (uint32_t i = 0; i < count && !reader->failed(); ++i) {
+    std::shared_ptr<Layer> layer = reader->ReadLayer();
+    if (layer)
+      Add(std::move(layer));
+  }
+}
+
+void ContainerLayer::PrerollChildrenWithRasterCache(PrerollContext* context,
+                                                    const SkMatrix& matrix) {
+  cached_children_image_ = nullptr;
+
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, paint_bounds());
+  children_occluded_ = !paint_bounds().isEmpty() &&
+                       device_bounds.intersect(context->cull_rect) &&
+                       context->occluded_rect.contains(device_bounds);
+  if (children_occluded_)
+    return;
+
+  // Animated children would be frozen in the cache.
+  if (!context->raster_cache_enabled || ChildrenHaveAnimations()) {
+    PrerollBlendedChildren(context, matrix);
+    return;
+  }
+
+  LayerSignature signature;
+  AppendChildrenSignature(&signature);
+
+  PaintContext& paint_context = context->frame.paint_context();
+  GrContext* gr_context = context->frame.gr_context();
+
+  // Only invoked when the cache is filled. The children are prerolled
+  // against the offscreen canvas with caching disabled and painted
+  // directly into it.
+  const base::TimeTicks animation_time = context->animation_time;
+  auto draw = [this, &paint_context, gr_context,
+               animation_time](SkCanvas* canvas) {
+    PaintContext::ScopedFrame frame =
+        paint_context.AcquireFrame(*canvas, gr_context, false);
+    SkIRect device_clip;
+    canvas->getClipDeviceBounds(&device_clip);
+    PrerollContext child_context = {frame,
+                                    SkRect::Make(device_clip),
+                                    false,
+                                    nullptr,
+                                    0,
+                                    0,
+                                    SkRect::MakeEmpty(),
+                                    true,
+                                    animation_time,
+                                    false};
+    PrerollChildren(&child_context, canvas->getTotalMatrix());
+    PaintChildren(frame);
+  };
+
+  PictureRasterzier& rasterizer = paint_context.rasterizer();
+  cached_children_image_ = rasterizer.GetCachedLayerImageIfPresent(
+      paint_context, gr_context, signature.value(), paint_bounds(), matrix,
+      draw, &cached_children_rect_);
+
+  if (!cached_children_image_) {
+    PrerollBlendedChildren(context, matrix);
+    return;
+  }
+
+  // The children are not prerolled, so they add no damage records. Record
+  // the cached image instead.
+  if (context->damage_tracker) {
+    LayerSignature key;
+    key.Add(context->ancestor_state);
+    key.Add(matrix);
+    AppendSignature(&key);
+
+    if (device_bounds.intersect(context->cull_rect))
+      context->damage_tracker->AddRecord(key.value(), device_bounds);
+  }
+}
+
+bool ContainerLayer::ChildrenHaveAnimations() const {
+  if (!has_animations())
+    return false;
+  for (const auto& layer : layers_) {
+    if (layer->has_animations())
+      return true;
+  }
+  return false;
+}
+
+void ContainerLayer::PrerollBlendedChildren(PrerollContext* context,
+                                            const SkMatrix& matrix) {
+  // The children are blended into what is under this layer, so their opaque
+  // pixels do not hide anything.
+  const bool occlusion_enabled = context->occlusion_enabled;
+  context->occlusion_enabled = false;
+  PrerollChildren(context, matrix);
+  context->occlusion_enabled = occlusion_enabled;
+}
+
+bool ContainerLayer::PaintCachedChildren(PaintContext::ScopedFrame& frame,
+                                         const SkPaint& paint) {
+  if (children_occluded_)
+    return true;
+
+  if (!cached_children_image_)
+    return false;
+
+  // The cached image is already in device space.
+  SkCanvas& canvas = frame.canvas();
+  canvas.save();
+  canvas.resetMatrix();
+  canvas.drawImageRect(cached_children_image_.get(),
+                       SkRect::MakeIWH(cached_children_rect_.width(),
+                                       cached_children_rect_.height()),
+                       SkRect::Make(cached_children_rect_), &paint);
+  canvas.restore();
+  cached_children_image_ = nullptr;
+  return true;
+}
+
 }  // namespace compositor
 }  // namespace sky
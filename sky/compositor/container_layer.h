@@ -6,23 +6,78 @@
 #define SKY_COMPOSITOR_CONTAINER_LAYER_H_
 
 #include "sky/compositor/layer.h"
+#include "sky/compositor/layer_arena.h"
 
 namespace sky {
 namespace compositor {
 
 class ContainerLayer : public Layer {
  public:
+  using LayerList = std::vector<std::shared_ptr<Layer>,
+                                LayerArenaAllocator<std::shared_ptr<Layer>>>;
+
   ContainerLayer();
   ~ContainerLayer() override;
 
-  void Add(std::unique_ptr<Layer> layer);
+  // Layers may be shared between the trees of consecutive frames when a
+  // subtree is retained, so ownership is shared.
+  void Add(std::shared_ptr<Layer> layer);
+
+  // Allocates the list of children from |arena|. Must be called before the
+  // first child is added.
+  void UseArena(const std::shared_ptr<LayerArena>& arena);
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  void PrerollChildren(PrerollContext* context, const SkMatrix& matrix);
 
   void PaintChildren(PaintContext::ScopedFrame& frame) const;
 
-  const std::vector<std::unique_ptr<Layer>>& layers() const { return layers_; }
+  void AppendSignature(LayerSignature* signature) const override;
+
+  // Adds the state of this layer, but not its children, that affects how
+  // the children paint.
+  virtual void AppendStateSignature(LayerSignature* signature) const;
+
+  void AppendChildrenSignature(LayerSignature* signature) const;
+
+  void Serialize(LayerWriter* writer) const override;
+  void Deserialize(LayerReader* reader) override;
+
+  void SerializeChildren(LayerWriter* writer) const;
+  void DeserializeChildren(LayerReader* reader);
+
+  const LayerList& layers() const { return layers_; }
+
+ protected:
+  // For layers that would otherwise paint their children into a save layer
+  // bounded by paint_bounds(). Once the children have been stable for long
+  // enough they are rasterized into the cache instead, and only that image
+  // is composited. Otherwise the children are prerolled as usual, except
+  // that they do not occlude anything. Nothing is prerolled if the layers
+  // above hide all of paint_bounds().
+  void PrerollChildrenWithRasterCache(PrerollContext* context,
+                                      const SkMatrix& matrix);
+
+  // Draws the image found during preroll with |paint| and returns true, or
+  // returns false if the children have to be painted. Also returns true,
+  // without drawing anything, if layers above hide the whole subtree.
+  bool PaintCachedChildren(PaintContext::ScopedFrame& frame,
+                           const SkPaint& paint);
 
  private:
-  std::vector<std::unique_ptr<Layer>> layers_;
+  void PrerollBlendedChildren(PrerollContext* context, const SkMatrix& matrix);
+  bool ChildrenHaveAnimations() const;
+
+  LayerList layers_;
+
+  // Signatures of retained subtrees are computed once.
+  mutable bool children_signature_valid_;
+  mutable uint64_t children_signature_;
+
+  RefPtr<SkImage> cached_children_image_;
+  SkIRect cached_children_rect_;
+  bool children_occluded_;
 
   DISALLOW_COPY_AND_ASSIGN(ContainerLayer);
 };
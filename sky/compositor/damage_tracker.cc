@@ -0,0 +1,65 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/damage_tracker.h"
+
+namespace sky {
+namespace compositor {
+
+DamageTracker::DamageTracker()
+    : previous_frame_bounds_(SkIRect::MakeEmpty()), invalidated_(true) {
+}
+
+DamageTracker::~DamageTracker() {
+}
+
+void DamageTracker::AddRecord(uint64_t key, const SkRect& device_bounds) {
+  SkIRect bounds = device_bounds.roundOut();
+  if (bounds.isEmpty())
+    return;
+  auto result = current_records_.insert(std::make_pair(key, bounds));
+  // The same contents drawn twice with the same state share a record.
+  if (!result.second)
+    result.first->second.join(bounds);
+}
+
+SkIRect DamageTracker::ComputeDamage(const SkIRect& frame_bounds) {
+  SkIRect damage = SkIRect::MakeEmpty();
+
+  if (invalidated_ || frame_bounds != previous_frame_bounds_) {
+    damage = frame_bounds;
+  } else {
+    for (const auto& record : current_records_) {
+      auto previous = previous_records_.find(record.first);
+      if (previous == previous_records_.end() ||
+          previous->second != record.second) {
+        damage.join(record.second);
+        if (previous != previous_records_.end())
+          damage.join(previous->second);
+      }
+    }
+
+    for (const auto& record : previous_records_) {
+      if (current_records_.find(record.first) == current_records_.end())
+        damage.join(record.second);
+    }
+
+    if (!damage.intersect(frame_bounds))
+      damage.setEmpty();
+  }
+
+  previous_records_.swap(current_records_);
+  current_records_.clear();
+  previous_frame_bounds_ = frame_bounds;
+  invalidated_ = false;
+
+  return damage;
+}
+
+void DamageTracker::Invalidate() {
+  invalidated_ = true;
+}
+
+}  // namespace compositor
+}  // namespace sky
@@ -0,0 +1,54 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_DAMAGE_TRACKER_H_
+#define SKY_COMPOSITOR_DAMAGE_TRACKER_H_
+
+#include <stdint.h>
+
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace sky {
+namespace compositor {
+
+// Works out which part of the frame changed since the previous frame. Layer
+// trees are rebuilt every frame, so layers are matched up across frames by
+// what they draw rather than by identity. During preroll every layer that
+// draws something adds a record keyed by a hash of its contents, its device
+// space matrix and the state of the layers above it. The damage is the union
+// of the bounds of all records that only appear in one of the two frames.
+class DamageTracker {
+ public:
+  DamageTracker();
+  ~DamageTracker();
+
+  void AddRecord(uint64_t key, const SkRect& device_bounds);
+
+  // Returns the part of |frame_bounds| that has to be repainted and starts
+  // tracking a new frame. The whole frame is damaged if |frame_bounds|
+  // changed or Invalidate() was called since the previous frame.
+  SkIRect ComputeDamage(const SkIRect& frame_bounds);
+
+  // Forces the whole of the next frame to be repainted, e.g. because the
+  // contents of the surface were lost.
+  void Invalidate();
+
+ private:
+  using Records = std::unordered_map<uint64_t, SkIRect>;
+
+  Records previous_records_;
+  Records current_records_;
+  SkIRect previous_frame_bounds_;
+  bool invalidated_;
+
+  DISALLOW_COPY_AND_ASSIGN(DamageTracker);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_DAMAGE_TRACKER_H_
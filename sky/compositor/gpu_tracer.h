@@ -0,0 +1,53 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_GPU_TRACER_H_
+#define SKY_COMPOSITOR_GPU_TRACER_H_
+
+#include "base/macros.h"
+
+#include <stdint.h>
+
+namespace sky {
+namespace compositor {
+
+// Measures how long the GPU spends on the work issued between BeginSpan and
+// EndSpan. The compositor marks the spans and the embedder, which owns the GL
+// context, does the timing. Results arrive frames later, once the GPU is done
+// with the work.
+class GPUTracer {
+ public:
+  virtual ~GPUTracer() {}
+
+  // Spans may nest. |name| must be a string literal. |picture_id| is the
+  // unique ID of the picture being drawn, or zero if the span is not about a
+  // single picture.
+  virtual void BeginSpan(const char* name, uint32_t picture_id) = 0;
+  virtual void EndSpan() = 0;
+};
+
+// Times the scope it is in. Does nothing if |tracer| is null.
+class ScopedGPUSpan {
+ public:
+  ScopedGPUSpan(GPUTracer* tracer, const char* name, uint32_t picture_id)
+      : tracer_(tracer) {
+    if (tracer_)
+      tracer_->BeginSpan(name, picture_id);
+  }
+
+  ~ScopedGPUSpan() {
+    if (tracer_)
+      tracer_->EndSpan();
+  }
+
+ private:
+  GPUTracer* tracer_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedGPUSpan);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_GPU_TRACER_H_
@@ -4,11 +4,68 @@
 
 #include "sky/compositor/instrumentation.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.h"
+
 namespace sky {
 namespace compositor {
 namespace instrumentation {
 
-//
+FrameTiming::FrameTiming() : frame_number(0) {
+}
+
+FrameTimeHistory::FrameTimeHistory() : next_(0) {
+  samples_.reserve(kMaxSamples);
+}
+
+FrameTimeHistory::~FrameTimeHistory() {
+}
+
+void FrameTimeHistory::Add(base::TimeDelta sample) {
+  if (samples_.size() < kMaxSamples) {
+    samples_.push_back(sample);
+    return;
+  }
+  samples_[next_] = sample;
+  next_ = (next_ + 1) % kMaxSamples;
+}
+
+base::TimeDelta FrameTimeHistory::sample(size_t index) const {
+  DCHECK(index < samples_.size());
+  return samples_[(next_ + index) % samples_.size()];
+}
+
+base::TimeDelta FrameTimeHistory::last() const {
+  if (samples_.empty())
+    return base::TimeDelta();
+  return sample(samples_.size() - 1);
+}
+
+base::TimeDelta FrameTimeHistory::Percentile(double percentile) const {
+  if (samples_.empty())
+    return base::TimeDelta();
+
+  std::vector<base::TimeDelta> sorted(samples_);
+  const double rank = std::ceil(percentile / 100.0 * sorted.size());
+  size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+  index = std::min(index, sorted.size() - 1);
+  std::nth_element(sorted.begin(), sorted.begin() + index, sorted.end());
+  return sorted[index];
+}
+
+base::TimeDelta FrameTimeHistory::Max() const {
+  if (samples_.empty())
+    return base::TimeDelta();
+  return *std::max_element(samples_.begin(), samples_.end());
+}
+
+size_t FrameTimeHistory::CountOver(base::TimeDelta budget) const {
+  return std::count_if(
+      samples_.begin(), samples_.end(),
+      [budget](const base::TimeDelta& sample) { return sample > budget; });
+}
 
 }  // namespace instrumentation
 }  // namespace compositor
@@ -8,6 +8,8 @@
 #include "base/macros.h"
 #include "base/time/time.h"
 
+#include <vector>
+
 namespace sky {
 namespace compositor {
 namespace instrumentation {
@@ -61,6 +63,73 @@ class Counter {
   DISALLOW_COPY_AND_ASSIGN(Counter);
 };
 
+// The time available to produce a frame at 60Hz.
+inline base::TimeDelta FrameBudget() {
+  return base::TimeDelta::FromMicroseconds(16667);
+}
+
+// Where the time of a single frame went, from the start of the frame on the
+// UI thread to the point it was handed to the display by the GPU thread.
+struct FrameTiming {
+  FrameTiming();
+
+  uint64_t frame_number;
+  // Usually the vsync time the frame was started for.
+  base::TimeTicks frame_time;
+  base::TimeTicks build_start;
+  base::TimeTicks build_end;
+  base::TimeTicks raster_start;
+  base::TimeTicks raster_end;
+  base::TimeTicks swap_end;
+
+  base::TimeDelta BuildTime() const { return build_end - build_start; }
+
+  // Time the finished layer tree spent waiting for the GPU thread.
+  base::TimeDelta QueueTime() const { return raster_start - build_end; }
+
+  base::TimeDelta RasterTime() const { return raster_end - raster_start; }
+
+  base::TimeDelta SwapTime() const { return swap_end - raster_end; }
+
+  base::TimeDelta TotalLatency() const { return swap_end - frame_time; }
+};
+
+// Keeps the most recent |kMaxSamples| frame timings so that intermittent
+// slow frames are still visible after the fact.
+class FrameTimeHistory {
+ public:
+  static const size_t kMaxSamples = 120;
+
+  FrameTimeHistory();
+  ~FrameTimeHistory();
+
+  void Add(base::TimeDelta sample);
+
+  size_t size() const { return samples_.size(); }
+
+  // Samples are indexed from the oldest to the most recent.
+  base::TimeDelta sample(size_t index) const;
+
+  base::TimeDelta last() const;
+
+  // Returns the smallest sample that is greater than or equal to
+  // |percentile| percent of all samples.
+  base::TimeDelta Percentile(double percentile) const;
+
+  base::TimeDelta Max() const;
+
+  // The number of samples that took longer than |budget|.
+  size_t CountOver(base::TimeDelta budget) const;
+
+ private:
+  std::vector<base::TimeDelta> samples_;
+  // The index in |samples_| the next sample is written to once the history
+  // is full.
+  size_t next_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameTimeHistory);
+};
+
 }  // namespace instrumentation
 }  // namespace compositor
 }  // namespace sky
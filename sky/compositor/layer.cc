@@ -4,16 +4,95 @@
 
 #include "sky/compositor/layer.h"
 
+#include "sky/compositor/container_layer.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 
 namespace sky {
 namespace compositor {
+namespace {
 
-Layer::Layer() {
+const SkColor kLayerBoundsColor = SkColorSetRGB(0xFF, 0x98, 0x00);
+
+// How far from a whole pixel a clip edge may be and still be taken as on
+// it, to allow for the rounding of the transforms above the clip.
+const SkScalar kPixelAlignmentTolerance = 1.0f / 256;
+
+bool IsNearlyIntegral(SkScalar value, int32_t integer) {
+  return SkScalarNearlyEqual(value, SkIntToScalar(integer),
+                             kPixelAlignmentTolerance);
+}
+
+}  // namespace
+
+Layer::Layer() : parent_(nullptr), has_animations_(false) {
 }
 
 Layer::~Layer() {
 }
 
+void Layer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+}
+
+void Layer::AddOccluder(PrerollContext* context, const SkRect& device_rect) {
+  if (!context->occlusion_enabled)
+    return;
+
+  SkRect rect = device_rect;
+  if (!rect.intersect(context->cull_rect))
+    return;
+
+  // Only a single rect is tracked. It is replaced by any rect that covers a
+  // larger area, as for the opaque regions of the engine's RegionTracker.
+  SkRect& occluded_rect = context->occluded_rect;
+  if (rect.width() * rect.height() >
+      occluded_rect.width() * occluded_rect.height()) {
+    occluded_rect = rect;
+  }
+}
+
+bool Layer::ClipToPixelAlignedRect(SkCanvas& canvas, const SkRect& rect) {
+  const SkMatrix matrix = canvas.getTotalMatrix();
+  if (matrix.getType() & ~(SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask))
+    return false;
+
+  SkRect device_rect;
+  matrix.mapRect(&device_rect, rect);
+  const SkIRect pixels = device_rect.round();
+  if (!IsNearlyIntegral(device_rect.left(), pixels.left()) ||
+      !IsNearlyIntegral(device_rect.top(), pixels.top()) ||
+      !IsNearlyIntegral(device_rect.right(), pixels.right()) ||
+      !IsNearlyIntegral(device_rect.bottom(), pixels.bottom())) {
+    return false;
+  }
+
+  canvas.resetMatrix();
+  canvas.clipRect(SkRect::Make(pixels), SkRegion::kIntersect_Op, false);
+  canvas.setMatrix(matrix);
+  return true;
+}
+
+void Layer::SetHasAnimations() {
+  // Ancestors already marked have marked theirs.
+  for (Layer* layer = this; layer && !layer->has_animations_;
+       layer = layer->parent()) {
+    layer->has_animations_ = true;
+  }
+}
+
+void Layer::PaintLayerBounds(PaintContext::ScopedFrame& frame,
+                             const SkRect& bounds) {
+  if (!frame.paint_context().options().isEnabled(
+          CompositorOptions::Option::VisualizeLayerBounds)) {
+    return;
+  }
+
+  // Hairlines are a single device pixel wide whatever the transform.
+  SkPaint paint;
+  paint.setStyle(SkPaint::kStroke_Style);
+  paint.setStrokeWidth(0);
+  paint.setColor(kLayerBoundsColor);
+  frame.canvas().drawRect(bounds, paint);
+}
+
 }  // namespace compositor
 }  // namespace sky
@@ -9,6 +9,7 @@
 #include <vector>
 
 #include "base/macros.h"
+#include "base/time/time.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefPtr.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -27,13 +28,68 @@ namespace sky {
 namespace compositor {
 
 class ContainerLayer;
+class DamageTracker;
+class LayerReader;
+class LayerSignature;
+class LayerWriter;
 class Layer {
  public:
   Layer();
   virtual ~Layer();
 
+  struct PrerollContext {
+    PaintContext::ScopedFrame& frame;
+    // The device space rect outside of which nothing painted is visible.
+    SkRect cull_rect;
+    // False while prerolling a subtree that is itself being rasterized into
+    // the cache. Its layers must not be cached a second time.
+    bool raster_cache_enabled;
+    // Receives a record for everything that is painted, or null if damage
+    // is not being tracked.
+    DamageTracker* damage_tracker;
+    // A signature of the ancestors' state that affects how this layer
+    // paints, such as clips, opacity and color filters.
+    uint64_t ancestor_state;
+    // The number of layers prerolled so far, for instrumentation.
+    size_t layer_count;
+    // The device space rect that the layers prerolled so far cover with
+    // opaque pixels. Children are prerolled from the top down, so whatever
+    // lies inside of it is hidden by layers that are painted later.
+    SkRect occluded_rect;
+    // False below layers that blend their children into what is under them
+    // or clip them to something other than a rect. Their children's opaque
+    // pixels cannot be said to hide anything.
+    bool occlusion_enabled;
+    // The time the frame is meant to be shown at, which animated layers are
+    // prerolled for.
+    base::TimeTicks animation_time;
+    // Set by animated layers whose values change after |animation_time|, so
+    // that the tree is drawn again for the next frame.
+    bool animations_running;
+  };
+
+  // Called on every layer in the tree before any layer is painted. |matrix|
+  // maps the layer's coordinate space to device space. Layers use this pass
+  // to decide what to rasterize so that offscreen rasterization never
+  // interrupts the draw calls of the frame.
+  virtual void Preroll(PrerollContext* context, const SkMatrix& matrix);
+
   virtual void Paint(PaintContext::ScopedFrame& frame) = 0;
 
+  // Adds everything that affects how this layer and its descendants paint to
+  // |signature|.
+  virtual void AppendSignature(LayerSignature* signature) const = 0;
+
+  // Writes this layer and its descendants so that a LayerReader can create
+  // an equivalent subtree. See layer_serialization.h.
+  virtual void Serialize(LayerWriter* writer) const = 0;
+
+  // Reads back what Serialize wrote after the header written by
+  // LayerWriter::BeginLayer.
+  virtual void Deserialize(LayerReader* reader) = 0;
+
+  // The container this layer was most recently added to. A retained layer
+  // shared between the trees of several frames refers to the newest one.
   ContainerLayer* parent() const { return parent_; }
 
   void set_parent(ContainerLayer* parent) { parent_ = parent; }
@@ -44,9 +100,34 @@ class Layer {
     paint_bounds_ = paint_bounds;
   }
 
+  // Whether this layer or one of its descendants animates, and so paints
+  // differently from one frame of the same tree to the next.
+  bool has_animations() const { return has_animations_; }
+
+ protected:
+  // Adds |device_rect|, which is covered with opaque pixels, to the rect
+  // that hides the layers prerolled after this one.
+  static void AddOccluder(PrerollContext* context, const SkRect& device_rect);
+
+  // Outlines |bounds|, in the canvas' current coordinate space, if
+  // CompositorOptions::Option::VisualizeLayerBounds is enabled.
+  static void PaintLayerBounds(PaintContext::ScopedFrame& frame,
+                               const SkRect& bounds);
+
+  // Clips |canvas| to |rect| if the canvas' matrix only scales and
+  // translates it onto whole device pixels. The clip is then set in device
+  // space without anti-aliasing, which the GPU applies as a scissor rather
+  // than with a stencil or a coverage mask. Returns false, leaving the clip
+  // alone, otherwise.
+  static bool ClipToPixelAlignedRect(SkCanvas& canvas, const SkRect& rect);
+
+  // Marks this layer and its ancestors as having animations.
+  void SetHasAnimations();
+
  private:
   ContainerLayer* parent_;
   SkRect paint_bounds_;
+  bool has_animations_;
 
   DISALLOW_COPY_AND_ASSIGN(Layer);
 };
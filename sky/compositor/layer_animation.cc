@@ -0,0 +1,105 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/layer_animation.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "sky/engine/platform/animation/UnitBezier.h"
+
+namespace sky {
+namespace compositor {
+
+LayerAnimation::LayerAnimation(base::TimeTicks start_time,
+                               base::TimeDelta duration)
+    : start_time_(start_time),
+      duration_(duration),
+      iterations_(1),
+      alternate_(false) {
+}
+
+LayerAnimation::~LayerAnimation() {
+}
+
+void LayerAnimation::AddKeyframe(double offset,
+                                 float value,
+                                 double x1,
+                                 double y1,
+                                 double x2,
+                                 double y2) {
+  // Control points outside of [0, 1] on the time axis would make the curve
+  // go back in time.
+  x1 = std::min(std::max(x1, 0.0), 1.0);
+  x2 = std::min(std::max(x2, 0.0), 1.0);
+  Keyframe keyframe = {std::min(std::max(offset, 0.0), 1.0),
+                       value, x1, y1, x2, y2};
+  auto it = std::upper_bound(
+      keyframes_.begin(), keyframes_.end(), keyframe,
+      [](const Keyframe& a, const Keyframe& b) { return a.offset < b.offset; });
+  keyframes_.insert(it, keyframe);
+}
+
+void LayerAnimation::SetIterations(int count, bool alternate) {
+  iterations_ = std::max(count, 0);
+  alternate_ = alternate;
+}
+
+double LayerAnimation::IterationOffsetAt(base::TimeTicks time) const {
+  if (time <= start_time_)
+    return 0;
+  if (duration_ <= base::TimeDelta())
+    return 1;
+
+  const double progress =
+      (time - start_time_).InSecondsF() / duration_.InSecondsF();
+  double iteration = std::floor(progress);
+  double offset = progress - iteration;
+  if (iterations_ && iteration >= iterations_) {
+    // Ended at the end of the last iteration.
+    iteration = iterations_ - 1;
+    offset = 1;
+  }
+  if (alternate_ && std::fmod(iteration, 2) == 1)
+    offset = 1 - offset;
+  return offset;
+}
+
+float LayerAnimation::ValueAt(base::TimeTicks time) const {
+  if (keyframes_.empty())
+    return 0;
+
+  const double offset = IterationOffsetAt(time);
+  if (offset <= keyframes_.front().offset)
+    return keyframes_.front().value;
+  if (offset >= keyframes_.back().offset)
+    return keyframes_.back().value;
+
+  auto next = std::find_if(
+      keyframes_.begin(), keyframes_.end(),
+      [offset](const Keyframe& keyframe) { return keyframe.offset > offset; });
+  const Keyframe& from = *(next - 1);
+  const Keyframe& to = *next;
+
+  const double fraction = (offset - from.offset) / (to.offset - from.offset);
+  // The same accuracy as the engine's timing functions, a fraction of a
+  // frame over the length of the segment.
+  const double segment_seconds =
+      duration_.InSecondsF() * (to.offset - from.offset);
+  const double accuracy = 1.0 / (200.0 * std::max(segment_seconds, 1e-3));
+  blink::UnitBezier curve(from.x1, from.y1, from.x2, from.y2);
+  const double eased = curve.solve(fraction, accuracy);
+  return from.value + (to.value - from.value) * eased;
+}
+
+bool LayerAnimation::IsRunningAt(base::TimeTicks time) const {
+  if (keyframes_.size() < 2)
+    return false;
+  if (!iterations_)
+    return true;
+  return time < start_time_ + duration_ * iterations_;
+}
+
+}  // namespace compositor
+}  // namespace sky
@@ -0,0 +1,69 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_LAYER_ANIMATION_H_
+#define SKY_COMPOSITOR_LAYER_ANIMATION_H_
+
+#include <vector>
+
+#include "base/time/time.h"
+
+namespace sky {
+namespace compositor {
+
+// A curve along which a layer animates one of its properties while the
+// layer tree is drawn, so that the GPU thread can keep drawing the same tree
+// at every frame without the UI thread building a new one.
+//
+// The keyframes divide an iteration, from offset 0 at its start to offset 1
+// at its end. Between two keyframes the value eases from the first one's to
+// the second one's along the first one's cubic Bezier timing curve.
+class LayerAnimation {
+ public:
+  LayerAnimation(base::TimeTicks start_time, base::TimeDelta duration);
+  ~LayerAnimation();
+
+  // Adds a keyframe, which eases into the next keyframe along the curve from
+  // (0, 0) to (1, 1) whose control points are (x1, y1) and (x2, y2).
+  void AddKeyframe(double offset,
+                   float value,
+                   double x1,
+                   double y1,
+                   double x2,
+                   double y2);
+
+  // Runs the animation |count| times, or forever if |count| is 0. Every
+  // other iteration runs backwards if |alternate| is set. Runs once by
+  // default.
+  void SetIterations(int count, bool alternate);
+
+  // The value at |time|. The first keyframe's value holds before the
+  // animation starts and the final value holds after it ends.
+  float ValueAt(base::TimeTicks time) const;
+
+  // Whether the value still changes after |time|.
+  bool IsRunningAt(base::TimeTicks time) const;
+
+ private:
+  struct Keyframe {
+    double offset;
+    float value;
+    double x1, y1, x2, y2;
+  };
+
+  // The offset into the current iteration at |time|.
+  double IterationOffsetAt(base::TimeTicks time) const;
+
+  base::TimeTicks start_time_;
+  base::TimeDelta duration_;
+  int iterations_;
+  bool alternate_;
+  // Sorted by offset.
+  std::vector<Keyframe> keyframes_;
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_LAYER_ANIMATION_H_
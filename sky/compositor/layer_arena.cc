@@ -0,0 +1,66 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/layer_arena.h"
+
+#include <stdint.h>
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace sky {
+namespace compositor {
+
+// Large enough for the layers of a typical scene to fit in a few blocks.
+static const size_t kBlockSize = 16 * 1024;
+
+std::shared_ptr<LayerArena> LayerArena::Create() {
+  return std::shared_ptr<LayerArena>(new LayerArena());
+}
+
+LayerArena::LayerArena()
+    : cursor_(nullptr), remaining_(0), allocated_bytes_(0) {
+}
+
+LayerArena::~LayerArena() {
+}
+
+void* LayerArena::Allocate(size_t size, size_t alignment) {
+  DCHECK(alignment && !(alignment & (alignment - 1)));
+
+  size_t padding =
+      (alignment - (reinterpret_cast<uintptr_t>(cursor_) & (alignment - 1))) &
+      (alignment - 1);
+
+  if (!cursor_ || padding + size > remaining_) {
+    // Oversized allocations get a block of their own so that the current
+    // block can still be used for the layers that follow.
+    const size_t block_size = std::max(kBlockSize, size + alignment);
+    std::unique_ptr<char[]> block(new char[block_size]);
+    char* start = block.get();
+    blocks_.push_back(std::move(block));
+    allocated_bytes_ += block_size;
+
+    if (block_size > kBlockSize) {
+      uintptr_t address = reinterpret_cast<uintptr_t>(start);
+      return reinterpret_cast<void*>((address + alignment - 1) &
+                                     ~(alignment - 1));
+    }
+
+    cursor_ = start;
+    remaining_ = block_size;
+    padding =
+        (alignment - (reinterpret_cast<uintptr_t>(cursor_) & (alignment - 1))) &
+        (alignment - 1);
+  }
+
+  char* result = cursor_ + padding;
+  cursor_ = result + size;
+  remaining_ -= padding + size;
+  return result;
+}
+
+}  // namespace compositor
+}  // namespace sky
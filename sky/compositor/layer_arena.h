@@ -0,0 +1,101 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_LAYER_ARENA_H_
+#define SKY_COMPOSITOR_LAYER_ARENA_H_
+
+#include <stddef.h>
+
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "base/macros.h"
+
+namespace sky {
+namespace compositor {
+
+// A bump allocator for the layers of one scene. Individual allocations are
+// never freed. The memory is released in one step once the arena and every
+// layer allocated from it are gone, which is usually when the GPU thread is
+// done with the layer tree.
+class LayerArena {
+ public:
+  static std::shared_ptr<LayerArena> Create();
+
+  ~LayerArena();
+
+  void* Allocate(size_t size, size_t alignment);
+
+  size_t allocated_bytes() const { return allocated_bytes_; }
+
+ private:
+  LayerArena();
+
+  std::vector<std::unique_ptr<char[]>> blocks_;
+  char* cursor_;
+  size_t remaining_;
+  size_t allocated_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerArena);
+};
+
+// A standard allocator backed by a LayerArena. Every copy keeps the arena
+// alive, so objects created with std::allocate_shared outlive the scene that
+// created them safely, e.g. when a subtree is retained. Without an arena it
+// falls back to the heap.
+template <typename T>
+class LayerArenaAllocator {
+ public:
+  using value_type = T;
+
+  LayerArenaAllocator() {}
+
+  explicit LayerArenaAllocator(std::shared_ptr<LayerArena> arena)
+      : arena_(std::move(arena)) {}
+
+  template <typename U>
+  LayerArenaAllocator(const LayerArenaAllocator<U>& other)
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t count) {
+    if (!arena_)
+      return static_cast<T*>(::operator new(count * sizeof(T)));
+    return static_cast<T*>(arena_->Allocate(count * sizeof(T), alignof(T)));
+  }
+
+  void deallocate(T* pointer, size_t count) {
+    if (!arena_)
+      ::operator delete(pointer);
+  }
+
+  const std::shared_ptr<LayerArena>& arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const LayerArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+
+  template <typename U>
+  bool operator!=(const LayerArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+ private:
+  std::shared_ptr<LayerArena> arena_;
+};
+
+// Creates a layer, and its reference count, in |arena|.
+template <typename T, typename... Args>
+std::shared_ptr<T> MakeLayer(const std::shared_ptr<LayerArena>& arena,
+                             Args&&... args) {
+  return std::allocate_shared<T>(LayerArenaAllocator<T>(arena),
+                                 std::forward<Args>(args)...);
+}
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_LAYER_ARENA_H_
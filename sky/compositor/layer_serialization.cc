@@ -0,0 +1,397 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/layer_serialization.h"
+
+#include "base/logging.h"
+#include "skia/ext/refptr.h"
+#include "sky/compositor/clip_path_layer.h"
+#include "sky/compositor/clip_rect_layer.h"
+#include "sky/compositor/clip_rrect_layer.h"
+#include "sky/compositor/color_filter_layer.h"
+#include "sky/compositor/container_layer.h"
+#include "sky/compositor/layer.h"
+#include "sky/compositor/layer_arena.h"
+#include "sky/compositor/layer_tree.h"
+#include "sky/compositor/opacity_layer.h"
+#include "sky/compositor/picture_layer.h"
+#include "sky/compositor/scroll_layer.h"
+#include "sky/compositor/shadow_layer.h"
+#include "sky/compositor/texture_layer.h"
+#include "sky/compositor/transform_layer.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace sky {
+namespace compositor {
+namespace {
+
+const char kMagic[8] = {'S', 'K', 'Y', 'L', 'A', 'Y', 'E', 'R'};
+const uint32_t kVersion = 2;
+
+enum Record : uint32_t {
+  kEndRecord,
+  kTreeRecord,
+  kReleasePicturesRecord,
+};
+
+// Layer trees are shallow. Anything deeper than this is a corrupt stream
+// that would otherwise overflow the stack.
+const int kMaxDepth = 256;
+
+}  // namespace
+
+LayerWriter::LayerWriter(SkWStream* stream,
+                         SkPixelSerializer* pixel_serializer)
+    : stream_(stream), pixel_serializer_(pixel_serializer), picture_count_(0) {
+  WriteBytes(kMagic, sizeof(kMagic));
+  Write(kVersion);
+}
+
+LayerWriter::~LayerWriter() {
+}
+
+void LayerWriter::WriteTree(const LayerTree& layer_tree) {
+  Write(static_cast<uint32_t>(kTreeRecord));
+  Write(static_cast<uint32_t>(layer_tree.frame_size().width()));
+  Write(static_cast<uint32_t>(layer_tree.frame_size().height()));
+  Layer* root_layer = layer_tree.root_layer();
+  Write(static_cast<uint32_t>(root_layer ? 1 : 0));
+  if (root_layer)
+    WriteLayer(*root_layer);
+}
+
+void LayerWriter::Finish() {
+  Write(static_cast<uint32_t>(kEndRecord));
+  stream_->flush();
+}
+
+void LayerWriter::SetStream(SkWStream* stream) {
+  stream_ = stream;
+}
+
+void LayerWriter::ReleaseUnusedPictures() {
+  std::vector<uint32_t> released;
+  for (auto it = picture_indices_.begin(); it != picture_indices_.end();) {
+    if (used_pictures_.count(it->first)) {
+      ++it;
+      continue;
+    }
+    released.push_back(it->second);
+    picture_indices_.erase(it++);
+  }
+  used_pictures_.clear();
+  if (released.empty())
+    return;
+
+  Write(static_cast<uint32_t>(kReleasePicturesRecord));
+  Write(static_cast<uint32_t>(released.size()));
+  for (uint32_t index : released)
+    Write(index);
+  free_picture_indices_.insert(free_picture_indices_.end(), released.begin(),
+                               released.end());
+}
+
+void LayerWriter::WriteLayer(const Layer& layer) {
+  layer.Serialize(this);
+}
+
+void LayerWriter::BeginLayer(LayerSignature::Tag tag, const Layer& layer) {
+  Write(static_cast<uint32_t>(tag));
+  Write(layer.paint_bounds());
+}
+
+void LayerWriter::Write(uint32_t value) {
+  stream_->write32(value);
+}
+
+void LayerWriter::Write(SkScalar value) {
+  stream_->writeScalar(value);
+}
+
+void LayerWriter::Write(const SkPoint& point) {
+  Write(point.x());
+  Write(point.y());
+}
+
+void LayerWriter::Write(const SkRect& rect) {
+  Write(rect.left());
+  Write(rect.top());
+  Write(rect.right());
+  Write(rect.bottom());
+}
+
+void LayerWriter::Write(const SkRRect& rrect) {
+  char buffer[SkRRect::kSizeInMemory];
+  rrect.writeToMemory(buffer);
+  WriteBytes(buffer, sizeof(buffer));
+}
+
+void LayerWriter::Write(const SkMatrix& matrix) {
+  for (int i = 0; i < 9; ++i)
+    Write(matrix.get(i));
+}
+
+void LayerWriter::Write(const SkPath& path) {
+  const size_t length = path.writeToMemory(nullptr);
+  std::vector<char> buffer(length);
+  path.writeToMemory(buffer.data());
+  Write(static_cast<uint32_t>(length));
+  WriteBytes(buffer.data(), length);
+}
+
+void LayerWriter::Write(SkPicture* picture) {
+  DCHECK(picture);
+  used_pictures_.insert(picture->uniqueID());
+  auto it = picture_indices_.find(picture->uniqueID());
+  if (it != picture_indices_.end()) {
+    Write(it->second);
+    return;
+  }
+
+  uint32_t index = picture_count_;
+  if (free_picture_indices_.empty()) {
+    ++picture_count_;
+  } else {
+    index = free_picture_indices_.back();
+    free_picture_indices_.pop_back();
+  }
+  picture_indices_[picture->uniqueID()] = index;
+  Write(index);
+
+  SkDynamicMemoryWStream picture_stream;
+  picture->serialize(&picture_stream, pixel_serializer_);
+  skia::RefPtr<SkData> data = skia::AdoptRef(picture_stream.copyToData());
+  Write(static_cast<uint32_t>(data->size()));
+  WriteBytes(data->data(), data->size());
+}
+
+void LayerWriter::WriteBytes(const void* data, size_t length) {
+  stream_->write(data, length);
+}
+
+LayerReader::LayerReader(SkStream* stream)
+    : stream_(stream),
+      started_(false),
+      failed_(false),
+      ended_(false),
+      depth_(0) {
+}
+
+LayerReader::~LayerReader() {
+}
+
+void LayerReader::SetStream(SkStream* stream) {
+  stream_ = stream;
+}
+
+scoped_ptr<LayerTree> LayerReader::ReadTree() {
+  if (!started_) {
+    started_ = true;
+    char magic[sizeof(kMagic)];
+    if (!ReadBytes(magic, sizeof(magic)) ||
+        memcmp(magic, kMagic, sizeof(kMagic)) != 0 ||
+        ReadUInt32() != kVersion) {
+      LOG(ERROR) << "Not a layer tree capture of version " << kVersion;
+      Fail();
+    }
+  }
+
+  if (failed_ || ended_)
+    return nullptr;
+
+  uint32_t record = ReadUInt32();
+  while (!failed_ && record == kReleasePicturesRecord) {
+    const uint32_t count = ReadUInt32();
+    for (uint32_t i = 0; i < count && !failed_; ++i) {
+      const uint32_t index = ReadUInt32();
+      if (index < pictures_.size() && pictures_[index])
+        pictures_[index] = nullptr;
+      else
+        Fail();
+    }
+    record = ReadUInt32();
+  }
+  if (failed_)
+    return nullptr;
+  if (record == kEndRecord) {
+    ended_ = true;
+    return nullptr;
+  }
+  if (record != kTreeRecord) {
+    Fail();
+    return nullptr;
+  }
+
+  arena_ = LayerArena::Create();
+  scoped_ptr<LayerTree> layer_tree(new LayerTree());
+  const uint32_t width = ReadUInt32();
+  const uint32_t height = ReadUInt32();
+  layer_tree->set_frame_size(SkISize::Make(width, height));
+  if (ReadUInt32())
+    layer_tree->set_root_layer(ReadLayer());
+  layer_tree->set_arena(arena_);
+  arena_ = nullptr;
+
+  if (failed_)
+    return nullptr;
+  return layer_tree.Pass();
+}
+
+std::shared_ptr<Layer> LayerReader::ReadLayer() {
+  if (failed_ || depth_ >= kMaxDepth) {
+    Fail();
+    return nullptr;
+  }
+
+  const uint32_t tag = ReadUInt32();
+  std::shared_ptr<Layer> layer;
+  switch (static_cast<LayerSignature::Tag>(tag)) {
+    case LayerSignature::Tag::ClipPath:
+      layer = MakeLayer<ClipPathLayer>(arena_);
+      break;
+    case LayerSignature::Tag::ClipRect:
+      layer = MakeLayer<ClipRectLayer>(arena_);
+      break;
+    case LayerSignature::Tag::ClipRRect:
+      layer = MakeLayer<ClipRRectLayer>(arena_);
+      break;
+    case LayerSignature::Tag::ColorFilter:
+      layer = MakeLayer<ColorFilterLayer>(arena_);
+      break;
+    case LayerSignature::Tag::Container:
+      layer = MakeLayer<ContainerLayer>(arena_);
+      break;
+    case LayerSignature::Tag::Opacity:
+      layer = MakeLayer<OpacityLayer>(arena_);
+      break;
+    case LayerSignature::Tag::Picture:
+      layer = MakeLayer<PictureLayer>(arena_);
+      break;
+    case LayerSignature::Tag::Shadow:
+      layer = MakeLayer<ShadowLayer>(arena_);
+      break;
+    case LayerSignature::Tag::Transform:
+      layer = MakeLayer<TransformLayer>(arena_);
+      break;
+    case LayerSignature::Tag::Scroll:
+      layer = MakeLayer<ScrollLayer>(arena_);
+      break;
+    case LayerSignature::Tag::Texture:
+      layer = MakeLayer<TextureLayer>(arena_);
+      break;
+  }
+  if (!layer || failed_) {
+    Fail();
+    return nullptr;
+  }
+
+  layer->set_paint_bounds(ReadRect());
+  ++depth_;
+  layer->Deserialize(this);
+  --depth_;
+  return failed_ ? nullptr : layer;
+}
+
+uint32_t LayerReader::ReadUInt32() {
+  uint32_t value = 0;
+  ReadBytes(&value, sizeof(value));
+  return value;
+}
+
+SkScalar LayerReader::ReadScalar() {
+  SkScalar value = 0;
+  ReadBytes(&value, sizeof(value));
+  return value;
+}
+
+SkPoint LayerReader::ReadPoint() {
+  SkScalar x = ReadScalar();
+  SkScalar y = ReadScalar();
+  return SkPoint::Make(x, y);
+}
+
+SkRect LayerReader::ReadRect() {
+  SkScalar left = ReadScalar();
+  SkScalar top = ReadScalar();
+  SkScalar right = ReadScalar();
+  SkScalar bottom = ReadScalar();
+  return SkRect::MakeLTRB(left, top, right, bottom);
+}
+
+SkRRect LayerReader::ReadRRect() {
+  SkRRect rrect;
+  char buffer[SkRRect::kSizeInMemory];
+  if (ReadBytes(buffer, sizeof(buffer)) &&
+      rrect.readFromMemory(buffer, sizeof(buffer)) != sizeof(buffer)) {
+    Fail();
+  }
+  return rrect;
+}
+
+SkMatrix LayerReader::ReadMatrix() {
+  SkScalar values[9];
+  for (int i = 0; i < 9; ++i)
+    values[i] = ReadScalar();
+  SkMatrix matrix;
+  matrix.set9(values);
+  return matrix;
+}
+
+SkPath LayerReader::ReadPath() {
+  SkPath path;
+  const uint32_t length = ReadUInt32();
+  std::vector<char> buffer(failed_ ? 0 : length);
+  if (ReadBytes(buffer.data(), length) &&
+      path.readFromMemory(buffer.data(), length) != length) {
+    Fail();
+  }
+  return path;
+}
+
+PassRefPtr<SkPicture> LayerReader::ReadPicture() {
+  const uint32_t index = ReadUInt32();
+  if (failed_)
+    return nullptr;
+  if (index < pictures_.size() && pictures_[index])
+    return pictures_[index];
+  if (index > pictures_.size()) {
+    Fail();
+    return nullptr;
+  }
+
+  const uint32_t length = ReadUInt32();
+  std::vector<char> buffer(failed_ ? 0 : length);
+  if (!ReadBytes(buffer.data(), length))
+    return nullptr;
+  SkMemoryStream picture_stream(buffer.data(), length);
+  RefPtr<SkPicture> picture =
+      adoptRef(SkPicture::CreateFromStream(&picture_stream));
+  if (!picture) {
+    Fail();
+    return nullptr;
+  }
+  if (index == pictures_.size())
+    pictures_.push_back(picture);
+  else
+    pictures_[index] = picture;
+  return picture.release();
+}
+
+bool LayerReader::ReadBytes(void* data, size_t length) {
+  if (failed_)
+    return false;
+  if (stream_->read(data, length) != length) {
+    Fail();
+    return false;
+  }
+  return true;
+}
+
+void LayerReader::Fail() {
+  failed_ = true;
+}
+
+}  // namespace compositor
+}  // namespace sky
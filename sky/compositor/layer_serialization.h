@@ -0,0 +1,144 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_LAYER_SERIALIZATION_H_
+#define SKY_COMPOSITOR_LAYER_SERIALIZATION_H_
+
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "sky/compositor/layer_signature.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefPtr.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPath.h"
+#include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPoint.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+class SkPixelSerializer;
+class SkStream;
+class SkWStream;
+
+namespace sky {
+namespace compositor {
+
+class Layer;
+class LayerArena;
+class LayerTree;
+
+// Writes a sequence of layer trees to a stream so that the frames can be
+// replayed later, for example to benchmark the compositor against real
+// workloads. Each picture is written once, however many frames draw it.
+//
+// The same format carries frames to a compositor in another process. There
+// the stream is split into one message per tree with SetStream, and
+// ReleaseUnusedPictures lets the reader free the pictures that are no longer
+// drawn, so that only the pictures that are new to a frame are sent with it.
+//
+// Layers serialize themselves. Each one begins with BeginLayer and then
+// writes the values its Deserialize reads back, in the same order.
+class LayerWriter {
+ public:
+  // |pixel_serializer| encodes the images in pictures and may be null, in
+  // which case images are written uncompressed.
+  LayerWriter(SkWStream* stream, SkPixelSerializer* pixel_serializer);
+  ~LayerWriter();
+
+  void WriteTree(const LayerTree& layer_tree);
+  // Marks the end of the stream. No trees may be written afterwards.
+  void Finish();
+
+  // Continues the stream on |stream|. Whatever was written to the previous
+  // one has to reach the reader first.
+  void SetStream(SkWStream* stream);
+
+  // Tells the reader to drop the pictures that no tree has drawn since the
+  // last call. Their indices are reused for later pictures, and a picture
+  // that is drawn again is written again.
+  void ReleaseUnusedPictures();
+
+  void WriteLayer(const Layer& layer);
+  void BeginLayer(LayerSignature::Tag tag, const Layer& layer);
+
+  void Write(uint32_t value);
+  void Write(SkScalar value);
+  void Write(const SkPoint& point);
+  void Write(const SkRect& rect);
+  void Write(const SkRRect& rrect);
+  void Write(const SkMatrix& matrix);
+  void Write(const SkPath& path);
+  void Write(SkPicture* picture);
+
+ private:
+  void WriteBytes(const void* data, size_t length);
+
+  SkWStream* stream_;
+  SkPixelSerializer* pixel_serializer_;
+  // Maps the unique ID of every picture the reader holds to its index.
+  std::map<uint32_t, uint32_t> picture_indices_;
+  // The unique IDs of the pictures drawn since ReleaseUnusedPictures.
+  std::set<uint32_t> used_pictures_;
+  uint32_t picture_count_;
+  // The indices of released pictures, which are handed out first.
+  std::vector<uint32_t> free_picture_indices_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerWriter);
+};
+
+// Reads the trees written by LayerWriter. Once a read fails, every later
+// read fails as well and ReadTree returns null.
+class LayerReader {
+ public:
+  explicit LayerReader(SkStream* stream);
+  ~LayerReader();
+
+  // Returns null at the end of the stream or if it is malformed.
+  scoped_ptr<LayerTree> ReadTree();
+
+  // Continues reading on |stream|, for streams that arrive in messages.
+  void SetStream(SkStream* stream);
+
+  bool failed() const { return failed_; }
+
+  // The layers of the tree being read are allocated from this arena.
+  const std::shared_ptr<LayerArena>& arena() const { return arena_; }
+
+  std::shared_ptr<Layer> ReadLayer();
+
+  uint32_t ReadUInt32();
+  SkScalar ReadScalar();
+  SkPoint ReadPoint();
+  SkRect ReadRect();
+  SkRRect ReadRRect();
+  SkMatrix ReadMatrix();
+  SkPath ReadPath();
+  // Never returns null unless the read fails.
+  PassRefPtr<SkPicture> ReadPicture();
+
+ private:
+  bool ReadBytes(void* data, size_t length);
+  void Fail();
+
+  SkStream* stream_;
+  bool started_;
+  bool failed_;
+  bool ended_;
+  int depth_;
+  std::shared_ptr<LayerArena> arena_;
+  // Released pictures leave null entries until their index is reused.
+  std::vector<RefPtr<SkPicture>> pictures_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerReader);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_LAYER_SERIALIZATION_H_
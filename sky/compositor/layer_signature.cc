@@ -0,0 +1,56 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/layer_signature.h"
+
+namespace sky {
+namespace compositor {
+
+static const uint64_t kFNVOffsetBasis = 14695981039346656037ULL;
+static const uint64_t kFNVPrime = 1099511628211ULL;
+
+LayerSignature::LayerSignature() : value_(kFNVOffsetBasis) {
+}
+
+LayerSignature::~LayerSignature() {
+}
+
+void LayerSignature::Add(const void* data, size_t length) {
+  const uint8_t* bytes = static_cast<const uint8_t*>(data);
+  for (size_t i = 0; i < length; ++i) {
+    value_ ^= bytes[i];
+    value_ *= kFNVPrime;
+  }
+}
+
+void LayerSignature::Add(const SkPoint& point) {
+  Add(point.x());
+  Add(point.y());
+}
+
+void LayerSignature::Add(const SkRect& rect) {
+  Add(rect.left());
+  Add(rect.top());
+  Add(rect.right());
+  Add(rect.bottom());
+}
+
+void LayerSignature::Add(const SkRRect& rrect) {
+  Add(rrect.getBounds());
+  Add(rrect.radii(SkRRect::kUpperLeft_Corner));
+  Add(rrect.radii(SkRRect::kUpperRight_Corner));
+  Add(rrect.radii(SkRRect::kLowerRight_Corner));
+  Add(rrect.radii(SkRRect::kLowerLeft_Corner));
+}
+
+void LayerSignature::Add(const SkMatrix& matrix) {
+  // Only the nine values matter. SkMatrix also caches a type mask that can
+  // differ between otherwise equal matrices.
+  SkScalar values[9];
+  matrix.get9(values);
+  Add(values, sizeof(values));
+}
+
+}  // namespace compositor
+}  // namespace sky
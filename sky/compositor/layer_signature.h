@@ -0,0 +1,72 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_LAYER_SIGNATURE_H_
+#define SKY_COMPOSITOR_LAYER_SIGNATURE_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPoint.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkRRect.h"
+
+namespace sky {
+namespace compositor {
+
+// Accumulates a 64-bit FNV-1a hash over everything that affects how a layer
+// subtree paints. Layer trees are rebuilt from scratch every frame, so the
+// signature is what identifies the same contents across frames.
+class LayerSignature {
+ public:
+  LayerSignature();
+  ~LayerSignature();
+
+  // Distinguishes layer types that would otherwise add identical values.
+  enum class Tag : uint32_t {
+    ClipPath,
+    ClipRect,
+    ClipRRect,
+    ColorFilter,
+    Container,
+    Opacity,
+    Picture,
+    Shadow,
+    Transform,
+    Scroll,
+    Texture,
+  };
+
+  uint64_t value() const { return value_; }
+
+  void Add(Tag tag) { Add(static_cast<uint32_t>(tag)); }
+
+  void Add(const void* data, size_t length);
+
+  void Add(uint32_t value) { Add(&value, sizeof(value)); }
+
+  void Add(uint64_t value) { Add(&value, sizeof(value)); }
+
+  void Add(SkScalar value) { Add(&value, sizeof(value)); }
+
+  void Add(const SkPoint& point);
+
+  void Add(const SkRect& rect);
+
+  void Add(const SkRRect& rrect);
+
+  void Add(const SkMatrix& matrix);
+
+ private:
+  uint64_t value_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerSignature);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_LAYER_SIGNATURE_H_
@@ -4,16 +4,75 @@
 
 #include "sky/compositor/layer_tree.h"
 
+#include "base/trace_event/trace_event.h"
+#include "sky/compositor/damage_tracker.h"
 #include "sky/compositor/layer.h"
 
 namespace sky {
 namespace compositor {
 
-LayerTree::LayerTree() {
+LayerTree::LayerTree()
+    : frame_number_(0), debug_flags_(0), animations_running_(false) {
 }
 
 LayerTree::~LayerTree() {
 }
 
+base::TimeTicks LayerTree::AnimationTime() const {
+  return target_time_.is_null() ? base::TimeTicks::Now() : target_time_;
+}
+
+SkIRect LayerTree::Preroll(PaintContext::ScopedFrame& frame) {
+  TRACE_EVENT1("sky", "LayerTree::Preroll", "frame", frame_number_);
+
+  SkCanvas& canvas = frame.canvas();
+
+  SkIRect device_clip;
+  if (!canvas.getClipDeviceBounds(&device_clip))
+    return SkIRect::MakeEmpty();
+
+  PaintContext& paint_context = frame.paint_context();
+  DamageTracker& damage_tracker = paint_context.damage_tracker();
+
+  if (!construction_time_.is_zero())
+    paint_context.RecordBuildTime(construction_time_);
+
+  if (root_layer_) {
+    Layer::PrerollContext context = {frame,
+                                     SkRect::Make(device_clip),
+                                     true,
+                                     &damage_tracker,
+                                     0,
+                                     1,
+                                     SkRect::MakeEmpty(),
+                                     true,
+                                     AnimationTime(),
+                                     false};
+    root_layer_->Preroll(&context, canvas.getTotalMatrix());
+    paint_context.RecordLayerCount(context.layer_count);
+    animations_running_ = context.animations_running;
+  }
+
+  // Statistics and visualizations are drawn on top of the frame outside of
+  // any layer, or change from frame to frame, so the damage only accounts
+  // for them by repainting everything.
+  if (paint_context.options().hasFrameOverlays())
+    damage_tracker.Invalidate();
+
+  return damage_tracker.ComputeDamage(device_clip);
+}
+
+void LayerTree::Paint(PaintContext::ScopedFrame& frame) {
+  TRACE_EVENT1("sky", "LayerTree::Paint", "frame", frame_number_);
+
+  if (root_layer_)
+    root_layer_->Paint(frame);
+}
+
+void LayerTree::Raster(PaintContext::ScopedFrame& frame) {
+  Preroll(frame);
+  Paint(frame);
+}
+
 }  // namespace compositor
 }  // namespace sky
@@ -8,7 +8,9 @@
 #include <memory>
 
 #include "base/macros.h"
+#include "base/time/time.h"
 #include "sky/compositor/layer.h"
+#include "sky/compositor/layer_arena.h"
 #include "third_party/skia/include/core/SkSize.h"
 
 namespace sky {
@@ -21,17 +23,92 @@ class LayerTree {
 
   Layer* root_layer() const { return root_layer_.get(); }
 
-  void set_root_layer(std::unique_ptr<Layer> root_layer) {
+  void set_root_layer(std::shared_ptr<Layer> root_layer) {
     root_layer_ = std::move(root_layer);
   }
 
+  // Prerolls the tree and returns the device space rect that differs from
+  // the previous frame painted with the same PaintContext.
+  SkIRect Preroll(PaintContext::ScopedFrame& frame);
+
+  // Paints the tree into the frame's canvas. Must follow Preroll.
+  void Paint(PaintContext::ScopedFrame& frame);
+
+  // Prerolls and then paints the whole tree into the frame's canvas.
+  void Raster(PaintContext::ScopedFrame& frame);
+
+  // The arena the layers of this tree were allocated from, if any. Keeping
+  // it here ties the lifetime of the arena to the tree.
+  void set_arena(std::shared_ptr<LayerArena> arena) {
+    arena_ = std::move(arena);
+  }
+
   const SkISize& frame_size() const { return frame_size_; }
 
   void set_frame_size(const SkISize& frame_size) { frame_size_ = frame_size; }
 
+  // Identifies the frame this tree was built for in traces and frame
+  // timings. Frame numbers start at 1, 0 means unknown.
+  uint64_t frame_number() const { return frame_number_; }
+
+  void set_frame_number(uint64_t frame_number) {
+    frame_number_ = frame_number;
+  }
+
+  // The time the frame this tree belongs to was started, usually the vsync
+  // time. Null if unknown.
+  const base::TimeTicks& frame_time() const { return frame_time_; }
+
+  void set_frame_time(base::TimeTicks frame_time) { frame_time_ = frame_time; }
+
+  // When the frame is meant to be on screen, usually the vsync after
+  // |frame_time|. Null if unknown.
+  const base::TimeTicks& target_time() const { return target_time_; }
+
+  void set_target_time(base::TimeTicks target_time) {
+    target_time_ = target_time;
+  }
+
+  // When the UI thread started building this tree.
+  const base::TimeTicks& build_start_time() const { return build_start_time_; }
+
+  void set_build_start_time(base::TimeTicks build_start_time) {
+    build_start_time_ = build_start_time;
+  }
+
+  // The time it took to build this tree on the UI thread.
+  const base::TimeDelta& construction_time() const {
+    return construction_time_;
+  }
+
+  void set_construction_time(const base::TimeDelta& delta) {
+    construction_time_ = delta;
+  }
+
+  // The CompositorOptions::DebugFlag values the app asked this tree to be
+  // painted with.
+  uint32_t debug_flags() const { return debug_flags_; }
+
+  void set_debug_flags(uint32_t debug_flags) { debug_flags_ = debug_flags; }
+
+  // Whether the last preroll found animations that go on after the frame,
+  // so that the tree has to be drawn again for the next one.
+  bool animations_running() const { return animations_running_; }
+
+  // The time animations are prerolled for, the target time if there is one.
+  base::TimeTicks AnimationTime() const;
+
  private:
   SkISize frame_size_;  // Physical pixels.
-  std::unique_ptr<Layer> root_layer_;
+  uint64_t frame_number_;
+  base::TimeTicks frame_time_;
+  base::TimeTicks target_time_;
+  base::TimeTicks build_start_time_;
+  base::TimeDelta construction_time_;
+  uint32_t debug_flags_;
+  bool animations_running_;
+  std::shared_ptr<Layer> root_layer_;
+  std::shared_ptr<LayerArena> arena_;
 
   DISALLOW_COPY_AND_ASSIGN(LayerTree);
 };
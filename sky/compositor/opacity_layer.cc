@@ -4,26 +4,73 @@
 
 #include "sky/compositor/opacity_layer.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
 namespace sky {
 namespace compositor {
 
-OpacityLayer::OpacityLayer() {
+OpacityLayer::OpacityLayer() : alpha_(255) {
 }
 
 OpacityLayer::~OpacityLayer() {
 }
 
+void OpacityLayer::set_alpha_animation(
+    std::shared_ptr<const LayerAnimation> animation) {
+  alpha_animation_ = std::move(animation);
+  if (alpha_animation_)
+    SetHasAnimations();
+}
+
+void OpacityLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  if (alpha_animation_) {
+    const float alpha = alpha_animation_->ValueAt(context->animation_time);
+    alpha_ = std::min(std::max<int>(std::lround(alpha), 0), 255);
+    if (alpha_animation_->IsRunningAt(context->animation_time))
+      context->animations_running = true;
+  }
+
+  // The alpha is not part of the children's signature, so fading a stable
+  // subtree in or out only composites the cached image.
+  PrerollChildrenWithRasterCache(context, matrix);
+}
+
 void OpacityLayer::Paint(PaintContext::ScopedFrame& frame) {
   SkColor color = SkColorSetARGB(alpha_, 0, 0, 0);
   RefPtr<SkColorFilter> colorFilter = adoptRef(
       SkColorFilter::CreateModeFilter(color, SkXfermode::kSrcOver_Mode));
   SkPaint paint;
   paint.setColorFilter(colorFilter.get());
+
+  if (PaintCachedChildren(frame, paint))
+    return;
+
   SkCanvas& canvas = frame.canvas();
   canvas.saveLayer(&paint_bounds(), &paint);
   PaintChildren(frame);
   canvas.restore();
 }
 
+void OpacityLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::Opacity);
+  signature->Add(static_cast<uint32_t>(alpha_));
+  signature->Add(paint_bounds());
+}
+
+void OpacityLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::Opacity, *this);
+  writer->Write(static_cast<uint32_t>(alpha_));
+  SerializeChildren(writer);
+}
+
+void OpacityLayer::Deserialize(LayerReader* reader) {
+  alpha_ = std::min<uint32_t>(reader->ReadUInt32(), 255);
+  DeserializeChildren(reader);
+}
+
 }  // namespace compositor
 }  // namespace sky
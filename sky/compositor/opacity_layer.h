@@ -5,7 +5,10 @@
 #ifndef SKY_COMPOSITOR_OPACITY_LAYER_H_
 #define SKY_COMPOSITOR_OPACITY_LAYER_H_
 
+#include <memory>
+
 #include "sky/compositor/container_layer.h"
+#include "sky/compositor/layer_animation.h"
 
 namespace sky {
 namespace compositor {
@@ -17,11 +20,24 @@ class OpacityLayer : public ContainerLayer {
 
   void set_alpha(int alpha) { alpha_ = alpha; }
 
+  // Replaces the alpha with the value of |animation|, from 0 to 255, at the
+  // time every frame is shown.
+  void set_alpha_animation(std::shared_ptr<const LayerAnimation> animation);
+
  protected:
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext::ScopedFrame& frame) override;
 
+  void AppendStateSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
  private:
   int alpha_;
+  std::shared_ptr<const LayerAnimation> alpha_animation_;
 
   DISALLOW_COPY_AND_ASSIGN(OpacityLayer);
 };
@@ -0,0 +1,133 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/overdraw_visualizer.h"
+
+#include <algorithm>
+
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "third_party/skia/include/core/SkColorFilter.h"
+#include "third_party/skia/include/core/SkDrawFilter.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/effects/SkColorMatrixFilter.h"
+#include "third_party/skia/include/effects/SkTableColorFilter.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/utils/SkNWayCanvas.h"
+
+namespace sky {
+namespace compositor {
+namespace {
+
+// Every draw adds this much to the color channels of the pixels it covers,
+// so up to 255 / kCountStep draws can be told apart.
+const int kCountStep = 16;
+
+// Indexed by the number of times a pixel was drawn. The last color is used
+// for every larger count.
+const SkColor kOverdrawColors[] = {
+    SK_ColorTRANSPARENT,
+    SK_ColorTRANSPARENT,
+    SkColorSetARGB(0x80, 0x00, 0x00, 0xFF),
+    SkColorSetARGB(0x80, 0x00, 0xFF, 0x00),
+    SkColorSetARGB(0x80, 0xFF, 0x80, 0xC0),
+    SkColorSetARGB(0x80, 0xFF, 0x00, 0x00),
+};
+
+// Replaces whatever a draw would put into the counting surface with one
+// more count for every pixel it covers. Shapes and glyphs keep their
+// coverage, while images count over their whole rect.
+class OverdrawCounter : public SkDrawFilter {
+ public:
+  OverdrawCounter()
+      : count_filter_(adoptRef(SkColorFilter::CreateModeFilter(
+            SkColorSetARGB(0xFF, kCountStep, kCountStep, kCountStep),
+            SkXfermode::kSrc_Mode))) {}
+
+  bool filter(SkPaint* paint, Type type) override {
+    paint->setColorFilter(count_filter_.get());
+    paint->setImageFilter(nullptr);
+    paint->setXfermodeMode(SkXfermode::kPlus_Mode);
+    return true;
+  }
+
+ private:
+  RefPtr<SkColorFilter> count_filter_;
+};
+
+// Maps the counts to kOverdrawColors. Counted pixels are opaque, so the
+// count is first copied into the alpha channel, which makes the tables see
+// the same count in every channel.
+PassRefPtr<SkColorFilter> CreateHeatmapFilter() {
+  SkColorMatrix matrix;
+  matrix.setIdentity();
+  matrix.fMat[SkColorMatrix::kA_Scale] = 0;
+  matrix.fMat[15] = 1;
+  RefPtr<SkColorFilter> count_to_alpha =
+      adoptRef(SkColorMatrixFilter::Create(matrix));
+
+  uint8_t a[256], r[256], g[256], b[256];
+  const size_t max_count = arraysize(kOverdrawColors) - 1;
+  for (int value = 0; value < 256; ++value) {
+    const size_t count = std::min<size_t>(
+        (value + kCountStep / 2) / kCountStep, max_count);
+    const SkColor color = kOverdrawColors[count];
+    a[value] = SkColorGetA(color);
+    r[value] = SkColorGetR(color);
+    g[value] = SkColorGetG(color);
+    b[value] = SkColorGetB(color);
+  }
+  RefPtr<SkColorFilter> heatmap =
+      adoptRef(SkTableColorFilter::CreateARGB(a, r, g, b));
+
+  return adoptRef(
+      SkColorFilter::CreateComposeFilter(heatmap.get(), count_to_alpha.get()));
+}
+
+}  // namespace
+
+OverdrawVisualizer::OverdrawVisualizer(SkCanvas* frame_canvas,
+                                       GrContext* gr_context)
+    : frame_canvas_(frame_canvas) {
+  const SkISize size = frame_canvas->getBaseLayerSize();
+  if (gr_context) {
+    count_surface_ = adoptRef(SkSurface::NewRenderTarget(
+        gr_context, SkSurface::kYes_Budgeted,
+        SkImageInfo::MakeN32Premul(size.width(), size.height())));
+  }
+  if (!count_surface_)
+    return;
+
+  SkCanvas* count_canvas = count_surface_->getCanvas();
+  count_canvas->clear(SK_ColorTRANSPARENT);
+  RefPtr<SkDrawFilter> counter = adoptRef(new OverdrawCounter());
+  count_canvas->setDrawFilter(counter.get());
+
+  canvas_.reset(new SkNWayCanvas(size.width(), size.height()));
+  canvas_->addCanvas(frame_canvas);
+  canvas_->addCanvas(count_canvas);
+}
+
+OverdrawVisualizer::~OverdrawVisualizer() {
+}
+
+SkCanvas* OverdrawVisualizer::canvas() const {
+  return canvas_.get();
+}
+
+void OverdrawVisualizer::Composite() {
+  if (!canvas_)
+    return;
+
+  // The snapshot is drawn through the filter, which is gone by then.
+  count_surface_->getCanvas()->setDrawFilter(nullptr);
+  RefPtr<SkImage> counts = adoptRef(count_surface_->newImageSnapshot());
+  RefPtr<SkColorFilter> heatmap = CreateHeatmapFilter();
+  SkPaint paint;
+  paint.setColorFilter(heatmap.get());
+  frame_canvas_->drawImage(counts.get(), 0, 0, &paint);
+  canvas_.reset();
+}
+
+}  // namespace compositor
+}  // namespace sky
@@ -0,0 +1,49 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_OVERDRAW_VISUALIZER_H_
+#define SKY_COMPOSITOR_OVERDRAW_VISUALIZER_H_
+
+#include <memory>
+
+#include "base/macros.h"
+#include "sky/engine/wtf/RefPtr.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkSurface.h"
+
+class GrContext;
+class SkNWayCanvas;
+
+namespace sky {
+namespace compositor {
+
+// Counts how many times every pixel of a frame is drawn, for
+// CompositorOptions::Option::VisualizeOverdraw. Everything drawn into
+// canvas() is drawn into the frame's canvas as usual, and also counted in
+// an offscreen surface. Composite() then tints the frame by the counts.
+class OverdrawVisualizer {
+ public:
+  OverdrawVisualizer(SkCanvas* frame_canvas, GrContext* gr_context);
+  ~OverdrawVisualizer();
+
+  // The canvas to draw the frame into instead of the frame's canvas, or
+  // null if there is no memory to count in.
+  SkCanvas* canvas() const;
+
+  // Tints the frame's canvas by the counts of what was drawn into canvas(),
+  // which must have all of its saves restored.
+  void Composite();
+
+ private:
+  SkCanvas* frame_canvas_;
+  RefPtr<SkSurface> count_surface_;
+  std::unique_ptr<SkNWayCanvas> canvas_;
+
+  DISALLOW_COPY_AND_ASSIGN(OverdrawVisualizer);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_OVERDRAW_VISUALIZER_H_
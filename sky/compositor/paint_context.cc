@@ -4,12 +4,22 @@
 
 #include "sky/compositor/paint_context.h"
 #include "base/logging.h"
+#include "base/trace_event/trace_event.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+#include <algorithm>
+#include <iomanip>
 
 namespace sky {
 namespace compositor {
 
-PaintContext::PaintContext() {
+PaintContext::PaintContext()
+    : texture_pool_(new TexturePool()),
+      texture_registry_(new TextureRegistry()),
+      gpu_tracer_(nullptr),
+      reported_cache_hits_(0),
+      reported_cache_fills_(0) {
 }
 
 void PaintContext::beginFrame(ScopedFrame& frame) {
@@ -18,12 +28,68 @@ void PaintContext::beginFrame(ScopedFrame& frame) {
 }
 
 void PaintContext::endFrame(ScopedFrame& frame) {
-  rasterizer_.PurgeCache();
+  rasterizer_.PurgeCache(options_.rasterCacheByteBudget());
   frame_time_.stop();
+  raster_times_.Add(frame_time_.lastLap());
+
+  const base::TimeDelta budget = instrumentation::FrameBudget();
+  TRACE_COUNTER1("sky", "RasterTimeUs", frame_time_.lastLap().InMicroseconds());
+  TRACE_COUNTER2("sky", "MissedFrames", "build",
+                 build_times_.CountOver(budget), "raster",
+                 raster_times_.CountOver(budget));
+
+  if (frame.gr_context()) {
+    int resource_count = 0;
+    size_t resource_bytes = 0;
+    frame.gr_context()->getResourceCacheUsage(&resource_count,
+                                              &resource_bytes);
+    gpu_resource_bytes_.reset(resource_bytes);
+  }
+  TRACE_COUNTER2("sky", "GPUMemoryBytes", "ganesh",
+                 gpu_resource_bytes_.count(), "raster_cache",
+                 rasterizer_.cache_bytes().count());
+  TRACE_COUNTER1("sky", "TexturePoolIdleBytes", texture_pool_->idle_bytes());
+
+  const size_t cache_hits = rasterizer_.cache_hits().count();
+  const size_t cache_fills = rasterizer_.cache_fills().count();
+  TRACE_COUNTER2("sky", "RasterCacheUse", "hits",
+                 cache_hits - reported_cache_hits_, "fills",
+                 cache_fills - reported_cache_fills_);
+  reported_cache_hits_ = cache_hits;
+  reported_cache_fills_ = cache_fills;
 
   DisplayStatistics(frame);
 }
 
+void PaintContext::RecordBuildTime(base::TimeDelta build_time) {
+  build_times_.Add(build_time);
+  TRACE_COUNTER1("sky", "BuildTimeUs", build_time.InMicroseconds());
+}
+
+void PaintContext::RecordLayerCount(size_t layer_count) {
+  layer_count_.reset(layer_count);
+  TRACE_COUNTER1("sky", "LayerCount", layer_count);
+}
+
+void PaintContext::RecordGPUTime(base::TimeDelta gpu_time) {
+  gpu_times_.Add(gpu_time);
+  TRACE_COUNTER1("sky", "GPUTimeUs", gpu_time.InMicroseconds());
+}
+
+void PaintContext::RecordFrameTiming(
+    const instrumentation::FrameTiming& timing) {
+  const base::TimeDelta latency = timing.TotalLatency();
+  presentation_latencies_.Add(latency);
+  TRACE_COUNTER1("sky", "PresentationLatencyUs", latency.InMicroseconds());
+  TRACE_EVENT_INSTANT2("sky", "FrameTiming", TRACE_EVENT_SCOPE_THREAD,
+                       "frame", timing.frame_number, "latency_us",
+                       latency.InMicroseconds());
+
+  frame_timings_.push_back(timing);
+  if (frame_timings_.size() > instrumentation::FrameTimeHistory::kMaxSamples)
+    frame_timings_.pop_front();
+}
+
 static void PaintContext_DrawStatisticsText(SkCanvas& canvas,
                                             const std::string& string,
                                             int x,
@@ -35,6 +101,56 @@ static void PaintContext_DrawStatisticsText(SkCanvas& canvas,
   canvas.drawText(string.c_str(), string.size(), x, y, paint);
 }
 
+// Build p50/p90/p99: 1.20/2.31/8.02ms Missed: 1
+static std::string PaintContext_DescribeHistory(
+    const char* name,
+    const instrumentation::FrameTimeHistory& history,
+    bool show_missed) {
+  std::stringstream stream;
+  stream << name << " p50/p90/p99: " << std::fixed << std::setprecision(2)
+         << history.Percentile(50).InMillisecondsF() << "/"
+         << history.Percentile(90).InMillisecondsF() << "/"
+         << history.Percentile(99).InMillisecondsF() << "ms";
+  if (show_missed) {
+    stream << " Missed: "
+           << history.CountOver(instrumentation::FrameBudget());
+  }
+  return stream.str();
+}
+
+// Draws one bar per sample in |history|, scaled so that twice the frame
+// budget fills |height|. Samples over budget are drawn in red.
+static void PaintContext_DrawHistoryGraph(
+    SkCanvas& canvas,
+    const instrumentation::FrameTimeHistory& history,
+    int x,
+    int y,
+    int height) {
+  static const int kBarWidth = 2;
+  const double budget_ms = instrumentation::FrameBudget().InMillisecondsF();
+  const double scale = height / (2 * budget_ms);
+  const int width =
+      instrumentation::FrameTimeHistory::kMaxSamples * kBarWidth;
+
+  SkPaint paint;
+  paint.setColor(SkColorSetARGB(0x80, 0xFF, 0xFF, 0xFF));
+  canvas.drawRect(SkRect::MakeXYWH(x, y, width, height), paint);
+
+  for (size_t i = 0; i < history.size(); ++i) {
+    const double sample_ms = history.sample(i).InMillisecondsF();
+    const SkScalar bar_height = std::min<double>(sample_ms * scale, height);
+    paint.setColor(sample_ms > budget_ms ? SK_ColorRED : SK_ColorGREEN);
+    canvas.drawRect(SkRect::MakeXYWH(x + i * kBarWidth,
+                                     y + height - bar_height, kBarWidth,
+                                     bar_height),
+                    paint);
+  }
+
+  // The budget line sits half way up the graph.
+  paint.setColor(SK_ColorBLACK);
+  canvas.drawLine(x, y + height / 2, x + width, y + height / 2, paint);
+}
+
 void PaintContext::DisplayStatistics(ScopedFrame& frame) {
   // TODO: We just draw text text on the top left corner for now. Make this
   // better
@@ -49,27 +165,88 @@ void PaintContext::DisplayStatistics(ScopedFrame& frame) {
            << "): " << frame_time_.lastLap().InMillisecondsF() << "ms";
     PaintContext_DrawStatisticsText(frame.canvas(), stream.str(), x, y);
     y += kLineSpacing;
+
+    PaintContext_DrawStatisticsText(
+        frame.canvas(),
+        PaintContext_DescribeHistory("Build", build_times_, true), x, y);
+    y += kLineSpacing;
+    PaintContext_DrawStatisticsText(
+        frame.canvas(),
+        PaintContext_DescribeHistory("Raster", raster_times_, true), x, y);
+    y += kLineSpacing;
+    PaintContext_DrawStatisticsText(
+        frame.canvas(),
+        PaintContext_DescribeHistory("Latency", presentation_latencies_,
+                                     false),
+        x, y);
+    y += kLineSpacing;
+    if (gpu_times_.size()) {
+      PaintContext_DrawStatisticsText(
+          frame.canvas(), PaintContext_DescribeHistory("GPU", gpu_times_, true),
+          x, y);
+      y += kLineSpacing;
+    }
+
+    // Raster time of the recent frames.
+    static const int kGraphHeight = 48;
+    y -= kLineSpacing / 2;
+    PaintContext_DrawHistoryGraph(frame.canvas(), raster_times_, x, y,
+                                  kGraphHeight);
+    y += kGraphHeight + kLineSpacing;
   }
 
   if (options_.isEnabled(
           CompositorOptions::Option::DisplayRasterizerStatistics)) {
-    // Rasterizer: Hits: 2 Misses: 4 Evictions: 8
+    // Rasterizer: Hits: 2 Misses: 4 Evictions: 8 Bytes: 1.25/32.00MB
+    static const double kBytesPerMegabyte = 1024.0 * 1024.0;
     std::stringstream stream;
     stream << "Rasterizer Hits: " << rasterizer_.cache_hits().count()
            << " Fills: " << rasterizer_.cache_fills().count()
-           << " Evictions: " << rasterizer_.cache_evictions().count();
+           << " Evictions: " << rasterizer_.cache_evictions().count()
+           << " Bytes: " << std::fixed << std::setprecision(2)
+           << rasterizer_.cache_bytes().count() / kBytesPerMegabyte << "/"
+           << options_.rasterCacheByteBudget() / kBytesPerMegabyte << "MB";
     PaintContext_DrawStatisticsText(frame.canvas(), stream.str(), x, y);
     y += kLineSpacing;
+
+    // GPU Ganesh: 24.50MB Pool: 4.00MB
+    std::stringstream gpu_stream;
+    gpu_stream << "GPU Ganesh: " << std::fixed << std::setprecision(2)
+               << gpu_resource_bytes_.count() / kBytesPerMegabyte << "MB"
+               << " Pool: "
+               << texture_pool_->idle_bytes() / kBytesPerMegabyte << "MB";
+    PaintContext_DrawStatisticsText(frame.canvas(), gpu_stream.str(), x, y);
+    y += kLineSpacing;
   }
 }
 
-PaintContext::ScopedFrame PaintContext::AcquireFrame(SkCanvas& canvas,
-                                                     GrContext* gr_context) {
-  return ScopedFrame(*this, canvas, gr_context);
+CompositorStatistics PaintContext::GetStatistics() {
+  CompositorStatistics statistics;
+  statistics.frame_count = frame_count_.count();
+  statistics.last_raster_time = raster_times_.last();
+  statistics.raster_time_p90 = raster_times_.Percentile(90);
+  statistics.missed_raster_frames =
+      raster_times_.CountOver(instrumentation::FrameBudget());
+  statistics.build_time_p90 = build_times_.Percentile(90);
+  statistics.presentation_latency_p90 = presentation_latencies_.Percentile(90);
+  statistics.raster_cache_hits = rasterizer_.cache_hits().count();
+  statistics.raster_cache_fills = rasterizer_.cache_fills().count();
+  statistics.raster_cache_evictions = rasterizer_.cache_evictions().count();
+  statistics.raster_cache_bytes = rasterizer_.cache_bytes().count();
+  statistics.texture_pool_bytes = texture_pool_->idle_bytes();
+  statistics.gpu_resource_bytes = gpu_resource_bytes_.count();
+  statistics.layer_count = layer_count_.count();
+  return statistics;
+}
+
+PaintContext::ScopedFrame PaintContext::AcquireFrame(
+    SkCanvas& canvas,
+    GrContext* gr_context,
+    bool instrumentation_enabled) {
+  return ScopedFrame(*this, canvas, gr_context, instrumentation_enabled);
 }
 
 PaintContext::~PaintContext() {
-  rasterizer_.PurgeCache();
 }
 
 }  // namespace compositor
@@ -7,9 +7,18 @@
 
 #include "base/macros.h"
 #include "base/logging.h"
+#include "base/memory/ref_counted.h"
 #include "sky/compositor/compositor_options.h"
+#include "sky/compositor/compositor_statistics.h"
+#include "sky/compositor/damage_tracker.h"
+#include "sky/compositor/gpu_tracer.h"
 #include "sky/compositor/instrumentation.h"
 #include "sky/compositor/picture_rasterizer.h"
+#include "sky/compositor/scroll_controller.h"
+#include "sky/compositor/texture_pool.h"
+#include "sky/compositor/texture_registry.h"
+
+#include <deque>
 
 namespace sky {
 namespace compositor {
@@ -26,19 +35,30 @@ class PaintContext {
 
     ScopedFrame(ScopedFrame&& frame) = default;
 
-    ~ScopedFrame() { context_.endFrame(*this); }
+    ~ScopedFrame() {
+      if (instrumentation_enabled_)
+        context_.endFrame(*this);
+    }
 
    private:
     PaintContext& context_;
     SkCanvas& canvas_;
     GrContext* gr_context_;
+    const bool instrumentation_enabled_;
 
     ScopedFrame() = delete;
 
-    ScopedFrame(PaintContext& context, SkCanvas& canvas, GrContext* gr_context)
-        : context_(context), canvas_(canvas), gr_context_(gr_context) {
+    ScopedFrame(PaintContext& context,
+                SkCanvas& canvas,
+                GrContext* gr_context,
+                bool instrumentation_enabled)
+        : context_(context),
+          canvas_(canvas),
+          gr_context_(gr_context),
+          instrumentation_enabled_(instrumentation_enabled) {
       DCHECK(&canvas) << "The frame requries a valid canvas";
-      context_.beginFrame(*this);
+      if (instrumentation_enabled_)
+        context_.beginFrame(*this);
     };
 
     friend class PaintContext;
@@ -51,16 +71,98 @@ class PaintContext {
 
   PictureRasterzier& rasterizer() { return rasterizer_; }
 
+  // Textures for offscreen rasterization. Shared by all users of this
+  // context.
+  TexturePool& texture_pool() { return *texture_pool_; }
+
+  // The external textures TextureLayers draw. Shared with the threads that
+  // produce their frames.
+  TextureRegistry& texture_registry() { return *texture_registry_; }
+
   CompositorOptions& options() { return options_; };
 
-  ScopedFrame AcquireFrame(SkCanvas& canvas, GrContext* gr_context);
+  DamageTracker& damage_tracker() { return damage_tracker_; }
+
+  // Scrolls the ScrollLayers of the frames painted with this context.
+  ScrollController& scroll_controller() { return scroll_controller_; }
+
+  // When set, each picture layer's painting is timed on the GPU. Only meant
+  // for debugging, since every span flushes the GrContext.
+  GPUTracer* gpu_tracer() { return gpu_tracer_; }
+  void set_gpu_tracer(GPUTracer* gpu_tracer) { gpu_tracer_ = gpu_tracer; }
+
+  // Time the GPU spent on a frame, as measured by timer queries.
+  void RecordGPUTime(base::TimeDelta gpu_time);
+
+  // The number of layers in the tree of the frame being painted.
+  void RecordLayerCount(size_t layer_count);
+
+  // Time the UI thread spent building the layer tree of a frame.
+  void RecordBuildTime(base::TimeDelta build_time);
+
+  // Records where the time of a frame went once it has been handed to the
+  // display. Also feeds the presentation latency history.
+  void RecordFrameTiming(const instrumentation::FrameTiming& timing);
+
+  // The timings of the most recently presented frames, oldest first.
+  const std::deque<instrumentation::FrameTiming>& frame_timings() const {
+    return frame_timings_;
+  }
+
+  const instrumentation::FrameTimeHistory& build_times() const {
+    return build_times_;
+  }
+
+  const instrumentation::FrameTimeHistory& raster_times() const {
+    return raster_times_;
+  }
+
+  const instrumentation::FrameTimeHistory& presentation_latencies() const {
+    return presentation_latencies_;
+  }
+
+  const instrumentation::FrameTimeHistory& gpu_times() const {
+    return gpu_times_;
+  }
+
+  // The number of bytes held by the GrContext's resource cache at the end of
+  // the last frame.
+  const instrumentation::Counter& gpu_resource_bytes() const {
+    return gpu_resource_bytes_;
+  }
+
+  // Everything above, summarized for readers on other threads.
+  CompositorStatistics GetStatistics();
+
+  // Frames acquired with |instrumentation_enabled| set to false do not count
+  // as frames. They are used to paint layers into offscreen canvases while
+  // another frame is in progress.
+  ScopedFrame AcquireFrame(SkCanvas& canvas,
+                           GrContext* gr_context,
+                           bool instrumentation_enabled = true);
 
  private:
+  scoped_refptr<TexturePool> texture_pool_;
+  scoped_refptr<TextureRegistry> texture_registry_;
   PictureRasterzier rasterizer_;
   CompositorOptions options_;
+  DamageTracker damage_tracker_;
+  ScrollController scroll_controller_;
+  GPUTracer* gpu_tracer_;
 
   instrumentation::Counter frame_count_;
   instrumentation::Stopwatch frame_time_;
+  instrumentation::FrameTimeHistory build_times_;
+  instrumentation::FrameTimeHistory raster_times_;
+  instrumentation::FrameTimeHistory presentation_latencies_;
+  instrumentation::FrameTimeHistory gpu_times_;
+  std::deque<instrumentation::FrameTiming> frame_timings_;
+  instrumentation::Counter gpu_resource_bytes_;
+  instrumentation::Counter layer_count_;
+  // The raster cache's totals as of the last frame, so that each frame can
+  // trace its own share.
+  size_t reported_cache_hits_;
+  size_t reported_cache_fills_;
 
   void beginFrame(ScopedFrame& frame);
   void endFrame(ScopedFrame& frame);
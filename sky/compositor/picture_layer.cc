@@ -3,39 +3,212 @@
 // found in the LICENSE file.
 
 #include "sky/compositor/picture_layer.h"
+
+#include <algorithm>
+
 #include "base/logging.h"
+#include "base/time/time.h"
+#include "sky/compositor/damage_tracker.h"
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+#include "third_party/skia/include/core/SkRegion.h"
 
 namespace sky {
 namespace compositor {
+namespace {
+
+// Layers that take this much of the frame budget to paint are tinted red
+// by CompositorOptions::Option::VisualizeRasterTime.
+const int kRasterTimeBudgetFraction = 8;
+
+// Tints |rect| from green, for layers that painted in no time, to red, for
+// layers that used up their share of the frame budget.
+void PaintRasterTime(SkCanvas& canvas,
+                     const SkRect& rect,
+                     base::TimeDelta paint_time) {
+  const double budget =
+      FrameBudget().InMillisecondsF() / kRasterTimeBudgetFraction;
+  const double load = std::min(paint_time.InMillisecondsF() / budget, 1.0);
+  const U8CPU red = static_cast<U8CPU>(0xFF * load);
+
+  SkPaint paint;
+  paint.setColor(SkColorSetARGB(0x60, red, 0xFF - red, 0x00));
+  canvas.drawRect(rect, paint);
+}
 
-PictureLayer::PictureLayer() {
+}  // namespace
+
+PictureLayer::PictureLayer() : culled_(false), image_scaled_(false) {
 }
 
 PictureLayer::~PictureLayer() {
 }
 
+void PictureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  DCHECK(picture_);
+
+  SkMatrix ctm = matrix;
+  ctm.preTranslate(offset_.x(), offset_.y());
+
+  SkRect device_bounds;
+  ctm.mapRect(&device_bounds, picture_->cullRect());
+  culled_ = !device_bounds.intersect(context->cull_rect) ||
+            context->occluded_rect.contains(device_bounds);
+
+  if (!culled_ && context->damage_tracker) {
+    LayerSignature key;
+    key.Add(context->ancestor_state);
+    key.Add(ctm);
+    key.Add(picture_->uniqueID());
+    context->damage_tracker->AddRecord(key.value(), device_bounds);
+  }
+
+  image_ = nullptr;
+  image_scaled_ = false;
+  tiles_.clear();
+
+  if (culled_)
+    return;
+
+  PaintContext& paint_context = context->frame.paint_context();
+  PictureRasterzier& rasterizer = paint_context.rasterizer();
+
+  // Opaque pictures hide the layers under them, such as the page a route
+  // transition pushed this one over.
+  SkRect opaque_rect;
+  if (context->occlusion_enabled && ctm.rectStaysRect() &&
+      rasterizer.GetOpaqueRect(picture_.get(), &opaque_rect)) {
+    SkRect device_opaque_rect;
+    ctm.mapRect(&device_opaque_rect, opaque_rect);
+    // Fractional edges are antialiased, which leaves them translucent.
+    SkIRect covered_rect;
+    device_opaque_rect.roundIn(&covered_rect);
+    AddOccluder(context, SkRect::Make(covered_rect));
+  }
+
+  if (!context->raster_cache_enabled)
+    return;
+
+  const bool tiled = rasterizer.GetCachedTilesIfPresent(
+      paint_context, context->frame.gr_context(), picture_.get(), ctm,
+      context->cull_rect, &tiles_);
+  if (!tiled) {
+    image_ = rasterizer.GetCachedImageIfPresent(
+        paint_context, context->frame.gr_context(), picture_.get(), ctm,
+        &image_rect_);
+  }
+
+  // While the picture's scale changes, the exact scale misses the cache in
+  // every frame, so the nearest quantized scale is drawn instead.
+  bool cached = image_ != nullptr || !tiles_.empty();
+  for (const auto& tile : tiles_)
+    cached = cached && tile.image;
+  if (!cached) {
+    image_ = rasterizer.GetCachedScaledImageIfPresent(
+        paint_context, context->frame.gr_context(), picture_.get(), ctm,
+        context->cull_rect, &scaled_image_size_, &scaled_image_rect_);
+    if (image_) {
+      image_scaled_ = true;
+      tiles_.clear();
+    }
+  }
+}
+
+void PictureLayer::PaintTiles(SkCanvas& canvas) {
+  // Tiles are already in device space.
+  SkRegion missing;
+  canvas.save();
+  canvas.resetMatrix();
+  for (const auto& tile : tiles_) {
+    if (!tile.image) {
+      missing.op(tile.device_rect, SkRegion::kUnion_Op);
+      continue;
+    }
+    canvas.drawImageRect(
+        tile.image.get(),
+        SkRect::MakeIWH(tile.device_rect.width(), tile.device_rect.height()),
+        SkRect::Make(tile.device_rect), nullptr);
+  }
+  canvas.restore();
+
+  // The parts that are not rasterized yet are drawn from the picture.
+  if (!missing.isEmpty()) {
+    canvas.save();
+    canvas.clipRegion(missing);
+    canvas.translate(offset_.x(), offset_.y());
+    canvas.drawPicture(picture_.get());
+    canvas.restore();
+  }
+
+  tiles_.clear();
+}
+
 void PictureLayer::Paint(PaintContext::ScopedFrame& frame) {
   DCHECK(picture_);
 
+  if (culled_) {
+    return;
+  }
+
   SkCanvas& canvas = frame.canvas();
-  const SkRect& bounds = paint_bounds();
-  const SkMatrix& ctm = canvas.getTotalMatrix();
-  const SkISize physical_size = SkISize::Make(
-      bounds.width() * ctm.getScaleX(), bounds.height() * ctm.getScaleY());
-
-  PictureRasterzier& rasterizer = frame.paint_context().rasterizer();
-  RefPtr<SkImage> image = rasterizer.GetCachedImageIfPresent(
-      frame.paint_context(), frame.gr_context(), picture_.get(), physical_size,
-      ctm);
-
-  if (image) {
-    canvas.drawImage(image.get(), offset_.x(), offset_.y());
+  ScopedGPUSpan gpu_span(frame.paint_context().gpu_tracer(), "PictureLayer",
+                         picture_->uniqueID());
+  const base::TimeTicks paint_start = base::TimeTicks::Now();
+
+  if (!tiles_.empty()) {
+    PaintTiles(canvas);
+  } else if (image_) {
+    // The cached image is already in device space.
+    canvas.save();
+    canvas.resetMatrix();
+    if (image_scaled_) {
+      SkPaint paint;
+      paint.setFilterQuality(kLow_SkFilterQuality);
+      canvas.drawImageRect(image_.get(),
+                           SkRect::MakeIWH(scaled_image_size_.width(),
+                                           scaled_image_size_.height()),
+                           scaled_image_rect_, &paint);
+    } else {
+      canvas.drawImageRect(
+          image_.get(),
+          SkRect::MakeIWH(image_rect_.width(), image_rect_.height()),
+          SkRect::Make(image_rect_), nullptr);
+    }
+    canvas.restore();
+    image_ = nullptr;
   } else {
     canvas.save();
     canvas.translate(offset_.x(), offset_.y());
     canvas.drawPicture(picture_.get());
     canvas.restore();
   }
+
+  SkRect bounds = picture_->cullRect();
+  bounds.offset(offset_.x(), offset_.y());
+  if (frame.paint_context().options().isEnabled(
+          CompositorOptions::Option::VisualizeRasterTime)) {
+    // This is the time it took to record the draws for the GPU, which is
+    // what the layer costs the GPU thread.
+    PaintRasterTime(canvas, bounds, base::TimeTicks::Now() - paint_start);
+  }
+  PaintLayerBounds(frame, bounds);
+}
+
+void PictureLayer::AppendSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::Picture);
+  signature->Add(offset_);
+  signature->Add(picture_->uniqueID());
+}
+
+void PictureLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::Picture, *this);
+  writer->Write(offset_);
+  writer->Write(picture_.get());
+}
+
+void PictureLayer::Deserialize(LayerReader* reader) {
+  offset_ = reader->ReadPoint();
+  picture_ = reader->ReadPicture();
 }
 
 }  // namespace compositor
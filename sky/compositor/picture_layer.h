@@ -7,6 +7,8 @@
 
 #include "sky/compositor/layer.h"
 
+#include <vector>
+
 namespace sky {
 namespace compositor {
 
@@ -21,12 +23,34 @@ class PictureLayer : public Layer {
 
   SkPicture* picture() const { return picture_.get(); }
 
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
   void Paint(PaintContext::ScopedFrame& frame) override;
 
+  void AppendSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
  private:
+  void PaintTiles(SkCanvas& canvas);
+
   SkPoint offset_;
   RefPtr<SkPicture> picture_;
 
+  // Computed during preroll and consumed by the following paint.
+  bool culled_;
+  RefPtr<SkImage> image_;
+  SkIRect image_rect_;
+  // Set when |image_| was rasterized at a scale close to the layer's, in
+  // which case its top left |scaled_image_size_| part is drawn into
+  // |scaled_image_rect_| instead of |image_rect_|.
+  bool image_scaled_;
+  SkISize scaled_image_size_;
+  SkRect scaled_image_rect_;
+  std::vector<PictureRasterzier::Tile> tiles_;
+
   DISALLOW_COPY_AND_ASSIGN(PictureLayer);
 };
 
@@ -6,54 +6,68 @@
 #include "sky/compositor/checkerboard.h"
 #include "sky/compositor/picture_rasterizer.h"
 #include "sky/compositor/paint_context.h"
+#include "sky/compositor/texture_pool.h"
 #include "base/logging.h"
+#include "skia/ext/analysis_canvas.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "third_party/skia/include/gpu/GrContext.h"
 #include "third_party/skia/include/core/SkSurface.h"
 #include "third_party/skia/include/core/SkCanvas.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <vector>
+
 namespace sky {
 namespace compositor {
 
-PictureRasterzier::PictureRasterzier() {
+PictureRasterzier::PictureRasterzier()
+    : current_frame_(1), background_rasterizer_(nullptr) {
 }
 
 PictureRasterzier::~PictureRasterzier() {
 }
 
-static void ImageReleaseProc(SkImage::ReleaseContext texture) {
-  DCHECK(texture);
-  reinterpret_cast<GrTexture*>(texture)->unref();
-}
+PictureRasterzier::Key::Key(Kind knd, uint64_t ident, const SkMatrix& mat)
+    : kind(knd), id(ident), matrix(mat), tile(SkIPoint::Make(0, 0)){};
 
-PictureRasterzier::Key::Key(uint32_t ident, SkISize sz)
-    : pictureID(ident), size(sz){};
+PictureRasterzier::Key::Key(Kind knd,
+                            uint64_t ident,
+                            const SkMatrix& mat,
+                            const SkIPoint& t)
+    : kind(knd), id(ident), matrix(mat), tile(t){};
 
 PictureRasterzier::Key::Key(const Key& key) = default;
 
 PictureRasterzier::Value::Value()
-    : access_count(kDeadAccessCount), image(nullptr) {
+    : last_used_frame(kNeverUsed),
+      used_frame_count(0),
+      complexity(Complexity::Unknown),
+      image_bytes(0),
+      image_bounds(SkIRect::MakeEmpty()),
+      image(nullptr),
+      job(nullptr) {
 }
 
 PictureRasterzier::Value::~Value() {
 }
 
-RefPtr<SkImage> PictureRasterzier::ImageFromPicture(
-    PaintContext& context,
-    GrContext* gr_context,
-    SkPicture* picture,
-    const SkISize& physical_size,
-    const SkMatrix& incoming_ctm) {
-  // Step 1: Create a texture from the context's texture provider
+PictureRasterzier::Tile::Tile(PassRefPtr<SkImage> img, const SkIRect& rect)
+    : image(img), device_rect(rect) {
+}
 
-  GrSurfaceDesc surfaceDesc;
-  surfaceDesc.fWidth = physical_size.width();
-  surfaceDesc.fHeight = physical_size.height();
-  surfaceDesc.fFlags = kRenderTarget_GrSurfaceFlag;
-  surfaceDesc.fConfig = kRGBA_8888_GrPixelConfig;
+PictureRasterzier::Tile::~Tile() {
+}
 
-  GrTexture* texture =
-      gr_context->textureProvider()->createTexture(surfaceDesc, true);
+RefPtr<SkImage> PictureRasterzier::RasterizeImage(
+    PaintContext& context,
+    GrContext* gr_context,
+    const SkMatrix& matrix,
+    const SkIRect& device_bounds,
+    const DrawCallback& draw) {
+  RefPtr<GrTexture> texture = context.texture_pool().Acquire(
+      gr_context, device_bounds.width(), device_bounds.height());
 
   if (!texture) {
     // The texture provider could not allocate a texture backing. Render
@@ -62,19 +76,6 @@ RefPtr<SkImage> PictureRasterzier::ImageFromPicture(
     return nullptr;
   }
 
-  // Step 2: Create a backend render target description for the created texture
-
-  GrBackendTextureDesc textureDesc;
-  textureDesc.fConfig = surfaceDesc.fConfig;
-  textureDesc.fWidth = physical_size.width() / incoming_ctm.getScaleX();
-  textureDesc.fHeight = physical_size.height() / incoming_ctm.getScaleY();
-  textureDesc.fSampleCnt = surfaceDesc.fSampleCnt;
-  textureDesc.fFlags = kRenderTarget_GrBackendTextureFlag;
-  textureDesc.fConfig = surfaceDesc.fConfig;
-  textureDesc.fTextureHandle = texture->getTextureHandle();
-
-  // Step 3: Render the picture into the offscreen texture
-
   GrRenderTarget* renderTarget = texture->asRenderTarget();
   DCHECK(renderTarget);
 
@@ -85,20 +86,20 @@ RefPtr<SkImage> PictureRasterzier::ImageFromPicture(
   SkCanvas* canvas = surface->getCanvas();
   DCHECK(canvas);
 
-  canvas->setMatrix(
-      SkMatrix::MakeScale(incoming_ctm.getScaleX(), incoming_ctm.getScaleY()));
-  canvas->drawPicture(picture);
+  // Pooled textures may contain stale contents.
+  canvas->clear(SK_ColorTRANSPARENT);
+  canvas->translate(-device_bounds.left(), -device_bounds.top());
+  canvas->concat(matrix);
+  draw(canvas);
 
   if (context.options().isEnabled(
           CompositorOptions::Option::HightlightRasterizedImages)) {
-    DrawCheckerboard(canvas, textureDesc.fWidth, textureDesc.fHeight);
+    canvas->resetMatrix();
+    DrawCheckerboard(canvas, device_bounds.width(), device_bounds.height());
   }
 
-  // Step 4: Create an image representation from the texture
-
-  RefPtr<SkImage> image = adoptRef(
-      SkImage::NewFromTexture(gr_context, textureDesc, kPremul_SkAlphaType,
-                              &ImageReleaseProc, texture));
+  RefPtr<SkImage> image =
+      context.texture_pool().CreateImage(gr_context, texture.release());
 
   if (image) {
     cache_fills_.increment();
@@ -107,56 +108,620 @@ RefPtr<SkImage> PictureRasterzier::ImageFromPicture(
   return image;
 }
 
-RefPtr<SkImage> PictureRasterzier::GetCachedImageIfPresent(
+RefPtr<SkImage> PictureRasterzier::RasterizeImageInBackground(
     PaintContext& context,
     GrContext* gr_context,
     SkPicture* picture,
-    const SkISize& physical_size,
-    const SkMatrix& incoming_ctm) {
-  if (physical_size.isEmpty() || picture == nullptr || gr_context == nullptr) {
+    const SkMatrix& matrix,
+    Value* value) {
+  DCHECK(background_rasterizer_);
+
+  if (!value->job) {
+    // If the job cannot be scheduled, it is retried the next time the
+    // picture is drawn.
+    value->job = background_rasterizer_->Rasterize(
+        picture, matrix, value->image_bounds,
+        context.options().isEnabled(
+            CompositorOptions::Option::HightlightRasterizedImages));
+    return nullptr;
+  }
+
+  if (!value->job->IsReady()) {
     return nullptr;
   }
 
-  const Key key(picture->uniqueID(), physical_size);
+  RefPtr<SkImage> image = value->job->TakeImage(gr_context);
+  value->job = nullptr;
+
+  if (image) {
+    cache_fills_.increment();
+  }
+
+  return image;
+}
+
+static bool IsPictureComplex(SkPicture* picture, int min_draw_op_count) {
+  if (min_draw_op_count <= 0) {
+    return true;
+  }
+
+  // The recorded op count is an upper bound on the ops actually drawn and
+  // is free to query.
+  if (picture->approximateOpCount() < min_draw_op_count) {
+    return false;
+  }
+
+  // Play the picture back into an analysis canvas to discount ops that end
+  // up drawing nothing. Playback is aborted as soon as enough ops have been
+  // seen, so the cost of the analysis stays bounded for large pictures.
+  const SkIRect bounds = picture->cullRect().roundOut();
+  skia::AnalysisCanvas canvas(bounds.width(), bounds.height());
+  canvas.translate(-bounds.x(), -bounds.y());
+  canvas.SetMaxDrawOpCount(min_draw_op_count - 1);
+  picture->playback(&canvas, &canvas);
+
+  SkColor color;
+  if (canvas.GetColorIfSolid(&color)) {
+    return false;
+  }
+
+  return canvas.draw_op_count() >= min_draw_op_count;
+}
+
+// Splits |translation| into an integral part, returned through |integral|,
+// and a fractional part snapped to |steps| steps per pixel.
+static SkScalar SnapTranslation(SkScalar translation,
+                                int steps,
+                                int* integral) {
+  int whole = SkScalarFloorToInt(translation);
+  int fraction = SkScalarRoundToInt((translation - whole) * steps);
+  if (fraction == steps) {
+    whole++;
+    fraction = 0;
+  }
+  *integral = whole;
+  return SkIntToScalar(fraction) / steps;
+}
+
+// Returns |ctm| with its translation reduced to the snapped fractional part.
+// The integral part is returned through |integral_translation|.
+static SkMatrix SnapMatrix(const SkMatrix& ctm,
+                           int steps,
+                           SkIPoint* integral_translation) {
+  SkMatrix matrix = ctm;
+  matrix.setTranslateX(SnapTranslation(ctm.getTranslateX(), steps,
+                                       &integral_translation->fX));
+  matrix.setTranslateY(SnapTranslation(ctm.getTranslateY(), steps,
+                                       &integral_translation->fY));
+  return matrix;
+}
 
+PictureRasterzier::Value& PictureRasterzier::Touch(const Key& key) {
   Value& value = cache_[key];
 
-  if (value.access_count == Value::kDeadAccessCount) {
-    value.access_count = 1;
+  const uint64_t previous_use = value.last_used_frame;
+  value.last_used_frame = current_frame_;
+
+  if (previous_use != current_frame_) {
+    value.used_frame_count = previous_use != Value::kNeverUsed &&
+                                     previous_use == current_frame_ - 1
+                                 ? value.used_frame_count + 1
+                                 : 1;
+  }
+
+  return value;
+}
+
+void PictureRasterzier::DidRasterize(Value* value) {
+  DCHECK(value->image);
+  // The backing texture is always kRGBA_8888_GrPixelConfig and may be
+  // larger than |image_bounds|.
+  value->image_bytes = value->image->width() * value->image->height() * 4;
+  cache_bytes_.increment(value->image_bytes);
+}
+
+RefPtr<SkImage> PictureRasterzier::Lookup(
+    PaintContext& context,
+    GrContext* gr_context,
+    Key::Kind kind,
+    uint64_t id,
+    SkPicture* picture,
+    const SkRect& bounds,
+    const SkMatrix& ctm,
+    const std::function<bool()>& is_complex,
+    const DrawCallback& draw,
+    SkIRect* device_rect) {
+  DCHECK(device_rect);
+
+  if (gr_context == nullptr) {
+    return nullptr;
+  }
+
+  // Resampling a perspective raster would never match direct drawing.
+  if (ctm.hasPerspective()) {
     return nullptr;
   }
 
-  value.access_count++;
-  DCHECK(value.access_count == 1)
-      << "Did you forget to call PurgeCache between frames?";
+  SkIPoint integral_translation;
+  const SkMatrix matrix =
+      SnapMatrix(ctm, kSubpixelSteps, &integral_translation);
+
+  Value& value = Touch(Key(kind, id, matrix));
+
+  if (value.image_bounds.isEmpty()) {
+    SkRect mapped_bounds;
+    matrix.mapRect(&mapped_bounds, bounds);
+    value.image_bounds = mapped_bounds.roundOut();
+    if (value.image_bounds.isEmpty()) {
+      return nullptr;
+    }
+  }
 
   if (!value.image) {
-    value.image = ImageFromPicture(context, gr_context, picture, physical_size,
-                                   incoming_ctm);
+    // Entries that were not rasterized never survive more than one purge,
+    // so |used_frame_count| only grows while the contents are painted in
+    // consecutive frames.
+    if (value.used_frame_count <
+        context.options().rasterCacheStableFrameCount()) {
+      return nullptr;
+    }
+
+    if (value.complexity == Value::Complexity::Unknown) {
+      value.complexity = is_complex() ? Value::Complexity::Complex
+                                      : Value::Complexity::Simple;
+    }
+
+    if (value.complexity != Value::Complexity::Complex) {
+      return nullptr;
+    }
+
+    if (picture && background_rasterizer_) {
+      value.image = RasterizeImageInBackground(context, gr_context, picture,
+                                               matrix, &value);
+    } else {
+      value.image = RasterizeImage(context, gr_context, matrix,
+                                   value.image_bounds, draw);
+    }
+
+    if (value.image) {
+      DidRasterize(&value);
+    }
   }
 
   if (value.image) {
     cache_hits_.increment();
+    *device_rect = value.image_bounds.makeOffset(integral_translation.x(),
+                                                 integral_translation.y());
   }
 
   return value.image;
 }
 
-void PictureRasterzier::PurgeCache() {
-  std::unordered_set<Key, KeyHash, KeyEqual> keys_to_purge;
+RefPtr<SkImage> PictureRasterzier::GetCachedImageIfPresent(
+    PaintContext& context,
+    GrContext* gr_context,
+    SkPicture* picture,
+    const SkMatrix& ctm,
+    SkIRect* device_rect) {
+  if (picture == nullptr) {
+    return nullptr;
+  }
+
+  const int min_draw_op_count = context.options().rasterCacheMinDrawOpCount();
+
+  return Lookup(
+      context, gr_context, Key::Kind::Picture, picture->uniqueID(), picture,
+      picture->cullRect(), ctm,
+      [picture, min_draw_op_count]() {
+        return IsPictureComplex(picture, min_draw_op_count);
+      },
+      [picture](SkCanvas* canvas) { canvas->drawPicture(picture); },
+      device_rect);
+}
+
+bool PictureRasterzier::GetCachedTilesIfPresent(
+    PaintContext& context,
+    GrContext* gr_context,
+    SkPicture* picture,
+    const SkMatrix& ctm,
+    const SkRect& visible_rect,
+    std::vector<Tile>* tiles) {
+  DCHECK(tiles);
+  tiles->clear();
+
+  const int tile_size = context.options().rasterCacheTileSize();
+  if (picture == nullptr || gr_context == nullptr || tile_size <= 0 ||
+      ctm.hasPerspective()) {
+    return false;
+  }
+
+  SkIPoint integral_translation;
+  const SkMatrix matrix =
+      SnapMatrix(ctm, kSubpixelSteps, &integral_translation);
+
+  SkRect mapped_bounds;
+  matrix.mapRect(&mapped_bounds, picture->cullRect());
+  const SkIRect image_bounds = mapped_bounds.roundOut();
+  if (image_bounds.width() <= 2 * tile_size &&
+      image_bounds.height() <= 2 * tile_size) {
+    return false;
+  }
+
+  // The entry for the whole picture never holds an image. It tracks whether
+  // the picture is stable and complex enough to be worth caching at all.
+  Value& picture_value =
+      Touch(Key(Key::Kind::Picture, picture->uniqueID(), matrix));
+
+  if (picture_value.used_frame_count <
+      context.options().rasterCacheStableFrameCount()) {
+    return true;
+  }
+
+  if (picture_value.complexity == Value::Complexity::Unknown) {
+    picture_value.complexity =
+        IsPictureComplex(picture, context.options().rasterCacheMinDrawOpCount())
+            ? Value::Complexity::Complex
+            : Value::Complexity::Simple;
+  }
+
+  if (picture_value.complexity != Value::Complexity::Complex) {
+    return true;
+  }
+
+  // Tiles are laid out in the space of the snapped matrix so that scrolling
+  // by whole pixels keeps hitting the same tiles.
+  SkRect visible = visible_rect;
+  visible.offset(-integral_translation.x(), -integral_translation.y());
+  const SkIRect visible_bounds = visible.roundOut();
 
-  for (auto& item : cache_) {
-    const auto count = --item.second.access_count;
-    if (count == Value::kDeadAccessCount) {
-      keys_to_purge.insert(item.first);
+  SkIRect prefetch_bounds = visible_bounds;
+  prefetch_bounds.outset(tile_size, tile_size);
+  if (!prefetch_bounds.intersect(image_bounds)) {
+    return true;
+  }
+
+  const int first_column = (prefetch_bounds.left() - image_bounds.left()) /
+                           tile_size;
+  const int last_column =
+      (prefetch_bounds.right() - 1 - image_bounds.left()) / tile_size;
+  const int first_row = (prefetch_bounds.top() - image_bounds.top()) /
+                        tile_size;
+  const int last_row =
+      (prefetch_bounds.bottom() - 1 - image_bounds.top()) / tile_size;
+
+  const DrawCallback draw = [picture](SkCanvas* canvas) {
+    canvas->drawPicture(picture);
+  };
+
+  for (int row = first_row; row <= last_row; ++row) {
+    for (int column = first_column; column <= last_column; ++column) {
+      SkIRect tile_bounds = SkIRect::MakeXYWH(
+          image_bounds.left() + column * tile_size,
+          image_bounds.top() + row * tile_size, tile_size, tile_size);
+      if (!tile_bounds.intersect(image_bounds)) {
+        continue;
+      }
+
+      const bool is_visible = SkIRect::Intersects(tile_bounds, visible_bounds);
+
+      Value& tile =
+          Touch(Key(Key::Kind::PictureTile, picture->uniqueID(), matrix,
+                    SkIPoint::Make(column, row)));
+      tile.image_bounds = tile_bounds;
+
+      if (!tile.image) {
+        // Without a background rasterizer only the visible tiles are worth
+        // the time they take to rasterize in this frame.
+        if (background_rasterizer_) {
+          tile.image = RasterizeImageInBackground(context, gr_context,
+                                                  picture, matrix, &tile);
+        } else if (is_visible) {
+          tile.image = RasterizeImage(context, gr_context, matrix,
+                                      tile_bounds, draw);
+        }
+
+        if (tile.image) {
+          DidRasterize(&tile);
+        }
+      }
+
+      if (!is_visible) {
+        continue;
+      }
+
+      if (tile.image) {
+        cache_hits_.increment();
+      }
+
+      tiles->push_back(Tile(tile.image, tile_bounds.makeOffset(
+                                            integral_translation.x(),
+                                            integral_translation.y())));
+    }
+  }
+
+  return true;
+}
+
+// Rounds |scale| to the nearest power of sqrt(2), so that a zoom passes
+// through a level every few frames and no level is more than 2^(1/4) away
+// from the scale it stands in for.
+static SkScalar QuantizeScale(SkScalar scale) {
+  const double level = std::floor(2 * std::log2(scale) + 0.5);
+  return static_cast<SkScalar>(std::pow(2.0, level / 2));
+}
+
+bool PictureRasterzier::IsScaleChanging(SkPicture* picture,
+                                        const SkMatrix& ctm,
+                                        int frame_count) {
+  auto result = picture_scales_.insert(
+      std::make_pair(picture->uniqueID(), PictureScale()));
+  PictureScale& entry = result.first->second;
+  if (result.second) {
+    entry.last_change_frame = Value::kNeverUsed;
+  } else if (entry.last_used_frame != current_frame_ &&
+             (entry.scale_x != ctm.getScaleX() ||
+              entry.scale_y != ctm.getScaleY())) {
+    entry.last_change_frame = current_frame_;
+  }
+  if (result.second || entry.last_used_frame != current_frame_) {
+    entry.scale_x = ctm.getScaleX();
+    entry.scale_y = ctm.getScaleY();
+  }
+  entry.last_used_frame = current_frame_;
+
+  return entry.last_change_frame != Value::kNeverUsed &&
+         current_frame_ - entry.last_change_frame <=
+             static_cast<uint64_t>(frame_count);
+}
+
+RefPtr<SkImage> PictureRasterzier::GetCachedScaledImageIfPresent(
+    PaintContext& context,
+    GrContext* gr_context,
+    SkPicture* picture,
+    const SkMatrix& ctm,
+    const SkRect& visible_rect,
+    SkISize* image_size,
+    SkRect* device_rect) {
+  DCHECK(image_size);
+  DCHECK(device_rect);
+
+  if (picture == nullptr || gr_context == nullptr) {
+    return nullptr;
+  }
+
+  // Only scales and translations survive being quantized and resampled
+  // without looking different from direct drawing.
+  if ((ctm.getType() & ~(SkMatrix::kScale_Mask | SkMatrix::kTranslate_Mask)) ||
+      ctm.getScaleX() <= 0 || ctm.getScaleY() <= 0) {
+    return nullptr;
+  }
+
+  // The exact scale takes over once it has been stable for long enough to
+  // be cached.
+  if (!IsScaleChanging(picture, ctm,
+                       context.options().rasterCacheStableFrameCount())) {
+    return nullptr;
+  }
+
+  const SkScalar level_x = QuantizeScale(ctm.getScaleX());
+  const SkScalar level_y = QuantizeScale(ctm.getScaleY());
+  const SkMatrix level = SkMatrix::MakeScale(level_x, level_y);
+
+  // Maps the level's space to device space.
+  SkMatrix level_to_device =
+      SkMatrix::MakeScale(ctm.getScaleX() / level_x, ctm.getScaleY() / level_y);
+  level_to_device.postTranslate(ctm.getTranslateX(), ctm.getTranslateY());
+  SkMatrix device_to_level;
+  if (!level_to_device.invert(&device_to_level)) {
+    return nullptr;
+  }
+
+  SkRect level_bounds;
+  level.mapRect(&level_bounds, picture->cullRect());
+  SkRect needed;
+  device_to_level.mapRect(&needed, visible_rect);
+  if (!needed.intersect(level_bounds)) {
+    return nullptr;
+  }
+  const SkIRect needed_bounds = needed.roundOut();
+
+  Value& value = Touch(Key(Key::Kind::PictureScaled, picture->uniqueID(),
+                           level));
+
+  if (value.complexity == Value::Complexity::Unknown) {
+    value.complexity =
+        IsPictureComplex(picture, context.options().rasterCacheMinDrawOpCount())
+            ? Value::Complexity::Complex
+            : Value::Complexity::Simple;
+  }
+
+  if (value.complexity != Value::Complexity::Complex) {
+    return nullptr;
+  }
+
+  // Large pictures are only rasterized around the visible part, with a
+  // margin for the zoom and scrolling to move into. The level is rasterized
+  // again once they move past it.
+  if (!value.image_bounds.contains(needed_bounds)) {
+    if (value.image) {
+      cache_bytes_.reset(cache_bytes_.count() - value.image_bytes);
+      value.image = nullptr;
+      value.image_bytes = 0;
     }
+    value.job = nullptr;
+    SkIRect image_bounds = needed_bounds;
+    image_bounds.outset(needed_bounds.width() / 4, needed_bounds.height() / 4);
+    if (!image_bounds.intersect(level_bounds.roundOut())) {
+      return nullptr;
+    }
+    value.image_bounds = image_bounds;
   }
 
-  cache_evictions_.increment(keys_to_purge.size());
+  if (!value.image) {
+    // Unlike entries at the exact scale, levels are rasterized the first
+    // time they are needed. Drawing the picture directly would cost as much,
+    // and the level is drawn for several frames.
+    if (background_rasterizer_) {
+      value.image = RasterizeImageInBackground(context, gr_context, picture,
+                                               level, &value);
+    } else {
+      value.image = RasterizeImage(
+          context, gr_context, level, value.image_bounds,
+          [picture](SkCanvas* canvas) { canvas->drawPicture(picture); });
+    }
 
-  for (const auto& key : keys_to_purge) {
-    cache_.erase(key);
+    if (value.image) {
+      DidRasterize(&value);
+    }
   }
+
+  if (!value.image) {
+    return nullptr;
+  }
+
+  cache_hits_.increment();
+  *image_size = SkISize::Make(value.image_bounds.width(),
+                              value.image_bounds.height());
+  level_to_device.mapRect(device_rect, SkRect::Make(value.image_bounds));
+  return value.image;
+}
+
+RefPtr<SkImage> PictureRasterzier::GetCachedLayerImageIfPresent(
+    PaintContext& context,
+    GrContext* gr_context,
+    uint64_t signature,
+    const SkRect& bounds,
+    const SkMatrix& ctm,
+    const DrawCallback& draw,
+    SkIRect* device_rect) {
+  // Layer subtrees are only cached in place of a save layer, which is always
+  // more expensive than compositing a single texture.
+  return Lookup(context, gr_context, Key::Kind::Layer, signature, nullptr,
+                bounds, ctm, []() { return true; }, draw, device_rect);
+}
+
+bool PictureRasterzier::GetOpaqueRect(SkPicture* picture,
+                                      SkRect* opaque_rect) {
+  auto result = opaque_rects_.insert(
+      std::make_pair(picture->uniqueID(), OpaqueRect()));
+  OpaqueRect& entry = result.first->second;
+  entry.last_used_frame = current_frame_;
+
+  if (result.second) {
+    // Unlike the complexity analysis, this one has to see every op, since a
+    // late op may clear part of what an early one made opaque.
+    const SkIRect bounds = picture->cullRect().roundOut();
+    skia::AnalysisCanvas canvas(bounds.width(), bounds.height());
+    canvas.translate(-bounds.x(), -bounds.y());
+    canvas.SetMaxDrawOpCount(std::numeric_limits<int>::max());
+    picture->playback(&canvas, &canvas);
+
+    SkIRect device_rect;
+    if (canvas.GetOpaqueRect(&device_rect)) {
+      device_rect.offset(bounds.x(), bounds.y());
+      entry.rect = SkRect::Make(device_rect);
+    } else {
+      entry.rect.setEmpty();
+    }
+  }
+
+  if (entry.rect.isEmpty())
+    return false;
+  *opaque_rect = entry.rect;
+  return true;
+}
+
+void PictureRasterzier::PurgeCache(size_t byte_budget) {
+  for (auto it = opaque_rects_.begin(); it != opaque_rects_.end();) {
+    if (it->second.last_used_frame != current_frame_)
+      it = opaque_rects_.erase(it);
+    else
+      ++it;
+  }
+
+  for (auto it = picture_scales_.begin(); it != picture_scales_.end();) {
+    if (it->second.last_used_frame != current_frame_)
+      it = picture_scales_.erase(it);
+    else
+      ++it;
+  }
+
+  std::vector<Cache::iterator> eviction_candidates;
+
+  for (auto it = cache_.begin(); it != cache_.end();) {
+    const Value& value = it->second;
+    const bool used_this_frame = value.last_used_frame == current_frame_;
+
+    // Dropping an entry with a pending background job lets the job finish
+    // on its own. Its result is then discarded.
+    if (!value.image && !used_this_frame) {
+      it = cache_.erase(it);
+      continue;
+    }
+
+    // Images used in the frame that just ended are never evicted, even if
+    // they alone exceed the budget. Doing so would cause them to be
+    // rasterized again in the very next frame.
+    if (value.image && !used_this_frame) {
+      eviction_candidates.push_back(it);
+    }
+
+    ++it;
+  }
+
+  EvictLeastRecentlyUsed(&eviction_candidates, byte_budget);
+
+  current_frame_++;
+}
+
+void PictureRasterzier::Trim(size_t byte_budget) {
+  std::vector<Cache::iterator> eviction_candidates;
+  for (auto it = cache_.begin(); it != cache_.end(); ++it) {
+    if (it->second.image)
+      eviction_candidates.push_back(it);
+  }
+  EvictLeastRecentlyUsed(&eviction_candidates, byte_budget);
+}
+
+void PictureRasterzier::Clear() {
+  size_t evictions = 0;
+  for (const auto& entry : cache_) {
+    if (entry.second.image)
+      evictions++;
+  }
+  cache_.clear();
+  opaque_rects_.clear();
+  picture_scales_.clear();
+  cache_bytes_.reset(0);
+  cache_evictions_.increment(evictions);
+}
+
+void PictureRasterzier::EvictLeastRecentlyUsed(
+    std::vector<Cache::iterator>* candidates,
+    size_t byte_budget) {
+  if (cache_bytes_.count() <= byte_budget)
+    return;
+
+  std::sort(candidates->begin(), candidates->end(),
+            [](const Cache::iterator& lhs, const Cache::iterator& rhs) {
+              return lhs->second.last_used_frame <
+                     rhs->second.last_used_frame;
+            });
+
+  size_t bytes = cache_bytes_.count();
+  size_t evictions = 0;
+
+  for (const auto& it : *candidates) {
+    if (bytes <= byte_budget) {
+      break;
+    }
+    bytes -= it->second.image_bytes;
+    cache_.erase(it);
+    evictions++;
+  }
+
+  cache_bytes_.reset(bytes);
+  cache_evictions_.increment(evictions);
 }
 
 }  // namespace compositor
@@ -6,15 +6,19 @@
 #define SKY_COMPOSITOR_PICTURE_RASTERIZER_H_
 
 #include "base/macros.h"
-#include "third_party/skia/include/core/SkSize.h"
+#include "sky/compositor/background_rasterizer.h"
 #include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkSize.h"
 #include "sky/compositor/instrumentation.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefPtr.h"
 
 #include <functional>  // for std::hash
+#include <memory>
 #include <unordered_map>
-#include <unordered_set>
+#include <vector>
 
 namespace sky {
 namespace compositor {
@@ -25,13 +29,110 @@ class PictureRasterzier {
   PictureRasterzier();
   ~PictureRasterzier();
 
+  // Draws the contents of a layer subtree into a canvas that has already been
+  // set up with the device space matrix of the cache entry.
+  using DrawCallback = std::function<void(SkCanvas*)>;
+
+  // A part of a tiled picture in device space. |image| is nullptr while the
+  // tile has not been rasterized yet, in which case the picture has to be
+  // drawn directly into |device_rect|.
+  struct Tile {
+    RefPtr<SkImage> image;
+    SkIRect device_rect;
+
+    Tile(PassRefPtr<SkImage> img, const SkIRect& rect);
+    ~Tile();
+  };
+
+  // Returns a rasterized image of |picture| as drawn with |ctm|, or nullptr
+  // if the picture should be drawn directly. The image is in device space.
+  // It may be larger than |device_rect|, in which case only its top left
+  // part of the size of |device_rect| is defined. That part must be drawn
+  // with an identity matrix into |device_rect|.
+  //
+  // Only the integer part of the translation in |ctm| is left out of the
+  // cache key so that pure scrolling keeps hitting the cache. Scale, skew
+  // and the fractional part of the translation (snapped to
+  // |kSubpixelSteps|) are part of the key.
   RefPtr<SkImage> GetCachedImageIfPresent(PaintContext& context,
                                           GrContext* gr_context,
                                           SkPicture* picture,
-                                          const SkISize& physical_size,
-                                          const SkMatrix& incoming_ctm);
+                                          const SkMatrix& ctm,
+                                          SkIRect* device_rect);
+
+  // Returns false if |picture| is too small to be tiled under |ctm|, in
+  // which case GetCachedImageIfPresent should be used instead. Otherwise
+  // fills |tiles| with the tiles covering |visible_rect|, which is in device
+  // space. Tiles just outside of it are rasterized ahead of time but not
+  // returned. |tiles| is left empty if the whole picture should be drawn
+  // directly.
+  bool GetCachedTilesIfPresent(PaintContext& context,
+                               GrContext* gr_context,
+                               SkPicture* picture,
+                               const SkMatrix& ctm,
+                               const SkRect& visible_rect,
+                               std::vector<Tile>* tiles);
 
-  void PurgeCache();
+  // For pictures whose scale changed in the last few frames, as it does
+  // throughout a pinch or a zoom animation, under which every frame would
+  // miss the entries keyed by the exact matrix. Returns an image of the
+  // part of |picture| around |visible_rect|, which is in device space,
+  // rasterized at the power of sqrt(2) nearest to each of the scales of
+  // |ctm|, or nullptr if the scale is stable or |ctm| does more than scale
+  // and translate. A few such levels are kept per picture, and the exact
+  // scale is cached again once the scale settles. The top left
+  // |image_size| part of the image must be drawn, filtered, into
+  // |device_rect| with an identity matrix.
+  RefPtr<SkImage> GetCachedScaledImageIfPresent(PaintContext& context,
+                                                GrContext* gr_context,
+                                                SkPicture* picture,
+                                                const SkMatrix& ctm,
+                                                const SkRect& visible_rect,
+                                                SkISize* image_size,
+                                                SkRect* device_rect);
+
+  // Like GetCachedImageIfPresent but for the contents of a layer subtree
+  // identified by |signature|. |bounds| are in the coordinate space of the
+  // subtree. |draw| is only invoked when the cache needs to be filled.
+  RefPtr<SkImage> GetCachedLayerImageIfPresent(PaintContext& context,
+                                               GrContext* gr_context,
+                                               uint64_t signature,
+                                               const SkRect& bounds,
+                                               const SkMatrix& ctm,
+                                               const DrawCallback& draw,
+                                               SkIRect* device_rect);
+
+  // Returns false if |picture| is not known to cover any part of itself
+  // with opaque pixels. Otherwise sets |opaque_rect| to a rect in the
+  // picture's coordinates that it covers. Pictures are analyzed the first
+  // time they are asked about, and the result is kept for as long as the
+  // picture is asked about in every frame.
+  bool GetOpaqueRect(SkPicture* picture, SkRect* opaque_rect);
+
+  // Called once at the end of every frame. Entries that were never
+  // rasterized are dropped if they were not used in the frame that just
+  // ended. Rasterized entries are kept across frames and evicted in least
+  // recently used order once the total size of the cache exceeds
+  // |byte_budget|.
+  void PurgeCache(size_t byte_budget);
+
+  // Evicts rasterized entries in least recently used order until the cache
+  // holds no more than |byte_budget|, including entries used in the last
+  // frame. Meant for memory pressure, between frames.
+  void Trim(size_t byte_budget);
+
+  // Drops every entry. Pending background jobs finish on their own and their
+  // results are discarded.
+  void Clear();
+
+  // When set, cache fills for pictures are handed to |background_rasterizer|
+  // instead of being rasterized in the frame that first needs them. The
+  // picture keeps being drawn directly until its image is ready. Cache fills
+  // for layer subtrees are always synchronous since their contents may
+  // refer to images that only exist in the painting thread's GrContext.
+  void set_background_rasterizer(BackgroundRasterizer* background_rasterizer) {
+    background_rasterizer_ = background_rasterizer;
+  }
 
   const instrumentation::Counter& cache_fills() { return cache_fills_; }
 
@@ -39,34 +140,74 @@ class PictureRasterzier {
 
   const instrumentation::Counter& cache_evictions() { return cache_evictions_; }
 
+  // The number of bytes currently held by rasterized images in the cache.
+  const instrumentation::Counter& cache_bytes() { return cache_bytes_; }
+
  private:
+  // Fractional translations are snapped to multiples of 1 / kSubpixelSteps
+  // of a device pixel.
+  static const int kSubpixelSteps = 4;
+
   struct Key {
-    uint32_t pictureID;
-    SkISize size;
+    enum class Kind : uint8_t {
+      Picture,
+      PictureTile,
+      // A picture at a quantized scale, without translation.
+      PictureScaled,
+      Layer,
+    };
+
+    Kind kind;
+    // The picture's unique ID or the layer subtree's signature.
+    uint64_t id;
+    // |matrix| has its translation reduced to the snapped fractional part.
+    SkMatrix matrix;
+    // The column and row of a picture tile. Zero for other kinds.
+    SkIPoint tile;
 
-    explicit Key(uint32_t ident, SkISize sz);
+    explicit Key(Kind knd, uint64_t ident, const SkMatrix& mat);
+    Key(Kind knd, uint64_t ident, const SkMatrix& mat, const SkIPoint& t);
     Key(const Key& key);
   };
 
   struct KeyHash {
     std::size_t operator()(const Key& key) const {
-      return std::hash<uint32_t>()(key.pictureID) ^
-             std::hash<int32_t>()(key.size.width()) ^
-             std::hash<int32_t>()(key.size.height());
+      return std::hash<uint64_t>()(key.id) ^
+             std::hash<float>()(key.matrix.getScaleX()) ^
+             std::hash<float>()(key.matrix.getScaleY()) ^
+             std::hash<float>()(key.matrix.getSkewX()) ^
+             std::hash<float>()(key.matrix.getSkewY()) ^
+             std::hash<float>()(key.matrix.getTranslateX()) ^
+             std::hash<float>()(key.matrix.getTranslateY()) ^
+             std::hash<int32_t>()((key.tile.y() << 16) ^ key.tile.x());
     }
   };
 
   struct KeyEqual {
     bool operator()(const Key& lhs, const Key& rhs) const {
-      return lhs.pictureID == rhs.pictureID && lhs.size == rhs.size;
+      return lhs.kind == rhs.kind && lhs.id == rhs.id &&
+             lhs.matrix == rhs.matrix && lhs.tile == rhs.tile;
     }
   };
 
   struct Value {
-    static const int8_t kDeadAccessCount = -1;
+    static const uint64_t kNeverUsed = 0;
 
-    int8_t access_count;
+    enum class Complexity : uint8_t {
+      Unknown,
+      Simple,
+      Complex,
+    };
+
+    uint64_t last_used_frame;
+    int used_frame_count;
+    Complexity complexity;
+    size_t image_bytes;
+    // The device space bounds of the contents under the key's matrix.
+    SkIRect image_bounds;
     RefPtr<SkImage> image;
+    // The pending background rasterization for |image|, if any.
+    std::shared_ptr<BackgroundRasterizer::Job> job;
 
     Value();
     ~Value();
@@ -74,15 +215,78 @@ class PictureRasterzier {
 
   using Cache = std::unordered_map<Key, Value, KeyHash, KeyEqual>;
   Cache cache_;
+
+  struct OpaqueRect {
+    uint64_t last_used_frame;
+    // Empty if the picture is not known to be opaque anywhere.
+    SkRect rect;
+  };
+
+  // Keyed by the pictures' unique IDs.
+  std::unordered_map<uint32_t, OpaqueRect> opaque_rects_;
+
+  struct PictureScale {
+    uint64_t last_used_frame;
+    // The last frame the picture was drawn at a different scale than in the
+    // frame before, or |Value::kNeverUsed|.
+    uint64_t last_change_frame;
+    SkScalar scale_x;
+    SkScalar scale_y;
+  };
+
+  // The scales the pictures were drawn at in the frames before the current
+  // one, keyed by the pictures' unique IDs. A picture drawn at several
+  // scales in one frame only counts the first.
+  std::unordered_map<uint32_t, PictureScale> picture_scales_;
+  // Frame numbers start at 1 so that |Value::kNeverUsed| is never a valid
+  // frame.
+  uint64_t current_frame_;
+  BackgroundRasterizer* background_rasterizer_;
   instrumentation::Counter cache_fills_;
   instrumentation::Counter cache_hits_;
   instrumentation::Counter cache_evictions_;
+  instrumentation::Counter cache_bytes_;
+
+  // Returns the entry for |key| after marking it as used in the current
+  // frame.
+  Value& Touch(const Key& key);
+
+  // Accounts for the image that was just stored in |value|.
+  void DidRasterize(Value* value);
+
+  // Records the scale of |ctm| for |picture| and returns whether it changed
+  // within the last |frame_count| frames.
+  bool IsScaleChanging(SkPicture* picture,
+                       const SkMatrix& ctm,
+                       int frame_count);
+
+  RefPtr<SkImage> Lookup(PaintContext& context,
+                         GrContext* gr_context,
+                         Key::Kind kind,
+                         uint64_t id,
+                         SkPicture* picture,
+                         const SkRect& bounds,
+                         const SkMatrix& ctm,
+                         const std::function<bool()>& is_complex,
+                         const DrawCallback& draw,
+                         SkIRect* device_rect);
+
+  RefPtr<SkImage> RasterizeImage(PaintContext& context,
+                                 GrContext* gr_context,
+                                 const SkMatrix& matrix,
+                                 const SkIRect& device_bounds,
+                                 const DrawCallback& draw);
+
+  // Erases |candidates| in least recently used order until the cache holds
+  // no more than |byte_budget|.
+  void EvictLeastRecentlyUsed(std::vector<Cache::iterator>* candidates,
+                              size_t byte_budget);
 
-  RefPtr<SkImage> ImageFromPicture(PaintContext& context,
-                                   GrContext* gr_context,
-                                   SkPicture* picture,
-                                   const SkISize& physical_size,
-                                   const SkMatrix& incomingCTM);
+  RefPtr<SkImage> RasterizeImageInBackground(PaintContext& context,
+                                             GrContext* gr_context,
+                                             SkPicture* picture,
+                                             const SkMatrix& matrix,
+                                             Value* value);
 
   DISALLOW_COPY_AND_ASSIGN(PictureRasterzier);
 };
@@ -0,0 +1,304 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/scroll_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/logging.h"
+
+namespace sky {
+namespace compositor {
+namespace {
+
+// The rate at which a fling's velocity decays, per second.
+const double kFlingDecayRate = 2.0;
+
+// A fling stops once it is slower than this, in pixels per second.
+const double kMinFlingVelocity = 20.0;
+
+// How many offsets of a scroller are remembered for recognizing the app's
+// frames that repeat them.
+const size_t kMaxReportedOffsets = 32;
+
+// Scrollers that have not been drawn for this many frames are forgotten.
+const int kMaxUnseenFrames = 60;
+
+SkScalar Clamp(SkScalar value, SkScalar max) {
+  return std::max<SkScalar>(0, std::min(value, max));
+}
+
+bool IsNearEdge(SkScalar offset,
+                SkScalar previous_offset,
+                SkScalar max_offset,
+                SkScalar extent) {
+  if (max_offset <= 0 || offset == previous_offset)
+    return false;
+  if (offset > previous_offset)
+    return max_offset - offset < extent;
+  return offset < extent;
+}
+
+}  // namespace
+
+ScrollGesture::ScrollGesture()
+    : type(Type::kEnd),
+      position(SkPoint::Make(0, 0)),
+      delta(SkVector::Make(0, 0)),
+      velocity(SkVector::Make(0, 0)) {
+}
+
+ScrollOffsetStore::ScrollOffsetStore() {
+}
+
+ScrollOffsetStore::~ScrollOffsetStore() {
+}
+
+void ScrollOffsetStore::Update(const std::map<uint32_t, SkPoint>& offsets) {
+  base::AutoLock lock(lock_);
+  offsets_ = offsets;
+}
+
+bool ScrollOffsetStore::Get(uint32_t scroll_id, SkPoint* offset) const {
+  base::AutoLock lock(lock_);
+  auto it = offsets_.find(scroll_id);
+  if (it == offsets_.end())
+    return false;
+  *offset = it->second;
+  return true;
+}
+
+ScrollController::Scroller::Scroller()
+    : offset(SkPoint::Make(0, 0)),
+      app_offset(SkPoint::Make(0, 0)),
+      pending_delta(SkVector::Make(0, 0)),
+      flinging(false),
+      fling_origin(SkPoint::Make(0, 0)),
+      fling_velocity(SkVector::Make(0, 0)),
+      frames_unseen(0) {
+  device_to_local.reset();
+}
+
+ScrollController::ScrollController()
+    : in_frame_(false),
+      depth_(0),
+      has_active_scroller_(false),
+      active_scroll_id_(0),
+      content_requested_(false),
+      offsets_(new ScrollOffsetStore()) {
+}
+
+ScrollController::~ScrollController() {
+}
+
+void ScrollController::HandleGesture(const ScrollGesture& gesture) {
+  switch (gesture.type) {
+    case ScrollGesture::Type::kBegin: {
+      Scroller* scroller = FindScroller(gesture.position);
+      has_active_scroller_ = scroller != nullptr;
+      if (scroller)
+        scroller->flinging = false;
+      break;
+    }
+    case ScrollGesture::Type::kUpdate: {
+      if (!has_active_scroller_)
+        break;
+      Scroller& scroller = scrollers_[active_scroll_id_];
+      SkVector delta;
+      scroller.device_to_local.mapVectors(&delta, &gesture.delta, 1);
+      scroller.pending_delta += delta;
+      break;
+    }
+    case ScrollGesture::Type::kEnd:
+      has_active_scroller_ = false;
+      break;
+    case ScrollGesture::Type::kFling: {
+      if (!has_active_scroller_)
+        break;
+      Scroller& scroller = scrollers_[active_scroll_id_];
+      scroller.device_to_local.mapVectors(&scroller.fling_velocity,
+                                          &gesture.velocity, 1);
+      // The fling starts where the pending deltas leave the scroller.
+      scroller.fling_origin = scroller.offset - scroller.pending_delta;
+      scroller.pending_delta.set(0, 0);
+      scroller.fling_start = gesture.time;
+      scroller.flinging = true;
+      has_active_scroller_ = false;
+      break;
+    }
+  }
+}
+
+ScrollController::Scroller* ScrollController::FindScroller(
+    const SkPoint& device_position) {
+  // Nested scrollers take the gesture before the ones they are in, and of
+  // the scrollers at the same depth the topmost one does.
+  const HitRegion* hit = nullptr;
+  for (const HitRegion& region : hit_regions_) {
+    if (!region.device_rect.contains(device_position.x(),
+                                     device_position.y()))
+      continue;
+    if (!hit || region.depth > hit->depth)
+      hit = &region;
+  }
+  if (!hit)
+    return nullptr;
+  auto it = scrollers_.find(hit->scroll_id);
+  if (it == scrollers_.end())
+    return nullptr;
+  active_scroll_id_ = hit->scroll_id;
+  return &it->second;
+}
+
+void ScrollController::BeginFrame() {
+  DCHECK(!in_frame_);
+  in_frame_ = true;
+  depth_ = 0;
+  hit_regions_.clear();
+  for (auto& entry : scrollers_)
+    ++entry.second.frames_unseen;
+}
+
+void ScrollController::EndFrame() {
+  DCHECK(in_frame_);
+  DCHECK_EQ(0, depth_);
+  in_frame_ = false;
+
+  std::map<uint32_t, SkPoint> offsets;
+  for (auto it = scrollers_.begin(); it != scrollers_.end();) {
+    Scroller& scroller = it->second;
+    if (scroller.frames_unseen > kMaxUnseenFrames) {
+      if (has_active_scroller_ && active_scroll_id_ == it->first)
+        has_active_scroller_ = false;
+      scrollers_.erase(it++);
+      continue;
+    }
+    std::vector<SkPoint>& reported = scroller.reported_offsets;
+    if (reported.empty() || reported.back() != scroller.offset) {
+      if (reported.size() == kMaxReportedOffsets)
+        reported.erase(reported.begin());
+      reported.push_back(scroller.offset);
+    }
+    offsets[it->first] = scroller.offset;
+    ++it;
+  }
+  offsets_->Update(offsets);
+}
+
+SkPoint ScrollController::BeginScroller(uint32_t scroll_id,
+                                        const SkPoint& app_offset,
+                                        const SkPoint& max_offset,
+                                        const SkRect& viewport,
+                                        const SkMatrix& matrix,
+                                        base::TimeTicks time,
+                                        bool* running) {
+  ++depth_;
+  auto result = scrollers_.insert(std::make_pair(scroll_id, Scroller()));
+  Scroller& scroller = result.first->second;
+  // Trees drawn outside of frames do not change what is on screen.
+  if (!in_frame_ && result.second) {
+    scrollers_.erase(result.first);
+    return SkPoint::Make(Clamp(app_offset.x(), max_offset.x()),
+                         Clamp(app_offset.y(), max_offset.y()));
+  }
+  if (!in_frame_)
+    return scroller.offset;
+
+  const std::vector<SkPoint>& reported = scroller.reported_offsets;
+  const bool app_scrolled =
+      result.second ||
+      (app_offset != scroller.app_offset &&
+       std::find(reported.begin(), reported.end(), app_offset) ==
+           reported.end());
+  scroller.app_offset = app_offset;
+  if (app_scrolled) {
+    scroller.offset = app_offset;
+    scroller.reported_offsets.clear();
+    scroller.pending_delta.set(0, 0);
+    scroller.flinging = false;
+  }
+
+  const SkPoint previous_offset = scroller.offset;
+  if (scroller.flinging) {
+    UpdateFling(&scroller, max_offset, time);
+    if (scroller.flinging)
+      *running = true;
+  } else {
+    // The content follows the finger, so the offset moves against it.
+    scroller.offset -= scroller.pending_delta;
+  }
+  scroller.pending_delta.set(0, 0);
+  scroller.offset.set(Clamp(scroller.offset.x(), max_offset.x()),
+                      Clamp(scroller.offset.y(), max_offset.y()));
+  scroller.frames_unseen = 0;
+
+  if (!matrix.invert(&scroller.device_to_local))
+    scroller.device_to_local.setScale(0, 0);
+
+  SkRect device_rect;
+  matrix.mapRect(&device_rect, viewport);
+  hit_regions_.push_back({scroll_id, device_rect, depth_});
+
+  if (IsNearEdge(scroller.offset.x(), previous_offset.x(), max_offset.x(),
+                 viewport.width()) ||
+      IsNearEdge(scroller.offset.y(), previous_offset.y(), max_offset.y(),
+                 viewport.height())) {
+    content_requested_ = true;
+  }
+
+  return scroller.offset;
+}
+
+void ScrollController::EndScroller() {
+  DCHECK_GT(depth_, 0);
+  --depth_;
+}
+
+void ScrollController::UpdateFling(Scroller* scroller,
+                                   const SkPoint& max_offset,
+                                   base::TimeTicks time) {
+  const double elapsed =
+      std::max(0.0, (time - scroller->fling_start).InSecondsF());
+  const double decay = std::exp(-kFlingDecayRate * elapsed);
+  const double distance = (1 - decay) / kFlingDecayRate;
+  SkPoint offset = scroller->fling_origin -
+                   SkVector::Make(scroller->fling_velocity.x() * distance,
+                                  scroller->fling_velocity.y() * distance);
+
+  // An axis that runs into an edge stops there, and the other goes on.
+  if (offset.x() != Clamp(offset.x(), max_offset.x())) {
+    offset.fX = Clamp(offset.x(), max_offset.x());
+    scroller->fling_origin.fX = offset.x();
+    scroller->fling_velocity.fX = 0;
+  }
+  if (offset.y() != Clamp(offset.y(), max_offset.y())) {
+    offset.fY = Clamp(offset.y(), max_offset.y());
+    scroller->fling_origin.fY = offset.y();
+    scroller->fling_velocity.fY = 0;
+  }
+  scroller->offset = offset;
+
+  const double speed = scroller->fling_velocity.length() * decay;
+  if (speed < kMinFlingVelocity)
+    scroller->flinging = false;
+}
+
+bool ScrollController::NeedsFrame() const {
+  for (const auto& entry : scrollers_) {
+    const Scroller& scroller = entry.second;
+    if (scroller.flinging || !scroller.pending_delta.isZero())
+      return true;
+  }
+  return false;
+}
+
+bool ScrollController::TakeContentRequest() {
+  const bool requested = content_requested_;
+  content_requested_ = false;
+  return requested;
+}
+
+}  // namespace compositor
+}  // namespace sky
@@ -0,0 +1,165 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_SCROLL_CONTROLLER_H_
+#define SKY_COMPOSITOR_SCROLL_CONTROLLER_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "third_party/skia/include/core/SkMatrix.h"
+#include "third_party/skia/include/core/SkPoint.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace sky {
+namespace compositor {
+
+// A scroll gesture as the compositor sees it. Positions, deltas and
+// velocities are in device pixels, in the direction the finger moved.
+struct ScrollGesture {
+  enum class Type {
+    kBegin,
+    kUpdate,
+    kEnd,
+    kFling,
+  };
+
+  ScrollGesture();
+
+  Type type;
+  base::TimeTicks time;
+  SkPoint position;
+  // How far the finger moved since the last update, for kUpdate.
+  SkVector delta;
+  // In pixels per second, for kFling.
+  SkVector velocity;
+};
+
+// Hands the offsets the compositor scrolled to to other threads, so that the
+// app can pick them up when it builds its next frame.
+class ScrollOffsetStore
+    : public base::RefCountedThreadSafe<ScrollOffsetStore> {
+ public:
+  ScrollOffsetStore();
+
+  void Update(const std::map<uint32_t, SkPoint>& offsets);
+
+  // Returns false if no scroll layer with |scroll_id| has been drawn.
+  bool Get(uint32_t scroll_id, SkPoint* offset) const;
+
+ private:
+  friend class base::RefCountedThreadSafe<ScrollOffsetStore>;
+  ~ScrollOffsetStore();
+
+  mutable base::Lock lock_;
+  std::map<uint32_t, SkPoint> offsets_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScrollOffsetStore);
+};
+
+// Scrolls the ScrollLayers of the frames painted with a PaintContext without
+// waiting for the app. Gestures are hit tested against the scroll layers of
+// the last frame, their deltas accumulate until the next frame is prerolled,
+// and flings decelerate at the frame clock.
+//
+// The offset the app gives a scroll layer is taken over only when it is not
+// one the compositor reported, since the app's frames trail the compositor's
+// and mostly repeat offsets it read back a frame or two ago.
+class ScrollController {
+ public:
+  ScrollController();
+  ~ScrollController();
+
+  void HandleGesture(const ScrollGesture& gesture);
+
+  // Brackets the preroll of a frame that is shown. Scroll layers prerolled
+  // outside of a frame, such as those of trees rasterized into images, are
+  // drawn at their offsets but receive no gestures.
+  void BeginFrame();
+  void EndFrame();
+
+  // Called by a scroll layer during preroll. Returns the offset to draw the
+  // layer's content at for |time| and sets |*running| if a fling goes on
+  // after it. |matrix| maps the layer's coordinate space, in which
+  // |viewport| is given, to device space. Scroll layers nest, so every
+  // call has to be followed by EndScroller once the content is prerolled.
+  SkPoint BeginScroller(uint32_t scroll_id,
+                        const SkPoint& app_offset,
+                        const SkPoint& max_offset,
+                        const SkRect& viewport,
+                        const SkMatrix& matrix,
+                        base::TimeTicks time,
+                        bool* running);
+  void EndScroller();
+
+  // Whether gestures moved a scroll layer since the last frame, or one is
+  // flinging, so that the last tree has to be drawn again.
+  bool NeedsFrame() const;
+
+  // Whether the last frame had a scroll layer.
+  bool has_scrollers() const { return !scrollers_.empty(); }
+
+  // Returns true once after a frame in which the compositor scrolled a
+  // layer to within a viewport of the end of its content, so that the app
+  // can add more.
+  bool TakeContentRequest();
+
+  ScrollOffsetStore* offsets() const { return offsets_.get(); }
+
+ private:
+  struct Scroller {
+    Scroller();
+
+    SkPoint offset;
+    // The offset the app gave the layer in the last frame.
+    SkPoint app_offset;
+    // The offsets reported to the app since it last set one itself.
+    std::vector<SkPoint> reported_offsets;
+    // The gesture deltas since the last frame, in the layer's coordinates.
+    SkVector pending_delta;
+    // Maps device space to the layer's coordinates, as of the last frame.
+    SkMatrix device_to_local;
+    bool flinging;
+    base::TimeTicks fling_start;
+    SkPoint fling_origin;
+    SkVector fling_velocity;
+    // The number of frames since the scroller was last prerolled.
+    int frames_unseen;
+  };
+
+  struct HitRegion {
+    uint32_t scroll_id;
+    SkRect device_rect;
+    int depth;
+  };
+
+  Scroller* FindScroller(const SkPoint& device_position);
+  void UpdateFling(Scroller* scroller,
+                   const SkPoint& max_offset,
+                   base::TimeTicks time);
+
+  std::map<uint32_t, Scroller> scrollers_;
+  // The viewports of the last frame's scroll layers, from the top down.
+  std::vector<HitRegion> hit_regions_;
+  bool in_frame_;
+  int depth_;
+  // The scroller the current gesture scrolls, if any.
+  bool has_active_scroller_;
+  uint32_t active_scroll_id_;
+  bool content_requested_;
+  scoped_refptr<ScrollOffsetStore> offsets_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScrollController);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_SCROLL_CONTROLLER_H_
@@ -0,0 +1,91 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/scroll_layer.h"
+
+#include <algorithm>
+
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+#include "sky/compositor/scroll_controller.h"
+
+namespace sky {
+namespace compositor {
+
+ScrollLayer::ScrollLayer()
+    : scroll_id_(0),
+      offset_(SkPoint::Make(0, 0)),
+      viewport_(SkRect::MakeEmpty()),
+      content_size_(SkSize::Make(0, 0)),
+      scroll_offset_(SkPoint::Make(0, 0)) {
+  SetHasAnimations();
+}
+
+ScrollLayer::~ScrollLayer() {
+}
+
+SkMatrix ScrollLayer::ContentTransform() const {
+  return SkMatrix::MakeTrans(viewport_.x() - scroll_offset_.x(),
+                             viewport_.y() - scroll_offset_.y());
+}
+
+void ScrollLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  const SkPoint max_offset = SkPoint::Make(
+      std::max<SkScalar>(0, content_size_.width() - viewport_.width()),
+      std::max<SkScalar>(0, content_size_.height() - viewport_.height()));
+  ScrollController& controller =
+      context->frame.paint_context().scroll_controller();
+  scroll_offset_ = controller.BeginScroller(
+      scroll_id_, offset_, max_offset, viewport_, matrix,
+      context->animation_time, &context->animations_running);
+
+  SkRect clip_bounds;
+  matrix.mapRect(&clip_bounds, viewport_);
+  const SkRect parent_cull_rect = context->cull_rect;
+  if (!context->cull_rect.intersect(clip_bounds))
+    context->cull_rect.setEmpty();
+  SkMatrix child_matrix;
+  child_matrix.setConcat(matrix, ContentTransform());
+  PrerollChildren(context, child_matrix);
+  context->cull_rect = parent_cull_rect;
+
+  controller.EndScroller();
+}
+
+void ScrollLayer::Paint(PaintContext::ScopedFrame& frame) {
+  SkCanvas& canvas = frame.canvas();
+  canvas.save();
+  canvas.clipRect(viewport_);
+  canvas.concat(ContentTransform());
+  PaintChildren(frame);
+  canvas.restore();
+}
+
+void ScrollLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::Scroll);
+  signature->Add(viewport_);
+  signature->Add(ContentTransform());
+}
+
+void ScrollLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::Scroll, *this);
+  writer->Write(scroll_id_);
+  writer->Write(scroll_offset_);
+  writer->Write(viewport_);
+  writer->Write(content_size_.width());
+  writer->Write(content_size_.height());
+  SerializeChildren(writer);
+}
+
+void ScrollLayer::Deserialize(LayerReader* reader) {
+  scroll_id_ = reader->ReadUInt32();
+  set_offset(reader->ReadPoint());
+  viewport_ = reader->ReadRect();
+  const SkScalar width = reader->ReadScalar();
+  content_size_ = SkSize::Make(width, reader->ReadScalar());
+  DeserializeChildren(reader);
+}
+
+}  // namespace compositor
+}  // namespace sky
@@ -0,0 +1,67 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_SCROLL_LAYER_H_
+#define SKY_COMPOSITOR_SCROLL_LAYER_H_
+
+#include "sky/compositor/container_layer.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace sky {
+namespace compositor {
+
+// Shows the part of its children that |viewport| looks at, with the origin
+// of the children at |offset| from the viewport's top left corner. The
+// compositor moves the offset with the scroll gestures on the viewport by
+// itself, see ScrollController, so the layer paints differently from one
+// frame of the same tree to the next, as animated layers do.
+class ScrollLayer : public ContainerLayer {
+ public:
+  ScrollLayer();
+  ~ScrollLayer() override;
+
+  // Identifies the layer across frames, for the offsets reported back.
+  void set_scroll_id(uint32_t scroll_id) { scroll_id_ = scroll_id; }
+
+  // The offset the app scrolled to.
+  void set_offset(const SkPoint& offset) {
+    offset_ = offset;
+    scroll_offset_ = offset;
+  }
+
+  void set_viewport(const SkRect& viewport) { viewport_ = viewport; }
+
+  // The size of the children's content, past which the layer does not
+  // scroll.
+  void set_content_size(const SkSize& content_size) {
+    content_size_ = content_size;
+  }
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  void Paint(PaintContext::ScopedFrame& frame) override;
+
+  void AppendStateSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
+ private:
+  SkMatrix ContentTransform() const;
+
+  uint32_t scroll_id_;
+  SkPoint offset_;
+  SkRect viewport_;
+  SkSize content_size_;
+  // The offset the compositor scrolled to, for the frame prerolled last.
+  SkPoint scroll_offset_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScrollLayer);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_SCROLL_LAYER_H_
@@ -0,0 +1,134 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/shadow_layer.h"
+
+#include "sky/compositor/damage_tracker.h"
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+#include "third_party/skia/include/core/SkMaskFilter.h"
+#include "third_party/skia/include/effects/SkBlurMaskFilter.h"
+
+namespace sky {
+namespace compositor {
+namespace {
+
+// A Gaussian blur is invisible beyond three standard deviations.
+const SkScalar kBlurExtentInSigmas = 3;
+
+}  // namespace
+
+ShadowLayer::ShadowLayer()
+    : color_(SK_ColorBLACK),
+      blur_sigma_(0),
+      offset_(SkPoint::Make(0, 0)),
+      culled_(false) {
+}
+
+ShadowLayer::~ShadowLayer() {
+}
+
+void ShadowLayer::UpdatePaintBounds() {
+  SkRect bounds = shape_.getBounds();
+  bounds.offset(offset_.x(), offset_.y());
+  const SkScalar extent = blur_sigma_ * kBlurExtentInSigmas;
+  bounds.outset(extent, extent);
+  set_paint_bounds(bounds);
+}
+
+void ShadowLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  image_ = nullptr;
+
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, paint_bounds());
+  culled_ = !device_bounds.intersect(context->cull_rect) ||
+            context->occluded_rect.contains(device_bounds);
+  if (culled_)
+    return;
+
+  if (context->damage_tracker) {
+    LayerSignature key;
+    key.Add(context->ancestor_state);
+    key.Add(matrix);
+    AppendSignature(&key);
+    context->damage_tracker->AddRecord(key.value(), device_bounds);
+  }
+
+  if (!context->raster_cache_enabled)
+    return;
+
+  LayerSignature signature;
+  AppendSignature(&signature);
+
+  PaintContext& paint_context = context->frame.paint_context();
+  image_ = paint_context.rasterizer().GetCachedLayerImageIfPresent(
+      paint_context, context->frame.gr_context(), signature.value(),
+      paint_bounds(), matrix,
+      [this](SkCanvas* canvas) { DrawShadow(canvas); }, &image_rect_);
+}
+
+void ShadowLayer::Paint(PaintContext::ScopedFrame& frame) {
+  if (culled_)
+    return;
+
+  SkCanvas& canvas = frame.canvas();
+
+  if (image_) {
+    // The cached image is already in device space.
+    canvas.save();
+    canvas.resetMatrix();
+    canvas.drawImageRect(
+        image_.get(),
+        SkRect::MakeIWH(image_rect_.width(), image_rect_.height()),
+        SkRect::Make(image_rect_), nullptr);
+    canvas.restore();
+    image_ = nullptr;
+  } else {
+    DrawShadow(&canvas);
+  }
+
+  PaintLayerBounds(frame, paint_bounds());
+}
+
+void ShadowLayer::AppendSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::Shadow);
+  signature->Add(shape_);
+  signature->Add(static_cast<uint32_t>(color_));
+  signature->Add(blur_sigma_);
+  signature->Add(offset_);
+}
+
+void ShadowLayer::DrawShadow(SkCanvas* canvas) const {
+  SkPaint paint;
+  paint.setAntiAlias(true);
+  paint.setColor(color_);
+  if (blur_sigma_ > 0) {
+    RefPtr<SkMaskFilter> blur = adoptRef(SkBlurMaskFilter::Create(
+        kNormal_SkBlurStyle, blur_sigma_,
+        SkBlurMaskFilter::kHighQuality_BlurFlag));
+    paint.setMaskFilter(blur.get());
+  }
+
+  SkRRect shape = shape_;
+  shape.offset(offset_.x(), offset_.y());
+  canvas->drawRRect(shape, paint);
+}
+
+void ShadowLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::Shadow, *this);
+  writer->Write(shape_);
+  writer->Write(static_cast<uint32_t>(color_));
+  writer->Write(blur_sigma_);
+  writer->Write(offset_);
+}
+
+void ShadowLayer::Deserialize(LayerReader* reader) {
+  shape_ = reader->ReadRRect();
+  color_ = reader->ReadUInt32();
+  blur_sigma_ = reader->ReadScalar();
+  offset_ = reader->ReadPoint();
+}
+
+}  // namespace compositor
+}  // namespace sky
@@ -0,0 +1,66 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_SHADOW_LAYER_H_
+#define SKY_COMPOSITOR_SHADOW_LAYER_H_
+
+#include "sky/compositor/layer.h"
+
+namespace sky {
+namespace compositor {
+
+// Draws the blurred shadow of a rounded rect, such as the elevation shadow
+// of a material card. Once the shadow has been stable for long enough it is
+// blurred into the raster cache once and only composited afterwards, rather
+// than being blurred again on every repaint like a mask filter in a picture.
+class ShadowLayer : public Layer {
+ public:
+  ShadowLayer();
+  ~ShadowLayer() override;
+
+  void set_shape(const SkRRect& shape) { shape_ = shape; }
+
+  void set_color(SkColor color) { color_ = color; }
+
+  // The standard deviation of the Gaussian blur, in the layer's coordinate
+  // space.
+  void set_blur_sigma(SkScalar blur_sigma) { blur_sigma_ = blur_sigma; }
+
+  // Where the shadow is drawn relative to |shape|.
+  void set_offset(const SkPoint& offset) { offset_ = offset; }
+
+  // Sets paint_bounds() to the bounds of the blurred shadow. Must be called
+  // after the setters above.
+  void UpdatePaintBounds();
+
+ protected:
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  void Paint(PaintContext::ScopedFrame& frame) override;
+
+  void AppendSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
+ private:
+  void DrawShadow(SkCanvas* canvas) const;
+
+  SkRRect shape_;
+  SkColor color_;
+  SkScalar blur_sigma_;
+  SkPoint offset_;
+
+  bool culled_;
+  RefPtr<SkImage> image_;
+  SkIRect image_rect_;
+
+  DISALLOW_COPY_AND_ASSIGN(ShadowLayer);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_SHADOW_LAYER_H_
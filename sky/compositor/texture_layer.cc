@@ -0,0 +1,90 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/texture_layer.h"
+
+#include "sky/compositor/damage_tracker.h"
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
+namespace sky {
+namespace compositor {
+
+TextureLayer::TextureLayer()
+    : texture_id_(0),
+      offset_(SkPoint::Make(0, 0)),
+      size_(SkSize::Make(0, 0)),
+      frame_count_(0) {
+  SetHasAnimations();
+}
+
+TextureLayer::~TextureLayer() {
+}
+
+void TextureLayer::UpdatePaintBounds() {
+  set_paint_bounds(SkRect::MakeXYWH(offset_.x(), offset_.y(), size_.width(),
+                                    size_.height()));
+}
+
+void TextureLayer::Preroll(PrerollContext* context, const SkMatrix& matrix) {
+  texture_ = nullptr;
+
+  SkRect device_bounds;
+  matrix.mapRect(&device_bounds, paint_bounds());
+  if (!device_bounds.intersect(context->cull_rect) ||
+      context->occluded_rect.contains(device_bounds)) {
+    return;
+  }
+
+  texture_ = context->frame.paint_context().texture_registry().GetTexture(
+      texture_id_, &frame_count_);
+  if (!texture_)
+    return;
+
+  // Every new frame of the texture damages the layer.
+  if (context->damage_tracker) {
+    LayerSignature key;
+    key.Add(context->ancestor_state);
+    key.Add(matrix);
+    AppendSignature(&key);
+    key.Add(frame_count_);
+    context->damage_tracker->AddRecord(key.value(), device_bounds);
+  }
+}
+
+void TextureLayer::Paint(PaintContext::ScopedFrame& frame) {
+  if (!texture_)
+    return;
+
+  texture_->Paint(frame.canvas(), frame.gr_context(), paint_bounds(),
+                  frame_count_);
+  texture_ = nullptr;
+
+  PaintLayerBounds(frame, paint_bounds());
+}
+
+void TextureLayer::AppendSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::Texture);
+  signature->Add(texture_id_);
+  signature->Add(paint_bounds());
+}
+
+void TextureLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::Texture, *this);
+  writer->Write(texture_id_);
+  writer->Write(offset_);
+  writer->Write(size_.width());
+  writer->Write(size_.height());
+}
+
+void TextureLayer::Deserialize(LayerReader* reader) {
+  texture_id_ = reader->ReadUInt32();
+  offset_ = reader->ReadPoint();
+  const SkScalar width = reader->ReadScalar();
+  const SkScalar height = reader->ReadScalar();
+  size_ = SkSize::Make(width, height);
+}
+
+}  // namespace compositor
+}  // namespace sky
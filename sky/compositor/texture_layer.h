@@ -0,0 +1,61 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_TEXTURE_LAYER_H_
+#define SKY_COMPOSITOR_TEXTURE_LAYER_H_
+
+#include "sky/compositor/layer.h"
+#include "sky/compositor/texture_registry.h"
+#include "third_party/skia/include/core/SkSize.h"
+
+namespace sky {
+namespace compositor {
+
+// Draws the newest frame of an external texture registered with the
+// TextureRegistry of the PaintContext, such as a video or a camera preview.
+// The frames change without the tree changing, so the layer paints
+// differently from one frame of the same tree to the next, as animated
+// layers do. Draws nothing while no texture is registered as its id.
+class TextureLayer : public Layer {
+ public:
+  TextureLayer();
+  ~TextureLayer() override;
+
+  void set_texture_id(uint32_t texture_id) { texture_id_ = texture_id; }
+
+  void set_offset(const SkPoint& offset) { offset_ = offset; }
+
+  void set_size(const SkSize& size) { size_ = size; }
+
+  // Sets paint_bounds() to the rect the frames are drawn into. Must be
+  // called after the setters above.
+  void UpdatePaintBounds();
+
+ protected:
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
+
+  void Paint(PaintContext::ScopedFrame& frame) override;
+
+  void AppendSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
+ private:
+  uint32_t texture_id_;
+  SkPoint offset_;
+  SkSize size_;
+
+  // The texture to paint, looked up in preroll.
+  scoped_refptr<ExternalTexture> texture_;
+  uint32_t frame_count_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextureLayer);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_TEXTURE_LAYER_H_
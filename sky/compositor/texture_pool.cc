@@ -0,0 +1,172 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/texture_pool.h"
+
+#include "base/logging.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+#include <iterator>
+
+namespace sky {
+namespace compositor {
+namespace {
+
+const size_t kDefaultMaxIdleBytes = 16 * 1024 * 1024;
+
+// Pool textures are always kRGBA_8888_GrPixelConfig.
+size_t TextureBytes(const GrTexture* texture) {
+  return static_cast<size_t>(texture->width()) * texture->height() * 4;
+}
+
+int RoundUpToBucket(int dimension) {
+  const int granularity = TexturePool::kBucketGranularity;
+  return ((dimension + granularity - 1) / granularity) * granularity;
+}
+
+struct PooledTexture {
+  scoped_refptr<TexturePool> pool;
+  GrTexture* texture;
+};
+
+}  // namespace
+
+TexturePool::TexturePool()
+    : idle_bytes_(0), max_idle_bytes_(kDefaultMaxIdleBytes) {
+}
+
+TexturePool::~TexturePool() {
+  base::AutoLock lock(lock_);
+  TrimLocked(0);
+}
+
+SkISize TexturePool::BucketSize(int width, int height) {
+  return SkISize::Make(RoundUpToBucket(width), RoundUpToBucket(height));
+}
+
+RefPtr<GrTexture> TexturePool::Acquire(GrContext* gr_context,
+                                       int width,
+                                       int height) {
+  DCHECK(gr_context);
+  const SkISize size = BucketSize(width, height);
+
+  {
+    base::AutoLock lock(lock_);
+    // Prefer the most recently recycled texture since it is the most likely
+    // to still be resident.
+    for (auto it = idle_textures_.rbegin(); it != idle_textures_.rend();
+         ++it) {
+      GrTexture* texture = *it;
+      if (texture->getContext() == gr_context &&
+          texture->width() == size.width() &&
+          texture->height() == size.height()) {
+        idle_textures_.erase(std::next(it).base());
+        idle_bytes_ -= TextureBytes(texture);
+        return adoptRef(texture);
+      }
+    }
+  }
+
+  GrSurfaceDesc desc;
+  desc.fWidth = size.width();
+  desc.fHeight = size.height();
+  desc.fFlags = kRenderTarget_GrSurfaceFlag;
+  desc.fConfig = kRGBA_8888_GrPixelConfig;
+
+  return adoptRef(gr_context->textureProvider()->createTexture(desc, true));
+}
+
+RefPtr<SkImage> TexturePool::CreateImage(GrContext* gr_context,
+                                         PassRefPtr<GrTexture> texture) {
+  GrTexture* raw_texture = texture.leakRef();
+  DCHECK(raw_texture);
+
+  GrBackendTextureDesc desc;
+  desc.fFlags = kRenderTarget_GrBackendTextureFlag;
+  desc.fWidth = raw_texture->width();
+  desc.fHeight = raw_texture->height();
+  desc.fConfig = raw_texture->config();
+  desc.fSampleCnt = 0;
+  desc.fTextureHandle = raw_texture->getTextureHandle();
+
+  PooledTexture* pooled = new PooledTexture();
+  pooled->pool = this;
+  pooled->texture = raw_texture;
+
+  RefPtr<SkImage> image = adoptRef(SkImage::NewFromTexture(
+      gr_context, desc, kPremul_SkAlphaType, &ImageReleaseProc, pooled));
+
+  if (!image) {
+    // The release proc is not called when the image cannot be created.
+    Recycle(raw_texture);
+    delete pooled;
+  }
+
+  return image;
+}
+
+void TexturePool::ImageReleaseProc(SkImage::ReleaseContext context) {
+  DCHECK(context);
+  PooledTexture* pooled = reinterpret_cast<PooledTexture*>(context);
+  pooled->pool->Recycle(pooled->texture);
+  delete pooled;
+}
+
+void TexturePool::Recycle(GrTexture* texture) {
+  base::AutoLock lock(lock_);
+
+  // Textures of an abandoned context can never be used again.
+  if (texture->wasDestroyed()) {
+    texture->unref();
+    return;
+  }
+
+  idle_textures_.push_back(texture);
+  idle_bytes_ += TextureBytes(texture);
+  TrimLocked(max_idle_bytes_);
+}
+
+void TexturePool::set_max_idle_bytes(size_t max_idle_bytes) {
+  base::AutoLock lock(lock_);
+  max_idle_bytes_ = max_idle_bytes;
+  TrimLocked(max_idle_bytes_);
+}
+
+size_t TexturePool::idle_bytes() {
+  base::AutoLock lock(lock_);
+  return idle_bytes_;
+}
+
+void TexturePool::Clear() {
+  base::AutoLock lock(lock_);
+  TrimLocked(0);
+}
+
+void TexturePool::OnMemoryPressure(
+    base::MemoryPressureListener::MemoryPressureLevel level) {
+  base::AutoLock lock(lock_);
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      TrimLocked(idle_bytes_ / 2);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      TrimLocked(0);
+      break;
+  }
+}
+
+void TexturePool::TrimLocked(size_t byte_budget) {
+  lock_.AssertAcquired();
+  while (idle_bytes_ > byte_budget && !idle_textures_.empty()) {
+    GrTexture* texture = idle_textures_.front();
+    idle_textures_.pop_front();
+    idle_bytes_ -= TextureBytes(texture);
+    texture->unref();
+  }
+}
+
+}  // namespace compositor
+}  // namespace sky
@@ -0,0 +1,88 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_TEXTURE_POOL_H_
+#define SKY_COMPOSITOR_TEXTURE_POOL_H_
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSize.h"
+#include "third_party/skia/include/gpu/GrTexture.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefPtr.h"
+
+#include <deque>
+
+class GrContext;
+
+namespace sky {
+namespace compositor {
+
+// Recycles the render target textures used for offscreen rasterization.
+// Requested sizes are rounded up to a multiple of |kBucketGranularity| so
+// that contents of similar sizes share textures. Callers must only read back
+// the requested part of a texture.
+//
+// Images created by the pool return their texture to it when they are
+// destroyed, which may happen on any thread.
+class TexturePool : public base::RefCountedThreadSafe<TexturePool> {
+ public:
+  static const int kBucketGranularity = 64;
+
+  TexturePool();
+
+  // Returns the size of the textures handed out for |width| by |height|.
+  static SkISize BucketSize(int width, int height);
+
+  // Returns a render target texture of BucketSize(|width|, |height|) for use
+  // with |gr_context|. Its contents are undefined. Returns nullptr if no
+  // texture could be allocated.
+  RefPtr<GrTexture> Acquire(GrContext* gr_context, int width, int height);
+
+  // Wraps |texture| in an image that recycles the texture once the image is
+  // destroyed.
+  RefPtr<SkImage> CreateImage(GrContext* gr_context,
+                              PassRefPtr<GrTexture> texture);
+
+  // Idle textures beyond |max_idle_bytes| are freed, least recently used
+  // first.
+  void set_max_idle_bytes(size_t max_idle_bytes);
+
+  size_t idle_bytes();
+
+  // Frees all idle textures. Must be called before the GrContext the
+  // textures belong to is abandoned.
+  void Clear();
+
+  void OnMemoryPressure(
+      base::MemoryPressureListener::MemoryPressureLevel level);
+
+ private:
+  friend class base::RefCountedThreadSafe<TexturePool>;
+
+  ~TexturePool();
+
+  static void ImageReleaseProc(SkImage::ReleaseContext context);
+
+  void Recycle(GrTexture* texture);
+
+  // Must be called with |lock_| held.
+  void TrimLocked(size_t byte_budget);
+
+  base::Lock lock_;
+  // Owned references, least recently recycled first.
+  std::deque<GrTexture*> idle_textures_;
+  size_t idle_bytes_;
+  size_t max_idle_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(TexturePool);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_TEXTURE_POOL_H_
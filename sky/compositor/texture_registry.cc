@@ -0,0 +1,107 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/compositor/texture_registry.h"
+
+#include "base/logging.h"
+
+namespace sky {
+namespace compositor {
+
+ExternalTexture::ExternalTexture() {
+}
+
+ExternalTexture::~ExternalTexture() {
+}
+
+TextureRegistry::TextureRegistry() : next_texture_id_(1), frame_count_(0) {
+}
+
+TextureRegistry::~TextureRegistry() {
+}
+
+uint32_t TextureRegistry::RegisterTexture(
+    scoped_refptr<ExternalTexture> texture) {
+  DCHECK(texture);
+  base::AutoLock lock(lock_);
+  const uint32_t texture_id = next_texture_id_++;
+  textures_[texture_id] = {texture, 0};
+  return texture_id;
+}
+
+void TextureRegistry::UnregisterTexture(uint32_t texture_id) {
+  base::AutoLock lock(lock_);
+  auto it = textures_.find(texture_id);
+  if (it == textures_.end())
+    return;
+  unregistered_textures_.push_back(it->second.texture);
+  textures_.erase(it);
+}
+
+scoped_refptr<ExternalTexture> TextureRegistry::GetTexture(
+    uint32_t texture_id,
+    uint32_t* frame_count) const {
+  base::AutoLock lock(lock_);
+  auto it = textures_.find(texture_id);
+  if (it == textures_.end())
+    return nullptr;
+  *frame_count = it->second.frame_count;
+  return it->second.texture;
+}
+
+void TextureRegistry::MarkFrameAvailable(uint32_t texture_id) {
+  base::Closure callback;
+  {
+    base::AutoLock lock(lock_);
+    auto it = textures_.find(texture_id);
+    if (it == textures_.end())
+      return;
+    ++it->second.frame_count;
+    ++frame_count_;
+    callback = frame_available_callback_;
+  }
+  if (!callback.is_null())
+    callback.Run();
+}
+
+void TextureRegistry::set_frame_available_callback(
+    const base::Closure& callback) {
+  base::AutoLock lock(lock_);
+  frame_available_callback_ = callback;
+}
+
+bool TextureRegistry::has_textures() const {
+  base::AutoLock lock(lock_);
+  return !textures_.empty();
+}
+
+uint64_t TextureRegistry::frame_count() const {
+  base::AutoLock lock(lock_);
+  return frame_count_;
+}
+
+void TextureRegistry::ReleaseUnregisteredTextures() {
+  std::vector<scoped_refptr<ExternalTexture>> textures;
+  {
+    base::AutoLock lock(lock_);
+    textures.swap(unregistered_textures_);
+  }
+  for (const auto& texture : textures)
+    texture->ReleaseGLResources();
+}
+
+void TextureRegistry::ReleaseGLResources() {
+  ReleaseUnregisteredTextures();
+  std::vector<scoped_refptr<ExternalTexture>> textures;
+  {
+    base::AutoLock lock(lock_);
+    for (const auto& entry : textures_)
+      textures.push_back(entry.second.texture);
+  }
+  for (const auto& texture : textures)
+    texture->ReleaseGLResources();
+}
+
+}  // namespace compositor
+}  // namespace sky
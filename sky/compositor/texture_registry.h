@@ -0,0 +1,115 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_COMPOSITOR_TEXTURE_REGISTRY_H_
+#define SKY_COMPOSITOR_TEXTURE_REGISTRY_H_
+
+#include <stdint.h>
+
+#include <map>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+class GrContext;
+class SkCanvas;
+
+namespace sky {
+namespace compositor {
+
+// A texture whose frames are produced outside of the compositor, such as by
+// a video decoder or a camera, and drawn by TextureLayers straight from the
+// GPU memory they were produced into.
+class ExternalTexture : public base::RefCountedThreadSafe<ExternalTexture> {
+ public:
+  // Draws the newest frame into |bounds|. |frame_count| is the number of
+  // frames the producer has made available so far, so that the texture
+  // knows when to latch a new one. Called on the GPU thread with the GL
+  // context of |gr_context| current.
+  virtual void Paint(SkCanvas& canvas,
+                     GrContext* gr_context,
+                     const SkRect& bounds,
+                     uint32_t frame_count) = 0;
+
+  // Frees the GL objects the texture created while painting, on the GPU
+  // thread with their context current, before the context goes away or once
+  // the texture is unregistered. Painting again creates them again.
+  virtual void ReleaseGLResources() = 0;
+
+ protected:
+  friend class base::RefCountedThreadSafe<ExternalTexture>;
+  ExternalTexture();
+  virtual ~ExternalTexture();
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(ExternalTexture);
+};
+
+// Hands out the ids TextureLayers refer to external textures by. Textures
+// are registered and their frames announced on the threads of their
+// producers, and drawn on the GPU thread.
+class TextureRegistry : public base::RefCountedThreadSafe<TextureRegistry> {
+ public:
+  TextureRegistry();
+
+  // Returns the id of |texture|, which is never 0.
+  uint32_t RegisterTexture(scoped_refptr<ExternalTexture> texture);
+
+  // The texture is kept until ReleaseUnregisteredTextures() frees its GL
+  // objects on the GPU thread.
+  void UnregisterTexture(uint32_t texture_id);
+
+  // Returns null if no texture is registered as |texture_id|. Otherwise sets
+  // |*frame_count| to the number of frames made available for it.
+  scoped_refptr<ExternalTexture> GetTexture(uint32_t texture_id,
+                                            uint32_t* frame_count) const;
+
+  // Called by the producer of |texture_id| whenever it made a new frame
+  // available. Runs the frame available callback on the calling thread.
+  void MarkFrameAvailable(uint32_t texture_id);
+
+  // Run whenever a frame is made available, so that the compositor draws
+  // the last tree again.
+  void set_frame_available_callback(const base::Closure& callback);
+
+  // Whether any texture is registered.
+  bool has_textures() const;
+
+  // The number of frames made available for all textures so far.
+  uint64_t frame_count() const;
+
+  // Frees the GL objects of the textures unregistered since the last call.
+  // Called on the GPU thread with the context current.
+  void ReleaseUnregisteredTextures();
+
+  // Frees the GL objects of every texture, for when the context goes away.
+  void ReleaseGLResources();
+
+ private:
+  friend class base::RefCountedThreadSafe<TextureRegistry>;
+  ~TextureRegistry();
+
+  struct Entry {
+    scoped_refptr<ExternalTexture> texture;
+    uint32_t frame_count;
+  };
+
+  mutable base::Lock lock_;
+  std::map<uint32_t, Entry> textures_;
+  std::vector<scoped_refptr<ExternalTexture>> unregistered_textures_;
+  uint32_t next_texture_id_;
+  uint64_t frame_count_;
+  base::Closure frame_available_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(TextureRegistry);
+};
+
+}  // namespace compositor
+}  // namespace sky
+
+#endif  // SKY_COMPOSITOR_TEXTURE_REGISTRY_H_
@@ -4,22 +4,99 @@
 
 #include "sky/compositor/transform_layer.h"
 
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_signature.h"
+
 namespace sky {
 namespace compositor {
 
-TransformLayer::TransformLayer() {
+TransformLayer::TransformLayer()
+    : animation_origin_(SkPoint::Make(0, 0)) {
+  transform_.reset();
+  animated_transform_.reset();
 }
 
 TransformLayer::~TransformLayer() {
 }
 
+void TransformLayer::set_animation(
+    AnimatedProperty property,
+    std::shared_ptr<const LayerAnimation> animation) {
+  const size_t index = static_cast<size_t>(property);
+  DCHECK(index < kAnimatedPropertyCount);
+  animations_[index] = std::move(animation);
+  if (animations_[index])
+    SetHasAnimations();
+}
+
+bool TransformLayer::HasOwnAnimations() const {
+  for (const auto& animation : animations_) {
+    if (animation)
+      return true;
+  }
+  return false;
+}
+
+float TransformLayer::AnimatedValue(PrerollContext* context,
+                                    AnimatedProperty property,
+                                    float default_value) const {
+  const LayerAnimation* animation =
+      animations_[static_cast<size_t>(property)].get();
+  if (!animation)
+    return default_value;
+  if (animation->IsRunningAt(context->animation_time))
+    context->animations_running = true;
+  return animation->ValueAt(context->animation_time);
+}
+
+void TransformLayer::Preroll(PrerollContext* context,
+                             const SkMatrix& matrix) {
+  if (HasOwnAnimations()) {
+    animated_transform_ = transform_;
+    const float dx =
+        AnimatedValue(context, AnimatedProperty::kTranslateX, 0);
+    const float dy =
+        AnimatedValue(context, AnimatedProperty::kTranslateY, 0);
+    const float scale = AnimatedValue(context, AnimatedProperty::kScale, 1);
+    const float rotation =
+        AnimatedValue(context, AnimatedProperty::kRotation, 0);
+    animated_transform_.preTranslate(dx + animation_origin_.x(),
+                                     dy + animation_origin_.y());
+    animated_transform_.preRotate(SkRadiansToDegrees(rotation));
+    animated_transform_.preScale(scale, scale);
+    animated_transform_.preTranslate(-animation_origin_.x(),
+                                     -animation_origin_.y());
+  }
+
+  SkMatrix child_matrix;
+  child_matrix.setConcat(matrix, animated_transform_);
+  PrerollChildren(context, child_matrix);
+}
+
 void TransformLayer::Paint(PaintContext::ScopedFrame& frame) {
   SkCanvas& canvas = frame.canvas();
   canvas.save();
-  canvas.concat(transform_);
+  canvas.concat(animated_transform_);
   PaintChildren(frame);
   canvas.restore();
 }
 
+void TransformLayer::AppendStateSignature(LayerSignature* signature) const {
+  signature->Add(LayerSignature::Tag::Transform);
+  signature->Add(animated_transform_);
+}
+
+void TransformLayer::Serialize(LayerWriter* writer) const {
+  writer->BeginLayer(LayerSignature::Tag::Transform, *this);
+  writer->Write(animated_transform_);
+  SerializeChildren(writer);
+}
+
+void TransformLayer::Deserialize(LayerReader* reader) {
+  transform_ = reader->ReadMatrix();
+  animated_transform_ = transform_;
+  DeserializeChildren(reader);
+}
+
 }  // namespace compositor
 }  // namespace sky
@@ -5,7 +5,10 @@
 #ifndef SKY_COMPOSITOR_TRANSFORM_LAYER_H_
 #define SKY_COMPOSITOR_TRANSFORM_LAYER_H_
 
+#include <memory>
+
 #include "sky/compositor/container_layer.h"
+#include "sky/compositor/layer_animation.h"
 
 namespace sky {
 namespace compositor {
@@ -15,12 +18,55 @@ class TransformLayer : public ContainerLayer {
   TransformLayer();
   ~TransformLayer() override;
 
-  void set_transform(const SkMatrix& transform) { transform_ = transform; }
+  // The properties an animation can move the children by, in their own
+  // coordinate space.
+  enum class AnimatedProperty {
+    kTranslateX,
+    kTranslateY,
+    kScale,
+    // In radians, clockwise.
+    kRotation,
+  };
+
+  void set_transform(const SkMatrix& transform) {
+    transform_ = transform;
+    animated_transform_ = transform;
+  }
+
+  // Animates |property| at the time every frame is shown. The animations
+  // move the children before the transform maps them, and scale and rotate
+  // them around |animation_origin|.
+  void set_animation(AnimatedProperty property,
+                     std::shared_ptr<const LayerAnimation> animation);
+
+  void set_animation_origin(const SkPoint& origin) {
+    animation_origin_ = origin;
+  }
+
+  void Preroll(PrerollContext* context, const SkMatrix& matrix) override;
 
   void Paint(PaintContext::ScopedFrame& frame) override;
 
+  void AppendStateSignature(LayerSignature* signature) const override;
+
+  void Serialize(LayerWriter* writer) const override;
+
+  void Deserialize(LayerReader* reader) override;
+
  private:
+  static const size_t kAnimatedPropertyCount = 4;
+
+  bool HasOwnAnimations() const;
+  float AnimatedValue(PrerollContext* context,
+                      AnimatedProperty property,
+                      float default_value) const;
+
   SkMatrix transform_;
+  std::shared_ptr<const LayerAnimation> animations_[kAnimatedPropertyCount];
+  SkPoint animation_origin_;
+  // The transform with the animations applied, for the frame prerolled
+  // last.
+  SkMatrix animated_transform_;
 
   DISALLOW_COPY_AND_ASSIGN(TransformLayer);
 };
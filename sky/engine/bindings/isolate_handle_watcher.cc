@@ -0,0 +1,89 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/bindings/isolate_handle_watcher.h"
+
+#include "base/bind.h"
+#include "dart/runtime/include/dart_native_api.h"
+#include "mojo/message_pump/handle_watcher.h"
+#include "mojo/public/cpp/system/core.h"
+#include "sky/engine/tonic/dart_state.h"
+
+namespace blink {
+namespace {
+
+int kIsolateHandleWatcherKey = 0;
+
+IsolateHandleWatcher* GetIsolateHandleWatcher(DartState* dart_state) {
+  return static_cast<IsolateHandleWatcher*>(
+      dart_state->GetUserData(&kIsolateHandleWatcherKey));
+}
+
+}  // namespace
+
+IsolateHandleWatcher::IsolateHandleWatcher() {
+}
+
+IsolateHandleWatcher::~IsolateHandleWatcher() {
+}
+
+IsolateHandleWatcher* IsolateHandleWatcher::From(DartState* dart_state) {
+  IsolateHandleWatcher* watcher = GetIsolateHandleWatcher(dart_state);
+  if (!watcher) {
+    watcher = new IsolateHandleWatcher();
+    dart_state->SetUserData(&kIsolateHandleWatcherKey, watcher);
+  }
+  return watcher;
+}
+
+void IsolateHandleWatcher::DidCloseHandle(DartState* dart_state,
+                                          MojoHandle handle) {
+  if (!dart_state)
+    return;
+  if (IsolateHandleWatcher* watcher = GetIsolateHandleWatcher(dart_state))
+    watcher->Cancel(handle);
+}
+
+void IsolateHandleWatcher::Watch(MojoHandle handle,
+                                 MojoHandleSignals signals,
+                                 Dart_Port port) {
+  std::unique_ptr<mojo::common::HandleWatcher>& watcher = watchers_[handle];
+  if (!watcher)
+    watcher.reset(new mojo::common::HandleWatcher());
+  // The watcher is owned by this object and stopped when it is destroyed, so
+  // the callback never outlives it.
+  watcher->Start(mojo::Handle(handle), signals, MOJO_DEADLINE_INDEFINITE,
+                 base::Bind(&IsolateHandleWatcher::OnHandleReady,
+                            base::Unretained(this), handle, signals, port));
+}
+
+void IsolateHandleWatcher::Cancel(MojoHandle handle) {
+  watchers_.erase(handle);
+}
+
+void IsolateHandleWatcher::OnHandleReady(MojoHandle handle,
+                                         MojoHandleSignals signals,
+                                         Dart_Port port,
+                                         MojoResult result) {
+  // The stopped watcher stays in |watchers_| because it cannot be destroyed
+  // from its own callback. It is reused by the next Watch() on the handle
+  // and dropped when the handle is closed.
+  if (result == MOJO_RESULT_INVALID_ARGUMENT || result == MOJO_RESULT_ABORTED)
+    return;
+
+  // A handle whose peer has closed can never satisfy |signals| again, which
+  // the receiver learns from the peer closed bit.
+  MojoHandleSignalsState state;
+  MojoResult wait_result = mojo::Wait(mojo::Handle(handle), signals, 0, &state);
+  if (!mojo::WaitManyResult(wait_result).AreSignalsStatesValid())
+    return;
+  MojoHandleSignals satisfied =
+      state.satisfied_signals & (signals | MOJO_HANDLE_SIGNAL_PEER_CLOSED);
+
+  // Fails only if the port has been closed, in which case nobody wants to
+  // hear about the handle anymore.
+  Dart_PostInteger(port, satisfied);
+}
+
+}  // namespace blink
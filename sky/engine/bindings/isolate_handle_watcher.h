@@ -0,0 +1,65 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_BINDINGS_ISOLATE_HANDLE_WATCHER_H_
+#define SKY_ENGINE_BINDINGS_ISOLATE_HANDLE_WATCHER_H_
+
+#include <memory>
+#include <unordered_map>
+
+#include "base/macros.h"
+#include "base/supports_user_data.h"
+#include "dart/runtime/include/dart_api.h"
+#include "mojo/public/c/system/types.h"
+
+namespace mojo {
+namespace common {
+class HandleWatcher;
+}
+}
+
+namespace blink {
+class DartState;
+
+// IsolateHandleWatcher watches Mojo handles for an isolate on the thread the
+// isolate runs on. When a handle becomes ready, the satisfied signals are
+// posted to the port that asked to watch it, the same message the handle
+// watcher isolate sends.
+//
+// On a thread that runs a MessagePumpMojo the handles are waited on by the
+// pump itself, so a message for the isolate costs neither a hop to the
+// watcher isolate's thread nor the control messages to and from it.
+//
+// Like the watcher isolate, each watch fires once and has to be renewed by
+// the receiver.
+class IsolateHandleWatcher : public base::SupportsUserData::Data {
+ public:
+  ~IsolateHandleWatcher() override;
+
+  static IsolateHandleWatcher* From(DartState* dart_state);
+  // Drops the watch on a handle that is being closed, without creating an
+  // IsolateHandleWatcher for isolates that never used one.
+  static void DidCloseHandle(DartState* dart_state, MojoHandle handle);
+
+  // Replaces any watch on |handle|.
+  void Watch(MojoHandle handle, MojoHandleSignals signals, Dart_Port port);
+  void Cancel(MojoHandle handle);
+
+ private:
+  IsolateHandleWatcher();
+
+  void OnHandleReady(MojoHandle handle,
+                     MojoHandleSignals signals,
+                     Dart_Port port,
+                     MojoResult result);
+
+  std::unordered_map<MojoHandle, std::unique_ptr<mojo::common::HandleWatcher>>
+      watchers_;
+
+  DISALLOW_COPY_AND_ASSIGN(IsolateHandleWatcher);
+};
+
+}  // namespace blink
+
+#endif  // SKY_ENGINE_BINDINGS_ISOLATE_HANDLE_WATCHER_H_
@@ -63,8 +63,14 @@ def method_context(interface, method):
 
     is_auto_scope = not 'DartNoAutoScope' in extended_attributes
 
-    arguments_data = [argument_context(interface, method, argument, index)
-                      for index, argument in enumerate(arguments)]
+    unbox_arguments = can_unbox_arguments(method)
+    arguments_data = []
+    arg_index = 0 if method.is_static else 1
+    for index, argument in enumerate(arguments):
+        argument_data = argument_context(interface, method, argument, index,
+                                         arg_index, unbox_arguments)
+        arguments_data.append(argument_data)
+        arg_index += len(argument_data['unboxed_fields']) or 1
 
     union_arguments = []
     if idl_type.union_arguments:
@@ -79,6 +85,8 @@ def method_context(interface, method):
         'cpp_value': this_cpp_value,
         'dart_type': dart_types.idl_type_to_dart_type(idl_type),
         'dart_name': extended_attributes.get('DartName'),
+        'has_unboxed_arguments':
+            any(argument['unboxed_fields'] for argument in arguments_data),
         'has_exception_state':
             context['is_raises_exception'] or
             any(argument for argument in arguments
@@ -99,14 +107,30 @@ def method_context(interface, method):
     })
     return context
 
-def argument_context(interface, method, argument, index):
+# Methods whose Point, Offset and Size arguments are passed to the native as
+# their fields. The Dart side of these methods is a wrapper that unpacks the
+# arguments, so only methods that are called with a fixed argument list
+# qualify.
+def can_unbox_arguments(method):
+    extended_attributes = method.extended_attributes
+    return not (method.is_constructor or
+                method.is_static or
+                'Custom' in extended_attributes or
+                'DartCustom' in extended_attributes or
+                any(argument.is_optional for argument in method.arguments))
+
+
+def argument_context(interface, method, argument, index, arg_index=None,
+                     unbox=False):
     context = v8_methods.argument_context(interface, method, argument, index)
 
     extended_attributes = argument.extended_attributes
     idl_type = argument.idl_type
     this_cpp_value = cpp_value(interface, method, index)
     auto_scope = not 'DartNoAutoScope' in extended_attributes
-    arg_index = index + 1 if not method.is_static else index
+    if arg_index is None:
+        arg_index = index + 1 if not method.is_static else index
+    unboxed_fields = dart_types.unboxed_value_type_fields(idl_type) if unbox else ()
     preprocessed_type = str(idl_type.preprocessed_type)
     local_cpp_type = idl_type.cpp_type_args(argument.extended_attributes, raw_type=True)
     default_value = argument.default_cpp_value
@@ -135,10 +159,15 @@ def argument_context(interface, method, argument, index):
                                                                       this_cpp_value, for_main_world=True),
         'dart_set_return_value': dart_set_return_value(interface.name, method, this_cpp_value),
         'arg_index': arg_index,
+        'unboxed_fields': unboxed_fields,
         'dart_value_to_local_cpp_value': dart_value_to_local_cpp_value(interface,
                                                                        context['has_type_checking_interface'],
                                                                        argument, arg_index, auto_scope),
     })
+    if unboxed_fields:
+        context['dart_value_to_local_cpp_value'] = (
+            'DartConverter<%s>::FromUnboxedArguments(args, %d, exception)' %
+            (local_cpp_type, arg_index))
     return context
 
 
@@ -155,7 +184,7 @@ def cpp_value(interface, method, number_of_arguments):
             return '%s.get()' % argument_name
 
         # TODO(eseidel): This should check cpp_type.endswith('Handle')
-        if idl_type.name == 'MojoDataPipeConsumer':
+        if idl_type.name in ('MojoDataPipeConsumer', 'MojoDataPipeProducer'):
             return '%s.Pass()' % argument_name
 
         if idl_type.is_callback_interface:
@@ -118,12 +118,16 @@ CPP_SPECIAL_CONVERSION_RULES = {
     # dart_value_to_cpp_value using CPP_SPECIAL_CONVERSION_RULES directly
     # instead of calling cpp_type.
     'Float32List': 'Float32List',
+    'Float64List': 'Float64List',
+    'Int32List': 'Int32List',
+    'Uint8List': 'Uint8List',
     'Offset': 'Offset',
     'Paint': 'Paint',
     'Point': 'Point',
     'Rect': 'Rect',
     'Size': 'Size',
     'MojoDataPipeConsumer': 'mojo::ScopedDataPipeConsumerHandle',
+    'MojoDataPipeProducer': 'mojo::ScopedDataPipeProducerHandle',
     'TileMode': 'SkShader::TileMode',
     'TransferMode': 'SkXfermode::Mode',
     'VertexMode': 'SkCanvas::VertexMode',
@@ -136,6 +140,7 @@ CPP_SPECIAL_CONVERSION_RULES = {
     'TextBaseline': 'int',
     'TextDecoration': 'int',
     'TextDecorationStyle': 'int',
+    'VelocityEstimator': 'int',
 }
 
 
@@ -270,6 +275,7 @@ INCLUDES_FOR_TYPE = {
                      'sky/engine/core/dom/StaticNodeList.h']),
     'DartValue': set(['sky/engine/tonic/dart_value.h']),
     'MojoDataPipeConsumer': set(['sky/engine/tonic/mojo_converter.h']),
+    'MojoDataPipeProducer': set(['sky/engine/tonic/mojo_converter.h']),
 }
 
 
@@ -379,6 +385,9 @@ DART_TO_CPP_VALUE = {
     # Pass-by-value types.
     'Color': pass_by_value_format('CanvasColor'),
     'Float32List': pass_by_value_format('Float32List'),
+    'Float64List': pass_by_value_format('Float64List'),
+    'Int32List': pass_by_value_format('Int32List'),
+    'Uint8List': pass_by_value_format('Uint8List'),
     'Offset': pass_by_value_format('Offset'),
     'Paint': pass_by_value_format('Paint'),
     'Point': pass_by_value_format('Point'),
@@ -396,7 +405,9 @@ DART_TO_CPP_VALUE = {
     'TextBaseline': pass_by_value_format('TextBaseline', ''),
     'TextDecoration': pass_by_value_format('TextDecoration', ''),
     'TextDecorationStyle': pass_by_value_format('TextDecorationStyle', ''),
+    'VelocityEstimator': pass_by_value_format('VelocityEstimator', ''),
     'MojoDataPipeConsumer': pass_by_value_format('mojo::ScopedDataPipeConsumerHandle'),
+    'MojoDataPipeProducer': pass_by_value_format('mojo::ScopedDataPipeProducerHandle'),
 }
 
 def dart_value_to_cpp_value(idl_type, extended_attributes, variable_name,
@@ -459,6 +470,22 @@ INNER_TYPE_FOR_ARRAY = {
     'SkColor': 'CanvasColor'
 }
 
+# Value types that the generated Dart code passes to natives as their double
+# fields rather than as an instance. The bindings then read each field with
+# Dart_GetNativeDoubleArgument instead of looking it up with Dart_GetField.
+UNBOXED_VALUE_TYPE_FIELDS = {
+    'Offset': ('dx', 'dy'),
+    'Point': ('x', 'y'),
+    'Size': ('width', 'height'),
+}
+
+
+def unboxed_value_type_fields(idl_type):
+    if idl_type.is_nullable:
+        return ()
+    return UNBOXED_VALUE_TYPE_FIELDS.get(idl_type.name, ())
+
+
 def dart_value_to_cpp_value_array_or_sequence(native_array_element_type, variable_name, index):
     # Index is None for setters, index (starting at 0) for method arguments,
     # and is used to provide a human-readable exception message
@@ -531,6 +558,7 @@ IDL_TO_DART_TYPE = {
     'void': 'void',
     'unsigned long': 'int',
     'MojoDataPipeConsumer': 'int',
+    'MojoDataPipeProducer': 'int',
 }
 
 def idl_type_to_dart_type(idl_type):
@@ -664,6 +692,9 @@ DART_SET_RETURN_VALUE = {
     'TypedList': 'Dart_SetReturnValue(args, DartUtilities::arrayBufferViewToDart({cpp_value}))',
     'Color': 'DartConverter<CanvasColor>::SetReturnValue(args, {cpp_value})',
     'Float32List': 'DartConverter<Float32List>::SetReturnValue(args, {cpp_value})',
+    'Float64List': 'DartConverter<Float64List>::SetReturnValue(args, {cpp_value})',
+    'Int32List': 'DartConverter<Int32List>::SetReturnValue(args, {cpp_value})',
+    'Uint8List': 'DartConverter<Uint8List>::SetReturnValue(args, {cpp_value})',
 }
 
 
@@ -762,6 +793,11 @@ CPP_VALUE_TO_DART_VALUE = {
     # We need to generate the NullCheck version in some cases.
     'ScriptPromise': 'DartUtilities::scriptPromiseToDart({cpp_value})',
     'DartValue': 'DartConverter<DartValue*>::ToDart({cpp_value})',
+    # Typed lists are created (and released) by the caller.
+    'Float32List': '{cpp_value}.dart_handle()',
+    'Float64List': '{cpp_value}.dart_handle()',
+    'Int32List': '{cpp_value}.dart_handle()',
+    'Uint8List': '{cpp_value}.dart_handle()',
     # General
     'array': 'VectorToDart({cpp_value})',
     'DOMWrapper': 'DartConverter<{cpp_type}>::ToDart({cpp_value})',
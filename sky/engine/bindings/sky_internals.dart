@@ -13,3 +13,15 @@ int takeServiceRegistry() native "takeServiceRegistry";
 int takeServicesProvidedByEmbedder() native "takeServicesProvidedByEmbedder";
 int takeServicesProvidedToEmbedder() native "takeServicesProvidedToEmbedder";
 int takeShellProxyHandle() native "takeShellProxyHandle";
+
+List _getStartupMilestones() native "getStartupMilestones";
+
+// The startup milestones the shell has reached so far, with the number of
+// microseconds from the launch of the process to each of them.
+Map<String, int> getStartupMilestones() {
+  List milestones = _getStartupMilestones();
+  Map<String, int> result = new Map<String, int>();
+  for (int i = 0; i < milestones.length; i += 2)
+    result[milestones[i]] = milestones[i + 1];
+  return result;
+}
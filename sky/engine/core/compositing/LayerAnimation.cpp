@@ -0,0 +1,43 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/compositing/LayerAnimation.h"
+
+namespace blink {
+namespace {
+
+base::TimeDelta FromMilliseconds(double milliseconds) {
+  return base::TimeDelta::FromMicroseconds(static_cast<int64_t>(
+      milliseconds * base::Time::kMicrosecondsPerMillisecond));
+}
+
+} // namespace
+
+PassRefPtr<LayerAnimation> LayerAnimation::create(double startTime,
+                                                  double duration) {
+  return adoptRef(new LayerAnimation(startTime, duration));
+}
+
+LayerAnimation::LayerAnimation(double startTime, double duration)
+    : m_animation(base::TimeTicks() + FromMilliseconds(startTime),
+                  FromMilliseconds(duration)) {
+}
+
+LayerAnimation::~LayerAnimation() {
+}
+
+void LayerAnimation::addKeyframe(double offset,
+                                 double value,
+                                 double x1,
+                                 double y1,
+                                 double x2,
+                                 double y2) {
+  m_animation.AddKeyframe(offset, value, x1, y1, x2, y2);
+}
+
+void LayerAnimation::setIterations(int count, bool alternate) {
+  m_animation.SetIterations(count, alternate);
+}
+
+} // namespace blink
@@ -0,0 +1,44 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_COMPOSITING_LAYERANIMATION_H_
+#define SKY_ENGINE_CORE_COMPOSITING_LAYERANIMATION_H_
+
+#include "sky/compositor/layer_animation.h"
+#include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefCounted.h"
+
+namespace blink {
+
+class LayerAnimation : public RefCounted<LayerAnimation>, public DartWrappable {
+  DEFINE_WRAPPERTYPEINFO();
+
+ public:
+  ~LayerAnimation() override;
+  static PassRefPtr<LayerAnimation> create(double startTime, double duration);
+
+  void addKeyframe(double offset,
+                   double value,
+                   double x1,
+                   double y1,
+                   double x2,
+                   double y2);
+  void setIterations(int count, bool alternate);
+
+  // Layers get a copy, which the GPU thread reads while Dart goes on
+  // changing this one.
+  const sky::compositor::LayerAnimation& animation() const {
+    return m_animation;
+  }
+
+ private:
+  LayerAnimation(double startTime, double duration);
+
+  sky::compositor::LayerAnimation m_animation;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_COMPOSITING_LAYERANIMATION_H_
@@ -10,14 +10,21 @@
 namespace blink {
 
 PassRefPtr<Scene> Scene::create(
-    std::unique_ptr<sky::compositor::Layer> rootLayer) {
+    std::shared_ptr<sky::compositor::Layer> rootLayer,
+    std::shared_ptr<sky::compositor::LayerArena> arena,
+    uint32_t debugFlags) {
   ASSERT(rootLayer);
-  return adoptRef(new Scene(std::move(rootLayer)));
+  return adoptRef(
+      new Scene(std::move(rootLayer), std::move(arena), debugFlags));
 }
 
-Scene::Scene(std::unique_ptr<sky::compositor::Layer> rootLayer)
+Scene::Scene(std::shared_ptr<sky::compositor::Layer> rootLayer,
+             std::shared_ptr<sky::compositor::LayerArena> arena,
+             uint32_t debugFlags)
     : m_layerTree(new sky::compositor::LayerTree()) {
   m_layerTree->set_root_layer(std::move(rootLayer));
+  m_layerTree->set_arena(std::move(arena));
+  m_layerTree->set_debug_flags(debugFlags);
 }
 
 Scene::~Scene() {}
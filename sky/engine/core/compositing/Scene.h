@@ -22,12 +22,16 @@ class Scene : public RefCounted<Scene>, public DartWrappable {
  public:
   ~Scene() override;
   static PassRefPtr<Scene> create(
-      std::unique_ptr<sky::compositor::Layer> rootLayer);
+      std::shared_ptr<sky::compositor::Layer> rootLayer,
+      std::shared_ptr<sky::compositor::LayerArena> arena,
+      uint32_t debugFlags);
 
   std::unique_ptr<sky::compositor::LayerTree> takeLayerTree();
 
  private:
-  explicit Scene(std::unique_ptr<sky::compositor::Layer> rootLayer);
+  Scene(std::shared_ptr<sky::compositor::Layer> rootLayer,
+        std::shared_ptr<sky::compositor::LayerArena> arena,
+        uint32_t debugFlags);
 
   std::unique_ptr<sky::compositor::LayerTree> m_layerTree;
 };
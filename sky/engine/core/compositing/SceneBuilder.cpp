@@ -5,6 +5,7 @@
 #include "sky/engine/core/compositing/SceneBuilder.h"
 
 #include "sky/engine/core/painting/Matrix.h"
+#include "sky/engine/core/script/dom_dart_state.h"
 #include "third_party/skia/include/core/SkColorFilter.h"
 #include "sky/compositor/transform_layer.h"
 #include "sky/compositor/clip_path_layer.h"
@@ -14,12 +15,26 @@
 #include "sky/compositor/container_layer.h"
 #include "sky/compositor/opacity_layer.h"
 #include "sky/compositor/picture_layer.h"
+#include "sky/compositor/scroll_layer.h"
+#include "sky/compositor/shadow_layer.h"
+#include "sky/compositor/texture_layer.h"
 
 namespace blink {
+namespace {
+
+// Analyzing a picture replays it, so only pictures this small are checked
+// for drawing nothing visible before being added to the scene.
+const int kMaxOpCountToCheckTransparency = 8;
+
+} // namespace
 
 SceneBuilder::SceneBuilder(const Rect& bounds)
     : m_rootPaintBounds(bounds.sk_rect)
-    , m_currentLayer(nullptr)
+    , m_arena(sky::compositor::LayerArena::Create())
+    , m_lastOpacityLayer(nullptr)
+    , m_lastTransformLayer(nullptr)
+    , m_debugFlags(0)
+    , m_built(false)
 {
 }
 
@@ -32,88 +47,190 @@ void SceneBuilder::pushTransform(const Float32List& matrix4, ExceptionState& es)
     SkMatrix sk_matrix = toSkMatrix(matrix4, es);
     if (es.had_exception())
         return;
-    std::unique_ptr<sky::compositor::TransformLayer> layer(new sky::compositor::TransformLayer());
+    auto layer = sky::compositor::MakeLayer<sky::compositor::TransformLayer>(m_arena);
     layer->set_transform(sk_matrix);
-    addLayer(std::move(layer));
+    addLayer(layer);
+    if (!m_layerStack.empty() && m_layerStack.back() == layer)
+        m_lastTransformLayer = layer.get();
 }
 
 void SceneBuilder::pushClipRect(const Rect& rect)
 {
-    std::unique_ptr<sky::compositor::ClipRectLayer> layer(new sky::compositor::ClipRectLayer());
+    auto layer = sky::compositor::MakeLayer<sky::compositor::ClipRectLayer>(m_arena);
     layer->set_clip_rect(rect.sk_rect);
     addLayer(std::move(layer));
 }
 
-void SceneBuilder::pushClipRRect(const RRect* rrect, const Rect& bounds)
+void SceneBuilder::pushClipRRect(const RRect* rrect, const Rect& bounds, bool antiAlias)
 {
-    std::unique_ptr<sky::compositor::ClipRRectLayer> layer(new sky::compositor::ClipRRectLayer());
+    auto layer = sky::compositor::MakeLayer<sky::compositor::ClipRRectLayer>(m_arena);
     layer->set_clip_rrect(rrect->rrect());
+    layer->set_anti_alias(antiAlias);
     addLayer(std::move(layer));
 }
 
-void SceneBuilder::pushClipPath(const CanvasPath* path, const Rect& bounds)
+void SceneBuilder::pushClipPath(const CanvasPath* path, const Rect& bounds, bool antiAlias)
 {
-    std::unique_ptr<sky::compositor::ClipPathLayer> layer(new sky::compositor::ClipPathLayer());
+    auto layer = sky::compositor::MakeLayer<sky::compositor::ClipPathLayer>(m_arena);
     layer->set_clip_path(path->path());
+    layer->set_anti_alias(antiAlias);
     addLayer(std::move(layer));
 }
 
 void SceneBuilder::pushOpacity(int alpha, const Rect& bounds)
 {
-    std::unique_ptr<sky::compositor::OpacityLayer> layer(new sky::compositor::OpacityLayer());
+    auto layer = sky::compositor::MakeLayer<sky::compositor::OpacityLayer>(m_arena);
     layer->set_paint_bounds(bounds.sk_rect);
     layer->set_alpha(alpha);
-    addLayer(std::move(layer));
+    addLayer(layer);
+    if (!m_layerStack.empty() && m_layerStack.back() == layer)
+        m_lastOpacityLayer = layer.get();
 }
 
 void SceneBuilder::pushColorFilter(SkColor color, SkXfermode::Mode transferMode, const Rect& bounds)
 {
-    std::unique_ptr<sky::compositor::ColorFilterLayer> layer(new sky::compositor::ColorFilterLayer());
+    auto layer = sky::compositor::MakeLayer<sky::compositor::ColorFilterLayer>(m_arena);
     layer->set_paint_bounds(bounds.sk_rect);
     layer->set_color(color);
     layer->set_transfer_mode(transferMode);
     addLayer(std::move(layer));
 }
 
-void SceneBuilder::addLayer(std::unique_ptr<sky::compositor::ContainerLayer> layer)
+void SceneBuilder::pushScroll(int scrollId, const Offset& offset, const Rect& viewport, const Size& contentSize)
+{
+    auto layer = sky::compositor::MakeLayer<sky::compositor::ScrollLayer>(m_arena);
+    layer->set_scroll_id(scrollId);
+    layer->set_offset(SkPoint::Make(offset.sk_size.width(), offset.sk_size.height()));
+    layer->set_viewport(viewport.sk_rect);
+    layer->set_content_size(contentSize.sk_size);
+    addLayer(std::move(layer));
+}
+
+void SceneBuilder::addLayer(std::shared_ptr<sky::compositor::ContainerLayer> layer)
 {
     DCHECK(layer);
+    m_lastOpacityLayer = nullptr;
+    m_lastTransformLayer = nullptr;
+    layer->UseArena(m_arena);
     if (!m_rootLayer) {
-        DCHECK(!m_currentLayer);
-        m_rootLayer = std::move(layer);
+        DCHECK(m_layerStack.empty());
+        if (m_built)
+            return;
+        m_rootLayer = layer;
         m_rootLayer->set_paint_bounds(m_rootPaintBounds);
-        m_currentLayer = m_rootLayer.get();
+        m_layerStack.push_back(std::move(layer));
         return;
     }
-    if (!m_currentLayer)
+    if (m_layerStack.empty())
         return;
-    sky::compositor::ContainerLayer* newLayer = layer.get();
-    m_currentLayer->Add(std::move(layer));
-    m_currentLayer = newLayer;
+    m_layerStack.back()->Add(layer);
+    m_layerStack.push_back(std::move(layer));
 }
 
 void SceneBuilder::pop()
 {
-    if (!m_currentLayer)
+    if (m_layerStack.empty())
+        return;
+    m_layerStack.pop_back();
+}
+
+void SceneBuilder::setOpacityAnimation(const LayerAnimation* animation)
+{
+    if (!m_lastOpacityLayer || !animation)
+        return;
+    m_lastOpacityLayer->set_alpha_animation(
+        std::make_shared<sky::compositor::LayerAnimation>(animation->animation()));
+}
+
+void SceneBuilder::setTransformAnimation(int property, const LayerAnimation* animation, const Point& origin)
+{
+    using AnimatedProperty = sky::compositor::TransformLayer::AnimatedProperty;
+    if (!m_lastTransformLayer || !animation)
+        return;
+    if (property < static_cast<int>(AnimatedProperty::kTranslateX) || property > static_cast<int>(AnimatedProperty::kRotation))
+        return;
+    m_lastTransformLayer->set_animation(static_cast<AnimatedProperty>(property),
+        std::make_shared<sky::compositor::LayerAnimation>(animation->animation()));
+    m_lastTransformLayer->set_animation_origin(origin.sk_point);
+}
+
+void SceneBuilder::setRetainedKey(int key)
+{
+    if (m_layerStack.empty())
         return;
-    m_currentLayer = m_currentLayer->parent();
+    m_retainedLayers[key] = m_layerStack.back();
+}
+
+bool SceneBuilder::addRetained(int key)
+{
+    if (m_layerStack.empty())
+        return false;
+    DOMDartState* state = DOMDartState::Current();
+    if (!state)
+        return false;
+    DOMDartState::RetainedLayerMap& previous = state->retained_layers();
+    auto it = previous.find(key);
+    if (it == previous.end())
+        return false;
+    // Retained layers are never mutated after their scene was built, so the
+    // same subtree can safely be part of several layer trees.
+    m_layerStack.back()->Add(it->second);
+    m_retainedLayers[key] = it->second;
+    return true;
 }
 
 void SceneBuilder::addPicture(const Offset& offset, Picture* picture, const Rect& paintBounds)
 {
-    if (!m_currentLayer)
+    if (m_layerStack.empty())
         return;
-    std::unique_ptr<sky::compositor::PictureLayer> layer(new sky::compositor::PictureLayer());
+    if (picture->approximateOpCount() <= kMaxOpCountToCheckTransparency && picture->isTransparent())
+        return;
+    auto layer = sky::compositor::MakeLayer<sky::compositor::PictureLayer>(m_arena);
     layer->set_offset(SkPoint::Make(offset.sk_size.width(), offset.sk_size.height()));
     layer->set_picture(picture->toSkia());
     layer->set_paint_bounds(paintBounds.sk_rect);
-    m_currentLayer->Add(std::move(layer));
+    m_layerStack.back()->Add(std::move(layer));
+}
+
+void SceneBuilder::addShadow(const RRect* shape, SkColor color, double blurSigma, const Offset& offset)
+{
+    if (m_layerStack.empty() || !shape)
+        return;
+    auto layer = sky::compositor::MakeLayer<sky::compositor::ShadowLayer>(m_arena);
+    layer->set_shape(shape->rrect());
+    layer->set_color(color);
+    layer->set_blur_sigma(blurSigma);
+    layer->set_offset(SkPoint::Make(offset.sk_size.width(), offset.sk_size.height()));
+    layer->UpdatePaintBounds();
+    m_layerStack.back()->Add(std::move(layer));
+}
+
+void SceneBuilder::addTexture(const Offset& offset, int textureId, const Size& size)
+{
+    if (m_layerStack.empty())
+        return;
+    auto layer = sky::compositor::MakeLayer<sky::compositor::TextureLayer>(m_arena);
+    layer->set_texture_id(textureId);
+    layer->set_offset(SkPoint::Make(offset.sk_size.width(), offset.sk_size.height()));
+    layer->set_size(size.sk_size);
+    layer->UpdatePaintBounds();
+    m_layerStack.back()->Add(std::move(layer));
+}
+
+void SceneBuilder::setDebugOptions(int options)
+{
+    m_debugFlags = options;
 }
 
 PassRefPtr<Scene> SceneBuilder::build()
 {
-    m_currentLayer = nullptr;
-    return Scene::create(std::move(m_rootLayer));
+    m_layerStack.clear();
+    m_built = true;
+    // Only the layers tagged in this scene are available to the next one.
+    if (DOMDartState* state = DOMDartState::Current())
+        state->retained_layers().swap(m_retainedLayers);
+    m_retainedLayers.clear();
+    return Scene::create(std::move(m_rootLayer), std::move(m_arena), m_debugFlags);
 }
 
 } // namespace blink
@@ -6,9 +6,15 @@
 #define SKY_ENGINE_CORE_COMPOSITING_SCENEBUILDER_H_
 
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 #include "sky/compositor/layer.h"
+#include "sky/compositor/layer_arena.h"
+#include "sky/compositor/opacity_layer.h"
+#include "sky/compositor/transform_layer.h"
 #include "sky/engine/bindings/exception_state.h"
+#include "sky/engine/core/compositing/LayerAnimation.h"
 #include "sky/engine/core/compositing/Scene.h"
 #include "sky/engine/core/painting/CanvasPath.h"
 #include "sky/engine/core/painting/Offset.h"
@@ -19,7 +25,7 @@
 #include "sky/engine/core/painting/RRect.h"
 #include "sky/engine/core/painting/Size.h"
 #include "sky/engine/tonic/dart_wrappable.h"
-#include "sky/engine/tonic/float32_list.h"
+#include "sky/engine/tonic/typed_list.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefCounted.h"
 
@@ -36,23 +42,47 @@ public:
 
     void pushTransform(const Float32List& matrix4, ExceptionState&);
     void pushClipRect(const Rect& rect);
-    void pushClipRRect(const RRect* rrect, const Rect& bounds);
-    void pushClipPath(const CanvasPath* path, const Rect& bounds);
+    void pushClipRRect(const RRect* rrect, const Rect& bounds, bool antiAlias);
+    void pushClipPath(const CanvasPath* path, const Rect& bounds, bool antiAlias);
     void pushOpacity(int alpha, const Rect& bounds);
     void pushColorFilter(SkColor color, SkXfermode::Mode transferMode, const Rect& bounds);
+    void pushScroll(int scrollId, const Offset& offset, const Rect& viewport, const Size& contentSize);
     void pop();
+    void setOpacityAnimation(const LayerAnimation* animation);
+    void setTransformAnimation(int property, const LayerAnimation* animation, const Point& origin);
+    void setRetainedKey(int key);
+    bool addRetained(int key);
     void addPicture(const Offset& offset, Picture* picture, const Rect& bounds);
+    void addShadow(const RRect* shape, SkColor color, double blurSigma, const Offset& offset);
+    void addTexture(const Offset& offset, int textureId, const Size& size);
+    void setDebugOptions(int options);
 
     PassRefPtr<Scene> build();
 
 private:
     explicit SceneBuilder(const Rect& bounds);
 
-    void addLayer(std::unique_ptr<sky::compositor::ContainerLayer> layer);
+    void addLayer(std::shared_ptr<sky::compositor::ContainerLayer> layer);
+
+    using LayerMap = std::unordered_map<int, std::shared_ptr<sky::compositor::ContainerLayer>>;
 
     SkRect m_rootPaintBounds;
-    std::unique_ptr<sky::compositor::ContainerLayer> m_rootLayer;
-    sky::compositor::ContainerLayer* m_currentLayer;
+    // Every layer of the scene is allocated from this arena, which is handed
+    // to the layer tree once the scene is built.
+    std::shared_ptr<sky::compositor::LayerArena> m_arena;
+    std::shared_ptr<sky::compositor::ContainerLayer> m_rootLayer;
+    // The layers that have been pushed but not yet popped. The last one is
+    // the current layer.
+    std::vector<std::shared_ptr<sky::compositor::ContainerLayer>> m_layerStack;
+    // Layers tagged with setRetainedKey or re-added with addRetained.
+    LayerMap m_retainedLayers;
+    // The layer pushed last, if it was pushed by pushOpacity or
+    // pushTransform, for setOpacityAnimation and setTransformAnimation.
+    sky::compositor::OpacityLayer* m_lastOpacityLayer;
+    sky::compositor::TransformLayer* m_lastTransformLayer;
+    // The sky::compositor::CompositorOptions::DebugFlag values to paint with.
+    uint32_t m_debugFlags;
+    bool m_built;
 };
 
 } // namespace blink
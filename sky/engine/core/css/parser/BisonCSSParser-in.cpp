@@ -213,6 +213,8 @@ static inline bool isSimpleLengthPropertyID(CSSPropertyID propertyId, bool& acce
     case CSSPropertyFontSize:
     case CSSPropertyHeight:
     case CSSPropertyWidth:
+    case CSSPropertyMaxHeight:
+    case CSSPropertyMaxWidth:
     case CSSPropertyMinHeight:
     case CSSPropertyMinWidth:
     case CSSPropertyPaddingBottom:
@@ -221,6 +223,8 @@ static inline bool isSimpleLengthPropertyID(CSSPropertyID propertyId, bool& acce
     case CSSPropertyPaddingTop:
     case CSSPropertyWebkitLogicalWidth:
     case CSSPropertyWebkitLogicalHeight:
+    case CSSPropertyWebkitMaxLogicalWidth:
+    case CSSPropertyWebkitMaxLogicalHeight:
     case CSSPropertyWebkitMinLogicalWidth:
     case CSSPropertyWebkitMinLogicalHeight:
     case CSSPropertyWebkitPaddingAfter:
@@ -302,6 +306,40 @@ static bool parseSimpleLengthValue(MutableStylePropertySet* declaration, CSSProp
     return true;
 }
 
+static inline bool isSimpleNumberPropertyID(CSSPropertyID propertyId, bool& acceptsNegativeNumbers)
+{
+    switch (propertyId) {
+    case CSSPropertyFlexGrow:
+    case CSSPropertyFlexShrink:
+        acceptsNegativeNumbers = false;
+        return true;
+    case CSSPropertyOpacity:
+        acceptsNegativeNumbers = true;
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool parseSimpleNumberValue(MutableStylePropertySet* declaration, CSSPropertyID propertyId, const String& string)
+{
+    ASSERT(!string.isEmpty());
+    bool acceptsNegativeNumbers = false;
+    if (!isSimpleNumberPropertyID(propertyId, acceptsNegativeNumbers))
+        return false;
+
+    bool ok;
+    double number = string.is8Bit()
+        ? charactersToDouble(string.characters8(), string.length(), &ok)
+        : charactersToDouble(string.characters16(), string.length(), &ok);
+    if (!ok || (number < 0 && !acceptsNegativeNumbers))
+        return false;
+
+    RefPtr<CSSValue> value = cssValuePool().createValue(number, CSSPrimitiveValue::CSS_NUMBER);
+    declaration->addParsedProperty(CSSProperty(propertyId, value.release()));
+    return true;
+}
+
 bool isValidKeywordPropertyAndValue(CSSPropertyID propertyId, CSSValueID valueID, const CSSParserContext& parserContext)
 {
     if (valueID == CSSValueInvalid)
@@ -560,12 +598,13 @@ static bool parseTransformNumberArguments(CharType*& pos, CharType* end, unsigne
 template <typename CharType>
 static PassRefPtr<CSSTransformValue> parseSimpleTransformValue(CharType*& pos, CharType* end)
 {
-    static const int shortestValidTransformStringLength = 12;
+    static const int shortestValidTransformStringLength = 8;
 
     if (end - pos < shortestValidTransformStringLength)
         return nullptr;
 
-    const bool isTranslate = toASCIILower(pos[0]) == 't'
+    const bool isTranslate = end - pos >= 12
+        && toASCIILower(pos[0]) == 't'
         && toASCIILower(pos[1]) == 'r'
         && toASCIILower(pos[2]) == 'a'
         && toASCIILower(pos[3]) == 'n'
@@ -604,7 +643,8 @@ static PassRefPtr<CSSTransformValue> parseSimpleTransformValue(CharType*& pos, C
         return transformValue.release();
     }
 
-    const bool isMatrix3d = toASCIILower(pos[0]) == 'm'
+    const bool isMatrix3d = end - pos >= 9
+        && toASCIILower(pos[0]) == 'm'
         && toASCIILower(pos[1]) == 'a'
         && toASCIILower(pos[2]) == 't'
         && toASCIILower(pos[3]) == 'r'
@@ -622,19 +662,39 @@ static PassRefPtr<CSSTransformValue> parseSimpleTransformValue(CharType*& pos, C
         return transformValue.release();
     }
 
-    const bool isScale3d = toASCIILower(pos[0]) == 's'
+    const bool isScale = toASCIILower(pos[0]) == 's'
         && toASCIILower(pos[1]) == 'c'
         && toASCIILower(pos[2]) == 'a'
         && toASCIILower(pos[3]) == 'l'
-        && toASCIILower(pos[4]) == 'e'
-        && pos[5] == '3'
-        && toASCIILower(pos[6]) == 'd'
-        && pos[7] == '(';
-
-    if (isScale3d) {
-        pos += 8;
-        RefPtr<CSSTransformValue> transformValue = CSSTransformValue::create(CSSTransformValue::Scale3DTransformOperation);
-        if (!parseTransformNumberArguments(pos, end, 3, transformValue.get()))
+        && toASCIILower(pos[4]) == 'e';
+
+    if (isScale) {
+        CSSTransformValue::TransformOperationType transformType;
+        unsigned expectedArgumentCount = 1;
+        unsigned argumentStart = 7;
+        CharType c5 = toASCIILower(pos[5]);
+        if (c5 == 'x' && pos[6] == '(') {
+            transformType = CSSTransformValue::ScaleXTransformOperation;
+        } else if (c5 == 'y' && pos[6] == '(') {
+            transformType = CSSTransformValue::ScaleYTransformOperation;
+        } else if (c5 == '(') {
+            // scale() takes one or two arguments.
+            transformType = CSSTransformValue::ScaleTransformOperation;
+            argumentStart = 6;
+            size_t close = WTF::find(pos, end - pos, ')');
+            size_t comma = WTF::find(pos, end - pos, ',');
+            if (comma != kNotFound && comma < close)
+                expectedArgumentCount = 2;
+        } else if (c5 == '3' && toASCIILower(pos[6]) == 'd' && pos[7] == '(') {
+            transformType = CSSTransformValue::Scale3DTransformOperation;
+            expectedArgumentCount = 3;
+            argumentStart = 8;
+        } else {
+            return nullptr;
+        }
+        pos += argumentStart;
+        RefPtr<CSSTransformValue> transformValue = CSSTransformValue::create(transformType);
+        if (!parseTransformNumberArguments(pos, end, expectedArgumentCount, transformValue.get()))
             return nullptr;
         return transformValue.release();
     }
@@ -712,8 +772,12 @@ bool BisonCSSParser::parseValue(MutableStylePropertySet* declaration, CSSPropert
         return true;
     if (parseColorValue(declaration, propertyID, string, context.mode()))
         return true;
+    if (parseSimpleNumberValue(declaration, propertyID, string))
+        return true;
     if (parseKeywordValue(declaration, propertyID, string, context))
         return true;
+    if (parseSimpleTransform(declaration, propertyID, string))
+        return true;
 
     BisonCSSParser parser(context);
     return parser.parseValue(declaration, propertyID, string, static_cast<StyleSheetContents*>(0));
@@ -726,6 +790,8 @@ bool BisonCSSParser::parseValue(MutableStylePropertySet* declaration, CSSPropert
         return true;
     if (parseColorValue(declaration, propertyID, string, cssParserMode))
         return true;
+    if (parseSimpleNumberValue(declaration, propertyID, string))
+        return true;
 
     CSSParserContext context;
     if (contextStyleSheet)
@@ -0,0 +1,33 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/css/resolver/SharedStyleDataCache.h"
+
+#include "sky/engine/core/rendering/style/RenderStyle.h"
+
+namespace blink {
+
+void SharedStyleDataCache::shareData(RenderStyle& style)
+{
+    m_box.share(style.m_box);
+    m_visual.share(style.visual);
+    m_background.share(style.m_background);
+    m_surround.share(style.surround);
+    m_rareNonInheritedData.share(style.rareNonInheritedData);
+    m_rareInheritedData.share(style.rareInheritedData);
+    m_inherited.share(style.inherited);
+}
+
+void SharedStyleDataCache::clear()
+{
+    m_box.clear();
+    m_visual.clear();
+    m_background.clear();
+    m_surround.clear();
+    m_rareNonInheritedData.clear();
+    m_rareInheritedData.clear();
+    m_inherited.clear();
+}
+
+} // namespace blink
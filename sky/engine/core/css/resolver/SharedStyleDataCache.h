@@ -0,0 +1,90 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_CSS_RESOLVER_SHAREDSTYLEDATACACHE_H_
+#define SKY_ENGINE_CORE_CSS_RESOLVER_SHAREDSTYLEDATACACHE_H_
+
+#include "sky/engine/core/rendering/style/DataRef.h"
+#include "sky/engine/core/rendering/style/StyleBackgroundData.h"
+#include "sky/engine/core/rendering/style/StyleBoxData.h"
+#include "sky/engine/core/rendering/style/StyleInheritedData.h"
+#include "sky/engine/core/rendering/style/StyleRareInheritedData.h"
+#include "sky/engine/core/rendering/style/StyleRareNonInheritedData.h"
+#include "sky/engine/core/rendering/style/StyleSurroundData.h"
+#include "sky/engine/core/rendering/style/StyleVisualData.h"
+#include "sky/engine/wtf/Noncopyable.h"
+#include "sky/engine/wtf/Vector.h"
+
+namespace blink {
+
+class RenderStyle;
+
+// A style that neither shares another element's style nor comes out of the
+// matched properties cache gets its own copy of every group of data a
+// property was applied to, even when another element just ended up with a
+// group holding the same values. The cache remembers the groups of the most
+// recently resolved styles, so that such a style can point at an equal group
+// instead of keeping its copy alive for as long as the element is rendered.
+class SharedStyleDataCache {
+    WTF_MAKE_NONCOPYABLE(SharedStyleDataCache);
+public:
+    SharedStyleDataCache() { }
+
+    // Replaces the groups of a newly resolved style with equal ones that
+    // other styles already use.
+    void shareData(RenderStyle&);
+
+    void clear();
+
+private:
+    template<typename T>
+    class RecentData {
+    public:
+        RecentData() : m_next(0) { }
+
+        void share(DataRef<T>& data)
+        {
+            // Groups that came from the parent or the matched properties cache
+            // are already shared.
+            if (!data.isUnshared())
+                return;
+            for (const DataRef<T>& entry : m_entries) {
+                if (data.shareIfEqual(entry))
+                    return;
+            }
+            if (m_entries.size() < capacity) {
+                m_entries.append(data);
+                return;
+            }
+            m_entries[m_next] = data;
+            m_next = (m_next + 1) % capacity;
+        }
+
+        void clear()
+        {
+            m_entries.clear();
+            m_next = 0;
+        }
+
+    private:
+        // Comparing groups is not free, and siblings styled by the same rules
+        // are resolved one after the other.
+        static const size_t capacity = 8;
+
+        Vector<DataRef<T>, capacity> m_entries;
+        size_t m_next;
+    };
+
+    RecentData<StyleBoxData> m_box;
+    RecentData<StyleVisualData> m_visual;
+    RecentData<StyleBackgroundData> m_background;
+    RecentData<StyleSurroundData> m_surround;
+    RecentData<StyleRareNonInheritedData> m_rareNonInheritedData;
+    RecentData<StyleRareInheritedData> m_rareInheritedData;
+    RecentData<StyleInheritedData> m_inherited;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_CSS_RESOLVER_SHAREDSTYLEDATACACHE_H_
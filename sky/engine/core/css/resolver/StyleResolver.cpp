@@ -56,6 +56,7 @@
 #include "sky/engine/core/frame/FrameView.h"
 #include "sky/engine/core/frame/LocalFrame.h"
 #include "sky/engine/core/rendering/RenderView.h"
+#include "sky/engine/platform/TraceEvent.h"
 #include "sky/engine/wtf/LeakAnnotations.h"
 #include "sky/engine/wtf/StdLibExtras.h"
 
@@ -196,6 +197,8 @@ PassRefPtr<RenderStyle> StyleResolver::styleForElement(Element* element, RenderS
     if (state.style()->hasViewportUnits())
         m_document.setHasViewportUnits();
 
+    m_sharedStyleDataCache.shareData(*state.style());
+
     // Now return the style.
     return state.takeStyle();
 }
@@ -316,6 +319,7 @@ static unsigned computeMatchedPropertiesHash(const RefPtr<StylePropertySet>* pro
 void StyleResolver::invalidateMatchedPropertiesCache()
 {
     m_matchedPropertiesCache.clear();
+    m_sharedStyleDataCache.clear();
 }
 
 void StyleResolver::notifyResizeForViewportUnits()
@@ -369,8 +373,13 @@ void StyleResolver::applyMatchedProperties(StyleResolverState& state, const Matc
 
     applyMatchedProperties<LowPriorityProperties>(state, matchResult, applyInheritedOnly);
 
-    if (!cachedMatchedProperties && cacheHash && MatchedPropertiesCache::isCacheable(element, state.style(), state.parentStyle())) {
-        INCREMENT_STYLE_STATS_COUNTER(*this, matchedPropertyCacheAdded);
+    // An entry whose parent style did not match is replaced with this style.
+    // After a change that restyles the whole document, every parent has a new
+    // style, and the siblings that follow would otherwise all apply their
+    // inherited properties again instead of copying them from the cache.
+    if (cacheHash && MatchedPropertiesCache::isCacheable(element, state.style(), state.parentStyle())) {
+        if (!cachedMatchedProperties)
+            INCREMENT_STYLE_STATS_COUNTER(*this, matchedPropertyCacheAdded);
         m_matchedPropertiesCache.add(state.style(), state.parentStyle(), cacheHash, matchResult);
     }
 
@@ -410,6 +419,19 @@ void StyleResolver::printStats()
     fprintf(stderr, "%s\n", m_styleResolverStatsTotals->report().utf8().data());
 }
 
+void StyleResolver::traceStats()
+{
+    if (!m_styleResolverStats)
+        return;
+    const StyleResolverStats& stats = *m_styleResolverStats;
+    TRACE_COUNTER2("blink", "StyleSharing",
+        "lookups", stats.sharedStyleLookups,
+        "shared", stats.sharedStyleFound - stats.sharedStyleRejectedByAttributeRules);
+    TRACE_COUNTER2("blink", "MatchedPropertiesCache",
+        "applies", stats.matchedPropertyApply,
+        "hits", stats.matchedPropertyCacheHit);
+}
+
 void StyleResolver::applyPropertiesToStyle(const CSSPropertyValue* properties, size_t count, RenderStyle* style)
 {
     StyleResolverState state(m_document, nullptr, style);
@@ -25,6 +25,7 @@
 #include "sky/engine/core/css/MediaQueryEvaluator.h"
 #include "sky/engine/core/css/resolver/MatchedPropertiesCache.h"
 #include "sky/engine/core/css/resolver/ScopedStyleResolver.h"
+#include "sky/engine/core/css/resolver/SharedStyleDataCache.h"
 #include "sky/engine/platform/heap/Handle.h"
 #include "sky/engine/wtf/Deque.h"
 #include "sky/engine/wtf/HashMap.h"
@@ -89,6 +90,8 @@ public:
     void enableStats(StatsReportType = ReportDefaultStats);
     void disableStats();
     void printStats();
+    // Emits the stats of the last style recalc as trace counters.
+    void traceStats();
 
 private:
     // FIXME: This should probably go away, folded into FontBuilder.
@@ -114,6 +117,7 @@ private:
     void applyProperties(StyleResolverState&, const StylePropertySet* properties, bool inheritedOnly);
 
     MatchedPropertiesCache m_matchedPropertiesCache;
+    SharedStyleDataCache m_sharedStyleDataCache;
 
     Document& m_document;
 
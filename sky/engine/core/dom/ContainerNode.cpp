@@ -38,6 +38,7 @@
 #include "sky/engine/core/rendering/RenderView.h"
 #include "sky/engine/platform/EventDispatchForbiddenScope.h"
 #include "sky/engine/platform/ScriptForbiddenScope.h"
+#include "sky/engine/wtf/HashSet.h"
 
 namespace blink {
 
@@ -49,7 +50,8 @@ static void collectChildrenAndRemoveFromOldParent(Node& node, NodeVector& nodes,
 {
     if (node.isDocumentFragment()) {
         DocumentFragment& fragment = toDocumentFragment(node);
-        appendChildNodes(fragment, nodes);
+        for (Node* child = fragment.firstChild(); child; child = child->nextSibling())
+            nodes.append(child);
         fragment.removeChildren();
         return;
     }
@@ -139,26 +141,7 @@ PassRefPtr<Node> ContainerNode::insertBefore(PassRefPtr<Node> newChild, Node* re
     if (exceptionState.had_exception())
         return nullptr;
 
-    ChildListMutationScope mutation(*this);
-    for (NodeVector::const_iterator it = targets.begin(); it != targets.end(); ++it) {
-        ASSERT(*it);
-        Node& child = **it;
-
-        // Due to arbitrary code running in response to a DOM mutation event it's
-        // possible that "next" is no longer a child of "this".
-        // It's also possible that "child" has been inserted elsewhere.
-        // In either of those cases, we'll just stop.
-        if (next->parentNode() != this)
-            break;
-        if (child.parentNode())
-            break;
-
-        treeScope().adoptIfNeeded(child);
-
-        insertBeforeCommon(*next, child);
-
-        updateTreeAfterInsertion(child);
-    }
+    insertChildren(targets, next.get());
 
     return newChild;
 }
@@ -256,32 +239,7 @@ PassRefPtr<Node> ContainerNode::replaceChild(PassRefPtr<Node> newChild, PassRefP
         return nullptr;
 
     // Add the new child(ren)
-    for (NodeVector::const_iterator it = targets.begin(); it != targets.end(); ++it) {
-        ASSERT(*it);
-        Node& child = **it;
-
-        // Due to arbitrary code running in response to a DOM mutation event it's
-        // possible that "next" is no longer a child of "this".
-        // It's also possible that "child" has been inserted elsewhere.
-        // In either of those cases, we'll just stop.
-        if (next && next->parentNode() != this)
-            break;
-        if (child.parentNode())
-            break;
-
-        treeScope().adoptIfNeeded(child);
-
-        // Add child before "next".
-        {
-            EventDispatchForbiddenScope assertNoEventDispatch;
-            if (next)
-                insertBeforeCommon(*next, child);
-            else
-                appendChildCommon(child);
-        }
-
-        updateTreeAfterInsertion(child);
-    }
+    insertChildren(targets, next.get());
 
     return child;
 }
@@ -504,27 +462,7 @@ PassRefPtr<Node> ContainerNode::appendChild(PassRefPtr<Node> newChild, Exception
         return nullptr;
 
     // Now actually add the child(ren)
-    ChildListMutationScope mutation(*this);
-    for (NodeVector::const_iterator it = targets.begin(); it != targets.end(); ++it) {
-        ASSERT(*it);
-        Node& child = **it;
-
-        // If the child has a parent again, just stop what we're doing, because
-        // that means someone is doing something with DOM mutation -- can't re-parent
-        // a child that already has a parent.
-        if (child.parentNode())
-            break;
-
-        {
-            EventDispatchForbiddenScope assertNoEventDispatch;
-            ScriptForbiddenScope forbidScript;
-
-            treeScope().adoptIfNeeded(child);
-            appendChildCommon(child);
-        }
-
-        updateTreeAfterInsertion(child);
-    }
+    insertChildren(targets, nullptr);
 
     return newChild;
 }
@@ -819,25 +757,58 @@ Vector<RefPtr<Element>> ContainerNode::getChildElements() const
     return result;
 }
 
-void ContainerNode::append(Vector<RefPtr<Node>>& nodes, ExceptionState& es)
+bool ContainerNode::collectChildrenForInsertion(const Vector<RefPtr<Node>>& nodes, NodeVector& targets, ExceptionState& es)
 {
-    RefPtr<ContainerNode> protect(this);
-    for (auto& node : nodes) {
-        appendChild(node.release(), es);
+    // Every node is checked before any of them is moved, so a bad node at the
+    // end of the list leaves the tree untouched.
+    for (const RefPtr<Node>& node : nodes) {
+        checkAcceptChildType(node.get(), es);
         if (es.had_exception())
-            return;
+            return false;
+        checkAcceptChildHierarchy(*node, es);
+        if (es.had_exception())
+            return false;
+    }
+
+    targets.reserveCapacity(nodes.size());
+    for (const RefPtr<Node>& node : nodes) {
+        collectChildrenAndRemoveFromOldParent(*node, targets, es);
+        if (es.had_exception())
+            return false;
     }
+    return true;
+}
+
+void ContainerNode::append(Vector<RefPtr<Node>>& nodes, ExceptionState& es)
+{
+    ASSERT(refCount() || parentNode());
+    RefPtr<ContainerNode> protect(this);
+
+    NodeVector targets;
+    if (!collectChildrenForInsertion(nodes, targets, es))
+        return;
+    insertChildren(targets, nullptr);
 }
 
 void ContainerNode::prepend(Vector<RefPtr<Node>>& nodes, ExceptionState& es)
 {
+    ASSERT(refCount() || parentNode());
     RefPtr<ContainerNode> protect(this);
-    RefPtr<Node> refChild = m_firstChild;
-    for (auto& node : nodes) {
-        insertBefore(node.release(), refChild.get(), es);
-        if (es.had_exception())
-            return;
+
+    // The nodes go before the first child that is not itself being moved.
+    RefPtr<Node> next = m_firstChild;
+    if (next) {
+        HashSet<RawPtr<Node>> moving;
+        for (const RefPtr<Node>& node : nodes)
+            moving.add(node.get());
+        while (next && moving.contains(next.get()))
+            next = next->nextSibling();
     }
+
+    NodeVector targets;
+    if (!collectChildrenForInsertion(nodes, targets, es))
+        return;
+    insertChildren(targets, next.get());
 }
 
 PassRefPtr<Node> ContainerNode::prependChild(PassRefPtr<Node> node, ExceptionState& es)
@@ -897,14 +868,54 @@ Vector<RefPtr<Element>> ContainerNode::querySelectorAll(const AtomicString& sele
     return result;
 }
 
-void ContainerNode::updateTreeAfterInsertion(Node& child)
+void ContainerNode::insertChildren(const NodeVector& targets, Node* next)
 {
     ASSERT(refCount());
-    ASSERT(child.refCount());
+    ASSERT(!EventDispatchForbiddenScope::isEventDispatchForbidden());
+
+    RefPtr<Node> protect(this);
 
-    ChildListMutationScope(*this).childAdded(child);
+    // All the children share one mutation record and one childrenChanged()
+    // call, so observers, ranges and style invalidation see a single change
+    // however many nodes are inserted.
+    ChildListMutationScope mutation(*this);
+    bool insertedChild = false;
+    bool insertedElement = false;
+    for (NodeVector::const_iterator it = targets.begin(); it != targets.end(); ++it) {
+        ASSERT(*it);
+        Node& child = **it;
+
+        // Due to arbitrary code running in response to a DOM mutation event it's
+        // possible that "next" is no longer a child of "this".
+        // It's also possible that "child" has been inserted elsewhere.
+        // In either of those cases, we'll just stop.
+        if (next && next->parentNode() != this)
+            break;
+        if (child.parentNode())
+            break;
 
-    notifyNodeInserted(child);
+        {
+            EventDispatchForbiddenScope assertNoEventDispatch;
+            ScriptForbiddenScope forbidScript;
+
+            treeScope().adoptIfNeeded(child);
+            if (next)
+                insertBeforeCommon(*next, child);
+            else
+                appendChildCommon(child);
+        }
+
+        ASSERT(child.refCount());
+        mutation.childAdded(child);
+        notifyNodeInsertedInternal(child);
+        insertedChild = true;
+        insertedElement |= child.isElementNode();
+    }
+
+    if (!insertedChild)
+        return;
+    ChildrenChange change = { insertedElement ? ElementInserted : NonElementInserted, ChildrenChangeSourceAPI };
+    childrenChanged(change);
 }
 
 Element* ContainerNode::getElementById(const AtomicString& id) const
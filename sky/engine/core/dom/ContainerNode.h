@@ -144,7 +144,10 @@ private:
     void removeBetween(Node* previousChild, Node* nextChild, Node& oldChild);
     void insertBeforeCommon(Node& nextChild, Node& oldChild);
     void appendChildCommon(Node& child);
-    void updateTreeAfterInsertion(Node& child);
+    // Inserts |targets| before |next|, or at the end if |next| is null, and
+    // sends the notifications for all of them at once.
+    void insertChildren(const NodeVector& targets, Node* next);
+    bool collectChildrenForInsertion(const Vector<RefPtr<Node>>& nodes, NodeVector& targets, ExceptionState&);
     void willRemoveChildren();
     void willRemoveChild(Node& child);
     void removeDetachedChildrenInContainer(ContainerNode&);
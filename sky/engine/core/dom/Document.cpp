@@ -697,11 +697,16 @@ void Document::updateStyle(StyleRecalcChange change)
 
     clearNeedsStyleRecalc();
 
-    // Uncomment to enable printing of statistics about style sharing and the matched property cache.
-    // Optionally pass StyleResolver::ReportSlowStats to print numbers that require crawling the
-    // entire DOM (where collecting them is very slow).
-    // FIXME: Expose this as a runtime flag.
-    // styleResolver().enableStats(/*StyleResolver::ReportSlowStats*/);
+    // Statistics about style sharing and the matched properties cache are
+    // collected while tracing, and emitted as counters once the recalc is done.
+    // StyleResolver::ReportSlowStats adds numbers that require crawling the
+    // entire DOM, which is too slow to do while tracing.
+    bool statsEnabled = false;
+    TRACE_EVENT_CATEGORY_GROUP_ENABLED("blink", &statsEnabled);
+    if (statsEnabled)
+        styleResolver().enableStats();
+    else
+        styleResolver().disableStats();
 
     if (StyleResolverStats* stats = styleResolver().stats())
         stats->reset();
@@ -711,9 +716,10 @@ void Document::updateStyle(StyleRecalcChange change)
             element->recalcStyle(change);
     }
 
-    styleResolver().printStats();
+    styleResolver().traceStats();
 
     view()->recalcOverflowAfterStyleChange();
+    renderView()->geometryDidChange();
 
     clearChildNeedsStyleRecalc();
 
@@ -99,4 +99,10 @@ Element* DocumentOrderedMap::getElementById(const AtomicString& key, const TreeS
     return 0;
 }
 
+bool DocumentOrderedMap::containsMultiple(const AtomicString& key) const
+{
+    MapEntry* entry = m_map.get(key);
+    return entry && entry->count > 1;
+}
+
 } // namespace blink
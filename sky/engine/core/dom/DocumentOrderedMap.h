@@ -31,8 +31,8 @@
 #ifndef SKY_ENGINE_CORE_DOM_DOCUMENTORDEREDMAP_H_
 #define SKY_ENGINE_CORE_DOM_DOCUMENTORDEREDMAP_H_
 
+#include "sky/engine/wtf/FlatHashMap.h"
 #include "sky/engine/wtf/Forward.h"
-#include "sky/engine/wtf/HashMap.h"
 #include "sky/engine/wtf/text/AtomicString.h"
 #include "sky/engine/wtf/text/AtomicStringHash.h"
 
@@ -49,6 +49,7 @@ public:
     void remove(const AtomicString&, Element*);
 
     Element* getElementById(const AtomicString&, const TreeScope*) const;
+    bool containsMultiple(const AtomicString&) const;
 
 private:
     class MapEntry {
@@ -63,7 +64,7 @@ private:
         unsigned count;
     };
 
-    typedef HashMap<AtomicString, OwnPtr<MapEntry> > Map;
+    typedef FlatHashMap<AtomicString, OwnPtr<MapEntry> > Map;
     Map m_map;
 };
 
@@ -28,7 +28,7 @@
 #define SKY_ENGINE_CORE_DOM_ELEMENTDATACACHE_H_
 
 #include "sky/engine/platform/heap/Handle.h"
-#include "sky/engine/wtf/HashMap.h"
+#include "sky/engine/wtf/FlatHashMap.h"
 #include "sky/engine/wtf/PassOwnPtr.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefPtr.h"
@@ -50,7 +50,7 @@ public:
 private:
     ElementDataCache();
 
-    typedef HashMap<unsigned, RefPtr<ShareableElementData>, AlreadyHashed> ShareableElementDataCache;
+    typedef FlatHashMap<unsigned, RefPtr<ShareableElementData>, AlreadyHashed> ShareableElementDataCache;
     ShareableElementDataCache m_shareableElementDataCache;
 };
 
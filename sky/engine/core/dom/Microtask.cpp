@@ -70,7 +70,7 @@ void Microtask::performCheckpoint()
 {
     MicrotaskQueue& queue = microtaskQueue();
     while(!queue.isEmpty()) {
-        TRACE_EVENT0("sky", "Microtask::performCheckpoint");
+        TRACE_EVENT1("sky", "Microtask::performCheckpoint", "count", queue.size());
 
         MicrotaskQueue local;
         swap(queue, local);
@@ -44,6 +44,16 @@ PassOwnPtr<SelectorQuery> SelectorQuery::adopt(CSSSelectorList& selectorList)
 SelectorQuery::SelectorQuery(CSSSelectorList& selectorList)
 {
     m_selectors.adopt(selectorList);
+
+    const CSSSelector* selector = m_selectors.first();
+    if (!selector || CSSSelectorList::next(*selector))
+        return;
+    for (const CSSSelector* current = selector; current; current = current->tagHistory()) {
+        if (current->match() == CSSSelector::Id) {
+            m_selectorId = current->value();
+            break;
+        }
+    }
 }
 
 bool SelectorQuery::matches(Element& element) const
@@ -54,6 +64,11 @@ bool SelectorQuery::matches(Element& element) const
 Vector<RefPtr<Element>> SelectorQuery::queryAll(ContainerNode& rootNode) const
 {
     Vector<RefPtr<Element>> result;
+    if (canUseIdLookup(rootNode)) {
+        if (Element* element = elementForIdLookup(rootNode))
+            result.append(element);
+        return result;
+    }
     for (Element* element = ElementTraversal::firstWithin(rootNode); element; element = ElementTraversal::next(*element, &rootNode)) {
         if (selectorMatches(rootNode, *element))
             result.append(element);
@@ -63,6 +78,8 @@ Vector<RefPtr<Element>> SelectorQuery::queryAll(ContainerNode& rootNode) const
 
 PassRefPtr<Element> SelectorQuery::queryFirst(ContainerNode& rootNode) const
 {
+    if (canUseIdLookup(rootNode))
+        return elementForIdLookup(rootNode);
     for (Element* element = ElementTraversal::firstWithin(rootNode); element; element = ElementTraversal::next(*element, &rootNode)) {
         if (selectorMatches(rootNode, *element))
             return element;
@@ -80,6 +97,26 @@ bool SelectorQuery::selectorMatches(ContainerNode& rootNode, Element& element) c
     return false;
 }
 
+// Elements are only registered by id while they are in the document, and
+// ids that more than one element share have to be matched by traversal to
+// find all of them in document order.
+bool SelectorQuery::canUseIdLookup(ContainerNode& rootNode) const
+{
+    return !m_selectorId.isNull()
+        && rootNode.inDocument()
+        && !rootNode.treeScope().containsMultipleElementsWithId(m_selectorId);
+}
+
+Element* SelectorQuery::elementForIdLookup(ContainerNode& rootNode) const
+{
+    Element* element = rootNode.treeScope().getElementById(m_selectorId);
+    if (!element || element == &rootNode)
+        return nullptr;
+    if (!element->isDescendantOf(&rootNode))
+        return nullptr;
+    return selectorMatches(rootNode, *element) ? element : nullptr;
+}
+
 SelectorQuery* SelectorQueryCache::add(const AtomicString& selectors, const Document& document, ExceptionState& exceptionState)
 {
     HashMap<AtomicString, OwnPtr<SelectorQuery> >::iterator it = m_entries.find(selectors);
@@ -54,8 +54,15 @@ public:
 private:
     explicit SelectorQuery(CSSSelectorList&);
     bool selectorMatches(ContainerNode& rootNode, Element& subject) const;
+    // Returns the only element that can match, or null if there is none.
+    // Only valid if canUseIdLookup(rootNode) is true.
+    Element* elementForIdLookup(ContainerNode& rootNode) const;
+    bool canUseIdLookup(ContainerNode& rootNode) const;
 
     CSSSelectorList m_selectors;
+    // The id that a query made of a single selector requires, if any. Such
+    // queries look the element up by id instead of visiting every element.
+    AtomicString m_selectorId;
 };
 
 class SelectorQueryCache {
@@ -111,6 +111,11 @@ Element* TreeScope::getElementById(const AtomicString& elementId) const
     return m_elementsById->getElementById(elementId, this);
 }
 
+bool TreeScope::containsMultipleElementsWithId(const AtomicString& elementId) const
+{
+    return m_elementsById && m_elementsById->containsMultiple(elementId);
+}
+
 void TreeScope::addElementById(const AtomicString& elementId, Element* element)
 {
     if (!m_elementsById)
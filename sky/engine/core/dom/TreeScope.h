@@ -48,6 +48,7 @@ public:
     TreeScope* parentTreeScope() const { return m_parentTreeScope; }
 
     Element* getElementById(const AtomicString&) const;
+    bool containsMultipleElementsWithId(const AtomicString&) const;
     void addElementById(const AtomicString& elementId, Element*);
     void removeElementById(const AtomicString& elementId, Element*);
 
@@ -0,0 +1,15 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of dart.sky;
+
+/// How a [VelocityTracker] estimates velocities from positions
+enum VelocityEstimator {
+  /// Fit a second degree polynomial to the recent positions
+  leastSquares,
+
+  /// Sum up the kinetic energy that each movement imparts on the pointer,
+  /// which copes better with unevenly spaced positions
+  impulse
+}
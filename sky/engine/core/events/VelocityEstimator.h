@@ -0,0 +1,24 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_EVENTS_VELOCITYESTIMATOR_H_
+#define SKY_ENGINE_CORE_EVENTS_VELOCITYESTIMATOR_H_
+
+#include "sky/engine/tonic/dart_converter.h"
+
+namespace blink {
+
+// Must match the VelocityEstimator enum in VelocityEstimator.dart.
+enum VelocityEstimator {
+    VelocityEstimatorLeastSquares,
+    VelocityEstimatorImpulse,
+};
+
+template <>
+struct DartConverter<VelocityEstimator>
+    : public DartConverterEnum<int> {};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_EVENTS_VELOCITYESTIMATOR_H_
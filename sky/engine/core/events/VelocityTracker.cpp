@@ -93,6 +93,51 @@ float VectorNorm(const float* a, uint32_t m) {
   return sqrtf(r);
 }
 
+// The most recent positions of a single pointer, newest first. Pointers are
+// tracked separately so that positions added one pointer at a time do not
+// push the other pointers' positions out of the history.
+class PointerHistory {
+ public:
+  // Number of samples to keep.
+  static const uint32_t kHistorySize = 20;
+
+  struct Sample {
+    TimeTicks event_time;
+    PointerXY position;
+  };
+
+  PointerHistory() : newest_(0), count_(0) {}
+
+  uint32_t count() const { return count_; }
+  void Clear() { count_ = 0; }
+
+  void Add(const TimeTicks& event_time, const PointerXY& position) {
+    // A pointer that has not moved for a while has stopped, and its older
+    // samples say nothing about how it moves now.
+    if (count_ && event_time - at(0).event_time >=
+                      TimeDelta::FromMilliseconds(
+                          kAssumePointerMoveStoppedTimeMs)) {
+      count_ = 0;
+    }
+    newest_ = (newest_ + 1) % kHistorySize;
+    samples_[newest_].event_time = event_time;
+    samples_[newest_].position = position;
+    if (count_ < kHistorySize)
+      ++count_;
+  }
+
+  // Returns the |age|th newest sample.
+  const Sample& at(uint32_t age) const {
+    DCHECK_LT(age, count_);
+    return samples_[(newest_ + kHistorySize - age) % kHistorySize];
+  }
+
+ private:
+  uint32_t newest_;
+  uint32_t count_;
+  Sample samples_[kHistorySize];
+};
+
 // Velocity tracker algorithm based on least-squares linear regression.
 class LeastSquaresVelocityTrackerStrategy : public VelocityTrackerStrategy {
  public:
@@ -112,7 +157,7 @@ class LeastSquaresVelocityTrackerStrategy : public VelocityTrackerStrategy {
   };
 
   // Number of samples to keep.
-  static const uint8_t kHistorySize = 20;
+  static const uint8_t kHistorySize = PointerHistory::kHistorySize;
 
   // Degree must be no greater than Estimator::kMaxDegree.
   LeastSquaresVelocityTrackerStrategy(uint32_t degree,
@@ -132,22 +177,34 @@ class LeastSquaresVelocityTrackerStrategy : public VelocityTrackerStrategy {
   // changes in direction.
   static const uint8_t kHorizonMS = 100;
 
-  struct Movement {
-    TimeTicks event_time;
-    BitSet32 id_bits;
-    PointerXY positions[VelocityTracker::MAX_POINTERS];
-
-    inline const PointerXY& GetPointerXY(uint32_t id) const {
-      return positions[id_bits.get_index_of_bit(id)];
-    }
-  };
-
-  float ChooseWeight(uint32_t index) const;
+  float ChooseWeight(const PointerHistory& history, uint32_t age) const;
 
   const uint32_t degree_;
   const Weighting weighting_;
-  uint32_t index_;
-  Movement movements_[kHistorySize];
+  PointerHistory histories_[MAX_POINTER_ID + 1];
+};
+
+// Velocity tracker algorithm that treats the pointer as a mass pushed along
+// by the movement between samples. The kinetic energy gained and lost along
+// the way is summed up to give the final velocity, which makes this strategy
+// robust to uneven sampling without a polynomial fit.
+class ImpulseVelocityTrackerStrategy : public VelocityTrackerStrategy {
+ public:
+  ImpulseVelocityTrackerStrategy();
+  ~ImpulseVelocityTrackerStrategy() override;
+
+  void Clear() override;
+  void ClearPointers(BitSet32 id_bits) override;
+  void AddMovement(const TimeTicks& event_time,
+                   BitSet32 id_bits,
+                   const PointerXY* positions) override;
+  bool GetEstimator(uint32_t id, Estimator* out_estimator) const override;
+
+ private:
+  // Same as the least-squares strategy.
+  static const uint8_t kHorizonMS = 100;
+
+  PointerHistory histories_[MAX_POINTER_ID + 1];
 };
 
 // Velocity tracker algorithm that uses an IIR filter.
@@ -210,6 +267,8 @@ VelocityTrackerStrategy* CreateStrategy(VelocityTracker::Strategy strategy) {
       return new IntegratingVelocityTrackerStrategy(1);
     case VelocityTracker::INT2:
       return new IntegratingVelocityTrackerStrategy(2);
+    case VelocityTracker::IMPULSE:
+      return new ImpulseVelocityTrackerStrategy();
   }
   NOTREACHED() << "Unrecognized velocity tracker strategy: " << strategy;
   return CreateStrategy(VelocityTracker::STRATEGY_DEFAULT);
@@ -226,6 +285,22 @@ void VelocityTracker::addPosition(int timeStamp, int pointerId, float x, float y
   AddMovement(event_time, id_bits, &position);
 }
 
+void VelocityTracker::addPositions(const Float64List& positions) {
+  const intptr_t count = positions.num_elements() / kPositionFieldCount;
+  const double* data = positions.data();
+  for (intptr_t i = 0; i < count; ++i, data += kPositionFieldCount) {
+    int pointer_id = static_cast<int>(data[1]);
+    if (pointer_id < 0 || pointer_id > MAX_POINTER_ID)
+      continue;
+    TimeTicks event_time = TimeTicks() + TimeDelta::FromMicroseconds(
+        static_cast<int64_t>(data[0] * 1000));
+    BitSet32 id_bits(BitSet32::value_for_bit(pointer_id));
+    PointerXY position = {static_cast<float>(data[2]),
+                          static_cast<float>(data[3])};
+    AddMovement(event_time, id_bits, &position);
+  }
+}
+
 PassRefPtr<GestureVelocity> VelocityTracker::getVelocity(int pointerId) {
   float vx = 0;
   float vy = 0;
@@ -244,6 +319,13 @@ VelocityTracker::VelocityTracker()
       active_pointer_id_(-1),
       strategy_(CreateStrategy(STRATEGY_DEFAULT)) {}
 
+// static
+PassRefPtr<VelocityTracker> VelocityTracker::create(int estimator) {
+  if (estimator == VelocityEstimatorImpulse)
+    return adoptRef(new VelocityTracker(IMPULSE));
+  return adoptRef(new VelocityTracker(STRATEGY_DEFAULT));
+}
+
 VelocityTracker::VelocityTracker(Strategy strategy)
     : current_pointer_id_bits_(0),
       active_pointer_id_(-1),
@@ -310,16 +392,10 @@ void LeastSquaresVelocityTrackerStrategy::AddMovement(
     const TimeTicks& event_time,
     BitSet32 id_bits,
     const PointerXY* positions) {
-  if (++index_ == kHistorySize) {
-    index_ = 0;
-  }
-
-  Movement& movement = movements_[index_];
-  movement.event_time = event_time;
-  movement.id_bits = id_bits;
-  uint32_t count = id_bits.count();
-  for (uint32_t i = 0; i < count; i++) {
-    movement.positions[i] = positions[i];
+  uint32_t index = 0;
+  for (BitSet32 iter_id_bits(id_bits); !iter_id_bits.is_empty();) {
+    uint32_t id = iter_id_bits.clear_first_marked_bit();
+    histories_[id].Add(event_time, positions[index++]);
   }
 }
 
@@ -341,8 +417,8 @@ LeastSquaresVelocityTrackerStrategy::LeastSquaresVelocityTrackerStrategy(
 LeastSquaresVelocityTrackerStrategy::~LeastSquaresVelocityTrackerStrategy() {}
 
 void LeastSquaresVelocityTrackerStrategy::Clear() {
-  index_ = 0;
-  movements_[0].id_bits.clear();
+  for (PointerHistory& history : histories_)
+    history.Clear();
 }
 
 /**
@@ -501,8 +577,8 @@ static bool SolveLeastSquares(const float* x,
 }
 
 void LeastSquaresVelocityTrackerStrategy::ClearPointers(BitSet32 id_bits) {
-  BitSet32 remaining_id_bits(movements_[index_].id_bits.value & ~id_bits.value);
-  movements_[index_].id_bits = remaining_id_bits;
+  for (BitSet32 iter_id_bits(id_bits); !iter_id_bits.is_empty();)
+    histories_[iter_id_bits.clear_first_marked_bit()].Clear();
 }
 
 bool LeastSquaresVelocityTrackerStrategy::GetEstimator(
@@ -515,29 +591,24 @@ bool LeastSquaresVelocityTrackerStrategy::GetEstimator(
   float y[kHistorySize];
   float w[kHistorySize];
   float time[kHistorySize];
+  const PointerHistory& history = histories_[id];
+  if (history.count() == 0)
+    return false;  // no data
+
   uint32_t m = 0;
-  uint32_t index = index_;
   const base::TimeDelta horizon = base::TimeDelta::FromMilliseconds(kHorizonMS);
-  const Movement& newest_movement = movements_[index_];
-  do {
-    const Movement& movement = movements_[index];
-    if (!movement.id_bits.has_bit(id))
-      break;
-
-    TimeDelta age = newest_movement.event_time - movement.event_time;
+  const PointerHistory::Sample& newest_sample = history.at(0);
+  for (; m < history.count(); ++m) {
+    const PointerHistory::Sample& sample = history.at(m);
+    TimeDelta age = newest_sample.event_time - sample.event_time;
     if (age > horizon)
       break;
 
-    const PointerXY& position = movement.GetPointerXY(id);
-    x[m] = position.x;
-    y[m] = position.y;
-    w[m] = ChooseWeight(index);
+    x[m] = sample.position.x;
+    y[m] = sample.position.y;
+    w[m] = ChooseWeight(history, m);
     time[m] = -static_cast<float>(age.InSecondsF());
-    index = (index == 0 ? kHistorySize : index) - 1;
-  } while (++m < kHistorySize);
-
-  if (m == 0)
-    return false;  // no data
+  }
 
   // Calculate a least squares polynomial fit.
   uint32_t degree = degree_;
@@ -549,7 +620,7 @@ bool LeastSquaresVelocityTrackerStrategy::GetEstimator(
     uint32_t n = degree + 1;
     if (SolveLeastSquares(time, x, w, m, n, out_estimator->xcoeff, &xdet) &&
         SolveLeastSquares(time, y, w, m, n, out_estimator->ycoeff, &ydet)) {
-      out_estimator->time = newest_movement.event_time;
+      out_estimator->time = newest_sample.event_time;
       out_estimator->degree = degree;
       out_estimator->confidence = xdet * ydet;
       return true;
@@ -560,26 +631,27 @@ bool LeastSquaresVelocityTrackerStrategy::GetEstimator(
   // position.
   out_estimator->xcoeff[0] = x[0];
   out_estimator->ycoeff[0] = y[0];
-  out_estimator->time = newest_movement.event_time;
+  out_estimator->time = newest_sample.event_time;
   out_estimator->degree = 0;
   out_estimator->confidence = 1;
   return true;
 }
 
-float LeastSquaresVelocityTrackerStrategy::ChooseWeight(uint32_t index) const {
+float LeastSquaresVelocityTrackerStrategy::ChooseWeight(
+    const PointerHistory& history,
+    uint32_t age) const {
+  const TimeTicks event_time = history.at(age).event_time;
   switch (weighting_) {
     case WEIGHTING_DELTA: {
       // Weight points based on how much time elapsed between them and the next
       // point so that points that "cover" a shorter time span are weighed less.
       //   delta  0ms: 0.5
       //   delta 10ms: 1.0
-      if (index == index_) {
+      if (age == 0) {
         return 1.0f;
       }
-      uint32_t next_index = (index + 1) % kHistorySize;
-      float delta_millis =
-          static_cast<float>((movements_[next_index].event_time -
-                              movements_[index].event_time).InMillisecondsF());
+      float delta_millis = static_cast<float>(
+          (history.at(age - 1).event_time - event_time).InMillisecondsF());
       if (delta_millis < 0)
         return 0.5f;
       if (delta_millis < 10)
@@ -595,9 +667,8 @@ float LeastSquaresVelocityTrackerStrategy::ChooseWeight(uint32_t index) const {
       //   age 10ms: 1.0
       //   age 50ms: 1.0
       //   age 60ms: 0.5
-      float age_millis =
-          static_cast<float>((movements_[index_].event_time -
-                              movements_[index].event_time).InMillisecondsF());
+      float age_millis = static_cast<float>(
+          (history.at(0).event_time - event_time).InMillisecondsF());
       if (age_millis < 0)
         return 0.5f;
       if (age_millis < 10)
@@ -615,9 +686,8 @@ float LeastSquaresVelocityTrackerStrategy::ChooseWeight(uint32_t index) const {
       //   age   0ms: 1.0
       //   age  50ms: 1.0
       //   age 100ms: 0.5
-      float age_millis =
-          static_cast<float>((movements_[index_].event_time -
-                              movements_[index].event_time).InMillisecondsF());
+      float age_millis = static_cast<float>(
+          (history.at(0).event_time - event_time).InMillisecondsF());
       if (age_millis < 50) {
         return 1.0f;
       }
@@ -664,7 +734,9 @@ void IntegratingVelocityTrackerStrategy::AddMovement(
       InitState(state, event_time, position.x, position.y);
   }
 
-  pointer_id_bits_ = id_bits;
+  // Positions are added one pointer at a time, so pointers that are missing
+  // from this movement are still down. They are removed by ClearPointers.
+  pointer_id_bits_.value |= id_bits.value;
 }
 
 bool IntegratingVelocityTrackerStrategy::GetEstimator(
@@ -753,4 +825,102 @@ void IntegratingVelocityTrackerStrategy::PopulateEstimator(
   out_estimator->ycoeff[2] = state.yaccel / 2;
 }
 
+// --- ImpulseVelocityTrackerStrategy ---
+
+ImpulseVelocityTrackerStrategy::ImpulseVelocityTrackerStrategy() {}
+
+ImpulseVelocityTrackerStrategy::~ImpulseVelocityTrackerStrategy() {}
+
+void ImpulseVelocityTrackerStrategy::Clear() {
+  for (PointerHistory& history : histories_)
+    history.Clear();
+}
+
+void ImpulseVelocityTrackerStrategy::ClearPointers(BitSet32 id_bits) {
+  for (BitSet32 iter_id_bits(id_bits); !iter_id_bits.is_empty();)
+    histories_[iter_id_bits.clear_first_marked_bit()].Clear();
+}
+
+void ImpulseVelocityTrackerStrategy::AddMovement(const TimeTicks& event_time,
+                                                 BitSet32 id_bits,
+                                                 const PointerXY* positions) {
+  uint32_t index = 0;
+  for (BitSet32 iter_id_bits(id_bits); !iter_id_bits.is_empty();) {
+    uint32_t id = iter_id_bits.clear_first_marked_bit();
+    histories_[id].Add(event_time, positions[index++]);
+  }
+}
+
+// The velocity a unit mass has with |work| units of kinetic energy, keeping
+// the sign of |work| as the direction.
+static float KineticEnergyToVelocity(float work) {
+  const float kSqrt2 = 1.41421356237f;
+  return (work < 0 ? -1.0f : 1.0f) * sqrtf(fabsf(work)) * kSqrt2;
+}
+
+// |t| and |x| are ordered newest first, |t| in seconds.
+static float CalculateImpulseVelocity(const float* t,
+                                      const float* x,
+                                      uint32_t count) {
+  if (count < 2)
+    return 0;
+  if (count == 2) {
+    if (t[1] == t[0])
+      return 0;
+    return (x[1] - x[0]) / (t[1] - t[0]);
+  }
+  // Start with the oldest sample and go forward in time. The mass starts at
+  // rest, so the first segment only contributes half its kinetic energy.
+  float work = 0;
+  for (uint32_t i = count - 1; i > 0; i--) {
+    if (t[i] == t[i - 1])
+      continue;
+    float vprev = KineticEnergyToVelocity(work);
+    float vcurr = (x[i] - x[i - 1]) / (t[i] - t[i - 1]);
+    work += (vcurr - vprev) * fabsf(vcurr);
+    if (i == count - 1)
+      work *= 0.5f;
+  }
+  return KineticEnergyToVelocity(work);
+}
+
+bool ImpulseVelocityTrackerStrategy::GetEstimator(
+    uint32_t id,
+    Estimator* out_estimator) const {
+  out_estimator->Clear();
+
+  const PointerHistory& history = histories_[id];
+  if (history.count() == 0)
+    return false;  // no data
+
+  float x[PointerHistory::kHistorySize];
+  float y[PointerHistory::kHistorySize];
+  float time[PointerHistory::kHistorySize];
+  uint32_t m = 0;
+  const base::TimeDelta horizon = base::TimeDelta::FromMilliseconds(kHorizonMS);
+  const PointerHistory::Sample& newest_sample = history.at(0);
+  for (; m < history.count(); ++m) {
+    const PointerHistory::Sample& sample = history.at(m);
+    TimeDelta age = newest_sample.event_time - sample.event_time;
+    if (age > horizon)
+      break;
+    x[m] = sample.position.x;
+    y[m] = sample.position.y;
+    time[m] = -static_cast<float>(age.InSecondsF());
+  }
+
+  out_estimator->time = newest_sample.event_time;
+  out_estimator->xcoeff[0] = x[0];
+  out_estimator->ycoeff[0] = y[0];
+  out_estimator->confidence = 1;
+  if (m < 2) {
+    out_estimator->degree = 0;
+    return true;
+  }
+  out_estimator->xcoeff[1] = CalculateImpulseVelocity(time, x, m);
+  out_estimator->ycoeff[1] = CalculateImpulseVelocity(time, y, m);
+  out_estimator->degree = 1;
+  return true;
+}
+
 }  // namespace blink
@@ -15,7 +15,9 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/time/time.h"
 #include "sky/engine/core/events/GestureVelocity.h"
+#include "sky/engine/core/events/VelocityEstimator.h"
 #include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/tonic/typed_list.h"
 #include "sky/engine/wtf/OwnPtr.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefCounted.h"
@@ -204,7 +206,13 @@ public:
     // For comparison purposes only.  Unlike 'int1' this strategy can compensate
     // for acceleration but it typically overestimates the effect.
     INT2,
-    STRATEGY_MAX = INT2,
+
+    // Impulse-based: sums the kinetic energy that the movement between
+    // samples imparts on the pointer.  Quality: GOOD.
+    // Handles irregularly spaced samples better than the least squares
+    // strategies and needs no matrix math.
+    IMPULSE,
+    STRATEGY_MAX = IMPULSE,
 
     // The default velocity tracker strategy.
     // Although other strategies are available for testing and comparison
@@ -214,12 +222,15 @@ public:
     STRATEGY_DEFAULT = LSQ2,
   };
 
+  // The number of doubles per position passed to addPositions: the time
+  // stamp in milliseconds, the pointer id, x and y.
+  static const intptr_t kPositionFieldCount = 4;
+
   // VelocityTracker IDL implementation
-  static PassRefPtr<VelocityTracker> create() {
-    return adoptRef(new VelocityTracker());
-  }
+  static PassRefPtr<VelocityTracker> create(int estimator = 0);
   void reset();
   void addPosition(int timeStamp, int pointerId, float x, float y);
+  void addPositions(const Float64List& positions);
   PassRefPtr<GestureVelocity> getVelocity(int pointerId);
 
 
@@ -55,7 +55,6 @@ bool FrameView::s_inPaintContents = false;
 FrameView::FrameView(LocalFrame* frame)
     : m_frame(frame)
     , m_hasPendingLayout(false)
-    , m_layoutSubtreeRoot(0)
     , m_inSynchronousPostLayout(false)
     , m_postLayoutTasksTimer(this, &FrameView::postLayoutTimerFired)
     , m_isTransparent(false)
@@ -98,12 +97,14 @@ FrameView::~FrameView()
 void FrameView::reset()
 {
     m_hasPendingLayout = false;
-    m_layoutSubtreeRoot = 0;
+    m_layoutSubtreeRoots.clear();
     m_layoutSchedulingEnabled = true;
     m_inPerformLayout = false;
     m_inSynchronousPostLayout = false;
     m_layoutCount = 0;
     m_nestedLayoutCount = 0;
+    m_layoutCountAtLayoutStart = 0;
+    m_laidOutCountAtLayoutStart = 0;
     m_postLayoutTasksTimer.stop();
     m_firstLayout = true;
     m_lastViewportSize = IntSize();
@@ -174,9 +175,26 @@ void FrameView::recalcOverflowAfterStyleChange()
     renderView->recalcOverflowAfterStyleChange();
 }
 
-RenderObject* FrameView::layoutRoot(bool onlyDuringLayout) const
+bool FrameView::isLayoutSubtreeRoot(const RenderObject* object, bool onlyDuringLayout) const
 {
-    return onlyDuringLayout && layoutPending() ? 0 : m_layoutSubtreeRoot;
+    if (onlyDuringLayout && layoutPending())
+        return false;
+    return m_layoutSubtreeRoots.contains(object);
+}
+
+void FrameView::removeLayoutSubtreeRoot(RenderObject* object)
+{
+    size_t index = m_layoutSubtreeRoots.find(object);
+    if (index != kNotFound)
+        m_layoutSubtreeRoots.remove(index);
+}
+
+// Turns the pending subtree layouts into a full layout.
+void FrameView::clearLayoutSubtreeRoots()
+{
+    for (RenderObject* root : m_layoutSubtreeRoots)
+        root->markContainingBlocksForLayout(false);
+    m_layoutSubtreeRoots.clear();
 }
 
 void FrameView::performPreLayoutTasks()
@@ -266,10 +284,8 @@ void FrameView::layout(bool allowSubtree)
 
     RELEASE_ASSERT(!isPainting());
 
-    if (!allowSubtree && isSubtreeLayout()) {
-        m_layoutSubtreeRoot->markContainingBlocksForLayout(false);
-        m_layoutSubtreeRoot = 0;
-    }
+    if (!allowSubtree)
+        clearLayoutSubtreeRoots();
 
     performPreLayoutTasks();
 
@@ -280,18 +296,28 @@ void FrameView::layout(bool allowSubtree)
 
     Document* document = m_frame->document();
     bool inSubtreeLayout = isSubtreeLayout();
-    RenderObject* rootForThisLayout = inSubtreeLayout ? m_layoutSubtreeRoot : document->renderView();
-    if (!rootForThisLayout) {
+    // The roots are copied so that a full relayout scheduled while one of
+    // them is laid out does not disturb the iteration.
+    Vector<RenderObject*> rootsForThisLayout;
+    if (inSubtreeLayout)
+        rootsForThisLayout = m_layoutSubtreeRoots;
+    else if (document->renderView())
+        rootsForThisLayout.append(document->renderView());
+    if (rootsForThisLayout.isEmpty()) {
         // FIXME: Do we need to set m_size here?
         ASSERT_NOT_REACHED();
         return;
     }
 
     FontCachePurgePreventer fontCachePurgePreventer;
-    RenderLayer* layer;
+    Vector<RenderLayer*, 1> layers;
     {
         TemporaryChange<bool> changeSchedulingEnabled(m_layoutSchedulingEnabled, false);
 
+        if (!m_nestedLayoutCount) {
+            m_layoutCountAtLayoutStart = m_layoutCount;
+            m_laidOutCountAtLayoutStart = RenderObject::laidOutCount();
+        }
         m_nestedLayoutCount++;
 
         if (!inSubtreeLayout) {
@@ -303,18 +329,27 @@ void FrameView::layout(bool allowSubtree)
             m_size = LayoutSize(layoutSize());
         }
 
-        layer = rootForThisLayout->enclosingLayer();
+        for (RenderObject* root : rootsForThisLayout) {
+            RenderLayer* layer = root->enclosingLayer();
+            if (!layers.contains(layer))
+                layers.append(layer);
 
-        performLayout(rootForThisLayout, inSubtreeLayout);
+            performLayout(root, inSubtreeLayout);
+        }
 
-        m_layoutSubtreeRoot = 0;
+        m_layoutSubtreeRoots.clear();
     } // Reset m_layoutSchedulingEnabled to its previous value.
 
-    layer->updateLayerPositionsAfterLayout();
+    for (RenderLayer* layer : layers)
+        layer->updateLayerPositionsAfterLayout();
+    document->renderView()->geometryDidChange();
 
     m_layoutCount++;
 
-    ASSERT(!rootForThisLayout->needsLayout());
+#if ENABLE(ASSERT)
+    for (RenderObject* root : rootsForThisLayout)
+        ASSERT(!root->needsLayout());
+#endif
 
     scheduleOrPerformPostLayoutTasks();
 
@@ -322,6 +357,12 @@ void FrameView::layout(bool allowSubtree)
     if (m_nestedLayoutCount)
         return;
 
+    // Layouts that post-layout tasks trigger are counted with the one that
+    // ran the tasks, so a pass that keeps invalidating itself stands out.
+    TRACE_COUNTER2("blink", "Layout",
+        "relayouts", m_layoutCount - m_layoutCountAtLayoutStart,
+        "renderers", RenderObject::laidOutCount() - m_laidOutCountAtLayoutStart);
+
 #if ENABLE(ASSERT)
     // Post-layout assert that nobody was re-marked as needing layout during layout.
     document->renderView()->assertSubtreeIsLaidOut();
@@ -371,10 +412,7 @@ void FrameView::scheduleRelayout()
 {
     ASSERT(m_frame->view() == this);
 
-    if (isSubtreeLayout()) {
-        m_layoutSubtreeRoot->markContainingBlocksForLayout(false);
-        m_layoutSubtreeRoot = 0;
-    }
+    clearLayoutSubtreeRoots();
     if (!m_layoutSchedulingEnabled)
         return;
     if (!needsLayout())
@@ -389,6 +427,10 @@ void FrameView::scheduleRelayout()
     m_frame->document()->scheduleVisualUpdate();
 }
 
+// Beyond this many, finding where a new root goes costs more than laying
+// out the whole tree would save.
+static const size_t maxLayoutSubtreeRoots = 32;
+
 static bool isObjectAncestorContainerOf(RenderObject* ancestor, RenderObject* descendant)
 {
     for (RenderObject* r = descendant; r; r = r->container()) {
@@ -413,27 +455,48 @@ void FrameView::scheduleRelayoutOfSubtree(RenderObject* relayoutRoot)
     }
 
     if (layoutPending() || !m_layoutSchedulingEnabled) {
-        if (m_layoutSubtreeRoot != relayoutRoot) {
-            if (isObjectAncestorContainerOf(m_layoutSubtreeRoot, relayoutRoot)) {
+        if (m_layoutSubtreeRoots.contains(relayoutRoot))
+            return;
+
+        // A full layout is already pending.
+        if (!isSubtreeLayout()) {
+            relayoutRoot->markContainingBlocksForLayout(false);
+            return;
+        }
+
+        for (RenderObject* root : m_layoutSubtreeRoots) {
+            if (isObjectAncestorContainerOf(root, relayoutRoot)) {
                 // Keep the current root
-                relayoutRoot->markContainingBlocksForLayout(false, m_layoutSubtreeRoot);
-                ASSERT(!m_layoutSubtreeRoot->container() || !m_layoutSubtreeRoot->container()->needsLayout());
-            } else if (isSubtreeLayout() && isObjectAncestorContainerOf(relayoutRoot, m_layoutSubtreeRoot)) {
-                // Re-root at relayoutRoot
-                m_layoutSubtreeRoot->markContainingBlocksForLayout(false, relayoutRoot);
-                m_layoutSubtreeRoot = relayoutRoot;
-                ASSERT(!m_layoutSubtreeRoot->container() || !m_layoutSubtreeRoot->container()->needsLayout());
-            } else {
-                // Just do a full relayout
-                if (isSubtreeLayout())
-                    m_layoutSubtreeRoot->markContainingBlocksForLayout(false);
-                m_layoutSubtreeRoot = 0;
-                relayoutRoot->markContainingBlocksForLayout(false);
+                relayoutRoot->markContainingBlocksForLayout(false, root);
+                ASSERT(!root->container() || !root->container()->needsLayout());
+                return;
             }
         }
+
+        // The roots are fixed while they are being laid out.
+        if (m_inPerformLayout || m_layoutSubtreeRoots.size() >= maxLayoutSubtreeRoots) {
+            // Just do a full relayout
+            clearLayoutSubtreeRoots();
+            relayoutRoot->markContainingBlocksForLayout(false);
+            return;
+        }
+
+        // Re-root the roots inside relayoutRoot at it, and lay it out
+        // alongside the others.
+        size_t keptRoots = 0;
+        for (RenderObject* root : m_layoutSubtreeRoots) {
+            if (isObjectAncestorContainerOf(relayoutRoot, root))
+                root->markContainingBlocksForLayout(false, relayoutRoot);
+            else
+                m_layoutSubtreeRoots[keptRoots++] = root;
+        }
+        m_layoutSubtreeRoots.shrink(keptRoots);
+        m_layoutSubtreeRoots.append(relayoutRoot);
+        ASSERT(!relayoutRoot->container() || !relayoutRoot->container()->needsLayout());
     } else if (m_layoutSchedulingEnabled) {
-        m_layoutSubtreeRoot = relayoutRoot;
-        ASSERT(!m_layoutSubtreeRoot->container() || !m_layoutSubtreeRoot->container()->needsLayout());
+        ASSERT(!isSubtreeLayout());
+        m_layoutSubtreeRoots.append(relayoutRoot);
+        ASSERT(!relayoutRoot->container() || !relayoutRoot->container()->needsLayout());
         m_hasPendingLayout = true;
 
         m_frame->document()->scheduleVisualUpdate();
@@ -709,20 +772,22 @@ void FrameView::setLayoutSizeInternal(const IntSize& size)
 
 void FrameView::countObjectsNeedingLayout(unsigned& needsLayoutObjects, unsigned& totalObjects, bool& isPartial)
 {
-    RenderObject* root = layoutRoot();
+    Vector<RenderObject*> roots = m_layoutSubtreeRoots;
     isPartial = true;
-    if (!root) {
+    if (roots.isEmpty()) {
         isPartial = false;
-        root = m_frame->contentRenderer();
+        roots.append(m_frame->contentRenderer());
     }
 
     needsLayoutObjects = 0;
     totalObjects = 0;
 
-    for (RenderObject* o = root; o; o = o->nextInPreOrder(root)) {
-        ++totalObjects;
-        if (o->needsLayout())
-            ++needsLayoutObjects;
+    for (RenderObject* root : roots) {
+        for (RenderObject* o = root; o; o = o->nextInPreOrder(root)) {
+            ++totalObjects;
+            if (o->needsLayout())
+                ++needsLayoutObjects;
+        }
     }
 }
 
@@ -77,8 +77,10 @@ public:
     bool layoutPending() const;
     bool isInPerformLayout() const;
 
-    RenderObject* layoutRoot(bool onlyDuringLayout = false) const;
-    void clearLayoutSubtreeRoot() { m_layoutSubtreeRoot = 0; }
+    // Whether |object| is the root of one of the subtrees that the pending or
+    // current layout is limited to.
+    bool isLayoutSubtreeRoot(const RenderObject* object, bool onlyDuringLayout = false) const;
+    void removeLayoutSubtreeRoot(RenderObject* object);
     int layoutCount() const { return m_layoutCount; }
 
     bool needsLayout() const;
@@ -146,7 +148,7 @@ public:
     // FIXME: This should probably be renamed as the 'inSubtreeLayout' parameter
     // passed around the FrameView layout methods can be true while this returns
     // false.
-    bool isSubtreeLayout() const { return !!m_layoutSubtreeRoot; }
+    bool isSubtreeLayout() const { return !m_layoutSubtreeRoots.isEmpty(); }
 
     // FIXME(sky): remove
     IntPoint windowToContents(const IntPoint& windowPoint) const { return windowPoint; }
@@ -176,6 +178,7 @@ private:
     virtual bool isFrameView() const override { return true; }
 
     void forceLayoutParentViewIfNeeded();
+    void clearLayoutSubtreeRoots();
     void performPreLayoutTasks();
     void performLayout(RenderObject* rootForThisLayout, bool inSubtreeLayout);
     void scheduleOrPerformPostLayoutTasks();
@@ -197,13 +200,18 @@ private:
     RefPtr<LocalFrame> m_frame;
 
     bool m_hasPendingLayout;
-    RenderObject* m_layoutSubtreeRoot;
+    // Relayout boundaries that were dirtied independently of each other. None
+    // of them contains another, so each is laid out on its own.
+    Vector<RenderObject*> m_layoutSubtreeRoots;
 
     bool m_layoutSchedulingEnabled;
     bool m_inPerformLayout;
     bool m_inSynchronousPostLayout;
     int m_layoutCount;
     unsigned m_nestedLayoutCount;
+    // Where the counters stood when the outermost layout started.
+    int m_layoutCountAtLayoutStart;
+    unsigned m_laidOutCountAtLayoutStart;
     Timer<FrameView> m_postLayoutTasksTimer;
 
     bool m_firstLayout;
@@ -0,0 +1,20 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_LOADER_ANIMATEDIMAGECALLBACK_H_
+#define SKY_ENGINE_CORE_LOADER_ANIMATEDIMAGECALLBACK_H_
+
+#include "sky/engine/core/painting/AnimatedImage.h"
+
+namespace blink {
+
+class AnimatedImageCallback {
+public:
+    virtual ~AnimatedImageCallback() {}
+    virtual void handleEvent(AnimatedImage* result) = 0;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_LOADER_ANIMATEDIMAGECALLBACK_H_
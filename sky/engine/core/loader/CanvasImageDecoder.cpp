@@ -3,13 +3,277 @@
 // found in the LICENSE file.
 
 #include "base/bind.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/ref_counted.h"
 #include "base/message_loop/message_loop.h"
+#include "base/task_runner_util.h"
+#include "base/trace_event/trace_event_synthetic_delay.h"
+#include "gen/sky/platform/RuntimeEnabledFeatures.h"
+#include "skia/ext/image_operations.h"
 #include "sky/engine/core/loader/CanvasImageDecoder.h"
+#include "sky/engine/core/painting/AnimatedImage.h"
 #include "sky/engine/core/painting/CanvasImage.h"
+#include "sky/engine/core/painting/ImageAtlas.h"
 #include "sky/engine/platform/SharedBuffer.h"
+#include "sky/engine/platform/TraceEvent.h"
+#include "sky/engine/platform/graphics/DeferredImageDecoder.h"
 #include "sky/engine/platform/image-decoders/ImageDecoder.h"
+#include "sky/engine/public/platform/Platform.h"
+#include "sky/engine/wtf/StdLibExtras.h"
+#include "third_party/skia/include/core/SkData.h"
+#include "third_party/skia/include/core/SkImage.h"
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <string.h>
 
 namespace blink {
+namespace {
+
+// A burst of images, such as a grid scrolling into view, would otherwise
+// occupy every worker and every core at once.
+const int kMaxConcurrentDecodes = 2;
+
+// How much new data has to arrive before a partial image is decoded again.
+// Smaller steps mostly add copies of the partial frame.
+const size_t kMinBytesBetweenPartialDecodes = 32 * 1024;
+
+int g_active_decodes = 0;
+
+std::deque<base::WeakPtr<CanvasImageDecoder>>& PendingDecodes() {
+  DEFINE_STATIC_LOCAL(std::deque<base::WeakPtr<CanvasImageDecoder>>, queue,
+                      ());
+  return queue;
+}
+
+// Building a color transform for a profile is the slow part of color managed
+// decoding, and ImageDecoder shares them across images.
+ImageSource::GammaAndColorProfileOption ColorProfileOption() {
+  return RuntimeEnabledFeatures::colorManagedImagesEnabled()
+             ? ImageSource::GammaAndColorProfileApplied
+             : ImageSource::GammaAndColorProfileIgnored;
+}
+
+// The JPEG decoder scales by multiples of 1/8 while decoding, which is far
+// cheaper than decoding at full size and scaling afterwards.
+const unsigned kJPEGScaleDenominator = 8;
+
+// The scale that shrinks |size| as much as possible while still covering
+// |target|, or 1 if the image is no bigger than that already.
+double ScaleToCover(int width, int height, const SkISize& target) {
+  if (width <= 0 || height <= 0)
+    return 1;
+  double scale = std::max(static_cast<double>(target.width()) / width,
+                          static_cast<double>(target.height()) / height);
+  return std::min(scale, 1.0);
+}
+
+// The byte limit that makes the JPEG decoder pick the smallest DCT scale
+// whose output still covers |target|, or 0 to decode at full size.
+size_t MaxDecodedBytesForTarget(const IntSize& size, const SkISize& target) {
+  double scale = ScaleToCover(size.width(), size.height(), target);
+  unsigned numerator = std::max(
+      1u, static_cast<unsigned>(ceil(scale * kJPEGScaleDenominator)));
+  if (numerator >= kJPEGScaleDenominator)
+    return 0;
+  // JPEGImageDecoder::desiredScaleNumerator() inverts this, rounding down.
+  uint64_t original_bytes =
+      static_cast<uint64_t>(size.width()) * size.height() * 4;
+  uint64_t denominator_squared = kJPEGScaleDenominator * kJPEGScaleDenominator;
+  return static_cast<size_t>(
+      (original_bytes * numerator * numerator + denominator_squared - 1) /
+      denominator_squared);
+}
+
+// Whether |data| starts like a KTX, PKM or ASTC file. Those hold textures
+// that are already compressed in a GPU format, ETC1 for the first two.
+bool IsCompressedTexture(const SharedBuffer& data) {
+  static const unsigned char kKTXSignature[] = {
+      0xAB, 'K', 'T', 'X', ' ', '1', '1', 0xBB, '\r', '\n', 0x1A, '\n'};
+  static const unsigned char kPKMSignature[] = {'P', 'K', 'M', ' '};
+  static const unsigned char kASTCSignature[] = {0x13, 0xAB, 0xA1, 0x5C};
+
+  const unsigned char* bytes =
+      reinterpret_cast<const unsigned char*>(data.data());
+  auto starts_with = [&data, bytes](const unsigned char* signature,
+                                    size_t length) {
+    return data.size() >= length && !memcmp(bytes, signature, length);
+  };
+  return starts_with(kKTXSignature, sizeof(kKTXSignature)) ||
+         starts_with(kPKMSignature, sizeof(kPKMSignature)) ||
+         starts_with(kASTCSignature, sizeof(kASTCSignature));
+}
+
+}  // namespace
+
+// The data received so far and the decoder reading it. Both are only
+// touched by decode tasks on the worker pool, and a CanvasImageDecoder has
+// at most one of those in flight, so they are never used on two threads at
+// once. The decoder keeps its progress between tasks, so each task only
+// decodes the data that arrived since the previous one.
+class CanvasImageDecoder::DecodeState
+    : public base::RefCountedThreadSafe<DecodeState> {
+ public:
+  // Images bigger than needed to cover |target_size| are shrunk to that
+  // size. An empty |target_size| keeps images at their full size.
+  explicit DecodeState(const SkISize& target_size)
+      : target_size_(target_size),
+        checked_target_size_(target_size.isEmpty()),
+        repetition_count_(cAnimationNone) {}
+
+  // The frames of animated images, filled in by the decode of the complete
+  // data. Neither these nor the data are used by a decode task once that
+  // is done, so they can be read and taken on the UI thread afterwards.
+  const std::vector<double>& frame_durations() const {
+    return frame_durations_;
+  }
+  int repetition_count() const { return repetition_count_; }
+  PassRefPtr<SharedBuffer> TakeData() { return buffer_.release(); }
+
+  // Set instead of returning a bitmap when the complete data is a
+  // compressed texture. Like the frames, only read once the decode is done.
+  PassRefPtr<SkImage> TakeCompressedImage() {
+    return compressed_image_.release();
+  }
+
+  // Returns the first frame, or a null bitmap if there is nothing to show
+  // yet. Partial frames are copied, because the decoder keeps writing into
+  // the frame's pixels as more data arrives.
+  SkBitmap Decode(scoped_ptr<Vector<char>> data, bool all_data_received) {
+    TRACE_EVENT0("blink", "CanvasImageDecoder::DecodeState::Decode");
+    TRACE_EVENT_SYNTHETIC_DELAY("sky.ImageDecode");
+    // Images that are decoded in one go, which is most of them, adopt the
+    // data without copying it again.
+    if (!buffer_)
+      buffer_ = SharedBuffer::adoptVector(*data);
+    else
+      buffer_->append(*data);
+
+    // Compressed textures are not decoded here. Skia uploads them to the
+    // GPU as they are when it supports their format, and decodes them on
+    // the CPU when it draws them otherwise.
+    if (!decoder_ && all_data_received && IsCompressedTexture(*buffer_)) {
+      RefPtr<SkData> encoded = buffer_->getAsSkData();
+      compressed_image_ = adoptRef(SkImage::NewFromEncoded(encoded.get()));
+      return SkBitmap();
+    }
+
+    // decoder can be null if the buffer we was empty and we couldn't even
+    // guess what type of image to decode.
+    if (!decoder_) {
+      decoder_ = ImageDecoder::create(*buffer_.get(),
+                                      ImageSource::AlphaPremultiplied,
+                                      ColorProfileOption());
+      if (!decoder_)
+        return SkBitmap();
+    }
+    decoder_->setData(buffer_.get(), all_data_received);
+    if (!checked_target_size_ && decoder_->isSizeAvailable()) {
+      checked_target_size_ = true;
+      // Only the header has been read so far, so switching to a decoder
+      // that scales while decoding loses no work.
+      size_t max_decoded_bytes =
+          MaxDecodedBytesForTarget(decoder_->size(), target_size_);
+      if (decoder_->filenameExtension() == "jpg" && max_decoded_bytes) {
+        decoder_ = ImageDecoder::create(
+            *buffer_.get(), ImageSource::AlphaPremultiplied,
+            ColorProfileOption(), max_decoded_bytes);
+        if (!decoder_)
+          return SkBitmap();
+        decoder_->setData(buffer_.get(), all_data_received);
+      }
+    }
+    if (decoder_->failed() || decoder_->frameCount() == 0)
+      return SkBitmap();
+
+    if (all_data_received && decoder_->frameCount() > 1) {
+      for (size_t i = 0; i < decoder_->frameCount(); ++i) {
+        // Like browsers, treat very short frames as the 100ms that GIFs
+        // made for them were tuned to.
+        double duration = decoder_->frameDurationAtIndex(i);
+        frame_durations_.push_back(duration <= 10 ? 100 : duration);
+      }
+      repetition_count_ = decoder_->repetitionCount();
+    }
+
+    // Images too big for the atlas keep only their encoded bytes for good.
+    // Their pixels are decoded into discardable memory, which is purged
+    // under memory pressure and decoded again when the image is next drawn.
+    if (all_data_received && frame_durations_.empty() &&
+        target_size_.isEmpty() &&
+        DeferredImageDecoder::enabled() &&
+        (decoder_->size().width() > ImageAtlas::kMaxImageSize ||
+         decoder_->size().height() > ImageAtlas::kMaxImageSize)) {
+      SkBitmap lazy_bitmap = CreateLazyBitmap();
+      if (!lazy_bitmap.isNull())
+        return lazy_bitmap;
+    }
+
+    ImageFrame* imageFrame = decoder_->frameBufferAtIndex(0);
+    if (!imageFrame || imageFrame->status() == ImageFrame::FrameEmpty)
+      return SkBitmap();
+    const SkBitmap& bitmap = imageFrame->getSkBitmap();
+
+    // Formats that cannot scale while decoding, and JPEGs that are still
+    // bigger than the target after scaling, are shrunk the rest of the way.
+    double scale = ScaleToCover(bitmap.width(), bitmap.height(), target_size_);
+    if (!target_size_.isEmpty() && scale < 1) {
+      return skia::ImageOperations::Resize(
+          bitmap, skia::ImageOperations::RESIZE_BETTER,
+          std::max(1, static_cast<int>(ceil(bitmap.width() * scale))),
+          std::max(1, static_cast<int>(ceil(bitmap.height() * scale))));
+    }
+
+    // The bitmap shares its pixels with the frame and keeps them alive after
+    // the decoder is gone.
+    if (all_data_received)
+      return bitmap;
+
+    SkBitmap partial;
+    if (!bitmap.copyTo(&partial))
+      return SkBitmap();
+    return partial;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<DecodeState>;
+  ~DecodeState() {}
+
+  SkBitmap CreateLazyBitmap() {
+    OwnPtr<DeferredImageDecoder> deferred =
+        DeferredImageDecoder::create(*buffer_.get(),
+                                     ImageSource::AlphaPremultiplied,
+                                     ColorProfileOption());
+    if (!deferred)
+      return SkBitmap();
+    // The frame generator behind the bitmap keeps its own copy of the data.
+    deferred->setData(*buffer_.get(), true);
+    ImageFrame* imageFrame = deferred->frameBufferAtIndex(0);
+    if (!imageFrame ||
+        !DeferredImageDecoder::isLazyDecoded(imageFrame->getSkBitmap()))
+      return SkBitmap();
+
+    SkBitmap bitmap = imageFrame->getSkBitmap();
+    // Lets SkImage share the pixel ref instead of copying the pixels.
+    bitmap.setImmutable();
+    // Decode once here, so that the first frame that draws the image does
+    // not have to. The pixels stay around until they are purged.
+    bitmap.lockPixels();
+    bitmap.unlockPixels();
+    return bitmap;
+  }
+
+  RefPtr<SharedBuffer> buffer_;
+  OwnPtr<ImageDecoder> decoder_;
+  const SkISize target_size_;
+  bool checked_target_size_;
+  std::vector<double> frame_durations_;
+  int repetition_count_;
+  RefPtr<SkImage> compressed_image_;
+
+  DISALLOW_COPY_AND_ASSIGN(DecodeState);
+};
 
 PassRefPtr<CanvasImageDecoder> CanvasImageDecoder::create(
     mojo::ScopedDataPipeConsumerHandle handle,
@@ -20,7 +284,11 @@ PassRefPtr<CanvasImageDecoder> CanvasImageDecoder::create(
 CanvasImageDecoder::CanvasImageDecoder(
     mojo::ScopedDataPipeConsumerHandle handle,
     PassOwnPtr<ImageDecoderCallback> callback)
-    : callback_(callback), weak_factory_(this) {
+    : callback_(callback),
+      target_size_(SkISize::Make(0, 0)),
+      data_complete_(false),
+      decode_in_flight_(false),
+      weak_factory_(this) {
   CHECK(callback_);
   if (!handle.is_valid()) {
     base::MessageLoop::current()->PostTask(
@@ -29,38 +297,146 @@ CanvasImageDecoder::CanvasImageDecoder(
     return;
   }
 
-  buffer_ = SharedBuffer::create();
   drainer_ = adoptPtr(new mojo::common::DataPipeDrainer(this, handle.Pass()));
 }
 
 CanvasImageDecoder::~CanvasImageDecoder() {
 }
 
+void CanvasImageDecoder::setProgressCallback(
+    PassOwnPtr<ImageDecoderCallback> callback) {
+  progress_callback_ = callback;
+}
+
+void CanvasImageDecoder::setAnimatedImageCallback(
+    PassOwnPtr<AnimatedImageCallback> callback) {
+  animated_image_callback_ = callback;
+}
+
+void CanvasImageDecoder::setTargetSize(int width, int height) {
+  // The size is handed to the decode state when the first decode starts.
+  if (!state_ && width > 0 && height > 0)
+    target_size_ = SkISize::Make(width, height);
+}
+
 void CanvasImageDecoder::OnDataAvailable(const void* data, size_t num_bytes) {
-  buffer_->append(static_cast<const char*>(data), num_bytes);
+  // The drainer reads the pipe in place, so this is the only copy made
+  // before the bytes reach the decoder.
+  pending_data_.append(static_cast<const char*>(data), num_bytes);
+
+  // Partial decodes share the limit with complete ones, but do not wait for
+  // it: they are skipped and tried again when more data arrives.
+  if (progress_callback_ && !decode_in_flight_ &&
+      pending_data_.size() >= kMinBytesBetweenPartialDecodes &&
+      g_active_decodes < kMaxConcurrentDecodes) {
+    StartDecode();
+  }
 }
 
 void CanvasImageDecoder::OnDataComplete() {
-  OwnPtr<ImageDecoder> decoder =
-      ImageDecoder::create(*buffer_.get(), ImageSource::AlphaPremultiplied,
-                           ImageSource::GammaAndColorProfileIgnored);
-  // decoder can be null if the buffer we was empty and we couldn't even guess
-  // what type of image to decode.
-  if (!decoder) {
-    callback_->handleEvent(nullptr);
+  data_complete_ = true;
+  // A partial decode that is still running queues the final one when it is
+  // done.
+  if (decode_in_flight_)
     return;
+  PendingDecodes().push_back(weak_factory_.GetWeakPtr());
+  StartPendingDecodes();
+}
+
+void CanvasImageDecoder::StartPendingDecodes() {
+  std::deque<base::WeakPtr<CanvasImageDecoder>>& pending = PendingDecodes();
+  while (g_active_decodes < kMaxConcurrentDecodes && !pending.empty()) {
+    base::WeakPtr<CanvasImageDecoder> decoder = pending.front();
+    pending.pop_front();
+    // Decoders that went away while waiting are skipped.
+    if (decoder)
+      decoder->StartDecode();
   }
-  decoder->setData(buffer_.get(), true);
-  if (decoder->failed() || decoder->frameCount() == 0) {
+}
+
+void CanvasImageDecoder::StartDecode() {
+  DCHECK(!decode_in_flight_);
+  ++g_active_decodes;
+  decode_in_flight_ = true;
+  if (!state_)
+    state_ = make_scoped_refptr(new DecodeState(target_size_));
+
+  const bool all_data_received = data_complete_;
+  scoped_ptr<Vector<char>> data(new Vector<char>);
+  data->swap(pending_data_);
+  base::PostTaskAndReplyWithResult(
+      Platform::current()->workerTaskRunner(Platform::UserBlockingWorkerTask),
+      FROM_HERE,
+      base::Bind(&DecodeState::Decode, state_, base::Passed(&data),
+                 all_data_received),
+      base::Bind(&CanvasImageDecoder::DidDecode, weak_factory_.GetWeakPtr(),
+                 all_data_received));
+}
+
+// static
+void CanvasImageDecoder::DidDecode(base::WeakPtr<CanvasImageDecoder> decoder,
+                                   bool all_data_received,
+                                   const SkBitmap& bitmap) {
+  --g_active_decodes;
+  if (decoder) {
+    decoder->decode_in_flight_ = false;
+    if (all_data_received) {
+      decoder->OnDecodeComplete(bitmap);
+    } else {
+      decoder->OnPartialDecode(bitmap);
+      if (decoder && decoder->data_complete_)
+        PendingDecodes().push_back(decoder);
+    }
+  }
+  StartPendingDecodes();
+}
+
+void CanvasImageDecoder::OnPartialDecode(const SkBitmap& bitmap) {
+  if (bitmap.isNull() || !progress_callback_)
+    return;
+  // Partial images are short lived, so they are not packed into the atlas.
+  RefPtr<CanvasImage> partialImage = CanvasImage::create();
+  partialImage->setImage(adoptRef(SkImage::NewFromBitmap(bitmap)));
+  progress_callback_->handleEvent(partialImage.get());
+}
+
+void CanvasImageDecoder::OnDecodeComplete(const SkBitmap& bitmap) {
+  scoped_refptr<DecodeState> state = state_;
+  state_ = nullptr;
+  if (RefPtr<SkImage> compressedImage = state->TakeCompressedImage()) {
+    // Compressed textures cannot be copied into the atlas.
+    RefPtr<CanvasImage> resultImage = CanvasImage::create();
+    resultImage->setImage(compressedImage.release());
+    callback_->handleEvent(resultImage.get());
+    return;
+  }
+  if (bitmap.isNull()) {
     callback_->handleEvent(nullptr);
     return;
   }
 
+  RefPtr<AnimatedImage> animatedImage;
+  if (animated_image_callback_ && !state->frame_durations().empty()) {
+    animatedImage = AnimatedImage::create(state->TakeData(),
+                                          state->frame_durations(),
+                                          state->repetition_count());
+  }
+
   RefPtr<CanvasImage> resultImage = CanvasImage::create();
-  ImageFrame* imageFrame = decoder->frameBufferAtIndex(0);
-  RefPtr<SkImage> skImage = adoptRef(SkImage::NewFromBitmap(imageFrame->getSkBitmap()));
-  resultImage->setImage(skImage.release());
+  RefPtr<ImageAtlasPage> page;
+  SkIRect rect;
+  if (ImageAtlas::shared().add(bitmap, page, rect)) {
+    resultImage->setAtlasEntry(page.release(), rect);
+  } else {
+    RefPtr<SkImage> skImage = adoptRef(SkImage::NewFromBitmap(bitmap));
+    resultImage->setImage(skImage.release());
+  }
+
+  // The callbacks run Dart, which can drop the last reference to us.
+  RefPtr<CanvasImageDecoder> protect(this);
   callback_->handleEvent(resultImage.get());
+  if (animatedImage)
+    animated_image_callback_->handleEvent(animatedImage.get());
 }
 
 void CanvasImageDecoder::RejectCallback() {
@@ -6,13 +6,17 @@
 #ifndef SKY_ENGINE_CORE_LOADER_CANVASIMAGELOADER_H_
 #define SKY_ENGINE_CORE_LOADER_CANVASIMAGELOADER_H_
 
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
 #include "mojo/data_pipe_utils/data_pipe_drainer.h"
+#include "sky/engine/core/loader/AnimatedImageCallback.h"
 #include "sky/engine/core/loader/ImageDecoderCallback.h"
 #include "sky/engine/platform/SharedBuffer.h"
 #include "sky/engine/tonic/dart_wrappable.h"
 #include "sky/engine/wtf/OwnPtr.h"
+#include "sky/engine/wtf/Vector.h"
 #include "sky/engine/wtf/text/AtomicString.h"
+#include "third_party/skia/include/core/SkBitmap.h"
 
 namespace blink {
 
@@ -24,6 +28,20 @@ class CanvasImageDecoder : public mojo::common::DataPipeDrainer::Client,
   static PassRefPtr<CanvasImageDecoder> create(mojo::ScopedDataPipeConsumerHandle handle, PassOwnPtr<ImageDecoderCallback> callback);
   virtual ~CanvasImageDecoder();
 
+  // Called with partial images while the data is still arriving, for
+  // formats that can show something before they are complete, such as
+  // progressive JPEGs and interlaced PNGs.
+  void setProgressCallback(PassOwnPtr<ImageDecoderCallback> callback);
+
+  // Called after the ImageDecoderCallback, with all the frames of images
+  // that have more than one.
+  void setAnimatedImageCallback(PassOwnPtr<AnimatedImageCallback> callback);
+
+  // Decodes the image no bigger than it needs to be to cover |width| by
+  // |height| pixels, keeping its aspect ratio. Has no effect once decoding
+  // has started, so call it right after creating the decoder.
+  void setTargetSize(int width, int height);
+
   // mojo::common::DataPipeDrainer::Client
   void OnDataAvailable(const void*, size_t) override;
   void OnDataComplete() override;
@@ -33,9 +51,29 @@ class CanvasImageDecoder : public mojo::common::DataPipeDrainer::Client,
 
   void RejectCallback();
 
+  class DecodeState;
+
+  // Decoding runs on the worker pool. Only a few images are decoded at a
+  // time, the others wait on the UI thread in the order their data arrived.
+  static void StartPendingDecodes();
+  static void DidDecode(base::WeakPtr<CanvasImageDecoder> decoder,
+                        bool all_data_received,
+                        const SkBitmap& bitmap);
+  void StartDecode();
+  void OnPartialDecode(const SkBitmap& bitmap);
+  void OnDecodeComplete(const SkBitmap& bitmap);
+
   OwnPtr<mojo::common::DataPipeDrainer> drainer_;
-  RefPtr<SharedBuffer> buffer_;
+  scoped_refptr<DecodeState> state_;
+  // Data that has arrived since the last decode task was posted. It is
+  // copied once, out of the data pipe, and handed to the decode task.
+  Vector<char> pending_data_;
   OwnPtr<ImageDecoderCallback> callback_;
+  OwnPtr<ImageDecoderCallback> progress_callback_;
+  OwnPtr<AnimatedImageCallback> animated_image_callback_;
+  SkISize target_size_;
+  bool data_complete_;
+  bool decode_in_flight_;
 
   base::WeakPtrFactory<CanvasImageDecoder> weak_factory_;
 };
@@ -0,0 +1,203 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/painting/AnimatedImage.h"
+
+#include "base/bind.h"
+#include "base/task_runner_util.h"
+#include "sky/engine/core/loader/ImageDecoderCallback.h"
+#include "sky/engine/platform/TraceEvent.h"
+#include "sky/engine/platform/image-decoders/ImageDecoder.h"
+#include "sky/engine/public/platform/Platform.h"
+#include "sky/engine/wtf/Vector.h"
+
+namespace blink {
+namespace {
+
+// Enough for the frame on screen, the next one being decoded ahead of time,
+// and one to spare for callers that are a frame behind.
+const size_t kMaxDecodedFrames = 3;
+
+}  // namespace
+
+// Decodes frames on the worker pool. AnimatedImage has at most one decode
+// in flight, so the decoder is never used on two threads at once.
+class AnimatedImage::FrameDecoder
+    : public base::RefCountedThreadSafe<FrameDecoder> {
+ public:
+  explicit FrameDecoder(PassRefPtr<SharedBuffer> data) : data_(data) {}
+
+  SkBitmap DecodeFrame(int index) {
+    TRACE_EVENT1("blink", "AnimatedImage::FrameDecoder::DecodeFrame", "index",
+                 index);
+    if (!decoder_) {
+      decoder_ = ImageDecoder::create(*data_.get(),
+                                      ImageSource::AlphaPremultiplied,
+                                      ImageSource::GammaAndColorProfileIgnored);
+      if (!decoder_)
+        return SkBitmap();
+      decoder_->setData(data_.get(), true);
+    }
+
+    // The decoder decodes whichever earlier frames this one is drawn on top
+    // of, reusing the ones it still has.
+    ImageFrame* imageFrame = decoder_->frameBufferAtIndex(index);
+    if (!imageFrame || imageFrame->status() != ImageFrame::FrameComplete)
+      return SkBitmap();
+
+    // The decoder draws later frames into the same pixels.
+    SkBitmap frame;
+    if (!imageFrame->getSkBitmap().copyTo(&frame))
+      return SkBitmap();
+    frame.setImmutable();
+
+    // Frames after this one only need this one, so the decoder does not
+    // have to keep the others around.
+    decoder_->clearCacheExceptFrame(index);
+    return frame;
+  }
+
+ private:
+  friend class base::RefCountedThreadSafe<FrameDecoder>;
+  ~FrameDecoder() {}
+
+  RefPtr<SharedBuffer> data_;
+  OwnPtr<ImageDecoder> decoder_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameDecoder);
+};
+
+AnimatedImage::Request::Request(int index,
+                                PassOwnPtr<ImageDecoderCallback> callback)
+    : index(index), callback(callback) {
+}
+
+AnimatedImage::Request::~Request() {
+}
+
+PassRefPtr<AnimatedImage> AnimatedImage::create(
+    PassRefPtr<SharedBuffer> data,
+    const std::vector<double>& frame_durations,
+    int repetition_count) {
+  return adoptRef(
+      new AnimatedImage(data, frame_durations, repetition_count));
+}
+
+AnimatedImage::AnimatedImage(PassRefPtr<SharedBuffer> data,
+                             const std::vector<double>& frame_durations,
+                             int repetition_count)
+    : decoder_(make_scoped_refptr(new FrameDecoder(data))),
+      frame_durations_(frame_durations),
+      repetition_count_(repetition_count),
+      decode_in_flight_(false),
+      weak_factory_(this) {
+}
+
+AnimatedImage::~AnimatedImage() {
+}
+
+double AnimatedImage::frameDuration(int index) const {
+  if (index < 0 || index >= frameCount())
+    return 0;
+  return frame_durations_[index];
+}
+
+void AnimatedImage::getFrame(int index,
+                             PassOwnPtr<ImageDecoderCallback> callback) {
+  if (!callback)
+    return;
+  if (index < 0 || index >= frameCount()) {
+    callback->handleEvent(nullptr);
+    return;
+  }
+
+  int next = (index + 1) % frameCount();
+  if (CanvasImage* frame = decodedFrame(index)) {
+    if (!decodedFrame(next))
+      addRequest(next, nullptr);
+    callback->handleEvent(frame);
+    return;
+  }
+
+  addRequest(index, callback);
+  addRequest(next, nullptr);
+}
+
+CanvasImage* AnimatedImage::decodedFrame(int index) const {
+  for (const auto& frame : decoded_frames_) {
+    if (frame.first == index)
+      return frame.second.get();
+  }
+  return nullptr;
+}
+
+void AnimatedImage::addRequest(int index,
+                               PassOwnPtr<ImageDecoderCallback> callback) {
+  // Frames that are asked for ahead of time only need to be decoded once.
+  if (!callback) {
+    if (decodedFrame(index))
+      return;
+    for (const auto& request : requests_) {
+      if (request->index == index)
+        return;
+    }
+  }
+  requests_.append(adoptPtr(new Request(index, callback)));
+  decodeNextFrame();
+}
+
+void AnimatedImage::decodeNextFrame() {
+  if (decode_in_flight_ || requests_.isEmpty())
+    return;
+
+  int index = requests_.first()->index;
+  decode_in_flight_ = true;
+  base::PostTaskAndReplyWithResult(
+      Platform::current()->workerTaskRunner(Platform::UserBlockingWorkerTask),
+      FROM_HERE,
+      base::Bind(&FrameDecoder::DecodeFrame, decoder_, index),
+      base::Bind(&AnimatedImage::didDecodeFrame, weak_factory_.GetWeakPtr(),
+                 index));
+}
+
+// static
+void AnimatedImage::didDecodeFrame(base::WeakPtr<AnimatedImage> image,
+                                   int index,
+                                   const SkBitmap& bitmap) {
+  if (image)
+    image->onFrameDecoded(index, bitmap);
+}
+
+void AnimatedImage::onFrameDecoded(int index, const SkBitmap& bitmap) {
+  decode_in_flight_ = false;
+
+  RefPtr<CanvasImage> frame;
+  if (!bitmap.isNull()) {
+    frame = CanvasImage::create();
+    frame->setImage(adoptRef(SkImage::NewFromBitmap(bitmap)));
+    decoded_frames_.push_back(std::make_pair(index, frame));
+    if (decoded_frames_.size() > kMaxDecodedFrames)
+      decoded_frames_.erase(decoded_frames_.begin());
+  }
+
+  // Every request for this frame is answered by this decode. The callbacks
+  // run Dart, which can ask for more frames, so they are collected first.
+  Vector<OwnPtr<ImageDecoderCallback>> callbacks;
+  Deque<OwnPtr<Request>> remaining;
+  while (!requests_.isEmpty()) {
+    OwnPtr<Request> request = requests_.takeFirst();
+    if (request->index != index)
+      remaining.append(request.release());
+    else if (request->callback)
+      callbacks.append(request->callback.release());
+  }
+  requests_.swap(remaining);
+
+  RefPtr<AnimatedImage> protect(this);
+  decodeNextFrame();
+  for (const auto& callback : callbacks)
+    callback->handleEvent(frame.get());
+}
+
+}  // namespace blink
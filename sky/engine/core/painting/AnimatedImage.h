@@ -0,0 +1,84 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_PAINTING_ANIMATEDIMAGE_H_
+#define SKY_ENGINE_CORE_PAINTING_ANIMATEDIMAGE_H_
+
+#include <utility>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/weak_ptr.h"
+#include "sky/engine/core/painting/CanvasImage.h"
+#include "sky/engine/platform/SharedBuffer.h"
+#include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/wtf/Deque.h"
+#include "sky/engine/wtf/OwnPtr.h"
+#include "sky/engine/wtf/PassOwnPtr.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefCounted.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace blink {
+
+class ImageDecoderCallback;
+
+class AnimatedImage final : public RefCounted<AnimatedImage>,
+                            public DartWrappable {
+  DEFINE_WRAPPERTYPEINFO();
+ public:
+  ~AnimatedImage() override;
+  // |frame_durations| are in milliseconds. |data| has to be all of the
+  // image's data and must not be used anywhere else afterwards.
+  static PassRefPtr<AnimatedImage> create(
+      PassRefPtr<SharedBuffer> data,
+      const std::vector<double>& frame_durations,
+      int repetition_count);
+
+  int frameCount() const { return frame_durations_.size(); }
+  int repetitionCount() const { return repetition_count_; }
+  double frameDuration(int index) const;
+
+  void getFrame(int index, PassOwnPtr<ImageDecoderCallback> callback);
+
+ private:
+  class FrameDecoder;
+
+  // A callback waiting for a frame. Frames that are decoded ahead of time
+  // have no callback.
+  struct Request {
+    Request(int index, PassOwnPtr<ImageDecoderCallback> callback);
+    ~Request();
+
+    int index;
+    OwnPtr<ImageDecoderCallback> callback;
+  };
+
+  AnimatedImage(PassRefPtr<SharedBuffer> data,
+                const std::vector<double>& frame_durations,
+                int repetition_count);
+
+  CanvasImage* decodedFrame(int index) const;
+  void addRequest(int index, PassOwnPtr<ImageDecoderCallback> callback);
+  void decodeNextFrame();
+  static void didDecodeFrame(base::WeakPtr<AnimatedImage> image,
+                             int index,
+                             const SkBitmap& bitmap);
+  void onFrameDecoded(int index, const SkBitmap& bitmap);
+
+  scoped_refptr<FrameDecoder> decoder_;
+  const std::vector<double> frame_durations_;
+  const int repetition_count_;
+
+  // The most recently decoded frames, newest last.
+  std::vector<std::pair<int, RefPtr<CanvasImage>>> decoded_frames_;
+  Deque<OwnPtr<Request>> requests_;
+  bool decode_in_flight_;
+
+  base::WeakPtrFactory<AnimatedImage> weak_factory_;
+};
+
+}  // namespace blink
+
+#endif  // SKY_ENGINE_CORE_PAINTING_ANIMATEDIMAGE_H_
@@ -205,6 +205,16 @@ void Canvas::drawImage(const CanvasImage* image, const Point& p, const Paint& pa
     if (!m_canvas)
         return;
     ASSERT(image);
+    didDrawGPUResources(image->image_task_runner());
+    if (image->is_atlased()) {
+        const SkIRect& rect = image->atlas_rect();
+        // The atlas pads every image with its edge pixels, so sampling does
+        // not need to be constrained to the image's part of the page.
+        m_canvas->drawImageRect(image->atlas_image(), SkRect::Make(rect),
+            SkRect::MakeXYWH(p.sk_point.x(), p.sk_point.y(), rect.width(), rect.height()),
+            paint.paint(), SkCanvas::kFast_SrcRectConstraint);
+        return;
+    }
     m_canvas->drawImage(image->image(), p.sk_point.x(), p.sk_point.y(), paint.paint());
 }
 
@@ -212,6 +222,19 @@ void Canvas::drawImageRect(const CanvasImage* image, Rect& src, Rect& dst, const
     if (!m_canvas)
         return;
     ASSERT(image);
+    didDrawGPUResources(image->image_task_runner());
+    if (image->is_atlased()) {
+        const SkIRect& rect = image->atlas_rect();
+        // Source rects reaching outside the image would sample its neighbours
+        // on the page, so those draw from a standalone copy instead.
+        if (SkRect::MakeIWH(rect.width(), rect.height()).contains(src.sk_rect)) {
+            SkRect atlasSrc = src.sk_rect;
+            atlasSrc.offset(rect.x(), rect.y());
+            m_canvas->drawImageRect(image->atlas_image(), atlasSrc, dst.sk_rect,
+                paint.paint(), SkCanvas::kFast_SrcRectConstraint);
+            return;
+        }
+    }
     m_canvas->drawImageRect(image->image(), src.sk_rect, dst.sk_rect, paint.paint());
 }
 
@@ -220,6 +243,7 @@ void Canvas::drawPicture(Picture* picture)
     if (!m_canvas)
         return;
     ASSERT(picture);
+    didDrawGPUResources(picture->imageTaskRunner());
     m_canvas->drawPicture(picture->toSkia());
 }
 
@@ -228,9 +252,18 @@ void Canvas::drawDrawable(Drawable* drawable)
     if (!m_canvas)
         return;
     ASSERT(drawable);
+    didDrawGPUResources(drawable->imageTaskRunner());
     m_canvas->drawDrawable(drawable->toSkia());
 }
 
+void Canvas::didDrawGPUResources(base::SingleThreadTaskRunner* taskRunner)
+{
+    // There is only one GPU thread, so the first task runner seen is the
+    // only one there is.
+    if (taskRunner && !m_imageTaskRunner)
+        m_imageTaskRunner = taskRunner;
+}
+
 void Canvas::drawVertices(SkCanvas::VertexMode vertexMode,
         const Vector<Point>& vertices,
         const Vector<Point>& textureCoordinates,
@@ -250,25 +283,28 @@ void Canvas::drawVertices(SkCanvas::VertexMode vertexMode,
         return es.ThrowRangeError("vertices and colors lengths must match");
 
     Vector<SkPoint> skVertices;
+    skVertices.reserveInitialCapacity(vertexCount);
     for (size_t x = 0; x < vertices.size(); x++) {
         const Point& point = vertices[x];
         if (point.is_null)
             return es.ThrowRangeError("vertices contained a null");
-        skVertices.append(point.sk_point);
+        skVertices.uncheckedAppend(point.sk_point);
     }
 
     Vector<SkPoint> skTextureCoordinates;
+    skTextureCoordinates.reserveInitialCapacity(textureCoordinates.size());
     for (size_t x = 0; x < textureCoordinates.size(); x++) {
         const Point& point = textureCoordinates[x];
         if (point.is_null)
             return es.ThrowRangeError("textureCoordinates contained a null");
-        skTextureCoordinates.append(point.sk_point);
+        skTextureCoordinates.uncheckedAppend(point.sk_point);
     }
 
     Vector<uint16_t> skIndices;
+    skIndices.reserveInitialCapacity(indices.size());
     for (size_t x = 0; x < indices.size(); x++) {
         uint16_t i = indices[x];
-        skIndices.append(i);
+        skIndices.uncheckedAppend(i);
     }
 
     RefPtr<SkXfermode> transferModePtr = adoptRef(SkXfermode::Create(transferMode));
@@ -293,6 +329,7 @@ void Canvas::drawAtlas(CanvasImage* atlas,
 {
     if (!m_canvas)
         return;
+    didDrawGPUResources(atlas->image_task_runner());
     RefPtr<SkImage> skImage = atlas->image();
     if (transforms.size() != rects.size())
         return es.ThrowRangeError("transforms and rects lengths must match");
@@ -300,19 +337,21 @@ void Canvas::drawAtlas(CanvasImage* atlas,
         return es.ThrowRangeError("if supplied, colors length must match that of transforms and rects");
 
     Vector<SkRSXform> skXForms;
+    skXForms.reserveInitialCapacity(transforms.size());
     for (size_t x = 0; x < transforms.size(); x++) {
         const RSTransform& transform = transforms[x];
         if (transform.is_null)
             return es.ThrowRangeError("transforms contained a null");
-        skXForms.append(transform.sk_xform);
+        skXForms.uncheckedAppend(transform.sk_xform);
     }
 
     Vector<SkRect> skRects;
+    skRects.reserveInitialCapacity(rects.size());
     for (size_t x = 0; x < rects.size(); x++) {
         const Rect& rect = rects[x];
         if (rect.is_null)
             return es.ThrowRangeError("rects contained a null");
-        skRects.append(rect.sk_rect);
+        skRects.uncheckedAppend(rect.sk_rect);
     }
 
     m_canvas->drawAtlas(
@@ -327,5 +366,195 @@ void Canvas::drawAtlas(CanvasImage* atlas,
     );
 }
 
+static_assert(sizeof(SkPoint) == 2 * sizeof(float), "SkPoint must be two floats");
+static_assert(sizeof(SkRSXform) == 4 * sizeof(float), "SkRSXform must be four floats");
+static_assert(sizeof(SkRect) == 4 * sizeof(float), "SkRect must be four floats");
+static_assert(sizeof(SkColor) == sizeof(int32_t), "SkColor must be 32 bits");
+
+void Canvas::drawRawVertices(SkCanvas::VertexMode vertexMode,
+        const Float32List& vertices,
+        const Float32List& textureCoordinates,
+        const Int32List& colors,
+        SkXfermode::Mode transferMode,
+        const Int32List& indices,
+        const Paint& paint,
+        ExceptionState& es)
+{
+    if (!m_canvas)
+        return;
+    if (vertices.num_elements() % 2)
+        return es.ThrowRangeError("vertices length must be a multiple of 2");
+    size_t vertexCount = vertices.num_elements() / 2;
+
+    if (textureCoordinates.num_elements() && static_cast<size_t>(textureCoordinates.num_elements()) != vertexCount * 2)
+        return es.ThrowRangeError("vertices and textureCoordinates lengths must match");
+    if (colors.num_elements() && static_cast<size_t>(colors.num_elements()) != vertexCount)
+        return es.ThrowRangeError("vertices and colors lengths must match");
+
+    // Skia takes 16 bit indices, so these are the only data that still have
+    // to be copied.
+    Vector<uint16_t> skIndices;
+    skIndices.reserveInitialCapacity(indices.num_elements());
+    for (intptr_t x = 0; x < indices.num_elements(); x++) {
+        int32_t i = indices[x];
+        if (i < 0 || static_cast<size_t>(i) >= vertexCount)
+            return es.ThrowRangeError("indices must refer to vertices");
+        skIndices.uncheckedAppend(i);
+    }
+
+    RefPtr<SkXfermode> transferModePtr = adoptRef(SkXfermode::Create(transferMode));
+
+    m_canvas->drawVertices(
+        vertexMode,
+        vertexCount,
+        reinterpret_cast<const SkPoint*>(vertices.data()),
+        textureCoordinates.num_elements() ? reinterpret_cast<const SkPoint*>(textureCoordinates.data()) : nullptr,
+        colors.num_elements() ? reinterpret_cast<const SkColor*>(colors.data()) : nullptr,
+        transferModePtr.get(),
+        skIndices.isEmpty() ? nullptr : skIndices.data(),
+        skIndices.size(),
+        *paint.paint()
+    );
+}
+
+void Canvas::drawRawAtlas(CanvasImage* atlas,
+    const Float32List& transforms, const Float32List& rects,
+    const Int32List& colors, SkXfermode::Mode mode,
+    const Rect& cullRect, const Paint& paint, ExceptionState& es)
+{
+    if (!m_canvas)
+        return;
+    if (!atlas)
+        return es.ThrowTypeError("image must not be null");
+    if (transforms.num_elements() % 4)
+        return es.ThrowRangeError("transforms length must be a multiple of 4");
+    if (transforms.num_elements() != rects.num_elements())
+        return es.ThrowRangeError("transforms and rects lengths must match");
+    size_t spriteCount = transforms.num_elements() / 4;
+    if (colors.num_elements() && static_cast<size_t>(colors.num_elements()) != spriteCount)
+        return es.ThrowRangeError("if supplied, colors length must match the number of sprites");
+
+    didDrawGPUResources(atlas->image_task_runner());
+    RefPtr<SkImage> skImage = atlas->image();
+    m_canvas->drawAtlas(
+        skImage.get(),
+        reinterpret_cast<const SkRSXform*>(transforms.data()),
+        reinterpret_cast<const SkRect*>(rects.data()),
+        colors.num_elements() ? reinterpret_cast<const SkColor*>(colors.data()) : nullptr,
+        spriteCount,
+        mode,
+        cullRect.is_null ? nullptr : &cullRect.sk_rect,
+        paint.paint()
+    );
+}
+
+namespace {
+
+// Must match the constants in DrawCommandBuffer.dart.
+enum DrawCommand {
+    kSave,
+    kRestore,
+    kTranslate,
+    kScale,
+    kRotate,
+    kClipRect,
+    kDrawPaint,
+    kDrawLine,
+    kDrawRect,
+    kDrawOval,
+    kDrawCircle,
+
+    // kNumberOfDrawCommands must be last.
+    kNumberOfDrawCommands,
+};
+
+// The number of floats following each command. Commands that draw start
+// with the index of their paint.
+const int kDrawCommandArgumentCounts[kNumberOfDrawCommands] = {
+    0, // kSave
+    0, // kRestore
+    2, // kTranslate
+    2, // kScale
+    1, // kRotate
+    4, // kClipRect
+    1, // kDrawPaint
+    5, // kDrawLine
+    5, // kDrawRect
+    5, // kDrawOval
+    4, // kDrawCircle
+};
+
+SkRect RectFromArguments(const float* args)
+{
+    return SkRect::MakeLTRB(args[0], args[1], args[2], args[3]);
+}
+
+} // namespace
+
+void Canvas::drawCommands(const Float32List& commands, const Vector<Paint>& paints, ExceptionState& es)
+{
+    if (!m_canvas)
+        return;
+
+    const float* data = commands.data();
+    const intptr_t length = commands.num_elements();
+
+    for (intptr_t i = 0; i < length;) {
+        const int command = static_cast<int>(data[i]);
+        if (command < 0 || command >= kNumberOfDrawCommands)
+            return es.ThrowRangeError("commands contained an unknown command");
+        const int argumentCount = kDrawCommandArgumentCounts[command];
+        if (i + 1 + argumentCount > length)
+            return es.ThrowRangeError("commands ended in the middle of a command");
+        const float* args = data + i + 1;
+        i += 1 + argumentCount;
+
+        switch (command) {
+        case kSave:
+            m_canvas->save();
+            continue;
+        case kRestore:
+            m_canvas->restore();
+            continue;
+        case kTranslate:
+            m_canvas->translate(args[0], args[1]);
+            continue;
+        case kScale:
+            m_canvas->scale(args[0], args[1]);
+            continue;
+        case kRotate:
+            m_canvas->rotate(args[0] * 180.0 / M_PI);
+            continue;
+        case kClipRect:
+            m_canvas->clipRect(RectFromArguments(args));
+            continue;
+        }
+
+        // The remaining commands draw with a paint from the table.
+        const size_t paintIndex = static_cast<size_t>(args[0]);
+        if (args[0] < 0 || paintIndex >= paints.size() || paints[paintIndex].is_null)
+            return es.ThrowRangeError("commands referred to a missing paint");
+        const SkPaint& paint = paints[paintIndex].sk_paint;
+        ++args;
+
+        switch (command) {
+        case kDrawPaint:
+            m_canvas->drawPaint(paint);
+            break;
+        case kDrawLine:
+            m_canvas->drawLine(args[0], args[1], args[2], args[3], paint);
+            break;
+        case kDrawRect:
+            m_canvas->drawRect(RectFromArguments(args), paint);
+            break;
+        case kDrawOval:
+            m_canvas->drawOval(RectFromArguments(args), paint);
+            break;
+        case kDrawCircle:
+            m_canvas->drawCircle(args[0], args[1], args[2], paint);
+            break;
+        }
+    }
+}
 
 } // namespace blink
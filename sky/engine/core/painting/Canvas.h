@@ -5,6 +5,8 @@
 #ifndef SKY_ENGINE_CORE_PAINTING_CANVAS_H_
 #define SKY_ENGINE_CORE_PAINTING_CANVAS_H_
 
+#include "base/memory/ref_counted.h"
+#include "base/single_thread_task_runner.h"
 #include "sky/engine/bindings/exception_state.h"
 #include "sky/engine/core/painting/CanvasPath.h"
 #include "sky/engine/core/painting/Drawable.h"
@@ -20,7 +22,7 @@
 #include "sky/engine/core/painting/VertexMode.h"
 #include "sky/engine/platform/graphics/DisplayList.h"
 #include "sky/engine/tonic/dart_wrappable.h"
-#include "sky/engine/tonic/float32_list.h"
+#include "sky/engine/tonic/typed_list.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefCounted.h"
 #include "third_party/skia/include/core/SkCanvas.h"
@@ -106,10 +108,32 @@ public:
         const Vector<SkColor>& colors, SkXfermode::Mode mode,
         const Rect& cullRect, const Paint& paint, ExceptionState&);
 
+    void drawRawVertices(SkCanvas::VertexMode vertexMode,
+        const Float32List& vertices,
+        const Float32List& textureCoordinates,
+        const Int32List& colors,
+        SkXfermode::Mode transferMode,
+        const Int32List& indices,
+        const Paint& paint,
+        ExceptionState& es);
+
+    void drawRawAtlas(CanvasImage* atlas,
+        const Float32List& transforms, const Float32List& rects,
+        const Int32List& colors, SkXfermode::Mode mode,
+        const Rect& cullRect, const Paint& paint, ExceptionState&);
+
+    void drawCommands(const Float32List& commands, const Vector<Paint>& paints,
+        ExceptionState&);
+
     SkCanvas* skCanvas() { return m_canvas; }
     void clearSkCanvas() { m_canvas = nullptr; }
     bool isRecording() const { return !!m_canvas; }
 
+    // The thread that owns the textures of the GPU backed images drawn so
+    // far, if any. Pictures recorded from this canvas have to be released
+    // on it.
+    base::SingleThreadTaskRunner* imageTaskRunner() const { return m_imageTaskRunner.get(); }
+
 protected:
     explicit Canvas(SkCanvas* skCanvas);
 
@@ -118,6 +142,10 @@ private:
     // which does not transfer ownership.  For this reason, we hold a raw
     // pointer and manually set the SkCanvas to null in clearSkCanvas.
     SkCanvas* m_canvas;
+
+    void didDrawGPUResources(base::SingleThreadTaskRunner* taskRunner);
+
+    scoped_refptr<base::SingleThreadTaskRunner> m_imageTaskRunner;
 };
 
 } // namespace blink
@@ -4,20 +4,80 @@
 
 #include "sky/engine/core/painting/CanvasImage.h"
 
+#include "base/bind.h"
+#include "base/location.h"
+#include "sky/engine/core/painting/CanvasImageEncoder.h"
+
 namespace blink {
+namespace {
+
+// Decoded images are stored unpacked, whatever format they came in.
+const size_t kBytesPerPixel = 4;
+
+void ReleaseImage(SkImage* image) {
+  image->unref();
+}
+
+}  // namespace
 
 CanvasImage::CanvasImage() {
 }
 
 CanvasImage::~CanvasImage() {
+  if (image_task_runner_ && image_) {
+    image_task_runner_->PostTask(
+        FROM_HERE, base::Bind(&ReleaseImage, image_.release().leakRef()));
+  }
+}
+
+void CanvasImage::setImage(
+    PassRefPtr<SkImage> image,
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner) {
+  image_ = image;
+  image_task_runner_ = task_runner;
+}
+
+void CanvasImage::encode(const String& mime_type,
+                         double quality,
+                         mojo::ScopedDataPipeProducerHandle producer,
+                         PassOwnPtr<ImageEncoderCallback> callback) {
+  CanvasImageEncoder::Encode(this, mime_type, quality, producer.Pass(),
+                             callback);
 }
 
 int CanvasImage::width() const {
+  if (atlas_page_)
+    return atlas_rect_.width();
   return image_->width();
 }
 
 int CanvasImage::height() const {
+  if (atlas_page_)
+    return atlas_rect_.height();
   return image_->height();
 }
 
+size_t CanvasImage::GetAllocationSize() {
+  // Atlased images only account for their part of the shared page.
+  size_t pixels = 0;
+  if (atlas_page_)
+    pixels = static_cast<size_t>(atlas_rect_.width()) * atlas_rect_.height();
+  else if (image_)
+    pixels = static_cast<size_t>(image_->width()) * image_->height();
+  return sizeof(CanvasImage) + pixels * kBytesPerPixel;
+}
+
+SkImage* CanvasImage::image() const {
+  if (!image_ && atlas_page_)
+    image_ = atlas_page_->newSubsetImage(atlas_rect_);
+  return image_.get();
+}
+
+void CanvasImage::setAtlasEntry(PassRefPtr<ImageAtlasPage> page,
+                                const SkIRect& rect) {
+  atlas_page_ = page;
+  atlas_rect_ = rect;
+  image_ = nullptr;
+}
+
 }  // namespace blink
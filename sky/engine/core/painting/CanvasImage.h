@@ -5,8 +5,14 @@
 #ifndef SKY_ENGINE_CORE_PAINTING_CANVASIMAGE_H_
 #define SKY_ENGINE_CORE_PAINTING_CANVASIMAGE_H_
 
+#include "base/memory/ref_counted.h"
+#include "base/single_thread_task_runner.h"
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "sky/engine/core/painting/ImageAtlas.h"
+#include "sky/engine/core/painting/ImageEncoderCallback.h"
 #include "sky/engine/platform/weborigin/KURL.h"
 #include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/wtf/PassOwnPtr.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/text/AtomicString.h"
 #include "third_party/skia/include/core/SkImage.h"
@@ -23,13 +29,43 @@ class CanvasImage final : public RefCounted<CanvasImage>,
   int width() const;
   int height() const;
 
-  SkImage* image() const { return image_.get(); }
+  // DartWrappable:
+  size_t GetAllocationSize() override;
+
+  // Writes the image into |producer| encoded as |mime_type|. See
+  // CanvasImageEncoder.
+  void encode(const String& mime_type,
+              double quality,
+              mojo::ScopedDataPipeProducerHandle producer,
+              PassOwnPtr<ImageEncoderCallback> callback);
+
+  // A standalone image, for uses that cannot draw from an atlas page. Made
+  // on first use for atlased images.
+  SkImage* image() const;
   void setImage(PassRefPtr<SkImage> image) { image_ = image; }
 
+  // For GPU backed images, which have to be released on the thread that
+  // owns their texture.
+  void setImage(PassRefPtr<SkImage> image,
+                scoped_refptr<base::SingleThreadTaskRunner> task_runner);
+  base::SingleThreadTaskRunner* image_task_runner() const {
+    return image_task_runner_.get();
+  }
+
+  // Small images are drawn from a part of a shared atlas page instead. See
+  // ImageAtlas.
+  void setAtlasEntry(PassRefPtr<ImageAtlasPage> page, const SkIRect& rect);
+  bool is_atlased() const { return atlas_page_; }
+  SkImage* atlas_image() const { return atlas_page_->image(); }
+  const SkIRect& atlas_rect() const { return atlas_rect_; }
+
  private:
   CanvasImage();
 
-  RefPtr<SkImage> image_;
+  mutable RefPtr<SkImage> image_;
+  scoped_refptr<base::SingleThreadTaskRunner> image_task_runner_;
+  RefPtr<ImageAtlasPage> atlas_page_;
+  SkIRect atlas_rect_;
 };
 
 }  // namespace blink
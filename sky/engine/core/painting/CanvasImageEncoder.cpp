@@ -0,0 +1,151 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/painting/CanvasImageEncoder.h"
+
+#include <string>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "mojo/data_pipe_utils/data_pipe_utils.h"
+#include "sky/engine/core/painting/CanvasImage.h"
+#include "sky/engine/platform/TraceEvent.h"
+#include "sky/engine/platform/image-encoders/skia/JPEGImageEncoder.h"
+#include "sky/engine/platform/image-encoders/skia/PNGImageEncoder.h"
+#include "sky/engine/wtf/Vector.h"
+
+namespace blink {
+namespace {
+
+// Reads |image| into a new bitmap, or returns a null bitmap on failure.
+// GPU images have to be read on the thread that owns their texture.
+SkBitmap ReadPixels(SkImage* image) {
+  TRACE_EVENT0("blink", "CanvasImageEncoder::ReadPixels");
+  SkBitmap bitmap;
+  if (!bitmap.tryAllocPixels(
+          SkImageInfo::MakeN32Premul(image->width(), image->height())))
+    return SkBitmap();
+  if (!image->readPixels(bitmap.info(), bitmap.getPixels(), bitmap.rowBytes(),
+                         0, 0))
+    return SkBitmap();
+  return bitmap;
+}
+
+// Blocks until the whole image has been written into |producer| or the
+// other end has been closed. Closes |producer| when done, which tells the
+// reader that there is no more data.
+bool EncodeToPipe(const SkBitmap& bitmap,
+                  CanvasImageEncoder::Format format,
+                  int quality,
+                  mojo::ScopedDataPipeProducerHandle producer) {
+  TRACE_EVENT0("blink", "CanvasImageEncoder::EncodeToPipe");
+  if (bitmap.isNull())
+    return false;
+
+  Vector<unsigned char> encoded;
+  bool encoded_ok = format == CanvasImageEncoder::JPEG
+                        ? JPEGImageEncoder::encode(bitmap, quality, &encoded)
+                        : PNGImageEncoder::encode(bitmap, &encoded);
+  if (!encoded_ok)
+    return false;
+
+  std::string data(reinterpret_cast<const char*>(encoded.data()),
+                   encoded.size());
+  return mojo::common::BlockingCopyFromString(data, producer);
+}
+
+bool ReadAndEncodeToPipe(RefPtr<SkImage> image,
+                         CanvasImageEncoder::Format format,
+                         int quality,
+                         mojo::ScopedDataPipeProducerHandle producer) {
+  return EncodeToPipe(ReadPixels(image.get()), format, quality,
+                      producer.Pass());
+}
+
+}  // namespace
+
+// static
+void CanvasImageEncoder::Encode(PassRefPtr<CanvasImage> image,
+                                const String& mime_type,
+                                double quality,
+                                mojo::ScopedDataPipeProducerHandle producer,
+                                PassOwnPtr<ImageEncoderCallback> callback) {
+  // Like canvas.toDataURL, fall back to PNG and to the default quality.
+  Format format = mime_type == "image/jpeg" ? JPEG : PNG;
+  int jpeg_quality = JPEGImageEncoder::DefaultCompressionQuality;
+  if (quality >= 0 && quality <= 1)
+    jpeg_quality = static_cast<int>(quality * 100 + 0.5);
+
+  RefPtr<CanvasImageEncoder> encoder = adoptRef(new CanvasImageEncoder(
+      image, format, jpeg_quality, producer.Pass(), callback));
+  encoder->Start();
+}
+
+CanvasImageEncoder::CanvasImageEncoder(
+    PassRefPtr<CanvasImage> image,
+    Format format,
+    int quality,
+    mojo::ScopedDataPipeProducerHandle producer,
+    PassOwnPtr<ImageEncoderCallback> callback)
+    : image_(image),
+      format_(format),
+      quality_(quality),
+      producer_(producer.Pass()),
+      callback_(callback) {}
+
+CanvasImageEncoder::~CanvasImageEncoder() {
+}
+
+void CanvasImageEncoder::Start() {
+  SkImage* image = image_ ? image_->image() : nullptr;
+  if (!image || !producer_.is_valid()) {
+    // Called from Dart, so the callback has to wait for the next task.
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&CanvasImageEncoder::DidEncode,
+                              RefPtr<CanvasImageEncoder>(this), false));
+    return;
+  }
+
+  if (base::SingleThreadTaskRunner* task_runner = image_->image_task_runner()) {
+    // |image_| keeps the texture alive while it is read, and is only ever
+    // released on this thread.
+    base::PostTaskAndReplyWithResult(
+        task_runner, FROM_HERE, base::Bind(&ReadPixels, image),
+        base::Bind(&CanvasImageEncoder::DidReadPixels,
+                   RefPtr<CanvasImageEncoder>(this)));
+    return;
+  }
+
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+      base::Bind(&ReadAndEncodeToPipe, RefPtr<SkImage>(image), format_,
+                 quality_, base::Passed(&producer_)),
+      base::Bind(&CanvasImageEncoder::DidEncode,
+                 RefPtr<CanvasImageEncoder>(this)));
+}
+
+// static
+void CanvasImageEncoder::DidReadPixels(RefPtr<CanvasImageEncoder> encoder,
+                                       const SkBitmap& bitmap) {
+  encoder->EncodeBitmap(bitmap);
+}
+
+void CanvasImageEncoder::EncodeBitmap(const SkBitmap& bitmap) {
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+      base::Bind(&EncodeToPipe, bitmap, format_, quality_,
+                 base::Passed(&producer_)),
+      base::Bind(&CanvasImageEncoder::DidEncode,
+                 RefPtr<CanvasImageEncoder>(this)));
+}
+
+// static
+void CanvasImageEncoder::DidEncode(RefPtr<CanvasImageEncoder> encoder,
+                                   bool success) {
+  encoder->callback_->handleEvent(success);
+}
+
+}  // namespace blink
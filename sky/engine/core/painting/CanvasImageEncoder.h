@@ -0,0 +1,67 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_PAINTING_CANVASIMAGEENCODER_H_
+#define SKY_ENGINE_CORE_PAINTING_CANVASIMAGEENCODER_H_
+
+#include "mojo/public/cpp/system/data_pipe.h"
+#include "sky/engine/core/painting/ImageEncoderCallback.h"
+#include "sky/engine/wtf/OwnPtr.h"
+#include "sky/engine/wtf/PassOwnPtr.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefCounted.h"
+#include "sky/engine/wtf/RefPtr.h"
+#include "sky/engine/wtf/text/WTFString.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+
+namespace blink {
+
+class CanvasImage;
+
+// Encodes an image as PNG or JPEG and writes the result into a data pipe
+// without blocking the UI thread. GPU images are read back on the thread
+// that owns their texture. Everything else, including the encoding and
+// the writes into the pipe, happens on the worker pool. Keeps itself and
+// the image alive until the callback has run.
+class CanvasImageEncoder : public RefCounted<CanvasImageEncoder> {
+ public:
+  enum Format {
+    PNG,
+    JPEG,
+  };
+
+  // |mime_type| is "image/png" or "image/jpeg", other types encode as PNG.
+  // |quality| in [0, 1] only applies to JPEG.
+  static void Encode(PassRefPtr<CanvasImage> image,
+                     const String& mime_type,
+                     double quality,
+                     mojo::ScopedDataPipeProducerHandle producer,
+                     PassOwnPtr<ImageEncoderCallback> callback);
+
+  ~CanvasImageEncoder();
+
+ private:
+  CanvasImageEncoder(PassRefPtr<CanvasImage> image,
+                     Format format,
+                     int quality,
+                     mojo::ScopedDataPipeProducerHandle producer,
+                     PassOwnPtr<ImageEncoderCallback> callback);
+
+  void Start();
+  void EncodeBitmap(const SkBitmap& bitmap);
+
+  static void DidReadPixels(RefPtr<CanvasImageEncoder> encoder,
+                            const SkBitmap& bitmap);
+  static void DidEncode(RefPtr<CanvasImageEncoder> encoder, bool success);
+
+  RefPtr<CanvasImage> image_;
+  const Format format_;
+  const int quality_;
+  mojo::ScopedDataPipeProducerHandle producer_;
+  OwnPtr<ImageEncoderCallback> callback_;
+};
+
+}  // namespace blink
+
+#endif  // SKY_ENGINE_CORE_PAINTING_CANVASIMAGEENCODER_H_
@@ -4,10 +4,28 @@
 
 #include "sky/engine/core/painting/CanvasPath.h"
 
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/wtf/MainThread.h"
+
 namespace blink {
 
 CanvasPath::CanvasPath()
 {
+    // Skia caches the GPU representation of non-volatile paths by generation
+    // ID, which only pays off for paths that are drawn on more than one frame.
+    m_path.setIsVolatile(true);
+}
+
+void* CanvasPath::operator new(size_t size)
+{
+    ASSERT(isMainThread());
+    return partitionAlloc(Partitions::getWrappablePartition(), size);
+}
+
+void CanvasPath::operator delete(void* ptr)
+{
+    ASSERT(isMainThread());
+    partitionFree(ptr);
 }
 
 CanvasPath::~CanvasPath()
@@ -17,7 +35,24 @@ CanvasPath::~CanvasPath()
 PassRefPtr<CanvasPath> CanvasPath::shift(const Offset& offset) {
   RefPtr<CanvasPath> path = CanvasPath::create();
   m_path.offset(offset.sk_size.width(), offset.sk_size.height(), &path->m_path);
+  // The shifted path is a new path, whatever this one was marked as.
+  path->m_path.setIsVolatile(true);
   return path.release();
 }
 
+void CanvasPath::makeImmutable()
+{
+    // The path's generation ID stays the same from here on since it is no
+    // longer modified, so cached tessellations keyed on it stay valid.
+    m_path.setIsVolatile(false);
+}
+
+bool CanvasPath::checkMutable(ExceptionState& es)
+{
+    if (!isImmutable())
+        return true;
+    es.ThrowTypeError("Cannot modify an immutable Path");
+    return false;
+}
+
 } // namespace blink
@@ -7,6 +7,7 @@
 
 #include "math.h"
 
+#include "sky/engine/bindings/exception_state.h"
 #include "sky/engine/core/painting/Offset.h"
 #include "sky/engine/core/painting/Rect.h"
 #include "sky/engine/tonic/dart_wrappable.h"
@@ -24,36 +25,48 @@ class CanvasPath : public RefCounted<CanvasPath>, public DartWrappable {
     DEFINE_WRAPPERTYPEINFO();
 public:
     ~CanvasPath() override;
+
+    // Allocated out of the wrappable partition.
+    void* operator new(size_t);
+    void operator delete(void*);
     static PassRefPtr<CanvasPath> create()
     {
         return adoptRef(new CanvasPath);
     }
 
-    void moveTo(float x, float y)
+    void moveTo(float x, float y, ExceptionState& es)
     {
-        m_path.moveTo(x, y);
+        if (checkMutable(es))
+            m_path.moveTo(x, y);
     }
 
-    void lineTo(float x, float y)
+    void lineTo(float x, float y, ExceptionState& es)
     {
-        m_path.lineTo(x, y);
+        if (checkMutable(es))
+            m_path.lineTo(x, y);
     }
 
-    void arcTo(const Rect& rect, float startAngle, float sweepAngle, bool forceMoveTo)
+    void arcTo(const Rect& rect, float startAngle, float sweepAngle, bool forceMoveTo, ExceptionState& es)
     {
-        m_path.arcTo(rect.sk_rect, startAngle*180.0/M_PI, sweepAngle*180.0/M_PI, forceMoveTo);
+        if (checkMutable(es))
+            m_path.arcTo(rect.sk_rect, startAngle*180.0/M_PI, sweepAngle*180.0/M_PI, forceMoveTo);
     }
 
-    void addOval(const Rect& oval)
+    void addOval(const Rect& oval, ExceptionState& es)
     {
-        m_path.addOval(oval.sk_rect);
+        if (checkMutable(es))
+            m_path.addOval(oval.sk_rect);
     }
 
-    void close()
+    void close(ExceptionState& es)
     {
-        m_path.close();
+        if (checkMutable(es))
+            m_path.close();
     }
 
+    void makeImmutable();
+    bool isImmutable() const { return !m_path.isVolatile(); }
+
     const SkPath& path() const { return m_path; }
 
     PassRefPtr<CanvasPath> shift(const Offset& offset);
@@ -61,6 +74,8 @@ public:
 private:
     CanvasPath();
 
+    bool checkMutable(ExceptionState& es);
+
     SkPath m_path;
 };
 
@@ -0,0 +1,143 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of dart.sky;
+
+// Must match DrawCommand enum in Canvas.cpp.
+const int _kSave = 0;
+const int _kRestore = 1;
+const int _kTranslate = 2;
+const int _kScale = 3;
+const int _kRotate = 4;
+const int _kClipRect = 5;
+const int _kDrawPaint = 6;
+const int _kDrawLine = 7;
+const int _kDrawRect = 8;
+const int _kDrawOval = 9;
+const int _kDrawCircle = 10;
+
+/// Records canvas operations into a single typed buffer so that they can be
+/// replayed with one call into the engine.
+///
+/// Each paint is converted once per replay no matter how many operations
+/// use it, so reuse the same [Paint] objects where possible. Paints must not
+/// be modified between recording and the call to [replay].
+class DrawCommandBuffer {
+  static const int _kInitialCapacity = 256;
+
+  Float32List _commands = new Float32List(_kInitialCapacity);
+  int _length = 0;
+
+  final List<Paint> _paints = new List<Paint>();
+  final Map<Paint, int> _paintIndices = new Map<Paint, int>.identity();
+
+  bool get isEmpty => _length == 0;
+
+  void save() => _add0(_kSave);
+  void restore() => _add0(_kRestore);
+  void translate(double dx, double dy) => _add2(_kTranslate, dx, dy);
+  void scale(double sx, double sy) => _add2(_kScale, sx, sy);
+  void rotate(double radians) => _add1(_kRotate, radians);
+
+  void clipRect(Rect rect) {
+    _reserve(5);
+    _commands[_length++] = _kClipRect.toDouble();
+    _addRect(rect);
+  }
+
+  void drawPaint(Paint paint) {
+    _reserve(2);
+    _commands[_length++] = _kDrawPaint.toDouble();
+    _addPaint(paint);
+  }
+
+  void drawLine(Point p1, Point p2, Paint paint) {
+    _reserve(6);
+    _commands[_length++] = _kDrawLine.toDouble();
+    _addPaint(paint);
+    _commands[_length++] = p1.x;
+    _commands[_length++] = p1.y;
+    _commands[_length++] = p2.x;
+    _commands[_length++] = p2.y;
+  }
+
+  void drawRect(Rect rect, Paint paint) => _addRectOp(_kDrawRect, rect, paint);
+  void drawOval(Rect rect, Paint paint) => _addRectOp(_kDrawOval, rect, paint);
+
+  void drawCircle(Point c, double radius, Paint paint) {
+    _reserve(5);
+    _commands[_length++] = _kDrawCircle.toDouble();
+    _addPaint(paint);
+    _commands[_length++] = c.x;
+    _commands[_length++] = c.y;
+    _commands[_length++] = radius;
+  }
+
+  /// Draws the recorded operations into [canvas]. The buffer keeps its
+  /// contents and can be replayed again.
+  void replay(Canvas canvas) {
+    if (isEmpty)
+      return;
+    canvas.drawCommands(new Float32List.view(_commands.buffer, 0, _length),
+                        _paints);
+  }
+
+  /// Forgets all recorded operations and paints.
+  void clear() {
+    _length = 0;
+    _paints.clear();
+    _paintIndices.clear();
+  }
+
+  void _reserve(int count) {
+    if (_length + count <= _commands.length)
+      return;
+    int capacity = _commands.length * 2;
+    while (capacity < _length + count)
+      capacity *= 2;
+    Float32List commands = new Float32List(capacity);
+    commands.setRange(0, _length, _commands);
+    _commands = commands;
+  }
+
+  void _add0(int op) {
+    _reserve(1);
+    _commands[_length++] = op.toDouble();
+  }
+
+  void _add1(int op, double a) {
+    _reserve(2);
+    _commands[_length++] = op.toDouble();
+    _commands[_length++] = a;
+  }
+
+  void _add2(int op, double a, double b) {
+    _reserve(3);
+    _commands[_length++] = op.toDouble();
+    _commands[_length++] = a;
+    _commands[_length++] = b;
+  }
+
+  void _addRect(Rect rect) {
+    _commands[_length++] = rect.left;
+    _commands[_length++] = rect.top;
+    _commands[_length++] = rect.right;
+    _commands[_length++] = rect.bottom;
+  }
+
+  void _addRectOp(int op, Rect rect, Paint paint) {
+    _reserve(6);
+    _commands[_length++] = op.toDouble();
+    _addPaint(paint);
+    _addRect(rect);
+  }
+
+  void _addPaint(Paint paint) {
+    int index = _paintIndices.putIfAbsent(paint, () {
+      _paints.add(paint);
+      return _paints.length - 1;
+    });
+    _commands[_length++] = index.toDouble();
+  }
+}
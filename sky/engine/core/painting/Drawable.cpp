@@ -4,17 +4,73 @@
 
 #include "sky/engine/core/painting/Drawable.h"
 #include "sky/engine/core/painting/Picture.h"
+#include "base/bind.h"
+#include "base/location.h"
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/wtf/MainThread.h"
+#include "third_party/skia/include/core/SkCanvas.h"
 
 namespace blink {
+namespace {
 
-PassRefPtr<Drawable> Drawable::create(PassRefPtr<SkDrawable> skDrawable)
+// Draws a picture that can be replaced after the drawable has been recorded
+// into other pictures.
+class RetainedDrawable : public SkDrawable {
+public:
+    void setPicture(PassRefPtr<SkPicture> picture)
+    {
+        m_picture = picture;
+        notifyDrawingChanged();
+    }
+
+protected:
+    SkRect onGetBounds() override
+    {
+        return m_picture ? m_picture->cullRect() : SkRect::MakeEmpty();
+    }
+
+    void onDraw(SkCanvas* canvas) override
+    {
+        if (m_picture)
+            canvas->drawPicture(m_picture.get());
+    }
+
+    // The picture is immutable, so it is its own snapshot.
+    SkPicture* onNewPictureSnapshot() override
+    {
+        if (!m_picture)
+            return SkDrawable::onNewPictureSnapshot();
+        return SkRef(m_picture.get());
+    }
+
+private:
+    RefPtr<SkPicture> m_picture;
+};
+
+void releaseDrawable(SkDrawable* drawable)
+{
+    drawable->unref();
+}
+
+} // namespace
+
+PassRefPtr<Drawable> Drawable::create()
+{
+    return adoptRef(new Drawable(adoptRef(new RetainedDrawable()), true, nullptr));
+}
+
+PassRefPtr<Drawable> Drawable::create(PassRefPtr<SkDrawable> skDrawable,
+    scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner)
 {
     ASSERT(skDrawable);
-    return adoptRef(new Drawable(skDrawable));
+    return adoptRef(new Drawable(skDrawable, false, imageTaskRunner));
 }
 
-Drawable::Drawable(PassRefPtr<SkDrawable> skDrawable)
+Drawable::Drawable(PassRefPtr<SkDrawable> skDrawable, bool isRetained,
+    scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner)
     : m_drawable(skDrawable)
+    , m_isRetained(isRetained)
+    , m_imageTaskRunner(imageTaskRunner)
 {
 }
 
@@ -23,11 +79,34 @@ PassRefPtr<Picture> Drawable::newPictureSnapshot()
     if (!m_drawable)
         return nullptr;
     return Picture::create(
-        adoptRef(m_drawable->newPictureSnapshot()));
+        adoptRef(m_drawable->newPictureSnapshot()), m_imageTaskRunner);
+}
+
+void Drawable::setPicture(Picture* picture, ExceptionState& es)
+{
+    if (!m_isRetained)
+        return es.ThrowTypeError("Only drawables created with the Drawable constructor can be given a picture");
+    static_cast<RetainedDrawable*>(m_drawable.get())->setPicture(picture ? picture->toSkia() : nullptr);
+    if (picture && picture->imageTaskRunner())
+        m_imageTaskRunner = picture->imageTaskRunner();
+}
+
+void* Drawable::operator new(size_t size)
+{
+    ASSERT(isMainThread());
+    return partitionAlloc(Partitions::getWrappablePartition(), size);
+}
+
+void Drawable::operator delete(void* ptr)
+{
+    ASSERT(isMainThread());
+    partitionFree(ptr);
 }
 
 Drawable::~Drawable()
 {
+    if (m_imageTaskRunner)
+        m_imageTaskRunner->PostTask(FROM_HERE, base::Bind(&releaseDrawable, m_drawable.release().leakRef()));
 }
 
 } // namespace blink
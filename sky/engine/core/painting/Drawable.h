@@ -5,6 +5,7 @@
 #ifndef SKY_ENGINE_CORE_PAINTING_DRAWABLE_H_
 #define SKY_ENGINE_CORE_PAINTING_DRAWABLE_H_
 
+#include "sky/engine/bindings/exception_state.h"
 #include "sky/engine/core/painting/Picture.h"
 #include "sky/engine/tonic/dart_wrappable.h"
 #include "sky/engine/wtf/PassRefPtr.h"
@@ -16,15 +17,29 @@ namespace blink {
 class Drawable : public RefCounted<Drawable>, public DartWrappable {
     DEFINE_WRAPPERTYPEINFO();
 public:
-    static PassRefPtr<Drawable> create(PassRefPtr<SkDrawable> skDrawable);
+    // Creates a drawable whose picture is set with setPicture().
+    static PassRefPtr<Drawable> create();
+    static PassRefPtr<Drawable> create(PassRefPtr<SkDrawable> skDrawable,
+        scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner = nullptr);
     ~Drawable() override;
 
+    // Allocated out of the wrappable partition.
+    void* operator new(size_t);
+    void operator delete(void*);
+
     PassRefPtr<Picture> newPictureSnapshot();
+    void setPicture(Picture* picture, ExceptionState& es);
     SkDrawable* toSkia() const { return m_drawable.get(); }
 
+    // See Picture::imageTaskRunner().
+    base::SingleThreadTaskRunner* imageTaskRunner() const { return m_imageTaskRunner.get(); }
+
 private:
-    explicit Drawable(PassRefPtr<SkDrawable> skDrawable);
+    Drawable(PassRefPtr<SkDrawable> skDrawable, bool isRetained,
+        scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner);
     RefPtr<SkDrawable> m_drawable;
+    bool m_isRetained;
+    scoped_refptr<base::SingleThreadTaskRunner> m_imageTaskRunner;
 };
 
 } // namespace blink
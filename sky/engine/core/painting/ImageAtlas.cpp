@@ -0,0 +1,125 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/painting/ImageAtlas.h"
+
+#include "sky/engine/wtf/StdLibExtras.h"
+
+#include <algorithm>
+#include <string.h>
+
+namespace blink {
+namespace {
+
+// Each image is surrounded by a copy of its edge pixels so that bilinear
+// filtering near its edges does not sample its neighbours.
+const int kPadding = 1;
+
+} // namespace
+
+ImageAtlasPage::ImageAtlasPage()
+    : m_usedHeight(0)
+{
+    m_bitmap.allocN32Pixels(kSize, kSize);
+    m_bitmap.eraseColor(SK_ColorTRANSPARENT);
+}
+
+SkIRect ImageAtlasPage::allocate(int width, int height)
+{
+    for (Shelf& shelf : m_shelves) {
+        // Keep shelves from filling up with images much shorter than them.
+        if (height > shelf.height || height < shelf.height / 2)
+            continue;
+        if (shelf.usedWidth + width > kSize)
+            continue;
+        SkIRect rect = SkIRect::MakeXYWH(shelf.usedWidth, shelf.y, width, height);
+        shelf.usedWidth += width;
+        return rect;
+    }
+
+    if (m_usedHeight + height > kSize)
+        return SkIRect::MakeEmpty();
+
+    Shelf shelf = { m_usedHeight, height, width };
+    m_shelves.append(shelf);
+    m_usedHeight += height;
+    return SkIRect::MakeXYWH(0, shelf.y, width, height);
+}
+
+SkIRect ImageAtlasPage::add(const SkBitmap& bitmap)
+{
+    const int width = bitmap.width();
+    const int height = bitmap.height();
+    SkIRect padded = allocate(width + 2 * kPadding, height + 2 * kPadding);
+    if (padded.isEmpty())
+        return padded;
+
+    SkIRect rect = padded;
+    rect.inset(kPadding, kPadding);
+
+    SkAutoLockPixels sourceLock(bitmap);
+    SkAutoLockPixels pageLock(m_bitmap);
+    for (int y = -kPadding; y < height + kPadding; ++y) {
+        const int sourceY = std::min(std::max(y, 0), height - 1);
+        const uint32_t* source = bitmap.getAddr32(0, sourceY);
+        uint32_t* destination = m_bitmap.getAddr32(rect.x(), rect.y() + y);
+        memcpy(destination, source, width * sizeof(uint32_t));
+        for (int x = 1; x <= kPadding; ++x) {
+            destination[-x] = source[0];
+            destination[width - 1 + x] = source[width - 1];
+        }
+    }
+    m_bitmap.notifyPixelsChanged();
+
+    m_image = nullptr;
+    return rect;
+}
+
+SkImage* ImageAtlasPage::image()
+{
+    if (!m_image) {
+        SkAutoLockPixels lock(m_bitmap);
+        m_image = adoptRef(SkImage::NewRasterCopy(m_bitmap.info(), m_bitmap.getPixels(), m_bitmap.rowBytes()));
+    }
+    return m_image.get();
+}
+
+PassRefPtr<SkImage> ImageAtlasPage::newSubsetImage(const SkIRect& rect)
+{
+    SkBitmap subset;
+    if (!m_bitmap.extractSubset(&subset, rect))
+        return nullptr;
+    // The page is still being written to, so the pixels are copied.
+    return adoptRef(SkImage::NewFromBitmap(subset));
+}
+
+ImageAtlas& ImageAtlas::shared()
+{
+    DEFINE_STATIC_LOCAL(ImageAtlas, atlas, ());
+    return atlas;
+}
+
+bool ImageAtlas::add(const SkBitmap& bitmap, RefPtr<ImageAtlasPage>& page, SkIRect& rect)
+{
+    if (bitmap.colorType() != kN32_SkColorType || bitmap.alphaType() != kPremul_SkAlphaType)
+        return false;
+    if (bitmap.width() > kMaxImageSize || bitmap.height() > kMaxImageSize || bitmap.empty())
+        return false;
+
+    if (m_currentPage) {
+        rect = m_currentPage->add(bitmap);
+        if (!rect.isEmpty()) {
+            page = m_currentPage;
+            return true;
+        }
+    }
+
+    m_currentPage = ImageAtlasPage::create();
+    rect = m_currentPage->add(bitmap);
+    ASSERT(!rect.isEmpty());
+    page = m_currentPage;
+    return true;
+}
+
+} // namespace blink
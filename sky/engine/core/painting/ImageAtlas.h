@@ -0,0 +1,82 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_PAINTING_IMAGEATLAS_H_
+#define SKY_ENGINE_CORE_PAINTING_IMAGEATLAS_H_
+
+#include "sky/engine/wtf/Noncopyable.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefCounted.h"
+#include "sky/engine/wtf/RefPtr.h"
+#include "sky/engine/wtf/Vector.h"
+#include "third_party/skia/include/core/SkBitmap.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkRect.h"
+
+namespace blink {
+
+// A shared bitmap that small images are packed into. Every image on a page
+// is drawn from the same SkImage, so the GPU backend uploads the page as a
+// single texture and can batch draws of different images on it.
+class ImageAtlasPage : public RefCounted<ImageAtlasPage> {
+public:
+    static const int kSize = 512;
+
+    static PassRefPtr<ImageAtlasPage> create() { return adoptRef(new ImageAtlasPage()); }
+
+    // Copies |bitmap| onto the page and returns where it was placed, or an
+    // empty rect if there is no room left.
+    SkIRect add(const SkBitmap& bitmap);
+
+    // A snapshot of the page. Adding to the page invalidates the snapshot,
+    // and the next call copies the page again.
+    SkImage* image();
+
+    // A standalone copy of the part of the page at |rect|.
+    PassRefPtr<SkImage> newSubsetImage(const SkIRect& rect);
+
+private:
+    ImageAtlasPage();
+
+    SkIRect allocate(int width, int height);
+
+    // Images are packed left to right into shelves stacked top to bottom.
+    struct Shelf {
+        int y;
+        int height;
+        int usedWidth;
+    };
+
+    SkBitmap m_bitmap;
+    Vector<Shelf> m_shelves;
+    int m_usedHeight;
+    RefPtr<SkImage> m_image;
+};
+
+// Packs decoded images that are small enough into shared atlas pages. Only
+// used on the UI thread.
+class ImageAtlas {
+    WTF_MAKE_NONCOPYABLE(ImageAtlas);
+public:
+    // Larger images gain little from sharing a texture and would fill pages
+    // quickly.
+    static const int kMaxImageSize = 128;
+
+    static ImageAtlas& shared();
+
+    // Copies |bitmap| into an atlas page. Returns false, leaving |page| and
+    // |rect| untouched, if the bitmap is not suitable for the atlas.
+    bool add(const SkBitmap& bitmap, RefPtr<ImageAtlasPage>& page, SkIRect& rect);
+
+private:
+    ImageAtlas() { }
+
+    // The page new images go to. Full pages are dropped and stay alive for
+    // as long as images on them do.
+    RefPtr<ImageAtlasPage> m_currentPage;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_PAINTING_IMAGEATLAS_H_
@@ -0,0 +1,18 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_PAINTING_IMAGEENCODERCALLBACK_H_
+#define SKY_ENGINE_CORE_PAINTING_IMAGEENCODERCALLBACK_H_
+
+namespace blink {
+
+class ImageEncoderCallback {
+public:
+    virtual ~ImageEncoderCallback() {}
+    virtual void handleEvent(bool success) = 0;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_PAINTING_IMAGEENCODERCALLBACK_H_
@@ -11,7 +11,7 @@
 #include "sky/engine/core/painting/Shader.h"
 #include "sky/engine/tonic/dart_wrappable.h"
 #include "sky/engine/core/painting/Matrix.h"
-#include "sky/engine/tonic/float32_list.h"
+#include "sky/engine/tonic/typed_list.h"
 #include "third_party/skia/include/core/SkShader.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 
@@ -6,7 +6,7 @@
 #define SKY_ENGINE_CORE_PAINTING_MATRIX_H_
 
 #include "sky/engine/bindings/exception_state.h"
-#include "sky/engine/tonic/float32_list.h"
+#include "sky/engine/tonic/typed_list.h"
 #include "third_party/skia/include/core/SkMatrix.h"
 
 namespace blink {
@@ -23,6 +23,11 @@ struct DartConverter<Offset> {
   static Offset FromArgumentsWithNullCheck(Dart_NativeArguments args,
                                           int index,
                                           Dart_Handle& exception);
+  // Reads the two doubles the generated Dart code unpacks a Offset into,
+  // starting at |index|.
+  static Offset FromUnboxedArguments(Dart_NativeArguments args,
+                                     int index,
+                                     Dart_Handle& exception);
 };
 
 } // namespace blink
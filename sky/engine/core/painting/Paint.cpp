@@ -40,14 +40,35 @@ enum PaintFields {
   kNumberOfPaintFields,
 };
 
+// The SkPaint most recently built for a Dart Paint object. It is attached
+// to the object as its peer and lives as long as the object does.
+struct PaintPeer {
+  int64_t version;
+  SkPaint paint;
+};
+
+void FinalizePaintPeer(void* isolate_callback_data,
+                       Dart_WeakPersistentHandle handle,
+                       void* peer) {
+  delete static_cast<PaintPeer*>(peer);
 }
 
-Paint DartConverter<Paint>::FromDart(Dart_Handle dart_paint) {
-  Paint result;
-  result.is_null = true;
-  if (Dart_IsNull(dart_paint))
-    return result;
+PaintPeer* GetPaintPeer(Dart_Handle dart_paint) {
+  void* peer = nullptr;
+  CHECK(!LogIfError(Dart_GetPeer(dart_paint, &peer)));
+  if (peer)
+    return static_cast<PaintPeer*>(peer);
+
+  PaintPeer* paint_peer = new PaintPeer();
+  // Dart versions start at zero, so the first lookup always builds.
+  paint_peer->version = -1;
+  CHECK(!LogIfError(Dart_SetPeer(dart_paint, paint_peer)));
+  Dart_NewWeakPersistentHandle(dart_paint, paint_peer, sizeof(PaintPeer),
+                               FinalizePaintPeer);
+  return paint_peer;
+}
 
+void BuildPaint(Dart_Handle dart_paint, SkPaint& paint) {
   Dart_Handle value_handle = DOMDartState::Current()->value_handle();
   Dart_Handle data = Dart_GetField(dart_paint, value_handle);
 
@@ -61,7 +82,7 @@ Paint DartConverter<Paint>::FromDart(Dart_Handle dart_paint) {
   for (int i = 0; i < kNumberOfPaintFields; ++i)
     values[i] = Dart_ListGetAt(data, i);
 
-  SkPaint& paint = result.sk_paint;
+  paint.reset();
   if (!Dart_IsNull(values[kStrokeWidth]))
     paint.setStrokeWidth(DartConverter<SkScalar>::FromDart(values[kStrokeWidth]));
   if (!Dart_IsNull(values[kIsAntiAlias]))
@@ -82,7 +103,30 @@ Paint DartConverter<Paint>::FromDart(Dart_Handle dart_paint) {
     paint.setStyle(DartConverter<PaintingStyle>::FromDart(values[kStyle]));
   if (!Dart_IsNull(values[kTransferMode]))
     paint.setXfermodeMode(DartConverter<TransferMode>::FromDart(values[kTransferMode]));
+}
+
+}  // namespace
+
+Paint DartConverter<Paint>::FromDart(Dart_Handle dart_paint) {
+  Paint result;
+  result.is_null = true;
+  if (Dart_IsNull(dart_paint))
+    return result;
+
+  // Rebuilding the SkPaint takes a dozen lookups into the Dart object, so
+  // paints that did not change since they were last used are reused as is.
+  int64_t version = 0;
+  Dart_Handle version_handle = DOMDartState::Current()->version_handle();
+  CHECK(!LogIfError(Dart_IntegerToInt64(
+      Dart_GetField(dart_paint, version_handle), &version)));
+
+  PaintPeer* peer = GetPaintPeer(dart_paint);
+  if (peer->version != version) {
+    BuildPaint(dart_paint, peer->paint);
+    peer->version = version;
+  }
 
+  result.sk_paint = peer->paint;
   result.is_null = false;
   return result;
 }
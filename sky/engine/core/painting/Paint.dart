@@ -33,16 +33,79 @@ class Paint {
     this.transferMode = transferMode;
   }
 
-  double strokeWidth;
-  bool isAntiAlias = true;
-  Color color = const Color(0xFF000000);
-  ColorFilter colorFilter;
-  DrawLooper drawLooper;
-  FilterQuality filterQuality;
-  MaskFilter maskFilter;
-  Shader shader;
-  PaintingStyle style;
-  TransferMode transferMode;
+  double _strokeWidth;
+  double get strokeWidth => _strokeWidth;
+  void set strokeWidth(double value) {
+    _strokeWidth = value;
+    _version++;
+  }
+
+  bool _isAntiAlias = true;
+  bool get isAntiAlias => _isAntiAlias;
+  void set isAntiAlias(bool value) {
+    _isAntiAlias = value;
+    _version++;
+  }
+
+  Color _color = const Color(0xFF000000);
+  Color get color => _color;
+  void set color(Color value) {
+    _color = value;
+    _version++;
+  }
+
+  ColorFilter _colorFilter;
+  ColorFilter get colorFilter => _colorFilter;
+  void set colorFilter(ColorFilter value) {
+    _colorFilter = value;
+    _version++;
+  }
+
+  DrawLooper _drawLooper;
+  DrawLooper get drawLooper => _drawLooper;
+  void set drawLooper(DrawLooper value) {
+    _drawLooper = value;
+    _version++;
+  }
+
+  FilterQuality _filterQuality;
+  FilterQuality get filterQuality => _filterQuality;
+  void set filterQuality(FilterQuality value) {
+    _filterQuality = value;
+    _version++;
+  }
+
+  MaskFilter _maskFilter;
+  MaskFilter get maskFilter => _maskFilter;
+  void set maskFilter(MaskFilter value) {
+    _maskFilter = value;
+    _version++;
+  }
+
+  Shader _shader;
+  Shader get shader => _shader;
+  void set shader(Shader value) {
+    _shader = value;
+    _version++;
+  }
+
+  PaintingStyle _style;
+  PaintingStyle get style => _style;
+  void set style(PaintingStyle value) {
+    _style = value;
+    _version++;
+  }
+
+  TransferMode _transferMode;
+  TransferMode get transferMode => _transferMode;
+  void set transferMode(TransferMode value) {
+    _transferMode = value;
+    _version++;
+  }
+
+  // Bumped whenever a field changes. The engine keeps the native paint it
+  // last built for this object and only rebuilds it when the version moves.
+  int _version = 0;
 
   // Must match PaintFields enum in Paint.cpp.
   List<dynamic> get _value {
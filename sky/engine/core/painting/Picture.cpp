@@ -4,23 +4,156 @@
 
 #include "sky/engine/core/painting/Picture.h"
 
+#include "base/bind.h"
+#include "base/location.h"
+#include "skia/ext/analysis_canvas.h"
 #include "sky/engine/core/painting/Canvas.h"
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/wtf/HashSet.h"
+#include "sky/engine/wtf/MainThread.h"
+#include "third_party/skia/include/core/SkImage.h"
 
 namespace blink {
+namespace {
+
+// Extends the solid color analysis with what the picture draws. Images are
+// not tracked by AnalysisCanvas, so drawing one conservatively marks the
+// whole picture as neither solid nor transparent.
+class PictureAnalysisCanvas : public skia::AnalysisCanvas {
+public:
+    PictureAnalysisCanvas(int width, int height)
+        : skia::AnalysisCanvas(width, height)
+        , m_hasPaths(false)
+        , m_imageBytes(0)
+    {
+    }
+
+    bool hasPaths() const { return m_hasPaths; }
+    long long imageBytes() const { return m_imageBytes; }
+
+protected:
+    void onDrawPath(const SkPath& path, const SkPaint& paint) override
+    {
+        m_hasPaths = true;
+        skia::AnalysisCanvas::onDrawPath(path, paint);
+    }
+
+    void onDrawBitmap(const SkBitmap& bitmap, SkScalar left, SkScalar top, const SkPaint* paint) override
+    {
+        didDrawBitmap(bitmap);
+        skia::AnalysisCanvas::onDrawBitmap(bitmap, left, top, paint);
+    }
+
+    void onDrawBitmapRect(const SkBitmap& bitmap, const SkRect* src, const SkRect& dst, const SkPaint* paint, SrcRectConstraint constraint) override
+    {
+        didDrawBitmap(bitmap);
+        skia::AnalysisCanvas::onDrawBitmapRect(bitmap, src, dst, paint, constraint);
+    }
+
+    void onDrawBitmapNine(const SkBitmap& bitmap, const SkIRect& center, const SkRect& dst, const SkPaint* paint) override
+    {
+        didDrawBitmap(bitmap);
+        skia::AnalysisCanvas::onDrawBitmapNine(bitmap, center, dst, paint);
+    }
+
+    void onDrawImage(const SkImage* image, SkScalar, SkScalar, const SkPaint*) override
+    {
+        didDrawImage(image);
+    }
+
+    void onDrawImageRect(const SkImage* image, const SkRect*, const SkRect&, const SkPaint*, SrcRectConstraint) override
+    {
+        didDrawImage(image);
+    }
+
+    void onDrawImageNine(const SkImage* image, const SkIRect&, const SkRect&, const SkPaint*) override
+    {
+        didDrawImage(image);
+    }
+
+    void onDrawAtlas(const SkImage* atlas, const SkRSXform[], const SkRect[], const SkColor[], int, SkXfermode::Mode, const SkRect*, const SkPaint*) override
+    {
+        didDrawImage(atlas);
+    }
+
+private:
+    void didDrawBitmap(const SkBitmap& bitmap)
+    {
+        addImage(bitmap.getGenerationID(), bitmap.getSize());
+    }
+
+    void didDrawImage(const SkImage* image)
+    {
+        SetForceNotSolid(true);
+        SetForceNotTransparent(true);
+        // Images are decoded to 32-bit pixels.
+        addImage(image->uniqueID(), static_cast<long long>(image->width()) * image->height() * 4);
+    }
+
+    void addImage(uint32_t id, long long bytes)
+    {
+        if (m_imageIds.add(id).isNewEntry)
+            m_imageBytes += bytes;
+    }
+
+    bool m_hasPaths;
+    long long m_imageBytes;
+    HashSet<uint32_t, WTF::IntHash<uint32_t>, WTF::UnsignedWithZeroKeyHashTraits<uint32_t>> m_imageIds;
+};
+
+void releasePicture(SkPicture* picture)
+{
+    picture->unref();
+}
+
+} // namespace
 
 PassRefPtr<Picture> Picture::create(PassRefPtr<SkPicture> skPicture)
+{
+    return create(skPicture, nullptr);
+}
+
+PassRefPtr<Picture> Picture::create(PassRefPtr<SkPicture> skPicture,
+    scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner)
 {
     ASSERT(skPicture);
-    return adoptRef(new Picture(skPicture));
+    return adoptRef(new Picture(skPicture, imageTaskRunner));
 }
 
-Picture::Picture(PassRefPtr<SkPicture> skPicture)
+Picture::Picture(PassRefPtr<SkPicture> skPicture, scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner)
     : m_picture(skPicture)
+    , m_imageTaskRunner(imageTaskRunner)
+    , m_analyzed(false)
+    , m_isSolidColor(false)
+    , m_solidColor(SK_ColorTRANSPARENT)
+    , m_hasPaths(false)
+    , m_imageBytes(0)
+{
+}
+
+void* Picture::operator new(size_t size)
 {
+    ASSERT(isMainThread());
+    return partitionAlloc(Partitions::getWrappablePartition(), size);
+}
+
+void Picture::operator delete(void* ptr)
+{
+    ASSERT(isMainThread());
+    partitionFree(ptr);
 }
 
 Picture::~Picture()
 {
+    if (m_imageTaskRunner)
+        m_imageTaskRunner->PostTask(FROM_HERE, base::Bind(&releasePicture, m_picture.release().leakRef()));
+}
+
+size_t Picture::GetAllocationSize()
+{
+    // Images the picture draws are owned, and reported, by their own
+    // wrappers, so only the recording itself is counted here.
+    return sizeof(Picture) + m_picture->approximateBytesUsed();
 }
 
 void Picture::playback(Canvas* canvas)
@@ -28,4 +161,57 @@ void Picture::playback(Canvas* canvas)
     m_picture->playback(canvas->skCanvas());
 }
 
+bool Picture::isSolidColor()
+{
+    ensureAnalyzed();
+    return m_isSolidColor;
+}
+
+bool Picture::isTransparent()
+{
+    ensureAnalyzed();
+    return m_isSolidColor && m_solidColor == SK_ColorTRANSPARENT;
+}
+
+bool Picture::hasPaths()
+{
+    ensureAnalyzed();
+    return m_hasPaths;
+}
+
+long long Picture::imageBytes()
+{
+    ensureAnalyzed();
+    return m_imageBytes;
+}
+
+SkColor Picture::solidColor()
+{
+    ensureAnalyzed();
+    return m_solidColor;
+}
+
+void Picture::ensureAnalyzed()
+{
+    if (m_analyzed)
+        return;
+    m_analyzed = true;
+
+    const SkIRect bounds = m_picture->cullRect().roundOut();
+    if (bounds.isEmpty()) {
+        m_isSolidColor = true;
+        return;
+    }
+
+    PictureAnalysisCanvas canvas(bounds.width(), bounds.height());
+    canvas.translate(-bounds.x(), -bounds.y());
+    m_picture->playback(&canvas);
+
+    m_isSolidColor = canvas.GetColorIfSolid(&m_solidColor);
+    if (!m_isSolidColor)
+        m_solidColor = SK_ColorTRANSPARENT;
+    m_hasPaths = canvas.hasPaths();
+    m_imageBytes = canvas.imageBytes();
+}
+
 } // namespace blink
@@ -5,6 +5,8 @@
 #ifndef SKY_ENGINE_CORE_PAINTING_PICTURE_H_
 #define SKY_ENGINE_CORE_PAINTING_PICTURE_H_
 
+#include "base/memory/ref_counted.h"
+#include "base/single_thread_task_runner.h"
 #include "sky/engine/tonic/dart_wrappable.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefCounted.h"
@@ -18,16 +20,48 @@ class Picture : public RefCounted<Picture>, public DartWrappable {
     DEFINE_WRAPPERTYPEINFO();
 public:
     ~Picture() override;
+
+    // Allocated out of the wrappable partition.
+    void* operator new(size_t);
+    void operator delete(void*);
     static PassRefPtr<Picture> create(PassRefPtr<SkPicture> skPicture);
+    // For pictures that draw GPU backed images, which have to be released
+    // on |imageTaskRunner|.
+    static PassRefPtr<Picture> create(PassRefPtr<SkPicture> skPicture,
+        scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner);
 
     SkPicture* toSkia() const { return m_picture.get(); }
 
+    // DartWrappable:
+    size_t GetAllocationSize() override;
+
     void playback(Canvas* canvas);
 
+    base::SingleThreadTaskRunner* imageTaskRunner() const { return m_imageTaskRunner.get(); }
+
+    int approximateOpCount() const { return m_picture->approximateOpCount(); }
+    bool isSolidColor();
+    bool isTransparent();
+    bool hasText() const { return m_picture->hasText(); }
+    bool hasPaths();
+    long long imageBytes();
+
+    // The color of a picture that isSolidColor(), or SK_ColorTRANSPARENT.
+    SkColor solidColor();
+
 private:
-    explicit Picture(PassRefPtr<SkPicture> skPicture);
+    Picture(PassRefPtr<SkPicture> skPicture, scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner);
+
+    void ensureAnalyzed();
 
     RefPtr<SkPicture> m_picture;
+    scoped_refptr<base::SingleThreadTaskRunner> m_imageTaskRunner;
+
+    bool m_analyzed;
+    bool m_isSolidColor;
+    SkColor m_solidColor;
+    bool m_hasPaths;
+    long long m_imageBytes;
 };
 
 } // namespace blink
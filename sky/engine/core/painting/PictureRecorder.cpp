@@ -10,6 +10,7 @@
 namespace blink {
 
 PictureRecorder::PictureRecorder()
+    : m_usesBoundingBoxHierarchy(true)
 {
 }
 
@@ -23,8 +24,11 @@ bool PictureRecorder::isRecording() {
 
 SkCanvas* PictureRecorder::beginRecording(Rect bounds)
 {
+    // The R-tree lets SkPicture::playback, and drawPicture into a clipped
+    // canvas, visit only the ops that intersect the clip.
+    SkBBHFactory* factory = m_usesBoundingBoxHierarchy ? &m_rtreeFactory : nullptr;
     return m_pictureRecorder.beginRecording(bounds.sk_rect,
-        &m_rtreeFactory, SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag);
+        factory, SkPictureRecorder::kComputeSaveLayerInfo_RecordFlag);
 }
 
 PassRefPtr<Picture> PictureRecorder::endRecording()
@@ -32,7 +36,7 @@ PassRefPtr<Picture> PictureRecorder::endRecording()
     if (!isRecording())
         return nullptr;
     RefPtr<Picture> picture = Picture::create(
-        adoptRef(m_pictureRecorder.endRecording()));
+        adoptRef(m_pictureRecorder.endRecording()), m_canvas->imageTaskRunner());
     m_canvas->clearSkCanvas();
     m_canvas = nullptr;
     return picture.release();
@@ -43,7 +47,7 @@ PassRefPtr<Drawable> PictureRecorder::endRecordingAsDrawable()
     if (!isRecording())
         return nullptr;
     RefPtr<Drawable> drawable = Drawable::create(
-        adoptRef(m_pictureRecorder.endRecordingAsDrawable()));
+        adoptRef(m_pictureRecorder.endRecordingAsDrawable()), m_canvas->imageTaskRunner());
     m_canvas->clearSkCanvas();
     m_canvas = nullptr;
     return drawable.release();
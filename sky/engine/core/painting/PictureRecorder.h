@@ -34,11 +34,15 @@ public:
     PassRefPtr<Drawable> endRecordingAsDrawable();
     bool isRecording();
 
+    bool usesBoundingBoxHierarchy() const { return m_usesBoundingBoxHierarchy; }
+    void setUsesBoundingBoxHierarchy(bool value) { m_usesBoundingBoxHierarchy = value; }
+
     void set_canvas(PassRefPtr<Canvas> canvas);
 
 private:
     PictureRecorder();
 
+    bool m_usesBoundingBoxHierarchy;
     SkRTreeFactory m_rtreeFactory;
     SkPictureRecorder m_pictureRecorder;
     RefPtr<Canvas> m_canvas;
@@ -36,4 +36,18 @@ Point DartConverter<Point>::FromArgumentsWithNullCheck(
   return FromDart(Dart_GetNativeArgument(args, index));
 }
 
+Point DartConverter<Point>::FromUnboxedArguments(
+    Dart_NativeArguments args,
+    int index,
+    Dart_Handle& exception) {
+  double x = 0.0, y = 0.0;
+  Dart_GetNativeDoubleArgument(args, index, &x);
+  Dart_GetNativeDoubleArgument(args, index + 1, &y);
+
+  Point result;
+  result.sk_point.set(x, y);
+  result.is_null = false;
+  return result;
+}
+
 } // namespace blink
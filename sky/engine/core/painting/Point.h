@@ -23,6 +23,11 @@ struct DartConverter<Point> {
   static Point FromArgumentsWithNullCheck(Dart_NativeArguments args,
                                           int index,
                                           Dart_Handle& exception);
+  // Reads the two doubles the generated Dart code unpacks a Point into,
+  // starting at |index|.
+  static Point FromUnboxedArguments(Dart_NativeArguments args,
+                                    int index,
+                                    Dart_Handle& exception);
 };
 
 } // namespace blink
@@ -4,12 +4,27 @@
 
 #include "sky/engine/core/painting/RRect.h"
 
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/wtf/MainThread.h"
+
 namespace blink {
 
 RRect::RRect()
 {
 }
 
+void* RRect::operator new(size_t size)
+{
+    ASSERT(isMainThread());
+    return partitionAlloc(Partitions::getWrappablePartition(), size);
+}
+
+void RRect::operator delete(void* ptr)
+{
+    ASSERT(isMainThread());
+    partitionFree(ptr);
+}
+
 RRect::~RRect()
 {
 }
@@ -18,6 +18,10 @@ class RRect : public RefCounted<RRect>, public DartWrappable {
     DEFINE_WRAPPERTYPEINFO();
 public:
     ~RRect() override;
+
+    // Allocated out of the wrappable partition.
+    void* operator new(size_t);
+    void operator delete(void*);
     static PassRefPtr<RRect> create()
     {
         return adoptRef(new RRect);
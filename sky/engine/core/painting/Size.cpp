@@ -36,4 +36,18 @@ Size DartConverter<Size>::FromArgumentsWithNullCheck(
   return FromDart(Dart_GetNativeArgument(args, index));
 }
 
+Size DartConverter<Size>::FromUnboxedArguments(
+    Dart_NativeArguments args,
+    int index,
+    Dart_Handle& exception) {
+  double dx = 0.0, dy = 0.0;
+  Dart_GetNativeDoubleArgument(args, index, &dx);
+  Dart_GetNativeDoubleArgument(args, index + 1, &dy);
+
+  Size result;
+  result.sk_size.set(dx, dy);
+  result.is_null = false;
+  return result;
+}
+
 } // namespace blink
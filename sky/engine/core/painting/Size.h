@@ -23,6 +23,11 @@ struct DartConverter<Size> {
   static Size FromArgumentsWithNullCheck(Dart_NativeArguments args,
                                           int index,
                                           Dart_Handle& exception);
+  // Reads the two doubles the generated Dart code unpacks a Size into,
+  // starting at |index|.
+  static Size FromUnboxedArguments(Dart_NativeArguments args,
+                                   int index,
+                                   Dart_Handle& exception);
 };
 
 } // namespace blink
@@ -35,7 +35,6 @@
 #include "sky/engine/platform/FloatConversion.h"
 #include "sky/engine/platform/LengthFunctions.h"
 #include "sky/engine/platform/graphics/ColorSpace.h"
-#include "sky/engine/platform/graphics/UnacceleratedImageBufferSurface.h"
 #include "sky/engine/platform/graphics/filters/FEColorMatrix.h"
 #include "sky/engine/platform/graphics/filters/FEComponentTransfer.h"
 #include "sky/engine/platform/graphics/filters/FEDropShadow.h"
@@ -62,7 +61,6 @@ static inline void lastMatrixRow(Vector<float>& parameters)
 
 FilterEffectRenderer::FilterEffectRenderer()
     : Filter(AffineTransform())
-    , m_graphicsBufferAttached(false)
     , m_hasFilterThatMovesPixels(false)
 {
     m_sourceGraphic = SourceGraphic::create(this);
@@ -72,11 +70,6 @@ FilterEffectRenderer::~FilterEffectRenderer()
 {
 }
 
-GraphicsContext* FilterEffectRenderer::inputContext()
-{
-    return sourceImage() ? sourceImage()->context() : 0;
-}
-
 bool FilterEffectRenderer::build(RenderObject* renderer, const FilterOperations& operations)
 {
     m_hasFilterThatMovesPixels = operations.hasFilterThatMovesPixels();
@@ -247,34 +240,6 @@ void FilterEffectRenderer::updateBackingStoreRect(const FloatRect& floatFilterRe
     }
 }
 
-void FilterEffectRenderer::allocateBackingStoreIfNeeded()
-{
-    // At this point the effect chain has been built, and the
-    // source image sizes set. We just need to attach the graphic
-    // buffer if we have not yet done so.
-    if (!m_graphicsBufferAttached) {
-        IntSize logicalSize(m_sourceDrawingRegion.width(), m_sourceDrawingRegion.height());
-        if (!sourceImage() || sourceImage()->size() != logicalSize) {
-            OwnPtr<ImageBufferSurface> surface = adoptPtr(new UnacceleratedImageBufferSurface(logicalSize));
-            setSourceImage(ImageBuffer::create(surface.release()));
-        }
-        m_graphicsBufferAttached = true;
-    }
-}
-
-void FilterEffectRenderer::clearIntermediateResults()
-{
-    if (m_lastEffect.get())
-        m_lastEffect->clearResultsRecursive();
-}
-
-void FilterEffectRenderer::apply()
-{
-    RefPtr<FilterEffect> effect = lastEffect();
-    effect->apply();
-    effect->transformResultColorSpace(ColorSpaceDeviceRGB);
-}
-
 LayoutRect FilterEffectRenderer::computeSourceImageRectForDirtyRect(const LayoutRect& filterBoxRect, const LayoutRect& dirtyRect)
 {
     // The result of this function is the area in the "filterBoxRect" that needs paint invalidation, so that we fully cover the "dirtyRect".
@@ -78,23 +78,14 @@ public:
         return adoptPtr(new FilterEffectRenderer());
     }
 
-    void setSourceImageRect(const IntRect& sourceImageRect)
-    {
-        m_sourceDrawingRegion = sourceImageRect;
-        m_graphicsBufferAttached = false;
-    }
+    void setSourceImageRect(const IntRect& sourceImageRect) { m_sourceDrawingRegion = sourceImageRect; }
     virtual IntRect sourceImageRect() const override { return m_sourceDrawingRegion; }
 
-    GraphicsContext* inputContext();
-    ImageBuffer* output() const { return lastEffect()->asImageBuffer(); }
-
+    // The effects are always lowered to a single SkImageFilter by
+    // FilterEffectRendererHelper, so they run wherever the canvas they are
+    // drawn into does and never go through a software ImageBuffer.
     bool build(RenderObject* renderer, const FilterOperations&);
     void updateBackingStoreRect(const FloatRect& filterRect);
-    void allocateBackingStoreIfNeeded();
-    void clearIntermediateResults();
-    void apply();
-
-    IntRect outputRect() const { return lastEffect()->hasResult() ? lastEffect()->absolutePaintRect() : IntRect(); }
 
     bool hasFilterThatMovesPixels() const { return m_hasFilterThatMovesPixels; }
     LayoutRect computeSourceImageRectForDirtyRect(const LayoutRect& filterBoxRect, const LayoutRect& dirtyRect);
@@ -112,7 +103,6 @@ private:
     RefPtr<SourceGraphic> m_sourceGraphic;
     RefPtr<FilterEffect> m_lastEffect;
 
-    bool m_graphicsBufferAttached;
     bool m_hasFilterThatMovesPixels;
 };
 
@@ -64,7 +64,7 @@ void InlineBox::remove(MarkLineBoxes markLineBoxes)
 
 void* InlineBox::operator new(size_t sz)
 {
-    return partitionAlloc(Partitions::getRenderingPartition(), sz);
+    return partitionAlloc(Partitions::getLineLayoutPartition(), sz);
 }
 
 void InlineBox::operator delete(void* ptr)
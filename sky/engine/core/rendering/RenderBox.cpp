@@ -44,6 +44,7 @@
 #include "sky/engine/core/rendering/RenderLayer.h"
 #include "sky/engine/core/rendering/RenderView.h"
 #include "sky/engine/platform/LengthFunctions.h"
+#include "sky/engine/platform/TraceEvent.h"
 #include "sky/engine/platform/geometry/FloatQuad.h"
 #include "sky/engine/platform/geometry/TransformState.h"
 #include "sky/engine/platform/graphics/GraphicsContextStateSaver.h"
@@ -575,6 +576,43 @@ static inline bool forwardCompareZIndex(RenderBox* first, RenderBox* second)
     return first->style()->zIndex() < second->style()->zIndex();
 }
 
+void RenderBox::collectLayersInHitTestOrder(Vector<RenderBox*>& layers)
+{
+    collectSelfPaintingLayers(layers);
+    // Hit testing needs to walk in the backwards direction from paint.
+    // Forward compare and then reverse instead of just reverse comparing
+    // so that elements with the same z-index are walked in reverse tree order.
+    std::stable_sort(layers.begin(), layers.end(), forwardCompareZIndex);
+    layers.reverse();
+}
+
+static LayoutRect transparencyClipBox(const RenderLayer*, const RenderLayer* rootLayer, const LayoutSize& subPixelAccumulation);
+
+const RenderLayerHitTestIndex& RenderBox::ensureHitTestIndex()
+{
+    unsigned version = view()->geometryVersion();
+    if (RenderLayerHitTestIndex* index = layer()->hitTestIndex()) {
+        if (index->version() == version)
+            return *index;
+    }
+
+    TRACE_EVENT0("blink", "RenderBox::ensureHitTestIndex");
+    OwnPtr<RenderLayerHitTestIndex> index = adoptPtr(new RenderLayerHitTestIndex(version));
+    Vector<RenderBox*> layers;
+    collectLayersInHitTestOrder(layers);
+    for (RenderBox* box : layers) {
+        // The box painting uses for a transparency layer covers the layer and
+        // all of its descendants, transformed or not, and ignores clips.
+        LayoutRect bounds = transparencyClipBox(box->layer(), layer(), LayoutSize());
+        // Absorbs the snapping of hit test locations to whole pixels.
+        bounds.inflate(1);
+        index->add(box, bounds);
+    }
+    index->finishBuilding();
+    layer()->setHitTestIndex(index.release());
+    return *layer()->hitTestIndex();
+}
+
 // hitTestLocation and hitTestRect are relative to rootLayer.
 // A 'flattening' layer is one preserves3D() == false.
 // transformState.m_accumulatedTransform holds the transform from the containing flattening layer.
@@ -662,12 +700,18 @@ bool RenderBox::hitTestLayer(RenderLayer* rootLayer, RenderLayer* containerLayer
     }
 
     Vector<RenderBox*> layers;
-    collectSelfPaintingLayers(layers);
-    // Hit testing needs to walk in the backwards direction from paint.
-    // Forward compare and then reverse instead of just reverse comparing
-    // so that elements with the same z-index are walked in reverse tree order.
-    std::stable_sort(layers.begin(), layers.end(), forwardCompareZIndex);
-    layers.reverse();
+    if (style()->preserves3D() || layer()->has3DTransformedDescendant()) {
+        // Layers that depth-sort can be hit outside of their flattened bounds.
+        collectLayersInHitTestOrder(layers);
+    } else {
+        // Only consider the layers whose bounds contain the hit test area,
+        // rather than walking the whole subtree to find every layer.
+        LayoutPoint offsetFromRoot;
+        layer()->convertToLayerCoords(rootLayer, offsetFromRoot);
+        LayoutRect hitTestArea(localHitTestLocation.boundingBox());
+        hitTestArea.moveBy(-offsetFromRoot);
+        ensureHitTestIndex().collectCandidates(hitTestArea, layers);
+    }
 
     bool hitLayer = false;
     for (auto& currentLayer : layers) {
@@ -803,8 +847,6 @@ void RenderBox::paintLayer(GraphicsContext* context, const LayerPaintingInfo& pa
     layer()->parent()->restoreClip(context, paintingInfo.paintDirtyRect, clipRect);
 }
 
-static LayoutRect transparencyClipBox(const RenderLayer*, const RenderLayer* rootLayer, const LayoutSize& subPixelAccumulation);
-
 static void expandClipRectForDescendantsAndReflection(LayoutRect& clipRect, const RenderLayer* layer, const RenderLayer* rootLayer,
     const LayoutSize& subPixelAccumulation)
 {
@@ -1291,7 +1333,7 @@ void RenderBox::computeLogicalWidth(LogicalExtentComputedValues& computedValues)
     }
 
     // If layout is limited to a subtree, the subtree root's logical width does not change.
-    if (node() && view()->frameView() && view()->frameView()->layoutRoot(true) == this)
+    if (node() && view()->frameView() && view()->frameView()->isLayoutSubtreeRoot(this, true))
         return;
 
     if (hasOverrideWidth()) {
@@ -32,6 +32,7 @@ namespace blink {
 struct LayerPaintingInfo;
 struct PaintInfo;
 class HitTestingTransformState;
+class RenderLayerHitTestIndex;
 class TransformationMatrix;
 
 enum SizeType { MainOrPreferredSize, MinSize, MaxSize };
@@ -520,6 +521,8 @@ private:
         const HitTestingTransformState* containerTransformState) const;
     bool hitTestNonLayerDescendants(const HitTestRequest& request, HitTestResult& result,
         const LayoutRect& layerBounds, const HitTestLocation& hitTestLocation);
+    void collectLayersInHitTestOrder(Vector<RenderBox*>& layers);
+    const RenderLayerHitTestIndex& ensureHitTestIndex();
 
     void paintLayerContents(GraphicsContext*, const LayerPaintingInfo&);
 
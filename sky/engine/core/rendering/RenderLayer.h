@@ -48,6 +48,7 @@
 #include "sky/engine/core/rendering/LayerPaintingInfo.h"
 #include "sky/engine/core/rendering/RenderBox.h"
 #include "sky/engine/core/rendering/RenderLayerClipper.h"
+#include "sky/engine/core/rendering/RenderLayerHitTestIndex.h"
 #include "sky/engine/core/rendering/RenderLayerStackingNode.h"
 #include "sky/engine/core/rendering/RenderLayerStackingNodeIterator.h"
 #include "sky/engine/public/platform/WebBlendMode.h"
@@ -127,6 +128,10 @@ public:
     // Only safe to call from RenderBox::destroyLayer()
     void operator delete(void*);
 
+    // Only valid if its version matches the RenderView's, see RenderBox::hitTestLayer.
+    RenderLayerHitTestIndex* hitTestIndex() const { return m_hitTestIndex.get(); }
+    void setHitTestIndex(PassOwnPtr<RenderLayerHitTestIndex> index) { m_hitTestIndex = index; }
+
     RenderLayerClipper& clipper() { return m_clipper; }
     const RenderLayerClipper& clipper() const { return m_clipper; }
 
@@ -176,6 +181,7 @@ private:
 
     RenderLayerClipper m_clipper; // FIXME: Lazily allocate?
     OwnPtr<RenderLayerStackingNode> m_stackingNode;
+    OwnPtr<RenderLayerHitTestIndex> m_hitTestIndex;
 };
 
 } // namespace blink
@@ -0,0 +1,96 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/rendering/RenderLayerHitTestIndex.h"
+
+#include <algorithm>
+
+namespace blink {
+
+// Below this many layers, checking every one of them is as fast as finding
+// the right cell.
+static const size_t minimumEntriesForGrid = 16;
+
+// Bounds the memory used by layers that span many cells.
+static const int maximumGridDimension = 32;
+static const int minimumCellSize = 256;
+
+RenderLayerHitTestIndex::RenderLayerHitTestIndex(unsigned version)
+    : m_version(version)
+    , m_cellSize(0)
+    , m_columns(0)
+{
+}
+
+void RenderLayerHitTestIndex::add(RenderBox* box, const LayoutRect& bounds)
+{
+    ASSERT(m_cells.isEmpty());
+    Entry entry;
+    entry.box = box;
+    entry.bounds = bounds;
+    m_entries.append(entry);
+}
+
+void RenderLayerHitTestIndex::finishBuilding()
+{
+    if (m_entries.size() < minimumEntriesForGrid)
+        return;
+
+    for (const Entry& entry : m_entries)
+        m_gridBounds.unite(enclosingIntRect(entry.bounds));
+    if (m_gridBounds.isEmpty())
+        return;
+
+    int extent = std::max(m_gridBounds.width(), m_gridBounds.height());
+    m_cellSize = std::max(minimumCellSize, (extent + maximumGridDimension - 1) / maximumGridDimension);
+    m_columns = (m_gridBounds.width() + m_cellSize - 1) / m_cellSize;
+    int rows = (m_gridBounds.height() + m_cellSize - 1) / m_cellSize;
+    m_cells.resize(m_columns * rows);
+
+    for (unsigned i = 0; i < m_entries.size(); ++i) {
+        IntRect rect = enclosingIntRect(m_entries[i].bounds);
+        if (rect.isEmpty())
+            continue;
+        int firstColumn = (rect.x() - m_gridBounds.x()) / m_cellSize;
+        int lastColumn = (rect.maxX() - 1 - m_gridBounds.x()) / m_cellSize;
+        int firstRow = (rect.y() - m_gridBounds.y()) / m_cellSize;
+        int lastRow = (rect.maxY() - 1 - m_gridBounds.y()) / m_cellSize;
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = firstColumn; column <= lastColumn; ++column)
+                m_cells[row * m_columns + column].append(i);
+        }
+    }
+}
+
+void RenderLayerHitTestIndex::collectCandidates(const LayoutRect& rect, Vector<RenderBox*>& candidates) const
+{
+    if (!m_cells.isEmpty()) {
+        IntRect area = enclosingIntRect(rect);
+        area.intersect(m_gridBounds);
+        if (area.isEmpty())
+            return;
+
+        int column = (area.x() - m_gridBounds.x()) / m_cellSize;
+        int row = (area.y() - m_gridBounds.y()) / m_cellSize;
+        bool singleCell = column == (area.maxX() - 1 - m_gridBounds.x()) / m_cellSize
+            && row == (area.maxY() - 1 - m_gridBounds.y()) / m_cellSize;
+        // Cells list their entries in order, so only areas that span several
+        // cells, which are rect-based hit tests, need to look at every layer.
+        if (singleCell) {
+            for (unsigned index : m_cells[row * m_columns + column]) {
+                const Entry& entry = m_entries[index];
+                if (entry.bounds.intersects(rect))
+                    candidates.append(entry.box);
+            }
+            return;
+        }
+    }
+
+    for (const Entry& entry : m_entries) {
+        if (entry.bounds.intersects(rect))
+            candidates.append(entry.box);
+    }
+}
+
+} // namespace blink
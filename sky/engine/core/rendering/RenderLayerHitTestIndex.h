@@ -0,0 +1,58 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_RENDERING_RENDERLAYERHITTESTINDEX_H_
+#define SKY_ENGINE_CORE_RENDERING_RENDERLAYERHITTESTINDEX_H_
+
+#include "sky/engine/platform/geometry/IntRect.h"
+#include "sky/engine/platform/geometry/LayoutRect.h"
+#include "sky/engine/wtf/FastAllocBase.h"
+#include "sky/engine/wtf/Noncopyable.h"
+#include "sky/engine/wtf/Vector.h"
+
+namespace blink {
+
+class RenderBox;
+
+// The self-painting layers a layer hit tests, in hit testing order, with
+// conservative bounds in the coordinates of that layer. The bounds cover the
+// layer, its overflow and all of its descendant layers, so a layer whose
+// bounds miss the hit test area can be skipped without walking into it.
+// Large lists are bucketed into a grid so that point hit tests only look at
+// the layers in one cell.
+class RenderLayerHitTestIndex {
+    WTF_MAKE_NONCOPYABLE(RenderLayerHitTestIndex); WTF_MAKE_FAST_ALLOCATED;
+public:
+    explicit RenderLayerHitTestIndex(unsigned version);
+
+    // The RenderView::geometryVersion() the index was built for.
+    unsigned version() const { return m_version; }
+
+    // Layers have to be added in hit testing order, followed by a call to
+    // finishBuilding().
+    void add(RenderBox*, const LayoutRect& bounds);
+    void finishBuilding();
+
+    // Appends the layers whose bounds intersect |rect| in hit testing order.
+    void collectCandidates(const LayoutRect&, Vector<RenderBox*>& candidates) const;
+
+private:
+    struct Entry {
+        RenderBox* box;
+        LayoutRect bounds;
+    };
+
+    unsigned m_version;
+    Vector<Entry> m_entries;
+
+    // Empty unless there are enough entries to be worth bucketing.
+    IntRect m_gridBounds;
+    int m_cellSize;
+    int m_columns;
+    Vector<Vector<unsigned> > m_cells;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_RENDERING_RENDERLAYERHITTESTINDEX_H_
@@ -35,6 +35,8 @@
 #include "sky/engine/core/rendering/RenderView.h"
 #include "sky/engine/core/rendering/RootInlineBox.h"
 
+#include <algorithm>
+
 namespace blink {
 
 #if ENABLE(ASSERT)
@@ -48,6 +50,7 @@ RenderLineBoxList::~RenderLineBoxList()
 void RenderLineBoxList::appendLineBox(InlineFlowBox* box)
 {
     checkConsistency();
+    m_lineIndex.clear();
 
     if (!m_firstLineBox)
         m_firstLineBox = m_lastLineBox = box;
@@ -62,6 +65,7 @@ void RenderLineBoxList::appendLineBox(InlineFlowBox* box)
 
 void RenderLineBoxList::deleteLineBoxTree()
 {
+    m_lineIndex.clear();
     InlineFlowBox* line = m_firstLineBox;
     InlineFlowBox* nextLine;
     while (line) {
@@ -75,6 +79,7 @@ void RenderLineBoxList::deleteLineBoxTree()
 void RenderLineBoxList::extractLineBox(InlineFlowBox* box)
 {
     checkConsistency();
+    m_lineIndex.clear();
 
     m_lastLineBox = box->prevLineBox();
     if (box == m_firstLineBox)
@@ -91,6 +96,7 @@ void RenderLineBoxList::extractLineBox(InlineFlowBox* box)
 void RenderLineBoxList::attachLineBox(InlineFlowBox* box)
 {
     checkConsistency();
+    m_lineIndex.clear();
 
     if (m_lastLineBox) {
         m_lastLineBox->setNextLineBox(box);
@@ -110,6 +116,7 @@ void RenderLineBoxList::attachLineBox(InlineFlowBox* box)
 void RenderLineBoxList::removeLineBox(InlineFlowBox* box)
 {
     checkConsistency();
+    m_lineIndex.clear();
 
     if (box == m_firstLineBox)
         m_firstLineBox = box->nextLineBox();
@@ -125,6 +132,7 @@ void RenderLineBoxList::removeLineBox(InlineFlowBox* box)
 
 void RenderLineBoxList::deleteLineBoxes()
 {
+    m_lineIndex.clear();
     if (m_firstLineBox) {
         InlineFlowBox* next;
         for (InlineFlowBox* curr = m_firstLineBox; curr; curr = next) {
@@ -175,13 +183,53 @@ bool RenderLineBoxList::anyLineIntersectsRect(RenderBoxModelObject* renderer, co
     return rangeIntersectsRect(renderer, firstLineTop, lastLineBottom, rect, offset);
 }
 
-bool RenderLineBoxList::lineIntersectsDirtyRect(RenderBoxModelObject* renderer, InlineFlowBox* box, const PaintInfo& paintInfo, const LayoutPoint& offset) const
+static LayoutUnit linePaintTop(InlineFlowBox* box)
 {
     RootInlineBox& root = box->root();
-    LayoutUnit logicalTop = std::min<LayoutUnit>(box->logicalTopVisualOverflow(root.lineTop()), root.selectionTop());
-    LayoutUnit logicalBottom = box->logicalBottomVisualOverflow(root.lineBottom());
+    return std::min<LayoutUnit>(box->logicalTopVisualOverflow(root.lineTop()), root.selectionTop());
+}
+
+static LayoutUnit linePaintBottom(InlineFlowBox* box)
+{
+    return box->logicalBottomVisualOverflow(box->root().lineBottom());
+}
+
+bool RenderLineBoxList::lineIntersectsDirtyRect(RenderBoxModelObject* renderer, InlineFlowBox* box, const PaintInfo& paintInfo, const LayoutPoint& offset) const
+{
+    return rangeIntersectsRect(renderer, linePaintTop(box), linePaintBottom(box), paintInfo.rect, offset);
+}
 
-    return rangeIntersectsRect(renderer, logicalTop, logicalBottom, paintInfo.rect, offset);
+// Short lists are faster to walk than to index.
+static const unsigned minimumLinesForIndex = 32;
+
+const RenderLineBoxList::LineIndex* RenderLineBoxList::lineIndex(RenderBoxModelObject* renderer) const
+{
+    unsigned version = renderer->view()->geometryVersion();
+    if (m_lineIndex && m_lineIndex->version == version)
+        return m_lineIndex.get();
+
+    m_lineIndex.clear();
+    unsigned lineCount = 0;
+    for (InlineFlowBox* curr = firstLineBox(); curr && lineCount < minimumLinesForIndex; curr = curr->nextLineBox())
+        ++lineCount;
+    if (lineCount < minimumLinesForIndex)
+        return 0;
+
+    OwnPtr<LineIndex> index = adoptPtr(new LineIndex);
+    index->version = version;
+    for (InlineFlowBox* curr = firstLineBox(); curr; curr = curr->nextLineBox()) {
+        LayoutUnit bottom = linePaintBottom(curr);
+        if (!index->maxBottoms.isEmpty())
+            bottom = std::max(bottom, index->maxBottoms.last());
+        index->lines.append(curr);
+        index->maxBottoms.append(bottom);
+        index->minTops.append(linePaintTop(curr));
+    }
+    for (size_t i = index->minTops.size() - 1; i > 0; --i)
+        index->minTops[i - 1] = std::min(index->minTops[i - 1], index->minTops[i]);
+
+    m_lineIndex = index.release();
+    return m_lineIndex.get();
 }
 
 void RenderLineBoxList::paint(RenderBoxModelObject* renderer, PaintInfo& paintInfo, const LayoutPoint& paintOffset, Vector<RenderBox*>& layers) const
@@ -197,6 +245,23 @@ void RenderLineBoxList::paint(RenderBoxModelObject* renderer, PaintInfo& paintIn
 
     PaintInfo info(paintInfo);
 
+    if (const LineIndex* index = lineIndex(renderer)) {
+        // Lines before |first| end above the dirty rect and lines from |end|
+        // on start below it.
+        LayoutUnit rectTop = info.rect.y() - paintOffset.y();
+        LayoutUnit rectBottom = info.rect.maxY() - paintOffset.y();
+        size_t first = std::upper_bound(index->maxBottoms.begin(), index->maxBottoms.end(), rectTop) - index->maxBottoms.begin();
+        size_t end = std::lower_bound(index->minTops.begin(), index->minTops.end(), rectBottom) - index->minTops.begin();
+        for (size_t i = first; i < end; ++i) {
+            InlineFlowBox* curr = index->lines[i];
+            if (lineIntersectsDirtyRect(renderer, curr, info, paintOffset)) {
+                RootInlineBox& root = curr->root();
+                curr->paint(info, paintOffset, root.lineTop(), root.lineBottom(), layers);
+            }
+        }
+        return;
+    }
+
     // See if our root lines intersect with the dirty rect.  If so, then we paint
     // them.  Note that boxes can easily overlap, so we can't make any assumptions
     // based off positions of our first line box or our last line box.
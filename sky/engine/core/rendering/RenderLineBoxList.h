@@ -31,6 +31,7 @@
 #define SKY_ENGINE_CORE_RENDERING_RENDERLINEBOXLIST_H_
 
 #include "sky/engine/core/rendering/RenderObject.h"
+#include "sky/engine/wtf/OwnPtr.h"
 
 namespace blink {
 
@@ -71,11 +72,27 @@ private:
     bool lineIntersectsDirtyRect(RenderBoxModelObject*, InlineFlowBox*, const PaintInfo&, const LayoutPoint&) const;
     bool rangeIntersectsRect(RenderBoxModelObject*, LayoutUnit logicalTop, LayoutUnit logicalBottom, const LayoutRect&, const LayoutPoint&) const;
 
+    // Lets painting find the lines of a long paragraph that intersect the
+    // dirty rect with a binary search. Lines can overlap, so each line is
+    // indexed by the largest bottom of the lines up to it and by the smallest
+    // top of the lines from it on, which only ever grow.
+    struct LineIndex {
+        unsigned version;
+        Vector<InlineFlowBox*> lines;
+        Vector<LayoutUnit> maxBottoms;
+        Vector<LayoutUnit> minTops;
+    };
+
+    const LineIndex* lineIndex(RenderBoxModelObject*) const;
+
     // For block flows, each box represents the root inline box for a line in the
     // paragraph.
     // For inline flows, each box represents a portion of that inline.
     InlineFlowBox* m_firstLineBox;
     InlineFlowBox* m_lastLineBox;
+
+    // Built on demand and dropped whenever the list changes.
+    mutable OwnPtr<LineIndex> m_lineIndex;
 };
 
 
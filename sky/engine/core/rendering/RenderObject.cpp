@@ -130,6 +130,7 @@ RenderObject* RenderObject::createObject(Element* element, RenderStyle* style)
 
 DEFINE_DEBUG_ONLY_GLOBAL(WTF::RefCountedLeakCounter, renderObjectCounter, ("RenderObject"));
 unsigned RenderObject::s_instanceCount = 0;
+unsigned RenderObject::s_laidOutCount = 0;
 
 RenderObject::RenderObject(Node* node)
     : m_style(nullptr)
@@ -1520,13 +1521,13 @@ inline void RenderObject::clearLayoutRootIfNeeded() const
 {
     if (frame()) {
         if (FrameView* view = frame()->view()) {
-            if (view->layoutRoot() == this) {
+            if (view->isLayoutSubtreeRoot(this)) {
                 if (!documentBeingDestroyed())
                     ASSERT_NOT_REACHED();
                 // This indicates a failure to layout the child, which is why
                 // the layout root is still set to |this|. Make sure to clear it
                 // since we are getting destroyed.
-                view->clearLayoutSubtreeRoot();
+                view->removeLayoutSubtreeRoot(const_cast<RenderObject*>(this));
             }
         }
     }
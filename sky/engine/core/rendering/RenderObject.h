@@ -236,6 +236,9 @@ public:
 
     static RenderObject* createObject(Element*, RenderStyle*);
     static unsigned instanceCount() { return s_instanceCount; }
+    // The number of times a renderer that needed layout has been laid out,
+    // which FrameView reports in traces.
+    static unsigned laidOutCount() { return s_laidOutCount; }
 
 #if !ENABLE(OILPAN)
     // RenderObjects are allocated out of the rendering partition.
@@ -767,6 +770,7 @@ private:
     static bool s_affectsParentBlock;
 
     static unsigned s_instanceCount;
+    static unsigned s_laidOutCount;
 };
 
 // Allow equality comparisons of RenderObjects by reference or pointer, interchangeably.
@@ -792,6 +796,8 @@ inline void RenderObject::setNeedsLayout(MarkingBehavior markParents, SubtreeLay
 
 inline void RenderObject::clearNeedsLayout()
 {
+    if (needsLayout())
+        ++s_laidOutCount;
     setOnlyNeededPositionedMovementLayout(needsPositionedMovementLayoutOnly());
     setNeededLayoutBecauseOfChildren(needsLayoutBecauseOfChildren());
     setSelfNeedsLayout(false);
@@ -44,6 +44,7 @@ RenderView::RenderView(Document* document)
     , m_selectionEndPos(-1)
     , m_renderCounterCount(0)
     , m_hitTestCount(0)
+    , m_geometryVersion(0)
 {
     // init RenderObject attributes
     setInline(false);
@@ -43,6 +43,12 @@ public:
     // Returns the total count of calls to HitTest, for testing.
     unsigned hitTestCount() const { return m_hitTestCount; }
 
+    // Bumped after every layout and style recalc. Caches of positions and
+    // overflow, like the hit test bounds of layers and the paint index of
+    // long line box lists, are only valid for the version they were built for.
+    unsigned geometryVersion() const { return m_geometryVersion; }
+    void geometryDidChange() { ++m_geometryVersion; }
+
     virtual const char* renderName() const override { return "RenderView"; }
 
     virtual bool isRenderView() const override { return true; }
@@ -107,6 +113,7 @@ private:
     unsigned m_renderCounterCount;
 
     unsigned m_hitTestCount;
+    unsigned m_geometryVersion;
 };
 
 DEFINE_RENDER_OBJECT_TYPE_CASTS(RenderView, isRenderView());
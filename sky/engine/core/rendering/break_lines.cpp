@@ -115,8 +115,24 @@ static const unsigned char asciiLineBreakTable[][(asciiLineBreakTableLastChar -
 
 COMPILE_ASSERT(WTF_ARRAY_LENGTH(asciiLineBreakTable) == asciiLineBreakTableLastChar - asciiLineBreakTableFirstChar + 1, TestLineBreakTableConsistency);
 
+// Latin-1 letters have the same line breaking class as ASCII letters, so
+// text such as "café" or "Ångström" can be broken without ICU.
+static inline bool isLatin1Letter(UChar ch)
+{
+    return ch >= 0xC0 && ch <= 0xFF && ch != 0xD7 && ch != 0xF7;
+}
+
+static inline UChar asciiLineBreakEquivalent(UChar ch)
+{
+    return isLatin1Letter(ch) ? 'a' : ch;
+}
+
 static inline bool shouldBreakAfter(UChar lastCh, UChar ch, UChar nextCh)
 {
+    lastCh = asciiLineBreakEquivalent(lastCh);
+    ch = asciiLineBreakEquivalent(ch);
+    nextCh = asciiLineBreakEquivalent(nextCh);
+
     // Don't allow line breaking between '-' and a digit if the '-' may mean a minus sign in the context,
     // while allow breaking in 'ABCD-1234' and '1234-5678' which may be in long URLs.
     if (ch == '-' && isASCIIDigit(nextCh))
@@ -137,9 +153,9 @@ static inline bool shouldBreakAfter(UChar lastCh, UChar ch, UChar nextCh)
 template<bool treatNoBreakSpaceAsBreak>
 inline bool needsLineBreakIterator(UChar ch)
 {
-    if (treatNoBreakSpaceAsBreak)
-        return ch > asciiLineBreakTableLastChar;
-    return ch > asciiLineBreakTableLastChar && ch != noBreakSpace;
+    if (ch <= asciiLineBreakTableLastChar || isLatin1Letter(ch))
+        return false;
+    return treatNoBreakSpaceAsBreak || ch != noBreakSpace;
 }
 
 template<typename CharacterType, bool treatNoBreakSpaceAsBreak>
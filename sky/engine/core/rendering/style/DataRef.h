@@ -48,6 +48,22 @@ public:
         m_data = T::create();
     }
 
+    // True if no other style refers to the same data.
+    bool isUnshared() const { return m_data->hasOneRef(); }
+
+    // Refers to the data of |o| instead, if it holds the same values.
+    bool shareIfEqual(const DataRef<T>& o)
+    {
+        ASSERT(m_data);
+        ASSERT(o.m_data);
+        if (m_data == o.m_data)
+            return true;
+        if (*m_data != *o.m_data)
+            return false;
+        m_data = o.m_data;
+        return true;
+    }
+
     bool operator==(const DataRef<T>& o) const
     {
         ASSERT(m_data);
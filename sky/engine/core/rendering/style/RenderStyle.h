@@ -105,6 +105,7 @@ class RenderStyle: public RefCounted<RenderStyle> {
     friend class StyleBuilderConverter;
     friend class StyleResolverState;
     friend class StyleResolver;
+    friend class SharedStyleDataCache; // Shares equal groups between styles.
 protected:
 
     // non-inherited attributes
@@ -136,6 +136,7 @@ bool StyleRareNonInheritedData::operator==(const StyleRareNonInheritedData& o) c
         && m_hasAspectRatio == o.m_hasAspectRatio
         && m_touchAction == o.m_touchAction
         && m_objectFit == o.m_objectFit
+        && m_isolation == o.m_isolation
         && m_justifyItems == o.m_justifyItems
         && m_justifyItemsOverflowAlignment == o.m_justifyItemsOverflowAlignment
         && m_justifyItemsPositionType == o.m_justifyItemsPositionType
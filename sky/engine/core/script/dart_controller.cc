@@ -8,7 +8,9 @@
 #include "base/logging.h"
 #include "base/single_thread_task_runner.h"
 #include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_synthetic_delay.h"
 #include "dart/runtime/include/dart_tools_api.h"
+#include "gen/sky/platform/RuntimeEnabledFeatures.h"
 #include "mojo/data_pipe_utils/data_pipe_utils.h"
 #include "mojo/public/cpp/system/data_pipe.h"
 #include "sky/engine/bindings/builtin.h"
@@ -17,6 +19,7 @@
 #include "sky/engine/core/script/dart_debugger.h"
 #include "sky/engine/core/script/dart_init.h"
 #include "sky/engine/core/script/dart_service_isolate.h"
+#include "sky/engine/core/script/dart_worker_isolate.h"
 #include "sky/engine/core/script/dom_dart_state.h"
 #include "sky/engine/public/platform/Platform.h"
 #include "sky/engine/tonic/dart_api_scope.h"
@@ -34,6 +37,10 @@
 namespace blink {
 namespace {
 
+// While tracing, app callbacks that take longer than this are called out in
+// the trace. A quarter of a 60Hz frame leaves time for the rest of the frame.
+const int64_t kSlowInvokeThresholdMicroseconds = 4000;
+
 void CreateEmptyRootLibraryIfNeeded() {
   if (Dart_IsNull(Dart_RootLibrary())) {
     Dart_LoadScript(Dart_NewStringFromCString("dart:empty"), Dart_EmptyString(),
@@ -41,8 +48,19 @@ void CreateEmptyRootLibraryIfNeeded() {
   }
 }
 
+// Compiling a function the first time it is called makes the first frames
+// that call it slow. Compiling everything up front trades that for a longer
+// start.
+void CompileAllIfEnabled() {
+  if (!RuntimeEnabledFeatures::dartCompileAllEnabled())
+    return;
+  TRACE_EVENT0("sky", "Dart_CompileAll");
+  LogIfError(Dart_CompileAll());
+}
+
 void CallHandleMessage(base::WeakPtr<DartState> dart_state) {
   TRACE_EVENT0("sky", "CallHandleMessage");
+  TRACE_EVENT_SYNTHETIC_DELAY("sky.MojoDispatch");
 
   if (!dart_state)
     return;
@@ -65,6 +83,7 @@ DartController::DartController() : weak_factory_(this) {
 
 DartController::~DartController() {
   if (dom_dart_state_) {
+    DartWorkerIsolate::ClearScript(dom_dart_state_.get());
     // Don't use a DartIsolateScope here since we never exit the isolate.
     Dart_EnterIsolate(dom_dart_state_->isolate());
     Dart_ShutdownIsolate();
@@ -73,22 +92,43 @@ DartController::~DartController() {
   }
 }
 
-void DartController::DidLoadMainLibrary(String name) {
+void DartController::DidLoadMainLibrary(
+    String name,
+    ScriptSnapshotCallback snapshot_callback) {
+  TRACE_EVENT0("sky", "DartController::DidLoadMainLibrary");
   DCHECK(Dart_CurrentIsolate() == dart_state()->isolate());
   DartApiScope dart_api_scope;
 
   if (LogIfError(Dart_FinalizeLoading(true)))
     return;
 
+  if (!snapshot_callback.is_null()) {
+    TRACE_EVENT0("sky", "DartController::CreateScriptSnapshot");
+    uint8_t* buffer = nullptr;
+    intptr_t size = 0;
+    if (!LogIfError(Dart_CreateScriptSnapshot(&buffer, &size))) {
+      std::vector<uint8_t> snapshot(buffer, buffer + size);
+      DartWorkerIsolate::SetScript(
+          dart_state(),
+          make_scoped_refptr(new base::RefCountedBytes(snapshot)));
+      snapshot_callback.Run(snapshot,
+                            dart_state()->library_loader().source_digests());
+    }
+  }
+
   Dart_Handle library = Dart_LookupLibrary(StringToDart(dart_state(), name));
   // TODO(eseidel): We need to load a 404 page instead!
   if (LogIfError(library))
     return;
+  CompileAllIfEnabled();
   DartInvokeAppField(library, ToDart("main"), 0, nullptr);
 }
 
 void DartController::DidLoadSnapshot() {
+  TRACE_EVENT0("sky", "DartController::DidLoadSnapshot");
   DCHECK(Dart_CurrentIsolate() == nullptr);
+  if (snapshot_loader_->snapshot())
+    DartWorkerIsolate::SetScript(dart_state(), snapshot_loader_->snapshot());
   snapshot_loader_ = nullptr;
 
   Dart_Isolate isolate = dart_state()->isolate();
@@ -98,6 +138,7 @@ void DartController::DidLoadSnapshot() {
   Dart_Handle library = Dart_RootLibrary();
   if (LogIfError(library))
     return;
+  CompileAllIfEnabled();
   DartInvokeAppField(library, ToDart("main"), 0, nullptr);
 }
 
@@ -109,6 +150,13 @@ void DartController::RunFromSnapshot(
       base::Bind(&DartController::DidLoadSnapshot, weak_factory_.GetWeakPtr()));
 }
 
+void DartController::RunFromSnapshotFile(const base::FilePath& path) {
+  snapshot_loader_ = adoptPtr(new DartSnapshotLoader(dart_state()));
+  snapshot_loader_->LoadSnapshotFromFile(
+      path,
+      base::Bind(&DartController::DidLoadSnapshot, weak_factory_.GetWeakPtr()));
+}
+
 void DartController::RunFromLibrary(const String& name,
                                     DartLibraryProvider* library_provider) {
   DartState::Scope scope(dart_state());
@@ -121,7 +169,28 @@ void DartController::RunFromLibrary(const String& name,
   loader.LoadLibrary(name.toUTF8());
   loader.WaitForDependencies(dependency_catcher.dependencies(),
                              base::Bind(&DartController::DidLoadMainLibrary,
-                                        weak_factory_.GetWeakPtr(), name));
+                                        weak_factory_.GetWeakPtr(), name,
+                                        ScriptSnapshotCallback()));
+}
+
+void DartController::RunFromLibraryAndSnapshot(
+    const String& name,
+    DartLibraryProvider* library_provider,
+    const ScriptSnapshotCallback& callback) {
+  DartState::Scope scope(dart_state());
+
+  DartLibraryLoader& loader = dart_state()->library_loader();
+  loader.set_library_provider(library_provider);
+  loader.set_records_source_digests(true);
+
+  // A script snapshot only contains the root library and what it imports, so
+  // the main library has to be the root rather than dart:empty.
+  DartDependencyCatcher dependency_catcher(loader);
+  loader.LoadScript(name.toUTF8());
+  loader.WaitForDependencies(dependency_catcher.dependencies(),
+                             base::Bind(&DartController::DidLoadMainLibrary,
+                                        weak_factory_.GetWeakPtr(), name,
+                                        callback));
 }
 
 void DartController::CreateIsolateFor(PassOwnPtr<DOMDartState> state) {
@@ -135,6 +204,7 @@ void DartController::CreateIsolateFor(PassOwnPtr<DOMDartState> state) {
   CHECK(isolate) << error;
   dom_dart_state_->SetIsolate(isolate);
   CHECK(!LogIfError(Dart_SetLibraryTagHandler(DartLibraryTagHandler)));
+  CHECK(!LogIfError(Dart_SetGcCallbacks(DartGCPrologue, DartGCEpilogue)));
 
   {
     DartApiScope apiScope;
@@ -183,6 +253,8 @@ void DartController::StartTracing() {
   DartApiScope dart_api_scope;
 
   Dart_TimelineSetRecordedStreams(DART_TIMELINE_STREAM_ALL);
+  EnableDartInvokeProfiling(
+      base::TimeDelta::FromMicroseconds(kSlowInvokeThresholdMicroseconds));
 }
 
 void DartController::StopTracing(
@@ -191,6 +263,7 @@ void DartController::StopTracing(
   DartApiScope dart_api_scope;
 
   Dart_TimelineSetRecordedStreams(DART_TIMELINE_STREAM_DISABLE);
+  DisableDartInvokeProfiling();
 
   auto callback =
       reinterpret_cast<Dart_StreamConsumer>(&DartController_DartStreamConsumer);
@@ -6,10 +6,12 @@
 #define SKY_ENGINE_CORE_SCRIPT_DART_CONTROLLER_H_
 
 #include "base/callback_forward.h"
+#include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
 #include "dart/runtime/include/dart_api.h"
 #include "mojo/public/cpp/system/data_pipe.h"
+#include "sky/engine/tonic/dart_library_loader.h"
 #include "sky/engine/wtf/OwnPtr.h"
 #include "sky/engine/wtf/text/AtomicString.h"
 #include "sky/engine/wtf/text/TextPosition.h"
@@ -26,6 +28,12 @@ class View;
 
 class DartController {
  public:
+  // Receives a script snapshot of the app along with the sources it was made
+  // from.
+  typedef base::Callback<void(const std::vector<uint8_t>& snapshot,
+                              const DartLibraryLoader::SourceDigests& sources)>
+      ScriptSnapshotCallback;
+
   DartController();
   ~DartController();
 
@@ -33,7 +41,13 @@ class DartController {
 
   void RunFromLibrary(const String& name,
                       DartLibraryProvider* library_provider);
+  // Like RunFromLibrary, but loads |name| as the root script and takes a
+  // script snapshot once everything has loaded, just before main runs.
+  void RunFromLibraryAndSnapshot(const String& name,
+                                 DartLibraryProvider* library_provider,
+                                 const ScriptSnapshotCallback& callback);
   void RunFromSnapshot(mojo::ScopedDataPipeConsumerHandle snapshot);
+  void RunFromSnapshotFile(const base::FilePath& path);
 
   void CreateIsolateFor(PassOwnPtr<DOMDartState> dom_dart_state);
   void Shutdown();
@@ -45,7 +59,7 @@ class DartController {
   void StopTracing(mojo::ScopedDataPipeProducerHandle producer);
 
  private:
-  void DidLoadMainLibrary(String url);
+  void DidLoadMainLibrary(String url, ScriptSnapshotCallback snapshot_callback);
   void DidLoadSnapshot();
 
   OwnPtr<DOMDartState> dom_dart_state_;
@@ -16,6 +16,7 @@
 #include "sky/engine/bindings/builtin_sky.h"
 #include "sky/engine/core/script/dart_debugger.h"
 #include "sky/engine/core/script/dart_service_isolate.h"
+#include "sky/engine/core/script/dart_worker_isolate.h"
 #include "sky/engine/core/script/dom_dart_state.h"
 #include "sky/engine/tonic/dart_api_scope.h"
 #include "sky/engine/tonic/dart_class_library.h"
@@ -92,7 +93,7 @@ void UnhandledExceptionCallback(Dart_Handle error) {
 }
 
 void IsolateShutdownCallback(void* callback_data) {
-  // TODO(dart)
+  DartWorkerIsolate::DidShutdown(callback_data);
 }
 
 bool IsServiceIsolateURL(const char* url_name) {
@@ -100,9 +101,8 @@ bool IsServiceIsolateURL(const char* url_name) {
       String(url_name) == DART_VM_SERVICE_ISOLATE_NAME;
 }
 
-// TODO(rafaelw): Right now this only supports the creation of the handle
-// watcher isolate and the service isolate. Presumably, we'll want application
-// isolates to spawn their own isolates.
+// Creates the service isolate, the handle watcher isolate, and the isolates
+// apps spawn, whose parents have a script to run them from.
 Dart_Isolate IsolateCreateCallback(const char* script_uri,
                                           const char* main,
                                           const char* package_root,
@@ -110,6 +110,12 @@ Dart_Isolate IsolateCreateCallback(const char* script_uri,
                                           void* callback_data,
                                           char** error) {
   if (IsServiceIsolateURL(script_uri)) {
+    // The VM goes on without a service isolate. The handle watcher is then
+    // started by the first app isolate.
+    if (!RuntimeEnabledFeatures::observatoryEnabled()) {
+      *error = strdup("The observatory is disabled.");
+      return nullptr;
+    }
     CHECK(kDartIsolateSnapshotBuffer);
     DartState* dart_state = new DartState();
     Dart_Isolate isolate =
@@ -128,18 +134,20 @@ Dart_Isolate IsolateCreateCallback(const char* script_uri,
       // Start the handle watcher from the service isolate so it isn't available
       // for debugging or general Observatory interaction.
       EnsureHandleWatcherStarted();
-      if (RuntimeEnabledFeatures::observatoryEnabled()) {
-        std::string ip = "127.0.0.1";
-        const intptr_t port = 8181;
-        const bool service_isolate_booted =
-            DartServiceIsolate::Startup(ip, port, DartLibraryTagHandler, error);
-        CHECK(service_isolate_booted) << error;
-      }
+      std::string ip = "127.0.0.1";
+      const intptr_t port = 8181;
+      const bool service_isolate_booted =
+          DartServiceIsolate::Startup(ip, port, DartLibraryTagHandler, error);
+      CHECK(service_isolate_booted) << error;
     }
     Dart_ExitIsolate();
     return isolate;
   }
 
+  DartState* parent = static_cast<DartState*>(callback_data);
+  if (parent && DartWorkerIsolate::CanSpawn(parent))
+    return DartWorkerIsolate::Create(parent, script_uri, main, error);
+
   // Create & start the handle watcher isolate
   CHECK(kDartIsolateSnapshotBuffer);
   // TODO(abarth): Who deletes this DartState instance?
@@ -171,6 +179,7 @@ Dart_Isolate IsolateCreateCallback(const char* script_uri,
 } // namespace
 
 void InitDartVM() {
+  TRACE_EVENT0("sky", "InitDartVM");
   dart::bin::BootstrapDartIo();
 
   bool enable_checked_mode = RuntimeEnabledFeatures::dartCheckedModeEnabled();
@@ -194,7 +203,8 @@ void InitDartVM() {
                         nullptr, nullptr, nullptr, nullptr, nullptr));
   // Wait for load port- ensures handle watcher and service isolates are
   // running.
-  Dart_ServiceWaitForLoadPort();
+  if (RuntimeEnabledFeatures::observatoryEnabled())
+    Dart_ServiceWaitForLoadPort();
 }
 
 } // namespace blink
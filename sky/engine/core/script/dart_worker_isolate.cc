@@ -0,0 +1,145 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/script/dart_worker_isolate.h"
+
+#include <string.h>
+
+#include <map>
+#include <set>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/synchronization/lock.h"
+#include "base/trace_event/trace_event.h"
+#include "sky/engine/bindings/builtin.h"
+#include "sky/engine/bindings/builtin_natives.h"
+#include "sky/engine/core/script/dart_init.h"
+#include "sky/engine/tonic/dart_api_scope.h"
+#include "sky/engine/tonic/dart_error.h"
+#include "sky/engine/tonic/dart_library_loader.h"
+#include "sky/engine/tonic/dart_state.h"
+
+namespace blink {
+namespace {
+
+// Isolates are spawned and shut down on VM threads, so the bookkeeping is
+// behind a lock.
+struct Registry {
+  base::Lock lock;
+  std::map<DartState*, scoped_refptr<base::RefCountedMemory>> scripts;
+  // The states of the live workers, which are owned here.
+  std::set<DartState*> workers;
+};
+
+base::LazyInstance<Registry>::Leaky g_registry = LAZY_INSTANCE_INITIALIZER;
+
+scoped_refptr<base::RefCountedMemory> GetScript(DartState* dart_state) {
+  Registry& registry = g_registry.Get();
+  base::AutoLock lock(registry.lock);
+  auto it = registry.scripts.find(dart_state);
+  if (it == registry.scripts.end())
+    return nullptr;
+  return it->second;
+}
+
+Dart_Handle WorkerLibraryTagHandler(Dart_LibraryTag tag,
+                                    Dart_Handle library,
+                                    Dart_Handle url) {
+  return DartLibraryLoader::HandleLibraryTag(tag, library, url);
+}
+
+}  // namespace
+
+void DartWorkerIsolate::SetScript(
+    DartState* dart_state,
+    scoped_refptr<base::RefCountedMemory> script) {
+  DCHECK(script);
+  Registry& registry = g_registry.Get();
+  base::AutoLock lock(registry.lock);
+  registry.scripts[dart_state] = script;
+}
+
+void DartWorkerIsolate::ClearScript(DartState* dart_state) {
+  Registry& registry = g_registry.Get();
+  base::AutoLock lock(registry.lock);
+  registry.scripts.erase(dart_state);
+}
+
+bool DartWorkerIsolate::CanSpawn(DartState* dart_state) {
+  return GetScript(dart_state) != nullptr;
+}
+
+Dart_Isolate DartWorkerIsolate::Create(DartState* parent,
+                                       const char* script_uri,
+                                       const char* main,
+                                       char** error) {
+  TRACE_EVENT0("sky", "DartWorkerIsolate::Create");
+  scoped_refptr<base::RefCountedMemory> script = GetScript(parent);
+  if (!script) {
+    *error = strdup("This isolate cannot spawn isolates.");
+    return nullptr;
+  }
+
+  CHECK(kDartIsolateSnapshotBuffer);
+  DartState* dart_state = new DartState();
+  Dart_Isolate isolate = Dart_CreateIsolate(
+      script_uri, main, kDartIsolateSnapshotBuffer, nullptr, dart_state, error);
+  if (!isolate) {
+    delete dart_state;
+    return nullptr;
+  }
+  dart_state->SetIsolate(isolate);
+
+  {
+    DartApiScope api_scope;
+    CHECK(!LogIfError(Dart_SetLibraryTagHandler(WorkerLibraryTagHandler)));
+    Builtin::SetNativeResolver(Builtin::kBuiltinLibrary);
+    Builtin::SetNativeResolver(Builtin::kMojoInternalLibrary);
+    Builtin::SetNativeResolver(Builtin::kIOLibrary);
+    BuiltinNatives::Init(BuiltinNatives::DartIOIsolate);
+
+    Dart_Handle result =
+        Dart_LoadScriptFromSnapshot(script->front(), script->size());
+    if (Dart_IsError(result)) {
+      *error = strdup(Dart_GetError(result));
+      Dart_ShutdownIsolate();
+      delete dart_state;
+      return nullptr;
+    }
+  }
+
+  Dart_ExitIsolate();
+
+  {
+    Registry& registry = g_registry.Get();
+    base::AutoLock lock(registry.lock);
+    registry.workers.insert(dart_state);
+    // Workers spawn workers of their own from the same script.
+    registry.scripts[dart_state] = script;
+  }
+
+  if (!Dart_IsolateMakeRunnable(isolate)) {
+    *error = strdup("Could not make the isolate runnable.");
+    Dart_EnterIsolate(isolate);
+    Dart_ShutdownIsolate();
+    return nullptr;
+  }
+  return isolate;
+}
+
+void DartWorkerIsolate::DidShutdown(void* callback_data) {
+  DartState* dart_state = static_cast<DartState*>(callback_data);
+  {
+    Registry& registry = g_registry.Get();
+    base::AutoLock lock(registry.lock);
+    if (!registry.workers.erase(dart_state))
+      return;
+    registry.scripts.erase(dart_state);
+  }
+  dart_state->SetIsolate(nullptr);
+  delete dart_state;
+}
+
+}  // namespace blink
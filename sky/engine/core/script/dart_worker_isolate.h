@@ -0,0 +1,43 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_SCRIPT_DART_WORKER_ISOLATE_H_
+#define SKY_ENGINE_CORE_SCRIPT_DART_WORKER_ISOLATE_H_
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "include/dart_api.h"
+
+namespace blink {
+class DartState;
+
+// Creates the isolates an app spawns with Isolate.spawn, from the snapshot of
+// the app's script. Workers run on the VM's thread pool rather than the UI
+// thread, and have dart:mojo and dart:io but not the dart:sky natives, so
+// that they can decode or crunch data without holding up frames. Typed data
+// too large to copy is best handed over in a mojo shared buffer.
+class DartWorkerIsolate {
+ public:
+  // Lets the isolate of |dart_state| spawn workers that run |script|, a
+  // script snapshot. Can be called on any thread.
+  static void SetScript(DartState* dart_state,
+                        scoped_refptr<base::RefCountedMemory> script);
+  static void ClearScript(DartState* dart_state);
+  static bool CanSpawn(DartState* dart_state);
+
+  // Called from the VM's isolate creation callback, on the thread that
+  // spawns the isolate. Returns null and sets |*error| on failure.
+  static Dart_Isolate Create(DartState* parent,
+                             const char* script_uri,
+                             const char* main,
+                             char** error);
+
+  // Called from the VM's isolate shutdown callback. Frees the state of
+  // workers and ignores other isolates.
+  static void DidShutdown(void* callback_data);
+};
+
+}  // namespace blink
+
+#endif  // SKY_ENGINE_CORE_SCRIPT_DART_WORKER_ISOLATE_H_
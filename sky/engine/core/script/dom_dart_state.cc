@@ -31,6 +31,7 @@ void DOMDartState::DidSetIsolate() {
   dx_handle_.Set(this, ToDart("_dx"));
   dy_handle_.Set(this, ToDart("_dy"));
   value_handle_.Set(this, ToDart("_value"));
+  version_handle_.Set(this, ToDart("_version"));
 
   Dart_Handle sky_library = DartBuiltin::LookupLibrary("dart:sky");
   color_class_.Set(this, Dart_GetType(sky_library, ToDart("Color"), 0, 0));
@@ -5,7 +5,11 @@
 #ifndef SKY_ENGINE_CORE_SCRIPT_DOM_DART_STATE_H_
 #define SKY_ENGINE_CORE_SCRIPT_DOM_DART_STATE_H_
 
+#include <memory>
+#include <unordered_map>
+
 #include "dart/runtime/include/dart_api.h"
+#include "sky/compositor/container_layer.h"
 #include "sky/engine/core/dom/Document.h"
 #include "sky/engine/tonic/dart_state.h"
 #include "sky/engine/wtf/RefPtr.h"
@@ -31,16 +35,26 @@ class DOMDartState : public DartState {
   Dart_Handle dx_handle() { return dx_handle_.value(); }
   Dart_Handle dy_handle() { return dy_handle_.value(); }
   Dart_Handle value_handle() { return value_handle_.value(); }
+  Dart_Handle version_handle() { return version_handle_.value(); }
   Dart_Handle color_class() { return color_class_.value(); }
 
+  // Layers tagged with a retained key in the most recently built scene.
+  // SceneBuilder reuses them by reference in the next scene.
+  using RetainedLayerMap =
+      std::unordered_map<int, std::shared_ptr<sky::compositor::ContainerLayer>>;
+  RetainedLayerMap& retained_layers() { return retained_layers_; }
+
  private:
   String url_;
 
+  RetainedLayerMap retained_layers_;
+
   DartPersistentValue x_handle_;
   DartPersistentValue y_handle_;
   DartPersistentValue dx_handle_;
   DartPersistentValue dy_handle_;
   DartPersistentValue value_handle_;
+  DartPersistentValue version_handle_;
   DartPersistentValue color_class_;
 };
 
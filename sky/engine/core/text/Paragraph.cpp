@@ -2,63 +2,358 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
-#include "sky/engine/core/text/ParagraphBuilder.h"
+#include "sky/engine/core/text/Paragraph.h"
 
-#include "sky/engine/core/rendering/style/RenderStyle.h"
+#include "gen/sky/platform/RuntimeEnabledFeatures.h"
+#include "sky/engine/core/rendering/break_lines.h"
+#include "sky/engine/core/text/ParagraphLayoutQueue.h"
+#include "sky/engine/platform/fonts/FontMetrics.h"
+#include "sky/engine/platform/graphics/GraphicsContext.h"
+#include "sky/engine/platform/text/TextBreakIterator.h"
+#include "sky/engine/platform/text/TextRun.h"
+#include "sky/engine/wtf/text/StringView.h"
+
+#include <algorithm>
 
 namespace blink {
+namespace {
+
+// The values of the TextAlign enum in dart:sky.
+enum ParagraphAlign {
+    AlignLeft,
+    AlignRight,
+    AlignCenter,
+};
+
+// The text between two line break opportunities. [start, contentEnd) is
+// drawn, [contentEnd, end) is the whitespace that can hang past the end of
+// the line.
+struct Segment {
+    unsigned start;
+    unsigned contentEnd;
+    unsigned end;
+    bool endsWithHardBreak;
+};
+
+inline bool isCollapsibleSpace(UChar c)
+{
+    return c == ' ' || c == '\t';
+}
+
+// Finds the segment that starts at |start|. Returns false at the end of the
+// text.
+bool nextSegment(const String& text, LazyLineBreakIterator& breakIterator, unsigned start, Segment& segment)
+{
+    unsigned length = text.length();
+    if (start >= length)
+        return false;
+
+    segment.start = start;
+    segment.endsWithHardBreak = false;
+    if (text[start] == '\n') {
+        segment.contentEnd = start;
+        segment.end = start + 1;
+        segment.endsWithHardBreak = true;
+        return true;
+    }
+
+    unsigned end = std::min<unsigned>(nextBreakablePositionIgnoringNBSP(breakIterator, start + 1), length);
+    while (end < length && isCollapsibleSpace(text[end]))
+        ++end;
+
+    unsigned contentEnd = end;
+    while (contentEnd > start && isCollapsibleSpace(text[contentEnd - 1]))
+        --contentEnd;
+
+    segment.contentEnd = contentEnd;
+    segment.end = end;
+    if (end < length && text[end] == '\n') {
+        segment.end = end + 1;
+        segment.endsWithHardBreak = true;
+    }
+    return true;
+}
 
-Paragraph::Paragraph(PassOwnPtr<RenderView> renderView)
-    : m_renderView(renderView)
+} // namespace
+
+Paragraph::Paragraph(const String& text, Vector<ParagraphRun>& runs, int align, double lineHeight)
+    : m_text(text)
+    , m_align(align)
+    , m_lineHeight(lineHeight)
+    , m_fragmentsValid(false)
+    , m_minIntrinsicWidth(0)
+    , m_maxIntrinsicWidth(0)
+    , m_contentHeight(0)
 {
+    m_runs.swap(runs);
 }
 
 Paragraph::~Paragraph()
 {
 }
 
+size_t Paragraph::GetAllocationSize()
+{
+    // Wrappers are made before the paragraph is laid out, so the line
+    // breaking state and text blobs it builds later are not counted.
+    return sizeof(Paragraph) + m_text.sizeInBytes() + m_runs.capacity() * sizeof(ParagraphRun);
+}
+
 double Paragraph::width()
 {
-    return m_renderView->firstChildBox()->width();
+    return std::max(m_minWidth, m_maxWidth).toDouble();
 }
 
 double Paragraph::height()
 {
-    return m_renderView->firstChildBox()->height();
+    return std::max(m_minHeight.toFloat(), m_contentHeight);
 }
 
 double Paragraph::minIntrinsicWidth()
 {
-    return 0.0;
+    ensureFragments();
+    return m_minIntrinsicWidth;
 }
 
 double Paragraph::maxIntrinsicWidth()
 {
-    return 0.0;
+    ensureFragments();
+    return m_maxIntrinsicWidth;
 }
 
 double Paragraph::alphabeticBaseline()
 {
-    return 0.0;
+    if (m_lines.isEmpty())
+        return 0.0;
+    return m_lines.first().baseline;
 }
 
 double Paragraph::ideographicBaseline()
 {
-    return 0.0;
+    // The ideographic baseline sits at the bottom of the em box, which the
+    // descent of the first line approximates.
+    if (m_lines.isEmpty())
+        return 0.0;
+    return m_lines.first().baseline + m_lines.first().descent;
+}
+
+float Paragraph::measure(const ParagraphRun& run, unsigned start, unsigned end) const
+{
+    if (start >= end)
+        return 0;
+    return run.font.width(TextRun(StringView(m_text.impl(), start, end - start)));
+}
+
+void Paragraph::ensureFragments()
+{
+    if (m_fragmentsValid)
+        return;
+    m_fragmentsValid = true;
+
+    LazyLineBreakIterator breakIterator(m_text);
+    size_t runIndex = 0;
+    float lineWidth = 0;
+    Segment segment;
+    for (unsigned start = 0; nextSegment(m_text, breakIterator, start, segment); start = segment.end) {
+        // The newline that ends a hard break is neither drawn nor measured.
+        unsigned spaceEnd = segment.endsWithHardBreak ? segment.end - 1 : segment.end;
+        float segmentContentWidth = 0;
+        float segmentSpaceWidth = 0;
+
+        while (runIndex < m_runs.size() && m_runs[runIndex].end <= segment.start)
+            ++runIndex;
+        for (size_t i = runIndex; i < m_runs.size() && m_runs[i].start < segment.end; ++i) {
+            const ParagraphRun& run = m_runs[i];
+            Fragment fragment;
+            fragment.runIndex = i;
+            fragment.start = std::max(segment.start, run.start);
+            fragment.end = std::min(segment.end, run.end);
+            fragment.contentEnd = std::min(std::max(segment.contentEnd, fragment.start), fragment.end);
+            fragment.contentWidth = measure(run, fragment.start, fragment.contentEnd);
+            fragment.spaceWidth = measure(run, fragment.contentEnd, std::min(spaceEnd, fragment.end));
+            fragment.endsSegment = fragment.end == segment.end;
+            fragment.endsWithHardBreak = fragment.endsSegment && segment.endsWithHardBreak;
+            m_fragments.append(fragment);
+
+            segmentContentWidth += fragment.contentWidth;
+            segmentSpaceWidth += fragment.spaceWidth;
+        }
+
+        m_minIntrinsicWidth = std::max(m_minIntrinsicWidth, segmentContentWidth);
+        m_maxIntrinsicWidth = std::max(m_maxIntrinsicWidth, lineWidth + segmentContentWidth);
+        lineWidth += segmentContentWidth + segmentSpaceWidth;
+        if (segment.endsWithHardBreak)
+            lineWidth = 0;
+    }
+}
+
+void Paragraph::addRunMetrics(size_t runIndex, float& ascent, float& descent) const
+{
+    const ParagraphRun& run = m_runs[runIndex];
+    const FontMetrics& metrics = run.font.fontMetrics();
+    float runAscent = metrics.floatAscent();
+    float runDescent = metrics.floatDescent();
+    if (m_lineHeight > 0) {
+        // Like CSS, spread the difference to the requested line height
+        // evenly above and below the glyphs.
+        float leading = run.font.fontDescription().computedSize() * m_lineHeight - (runAscent + runDescent);
+        runAscent += leading / 2;
+        runDescent += leading / 2;
+    }
+    ascent = std::max(ascent, runAscent);
+    descent = std::max(descent, runDescent);
+}
+
+float Paragraph::appendLine(size_t firstFragment, size_t endFragment, float width, float top)
+{
+    Line line;
+    line.top = top;
+    line.width = width;
+    line.firstPositionedRun = m_positionedRuns.size();
+
+    float ascent = 0;
+    float descent = 0;
+    if (firstFragment == endFragment) {
+        // Empty lines take their height from the run they are in, or from the
+        // last run if they follow a trailing newline.
+        if (firstFragment < m_fragments.size())
+            addRunMetrics(m_fragments[firstFragment].runIndex, ascent, descent);
+        else if (!m_runs.isEmpty())
+            addRunMetrics(m_runs.size() - 1, ascent, descent);
+    }
+
+    float x = 0;
+    for (size_t i = firstFragment; i < endFragment; ++i) {
+        const Fragment& fragment = m_fragments[i];
+        bool sameRun = m_positionedRuns.size() > line.firstPositionedRun
+            && m_positionedRuns.last().runIndex == fragment.runIndex;
+        if (!sameRun)
+            addRunMetrics(fragment.runIndex, ascent, descent);
+
+        if (fragment.contentEnd > fragment.start) {
+            if (sameRun) {
+                // Draw consecutive fragments of a run as one piece of text.
+                PositionedRun& positionedRun = m_positionedRuns.last();
+                positionedRun.end = fragment.contentEnd;
+                positionedRun.width = x + fragment.contentWidth - positionedRun.x;
+            } else {
+                PositionedRun positionedRun;
+                positionedRun.runIndex = fragment.runIndex;
+                positionedRun.start = fragment.start;
+                positionedRun.end = fragment.contentEnd;
+                positionedRun.x = x;
+                positionedRun.width = fragment.contentWidth;
+                m_positionedRuns.append(positionedRun);
+            }
+        }
+        x += fragment.contentWidth + fragment.spaceWidth;
+    }
+
+    line.baseline = top + ascent;
+    line.descent = descent;
+    line.positionedRunCount = m_positionedRuns.size() - line.firstPositionedRun;
+    m_lines.append(line);
+    return top + ascent + descent;
 }
 
 void Paragraph::layout()
 {
-    LayoutUnit maxWidth = std::max(m_minWidth, m_maxWidth);
-    LayoutUnit maxHeight = std::max(m_minHeight, m_maxHeight);
-    IntSize maxSize(maxWidth, maxHeight);
+    ensureFragments();
+    m_lines.clear();
+    m_positionedRuns.clear();
+
+    float availableWidth = width();
+    float top = 0;
+    size_t lineStart = 0;
+    size_t lineEnd = 0;
+    float lineContentWidth = 0;
+    // The width of the line including the whitespace after its last segment.
+    float lineAdvance = 0;
+
+    size_t fragmentCount = m_fragments.size();
+    for (size_t segmentStart = 0; segmentStart < fragmentCount;) {
+        size_t segmentEnd = segmentStart;
+        float contentWidth = 0;
+        float spaceWidth = 0;
+        while (segmentEnd < fragmentCount) {
+            const Fragment& fragment = m_fragments[segmentEnd++];
+            contentWidth += fragment.contentWidth;
+            spaceWidth += fragment.spaceWidth;
+            if (fragment.endsSegment)
+                break;
+        }
+
+        if (lineEnd > lineStart && lineAdvance + contentWidth > availableWidth) {
+            top = appendLine(lineStart, lineEnd, lineContentWidth, top);
+            lineStart = segmentStart;
+            lineAdvance = 0;
+        }
+
+        lineEnd = segmentEnd;
+        lineContentWidth = lineAdvance + contentWidth;
+        lineAdvance = lineContentWidth + spaceWidth;
+
+        if (m_fragments[segmentEnd - 1].endsWithHardBreak) {
+            top = appendLine(lineStart, lineEnd, lineContentWidth, top);
+            lineStart = lineEnd;
+            lineContentWidth = 0;
+            lineAdvance = 0;
+        }
+        segmentStart = segmentEnd;
+    }
+
+    bool endsWithHardBreak = fragmentCount && m_fragments.last().endsWithHardBreak;
+    if (lineEnd > lineStart || !fragmentCount || endsWithHardBreak)
+        top = appendLine(lineStart, lineEnd, lineContentWidth, top);
+
+    m_contentHeight = top;
+}
+
+void Paragraph::layoutAsync(PassOwnPtr<ParagraphLayoutCallback> callback)
+{
+    ParagraphLayoutQueue::shared().add(this, callback);
+}
 
-    m_renderView->setFrameViewSize(maxSize);
-    m_renderView->layout();
+float Paragraph::alignmentOffset(const Line& line) const
+{
+    float freeSpace = width() - line.width;
+    switch (m_align) {
+    case AlignRight:
+        return freeSpace;
+    case AlignCenter:
+        return freeSpace / 2;
+    default:
+        return 0;
+    }
 }
 
 void Paragraph::paint(Canvas* canvas, const Offset& offset)
 {
+    if (!canvas)
+        return;
+
+    GraphicsContext context(canvas->skCanvas());
+    for (const Line& line : m_lines) {
+        float lineX = offset.sk_size.width() + alignmentOffset(line);
+        float baseline = offset.sk_size.height() + line.baseline;
+        float height = line.baseline - line.top + line.descent;
+        for (unsigned i = 0; i < line.positionedRunCount; ++i) {
+            PositionedRun& positionedRun = m_positionedRuns[line.firstPositionedRun + i];
+            const ParagraphRun& run = m_runs[positionedRun.runIndex];
+
+            TextRun textRun(StringView(m_text.impl(), positionedRun.start, positionedRun.end - positionedRun.start));
+            TextRunPaintInfo paintInfo(textRun);
+            FloatPoint origin(lineX + positionedRun.x, baseline);
+            paintInfo.bounds = FloatRect(origin.x(), offset.sk_size.height() + line.top, positionedRun.width, height);
+            // Blobs are positioned relative to the origin they are drawn at,
+            // so they stay valid when the paragraph is painted elsewhere.
+            if (RuntimeEnabledFeatures::textBlobEnabled())
+                paintInfo.cachedTextBlob = &positionedRun.textBlob;
+
+            context.setFillColor(Color(run.color));
+            context.drawText(run.font, paintInfo, origin);
+        }
+    }
 }
 
 } // namespace blink
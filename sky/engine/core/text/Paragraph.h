@@ -5,20 +5,42 @@
 #ifndef SKY_ENGINE_CORE_TEXT_PARAGRAPH_H_
 #define SKY_ENGINE_CORE_TEXT_PARAGRAPH_H_
 
+#include "sky/engine/core/painting/Canvas.h"
+#include "sky/engine/core/painting/Offset.h"
+#include "sky/engine/core/text/ParagraphLayoutCallback.h"
+#include "sky/engine/platform/LayoutUnit.h"
+#include "sky/engine/platform/fonts/Font.h"
+#include "sky/engine/platform/fonts/TextBlob.h"
 #include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/wtf/PassOwnPtr.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefCounted.h"
-#include "sky/engine/core/painting/Canvas.h"
-#include "sky/engine/core/painting/Offset.h"
-#include "sky/engine/core/rendering/RenderView.h"
+#include "sky/engine/wtf/Vector.h"
+#include "sky/engine/wtf/text/WTFString.h"
+#include "third_party/skia/include/core/SkColor.h"
 
 namespace blink {
 
+// A range of the paragraph's text that is drawn with a single font and color.
+struct ParagraphRun {
+    ParagraphRun(unsigned start, unsigned end, const Font& font, SkColor color)
+        : start(start), end(end), font(font), color(color) { }
+
+    unsigned start;
+    unsigned end;
+    Font font;
+    SkColor color;
+};
+
+// Paragraph lays out its styled runs directly with the platform font code:
+// each run is shaped by its Font, lines are broken at the opportunities
+// reported by the line break iterator, and the result is a list of
+// positioned pieces of runs. There is no render tree behind a Paragraph.
 class Paragraph : public RefCounted<Paragraph>, public DartWrappable {
     DEFINE_WRAPPERTYPEINFO();
 public:
-    static PassRefPtr<Paragraph> create(PassOwnPtr<RenderView> renderView) {
-      return adoptRef(new Paragraph(renderView));
+    static PassRefPtr<Paragraph> create(const String& text, Vector<ParagraphRun>& runs, int align, double lineHeight) {
+      return adoptRef(new Paragraph(text, runs, align, lineHeight));
     }
 
     ~Paragraph() override;
@@ -43,19 +65,76 @@ public:
     double ideographicBaseline();
 
     void layout();
+    void layoutAsync(PassOwnPtr<ParagraphLayoutCallback> callback);
     void paint(Canvas* canvas, const Offset& offset);
 
-    RenderView* renderView() const { return m_renderView.get(); }
+    // DartWrappable:
+    size_t GetAllocationSize() override;
 
 private:
+    // The part of a run between two line break opportunities, or between a
+    // break opportunity and the edge of the run. [start, contentEnd) is drawn,
+    // [contentEnd, end) is the whitespace that can hang past the end of a
+    // line. The widths are measured once, so laying the paragraph out again
+    // at a different width does not shape its text again.
+    struct Fragment {
+        unsigned runIndex;
+        unsigned start;
+        unsigned contentEnd;
+        unsigned end;
+        float contentWidth;
+        float spaceWidth;
+        bool endsSegment;
+        bool endsWithHardBreak;
+    };
+
+    // The part of a run that ends up on one line, |x| pixels from the start of
+    // the line. Its glyphs are turned into a text blob the first time it is
+    // painted and the blob is replayed until the next layout.
+    struct PositionedRun {
+        unsigned runIndex;
+        unsigned start;
+        unsigned end;
+        float x;
+        float width;
+        TextBlobPtr textBlob;
+    };
+
+    struct Line {
+        float top;
+        float baseline;
+        float descent;
+        float width;
+        unsigned firstPositionedRun;
+        unsigned positionedRunCount;
+    };
+
+    Paragraph(const String& text, Vector<ParagraphRun>& runs, int align, double lineHeight);
+
+    float measure(const ParagraphRun& run, unsigned start, unsigned end) const;
+    void ensureFragments();
+    void addRunMetrics(size_t runIndex, float& ascent, float& descent) const;
+    float appendLine(size_t firstFragment, size_t endFragment, float width, float top);
+    float alignmentOffset(const Line& line) const;
+
     LayoutUnit m_minWidth;
     LayoutUnit m_maxWidth;
     LayoutUnit m_minHeight;
     LayoutUnit m_maxHeight;
 
-    explicit Paragraph(PassOwnPtr<RenderView> renderView);
+    String m_text;
+    Vector<ParagraphRun> m_runs;
+    int m_align;
+    double m_lineHeight;
+
+    bool m_fragmentsValid;
+    Vector<Fragment> m_fragments;
+    float m_minIntrinsicWidth;
+    float m_maxIntrinsicWidth;
 
-    OwnPtr<RenderView> m_renderView;
+    Vector<Line> m_lines;
+    Vector<PositionedRun> m_positionedRuns;
+    float m_contentHeight;
 };
 
 } // namespace blink
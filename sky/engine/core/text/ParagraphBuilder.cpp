@@ -4,52 +4,101 @@
 
 #include "sky/engine/core/text/ParagraphBuilder.h"
 
-#include "sky/engine/core/css/CSSFontSelector.h"
-#include "sky/engine/core/css/resolver/FontBuilder.h"
-#include "sky/engine/core/rendering/RenderParagraph.h"
-#include "sky/engine/core/rendering/RenderText.h"
-#include "sky/engine/core/rendering/style/RenderStyle.h"
+#include "sky/engine/platform/fonts/FontCacheKey.h"
+#include "sky/engine/platform/fonts/FontDescription.h"
+#include "sky/engine/platform/fonts/FontFaceCreationParams.h"
+#include "sky/engine/platform/fonts/FontFamily.h"
+#include "sky/engine/wtf/HashMap.h"
+#include "sky/engine/wtf/StdLibExtras.h"
 
 namespace blink {
 namespace {
 
-PassOwnPtr<RenderView> createRenderView()
+// Matches the "medium" font size keyword the render tree used to start from.
+const float kDefaultFontSize = 16;
+
+// Apps use a handful of distinct text styles, but create a new TextStyle for
+// every span. Resolved fonts are shared between spans with the same style so
+// that the fallback list and glyph pages are only built once per style. The
+// map is dropped when it fills up rather than tracking which fonts are still
+// in use.
+const size_t kMaxResolvedFonts = 64;
+
+typedef HashMap<FontCacheKey, Font, FontCacheKeyHash, FontCacheKeyTraits> ResolvedFontMap;
+
+ResolvedFontMap& resolvedFonts()
+{
+    DEFINE_STATIC_LOCAL(ResolvedFontMap, fonts, ());
+    return fonts;
+}
+
+// Text is drawn with the platform fonts directly, so there is no font
+// selector and the fallback list resolved for the default font can be shared
+// by every paragraph.
+Font createDefaultFont()
 {
-    RefPtr<RenderStyle> style = RenderStyle::create();
-    style->setRTLOrdering(LogicalOrder);
-    style->setZIndex(0);
-    style->setUserModify(READ_ONLY);
-
-    FontBuilder fontBuilder;
-    fontBuilder.initForStyleResolve(nullptr, style.get());
-    RefPtr<CSSFontSelector> selector = CSSFontSelector::create(nullptr);
-    fontBuilder.createFontForDocument(selector.release(), style.get());
-
-    OwnPtr<RenderView> renderView = adoptPtr(new RenderView(nullptr));
-    renderView->setStyle(style.release());
-    return renderView.release();
+    FontDescription description;
+    description.setGenericFamily(FontDescription::StandardFamily);
+    description.setSpecifiedSize(kDefaultFontSize);
+    description.setComputedSize(kDefaultFontSize);
+    Font font(description);
+    font.update(nullptr);
+    return font;
 }
 
-RenderParagraph* createRenderParagraph(RenderStyle* parentStyle)
+const Font& defaultFont()
 {
-    RefPtr<RenderStyle> style = RenderStyle::create();
-    style->inheritFrom(parentStyle);
-    style->setDisplay(PARAGRAPH);
+    DEFINE_STATIC_LOCAL(Font, font, (createDefaultFont()));
+    return font;
+}
 
-    RenderParagraph* renderParagraph = new RenderParagraph(nullptr);
-    renderParagraph->setStyle(style.release());
-    return renderParagraph;
+Font createFont(const Font& parent, TextStyle* style)
+{
+    FontDescription description = parent.fontDescription();
+    if (!style->fontFamily().isEmpty()) {
+        FontFamily family;
+        family.setFamily(AtomicString(style->fontFamily()));
+        description.setFamily(family);
+        description.setGenericFamily(FontDescription::NoFamily);
+    }
+    if (style->fontSize() > 0) {
+        description.setSpecifiedSize(style->fontSize());
+        description.setComputedSize(style->fontSize());
+        description.setIsAbsoluteSize(true);
+    }
+    description.setWeight(style->fontWeight());
+    description.setStyle(style->fontStyle());
+
+    if (description == parent.fontDescription())
+        return parent;
+
+    // Every description built here differs from the default one only in the
+    // properties that the cache key covers.
+    FontCacheKey key = description.cacheKey(FontFaceCreationParams(description.family().family()));
+    // Sizes that round to zero would collide with the map's empty value.
+    bool cacheable = description.effectiveFontSize() * FontCacheKey::precisionMultiplier() >= 1;
+    ResolvedFontMap& fonts = resolvedFonts();
+    if (cacheable) {
+        ResolvedFontMap::iterator it = fonts.find(key);
+        if (it != fonts.end())
+            return it->value;
+    }
+
+    Font font(description);
+    font.update(nullptr);
+    if (cacheable) {
+        if (fonts.size() >= kMaxResolvedFonts)
+            fonts.clear();
+        fonts.set(key, font);
+    }
+    return font;
 }
 
 }  // namespace
 
 ParagraphBuilder::ParagraphBuilder()
 {
-    m_renderView = createRenderView();
-    m_parentStyle = RenderStyle::clone(m_renderView->style());
-    m_renderParagraph = createRenderParagraph(m_parentStyle.get());
-    m_parentStyle = RenderStyle::clone(m_renderParagraph->style());
-    m_renderView->addChild(m_renderParagraph);
+    m_styleStack.append(InheritedStyle(defaultFont(), SK_ColorBLACK));
 }
 
 ParagraphBuilder::~ParagraphBuilder()
@@ -58,26 +107,49 @@ ParagraphBuilder::~ParagraphBuilder()
 
 void ParagraphBuilder::pushStyle(TextStyle* style)
 {
+    const InheritedStyle& parent = m_styleStack.last();
+    if (!style) {
+        m_styleStack.append(parent);
+        return;
+    }
+    m_styleStack.append(InheritedStyle(createFont(parent.font, style), style->color()));
 }
 
 void ParagraphBuilder::pop()
 {
+    // The default style at the bottom of the stack is never popped.
+    if (m_styleStack.size() > 1)
+        m_styleStack.removeLast();
 }
 
 void ParagraphBuilder::addText(const String& text)
 {
-    RenderText* renderText = new RenderText(nullptr, text.impl());
-    RefPtr<RenderStyle> style = RenderStyle::create();
-    style->inheritFrom(m_parentStyle.get());
-    renderText->setStyle(style.release());
-    m_renderParagraph->addChild(renderText);
+    if (text.isEmpty())
+        return;
+
+    unsigned start = m_text.length();
+    m_text.append(text);
+    unsigned end = m_text.length();
+
+    const InheritedStyle& style = m_styleStack.last();
+    if (!m_runs.isEmpty()) {
+        ParagraphRun& last = m_runs.last();
+        if (last.end == start && last.color == style.color && last.font == style.font) {
+            last.end = end;
+            return;
+        }
+    }
+    m_runs.append(ParagraphRun(start, end, style.font, style.color));
 }
 
 PassRefPtr<Paragraph> ParagraphBuilder::build(ParagraphStyle* style)
 {
-    m_parentStyle = nullptr;
-    m_renderParagraph = nullptr;
-    return Paragraph::create(m_renderView.release());
+    int align = style ? style->align() : 0;
+    double lineHeight = style ? style->lineHeight() : 0.0;
+    RefPtr<Paragraph> paragraph = Paragraph::create(m_text.toString(), m_runs, align, lineHeight);
+    m_text.clear();
+    m_runs.clear();
+    return paragraph.release();
 }
 
 } // namespace blink
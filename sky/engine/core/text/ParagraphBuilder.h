@@ -11,6 +11,8 @@
 #include "sky/engine/tonic/dart_wrappable.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefCounted.h"
+#include "sky/engine/wtf/Vector.h"
+#include "sky/engine/wtf/text/StringBuilder.h"
 
 namespace blink {
 
@@ -33,10 +35,16 @@ public:
 private:
     explicit ParagraphBuilder();
 
-    OwnPtr<RenderView> m_renderView;
+    struct InheritedStyle {
+        InheritedStyle(const Font& font, SkColor color) : font(font), color(color) { }
 
-    RefPtr<RenderStyle> m_parentStyle;
-    RenderParagraph* m_renderParagraph;
+        Font font;
+        SkColor color;
+    };
+
+    StringBuilder m_text;
+    Vector<ParagraphRun> m_runs;
+    Vector<InheritedStyle> m_styleStack;
 };
 
 } // namespace blink
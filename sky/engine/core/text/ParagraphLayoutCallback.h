@@ -0,0 +1,20 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_TEXT_PARAGRAPHLAYOUTCALLBACK_H_
+#define SKY_ENGINE_CORE_TEXT_PARAGRAPHLAYOUTCALLBACK_H_
+
+namespace blink {
+
+class Paragraph;
+
+class ParagraphLayoutCallback {
+public:
+    virtual ~ParagraphLayoutCallback() {}
+    virtual void handleEvent(Paragraph* result) = 0;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_TEXT_PARAGRAPHLAYOUTCALLBACK_H_
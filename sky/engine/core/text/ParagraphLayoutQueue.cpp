@@ -0,0 +1,77 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/core/text/ParagraphLayoutQueue.h"
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/time/time.h"
+#include "sky/engine/platform/TraceEvent.h"
+#include "sky/engine/wtf/StdLibExtras.h"
+
+namespace blink {
+namespace {
+
+// Long enough to lay out a few dozen typical paragraphs, short enough that a
+// frame waiting behind the task does not notice.
+const int64_t kTimeBudgetMicroseconds = 4000;
+
+} // namespace
+
+ParagraphLayoutQueue& ParagraphLayoutQueue::shared()
+{
+    DEFINE_STATIC_LOCAL(ParagraphLayoutQueue, queue, ());
+    return queue;
+}
+
+ParagraphLayoutQueue::ParagraphLayoutQueue()
+    : m_taskScheduled(false)
+{
+}
+
+ParagraphLayoutQueue::~ParagraphLayoutQueue()
+{
+}
+
+void ParagraphLayoutQueue::add(PassRefPtr<Paragraph> paragraph, PassOwnPtr<ParagraphLayoutCallback> callback)
+{
+    OwnPtr<PendingLayout> pending = adoptPtr(new PendingLayout);
+    pending->paragraph = paragraph;
+    pending->callback = callback;
+    m_pending.append(pending.release());
+    scheduleTask();
+}
+
+void ParagraphLayoutQueue::scheduleTask()
+{
+    if (m_taskScheduled)
+        return;
+    m_taskScheduled = true;
+    base::MessageLoop::current()->PostTask(FROM_HERE,
+        base::Bind(&ParagraphLayoutQueue::run, base::Unretained(this)));
+}
+
+void ParagraphLayoutQueue::run()
+{
+    TRACE_EVENT0("blink", "ParagraphLayoutQueue::run");
+    m_taskScheduled = false;
+
+    base::TimeTicks deadline = base::TimeTicks::Now()
+        + base::TimeDelta::FromMicroseconds(kTimeBudgetMicroseconds);
+    while (!m_pending.isEmpty()) {
+        OwnPtr<PendingLayout> pending = m_pending.takeFirst();
+        pending->paragraph->layout();
+        // The callback may queue more paragraphs, which this task picks up
+        // if it still has time.
+        if (pending->callback)
+            pending->callback->handleEvent(pending->paragraph.get());
+        if (base::TimeTicks::Now() >= deadline)
+            break;
+    }
+
+    if (!m_pending.isEmpty())
+        scheduleTask();
+}
+
+} // namespace blink
@@ -0,0 +1,48 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_TEXT_PARAGRAPHLAYOUTQUEUE_H_
+#define SKY_ENGINE_CORE_TEXT_PARAGRAPHLAYOUTQUEUE_H_
+
+#include "sky/engine/core/text/Paragraph.h"
+#include "sky/engine/core/text/ParagraphLayoutCallback.h"
+#include "sky/engine/wtf/Deque.h"
+#include "sky/engine/wtf/OwnPtr.h"
+#include "sky/engine/wtf/PassOwnPtr.h"
+#include "sky/engine/wtf/RefPtr.h"
+
+namespace blink {
+
+// Lays out paragraphs ahead of time without stalling the frame that asked
+// for them. Paragraphs are laid out in tasks of their own, each of which
+// stops once it has used up a small time budget, and every paragraph's
+// callback runs as soon as it is done.
+//
+// The work stays on the thread that queued it because Font, FontCache and
+// the shaper's run cache are not thread-safe.
+class ParagraphLayoutQueue {
+public:
+    static ParagraphLayoutQueue& shared();
+
+    void add(PassRefPtr<Paragraph> paragraph, PassOwnPtr<ParagraphLayoutCallback> callback);
+
+private:
+    struct PendingLayout {
+        RefPtr<Paragraph> paragraph;
+        OwnPtr<ParagraphLayoutCallback> callback;
+    };
+
+    ParagraphLayoutQueue();
+    ~ParagraphLayoutQueue();
+
+    void scheduleTask();
+    void run();
+
+    Deque<OwnPtr<PendingLayout>> m_pending;
+    bool m_taskScheduled;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_TEXT_PARAGRAPHLAYOUTQUEUE_H_
@@ -4,10 +4,27 @@
 
 #include "sky/engine/core/text/ParagraphStyle.h"
 
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/wtf/MainThread.h"
+
 namespace blink {
 
 ParagraphStyle::ParagraphStyle(int align, double lineHeight, int textBaseline)
+    : m_align(align)
+    , m_lineHeight(lineHeight)
+{
+}
+
+void* ParagraphStyle::operator new(size_t size)
+{
+    ASSERT(isMainThread());
+    return partitionAlloc(Partitions::getWrappablePartition(), size);
+}
+
+void ParagraphStyle::operator delete(void* ptr)
 {
+    ASSERT(isMainThread());
+    partitionFree(ptr);
 }
 
 ParagraphStyle::~ParagraphStyle()
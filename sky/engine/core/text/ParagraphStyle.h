@@ -22,8 +22,18 @@ public:
 
     ~ParagraphStyle() override;
 
+    // Allocated out of the wrappable partition.
+    void* operator new(size_t);
+    void operator delete(void*);
+
+    int align() const { return m_align; }
+    double lineHeight() const { return m_lineHeight; }
+
 private:
     explicit ParagraphStyle(int align, double lineHeight, int textBaseline);
+
+    int m_align;
+    double m_lineHeight;
 };
 
 } // namespace blink
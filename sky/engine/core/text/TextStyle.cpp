@@ -4,6 +4,9 @@
 
 #include "sky/engine/core/text/TextStyle.h"
 
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/wtf/MainThread.h"
+
 namespace blink {
 
 TextStyle::TextStyle(
@@ -15,7 +18,24 @@ TextStyle::TextStyle(
     const Vector<int>& decoration,
     SkColor decorationColor,
     int decorationStyle)
+    : m_color(color)
+    , m_fontFamily(fontFamily)
+    , m_fontSize(fontSize)
+    , m_fontWeight(fontWeight)
+    , m_fontStyle(fontStyle)
+{
+}
+
+void* TextStyle::operator new(size_t size)
+{
+    ASSERT(isMainThread());
+    return partitionAlloc(Partitions::getWrappablePartition(), size);
+}
+
+void TextStyle::operator delete(void* ptr)
 {
+    ASSERT(isMainThread());
+    partitionFree(ptr);
 }
 
 TextStyle::~TextStyle()
@@ -44,6 +44,16 @@ public:
 
     ~TextStyle() override;
 
+    // Allocated out of the wrappable partition.
+    void* operator new(size_t);
+    void operator delete(void*);
+
+    SkColor color() const { return m_color; }
+    const String& fontFamily() const { return m_fontFamily; }
+    double fontSize() const { return m_fontSize; }
+    FontWeight fontWeight() const { return static_cast<FontWeight>(m_fontWeight); }
+    FontStyle fontStyle() const { return static_cast<FontStyle>(m_fontStyle); }
+
 private:
     explicit TextStyle(
         SkColor color,
@@ -55,6 +65,12 @@ private:
         SkColor decorationColor,
         int decorationStyle
     );
+
+    SkColor m_color;
+    String m_fontFamily;
+    double m_fontSize;
+    int m_fontWeight;
+    int m_fontStyle;
 };
 
 } // namespace blink
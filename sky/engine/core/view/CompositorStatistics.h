@@ -0,0 +1,52 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_VIEW_COMPOSITORSTATISTICS_H_
+#define SKY_ENGINE_CORE_VIEW_COMPOSITORSTATISTICS_H_
+
+#include "sky/compositor/compositor_statistics.h"
+#include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefCounted.h"
+
+namespace blink {
+
+// A copy of the compositor's statistics as of the last frame the GPU thread
+// painted. It does not change once it has been handed to Dart.
+class CompositorStatistics final : public RefCounted<CompositorStatistics>, public DartWrappable {
+    DEFINE_WRAPPERTYPEINFO();
+public:
+    static PassRefPtr<CompositorStatistics> create(const sky::compositor::CompositorStatistics& statistics)
+    {
+        return adoptRef(new CompositorStatistics(statistics));
+    }
+
+    unsigned frameCount() const { return m_statistics.frame_count; }
+    double lastRasterTime() const { return m_statistics.last_raster_time.InMillisecondsF(); }
+    double rasterTimeP90() const { return m_statistics.raster_time_p90.InMillisecondsF(); }
+    unsigned missedRasterFrames() const { return m_statistics.missed_raster_frames; }
+    double buildTimeP90() const { return m_statistics.build_time_p90.InMillisecondsF(); }
+    double presentationLatencyP90() const { return m_statistics.presentation_latency_p90.InMillisecondsF(); }
+
+    unsigned rasterCacheHits() const { return m_statistics.raster_cache_hits; }
+    unsigned rasterCacheFills() const { return m_statistics.raster_cache_fills; }
+    unsigned rasterCacheEvictions() const { return m_statistics.raster_cache_evictions; }
+    double rasterCacheBytes() const { return m_statistics.raster_cache_bytes; }
+    double texturePoolBytes() const { return m_statistics.texture_pool_bytes; }
+    double gpuResourceBytes() const { return m_statistics.gpu_resource_bytes; }
+
+    unsigned layerCount() const { return m_statistics.layer_count; }
+
+private:
+    explicit CompositorStatistics(const sky::compositor::CompositorStatistics& statistics)
+        : m_statistics(statistics)
+    {
+    }
+
+    const sky::compositor::CompositorStatistics m_statistics;
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_CORE_VIEW_COMPOSITORSTATISTICS_H_
@@ -0,0 +1,18 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_VIEW_IDLECALLBACK_H_
+#define SKY_ENGINE_CORE_VIEW_IDLECALLBACK_H_
+
+namespace blink {
+
+class IdleCallback {
+public:
+    virtual ~IdleCallback() { }
+    virtual void handleEvent(double deadline) = 0;
+};
+
+}
+
+#endif  // SKY_ENGINE_CORE_VIEW_IDLECALLBACK_H_
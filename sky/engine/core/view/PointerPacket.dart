@@ -0,0 +1,61 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+part of dart.sky;
+
+/// Reads the pointers that a [PointerPacketCallback] receives as a single
+/// list of doubles.
+class PointerPacket {
+  PointerPacket(this._data);
+
+  final Float64List _data;
+
+  // Must match the layout written by View::handlePointerPacket in View.cpp.
+  static const int kTimeStamp = 0;
+  static const int kType = 1;
+  static const int kPointer = 2;
+  static const int kKind = 3;
+  static const int kX = 4;
+  static const int kY = 5;
+  static const int kButtons = 6;
+  static const int kPressure = 7;
+  static const int kPressureMin = 8;
+  static const int kPressureMax = 9;
+  static const int kDistance = 10;
+  static const int kDistanceMin = 11;
+  static const int kDistanceMax = 12;
+  static const int kRadiusMajor = 13;
+  static const int kRadiusMinor = 14;
+  static const int kRadiusMin = 15;
+  static const int kRadiusMax = 16;
+  static const int kOrientation = 17;
+  static const int kTilt = 18;
+  static const int kFieldCount = 19;
+
+  // Values of the kType field.
+  static const int kTypeDown = 0;
+  static const int kTypeUp = 1;
+  static const int kTypeMove = 2;
+  static const int kTypeCancel = 3;
+
+  // Values of the kKind field.
+  static const int kKindTouch = 0;
+  static const int kKindMouse = 1;
+  static const int kKindStylus = 2;
+
+  int get length => _data.length ~/ kFieldCount;
+
+  /// Returns [field] of the pointer at [index].
+  double get(int index, int field) => _data[index * kFieldCount + field];
+
+  String typeName(int index) {
+    switch (get(index, kType).toInt()) {
+      case kTypeDown: return 'pointerdown';
+      case kTypeUp: return 'pointerup';
+      case kTypeMove: return 'pointermove';
+      case kTypeCancel: return 'pointercancel';
+    }
+    return '';
+  }
+}
@@ -0,0 +1,20 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_CORE_VIEW_POINTERPACKETCALLBACK_H_
+#define SKY_ENGINE_CORE_VIEW_POINTERPACKETCALLBACK_H_
+
+#include "sky/engine/tonic/typed_list.h"
+
+namespace blink {
+
+class PointerPacketCallback {
+public:
+    virtual ~PointerPacketCallback() { }
+    virtual void handleEvent(Float64List packet) = 0;
+};
+
+}
+
+#endif  // SKY_ENGINE_CORE_VIEW_POINTERPACKETCALLBACK_H_
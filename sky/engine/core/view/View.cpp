@@ -4,15 +4,134 @@
 
 #include "sky/engine/core/view/View.h"
 
+#include "base/bind.h"
+#include "sky/compositor/layer_arena.h"
+#include "sky/compositor/picture_layer.h"
+#include "sky/engine/core/painting/Canvas.h"
+#include "sky/engine/core/painting/CanvasImage.h"
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/platform/TraceEvent.h"
+#include "third_party/skia/include/core/SkPictureRecorder.h"
+
+#include <cmath>
+
 namespace blink {
+namespace {
+
+// Keeps the Dart callback of a rasterizeScene call alive until the image
+// comes back from the GPU thread.
+class RasterizeSceneRequest : public RefCounted<RasterizeSceneRequest> {
+public:
+    explicit RasterizeSceneRequest(PassOwnPtr<ImageDecoderCallback> callback)
+        : m_callback(callback)
+    {
+    }
+
+    void complete(RefPtr<SkImage> image, scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner)
+    {
+        if (!image) {
+            m_callback->handleEvent(nullptr);
+            return;
+        }
+        RefPtr<CanvasImage> canvasImage = CanvasImage::create();
+        canvasImage->setImage(image.release(), imageTaskRunner);
+        m_callback->handleEvent(canvasImage.get());
+    }
+
+private:
+    OwnPtr<ImageDecoderCallback> m_callback;
+};
+
+void didRasterizeScene(RefPtr<RasterizeSceneRequest> request, RefPtr<SkImage> image, scoped_refptr<base::SingleThreadTaskRunner> imageTaskRunner)
+{
+    request->complete(image, imageTaskRunner);
+}
 
-PassRefPtr<View> View::create(const base::Closure& scheduleFrameCallback)
+// The images drawn by precacheGlyphs and uploadImage are only a side effect
+// of filling the GPU thread's caches and are dropped.
+void didFillCaches(RefPtr<SkImage>, scoped_refptr<base::SingleThreadTaskRunner>)
 {
-    return adoptRef(new View(scheduleFrameCallback));
 }
 
-View::View(const base::Closure& scheduleFrameCallback)
+scoped_ptr<sky::compositor::LayerTree> createPictureLayerTree(SkPicture* picture, const SkISize& size)
+{
+    std::shared_ptr<sky::compositor::LayerArena> arena = sky::compositor::LayerArena::Create();
+    auto layer = sky::compositor::MakeLayer<sky::compositor::PictureLayer>(arena);
+    layer->set_offset(SkPoint::Make(0, 0));
+    layer->set_picture(picture);
+    layer->set_paint_bounds(SkRect::Make(size));
+
+    scoped_ptr<sky::compositor::LayerTree> layerTree(new sky::compositor::LayerTree());
+    layerTree->set_root_layer(std::move(layer));
+    layerTree->set_arena(std::move(arena));
+    layerTree->set_frame_size(size);
+    return layerTree.Pass();
+}
+
+// The layout of a pointer in the list passed to the pointer packet callback.
+// Must match the constants in PointerPacket.dart.
+enum PointerPacketField {
+    PointerTimeStamp,
+    PointerType,
+    PointerId,
+    PointerKind,
+    PointerX,
+    PointerY,
+    PointerButtons,
+    PointerPressure,
+    PointerPressureMin,
+    PointerPressureMax,
+    PointerDistance,
+    PointerDistanceMin,
+    PointerDistanceMax,
+    PointerRadiusMajor,
+    PointerRadiusMinor,
+    PointerRadiusMin,
+    PointerRadiusMax,
+    PointerOrientation,
+    PointerTilt,
+    PointerFieldCount,
+};
+
+void packPointer(const WebPointerEvent& event, double* fields)
+{
+    fields[PointerTimeStamp] = event.timeStampMS;
+    fields[PointerType] = event.type - WebInputEvent::PointerTypeFirst;
+    fields[PointerId] = event.pointer;
+    fields[PointerKind] = event.kind;
+    fields[PointerX] = event.x;
+    fields[PointerY] = event.y;
+    fields[PointerButtons] = event.buttons;
+    fields[PointerPressure] = event.pressure;
+    fields[PointerPressureMin] = event.pressureMin;
+    fields[PointerPressureMax] = event.pressureMax;
+    fields[PointerDistance] = event.distance;
+    fields[PointerDistanceMin] = event.distanceMin;
+    fields[PointerDistanceMax] = event.distanceMax;
+    fields[PointerRadiusMajor] = event.radiusMajor;
+    fields[PointerRadiusMinor] = event.radiusMinor;
+    fields[PointerRadiusMin] = event.radiusMin;
+    fields[PointerRadiusMax] = event.radiusMax;
+    fields[PointerOrientation] = event.orientation;
+    fields[PointerTilt] = event.tilt;
+}
+
+} // namespace
+
+PassRefPtr<View> View::create(const base::Closure& scheduleFrameCallback,
+                              const RasterizeCallback& rasterizeCallback,
+                              const StatisticsCallback& statisticsCallback,
+                              const ScrollOffsetCallback& scrollOffsetCallback)
+{
+    return adoptRef(new View(scheduleFrameCallback, rasterizeCallback, statisticsCallback, scrollOffsetCallback));
+}
+
+View::View(const base::Closure& scheduleFrameCallback, const RasterizeCallback& rasterizeCallback, const StatisticsCallback& statisticsCallback, const ScrollOffsetCallback& scrollOffsetCallback)
     : m_scheduleFrameCallback(scheduleFrameCallback)
+    , m_rasterizeCallback(rasterizeCallback)
+    , m_statisticsCallback(statisticsCallback)
+    , m_scrollOffsetCallback(scrollOffsetCallback)
+    , m_frameDeadlineMS(0)
 {
 }
 
@@ -32,11 +151,101 @@ double View::height() const
     return h / m_displayMetrics.device_pixel_ratio;
 }
 
+void View::rasterizeScene(Scene* scene, int width, int height, PassOwnPtr<ImageDecoderCallback> callback)
+{
+    RefPtr<RasterizeSceneRequest> request = adoptRef(new RasterizeSceneRequest(callback));
+
+    std::unique_ptr<sky::compositor::LayerTree> layerTree;
+    if (scene && width > 0 && height > 0)
+        layerTree = scene->takeLayerTree();
+    if (!layerTree) {
+        request->complete(nullptr, nullptr);
+        return;
+    }
+
+    layerTree->set_frame_size(SkISize::Make(width, height));
+    m_rasterizeCallback.Run(make_scoped_ptr(layerTree.release()),
+        base::Bind(&didRasterizeScene, request));
+}
+
+void View::precacheGlyphs(Paragraph* paragraph)
+{
+    TRACE_EVENT0("blink", "View::precacheGlyphs");
+    if (!paragraph)
+        return;
+
+    LayoutUnit width = LayoutUnit::fromFloatCeil(paragraph->maxIntrinsicWidth());
+    paragraph->setMinWidth(width);
+    paragraph->setMaxWidth(width);
+    paragraph->layout();
+
+    // Glyphs are cached per device size, so draw them at the scale the
+    // frames are drawn at.
+    float scale = m_displayMetrics.device_pixel_ratio;
+    int pixelWidth = ceil(paragraph->width() * scale);
+    int pixelHeight = ceil(paragraph->height() * scale);
+    if (pixelWidth <= 0 || pixelHeight <= 0)
+        return;
+
+    SkRect bounds = SkRect::MakeIWH(pixelWidth, pixelHeight);
+    SkPictureRecorder recorder;
+    SkCanvas* skCanvas = recorder.beginRecording(bounds);
+    skCanvas->scale(scale, scale);
+    Offset offset;
+    offset.sk_size = SkSize::Make(0, 0);
+    offset.is_null = false;
+    paragraph->paint(Canvas::create(skCanvas).get(), offset);
+    RefPtr<SkPicture> picture = adoptRef(recorder.endRecording());
+    m_rasterizeCallback.Run(createPictureLayerTree(picture.get(), SkISize::Make(pixelWidth, pixelHeight)),
+                            base::Bind(&didFillCaches));
+}
+
+void View::uploadImage(CanvasImage* image)
+{
+    TRACE_EVENT0("blink", "View::uploadImage");
+    // Images on the GPU already have their texture. Atlased images are
+    // small, and their page is copied again whenever an image is added to
+    // it, so uploading it early would mostly be wasted.
+    if (!image || image->image_task_runner() || image->is_atlased())
+        return;
+
+    // Drawing a raster image uploads all of it into the GrContext's texture
+    // cache, where the frames that draw the image find it, however small it
+    // is drawn here.
+    SkISize size = SkISize::Make(1, 1);
+    SkPictureRecorder recorder;
+    SkCanvas* skCanvas = recorder.beginRecording(SkRect::Make(size));
+    skCanvas->drawImageRect(image->image(), SkRect::Make(size), nullptr);
+    RefPtr<SkPicture> picture = adoptRef(recorder.endRecording());
+    m_rasterizeCallback.Run(createPictureLayerTree(picture.get(), size), base::Bind(&didFillCaches));
+}
+
+PassRefPtr<CompositorStatistics> View::getCompositorStatistics()
+{
+    return CompositorStatistics::create(m_statisticsCallback.Run());
+}
+
+Float32List View::getScrollOffset(int scrollId)
+{
+    SkPoint offset;
+    if (scrollId < 0 || !m_scrollOffsetCallback.Run(scrollId, &offset))
+        return Float32List(Dart_NewTypedData(Dart_TypedData_kFloat32, 0));
+    Float32List result(Dart_NewTypedData(Dart_TypedData_kFloat32, 2));
+    result[0] = offset.x();
+    result[1] = offset.y();
+    return result;
+}
+
 void View::setEventCallback(PassOwnPtr<EventCallback> callback)
 {
     m_eventCallback = callback;
 }
 
+void View::setPointerPacketCallback(PassOwnPtr<PointerPacketCallback> callback)
+{
+    m_pointerPacketCallback = callback;
+}
+
 void View::setMetricsChangedCallback(PassOwnPtr<VoidCallback> callback)
 {
     m_metricsChangedCallback = callback;
@@ -47,6 +256,11 @@ void View::setFrameCallback(PassOwnPtr<FrameCallback> callback)
     m_frameCallback = callback;
 }
 
+void View::setIdleCallback(PassOwnPtr<IdleCallback> callback)
+{
+    m_idleCallback = callback;
+}
+
 void View::scheduleFrame()
 {
     m_scheduleFrameCallback.Run();
@@ -65,13 +279,49 @@ void View::handleInputEvent(PassRefPtr<Event> event)
         m_eventCallback->handleEvent(event.get());
 }
 
+void View::handlePointerPacket(const std::vector<WebPointerEvent>& events)
+{
+    TRACE_EVENT1("input", "View::handlePointerPacket", "count", events.size());
+    if (!m_pointerPacketCallback || events.empty())
+        return;
+
+    // Everything is written while the data is acquired, which means one
+    // crossing into Dart for the whole packet instead of one for each field
+    // of each pointer.
+    Float64List packet(Dart_NewTypedData(Dart_TypedData_kFloat64, events.size() * PointerFieldCount));
+    double* fields = &packet[0];
+    for (const WebPointerEvent& event : events) {
+        packPointer(event, fields);
+        fields += PointerFieldCount;
+    }
+    packet.Release();
+    m_pointerPacketCallback->handleEvent(std::move(packet));
+}
+
 std::unique_ptr<sky::compositor::LayerTree> View::beginFrame(
-    base::TimeTicks frameTime) {
+    base::TimeTicks frameTime, base::TimeTicks deadline) {
     if (!m_frameCallback)
         return nullptr;
+    // Without a prediction, assume the frame is due one 60Hz interval later.
+    if (deadline.is_null())
+        deadline = frameTime + base::TimeDelta::FromMicroseconds(16667);
     double frameTimeMS = (frameTime - base::TimeTicks()).InMillisecondsF();
+    m_frameDeadlineMS = (deadline - base::TimeTicks()).InMillisecondsF();
+    Partitions::AllocationCounts allocationsBefore;
+    Partitions::getAllocationCounts(allocationsBefore);
     m_frameCallback->handleEvent(frameTimeMS);
+    // Building a frame should not need the allocator at all once the app is
+    // in a steady state, so these are expected to trend to zero.
+    Partitions::traceAllocationsSince(allocationsBefore);
     return m_scene ? m_scene->takeLayerTree() : nullptr;
 }
 
+void View::notifyIdle(base::TimeTicks deadline)
+{
+    if (!m_idleCallback)
+        return;
+    double deadlineMS = (deadline - base::TimeTicks()).InMillisecondsF();
+    m_idleCallback->handleEvent(deadlineMS);
+}
+
 } // namespace blink
@@ -6,24 +6,46 @@
 #define SKY_ENGINE_CORE_VIEW_VIEW_H_
 
 #include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/single_thread_task_runner.h"
 #include "base/time/time.h"
 #include "sky/engine/core/compositing/Scene.h"
 #include "sky/engine/core/html/VoidCallback.h"
+#include "sky/engine/core/loader/ImageDecoderCallback.h"
+#include "sky/engine/core/painting/CanvasImage.h"
 #include "sky/engine/core/painting/Picture.h"
+#include "sky/engine/core/text/Paragraph.h"
+#include "sky/engine/core/view/CompositorStatistics.h"
 #include "sky/engine/core/view/EventCallback.h"
 #include "sky/engine/core/view/FrameCallback.h"
+#include "sky/engine/core/view/IdleCallback.h"
+#include "sky/engine/core/view/PointerPacketCallback.h"
+#include "sky/engine/public/platform/WebInputEvent.h"
 #include "sky/engine/public/platform/sky_display_metrics.h"
 #include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/tonic/typed_list.h"
 #include "sky/engine/wtf/PassRefPtr.h"
 #include "sky/engine/wtf/RefCounted.h"
 
+#include <vector>
+
 namespace blink {
 
 class View : public RefCounted<View>, public DartWrappable {
     DEFINE_WRAPPERTYPEINFO();
 public:
+    // Must match SkyViewClient::ImageCallback.
+    typedef base::Callback<void(RefPtr<SkImage>, scoped_refptr<base::SingleThreadTaskRunner>)> ImageCallback;
+    typedef base::Callback<void(scoped_ptr<sky::compositor::LayerTree>, const ImageCallback&)> RasterizeCallback;
+    typedef base::Callback<sky::compositor::CompositorStatistics()> StatisticsCallback;
+    typedef base::Callback<bool(uint32_t, SkPoint*)> ScrollOffsetCallback;
+
     ~View() override;
-    static PassRefPtr<View> create(const base::Closure& scheduleFrameCallback);
+    static PassRefPtr<View> create(const base::Closure& scheduleFrameCallback,
+                                   const RasterizeCallback& rasterizeCallback,
+                                   const StatisticsCallback& statisticsCallback,
+                                   const ScrollOffsetCallback& scrollOffsetCallback);
 
     double devicePixelRatio() const { return m_displayMetrics.device_pixel_ratio; }
 
@@ -38,27 +60,52 @@ public:
     Scene* scene() const { return m_scene.get(); }
     void setScene(Scene* scene) { m_scene = scene; }
 
+    void rasterizeScene(Scene* scene, int width, int height, PassOwnPtr<ImageDecoderCallback> callback);
+    void precacheGlyphs(Paragraph* paragraph);
+    void uploadImage(CanvasImage* image);
+
+    PassRefPtr<CompositorStatistics> getCompositorStatistics();
+    Float32List getScrollOffset(int scrollId);
+
     void setEventCallback(PassOwnPtr<EventCallback> callback);
 
+    void setPointerPacketCallback(PassOwnPtr<PointerPacketCallback> callback);
+    bool hasPointerPacketCallback() const { return m_pointerPacketCallback; }
+
     void setMetricsChangedCallback(PassOwnPtr<VoidCallback> callback);
 
     void setFrameCallback(PassOwnPtr<FrameCallback> callback);
     void scheduleFrame();
 
+    // The time by which the frame being built should be on screen, in the
+    // same timebase as the time passed to the frame callback.
+    double frameDeadline() const { return m_frameDeadlineMS; }
+
+    void setIdleCallback(PassOwnPtr<IdleCallback> callback);
+
     void setDisplayMetrics(const SkyDisplayMetrics& metrics);
     void handleInputEvent(PassRefPtr<Event> event);
+    // Must be called in an API scope of the view's isolate.
+    void handlePointerPacket(const std::vector<WebPointerEvent>& events);
     std::unique_ptr<sky::compositor::LayerTree> beginFrame(
-        base::TimeTicks frameTime);
+        base::TimeTicks frameTime, base::TimeTicks deadline);
+    void notifyIdle(base::TimeTicks deadline);
 
 private:
-    explicit View(const base::Closure& scheduleFrameCallback);
+    View(const base::Closure& scheduleFrameCallback, const RasterizeCallback& rasterizeCallback, const StatisticsCallback& statisticsCallback, const ScrollOffsetCallback& scrollOffsetCallback);
 
     base::Closure m_scheduleFrameCallback;
+    RasterizeCallback m_rasterizeCallback;
+    StatisticsCallback m_statisticsCallback;
+    ScrollOffsetCallback m_scrollOffsetCallback;
     SkyDisplayMetrics m_displayMetrics;
     OwnPtr<EventCallback> m_eventCallback;
+    OwnPtr<PointerPacketCallback> m_pointerPacketCallback;
     OwnPtr<VoidCallback> m_metricsChangedCallback;
     OwnPtr<FrameCallback> m_frameCallback;
+    OwnPtr<IdleCallback> m_idleCallback;
     RefPtr<Scene> m_scene;
+    double m_frameDeadlineMS;
 };
 
 } // namespace blink
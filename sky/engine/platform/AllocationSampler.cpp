@@ -0,0 +1,73 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/platform/AllocationSampler.h"
+
+#include <stdio.h>
+
+#include "base/atomicops.h"
+#include "base/debug/stack_trace.h"
+#include "sky/engine/platform/TraceEvent.h"
+#include "sky/engine/wtf/Assertions.h"
+#include "sky/engine/wtf/PartitionAlloc.h"
+
+namespace blink {
+
+namespace {
+
+const size_t kMaxFrames = 32;
+
+base::subtle::AtomicWord s_sampleIntervalBytes = 0;
+base::subtle::AtomicWord s_bytesUntilSample = 0;
+
+void recordSample(size_t size)
+{
+    base::debug::StackTrace stackTrace;
+    size_t frameCount = 0;
+    const void* const* frames = stackTrace.Addresses(&frameCount);
+
+    // The partition's lock may be held here, so the stack is formatted on
+    // the stack rather than in a String. The first frames are the sampler's.
+    char stack[kMaxFrames * (2 + 2 * sizeof(void*) + 1) + 1];
+    char* end = stack;
+    *end = '\0';
+    for (size_t i = 2; i < frameCount && i < kMaxFrames + 2; ++i)
+        end += snprintf(end, stack + sizeof(stack) - end, "%p ", frames[i]);
+
+    TRACE_EVENT_INSTANT2("sky", "AllocationSample", TRACE_EVENT_SCOPE_THREAD,
+        "size", size, "stack", TRACE_STR_COPY(stack));
+}
+
+void sampleAllocation(void*, size_t size)
+{
+    base::subtle::AtomicWord left = base::subtle::NoBarrier_AtomicIncrement(
+        &s_bytesUntilSample, -static_cast<base::subtle::AtomicWord>(size));
+    if (left > 0)
+        return;
+    base::subtle::AtomicWord interval = base::subtle::NoBarrier_Load(&s_sampleIntervalBytes);
+    if (!interval)
+        return;
+    // Threads that cross zero together may each record a sample, which is
+    // close enough for profiling.
+    base::subtle::NoBarrier_Store(&s_bytesUntilSample, interval);
+    recordSample(size);
+}
+
+} // namespace
+
+void AllocationSampler::start(size_t sampleIntervalBytes)
+{
+    ASSERT(sampleIntervalBytes);
+    base::subtle::NoBarrier_Store(&s_sampleIntervalBytes, sampleIntervalBytes);
+    base::subtle::NoBarrier_Store(&s_bytesUntilSample, sampleIntervalBytes);
+    partitionAllocSetHook(sampleAllocation);
+}
+
+void AllocationSampler::stop()
+{
+    partitionAllocSetHook(0);
+    base::subtle::NoBarrier_Store(&s_sampleIntervalBytes, 0);
+}
+
+} // namespace blink
@@ -0,0 +1,27 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_PLATFORM_ALLOCATIONSAMPLER_H_
+#define SKY_ENGINE_PLATFORM_ALLOCATIONSAMPLER_H_
+
+#include <stddef.h>
+
+#include "sky/engine/platform/PlatformExport.h"
+
+namespace blink {
+
+// Records the call stack of about one allocation in every
+// |sampleIntervalBytes| bytes allocated from the partitions and fastMalloc,
+// as "AllocationSample" events in the trace. The stacks are raw return
+// addresses, to be symbolized offline. This slows every allocation down, so
+// it is only for profiling runs.
+class PLATFORM_EXPORT AllocationSampler {
+public:
+    static void start(size_t sampleIntervalBytes);
+    static void stop();
+};
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_PLATFORM_ALLOCATIONSAMPLER_H_
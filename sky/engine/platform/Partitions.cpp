@@ -30,15 +30,23 @@
 
 #include "sky/engine/platform/Partitions.h"
 
+#include "sky/engine/platform/TraceEvent.h"
+#include "sky/engine/wtf/FastMalloc.h"
+#include "sky/engine/wtf/WTF.h"
+
 namespace blink {
 
 SizeSpecificPartitionAllocator<3072> Partitions::m_objectModelAllocator;
 SizeSpecificPartitionAllocator<1024> Partitions::m_renderingAllocator;
+SizeSpecificPartitionAllocator<1024> Partitions::m_lineLayoutAllocator;
+SizeSpecificPartitionAllocator<256> Partitions::m_wrappableAllocator;
 
 void Partitions::init()
 {
     m_objectModelAllocator.init();
     m_renderingAllocator.init();
+    m_lineLayoutAllocator.init();
+    m_wrappableAllocator.init();
 }
 
 void Partitions::shutdown()
@@ -46,8 +54,59 @@ void Partitions::shutdown()
     // We could ASSERT here for a memory leak within the partition, but it leads
     // to very hard to diagnose ASSERTs, so it's best to leave leak checking for
     // the valgrind and heapcheck bots, which run without partitions.
+    (void) m_wrappableAllocator.shutdown();
+    (void) m_lineLayoutAllocator.shutdown();
     (void) m_renderingAllocator.shutdown();
     (void) m_objectModelAllocator.shutdown();
 }
 
+static void getPartitionCounts(const PartitionRoot* root, Partitions::AllocationCounts& counts, Partitions::AllocationPartition partition)
+{
+    counts.allocations[partition] = root->totalAllocations;
+    counts.bytes[partition] = root->totalAllocatedBytes;
+}
+
+void Partitions::getAllocationCounts(AllocationCounts& counts)
+{
+    getPartitionCounts(m_objectModelAllocator.root(), counts, ObjectModelAllocations);
+    getPartitionCounts(m_renderingAllocator.root(), counts, RenderingAllocations);
+    getPartitionCounts(m_lineLayoutAllocator.root(), counts, LineLayoutAllocations);
+    getPartitionCounts(m_wrappableAllocator.root(), counts, WrappableAllocations);
+    counts.allocations[BufferAllocations] = WTF::Partitions::bufferAllocationCount();
+    counts.bytes[BufferAllocations] = WTF::Partitions::bufferAllocatedBytes();
+    counts.allocations[FastMallocAllocations] = WTF::fastMallocAllocationCount();
+    counts.bytes[FastMallocAllocations] = WTF::fastMallocAllocatedBytes();
+}
+
+void Partitions::traceAllocationsSince(const AllocationCounts& start)
+{
+    // Trace events keep the pointer to their name, so these must be literals.
+    static const char* const kCounterNames[AllocationPartitionCount] = {
+        "Allocations.ObjectModel",
+        "Allocations.Rendering",
+        "Allocations.LineLayout",
+        "Allocations.Wrappable",
+        "Allocations.Buffer",
+        "Allocations.FastMalloc",
+    };
+
+    bool enabled;
+    TRACE_EVENT_CATEGORY_GROUP_ENABLED("sky", &enabled);
+    if (!enabled)
+        return;
+
+    AllocationCounts now;
+    getAllocationCounts(now);
+    size_t totalAllocations = 0;
+    size_t totalBytes = 0;
+    for (int i = 0; i < AllocationPartitionCount; ++i) {
+        size_t allocations = now.allocations[i] - start.allocations[i];
+        size_t bytes = now.bytes[i] - start.bytes[i];
+        TRACE_COUNTER2("sky", kCounterNames[i], "count", allocations, "bytes", bytes);
+        totalAllocations += allocations;
+        totalBytes += bytes;
+    }
+    TRACE_COUNTER2("sky", "Allocations", "count", totalAllocations, "bytes", totalBytes);
+}
+
 } // namespace blink
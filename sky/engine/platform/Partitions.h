@@ -43,15 +43,49 @@ public:
 
     ALWAYS_INLINE static PartitionRoot* getObjectModelPartition() { return m_objectModelAllocator.root(); }
     ALWAYS_INLINE static PartitionRoot* getRenderingPartition() { return m_renderingAllocator.root(); }
+    // Line boxes and bidi runs are thrown away and rebuilt every time a
+    // paragraph is laid out. Keeping them apart from render objects and
+    // layers keeps that churn from leaving holes in the pages long-lived
+    // renderers sit in.
+    ALWAYS_INLINE static PartitionRoot* getLineLayoutPartition() { return m_lineLayoutAllocator.root(); }
+    // For the small objects that scripts create and drop every frame, like
+    // pictures and paths, so that they do not each go through malloc.
+    ALWAYS_INLINE static PartitionRoot* getWrappablePartition() { return m_wrappableAllocator.root(); }
 
     static size_t currentDOMMemoryUsage()
     {
         return m_objectModelAllocator.root()->totalSizeOfCommittedPages;
     }
 
+    enum AllocationPartition {
+        ObjectModelAllocations,
+        RenderingAllocations,
+        LineLayoutAllocations,
+        WrappableAllocations,
+        BufferAllocations,
+        FastMallocAllocations,
+        AllocationPartitionCount
+    };
+
+    struct AllocationCounts {
+        size_t allocations[AllocationPartitionCount];
+        size_t bytes[AllocationPartitionCount];
+    };
+
+    // Allocations made so far from these partitions, WTF's buffer partition
+    // and fastMalloc, for counting the allocations a frame makes. Other
+    // threads' allocations are counted too and may be read slightly late.
+    static void getAllocationCounts(AllocationCounts&);
+
+    // Adds the allocations made since |start| to the trace, as one counter
+    // for all the partitions together and one for each of them.
+    static void traceAllocationsSince(const AllocationCounts& start);
+
 private:
     static SizeSpecificPartitionAllocator<3072> m_objectModelAllocator;
     static SizeSpecificPartitionAllocator<1024> m_renderingAllocator;
+    static SizeSpecificPartitionAllocator<1024> m_lineLayoutAllocator;
+    static SizeSpecificPartitionAllocator<256> m_wrappableAllocator;
 };
 
 } // namespace blink
@@ -30,6 +30,8 @@
 
 #include "sky/engine/public/platform/Platform.h"
 
+#include "base/threading/worker_pool.h"
+
 namespace blink {
 
 static Platform* s_platform = 0;
@@ -49,4 +51,9 @@ Platform* Platform::current()
     return s_platform;
 }
 
+base::TaskRunner* Platform::workerTaskRunner(WorkerTaskPriority)
+{
+    return base::WorkerPool::GetTaskRunner(true).get();
+}
+
 } // namespace blink
@@ -40,6 +40,8 @@
 #include "sky/engine/platform/fonts/FontFallbackList.h"
 #include "sky/engine/platform/fonts/FontPlatformData.h"
 #include "sky/engine/platform/fonts/FontSmoothingMode.h"
+#include "sky/engine/platform/fonts/GlyphPageTreeNode.h"
+#include "sky/engine/platform/fonts/SimpleFontData.h"
 #include "sky/engine/platform/fonts/TextRenderingMode.h"
 #include "sky/engine/platform/fonts/opentype/OpenTypeVerticalData.h"
 #include "sky/engine/wtf/HashMap.h"
@@ -151,6 +153,87 @@ PassRefPtr<SimpleFontData> FontCache::fontDataFromFontPlatformData(const FontPla
     return gFontDataCache->get(platformData, shouldRetain);
 }
 
+// The font the platform fell back to for a glyph page of a font description.
+struct FallbackFontKey {
+    FallbackFontKey()
+        : m_pageNumber(0) { }
+    FallbackFontKey(const FontCacheKey& fontKey, const String& locale, unsigned pageNumber)
+        : m_fontKey(fontKey)
+        , m_locale(locale)
+        , m_pageNumber(pageNumber) { }
+    FallbackFontKey(WTF::HashTableDeletedValueType)
+        : m_fontKey(WTF::HashTableDeletedValue)
+        , m_pageNumber(0) { }
+
+    unsigned hash() const
+    {
+        unsigned hashCodes[3] = {
+            m_fontKey.hash(),
+            m_locale.isNull() ? 0 : m_locale.impl()->hash(),
+            m_pageNumber
+        };
+        return StringHasher::hashMemory<sizeof(hashCodes)>(hashCodes);
+    }
+
+    bool operator==(const FallbackFontKey& other) const
+    {
+        return m_fontKey == other.m_fontKey
+            && m_locale == other.m_locale
+            && m_pageNumber == other.m_pageNumber;
+    }
+
+    bool isHashTableDeletedValue() const
+    {
+        return m_fontKey.isHashTableDeletedValue();
+    }
+
+private:
+    FontCacheKey m_fontKey;
+    String m_locale;
+    unsigned m_pageNumber;
+};
+
+struct FallbackFontKeyHash {
+    static unsigned hash(const FallbackFontKey& key) { return key.hash(); }
+    static bool equal(const FallbackFontKey& a, const FallbackFontKey& b) { return a == b; }
+    static const bool safeToCompareToEmptyOrDeleted = true;
+};
+
+typedef HashMap<FallbackFontKey, OwnPtr<FontPlatformData>, FallbackFontKeyHash, WTF::SimpleClassHashTraits<FallbackFontKey> > FallbackFontCache;
+
+// Text that falls back mostly does so for a handful of scripts, so the cache
+// is simply emptied once it grows past this.
+static const unsigned maxFallbackFontCacheSize = 256;
+
+static FallbackFontCache* gFallbackFontCache = 0;
+
+PassRefPtr<SimpleFontData> FontCache::fallbackFontForCharacter(const FontDescription& fontDescription, UChar32 c, const SimpleFontData* fontDataToSubstitute)
+{
+    if (!gFallbackFontCache)
+        gFallbackFontCache = new FallbackFontCache;
+
+    unsigned pageNumber = c >> GlyphPage::sizeBits;
+    FallbackFontKey key(fontDescription.cacheKey(FontFaceCreationParams(fontDescription.family().family())), fontDescription.locale(), pageNumber);
+    FallbackFontCache::iterator it = gFallbackFontCache->find(key);
+    if (it != gFallbackFontCache->end()) {
+        // The glyph page of the font is what tells whether it has the
+        // character, and the caller looks it up next anyway.
+        RefPtr<SimpleFontData> fontData = fontDataFromFontPlatformData(it->value.get(), DoNotRetain);
+        GlyphPage* page = GlyphPageTreeNode::getRootChild(fontData.get(), pageNumber)->page();
+        if (page && page->glyphForCharacter(c))
+            return fontData.release();
+    }
+
+    RefPtr<SimpleFontData> fontData = platformFallbackFontForCharacter(fontDescription, c, fontDataToSubstitute);
+    if (!fontData || fontData->isCustomFont())
+        return fontData.release();
+
+    if (gFallbackFontCache->size() >= maxFallbackFontCacheSize)
+        gFallbackFontCache->clear();
+    gFallbackFontCache->set(key, adoptPtr(new FontPlatformData(fontData->platformData())));
+    return fontData.release();
+}
+
 bool FontCache::isPlatformFontAvailable(const FontDescription& fontDescription, const AtomicString& family)
 {
     bool checkingAlternateName = true;
@@ -216,6 +299,9 @@ void FontCache::purge(PurgeSeverity PurgeSeverity)
     if (m_purgePreventCount)
         return;
 
+    if (PurgeSeverity == ForcePurge && gFallbackFontCache)
+        gFallbackFontCache->clear();
+
     if (!gFontDataCache || !gFontDataCache->purge(PurgeSeverity))
         return;
 
@@ -223,6 +309,15 @@ void FontCache::purge(PurgeSeverity PurgeSeverity)
     purgeFontVerticalDataCache();
 }
 
+FontCache::Statistics FontCache::statistics() const
+{
+    Statistics statistics;
+    statistics.platformDataCount = gFontPlatformDataCache ? gFontPlatformDataCache->size() : 0;
+    statistics.fontDataCount = gFontDataCache ? gFontDataCache->size() : 0;
+    statistics.inactiveFontDataCount = gFontDataCache ? gFontDataCache->inactiveSize() : 0;
+    return statistics;
+}
+
 static bool invalidateFontCache = false;
 
 HashSet<RawPtr<FontCacheClient> >& fontCacheClients()
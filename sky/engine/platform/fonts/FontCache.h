@@ -59,6 +59,8 @@ class SimpleFontData;
 enum ShouldRetain { Retain, DoNotRetain };
 enum PurgeSeverity { PurgeIfNeeded, ForcePurge };
 
+// There is a single FontCache per process, shared by every view. Like the
+// SimpleFontData it hands out, it must only be used on the main thread.
 class PLATFORM_EXPORT FontCache {
     friend class FontCachePurgePreventer;
 
@@ -66,10 +68,25 @@ class PLATFORM_EXPORT FontCache {
 public:
     static FontCache* fontCache();
 
+    struct Statistics {
+        size_t platformDataCount;
+        size_t fontDataCount;
+        size_t inactiveFontDataCount;
+    };
+    Statistics statistics() const;
+
+    // PurgeIfNeeded trims the font data no Font refers to down to a small
+    // working set, ForcePurge drops all of it. The platform data and vertical
+    // metrics only those font data used go with them. Must not be forced
+    // while a FontCachePurgePreventer is alive.
+    void purge(PurgeSeverity = PurgeIfNeeded);
+
     void releaseFontData(const SimpleFontData*);
 
-    // This method is implemented by the plaform and used by
-    // FontFastPath to lookup the font for a given character.
+    // Used by FontFastPath to lookup the font for a given character. The font
+    // the platform falls back to is remembered for the glyph page of the
+    // character, and is given out again for characters of that page it has
+    // glyphs for.
     PassRefPtr<SimpleFontData> fallbackFontForCharacter(const FontDescription&, UChar32, const SimpleFontData* fontDataToSubstitute);
 
     // Also implemented by the platform.
@@ -111,8 +128,6 @@ private:
     FontCache();
     ~FontCache();
 
-    void purge(PurgeSeverity = PurgeIfNeeded);
-
     void disablePurging() { m_purgePreventCount++; }
     void enablePurging()
     {
@@ -130,6 +145,9 @@ private:
     // Implemented on skia platforms.
     PassRefPtr<SkTypeface> createTypeface(const FontDescription&, const FontFaceCreationParams&, CString& name);
 
+    // Implemented by each platform.
+    PassRefPtr<SimpleFontData> platformFallbackFontForCharacter(const FontDescription&, UChar32, const SimpleFontData* fontDataToSubstitute);
+
     PassRefPtr<SimpleFontData> fontDataFromFontPlatformData(const FontPlatformData*, ShouldRetain = Retain);
     PassRefPtr<SimpleFontData> fallbackOnStandardFontStyle(const FontDescription&, UChar32);
 
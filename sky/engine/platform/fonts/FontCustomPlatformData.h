@@ -50,7 +50,15 @@ class SharedBuffer;
 class PLATFORM_EXPORT FontCustomPlatformData {
     WTF_MAKE_NONCOPYABLE(FontCustomPlatformData);
 public:
-    static PassOwnPtr<FontCustomPlatformData> create(SharedBuffer*);
+    enum FontDataOrigin {
+        // Fonts from the network or the app go through OTS.
+        UntrustedFontData,
+        // Fonts that ship with the engine are TrueType or OpenType fonts that
+        // are known to be well formed, so they skip OTS.
+        TrustedFontData,
+    };
+
+    static PassOwnPtr<FontCustomPlatformData> create(SharedBuffer*, FontDataOrigin = UntrustedFontData);
     ~FontCustomPlatformData();
 
     FontPlatformData fontPlatformData(float size, bool bold, bool italic, FontOrientation = Horizontal, FontWidthVariant = RegularWidth);
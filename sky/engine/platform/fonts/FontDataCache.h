@@ -86,6 +86,11 @@ public:
     // Returns true if any removal of cache items actually occurred.
     bool purge(PurgeSeverity);
 
+    // The number of font data in the cache, and how many of those no Font
+    // refers to any more.
+    size_t size() const { return m_cache.size(); }
+    size_t inactiveSize() const { return m_inactiveFontData.size(); }
+
 private:
     bool purgeLeastRecentlyUsed(int count);
 
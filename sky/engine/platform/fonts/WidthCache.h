@@ -33,6 +33,8 @@
 #include "sky/engine/wtf/HashSet.h"
 #include "sky/engine/wtf/HashTableDeletedValueType.h"
 #include "sky/engine/wtf/StringHasher.h"
+#include "sky/engine/wtf/text/StringHash.h"
+#include "sky/engine/wtf/text/WTFString.h"
 
 namespace blink {
 
@@ -121,16 +123,50 @@ private:
 
     friend bool operator==(const SmallStringKey&, const SmallStringKey&);
 
+    // Longer runs, such as whole labels, are keyed by a String instead. The
+    // translator looks them up straight from the run's characters, so only
+    // runs that are added to the cache allocate a key.
+    struct LongStringTranslator {
+        static unsigned hash(const TextRun& run)
+        {
+            if (run.is8Bit())
+                return StringHasher::computeHashAndMaskTop8Bits(run.characters8(), run.length());
+            return StringHasher::computeHashAndMaskTop8Bits(run.characters16(), run.length());
+        }
+
+        static bool equal(const String& key, const TextRun& run)
+        {
+            if (key.length() != static_cast<unsigned>(run.length()))
+                return false;
+            if (run.is8Bit())
+                return WTF::equal(key.impl(), run.characters8(), run.length());
+            return WTF::equal(key.impl(), run.characters16(), run.length());
+        }
+
+        static void translate(String& key, const TextRun& run, unsigned)
+        {
+            if (run.is8Bit())
+                key = String(run.characters8(), run.length());
+            else
+                key = String(run.characters16(), run.length());
+        }
+    };
+
 public:
     WidthCache()
         : m_interval(s_maxInterval)
         , m_countdown(m_interval)
+        , m_hitCount(0)
+        , m_missCount(0)
     {
     }
 
+    // Runs longer than this are measured every time.
+    static unsigned maxLength() { return s_maxLength; }
+
     WidthCacheEntry* add(const TextRun& run, WidthCacheEntry entry)
     {
-        if (static_cast<unsigned>(run.length()) > SmallStringKey::capacity())
+        if (static_cast<unsigned>(run.length()) > s_maxLength)
             return 0;
 
         if (m_countdown > 0) {
@@ -145,8 +181,14 @@ public:
     {
         m_singleCharMap.clear();
         m_map.clear();
+        m_longStringMap.clear();
     }
 
+    // Lookups that were sampled, for measuring how well the cache works for
+    // a given font. Lookups skipped by sampling are not counted.
+    unsigned hitCount() const { return m_hitCount; }
+    unsigned missCount() const { return m_missCount; }
+
 private:
     WidthCacheEntry* addSlowCase(const TextRun& run, WidthCacheEntry entry)
     {
@@ -157,6 +199,10 @@ private:
             SingleCharMap::AddResult addResult = m_singleCharMap.add(run[0], entry);
             isNewEntry = addResult.isNewEntry;
             value = &addResult.storedValue->value;
+        } else if (static_cast<unsigned>(length) > SmallStringKey::capacity()) {
+            LongStringMap::AddResult addResult = m_longStringMap.add<LongStringTranslator>(run, entry);
+            isNewEntry = addResult.isNewEntry;
+            value = &addResult.storedValue->value;
         } else {
             SmallStringKey smallStringKey;
             if (run.is8Bit())
@@ -171,34 +217,41 @@ private:
 
         // Cache hit: ramp up by sampling the next few words.
         if (!isNewEntry) {
+            ++m_hitCount;
             m_interval = s_minInterval;
             return value;
         }
+        ++m_missCount;
 
         // Cache miss: ramp down by increasing our sampling interval.
         if (m_interval < s_maxInterval)
             ++m_interval;
         m_countdown = m_interval;
 
-        if ((m_singleCharMap.size() + m_map.size()) < s_maxSize)
+        if ((m_singleCharMap.size() + m_map.size()) < s_maxSize && m_longStringMap.size() < s_maxLongStringCount)
             return value;
 
         // No need to be fancy: we're just trying to avoid pathological growth.
-        m_singleCharMap.clear();
-        m_map.clear();
+        clear();
         return 0;
     }
 
     typedef HashMap<SmallStringKey, WidthCacheEntry, SmallStringKeyHash, SmallStringKeyHashTraits> Map;
     typedef HashMap<uint32_t, WidthCacheEntry, DefaultHash<uint32_t>::Hash, WTF::UnsignedWithZeroKeyHashTraits<uint32_t> > SingleCharMap;
+    typedef HashMap<String, WidthCacheEntry> LongStringMap;
     static const int s_minInterval = -3; // A cache hit pays for about 3 cache misses.
     static const int s_maxInterval = 20; // Sampling at this interval has almost no overhead.
     static const unsigned s_maxSize = 500000; // Just enough to guard against pathological growth.
+    static const unsigned s_maxLength = 128; // Long enough for a label, short enough that a miss is cheap to store.
+    static const unsigned s_maxLongStringCount = 10000; // Long keys are heap allocated, so they get a tighter bound.
 
     int m_interval;
     int m_countdown;
+    unsigned m_hitCount;
+    unsigned m_missCount;
     SingleCharMap m_singleCharMap;
     Map m_map;
+    LongStringMap m_longStringMap;
 };
 
 inline bool operator==(const WidthCache::SmallStringKey& a, const WidthCache::SmallStringKey& b)
@@ -60,7 +60,7 @@ static AtomicString getFamilyNameForCharacter(UChar32 c, const FontDescription&
     return skiaFamilyName.c_str();
 }
 
-PassRefPtr<SimpleFontData> FontCache::fallbackFontForCharacter(const FontDescription& fontDescription, UChar32 c, const SimpleFontData*)
+PassRefPtr<SimpleFontData> FontCache::platformFallbackFontForCharacter(const FontDescription& fontDescription, UChar32 c, const SimpleFontData*)
 {
     AtomicString familyName = getFamilyNameForCharacter(c, fontDescription);
     if (familyName.isEmpty())
@@ -38,6 +38,7 @@
 #include "third_party/skia/include/core/SkPath.h"
 #include "third_party/skia/include/core/SkPoint.h"
 #include "third_party/skia/include/core/SkRect.h"
+#include "third_party/skia/include/core/SkStream.h"
 #include "third_party/skia/include/core/SkTypeface.h"
 #include "third_party/skia/include/core/SkUtils.h"
 
@@ -211,6 +212,33 @@ static hb_blob_t* harfBuzzSkiaGetTable(hb_face_t* face, hb_tag_t tag, void* user
     return hb_blob_create(const_cast<char*>(buffer), tableSize, HB_MEMORY_MODE_WRITABLE, buffer, fastFree);
 }
 
+static void unrefTypeface(void* userData)
+{
+    reinterpret_cast<SkTypeface*>(userData)->unref();
+}
+
+static void deleteFontStream(void* userData)
+{
+    delete reinterpret_cast<SkStreamAsset*>(userData);
+}
+
+// Wraps the font file in a blob if the typeface's stream is in memory, which
+// it is for mapped font files and for downloaded fonts. HarfBuzz then reads
+// its tables out of the file in place instead of copying them.
+static hb_blob_t* harfBuzzSkiaFontBlob(SkTypeface* typeface, int* ttcIndex)
+{
+    SkStreamAsset* stream = typeface->openStream(ttcIndex);
+    if (!stream)
+        return 0;
+    const void* base = stream->getMemoryBase();
+    const size_t length = stream->getLength();
+    if (!base || !length) {
+        delete stream;
+        return 0;
+    }
+    return hb_blob_create(static_cast<const char*>(base), length, HB_MEMORY_MODE_READONLY, stream, deleteFontStream);
+}
+
 static void destroyHarfBuzzFontData(void* userData)
 {
     HarfBuzzFontData* hbFontData = reinterpret_cast<HarfBuzzFontData*>(userData);
@@ -219,7 +247,19 @@ static void destroyHarfBuzzFontData(void* userData)
 
 hb_face_t* HarfBuzzFace::createFace()
 {
-    hb_face_t* face = hb_face_create_for_tables(harfBuzzSkiaGetTable, m_platformData->typeface(), 0);
+    // The face is shared by every size of the typeface, and outlives the
+    // FontPlatformData that created it, so it holds on to the typeface.
+    SkTypeface* typeface = m_platformData->typeface();
+    int ttcIndex = 0;
+    if (hb_blob_t* blob = harfBuzzSkiaFontBlob(typeface, &ttcIndex)) {
+        hb_face_t* face = hb_face_create(blob, ttcIndex);
+        hb_blob_destroy(blob);
+        ASSERT(face);
+        return face;
+    }
+
+    typeface->ref();
+    hb_face_t* face = hb_face_create_for_tables(harfBuzzSkiaGetTable, typeface, unrefTypeface);
     ASSERT(face);
     return face;
 }
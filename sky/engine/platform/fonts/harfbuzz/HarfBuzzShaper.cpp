@@ -78,21 +78,52 @@ private:
 };
 
 
-static const unsigned cHarfBuzzCacheMaxSize = 256;
+// The cache is shared by every shaper in the process, so it is bounded by the
+// memory its entries hold rather than by their number.
+static const size_t cHarfBuzzCacheMaxBytes = 2 * 1024 * 1024;
+
+// Shaping results depend on the font face a run falls back to, not only on
+// the primary font, so the face is part of the key. The rest of the font
+// description is checked against the cached Font on lookup.
+struct CachedShapingResultsKey {
+    CachedShapingResultsKey(const UChar* characters, unsigned length, const SimpleFontData* runFontData, hb_direction_t runDir, hb_script_t runScript)
+        : text(characters, characters + length)
+        , fontData(runFontData)
+        , dir(runDir)
+        , script(runScript)
+    {
+    }
+
+    bool operator<(const CachedShapingResultsKey& other) const
+    {
+        if (fontData != other.fontData)
+            return fontData < other.fontData;
+        if (dir != other.dir)
+            return dir < other.dir;
+        if (script != other.script)
+            return script < other.script;
+        return text < other.text;
+    }
+
+    std::wstring text;
+    const SimpleFontData* fontData;
+    hb_direction_t dir;
+    hb_script_t script;
+};
 
 struct CachedShapingResultsLRUNode;
 struct CachedShapingResults;
-typedef std::map<std::wstring, CachedShapingResults*> CachedShapingResultsMap;
+typedef std::map<CachedShapingResultsKey, CachedShapingResults*> CachedShapingResultsMap;
 typedef std::list<CachedShapingResultsLRUNode*> CachedShapingResultsLRU;
 
 struct CachedShapingResults {
-    CachedShapingResults(hb_buffer_t* harfBuzzBuffer, const Font* runFont, hb_direction_t runDir, const String& newLocale);
+    CachedShapingResults(hb_buffer_t* harfBuzzBuffer, const Font* runFont, const String& newLocale, size_t textLength);
     ~CachedShapingResults();
 
     hb_buffer_t* buffer;
     Font font;
-    hb_direction_t dir;
     String locale;
+    size_t byteSize;
     CachedShapingResultsLRU::iterator lru;
 };
 
@@ -103,12 +134,17 @@ struct CachedShapingResultsLRUNode {
     CachedShapingResultsMap::iterator entry;
 };
 
-CachedShapingResults::CachedShapingResults(hb_buffer_t* harfBuzzBuffer, const Font* fontData, hb_direction_t dirData, const String& newLocale)
+CachedShapingResults::CachedShapingResults(hb_buffer_t* harfBuzzBuffer, const Font* fontData, const String& newLocale, size_t textLength)
     : buffer(harfBuzzBuffer)
     , font(*fontData)
-    , dir(dirData)
     , locale(newLocale)
 {
+    // An estimate of what the entry keeps alive: the key, and the glyph info
+    // and positions allocated by the buffer.
+    size_t glyphCount = hb_buffer_get_length(buffer);
+    byteSize = sizeof(CachedShapingResults) + sizeof(CachedShapingResultsLRUNode)
+        + textLength * sizeof(wchar_t)
+        + glyphCount * (sizeof(hb_glyph_info_t) + sizeof(hb_glyph_position_t));
 }
 
 CachedShapingResults::~CachedShapingResults()
@@ -130,18 +166,34 @@ public:
     HarfBuzzRunCache();
     ~HarfBuzzRunCache();
 
-    CachedShapingResults* find(const std::wstring& key) const;
+    CachedShapingResults* find(const CachedShapingResultsKey& key) const;
     void remove(CachedShapingResults* node);
     void moveToBack(CachedShapingResults* node);
-    bool insert(const std::wstring& key, CachedShapingResults* run);
+    bool insert(const CachedShapingResultsKey& key, CachedShapingResults* run);
+    void clear();
+
+    void didHit() { ++m_hitCount; }
+    void didMiss() { ++m_missCount; }
+
+    unsigned hitCount() const { return m_hitCount; }
+    unsigned missCount() const { return m_missCount; }
+    size_t byteSize() const { return m_byteSize; }
 
 private:
+    void removeLeastRecentlyUsed();
+
     CachedShapingResultsMap m_harfBuzzRunMap;
     CachedShapingResultsLRU m_harfBuzzRunLRU;
+    size_t m_byteSize;
+    unsigned m_hitCount;
+    unsigned m_missCount;
 };
 
 
 HarfBuzzRunCache::HarfBuzzRunCache()
+    : m_byteSize(0)
+    , m_hitCount(0)
+    , m_missCount(0)
 {
 }
 
@@ -153,32 +205,36 @@ HarfBuzzRunCache::~HarfBuzzRunCache()
         delete *it;
 }
 
-bool HarfBuzzRunCache::insert(const std::wstring& key, CachedShapingResults* data)
+bool HarfBuzzRunCache::insert(const CachedShapingResultsKey& key, CachedShapingResults* data)
 {
+    // A single run bigger than the whole cache would only evict everything
+    // else without ever being hit.
+    if (data->byteSize > cHarfBuzzCacheMaxBytes) {
+        delete data;
+        return false;
+    }
+
     std::pair<CachedShapingResultsMap::iterator, bool> results =
         m_harfBuzzRunMap.insert(CachedShapingResultsMap::value_type(key, data));
 
-    if (!results.second)
+    if (!results.second) {
+        delete data;
         return false;
+    }
 
     CachedShapingResultsLRUNode* node = new CachedShapingResultsLRUNode(results.first);
 
     m_harfBuzzRunLRU.push_back(node);
     data->lru = --m_harfBuzzRunLRU.end();
+    m_byteSize += data->byteSize;
 
-    if (m_harfBuzzRunMap.size() > cHarfBuzzCacheMaxSize) {
-        CachedShapingResultsLRUNode* lru = m_harfBuzzRunLRU.front();
-        CachedShapingResults* foo = lru->entry->second;
-        m_harfBuzzRunMap.erase(lru->entry);
-        m_harfBuzzRunLRU.pop_front();
-        delete foo;
-        delete lru;
-    }
+    while (m_byteSize > cHarfBuzzCacheMaxBytes)
+        removeLeastRecentlyUsed();
 
     return true;
 }
 
-inline CachedShapingResults* HarfBuzzRunCache::find(const std::wstring& key) const
+inline CachedShapingResults* HarfBuzzRunCache::find(const CachedShapingResultsKey& key) const
 {
     CachedShapingResultsMap::const_iterator it = m_harfBuzzRunMap.find(key);
 
@@ -189,6 +245,7 @@ inline void HarfBuzzRunCache::remove(CachedShapingResults* node)
 {
     CachedShapingResultsLRUNode* lruNode = *node->lru;
 
+    m_byteSize -= node->byteSize;
     m_harfBuzzRunLRU.erase(node->lru);
     m_harfBuzzRunMap.erase(lruNode->entry);
     delete lruNode;
@@ -203,6 +260,18 @@ inline void HarfBuzzRunCache::moveToBack(CachedShapingResults* node)
     node->lru = --m_harfBuzzRunLRU.end();
 }
 
+void HarfBuzzRunCache::clear()
+{
+    while (!m_harfBuzzRunLRU.empty())
+        removeLeastRecentlyUsed();
+}
+
+void HarfBuzzRunCache::removeLeastRecentlyUsed()
+{
+    ASSERT(!m_harfBuzzRunLRU.empty());
+    remove(m_harfBuzzRunLRU.front()->entry->second);
+}
+
 HarfBuzzRunCache& harfBuzzRunCache()
 {
     DEFINE_STATIC_LOCAL(HarfBuzzRunCache, globalHarfBuzzRunCache, ());
@@ -365,6 +434,26 @@ static void normalizeCharacters(const TextRun& run, unsigned length, UChar* dest
     }
 }
 
+unsigned HarfBuzzShaper::runCacheHitCount()
+{
+    return harfBuzzRunCache().hitCount();
+}
+
+unsigned HarfBuzzShaper::runCacheMissCount()
+{
+    return harfBuzzRunCache().missCount();
+}
+
+size_t HarfBuzzShaper::runCacheByteSize()
+{
+    return harfBuzzRunCache().byteSize();
+}
+
+void HarfBuzzShaper::clearRunCache()
+{
+    harfBuzzRunCache().clear();
+}
+
 HarfBuzzShaper::HarfBuzzShaper(const Font* font, const TextRun& run, ForTextEmphasisOrNot forTextEmphasis, HashSet<const SimpleFontData*>* fallbackFonts)
     : m_font(font)
     , m_normalizedBufferLength(0)
@@ -605,8 +694,12 @@ struct CandidateRun {
     UScriptCode script;
 };
 
+// Most text runs are a single script in one font, so shaping them should
+// not have to allocate.
+typedef Vector<CandidateRun, 16> CandidateRunList;
+
 static inline bool collectCandidateRuns(const UChar* normalizedBuffer,
-    size_t bufferLength, const Font* font, Vector<CandidateRun>* runs)
+    size_t bufferLength, const Font* font, CandidateRunList* runs)
 {
     const UChar* normalizedBufferEnd = normalizedBuffer + bufferLength;
     SurrogatePairAwareTextIterator iterator(normalizedBuffer, 0, bufferLength, bufferLength);
@@ -669,7 +762,7 @@ static inline bool matchesAdjacentRun(UScriptCode* scriptExtensions, int length,
     return false;
 }
 
-static inline void resolveRunBasedOnScriptExtensions(Vector<CandidateRun>& runs,
+static inline void resolveRunBasedOnScriptExtensions(CandidateRunList& runs,
     CandidateRun& run, size_t i, size_t length, UScriptCode* scriptExtensions,
     int extensionsLength, size_t& nextResolvedRun)
 {
@@ -693,7 +786,7 @@ static inline void resolveRunBasedOnScriptExtensions(Vector<CandidateRun>& runs,
     }
 }
 
-static inline void resolveRunBasedOnScriptValue(Vector<CandidateRun>& runs,
+static inline void resolveRunBasedOnScriptValue(CandidateRunList& runs,
     CandidateRun& run, size_t i, size_t length, size_t& nextResolvedRun)
 {
     if (run.script != USCRIPT_COMMON)
@@ -713,7 +806,7 @@ static inline void resolveRunBasedOnScriptValue(Vector<CandidateRun>& runs,
     }
 }
 
-static inline bool resolveCandidateRuns(Vector<CandidateRun>& runs)
+static inline bool resolveCandidateRuns(CandidateRunList& runs)
 {
     UScriptCode scriptExtensions[8];
     UErrorCode errorCode = U_ZERO_ERROR;
@@ -745,7 +838,7 @@ static inline bool resolveCandidateRuns(Vector<CandidateRun>& runs)
 
 bool HarfBuzzShaper::createHarfBuzzRuns()
 {
-    Vector<CandidateRun> candidateRuns;
+    CandidateRunList candidateRuns;
     if (!collectCandidateRuns(m_normalizedBuffer.get(),
         m_normalizedBufferLength, m_font, &candidateRuns))
         return false;
@@ -832,24 +925,26 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns()
         hb_buffer_set_script(harfBuzzBuffer.get(), currentRun->script());
         hb_buffer_set_direction(harfBuzzBuffer.get(), currentRun->direction());
 
-        const UChar* src = m_normalizedBuffer.get() + currentRun->startIndex();
-        std::wstring key(src, src + currentRun->numCharacters());
+        CachedShapingResultsKey key(m_normalizedBuffer.get() + currentRun->startIndex(), currentRun->numCharacters(),
+            currentFontData, currentRun->direction(), currentRun->script());
 
         CachedShapingResults* cachedResults = runCache.find(key);
         if (cachedResults) {
-            if (cachedResults->dir == currentRun->direction() && cachedResults->font == *m_font && cachedResults->locale == localeString) {
+            if (cachedResults->font == *m_font && cachedResults->locale == localeString) {
                 currentRun->applyShapeResult(cachedResults->buffer);
                 setGlyphPositionsForHarfBuzzRun(currentRun, cachedResults->buffer);
 
                 hb_buffer_clear_contents(harfBuzzBuffer.get());
 
                 runCache.moveToBack(cachedResults);
+                runCache.didHit();
 
                 continue;
             }
 
             runCache.remove(cachedResults);
         }
+        runCache.didMiss();
 
         // Add a space as pre-context to the buffer. This prevents showing dotted-circle
         // for combining marks at the beginning of runs.
@@ -873,7 +968,7 @@ bool HarfBuzzShaper::shapeHarfBuzzRuns()
         currentRun->applyShapeResult(harfBuzzBuffer.get());
         setGlyphPositionsForHarfBuzzRun(currentRun, harfBuzzBuffer.get());
 
-        runCache.insert(key, new CachedShapingResults(harfBuzzBuffer.get(), m_font, currentRun->direction(), localeString));
+        runCache.insert(key, new CachedShapingResults(harfBuzzBuffer.get(), m_font, localeString, currentRun->numCharacters()));
 
         harfBuzzBuffer.set(hb_buffer_create());
     }
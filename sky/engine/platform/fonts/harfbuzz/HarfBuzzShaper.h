@@ -65,6 +65,13 @@ public:
     FloatRect selectionRect(const FloatPoint&, int height, int from, int to);
     FloatBoxExtent glyphBoundingBox() const { return m_glyphBoundingBox; }
 
+    // Statistics of the process-wide cache of shaped runs that all shapers
+    // consult before calling into HarfBuzz.
+    static unsigned runCacheHitCount();
+    static unsigned runCacheMissCount();
+    static size_t runCacheByteSize();
+    static void clearRunCache();
+
 private:
     class HarfBuzzRun {
     public:
@@ -30,14 +30,38 @@
 
 #include "sky/engine/platform/fonts/opentype/OpenTypeSanitizer.h"
 
+#include "base/sha1.h"
 #include "ots-memory-stream.h"
 #include "sky/engine/platform/SharedBuffer.h"
+#include "sky/engine/wtf/MainThread.h"
+#include "sky/engine/wtf/Vector.h"
 
 #include <stdarg.h>
+#include <string>
 
 namespace blink {
 
-PassRefPtr<SharedBuffer> OpenTypeSanitizer::sanitize()
+namespace {
+
+struct SanitizedFont {
+    std::string digest;
+    RefPtr<SkData> data;
+};
+
+// The typefaces made from recently sanitized fonts hold on to their data
+// anyway, so remembering it costs little memory while they are alive.
+const size_t maxSanitizedFonts = 4;
+
+Vector<SanitizedFont>& sanitizedFonts()
+{
+    ASSERT(isMainThread());
+    DEFINE_STATIC_LOCAL(Vector<SanitizedFont>, fonts, ());
+    return fonts;
+}
+
+} // namespace
+
+PassRefPtr<SkData> OpenTypeSanitizer::sanitize()
 {
     if (!m_buffer) {
         setErrorString("Empty Buffer");
@@ -58,16 +82,34 @@ PassRefPtr<SharedBuffer> OpenTypeSanitizer::sanitize()
     // With WOFF fonts, however, we'll be decompressing, so the result can be
     // much larger than the original.
 
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(m_buffer->data());
+    std::string digest(base::kSHA1Length, '\0');
+    base::SHA1HashBytes(data, m_buffer->size(), reinterpret_cast<unsigned char*>(&digest[0]));
+    Vector<SanitizedFont>& fonts = sanitizedFonts();
+    for (size_t i = 0; i < fonts.size(); ++i) {
+        if (fonts[i].digest == digest) {
+            RefPtr<SkData> sanitized = fonts[i].data;
+            fonts.remove(i);
+            fonts.append(SanitizedFont { digest, sanitized });
+            return sanitized.release();
+        }
+    }
+
     ots::ExpandingMemoryStream output(m_buffer->size(), maxWebFontSize);
     BlinkOTSContext otsContext;
 
-    if (!otsContext.Process(&output, reinterpret_cast<const uint8_t*>(m_buffer->data()), m_buffer->size())) {
+    if (!otsContext.Process(&output, data, m_buffer->size())) {
         setErrorString(otsContext.getErrorString());
         return nullptr;
     }
 
+    // Copy the output straight into the SkData the typeface is made from.
     const size_t transcodeLen = output.Tell();
-    return SharedBuffer::create(static_cast<unsigned char*>(output.get()), transcodeLen);
+    RefPtr<SkData> sanitized = adoptRef(SkData::NewWithCopy(output.get(), transcodeLen));
+    if (fonts.size() == maxSanitizedFonts)
+        fonts.remove(0);
+    fonts.append(SanitizedFont { digest, sanitized });
+    return sanitized.release();
 }
 
 bool OpenTypeSanitizer::supportsFormat(const String& format)
@@ -34,6 +34,7 @@
 #include "opentype-sanitiser.h"
 #include "sky/engine/wtf/Forward.h"
 #include "sky/engine/wtf/text/WTFString.h"
+#include "third_party/skia/include/core/SkData.h"
 
 namespace blink {
 
@@ -47,7 +48,10 @@ public:
     {
     }
 
-    PassRefPtr<SharedBuffer> sanitize();
+    // Returns the sanitized font, or null if the font is invalid. The last few
+    // fonts that were sanitized are remembered by their digest, so loading
+    // the same font again does not run it through OTS again.
+    PassRefPtr<SkData> sanitize();
 
     static bool supportsFormat(const String&);
     String getErrorString() const { return static_cast<String>(m_otsErrorString); }
@@ -145,7 +145,7 @@ PassRefPtr<SimpleFontData> FontCache::fallbackOnStandardFontStyle(
 }
 
 #if !OS(WIN) && !OS(ANDROID)
-PassRefPtr<SimpleFontData> FontCache::fallbackFontForCharacter(const FontDescription& fontDescription, UChar32 c, const SimpleFontData*)
+PassRefPtr<SimpleFontData> FontCache::platformFallbackFontForCharacter(const FontDescription& fontDescription, UChar32 c, const SimpleFontData*)
 {
     // First try the specified font with standard style & weight.
     if (fontDescription.style() == FontStyleItalic
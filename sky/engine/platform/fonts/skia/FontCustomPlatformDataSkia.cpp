@@ -58,17 +58,21 @@ FontPlatformData FontCustomPlatformData::fontPlatformData(float size, bool bold,
     return FontPlatformData(m_typeface.get(), "", size, bold && !m_typeface->isBold(), italic && !m_typeface->isItalic(), orientation);
 }
 
-PassOwnPtr<FontCustomPlatformData> FontCustomPlatformData::create(SharedBuffer* buffer)
+PassOwnPtr<FontCustomPlatformData> FontCustomPlatformData::create(SharedBuffer* buffer, FontDataOrigin origin)
 {
     ASSERT_ARG(buffer, buffer);
 
-    OpenTypeSanitizer sanitizer(buffer);
-    RefPtr<SharedBuffer> transcodeBuffer = sanitizer.sanitize();
-    if (!transcodeBuffer)
-        return nullptr; // validation failed.
-    buffer = transcodeBuffer.get();
+    RefPtr<SkData> data;
+    if (origin == TrustedFontData) {
+        data = buffer->getAsSkData();
+    } else {
+        OpenTypeSanitizer sanitizer(buffer);
+        data = sanitizer.sanitize();
+        if (!data)
+            return nullptr; // validation failed.
+    }
 
-    SkMemoryStream* stream = new SkMemoryStream(buffer->getAsSkData().get());
+    SkMemoryStream* stream = new SkMemoryStream(data.get());
     RefPtr<SkTypeface> typeface = adoptRef(SkTypeface::CreateFromStream(stream));
     if (!typeface)
         return nullptr;
@@ -0,0 +1,79 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_PLATFORM_GRAPHICS_CPU_ARM_IMAGEFRAMENEON_H_
+#define SKY_ENGINE_PLATFORM_GRAPHICS_CPU_ARM_IMAGEFRAMENEON_H_
+
+#if HAVE(ARM_NEON_INTRINSICS)
+
+#include <arm_neon.h>
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace blink {
+
+namespace SIMD {
+
+// These convert as many pixels of a row as fill whole vectors and advance
+// the pointers and count past them. The caller converts the rest.
+
+// Rounds like ImageFrame::setRGBAPremultiply: (t + 1 + (t >> 8)) >> 8 is
+// t / 255 rounded down for every product of two 8-bit values.
+ALWAYS_INLINE uint8x8_t premultiplyChannel(uint8x8_t channel, uint8x8_t alpha)
+{
+    uint16x8_t product = vmull_u8(channel, alpha);
+    uint16x8_t rounded = vaddq_u16(vaddq_u16(product, vdupq_n_u16(1)), vshrq_n_u16(product, 8));
+    return vshrn_n_u16(rounded, 8);
+}
+
+ALWAYS_INLINE void storePixels(uint32_t* destination, uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+{
+#if SK_R32_SHIFT == 0
+    uint8x8x4_t pixels = {{r, g, b, a}};
+#else
+    uint8x8x4_t pixels = {{b, g, r, a}};
+#endif
+    vst4_u8(reinterpret_cast<uint8_t*>(destination), pixels);
+}
+
+ALWAYS_INLINE unsigned alphaMaskOf(uint8x8_t alphas)
+{
+    uint8_t lanes[8];
+    vst1_u8(lanes, alphas);
+    unsigned mask = 255;
+    for (unsigned i = 0; i < 8; ++i)
+        mask &= lanes[i];
+    return mask;
+}
+
+ALWAYS_INLINE unsigned packRGBARow(const uint8_t*& source, uint32_t*& destination, unsigned& pixels, bool premultiply)
+{
+    uint8x8_t alphaMask = vdup_n_u8(255);
+    for (; pixels >= 8; pixels -= 8, source += 32, destination += 8) {
+        uint8x8x4_t rgba = vld4_u8(source);
+        uint8x8_t a = rgba.val[3];
+        alphaMask = vand_u8(alphaMask, a);
+        if (premultiply)
+            storePixels(destination, premultiplyChannel(rgba.val[0], a), premultiplyChannel(rgba.val[1], a), premultiplyChannel(rgba.val[2], a), a);
+        else
+            storePixels(destination, rgba.val[0], rgba.val[1], rgba.val[2], a);
+    }
+    return alphaMaskOf(alphaMask);
+}
+
+ALWAYS_INLINE void packRGBRow(const uint8_t*& source, uint32_t*& destination, unsigned& pixels)
+{
+    uint8x8_t opaque = vdup_n_u8(255);
+    for (; pixels >= 8; pixels -= 8, source += 24, destination += 8) {
+        uint8x8x3_t rgb = vld3_u8(source);
+        storePixels(destination, rgb.val[0], rgb.val[1], rgb.val[2], opaque);
+    }
+}
+
+} // namespace SIMD
+
+} // namespace blink
+
+#endif // HAVE(ARM_NEON_INTRINSICS)
+
+#endif  // SKY_ENGINE_PLATFORM_GRAPHICS_CPU_ARM_IMAGEFRAMENEON_H_
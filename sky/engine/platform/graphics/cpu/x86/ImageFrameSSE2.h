@@ -0,0 +1,72 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_PLATFORM_GRAPHICS_CPU_X86_IMAGEFRAMESSE2_H_
+#define SKY_ENGINE_PLATFORM_GRAPHICS_CPU_X86_IMAGEFRAMESSE2_H_
+
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+
+#include <emmintrin.h>
+#include "third_party/skia/include/core/SkColorPriv.h"
+
+namespace blink {
+
+namespace SIMD {
+
+// Like the NEON versions, these convert as many pixels of a row as fill
+// whole vectors and leave the rest to the caller. SSE2 cannot shuffle
+// bytes, so there is no version for RGB rows.
+
+// Reorders four RGBA pixels into the byte order of SkPMColor.
+ALWAYS_INLINE __m128i swizzleRGBA(__m128i pixels)
+{
+#if SK_R32_SHIFT == 0
+    return pixels;
+#else
+    __m128i ag = _mm_and_si128(pixels, _mm_set1_epi32(0xFF00FF00));
+    __m128i rb = _mm_and_si128(pixels, _mm_set1_epi32(0x00FF00FF));
+    return _mm_or_si128(ag, _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16)));
+#endif
+}
+
+// Premultiplies two pixels widened to 16 bits per channel, rounding like
+// ImageFrame::setRGBAPremultiply.
+ALWAYS_INLINE __m128i premultiplyWidePixels(__m128i pixels)
+{
+    __m128i alphas = _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+    // Alpha itself is multiplied by 255, which leaves it unchanged.
+    const __m128i alphaLanes = _mm_set_epi16(-1, 0, 0, 0, -1, 0, 0, 0);
+    __m128i factors = _mm_or_si128(_mm_andnot_si128(alphaLanes, alphas), _mm_and_si128(alphaLanes, _mm_set1_epi16(255)));
+    __m128i product = _mm_mullo_epi16(pixels, factors);
+    __m128i rounded = _mm_add_epi16(_mm_add_epi16(product, _mm_set1_epi16(1)), _mm_srli_epi16(product, 8));
+    return _mm_srli_epi16(rounded, 8);
+}
+
+ALWAYS_INLINE unsigned packRGBARow(const uint8_t*& source, uint32_t*& destination, unsigned& pixels, bool premultiply)
+{
+    const __m128i zero = _mm_setzero_si128();
+    __m128i alphaMask = _mm_set1_epi32(0xFFFFFFFF);
+    for (; pixels >= 4; pixels -= 4, source += 16, destination += 4) {
+        __m128i rgba = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source));
+        alphaMask = _mm_and_si128(alphaMask, rgba);
+        if (premultiply) {
+            __m128i low = premultiplyWidePixels(_mm_unpacklo_epi8(rgba, zero));
+            __m128i high = premultiplyWidePixels(_mm_unpackhi_epi8(rgba, zero));
+            rgba = _mm_packus_epi16(low, high);
+        }
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination), swizzleRGBA(rgba));
+    }
+
+    uint32_t lanes[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(lanes), alphaMask);
+    return (lanes[0] & lanes[1] & lanes[2] & lanes[3]) >> 24;
+}
+
+} // namespace SIMD
+
+} // namespace blink
+
+#endif // CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+
+#endif  // SKY_ENGINE_PLATFORM_GRAPHICS_CPU_X86_IMAGEFRAMESSE2_H_
@@ -31,6 +31,14 @@
 #include "sky/engine/wtf/Uint8ClampedArray.h"
 #include "third_party/skia/include/effects/SkMatrixConvolutionImageFilter.h"
 
+#if CPU(X86_64)
+#include <emmintrin.h>
+#define FECONVOLVEMATRIX_USE_SSE2 1
+#elif HAVE(ARM_NEON_INTRINSICS)
+#include "sky/engine/platform/graphics/cpu/arm/filters/NEONHelpers.h"
+#define FECONVOLVEMATRIX_USE_NEON 1
+#endif
+
 namespace blink {
 
 FEConvolveMatrix::FEConvolveMatrix(Filter* filter, const IntSize& kernelSize,
@@ -256,6 +264,41 @@ ALWAYS_INLINE void setDestinationPixels(Uint8ClampedArray* image, int& pixel, fl
 #pragma warning(disable: 4789)
 #endif
 
+#if FECONVOLVEMATRIX_USE_SSE2 || FECONVOLVEMATRIX_USE_NEON
+// Sums all four channels of the kernel's pixels at once. The products are
+// added up in the same order as in the scalar loop, so the result is the same.
+static ALWAYS_INLINE void sumKernelPixels(const unsigned char* source, int kernelPixel, int kernelIncrease, int kernelWidth, const Vector<float>& kernel, float* result)
+{
+    int width = kernelWidth;
+#if FECONVOLVEMATRIX_USE_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    __m128 sum = _mm_setzero_ps();
+#else
+    float32x4_t sum = vdupq_n_f32(0);
+#endif
+    for (int kernelValue = kernel.size() - 1; kernelValue >= 0; --kernelValue) {
+#if FECONVOLVEMATRIX_USE_SSE2
+        __m128i pixel = _mm_cvtsi32_si128(*reinterpret_cast<const int*>(source + kernelPixel));
+        pixel = _mm_unpacklo_epi16(_mm_unpacklo_epi8(pixel, zero), zero);
+        sum = _mm_add_ps(sum, _mm_mul_ps(_mm_set1_ps(kernel[kernelValue]), _mm_cvtepi32_ps(pixel)));
+#else
+        float32x4_t pixel = loadRGBA8AsFloat(reinterpret_cast<uint32_t*>(const_cast<unsigned char*>(source + kernelPixel)));
+        sum = vaddq_f32(sum, vmulq_n_f32(pixel, kernel[kernelValue]));
+#endif
+        kernelPixel += 4;
+        if (!--width) {
+            kernelPixel += kernelIncrease;
+            width = kernelWidth;
+        }
+    }
+#if FECONVOLVEMATRIX_USE_SSE2
+    _mm_storeu_ps(result, sum);
+#else
+    vst1q_f32(result, sum);
+#endif
+}
+#endif
+
 // Only for region C
 template<bool preserveAlphaValues>
 ALWAYS_INLINE void FEConvolveMatrix::fastSetInteriorPixels(PaintingData& paintingData, int clipRight, int clipBottom, int yStart, int yEnd)
@@ -276,6 +319,15 @@ ALWAYS_INLINE void FEConvolveMatrix::fastSetInteriorPixels(PaintingData& paintin
 
     for (int y = yEnd + 1; y > yStart; --y) {
         for (int x = clipRight + 1; x > 0; --x) {
+#if FECONVOLVEMATRIX_USE_SSE2 || FECONVOLVEMATRIX_USE_NEON
+            float sums[4];
+            sumKernelPixels(paintingData.srcPixelArray->data(), startKernelPixel, kernelIncrease, m_kernelSize.width(), m_kernelMatrix, sums);
+            totals[0] = sums[0];
+            totals[1] = sums[1];
+            totals[2] = sums[2];
+            if (!preserveAlphaValues)
+                totals[3] = sums[3];
+#else
             int kernelValue = m_kernelMatrix.size() - 1;
             int kernelPixel = startKernelPixel;
             int width = m_kernelSize.width();
@@ -299,6 +351,7 @@ ALWAYS_INLINE void FEConvolveMatrix::fastSetInteriorPixels(PaintingData& paintin
                     width = m_kernelSize.width();
                 }
             }
+#endif
 
             setDestinationPixels<preserveAlphaValues>(paintingData.dstPixelArray, pixel, totals, m_divisor, paintingData.bias, paintingData.srcPixelArray);
             startKernelPixel += 4;
@@ -28,12 +28,14 @@
 #ifndef SKY_ENGINE_PLATFORM_GRAPHICS_FILTERS_PARALLELJOBS_H_
 #define SKY_ENGINE_PLATFORM_GRAPHICS_FILTERS_PARALLELJOBS_H_
 
+#include "base/atomic_ref_count.h"
 #include "base/bind.h"
-#include "base/threading/thread.h"
+#include "base/location.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/task_runner.h"
 #include "sky/engine/public/platform/Platform.h"
 #include "sky/engine/wtf/Assertions.h"
 #include "sky/engine/wtf/Noncopyable.h"
-#include "sky/engine/wtf/OwnPtr.h"
 #include "sky/engine/wtf/Vector.h"
 
 // Usage:
@@ -51,6 +53,10 @@
 //     // Execute parallel jobs
 //     parallelJobs.execute();
 //
+// The jobs run on the platform's user-blocking worker task runner, apart from
+// the last one, which runs on the calling thread. execute() returns once all
+// of them are done.
+//
 
 namespace blink {
 
@@ -66,12 +72,6 @@ public:
     {
         size_t numberOfJobs = std::max(static_cast<size_t>(2), std::min(requestedJobNumber, Platform::current()->numberOfProcessors()));
         m_parameters.grow(numberOfJobs);
-        // The main thread can execute one job, so only create requestJobNumber - 1 threads.
-        for (size_t i = 0; i < numberOfJobs - 1; ++i) {
-            OwnPtr<base::Thread> thread = adoptPtr(new base::Thread("Unfortunate parallel worker"));
-            thread->Start();
-            m_threads.append(thread.release());
-        }
     }
 
     size_t numberOfJobs()
@@ -86,15 +86,30 @@ public:
 
     void execute()
     {
-        for (size_t i = 0; i < numberOfJobs() - 1; ++i)
-            m_threads[i]->message_loop()->PostTask(FROM_HERE, base::Bind(m_func, &parameter(i)));
-        m_func(&parameter(numberOfJobs() - 1));
-        m_threads.clear();
+        // The workers only touch |pending| and |done| before the last one
+        // signals, so both can live on this stack frame.
+        size_t workerJobs = numberOfJobs() - 1;
+        base::AtomicRefCount pending = workerJobs;
+        base::WaitableEvent done(false, false);
+        base::TaskRunner* workers = Platform::current()->workerTaskRunner(Platform::UserBlockingWorkerTask);
+        for (size_t i = 0; i < workerJobs; ++i) {
+            base::Closure job = base::Bind(&ParallelJobs::runJob, m_func, &parameter(i), &pending, &done);
+            if (!workers->PostTask(FROM_HERE, job))
+                job.Run();
+        }
+        m_func(&parameter(workerJobs));
+        done.Wait();
     }
 
 private:
+    static void runJob(WorkerFunction func, Type* parameter, base::AtomicRefCount* pending, base::WaitableEvent* done)
+    {
+        func(parameter);
+        if (!base::AtomicRefCountDec(pending))
+            done->Signal();
+    }
+
     WorkerFunction m_func;
-    Vector<OwnPtr<base::Thread> > m_threads;
     Vector<Type> m_parameters;
 };
 
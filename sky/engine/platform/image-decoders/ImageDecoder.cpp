@@ -27,6 +27,7 @@
 #include "platform/image-decoders/png/PNGImageDecoder.h"
 #include "sky/engine/platform/graphics/DeferredImageDecoder.h"
 #include "sky/engine/wtf/PassOwnPtr.h"
+#include "sky/engine/wtf/StdLibExtras.h"
 
 namespace blink {
 
@@ -76,12 +77,15 @@ inline bool matchesCURSignature(char* contents)
 }
 
 PassOwnPtr<ImageDecoder> ImageDecoder::create(const SharedBuffer& data, ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption)
+{
+    return create(data, alphaOption, gammaAndColorProfileOption, blink::Platform::current()->maxDecodedImageBytes());
+}
+
+PassOwnPtr<ImageDecoder> ImageDecoder::create(const SharedBuffer& data, ImageSource::AlphaOption alphaOption, ImageSource::GammaAndColorProfileOption gammaAndColorProfileOption, size_t maxDecodedBytes)
 {
     static const unsigned longestSignatureLength = sizeof("RIFF????WEBPVP") - 1;
     ASSERT(longestSignatureLength == 14);
 
-    size_t maxDecodedBytes = blink::Platform::current()->maxDecodedImageBytes();
-
     char contents[longestSignatureLength];
     if (copyFromSharedBuffer(contents, longestSignatureLength, data, 0) < longestSignatureLength)
         return nullptr;
@@ -222,4 +226,79 @@ size_t ImagePlanes::rowBytes(int i) const
     return m_rowBytes[i];
 }
 
+#if USE(QCMSLIB)
+
+namespace {
+
+struct CachedColorTransform {
+    ColorProfile colorProfile;
+    bool hasAlpha;
+    RefPtr<ColorTransform> transform;
+};
+
+// Photos mostly come with one of a handful of camera and editor profiles.
+const size_t maxCachedColorTransforms = 8;
+
+Mutex& colorTransformCacheMutex()
+{
+    AtomicallyInitializedStatic(Mutex&, mutex = *new Mutex);
+    return mutex;
+}
+
+// Must be used with colorTransformCacheMutex() held.
+Vector<CachedColorTransform>& colorTransformCache()
+{
+    DEFINE_STATIC_LOCAL(Vector<CachedColorTransform>, cache, ());
+    return cache;
+}
+
+} // namespace
+
+PassRefPtr<ColorTransform> ImageDecoder::colorTransform(const ColorProfile& colorProfile, bool hasAlpha)
+{
+    if (colorProfile.isEmpty())
+        return nullptr;
+
+    {
+        MutexLocker locker(colorTransformCacheMutex());
+        Vector<CachedColorTransform>& cache = colorTransformCache();
+        for (size_t i = 0; i < cache.size(); ++i) {
+            if (cache[i].hasAlpha == hasAlpha && cache[i].colorProfile == colorProfile) {
+                RefPtr<ColorTransform> transform = cache[i].transform;
+                // Keep the most recently used transforms at the end.
+                CachedColorTransform entry = cache[i];
+                cache.remove(i);
+                cache.append(entry);
+                return transform.release();
+            }
+        }
+    }
+
+    qcms_profile* deviceProfile = qcmsOutputDeviceProfile();
+    if (!deviceProfile)
+        return nullptr;
+    qcms_profile* inputProfile = qcms_profile_from_memory(colorProfile.data(), colorProfile.size());
+    if (!inputProfile)
+        return nullptr;
+    // We currently only support color profiles for RGB and RGBA images.
+    ASSERT(rgbData == qcms_profile_get_color_space(inputProfile));
+    qcms_data_type dataFormat = hasAlpha ? QCMS_DATA_RGBA_8 : QCMS_DATA_RGB_8;
+    // FIXME: Don't force perceptual intent if the image profile contains an intent.
+    qcms_transform* qcmsTransform = qcms_transform_create(inputProfile, dataFormat, deviceProfile, dataFormat, QCMS_INTENT_PERCEPTUAL);
+    qcms_profile_release(inputProfile);
+    if (!qcmsTransform)
+        return nullptr;
+
+    RefPtr<ColorTransform> transform = adoptRef(new ColorTransform(qcmsTransform));
+    CachedColorTransform entry = { colorProfile, hasAlpha, transform };
+    MutexLocker locker(colorTransformCacheMutex());
+    Vector<CachedColorTransform>& cache = colorTransformCache();
+    if (cache.size() == maxCachedColorTransforms)
+        cache.remove(0);
+    cache.append(entry);
+    return transform.release();
+}
+
+#endif // USE(QCMSLIB)
+
 } // namespace blink
@@ -35,6 +35,7 @@
 #include "sky/engine/wtf/Assertions.h"
 #include "sky/engine/wtf/PassOwnPtr.h"
 #include "sky/engine/wtf/RefPtr.h"
+#include "sky/engine/wtf/ThreadSafeRefCounted.h"
 #include "sky/engine/wtf/Threading.h"
 #include "sky/engine/wtf/Vector.h"
 #include "sky/engine/wtf/text/WTFString.h"
@@ -48,6 +49,27 @@ namespace blink {
 
 typedef WTF::Vector<char> ColorProfile;
 
+#if USE(QCMSLIB)
+// A transform from an image's color profile to the output device profile.
+// Building one takes about as long as applying it to a large image, so
+// decoders share them through ImageDecoder::colorTransform().
+class PLATFORM_EXPORT ColorTransform : public ThreadSafeRefCounted<ColorTransform> {
+public:
+    ~ColorTransform() { qcms_transform_release(m_transform); }
+
+    qcms_transform* transform() const { return m_transform; }
+
+private:
+    friend class ImageDecoder;
+
+    explicit ColorTransform(qcms_transform* transform)
+        : m_transform(transform)
+    { }
+
+    qcms_transform* m_transform;
+};
+#endif
+
 // ImagePlanes can be used to decode color components into provided buffers instead of using an ImageFrame.
 class PLATFORM_EXPORT ImagePlanes {
 public:
@@ -213,6 +235,12 @@ public:
 
         return outputDeviceProfile->profile();
     }
+
+    // Returns the transform from |colorProfile| to the output device profile
+    // for RGB or RGBA data, or null if the profile cannot be used. The last
+    // few transforms are kept, and given out again for images with the same
+    // profile. Can be called on any thread.
+    static PassRefPtr<ColorTransform> colorTransform(const ColorProfile&, bool hasAlpha);
 #endif
 
     // Sets the "decode failure" flag.  For caller convenience (since so
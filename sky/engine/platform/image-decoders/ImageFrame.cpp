@@ -26,8 +26,54 @@
 
 #include "platform/image-decoders/ImageDecoder.h"
 
+#include "sky/engine/platform/graphics/cpu/arm/ImageFrameNEON.h"
+#include "sky/engine/platform/graphics/cpu/x86/ImageFrameSSE2.h"
+
 namespace blink {
 
+namespace {
+
+#if HAVE(ARM_NEON_INTRINSICS) || CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+#define HAVE_SIMD_RGBA_ROWS 1
+#endif
+
+unsigned setRGBARow(ImageFrame::PixelData* dest, const uint8_t* source, unsigned pixelCount, bool premultiply)
+{
+    unsigned alphaMask = 255;
+#if defined(HAVE_SIMD_RGBA_ROWS)
+    alphaMask = SIMD::packRGBARow(source, dest, pixelCount, premultiply);
+#endif
+    for (; pixelCount; --pixelCount, source += 4) {
+        if (premultiply)
+            ImageFrame::setRGBAPremultiply(dest++, source[0], source[1], source[2], source[3]);
+        else
+            ImageFrame::setRGBARaw(dest++, source[0], source[1], source[2], source[3]);
+        alphaMask &= source[3];
+    }
+    return alphaMask;
+}
+
+} // namespace
+
+unsigned ImageFrame::setRGBARowPremultiply(PixelData* dest, const uint8_t* source, unsigned pixelCount)
+{
+    return setRGBARow(dest, source, pixelCount, true);
+}
+
+unsigned ImageFrame::setRGBARowRaw(PixelData* dest, const uint8_t* source, unsigned pixelCount)
+{
+    return setRGBARow(dest, source, pixelCount, false);
+}
+
+void ImageFrame::setRGBRow(PixelData* dest, const uint8_t* source, unsigned pixelCount)
+{
+#if HAVE(ARM_NEON_INTRINSICS)
+    SIMD::packRGBRow(source, dest, pixelCount);
+#endif
+    for (; pixelCount; --pixelCount, source += 3)
+        setRGBARaw(dest++, source[0], source[1], source[2], 255);
+}
+
 ImageFrame::ImageFrame()
     : m_allocator(0)
     , m_hasAlpha(false)
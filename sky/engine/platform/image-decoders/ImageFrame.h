@@ -197,6 +197,14 @@ public:
         *dest = SkPackARGB32NoCheck(a, r, g, b);
     }
 
+    // Row versions of the setters above for |pixelCount| pixels of 8-bit
+    // RGBA or RGB samples, vectorized where the CPU allows. The RGBA ones
+    // return the AND of the alpha values of the row, which is 255 if the
+    // row is opaque.
+    static unsigned setRGBARowPremultiply(PixelData* dest, const uint8_t* source, unsigned pixelCount);
+    static unsigned setRGBARowRaw(PixelData* dest, const uint8_t* source, unsigned pixelCount);
+    static void setRGBRow(PixelData* dest, const uint8_t* source, unsigned pixelCount);
+
     // Notifies the SkBitmap if any pixels changed and resets the flag.
     inline void notifyBitmapIfPixelsChanged()
     {
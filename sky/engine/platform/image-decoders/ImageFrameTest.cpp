@@ -0,0 +1,89 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "platform/image-decoders/ImageFrame.h"
+
+#include <gtest/gtest.h>
+#include "sky/engine/wtf/Vector.h"
+
+using namespace blink;
+
+namespace {
+
+// Long enough for whole vectors and a tail, with every alpha value that is
+// special cased.
+const unsigned kPixelCount = 37;
+
+Vector<uint8_t> makeSamples(unsigned channels)
+{
+    Vector<uint8_t> samples(kPixelCount * channels);
+    for (unsigned i = 0; i < samples.size(); ++i)
+        samples[i] = (i * 97 + 13) & 0xFF;
+    if (channels == 4) {
+        samples[3] = 0;
+        samples[7] = 255;
+        samples[11] = 1;
+        samples[kPixelCount * 4 - 1] = 254;
+    }
+    return samples;
+}
+
+TEST(ImageFrameTest, setRGBARowPremultiplyMatchesPixels)
+{
+    Vector<uint8_t> samples = makeSamples(4);
+    Vector<ImageFrame::PixelData> row(kPixelCount);
+    unsigned alphaMask = ImageFrame::setRGBARowPremultiply(row.data(), samples.data(), kPixelCount);
+
+    unsigned expectedAlphaMask = 255;
+    for (unsigned i = 0; i < kPixelCount; ++i) {
+        const uint8_t* pixel = &samples[i * 4];
+        ImageFrame::PixelData expected;
+        ImageFrame::setRGBAPremultiply(&expected, pixel[0], pixel[1], pixel[2], pixel[3]);
+        EXPECT_EQ(expected, row[i]) << "pixel " << i;
+        expectedAlphaMask &= pixel[3];
+    }
+    EXPECT_EQ(expectedAlphaMask, alphaMask);
+}
+
+TEST(ImageFrameTest, setRGBARowRawMatchesPixels)
+{
+    Vector<uint8_t> samples = makeSamples(4);
+    Vector<ImageFrame::PixelData> row(kPixelCount);
+    unsigned alphaMask = ImageFrame::setRGBARowRaw(row.data(), samples.data(), kPixelCount);
+
+    unsigned expectedAlphaMask = 255;
+    for (unsigned i = 0; i < kPixelCount; ++i) {
+        const uint8_t* pixel = &samples[i * 4];
+        ImageFrame::PixelData expected;
+        ImageFrame::setRGBARaw(&expected, pixel[0], pixel[1], pixel[2], pixel[3]);
+        EXPECT_EQ(expected, row[i]) << "pixel " << i;
+        expectedAlphaMask &= pixel[3];
+    }
+    EXPECT_EQ(expectedAlphaMask, alphaMask);
+}
+
+TEST(ImageFrameTest, setRGBARowReportsOpaqueRows)
+{
+    Vector<uint8_t> samples = makeSamples(4);
+    for (unsigned i = 3; i < samples.size(); i += 4)
+        samples[i] = 255;
+    Vector<ImageFrame::PixelData> row(kPixelCount);
+    EXPECT_EQ(255u, ImageFrame::setRGBARowPremultiply(row.data(), samples.data(), kPixelCount));
+}
+
+TEST(ImageFrameTest, setRGBRowMatchesPixels)
+{
+    Vector<uint8_t> samples = makeSamples(3);
+    Vector<ImageFrame::PixelData> row(kPixelCount);
+    ImageFrame::setRGBRow(row.data(), samples.data(), kPixelCount);
+
+    for (unsigned i = 0; i < kPixelCount; ++i) {
+        const uint8_t* pixel = &samples[i * 3];
+        ImageFrame::PixelData expected;
+        ImageFrame::setRGBARaw(&expected, pixel[0], pixel[1], pixel[2], 255);
+        EXPECT_EQ(expected, row[i]) << "pixel " << i;
+    }
+}
+
+} // namespace
@@ -311,9 +311,6 @@ public:
         , m_bytesToSkip(0)
         , m_state(JPEG_HEADER)
         , m_samples(0)
-#if USE(QCMSLIB)
-        , m_transform(0)
-#endif
     {
         memset(&m_info, 0, sizeof(jpeg_decompress_struct));
 
@@ -591,33 +588,13 @@ public:
     JSAMPARRAY samples() const { return m_samples; }
     JPEGImageDecoder* decoder() { return m_decoder; }
 #if USE(QCMSLIB)
-    qcms_transform* colorTransform() const { return m_transform; }
+    qcms_transform* colorTransform() const { return m_transform ? m_transform->transform() : 0; }
 
-    void clearColorTransform()
-    {
-        if (m_transform)
-            qcms_transform_release(m_transform);
-        m_transform = 0;
-    }
+    void clearColorTransform() { m_transform.clear(); }
 
     void createColorTransform(const ColorProfile& colorProfile, bool hasAlpha)
     {
-        clearColorTransform();
-
-        if (colorProfile.isEmpty())
-            return;
-        qcms_profile* deviceProfile = ImageDecoder::qcmsOutputDeviceProfile();
-        if (!deviceProfile)
-            return;
-        qcms_profile* inputProfile = qcms_profile_from_memory(colorProfile.data(), colorProfile.size());
-        if (!inputProfile)
-            return;
-        // We currently only support color profiles for RGB profiled images.
-        ASSERT(rgbData == qcms_profile_get_color_space(inputProfile));
-        qcms_data_type dataFormat = hasAlpha ? QCMS_DATA_RGBA_8 : QCMS_DATA_RGB_8;
-        // FIXME: Don't force perceptual intent if the image profile contains an intent.
-        m_transform = qcms_transform_create(inputProfile, dataFormat, deviceProfile, dataFormat, QCMS_INTENT_PERCEPTUAL);
-        qcms_profile_release(inputProfile);
+        m_transform = ImageDecoder::colorTransform(colorProfile, hasAlpha);
     }
 #endif
 
@@ -633,7 +610,7 @@ private:
     JSAMPARRAY m_samples;
 
 #if USE(QCMSLIB)
-    qcms_transform* m_transform;
+    RefPtr<ColorTransform> m_transform;
 #endif
 };
 
@@ -824,6 +801,10 @@ template <J_COLOR_SPACE colorSpace> bool outputRows(JPEGImageReader* reader, Ima
             qcms_transform_data(reader->colorTransform(), *samples, *samples, width);
 #endif
         ImageFrame::PixelData* pixel = buffer.getAddr(0, y);
+        if (colorSpace == JCS_RGB) {
+            ImageFrame::setRGBRow(pixel, *samples, width);
+            continue;
+        }
         for (int x = 0; x < width; ++pixel, ++x)
             setPixel<colorSpace>(buffer, pixel, samples, x);
     }
@@ -107,7 +107,6 @@ public:
         , m_hasAlpha(false)
         , m_interlaceBuffer(0)
 #if USE(QCMSLIB)
-        , m_transform(0)
         , m_rowBuffer()
 #endif
     {
@@ -171,33 +170,13 @@ public:
 #if USE(QCMSLIB)
     png_bytep rowBuffer() const { return m_rowBuffer.get(); }
     void createRowBuffer(int size) { m_rowBuffer = adoptArrayPtr(new png_byte[size]); }
-    qcms_transform* colorTransform() const { return m_transform; }
+    qcms_transform* colorTransform() const { return m_transform ? m_transform->transform() : 0; }
 
-    void clearColorTransform()
-    {
-        if (m_transform)
-            qcms_transform_release(m_transform);
-        m_transform = 0;
-    }
+    void clearColorTransform() { m_transform.clear(); }
 
     void createColorTransform(const ColorProfile& colorProfile, bool hasAlpha)
     {
-        clearColorTransform();
-
-        if (colorProfile.isEmpty())
-            return;
-        qcms_profile* deviceProfile = ImageDecoder::qcmsOutputDeviceProfile();
-        if (!deviceProfile)
-            return;
-        qcms_profile* inputProfile = qcms_profile_from_memory(colorProfile.data(), colorProfile.size());
-        if (!inputProfile)
-            return;
-        // We currently only support color profiles for RGB and RGBA images.
-        ASSERT(rgbData == qcms_profile_get_color_space(inputProfile));
-        qcms_data_type dataFormat = hasAlpha ? QCMS_DATA_RGBA_8 : QCMS_DATA_RGB_8;
-        // FIXME: Don't force perceptual intent if the image profile contains an intent.
-        m_transform = qcms_transform_create(inputProfile, dataFormat, deviceProfile, dataFormat, QCMS_INTENT_PERCEPTUAL);
-        qcms_profile_release(inputProfile);
+        m_transform = ImageDecoder::colorTransform(colorProfile, hasAlpha);
     }
 #endif
 
@@ -210,7 +189,7 @@ private:
     bool m_hasAlpha;
     png_bytep m_interlaceBuffer;
 #if USE(QCMSLIB)
-    qcms_transform* m_transform;
+    RefPtr<ColorTransform> m_transform;
     OwnPtr<png_byte[]> m_rowBuffer;
 #endif
 };
@@ -488,29 +467,19 @@ void PNGImageDecoder::rowAvailable(unsigned char* rowBuffer, unsigned rowIndex,
     }
 #endif
 
-    // Write the decoded row pixels to the frame buffer. The repetitive
-    // form of the row write loops is for speed.
+    // Write the decoded row pixels to the frame buffer. Gray and palette
+    // images have been expanded to RGB(A) by libpng already.
     ImageFrame::PixelData* address = buffer.getAddr(0, y);
     unsigned alphaMask = 255;
-    int width = size().width();
+    unsigned width = size().width();
 
-    png_bytep pixel = row;
     if (hasAlpha) {
-        if (buffer.premultiplyAlpha()) {
-            for (int x = 0; x < width; ++x, pixel += 4) {
-                buffer.setRGBAPremultiply(address++, pixel[0], pixel[1], pixel[2], pixel[3]);
-                alphaMask &= pixel[3];
-            }
-        } else {
-            for (int x = 0; x < width; ++x, pixel += 4) {
-                buffer.setRGBARaw(address++, pixel[0], pixel[1], pixel[2], pixel[3]);
-                alphaMask &= pixel[3];
-            }
-        }
+        if (buffer.premultiplyAlpha())
+            alphaMask = ImageFrame::setRGBARowPremultiply(address, row, width);
+        else
+            alphaMask = ImageFrame::setRGBARowRaw(address, row, width);
     } else {
-        for (int x = 0; x < width; ++x, pixel += 3) {
-            buffer.setRGBARaw(address++, pixel[0], pixel[1], pixel[2], 255);
-        }
+        ImageFrame::setRGBRow(address, row, width);
     }
 
     if (alphaMask != 255 && !buffer.hasAlpha())
@@ -37,7 +37,7 @@ void* BidiCharacterRun::operator new(size_t sz)
 #ifndef NDEBUG
     bidiRunCounter.increment();
 #endif
-    return partitionAlloc(Partitions::getRenderingPartition(), sz);
+    return partitionAlloc(Partitions::getLineLayoutPartition(), sz);
 }
 
 void BidiCharacterRun::operator delete(void* ptr)
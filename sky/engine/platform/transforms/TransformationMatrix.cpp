@@ -39,6 +39,8 @@
 
 #if CPU(X86_64)
 #include <emmintrin.h>
+#elif CPU(ARM64)
+#include <arm_neon.h>
 #endif
 
 namespace blink {
@@ -671,6 +673,9 @@ FloatPoint TransformationMatrix::mapPoint(const FloatPoint& p) const
     if (isIdentityOrTranslation())
         return FloatPoint(p.x() + static_cast<float>(m_matrix[3][0]), p.y() + static_cast<float>(m_matrix[3][1]));
 
+    if (isAffine())
+        return internalMapAffinePoint(p);
+
     return internalMapPoint(p);
 }
 
@@ -706,6 +711,14 @@ FloatRect TransformationMatrix::mapRect(const FloatRect& r) const
 
     float maxX = r.maxX();
     float maxY = r.maxY();
+    if (isAffine()) {
+        result.setP1(internalMapAffinePoint(FloatPoint(r.x(), r.y())));
+        result.setP2(internalMapAffinePoint(FloatPoint(maxX, r.y())));
+        result.setP3(internalMapAffinePoint(FloatPoint(maxX, maxY)));
+        result.setP4(internalMapAffinePoint(FloatPoint(r.x(), maxY)));
+        return result.boundingBox();
+    }
+
     result.setP1(internalMapPoint(FloatPoint(r.x(), r.y())));
     result.setP2(internalMapPoint(FloatPoint(maxX, r.y())));
     result.setP3(internalMapPoint(FloatPoint(maxX, maxY)));
@@ -723,6 +736,14 @@ FloatQuad TransformationMatrix::mapQuad(const FloatQuad& q) const
     }
 
     FloatQuad result;
+    if (isAffine()) {
+        result.setP1(internalMapAffinePoint(q.p1()));
+        result.setP2(internalMapAffinePoint(q.p2()));
+        result.setP3(internalMapAffinePoint(q.p3()));
+        result.setP4(internalMapAffinePoint(q.p4()));
+        return result;
+    }
+
     result.setP1(internalMapPoint(q.p1()));
     result.setP2(internalMapPoint(q.p2()));
     result.setP3(internalMapPoint(q.p3()));
@@ -993,9 +1014,37 @@ TransformationMatrix TransformationMatrix::rectToRect(const FloatRect& from, con
                                 to.y() - from.y());
 }
 
+void TransformationMatrix::multiplyAffine(const TransformationMatrix& mat)
+{
+    ASSERT(isAffine() && mat.isAffine());
+
+    // Only the 2x3 part of an affine matrix is not fixed, and the product of
+    // two affine matrices is affine, so the other ten entries stay as they are.
+    double m00 = mat.m_matrix[0][0] * m_matrix[0][0] + mat.m_matrix[0][1] * m_matrix[1][0];
+    double m01 = mat.m_matrix[0][0] * m_matrix[0][1] + mat.m_matrix[0][1] * m_matrix[1][1];
+    double m10 = mat.m_matrix[1][0] * m_matrix[0][0] + mat.m_matrix[1][1] * m_matrix[1][0];
+    double m11 = mat.m_matrix[1][0] * m_matrix[0][1] + mat.m_matrix[1][1] * m_matrix[1][1];
+    double m30 = mat.m_matrix[3][0] * m_matrix[0][0] + mat.m_matrix[3][1] * m_matrix[1][0] + m_matrix[3][0];
+    double m31 = mat.m_matrix[3][0] * m_matrix[0][1] + mat.m_matrix[3][1] * m_matrix[1][1] + m_matrix[3][1];
+
+    m_matrix[0][0] = m00;
+    m_matrix[0][1] = m01;
+    m_matrix[1][0] = m10;
+    m_matrix[1][1] = m11;
+    m_matrix[3][0] = m30;
+    m_matrix[3][1] = m31;
+}
+
 // this = mat * this.
 TransformationMatrix& TransformationMatrix::multiply(const TransformationMatrix& mat)
 {
+    // Most transforms are 2D, and their product takes 12 multiplications
+    // instead of 64.
+    if (isAffine() && mat.isAffine()) {
+        multiplyAffine(mat);
+        return *this;
+    }
+
 #if CPU(APPLE_ARMV7S)
     double* leftMatrix = &(m_matrix[0][0]);
     const double* rightMatrix = &(mat.m_matrix[0][0]);
@@ -1221,6 +1270,29 @@ TransformationMatrix& TransformationMatrix::multiply(const TransformationMatrix&
     accumulator = _mm_add_pd(accumulator, temp2);
     accumulator = _mm_add_pd(accumulator, temp3);
     _mm_store_pd(&m_matrix[3][2], accumulator);
+#elif defined(TRANSFORMATION_MATRIX_USE_ARM64_NEON)
+    // Same scheme as the SSE2 version above: every row of the result is the
+    // rows of this matrix weighted by one row of |mat|, computed two columns
+    // at a time. All of this matrix is loaded before the result is stored
+    // over it. Row i of |mat| is read before row i is stored, so |mat| may
+    // be this matrix.
+    float64x2_t rowsLow[4];
+    float64x2_t rowsHigh[4];
+    for (int i = 0; i < 4; ++i) {
+        rowsLow[i] = vld1q_f64(&m_matrix[i][0]);
+        rowsHigh[i] = vld1q_f64(&m_matrix[i][2]);
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        float64x2_t low = vmulq_n_f64(rowsLow[0], mat.m_matrix[i][0]);
+        float64x2_t high = vmulq_n_f64(rowsHigh[0], mat.m_matrix[i][0]);
+        for (int j = 1; j < 4; ++j) {
+            low = vaddq_f64(low, vmulq_n_f64(rowsLow[j], mat.m_matrix[i][j]));
+            high = vaddq_f64(high, vmulq_n_f64(rowsHigh[j], mat.m_matrix[i][j]));
+        }
+        vst1q_f64(&m_matrix[i][0], low);
+        vst1q_f64(&m_matrix[i][2], high);
+    }
 #else
     Matrix4 tmp;
 
@@ -44,13 +44,15 @@ class FloatQuad;
 class FloatBox;
 #if CPU(X86_64)
 #define TRANSFORMATION_MATRIX_USE_X86_64_SSE2
+#elif CPU(ARM64)
+#define TRANSFORMATION_MATRIX_USE_ARM64_NEON
 #endif
 
 class PLATFORM_EXPORT TransformationMatrix {
     WTF_MAKE_FAST_ALLOCATED;
 public:
 
-#if CPU(APPLE_ARMV7S) || defined(TRANSFORMATION_MATRIX_USE_X86_64_SSE2)
+#if CPU(APPLE_ARMV7S) || defined(TRANSFORMATION_MATRIX_USE_X86_64_SSE2) || defined(TRANSFORMATION_MATRIX_USE_ARM64_NEON)
     typedef double Matrix4[4][4] __attribute__((aligned (16)));
 #else
     typedef double Matrix4[4][4];
@@ -331,6 +333,19 @@ private:
         return FloatPoint(static_cast<float>(resultX), static_cast<float>(resultY));
     }
 
+    // Maps a point through a matrix that isAffine(), which needs neither the
+    // perspective terms nor the divide by w.
+    FloatPoint internalMapAffinePoint(const FloatPoint& sourcePoint) const
+    {
+        double x = sourcePoint.x();
+        double y = sourcePoint.y();
+        return FloatPoint(static_cast<float>(m_matrix[3][0] + x * m_matrix[0][0] + y * m_matrix[1][0]),
+            static_cast<float>(m_matrix[3][1] + x * m_matrix[0][1] + y * m_matrix[1][1]));
+    }
+
+    // this = mat * this, for two matrices that are isAffine().
+    void multiplyAffine(const TransformationMatrix& mat);
+
     // multiply passed 3D point by matrix
     void multVecMatrix(double x, double y, double z, double& dstX, double& dstY, double& dstZ) const;
     FloatPoint3D internalMapPoint(const FloatPoint3D& sourcePoint) const
@@ -43,6 +43,7 @@ class GrContext;
 
 namespace base {
 class SingleThreadTaskRunner;
+class TaskRunner;
 }
 
 namespace blink {
@@ -173,6 +174,20 @@ public:
 
     virtual base::SingleThreadTaskRunner* mainThreadTaskRunner() { return 0; }
 
+    enum WorkerTaskPriority {
+        // Work that something on screen is waiting for, such as decoding an
+        // image.
+        UserBlockingWorkerTask,
+        // Work nobody is waiting for, such as writing a cache.
+        BackgroundWorkerTask,
+    };
+
+    // Runs tasks that may block on disk or take a while on a pool of worker
+    // threads. The tasks must not wait on each other, or on a data pipe,
+    // since the pool has as many threads as there are cores. Defaults to
+    // base::WorkerPool.
+    BLINK_PLATFORM_EXPORT virtual base::TaskRunner* workerTaskRunner(WorkerTaskPriority);
+
 
     // Vibration -----------------------------------------------------------
 
@@ -41,7 +41,12 @@ void SkyView::CreateView(const String& name) {
   DCHECK(!dart_controller_);
 
   view_ = View::create(
-      base::Bind(&SkyView::ScheduleFrame, weak_factory_.GetWeakPtr()));
+      base::Bind(&SkyView::ScheduleFrame, weak_factory_.GetWeakPtr()),
+      base::Bind(&SkyView::RasterizeToImage, weak_factory_.GetWeakPtr()),
+      // Callbacks with a result cannot be bound to a weak pointer. The view
+      // only runs it from Dart, and the isolate goes away with |this|.
+      base::Bind(&SkyView::GetCompositorStatistics, base::Unretained(this)),
+      base::Bind(&SkyView::GetScrollOffset, base::Unretained(this)));
   view_->setDisplayMetrics(display_metrics_);
 
   dart_controller_ = adoptPtr(new DartController);
@@ -60,15 +65,36 @@ void SkyView::RunFromLibrary(const WebString& name,
   dart_controller_->RunFromLibrary(name, library_provider);
 }
 
+void SkyView::RunFromLibraryAndSnapshot(
+    const WebString& name,
+    DartLibraryProvider* library_provider,
+    const DartController::ScriptSnapshotCallback& callback) {
+  DCHECK(view_);
+  dart_controller_->RunFromLibraryAndSnapshot(name, library_provider,
+                                              callback);
+}
+
 void SkyView::RunFromSnapshot(const WebString& name,
                               mojo::ScopedDataPipeConsumerHandle snapshot) {
   DCHECK(view_);
   dart_controller_->RunFromSnapshot(snapshot.Pass());
 }
 
+void SkyView::RunFromSnapshotFile(const WebString& name,
+                                  const base::FilePath& path) {
+  DCHECK(view_);
+  dart_controller_->RunFromSnapshotFile(path);
+}
+
 std::unique_ptr<sky::compositor::LayerTree> SkyView::BeginFrame(
-    base::TimeTicks frame_time) {
-  return view_->beginFrame(frame_time);
+    base::TimeTicks frame_time,
+    base::TimeTicks deadline) {
+  return view_->beginFrame(frame_time, deadline);
+}
+
+void SkyView::NotifyIdle(base::TimeTicks deadline) {
+  TRACE_EVENT0("sky", "SkyView::NotifyIdle");
+  view_->notifyIdle(deadline);
 }
 
 void SkyView::HandleInputEvent(const WebInputEvent& inputEvent) {
@@ -92,10 +118,42 @@ void SkyView::HandleInputEvent(const WebInputEvent& inputEvent) {
 
 }
 
+void SkyView::HandlePointerPacket(const std::vector<WebPointerEvent>& events) {
+  TRACE_EVENT0("input", "SkyView::HandlePointerPacket");
+
+  if (!view_->hasPointerPacketCallback()) {
+    for (const WebPointerEvent& event : events)
+      view_->handleInputEvent(PointerEvent::create(event));
+    return;
+  }
+
+  DartIsolateScope scope(dart_controller_->dart_state()->isolate());
+  DartApiScope api_scope;
+  view_->handlePointerPacket(events);
+}
+
+bool SkyView::HasPointerPacketCallback() const {
+  return view_->hasPointerPacketCallback();
+}
+
 void SkyView::ScheduleFrame() {
   client_->ScheduleFrame();
 }
 
+void SkyView::RasterizeToImage(
+    scoped_ptr<sky::compositor::LayerTree> layer_tree,
+    const SkyViewClient::ImageCallback& callback) {
+  client_->RasterizeToImage(layer_tree.Pass(), callback);
+}
+
+sky::compositor::CompositorStatistics SkyView::GetCompositorStatistics() {
+  return client_->GetCompositorStatistics();
+}
+
+bool SkyView::GetScrollOffset(uint32_t scroll_id, SkPoint* offset) {
+  return client_->GetScrollOffset(scroll_id, offset);
+}
+
 void SkyView::StartDartTracing() {
   dart_controller_->StartTracing();
 }
@@ -6,26 +6,30 @@
 #define SKY_ENGINE_PUBLIC_SKY_SKY_VIEW_H_
 
 #include <memory>
+#include <vector>
 
+#include "base/files/file_path.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
 #include "mojo/public/cpp/system/data_pipe.h"
 #include "mojo/services/network/public/interfaces/url_loader.mojom.h"
 #include "sky/compositor/layer_tree.h"
+#include "sky/engine/core/script/dart_controller.h"
 #include "sky/engine/public/platform/WebCommon.h"
 #include "sky/engine/public/platform/WebURL.h"
 #include "sky/engine/public/platform/sky_display_metrics.h"
+#include "sky/engine/public/sky/sky_view_client.h"
 #include "sky/engine/wtf/OwnPtr.h"
 #include "sky/engine/wtf/RefPtr.h"
 #include "sky/engine/wtf/text/WTFString.h"
 #include "third_party/skia/include/core/SkPicture.h"
 
 namespace blink {
-class DartController;
 class DartLibraryProvider;
-class SkyViewClient;
 class View;
 class WebInputEvent;
+class WebPointerEvent;
 
 class SkyView {
  public:
@@ -35,17 +39,34 @@ class SkyView {
   const SkyDisplayMetrics& display_metrics() const { return display_metrics_; }
   void SetDisplayMetrics(const SkyDisplayMetrics& metrics);
 
+  // |deadline| may be null if the embedder does not predict frame deadlines.
   std::unique_ptr<sky::compositor::LayerTree> BeginFrame(
-      base::TimeTicks frame_time);
+      base::TimeTicks frame_time,
+      base::TimeTicks deadline);
+
+  // Lets the view do low priority work until |deadline|.
+  void NotifyIdle(base::TimeTicks deadline);
 
   void CreateView(const String& name);
 
   void RunFromLibrary(const WebString& name,
                       DartLibraryProvider* library_provider);
+  // Like RunFromLibrary, but also hands |callback| a script snapshot of the
+  // app, so that the next launch can use RunFromSnapshotFile instead.
+  void RunFromLibraryAndSnapshot(
+      const WebString& name,
+      DartLibraryProvider* library_provider,
+      const DartController::ScriptSnapshotCallback& callback);
   void RunFromSnapshot(const WebString& name,
                        mojo::ScopedDataPipeConsumerHandle snapshot);
+  // Maps the snapshot into memory rather than copying it out of a pipe.
+  void RunFromSnapshotFile(const WebString& name, const base::FilePath& path);
 
   void HandleInputEvent(const WebInputEvent& event);
+  // Delivers all of |events| to the app in one call if it registered a
+  // pointer packet callback, and one event at a time otherwise.
+  void HandlePointerPacket(const std::vector<WebPointerEvent>& events);
+  bool HasPointerPacketCallback() const;
 
   void StartDartTracing();
   void StopDartTracing(mojo::ScopedDataPipeProducerHandle producer);
@@ -54,6 +75,10 @@ class SkyView {
   explicit SkyView(SkyViewClient* client);
 
   void ScheduleFrame();
+  void RasterizeToImage(scoped_ptr<sky::compositor::LayerTree> layer_tree,
+                        const SkyViewClient::ImageCallback& callback);
+  sky::compositor::CompositorStatistics GetCompositorStatistics();
+  bool GetScrollOffset(uint32_t scroll_id, SkPoint* offset);
 
   SkyViewClient* client_;
   SkyDisplayMetrics display_metrics_;
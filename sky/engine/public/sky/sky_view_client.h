@@ -5,16 +5,49 @@
 #ifndef SKY_ENGINE_PUBLIC_SKY_SKY_VIEW_CLIENT_H_
 #define SKY_ENGINE_PUBLIC_SKY_SKY_VIEW_CLIENT_H_
 
+#include "base/callback.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/single_thread_task_runner.h"
+#include "sky/compositor/compositor_statistics.h"
+#include "sky/compositor/layer_tree.h"
+#include "sky/engine/wtf/RefPtr.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkPoint.h"
+
 typedef struct _Dart_Isolate* Dart_Isolate;
 
 namespace blink {
 
 class SkyViewClient {
  public:
+  // Receives a GPU backed image along with the task runner of the thread
+  // that owns its texture. The last reference to the image has to be
+  // dropped on that thread.
+  typedef base::Callback<void(RefPtr<SkImage>,
+                              scoped_refptr<base::SingleThreadTaskRunner>)>
+      ImageCallback;
+
   virtual void ScheduleFrame() = 0;
 
   virtual void DidCreateIsolate(Dart_Isolate isolate) = 0;
 
+  // Rasterizes |layer_tree| into an offscreen image of its frame size
+  // without reading the pixels back, and calls |callback| with it on the
+  // calling thread. The image is null if it could not be made.
+  virtual void RasterizeToImage(
+      scoped_ptr<sky::compositor::LayerTree> layer_tree,
+      const ImageCallback& callback) = 0;
+
+  // The statistics of the compositor that draws the view's frames. Called
+  // synchronously from Dart, so it must not block on the GPU thread.
+  virtual sky::compositor::CompositorStatistics GetCompositorStatistics() = 0;
+
+  // Sets |offset| to where the compositor scrolled the scroll layer with
+  // |scroll_id| and returns true, or returns false if it has not drawn one.
+  // Called synchronously from Dart as well.
+  virtual bool GetScrollOffset(uint32_t scroll_id, SkPoint* offset) = 0;
+
  protected:
   virtual ~SkyViewClient();
 };
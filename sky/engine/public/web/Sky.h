@@ -33,6 +33,8 @@
 
 #include "../platform/Platform.h"
 
+#include "base/memory/memory_pressure_listener.h"
+
 namespace blink {
 
 // Must be called on the thread that will be the main WebKit thread before
@@ -46,6 +48,17 @@ BLINK_EXPORT void initialize(Platform*);
 // terminated by the time this function returns.
 BLINK_EXPORT void shutdown();
 
+// Frees the font and image decoder caches shared by every view, more of them
+// the higher |level| is, and returns the number of bytes that are known to
+// have been freed. Has to be called on the main WebKit thread.
+BLINK_EXPORT size_t purgeMemory(base::MemoryPressureListener::MemoryPressureLevel level);
+
+// Records the call stack of about one allocation in every
+// |sampleIntervalBytes| bytes the engine allocates into the trace, for heap
+// profiling. Slows every allocation down while it is on.
+BLINK_EXPORT void startAllocationSampling(size_t sampleIntervalBytes);
+BLINK_EXPORT void stopAllocationSampling();
+
 // Alters the rendering of content to conform to a fixed set of rules.
 BLINK_EXPORT void setLayoutTestMode(bool);
 BLINK_EXPORT bool layoutTestMode();
@@ -40,6 +40,10 @@ namespace blink {
 class WebRuntimeFeatures {
 public:
     BLINK_EXPORT static void enableExperimentalFeatures(bool);
+
+    // Decodes large images into discardable memory on demand. Needs a
+    // base::DiscardableMemoryAllocator that actually discards memory.
+    BLINK_EXPORT static void enableDeferredImageDecoding(bool);
     BLINK_EXPORT static void enableTestOnlyFeatures(bool);
 
     BLINK_EXPORT static void enableDatabase(bool);
@@ -96,6 +100,14 @@ public:
 
     BLINK_EXPORT static void enableDartCheckedMode(bool);
 
+    // Compiles all of the app's code before main runs, instead of every
+    // function the first time it is called.
+    BLINK_EXPORT static void enableDartCompileAll(bool);
+
+    // Decodes images with the color profiles they embed applied, instead of
+    // taking their pixels as sRGB.
+    BLINK_EXPORT static void enableColorManagedImages(bool);
+
 private:
     WebRuntimeFeatures();
 };
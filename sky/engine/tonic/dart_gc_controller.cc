@@ -4,6 +4,8 @@
 
 #include "sky/engine/tonic/dart_gc_controller.h"
 
+#include "base/lazy_instance.h"
+#include "base/threading/thread_local.h"
 #include "base/trace_event/trace_event.h"
 #include "dart/runtime/include/dart_api.h"
 #include "sky/engine/tonic/dart_gc_context.h"
@@ -15,6 +17,23 @@ namespace {
 
 DartGCContext* g_gc_context = nullptr;
 
+struct DartGCTimer {
+  base::TimeTicks pause_start;
+  DartGCStats stats;
+};
+
+base::LazyInstance<base::ThreadLocalPointer<DartGCTimer>>::Leaky g_gc_timer =
+    LAZY_INSTANCE_INITIALIZER;
+
+DartGCTimer* GetTimer() {
+  DartGCTimer* timer = g_gc_timer.Get().Get();
+  if (!timer) {
+    timer = new DartGCTimer();
+    g_gc_timer.Get().Set(timer);
+  }
+  return timer;
+}
+
 DartWrappable* GetWrappable(intptr_t* fields) {
   return reinterpret_cast<DartWrappable*>(fields[DartWrappable::kPeerIndex]);
 }
@@ -33,7 +52,10 @@ void Visit(void* isolate_callback_data,
 }  // namespace
 
 void DartGCPrologue() {
-  TRACE_EVENT_ASYNC_BEGIN0("sky", "DartGC", 0);
+  // Collections pause the isolate's thread, so they are traced as regular
+  // slices that show up next to the frame work they interrupt.
+  TRACE_EVENT_BEGIN0("sky", "DartGC");
+  GetTimer()->pause_start = base::TimeTicks::Now();
 
   Dart_EnterScope();
   DCHECK(!g_gc_context);
@@ -46,7 +68,18 @@ void DartGCEpilogue() {
   g_gc_context = nullptr;
   Dart_ExitScope();
 
-  TRACE_EVENT_ASYNC_END0("sky", "DartGC", 0);
+  DartGCTimer* timer = GetTimer();
+  const base::TimeDelta pause = base::TimeTicks::Now() - timer->pause_start;
+  timer->stats.collection_count++;
+  timer->stats.last_pause = pause;
+  timer->stats.total_pause += pause;
+
+  TRACE_EVENT_END1("sky", "DartGC", "pause_us", pause.InMicroseconds());
+  TRACE_COUNTER1("sky", "DartGCPauseUs", pause.InMicroseconds());
+}
+
+const DartGCStats& GetDartGCStats() {
+  return GetTimer()->stats;
 }
 
 }  // namespace blink
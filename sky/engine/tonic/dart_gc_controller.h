@@ -5,11 +5,27 @@
 #ifndef SKY_ENGINE_TONIC_DART_GC_CONTROLLER_H_
 #define SKY_ENGINE_TONIC_DART_GC_CONTROLLER_H_
 
+#include "base/time/time.h"
+
 namespace blink {
 
+// The GC prologue and epilogue callbacks for isolates whose wrappers take
+// part in garbage collection. Register them with Dart_SetGcCallbacks.
 void DartGCPrologue();
 void DartGCEpilogue();
 
+struct DartGCStats {
+  DartGCStats() : collection_count(0) {}
+
+  int64_t collection_count;
+  base::TimeDelta last_pause;
+  base::TimeDelta total_pause;
+};
+
+// Pause statistics of the collections seen by DartGCPrologue and
+// DartGCEpilogue on the calling thread's isolates.
+const DartGCStats& GetDartGCStats();
+
 }  // namespace blink
 
 #endif  // SKY_ENGINE_TONIC_DART_GC_CONTROLLER_H_
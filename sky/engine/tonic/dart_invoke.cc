@@ -4,16 +4,69 @@
 
 #include "sky/engine/tonic/dart_invoke.h"
 
+#include <algorithm>
+#include <string>
+
+#include "base/atomicops.h"
+#include "base/basictypes.h"
 #include "base/logging.h"
 #include "base/trace_event/trace_event.h"
+#include "sky/engine/tonic/dart_converter.h"
 #include "sky/engine/tonic/dart_error.h"
 
 namespace blink {
+namespace {
+
+// In microseconds. Zero while profiling is disabled. 32 bits so that it can
+// be accessed atomically on every platform.
+base::subtle::Atomic32 g_slow_invoke_threshold_us = 0;
+
+// Times one invocation and reports it if it was slow. |callee| is only
+// stringified for slow invocations.
+class ScopedInvokeProfile {
+ public:
+  ScopedInvokeProfile(const char* kind, Dart_Handle callee)
+      : kind_(kind),
+        callee_(callee),
+        threshold_us_(
+            base::subtle::NoBarrier_Load(&g_slow_invoke_threshold_us)) {
+    if (threshold_us_)
+      start_ = base::TimeTicks::Now();
+  }
+
+  ~ScopedInvokeProfile() {
+    if (!threshold_us_)
+      return;
+    const int64_t duration_us =
+        (base::TimeTicks::Now() - start_).InMicroseconds();
+    if (duration_us < threshold_us_)
+      return;
+    Dart_Handle description = Dart_ToString(callee_);
+    const std::string name = Dart_IsError(description)
+                                 ? std::string("<unknown>")
+                                 : StdStringFromDart(description);
+    TRACE_EVENT_INSTANT3("sky", "DartInvoke::SlowInvoke",
+                         TRACE_EVENT_SCOPE_THREAD, "kind", kind_, "callee",
+                         TRACE_STR_COPY(name.c_str()), "duration_us",
+                         duration_us);
+  }
+
+ private:
+  const char* kind_;
+  Dart_Handle callee_;
+  const base::subtle::Atomic32 threshold_us_;
+  base::TimeTicks start_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScopedInvokeProfile);
+};
+
+}  // namespace
 
 bool DartInvokeAppField(Dart_Handle target, Dart_Handle name,
                                int number_of_arguments,
                                Dart_Handle* arguments) {
   TRACE_EVENT0("sky", "DartInvoke::DartInvokeAppField");
+  ScopedInvokeProfile profile("field", name);
   return LogIfError(Dart_Invoke(target, name, number_of_arguments, arguments));
 }
 
@@ -21,8 +74,22 @@ bool DartInvokeAppClosure(Dart_Handle closure,
                           int number_of_arguments,
                           Dart_Handle* arguments) {
   TRACE_EVENT0("sky", "DartInvoke::DartInvokeAppClosure");
+  ScopedInvokeProfile profile("closure", closure);
   return LogIfError(
       Dart_InvokeClosure(closure, number_of_arguments, arguments));
 }
 
+void EnableDartInvokeProfiling(base::TimeDelta threshold) {
+  // A zero threshold would read as disabled, so round it up.
+  const int64_t threshold_us = std::min<int64_t>(
+      std::max<int64_t>(1, threshold.InMicroseconds()), kint32max);
+  base::subtle::NoBarrier_Store(
+      &g_slow_invoke_threshold_us,
+      static_cast<base::subtle::Atomic32>(threshold_us));
+}
+
+void DisableDartInvokeProfiling() {
+  base::subtle::NoBarrier_Store(&g_slow_invoke_threshold_us, 0);
+}
+
 }  // namespace blink
@@ -5,6 +5,7 @@
 #ifndef SKY_ENGINE_TONIC_DART_INVOKE_H_
 #define SKY_ENGINE_TONIC_DART_INVOKE_H_
 
+#include "base/time/time.h"
 #include "dart/runtime/include/dart_api.h"
 
 namespace blink {
@@ -17,7 +18,13 @@ bool DartInvokeAppClosure(Dart_Handle closure,
                           int number_of_arguments,
                           Dart_Handle* arguments);
 
+// While enabled, invocations that run for longer than |threshold| emit a
+// trace event naming the closure or field they called, so that callbacks
+// that blow the frame budget can be told apart in a trace. Only slow
+// invocations pay for working out the name. Can be called from any thread.
+void EnableDartInvokeProfiling(base::TimeDelta threshold);
+void DisableDartInvokeProfiling();
+
 }  // namespace blink
 
 #endif  // SKY_ENGINE_TONIC_DART_INVOKE_H_
-
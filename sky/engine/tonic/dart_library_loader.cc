@@ -4,7 +4,15 @@
 
 #include "sky/engine/tonic/dart_library_loader.h"
 
+#include <ctype.h>
+
+#include <algorithm>
+
+#include "base/bind.h"
 #include "base/callback.h"
+#include "base/message_loop/message_loop.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
 #include "base/trace_event/trace_event.h"
 #include "mojo/data_pipe_utils/data_pipe_drainer.h"
 #include "sky/engine/tonic/dart_api_scope.h"
@@ -21,6 +29,9 @@ namespace blink {
 
 namespace {
 
+// Fetches beyond this many wait for earlier ones to finish.
+const size_t kDefaultMaxFetchesInFlight = 8;
+
 // Helper to erase a T* from a container of std::unique_ptr<T>s.
 template<typename T, typename C>
 void EraseUniquePtr(C& container, T* item) {
@@ -29,31 +40,148 @@ void EraseUniquePtr(C& container, T* item) {
   key.release();
 }
 
+bool IsIdentifierChar(uint8_t c) {
+  return isalnum(c) || c == '_' || c == '$';
+}
+
+// Returns the offset of the first character at or after |offset| that is not
+// whitespace or part of a comment, or std::string::npos if the buffer ends in
+// the middle of a comment.
+size_t SkipTrivia(const std::vector<uint8_t>& buffer, size_t offset) {
+  size_t end = buffer.size();
+  while (offset < end) {
+    uint8_t c = buffer[offset];
+    if (isspace(c)) {
+      ++offset;
+      continue;
+    }
+    if (c != '/')
+      return offset;
+    if (offset + 1 == end)
+      return std::string::npos;
+    if (buffer[offset + 1] == '/') {
+      while (offset < end && buffer[offset] != '\n')
+        ++offset;
+      if (offset == end)
+        return std::string::npos;
+    } else if (buffer[offset + 1] == '*') {
+      offset += 2;
+      while (offset + 1 < end &&
+             !(buffer[offset] == '*' && buffer[offset + 1] == '/'))
+        ++offset;
+      if (offset + 1 >= end)
+        return std::string::npos;
+      offset += 2;
+    } else {
+      return offset;
+    }
+  }
+  return offset;
+}
+
+// Collects the URLs of the import, export and part directives at the top of
+// a Dart library whose data has arrived up to the end of |buffer|. Scanning
+// resumes at |*offset| and stops before the first directive that has not
+// completely arrived yet, where the next call picks up. Once the scan reaches
+// the first declaration, there are no more directives and |*done| is set.
+void ScanDirectives(const std::vector<uint8_t>& buffer,
+                    size_t* offset,
+                    bool* done,
+                    std::vector<std::string>* urls) {
+  size_t end = buffer.size();
+  size_t pos = *offset;
+  if (pos == 0 && end >= 2 && buffer[0] == '#' && buffer[1] == '!') {
+    while (pos < end && buffer[pos] != '\n')
+      ++pos;
+    if (pos == end)
+      return;
+  }
+
+  while (true) {
+    *offset = pos;
+    pos = SkipTrivia(buffer, pos);
+    if (pos == std::string::npos || pos == end)
+      return;
+
+    size_t word_start = pos;
+    while (pos < end && IsIdentifierChar(buffer[pos]))
+      ++pos;
+    if (pos == end)
+      return;
+    std::string word(buffer.begin() + word_start, buffer.begin() + pos);
+    if (word != "library" && word != "import" && word != "export" &&
+        word != "part") {
+      *done = true;
+      return;
+    }
+
+    size_t semicolon = pos;
+    while (semicolon < end && buffer[semicolon] != ';')
+      ++semicolon;
+    if (semicolon == end)
+      return;
+
+    size_t quote = pos;
+    while (quote < semicolon && buffer[quote] != '\'' && buffer[quote] != '"')
+      ++quote;
+    if (word != "library" && quote < semicolon) {
+      size_t url_end = quote + 1;
+      while (url_end < semicolon && buffer[url_end] != buffer[quote])
+        ++url_end;
+      // "part of" names the library a part belongs to, not a file to load.
+      size_t next = SkipTrivia(buffer, pos);
+      bool is_part_of = word == "part" && next != std::string::npos &&
+                        next + 2 < end && buffer[next] == 'o' &&
+                        buffer[next + 1] == 'f' &&
+                        !IsIdentifierChar(buffer[next + 2]);
+      if (url_end < semicolon && !is_part_of)
+        urls->push_back(std::string(buffer.begin() + quote + 1,
+                                    buffer.begin() + url_end));
+    }
+    pos = semicolon + 1;
+  }
+}
+
 }
 
-// A DartLibraryLoader::Job represents a network load. It fetches data from the
-// network and buffers the data in std::vector. To cancel the job, delete this
-// object.
-class DartLibraryLoader::Job : public DartDependency,
-                               public DataPipeDrainer::Client {
+// A DartLibraryLoader::Fetch buffers the data of a library or a part in a
+// std::vector. A fetch starts either when Dart asks for the library or, as a
+// prefetch, when an import of it is found at the top of a library that is
+// still arriving. Once Dart asks for the library, a Job takes over the fetch.
+class DartLibraryLoader::Fetch : public DataPipeDrainer::Client {
  public:
-  Job(DartLibraryLoader* loader, const std::string& name)
-      : loader_(loader), name_(name), weak_factory_(this) {
-    loader->library_provider()->GetLibraryAsStream(
-        name, base::Bind(&Job::OnStreamAvailable, weak_factory_.GetWeakPtr()));
+  Fetch(DartLibraryLoader* loader, const std::string& name)
+      : loader_(loader),
+        name_(name),
+        job_(nullptr),
+        started_(false),
+        done_(false),
+        failed_(false),
+        scan_offset_(0),
+        scan_done_(false),
+        weak_factory_(this) {}
+
+  void Start() {
+    DCHECK(!started_);
+    started_ = true;
+    loader_->library_provider()->GetLibraryAsStream(
+        name_,
+        base::Bind(&Fetch::OnStreamAvailable, weak_factory_.GetWeakPtr()));
   }
 
   const std::string& name() const { return name_; }
+  const std::vector<uint8_t>& buffer() const { return buffer_; }
+  bool started() const { return started_; }
+  bool done() const { return done_; }
+  bool failed() const { return failed_; }
 
- protected:
-  DartLibraryLoader* loader_;
-  // TODO(abarth): Should we be using SharedBuffer to buffer the data?
-  std::vector<uint8_t> buffer_;
+  Job* job() const { return job_; }
+  void set_job(Job* job) { job_ = job; }
 
  private:
   void OnStreamAvailable(mojo::ScopedDataPipeConsumerHandle pipe) {
     if (!pipe.is_valid()) {
-      loader_->DidFailJob(this);
+      Finish(false);
       return;
     }
     drainer_ = adoptPtr(new DataPipeDrainer(this, pipe.Pass()));
@@ -63,28 +191,100 @@ class DartLibraryLoader::Job : public DartDependency,
   void OnDataAvailable(const void* data, size_t num_bytes) override {
     const uint8_t* bytes = static_cast<const uint8_t*>(data);
     buffer_.insert(buffer_.end(), bytes, bytes + num_bytes);
+    if (!scan_done_)
+      ScanForImports();
+  }
+
+  void OnDataComplete() override { Finish(true); }
+
+  void ScanForImports() {
+    std::vector<std::string> urls;
+    ScanDirectives(buffer_, &scan_offset_, &scan_done_, &urls);
+    for (const auto& url : urls) {
+      loader_->Prefetch(
+          loader_->library_provider()->CanonicalizeURLForPrefetch(name_, url));
+    }
   }
-  // Subclasses must implement OnDataComplete.
 
+  void Finish(bool success) {
+    done_ = true;
+    failed_ = !success;
+    // This object might be deleted by the time this returns.
+    loader_->DidFinishFetch(this);
+  }
+
+  DartLibraryLoader* loader_;
   std::string name_;
+  Job* job_;
+  bool started_;
+  bool done_;
+  bool failed_;
+  // TODO(abarth): Should we be using SharedBuffer to buffer the data?
+  std::vector<uint8_t> buffer_;
+  size_t scan_offset_;
+  bool scan_done_;
   OwnPtr<DataPipeDrainer> drainer_;
 
+  base::WeakPtrFactory<Fetch> weak_factory_;
+};
+
+// A DartLibraryLoader::Job represents a library or part that Dart asked for.
+// Its data comes from a Fetch, which might have started, or even finished,
+// before Dart asked. To cancel the job, delete this object.
+class DartLibraryLoader::Job : public DartDependency {
+ public:
+  Job(DartLibraryLoader* loader, const std::string& name)
+      : loader_(loader), fetch_(loader->TakeFetch(name)), weak_factory_(this) {
+    fetch_->set_job(this);
+    // Dart asks for libraries while it is loading another one, so a fetch
+    // that is already done is only reported once that load has finished.
+    if (fetch_->done()) {
+      base::MessageLoop::current()->PostTask(
+          FROM_HERE,
+          base::Bind(&Job::DidFinishFetch, weak_factory_.GetWeakPtr()));
+    }
+  }
+
+  virtual ~Job() {}
+
+  const std::string& name() const { return fetch_->name(); }
+
+  void DidFinishFetch() {
+    if (fetch_->failed())
+      loader_->DidFailJob(this);
+    else
+      OnDataComplete(fetch_->buffer());
+  }
+
+ protected:
+  virtual void OnDataComplete(const std::vector<uint8_t>& buffer) = 0;
+
+  DartLibraryLoader* loader_;
+
+ private:
+  std::unique_ptr<Fetch> fetch_;
+
   base::WeakPtrFactory<Job> weak_factory_;
 };
 
 class DartLibraryLoader::ImportJob : public Job {
  public:
-  ImportJob(DartLibraryLoader* loader, const std::string& name) : Job(loader, name) {
+  ImportJob(DartLibraryLoader* loader, const std::string& name, bool is_script)
+      : Job(loader, name), is_script_(is_script) {
     TRACE_EVENT_ASYNC_BEGIN1("sky", "DartLibraryLoader::ImportJob", this, "url",
                              name);
   }
 
+  bool is_script() const { return is_script_; }
+
  private:
-  // DataPipeDrainer::Client
-  void OnDataComplete() override {
+  // Job
+  void OnDataComplete(const std::vector<uint8_t>& buffer) override {
     TRACE_EVENT_ASYNC_END0("sky", "DartLibraryLoader::ImportJob", this);
-    loader_->DidCompleteImportJob(this, buffer_);
+    loader_->DidCompleteImportJob(this, buffer);
   }
+
+  bool is_script_;
 };
 
 class DartLibraryLoader::SourceJob : public Job {
@@ -98,10 +298,10 @@ class DartLibraryLoader::SourceJob : public Job {
   Dart_PersistentHandle library() const { return library_.value(); }
 
  private:
-  // DataPipeDrainer::Client
-  void OnDataComplete() override {
+  // Job
+  void OnDataComplete(const std::vector<uint8_t>& buffer) override {
     TRACE_EVENT_ASYNC_END0("sky", "DartLibraryLoader::SourceJob", this);
-    loader_->DidCompleteSourceJob(this, buffer_);
+    loader_->DidCompleteSourceJob(this, buffer);
   }
 
   DartPersistentValue library_;
@@ -185,7 +385,10 @@ class DartLibraryLoader::WatcherSignaler {
 DartLibraryLoader::DartLibraryLoader(DartState* dart_state)
     : dart_state_(dart_state),
       library_provider_(nullptr),
-      dependency_catcher_(nullptr) {
+      dependency_catcher_(nullptr),
+      records_source_digests_(false),
+      max_fetches_in_flight_(kDefaultMaxFetchesInFlight),
+      fetches_in_flight_(0) {
 }
 
 DartLibraryLoader::~DartLibraryLoader() {
@@ -219,10 +422,20 @@ void DartLibraryLoader::WaitForDependencies(
 }
 
 void DartLibraryLoader::LoadLibrary(const std::string& name) {
+  Load(name, false);
+}
+
+void DartLibraryLoader::LoadScript(const std::string& name) {
+  DCHECK(Dart_IsNull(Dart_RootLibrary()));
+  Load(name, true);
+}
+
+void DartLibraryLoader::Load(const std::string& name, bool is_script) {
   const auto& result = pending_libraries_.insert(std::make_pair(name, nullptr));
   if (result.second) {
     // New entry.
-    std::unique_ptr<Job> job = std::unique_ptr<Job>(new ImportJob(this, name));
+    std::unique_ptr<Job> job =
+        std::unique_ptr<Job>(new ImportJob(this, name, is_script));
     result.first->second = job.get();
     jobs_.insert(std::move(job));
   }
@@ -230,6 +443,70 @@ void DartLibraryLoader::LoadLibrary(const std::string& name) {
     dependency_catcher_->AddDependency(result.first->second);
 }
 
+void DartLibraryLoader::PrefetchLibraries(
+    const std::vector<std::string>& names) {
+  for (const auto& name : names)
+    Prefetch(name);
+}
+
+void DartLibraryLoader::Prefetch(const std::string& name) {
+  if (name.empty() || !fetched_names_.insert(name).second)
+    return;
+  std::unique_ptr<Fetch>& fetch = prefetches_[name];
+  fetch.reset(new Fetch(this, name));
+  StartOrQueueFetch(fetch.get(), false);
+}
+
+std::unique_ptr<DartLibraryLoader::Fetch> DartLibraryLoader::TakeFetch(
+    const std::string& name) {
+  fetched_names_.insert(name);
+  std::unique_ptr<Fetch> fetch;
+  auto it = prefetches_.find(name);
+  if (it == prefetches_.end()) {
+    fetch.reset(new Fetch(this, name));
+    StartOrQueueFetch(fetch.get(), true);
+    return fetch;
+  }
+
+  fetch = std::move(it->second);
+  prefetches_.erase(it);
+  if (!fetch->started()) {
+    // Dart is waiting for this one, so move it ahead of the other prefetches.
+    queued_fetches_.erase(std::find(queued_fetches_.begin(),
+                                    queued_fetches_.end(), fetch.get()));
+    StartOrQueueFetch(fetch.get(), true);
+  }
+  return fetch;
+}
+
+void DartLibraryLoader::StartOrQueueFetch(Fetch* fetch, bool urgent) {
+  if (fetches_in_flight_ >= max_fetches_in_flight_) {
+    if (urgent)
+      queued_fetches_.push_front(fetch);
+    else
+      queued_fetches_.push_back(fetch);
+    return;
+  }
+  ++fetches_in_flight_;
+  fetch->Start();
+}
+
+void DartLibraryLoader::DidFinishFetch(Fetch* fetch) {
+  DCHECK(fetches_in_flight_);
+  --fetches_in_flight_;
+  while (!queued_fetches_.empty() &&
+         fetches_in_flight_ < max_fetches_in_flight_) {
+    Fetch* next = queued_fetches_.front();
+    queued_fetches_.pop_front();
+    ++fetches_in_flight_;
+    next->Start();
+  }
+
+  // Prefetches wait for a Job to claim them.
+  if (Job* job = fetch->job())
+    job->DidFinishFetch();
+}
+
 Dart_Handle DartLibraryLoader::Import(Dart_Handle library, Dart_Handle url) {
   LoadLibrary(StdStringFromDart(url));
   return Dart_True();
@@ -257,13 +534,15 @@ void DartLibraryLoader::DidCompleteImportJob(
 
   WatcherSignaler watcher_signaler(*this, job);
 
-  Dart_Handle result = Dart_LoadLibrary(
-      StdStringToDart(job->name()),
-      Dart_NewStringFromUTF8(buffer.data(), buffer.size()), 0, 0);
+  Dart_Handle url = StdStringToDart(job->name());
+  Dart_Handle source = Dart_NewStringFromUTF8(buffer.data(), buffer.size());
+  Dart_Handle result = job->is_script() ? Dart_LoadScript(url, source, 0, 0)
+                                        : Dart_LoadLibrary(url, source, 0, 0);
   if (Dart_IsError(result)) {
     LOG(ERROR) << "Error Loading " << job->name() << " "
         << Dart_GetError(result);
   }
+  RecordSourceDigest(job->name(), buffer);
 
   pending_libraries_.erase(job->name());
   EraseUniquePtr<Job>(jobs_, job);
@@ -286,10 +565,21 @@ void DartLibraryLoader::DidCompleteSourceJob(
     LOG(ERROR) << "Error Loading " << job->name() << " "
         << Dart_GetError(result);
   }
+  RecordSourceDigest(job->name(), buffer);
 
   EraseUniquePtr<Job>(jobs_, job);
 }
 
+void DartLibraryLoader::RecordSourceDigest(const std::string& name,
+                                           const std::vector<uint8_t>& buffer) {
+  if (!records_source_digests_)
+    return;
+  std::string digest = base::SHA1HashString(
+      std::string(reinterpret_cast<const char*>(buffer.data()), buffer.size()));
+  source_digests_.push_back(
+      std::make_pair(name, base::HexEncode(digest.data(), digest.size())));
+}
+
 void DartLibraryLoader::DidFailJob(Job* job) {
   DartIsolateScope scope(dart_state_->isolate());
   DartApiScope api_scope;
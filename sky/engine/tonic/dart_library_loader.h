@@ -5,10 +5,12 @@
 #ifndef SKY_ENGINE_TONIC_DART_LIBRARY_LOADER_H_
 #define SKY_ENGINE_TONIC_DART_LIBRARY_LOADER_H_
 
+#include <deque>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include "base/callback_forward.h"
@@ -27,6 +29,10 @@ class DartState;
 // of inner classes that could potentially be factored out in some other way.
 class DartLibraryLoader {
  public:
+  // Pairs of the name of a library or part and the hex SHA-1 digest of its
+  // source, in the order they were loaded.
+  typedef std::vector<std::pair<std::string, std::string>> SourceDigests;
+
   explicit DartLibraryLoader(DartState* dart_state);
   ~DartLibraryLoader();
 
@@ -38,6 +44,17 @@ class DartLibraryLoader {
 
   void LoadLibrary(const std::string& name);
 
+  // Like LoadLibrary, but loads |name| as the isolate's root script, which is
+  // the library a script snapshot is made from. The isolate must not have a
+  // root library yet.
+  void LoadScript(const std::string& name);
+
+  // Starts fetching libraries that the app is known to import, such as those
+  // listed in a precomputed dependency manifest, so that they do not have to
+  // wait for the libraries that import them to load. |names| must already be
+  // canonical.
+  void PrefetchLibraries(const std::vector<std::string>& names);
+
   void WaitForDependencies(
       const std::unordered_set<DartDependency*>& dependencies,
       const base::Closure& callback);
@@ -56,7 +73,22 @@ class DartLibraryLoader {
     library_provider_ = library_provider;
   }
 
+  // Once set, the loader records the digest of every source it loads, for
+  // caches that need to know whether the sources have changed since.
+  void set_records_source_digests(bool records_source_digests) {
+    records_source_digests_ = records_source_digests;
+  }
+  const SourceDigests& source_digests() const { return source_digests_; }
+
+  // Limits the number of requests made to the |DartLibraryProvider| that are
+  // waiting for data at the same time.
+  void set_max_fetches_in_flight(size_t max_fetches_in_flight) {
+    DCHECK(max_fetches_in_flight);
+    max_fetches_in_flight_ = max_fetches_in_flight;
+  }
+
  private:
+  class Fetch;
   class Job;
   class ImportJob;
   class SourceJob;
@@ -66,6 +98,13 @@ class DartLibraryLoader {
   Dart_Handle Import(Dart_Handle library, Dart_Handle url);
   Dart_Handle Source(Dart_Handle library, Dart_Handle url);
   Dart_Handle CanonicalizeURL(Dart_Handle library, Dart_Handle url);
+  void Load(const std::string& name, bool is_script);
+  void RecordSourceDigest(const std::string& name,
+                          const std::vector<uint8_t>& buffer);
+  void Prefetch(const std::string& name);
+  std::unique_ptr<Fetch> TakeFetch(const std::string& name);
+  void StartOrQueueFetch(Fetch* fetch, bool urgent);
+  void DidFinishFetch(Fetch* fetch);
   void DidCompleteImportJob(ImportJob* job, const std::vector<uint8_t>& buffer);
   void DidCompleteSourceJob(SourceJob* job, const std::vector<uint8_t>& buffer);
   void DidFailJob(Job* job);
@@ -76,6 +115,18 @@ class DartLibraryLoader {
   std::unordered_set<std::unique_ptr<Job>> jobs_;
   std::unordered_set<std::unique_ptr<DependencyWatcher>> dependency_watchers_;
   DartDependencyCatcher* dependency_catcher_;
+  bool records_source_digests_;
+  SourceDigests source_digests_;
+
+  // Fetches that no Job has claimed yet, by name.
+  std::unordered_map<std::string, std::unique_ptr<Fetch>> prefetches_;
+  // Every name a fetch has been started for, so that libraries that have
+  // already loaded are not prefetched again.
+  std::unordered_set<std::string> fetched_names_;
+  // Fetches waiting for a slot, with the ones Dart is waiting for in front.
+  std::deque<Fetch*> queued_fetches_;
+  size_t max_fetches_in_flight_;
+  size_t fetches_in_flight_;
 
   DISALLOW_COPY_AND_ASSIGN(DartLibraryLoader);
 };
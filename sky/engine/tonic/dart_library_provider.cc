@@ -9,4 +9,10 @@ namespace blink {
 DartLibraryProvider::~DartLibraryProvider() {
 }
 
+std::string DartLibraryProvider::CanonicalizeURLForPrefetch(
+    const std::string& library_url,
+    const std::string& url) {
+  return std::string();
+}
+
 }  // namespace blink
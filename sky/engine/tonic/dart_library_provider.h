@@ -23,6 +23,13 @@ class DartLibraryProvider {
 
   virtual Dart_Handle CanonicalizeURL(Dart_Handle library, Dart_Handle url) = 0;
 
+  // Resolves |url| against |library_url| the way CanonicalizeURL would, but
+  // without a Dart library handle, so that imports can be fetched before the
+  // library that contains them has been loaded. Providers that return an
+  // empty string only fetch libraries once Dart asks for them.
+  virtual std::string CanonicalizeURLForPrefetch(const std::string& library_url,
+                                                 const std::string& url);
+
   virtual ~DartLibraryProvider();
 };
 
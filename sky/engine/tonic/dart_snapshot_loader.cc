@@ -4,7 +4,11 @@
 
 #include "sky/engine/tonic/dart_snapshot_loader.h"
 
+#include "base/bind.h"
 #include "base/callback.h"
+#include "base/location.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
 #include "base/trace_event/trace_event.h"
 #include "sky/engine/tonic/dart_api_scope.h"
 #include "sky/engine/tonic/dart_converter.h"
@@ -14,9 +18,39 @@
 using mojo::common::DataPipeDrainer;
 
 namespace blink {
+namespace {
+
+scoped_ptr<base::MemoryMappedFile> MapSnapshot(const base::FilePath& path) {
+  TRACE_EVENT0("sky", "DartSnapshotLoader::MapSnapshot");
+  scoped_ptr<base::MemoryMappedFile> mapped_file(new base::MemoryMappedFile);
+  if (!mapped_file->Initialize(path)) {
+    LOG(ERROR) << "Could not map snapshot " << path.AsUTF8Unsafe();
+    return nullptr;
+  }
+  return mapped_file.Pass();
+}
+
+// Keeps a mapped snapshot around for as long as it is referenced.
+class RefCountedMappedFile : public base::RefCountedMemory {
+ public:
+  explicit RefCountedMappedFile(scoped_ptr<base::MemoryMappedFile> mapped_file)
+      : mapped_file_(mapped_file.Pass()) {}
+
+  const unsigned char* front() const override { return mapped_file_->data(); }
+  size_t size() const override { return mapped_file_->length(); }
+
+ private:
+  ~RefCountedMappedFile() override {}
+
+  scoped_ptr<base::MemoryMappedFile> mapped_file_;
+
+  DISALLOW_COPY_AND_ASSIGN(RefCountedMappedFile);
+};
+
+}  // namespace
 
 DartSnapshotLoader::DartSnapshotLoader(DartState* dart_state)
-    : dart_state_(dart_state->GetWeakPtr()) {
+    : dart_state_(dart_state->GetWeakPtr()), weak_factory_(this) {
 }
 
 DartSnapshotLoader::~DartSnapshotLoader() {
@@ -30,19 +64,51 @@ void DartSnapshotLoader::LoadSnapshot(mojo::ScopedDataPipeConsumerHandle pipe,
   drainer_.reset(new DataPipeDrainer(this, pipe.Pass()));
 }
 
+void DartSnapshotLoader::LoadSnapshotFromFile(const base::FilePath& path,
+                                              const base::Closure& callback) {
+  TRACE_EVENT_ASYNC_BEGIN0("sky", "DartSnapshotLoader::LoadSnapshot", this);
+
+  callback_ = callback;
+  base::PostTaskAndReplyWithResult(
+      base::WorkerPool::GetTaskRunner(true).get(), FROM_HERE,
+      base::Bind(&MapSnapshot, path),
+      base::Bind(&DartSnapshotLoader::DidMapSnapshot,
+                 weak_factory_.GetWeakPtr()));
+}
+
 void DartSnapshotLoader::OnDataAvailable(const void* data, size_t num_bytes) {
   const uint8_t* bytes = static_cast<const uint8_t*>(data);
   buffer_.insert(buffer_.end(), bytes, bytes + num_bytes);
 }
 
 void DartSnapshotLoader::OnDataComplete() {
+  LoadScript(make_scoped_refptr(base::RefCountedBytes::TakeVector(&buffer_)));
+}
+
+void DartSnapshotLoader::DidMapSnapshot(
+    scoped_ptr<base::MemoryMappedFile> mapped_file) {
+  // A snapshot that could not be mapped fails to load like an empty stream.
+  if (!mapped_file) {
+    LoadScript(nullptr);
+    return;
+  }
+  // The VM deserializes the script while loading it. The mapping is kept for
+  // the isolates the app spawns, and costs no memory while they do not.
+  LoadScript(make_scoped_refptr(new RefCountedMappedFile(mapped_file.Pass())));
+}
+
+void DartSnapshotLoader::LoadScript(
+    scoped_refptr<base::RefCountedMemory> snapshot) {
   TRACE_EVENT_ASYNC_END0("sky", "DartSnapshotLoader::LoadSnapshot", this);
 
   {
     DartIsolateScope scope(dart_state_->isolate());
     DartApiScope api_scope;
 
-    LogIfError(Dart_LoadScriptFromSnapshot(buffer_.data(), buffer_.size()));
+    const uint8_t* data = snapshot ? snapshot->front() : nullptr;
+    const size_t length = snapshot ? snapshot->size() : 0;
+    if (!LogIfError(Dart_LoadScriptFromSnapshot(data, length)))
+      snapshot_ = snapshot;
   }
 
   callback_.Run();
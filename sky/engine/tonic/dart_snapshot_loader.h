@@ -8,7 +8,12 @@
 #include <vector>
 
 #include "base/callback_forward.h"
+#include "base/files/file_path.h"
+#include "base/files/memory_mapped_file.h"
 #include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/memory/scoped_ptr.h"
 #include "base/memory/weak_ptr.h"
 #include "dart/runtime/include/dart_api.h"
 #include "mojo/data_pipe_utils/data_pipe_drainer.h"
@@ -24,17 +29,35 @@ class DartSnapshotLoader : public mojo::common::DataPipeDrainer::Client {
   void LoadSnapshot(mojo::ScopedDataPipeConsumerHandle pipe,
                     const base::Closure& callback);
 
+  // Maps the snapshot at |path| into memory instead of copying it into a
+  // buffer, so that the VM reads it straight out of the page cache. The file
+  // is opened on a worker thread.
+  void LoadSnapshotFromFile(const base::FilePath& path,
+                            const base::Closure& callback);
+
+  // The snapshot once it has loaded, or null if it could not be read. It can
+  // be read on any thread.
+  const scoped_refptr<base::RefCountedMemory>& snapshot() const {
+    return snapshot_;
+  }
+
  private:
   // mojo::common::DataPipeDrainer::Client
   void OnDataAvailable(const void* data, size_t num_bytes) override;
   void OnDataComplete() override;
 
+  void DidMapSnapshot(scoped_ptr<base::MemoryMappedFile> mapped_file);
+  void LoadScript(scoped_refptr<base::RefCountedMemory> snapshot);
+
   base::WeakPtr<DartState> dart_state_;
   std::unique_ptr<mojo::common::DataPipeDrainer> drainer_;
   // TODO(abarth): Should we be using SharedBuffer to buffer the data?
   std::vector<uint8_t> buffer_;
+  scoped_refptr<base::RefCountedMemory> snapshot_;
   base::Closure callback_;
 
+  base::WeakPtrFactory<DartSnapshotLoader> weak_factory_;
+
   DISALLOW_COPY_AND_ASSIGN(DartSnapshotLoader);
 };
 
@@ -4,14 +4,29 @@
 
 #include "sky/engine/tonic/dart_state.h"
 
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/message_loop/message_loop.h"
+#include "base/trace_event/trace_event.h"
+
 #include "sky/engine/tonic/dart_class_library.h"
 #include "sky/engine/tonic/dart_converter.h"
 #include "sky/engine/tonic/dart_exception_factory.h"
 #include "sky/engine/tonic/dart_library_loader.h"
 #include "sky/engine/tonic/dart_string_cache.h"
 #include "sky/engine/tonic/dart_timer_heap.h"
+#include "sky/engine/tonic/dart_wrappable.h"
+#include "sky/engine/tonic/dart_wrapper_info.h"
 
 namespace blink {
+namespace {
+
+// Enough to keep up with the wrappers a frame leaves behind without letting
+// a large batch delay the next frame.
+const size_t kFinalizationBatchSize = 256;
+
+}  // namespace
 
 DartState::Scope::Scope(DartState* dart_state) : scope_(dart_state->isolate()) {
 }
@@ -30,10 +45,15 @@ DartState::DartState()
           new DartStringCache)),
       timer_heap_(std::unique_ptr<DartTimerHeap>(
           new DartTimerHeap())),
+      finalization_scheduled_(false),
       weak_factory_(this) {
 }
 
 DartState::~DartState() {
+  // The isolate is gone by now, so anything the native objects still hold
+  // in it must not try to enter it while they are destroyed.
+  weak_factory_.InvalidateWeakPtrs();
+  FinalizeWrappables(pending_finalizations_.size());
 }
 
 void DartState::SetIsolate(Dart_Isolate isolate) {
@@ -61,4 +81,38 @@ base::WeakPtr<DartState> DartState::GetWeakPtr() {
   return weak_factory_.GetWeakPtr();
 }
 
+void DartState::DeferFinalization(DartWrappable* wrappable) {
+  pending_finalizations_.push_back(wrappable);
+  if (finalization_scheduled_)
+    return;
+  finalization_scheduled_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&DartState::RunPendingFinalizations, GetWeakPtr()));
+}
+
+void DartState::RunPendingFinalizations() {
+  TRACE_EVENT1("sky", "DartState::RunPendingFinalizations", "pending",
+               pending_finalizations_.size());
+  finalization_scheduled_ = false;
+  FinalizeWrappables(
+      std::min(kFinalizationBatchSize, pending_finalizations_.size()));
+  TRACE_COUNTER1("sky", "DartPendingFinalizations",
+                 pending_finalizations_.size());
+  if (pending_finalizations_.empty())
+    return;
+  finalization_scheduled_ = true;
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&DartState::RunPendingFinalizations, GetWeakPtr()));
+}
+
+void DartState::FinalizeWrappables(size_t count) {
+  // Take the batch off the end of the list first: a destructor may let go
+  // of the last reference to another wrappable, but never defers one.
+  std::vector<DartWrappable*> batch(pending_finalizations_.end() - count,
+                                    pending_finalizations_.end());
+  pending_finalizations_.resize(pending_finalizations_.size() - count);
+  for (DartWrappable* wrappable : batch)
+    wrappable->GetDartWrapperInfo().deref_object(wrappable);
+}
+
 }  // namespace blink
@@ -5,6 +5,8 @@
 #ifndef SKY_ENGINE_TONIC_DART_STATE_H_
 #define SKY_ENGINE_TONIC_DART_STATE_H_
 
+#include <vector>
+
 #include "base/logging.h"
 #include "base/memory/weak_ptr.h"
 #include "base/supports_user_data.h"
@@ -19,6 +21,7 @@ class DartExceptionFactory;
 class DartLibraryLoader;
 class DartStringCache;
 class DartTimerHeap;
+class DartWrappable;
 
 // DartState represents the state associated with a given Dart isolate. The
 // lifetime of this object is controlled by the DartVM. If you want to hold a
@@ -56,9 +59,21 @@ class DartState : public base::SupportsUserData {
 
   Dart_Handle index_handle() { return index_handle_.value(); }
 
+  // Wrappers finalized by a collection drop their references to the native
+  // objects after the collection rather than from the GC callback, a batch
+  // at a time, so that a collection that finds many dead wrappers does not
+  // run all of their destructors inside the pause.
+  void DeferFinalization(DartWrappable* wrappable);
+  size_t pending_finalization_count() const {
+    return pending_finalizations_.size();
+  }
+
   virtual void DidSetIsolate() {}
 
  private:
+  void RunPendingFinalizations();
+  void FinalizeWrappables(size_t count);
+
   Dart_Isolate isolate_;
   std::unique_ptr<DartClassLibrary> class_library_;
   std::unique_ptr<DartExceptionFactory> exception_factory_;
@@ -66,6 +81,8 @@ class DartState : public base::SupportsUserData {
   std::unique_ptr<DartStringCache> string_cache_;
   std::unique_ptr<DartTimerHeap> timer_heap_;
   DartPersistentValue index_handle_;
+  std::vector<DartWrappable*> pending_finalizations_;
+  bool finalization_scheduled_;
 
  protected:
   base::WeakPtrFactory<DartState> weak_factory_;
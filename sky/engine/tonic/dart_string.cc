@@ -9,6 +9,11 @@
 namespace blink {
 namespace {
 
+// Strings shorter than this are copied rather than externalized. Copying a
+// label is cheaper than the weak handle and finalizer an external string
+// needs, and most of the text a UI passes around is that short.
+const intptr_t kMinExternalizedLength = 64;
+
 void FinalizeString(void* string_impl) {
   DCHECK(string_impl);
   reinterpret_cast<StringImpl*>(string_impl)->deref();
@@ -31,23 +36,55 @@ String Externalize(Dart_Handle handle, intptr_t length) {
   return String(string_impl.release());
 }
 
+String CopyLatin1(Dart_Handle handle, intptr_t length) {
+  LChar* buffer = nullptr;
+  RefPtr<StringImpl> string_impl =
+      StringImpl::createUninitialized(length, buffer);
+  Dart_Handle result = Dart_StringToLatin1(handle, buffer, &length);
+  DCHECK(!Dart_IsError(result));
+  return String(string_impl.release());
+}
+
+// Copies straight into the string's own storage, and only narrows it if the
+// characters turn out to fit in Latin-1.
+String CopyUTF16(Dart_Handle handle, intptr_t length) {
+  UChar* buffer = nullptr;
+  RefPtr<StringImpl> string_impl =
+      StringImpl::createUninitialized(length, buffer);
+  Dart_Handle result = Dart_StringToUTF16(
+      handle, reinterpret_cast<uint16_t*>(buffer), &length);
+  DCHECK(!Dart_IsError(result));
+  if (charactersAreAllLatin1(buffer, length))
+    return StringImpl::create8BitIfPossible(buffer, length);
+  return String(string_impl.release());
+}
+
 }  // namespace
 
 Dart_Handle CreateDartString(StringImpl* string_impl) {
   if (!string_impl)
     return Dart_EmptyString();
 
-  string_impl->ref();  // Balanced in FinalizeString.
-
   if (string_impl->is8Bit()) {
+    string_impl->ref();  // Balanced in FinalizeString.
     return Dart_NewExternalLatin1String(string_impl->characters8(),
                                         string_impl->length(), string_impl,
                                         FinalizeString);
-  } else {
-    return Dart_NewExternalUTF16String(string_impl->characters16(),
-                                       string_impl->length(), string_impl,
-                                       FinalizeString);
   }
+
+  // Wide strings of Latin-1 characters are copied, which lets the VM store
+  // them in one byte per character.
+  if (charactersAreAllLatin1(string_impl->characters16(),
+                             string_impl->length())) {
+    return Dart_NewStringFromUTF16(
+        reinterpret_cast<const uint16_t*>(string_impl->characters16()),
+        string_impl->length());
+  }
+
+  string_impl->ref();  // Balanced in FinalizeString.
+  return Dart_NewExternalUTF16String(string_impl->characters16(),
+                                     string_impl->length(), string_impl,
+                                     FinalizeString);
 }
 
 String ExternalizeDartString(Dart_Handle handle) {
@@ -56,6 +93,11 @@ String ExternalizeDartString(Dart_Handle handle) {
   bool is_latin1 = Dart_IsStringLatin1(handle);
   intptr_t length;
   Dart_StringLength(handle, &length);
+  if (length < kMinExternalizedLength) {
+    if (!length)
+      return StringImpl::empty();
+    return is_latin1 ? CopyLatin1(handle, length) : CopyUTF16(handle, length);
+  }
   if (is_latin1)
     return Externalize<LChar>(handle, length);
   return Externalize<UChar>(handle, length);
@@ -12,6 +12,9 @@
 namespace blink {
 
 Dart_Handle CreateDartString(StringImpl* string_impl);
+
+// Short strings are copied. Longer ones are turned into external strings
+// that share their characters with the returned String.
 String ExternalizeDartString(Dart_Handle handle);
 
 }  // namespace blink
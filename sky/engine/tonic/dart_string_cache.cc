@@ -4,12 +4,23 @@
 
 #include "sky/engine/tonic/dart_string_cache.h"
 
+#include "base/trace_event/trace_event.h"
 #include "sky/engine/tonic/dart_state.h"
 #include "sky/engine/tonic/dart_string.h"
 
 namespace blink {
+namespace {
 
-DartStringCache::DartStringCache() : last_dart_string_(nullptr) {
+// Strings that miss the front cache this many times are interned.
+const unsigned kInternLookupThreshold = 32;
+
+// Bounds the memory held by interned strings, which is never released while
+// the isolate is alive.
+const size_t kMaxInternedStrings = 256;
+
+}  // namespace
+
+DartStringCache::DartStringCache() : front_hits_(0), map_hits_(0), misses_(0) {
 }
 
 DartStringCache::~DartStringCache() {
@@ -17,12 +28,24 @@ DartStringCache::~DartStringCache() {
 
 Dart_WeakPersistentHandle DartStringCache::GetSlow(StringImpl* string_impl,
                                                    bool auto_scope) {
-  if (Dart_WeakPersistentHandle string = cache_.get(string_impl)) {
-    last_dart_string_ = string;
-    last_string_impl_ = string_impl;
+  StringCache::iterator it = cache_.find(string_impl);
+  if (it != cache_.end()) {
+    ++map_hits_;
+    CacheEntry& entry = it->value;
+    Dart_WeakPersistentHandle string = entry.dart_string;
+    if (++entry.lookups == kInternLookupThreshold) {
+      if (!auto_scope)
+        Dart_EnterScope();
+      Intern(string);
+      if (!auto_scope)
+        Dart_ExitScope();
+    }
+    Remember(string_impl, string);
+    TraceStats();
     return string;
   }
 
+  ++misses_;
   if (!auto_scope)
     Dart_EnterScope();
 
@@ -34,17 +57,40 @@ Dart_WeakPersistentHandle DartStringCache::GetSlow(StringImpl* string_impl,
       string, string_impl, size_in_bytes, FinalizeCacheEntry);
 
   string_impl->ref();  // Balanced in FinalizeCacheEntry.
-  cache_.set(string_impl, wrapper);
-
-  last_dart_string_ = wrapper;
-  last_string_impl_ = string_impl;
+  cache_.set(string_impl, CacheEntry(wrapper));
+  Remember(string_impl, wrapper);
 
   if (!auto_scope)
     Dart_ExitScope();
 
+  TraceStats();
   return wrapper;
 }
 
+void DartStringCache::Remember(StringImpl* string_impl,
+                               Dart_WeakPersistentHandle string) {
+  FrontEntry& entry = front_cache_[FrontIndex(string_impl)];
+  entry.string_impl = string_impl;
+  entry.dart_string = string;
+}
+
+void DartStringCache::Intern(Dart_WeakPersistentHandle string) {
+  if (interned_strings_.size() >= kMaxInternedStrings)
+    return;
+  // The strong reference keeps the weak handle from ever being finalized, so
+  // the entry stays in |cache_| for the lifetime of the isolate.
+  interned_strings_.push_back(std::unique_ptr<DartPersistentValue>(
+      new DartPersistentValue(DartState::Current(),
+                              Dart_HandleFromWeakPersistent(string))));
+}
+
+void DartStringCache::TraceStats() const {
+  TRACE_COUNTER2("sky", "DartStringCacheHits", "front", front_hits_, "map",
+                 map_hits_);
+  TRACE_COUNTER2("sky", "DartStringCacheStrings", "created", misses_,
+                 "interned", interned_strings_.size());
+}
+
 void DartStringCache::FinalizeCacheEntry(void* isolate_callback_data,
                                          Dart_WeakPersistentHandle handle,
                                          void* peer) {
@@ -52,13 +98,12 @@ void DartStringCache::FinalizeCacheEntry(void* isolate_callback_data,
   StringImpl* string_impl = reinterpret_cast<StringImpl*>(peer);
   DartStringCache& cache = state->string_cache();
 
-  Dart_WeakPersistentHandle cached_handle = cache.cache_.take(string_impl);
-  ASSERT_UNUSED(cached_handle, handle == cached_handle);
+  CacheEntry cached_entry = cache.cache_.take(string_impl);
+  ASSERT_UNUSED(cached_entry, handle == cached_entry.dart_string);
 
-  if (cache.last_dart_string_ == handle) {
-    cache.last_dart_string_ = nullptr;
-    cache.last_string_impl_ = nullptr;
-  }
+  FrontEntry& front_entry = cache.front_cache_[FrontIndex(string_impl)];
+  if (front_entry.string_impl == string_impl)
+    front_entry = FrontEntry();
 
   string_impl->deref();
 }
@@ -5,10 +5,15 @@
 #ifndef SKY_ENGINE_TONIC_DART_STRING_CACHE_H_
 #define SKY_ENGINE_TONIC_DART_STRING_CACHE_H_
 
+#include <stdint.h>
+
+#include <memory>
+#include <vector>
+
 #include "base/logging.h"
 #include "dart/runtime/include/dart_api.h"
+#include "sky/engine/tonic/dart_persistent_value.h"
 #include "sky/engine/wtf/HashMap.h"
-#include "sky/engine/wtf/RefPtr.h"
 #include "sky/engine/wtf/text/StringHash.h"
 #include "sky/engine/wtf/text/StringImpl.h"
 
@@ -17,6 +22,12 @@ namespace blink {
 // DartStringCache maintains a mapping between WTF Strings and Dart strings.
 // When you create a Dart string from a WTF String, the underlying character
 // data is shared between the two systems.
+//
+// Lookups first go through a small direct-mapped cache of recently converted
+// strings and only fall back to the hash map when that misses. Strings that
+// keep being converted are interned: the cache holds a strong reference to
+// their Dart string so that a garbage collection does not force them to be
+// converted again.
 class DartStringCache {
  public:
   DartStringCache();
@@ -25,20 +36,56 @@ class DartStringCache {
   Dart_WeakPersistentHandle Get(StringImpl* string_impl,
                                 bool auto_scope = true) {
     DCHECK(string_impl);
-    if (last_string_impl_.get() == string_impl)
-      return last_dart_string_;
+    const FrontEntry& entry = front_cache_[FrontIndex(string_impl)];
+    if (entry.string_impl == string_impl) {
+      ++front_hits_;
+      return entry.dart_string;
+    }
     return GetSlow(string_impl, auto_scope);
   }
 
  private:
+  static const size_t kFrontCacheSize = 64;
+
+  struct FrontEntry {
+    FrontEntry() : string_impl(nullptr), dart_string(nullptr) {}
+
+    // Not a reference: |cache_| keeps the string alive while it is here.
+    StringImpl* string_impl;
+    Dart_WeakPersistentHandle dart_string;
+  };
+
+  struct CacheEntry {
+    CacheEntry() : dart_string(nullptr), lookups(0) {}
+    explicit CacheEntry(Dart_WeakPersistentHandle dart_string)
+        : dart_string(dart_string), lookups(0) {}
+
+    Dart_WeakPersistentHandle dart_string;
+    unsigned lookups;
+  };
+
+  static size_t FrontIndex(StringImpl* string_impl) {
+    // StringImpls are at least 8-byte aligned, so the low bits carry no
+    // information.
+    return (reinterpret_cast<uintptr_t>(string_impl) >> 3) &
+           (kFrontCacheSize - 1);
+  }
+
   Dart_WeakPersistentHandle GetSlow(StringImpl* string_impl, bool auto_scope);
+  void Remember(StringImpl* string_impl, Dart_WeakPersistentHandle string);
+  void Intern(Dart_WeakPersistentHandle string);
+  void TraceStats() const;
   static void FinalizeCacheEntry(void*, Dart_WeakPersistentHandle, void* peer);
 
-  typedef HashMap<StringImpl*, Dart_WeakPersistentHandle> StringCache;
+  typedef HashMap<StringImpl*, CacheEntry> StringCache;
 
   StringCache cache_;
-  Dart_WeakPersistentHandle last_dart_string_;
-  RefPtr<StringImpl> last_string_impl_;
+  FrontEntry front_cache_[kFrontCacheSize];
+  std::vector<std::unique_ptr<DartPersistentValue>> interned_strings_;
+
+  uint64_t front_hits_;
+  uint64_t map_hits_;
+  uint64_t misses_;
 
   DISALLOW_COPY_AND_ASSIGN(DartStringCache);
 };
@@ -4,6 +4,8 @@
 
 #include "sky/engine/tonic/dart_timer_heap.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/message_loop/message_loop.h"
 #include "base/time/time.h"
@@ -14,7 +16,8 @@
 
 namespace blink {
 
-DartTimerHeap::DartTimerHeap() : next_timer_id_(1), weak_factory_(this) {
+DartTimerHeap::DartTimerHeap()
+    : next_timer_id_(1), next_sequence_(0), weak_factory_(this) {
 }
 
 DartTimerHeap::~DartTimerHeap() {
@@ -22,34 +25,104 @@ DartTimerHeap::~DartTimerHeap() {
 
 int DartTimerHeap::Add(std::unique_ptr<Task> task) {
   int id = next_timer_id_++;
-  Schedule(id, std::move(task));
+  base::TimeDelta delay = task->delay;
+  tasks_[id] = std::move(task);
+  Schedule(id, base::TimeTicks::Now(), delay);
+  ArmWakeUp();
   return id;
 }
 
 void DartTimerHeap::Remove(int id) {
-  heap_.erase(id);
+  tasks_.erase(id);
+  // A wakeup that has already been posted still fires, but it finds nothing
+  // to do and is not posted again.
+  DropCancelledDeadlines();
 }
 
-void DartTimerHeap::Schedule(int id, std::unique_ptr<Task> task) {
-  base::TimeDelta delay = task->delay;
-  heap_[id] = std::move(task);
-  base::MessageLoop::current()->PostDelayedTask(FROM_HERE,
-    base::Bind(&DartTimerHeap::Run, weak_factory_.GetWeakPtr(), id), delay);
+void DartTimerHeap::Schedule(int id,
+                             base::TimeTicks now,
+                             base::TimeDelta delay) {
+  Deadline deadline;
+  deadline.time = now + delay;
+  deadline.sequence = next_sequence_++;
+  deadline.id = id;
+  deadlines_.push(deadline);
+}
+
+void DartTimerHeap::DropCancelledDeadlines() {
+  while (!deadlines_.empty() && !tasks_.count(deadlines_.top().id))
+    deadlines_.pop();
+}
+
+void DartTimerHeap::ArmWakeUp() {
+  DropCancelledDeadlines();
+  if (deadlines_.empty())
+    return;
+
+  base::TimeTicks wake_up_time = deadlines_.top().time;
+  if (coalescing_window_ > base::TimeDelta()) {
+    wake_up_time = wake_up_time.SnappedToNextTick(base::TimeTicks(),
+                                                  coalescing_window_);
+  }
+  if (!armed_wake_up_time_.is_null() && armed_wake_up_time_ <= wake_up_time)
+    return;
+
+  armed_wake_up_time_ = wake_up_time;
+  base::TimeDelta delay = wake_up_time - base::TimeTicks::Now();
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE, base::Bind(&DartTimerHeap::OnWakeUp,
+                            weak_factory_.GetWeakPtr(), wake_up_time),
+      std::max(delay, base::TimeDelta()));
 }
 
-void DartTimerHeap::Run(int id) {
-  auto it = heap_.find(id);
-  if (it == heap_.end())
+void DartTimerHeap::OnWakeUp(base::TimeTicks wake_up_time) {
+  if (wake_up_time == armed_wake_up_time_)
+    armed_wake_up_time_ = base::TimeTicks();
+
+  // Timers scheduled by the callbacks below wait for the next wakeup, even if
+  // they are already due, so that a zero-delay timer that reschedules itself
+  // cannot starve the message loop.
+  base::TimeTicks now = base::TimeTicks::Now();
+  base::TimeTicks run_until = std::max(now, wake_up_time);
+  uint64_t end_sequence = next_sequence_;
+  while (!deadlines_.empty()) {
+    const Deadline& deadline = deadlines_.top();
+    if (deadline.time > run_until || deadline.sequence >= end_sequence)
+      break;
+    int id = deadline.id;
+    deadlines_.pop();
+    Run(id, now);
+  }
+
+  ArmWakeUp();
+}
+
+void DartTimerHeap::Run(int id, base::TimeTicks now) {
+  auto it = tasks_.find(id);
+  if (it == tasks_.end())
     return;
-  std::unique_ptr<Task> task = std::unique_ptr<Task>(it->second.release());
-  heap_.erase(it);
+
+  // The closure may cancel its own timer, so keep the task alive while it
+  // runs.
+  std::unique_ptr<Task> task = std::move(it->second);
+  if (!task->repeating || !task->closure.dart_state())
+    tasks_.erase(it);
   if (!task->closure.dart_state())
     return;
-  DartIsolateScope scope(task->closure.dart_state()->isolate());
-  DartApiScope api_scope;
-  DartInvokeAppClosure(task->closure.value(), 0, nullptr);
   if (task->repeating)
-    Schedule(id, std::move(task));
+    Schedule(id, now, task->delay);
+
+  {
+    DartIsolateScope scope(task->closure.dart_state()->isolate());
+    DartApiScope api_scope;
+    DartInvokeAppClosure(task->closure.value(), 0, nullptr);
+  }
+
+  if (task->repeating) {
+    it = tasks_.find(id);
+    if (it != tasks_.end())
+      it->second = std::move(task);
+  }
 }
 
 }
@@ -5,7 +5,11 @@
 #ifndef SKY_ENGINE_TONIC_DART_TIMER_HEAP_H_
 #define SKY_ENGINE_TONIC_DART_TIMER_HEAP_H_
 
+#include <stdint.h>
+
+#include <queue>
 #include <unordered_map>
+#include <vector>
 
 #include "base/memory/weak_ptr.h"
 #include "base/time/time.h"
@@ -14,6 +18,10 @@
 
 namespace blink {
 
+// DartTimerHeap keeps the deadlines of an isolate's timers in a min-heap and
+// has at most one wakeup posted to the message loop for the earliest of them,
+// however many timers are pending. Cancelled timers are dropped from the heap
+// lazily and never run.
 class DartTimerHeap {
  public:
   DartTimerHeap();
@@ -28,12 +36,47 @@ class DartTimerHeap {
   int Add(std::unique_ptr<Task> task);
   void Remove(int id);
 
+  // Wakeups are delayed to the next multiple of |window| so that timers with
+  // nearby deadlines run together. Zero, the default, runs every timer at its
+  // deadline.
+  void set_coalescing_window(base::TimeDelta window) {
+    coalescing_window_ = window;
+  }
+
  private:
-  void Schedule(int id, std::unique_ptr<Task> task);
-  void Run(int id);
+  struct Deadline {
+    base::TimeTicks time;
+    // Breaks ties so that timers with the same deadline run in the order
+    // they were scheduled.
+    uint64_t sequence;
+    int id;
+
+    bool operator>(const Deadline& other) const {
+      if (time != other.time)
+        return time > other.time;
+      return sequence > other.sequence;
+    }
+  };
+
+  typedef std::priority_queue<Deadline,
+                              std::vector<Deadline>,
+                              std::greater<Deadline>> DeadlineQueue;
+
+  void Schedule(int id, base::TimeTicks now, base::TimeDelta delay);
+  void DropCancelledDeadlines();
+  void ArmWakeUp();
+  void OnWakeUp(base::TimeTicks wake_up_time);
+  void Run(int id, base::TimeTicks now);
 
   int next_timer_id_;
-  std::unordered_map<int, std::unique_ptr<Task>> heap_;
+  uint64_t next_sequence_;
+  std::unordered_map<int, std::unique_ptr<Task>> tasks_;
+  DeadlineQueue deadlines_;
+
+  // The time of the earliest wakeup posted to the message loop, or null if
+  // there is none.
+  base::TimeTicks armed_wake_up_time_;
+  base::TimeDelta coalescing_window_;
 
   base::WeakPtrFactory<DartTimerHeap> weak_factory_;
 };
@@ -19,6 +19,10 @@ DartWrappable::~DartWrappable() {
 void DartWrappable::AcceptDartGCVisitor(DartGCVisitor& visitor) const {
 }
 
+size_t DartWrappable::GetAllocationSize() {
+  return GetDartWrapperInfo().size_in_bytes;
+}
+
 Dart_Handle DartWrappable::CreateDartWrapper(DartState* dart_state) {
   DCHECK(!dart_wrapper_);
   const DartWrapperInfo& info = GetDartWrapperInfo();
@@ -35,7 +39,7 @@ Dart_Handle DartWrappable::CreateDartWrapper(DartState* dart_state) {
 
   info.ref_object(this);  // Balanced in FinalizeDartWrapper.
   dart_wrapper_ = Dart_NewPrologueWeakPersistentHandle(
-      wrapper, this, info.size_in_bytes, &FinalizeDartWrapper);
+      wrapper, this, GetAllocationSize(), &FinalizeDartWrapper);
 
   return wrapper;
 }
@@ -60,7 +64,7 @@ void DartWrappable::AssociateWithDartWrapper(Dart_NativeArguments args) {
 
   info.ref_object(this);  // Balanced in FinalizeDartWrapper.
   dart_wrapper_ = Dart_NewPrologueWeakPersistentHandle(
-      wrapper, this, info.size_in_bytes, &FinalizeDartWrapper);
+      wrapper, this, GetAllocationSize(), &FinalizeDartWrapper);
 }
 
 void DartWrappable::FinalizeDartWrapper(void* isolate_callback_data,
@@ -68,8 +72,14 @@ void DartWrappable::FinalizeDartWrapper(void* isolate_callback_data,
                                         void* peer) {
   DartWrappable* wrappable = reinterpret_cast<DartWrappable*>(peer);
   wrappable->dart_wrapper_ = nullptr;
+  // Balanced in CreateDartWrapper. Isolates without a DartState, like the
+  // service isolate, release the object right away.
+  if (DartState* dart_state = static_cast<DartState*>(isolate_callback_data)) {
+    dart_state->DeferFinalization(wrappable);
+    return;
+  }
   const DartWrapperInfo& info = wrappable->GetDartWrapperInfo();
-  info.deref_object(wrappable);  // Balanced in CreateDartWrapper.
+  info.deref_object(wrappable);
 }
 
 DartWrappable* DartConverterWrappable::FromDart(Dart_Handle handle) {
@@ -39,6 +39,12 @@ class DartWrappable {
   // at the end of your override.
   virtual void AcceptDartGCVisitor(DartGCVisitor& visitor) const;
 
+  // The native memory the object keeps alive, which is reported to the VM
+  // along with the wrapper so that collections keep pace with native memory
+  // and not just with the Dart heap. It is only asked for when the wrapper is
+  // created. The default is the size of the object itself.
+  virtual size_t GetAllocationSize();
+
   Dart_Handle CreateDartWrapper(DartState* dart_state);
   void AssociateWithDartWrapper(Dart_NativeArguments args);
   Dart_WeakPersistentHandle dart_wrapper() const { return dart_wrapper_; }
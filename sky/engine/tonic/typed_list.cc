@@ -0,0 +1,78 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/tonic/dart_error.h"
+#include "sky/engine/tonic/typed_list.h"
+
+namespace blink {
+
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+TypedList<kTypeName, ElemType>::TypedList(Dart_Handle list)
+    : data_(nullptr), num_elements_(0), dart_handle_(list) {
+  if (Dart_IsNull(list))
+    return;
+
+  Dart_TypedData_Type type;
+  Dart_TypedDataAcquireData(
+      list, &type, reinterpret_cast<void**>(&data_), &num_elements_);
+  DCHECK(!LogIfError(list));
+  ASSERT(type == kTypeName);
+}
+
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+TypedList<kTypeName, ElemType>::TypedList(
+    TypedList<kTypeName, ElemType>&& other)
+    : data_(other.data_),
+      num_elements_(other.num_elements_),
+      dart_handle_(other.dart_handle_) {
+  other.data_ = nullptr;
+  other.dart_handle_ = nullptr;
+}
+
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+TypedList<kTypeName, ElemType>::~TypedList() {
+  if (data_)
+    Dart_TypedDataReleaseData(dart_handle_);
+}
+
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+void TypedList<kTypeName, ElemType>::Release() {
+  if (data_)
+    Dart_TypedDataReleaseData(dart_handle_);
+  data_ = nullptr;
+  num_elements_ = 0;
+}
+
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+TypedList<kTypeName, ElemType>
+DartConverter<TypedList<kTypeName, ElemType>>::FromArgumentsWithNullCheck(
+    Dart_NativeArguments args,
+    int index,
+    Dart_Handle& exception) {
+  Dart_Handle list = Dart_GetNativeArgument(args, index);
+  DCHECK(!LogIfError(list));
+
+  TypedList<kTypeName, ElemType> result(list);
+  return result;
+}
+
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+void DartConverter<TypedList<kTypeName, ElemType>>::SetReturnValue(
+    Dart_NativeArguments args,
+    TypedList<kTypeName, ElemType> val) {
+  Dart_SetReturnValue(args, val.dart_handle());
+}
+
+#define TONIC_TYPED_LIST_INSTANTIATE(name, type)                   \
+  template class TypedList<Dart_TypedData_k##name, type>;          \
+  template struct DartConverter<TypedList<Dart_TypedData_k##name, type>>;
+
+TONIC_TYPED_LIST_INSTANTIATE(Uint8, uint8_t)
+TONIC_TYPED_LIST_INSTANTIATE(Int32, int32_t)
+TONIC_TYPED_LIST_INSTANTIATE(Float32, float)
+TONIC_TYPED_LIST_INSTANTIATE(Float64, double)
+
+#undef TONIC_TYPED_LIST_INSTANTIATE
+
+} // namespace blink
@@ -0,0 +1,76 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_TONIC_TYPED_LIST_H_
+#define SKY_ENGINE_TONIC_TYPED_LIST_H_
+
+#include "dart/runtime/include/dart_api.h"
+#include "sky/engine/tonic/dart_converter.h"
+
+namespace blink {
+
+// A simple wrapper around Dart TypedData objects. It uses
+// Dart_TypedDataAcquireData to obtain a raw pointer to the data, which is
+// released when this object is destroyed. Nothing is copied, so the data
+// can be read and written in place for as long as the object exists, but
+// no other Dart API may be called in the meantime.
+//
+// This is designed to be used with DartConverter only.
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+class TypedList {
+ public:
+  explicit TypedList(Dart_Handle list);
+  TypedList(TypedList<kTypeName, ElemType>&& other);
+  ~TypedList();
+
+  ElemType& at(intptr_t i)
+  {
+      CHECK(i < num_elements_);
+      return data_[i];
+  }
+  const ElemType& at(intptr_t i) const
+  {
+      CHECK(i < num_elements_);
+      return data_[i];
+  }
+
+  ElemType& operator[](intptr_t i) { return at(i); }
+  const ElemType& operator[](intptr_t i) const { return at(i); }
+
+  const ElemType* data() const { return data_; }
+  intptr_t num_elements() const { return num_elements_; }
+  Dart_Handle dart_handle() const { return dart_handle_; }
+
+  // Gives the data back to the VM before this object is destroyed, so that
+  // the list can be handed to Dart (e.g., as a callback argument). The
+  // element accessors must not be used afterwards.
+  void Release();
+
+ private:
+  ElemType* data_;
+  intptr_t num_elements_;
+  Dart_Handle dart_handle_;
+
+  TypedList(const TypedList<kTypeName, ElemType>& other) = delete;
+};
+
+template <Dart_TypedData_Type kTypeName, typename ElemType>
+struct DartConverter<TypedList<kTypeName, ElemType>> {
+  static void SetReturnValue(Dart_NativeArguments args,
+                             TypedList<kTypeName, ElemType> val);
+
+  static TypedList<kTypeName, ElemType> FromArgumentsWithNullCheck(
+      Dart_NativeArguments args,
+      int index,
+      Dart_Handle& exception);
+};
+
+typedef TypedList<Dart_TypedData_kUint8, uint8_t> Uint8List;
+typedef TypedList<Dart_TypedData_kInt32, int32_t> Int32List;
+typedef TypedList<Dart_TypedData_kFloat32, float> Float32List;
+typedef TypedList<Dart_TypedData_kFloat64, double> Float64List;
+
+} // namespace blink
+
+#endif  // SKY_ENGINE_TONIC_TYPED_LIST_H_
@@ -0,0 +1,125 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/engine/web/EngineMemoryDumpProvider.h"
+
+#include "base/message_loop/message_loop.h"
+#include "base/strings/stringprintf.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
+#include "sky/engine/platform/Partitions.h"
+#include "sky/engine/platform/fonts/FontCache.h"
+#include "sky/engine/platform/graphics/ImageDecodingStore.h"
+#include "sky/engine/wtf/StdLibExtras.h"
+#include "sky/engine/wtf/WTF.h"
+#include "third_party/skia/include/core/SkGraphics.h"
+
+namespace blink {
+namespace {
+
+using base::trace_event::MemoryAllocatorDump;
+using base::trace_event::ProcessMemoryDump;
+
+MemoryAllocatorDump* dumpPartition(ProcessMemoryDump* pmd, const char* name, const PartitionRootBase& root)
+{
+    MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(name);
+    dump->AddScalar(MemoryAllocatorDump::kNameSize, MemoryAllocatorDump::kUnitsBytes, root.totalSizeOfCommittedPages);
+    dump->AddScalar("reserved_size", MemoryAllocatorDump::kUnitsBytes, root.totalSizeOfSuperPages);
+    return dump;
+}
+
+// Breaks a size specific partition down by bucket, which tells apart the
+// kinds of objects that live in it and shows how much of their pages they
+// leave empty.
+class BucketStatsDumper final : public PartitionStatsDumper {
+public:
+    BucketStatsDumper(ProcessMemoryDump* pmd, const std::string& partitionName)
+        : m_pmd(pmd)
+        , m_partitionName(partitionName)
+        , m_totalActiveBytes(0)
+    {
+    }
+
+    void partitionDumpBucketStats(const PartitionBucketMemoryStats& stats) override
+    {
+        std::string name = base::StringPrintf("%s/buckets/bucket_%zu", m_partitionName.c_str(), stats.slotSize);
+        MemoryAllocatorDump* dump = m_pmd->CreateAllocatorDump(name);
+        dump->AddScalar(MemoryAllocatorDump::kNameSize, MemoryAllocatorDump::kUnitsBytes, stats.residentBytes);
+        dump->AddScalar(MemoryAllocatorDump::kNameObjectsCount, MemoryAllocatorDump::kUnitsObjects, stats.activeBytes / stats.slotSize);
+        dump->AddScalar("allocated_objects_size", MemoryAllocatorDump::kUnitsBytes, stats.activeBytes);
+        dump->AddScalar("freeable_size", MemoryAllocatorDump::kUnitsBytes, stats.freeableBytes);
+        m_totalActiveBytes += stats.activeBytes;
+    }
+
+    size_t totalActiveBytes() const { return m_totalActiveBytes; }
+
+private:
+    ProcessMemoryDump* m_pmd;
+    std::string m_partitionName;
+    size_t m_totalActiveBytes;
+};
+
+void dumpPartitionWithBuckets(ProcessMemoryDump* pmd, const char* name, const PartitionRoot& root)
+{
+    MemoryAllocatorDump* dump = dumpPartition(pmd, name, root);
+    BucketStatsDumper dumper(pmd, name);
+    partitionDumpBucketStats(root, &dumper);
+    dump->AddScalar("allocated_objects_size", MemoryAllocatorDump::kUnitsBytes, dumper.totalActiveBytes());
+}
+
+void dumpObjectCount(ProcessMemoryDump* pmd, const char* name, size_t count)
+{
+    MemoryAllocatorDump* dump = pmd->CreateAllocatorDump(name);
+    dump->AddScalar(MemoryAllocatorDump::kNameObjectsCount, MemoryAllocatorDump::kUnitsObjects, count);
+}
+
+} // namespace
+
+EngineMemoryDumpProvider* EngineMemoryDumpProvider::instance()
+{
+    DEFINE_STATIC_LOCAL(EngineMemoryDumpProvider, provider, ());
+    return &provider;
+}
+
+void EngineMemoryDumpProvider::registerDumpProvider()
+{
+    base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(this, base::MessageLoop::current()->task_runner());
+}
+
+void EngineMemoryDumpProvider::unregisterDumpProvider()
+{
+    base::trace_event::MemoryDumpManager::GetInstance()->UnregisterDumpProvider(this);
+}
+
+bool EngineMemoryDumpProvider::OnMemoryDump(ProcessMemoryDump* pmd)
+{
+    // The partitions only count whole pages, which is what they cost the
+    // process regardless of how full they are.
+    dumpPartitionWithBuckets(pmd, "partition_alloc/partitions/object_model", *Partitions::getObjectModelPartition());
+    dumpPartitionWithBuckets(pmd, "partition_alloc/partitions/rendering", *Partitions::getRenderingPartition());
+    dumpPartitionWithBuckets(pmd, "partition_alloc/partitions/line_layout", *Partitions::getLineLayoutPartition());
+    dumpPartitionWithBuckets(pmd, "partition_alloc/partitions/wrappable", *Partitions::getWrappablePartition());
+    dumpPartition(pmd, "partition_alloc/partitions/buffer", *WTF::Partitions::getBufferPartition());
+
+    MemoryAllocatorDump* decoders = pmd->CreateAllocatorDump("sky/image_decoding_store");
+    decoders->AddScalar(MemoryAllocatorDump::kNameSize, MemoryAllocatorDump::kUnitsBytes, ImageDecodingStore::instance()->memoryUsageInBytes());
+    decoders->AddScalar(MemoryAllocatorDump::kNameObjectsCount, MemoryAllocatorDump::kUnitsObjects, ImageDecodingStore::instance()->decoderCacheEntries());
+
+    // FontCache does not know the size of what it caches, only how much of
+    // it there is. The glyphs are in Skia's glyph cache.
+    FontCache::Statistics fonts = FontCache::fontCache()->statistics();
+    dumpObjectCount(pmd, "sky/font_cache/platform_data", fonts.platformDataCount);
+    dumpObjectCount(pmd, "sky/font_cache/font_data", fonts.fontDataCount);
+    dumpObjectCount(pmd, "sky/font_cache/font_data/inactive", fonts.inactiveFontDataCount);
+
+    MemoryAllocatorDump* glyphs = pmd->CreateAllocatorDump("skia/glyph_cache");
+    glyphs->AddScalar(MemoryAllocatorDump::kNameSize, MemoryAllocatorDump::kUnitsBytes, SkGraphics::GetFontCacheUsed());
+    glyphs->AddScalar(MemoryAllocatorDump::kNameObjectsCount, MemoryAllocatorDump::kUnitsObjects, SkGraphics::GetFontCacheCountUsed());
+
+    MemoryAllocatorDump* resources = pmd->CreateAllocatorDump("skia/resource_cache");
+    resources->AddScalar(MemoryAllocatorDump::kNameSize, MemoryAllocatorDump::kUnitsBytes, SkGraphics::GetResourceCacheTotalBytesUsed());
+    return true;
+}
+
+} // namespace blink
@@ -0,0 +1,33 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_WEB_ENGINEMEMORYDUMPPROVIDER_H_
+#define SKY_ENGINE_WEB_ENGINEMEMORYDUMPPROVIDER_H_
+
+#include "base/trace_event/memory_dump_provider.h"
+#include "sky/engine/wtf/Noncopyable.h"
+
+namespace blink {
+
+// Reports the engine's process-wide caches and allocators to memory-infra
+// traces. The caches it reads are main thread only, so it is registered with
+// the main thread's task runner.
+class EngineMemoryDumpProvider : public base::trace_event::MemoryDumpProvider {
+    WTF_MAKE_NONCOPYABLE(EngineMemoryDumpProvider);
+public:
+    static EngineMemoryDumpProvider* instance();
+
+    void registerDumpProvider();
+    void unregisterDumpProvider();
+
+    // MemoryDumpProvider:
+    bool OnMemoryDump(base::trace_event::ProcessMemoryDump*) override;
+
+private:
+    EngineMemoryDumpProvider() { }
+};
+
+} // namespace blink
+
+#endif // SKY_ENGINE_WEB_ENGINEMEMORYDUMPPROVIDER_H_
@@ -30,6 +30,9 @@
 
 #include "sky/engine/public/web/Sky.h"
 
+#include <algorithm>
+
+#include "base/memory/memory_pressure_listener.h"
 #include "base/message_loop/message_loop.h"
 #include "base/rand_util.h"
 #include "gen/sky/platform/RuntimeEnabledFeatures.h"
@@ -39,9 +42,15 @@
 #include "sky/engine/core/Init.h"
 #include "sky/engine/core/page/Page.h"
 #include "sky/engine/core/script/dart_init.h"
+#include "sky/engine/platform/AllocationSampler.h"
 #include "sky/engine/platform/LayoutTestSupport.h"
 #include "sky/engine/platform/Logging.h"
+#include "sky/engine/platform/TraceEvent.h"
+#include "sky/engine/platform/fonts/FontCache.h"
+#include "sky/engine/platform/fonts/harfbuzz/HarfBuzzShaper.h"
+#include "sky/engine/platform/graphics/ImageDecodingStore.h"
 #include "sky/engine/public/platform/Platform.h"
+#include "sky/engine/web/EngineMemoryDumpProvider.h"
 #include "sky/engine/wtf/Assertions.h"
 #include "sky/engine/wtf/CryptographicallyRandomNumber.h"
 #include "sky/engine/wtf/MainThread.h"
@@ -69,10 +78,20 @@ public:
     void DidProcessTask(const base::PendingTask& pending_task) override { didProcessTask(); }
 };
 
+// Mojo handle signals run their handlers outside of a base task, so they
+// are traced here to show up next to the tasks in a trace.
 class SignalObserver : public mojo::common::MessagePumpMojo::Observer {
 public:
-    void WillSignalHandler() override { willProcessTask(); }
-    void DidSignalHandler() override { didProcessTask(); }
+    void WillSignalHandler() override
+    {
+        TRACE_EVENT_BEGIN0("sky", "SignalHandler");
+        willProcessTask();
+    }
+    void DidSignalHandler() override
+    {
+        didProcessTask();
+        TRACE_EVENT_END0("sky", "SignalHandler");
+    }
 };
 
 static TaskObserver* s_taskObserver = 0;
@@ -142,12 +161,16 @@ void initialize(Platform* platform)
     InitDartVM();
 
     addMessageLoopObservers();
+
+    EngineMemoryDumpProvider::instance()->registerDumpProvider();
 }
 
 void shutdown()
 {
     removeMessageLoopObservers();
 
+    EngineMemoryDumpProvider::instance()->unregisterDumpProvider();
+
     // FIXME: Shutdown dart?
 
     CoreInitializer::shutdown();
@@ -155,6 +178,42 @@ void shutdown()
     Platform::shutdown();
 }
 
+// Fonts are shared by every view in the process, so they are purged here
+// rather than by each view. The font caches do not track their sizes, so
+// only the decoders are counted.
+size_t purgeMemory(base::MemoryPressureListener::MemoryPressureLevel level)
+{
+    TRACE_EVENT1("blink", "purgeMemory", "level", level);
+    ImageDecodingStore* decodingStore = ImageDecodingStore::instance();
+    size_t decoderBytes = decodingStore->memoryUsageInBytes();
+    switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+        return 0;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+        FontCache::fontCache()->purge(PurgeIfNeeded);
+        return 0;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+        // Cached shaping results hold on to their fonts, so drop them first.
+        HarfBuzzShaper::clearRunCache();
+        FontCache::fontCache()->purge(ForcePurge);
+        // Decoders kept around to decode discarded images again. Ones that
+        // are in use stay.
+        decodingStore->clear();
+        return decoderBytes - std::min(decoderBytes, decodingStore->memoryUsageInBytes());
+    }
+    return 0;
+}
+
+void startAllocationSampling(size_t sampleIntervalBytes)
+{
+    AllocationSampler::start(sampleIntervalBytes);
+}
+
+void stopAllocationSampling()
+{
+    AllocationSampler::stop();
+}
+
 void setLayoutTestMode(bool value)
 {
     LayoutTestSupport::setIsRunningLayoutTest(value);
@@ -31,6 +31,7 @@
 #include "sky/engine/public/web/WebRuntimeFeatures.h"
 
 #include "gen/sky/platform/RuntimeEnabledFeatures.h"
+#include "sky/engine/platform/graphics/DeferredImageDecoder.h"
 #include "sky/engine/wtf/Assertions.h"
 
 namespace blink {
@@ -40,6 +41,11 @@ void WebRuntimeFeatures::enableExperimentalFeatures(bool enable)
     RuntimeEnabledFeatures::setExperimentalFeaturesEnabled(enable);
 }
 
+void WebRuntimeFeatures::enableDeferredImageDecoding(bool enable)
+{
+    DeferredImageDecoder::setEnabled(enable);
+}
+
 void WebRuntimeFeatures::enableBleedingEdgeFastPaths(bool enable)
 {
     ASSERT(enable);
@@ -180,4 +186,14 @@ void WebRuntimeFeatures::enableDartCheckedMode(bool enable)
     RuntimeEnabledFeatures::setDartCheckedModeEnabled(enable);
 }
 
+void WebRuntimeFeatures::enableDartCompileAll(bool enable)
+{
+    RuntimeEnabledFeatures::setDartCompileAllEnabled(enable);
+}
+
+void WebRuntimeFeatures::enableColorManagedImages(bool enable)
+{
+    RuntimeEnabledFeatures::setColorManagedImagesEnabled(enable);
+}
+
 } // namespace blink
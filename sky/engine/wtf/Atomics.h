@@ -85,6 +85,16 @@ ALWAYS_INLINE unsigned acquireLoad(volatile const unsigned* ptr)
 {
     return static_cast<unsigned>(__tsan_atomic32_load(reinterpret_cast<volatile const int*>(ptr), __tsan_memory_order_acquire));
 }
+
+ALWAYS_INLINE void releaseStore(void* volatile* ptr, void* value)
+{
+    __tsan_atomic64_store(reinterpret_cast<volatile __tsan_atomic64*>(ptr), reinterpret_cast<__tsan_atomic64>(value), __tsan_memory_order_release);
+}
+
+ALWAYS_INLINE void* acquireLoad(void* volatile const* ptr)
+{
+    return reinterpret_cast<void*>(__tsan_atomic64_load(reinterpret_cast<volatile const __tsan_atomic64*>(ptr), __tsan_memory_order_acquire));
+}
 #else
 
 #if CPU(X86) || CPU(X86_64)
@@ -132,6 +142,19 @@ ALWAYS_INLINE unsigned acquireLoad(volatile const unsigned* ptr)
     return value;
 }
 
+ALWAYS_INLINE void releaseStore(void* volatile* ptr, void* value)
+{
+    MEMORY_BARRIER();
+    *ptr = value;
+}
+
+ALWAYS_INLINE void* acquireLoad(void* volatile const* ptr)
+{
+    void* value = *ptr;
+    MEMORY_BARRIER();
+    return value;
+}
+
 #undef MEMORY_BARRIER
 
 #endif
@@ -61,6 +61,17 @@ ALWAYS_INLINE uint64_t countLeadingZeros64(uint64_t x)
     return LIKELY(x) ? __builtin_clzll(x) : 64;
 }
 
+// The same goes for __builtin_ctz.
+ALWAYS_INLINE uint32_t countTrailingZeros32(uint32_t x)
+{
+    return LIKELY(x) ? __builtin_ctz(x) : 32;
+}
+
+ALWAYS_INLINE uint64_t countTrailingZeros64(uint64_t x)
+{
+    return LIKELY(x) ? __builtin_ctzll(x) : 64;
+}
+
 #endif
 
 #if CPU(64BIT)
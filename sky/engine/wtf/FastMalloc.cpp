@@ -83,4 +83,14 @@ void* fastRealloc(void* p, size_t n)
     return partitionReallocGeneric(gPartition.root(), p, n);
 }
 
+size_t fastMallocAllocationCount()
+{
+    return gInitialized ? gPartition.root()->totalAllocations : 0;
+}
+
+size_t fastMallocAllocatedBytes()
+{
+    return gInitialized ? gPartition.root()->totalAllocatedBytes : 0;
+}
+
 } // namespace WTF
@@ -38,6 +38,11 @@ WTF_EXPORT char* fastStrDup(const char*);
 
 WTF_EXPORT void fastFree(void*);
 
+// The number of fastMalloc() and fastRealloc() allocations so far, and the
+// bytes they asked for.
+WTF_EXPORT size_t fastMallocAllocationCount();
+WTF_EXPORT size_t fastMallocAllocatedBytes();
+
 } // namespace WTF
 
 using WTF::fastFree;
@@ -0,0 +1,140 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_WTF_FLATHASHMAP_H_
+#define SKY_ENGINE_WTF_FLATHASHMAP_H_
+
+#include "sky/engine/wtf/FlatHashTable.h"
+#include "sky/engine/wtf/HashMap.h"
+
+namespace WTF {
+
+// A HashMap on a FlatHashTable, for maps that are looked up and changed
+// often. It has the same interface as HashMap, except that there are no keys()
+// or values() ranges and that the traits' empty and deleted values can be used
+// as keys whenever the hash functions accept them, as they do for integers.
+template<
+    typename KeyArg,
+    typename MappedArg,
+    typename HashArg = typename DefaultHash<KeyArg>::Hash,
+    typename KeyTraitsArg = HashTraits<KeyArg>,
+    typename MappedTraitsArg = HashTraits<MappedArg> >
+class FlatHashMap {
+    WTF_USE_ALLOCATOR(FlatHashMap, DefaultAllocator);
+private:
+    typedef KeyTraitsArg KeyTraits;
+    typedef MappedTraitsArg MappedTraits;
+    typedef HashMapValueTraits<KeyTraits, MappedTraits> ValueTraits;
+
+public:
+    typedef typename KeyTraits::TraitType KeyType;
+    typedef typename KeyTraits::PassInType KeyPassInType;
+    typedef const typename KeyTraits::PeekInType& KeyPeekInType;
+    typedef typename MappedTraits::TraitType MappedType;
+    typedef typename ValueTraits::TraitType ValueType;
+
+private:
+    typedef typename MappedTraits::PassInType MappedPassInType;
+    typedef typename MappedTraits::PassOutType MappedPassOutType;
+    typedef typename MappedTraits::PeekOutType MappedPeekType;
+
+    typedef typename ReferenceTypeMaker<MappedPassInType>::ReferenceType MappedPassInReferenceType;
+
+    typedef HashArg HashFunctions;
+
+    typedef FlatHashTable<KeyType, ValueType, KeyValuePairKeyExtractor,
+        HashFunctions, ValueTraits> HashTableType;
+    typedef HashMapTranslator<ValueTraits, HashFunctions> Translator;
+
+public:
+    typedef typename HashTableType::iterator iterator;
+    typedef typename HashTableType::const_iterator const_iterator;
+    typedef typename HashTableType::AddResult AddResult;
+
+    void swap(FlatHashMap& other) { m_impl.swap(other.m_impl); }
+
+    unsigned size() const { return m_impl.size(); }
+    unsigned capacity() const { return m_impl.capacity(); }
+    bool isEmpty() const { return m_impl.isEmpty(); }
+
+    // iterators iterate over pairs of keys and values
+    iterator begin() { return m_impl.begin(); }
+    iterator end() { return m_impl.end(); }
+    const_iterator begin() const { return m_impl.begin(); }
+    const_iterator end() const { return m_impl.end(); }
+
+    iterator find(KeyPeekInType key) { return m_impl.template find<Translator>(key); }
+    const_iterator find(KeyPeekInType key) const { return m_impl.template find<Translator>(key); }
+    bool contains(KeyPeekInType key) const { return m_impl.template contains<Translator>(key); }
+    MappedPeekType get(KeyPeekInType) const;
+
+    // replaces value but not key if key is already present
+    // return value is a pair of the iterator to the key location,
+    // and a boolean that's true if a new value was actually added
+    AddResult set(KeyPassInType, MappedPassInType);
+
+    // does nothing if key is already present
+    // return value is a pair of the iterator to the key location,
+    // and a boolean that's true if a new value was actually added
+    AddResult add(KeyPassInType key, MappedPassInType mapped) { return inlineAdd(key, mapped); }
+
+    void remove(KeyPeekInType key) { remove(find(key)); }
+    void remove(iterator it) { m_impl.remove(it); }
+    void clear() { m_impl.clear(); }
+
+    MappedPassOutType take(KeyPeekInType); // efficient combination of get with remove
+
+    // Finds by hashing and comparing with some other type, as for HashMap.
+    template<typename HashTranslator, typename T> iterator find(const T& key) { return m_impl.template find<HashTranslator>(key); }
+    template<typename HashTranslator, typename T> const_iterator find(const T& key) const { return m_impl.template find<HashTranslator>(key); }
+    template<typename HashTranslator, typename T> bool contains(const T& key) const { return m_impl.template contains<HashTranslator>(key); }
+
+private:
+    AddResult inlineAdd(KeyPassInType key, MappedPassInReferenceType mapped)
+    {
+        return m_impl.template add<Translator>(key, mapped);
+    }
+
+    HashTableType m_impl;
+};
+
+template<typename T, typename U, typename V, typename W, typename X>
+typename FlatHashMap<T, U, V, W, X>::AddResult
+FlatHashMap<T, U, V, W, X>::set(KeyPassInType key, MappedPassInType mapped)
+{
+    AddResult result = inlineAdd(key, mapped);
+    if (!result.isNewEntry) {
+        // The inlineAdd call above found an existing hash table entry; we need to set the mapped value.
+        MappedTraits::store(mapped, result.storedValue->value);
+    }
+    return result;
+}
+
+template<typename T, typename U, typename V, typename W, typename X>
+typename FlatHashMap<T, U, V, W, X>::MappedPeekType
+FlatHashMap<T, U, V, W, X>::get(KeyPeekInType key) const
+{
+    ValueType* entry = m_impl.template lookup<Translator>(key);
+    if (!entry)
+        return MappedTraits::peek(MappedTraits::emptyValue());
+    return MappedTraits::peek(entry->value);
+}
+
+template<typename T, typename U, typename V, typename W, typename X>
+typename FlatHashMap<T, U, V, W, X>::MappedPassOutType
+FlatHashMap<T, U, V, W, X>::take(KeyPeekInType key)
+{
+    iterator it = find(key);
+    if (it == end())
+        return MappedTraits::passOut(MappedTraits::emptyValue());
+    MappedPassOutType result = MappedTraits::passOut(it->value);
+    remove(it);
+    return result;
+}
+
+} // namespace WTF
+
+using WTF::FlatHashMap;
+
+#endif  // SKY_ENGINE_WTF_FLATHASHMAP_H_
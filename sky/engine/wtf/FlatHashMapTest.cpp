@@ -0,0 +1,234 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include <gtest/gtest.h>
+#include "sky/engine/wtf/FlatHashMap.h"
+#include "sky/engine/wtf/FlatHashSet.h"
+#include "sky/engine/wtf/OwnPtr.h"
+#include "sky/engine/wtf/PassOwnPtr.h"
+#include "sky/engine/wtf/PassRefPtr.h"
+#include "sky/engine/wtf/RefCounted.h"
+#include "sky/engine/wtf/text/AtomicString.h"
+#include "sky/engine/wtf/text/AtomicStringHash.h"
+
+namespace {
+
+typedef WTF::FlatHashMap<int, int> IntFlatHashMap;
+
+TEST(FlatHashMapTest, IteratorComparison)
+{
+    IntFlatHashMap map;
+    EXPECT_TRUE(map.begin() == map.end());
+    map.add(1, 2);
+    EXPECT_TRUE(map.begin() != map.end());
+    EXPECT_FALSE(map.begin() == map.end());
+
+    IntFlatHashMap::const_iterator begin = map.begin();
+    EXPECT_TRUE(begin == map.begin());
+    EXPECT_TRUE(map.begin() == begin);
+    EXPECT_TRUE(begin != map.end());
+    EXPECT_TRUE(map.end() != begin);
+    EXPECT_FALSE(begin == map.end());
+}
+
+TEST(FlatHashMapTest, EmptyAndDeletedKeys)
+{
+    // HashMap reserves 0 and -1 for empty and deleted buckets.
+    IntFlatHashMap map;
+    map.add(0, 1);
+    map.add(-1, 2);
+    EXPECT_EQ(2u, map.size());
+    EXPECT_EQ(1, map.get(0));
+    EXPECT_EQ(2, map.get(-1));
+    map.remove(0);
+    EXPECT_FALSE(map.contains(0));
+    EXPECT_TRUE(map.contains(-1));
+}
+
+TEST(FlatHashMapTest, AddSetTake)
+{
+    IntFlatHashMap map;
+    IntFlatHashMap::AddResult result = map.add(1, 10);
+    EXPECT_TRUE(result.isNewEntry);
+    EXPECT_EQ(1, result.storedValue->key);
+    EXPECT_EQ(10, result.storedValue->value);
+
+    result = map.add(1, 20);
+    EXPECT_FALSE(result.isNewEntry);
+    EXPECT_EQ(10, map.get(1));
+
+    result = map.set(1, 30);
+    EXPECT_FALSE(result.isNewEntry);
+    EXPECT_EQ(30, map.get(1));
+
+    EXPECT_EQ(30, map.take(1));
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(0, map.get(1));
+}
+
+TEST(FlatHashMapTest, ManyKeys)
+{
+    IntFlatHashMap map;
+    for (int i = 0; i < 10000; ++i)
+        map.add(i * 7, i);
+    EXPECT_EQ(10000u, map.size());
+    EXPECT_LE(map.size(), map.capacity());
+
+    for (int i = 0; i < 10000; ++i) {
+        IntFlatHashMap::iterator it = map.find(i * 7);
+        ASSERT_TRUE(it != map.end());
+        EXPECT_EQ(i, it->value);
+        EXPECT_FALSE(map.contains(i * 7 + 1));
+    }
+
+    unsigned count = 0;
+    for (IntFlatHashMap::const_iterator it = map.begin(); it != map.end(); ++it) {
+        EXPECT_EQ(it->key, it->value * 7);
+        ++count;
+    }
+    EXPECT_EQ(10000u, count);
+
+    for (int i = 0; i < 10000; i += 2)
+        map.remove(i * 7);
+    EXPECT_EQ(5000u, map.size());
+    for (int i = 0; i < 10000; ++i)
+        EXPECT_EQ(i % 2 == 1, map.contains(i * 7));
+
+    IntFlatHashMap copy(map);
+    EXPECT_EQ(5000u, copy.size());
+    EXPECT_EQ(7, copy.get(49));
+
+    map.clear();
+    EXPECT_TRUE(map.isEmpty());
+    EXPECT_EQ(0u, map.capacity());
+    EXPECT_FALSE(map.contains(49));
+}
+
+TEST(FlatHashMapTest, ChurnDoesNotGrow)
+{
+    IntFlatHashMap map;
+    for (int i = 0; i < 100; ++i)
+        map.add(i, i);
+
+    // Keep a hundred keys in the table while a million go through it. The
+    // table may grow once to make room for tombstones, but not after that.
+    unsigned capacity = 0;
+    for (int i = 100; i < 1000000; ++i) {
+        map.remove(i - 100);
+        map.add(i, i);
+        if (i == 10000)
+            capacity = map.capacity();
+    }
+    EXPECT_EQ(100u, map.size());
+    EXPECT_EQ(capacity, map.capacity());
+    EXPECT_LE(map.capacity(), 256u);
+    for (int i = 1000000 - 100; i < 1000000; ++i)
+        EXPECT_EQ(i, map.get(i));
+}
+
+class DestructCounter {
+public:
+    explicit DestructCounter(int i, int* destructNumber)
+        : m_i(i)
+        , m_destructNumber(destructNumber)
+    { }
+
+    ~DestructCounter() { ++(*m_destructNumber); }
+    int get() const { return m_i; }
+
+private:
+    int m_i;
+    int* m_destructNumber;
+};
+
+typedef WTF::FlatHashMap<int, OwnPtr<DestructCounter> > OwnPtrFlatHashMap;
+
+TEST(FlatHashMapTest, OwnPtrAsValue)
+{
+    int destructNumber = 0;
+    {
+        OwnPtrFlatHashMap map;
+        for (int i = 0; i < 100; ++i)
+            map.add(i, adoptPtr(new DestructCounter(i, &destructNumber)));
+        EXPECT_EQ(0, destructNumber);
+
+        for (OwnPtrFlatHashMap::iterator iter = map.begin(); iter != map.end(); ++iter)
+            EXPECT_EQ(iter->key, iter->value->get());
+
+        OwnPtr<DestructCounter> ownCounter1 = map.take(1);
+        EXPECT_EQ(1, ownCounter1->get());
+        EXPECT_FALSE(map.contains(1));
+        EXPECT_EQ(0, destructNumber);
+
+        map.remove(2);
+        EXPECT_EQ(1, destructNumber);
+        EXPECT_EQ(3, map.get(3)->get());
+    }
+    EXPECT_EQ(100, destructNumber);
+}
+
+class DummyRefCounted : public WTF::RefCounted<DummyRefCounted> {
+public:
+    explicit DummyRefCounted(bool& isDeleted) : m_isDeleted(isDeleted) { m_isDeleted = false; }
+    ~DummyRefCounted() { m_isDeleted = true; }
+
+private:
+    bool& m_isDeleted;
+};
+
+TEST(FlatHashMapTest, RefPtrAsKey)
+{
+    bool isDeleted = false;
+    RefPtr<DummyRefCounted> ptr = adoptRef(new DummyRefCounted(isDeleted));
+    FlatHashMap<RefPtr<DummyRefCounted>, int> map;
+    map.add(ptr, 1);
+    EXPECT_EQ(1, map.get(ptr));
+
+    DummyRefCounted* rawPtr = ptr.get();
+    EXPECT_TRUE(map.contains(rawPtr));
+    EXPECT_TRUE(map.find(rawPtr) != map.end());
+
+    ptr.clear();
+    EXPECT_FALSE(isDeleted);
+
+    map.remove(rawPtr);
+    EXPECT_TRUE(isDeleted);
+    EXPECT_TRUE(map.isEmpty());
+}
+
+TEST(FlatHashMapTest, AtomicStringKeys)
+{
+    FlatHashMap<AtomicString, int> map;
+    map.add(AtomicString("foo"), 1);
+    map.add(AtomicString("bar"), 2);
+    EXPECT_EQ(1, map.get(AtomicString("foo")));
+    EXPECT_EQ(2, map.get(AtomicString("bar")));
+    EXPECT_FALSE(map.contains(AtomicString("baz")));
+    map.remove(AtomicString("foo"));
+    EXPECT_FALSE(map.contains(AtomicString("foo")));
+    EXPECT_EQ(2, map.get(AtomicString("bar")));
+}
+
+TEST(FlatHashSetTest, AddRemove)
+{
+    FlatHashSet<int> set;
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_TRUE(set.add(i).isNewEntry);
+    EXPECT_FALSE(set.add(0).isNewEntry);
+    EXPECT_EQ(1000u, set.size());
+
+    for (int i = 0; i < 1000; i += 3)
+        set.remove(i);
+    for (int i = 0; i < 1000; ++i)
+        EXPECT_EQ(i % 3 != 0, set.contains(i));
+
+    EXPECT_EQ(1, set.take(1));
+    EXPECT_FALSE(set.contains(1));
+
+    int any = set.takeAny();
+    EXPECT_FALSE(set.contains(any));
+    EXPECT_EQ(664u, set.size());
+}
+
+} // namespace
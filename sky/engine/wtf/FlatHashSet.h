@@ -0,0 +1,88 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_WTF_FLATHASHSET_H_
+#define SKY_ENGINE_WTF_FLATHASHSET_H_
+
+#include "sky/engine/wtf/FlatHashTable.h"
+#include "sky/engine/wtf/HashSet.h"
+
+namespace WTF {
+
+// A HashSet on a FlatHashTable. See FlatHashMap.
+template<
+    typename ValueArg,
+    typename HashArg = typename DefaultHash<ValueArg>::Hash,
+    typename TraitsArg = HashTraits<ValueArg> >
+class FlatHashSet {
+    WTF_USE_ALLOCATOR(FlatHashSet, DefaultAllocator);
+private:
+    typedef HashArg HashFunctions;
+    typedef TraitsArg ValueTraits;
+    typedef typename ValueTraits::PeekInType ValuePeekInType;
+    typedef typename ValueTraits::PassInType ValuePassInType;
+    typedef typename ValueTraits::PassOutType ValuePassOutType;
+
+public:
+    typedef typename ValueTraits::TraitType ValueType;
+
+private:
+    typedef FlatHashTable<ValueType, ValueType, IdentityExtractor,
+        HashFunctions, ValueTraits> HashTableType;
+    typedef IdentityHashTranslator<HashFunctions> Translator;
+
+public:
+    typedef typename HashTableType::const_iterator iterator;
+    typedef typename HashTableType::const_iterator const_iterator;
+    typedef typename HashTableType::AddResult AddResult;
+
+    void swap(FlatHashSet& other) { m_impl.swap(other.m_impl); }
+
+    unsigned size() const { return m_impl.size(); }
+    unsigned capacity() const { return m_impl.capacity(); }
+    bool isEmpty() const { return m_impl.isEmpty(); }
+
+    iterator begin() const { return m_impl.begin(); }
+    iterator end() const { return m_impl.end(); }
+
+    iterator find(ValuePeekInType value) const { return m_impl.template find<Translator>(value); }
+    bool contains(ValuePeekInType value) const { return m_impl.template contains<Translator>(value); }
+
+    // Finds by hashing and comparing with some other type, as for HashSet.
+    template<typename HashTranslator, typename T> iterator find(const T& value) const { return m_impl.template find<HashTranslator>(value); }
+    template<typename HashTranslator, typename T> bool contains(const T& value) const { return m_impl.template contains<HashTranslator>(value); }
+
+    // The return value is a pair of a pointer to the new value's location,
+    // and a bool that is true if an new entry was added.
+    AddResult add(ValuePassInType value) { return m_impl.template add<Translator>(value, value); }
+
+    void remove(ValuePeekInType value) { remove(find(value)); }
+    void remove(iterator it) { m_impl.remove(it); }
+    void clear() { m_impl.clear(); }
+
+    ValuePassOutType take(iterator);
+    ValuePassOutType take(ValuePeekInType value) { return take(find(value)); }
+    ValuePassOutType takeAny() { return take(begin()); }
+
+private:
+    HashTableType m_impl;
+};
+
+template<typename T, typename U, typename V>
+inline typename FlatHashSet<T, U, V>::ValuePassOutType FlatHashSet<T, U, V>::take(iterator it)
+{
+    if (it == end())
+        return ValueTraits::emptyValue();
+
+    ValuePassOutType result = ValueTraits::passOut(const_cast<ValueType&>(*it));
+    remove(it);
+
+    return result;
+}
+
+} // namespace WTF
+
+using WTF::FlatHashSet;
+
+#endif  // SKY_ENGINE_WTF_FLATHASHSET_H_
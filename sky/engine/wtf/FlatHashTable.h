@@ -0,0 +1,468 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_ENGINE_WTF_FLATHASHTABLE_H_
+#define SKY_ENGINE_WTF_FLATHASHTABLE_H_
+
+#include <stdint.h>
+#include <string.h>
+#include <utility>
+#include "sky/engine/wtf/Assertions.h"
+#include "sky/engine/wtf/BitwiseOperations.h"
+#include "sky/engine/wtf/CPU.h"
+#include "sky/engine/wtf/DefaultAllocator.h"
+#include "sky/engine/wtf/HashTable.h"
+
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+#define FLAT_HASH_TABLE_USE_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace WTF {
+
+// An open-addressed hash table that keeps one control byte per slot next to
+// the slots themselves. A full slot's control byte holds seven bits of its
+// hash, so that a lookup compares a whole group of control bytes against the
+// key's hash at once and only compares keys for the slots that match. Unlike
+// HashTable, no key values are reserved for empty and deleted slots, and
+// tables that see adds and removes all the time do not get slower, since a
+// removed slot is only kept as a tombstone when a probe may have passed it.
+//
+// FlatHashMap and FlatHashSet wrap this with the interface of HashMap and
+// HashSet. Like those, any add or remove invalidates iterators and pointers
+// into the table.
+
+class FlatHashGroup {
+public:
+    static const int8_t empty = -128;
+    static const int8_t deleted = -2;
+
+#if defined(FLAT_HASH_TABLE_USE_SSE2)
+    static const unsigned width = 16;
+    typedef uint32_t Mask;
+
+    explicit FlatHashGroup(const int8_t* control)
+        : m_control(_mm_loadu_si128(reinterpret_cast<const __m128i*>(control)))
+    {
+    }
+
+    // A bit for each slot whose control byte is |hash|.
+    Mask match(int8_t hash) const
+    {
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(hash), m_control));
+    }
+    Mask matchEmpty() const { return match(empty); }
+    Mask matchEmptyOrDeleted() const { return _mm_movemask_epi8(m_control); }
+
+    static unsigned lowestSlot(Mask mask) { return countTrailingZeros32(mask); }
+    static unsigned highestSlot(Mask mask) { return 31 - countLeadingZeros32(mask); }
+#else
+    // Without SSE2, a group is eight control bytes tested with ordinary
+    // integer arithmetic. The mask has the top bit of each matching byte set.
+    static const unsigned width = 8;
+    typedef uint64_t Mask;
+
+    explicit FlatHashGroup(const int8_t* control)
+    {
+        memcpy(&m_control, control, sizeof(m_control));
+    }
+
+    // May report a slot whose byte is |hash| + 1 right after a real match,
+    // which costs a key comparison but never misses a slot.
+    Mask match(int8_t hash) const
+    {
+        uint64_t x = m_control ^ (lsbs * static_cast<uint8_t>(hash));
+        return (x - lsbs) & ~x & msbs;
+    }
+    // Empty is the only control byte with the top bit set and bit 1 clear.
+    Mask matchEmpty() const { return m_control & ~(m_control << 6) & msbs; }
+    Mask matchEmptyOrDeleted() const { return m_control & msbs; }
+
+    static unsigned lowestSlot(Mask mask) { return countTrailingZeros64(mask) >> 3; }
+    static unsigned highestSlot(Mask mask) { return (63 - countLeadingZeros64(mask)) >> 3; }
+
+private:
+    static const uint64_t lsbs = 0x0101010101010101ULL;
+    static const uint64_t msbs = 0x8080808080808080ULL;
+#endif
+
+public:
+    static Mask clearLowestSlot(Mask mask) { return mask & (mask - 1); }
+
+private:
+#if defined(FLAT_HASH_TABLE_USE_SSE2)
+    __m128i m_control;
+#else
+    uint64_t m_control;
+#endif
+};
+
+template<typename T>
+class FlatHashTableIterator {
+public:
+    FlatHashTableIterator()
+        : m_control(0)
+        , m_controlEnd(0)
+        , m_slot(0)
+    {
+    }
+
+    FlatHashTableIterator(const int8_t* control, const int8_t* controlEnd, T* slot)
+        : m_control(control)
+        , m_controlEnd(controlEnd)
+        , m_slot(slot)
+    {
+        skipEmptySlots();
+    }
+
+    // Allows an iterator to be converted to a const_iterator.
+    template<typename U>
+    FlatHashTableIterator(const FlatHashTableIterator<U>& other)
+        : m_control(other.m_control)
+        , m_controlEnd(other.m_controlEnd)
+        , m_slot(other.m_slot)
+    {
+    }
+
+    T* get() const { return m_slot; }
+    T& operator*() const { return *m_slot; }
+    T* operator->() const { return m_slot; }
+
+    FlatHashTableIterator& operator++()
+    {
+        ++m_control;
+        ++m_slot;
+        skipEmptySlots();
+        return *this;
+    }
+
+private:
+    template<typename U> friend class FlatHashTableIterator;
+
+    void skipEmptySlots()
+    {
+        while (m_control != m_controlEnd && *m_control < 0) {
+            ++m_control;
+            ++m_slot;
+        }
+    }
+
+    const int8_t* m_control;
+    const int8_t* m_controlEnd;
+    T* m_slot;
+};
+
+template<typename T, typename U>
+inline bool operator==(const FlatHashTableIterator<T>& a, const FlatHashTableIterator<U>& b)
+{
+    return a.get() == b.get();
+}
+
+template<typename T, typename U>
+inline bool operator!=(const FlatHashTableIterator<T>& a, const FlatHashTableIterator<U>& b)
+{
+    return a.get() != b.get();
+}
+
+template<typename ValueType>
+struct FlatHashTableAddResult {
+    FlatHashTableAddResult(ValueType* storedValue, bool isNewEntry)
+        : storedValue(storedValue)
+        , isNewEntry(isNewEntry)
+    {
+    }
+
+    ValueType* storedValue;
+    bool isNewEntry;
+};
+
+template<typename Key, typename Value, typename Extractor, typename HashFunctions, typename Traits>
+class FlatHashTable {
+public:
+    typedef Key KeyType;
+    typedef Value ValueType;
+    typedef FlatHashTableIterator<ValueType> iterator;
+    typedef FlatHashTableIterator<const ValueType> const_iterator;
+    typedef FlatHashTableAddResult<ValueType> AddResult;
+
+    FlatHashTable()
+        : m_control(0)
+        , m_slots(0)
+        , m_capacity(0)
+        , m_size(0)
+        , m_growthLeft(0)
+    {
+    }
+
+    FlatHashTable(const FlatHashTable& other)
+        : m_control(0)
+        , m_slots(0)
+        , m_capacity(0)
+        , m_size(0)
+        , m_growthLeft(0)
+    {
+        if (!other.m_size)
+            return;
+        allocate(capacityForSize(other.m_size));
+        for (const_iterator it = other.begin(); it != other.end(); ++it) {
+            ValueType* slot = insertNew(hashOf(Extractor::extract(*it)));
+            new (NotNull, slot) ValueType(*it);
+        }
+    }
+
+    ~FlatHashTable()
+    {
+        destroyAll();
+        deallocate();
+    }
+
+    FlatHashTable& operator=(const FlatHashTable& other)
+    {
+        FlatHashTable copy(other);
+        swap(copy);
+        return *this;
+    }
+
+    void swap(FlatHashTable& other)
+    {
+        std::swap(m_control, other.m_control);
+        std::swap(m_slots, other.m_slots);
+        std::swap(m_capacity, other.m_capacity);
+        std::swap(m_size, other.m_size);
+        std::swap(m_growthLeft, other.m_growthLeft);
+    }
+
+    unsigned size() const { return m_size; }
+    unsigned capacity() const { return m_capacity; }
+    bool isEmpty() const { return !m_size; }
+
+    iterator begin() { return iterator(m_control, m_control + m_capacity, m_slots); }
+    iterator end() { return iterator(m_control + m_capacity, m_control + m_capacity, m_slots + m_capacity); }
+    const_iterator begin() const { return const_iterator(m_control, m_control + m_capacity, m_slots); }
+    const_iterator end() const { return const_iterator(m_control + m_capacity, m_control + m_capacity, m_slots + m_capacity); }
+
+    template<typename HashTranslator, typename T>
+    ValueType* lookup(const T& key) const
+    {
+        if (!m_size)
+            return 0;
+        unsigned hash = HashTranslator::hash(key);
+        const int8_t tag = tagOf(hash);
+        const unsigned mask = m_capacity - 1;
+        unsigned position = (hash >> 7) & mask;
+        for (unsigned step = FlatHashGroup::width; ; step += FlatHashGroup::width) {
+            FlatHashGroup group(m_control + position);
+            for (FlatHashGroup::Mask matches = group.match(tag); matches; matches = FlatHashGroup::clearLowestSlot(matches)) {
+                unsigned index = (position + FlatHashGroup::lowestSlot(matches)) & mask;
+                if (HashTranslator::equal(Extractor::extract(m_slots[index]), key))
+                    return &m_slots[index];
+            }
+            if (group.matchEmpty())
+                return 0;
+            position = (position + step) & mask;
+        }
+    }
+
+    template<typename HashTranslator, typename T>
+    iterator find(const T& key)
+    {
+        ValueType* slot = lookup<HashTranslator>(key);
+        return slot ? makeIterator(slot) : end();
+    }
+
+    template<typename HashTranslator, typename T>
+    const_iterator find(const T& key) const
+    {
+        ValueType* slot = lookup<HashTranslator>(key);
+        return slot ? makeConstIterator(slot) : end();
+    }
+
+    template<typename HashTranslator, typename T>
+    bool contains(const T& key) const
+    {
+        return lookup<HashTranslator>(key);
+    }
+
+    // Adds an entry with HashTranslator::translate(slot, key, extra) unless
+    // one is already there.
+    template<typename HashTranslator, typename T, typename Extra>
+    AddResult add(const T& key, const Extra& extra)
+    {
+        if (ValueType* slot = lookup<HashTranslator>(key))
+            return AddResult(slot, false);
+        ValueType* slot = insertNew(HashTranslator::hash(key));
+        new (NotNull, slot) ValueType(Traits::emptyValue());
+        HashTranslator::translate(*slot, key, extra);
+        return AddResult(slot, true);
+    }
+
+    void remove(const ValueType* slot)
+    {
+        unsigned index = slot - m_slots;
+        ASSERT(index < m_capacity && m_control[index] >= 0);
+        m_slots[index].~ValueType();
+        --m_size;
+
+        // A probe for another key can only have passed this slot if it was
+        // in a group with no empty slot, in which case it has to stay a
+        // tombstone for that probe to keep going past it.
+        bool probesStopHere = m_capacity == FlatHashGroup::width;
+        if (!probesStopHere) {
+            FlatHashGroup::Mask emptyAfter = FlatHashGroup(m_control + index).matchEmpty();
+            FlatHashGroup::Mask emptyBefore = FlatHashGroup(m_control + ((index - FlatHashGroup::width) & (m_capacity - 1))).matchEmpty();
+            if (emptyAfter && emptyBefore) {
+                unsigned fullAfter = FlatHashGroup::lowestSlot(emptyAfter);
+                unsigned fullBefore = FlatHashGroup::width - 1 - FlatHashGroup::highestSlot(emptyBefore);
+                probesStopHere = fullAfter + fullBefore < FlatHashGroup::width;
+            }
+        }
+        if (probesStopHere) {
+            setControl(index, FlatHashGroup::empty);
+            ++m_growthLeft;
+        } else {
+            setControl(index, FlatHashGroup::deleted);
+        }
+    }
+
+    void remove(const_iterator it)
+    {
+        if (it != end())
+            remove(it.get());
+    }
+
+    void clear()
+    {
+        destroyAll();
+        deallocate();
+        m_control = 0;
+        m_slots = 0;
+        m_capacity = 0;
+        m_size = 0;
+        m_growthLeft = 0;
+    }
+
+    iterator makeIterator(ValueType* slot) { return iterator(m_control + (slot - m_slots), m_control + m_capacity, slot); }
+    const_iterator makeConstIterator(const ValueType* slot) const { return const_iterator(m_control + (slot - m_slots), m_control + m_capacity, slot); }
+
+private:
+    static unsigned hashOf(const KeyType& key) { return HashFunctions::hash(key); }
+    static int8_t tagOf(unsigned hash) { return hash & 0x7F; }
+
+    // Tables are filled to at most seven eighths, so that every probe ends
+    // at an empty slot long before it has visited the whole table.
+    static unsigned maxLoad(unsigned capacity) { return capacity - capacity / 8; }
+
+    static unsigned capacityForSize(unsigned size)
+    {
+        unsigned capacity = FlatHashGroup::width;
+        while (maxLoad(capacity) < size + 1)
+            capacity *= 2;
+        return capacity;
+    }
+
+    static size_t controlOffset(unsigned capacity)
+    {
+        size_t offset = capacity * sizeof(ValueType);
+        return (offset + sizeof(void*) - 1) & ~(sizeof(void*) - 1);
+    }
+
+    // The control bytes follow the slots in the same allocation, and the first
+    // group of them is repeated after the end so that a group can be loaded
+    // at any slot without wrapping around.
+    void allocate(unsigned capacity)
+    {
+        size_t offset = controlOffset(capacity);
+        char* memory = DefaultAllocator::backingMalloc<char*, void>(offset + capacity + FlatHashGroup::width);
+        m_slots = reinterpret_cast<ValueType*>(memory);
+        m_control = reinterpret_cast<int8_t*>(memory + offset);
+        memset(m_control, FlatHashGroup::empty, capacity + FlatHashGroup::width);
+        m_capacity = capacity;
+        m_growthLeft = maxLoad(capacity) - m_size;
+    }
+
+    void deallocate()
+    {
+        if (m_slots)
+            DefaultAllocator::backingFree(m_slots);
+    }
+
+    void destroyAll()
+    {
+        if (!Traits::needsDestruction || !m_size)
+            return;
+        for (unsigned i = 0; i < m_capacity; ++i) {
+            if (m_control[i] >= 0)
+                m_slots[i].~ValueType();
+        }
+    }
+
+    void setControl(unsigned index, int8_t control)
+    {
+        m_control[index] = control;
+        if (index < FlatHashGroup::width)
+            m_control[m_capacity + index] = control;
+    }
+
+    unsigned findInsertIndex(unsigned hash) const
+    {
+        const unsigned mask = m_capacity - 1;
+        unsigned position = (hash >> 7) & mask;
+        for (unsigned step = FlatHashGroup::width; ; step += FlatHashGroup::width) {
+            if (FlatHashGroup::Mask free = FlatHashGroup(m_control + position).matchEmptyOrDeleted())
+                return (position + FlatHashGroup::lowestSlot(free)) & mask;
+            position = (position + step) & mask;
+        }
+    }
+
+    // Claims a slot for a key with |hash| that is not in the table yet,
+    // leaving it for the caller to construct.
+    ValueType* insertNew(unsigned hash)
+    {
+        unsigned index = m_capacity ? findInsertIndex(hash) : 0;
+        if (!m_growthLeft && (!m_capacity || m_control[index] != FlatHashGroup::deleted)) {
+            rehash();
+            index = findInsertIndex(hash);
+        }
+        if (m_control[index] == FlatHashGroup::empty)
+            --m_growthLeft;
+        setControl(index, tagOf(hash));
+        ++m_size;
+        return &m_slots[index];
+    }
+
+    // Grows the table, or only clears out its tombstones if removes have left
+    // it less than half full.
+    void rehash()
+    {
+        int8_t* oldControl = m_control;
+        ValueType* oldSlots = m_slots;
+        unsigned oldCapacity = m_capacity;
+
+        unsigned capacity = oldCapacity && m_size * 2 < maxLoad(oldCapacity) ? oldCapacity : capacityForSize(m_size * 2);
+        allocate(capacity);
+        for (unsigned i = 0; i < oldCapacity; ++i) {
+            if (oldControl[i] < 0)
+                continue;
+            unsigned hash = hashOf(Extractor::extract(oldSlots[i]));
+            unsigned index = findInsertIndex(hash);
+            setControl(index, tagOf(hash));
+            new (NotNull, &m_slots[index]) ValueType(Traits::emptyValue());
+            Mover<ValueType, DefaultAllocator, Traits::needsDestruction>::move(oldSlots[i], m_slots[index]);
+            oldSlots[i].~ValueType();
+        }
+        if (oldSlots)
+            DefaultAllocator::backingFree(oldSlots);
+    }
+
+    int8_t* m_control;
+    ValueType* m_slots;
+    unsigned m_capacity;
+    unsigned m_size;
+    // Empty slots that can still be filled before the table has to grow.
+    unsigned m_growthLeft;
+};
+
+} // namespace WTF
+
+#endif  // SKY_ENGINE_WTF_FLATHASHTABLE_H_
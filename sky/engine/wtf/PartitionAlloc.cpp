@@ -58,6 +58,7 @@ int PartitionRootBase::gInitializedLock = 0;
 bool PartitionRootBase::gInitialized = false;
 PartitionPage PartitionRootBase::gSeedPage;
 PartitionBucket PartitionRootBase::gPagedBucket;
+PartitionAllocHook PartitionRootBase::gAllocationHook = 0;
 
 static size_t partitionBucketNumSystemPages(size_t size)
 {
@@ -113,6 +114,8 @@ static void parititonAllocBaseInit(PartitionRootBase* root)
     root->initialized = true;
     root->totalSizeOfCommittedPages = 0;
     root->totalSizeOfSuperPages = 0;
+    root->totalAllocations = 0;
+    root->totalAllocatedBytes = 0;
     root->nextSuperPage = 0;
     root->nextPartitionPage = 0;
     root->nextPartitionPageEnd = 0;
@@ -298,6 +301,11 @@ bool partitionAllocGenericShutdown(PartitionRootGeneric* root)
     return noLeaks;
 }
 
+void partitionAllocSetHook(PartitionAllocHook hook)
+{
+    PartitionRootBase::gAllocationHook = hook;
+}
+
 static NEVER_INLINE void partitionOutOfMemory()
 {
     IMMEDIATE_CRASH();
@@ -920,62 +928,101 @@ void* partitionReallocGeneric(PartitionRootGeneric* root, void* ptr, size_t newS
 #endif
 }
 
-#ifndef NDEBUG
+static void partitionGetBucketStats(const PartitionBucket& bucket, PartitionBucketMemoryStats* stats)
+{
+    size_t numFreePages = 0;
+    PartitionPage* freePages = bucket.freePagesHead;
+    while (freePages) {
+        ++numFreePages;
+        freePages = freePages->nextPage;
+    }
+    size_t bucketSlotSize = bucket.slotSize;
+    size_t bucketNumSlots = partitionBucketSlots(&bucket);
+    size_t bucketUsefulStorage = bucketSlotSize * bucketNumSlots;
+    size_t bucketPageSize = bucket.numSystemPagesPerSlotSpan * kSystemPageSize;
+    size_t numActiveBytes = bucket.numFullPages * bucketUsefulStorage;
+    size_t numResidentBytes = bucket.numFullPages * bucketPageSize;
+    size_t numFreeableBytes = 0;
+    size_t numActivePages = 0;
+    const PartitionPage* page = bucket.activePagesHead;
+    while (page) {
+        ASSERT(page != &PartitionRootGeneric::gSeedPage);
+        // A page may be on the active list but freed and not yet swept.
+        if (!page->freelistHead && !page->numUnprovisionedSlots && !page->numAllocatedSlots) {
+            ++numFreePages;
+        } else {
+            ++numActivePages;
+            numActiveBytes += (page->numAllocatedSlots * bucketSlotSize);
+            size_t pageBytesResident = (bucketNumSlots - page->numUnprovisionedSlots) * bucketSlotSize;
+            // Round up to system page size.
+            pageBytesResident = (pageBytesResident + kSystemPageOffsetMask) & kSystemPageBaseMask;
+            numResidentBytes += pageBytesResident;
+            if (!page->numAllocatedSlots)
+                numFreeableBytes += pageBytesResident;
+        }
+        page = page->nextPage;
+    }
 
-void partitionDumpStats(const PartitionRoot& root)
+    stats->slotSize = bucketSlotSize;
+    stats->activeBytes = numActiveBytes;
+    stats->residentBytes = numResidentBytes;
+    stats->freeableBytes = numFreeableBytes;
+    stats->numFullPages = bucket.numFullPages;
+    stats->numActivePages = numActivePages;
+    stats->numFreePages = numFreePages;
+}
+
+void partitionDumpBucketStats(const PartitionRoot& root, PartitionStatsDumper* dumper)
 {
-    size_t i;
-    size_t totalLive = 0;
-    size_t totalResident = 0;
-    size_t totalFreeable = 0;
-    for (i = 0; i < root.numBuckets; ++i) {
+    for (size_t i = 0; i < root.numBuckets; ++i) {
         const PartitionBucket& bucket = root.buckets()[i];
         if (bucket.activePagesHead == &PartitionRootGeneric::gSeedPage && !bucket.freePagesHead && !bucket.numFullPages) {
             // Empty bucket with no freelist or full pages. Skip reporting it.
             continue;
         }
-        size_t numFreePages = 0;
-        PartitionPage* freePages = bucket.freePagesHead;
-        while (freePages) {
-            ++numFreePages;
-            freePages = freePages->nextPage;
-        }
-        size_t bucketSlotSize = bucket.slotSize;
-        size_t bucketNumSlots = partitionBucketSlots(&bucket);
-        size_t bucketUsefulStorage = bucketSlotSize * bucketNumSlots;
-        size_t bucketPageSize = bucket.numSystemPagesPerSlotSpan * kSystemPageSize;
-        size_t bucketWaste = bucketPageSize - bucketUsefulStorage;
-        size_t numActiveBytes = bucket.numFullPages * bucketUsefulStorage;
-        size_t numResidentBytes = bucket.numFullPages * bucketPageSize;
-        size_t numFreeableBytes = 0;
-        size_t numActivePages = 0;
-        const PartitionPage* page = bucket.activePagesHead;
-        while (page) {
-            ASSERT(page != &PartitionRootGeneric::gSeedPage);
-            // A page may be on the active list but freed and not yet swept.
-            if (!page->freelistHead && !page->numUnprovisionedSlots && !page->numAllocatedSlots) {
-                ++numFreePages;
-            } else {
-                ++numActivePages;
-                numActiveBytes += (page->numAllocatedSlots * bucketSlotSize);
-                size_t pageBytesResident = (bucketNumSlots - page->numUnprovisionedSlots) * bucketSlotSize;
-                // Round up to system page size.
-                pageBytesResident = (pageBytesResident + kSystemPageOffsetMask) & kSystemPageBaseMask;
-                numResidentBytes += pageBytesResident;
-                if (!page->numAllocatedSlots)
-                    numFreeableBytes += pageBytesResident;
-            }
-            page = page->nextPage;
-        }
-        totalLive += numActiveBytes;
-        totalResident += numResidentBytes;
-        totalFreeable += numFreeableBytes;
-        printf("bucket size %zu (pageSize %zu waste %zu): %zu alloc/%zu commit/%zu freeable bytes, %zu/%zu/%zu full/active/free pages\n", bucketSlotSize, bucketPageSize, bucketWaste, numActiveBytes, numResidentBytes, numFreeableBytes, static_cast<size_t>(bucket.numFullPages), numActivePages, numFreePages);
-    }
-    printf("total live: %zu bytes\n", totalLive);
-    printf("total resident: %zu bytes\n", totalResident);
-    printf("total freeable: %zu bytes\n", totalFreeable);
-    fflush(stdout);
+        PartitionBucketMemoryStats stats;
+        partitionGetBucketStats(bucket, &stats);
+        dumper->partitionDumpBucketStats(stats);
+    }
+}
+
+#ifndef NDEBUG
+
+namespace {
+
+class PrintingStatsDumper final : public PartitionStatsDumper {
+public:
+    PrintingStatsDumper() : m_totalLive(0), m_totalResident(0), m_totalFreeable(0) { }
+
+    void partitionDumpBucketStats(const PartitionBucketMemoryStats& stats) override
+    {
+        m_totalLive += stats.activeBytes;
+        m_totalResident += stats.residentBytes;
+        m_totalFreeable += stats.freeableBytes;
+        printf("bucket size %zu: %zu alloc/%zu commit/%zu freeable bytes, %zu/%zu/%zu full/active/free pages\n", stats.slotSize, stats.activeBytes, stats.residentBytes, stats.freeableBytes, stats.numFullPages, stats.numActivePages, stats.numFreePages);
+    }
+
+    void printTotals()
+    {
+        printf("total live: %zu bytes\n", m_totalLive);
+        printf("total resident: %zu bytes\n", m_totalResident);
+        printf("total freeable: %zu bytes\n", m_totalFreeable);
+        fflush(stdout);
+    }
+
+private:
+    size_t m_totalLive;
+    size_t m_totalResident;
+    size_t m_totalFreeable;
+};
+
+} // namespace
+
+void partitionDumpStats(const PartitionRoot& root)
+{
+    PrintingStatsDumper dumper;
+    partitionDumpBucketStats(root, &dumper);
+    dumper.printTotals();
 }
 
 #endif // !NDEBUG
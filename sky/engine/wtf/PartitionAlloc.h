@@ -253,6 +253,11 @@ struct PartitionSuperPageExtentEntry {
     PartitionSuperPageExtentEntry* next;
 };
 
+// Called with the address and size of every allocation while a profiler has
+// set one. Generic partitions call it with their lock held, so it must not
+// allocate from a partition itself.
+typedef void (*PartitionAllocHook)(void* address, size_t size);
+
 struct WTF_EXPORT PartitionRootBase {
     size_t totalSizeOfCommittedPages;
     size_t totalSizeOfSuperPages;
@@ -267,11 +272,17 @@ struct WTF_EXPORT PartitionRootBase {
     PartitionPage* globalEmptyPageRing[kMaxFreeableSpans];
     size_t globalEmptyPageRingIndex;
     uintptr_t invertedSelf;
+    // Count every allocation and the bytes it asked for, so that callers can
+    // measure how much a piece of work allocates. Only written with the
+    // partition's lock held, if it has one.
+    size_t totalAllocations;
+    size_t totalAllocatedBytes;
 
     static int gInitializedLock;
     static bool gInitialized;
     static PartitionPage gSeedPage;
     static PartitionBucket gPagedBucket;
+    static PartitionAllocHook gAllocationHook;
 };
 
 // Never instantiate a PartitionRoot directly, instead use PartitionAlloc.
@@ -304,11 +315,35 @@ WTF_EXPORT void partitionAllocInit(PartitionRoot*, size_t numBuckets, size_t max
 WTF_EXPORT bool partitionAllocShutdown(PartitionRoot*);
 WTF_EXPORT void partitionAllocGenericInit(PartitionRootGeneric*);
 WTF_EXPORT bool partitionAllocGenericShutdown(PartitionRootGeneric*);
+// Sets the hook every partition calls on allocation, or clears it if null.
+WTF_EXPORT void partitionAllocSetHook(PartitionAllocHook);
 
 WTF_EXPORT NEVER_INLINE void* partitionAllocSlowPath(PartitionRootBase*, int, size_t, PartitionBucket*);
 WTF_EXPORT NEVER_INLINE void partitionFreeSlowPath(PartitionPage*);
 WTF_EXPORT NEVER_INLINE void* partitionReallocGeneric(PartitionRootGeneric*, void*, size_t);
 
+// What one bucket of a partition holds, for memory dumps.
+struct PartitionBucketMemoryStats {
+    size_t slotSize;
+    size_t activeBytes; // Bytes in allocated slots.
+    size_t residentBytes; // Bytes in committed system pages.
+    size_t freeableBytes; // Resident bytes of pages without allocations.
+    size_t numFullPages;
+    size_t numActivePages;
+    size_t numFreePages;
+};
+
+class WTF_EXPORT PartitionStatsDumper {
+public:
+    virtual void partitionDumpBucketStats(const PartitionBucketMemoryStats&) = 0;
+
+protected:
+    virtual ~PartitionStatsDumper() { }
+};
+
+// Reports every bucket that has pages to |dumper|.
+WTF_EXPORT void partitionDumpBucketStats(const PartitionRoot&, PartitionStatsDumper*);
+
 #ifndef NDEBUG
 WTF_EXPORT void partitionDumpStats(const PartitionRoot&);
 #endif
@@ -440,6 +475,8 @@ ALWAYS_INLINE bool partitionPointerIsValid(void* ptr)
 
 ALWAYS_INLINE void* partitionBucketAlloc(PartitionRootBase* root, int flags, size_t size, PartitionBucket* bucket)
 {
+    ++root->totalAllocations;
+    root->totalAllocatedBytes += size;
     PartitionPage* page = bucket->activePagesHead;
     ASSERT(page->numAllocatedSlots >= 0);
     void* ret = page->freelistHead;
@@ -465,6 +502,8 @@ ALWAYS_INLINE void* partitionBucketAlloc(PartitionRootBase* root, int flags, siz
     // The value given to the application is actually just after the cookie.
     ret = static_cast<char*>(ret) + kCookieSize;
 #endif
+    if (UNLIKELY(PartitionRootBase::gAllocationHook != 0) && ret)
+        PartitionRootBase::gAllocationHook(ret, size);
     return ret;
 }
 
@@ -658,8 +697,12 @@ private:
 using WTF::SizeSpecificPartitionAllocator;
 using WTF::PartitionAllocatorGeneric;
 using WTF::PartitionRoot;
+using WTF::PartitionBucketMemoryStats;
+using WTF::PartitionStatsDumper;
+using WTF::partitionDumpBucketStats;
 using WTF::partitionAllocInit;
 using WTF::partitionAllocShutdown;
+using WTF::partitionAllocSetHook;
 using WTF::partitionAlloc;
 using WTF::partitionFree;
 using WTF::partitionAllocGeneric;
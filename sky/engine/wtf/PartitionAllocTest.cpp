@@ -1167,6 +1167,72 @@ TEST(PartitionAllocDeathTest, GuardPages)
 
 #endif // !OS(ANDROID)
 
+// Tests that every allocation is counted, including ones from the slow path
+// and direct mapped ones, and that frees are not.
+TEST(PartitionAllocTest, AllocationCount)
+{
+    TestSetup();
+    EXPECT_EQ(0u, allocator.root()->totalAllocations);
+    EXPECT_EQ(0u, genericAllocator.root()->totalAllocations);
+    EXPECT_EQ(0u, allocator.root()->totalAllocatedBytes);
+
+    void* ptr = partitionAlloc(allocator.root(), kTestAllocSize);
+    partitionFree(ptr);
+    ptr = partitionAlloc(allocator.root(), kTestAllocSize);
+    partitionFree(ptr);
+    EXPECT_EQ(2u, allocator.root()->totalAllocations);
+    EXPECT_EQ(2 * kRealAllocSize, allocator.root()->totalAllocatedBytes);
+
+    ptr = partitionAllocGeneric(genericAllocator.root(), kTestAllocSize);
+    void* directMapped = partitionAllocGeneric(genericAllocator.root(), WTF::kGenericMaxBucketed + 1);
+    partitionFreeGeneric(genericAllocator.root(), directMapped);
+    partitionFreeGeneric(genericAllocator.root(), ptr);
+    EXPECT_EQ(2u, genericAllocator.root()->totalAllocations);
+    EXPECT_EQ(kRealAllocSize + WTF::kGenericMaxBucketed + 1 + kExtraAllocSize, genericAllocator.root()->totalAllocatedBytes);
+
+    TestShutdown();
+}
+
+static void* s_hookAddress;
+static size_t s_hookSize;
+static int s_hookCalls;
+
+static void allocationHook(void* address, size_t size)
+{
+    s_hookAddress = address;
+    s_hookSize = size;
+    ++s_hookCalls;
+}
+
+// Tests that the allocation hook sees every allocation until it is cleared.
+TEST(PartitionAllocTest, AllocationHook)
+{
+    TestSetup();
+    s_hookCalls = 0;
+    partitionAllocSetHook(allocationHook);
+
+    void* ptr = partitionAlloc(allocator.root(), kTestAllocSize);
+    EXPECT_EQ(1, s_hookCalls);
+    EXPECT_EQ(ptr, s_hookAddress);
+    EXPECT_EQ(kRealAllocSize, s_hookSize);
+    partitionFree(ptr);
+
+    ptr = partitionAllocGeneric(genericAllocator.root(), kTestAllocSize);
+    EXPECT_EQ(2, s_hookCalls);
+    EXPECT_EQ(ptr, s_hookAddress);
+    ptr = partitionReallocGeneric(genericAllocator.root(), ptr, kTestAllocSize * 100);
+    EXPECT_EQ(3, s_hookCalls);
+    EXPECT_EQ(ptr, s_hookAddress);
+    partitionFreeGeneric(genericAllocator.root(), ptr);
+
+    partitionAllocSetHook(0);
+    ptr = partitionAlloc(allocator.root(), kTestAllocSize);
+    partitionFree(ptr);
+    EXPECT_EQ(3, s_hookCalls);
+
+    TestShutdown();
+}
+
 // Tests that the countLeadingZeros() functions work to our satisfaction.
 // It doesn't seem worth the overhead of a whole new file for these tests, so
 // we'll put them here since partitionAllocGeneric will depend heavily on these
@@ -53,6 +53,16 @@ public:
             initialize();
         return m_bufferAllocator.root();
     }
+    // The number of allocations made from the buffer partition so far, and
+    // the bytes they asked for.
+    static size_t bufferAllocationCount()
+    {
+        return s_initialized ? m_bufferAllocator.root()->totalAllocations : 0;
+    }
+    static size_t bufferAllocatedBytes()
+    {
+        return s_initialized ? m_bufferAllocator.root()->totalAllocatedBytes : 0;
+    }
 
 private:
     static bool s_initialized;
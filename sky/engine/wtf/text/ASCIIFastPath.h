@@ -98,6 +98,41 @@ inline bool charactersAreAllASCII(const CharacterType* characters, size_t length
     return !(allCharBits & nonASCIIBitMask);
 }
 
+template<size_t size> struct NonLatin1Mask;
+template<> struct NonLatin1Mask<4> {
+    static inline uint32_t value() { return 0xFF00FF00U; }
+};
+template<> struct NonLatin1Mask<8> {
+    static inline uint64_t value() { return 0xFF00FF00FF00FF00ULL; }
+};
+
+// Like charactersAreAllASCII(), this reads a word at a time and does not
+// leave early, since the input is likely to be all Latin-1.
+inline bool charactersAreAllLatin1(const UChar* characters, size_t length)
+{
+    MachineWord allCharBits = 0;
+    const UChar* end = characters + length;
+
+    while (!isAlignedToMachineWord(characters) && characters != end) {
+        allCharBits |= *characters;
+        ++characters;
+    }
+
+    const UChar* wordEnd = alignToMachineWord(end);
+    const size_t loopIncrement = sizeof(MachineWord) / sizeof(UChar);
+    while (characters < wordEnd) {
+        allCharBits |= *(reinterpret_cast_ptr<const MachineWord*>(characters));
+        characters += loopIncrement;
+    }
+
+    while (characters != end) {
+        allCharBits |= *characters;
+        ++characters;
+    }
+
+    return !(allCharBits & NonLatin1Mask<sizeof(MachineWord)>::value());
+}
+
 inline void copyLCharsFromUCharSource(LChar* destination, const UChar* source, size_t length)
 {
 #if COMPILER(GCC) && CPU(ARM_NEON) && !(CPU(BIG_ENDIAN) || CPU(MIDDLE_ENDIAN)) && defined(NDEBUG)
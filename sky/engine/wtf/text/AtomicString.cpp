@@ -22,7 +22,10 @@
 
 #include "sky/engine/wtf/text/AtomicString.h"
 
+#include "sky/engine/wtf/Atomics.h"
+#include "sky/engine/wtf/FastMalloc.h"
 #include "sky/engine/wtf/HashSet.h"
+#include "sky/engine/wtf/SpinLock.h"
 #include "sky/engine/wtf/WTFThreadData.h"
 #include "sky/engine/wtf/dtoa.h"
 #include "sky/engine/wtf/text/IntegerToStringConversion.h"
@@ -94,6 +97,84 @@ private:
     HashSet<StringImpl*> m_table;
 };
 
+// The strings that AtomicString::shared() returns. There is one table for
+// the whole process, which any thread can read without taking a lock. The
+// strings are immortal, so finding one never races with its destruction.
+//
+// The table is split into shards by hash, each an open-addressed array that
+// only ever grows. Writers take the shard's lock and publish each entry, or
+// a whole new array, with a release store. Arrays that have been replaced
+// are never freed, since a reader may still be probing them, which costs at
+// most as much again as the live arrays.
+class SharedAtomicStringTable {
+public:
+    static bool isEmpty() { return !acquireLoad(&s_size); }
+
+    template<typename T, typename HashTranslator>
+    static StringImpl* find(const T& value)
+    {
+        unsigned hash = HashTranslator::hash(value);
+        Buckets* buckets = static_cast<Buckets*>(acquireLoad(&shardFor(hash).buckets));
+        if (!buckets)
+            return 0;
+        unsigned mask = buckets->capacity - 1;
+        for (unsigned i = probeStart(hash) & mask; ; i = (i + 1) & mask) {
+            StringImpl* string = static_cast<StringImpl*>(acquireLoad(&buckets->strings[i]));
+            if (!string)
+                return 0;
+            if (string->existingHash() == hash && HashTranslator::equal(string, value))
+                return string;
+        }
+    }
+
+    // |localCopy| is the calling thread's atomic copy of |string|, if it has
+    // one, and becomes the shared string unless another thread shared the
+    // name first.
+    static StringImpl* add(StringImpl* string, StringImpl* localCopy);
+
+private:
+    struct Buckets {
+        unsigned capacity;
+        void* volatile strings[1];
+    };
+
+    struct Shard {
+        int lock;
+        unsigned size;
+        void* volatile buckets;
+    };
+
+    static const unsigned shardCount = 16;
+    static const unsigned minCapacity = 64;
+
+    static Shard& shardFor(unsigned hash) { return s_shards[hash & (shardCount - 1)]; }
+    static unsigned probeStart(unsigned hash) { return hash / shardCount; }
+
+    static Buckets* createBuckets(unsigned capacity)
+    {
+        size_t size = sizeof(Buckets) + (capacity - 1) * sizeof(void*);
+        Buckets* buckets = static_cast<Buckets*>(fastZeroedMalloc(size));
+        buckets->capacity = capacity;
+        return buckets;
+    }
+
+    static void insert(Buckets* buckets, StringImpl* string)
+    {
+        unsigned mask = buckets->capacity - 1;
+        unsigned i = probeStart(string->existingHash()) & mask;
+        while (buckets->strings[i])
+            i = (i + 1) & mask;
+        releaseStore(&buckets->strings[i], string);
+    }
+
+    // Zero-initialized, so the table works before any constructor runs.
+    static Shard s_shards[shardCount];
+    static volatile unsigned s_size;
+};
+
+SharedAtomicStringTable::Shard SharedAtomicStringTable::s_shards[SharedAtomicStringTable::shardCount];
+volatile unsigned SharedAtomicStringTable::s_size;
+
 static inline AtomicStringTable& atomicStringTable()
 {
     // Once possible we should make this non-lazy (constructed in WTFThreadData's constructor).
@@ -112,6 +193,16 @@ static inline HashSet<StringImpl*>& atomicStrings()
 template<typename T, typename HashTranslator>
 static inline PassRefPtr<StringImpl> addToStringTable(const T& value)
 {
+    if (UNLIKELY(!SharedAtomicStringTable::isEmpty())) {
+        // A copy the thread made before the name was shared wins, so that
+        // the thread's atomic strings stay unique.
+        HashSet<StringImpl*>::iterator iterator = atomicStrings().find<HashTranslator>(value);
+        if (iterator != atomicStrings().end())
+            return *iterator;
+        if (StringImpl* shared = SharedAtomicStringTable::find<T, HashTranslator>(value))
+            return shared;
+    }
+
     HashSet<StringImpl*>::AddResult addResult = atomicStrings().add<HashTranslator>(value);
 
     // If the string is newly-translated, then we need to adopt it.
@@ -402,16 +493,86 @@ PassRefPtr<StringImpl> AtomicString::addFromLiteralData(const char* characters,
     return addToStringTable<CharBuffer, CharBufferFromLiteralDataTranslator>(buffer);
 }
 
+template<typename CharacterType>
+static inline HashSet<StringImpl*>::iterator findString(const StringImpl* stringImpl)
+{
+    HashAndCharacters<CharacterType> buffer = { stringImpl->existingHash(), stringImpl->getCharacters<CharacterType>(), stringImpl->length() };
+    return atomicStrings().find<HashAndCharactersTranslator<CharacterType> >(buffer);
+}
+
+template<typename CharacterType>
+static inline StringImpl* findShared(const StringImpl* stringImpl)
+{
+    HashAndCharacters<CharacterType> buffer = { stringImpl->hash(), stringImpl->getCharacters<CharacterType>(), stringImpl->length() };
+    return SharedAtomicStringTable::find<HashAndCharacters<CharacterType>, HashAndCharactersTranslator<CharacterType> >(buffer);
+}
+
+StringImpl* SharedAtomicStringTable::add(StringImpl* string, StringImpl* localCopy)
+{
+    ASSERT(string->length());
+    ASSERT(!localCopy || localCopy->isAtomic());
+    Shard& shard = shardFor(string->hash());
+    spinLockLock(&shard.lock);
+
+    StringImpl* result = string->is8Bit() ? findShared<LChar>(string) : findShared<UChar>(string);
+    if (!result) {
+        Buckets* buckets = static_cast<Buckets*>(shard.buckets);
+        if (!buckets || (shard.size + 1) * 2 > buckets->capacity) {
+            Buckets* grown = createBuckets(buckets ? buckets->capacity * 2 : minCapacity);
+            for (unsigned i = 0; buckets && i < buckets->capacity; ++i) {
+                if (buckets->strings[i])
+                    insert(grown, static_cast<StringImpl*>(buckets->strings[i]));
+            }
+            releaseStore(&shard.buckets, grown);
+            buckets = grown;
+        }
+
+        if (localCopy) {
+            localCopy->makeImmortal();
+            result = localCopy;
+        } else {
+            result = StringImpl::createImmortal(*string);
+        }
+        insert(buckets, result);
+        ++shard.size;
+        atomicIncrement(reinterpret_cast<volatile int*>(&s_size));
+    }
+
+    spinLockUnlock(&shard.lock);
+    return result;
+}
+
 PassRefPtr<StringImpl> AtomicString::addSlowCase(StringImpl* string)
 {
+    if (UNLIKELY(!SharedAtomicStringTable::isEmpty()) && string->length() && !atomicStrings().contains(string)) {
+        StringImpl* shared = string->is8Bit() ? findShared<LChar>(string) : findShared<UChar>(string);
+        if (shared)
+            return shared;
+    }
     return atomicStringTable().addStringImpl(string);
 }
 
-template<typename CharacterType>
-static inline HashSet<StringImpl*>::iterator findString(const StringImpl* stringImpl)
+AtomicString AtomicString::shared(const String& string)
 {
-    HashAndCharacters<CharacterType> buffer = { stringImpl->existingHash(), stringImpl->getCharacters<CharacterType>(), stringImpl->length() };
-    return atomicStrings().find<HashAndCharactersTranslator<CharacterType> >(buffer);
+    StringImpl* impl = string.impl();
+    if (!impl)
+        return nullAtom;
+    if (!impl->length())
+        return emptyAtom;
+    if (impl->isStatic() && impl->isAtomic())
+        return AtomicString(impl);
+
+    StringImpl* shared = impl->is8Bit() ? findShared<LChar>(impl) : findShared<UChar>(impl);
+    if (shared)
+        return AtomicString(shared);
+
+    StringImpl* localCopy = impl->isAtomic() ? impl : 0;
+    if (!localCopy) {
+        HashSet<StringImpl*>::iterator iterator = impl->is8Bit() ? findString<LChar>(impl) : findString<UChar>(impl);
+        if (iterator != atomicStrings().end())
+            localCopy = *iterator;
+    }
+    return AtomicString(SharedAtomicStringTable::add(impl, localCopy));
 }
 
 StringImpl* AtomicString::find(const StringImpl* stringImpl)
@@ -427,9 +588,11 @@ StringImpl* AtomicString::find(const StringImpl* stringImpl)
         iterator = findString<LChar>(stringImpl);
     else
         iterator = findString<UChar>(stringImpl);
-    if (iterator == atomicStrings().end())
-        return 0;
-    return *iterator;
+    if (iterator != atomicStrings().end())
+        return *iterator;
+    if (UNLIKELY(!SharedAtomicStringTable::isEmpty()))
+        return stringImpl->is8Bit() ? findShared<LChar>(stringImpl) : findShared<UChar>(stringImpl);
+    return 0;
 }
 
 void AtomicString::remove(StringImpl* r)
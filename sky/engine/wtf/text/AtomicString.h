@@ -75,6 +75,14 @@ public:
 
     static StringImpl* find(const StringImpl*);
 
+    // Returns the atomic string for |string| that every thread shares, such
+    // as a font family name that text layout on a worker needs. Shared
+    // strings are never freed, and once a name is shared every thread that
+    // atomizes it gets the shared string. A thread that atomized the name
+    // before it was shared keeps its own copy, unless it is the thread that
+    // shares it.
+    static AtomicString shared(const String&);
+
     operator const String&() const { return m_string; }
     const String& string() const { return m_string; };
 
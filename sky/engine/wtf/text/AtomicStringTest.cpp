@@ -76,4 +76,24 @@ TEST(AtomicStringTest, ImplEquality)
     ASSERT_NE(bar.impl(), baz.impl());
 }
 
+TEST(AtomicStringTest, Shared)
+{
+    AtomicString shared = AtomicString::shared(String("sharedTestName"));
+    ASSERT_TRUE(shared.impl()->isStatic());
+    ASSERT_EQ(shared.impl(), AtomicString("sharedTestName").impl());
+    ASSERT_EQ(shared.impl(), AtomicString::shared(String("sharedTestName")).impl());
+
+    const UChar characters[] = { 's', 'h', 'a', 'r', 'e', 'd', 'T', 'e', 's', 't', 'N', 'a', 'm', 'e' };
+    ASSERT_EQ(shared.impl(), AtomicString(characters, WTF_ARRAY_LENGTH(characters)).impl());
+    ASSERT_EQ(shared.impl(), AtomicString::find(String("sharedTestName").impl()));
+}
+
+TEST(AtomicStringTest, SharedKeepsLocalCopy)
+{
+    AtomicString local("localTestName");
+    AtomicString shared = AtomicString::shared(String("localTestName"));
+    ASSERT_EQ(local.impl(), shared.impl());
+    ASSERT_TRUE(local.impl()->isStatic());
+}
+
 } // namespace
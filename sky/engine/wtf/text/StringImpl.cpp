@@ -34,6 +34,7 @@
 #include "sky/engine/wtf/PassOwnPtr.h"
 #include "sky/engine/wtf/StdLibExtras.h"
 #include "sky/engine/wtf/WTF.h"
+#include "sky/engine/wtf/text/ASCIIFastPath.h"
 #include "sky/engine/wtf/text/AtomicString.h"
 #include "sky/engine/wtf/text/StringBuffer.h"
 #include "sky/engine/wtf/text/StringHash.h"
@@ -397,6 +398,24 @@ StringImpl* StringImpl::createStatic(const char* string, unsigned length, unsign
     return impl;
 }
 
+StringImpl* StringImpl::createImmortal(const StringImpl& string)
+{
+    unsigned length = string.length();
+    ASSERT(length);
+    size_t characterSize = string.is8Bit() ? sizeof(LChar) : sizeof(UChar);
+    RELEASE_ASSERT(length <= ((std::numeric_limits<unsigned>::max() - sizeof(StringImpl)) / characterSize));
+    size_t size = sizeof(StringImpl) + length * characterSize;
+
+    WTF_ANNOTATE_SCOPED_MEMORY_LEAK;
+    StringImpl* impl = static_cast<StringImpl*>(partitionAllocGeneric(Partitions::getBufferPartition(), size));
+    const void* characters = string.is8Bit() ? static_cast<const void*>(string.characters8()) : static_cast<const void*>(string.characters16());
+    memcpy(impl + 1, characters, length * characterSize);
+    impl = new (impl) StringImpl(length, string.hash(), string.is8Bit(), ImmortalString);
+    WTF_ANNOTATE_BENIGN_RACE(impl,
+        "Benign race on the reference counter of an immortal string created by StringImpl::createImmortal");
+    return impl;
+}
+
 PassRefPtr<StringImpl> StringImpl::create(const UChar* characters, unsigned length)
 {
     if (!characters || !length)
@@ -424,15 +443,14 @@ PassRefPtr<StringImpl> StringImpl::create8BitIfPossible(const UChar* characters,
     if (!characters || !length)
         return empty();
 
+    // Scanning first avoids allocating a narrow string that is then thrown
+    // away, and lets the copy use the vectorized narrowing loop.
+    if (!charactersAreAllLatin1(characters, length))
+        return create(characters, length);
+
     LChar* data;
     RefPtr<StringImpl> string = createUninitialized(length, data);
-
-    for (size_t i = 0; i < length; ++i) {
-        if (characters[i] & 0xff00)
-            return create(characters, length);
-        data[i] = static_cast<LChar>(characters[i]);
-    }
-
+    copyLCharsFromUCharSource(data, characters, length);
     return string.release();
 }
 
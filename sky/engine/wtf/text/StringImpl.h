@@ -40,6 +40,7 @@ template<typename CharacterType> struct HashAndCharactersTranslator;
 struct HashAndUTF8CharactersTranslator;
 struct LCharBufferTranslator;
 struct CharBufferFromLiteralDataTranslator;
+class SharedAtomicStringTable;
 struct SubstringTranslator;
 struct UCharBufferTranslator;
 
@@ -106,6 +107,7 @@ class WTF_EXPORT StringImpl {
     friend struct WTF::LCharBufferTranslator;
     friend struct WTF::SubstringTranslator;
     friend struct WTF::UCharBufferTranslator;
+    friend class WTF::SharedAtomicStringTable;
 
 private:
     // StringImpls are allocated out of the WTF buffer partition.
@@ -169,6 +171,24 @@ private:
     {
     }
 
+    // Immortal strings are never destroyed either, but unlike static strings
+    // they can be created on any thread at any time. They are the entries of
+    // the table behind AtomicString::shared().
+    enum ImmortalStringTag { ImmortalString };
+    StringImpl(unsigned length, unsigned hash, bool is8Bit, ImmortalStringTag)
+        : m_refCount(1)
+        , m_length(length)
+        , m_hash(hash)
+        , m_isAtomic(true)
+        , m_is8Bit(is8Bit)
+        , m_isStatic(true)
+    {
+    }
+
+    static StringImpl* createImmortal(const StringImpl&);
+    // Only for atomic strings that no other thread has seen yet.
+    void makeImmortal() { m_isStatic = true; }
+
 public:
     ~StringImpl();
 
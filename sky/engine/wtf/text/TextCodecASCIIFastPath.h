@@ -29,6 +29,14 @@
 
 #include "sky/engine/wtf/text/ASCIIFastPath.h"
 
+#if CPU(X86_64) || (CPU(X86) && defined(__SSE2__))
+#define ASCII_FAST_PATH_USE_SSE2
+#include <emmintrin.h>
+#elif HAVE(ARM_NEON_INTRINSICS) || CPU(ARM64)
+#define ASCII_FAST_PATH_USE_NEON
+#include <arm_neon.h>
+#endif
+
 namespace WTF {
 
 template<size_t size> struct UCharByteFiller;
@@ -75,6 +83,94 @@ inline void copyASCIIMachineWord(UChar* destination, const uint8_t* source)
     UCharByteFiller<sizeof(WTF::MachineWord)>::copy(destination, source);
 }
 
+// These copy the ASCII characters at the start of |source| sixteen at a
+// time, and return how many they copied. They stop at the first block of
+// sixteen that is not all ASCII, or that runs past |length|, and leave the
+// rest to the callers' word and character loops. Without SIMD they copy
+// nothing.
+const size_t asciiBlockSize = 16;
+
+inline size_t copyASCIIBlocks(LChar* destination, const uint8_t* source, size_t length)
+{
+    size_t copied = 0;
+#if defined(ASCII_FAST_PATH_USE_SSE2)
+    for (; copied + asciiBlockSize <= length; copied += asciiBlockSize) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + copied));
+        if (_mm_movemask_epi8(block))
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + copied), block);
+    }
+#elif defined(ASCII_FAST_PATH_USE_NEON)
+    for (; copied + asciiBlockSize <= length; copied += asciiBlockSize) {
+        uint8x16_t block = vld1q_u8(source + copied);
+        uint8x8_t highBits = vorr_u8(vget_low_u8(block), vget_high_u8(block));
+        if (vget_lane_u64(vreinterpret_u64_u8(highBits), 0) & 0x8080808080808080ULL)
+            break;
+        vst1q_u8(destination + copied, block);
+    }
+#endif
+    return copied;
+}
+
+inline size_t copyASCIIBlocks(UChar* destination, const uint8_t* source, size_t length)
+{
+    size_t copied = 0;
+#if defined(ASCII_FAST_PATH_USE_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    for (; copied + asciiBlockSize <= length; copied += asciiBlockSize) {
+        __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + copied));
+        if (_mm_movemask_epi8(block))
+            break;
+        __m128i* output = reinterpret_cast<__m128i*>(destination + copied);
+        _mm_storeu_si128(output, _mm_unpacklo_epi8(block, zero));
+        _mm_storeu_si128(output + 1, _mm_unpackhi_epi8(block, zero));
+    }
+#elif defined(ASCII_FAST_PATH_USE_NEON)
+    for (; copied + asciiBlockSize <= length; copied += asciiBlockSize) {
+        uint8x16_t block = vld1q_u8(source + copied);
+        uint8x8_t highBits = vorr_u8(vget_low_u8(block), vget_high_u8(block));
+        if (vget_lane_u64(vreinterpret_u64_u8(highBits), 0) & 0x8080808080808080ULL)
+            break;
+        uint16_t* output = reinterpret_cast<uint16_t*>(destination + copied);
+        vst1q_u16(output, vmovl_u8(vget_low_u8(block)));
+        vst1q_u16(output + 8, vmovl_u8(vget_high_u8(block)));
+    }
+#endif
+    return copied;
+}
+
+// Narrows UTF-16 that is ASCII to the bytes UTF-8 encodes it as.
+inline size_t copyASCIIBlocks(LChar* destination, const UChar* source, size_t length)
+{
+    size_t copied = 0;
+#if defined(ASCII_FAST_PATH_USE_SSE2)
+    const __m128i nonASCIIMask = _mm_set1_epi16(static_cast<short>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    for (; copied + asciiBlockSize <= length; copied += asciiBlockSize) {
+        const __m128i* input = reinterpret_cast<const __m128i*>(source + copied);
+        __m128i low = _mm_loadu_si128(input);
+        __m128i high = _mm_loadu_si128(input + 1);
+        __m128i nonASCII = _mm_and_si128(_mm_or_si128(low, high), nonASCIIMask);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(nonASCII, zero)) != 0xFFFF)
+            break;
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(destination + copied), _mm_packus_epi16(low, high));
+    }
+#elif defined(ASCII_FAST_PATH_USE_NEON)
+    const uint16x8_t nonASCIIMask = vdupq_n_u16(0xFF80);
+    for (; copied + asciiBlockSize <= length; copied += asciiBlockSize) {
+        const uint16_t* input = reinterpret_cast<const uint16_t*>(source + copied);
+        uint16x8_t low = vld1q_u16(input);
+        uint16x8_t high = vld1q_u16(input + 8);
+        uint16x8_t nonASCII = vandq_u16(vorrq_u16(low, high), nonASCIIMask);
+        uint16x4_t folded = vorr_u16(vget_low_u16(nonASCII), vget_high_u16(nonASCII));
+        if (vget_lane_u64(vreinterpret_u64_u16(folded), 0))
+            break;
+        vst1q_u8(destination + copied, vcombine_u8(vmovn_u16(low), vmovn_u16(high)));
+    }
+#endif
+    return copied;
+}
+
 } // namespace WTF
 
 #endif  // SKY_ENGINE_WTF_TEXT_TEXTCODECASCIIFASTPATH_H_
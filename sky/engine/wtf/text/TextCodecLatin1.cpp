@@ -132,6 +132,13 @@ String TextCodecLatin1::decode(const char* bytes, size_t length, FlushBehavior,
     while (source < end) {
         if (isASCII(*source)) {
             // Fast path for ASCII. Most Latin-1 text will be ASCII.
+            size_t copied = copyASCIIBlocks(destination, source, end - source);
+            source += copied;
+            destination += copied;
+            if (source == end)
+                break;
+            if (!isASCII(*source))
+                goto useLookupTable;
             if (isAlignedToMachineWord(source)) {
                 while (source < alignedEnd) {
                     MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
@@ -183,6 +190,13 @@ upConvertTo16Bit:
     while (source < end) {
         if (isASCII(*source)) {
             // Fast path for ASCII. Most Latin-1 text will be ASCII.
+            size_t copied = copyASCIIBlocks(destination16, source, end - source);
+            source += copied;
+            destination16 += copied;
+            if (source == end)
+                break;
+            if (!isASCII(*source))
+                goto useLookupTable16;
             if (isAlignedToMachineWord(source)) {
                 while (source < alignedEnd) {
                     MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
@@ -296,6 +296,13 @@ String TextCodecUTF8::decode(const char* bytes, size_t length, FlushBehavior flu
         while (source < end) {
             if (isASCII(*source)) {
                 // Fast path for ASCII. Most UTF-8 text will be ASCII.
+                size_t copied = copyASCIIBlocks(destination, source, end - source);
+                source += copied;
+                destination += copied;
+                if (source == end)
+                    break;
+                if (!isASCII(*source))
+                    continue;
                 if (isAlignedToMachineWord(source)) {
                     while (source < alignedEnd) {
                         MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
@@ -373,6 +380,13 @@ upConvertTo16Bit:
         while (source < end) {
             if (isASCII(*source)) {
                 // Fast path for ASCII. Most UTF-8 text will be ASCII.
+                size_t copied = copyASCIIBlocks(destination16, source, end - source);
+                source += copied;
+                destination16 += copied;
+                if (source == end)
+                    break;
+                if (!isASCII(*source))
+                    continue;
                 if (isAlignedToMachineWord(source)) {
                     while (source < alignedEnd) {
                         MachineWord chunk = *reinterpret_cast_ptr<const MachineWord*>(source);
@@ -437,6 +451,13 @@ CString TextCodecUTF8::encodeCommon(const CharType* characters, size_t length)
     size_t i = 0;
     size_t bytesWritten = 0;
     while (i < length) {
+        if (isASCII(characters[i])) {
+            size_t copied = copyASCIIBlocks(bytes.data() + bytesWritten, characters + i, length - i);
+            i += copied;
+            bytesWritten += copied;
+            if (i == length)
+                break;
+        }
         UChar32 character;
         U16_NEXT(characters, i, length, character);
         // U16_NEXT will simply emit a surrogate code point if an unmatched surrogate
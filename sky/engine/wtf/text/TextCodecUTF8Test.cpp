@@ -88,6 +88,42 @@ TEST(TextCodecUTF8, Decode0xFF)
     EXPECT_EQ(0xFFFDU, result[0]);
 }
 
+// Long enough for the SIMD blocks, with the non-ASCII character past the
+// first of them.
+TEST(TextCodecUTF8, DecodeLongAsciiThenChinese)
+{
+    TextEncoding encoding("UTF-8");
+    OwnPtr<TextCodec> codec(newTextCodec(encoding));
+
+    const char testCase[] = "The quick brown fox jumps over \xe6\xbc\xa2 the lazy dog";
+    size_t testCaseSize = sizeof(testCase) - 1;
+
+    bool sawError = false;
+    const String& result = codec->decode(testCase, testCaseSize, DataEOF, false, sawError);
+    EXPECT_FALSE(sawError);
+    ASSERT_EQ(testCaseSize - 2, result.length());
+    EXPECT_FALSE(result.is8Bit());
+    EXPECT_EQ('T', result[0]);
+    EXPECT_EQ(' ', result[30]);
+    EXPECT_EQ(0x6f22U, result[31]);
+    EXPECT_EQ('g', result[result.length() - 1]);
+}
+
+TEST(TextCodecUTF8, EncodeLongAscii)
+{
+    TextEncoding encoding("UTF-8");
+    OwnPtr<TextCodec> codec(newTextCodec(encoding));
+
+    String source("The quick brown fox jumps over the lazy dog");
+    source.ensure16Bit();
+    CString result = codec->encode(source.characters16(), source.length(), QuestionMarksForUnencodables);
+    EXPECT_STREQ("The quick brown fox jumps over the lazy dog", result.data());
+
+    const UChar mixed[] = { 'a', 'b', 'c', 'd', 'e', 'f', 'g', 'h', 'i', 'j', 'k', 'l', 'm', 'n', 'o', 'p', 0xe9, 'q', 'r', 's' };
+    result = codec->encode(mixed, WTF_ARRAY_LENGTH(mixed), QuestionMarksForUnencodables);
+    EXPECT_STREQ("abcdefghijklmnop\xc3\xa9qrs", result.data());
+}
+
 } // namespace
 
 } // namespace WTF
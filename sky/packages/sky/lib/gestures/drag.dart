@@ -3,6 +3,7 @@
 // found in the LICENSE file.
 
 import 'dart:sky' as sky;
+import 'dart:typed_data';
 
 import 'package:sky/gestures/arena.dart';
 import 'package:sky/gestures/recognizer.dart';
@@ -24,7 +25,10 @@ typedef void GesturePanEndCallback(sky.Offset velocity);
 
 typedef void _GesturePolymorphicUpdateCallback<T>(T scrollDelta);
 
-int _eventTime(sky.PointerEvent event) => (event.timeStamp * 1000.0).toInt(); // microseconds
+// Positions are handed to the velocity tracker in batches, so that a drag
+// costs one native call per batch rather than one per move.
+const int _kPositionBatchSize = 16;
+const int _kPositionFieldCount = 4; // time stamp, pointer, x, y
 
 bool _isFlingGesture(sky.GestureVelocity velocity) {
   double velocitySquared = velocity.x * velocity.x + velocity.y * velocity.y;
@@ -49,6 +53,33 @@ abstract class _DragGestureRecognizer<T extends dynamic> extends GestureRecogniz
   bool get _hasSufficientPendingDragDeltaToAccept;
 
   final sky.VelocityTracker _velocityTracker = new sky.VelocityTracker();
+  final Float64List _positions = new Float64List(_kPositionBatchSize * _kPositionFieldCount);
+  int _positionCount = 0;
+
+  void _addPosition(sky.PointerEvent event) {
+    int index = _positionCount * _kPositionFieldCount;
+    _positions[index] = event.timeStamp;
+    _positions[index + 1] = event.pointer.toDouble();
+    _positions[index + 2] = event.x;
+    _positions[index + 3] = event.y;
+    if (++_positionCount == _kPositionBatchSize)
+      _flushPositions();
+  }
+
+  void _flushPositions() {
+    if (_positionCount == 0)
+      return;
+    if (_positionCount == _kPositionBatchSize)
+      _velocityTracker.addPositions(_positions);
+    else
+      _velocityTracker.addPositions(new Float64List.view(_positions.buffer, 0, _positionCount * _kPositionFieldCount));
+    _positionCount = 0;
+  }
+
+  void _resetVelocityTracker() {
+    _positionCount = 0;
+    _velocityTracker.reset();
+  }
 
   void addPointer(sky.PointerEvent event) {
     startTrackingPointer(event.pointer);
@@ -61,7 +92,7 @@ abstract class _DragGestureRecognizer<T extends dynamic> extends GestureRecogniz
   void handleEvent(sky.PointerEvent event) {
     assert(_state != DragState.ready);
     if (event.type == 'pointermove') {
-      _velocityTracker.addPosition(_eventTime(event), event.pointer, event.x, event.y);
+      _addPosition(event);
       T delta = _getDragDelta(event);
       if (_state == DragState.accepted) {
         if (onUpdate != null)
@@ -96,6 +127,7 @@ abstract class _DragGestureRecognizer<T extends dynamic> extends GestureRecogniz
     bool wasAccepted = (_state == DragState.accepted);
     _state = DragState.ready;
     if (wasAccepted && onEnd != null) {
+      _flushPositions();
       sky.GestureVelocity gestureVelocity = _velocityTracker.getVelocity(pointer);
       sky.Offset velocity = sky.Offset.zero;
       if (_isFlingGesture(gestureVelocity))
@@ -103,11 +135,11 @@ abstract class _DragGestureRecognizer<T extends dynamic> extends GestureRecogniz
       resolve(GestureDisposition.accepted);
       onEnd(velocity);
     }
-    _velocityTracker.reset();
+    _resetVelocityTracker();
   }
 
   void dispose() {
-    _velocityTracker.reset();
+    _resetVelocityTracker();
     super.dispose();
   }
 }
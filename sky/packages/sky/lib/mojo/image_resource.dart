@@ -44,6 +44,10 @@ class ImageResource {
   }
 
   void _handleImageLoaded(sky.Image image) {
+    // Start the GPU upload while the first frame showing the image is still
+    // being built.
+    if (image != null)
+      sky.view.uploadImage(image);
     _image = image;
     _resolved = true;
     _notifyListeners();
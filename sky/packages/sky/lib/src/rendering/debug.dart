@@ -41,6 +41,15 @@ sky.Color debugPaintLayerBordersColor = const sky.Color(0xFFFF9800);
 /// Causes RenderObjects to paint warnings when painting outside their bounds.
 bool debugPaintBoundsEnabled = false;
 
+/// Causes the compositor to tint each pixel by how many times it was drawn.
+bool debugCompositorOverdrawEnabled = false;
+
+/// Causes the compositor to outline each picture and shadow it paints.
+bool debugCompositorLayerBoundsEnabled = false;
+
+/// Causes the compositor to tint each picture by how long it took to paint.
+bool debugCompositorRasterTimeEnabled = false;
+
 /// The color to use when painting RenderError boxes in checked mode.
 sky.Color debugErrorBoxColor = const sky.Color(0xFFFF0000);
 
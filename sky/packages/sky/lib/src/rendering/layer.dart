@@ -87,6 +87,26 @@ class PictureLayer extends Layer {
 
 }
 
+/// A composited layer that shows the frames of an external texture
+///
+/// The frames of the texture, such as those of a video, are drawn by the
+/// compositor as they arrive, without the layer tree being rebuilt.
+class TextureLayer extends Layer {
+  TextureLayer({ Offset offset: Offset.zero, this.textureId, this.size })
+    : super(offset: offset);
+
+  /// The id of the texture, as returned by the service producing its frames
+  int textureId;
+
+  /// The size the frames are scaled to in this layer's coordinate system
+  Size size;
+
+  void addToScene(sky.SceneBuilder builder, Offset layerOffset) {
+    builder.addTexture(offset + layerOffset, textureId, size);
+  }
+
+}
+
 /// A composited layer that has a list of children
 class ContainerLayer extends Layer {
   ContainerLayer({ Offset offset: Offset.zero }) : super(offset: offset);
@@ -201,7 +221,7 @@ class ClipRectLayer extends ContainerLayer {
 
 /// A composite layer that clips its children using a rounded rectangle
 class ClipRRectLayer extends ContainerLayer {
-  ClipRRectLayer({ Offset offset: Offset.zero, this.bounds, this.clipRRect }) : super(offset: offset);
+  ClipRRectLayer({ Offset offset: Offset.zero, this.bounds, this.clipRRect, this.antiAlias: true }) : super(offset: offset);
 
   /// Unused
   Rect bounds;
@@ -212,8 +232,13 @@ class ClipRRectLayer extends ContainerLayer {
   // TODO(abarth): Why is the rounded-rect in the parent's coordinate system
   // instead of in the coordinate system of this layer?
 
+  /// Whether the edges of the clip are anti-aliased
+  ///
+  /// Clips without anti-aliasing are cheaper for the compositor to apply.
+  bool antiAlias;
+
   void addToScene(sky.SceneBuilder builder, Offset layerOffset) {
-    builder.pushClipRRect(clipRRect.shift(layerOffset), bounds.shift(layerOffset));
+    builder.pushClipRRect(clipRRect.shift(layerOffset), bounds.shift(layerOffset), antiAlias);
     addChildrenToScene(builder, offset + layerOffset);
     builder.pop();
   }
@@ -222,7 +247,7 @@ class ClipRRectLayer extends ContainerLayer {
 
 /// A composite layer that clips its children using a path
 class ClipPathLayer extends ContainerLayer {
-  ClipPathLayer({ Offset offset: Offset.zero, this.bounds, this.clipPath }) : super(offset: offset);
+  ClipPathLayer({ Offset offset: Offset.zero, this.bounds, this.clipPath, this.antiAlias: true }) : super(offset: offset);
 
   /// Unused
   Rect bounds;
@@ -233,14 +258,66 @@ class ClipPathLayer extends ContainerLayer {
   // TODO(abarth): Why is the path in the parent's coordinate system instead of
   // in the coordinate system of this layer?
 
+  /// Whether the edges of the clip are anti-aliased
+  ///
+  /// Clips without anti-aliasing are cheaper for the compositor to apply.
+  bool antiAlias;
+
   void addToScene(sky.SceneBuilder builder, Offset layerOffset) {
-    builder.pushClipPath(clipPath.shift(layerOffset), bounds.shift(layerOffset));
+    builder.pushClipPath(clipPath.shift(layerOffset), bounds.shift(layerOffset), antiAlias);
     addChildrenToScene(builder, offset + layerOffset);
     builder.pop();
   }
 
 }
 
+/// A composited layer that the compositor scrolls by itself
+///
+/// The children are shown through [viewport], with their origin
+/// [scrollOffset] above and left of the viewport's top left corner. While the
+/// viewport is dragged or flung, the compositor moves the offset without a
+/// new frame for every step, and schedules a frame when the viewport gets
+/// close to the end of [contentSize], so that more content can be added.
+class ScrollLayer extends ContainerLayer {
+  ScrollLayer({
+    Offset offset: Offset.zero,
+    this.scrollId,
+    this.scrollOffset: Offset.zero,
+    this.viewport,
+    this.contentSize
+  }) : super(offset: offset);
+
+  /// Identifies the layer from frame to frame
+  int scrollId;
+
+  /// How far the children are scrolled
+  ///
+  /// Start from [compositorScrollOffset] to keep the compositor's scrolling.
+  Offset scrollOffset;
+
+  /// The rectangle the children are shown through, in the parent's
+  /// coordinate system
+  Rect viewport;
+
+  /// The size of the children, past which the layer does not scroll
+  Size contentSize;
+
+  /// Where the compositor scrolled the layer with [scrollId] to, or null if
+  /// it has not drawn such a layer
+  static Offset compositorScrollOffset(int scrollId) {
+    List<double> offset = sky.view.getScrollOffset(scrollId);
+    if (offset.isEmpty)
+      return null;
+    return new Offset(offset[0], offset[1]);
+  }
+
+  void addToScene(sky.SceneBuilder builder, Offset layerOffset) {
+    builder.pushScroll(scrollId, scrollOffset, viewport.shift(offset + layerOffset), contentSize);
+    addChildrenToScene(builder, Offset.zero);
+    builder.pop();
+  }
+}
+
 /// A composited layer that applies a transformation matrix to its children
 class TransformLayer extends ContainerLayer {
   TransformLayer({ Offset offset: Offset.zero, this.transform }) : super(offset: offset);
@@ -248,13 +325,36 @@ class TransformLayer extends ContainerLayer {
   /// The matrix to apply
   Matrix4 transform;
 
+  /// Animations the compositor applies to the children by itself, without a
+  /// new frame for every step of the animation
+  ///
+  /// The children are translated, then scaled and rotated (in radians,
+  /// clockwise) around [animationOrigin], in their own coordinates, before
+  /// [transform] applies.
+  sky.LayerAnimation translateXAnimation;
+  sky.LayerAnimation translateYAnimation;
+  sky.LayerAnimation scaleAnimation;
+  sky.LayerAnimation rotationAnimation;
+
+  /// The point scale and rotation animations are centered on
+  Point animationOrigin = Point.origin;
+
   void addToScene(sky.SceneBuilder builder, Offset layerOffset) {
     Matrix4 offsetTransform = new Matrix4.identity();
     offsetTransform.translate(offset.dx + layerOffset.dx, offset.dy + layerOffset.dy);
     builder.pushTransform((offsetTransform * transform).storage);
+    _addAnimation(builder, 0, translateXAnimation);
+    _addAnimation(builder, 1, translateYAnimation);
+    _addAnimation(builder, 2, scaleAnimation);
+    _addAnimation(builder, 3, rotationAnimation);
     addChildrenToScene(builder, Offset.zero);
     builder.pop();
   }
+
+  void _addAnimation(sky.SceneBuilder builder, int property, sky.LayerAnimation animation) {
+    if (animation != null)
+      builder.setTransformAnimation(property, animation, animationOrigin);
+  }
 }
 
 /// A composited layer that makes its children partially transparent
@@ -271,8 +371,14 @@ class OpacityLayer extends ContainerLayer {
   /// transparent and 255 is fully opaque.
   int alpha;
 
+  /// Replaces [alpha] with values the compositor computes by itself, without
+  /// a new frame for every step of the animation
+  sky.LayerAnimation alphaAnimation;
+
   void addToScene(sky.SceneBuilder builder, Offset layerOffset) {
     builder.pushOpacity(alpha, bounds?.shift(layerOffset));
+    if (alphaAnimation != null)
+      builder.setOpacityAnimation(alphaAnimation);
     addChildrenToScene(builder, offset + layerOffset);
     builder.pop();
   }
@@ -5,6 +5,7 @@
 import 'dart:sky' as sky;
 
 import 'package:sky/animation.dart';
+import 'package:sky/src/rendering/debug.dart';
 import 'package:sky/src/rendering/layer.dart';
 import 'package:sky/src/rendering/object.dart';
 import 'package:sky/src/rendering/box.dart';
@@ -119,11 +120,23 @@ class RenderView extends RenderObject with RenderObjectWithChildMixin<RenderBox>
       Rect bounds = Point.origin & (size * sky.view.devicePixelRatio);
       sky.SceneBuilder builder = new sky.SceneBuilder(bounds);
       layer.addToScene(builder, Offset.zero);
+      builder.setDebugOptions(_compositorDebugOptions);
       sky.view.scene = builder.build();
     } finally {
       sky.tracing.end('RenderView.compositeFrame');
     }
   }
 
+  int get _compositorDebugOptions {
+    int options = 0;
+    if (debugCompositorOverdrawEnabled)
+      options |= 8;
+    if (debugCompositorLayerBoundsEnabled)
+      options |= 16;
+    if (debugCompositorRasterTimeEnabled)
+      options |= 32;
+    return options;
+  }
+
   Rect get paintBounds => Point.origin & size;
 }
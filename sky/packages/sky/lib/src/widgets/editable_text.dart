@@ -130,6 +130,15 @@ class EditableString implements KeyboardClient {
     selection = new TextRange(start: start, end: end);
     onUpdated();
   }
+
+  void updateEditingState(EditingState state) {
+    text = state.text;
+    selection = new TextRange(
+        start: state.selectionBase, end: state.selectionExtent);
+    composing = new TextRange(
+        start: state.composingBase, end: state.composingExtent);
+    onUpdated();
+  }
 }
 
 class EditableText extends StatefulComponent {
@@ -32,6 +32,9 @@ class MediaPlayerImpl : public ::media::MediaPlayer {
   void Start() override;
   void Pause() override;
   void SeekTo(uint32_t msec) override;
+  void CreateVideoTexture(
+      const ::media::MediaPlayer::CreateVideoTextureCallback& callback)
+      override;
 
  private:
   mojo::StrongBinding<::media::MediaPlayer> binding_;
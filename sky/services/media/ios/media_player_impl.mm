@@ -131,6 +131,12 @@ void MediaPlayerImpl::SeekTo(uint32_t msec) {
   [audio_client_ seekTo:msec * 1e-3];
 }
 
+void MediaPlayerImpl::CreateVideoTexture(
+    const ::media::MediaPlayer::CreateVideoTextureCallback& callback) {
+  // The player only plays audio.
+  callback.Run(0);
+}
+
 void MediaPlayerImpl::reset() {
   [audio_client_ release];
   audio_client_ = nullptr;
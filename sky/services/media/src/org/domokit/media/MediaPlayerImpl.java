@@ -6,6 +6,7 @@ package org.domokit.media;
 
 import android.content.Context;
 import android.util.Log;
+import android.view.Surface;
 
 import org.chromium.mojo.common.DataPipeUtils;
 import org.chromium.mojo.system.Core;
@@ -26,14 +27,19 @@ public class MediaPlayerImpl implements MediaPlayer, android.media.MediaPlayer.O
     private final Context mContext;
     private final Executor mExecutor;
     private final android.media.MediaPlayer mPlayer;
+    private final SurfaceTextureRegistry mSurfaceTextureRegistry;
+    private int mTextureId;
     private PrepareResponse mPrepareResponse;
     private File mTempFile;
 
-    public MediaPlayerImpl(Core core, Context context, Executor executor) {
+    public MediaPlayerImpl(Core core, Context context, Executor executor,
+            SurfaceTextureRegistry surfaceTextureRegistry) {
         mCore = core;
         mContext = context;
         mExecutor = executor;
         mPlayer = new android.media.MediaPlayer();
+        mSurfaceTextureRegistry = surfaceTextureRegistry;
+        mTextureId = 0;
         mTempFile = null;
         mPrepareResponse = null;
     }
@@ -41,6 +47,9 @@ public class MediaPlayerImpl implements MediaPlayer, android.media.MediaPlayer.O
     @Override
     public void close() {
         mPlayer.release();
+        if (mTextureId != 0) {
+            mSurfaceTextureRegistry.releaseSurfaceTexture(mTextureId);
+        }
         if (mTempFile != null) {
             mTempFile.delete();
         }
@@ -107,4 +116,18 @@ public class MediaPlayerImpl implements MediaPlayer, android.media.MediaPlayer.O
     public void pause() {
         mPlayer.pause();
     }
+
+    @Override
+    public void createVideoTexture(CreateVideoTextureResponse callback) {
+        if (mTextureId == 0 && mSurfaceTextureRegistry != null) {
+            mTextureId = mSurfaceTextureRegistry.createSurfaceTexture();
+            // The player decodes straight into the texture's buffers, which
+            // the compositor draws without copying them.
+            Surface surface = new Surface(
+                    mSurfaceTextureRegistry.getSurfaceTexture(mTextureId));
+            mPlayer.setSurface(surface);
+            surface.release();
+        }
+        callback.call(mTextureId);
+    }
 }
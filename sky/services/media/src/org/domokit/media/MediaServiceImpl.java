@@ -23,6 +23,12 @@ public class MediaServiceImpl implements MediaService {
     private final Core mCore;
     private final Context mContext;
     private static ExecutorService sThreadPool;
+    private static SurfaceTextureRegistry sSurfaceTextureRegistry;
+
+    // TODO(eseidel): We need per-view services!
+    public static void setSurfaceTextureRegistry(SurfaceTextureRegistry registry) {
+        sSurfaceTextureRegistry = registry;
+    }
 
     public MediaServiceImpl(Context context, Core core) {
         assert context != null;
@@ -43,6 +49,7 @@ public class MediaServiceImpl implements MediaService {
 
     @Override
     public void createPlayer(InterfaceRequest<MediaPlayer> player) {
-        MediaPlayer.MANAGER.bind(new MediaPlayerImpl(mCore, mContext, sThreadPool), player);
+        MediaPlayer.MANAGER.bind(new MediaPlayerImpl(mCore, mContext, sThreadPool,
+                sSurfaceTextureRegistry), player);
     }
 }
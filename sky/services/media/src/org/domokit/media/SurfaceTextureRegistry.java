@@ -0,0 +1,25 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+package org.domokit.media;
+
+import android.graphics.SurfaceTexture;
+
+/**
+ * Creates the SurfaceTextures whose frames the compositor draws for the
+ * texture layers of a view.
+ */
+public interface SurfaceTextureRegistry {
+    /**
+     * Returns the id texture layers refer to a new SurfaceTexture by.
+     */
+    int createSurfaceTexture();
+
+    /**
+     * Returns the SurfaceTexture registered as textureId, or null.
+     */
+    SurfaceTexture getSurfaceTexture(int textureId);
+
+    void releaseSurfaceTexture(int textureId);
+}
@@ -26,6 +26,7 @@ class VsyncProviderImpl : public ::vsync::VSyncProvider {
       mojo::InterfaceRequest<::vsync::VSyncProvider> request);
   ~VsyncProviderImpl() override;
   void AwaitVSync(const AwaitVSyncCallback& callback) override;
+  void Subscribe(::vsync::VSyncListenerPtr listener) override;
 
  private:
   mojo::StrongBinding<::vsync::VSyncProvider> binding_;
@@ -25,6 +25,7 @@ static inline uint64_t CurrentTimeMicrosSeconds() {
 @implementation VSyncClient {
   CADisplayLink* _displayLink;
   ::vsync::VSyncProvider::AwaitVSyncCallback _pendingCallback;
+  ::vsync::VSyncListenerPtr _listener;
 }
 
 - (instancetype)init {
@@ -47,9 +48,29 @@ static inline uint64_t CurrentTimeMicrosSeconds() {
   _displayLink.paused = NO;
 }
 
+- (void)subscribe:(::vsync::VSyncListenerPtr)listener {
+  _listener = listener.Pass();
+  _displayLink.paused = NO;
+}
+
 - (void)onDisplayLink:(CADisplayLink*)link {
-  _displayLink.paused = YES;
-  _pendingCallback.Run(CurrentTimeMicrosSeconds());
+  const uint64_t timeStamp = CurrentTimeMicrosSeconds();
+
+  if (!_pendingCallback.is_null()) {
+    ::vsync::VSyncProvider::AwaitVSyncCallback callback = _pendingCallback;
+    _pendingCallback.reset();
+    callback.Run(timeStamp);
+  }
+
+  // The display link keeps running for as long as someone listens.
+  if (_listener && _listener.encountered_error())
+    _listener.reset();
+  if (_listener) {
+    const int64_t interval = link.duration * link.frameInterval * 1e6;
+    _listener->OnVSync(timeStamp, interval);
+  } else {
+    _displayLink.paused = YES;
+  }
 }
 
 - (void)dealloc {
@@ -77,6 +98,10 @@ void VsyncProviderImpl::AwaitVSync(const AwaitVSyncCallback& callback) {
   [client_ await:callback];
 }
 
+void VsyncProviderImpl::Subscribe(::vsync::VSyncListenerPtr listener) {
+  [client_ subscribe:listener.Pass()];
+}
+
 void VSyncProviderFactory::Create(
     mojo::ApplicationConnection* connection,
     mojo::InterfaceRequest<::vsync::VSyncProvider> request) {
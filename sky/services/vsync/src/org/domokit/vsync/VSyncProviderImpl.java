@@ -4,10 +4,14 @@
 
 package org.domokit.vsync;
 
+import android.content.Context;
 import android.view.Choreographer;
+import android.view.WindowManager;
 
+import org.chromium.mojo.bindings.ConnectionErrorHandler;
 import org.chromium.mojo.system.MessagePipeHandle;
 import org.chromium.mojo.system.MojoException;
+import org.chromium.mojom.vsync.VSyncListener;
 import org.chromium.mojom.vsync.VSyncProvider;
 
 /**
@@ -16,11 +20,18 @@ import org.chromium.mojom.vsync.VSyncProvider;
 public class VSyncProviderImpl implements VSyncProvider, Choreographer.FrameCallback {
     private Choreographer mChoreographer;
     private AwaitVSyncResponse mCallback;
+    private VSyncListener.Proxy mListener;
+    private boolean mFrameCallbackPosted;
     private MessagePipeHandle mPipe;
+    private long mIntervalMicros;
 
-    public VSyncProviderImpl(MessagePipeHandle pipe) {
+    public VSyncProviderImpl(Context context, MessagePipeHandle pipe) {
         mPipe = pipe;
         mChoreographer = Choreographer.getInstance();
+        WindowManager windowManager =
+                (WindowManager) context.getSystemService(Context.WINDOW_SERVICE);
+        float refreshRate = windowManager.getDefaultDisplay().getRefreshRate();
+        if (refreshRate > 0) mIntervalMicros = (long) (1000000 / refreshRate);
     }
 
     @Override
@@ -36,12 +47,42 @@ public class VSyncProviderImpl implements VSyncProvider, Choreographer.FrameCall
             return;
         }
         mCallback = callback;
+        postFrameCallback();
+    }
+
+    @Override
+    public void subscribe(VSyncListener listener) {
+        if (mListener != null) mListener.close();
+        final VSyncListener.Proxy proxy = (VSyncListener.Proxy) listener;
+        mListener = proxy;
+        proxy.getProxyHandler().setErrorHandler(new ConnectionErrorHandler() {
+            @Override
+            public void onConnectionError(MojoException e) {
+                if (mListener == proxy) mListener = null;
+            }
+        });
+        postFrameCallback();
+    }
+
+    private void postFrameCallback() {
+        if (mFrameCallbackPosted) return;
+        mFrameCallbackPosted = true;
         mChoreographer.postFrameCallback(this);
     }
 
     @Override
     public void doFrame(long frameTimeNanos) {
-        mCallback.call(frameTimeNanos / 1000);
-        mCallback = null;
+        mFrameCallbackPosted = false;
+        long timeStamp = frameTimeNanos / 1000;
+        if (mCallback != null) {
+            AwaitVSyncResponse callback = mCallback;
+            mCallback = null;
+            callback.call(timeStamp);
+        }
+        if (mListener != null) {
+            mListener.onVSync(timeStamp, mIntervalMicros);
+            // Keep the choreographer going for as long as someone listens.
+            postFrameCallback();
+        }
     }
 }
@@ -0,0 +1,254 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/android/external_texture_android.h"
+
+#include <algorithm>
+
+#include "base/android/jni_android.h"
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "jni/SurfaceTexture_jni.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const char kVertexShader[] =
+    "attribute vec2 a_position;\n"
+    "attribute vec2 a_texture_coord;\n"
+    "uniform mat4 u_transform;\n"
+    "varying vec2 v_texture_coord;\n"
+    "void main() {\n"
+    "  gl_Position = vec4(a_position, 0.0, 1.0);\n"
+    "  v_texture_coord = (u_transform * vec4(a_texture_coord, 0.0, 1.0)).xy;\n"
+    "}\n";
+
+const char kFragmentShader[] =
+    "#extension GL_OES_EGL_image_external : require\n"
+    "precision mediump float;\n"
+    "uniform samplerExternalOES u_texture;\n"
+    "varying vec2 v_texture_coord;\n"
+    "void main() {\n"
+    "  gl_FragColor = texture2D(u_texture, v_texture_coord);\n"
+    "}\n";
+
+// A quad covering the whole framebuffer, with the texture coordinates of
+// SurfaceTexture, whose origin is at the bottom left as GL's is.
+const GLfloat kPositions[] = {-1, -1, 1, -1, -1, 1, 1, 1};
+const GLfloat kTextureCoords[] = {0, 0, 1, 0, 0, 1, 1, 1};
+
+GLuint CompileShader(GLenum type, const char* source) {
+  GLuint shader = glCreateShader(type);
+  glShaderSource(shader, 1, &source, nullptr);
+  glCompileShader(shader);
+  GLint compiled = GL_FALSE;
+  glGetShaderiv(shader, GL_COMPILE_STATUS, &compiled);
+  if (!compiled) {
+    LOG(ERROR) << "Could not compile the external texture shader.";
+    glDeleteShader(shader);
+    return 0;
+  }
+  return shader;
+}
+
+}  // namespace
+
+ExternalTextureAndroid::ExternalTextureAndroid(
+    const base::android::JavaRef<jobject>& surface_texture)
+    : external_texture_(0),
+      latched_frame_count_(0),
+      program_(0),
+      position_location_(-1),
+      texture_coord_location_(-1),
+      transform_location_(-1),
+      framebuffer_(0),
+      texture_(0),
+      texture_size_(SkISize::Make(0, 0)) {
+  surface_texture_.Reset(surface_texture);
+  std::fill(transform_, transform_ + 16, 0.0f);
+}
+
+ExternalTextureAndroid::~ExternalTextureAndroid() {
+  // The GL objects go away with the context if ReleaseGLResources() was not
+  // called before.
+}
+
+void ExternalTextureAndroid::Paint(SkCanvas& canvas,
+                                   GrContext* gr_context,
+                                   const SkRect& bounds,
+                                   uint32_t frame_count) {
+  // Frames can only be latched into a GL context, and there is nothing to
+  // draw before the first one.
+  if (!gr_context || !frame_count)
+    return;
+
+  SkRect device_bounds;
+  canvas.getTotalMatrix().mapRect(&device_bounds, bounds);
+  const SkISize size =
+      SkISize::Make(std::max(1, SkScalarCeilToInt(device_bounds.width())),
+                    std::max(1, SkScalarCeilToInt(device_bounds.height())));
+
+  if (frame_count != latched_frame_count_ || !image_ ||
+      size != texture_size_) {
+    TRACE_EVENT0("sky", "ExternalTextureAndroid::CopyFrame");
+    // The GL calls below change state behind Ganesh's back.
+    gr_context->flush();
+
+    JNIEnv* env = base::android::AttachCurrentThread();
+    if (!external_texture_) {
+      glGenTextures(1, &external_texture_);
+      glBindTexture(GL_TEXTURE_EXTERNAL_OES, external_texture_);
+      JNI_SurfaceTexture::Java_SurfaceTexture_attachToGLContext(
+          env, surface_texture_.obj(), external_texture_);
+      // Attaching drops the frame latched into the previous context.
+      latched_frame_count_ = 0;
+    }
+    if (frame_count != latched_frame_count_) {
+      JNI_SurfaceTexture::Java_SurfaceTexture_updateTexImage(
+          env, surface_texture_.obj());
+      base::android::ScopedJavaLocalRef<jfloatArray> transform(
+          env, env->NewFloatArray(16));
+      JNI_SurfaceTexture::Java_SurfaceTexture_getTransformMatrix(
+          env, surface_texture_.obj(), transform.obj());
+      env->GetFloatArrayRegion(transform.obj(), 0, 16, transform_);
+      latched_frame_count_ = frame_count;
+    }
+
+    if (EnsureProgram())
+      CopyFrame(size);
+    gr_context->resetContext();
+
+    if (!image_ && texture_) {
+      GrBackendTextureDesc desc;
+      desc.fOrigin = kBottomLeft_GrSurfaceOrigin;
+      desc.fWidth = texture_size_.width();
+      desc.fHeight = texture_size_.height();
+      desc.fConfig = kRGBA_8888_GrPixelConfig;
+      desc.fSampleCnt = 0;
+      desc.fTextureHandle = texture_;
+      image_ = adoptRef(
+          SkImage::NewFromTexture(gr_context, desc, kPremul_SkAlphaType));
+    }
+  }
+
+  if (!image_)
+    return;
+
+  SkPaint paint;
+  paint.setFilterQuality(kLow_SkFilterQuality);
+  canvas.drawImageRect(
+      image_.get(),
+      SkRect::MakeIWH(texture_size_.width(), texture_size_.height()), bounds,
+      &paint);
+}
+
+void ExternalTextureAndroid::ReleaseGLResources() {
+  image_ = nullptr;
+  if (external_texture_) {
+    // Detaching deletes the texture.
+    JNI_SurfaceTexture::Java_SurfaceTexture_detachFromGLContext(
+        base::android::AttachCurrentThread(), surface_texture_.obj());
+    external_texture_ = 0;
+  }
+  if (texture_) {
+    glDeleteTextures(1, &texture_);
+    texture_ = 0;
+    texture_size_ = SkISize::Make(0, 0);
+  }
+  if (framebuffer_) {
+    glDeleteFramebuffersEXT(1, &framebuffer_);
+    framebuffer_ = 0;
+  }
+  if (program_) {
+    glDeleteProgram(program_);
+    program_ = 0;
+  }
+}
+
+bool ExternalTextureAndroid::EnsureProgram() {
+  if (program_)
+    return true;
+
+  GLuint vertex_shader = CompileShader(GL_VERTEX_SHADER, kVertexShader);
+  GLuint fragment_shader = CompileShader(GL_FRAGMENT_SHADER, kFragmentShader);
+  if (vertex_shader && fragment_shader) {
+    program_ = glCreateProgram();
+    glAttachShader(program_, vertex_shader);
+    glAttachShader(program_, fragment_shader);
+    glLinkProgram(program_);
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program_, GL_LINK_STATUS, &linked);
+    if (!linked) {
+      LOG(ERROR) << "Could not link the external texture program.";
+      glDeleteProgram(program_);
+      program_ = 0;
+    }
+  }
+  // The program keeps the shaders it links.
+  if (vertex_shader)
+    glDeleteShader(vertex_shader);
+  if (fragment_shader)
+    glDeleteShader(fragment_shader);
+  if (!program_)
+    return false;
+
+  position_location_ = glGetAttribLocation(program_, "a_position");
+  texture_coord_location_ = glGetAttribLocation(program_, "a_texture_coord");
+  transform_location_ = glGetUniformLocation(program_, "u_transform");
+  return true;
+}
+
+void ExternalTextureAndroid::CopyFrame(const SkISize& size) {
+  if (!texture_ || size != texture_size_) {
+    image_ = nullptr;
+    if (!texture_)
+      glGenTextures(1, &texture_);
+    glBindTexture(GL_TEXTURE_2D, texture_);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.width(), size.height(), 0,
+                 GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    texture_size_ = size;
+  }
+
+  if (!framebuffer_)
+    glGenFramebuffersEXT(1, &framebuffer_);
+  glBindFramebufferEXT(GL_FRAMEBUFFER, framebuffer_);
+  glFramebufferTexture2DEXT(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0,
+                            GL_TEXTURE_2D, texture_, 0);
+
+  glViewport(0, 0, size.width(), size.height());
+  glDisable(GL_BLEND);
+  glDisable(GL_CULL_FACE);
+  glDisable(GL_DEPTH_TEST);
+  glDisable(GL_SCISSOR_TEST);
+  glDisable(GL_STENCIL_TEST);
+  glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+
+  glUseProgram(program_);
+  glActiveTexture(GL_TEXTURE0);
+  glBindTexture(GL_TEXTURE_EXTERNAL_OES, external_texture_);
+  glUniformMatrix4fv(transform_location_, 1, GL_FALSE, transform_);
+
+  glBindBuffer(GL_ARRAY_BUFFER, 0);
+  glVertexAttribPointer(position_location_, 2, GL_FLOAT, GL_FALSE, 0,
+                        kPositions);
+  glEnableVertexAttribArray(position_location_);
+  glVertexAttribPointer(texture_coord_location_, 2, GL_FLOAT, GL_FALSE, 0,
+                        kTextureCoords);
+  glEnableVertexAttribArray(texture_coord_location_);
+  glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+  glDisableVertexAttribArray(position_location_);
+  glDisableVertexAttribArray(texture_coord_location_);
+
+  glBindFramebufferEXT(GL_FRAMEBUFFER, 0);
+}
+
+}  // namespace shell
+}  // namespace sky
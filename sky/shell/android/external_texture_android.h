@@ -0,0 +1,70 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_ANDROID_EXTERNAL_TEXTURE_ANDROID_H_
+#define SKY_SHELL_ANDROID_EXTERNAL_TEXTURE_ANDROID_H_
+
+#include "base/android/scoped_java_ref.h"
+#include "sky/compositor/texture_registry.h"
+#include "sky/engine/wtf/RefPtr.h"
+#include "third_party/skia/include/core/SkImage.h"
+#include "third_party/skia/include/core/SkSize.h"
+#include "ui/gl/gl_bindings.h"
+
+namespace sky {
+namespace shell {
+
+// Draws the frames of an android.graphics.SurfaceTexture, which producers
+// such as MediaPlayer or the camera decode into GPU memory.
+//
+// The SurfaceTexture is created detached and attached to the GL context of
+// the GPU thread when its first frame is drawn. Ganesh cannot sample the
+// GL_TEXTURE_EXTERNAL_OES texture it latches frames into, so every new frame
+// is drawn once into a texture of the layer's device size, on the GPU,
+// which the frames in between composite like any other image.
+class ExternalTextureAndroid : public compositor::ExternalTexture {
+ public:
+  explicit ExternalTextureAndroid(
+      const base::android::JavaRef<jobject>& surface_texture);
+
+  // compositor::ExternalTexture:
+  void Paint(SkCanvas& canvas,
+             GrContext* gr_context,
+             const SkRect& bounds,
+             uint32_t frame_count) override;
+  void ReleaseGLResources() override;
+
+ private:
+  ~ExternalTextureAndroid() override;
+
+  bool EnsureProgram();
+  // Draws the latched frame into |texture_|, resizing it to |size|.
+  void CopyFrame(const SkISize& size);
+
+  base::android::ScopedJavaGlobalRef<jobject> surface_texture_;
+
+  // The texture the SurfaceTexture is attached to, or 0 while it is
+  // detached.
+  GLuint external_texture_;
+  uint32_t latched_frame_count_;
+  // Maps texture coordinates to those of the latched frame.
+  float transform_[16];
+
+  GLuint program_;
+  GLint position_location_;
+  GLint texture_coord_location_;
+  GLint transform_location_;
+  GLuint framebuffer_;
+  GLuint texture_;
+  SkISize texture_size_;
+  // Wraps |texture_|.
+  RefPtr<SkImage> image_;
+
+  DISALLOW_COPY_AND_ASSIGN(ExternalTextureAndroid);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_ANDROID_EXTERNAL_TEXTURE_ANDROID_H_
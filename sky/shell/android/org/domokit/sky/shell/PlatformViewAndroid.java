@@ -5,7 +5,9 @@
 package org.domokit.sky.shell;
 
 import android.content.Context;
+import android.graphics.SurfaceTexture;
 import android.os.Build;
+import android.util.SparseArray;
 import android.view.MotionEvent;
 import android.view.Surface;
 import android.view.SurfaceHolder;
@@ -27,13 +29,15 @@ import org.chromium.mojom.sky.PointerData;
 import org.chromium.mojom.sky.PointerKind;
 import org.chromium.mojom.sky.SkyEngine;
 import org.chromium.mojom.sky.ViewportMetrics;
+import org.domokit.media.MediaServiceImpl;
+import org.domokit.media.SurfaceTextureRegistry;
 
 /**
  * A view containing Sky
  */
 @JNINamespace("sky::shell")
 public class PlatformViewAndroid extends SurfaceView
-        implements GestureProvider.OnGestureListener {
+        implements GestureProvider.OnGestureListener, SurfaceTextureRegistry {
     private static final String TAG = "PlatformViewAndroid";
 
     private long mNativePlatformView;
@@ -42,6 +46,7 @@ public class PlatformViewAndroid extends SurfaceView
     private GestureProvider mGestureProvider;
     private final EdgeDims mPadding;
     private final KeyboardServiceState mKeyboardState;
+    private final SparseArray<SurfaceTexture> mSurfaceTextures;
 
     /**
      * Dimensions in each of the four cardinal directions.
@@ -101,6 +106,9 @@ public class PlatformViewAndroid extends SurfaceView
         // TODO(eseidel): We need per-view services!
         mKeyboardState = new KeyboardServiceState(this);
         KeyboardServiceImpl.setViewState(mKeyboardState);
+
+        mSurfaceTextures = new SparseArray<SurfaceTexture>();
+        MediaServiceImpl.setSurfaceTextureRegistry(this);
     }
 
     SkyEngine getEngine() {
@@ -110,6 +118,10 @@ public class PlatformViewAndroid extends SurfaceView
     @Override
     protected void onDetachedFromWindow() {
         getHolder().removeCallback(mSurfaceCallback);
+        for (int i = 0; i < mSurfaceTextures.size(); i++) {
+            mSurfaceTextures.valueAt(i).setOnFrameAvailableListener(null);
+        }
+        mSurfaceTextures.clear();
         nativeDetach(mNativePlatformView);
         mNativePlatformView = 0;
     }
@@ -212,6 +224,44 @@ public class PlatformViewAndroid extends SurfaceView
         mSkyEngine.onInputEvent(event);
     }
 
+    @Override
+    public int createSurfaceTexture() {
+        assert mNativePlatformView != 0;
+        // The compositor attaches the texture to its GL context on the GPU
+        // thread once it draws the first frame.
+        SurfaceTexture surfaceTexture = new SurfaceTexture(0);
+        surfaceTexture.detachFromGLContext();
+        final int textureId = nativeRegisterSurfaceTexture(mNativePlatformView, surfaceTexture);
+        surfaceTexture.setOnFrameAvailableListener(new SurfaceTexture.OnFrameAvailableListener() {
+            @Override
+            public void onFrameAvailable(SurfaceTexture texture) {
+                if (mNativePlatformView != 0) {
+                    nativeMarkTextureFrameAvailable(mNativePlatformView, textureId);
+                }
+            }
+        });
+        mSurfaceTextures.put(textureId, surfaceTexture);
+        return textureId;
+    }
+
+    @Override
+    public SurfaceTexture getSurfaceTexture(int textureId) {
+        return mSurfaceTextures.get(textureId);
+    }
+
+    @Override
+    public void releaseSurfaceTexture(int textureId) {
+        SurfaceTexture surfaceTexture = mSurfaceTextures.get(textureId);
+        if (surfaceTexture == null) {
+            return;
+        }
+        surfaceTexture.setOnFrameAvailableListener(null);
+        mSurfaceTextures.remove(textureId);
+        if (mNativePlatformView != 0) {
+            nativeUnregisterSurfaceTexture(mNativePlatformView, textureId);
+        }
+    }
+
     private void attach() {
         Core core = CoreImpl.getInstance();
         Pair<SkyEngine.Proxy, InterfaceRequest<SkyEngine>> result =
@@ -225,4 +275,10 @@ public class PlatformViewAndroid extends SurfaceView
     private static native void nativeSurfaceCreated(long nativePlatformViewAndroid,
                                                     Surface surface);
     private static native void nativeSurfaceDestroyed(long nativePlatformViewAndroid);
+    private static native int nativeRegisterSurfaceTexture(long nativePlatformViewAndroid,
+                                                           SurfaceTexture surfaceTexture);
+    private static native void nativeUnregisterSurfaceTexture(long nativePlatformViewAndroid,
+                                                              int textureId);
+    private static native void nativeMarkTextureFrameAvailable(long nativePlatformViewAndroid,
+                                                               int textureId);
 }
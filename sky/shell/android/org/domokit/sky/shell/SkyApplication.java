@@ -38,7 +38,9 @@ public class SkyApplication extends BaseChromiumApplication {
 
     private static final String TAG = "SkyApplication";
     private static final String PRIVATE_DATA_DIRECTORY_SUFFIX = "sky_shell";
-    private static final String[] SKY_RESOURCES = {"icudtl.dat", SNAPSHOT, APP_BUNDLE, MANIFEST};
+    // ICU's data is not extracted. It is stored uncompressed in the APK, and
+    // base::i18n::InitializeICU maps it from there.
+    private static final String[] SKY_RESOURCES = {SNAPSHOT, APP_BUNDLE, MANIFEST};
 
     private ResourceExtractor mResourceExtractor;
 
@@ -52,6 +54,7 @@ public class SkyApplication extends BaseChromiumApplication {
         initJavaUtils();
         initResources();
         initNative();
+        SkyMain.warmUp(getApplicationContext());
         UpdateService.init(getApplicationContext());
         onServiceRegistryAvailable(ServiceRegistry.SHARED);
     }
@@ -98,14 +101,14 @@ public class SkyApplication extends BaseChromiumApplication {
         registry.register(SensorService.MANAGER.getName(), new ServiceFactory() {
             @Override
             public void connectToService(Context context, Core core, MessagePipeHandle pipe) {
-                SensorService.MANAGER.bind(new SensorServiceImpl(context), pipe);
+                SensorService.MANAGER.bind(new SensorServiceImpl(context, core), pipe);
             }
         });
 
         registry.register(VSyncProvider.MANAGER.getName(), new ServiceFactory() {
             @Override
             public void connectToService(Context context, Core core, MessagePipeHandle pipe) {
-                VSyncProvider.MANAGER.bind(new VSyncProviderImpl(pipe), pipe);
+                VSyncProvider.MANAGER.bind(new VSyncProviderImpl(context, pipe), pipe);
             }
         });
     }
@@ -5,11 +5,15 @@
 package org.domokit.sky.shell;
 
 import android.content.Context;
+import android.os.Process;
 import android.util.Log;
 
 import org.chromium.base.JNINamespace;
+import org.chromium.base.PathUtils;
 import org.chromium.mojo.system.impl.CoreImpl;
 
+import java.io.File;
+
 /**
  * A class to intialize the native code.
  **/
@@ -42,5 +46,30 @@ public class SkyMain {
         }
     }
 
+    /**
+     * Starts reading the extracted resources and the system fonts on a background thread, so that
+     * initializing the native system and running the app find them in memory. Can be called as
+     * soon as the native library is loaded.
+     **/
+    public static void warmUp(final Context applicationContext) {
+        Thread thread = new Thread("SkyWarmUp") {
+            @Override
+            public void run() {
+                Process.setThreadPriority(Process.THREAD_PRIORITY_BACKGROUND);
+                SkyApplication app = (SkyApplication) applicationContext;
+                app.getResourceExtractor().waitForCompletion();
+                File dataDir = new File(PathUtils.getDataDirectory(applicationContext));
+                String[] paths = {
+                    new File(dataDir, SkyApplication.SNAPSHOT).getPath(),
+                    new File(dataDir, SkyApplication.APP_BUNDLE).getPath(),
+                };
+                nativeWarmUp(paths);
+            }
+        };
+        thread.setDaemon(true);
+        thread.start();
+    }
+
     private static native void nativeInit(Context context, String[] args);
+    private static native void nativeWarmUp(String[] paths);
 }
@@ -26,6 +26,10 @@ class TracingController {
     private static final String TAG = "TracingController";
     private static final String TRACING_START = ".TRACING_START";
     private static final String TRACING_STOP = ".TRACING_STOP";
+    private static final String PROFILING_START = ".PROFILING_START";
+    private static final String PROFILING_STOP = ".PROFILING_STOP";
+    private static final String PROFILING_RATE = "rate";
+    private static final int DEFAULT_PROFILING_RATE = 250;
 
     private final Context mContext;
     private final TracingBroadcastReceiver mBroadcastReceiver;
@@ -43,12 +47,12 @@ class TracingController {
         mContext.unregisterReceiver(mBroadcastReceiver);
     }
 
-    private String generateTracingFilePath() {
+    private String generateFilePath(String prefix) {
         SimpleDateFormat formatter = new SimpleDateFormat("yyyy-MM-dd-HHmmss", Locale.US);
         formatter.setTimeZone(TimeZone.getTimeZone("UTC"));
         File dir = mContext.getCacheDir();
         String date = formatter.format(new Date());
-        File file = new File(dir, "sky-trace-" + date + ".json");
+        File file = new File(dir, prefix + date + ".json");
         return file.getPath();
     }
 
@@ -56,6 +60,8 @@ class TracingController {
         TracingIntentFilter(Context context) {
             addAction(context.getPackageName() + TRACING_START);
             addAction(context.getPackageName() + TRACING_STOP);
+            addAction(context.getPackageName() + PROFILING_START);
+            addAction(context.getPackageName() + PROFILING_STOP);
         }
     }
 
@@ -65,7 +71,12 @@ class TracingController {
             if (intent.getAction().endsWith(TRACING_START)) {
                 nativeStartTracing();
             } else if (intent.getAction().endsWith(TRACING_STOP)) {
-                nativeStopTracing(generateTracingFilePath());
+                nativeStopTracing(generateFilePath("sky-trace-"));
+            } else if (intent.getAction().endsWith(PROFILING_START)) {
+                nativeStartProfiling(
+                        intent.getIntExtra(PROFILING_RATE, DEFAULT_PROFILING_RATE));
+            } else if (intent.getAction().endsWith(PROFILING_STOP)) {
+                nativeStopProfiling(generateFilePath("sky-profile-"));
             } else {
                 Log.e(TAG, "Unexpected intent: " + intent);
             }
@@ -74,4 +85,6 @@ class TracingController {
 
     private static native void nativeStartTracing();
     private static native void nativeStopTracing(String path);
+    private static native void nativeStartProfiling(int samplesPerSecond);
+    private static native void nativeStopProfiling(String path);
 }
@@ -4,6 +4,7 @@
 
 package org.domokit.sky.shell;
 
+import android.app.ActivityManager;
 import android.app.AlarmManager;
 import android.app.Service;
 import android.app.PendingIntent;
@@ -66,10 +67,19 @@ public class UpdateService extends Service {
     @Override
     public int onStartCommand(Intent intent, int flags, int startId) {
         final File dataDir = new File(PathUtils.getDataDirectory(this));
-        mNativePtr = nativeCheckForUpdates(dataDir.getPath());
+        mNativePtr = nativeCheckForUpdates(dataDir.getPath(), isAppInForeground());
         return START_NOT_STICKY;
     }
 
+    // Updates are throttled while the app is being used.
+    private static boolean isAppInForeground() {
+        ActivityManager.RunningAppProcessInfo info =
+                new ActivityManager.RunningAppProcessInfo();
+        ActivityManager.getMyMemoryState(info);
+        return info.importance
+                == ActivityManager.RunningAppProcessInfo.IMPORTANCE_FOREGROUND;
+    }
+
     @Override
     public IBinder onBind(Intent intent) {
       return null;
@@ -81,6 +91,6 @@ public class UpdateService extends Service {
         stopSelf();
     }
 
-    private native long nativeCheckForUpdates(String dataDir);
+    private native long nativeCheckForUpdates(String dataDir, boolean foreground);
     private native void nativeDestroy(long nativeUpdateTaskAndroid);
 }
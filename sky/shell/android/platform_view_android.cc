@@ -7,10 +7,13 @@
 #include <android/input.h>
 #include <android/native_window_jni.h>
 
+#include <algorithm>
+
 #include "base/android/jni_android.h"
 #include "base/bind.h"
 #include "base/location.h"
 #include "jni/PlatformViewAndroid_jni.h"
+#include "sky/shell/android/external_texture_android.h"
 #include "sky/shell/shell.h"
 #include "sky/shell/shell_view.h"
 
@@ -43,6 +46,8 @@ PlatformViewAndroid::PlatformViewAndroid(const Config& config)
 PlatformViewAndroid::~PlatformViewAndroid() {
   if (window_)
     ReleaseWindow();
+  for (uint32_t texture_id : texture_ids_)
+    config_.texture_registry->UnregisterTexture(texture_id);
 }
 
 void PlatformViewAndroid::Detach(JNIEnv* env, jobject obj) {
@@ -69,6 +74,32 @@ void PlatformViewAndroid::SurfaceDestroyed(JNIEnv* env, jobject obj) {
   ReleaseWindow();
 }
 
+jint PlatformViewAndroid::RegisterSurfaceTexture(JNIEnv* env,
+                                                 jobject obj,
+                                                 jobject surface_texture) {
+  const uint32_t texture_id = config_.texture_registry->RegisterTexture(
+      new ExternalTextureAndroid(
+          base::android::ScopedJavaLocalRef<jobject>(env, surface_texture)));
+  texture_ids_.push_back(texture_id);
+  return texture_id;
+}
+
+void PlatformViewAndroid::UnregisterSurfaceTexture(JNIEnv* env,
+                                                   jobject obj,
+                                                   jint texture_id) {
+  auto it = std::find(texture_ids_.begin(), texture_ids_.end(), texture_id);
+  if (it == texture_ids_.end())
+    return;
+  texture_ids_.erase(it);
+  config_.texture_registry->UnregisterTexture(texture_id);
+}
+
+void PlatformViewAndroid::MarkTextureFrameAvailable(JNIEnv* env,
+                                                    jobject obj,
+                                                    jint texture_id) {
+  config_.texture_registry->MarkFrameAvailable(texture_id);
+}
+
 void PlatformViewAndroid::SetShellView(scoped_ptr<ShellView> shell_view) {
   DCHECK(!shell_view_);
   shell_view_ = shell_view.Pass();
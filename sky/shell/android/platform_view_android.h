@@ -5,6 +5,8 @@
 #ifndef SKY_SHELL_PLATFORM_VIEW_ANDROID_H_
 #define SKY_SHELL_PLATFORM_VIEW_ANDROID_H_
 
+#include <vector>
+
 #include "sky/shell/platform_view.h"
 
 struct ANativeWindow;
@@ -24,6 +26,11 @@ class PlatformViewAndroid : public PlatformView {
   void Detach(JNIEnv* env, jobject obj);
   void SurfaceCreated(JNIEnv* env, jobject obj, jobject jsurface);
   void SurfaceDestroyed(JNIEnv* env, jobject obj);
+  jint RegisterSurfaceTexture(JNIEnv* env,
+                              jobject obj,
+                              jobject surface_texture);
+  void UnregisterSurfaceTexture(JNIEnv* env, jobject obj, jint texture_id);
+  void MarkTextureFrameAvailable(JNIEnv* env, jobject obj, jint texture_id);
 
   void SetShellView(scoped_ptr<ShellView> shell_view);
 
@@ -36,6 +43,9 @@ class PlatformViewAndroid : public PlatformView {
   // |Detach|, which will eventually cause |~PlatformViewAndroid|.
   scoped_ptr<ShellView> shell_view_;
 
+  // The ids of the SurfaceTextures registered by this view.
+  std::vector<uint32_t> texture_ids_;
+
   DISALLOW_COPY_AND_ASSIGN(PlatformViewAndroid);
 };
 
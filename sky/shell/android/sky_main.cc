@@ -4,12 +4,17 @@
 
 #include "sky/shell/android/sky_main.h"
 
+#include <fcntl.h>
+
 #include "base/android/jni_android.h"
 #include "base/android/jni_array.h"
 #include "base/android/jni_string.h"
+#include "base/android/memory_pressure_listener_android.h"
 #include "base/at_exit.h"
 #include "base/bind.h"
 #include "base/command_line.h"
+#include "base/files/file.h"
+#include "base/files/file_path.h"
 #include "base/lazy_instance.h"
 #include "base/logging.h"
 #include "base/macros.h"
@@ -19,6 +24,9 @@
 #include "jni/SkyMain_jni.h"
 #include "sky/shell/service_provider.h"
 #include "sky/shell/shell.h"
+#include "skia/ext/refptr.h"
+#include "third_party/skia/include/core/SkTypeface.h"
+#include "third_party/skia/include/ports/SkFontMgr.h"
 
 using base::LazyInstance;
 
@@ -59,6 +67,10 @@ static void Init(JNIEnv* env,
 
   InitializeLogging();
 
+  // Forwards onTrimMemory and onLowMemory to base::MemoryPressureListener,
+  // which the rasterizer listens to.
+  base::android::MemoryPressureListenerAndroid::RegisterSystemCallback(env);
+
   g_java_message_loop.Get().reset(new base::MessageLoopForUI);
   base::MessageLoopForUI::current()->Start();
 
@@ -66,6 +78,29 @@ static void Init(JNIEnv* env,
       g_java_message_loop.Get()->task_runner())));
 }
 
+// Runs on a background thread while the application starts up, before the
+// shell exists. Only does work whose results the process keeps anyway.
+static void WarmUp(JNIEnv* env, jclass clazz, jobjectArray jpaths) {
+  // The kernel reads the files into the page cache in the background, so
+  // that loading the app reads from memory. ICU's data is left alone, since
+  // ICU only touches the pages of the tables it uses.
+  std::vector<std::string> paths;
+  base::android::AppendJavaStringArrayToStringVector(env, jpaths, &paths);
+  for (const std::string& path : paths) {
+    base::File file(base::FilePath(path),
+                    base::File::FLAG_OPEN | base::File::FLAG_READ);
+    if (file.IsValid())
+      posix_fadvise(file.GetPlatformFile(), 0, 0, POSIX_FADV_WILLNEED);
+  }
+
+  // Parses the system's font configuration and opens the default family,
+  // which the first frame with text would otherwise wait for.
+  skia::RefPtr<SkFontMgr> font_manager =
+      skia::AdoptRef(SkFontMgr::RefDefault());
+  skia::RefPtr<SkTypeface> typeface = skia::AdoptRef(
+      font_manager->legacyCreateTypeface(nullptr, SkTypeface::kNormal));
+}
+
 bool RegisterSkyMain(JNIEnv* env) {
   return RegisterNativesImpl(env);
 }
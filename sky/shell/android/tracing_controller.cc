@@ -11,6 +11,9 @@
 #include "base/trace_event/trace_config.h"
 #include "base/trace_event/trace_event.h"
 #include "jni/TracingController_jni.h"
+#include "sky/shell/shell.h"
+#include "sky/shell/synthetic_delays.h"
+#include "sky/shell/tracing_controller.h"
 
 namespace sky {
 namespace shell {
@@ -37,6 +40,7 @@ void HandleChunk(const scoped_refptr<base::RefCountedString>& chunk,
     g_file = NULL;
 
     LOG(INFO) << "Trace complete";
+    Shell::Shared().tracing_controller().jank_tracer().Resume();
   }
 }
 
@@ -45,8 +49,10 @@ void HandleChunk(const scoped_refptr<base::RefCountedString>& chunk,
 static void StartTracing(JNIEnv* env, jclass clazz) {
   LOG(INFO) << "Starting trace";
 
+  Shell::Shared().tracing_controller().jank_tracer().Suspend();
   base::trace_event::TraceLog::GetInstance()->SetEnabled(
-      base::trace_event::TraceConfig("*", base::trace_event::RECORD_UNTIL_FULL),
+      base::trace_event::TraceConfig(AddSyntheticDelays(kTraceCategories),
+                                     base::trace_event::RECORD_UNTIL_FULL),
       base::trace_event::TraceLog::RECORDING_MODE);
 }
 
@@ -62,6 +68,23 @@ static void StopTracing(JNIEnv* env, jclass clazz, jstring path) {
   base::trace_event::TraceLog::GetInstance()->Flush(base::Bind(&HandleChunk));
 }
 
+static void StartProfiling(JNIEnv* env, jclass clazz, jint samples_per_second) {
+  LOG(INFO) << "Starting profile";
+  if (!Shell::Shared().tracing_controller().sampling_profiler().Start(
+          samples_per_second)) {
+    LOG(ERROR) << "Could not start profiling";
+  }
+}
+
+static void StopProfiling(JNIEnv* env, jclass clazz, jstring path) {
+  base::FilePath file_path(base::android::ConvertJavaStringToUTF8(env, path));
+  LOG(INFO) << "Saving profile to " << file_path.LossyDisplayName();
+  if (Shell::Shared().tracing_controller().sampling_profiler().Stop(file_path))
+    LOG(INFO) << "Profile complete";
+  else
+    LOG(ERROR) << "Profile failed";
+}
+
 bool RegisterTracingController(JNIEnv* env) {
   return RegisterNativesImpl(env);
 }
@@ -9,10 +9,14 @@
 namespace sky {
 namespace shell {
 
-static jlong CheckForUpdates(JNIEnv* env, jobject jcaller, jstring j_data_dir) {
+static jlong CheckForUpdates(JNIEnv* env,
+                             jobject jcaller,
+                             jstring j_data_dir,
+                             jboolean foreground) {
   std::string data_dir =
       base::android::ConvertJavaStringToUTF8(env, j_data_dir);
   scoped_ptr<UpdateTask> task(new UpdateTaskAndroid(env, jcaller, data_dir));
+  task->SetForeground(foreground);
   task->Start();
   return reinterpret_cast<jlong>(task.release());
 }
@@ -0,0 +1,97 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/dart/dart_library_cache.h"
+
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/trace_event/trace_event.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const char kBodyExtension[] = ".dart";
+const char kDownloadExtension[] = ".download";
+const char kValidatorsExtension[] = ".validators";
+
+}  // namespace
+
+DartLibraryCache::DartLibraryCache(const base::FilePath& cache_dir)
+    : cache_dir_(cache_dir) {
+}
+
+DartLibraryCache::~DartLibraryCache() {
+}
+
+DartLibraryCache::Entry DartLibraryCache::Find(const std::string& url) const {
+  TRACE_EVENT0("sky", "DartLibraryCache::Find");
+
+  Entry entry;
+  // Create the directory here so that bodies can be downloaded into it.
+  if (!base::CreateDirectory(cache_dir_)) {
+    LOG(ERROR) << "Could not create " << cache_dir_.AsUTF8Unsafe();
+    return entry;
+  }
+  base::FilePath body_path = EntryPath(url, kBodyExtension);
+  std::string validators;
+  if (!base::PathExists(body_path) ||
+      !base::ReadFileToString(EntryPath(url, kValidatorsExtension),
+                              &validators))
+    return entry;
+
+  // The ETag is on the first line and Last-Modified on the second.
+  std::vector<std::string> lines;
+  base::SplitString(validators, '\n', &lines);
+  if (lines.size() < 2 || (lines[0].empty() && lines[1].empty()))
+    return entry;
+  entry.body_path = body_path;
+  entry.etag = lines[0];
+  entry.last_modified = lines[1];
+  return entry;
+}
+
+base::FilePath DartLibraryCache::DownloadPath(const std::string& url) const {
+  return EntryPath(url, kDownloadExtension);
+}
+
+base::FilePath DartLibraryCache::Store(const std::string& url,
+                                       const std::string& etag,
+                                       const std::string& last_modified) const {
+  TRACE_EVENT0("sky", "DartLibraryCache::Store");
+
+  base::FilePath download_path = DownloadPath(url);
+  base::FilePath body_path = EntryPath(url, kBodyExtension);
+  base::FilePath validators_path = EntryPath(url, kValidatorsExtension);
+
+  // The validators are written last so that a body is never paired with the
+  // validators of a different one.
+  base::DeleteFile(validators_path, false);
+  std::string validators = etag + "\n" + last_modified + "\n";
+  if (!base::ReplaceFile(download_path, body_path, nullptr)) {
+    LOG(ERROR) << "Could not cache " << url;
+    return download_path;
+  }
+  if (base::WriteFile(validators_path, validators.data(), validators.size()) !=
+      static_cast<int>(validators.size())) {
+    LOG(ERROR) << "Could not cache " << url;
+    base::DeleteFile(validators_path, false);
+  }
+  return body_path;
+}
+
+base::FilePath DartLibraryCache::EntryPath(const std::string& url,
+                                           const char* extension) const {
+  std::string digest = base::SHA1HashString(url);
+  return cache_dir_.AppendASCII(
+      base::HexEncode(digest.data(), digest.size()) + extension);
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,58 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_DART_DART_LIBRARY_CACHE_H_
+#define SKY_SHELL_DART_DART_LIBRARY_CACHE_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+
+namespace sky {
+namespace shell {
+
+// DartLibraryCache keeps the libraries DartLibraryProviderNetwork fetched,
+// along with the validators the server sent for them, so that a library the
+// server reports as unchanged is read from disk instead of downloaded again.
+//
+// The methods do blocking file IO and are meant to run on a worker thread.
+class DartLibraryCache {
+ public:
+  struct Entry {
+    // Empty if the library is not cached.
+    base::FilePath body_path;
+    std::string etag;
+    std::string last_modified;
+  };
+
+  explicit DartLibraryCache(const base::FilePath& cache_dir);
+  ~DartLibraryCache();
+
+  // Also creates the cache directory if needed.
+  Entry Find(const std::string& url) const;
+
+  // Where a new body of |url| is downloaded to before it is stored.
+  base::FilePath DownloadPath(const std::string& url) const;
+
+  // Moves the body at DownloadPath(url) into the cache and returns where it
+  // now is. If it cannot be stored, it is left where it was and that path is
+  // returned instead.
+  base::FilePath Store(const std::string& url,
+                       const std::string& etag,
+                       const std::string& last_modified) const;
+
+ private:
+  base::FilePath EntryPath(const std::string& url,
+                           const char* extension) const;
+
+  base::FilePath cache_dir_;
+
+  DISALLOW_COPY_AND_ASSIGN(DartLibraryCache);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_DART_DART_LIBRARY_CACHE_H_
@@ -87,10 +87,32 @@ Dart_Handle DartLibraryProviderFiles::CanonicalizeURL(Dart_Handle library,
     return blink::StdStringToDart(CanonicalizePackageURL(string));
   if (base::StartsWithASCII(string, "file:", true))
     return blink::StdStringToDart(CanonicalizeFileURL(string));
-  base::FilePath base_path(blink::StdStringFromDart(Dart_LibraryUrl(library)));
-  base::FilePath resolved_path = base_path.DirName().Append(string);
-  base::FilePath normalized_path = SimplifyPath(resolved_path);
-  return blink::StdStringToDart(normalized_path.AsUTF8Unsafe());
+  return blink::StdStringToDart(CanonicalizeRelativeURL(
+      blink::StdStringFromDart(Dart_LibraryUrl(library)), string));
+}
+
+std::string DartLibraryProviderFiles::CanonicalizeURLForPrefetch(
+    const std::string& library_url,
+    const std::string& url) {
+  if (base::StartsWithASCII(url, "dart:", true))
+    return std::string();
+  if (base::StartsWithASCII(url, "package:", true)) {
+    // Leave the missing package root to be reported by CanonicalizeURL.
+    if (package_root_.empty())
+      return std::string();
+    return CanonicalizePackageURL(url);
+  }
+  if (base::StartsWithASCII(url, "file:", true))
+    return CanonicalizeFileURL(url);
+  return CanonicalizeRelativeURL(library_url, url);
+}
+
+std::string DartLibraryProviderFiles::CanonicalizeRelativeURL(
+    const std::string& library_url,
+    const std::string& url) {
+  base::FilePath base_path(library_url);
+  base::FilePath resolved_path = base_path.DirName().Append(url);
+  return SimplifyPath(resolved_path).AsUTF8Unsafe();
 }
 
 }  // namespace shell
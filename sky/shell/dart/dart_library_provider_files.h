@@ -21,10 +21,14 @@ class DartLibraryProviderFiles : public blink::DartLibraryProvider {
   void GetLibraryAsStream(const std::string& name,
                           blink::DataPipeConsumerCallback callback) override;
   Dart_Handle CanonicalizeURL(Dart_Handle library, Dart_Handle url) override;
+  std::string CanonicalizeURLForPrefetch(const std::string& library_url,
+                                         const std::string& url) override;
 
  private:
   std::string CanonicalizePackageURL(std::string url);
   std::string CanonicalizeFileURL(std::string url);
+  std::string CanonicalizeRelativeURL(const std::string& library_url,
+                                      const std::string& url);
 
   base::FilePath package_root_;
 
@@ -5,61 +5,200 @@
 #include "sky/shell/dart/dart_library_provider_network.h"
 
 #include "base/bind.h"
+#include "base/logging.h"
+#include "base/macros.h"
 #include "base/strings/string_util.h"
+#include "base/task_runner_util.h"
+#include "base/threading/worker_pool.h"
+#include "mojo/data_pipe_utils/data_pipe_utils.h"
 #include "sky/engine/tonic/dart_converter.h"
+#include "sky/shell/dart/dart_library_cache.h"
 #include "url/gurl.h"
 
 namespace sky {
 namespace shell {
 namespace {
 
-mojo::URLLoaderPtr Fetch(mojo::NetworkService* network_service,
-                         const std::string& url,
-                         base::Callback<void(mojo::URLResponsePtr)> callback) {
-  mojo::URLLoaderPtr loader;
-  network_service->CreateURLLoader(GetProxy(&loader));
+const uint32_t kOKStatus = 200;
+const uint32_t kNotModifiedStatus = 304;
 
-  mojo::URLRequestPtr request = mojo::URLRequest::New();
-  request->url = url;
-  request->auto_follow_redirects = true;
-  loader->Start(request.Pass(), callback);
+const char kPackagePrefix[] = "package:";
 
-  return loader.Pass();
+// Whether |path| is a relative path that URL canonicalization would leave
+// as it is: segments of unreserved characters, none of them "." or "..".
+bool IsSimpleRelativePath(const std::string& path) {
+  if (path.empty() || path[0] == '/')
+    return false;
+  size_t segment_start = 0;
+  for (size_t i = 0; i <= path.size(); ++i) {
+    if (i == path.size() || path[i] == '/') {
+      const size_t segment_length = i - segment_start;
+      if (!segment_length)
+        return false;
+      if (path[segment_start] == '.' &&
+          (segment_length == 1 ||
+           (segment_length == 2 && path[segment_start + 1] == '.')))
+        return false;
+      segment_start = i + 1;
+      continue;
+    }
+    const char c = path[i];
+    if (!base::IsAsciiAlpha(c) && !base::IsAsciiDigit(c) && c != '-' &&
+        c != '.' && c != '_' && c != '~')
+      return false;
+  }
+  return true;
+}
+
+void AddHeader(const mojo::URLRequestPtr& request,
+               const char* name,
+               const std::string& value) {
+  if (value.empty())
+    return;
+  mojo::HttpHeaderPtr header = mojo::HttpHeader::New();
+  header->name = name;
+  header->value = value;
+  request->headers.push_back(header.Pass());
+}
+
+std::string FindHeader(const mojo::URLResponsePtr& response,
+                       const char* name) {
+  for (size_t i = 0; i < response->headers.size(); ++i) {
+    if (base::LowerCaseEqualsASCII(response->headers[i]->name.get(), name))
+      return response->headers[i]->value;
+  }
+  return std::string();
+}
+
+scoped_refptr<base::TaskRunner> FileTaskRunner() {
+  return base::WorkerPool::GetTaskRunner(true);
+}
+
+void Ignored(bool) {
 }
 
 }  // namespace
 
+// Fetches a library. With a cache, the request carries the validators of the
+// cached copy, which is read instead of the body if the server says that it
+// has not changed or cannot be reached. New bodies are downloaded into the
+// cache before they are handed to the loader.
 class DartLibraryProviderNetwork::Job {
  public:
   Job(DartLibraryProviderNetwork* provider,
       const std::string& name,
       blink::DataPipeConsumerCallback callback)
-      : provider_(provider), callback_(callback), weak_factory_(this) {
-    url_loader_ =
-        Fetch(provider_->network_service(), name,
-              base::Bind(&Job::OnReceivedResponse, weak_factory_.GetWeakPtr()));
+      : provider_(provider),
+        name_(name),
+        callback_(callback),
+        use_cache_(!provider->cache_dir().empty()),
+        weak_factory_(this) {
+    if (!use_cache_) {
+      StartRequest(DartLibraryCache::Entry());
+      return;
+    }
+    base::PostTaskAndReplyWithResult(
+        FileTaskRunner().get(), FROM_HERE,
+        base::Bind(&DartLibraryCache::Find, base::Owned(CreateCache()), name_),
+        base::Bind(&Job::StartRequest, weak_factory_.GetWeakPtr()));
   }
 
  private:
+  DartLibraryCache* CreateCache() const {
+    return new DartLibraryCache(provider_->cache_dir());
+  }
+
+  void StartRequest(const DartLibraryCache::Entry& entry) {
+    entry_ = entry;
+    provider_->network_service()->CreateURLLoader(GetProxy(&url_loader_));
+
+    mojo::URLRequestPtr request = mojo::URLRequest::New();
+    request->url = name_;
+    request->auto_follow_redirects = true;
+    if (!entry_.body_path.empty()) {
+      AddHeader(request, "If-None-Match", entry_.etag);
+      AddHeader(request, "If-Modified-Since", entry_.last_modified);
+    }
+    url_loader_->Start(request.Pass(), base::Bind(&Job::OnReceivedResponse,
+                                                  weak_factory_.GetWeakPtr()));
+  }
+
   void OnReceivedResponse(mojo::URLResponsePtr response) {
-    mojo::ScopedDataPipeConsumerHandle data;
-    if (response->status_code == 200)
-      data = response->body.Pass();
+    const bool cached = !entry_.body_path.empty();
+    if (cached && (response->error ||
+                   response->status_code == kNotModifiedStatus)) {
+      if (response->error) {
+        LOG(WARNING) << "Using the cached copy of " << name_ << ": "
+                     << response->error->description;
+      }
+      ReadBody(entry_.body_path);
+      return;
+    }
+
+    if (response->status_code != kOKStatus) {
+      Finish(mojo::ScopedDataPipeConsumerHandle());
+      return;
+    }
+
+    std::string etag = FindHeader(response, "etag");
+    std::string last_modified = FindHeader(response, "last-modified");
+    if (!use_cache_ || (etag.empty() && last_modified.empty())) {
+      Finish(response->body.Pass());
+      return;
+    }
+    base::FilePath download_path =
+        DartLibraryCache(provider_->cache_dir()).DownloadPath(name_);
+    mojo::common::CopyToFile(
+        response->body.Pass(), download_path, FileTaskRunner().get(),
+        base::Bind(&Job::DidDownload, weak_factory_.GetWeakPtr(), etag,
+                   last_modified));
+  }
+
+  void DidDownload(const std::string& etag,
+                   const std::string& last_modified,
+                   bool success) {
+    if (!success) {
+      // Fetch the library again without the cache rather than fail to load
+      // it.
+      LOG(ERROR) << "Could not cache " << name_;
+      use_cache_ = false;
+      StartRequest(DartLibraryCache::Entry());
+      return;
+    }
+    base::PostTaskAndReplyWithResult(
+        FileTaskRunner().get(), FROM_HERE,
+        base::Bind(&DartLibraryCache::Store, base::Owned(CreateCache()), name_,
+                   etag, last_modified),
+        base::Bind(&Job::ReadBody, weak_factory_.GetWeakPtr()));
+  }
+
+  void ReadBody(const base::FilePath& path) {
+    mojo::DataPipe pipe;
+    mojo::common::CopyFromFile(path, pipe.producer_handle.Pass(), 0,
+                               FileTaskRunner().get(), base::Bind(&Ignored));
+    Finish(pipe.consumer_handle.Pass());
+  }
+
+  void Finish(mojo::ScopedDataPipeConsumerHandle data) {
     callback_.Run(data.Pass());
     provider_->jobs_.remove(this);
     // We're deleted now.
   }
 
   DartLibraryProviderNetwork* provider_;
+  std::string name_;
   blink::DataPipeConsumerCallback callback_;
+  bool use_cache_;
+  DartLibraryCache::Entry entry_;
   mojo::URLLoaderPtr url_loader_;
 
   base::WeakPtrFactory<Job> weak_factory_;
 };
 
 DartLibraryProviderNetwork::DartLibraryProviderNetwork(
-    mojo::NetworkService* network_service)
-    : network_service_(network_service) {
+    mojo::NetworkService* network_service,
+    const base::FilePath& cache_dir)
+    : network_service_(network_service), cache_dir_(cache_dir) {
 }
 
 DartLibraryProviderNetwork::~DartLibraryProviderNetwork() {
@@ -76,12 +215,60 @@ Dart_Handle DartLibraryProviderNetwork::CanonicalizeURL(Dart_Handle library,
   std::string string = blink::StdStringFromDart(url);
   if (base::StartsWithASCII(string, "dart:", true))
     return url;
+  return blink::StdStringToDart(CanonicalizeURLForPrefetch(
+      blink::StdStringFromDart(Dart_LibraryUrl(library)), string));
+}
+
+std::string DartLibraryProviderNetwork::CanonicalizeURLForPrefetch(
+    const std::string& library_url,
+    const std::string& url) {
+  if (base::StartsWithASCII(url, "dart:", true))
+    return std::string();
+  auto key = std::make_pair(library_url, url);
+  auto it = resolved_urls_.find(key);
+  if (it != resolved_urls_.end())
+    return it->second;
+  std::string resolved_url = ResolveURL(library_url, url);
+  resolved_urls_.insert(std::make_pair(key, resolved_url));
+  return resolved_url;
+}
+
+std::string DartLibraryProviderNetwork::ResolveURL(
+    const std::string& library_url,
+    const std::string& url) {
+  const GURL& base_url = LibraryURL(library_url);
+  const bool is_package = base::StartsWithASCII(url, kPackagePrefix, true);
+
+  // Most imports are plain paths that canonicalization would not change, so
+  // they are appended to the library's directory, or to the package root.
+  if (base_url.is_valid() && base_url.IsStandard() && !base_url.has_query() &&
+      !base_url.has_ref()) {
+    if (is_package) {
+      std::string path = url.substr(arraysize(kPackagePrefix) - 1);
+      if (base_url.SchemeIsHTTPOrHTTPS() && !base_url.has_username() &&
+          !base_url.has_password() && IsSimpleRelativePath(path))
+        return base_url.GetOrigin().spec() + "packages/" + path;
+    } else if (IsSimpleRelativePath(url)) {
+      const std::string& spec = base_url.spec();
+      return spec.substr(0, spec.rfind('/') + 1) + url;
+    }
+  }
+
+  std::string string = url;
   // TODO(abarth): The package root should be configurable.
-  if (base::StartsWithASCII(string, "package:", true))
-    base::ReplaceFirstSubstringAfterOffset(&string, 0, "package:", "/packages/");
-  GURL library_url(blink::StdStringFromDart(Dart_LibraryUrl(library)));
-  GURL resolved_url = library_url.Resolve(string);
-  return blink::StdStringToDart(resolved_url.spec());
+  if (is_package)
+    base::ReplaceFirstSubstringAfterOffset(&string, 0, kPackagePrefix,
+                                           "/packages/");
+  return base_url.Resolve(string).spec();
+}
+
+const GURL& DartLibraryProviderNetwork::LibraryURL(
+    const std::string& library_url) {
+  auto it = library_urls_.find(library_url);
+  if (it == library_urls_.end())
+    it = library_urls_.insert(std::make_pair(library_url, GURL(library_url)))
+             .first;
+  return it->second;
 }
 
 }  // namespace shell
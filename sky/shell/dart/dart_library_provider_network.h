@@ -5,32 +5,55 @@
 #ifndef SKY_SHELL_DART_DART_LIBRARY_PROVIDER_NETWORK_H_
 #define SKY_SHELL_DART_DART_LIBRARY_PROVIDER_NETWORK_H_
 
+#include <map>
+#include <string>
+#include <utility>
+
+#include "base/files/file_path.h"
 #include "mojo/services/network/public/interfaces/network_service.mojom.h"
 #include "sky/engine/tonic/dart_library_provider.h"
 #include "sky/engine/wtf/HashSet.h"
 #include "sky/engine/wtf/OwnPtr.h"
+#include "url/gurl.h"
 
 namespace sky {
 namespace shell {
 
 class DartLibraryProviderNetwork : public blink::DartLibraryProvider {
  public:
-  explicit DartLibraryProviderNetwork(mojo::NetworkService* network_service);
+  // Libraries are kept in |cache_dir| and revalidated with the server on
+  // later fetches, unless it is empty.
+  DartLibraryProviderNetwork(mojo::NetworkService* network_service,
+                             const base::FilePath& cache_dir);
   ~DartLibraryProviderNetwork() override;
 
   mojo::NetworkService* network_service() const { return network_service_; }
+  const base::FilePath& cache_dir() const { return cache_dir_; }
 
  protected:
   // |DartLibraryProvider| implementation:
   void GetLibraryAsStream(const std::string& name,
                           blink::DataPipeConsumerCallback callback) override;
   Dart_Handle CanonicalizeURL(Dart_Handle library, Dart_Handle url) override;
+  std::string CanonicalizeURLForPrefetch(const std::string& library_url,
+                                         const std::string& url) override;
 
  private:
   class Job;
 
+  std::string ResolveURL(const std::string& library_url,
+                         const std::string& url);
+  // Every import of a library is resolved against its URL, so it is only
+  // parsed once.
+  const GURL& LibraryURL(const std::string& library_url);
+
   mojo::NetworkService* network_service_;
+  base::FilePath cache_dir_;
   HashSet<OwnPtr<Job>> jobs_;
+  std::map<std::string, GURL> library_urls_;
+  // Imports are resolved once when prefetched and again when Dart asks, and
+  // libraries of a package import the same paths.
+  std::map<std::pair<std::string, std::string>, std::string> resolved_urls_;
 
   DISALLOW_COPY_AND_ASSIGN(DartLibraryProviderNetwork);
 };
@@ -0,0 +1,110 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/dart/script_snapshot_cache.h"
+
+#include "base/files/file_util.h"
+#include "base/logging.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/trace_event/trace_event.h"
+#include "dart/runtime/include/dart_api.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const char kSnapshotExtension[] = ".snapshot";
+const char kSourcesExtension[] = ".sources";
+
+std::string HexDigest(const std::string& data) {
+  std::string digest = base::SHA1HashString(data);
+  return base::HexEncode(digest.data(), digest.size());
+}
+
+// Writes |data| next to |path| and then moves it into place, so that readers
+// never see a partially written file.
+bool WriteFileAtomically(const base::FilePath& path, const std::string& data) {
+  base::FilePath temp_path = path.AddExtension(FILE_PATH_LITERAL(".tmp"));
+  if (base::WriteFile(temp_path, data.data(), data.size()) !=
+      static_cast<int>(data.size())) {
+    base::DeleteFile(temp_path, false);
+    return false;
+  }
+  return base::ReplaceFile(temp_path, path, nullptr);
+}
+
+}  // namespace
+
+ScriptSnapshotCache::ScriptSnapshotCache(const base::FilePath& cache_dir)
+    : cache_dir_(cache_dir) {
+}
+
+ScriptSnapshotCache::~ScriptSnapshotCache() {
+}
+
+base::FilePath ScriptSnapshotCache::Find(const std::string& main) const {
+  TRACE_EVENT0("sky", "ScriptSnapshotCache::Find");
+
+  base::FilePath snapshot_path = EntryPath(main, kSnapshotExtension);
+  std::string sources;
+  if (!base::PathExists(snapshot_path) ||
+      !base::ReadFileToString(EntryPath(main, kSourcesExtension), &sources))
+    return base::FilePath();
+
+  // Each line is the digest of a source followed by its name.
+  std::vector<std::string> lines;
+  base::SplitString(sources, '\n', &lines);
+  for (const std::string& line : lines) {
+    if (line.empty())
+      continue;
+    size_t space = line.find(' ');
+    if (space == std::string::npos)
+      return base::FilePath();
+    std::string contents;
+    base::FilePath source_path(line.substr(space + 1));
+    if (!base::ReadFileToString(source_path, &contents) ||
+        HexDigest(contents) != line.substr(0, space))
+      return base::FilePath();
+  }
+  return snapshot_path;
+}
+
+void ScriptSnapshotCache::Store(
+    const std::string& main,
+    const std::vector<uint8_t>& snapshot,
+    const blink::DartLibraryLoader::SourceDigests& sources) const {
+  TRACE_EVENT0("sky", "ScriptSnapshotCache::Store");
+
+  if (!base::CreateDirectory(cache_dir_)) {
+    LOG(ERROR) << "Could not create " << cache_dir_.AsUTF8Unsafe();
+    return;
+  }
+
+  std::string source_list;
+  for (const auto& source : sources)
+    source_list += source.second + " " + source.first + "\n";
+
+  // The sources are written last so that a snapshot is never paired with the
+  // list of a different one.
+  base::FilePath sources_path = EntryPath(main, kSourcesExtension);
+  base::DeleteFile(sources_path, false);
+  std::string data(reinterpret_cast<const char*>(snapshot.data()),
+                   snapshot.size());
+  if (!WriteFileAtomically(EntryPath(main, kSnapshotExtension), data) ||
+      !WriteFileAtomically(sources_path, source_list)) {
+    LOG(ERROR) << "Could not cache the script snapshot of " << main;
+  }
+}
+
+base::FilePath ScriptSnapshotCache::EntryPath(const std::string& main,
+                                              const char* extension) const {
+  // Snapshots are only readable by the VM that wrote them.
+  std::string key = HexDigest(main + '\n' + Dart_VersionString());
+  return cache_dir_.AppendASCII(key + extension);
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,50 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_DART_SCRIPT_SNAPSHOT_CACHE_H_
+#define SKY_SHELL_DART_SCRIPT_SNAPSHOT_CACHE_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "sky/engine/tonic/dart_library_loader.h"
+
+namespace sky {
+namespace shell {
+
+// ScriptSnapshotCache keeps script snapshots of apps that are run from source
+// files, so that launching an app whose sources have not changed skips
+// parsing them. Each entry is a snapshot next to a list of the sources it was
+// made from and their digests. An entry is only used if every source still
+// has the same digest.
+//
+// The methods do blocking file IO and are meant to run on a worker thread.
+class ScriptSnapshotCache {
+ public:
+  explicit ScriptSnapshotCache(const base::FilePath& cache_dir);
+  ~ScriptSnapshotCache();
+
+  // Returns the path of an up-to-date snapshot of the app whose main library
+  // is |main|, or an empty path if there is none.
+  base::FilePath Find(const std::string& main) const;
+
+  void Store(const std::string& main,
+             const std::vector<uint8_t>& snapshot,
+             const blink::DartLibraryLoader::SourceDigests& sources) const;
+
+ private:
+  base::FilePath EntryPath(const std::string& main,
+                           const char* extension) const;
+
+  base::FilePath cache_dir_;
+
+  DISALLOW_COPY_AND_ASSIGN(ScriptSnapshotCache);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_DART_SCRIPT_SNAPSHOT_CACHE_H_
@@ -0,0 +1,145 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/discardable_memory_allocator.h"
+
+#include "base/logging.h"
+#include "base/memory/discardable_memory.h"
+#include "base/trace_event/trace_event.h"
+
+namespace sky {
+namespace shell {
+
+class DiscardableMemoryAllocator::Memory : public base::DiscardableMemory {
+ public:
+  Memory(DiscardableMemoryAllocator* allocator, size_t size)
+      : allocator_(allocator),
+        size_(size),
+        data_(new uint8_t[size]),
+        locked_(true) {}
+
+  ~Memory() override {
+    base::AutoLock lock(allocator_->lock_);
+    allocator_->DidDestroy(this);
+  }
+
+  // base::DiscardableMemory:
+  bool Lock() override {
+    base::AutoLock lock(allocator_->lock_);
+    DCHECK(!locked_);
+    // Discarded memory stays discarded. The owner throws this object away
+    // and allocates a new one.
+    if (!data_)
+      return false;
+    locked_ = true;
+    allocator_->DidLock(this);
+    return true;
+  }
+
+  void Unlock() override {
+    base::AutoLock lock(allocator_->lock_);
+    DCHECK(locked_);
+    locked_ = false;
+    allocator_->DidUnlock(this);
+  }
+
+  void* data() const override {
+    DCHECK(locked_);
+    return data_.get();
+  }
+
+  size_t size() const { return size_; }
+  bool locked() const { return locked_; }
+  bool discarded() const { return !data_; }
+
+  // Called by the allocator with its lock held.
+  void Discard() {
+    DCHECK(!locked_);
+    data_.reset();
+  }
+
+ private:
+  DiscardableMemoryAllocator* const allocator_;
+  const size_t size_;
+  scoped_ptr<uint8_t[]> data_;
+  bool locked_;
+
+  DISALLOW_COPY_AND_ASSIGN(Memory);
+};
+
+DiscardableMemoryAllocator::DiscardableMemoryAllocator(
+    size_t unlocked_budget_bytes)
+    : unlocked_budget_bytes_(unlocked_budget_bytes), unlocked_bytes_(0) {
+}
+
+DiscardableMemoryAllocator::~DiscardableMemoryAllocator() {
+  DCHECK(unlocked_.empty());
+}
+
+scoped_ptr<base::DiscardableMemory>
+DiscardableMemoryAllocator::AllocateLockedDiscardableMemory(size_t size) {
+  return make_scoped_ptr(new Memory(this, size));
+}
+
+void DiscardableMemoryAllocator::Purge() {
+  TRACE_EVENT0("sky", "DiscardableMemoryAllocator::Purge");
+  base::AutoLock lock(lock_);
+  PurgeUntil(0);
+}
+
+size_t DiscardableMemoryAllocator::unlocked_bytes() const {
+  base::AutoLock lock(lock_);
+  return unlocked_bytes_;
+}
+
+void DiscardableMemoryAllocator::DidUnlock(Memory* memory) {
+  lock_.AssertAcquired();
+  unlocked_.push_back(memory);
+  unlocked_bytes_ += memory->size();
+  PurgeUntil(unlocked_budget_bytes_);
+}
+
+void DiscardableMemoryAllocator::DidLock(Memory* memory) {
+  lock_.AssertAcquired();
+  unlocked_.remove(memory);
+  unlocked_bytes_ -= memory->size();
+}
+
+void DiscardableMemoryAllocator::DidDestroy(Memory* memory) {
+  lock_.AssertAcquired();
+  if (memory->locked() || memory->discarded())
+    return;
+  unlocked_.remove(memory);
+  unlocked_bytes_ -= memory->size();
+}
+
+void DiscardableMemoryAllocator::PurgeUntil(size_t target_bytes) {
+  lock_.AssertAcquired();
+  while (unlocked_bytes_ > target_bytes && !unlocked_.empty()) {
+    Memory* memory = unlocked_.front();
+    unlocked_.pop_front();
+    unlocked_bytes_ -= memory->size();
+    memory->Discard();
+  }
+}
+
+size_t DiscardableMemoryAllocator::OnMemoryPressure(
+    MemoryPressureCoordinator::Level level) {
+  base::AutoLock lock(lock_);
+  const size_t unlocked_bytes = unlocked_bytes_;
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE:
+      PurgeUntil(unlocked_bytes_ / 2);
+      break;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL:
+      PurgeUntil(0);
+      break;
+  }
+  return unlocked_bytes - unlocked_bytes_;
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,73 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_DISCARDABLE_MEMORY_ALLOCATOR_H_
+#define SKY_SHELL_DISCARDABLE_MEMORY_ALLOCATOR_H_
+
+#include <stddef.h>
+
+#include <list>
+
+#include "base/macros.h"
+#include "base/memory/discardable_memory_allocator.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "sky/shell/memory_pressure_coordinator.h"
+
+namespace sky {
+namespace shell {
+
+// Hands out heap memory that is freed while it is unlocked, either when the
+// unlocked memory goes over a budget or when the system is short of memory.
+// Sky runs in a single process, so there is no system-wide discardable
+// memory manager to defer to. Skia keeps lazily decoded images in this
+// memory and decodes them again when it finds them discarded.
+//
+// Memory is locked and unlocked on whichever thread draws it, so all of the
+// bookkeeping is behind a lock.
+class DiscardableMemoryAllocator : public base::DiscardableMemoryAllocator,
+                                   public MemoryPressureCoordinator::Client {
+ public:
+  explicit DiscardableMemoryAllocator(size_t unlocked_budget_bytes);
+  ~DiscardableMemoryAllocator() override;
+
+  // base::DiscardableMemoryAllocator:
+  scoped_ptr<base::DiscardableMemory> AllocateLockedDiscardableMemory(
+      size_t size) override;
+
+  // Frees all unlocked memory.
+  void Purge();
+
+  size_t unlocked_bytes() const;
+
+  // MemoryPressureCoordinator::Client:
+  size_t OnMemoryPressure(MemoryPressureCoordinator::Level level) override;
+
+ private:
+  class Memory;
+  friend class Memory;
+
+  // These are called by Memory with |lock_| held.
+  void DidUnlock(Memory* memory);
+  void DidLock(Memory* memory);
+  void DidDestroy(Memory* memory);
+
+  // Frees the least recently unlocked memory until no more than
+  // |target_bytes| remain unlocked. |lock_| has to be held.
+  void PurgeUntil(size_t target_bytes);
+
+  const size_t unlocked_budget_bytes_;
+
+  mutable base::Lock lock_;
+  // Least recently unlocked first.
+  std::list<Memory*> unlocked_;
+  size_t unlocked_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(DiscardableMemoryAllocator);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_DISCARDABLE_MEMORY_ALLOCATOR_H_
@@ -5,6 +5,8 @@
 #include "sky/shell/gpu/ganesh_context.h"
 
 #include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "sky/shell/gpu/program_binary_cache.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
 #include "ui/gl/gl_bindings_skia_in_process.h"
 
@@ -16,28 +18,58 @@ namespace {
 // GPU cache.
 const int kMaxGaneshResourceCacheCount = 2048;
 
-// The limit of the bytes allocated toward GPU resources in the GrContext's
-// GPU cache.
-const size_t kMaxGaneshResourceCacheBytes = 96 * 1024 * 1024;
+const char kNVPathRenderingExtension[] = "GL_NV_path_rendering";
 
 }  // namespace
 
-GaneshContext::GaneshContext(scoped_refptr<gfx::GLContext> gl_context)
+const size_t GaneshContext::kDefaultResourceCacheBytes = 96 * 1024 * 1024;
+
+GaneshContext::GaneshContext(scoped_refptr<gfx::GLContext> gl_context,
+                             size_t resource_cache_bytes,
+                             bool count_gl_calls,
+                             bool nv_path_rendering)
     : gl_context_(gl_context) {
   skia::RefPtr<const GrGLInterface> interface =
-      skia::AdoptRef(gfx::CreateInProcessSkiaGLBinding());
+      skia::AdoptRef(count_gl_calls
+                         ? gfx::CreateCountingInProcessSkiaGLBinding()
+                         : gfx::CreateInProcessSkiaGLBinding());
   DCHECK(interface);
 
+  if (ProgramBinaryCache* program_cache = ProgramBinaryCache::Shared()) {
+    GrGLInterface* cached = GrGLInterface::NewClone(interface.get());
+    program_cache->Install(&cached->fFunctions);
+    interface = skia::AdoptRef(static_cast<const GrGLInterface*>(cached));
+  }
+
+  if (!nv_path_rendering &&
+      interface->hasExtension(kNVPathRenderingExtension)) {
+    GrGLInterface* without = GrGLInterface::NewClone(interface.get());
+    without->fExtensions.remove(kNVPathRenderingExtension);
+    interface = skia::AdoptRef(static_cast<const GrGLInterface*>(without));
+  }
+
   gr_context_ = skia::AdoptRef(GrContext::Create(
       kOpenGL_GrBackend, reinterpret_cast<GrBackendContext>(interface.get())));
   DCHECK(gr_context_) << "Failed to create GrContext.";
   gr_context_->setResourceCacheLimits(kMaxGaneshResourceCacheCount,
-                                      kMaxGaneshResourceCacheBytes);
+                                      resource_cache_bytes);
 }
 
 GaneshContext::~GaneshContext() {
   gr_context_->abandonContext();
 }
 
+void GaneshContext::PurgeResources() {
+  TRACE_EVENT0("sky", "GaneshContext::PurgeResources");
+  gr_context_->freeGpuResources();
+}
+
+size_t GaneshContext::GetResourceCacheBytes() const {
+  int resource_count = 0;
+  size_t resource_bytes = 0;
+  gr_context_->getResourceCacheUsage(&resource_count, &resource_bytes);
+  return resource_bytes;
+}
+
 }  // namespace shell
 }  // namespace sky
@@ -19,11 +19,28 @@ namespace shell {
 // gfx::GLContext.
 class GaneshContext {
  public:
-  explicit GaneshContext(scoped_refptr<gfx::GLContext> gl_context);
+  // The number of bytes the GrContext keeps cached for reuse by default.
+  static const size_t kDefaultResourceCacheBytes;
+
+  // With |count_gl_calls| the GL calls Ganesh makes are counted, see
+  // gfx::TakeSkiaGLCallCounts(). Without |nv_path_rendering| Ganesh does
+  // not see NV_path_rendering, even if the driver has it.
+  GaneshContext(scoped_refptr<gfx::GLContext> gl_context,
+                size_t resource_cache_bytes,
+                bool count_gl_calls,
+                bool nv_path_rendering);
   ~GaneshContext();
 
   GrContext* gr() const { return gr_context_.get(); }
 
+  // Frees all GPU resources the GrContext holds on to that are not currently
+  // in use. The GL context must be current.
+  void PurgeResources();
+
+  // The number of bytes of GPU memory currently held by the GrContext's
+  // resource cache.
+  size_t GetResourceCacheBytes() const;
+
  private:
   scoped_refptr<gfx::GLContext> gl_context_;
   skia::RefPtr<GrContext> gr_context_;
@@ -6,6 +6,7 @@
 
 #include "base/logging.h"
 #include "third_party/skia/include/gpu/GrContext.h"
+#include "ui/gl/gl_bindings.h"
 
 namespace sky {
 namespace shell {
@@ -13,11 +14,22 @@ namespace shell {
 GaneshSurface::GaneshSurface(intptr_t window_fbo,
               GaneshContext* context,
               const gfx::Size& size) {
+  // The window's config may have more samples or stencil bits than were
+  // asked for, and Ganesh has to know how many there are.
+  GLint sample_count = 0;
+  GLint stencil_bits = 0;
+  glBindFramebufferEXT(GL_FRAMEBUFFER, window_fbo);
+  glGetIntegerv(GL_SAMPLES, &sample_count);
+  glGetIntegerv(GL_STENCIL_BITS, &stencil_bits);
+  context->gr()->resetContext();
+
   GrBackendRenderTargetDesc desc;
   desc.fWidth = size.width();
   desc.fHeight = size.height();
   desc.fConfig = kSkia8888_GrPixelConfig;
   desc.fOrigin = kBottomLeft_GrSurfaceOrigin;
+  desc.fSampleCnt = sample_count;
+  desc.fStencilBits = stencil_bits;
   desc.fRenderTargetHandle = window_fbo;
 
   skia::RefPtr<GrRenderTarget> target = skia::AdoptRef(
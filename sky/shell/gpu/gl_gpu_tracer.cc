@@ -0,0 +1,151 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/gpu/gl_gpu_tracer.h"
+
+#include "base/logging.h"
+#include "base/stl_util.h"
+#include "base/trace_event/trace_event.h"
+#include "sky/compositor/paint_context.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "ui/gl/gl_context.h"
+#include "ui/gl/gpu_timing.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Spans that are still not done after this many frames are dropped, which
+// keeps a stalled driver from accumulating queries without bound.
+const size_t kMaxFinishedSpans = 1024;
+
+}  // namespace
+
+GLGPUTracer::Span::Span() : name(nullptr), picture_id(0) {
+}
+
+GLGPUTracer::Span::~Span() {
+}
+
+scoped_ptr<GLGPUTracer> GLGPUTracer::Create(
+    gfx::GLContext* context,
+    GrContext* gr_context,
+    compositor::PaintContext* paint_context) {
+  scoped_refptr<gfx::GPUTimingClient> timing_client =
+      context->CreateGPUTimingClient();
+  if (!timing_client || !timing_client->IsAvailable()) {
+    LOG(WARNING) << "GPU timer queries are not available.";
+    return nullptr;
+  }
+  return make_scoped_ptr(
+      new GLGPUTracer(timing_client, gr_context, paint_context));
+}
+
+GLGPUTracer::GLGPUTracer(scoped_refptr<gfx::GPUTimingClient> timing_client,
+                         GrContext* gr_context,
+                         compositor::PaintContext* paint_context)
+    : timing_client_(timing_client),
+      gr_context_(gr_context),
+      paint_context_(paint_context),
+      can_nest_(timing_client_->IsTimerOffsetAvailable()) {
+  VLOG(1) << "Timing the GPU with " << timing_client_->GetTimerTypeName();
+}
+
+GLGPUTracer::~GLGPUTracer() {
+  for (Span* span : open_spans_)
+    finished_spans_.push_back(span);
+  for (Span* span : finished_spans_) {
+    if (span->timer)
+      span->timer->Destroy(true);
+  }
+  STLDeleteElements(&finished_spans_);
+}
+
+void GLGPUTracer::BeginSpan(const char* name, uint32_t picture_id) {
+  Span* span = new Span();
+  span->name = name;
+  span->picture_id = picture_id;
+
+  // An elapsed time query that is already running would be ended by the
+  // nested one, so spans inside it are not timed.
+  bool nested = !open_spans_.empty();
+  if (can_nest_ || !nested) {
+    // Ganesh batches its draws, so everything recorded before the span has
+    // to reach GL before the query starts.
+    gr_context_->flush();
+    span->timer = timing_client_->CreateGPUTimer();
+    span->timer->Start();
+  }
+  open_spans_.push_back(span);
+}
+
+void GLGPUTracer::EndSpan() {
+  DCHECK(!open_spans_.empty());
+  Span* span = open_spans_.back();
+  open_spans_.pop_back();
+
+  if (span->timer) {
+    gr_context_->flush();
+    span->timer->End();
+  }
+
+  if (finished_spans_.size() >= kMaxFinishedSpans) {
+    Span* oldest = finished_spans_.front();
+    finished_spans_.pop_front();
+    if (oldest->timer)
+      oldest->timer->Destroy(true);
+    delete oldest;
+  }
+  finished_spans_.push_back(span);
+}
+
+void GLGPUTracer::CollectResults() {
+  // A disjoint operation, such as a change of GPU frequency, invalidates
+  // every query that was running at the time.
+  if (timing_client_->CheckAndResetTimerErrors()) {
+    for (Span* span : finished_spans_) {
+      if (span->timer)
+        span->timer->Destroy(true);
+    }
+    STLDeleteElements(&finished_spans_);
+    return;
+  }
+
+  // Queries complete in the order they were issued.
+  while (!finished_spans_.empty()) {
+    Span* span = finished_spans_.front();
+    if (span->timer && !span->timer->IsAvailable())
+      break;
+    finished_spans_.pop_front();
+    if (span->timer) {
+      Report(*span);
+      span->timer->Destroy(true);
+    }
+    delete span;
+  }
+}
+
+void GLGPUTracer::Report(const Span& span) {
+  const int64 elapsed = span.timer->GetDeltaElapsed();
+  if (!span.picture_id) {
+    paint_context_->RecordGPUTime(base::TimeDelta::FromMicroseconds(elapsed));
+    return;
+  }
+
+  TRACE_EVENT_INSTANT2("sky", "LayerGPUTime", TRACE_EVENT_SCOPE_THREAD,
+                       "picture", span.picture_id, "gpu_us", elapsed);
+
+  // Timestamp queries also say when the GPU did the work, which lets the
+  // spans line up with the CPU side of the trace.
+  if (can_nest_) {
+    int64 start = 0;
+    int64 end = 0;
+    span.timer->GetStartEndTimestamps(&start, &end);
+    TRACE_EVENT_ASYNC_BEGIN_WITH_TIMESTAMP0("sky", span.name, &span, start);
+    TRACE_EVENT_ASYNC_END_WITH_TIMESTAMP0("sky", span.name, &span, end);
+  }
+}
+
+}  // namespace shell
+}  // namespace sky
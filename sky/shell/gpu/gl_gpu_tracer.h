@@ -0,0 +1,83 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_GPU_GL_GPU_TRACER_H_
+#define SKY_SHELL_GPU_GL_GPU_TRACER_H_
+
+#include <deque>
+#include <vector>
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "sky/compositor/gpu_tracer.h"
+
+class GrContext;
+
+namespace gfx {
+class GLContext;
+class GPUTimer;
+class GPUTimingClient;
+}
+
+namespace sky {
+namespace compositor {
+class PaintContext;
+}
+
+namespace shell {
+
+// Times spans with GL timer queries. Whole frames are reported to the paint
+// context's instrumentation, spans around single pictures are reported as
+// trace events in the "sky" category.
+//
+// Only used on the GPU thread, with |context| current.
+class GLGPUTracer : public compositor::GPUTracer {
+ public:
+  // Returns null if the context has no timer queries.
+  static scoped_ptr<GLGPUTracer> Create(gfx::GLContext* context,
+                                        GrContext* gr_context,
+                                        compositor::PaintContext* paint_context);
+
+  ~GLGPUTracer() override;
+
+  // Reports the spans the GPU has finished. Called once per frame.
+  void CollectResults();
+
+  // compositor::GPUTracer:
+  void BeginSpan(const char* name, uint32_t picture_id) override;
+  void EndSpan() override;
+
+ private:
+  struct Span {
+    Span();
+    ~Span();
+
+    const char* name;
+    uint32_t picture_id;
+    // Null if the span could not be timed.
+    scoped_ptr<gfx::GPUTimer> timer;
+  };
+
+  GLGPUTracer(scoped_refptr<gfx::GPUTimingClient> timing_client,
+              GrContext* gr_context,
+              compositor::PaintContext* paint_context);
+
+  void Report(const Span& span);
+
+  scoped_refptr<gfx::GPUTimingClient> timing_client_;
+  GrContext* gr_context_;
+  compositor::PaintContext* paint_context_;
+
+  // Timestamp queries can nest, elapsed time queries cannot.
+  const bool can_nest_;
+  std::vector<Span*> open_spans_;
+  std::deque<Span*> finished_spans_;
+
+  DISALLOW_COPY_AND_ASSIGN(GLGPUTracer);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_GPU_GL_GPU_TRACER_H_
@@ -0,0 +1,78 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/gpu/layer_tree_capture.h"
+
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/trace_event/trace_event.h"
+#include "sky/compositor/layer_tree.h"
+#include "sky/shell/switches.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// About a second of animation at 60Hz.
+const int kDefaultCaptureFrameCount = 60;
+
+}  // namespace
+
+scoped_ptr<LayerTreeCapture> LayerTreeCapture::CreateFromCommandLine() {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kCaptureLayerTrees))
+    return nullptr;
+
+  int frame_count = kDefaultCaptureFrameCount;
+  if (command_line.HasSwitch(switches::kCaptureFrameCount) &&
+      (!base::StringToInt(
+           command_line.GetSwitchValueASCII(switches::kCaptureFrameCount),
+           &frame_count) ||
+       frame_count <= 0)) {
+    LOG(ERROR) << "Invalid value for --" << switches::kCaptureFrameCount;
+    frame_count = kDefaultCaptureFrameCount;
+  }
+
+  const base::FilePath path =
+      command_line.GetSwitchValuePath(switches::kCaptureLayerTrees);
+  scoped_ptr<LayerTreeCapture> capture(
+      new LayerTreeCapture(path, frame_count));
+  if (!capture->stream_.isValid()) {
+    LOG(ERROR) << "Could not open " << path.value() << " for writing.";
+    return nullptr;
+  }
+  return capture.Pass();
+}
+
+LayerTreeCapture::LayerTreeCapture(const base::FilePath& path,
+                                   int frame_count)
+    : path_(path),
+      frames_remaining_(frame_count),
+      stream_(path.value().c_str()),
+      writer_(&stream_, &pixel_serializer_) {
+}
+
+LayerTreeCapture::~LayerTreeCapture() {
+  if (frames_remaining_ > 0)
+    writer_.Finish();
+}
+
+bool LayerTreeCapture::Capture(const compositor::LayerTree& layer_tree) {
+  TRACE_EVENT0("sky", "LayerTreeCapture::Capture");
+  if (frames_remaining_ <= 0)
+    return false;
+
+  writer_.WriteTree(layer_tree);
+  if (--frames_remaining_ > 0)
+    return true;
+
+  writer_.Finish();
+  LOG(INFO) << "Captured layer trees to " << path_.value();
+  return false;
+}
+
+}  // namespace shell
+}  // namespace sky
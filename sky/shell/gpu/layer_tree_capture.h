@@ -0,0 +1,51 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_GPU_LAYER_TREE_CAPTURE_H_
+#define SKY_SHELL_GPU_LAYER_TREE_CAPTURE_H_
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "sky/compositor/layer_serialization.h"
+#include "sky/shell/gpu/picture_serializer.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace sky {
+namespace compositor {
+class LayerTree;
+}
+
+namespace shell {
+
+// Writes the layer trees of consecutive frames to a file that sky_replay
+// can rasterize again offline.
+class LayerTreeCapture {
+ public:
+  // Returns null unless --capture-layer-trees names a file that can be
+  // written.
+  static scoped_ptr<LayerTreeCapture> CreateFromCommandLine();
+
+  ~LayerTreeCapture();
+
+  // Records |layer_tree| until enough frames have been captured. Returns
+  // false once the capture is complete.
+  bool Capture(const compositor::LayerTree& layer_tree);
+
+ private:
+  LayerTreeCapture(const base::FilePath& path, int frame_count);
+
+  const base::FilePath path_;
+  int frames_remaining_;
+  SkFILEWStream stream_;
+  PngPixelSerializer pixel_serializer_;
+  compositor::LayerWriter writer_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerTreeCapture);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_GPU_LAYER_TREE_CAPTURE_H_
@@ -0,0 +1,83 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/gpu/layer_tree_transport.h"
+
+#include "base/logging.h"
+#include "base/trace_event/trace_event.h"
+#include "sky/compositor/layer_tree.h"
+
+namespace sky {
+namespace shell {
+
+// Images go uncompressed, since both processes are on the same device and
+// encoding them would cost more than copying them.
+LayerTreeSender::LayerTreeSender()
+    : writer_(&stream_, nullptr), failed_(false) {
+}
+
+LayerTreeSender::~LayerTreeSender() {
+}
+
+mojo::ScopedSharedBufferHandle LayerTreeSender::Send(
+    const compositor::LayerTree& layer_tree,
+    uint64_t* num_bytes) {
+  TRACE_EVENT1("sky", "LayerTreeSender::Send", "frame",
+               layer_tree.frame_number());
+  if (failed_)
+    return mojo::ScopedSharedBufferHandle();
+
+  // Pictures the last frame did not draw are released before the ones this
+  // frame draws for the first time take their indices.
+  writer_.ReleaseUnusedPictures();
+  writer_.WriteTree(layer_tree);
+
+  const size_t size = stream_.bytesWritten();
+  mojo::ScopedSharedBufferHandle buffer;
+  void* data = nullptr;
+  if (CreateSharedBuffer(nullptr, size, &buffer) != MOJO_RESULT_OK ||
+      MapBuffer(buffer.get(), 0, size, &data, MOJO_MAP_BUFFER_FLAG_NONE) !=
+          MOJO_RESULT_OK) {
+    LOG(ERROR) << "Could not create a buffer of " << size << " bytes.";
+    failed_ = true;
+    return mojo::ScopedSharedBufferHandle();
+  }
+  stream_.copyTo(data);
+  UnmapBuffer(data);
+  stream_.reset();
+  *num_bytes = size;
+  return buffer.Pass();
+}
+
+LayerTreeReceiver::LayerTreeReceiver() : reader_(&stream_), failed_(false) {
+}
+
+LayerTreeReceiver::~LayerTreeReceiver() {
+}
+
+scoped_ptr<compositor::LayerTree> LayerTreeReceiver::Receive(
+    mojo::ScopedSharedBufferHandle buffer,
+    uint64_t num_bytes) {
+  TRACE_EVENT0("sky", "LayerTreeReceiver::Receive");
+  if (failed_ || reader_.failed())
+    return nullptr;
+
+  void* data = nullptr;
+  if (MapBuffer(buffer.get(), 0, num_bytes, &data,
+                MOJO_MAP_BUFFER_FLAG_NONE) != MOJO_RESULT_OK) {
+    LOG(ERROR) << "Could not map a layer tree of " << num_bytes << " bytes.";
+    failed_ = true;
+    return nullptr;
+  }
+  // The pictures are copied out as they are read, so the tree doesn't keep
+  // the buffer mapped.
+  stream_.setMemory(data, num_bytes, false);
+  scoped_ptr<compositor::LayerTree> layer_tree = reader_.ReadTree();
+  stream_.setMemory(nullptr, 0, false);
+  UnmapBuffer(data);
+  return layer_tree.Pass();
+}
+
+}  // namespace shell
+}  // namespace sky
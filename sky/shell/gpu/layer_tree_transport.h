@@ -0,0 +1,72 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_GPU_LAYER_TREE_TRANSPORT_H_
+#define SKY_SHELL_GPU_LAYER_TREE_TRANSPORT_H_
+
+#include <stdint.h>
+
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "mojo/public/cpp/system/buffer.h"
+#include "sky/compositor/layer_serialization.h"
+#include "third_party/skia/include/core/SkStream.h"
+
+namespace sky {
+namespace compositor {
+class LayerTree;
+}
+
+namespace shell {
+
+// Serializes the layer trees of consecutive frames into shared buffers, for
+// a compositor in another process that rasterizes the trees of many apps
+// with one GPU context and raster cache. Pictures are sent with the first
+// frame that draws them and released once no frame draws them anymore, so
+// a frame that only moves layers around costs a few hundred bytes.
+//
+// Every frame has to be received, in order, by one LayerTreeReceiver.
+class LayerTreeSender {
+ public:
+  LayerTreeSender();
+  ~LayerTreeSender();
+
+  // Returns an invalid handle if the buffer could not be created. The
+  // receiver can't read later frames without this one, so every later call
+  // fails as well and both ends have to start over.
+  mojo::ScopedSharedBufferHandle Send(const compositor::LayerTree& layer_tree,
+                                      uint64_t* num_bytes);
+
+ private:
+  SkDynamicMemoryWStream stream_;
+  compositor::LayerWriter writer_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerTreeSender);
+};
+
+// Reads back the frames of a LayerTreeSender.
+class LayerTreeReceiver {
+ public:
+  LayerTreeReceiver();
+  ~LayerTreeReceiver();
+
+  // Returns null if the frame is malformed or can't be mapped, after which
+  // every later frame is rejected as well and both ends have to start over.
+  scoped_ptr<compositor::LayerTree> Receive(
+      mojo::ScopedSharedBufferHandle buffer,
+      uint64_t num_bytes);
+
+ private:
+  SkMemoryStream stream_;
+  compositor::LayerReader reader_;
+  bool failed_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerTreeReceiver);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_GPU_LAYER_TREE_TRANSPORT_H_
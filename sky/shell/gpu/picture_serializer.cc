@@ -5,27 +5,27 @@
 #include "sky/shell/gpu/picture_serializer.h"
 
 #include "third_party/skia/include/core/SkData.h"
-#include "third_party/skia/include/core/SkPixelSerializer.h"
 #include "third_party/skia/include/core/SkStream.h"
 #include "ui/gfx/codec/png_codec.h"
 
 namespace sky {
 
-class PngPixelSerializer : public SkPixelSerializer {
- public:
-  bool onUseEncodedData(const void*, size_t) override { return true; }
-  SkData* onEncodePixels(const SkImageInfo& info, const void* pixels,
-      size_t row_bytes) override {
-    std::vector<unsigned char> data;
-
-    SkBitmap bm;
-    if (!bm.installPixels(info, const_cast<void*>(pixels), row_bytes))
-      return nullptr;
-    if (!gfx::PNGCodec::EncodeBGRASkBitmap(bm, false, &data))
-      return nullptr;
-    return SkData::NewWithCopy(&data.front(), data.size());
-  }
-};
+bool PngPixelSerializer::onUseEncodedData(const void*, size_t) {
+  return true;
+}
+
+SkData* PngPixelSerializer::onEncodePixels(const SkImageInfo& info,
+                                           const void* pixels,
+                                           size_t row_bytes) {
+  std::vector<unsigned char> data;
+
+  SkBitmap bm;
+  if (!bm.installPixels(info, const_cast<void*>(pixels), row_bytes))
+    return nullptr;
+  if (!gfx::PNGCodec::EncodeBGRASkBitmap(bm, false, &data))
+    return nullptr;
+  return SkData::NewWithCopy(&data.front(), data.size());
+}
 
 void SerializePicture(const char* file_name, SkPicture* picture) {
   SkFILEWStream stream(file_name);
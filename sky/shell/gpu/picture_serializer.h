@@ -6,9 +6,19 @@
 #define SKY_SHELL_GPU_PICTURE_SERIALIZER_H_
 
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkPixelSerializer.h"
 
 namespace sky {
 
+// Encodes the images in serialized pictures as PNGs.
+class PngPixelSerializer : public SkPixelSerializer {
+ public:
+  bool onUseEncodedData(const void*, size_t) override;
+  SkData* onEncodePixels(const SkImageInfo& info,
+                         const void* pixels,
+                         size_t row_bytes) override;
+};
+
 void SerializePicture(const char* file_name, SkPicture*);
 
 }  // namespace sky
@@ -0,0 +1,492 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/gpu/program_binary_cache.h"
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/files/important_file_writer.h"
+#include "base/logging.h"
+#include "base/pickle.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/trace_event/trace_event.h"
+#include "ui/gl/gl_bindings.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Changed whenever the layout of the file changes.
+const uint32_t kFileVersion = 1;
+
+// Programs linked once the cache holds this much are linked again by every
+// run instead.
+const size_t kMaxBinaryBytes = 8 * 1024 * 1024;
+
+// Ganesh links several programs for a new scene in a row, so the file is
+// written once they are all in rather than after each of them.
+const int kMinSecondsBetweenSaves = 5;
+
+// Never deleted, since GrContexts may use their interface until the end.
+ProgramBinaryCache* g_cache = nullptr;
+
+std::string DriverVersion() {
+  std::string version;
+  const GLenum names[] = {GL_VENDOR, GL_RENDERER, GL_VERSION};
+  for (GLenum name : names) {
+    const char* value = reinterpret_cast<const char*>(glGetString(name));
+    if (value)
+      version += value;
+    version += '\n';
+  }
+  return version;
+}
+
+void WriteCacheFile(const base::FilePath& path, const std::string& data) {
+  TRACE_EVENT1("sky", "ProgramBinaryCache::Write", "bytes", data.size());
+  if (!base::CreateDirectory(path.DirName()) ||
+      !base::ImportantFileWriter::WriteFileAtomically(path, data)) {
+    LOG(ERROR) << "Could not write " << path.AsUTF8Unsafe();
+  }
+}
+
+}  // namespace
+
+ProgramBinaryCache::Shader::Shader() : compile_pending(false) {
+}
+
+// static
+void ProgramBinaryCache::Initialize(
+    const base::FilePath& path,
+    scoped_refptr<base::TaskRunner> file_task_runner) {
+  static bool initialized = false;
+  if (initialized)
+    return;
+  initialized = true;
+
+  if (!gfx::g_driver_gl.fn.glProgramBinaryFn ||
+      !gfx::g_driver_gl.fn.glGetProgramBinaryFn)
+    return;
+  // Drivers with the entry points may still support no formats at all.
+  GLint format_count = 0;
+  glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_OES, &format_count);
+  if (format_count <= 0)
+    return;
+
+  g_cache = new ProgramBinaryCache(path, DriverVersion(), file_task_runner);
+  g_cache->Load();
+}
+
+// static
+ProgramBinaryCache* ProgramBinaryCache::Shared() {
+  return g_cache;
+}
+
+ProgramBinaryCache::ProgramBinaryCache(
+    const base::FilePath& path,
+    const std::string& driver_version,
+    scoped_refptr<base::TaskRunner> file_task_runner)
+    : path_(path),
+      driver_version_(driver_version),
+      file_task_runner_(file_task_runner),
+      has_native_(false),
+      binary_bytes_(0),
+      dirty_(false) {
+}
+
+ProgramBinaryCache::~ProgramBinaryCache() {
+}
+
+void ProgramBinaryCache::Install(GrGLInterface::Functions* functions) {
+  {
+    // Every context gets the same native entry points, which calls on other
+    // threads may already be reading.
+    base::AutoLock lock(lock_);
+    if (!has_native_) {
+      native_ = *functions;
+      has_native_ = true;
+    }
+  }
+  functions->fShaderSource = &CallShaderSource;
+  functions->fCompileShader = &CallCompileShader;
+  functions->fGetShaderiv = &CallGetShaderiv;
+  functions->fGetShaderInfoLog = &CallGetShaderInfoLog;
+  functions->fDeleteShader = &CallDeleteShader;
+  functions->fAttachShader = &CallAttachShader;
+  functions->fBindAttribLocation = &CallBindAttribLocation;
+  if (functions->fBindFragDataLocation)
+    functions->fBindFragDataLocation = &CallBindFragDataLocation;
+  functions->fLinkProgram = &CallLinkProgram;
+  functions->fDeleteProgram = &CallDeleteProgram;
+}
+
+void ProgramBinaryCache::SaveIfNeeded() {
+  base::TimeTicks now = base::TimeTicks::Now();
+  std::string data;
+  {
+    base::AutoLock lock(lock_);
+    if (!dirty_ ||
+        now - last_save_ < base::TimeDelta::FromSeconds(kMinSecondsBetweenSaves))
+      return;
+    dirty_ = false;
+    last_save_ = now;
+    data = Serialize();
+  }
+  file_task_runner_->PostTask(FROM_HERE,
+                              base::Bind(&WriteCacheFile, path_, data));
+}
+
+void ProgramBinaryCache::Load() {
+  TRACE_EVENT0("sky", "ProgramBinaryCache::Load");
+  std::string data;
+  if (!base::ReadFileToString(path_, &data))
+    return;
+
+  base::Pickle pickle(data.data(), data.size());
+  base::PickleIterator it(pickle);
+  uint32_t version = 0;
+  std::string driver_version;
+  // A file from another driver is replaced by the next save.
+  if (!it.ReadUInt32(&version) || version != kFileVersion ||
+      !it.ReadString(&driver_version) || driver_version != driver_version_)
+    return;
+
+  base::AutoLock lock(lock_);
+  int shader_count = 0;
+  if (!it.ReadInt(&shader_count))
+    return;
+  for (int i = 0; i < shader_count; ++i) {
+    std::string digest;
+    if (!it.ReadString(&digest))
+      return;
+    compiled_shaders_.insert(digest);
+  }
+
+  int binary_count = 0;
+  if (!it.ReadInt(&binary_count))
+    return;
+  for (int i = 0; i < binary_count; ++i) {
+    std::string key;
+    uint32_t format = 0;
+    const char* bytes = nullptr;
+    int length = 0;
+    if (!it.ReadString(&key) || !it.ReadUInt32(&format) ||
+        !it.ReadData(&bytes, &length))
+      return;
+    Binary& binary = binaries_[key];
+    binary.format = format;
+    binary.data.assign(bytes, length);
+    binary_bytes_ += length;
+  }
+}
+
+std::string ProgramBinaryCache::Serialize() const {
+  base::Pickle pickle;
+  pickle.WriteUInt32(kFileVersion);
+  pickle.WriteString(driver_version_);
+  pickle.WriteInt(compiled_shaders_.size());
+  for (const std::string& digest : compiled_shaders_)
+    pickle.WriteString(digest);
+  pickle.WriteInt(binaries_.size());
+  for (const auto& entry : binaries_) {
+    pickle.WriteString(entry.first);
+    pickle.WriteUInt32(entry.second.format);
+    pickle.WriteData(entry.second.data.data(), entry.second.data.size());
+  }
+  return std::string(static_cast<const char*>(pickle.data()), pickle.size());
+}
+
+std::string ProgramBinaryCache::ProgramKey(GrGLuint program) const {
+  auto program_it = programs_.find(program);
+  if (program_it == programs_.end())
+    return std::string();
+  std::string key;
+  for (GrGLuint shader : program_it->second.shaders) {
+    auto shader_it = shaders_.find(shader);
+    if (shader_it == shaders_.end())
+      return std::string();
+    key += shader_it->second.digest;
+  }
+  key += program_it->second.bindings;
+  return base::SHA1HashString(key);
+}
+
+void ProgramBinaryCache::CompileIfPending(GrGLuint shader) {
+  {
+    base::AutoLock lock(lock_);
+    auto it = shaders_.find(shader);
+    if (it == shaders_.end() || !it->second.compile_pending)
+      return;
+    it->second.compile_pending = false;
+  }
+  native_.fCompileShader(shader);
+}
+
+void ProgramBinaryCache::CompilePendingShaders(GrGLuint program) {
+  std::vector<GrGLuint> pending;
+  {
+    base::AutoLock lock(lock_);
+    auto program_it = programs_.find(program);
+    if (program_it == programs_.end())
+      return;
+    for (GrGLuint shader : program_it->second.shaders) {
+      auto shader_it = shaders_.find(shader);
+      if (shader_it != shaders_.end() && shader_it->second.compile_pending) {
+        shader_it->second.compile_pending = false;
+        pending.push_back(shader);
+      }
+    }
+  }
+  for (GrGLuint shader : pending)
+    native_.fCompileShader(shader);
+}
+
+void ProgramBinaryCache::StoreBinary(GrGLuint program,
+                                     const std::string& key) {
+  GrGLint length = 0;
+  native_.fGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH_OES, &length);
+  if (length <= 0)
+    return;
+
+  Binary binary;
+  binary.format = 0;
+  binary.data.resize(length);
+  GLsizei written = 0;
+  gfx::g_driver_gl.fn.glGetProgramBinaryFn(program, length, &written,
+                                           &binary.format, &binary.data[0]);
+  if (written <= 0)
+    return;
+  binary.data.resize(written);
+
+  base::AutoLock lock(lock_);
+  auto program_it = programs_.find(program);
+  if (program_it != programs_.end()) {
+    for (GrGLuint shader : program_it->second.shaders) {
+      auto shader_it = shaders_.find(shader);
+      if (shader_it != shaders_.end())
+        compiled_shaders_.insert(shader_it->second.digest);
+    }
+  }
+  if (binary_bytes_ + binary.data.size() > kMaxBinaryBytes)
+    return;
+  binary_bytes_ += binary.data.size();
+  binaries_[key] = binary;
+  dirty_ = true;
+}
+
+void ProgramBinaryCache::DidSetShaderSource(GrGLuint shader,
+                                            const std::string& source) {
+  std::string digest = base::SHA1HashString(source);
+  base::AutoLock lock(lock_);
+  Shader& entry = shaders_[shader];
+  entry.digest = digest;
+  entry.compile_pending = false;
+}
+
+void ProgramBinaryCache::CompileShader(GrGLuint shader) {
+  {
+    base::AutoLock lock(lock_);
+    auto it = shaders_.find(shader);
+    if (it != shaders_.end()) {
+      it->second.compile_pending = true;
+      return;
+    }
+  }
+  native_.fCompileShader(shader);
+}
+
+void ProgramBinaryCache::GetShaderiv(GrGLuint shader,
+                                     GrGLenum pname,
+                                     GrGLint* params) {
+  if (pname == GL_COMPILE_STATUS) {
+    base::AutoLock lock(lock_);
+    auto it = shaders_.find(shader);
+    if (it != shaders_.end() && it->second.compile_pending &&
+        compiled_shaders_.count(it->second.digest)) {
+      *params = GL_TRUE;
+      return;
+    }
+  }
+  CompileIfPending(shader);
+  native_.fGetShaderiv(shader, pname, params);
+}
+
+void ProgramBinaryCache::GetShaderInfoLog(GrGLuint shader,
+                                          GrGLsizei bufsize,
+                                          GrGLsizei* length,
+                                          char* infolog) {
+  CompileIfPending(shader);
+  native_.fGetShaderInfoLog(shader, bufsize, length, infolog);
+}
+
+void ProgramBinaryCache::DeleteShader(GrGLuint shader) {
+  {
+    base::AutoLock lock(lock_);
+    shaders_.erase(shader);
+  }
+  native_.fDeleteShader(shader);
+}
+
+void ProgramBinaryCache::AttachShader(GrGLuint program, GrGLuint shader) {
+  {
+    base::AutoLock lock(lock_);
+    programs_[program].shaders.push_back(shader);
+  }
+  native_.fAttachShader(program, shader);
+}
+
+void ProgramBinaryCache::BindLocation(GrGLuint program,
+                                      char kind,
+                                      GrGLuint index,
+                                      const char* name) {
+  base::AutoLock lock(lock_);
+  std::string& bindings = programs_[program].bindings;
+  bindings += kind;
+  bindings += base::UintToString(index);
+  bindings += ' ';
+  bindings += name;
+  bindings += '\n';
+}
+
+void ProgramBinaryCache::LinkProgram(GrGLuint program) {
+  TRACE_EVENT0("sky", "ProgramBinaryCache::LinkProgram");
+  std::string key;
+  Binary binary;
+  bool found = false;
+  {
+    base::AutoLock lock(lock_);
+    key = ProgramKey(program);
+    auto it = key.empty() ? binaries_.end() : binaries_.find(key);
+    if (it != binaries_.end()) {
+      binary = it->second;
+      found = true;
+    }
+  }
+
+  GrGLint linked = GL_FALSE;
+  if (found) {
+    gfx::g_driver_gl.fn.glProgramBinaryFn(program, binary.format,
+                                          binary.data.data(),
+                                          binary.data.size());
+    native_.fGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (linked) {
+      base::AutoLock lock(lock_);
+      programs_.erase(program);
+      return;
+    }
+    // Drivers may turn binaries down after an update that kept their
+    // version, so the program is linked from its shaders after all.
+    base::AutoLock lock(lock_);
+    binary_bytes_ -= binaries_[key].data.size();
+    binaries_.erase(key);
+    dirty_ = true;
+  }
+
+  CompilePendingShaders(program);
+  if (!key.empty() && gfx::g_driver_gl.fn.glProgramParameteriFn) {
+    gfx::g_driver_gl.fn.glProgramParameteriFn(
+        program, PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+  }
+  native_.fLinkProgram(program);
+  native_.fGetProgramiv(program, GL_LINK_STATUS, &linked);
+  if (linked && !key.empty())
+    StoreBinary(program, key);
+
+  base::AutoLock lock(lock_);
+  programs_.erase(program);
+}
+
+void ProgramBinaryCache::DeleteProgram(GrGLuint program) {
+  {
+    base::AutoLock lock(lock_);
+    programs_.erase(program);
+  }
+  native_.fDeleteProgram(program);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallShaderSource(GrGLuint shader,
+                                     GrGLsizei count,
+                                     const char* const* str,
+                                     const GrGLint* length) {
+  g_cache->native_.fShaderSource(shader, count, str, length);
+  std::string source;
+  for (GrGLsizei i = 0; i < count; ++i) {
+    if (length && length[i] >= 0)
+      source.append(str[i], length[i]);
+    else
+      source.append(str[i]);
+  }
+  g_cache->DidSetShaderSource(shader, source);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallCompileShader(GrGLuint shader) {
+  g_cache->CompileShader(shader);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallGetShaderiv(GrGLuint shader,
+                                    GrGLenum pname,
+                                    GrGLint* params) {
+  g_cache->GetShaderiv(shader, pname, params);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallGetShaderInfoLog(GrGLuint shader,
+                                         GrGLsizei bufsize,
+                                         GrGLsizei* length,
+                                         char* infolog) {
+  g_cache->GetShaderInfoLog(shader, bufsize, length, infolog);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallDeleteShader(GrGLuint shader) {
+  g_cache->DeleteShader(shader);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallAttachShader(GrGLuint program, GrGLuint shader) {
+  g_cache->AttachShader(program, shader);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallBindAttribLocation(GrGLuint program,
+                                           GrGLuint index,
+                                           const char* name) {
+  g_cache->BindLocation(program, 'a', index, name);
+  g_cache->native_.fBindAttribLocation(program, index, name);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallBindFragDataLocation(GrGLuint program,
+                                             GrGLuint color_number,
+                                             const char* name) {
+  g_cache->BindLocation(program, 'f', color_number, name);
+  g_cache->native_.fBindFragDataLocation(program, color_number, name);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallLinkProgram(GrGLuint program) {
+  g_cache->LinkProgram(program);
+}
+
+// static
+GrGLvoid GR_GL_FUNCTION_TYPE
+ProgramBinaryCache::CallDeleteProgram(GrGLuint program) {
+  g_cache->DeleteProgram(program);
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,162 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_GPU_PROGRAM_BINARY_CACHE_H_
+#define SKY_SHELL_GPU_PROGRAM_BINARY_CACHE_H_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner.h"
+#include "base/time/time.h"
+#include "third_party/skia/include/gpu/gl/GrGLInterface.h"
+
+namespace sky {
+namespace shell {
+
+// Keeps the programs the GL driver links for Ganesh in a file, so that later
+// runs load them with glProgramBinary instead of compiling and linking them
+// again in the middle of a frame. The file only holds binaries of the driver
+// that wrote it.
+//
+// Ganesh compiles shaders as soon as it has their source. The cache puts
+// compiling off until a program that needs the shaders is linked, and does
+// not compile them at all when the program's binary is in the cache. Shaders
+// that compiled before report that they compiled without being compiled.
+//
+// Programs and shaders belong to the share group, and raster workers link
+// them on their own threads, so the bookkeeping is behind a lock.
+class ProgramBinaryCache {
+ public:
+  // Reads the binaries |path| holds for the driver of the GL context current
+  // on the calling thread, and writes them back on |file_task_runner|. Does
+  // nothing if the driver cannot hand out program binaries. Only the first
+  // call does anything.
+  static void Initialize(const base::FilePath& path,
+                         scoped_refptr<base::TaskRunner> file_task_runner);
+
+  // The cache, or null before Initialize() or without driver support.
+  static ProgramBinaryCache* Shared();
+
+  // Routes the shader and program calls of |functions| through the cache.
+  void Install(GrGLInterface::Functions* functions);
+
+  // Writes the file in the background if programs were linked since it was
+  // last written, at most every few seconds.
+  void SaveIfNeeded();
+
+ private:
+  struct Shader {
+    Shader();
+
+    // The SHA-1 of the shader's source.
+    std::string digest;
+    // Set by glCompileShader until the shader is really compiled.
+    bool compile_pending;
+  };
+
+  struct Program {
+    std::vector<GrGLuint> shaders;
+    // The attribute and fragment output locations bound before linking,
+    // which are part of the binary.
+    std::string bindings;
+  };
+
+  struct Binary {
+    GrGLenum format;
+    std::string data;
+  };
+
+  ProgramBinaryCache(const base::FilePath& path,
+                     const std::string& driver_version,
+                     scoped_refptr<base::TaskRunner> file_task_runner);
+  ~ProgramBinaryCache();
+
+  void Load();
+  std::string Serialize() const;
+
+  // The key of |program|'s binary, or an empty string if a shader's source
+  // is unknown. |lock_| has to be held.
+  std::string ProgramKey(GrGLuint program) const;
+  void CompileIfPending(GrGLuint shader);
+  void CompilePendingShaders(GrGLuint program);
+  // Reads back the binary of |program|, which has just been linked.
+  void StoreBinary(GrGLuint program, const std::string& key);
+
+  // The calls Ganesh makes.
+  void DidSetShaderSource(GrGLuint shader, const std::string& source);
+  void CompileShader(GrGLuint shader);
+  void GetShaderiv(GrGLuint shader, GrGLenum pname, GrGLint* params);
+  void GetShaderInfoLog(GrGLuint shader,
+                        GrGLsizei bufsize,
+                        GrGLsizei* length,
+                        char* infolog);
+  void DeleteShader(GrGLuint shader);
+  void AttachShader(GrGLuint program, GrGLuint shader);
+  void BindLocation(GrGLuint program,
+                    char kind,
+                    GrGLuint index,
+                    const char* name);
+  void LinkProgram(GrGLuint program);
+  void DeleteProgram(GrGLuint program);
+
+  // Entry points installed into GrGLInterface::Functions, which forward to
+  // the shared cache.
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallShaderSource(GrGLuint shader,
+                                                       GrGLsizei count,
+                                                       const char* const* str,
+                                                       const GrGLint* length);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallCompileShader(GrGLuint shader);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallGetShaderiv(GrGLuint shader,
+                                                      GrGLenum pname,
+                                                      GrGLint* params);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallGetShaderInfoLog(GrGLuint shader,
+                                                           GrGLsizei bufsize,
+                                                           GrGLsizei* length,
+                                                           char* infolog);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallDeleteShader(GrGLuint shader);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallAttachShader(GrGLuint program,
+                                                       GrGLuint shader);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallBindAttribLocation(GrGLuint program,
+                                                             GrGLuint index,
+                                                             const char* name);
+  static GrGLvoid GR_GL_FUNCTION_TYPE
+  CallBindFragDataLocation(GrGLuint program,
+                           GrGLuint color_number,
+                           const char* name);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallLinkProgram(GrGLuint program);
+  static GrGLvoid GR_GL_FUNCTION_TYPE CallDeleteProgram(GrGLuint program);
+
+  const base::FilePath path_;
+  const std::string driver_version_;
+  scoped_refptr<base::TaskRunner> file_task_runner_;
+
+  // The driver's own entry points, the same for every context.
+  GrGLInterface::Functions native_;
+  bool has_native_;
+
+  mutable base::Lock lock_;
+  std::map<GrGLuint, Shader> shaders_;
+  // Programs that have not been linked yet.
+  std::map<GrGLuint, Program> programs_;
+  // The digests of the shaders that compiled before.
+  std::set<std::string> compiled_shaders_;
+  std::map<std::string, Binary> binaries_;
+  size_t binary_bytes_;
+  bool dirty_;
+  base::TimeTicks last_save_;
+
+  DISALLOW_COPY_AND_ASSIGN(ProgramBinaryCache);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_GPU_PROGRAM_BINARY_CACHE_H_
@@ -0,0 +1,318 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/gpu/raster_worker.h"
+
+#include "base/atomicops.h"
+#include "base/bind.h"
+#include "base/logging.h"
+#include "base/single_thread_task_runner.h"
+#include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
+#include "base/threading/thread.h"
+#include "base/trace_event/trace_event.h"
+#include "skia/ext/refptr.h"
+#include "sky/compositor/checkerboard.h"
+#include "sky/shell/gpu/ganesh_context.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "third_party/skia/include/gpu/GrTexture.h"
+#include "ui/gl/gl_bindings.h"
+#include "ui/gl/gl_context.h"
+#include "ui/gl/gl_share_group.h"
+#include "ui/gl/gl_surface.h"
+
+#include <algorithm>
+
+namespace sky {
+namespace shell {
+namespace {
+
+// The worker renders into textures it does not cache, so its GrContext only
+// needs room for glyph atlases and scratch targets of a single picture.
+const size_t kRasterWorkerResourceCacheBytes = 16 * 1024 * 1024;
+
+// More threads than this mostly contend with each other in the GL driver.
+const int kMaxRasterThreadCount = 2;
+
+void DeleteTexture(GLuint texture_id) {
+  if (texture_id)
+    glDeleteTextures(1, &texture_id);
+}
+
+void ImageReleaseProc(SkImage::ReleaseContext texture_id) {
+  DeleteTexture(static_cast<GLuint>(reinterpret_cast<uintptr_t>(texture_id)));
+}
+
+}  // namespace
+
+class RasterWorker::RasterJob : public compositor::BackgroundRasterizer::Job {
+ public:
+  RasterJob(PassRefPtr<SkPicture> picture,
+            const SkMatrix& matrix,
+            const SkIRect& device_bounds,
+            bool checkerboard)
+      : picture_(picture),
+        matrix_(matrix),
+        device_bounds_(device_bounds),
+        checkerboard_(checkerboard),
+        texture_id_(0),
+        ready_(0) {}
+
+  // The last reference to a job is dropped either on the worker thread or on
+  // the painting thread while it is painting, so a context in the share
+  // group is current.
+  ~RasterJob() override { DeleteTexture(texture_id_); }
+
+  bool IsReady() const override {
+    return base::subtle::Acquire_Load(&ready_) != 0;
+  }
+
+  RefPtr<SkImage> TakeImage(GrContext* gr_context) override {
+    DCHECK(IsReady());
+    if (!texture_id_)
+      return nullptr;
+
+    RefPtr<SkImage> image = adoptRef(SkImage::NewFromTexture(
+        gr_context, TextureDesc(texture_id_), kPremul_SkAlphaType,
+        &ImageReleaseProc,
+        reinterpret_cast<SkImage::ReleaseContext>(
+            static_cast<uintptr_t>(texture_id_))));
+    // On failure the release proc is not called and the texture is deleted
+    // along with the job.
+    if (image)
+      texture_id_ = 0;
+    return image;
+  }
+
+  // Called on the worker thread with its context current.
+  void Rasterize(GrContext* gr_context) {
+    GLuint texture_id = 0;
+    glGenTextures(1, &texture_id);
+    glBindTexture(GL_TEXTURE_2D, texture_id);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, device_bounds_.width(),
+                 device_bounds_.height(), 0, GL_RGBA, GL_UNSIGNED_BYTE,
+                 nullptr);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    // Ganesh caches GL state and has to be told about the calls above.
+    gr_context->resetContext();
+
+    // The texture is wrapped without transferring ownership so that it
+    // outlives the worker's GrContext.
+    skia::RefPtr<GrTexture> texture =
+        skia::AdoptRef(gr_context->textureProvider()->wrapBackendTexture(
+            TextureDesc(texture_id)));
+    if (!texture || !texture->asRenderTarget()) {
+      DeleteTexture(texture_id);
+      return;
+    }
+
+    skia::RefPtr<SkSurface> surface = skia::AdoptRef(
+        SkSurface::NewRenderTargetDirect(texture->asRenderTarget()));
+    if (!surface) {
+      DeleteTexture(texture_id);
+      return;
+    }
+
+    SkCanvas* canvas = surface->getCanvas();
+    canvas->clear(SK_ColorTRANSPARENT);
+    canvas->translate(-device_bounds_.left(), -device_bounds_.top());
+    canvas->concat(matrix_);
+    canvas->drawPicture(picture_.get());
+
+    if (checkerboard_) {
+      canvas->resetMatrix();
+      compositor::DrawCheckerboard(canvas, device_bounds_.width(),
+                                   device_bounds_.height());
+    }
+
+    canvas->flush();
+
+    // ui/gl has no fence primitive, so wait for the GPU to be done with the
+    // texture before handing it to the painting thread's context.
+    glFinish();
+
+    texture_id_ = texture_id;
+    picture_ = nullptr;
+  }
+
+  // Called on the worker thread once the job is done, whether it succeeded
+  // or not.
+  void MarkReady() { base::subtle::Release_Store(&ready_, 1); }
+
+ private:
+  RefPtr<SkPicture> picture_;
+  const SkMatrix matrix_;
+  const SkIRect device_bounds_;
+  const bool checkerboard_;
+  // Written on the worker thread before |ready_| is set, and only accessed on
+  // the painting thread afterwards.
+  GLuint texture_id_;
+  base::subtle::Atomic32 ready_;
+
+  GrBackendTextureDesc TextureDesc(GLuint texture_id) const {
+    GrBackendTextureDesc desc;
+    desc.fFlags = kRenderTarget_GrBackendTextureFlag;
+    desc.fOrigin = kTopLeft_GrSurfaceOrigin;
+    desc.fWidth = device_bounds_.width();
+    desc.fHeight = device_bounds_.height();
+    desc.fConfig = kRGBA_8888_GrPixelConfig;
+    desc.fSampleCnt = 0;
+    desc.fTextureHandle = texture_id;
+    return desc;
+  }
+
+  DISALLOW_COPY_AND_ASSIGN(RasterJob);
+};
+
+// A thread with its own GL context in the painting context's share group.
+class RasterWorker::WorkerThread {
+ public:
+  WorkerThread(gfx::GLShareGroup* share_group, const std::string& name)
+      : share_group_(share_group), thread_(name), pending_jobs_(0) {
+    CHECK(thread_.Start());
+  }
+
+  ~WorkerThread() {
+    thread_.task_runner()->PostTask(
+        FROM_HERE,
+        base::Bind(&WorkerThread::Shutdown, base::Unretained(this)));
+    thread_.Stop();
+  }
+
+  int pending_jobs() const {
+    return base::subtle::NoBarrier_Load(&pending_jobs_);
+  }
+
+  void Rasterize(std::shared_ptr<RasterJob> job) {
+    base::subtle::NoBarrier_AtomicIncrement(&pending_jobs_, 1);
+    thread_.task_runner()->PostTask(
+        FROM_HERE, base::Bind(&WorkerThread::RasterizeOnThread,
+                              base::Unretained(this), job));
+  }
+
+  void PurgeResources() {
+    thread_.task_runner()->PostTask(
+        FROM_HERE, base::Bind(&WorkerThread::PurgeResourcesOnThread,
+                              base::Unretained(this)));
+  }
+
+ private:
+  // These are only called on |thread_|.
+  bool EnsureGLContext() {
+    if (context_)
+      return true;
+
+    surface_ = gfx::GLSurface::CreateOffscreenGLSurface(
+        gfx::Size(1, 1), gfx::SurfaceConfiguration());
+    if (!surface_) {
+      LOG(ERROR) << "Could not create an offscreen surface for raster work.";
+      return false;
+    }
+
+    context_ = gfx::GLContext::CreateGLContext(
+        share_group_.get(), surface_.get(), gfx::PreferIntegratedGpu);
+    if (!context_ || !context_->MakeCurrent(surface_.get())) {
+      LOG(ERROR) << "Could not create a shared context for raster work.";
+      context_ = nullptr;
+      surface_ = nullptr;
+      return false;
+    }
+
+    ganesh_context_.reset(
+        new GaneshContext(context_.get(), kRasterWorkerResourceCacheBytes,
+                          false, true));
+    return true;
+  }
+
+  void RasterizeOnThread(std::shared_ptr<RasterJob> job) {
+    TRACE_EVENT0("sky", "RasterWorker::RasterizeOnThread");
+
+    // A job that fails is still marked ready so that the painting thread
+    // stops waiting for it and tries again later.
+    if (EnsureGLContext())
+      job->Rasterize(ganesh_context_->gr());
+
+    job->MarkReady();
+    base::subtle::NoBarrier_AtomicIncrement(&pending_jobs_, -1);
+  }
+
+  void PurgeResourcesOnThread() {
+    if (!context_)
+      return;
+    CHECK(context_->MakeCurrent(surface_.get()));
+    ganesh_context_->PurgeResources();
+  }
+
+  void Shutdown() {
+    if (!context_)
+      return;
+    CHECK(context_->MakeCurrent(surface_.get()));
+    ganesh_context_.reset();
+    context_ = nullptr;
+    surface_ = nullptr;
+  }
+
+  scoped_refptr<gfx::GLShareGroup> share_group_;
+  base::Thread thread_;
+  base::subtle::Atomic32 pending_jobs_;
+
+  // Only accessed on |thread_|.
+  scoped_refptr<gfx::GLSurface> surface_;
+  scoped_refptr<gfx::GLContext> context_;
+  scoped_ptr<GaneshContext> ganesh_context_;
+
+  DISALLOW_COPY_AND_ASSIGN(WorkerThread);
+};
+
+RasterWorker::RasterWorker(gfx::GLShareGroup* share_group, int thread_count) {
+  DCHECK_GT(thread_count, 0);
+  for (int i = 0; i < thread_count; ++i) {
+    threads_.push_back(new WorkerThread(
+        share_group, base::StringPrintf("raster_worker_%d", i + 1)));
+  }
+}
+
+RasterWorker::~RasterWorker() {
+}
+
+int RasterWorker::DefaultThreadCount() {
+  // Leave a core each for the UI and GPU threads.
+  return std::max(1, std::min(kMaxRasterThreadCount,
+                              base::SysInfo::NumberOfProcessors() - 2));
+}
+
+std::shared_ptr<compositor::BackgroundRasterizer::Job> RasterWorker::Rasterize(
+    PassRefPtr<SkPicture> picture,
+    const SkMatrix& matrix,
+    const SkIRect& device_bounds,
+    bool checkerboard) {
+  auto job = std::make_shared<RasterJob>(picture, matrix, device_bounds,
+                                         checkerboard);
+  NextThread()->Rasterize(job);
+  return job;
+}
+
+void RasterWorker::PurgeResources() {
+  for (WorkerThread* thread : threads_)
+    thread->PurgeResources();
+}
+
+RasterWorker::WorkerThread* RasterWorker::NextThread() {
+  WorkerThread* next = threads_[0];
+  for (WorkerThread* thread : threads_) {
+    if (thread->pending_jobs() < next->pending_jobs())
+      next = thread;
+  }
+  return next;
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,60 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_GPU_RASTER_WORKER_H_
+#define SKY_SHELL_GPU_RASTER_WORKER_H_
+
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/scoped_vector.h"
+#include "sky/compositor/background_rasterizer.h"
+
+namespace gfx {
+class GLContext;
+class GLShareGroup;
+class GLSurface;
+}
+
+namespace sky {
+namespace shell {
+class GaneshContext;
+
+// RasterWorker rasterizes pictures for the raster cache on a small set of
+// threads of its own. Each thread has a GL context in the same share group
+// as the context used for painting, so the textures it renders into can be
+// drawn directly by the painting thread once they are complete.
+class RasterWorker : public compositor::BackgroundRasterizer {
+ public:
+  // Must be created after a context in |share_group| has been created.
+  RasterWorker(gfx::GLShareGroup* share_group, int thread_count);
+  ~RasterWorker() override;
+
+  // The number of threads worth dedicating to raster work on this device.
+  static int DefaultThreadCount();
+
+  std::shared_ptr<Job> Rasterize(PassRefPtr<SkPicture> picture,
+                                 const SkMatrix& matrix,
+                                 const SkIRect& device_bounds,
+                                 bool checkerboard) override;
+
+  // Frees the GPU resources cached by the worker's GrContext once the jobs
+  // that are already queued are done.
+  void PurgeResources();
+
+ private:
+  class RasterJob;
+  class WorkerThread;
+
+  // Jobs go to the thread with the fewest jobs outstanding.
+  WorkerThread* NextThread();
+
+  ScopedVector<WorkerThread> threads_;
+
+  DISALLOW_COPY_AND_ASSIGN(RasterWorker);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_GPU_RASTER_WORKER_H_
@@ -4,50 +4,236 @@
 
 #include "sky/shell/gpu/rasterizer.h"
 
+#include <algorithm>
+#include <cmath>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/message_loop/message_loop.h"
+#include "base/path_service.h"
+#include "base/single_thread_task_runner.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/trace_event/memory_dump_manager.h"
+#include "base/trace_event/process_memory_dump.h"
 #include "base/trace_event/trace_event.h"
-#include "sky/compositor/container_layer.h"
+#include "base/trace_event/trace_event_synthetic_delay.h"
 #include "sky/compositor/layer.h"
+#include "sky/compositor/overdraw_visualizer.h"
 #include "sky/compositor/paint_context.h"
-#include "sky/compositor/picture_layer.h"
 #include "sky/shell/gpu/ganesh_context.h"
 #include "sky/shell/gpu/ganesh_surface.h"
-#include "sky/shell/gpu/picture_serializer.h"
+#include "sky/shell/gpu/gl_gpu_tracer.h"
+#include "sky/shell/gpu/layer_tree_capture.h"
+#include "sky/shell/gpu/program_binary_cache.h"
+#include "sky/shell/gpu/raster_worker.h"
+#include "sky/shell/gpu/resolution_controller.h"
+#include "sky/shell/shell.h"
+#include "sky/shell/startup_timeline.h"
+#include "sky/shell/switches.h"
+#include "sky/engine/wtf/PassRefPtr.h"
 #include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "third_party/skia/include/core/SkPicture.h"
+#include "third_party/skia/include/core/SkRRect.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/effects/SkGradientShader.h"
 #include "ui/gl/gl_bindings.h"
+#include "ui/gl/gl_bindings_skia_in_process.h"
 #include "ui/gl/gl_context.h"
 #include "ui/gl/gl_share_group.h"
 #include "ui/gl/gl_surface.h"
 
-// Set this value to 1 to serialize the layer tree to disk.
-#define SERIALIZE_LAYER_TREE 0
-
 namespace sky {
 namespace shell {
 namespace {
 
-#if SERIALIZE_LAYER_TREE
+const char kProgramBinaryCacheFile[] = "program_binaries";
 
-void SketchySerializeLayerTree(const char* path,
-                               compositor::LayerTree* layer_tree) {
-  const auto& layers =
-      static_cast<compositor::ContainerLayer*>(layer_tree->root_layer())
-          ->layers();
-  if (layers.empty())
-    return;
-  SerializePicture(
-      path, static_cast<compositor::PictureLayer*>(layers[0].get())->picture());
+size_t GetGPUResourceCacheBytes() {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kGPUResourceCacheMB))
+    return GaneshContext::kDefaultResourceCacheBytes;
+
+  size_t megabytes = 0;
+  if (!base::StringToSizeT(
+          command_line.GetSwitchValueASCII(switches::kGPUResourceCacheMB),
+          &megabytes)) {
+    LOG(ERROR) << "Invalid value for --" << switches::kGPUResourceCacheMB;
+    return GaneshContext::kDefaultResourceCacheBytes;
+  }
+  return megabytes * 1024 * 1024;
+}
+
+Rasterizer::PresentationMode GetPresentationMode() {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kPresentationMode))
+    return Rasterizer::PresentationMode::kFifo;
+
+  const std::string mode =
+      command_line.GetSwitchValueASCII(switches::kPresentationMode);
+  if (mode == "fifo")
+    return Rasterizer::PresentationMode::kFifo;
+  if (mode == "mailbox")
+    return Rasterizer::PresentationMode::kMailbox;
+  if (mode == "timed")
+    return Rasterizer::PresentationMode::kTimed;
+  LOG(ERROR) << "Invalid value for --" << switches::kPresentationMode;
+  return Rasterizer::PresentationMode::kFifo;
+}
+
+int GetMSAASampleCount(const compositor::CompositorOptions& options) {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kMSAASamples))
+    return options.msaaSampleCount();
+
+  int samples = 0;
+  if (!base::StringToInt(
+          command_line.GetSwitchValueASCII(switches::kMSAASamples),
+          &samples) ||
+      samples < 0 || samples > 16) {
+    LOG(ERROR) << "Invalid value for --" << switches::kMSAASamples;
+    return options.msaaSampleCount();
+  }
+  return samples;
 }
 
-#endif
+uint32_t GetCompositorDebugFlags() {
+  using compositor::CompositorOptions;
+
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kCompositorDebug))
+    return 0;
+
+  uint32_t flags = 0;
+  std::vector<std::string> names;
+  base::SplitString(
+      command_line.GetSwitchValueASCII(switches::kCompositorDebug), ',',
+      &names);
+  for (const std::string& name : names) {
+    if (name == "overdraw") {
+      flags |= CompositorOptions::kVisualizeOverdrawFlag;
+    } else if (name == "layer-bounds") {
+      flags |= CompositorOptions::kVisualizeLayerBoundsFlag;
+    } else if (name == "raster-time") {
+      flags |= CompositorOptions::kVisualizeRasterTimeFlag;
+    } else if (name == "rasterized-images") {
+      flags |= CompositorOptions::kHighlightRasterizedImagesFlag;
+    } else if (name == "frame-statistics") {
+      flags |= CompositorOptions::kDisplayFrameStatisticsFlag;
+    } else if (name == "rasterizer-statistics") {
+      flags |= CompositorOptions::kDisplayRasterizerStatisticsFlag;
+    } else {
+      LOG(ERROR) << "Invalid value for --" << switches::kCompositorDebug
+                 << ": " << name;
+    }
+  }
+  return flags;
+}
+
+// Draws the shapes, gradients, images and clips most apps start with, so
+// that Ganesh has linked their programs before the first frame needs them.
+void WarmUpShaders(GrContext* gr_context) {
+  TRACE_EVENT0("sky", "WarmUpShaders");
+  skia::RefPtr<SkSurface> surface = skia::AdoptRef(SkSurface::NewRenderTarget(
+      gr_context, SkSurface::kNo_Budgeted, SkImageInfo::MakeN32Premul(64, 64)));
+  if (!surface)
+    return;
+  SkCanvas* canvas = surface->getCanvas();
+  const SkRect rect = SkRect::MakeWH(32, 32);
+  const SkRRect rrect = SkRRect::MakeRectXY(rect, 4, 4);
+
+  SkPaint paint;
+  canvas->drawRect(rect, paint);
+  paint.setAntiAlias(true);
+  canvas->drawRRect(rrect, paint);
+  canvas->drawCircle(16, 16, 8, paint);
+  SkPath path;
+  path.moveTo(0, 0);
+  path.quadTo(30, 0, 30, 30);
+  path.close();
+  canvas->drawPath(path, paint);
+
+  const SkPoint points[] = {SkPoint::Make(0, 0), SkPoint::Make(32, 32)};
+  const SkColor colors[] = {SK_ColorBLACK, SK_ColorWHITE};
+  skia::RefPtr<SkShader> linear = skia::AdoptRef(SkGradientShader::CreateLinear(
+      points, colors, nullptr, 2, SkShader::kClamp_TileMode));
+  paint.setShader(linear.get());
+  canvas->drawRect(rect, paint);
+  skia::RefPtr<SkShader> radial = skia::AdoptRef(SkGradientShader::CreateRadial(
+      points[0], 32, colors, nullptr, 2, SkShader::kClamp_TileMode));
+  paint.setShader(radial.get());
+  canvas->drawRRect(rrect, paint);
+  paint.setShader(nullptr);
+
+  SkBitmap bitmap;
+  bitmap.allocN32Pixels(8, 8);
+  bitmap.eraseColor(SK_ColorTRANSPARENT);
+  SkPaint image_paint;
+  image_paint.setFilterQuality(kLow_SkFilterQuality);
+  canvas->drawBitmapRect(bitmap, rect, &image_paint);
+
+  canvas->save();
+  canvas->clipRRect(rrect, SkRegion::kIntersect_Op, true);
+  canvas->drawRect(SkRect::MakeWH(64, 64), paint);
+  canvas->restore();
+
+  canvas->flush();
+}
 
 }  // namespace
 
 Rasterizer::Rasterizer()
-    : share_group_(new gfx::GLShareGroup()),
-      weak_factory_(this) {}
+    : gpu_resource_cache_bytes_(GetGPUResourceCacheBytes()),
+      share_group_(new gfx::GLShareGroup()),
+      frame_scale_(1.0f),
+      statistics_(new compositor::CompositorStatisticsStore()),
+      layer_tree_capture_(LayerTreeCapture::CreateFromCommandLine()),
+      recording_frame_timings_(false),
+      count_gl_calls_(base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kCountGLCalls)),
+      presentation_mode_(GetPresentationMode()),
+      debug_flags_(GetCompositorDebugFlags()),
+      animation_frame_request_(0),
+      animation_frame_scheduled_(false),
+      drawn_texture_frame_count_(0),
+      listening_for_memory_pressure_(false),
+      weak_factory_(this) {
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDynamicResolution)) {
+    resolution_controller_.reset(new ResolutionController());
+  }
+
+  compositor::CompositorOptions& options = paint_context_.options();
+  options.setMSAASampleCount(GetMSAASampleCount(options));
+  options.setNVPathRenderingEnabled(
+      !base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableNVPathRendering));
+
+  // Frames are announced on the threads of their producers.
+  paint_context_.texture_registry().set_frame_available_callback(base::Bind(
+      base::IgnoreResult(&base::SingleThreadTaskRunner::PostTask),
+      Shell::Shared().gpu_task_runner(), FROM_HERE,
+      base::Bind(&Rasterizer::OnTextureFrameAvailable,
+                 weak_factory_.GetWeakPtr())));
+
+  // Everything the dump reports belongs to the GPU thread, which is also
+  // where the rasterizer is destroyed.
+  base::trace_event::MemoryDumpManager::GetInstance()->RegisterDumpProvider(
+      this, Shell::Shared().gpu_task_runner());
+}
 
 Rasterizer::~Rasterizer() {
+  paint_context_.texture_registry().set_frame_available_callback(
+      base::Closure());
+  if (listening_for_memory_pressure_)
+    Shell::Shared().memory_pressure_coordinator().RemoveClient(this);
+  base::trace_event::MemoryDumpManager::GetInstance()->UnregisterDumpProvider(
+      this);
 }
 
 base::WeakPtr<Rasterizer> Rasterizer::GetWeakPtr() {
@@ -55,53 +241,453 @@ base::WeakPtr<Rasterizer> Rasterizer::GetWeakPtr() {
 }
 
 void Rasterizer::OnAcceleratedWidgetAvailable(gfx::AcceleratedWidget widget) {
-  surface_ = gfx::GLSurface::CreateViewGLSurface(widget,
-                                                 gfx::SurfaceConfiguration());
+  // Embedders without a window, such as benchmarks on Linux, still get their
+  // frames drawn, just not shown. Draw resizes the surface to the frame.
+  if (widget == gfx::kNullAcceleratedWidget) {
+    surface_ = gfx::GLSurface::CreateOffscreenGLSurface(
+        gfx::Size(1, 1), gfx::SurfaceConfiguration());
+  } else {
+    // Stenciling paths needs a stencil buffer as well as the samples.
+    gfx::SurfaceConfiguration config;
+    config.samples = paint_context_.options().msaaSampleCount();
+    config.stencil_bits = config.samples ? 8 : 0;
+    surface_ = gfx::GLSurface::CreateViewGLSurface(widget, config);
+    if (!surface_ && config.samples) {
+      LOG(WARNING) << "No window config with "
+                   << static_cast<int>(config.samples)
+                   << " samples, falling back to none.";
+      surface_ = gfx::GLSurface::CreateViewGLSurface(
+          widget, gfx::SurfaceConfiguration());
+    }
+  }
   CHECK(surface_) << "GLSurface required.";
+
+  // The engine builds the first frame in the meantime.
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kWarmUpShaders)) {
+    EnsureGLContext();
+    WarmUpShaders(ganesh_context_->gr());
+  }
+}
+
+void Rasterizer::StartRecordingFrameTimings() {
+  recording_frame_timings_ = true;
+  recorded_frame_timings_.clear();
+}
+
+std::vector<compositor::instrumentation::FrameTiming>
+Rasterizer::TakeFrameTimings() {
+  recording_frame_timings_ = false;
+  std::vector<compositor::instrumentation::FrameTiming> timings;
+  timings.swap(recorded_frame_timings_);
+  return timings;
 }
 
 void Rasterizer::Draw(scoped_ptr<compositor::LayerTree> layer_tree) {
-  TRACE_EVENT0("sky", "Rasterizer::Draw");
+  TRACE_EVENT1("sky", "Rasterizer::Draw", "frame",
+               layer_tree->frame_number());
+  TRACE_EVENT_FLOW_END_BIND_TO_ENCLOSING0("sky", "Frame",
+                                          layer_tree->frame_number());
+  TRACE_EVENT_SYNTHETIC_DELAY("sky.Draw");
+
+  // The new tree replaces the one whose animations were being drawn.
+  ++animation_frame_request_;
+  animation_frame_scheduled_ = false;
+  DrawLayerTree(layer_tree.get());
+  ScheduleAnimationFrame(layer_tree.Pass());
+}
+
+void Rasterizer::Scroll(const compositor::ScrollGesture& gesture) {
+  TRACE_EVENT0("sky", "Rasterizer::Scroll");
+  compositor::ScrollController& controller =
+      paint_context_.scroll_controller();
+  controller.HandleGesture(gesture);
+  if (animating_layer_tree_ && !animation_frame_scheduled_ &&
+      controller.NeedsFrame()) {
+    ScheduleAnimationFrame(animating_layer_tree_.Pass());
+  }
+}
+
+void Rasterizer::ScheduleAnimationFrame(
+    scoped_ptr<compositor::LayerTree> layer_tree) {
+  const compositor::ScrollController& controller =
+      paint_context_.scroll_controller();
+  const compositor::TextureRegistry& textures =
+      paint_context_.texture_registry();
+  if (!surface_ ||
+      (!layer_tree->animations_running() && !controller.has_scrollers() &&
+       !textures.has_textures())) {
+    animating_layer_tree_.reset();
+    return;
+  }
+  // A tree with scroll layers or textures waits for the next gesture or
+  // texture frame.
+  if (!layer_tree->animations_running() && !controller.NeedsFrame() &&
+      textures.frame_count() == drawn_texture_frame_count_) {
+    animating_layer_tree_ = layer_tree.Pass();
+    return;
+  }
+
+  // The next frame is drawn while this one is being shown, for the vsync
+  // after it. Presenting in FIFO order keeps the frames from running ahead.
+  const base::TimeDelta interval = compositor::instrumentation::FrameBudget();
+  const base::TimeTicks now = base::TimeTicks::Now();
+  const base::TimeTicks shown = layer_tree->target_time().is_null()
+                                    ? now
+                                    : layer_tree->target_time();
+  const base::TimeTicks next_target = std::max(shown, now) + interval;
+  layer_tree->set_frame_time(next_target - interval);
+  layer_tree->set_target_time(next_target);
+  // Nothing is built for the frame on the UI thread.
+  layer_tree->set_build_start_time(base::TimeTicks());
+  layer_tree->set_construction_time(base::TimeDelta());
+  animating_layer_tree_ = layer_tree.Pass();
+  animation_frame_scheduled_ = true;
+
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&Rasterizer::DrawAnimationFrame, weak_factory_.GetWeakPtr(),
+                 animation_frame_request_),
+      std::max(base::TimeDelta(), shown - now));
+}
+
+void Rasterizer::DrawAnimationFrame(uint64_t request) {
+  if (request != animation_frame_request_)
+    return;
+  animation_frame_scheduled_ = false;
+  if (!animating_layer_tree_)
+    return;
+  TRACE_EVENT1("sky", "Rasterizer::DrawAnimationFrame", "frame",
+               animating_layer_tree_->frame_number());
 
+  scoped_ptr<compositor::LayerTree> layer_tree = animating_layer_tree_.Pass();
+  DrawLayerTree(layer_tree.get());
+  ScheduleAnimationFrame(layer_tree.Pass());
+}
+
+void Rasterizer::OnTextureFrameAvailable() {
+  if (animating_layer_tree_ && !animation_frame_scheduled_)
+    ScheduleAnimationFrame(animating_layer_tree_.Pass());
+}
+
+void Rasterizer::DrawLayerTree(compositor::LayerTree* layer_tree) {
   if (!surface_)
     return;
 
+  if (layer_tree_capture_ && !layer_tree_capture_->Capture(*layer_tree))
+    layer_tree_capture_.reset();
+
+  compositor::instrumentation::FrameTiming timing;
+  timing.frame_number = layer_tree->frame_number();
+  timing.frame_time = layer_tree->frame_time();
+  timing.build_start = layer_tree->build_start_time();
+  timing.build_end =
+      layer_tree->build_start_time() + layer_tree->construction_time();
+  timing.raster_start = base::TimeTicks::Now();
+
   gfx::Size size(layer_tree->frame_size().width(),
                  layer_tree->frame_size().height());
 
-  if (surface_->GetSize() != size)
+  const bool resized = surface_->GetSize() != size;
+  if (resized)
     surface_->Resize(size);
 
   EnsureGLContext();
   CHECK(context_->MakeCurrent(surface_.get()));
+  // The swap interval belongs to the EGL surface, which resizing replaces.
+  if (resized)
+    context_->SetSwapInterval(SwapInterval());
   EnsureGaneshSurface(surface_->GetBackingFrameBufferObject(), size);
   SkCanvas* canvas = ganesh_surface_->canvas();
 
-  canvas->clear(SK_ColorBLACK);
+  compositor::TextureRegistry& textures = paint_context_.texture_registry();
+  textures.ReleaseUnregisteredTextures();
+  drawn_texture_frame_count_ = textures.frame_count();
+
+  if (gpu_tracer_)
+    gpu_tracer_->CollectResults();
+
+  compositor::CompositorOptions& options = paint_context_.options();
+  options.setDebugFlags(debug_flags_ | layer_tree->debug_flags());
+
+  // A frame drawn below full scale is painted into an offscreen surface,
+  // which keeps its contents from frame to frame, and all of it is upscaled
+  // into the window.
+  const float scale =
+      resolution_controller_ ? resolution_controller_->scale() : 1.0f;
+  if (scale != frame_scale_) {
+    paint_context_.damage_tracker().Invalidate();
+    frame_scale_ = scale;
+  }
+  SkCanvas* frame_canvas = canvas;
+  if (scale < 1.0f) {
+    EnsureScaledSurface(size, scale);
+    frame_canvas = scaled_surface_->getCanvas();
+  } else {
+    scaled_surface_.clear();
+  }
+
+  // Without partial presentation the back buffer contents are undefined
+  // after a swap, so every frame has to be repainted in full unless the
+  // surface reports that the back buffer still holds the previous frame.
+  const bool partial_repaint = scaled_surface_ ||
+                               surface_->SupportsPostSubBuffer() ||
+                               surface_->GetBufferAge() == 1;
+  if (!partial_repaint)
+    paint_context_.damage_tracker().Invalidate();
+
+  // The layers paint through the visualizer, which counts their draws.
+  scoped_ptr<compositor::OverdrawVisualizer> overdraw_visualizer;
+  SkCanvas* paint_canvas = frame_canvas;
+  if (options.isEnabled(
+          compositor::CompositorOptions::Option::VisualizeOverdraw)) {
+    overdraw_visualizer.reset(new compositor::OverdrawVisualizer(
+        frame_canvas, ganesh_context_->gr()));
+    if (overdraw_visualizer->canvas())
+      paint_canvas = overdraw_visualizer->canvas();
+  }
+
+  SkIRect damage;
+  compositor::ScrollController& scroll_controller =
+      paint_context_.scroll_controller();
+  if (gpu_tracer_)
+    gpu_tracer_->BeginSpan("Frame", 0);
   {
-    auto frame = paint_context_.AcquireFrame(*canvas, ganesh_context_->gr());
-    layer_tree->root_layer()->Paint(frame);
+    auto frame =
+        paint_context_.AcquireFrame(*paint_canvas, ganesh_context_->gr());
+    // The damage is in device pixels, so it is computed with the scale
+    // applied, but clipped to without it.
+    paint_canvas->save();
+    paint_canvas->scale(scale, scale);
+    scroll_controller.BeginFrame();
+    damage = layer_tree->Preroll(frame);
+    scroll_controller.EndFrame();
+    paint_canvas->restore();
+    if (!damage.isEmpty()) {
+      paint_canvas->save();
+      paint_canvas->clipRect(SkRect::Make(damage));
+      // Clearing is not a draw of the frame's layers, so it is not counted.
+      frame_canvas->clear(SK_ColorBLACK);
+      paint_canvas->scale(scale, scale);
+      layer_tree->Paint(frame);
+      paint_canvas->restore();
+    }
+  }
+  if (overdraw_visualizer && !damage.isEmpty())
+    overdraw_visualizer->Composite();
+  if (scaled_surface_ && !damage.isEmpty()) {
+    skia::RefPtr<SkImage> image =
+        skia::AdoptRef(scaled_surface_->newImageSnapshot());
+    SkPaint paint;
+    paint.setFilterQuality(kLow_SkFilterQuality);
+    const SkRect src =
+        SkRect::MakeWH(size.width() * scale, size.height() * scale);
+    damage = SkIRect::MakeWH(size.width(), size.height());
+    canvas->drawImageRect(image.get(), &src, SkRect::Make(damage), &paint);
+  }
+  if (gpu_tracer_)
+    gpu_tracer_->EndSpan();
+  statistics_->Update(paint_context_.GetStatistics());
+  if (scroll_controller.TakeContentRequest() &&
+      !scroll_content_callback_.is_null()) {
+    Shell::Shared().ui_task_runner()->PostTask(FROM_HERE,
+                                               scroll_content_callback_);
   }
+
+  // Nothing on screen changed since the last frame.
+  if (damage.isEmpty()) {
+    ReportGLCallCounts();
+    return;
+  }
+
   canvas->flush();
-  surface_->SwapBuffers();
+  timing.raster_end = base::TimeTicks::Now();
+  ReportGLCallCounts();
+  if (resolution_controller_) {
+    // Without a GPU tracer the time Ganesh takes to issue the frame stands
+    // in for the time the GPU takes to draw it.
+    base::TimeDelta cost = timing.raster_end - timing.raster_start;
+    if (gpu_tracer_ && paint_context_.gpu_times().size())
+      cost = std::max(cost, paint_context_.gpu_times().last());
+    resolution_controller_->DidDrawFrame(cost);
+  }
+  if (ProgramBinaryCache* program_cache = ProgramBinaryCache::Shared())
+    program_cache->SaveIfNeeded();
+
+  if (options.isEnabled(
+          compositor::CompositorOptions::Option::PipelinedSwap)) {
+    // The reply that lets the animator start the next frame is posted as
+    // soon as Draw returns. Tasks on this thread run in order, so the swap
+    // still happens before the next frame is drawn.
+    base::MessageLoop::current()->PostTask(
+        FROM_HERE, base::Bind(&Rasterizer::Present, weak_factory_.GetWeakPtr(),
+                              surface_, damage, size,
+                              layer_tree->target_time(), timing));
+  } else {
+    Present(surface_, damage, size, layer_tree->target_time(), timing);
+  }
+}
+
+void Rasterizer::ReportGLCallCounts() {
+  if (!count_gl_calls_)
+    return;
+  // Ganesh defers most of its calls until the flush, so this includes the
+  // calls that draw the frame.
+  gfx::SkiaGLCallCounts counts = gfx::TakeSkiaGLCallCounts();
+  TRACE_COUNTER2("sky", "GLCalls", "calls", counts.calls, "draws",
+                 counts.draws);
+  TRACE_COUNTER2("sky", "GLStateChanges", "state_changes",
+                 counts.state_changes, "uploads", counts.uploads);
+}
 
-#if SERIALIZE_LAYER_TREE
-  SketchySerializeLayerTree("/data/data/org.domokit.sky.shell/cache/layer0.skp",
-                            layer_tree.get());
-#endif
+int Rasterizer::SwapInterval() const {
+  return presentation_mode_ == PresentationMode::kMailbox ? 0 : 1;
+}
+
+void Rasterizer::RasterizeToImage(scoped_ptr<compositor::LayerTree> layer_tree,
+                                  const ImageCallback& callback) {
+  TRACE_EVENT0("sky", "Rasterizer::RasterizeToImage");
+
+  // The GL context is only made once there is a window to draw into.
+  if (!surface_) {
+    callback.Run(nullptr);
+    return;
+  }
+
+  EnsureGLContext();
+  CHECK(context_->MakeCurrent(surface_.get()));
+
+  const SkISize& size = layer_tree->frame_size();
+  skia::RefPtr<SkSurface> surface = skia::AdoptRef(SkSurface::NewRenderTarget(
+      ganesh_context_->gr(), SkSurface::kNo_Budgeted,
+      SkImageInfo::MakeN32Premul(size.width(), size.height())));
+  if (!surface) {
+    callback.Run(nullptr);
+    return;
+  }
+
+  SkCanvas* canvas = surface->getCanvas();
+  canvas->clear(SK_ColorTRANSPARENT);
+  {
+    // The tree is unrelated to the frames on screen, so it is painted with
+    // a context of its own to leave their damage tracking and raster cache
+    // alone.
+    compositor::PaintContext paint_context;
+    auto frame = paint_context.AcquireFrame(*canvas, ganesh_context_->gr(),
+                                            false);
+    layer_tree->Raster(frame);
+  }
+  canvas->flush();
+
+  callback.Run(adoptRef(surface->newImageSnapshot()));
+}
+
+bool Rasterizer::OnMemoryDump(base::trace_event::ProcessMemoryDump* pmd) {
+  using base::trace_event::MemoryAllocatorDump;
+
+  // Textures the GrContext allocated for the raster cache and the texture
+  // pool also count towards its resource cache, so these dumps overlap.
+  if (ganesh_context_) {
+    MemoryAllocatorDump* resource_cache =
+        pmd->CreateAllocatorDump("sky/gpu/resource_cache");
+    resource_cache->AddScalar(MemoryAllocatorDump::kNameSize,
+                              MemoryAllocatorDump::kUnitsBytes,
+                              ganesh_context_->GetResourceCacheBytes());
+  }
+
+  MemoryAllocatorDump* raster_cache =
+      pmd->CreateAllocatorDump("sky/gpu/raster_cache");
+  raster_cache->AddScalar(MemoryAllocatorDump::kNameSize,
+                          MemoryAllocatorDump::kUnitsBytes,
+                          paint_context_.rasterizer().cache_bytes().count());
+
+  MemoryAllocatorDump* texture_pool =
+      pmd->CreateAllocatorDump("sky/gpu/texture_pool");
+  texture_pool->AddScalar(MemoryAllocatorDump::kNameSize,
+                          MemoryAllocatorDump::kUnitsBytes,
+                          paint_context_.texture_pool().idle_bytes());
+  return true;
+}
+
+void Rasterizer::Present(
+    scoped_refptr<gfx::GLSurface> surface,
+    const SkIRect& damage,
+    const gfx::Size& size,
+    base::TimeTicks target_time,
+    const compositor::instrumentation::FrameTiming& timing) {
+  TRACE_EVENT1("sky", "Rasterizer::Present", "frame", timing.frame_number);
+
+  // The surface the frame was drawn into may have gone away while a
+  // pipelined swap was pending.
+  if (!surface_ || surface_.get() != surface.get() || !context_)
+    return;
+
+  CHECK(context_->MakeCurrent(surface_.get()));
+
+  // Tagged with its vsync, a frame that is finished early waits in the
+  // display's queue instead of replacing the frame before it.
+  if (presentation_mode_ == PresentationMode::kTimed &&
+      !target_time.is_null() && surface_->SupportsPresentationTime()) {
+    surface_->SetPresentationTime(target_time);
+  }
+
+  if (surface_->IsOffscreen()) {
+    // There is nothing to swap. Waiting for the GPU keeps the timing
+    // comparable to a swap that blocks on the previous frame.
+    glFinish();
+  } else if (surface_->SupportsPostSubBuffer()) {
+    // PostSubBuffer takes GL window coordinates with the origin at the
+    // bottom left.
+    surface_->PostSubBuffer(damage.x(), size.height() - damage.bottom(),
+                            damage.width(), damage.height());
+  } else {
+    surface_->SwapBuffers();
+  }
+
+  compositor::instrumentation::FrameTiming presented = timing;
+  presented.swap_end = base::TimeTicks::Now();
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::FirstFrameSwapped);
+
+  // Trees from embedders that do not track frames carry no timestamps.
+  if (!presented.frame_time.is_null()) {
+    paint_context_.RecordFrameTiming(presented);
+    if (recording_frame_timings_)
+      recorded_frame_timings_.push_back(presented);
+    Shell::Shared().tracing_controller().jank_tracer().DidPresentFrame(
+        presented);
+  }
 }
 
 void Rasterizer::OnOutputSurfaceDestroyed() {
+  paint_context_.damage_tracker().Invalidate();
   if (context_) {
     CHECK(context_->MakeCurrent(surface_.get()));
+    paint_context_.rasterizer().set_background_rasterizer(nullptr);
+    paint_context_.set_gpu_tracer(nullptr);
+    gpu_tracer_.reset();
+    raster_worker_.reset();
+    paint_context_.texture_registry().ReleaseGLResources();
+    paint_context_.texture_pool().Clear();
+    scaled_surface_.clear();
     ganesh_surface_.reset();
     ganesh_context_.reset();
     context_ = nullptr;
   }
   CHECK(!ganesh_surface_);
   CHECK(!ganesh_context_);
+  CHECK(!raster_worker_);
   CHECK(!context_);
   surface_ = nullptr;
+  animating_layer_tree_.reset();
+}
+
+void Rasterizer::OnActivityPaused() {
+  // The surface usually goes away along with the activity, which frees
+  // everything. Some activities stay visible while paused, so purge
+  // explicitly as well.
+  animating_layer_tree_.reset();
+  PurgeResources();
 }
 
 void Rasterizer::EnsureGLContext() {
@@ -111,14 +697,127 @@ void Rasterizer::EnsureGLContext() {
                                              gfx::PreferIntegratedGpu);
   CHECK(context_) << "GLContext required.";
   CHECK(context_->MakeCurrent(surface_.get()));
-  ganesh_context_.reset(new GaneshContext(context_.get()));
+  context_->SetSwapInterval(SwapInterval());
+
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  base::FilePath cache_dir;
+  if (!command_line.HasSwitch(switches::kDisableProgramBinaryCache) &&
+      PathService::Get(base::DIR_CACHE, &cache_dir)) {
+    ProgramBinaryCache::Initialize(
+        cache_dir.AppendASCII(kProgramBinaryCacheFile),
+        Shell::Shared().task_scheduler().task_runner(
+            TaskScheduler::TaskPriority::kBackground));
+  }
+
+  ganesh_context_.reset(new GaneshContext(
+      context_.get(), gpu_resource_cache_bytes_, count_gl_calls_,
+      paint_context_.options().nvPathRenderingEnabled()));
+  // The workers' contexts join the share group, so they can only be created
+  // once the group has a context.
+  raster_worker_.reset(new RasterWorker(share_group_.get(),
+                                        RasterWorker::DefaultThreadCount()));
+  paint_context_.rasterizer().set_background_rasterizer(raster_worker_.get());
+
+  const bool trace_layers =
+      command_line.HasSwitch(switches::kTraceLayerGPUTime);
+  if (trace_layers || command_line.HasSwitch(switches::kTraceGPUTime)) {
+    gpu_tracer_ = GLGPUTracer::Create(context_.get(), ganesh_context_->gr(),
+                                      &paint_context_);
+    // Timing single layers flushes Ganesh around each of them, which skews
+    // the frame it measures.
+    if (trace_layers)
+      paint_context_.set_gpu_tracer(gpu_tracer_.get());
+  }
+
+  // Clients are notified on the thread they are added on, which has to be
+  // the one that owns the GL context.
+  if (!listening_for_memory_pressure_) {
+    Shell::Shared().memory_pressure_coordinator().AddClient("rasterizer",
+                                                            this);
+    listening_for_memory_pressure_ = true;
+  }
 }
 
 void Rasterizer::EnsureGaneshSurface(intptr_t window_fbo,
                                      const gfx::Size& size) {
-  if (!ganesh_surface_ || ganesh_surface_->size() != size)
+  if (!ganesh_surface_ || ganesh_surface_->size() != size) {
     ganesh_surface_.reset(
       new GaneshSurface(window_fbo, ganesh_context_.get(), size));
+    paint_context_.damage_tracker().Invalidate();
+  }
+}
+
+void Rasterizer::EnsureScaledSurface(const gfx::Size& size, float scale) {
+  const int width = static_cast<int>(std::ceil(size.width() * scale));
+  const int height = static_cast<int>(std::ceil(size.height() * scale));
+  if (scaled_surface_ && scaled_surface_->width() == width &&
+      scaled_surface_->height() == height) {
+    return;
+  }
+  scaled_surface_ = skia::AdoptRef(SkSurface::NewRenderTarget(
+      ganesh_context_->gr(), SkSurface::kYes_Budgeted,
+      SkImageInfo::MakeN32Premul(width, height),
+      paint_context_.options().msaaSampleCount()));
+  CHECK(scaled_surface_);
+  paint_context_.damage_tracker().Invalidate();
+}
+
+size_t Rasterizer::OnMemoryPressure(MemoryPressureCoordinator::Level level) {
+  TRACE_EVENT1("sky", "Rasterizer::OnMemoryPressure", "level",
+               static_cast<int>(level));
+  compositor::PictureRasterzier& raster_cache = paint_context_.rasterizer();
+  compositor::TexturePool& texture_pool = paint_context_.texture_pool();
+  switch (level) {
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE:
+      return 0;
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_MODERATE: {
+      if (context_)
+        CHECK(context_->MakeCurrent(surface_.get()));
+      // The textures go back to the GrContext, which frees them once its
+      // cache is over budget, so only what the caches let go of is counted.
+      const size_t cached_bytes =
+          raster_cache.cache_bytes().count() + texture_pool.idle_bytes();
+      raster_cache.Trim(raster_cache.cache_bytes().count() / 2);
+      texture_pool.OnMemoryPressure(level);
+      const size_t remaining_bytes =
+          raster_cache.cache_bytes().count() + texture_pool.idle_bytes();
+      return cached_bytes > remaining_bytes ? cached_bytes - remaining_bytes
+                                            : 0;
+    }
+    case base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL: {
+      // Everything the caches hold is also in the GrContext's resource
+      // cache, which is emptied along with them.
+      if (!ganesh_context_) {
+        PurgeResources();
+        return 0;
+      }
+      const size_t resource_bytes = ganesh_context_->GetResourceCacheBytes();
+      PurgeResources();
+      const size_t remaining_bytes = ganesh_context_->GetResourceCacheBytes();
+      return resource_bytes > remaining_bytes ? resource_bytes - remaining_bytes
+                                              : 0;
+    }
+  }
+  return 0;
+}
+
+void Rasterizer::PurgeResources() {
+  TRACE_EVENT0("sky", "Rasterizer::PurgeResources");
+  if (context_)
+    CHECK(context_->MakeCurrent(surface_.get()));
+
+  // Dropping the cached images returns their textures to the pool, so the
+  // pool has to be cleared afterwards.
+  paint_context_.rasterizer().Clear();
+  paint_context_.texture_pool().Clear();
+  // The next frame drawn below full scale allocates it again.
+  scaled_surface_.clear();
+
+  if (ganesh_context_)
+    ganesh_context_->PurgeResources();
+  if (raster_worker_)
+    raster_worker_->PurgeResources();
 }
 
 }  // namespace shell
@@ -5,15 +5,21 @@
 #ifndef SKY_SHELL_GPU_RASTERIZER_H_
 #define SKY_SHELL_GPU_RASTERIZER_H_
 
+#include <vector>
+
 #include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/trace_event/memory_dump_provider.h"
+#include "sky/compositor/instrumentation.h"
 #include "skia/ext/refptr.h"
 #include "sky/shell/gpu_delegate.h"
+#include "sky/shell/memory_pressure_coordinator.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/native_widget_types.h"
 #include "sky/compositor/paint_context.h"
 
 class SkPicture;
+class SkSurface;
 
 namespace gfx {
 class GLContext;
@@ -25,21 +31,101 @@ namespace sky {
 namespace shell {
 class GaneshContext;
 class GaneshSurface;
-
-class Rasterizer : public GPUDelegate {
+class GLGPUTracer;
+class LayerTreeCapture;
+class RasterWorker;
+class ResolutionController;
+
+class Rasterizer : public GPUDelegate,
+                   public base::trace_event::MemoryDumpProvider,
+                   public MemoryPressureCoordinator::Client {
  public:
+  // How frames are handed to the display, chosen with --presentation-mode.
+  enum class PresentationMode {
+    // Every swap waits for the display to take the previous frame.
+    kFifo,
+    // Swaps never wait, and the display shows the latest frame it has.
+    kMailbox,
+    // Like kFifo, but every frame is also tagged with the time it is meant
+    // to be shown at, where the surface supports it.
+    kTimed,
+  };
+
   explicit Rasterizer();
   ~Rasterizer() override;
 
   base::WeakPtr<Rasterizer> GetWeakPtr();
 
+  // Statistics of the frames drawn so far, readable from any thread.
+  compositor::CompositorStatisticsStore* statistics() const {
+    return statistics_.get();
+  }
+
+  // The offsets the compositor scrolled the scroll layers to, readable from
+  // any thread.
+  compositor::ScrollOffsetStore* scroll_offsets() {
+    return paint_context_.scroll_controller().offsets();
+  }
+
+  // The external textures the frames draw, which producers register and
+  // announce new frames of on their own threads.
+  compositor::TextureRegistry* texture_registry() {
+    return &paint_context_.texture_registry();
+  }
+
+  // Runs |callback| on the UI thread whenever a scroll layer gets close to
+  // the end of its content while the compositor scrolls it.
+  void set_scroll_content_callback(const base::Closure& callback) {
+    scroll_content_callback_ = callback;
+  }
+
   void OnAcceleratedWidgetAvailable(gfx::AcceleratedWidget widget) override;
   void OnOutputSurfaceDestroyed() override;
+  void OnActivityPaused() override;
   void Draw(scoped_ptr<compositor::LayerTree> layer_tree) override;
+  void Scroll(const compositor::ScrollGesture& gesture) override;
+  void RasterizeToImage(scoped_ptr<compositor::LayerTree> layer_tree,
+                        const ImageCallback& callback) override;
+
+  // Keeps the timing of every frame presented from now on, however many
+  // there are, until the timings are taken.
+  void StartRecordingFrameTimings();
+  std::vector<compositor::instrumentation::FrameTiming> TakeFrameTimings();
+
+  // base::trace_event::MemoryDumpProvider:
+  bool OnMemoryDump(base::trace_event::ProcessMemoryDump* pmd) override;
+
+  // MemoryPressureCoordinator::Client:
+  size_t OnMemoryPressure(MemoryPressureCoordinator::Level level) override;
 
  private:
+  // Paints |layer_tree| and presents it if anything changed.
+  void DrawLayerTree(compositor::LayerTree* layer_tree);
+  // Keeps |layer_tree| to be drawn again for the next frame if its
+  // animations are still running or its scroll layers are being scrolled,
+  // and to be drawn again once they are if it has scroll layers.
+  void ScheduleAnimationFrame(scoped_ptr<compositor::LayerTree> layer_tree);
+  void DrawAnimationFrame(uint64_t request);
+  // Draws the last tree again for a new frame of an external texture.
+  void OnTextureFrameAvailable();
   void EnsureGLContext();
+  int SwapInterval() const;
+  // Traces the GL calls made since the last frame, with --count-gl-calls.
+  void ReportGLCallCounts();
   void EnsureGaneshSurface(intptr_t window_fbo, const gfx::Size& size);
+  // Makes |scaled_surface_| large enough for a frame of |size| drawn at
+  // |scale|.
+  void EnsureScaledSurface(const gfx::Size& size, float scale);
+  void Present(scoped_refptr<gfx::GLSurface> surface,
+               const SkIRect& damage,
+               const gfx::Size& size,
+               base::TimeTicks target_time,
+               const compositor::instrumentation::FrameTiming& timing);
+  // Frees every cached GPU resource that can be recreated on demand.
+  void PurgeResources();
+
+  // The resource cache budget of the painting thread's GrContext.
+  size_t gpu_resource_cache_bytes_;
 
   scoped_refptr<gfx::GLShareGroup> share_group_;
   scoped_refptr<gfx::GLSurface> surface_;
@@ -47,8 +133,50 @@ class Rasterizer : public GPUDelegate {
 
   scoped_ptr<GaneshContext> ganesh_context_;
   scoped_ptr<GaneshSurface> ganesh_surface_;
+  scoped_ptr<RasterWorker> raster_worker_;
+  scoped_ptr<GLGPUTracer> gpu_tracer_;
+
+  // Set by --dynamic-resolution. Frames drawn below full scale are painted
+  // into |scaled_surface_| and upscaled into the window.
+  scoped_ptr<ResolutionController> resolution_controller_;
+  skia::RefPtr<SkSurface> scaled_surface_;
+  // The scale the last frame was painted at.
+  float frame_scale_;
 
   compositor::PaintContext paint_context_;
+  scoped_refptr<compositor::CompositorStatisticsStore> statistics_;
+  // Set while --capture-layer-trees is recording frames.
+  scoped_ptr<LayerTreeCapture> layer_tree_capture_;
+
+  bool recording_frame_timings_;
+  std::vector<compositor::instrumentation::FrameTiming> recorded_frame_timings_;
+
+  // Set by --count-gl-calls.
+  const bool count_gl_calls_;
+
+  const PresentationMode presentation_mode_;
+
+  // The compositor::CompositorOptions::DebugFlag values set by
+  // --compositor-debug, which apply in addition to the ones every layer
+  // tree asks for.
+  const uint32_t debug_flags_;
+
+  // The last tree drawn while its animations run or it has scroll layers
+  // or external textures, which is drawn again at every frame until a new
+  // tree arrives or they stop.
+  scoped_ptr<compositor::LayerTree> animating_layer_tree_;
+  // Incremented with every new tree, which cancels the frames scheduled to
+  // draw the previous one.
+  uint64_t animation_frame_request_;
+  bool animation_frame_scheduled_;
+  // The texture registry's frame count as of the last frame drawn.
+  uint64_t drawn_texture_frame_count_;
+
+  base::Closure scroll_content_callback_;
+
+  // Whether the rasterizer is a client of the shell's memory pressure
+  // coordinator, which it becomes once it has a GL context.
+  bool listening_for_memory_pressure_;
 
   base::WeakPtrFactory<Rasterizer> weak_factory_;
 
@@ -0,0 +1,69 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/gpu/resolution_controller.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/trace_event/trace_event.h"
+#include "sky/compositor/instrumentation.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Frames that take more than this share of the budget leave too little
+// room for the occasional expensive one.
+const double kHighWater = 0.85;
+// Frames that take less than this share of the budget would still fit at
+// the next larger scale.
+const double kLowWater = 0.5;
+const int kFramesBeforeDecrease = 3;
+const int kFramesBeforeIncrease = 60;
+
+}  // namespace
+
+const float ResolutionController::kMinScale = 0.5f;
+const float ResolutionController::kScaleStep = 0.125f;
+
+ResolutionController::ResolutionController()
+    : scale_(1.0f), frames_over_(0), frames_under_(0) {
+}
+
+ResolutionController::~ResolutionController() {
+}
+
+bool ResolutionController::DidDrawFrame(base::TimeDelta cost) {
+  const double budget =
+      compositor::instrumentation::FrameBudget().InSecondsF();
+  const double load = cost.InSecondsF() / budget;
+  frames_over_ = load > kHighWater ? frames_over_ + 1 : 0;
+  frames_under_ = load < kLowWater ? frames_under_ + 1 : 0;
+
+  float scale = scale_;
+  if (frames_over_ >= kFramesBeforeDecrease) {
+    // The cost grows with the number of pixels, which is the square of the
+    // scale. Aim for the middle between the two water marks.
+    const double target = (kHighWater + kLowWater) / 2;
+    scale = scale_ * std::sqrt(target / load);
+    scale = std::floor(scale / kScaleStep) * kScaleStep;
+    scale = std::min(scale, scale_ - kScaleStep);
+  } else if (frames_under_ >= kFramesBeforeIncrease) {
+    scale = scale_ + kScaleStep;
+  }
+  scale = std::max(kMinScale, std::min(1.0f, scale));
+
+  if (scale == scale_)
+    return false;
+  scale_ = scale;
+  frames_over_ = 0;
+  frames_under_ = 0;
+  TRACE_COUNTER1("sky", "ResolutionScalePercent",
+                 static_cast<int>(scale_ * 100));
+  return true;
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,46 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_GPU_RESOLUTION_CONTROLLER_H_
+#define SKY_SHELL_GPU_RESOLUTION_CONTROLLER_H_
+
+#include "base/macros.h"
+#include "base/time/time.h"
+
+namespace sky {
+namespace shell {
+
+// Picks the scale frames are rasterized at from what the recent frames cost,
+// for --dynamic-resolution. The scale drops as soon as a few frames in a row
+// come close to the frame budget, and climbs back one step at a time once
+// frames have been cheap for a while, so that it does not oscillate.
+class ResolutionController {
+ public:
+  // The smallest scale frames are rasterized at.
+  static const float kMinScale;
+  // Scales are multiples of this, so that the offscreen surface is not
+  // reallocated for every small change.
+  static const float kScaleStep;
+
+  ResolutionController();
+  ~ResolutionController();
+
+  float scale() const { return scale_; }
+
+  // Records the cost of a frame drawn at scale(), and returns whether the
+  // scale changed for the next one.
+  bool DidDrawFrame(base::TimeDelta cost);
+
+ private:
+  float scale_;
+  int frames_over_;
+  int frames_under_;
+
+  DISALLOW_COPY_AND_ASSIGN(ResolutionController);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_GPU_RESOLUTION_CONTROLLER_H_
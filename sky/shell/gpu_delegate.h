@@ -7,8 +7,12 @@
 
 #include <memory>
 
+#include "base/callback.h"
 #include "base/memory/scoped_ptr.h"
 #include "sky/compositor/layer_tree.h"
+#include "sky/compositor/scroll_controller.h"
+#include "sky/engine/wtf/RefPtr.h"
+#include "third_party/skia/include/core/SkImage.h"
 #include "ui/gfx/geometry/size.h"
 #include "ui/gfx/native_widget_types.h"
 
@@ -21,8 +25,22 @@ class GPUDelegate {
  public:
   virtual void OnAcceleratedWidgetAvailable(gfx::AcceleratedWidget widget) = 0;
   virtual void OnOutputSurfaceDestroyed() = 0;
+  // The application went into the background and should give up the GPU
+  // memory it can recreate.
+  virtual void OnActivityPaused() = 0;
   virtual void Draw(scoped_ptr<compositor::LayerTree> layer_tree) = 0;
 
+  // Scrolls the scroll layers of the frames on screen without waiting for a
+  // new layer tree.
+  virtual void Scroll(const compositor::ScrollGesture& gesture) = 0;
+
+  typedef base::Callback<void(RefPtr<SkImage>)> ImageCallback;
+  // Rasterizes |layer_tree| into a texture of its frame size instead of the
+  // screen and calls |callback| with the image, or with nullptr on failure.
+  // The image belongs to the GPU thread's GrContext.
+  virtual void RasterizeToImage(scoped_ptr<compositor::LayerTree> layer_tree,
+                                const ImageCallback& callback) = 0;
+
  protected:
   virtual ~GPUDelegate();
 };
@@ -0,0 +1,155 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/jank_tracer.h"
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/files/file_util.h"
+#include "base/memory/ref_counted_memory.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/trace_event/trace_config.h"
+#include "base/trace_event/trace_event.h"
+#include "sky/shell/shell.h"
+#include "sky/shell/synthetic_delays.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Compact enough to leave on: these are the frame, layer and raster events.
+const char kJankTraceCategories[] = "sky";
+
+// A frame that takes longer than this many frame budgets from vsync to
+// screen is worth a report.
+const int kJankFrameBudgets = 3;
+
+// Janky frames tend to come in bursts, and one snapshot covers the burst.
+const int kMinSnapshotIntervalSeconds = 30;
+
+// Snapshots are written to jank_trace_<n>.json, cycling through this many
+// files.
+const int kMaxSnapshots = 4;
+
+const char kTraceStart[] = "{\"traceEvents\":[";
+const char kTraceEnd[] = "]}";
+
+void WriteSnapshotChunk(base::File* file,
+                        const scoped_refptr<base::RefCountedString>& chunk,
+                        bool has_more_events) {
+  const std::string& data = chunk->data();
+  file->WriteAtCurrentPos(data.data(), data.size());
+  if (has_more_events)
+    file->WriteAtCurrentPos(",", 1);
+  else
+    file->WriteAtCurrentPos(kTraceEnd, sizeof(kTraceEnd) - 1);
+}
+
+}  // namespace
+
+JankTracer::JankTracer()
+    : started_(false), suspended_(false), next_snapshot_index_(0) {
+}
+
+JankTracer::~JankTracer() {
+}
+
+void JankTracer::Start(const base::FilePath& directory) {
+  base::AutoLock lock(lock_);
+  DCHECK(!started_);
+  directory_ = directory;
+  started_ = true;
+  if (!suspended_)
+    EnableTracingLocked();
+}
+
+void JankTracer::Suspend() {
+  base::AutoLock lock(lock_);
+  if (suspended_)
+    return;
+  suspended_ = true;
+  if (started_)
+    base::trace_event::TraceLog::GetInstance()->SetDisabled();
+}
+
+void JankTracer::Resume() {
+  base::AutoLock lock(lock_);
+  if (!suspended_)
+    return;
+  suspended_ = false;
+  if (started_)
+    EnableTracingLocked();
+}
+
+void JankTracer::EnableTracingLocked() {
+  lock_.AssertAcquired();
+  // Recording continuously turns the trace buffer into a ring that drops
+  // the oldest events once it is full.
+  base::trace_event::TraceLog::GetInstance()->SetEnabled(
+      base::trace_event::TraceConfig(
+          AddSyntheticDelays(kJankTraceCategories),
+          base::trace_event::RECORD_CONTINUOUSLY),
+      base::trace_event::TraceLog::MONITORING_MODE);
+}
+
+void JankTracer::DidPresentFrame(
+    const compositor::instrumentation::FrameTiming& timing) {
+  if (timing.TotalLatency() <
+      compositor::instrumentation::FrameBudget() * kJankFrameBudgets) {
+    return;
+  }
+
+  base::FilePath path;
+  {
+    base::AutoLock lock(lock_);
+    if (!started_ || suspended_)
+      return;
+    base::TimeTicks now = base::TimeTicks::Now();
+    if (!last_snapshot_time_.is_null() &&
+        now - last_snapshot_time_ <
+            base::TimeDelta::FromSeconds(kMinSnapshotIntervalSeconds)) {
+      return;
+    }
+    last_snapshot_time_ = now;
+    path = directory_.AppendASCII(
+        "jank_trace_" + base::IntToString(next_snapshot_index_) + ".json");
+    next_snapshot_index_ = (next_snapshot_index_ + 1) % kMaxSnapshots;
+  }
+
+  TRACE_EVENT_INSTANT2("sky", "JankTracer::Snapshot", TRACE_EVENT_SCOPE_THREAD,
+                       "frame", timing.frame_number, "latency_us",
+                       timing.TotalLatency().InMicroseconds());
+  // Converting the buffer to JSON takes a while, so it is done on a worker
+  // rather than on the thread that just missed a frame.
+  Shell::Shared()
+      .task_scheduler()
+      .PostTask(FROM_HERE, base::Bind(&JankTracer::WriteSnapshot, path),
+                TaskScheduler::TaskPriority::kBackground);
+}
+
+// static
+void JankTracer::WriteSnapshot(const base::FilePath& path) {
+  if (!base::CreateDirectory(path.DirName())) {
+    LOG(ERROR) << "Could not create " << path.DirName().value();
+    return;
+  }
+
+  base::File file(path,
+                  base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE);
+  if (!file.IsValid()) {
+    LOG(ERROR) << "Could not write jank trace to " << path.value();
+    return;
+  }
+
+  // The buffer is copied and left recording. Events still sitting in a
+  // thread's local chunk are not part of the copy, so the last few events of
+  // each thread may be missing.
+  file.WriteAtCurrentPos(kTraceStart, sizeof(kTraceStart) - 1);
+  base::trace_event::TraceLog::GetInstance()->FlushButLeaveBufferIntact(
+      base::Bind(&WriteSnapshotChunk, base::Unretained(&file)));
+  LOG(INFO) << "Wrote jank trace to " << path.value();
+}
+
+}  // namespace shell
+}  // namespace sky
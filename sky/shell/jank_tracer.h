@@ -0,0 +1,60 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_JANK_TRACER_H_
+#define SKY_SHELL_JANK_TRACER_H_
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+#include "sky/compositor/instrumentation.h"
+
+namespace sky {
+namespace shell {
+
+// Keeps recent "sky" trace events in a bounded ring buffer for as long as the
+// shell runs, and writes the buffer to a file whenever a frame takes far
+// longer than its budget. The events themselves go through TraceLog's usual
+// per-thread chunks, so the cost while nothing janks is that of the trace
+// macros in the sky category.
+//
+// Explicit traces replace the ring buffer while they run, so they have to
+// suspend the tracer before they start and resume it once they are flushed.
+class JankTracer {
+ public:
+  JankTracer();
+  ~JankTracer();
+
+  // Starts recording. Snapshots are written to |directory|, which is created
+  // if needed. Only the most recent few snapshots are kept.
+  void Start(const base::FilePath& directory);
+
+  void Suspend();
+  void Resume();
+
+  // Can be called on any thread, usually the GPU thread once a frame is on
+  // screen.
+  void DidPresentFrame(const compositor::instrumentation::FrameTiming& timing);
+
+ private:
+  // Must be called with |lock_| held.
+  void EnableTracingLocked();
+
+  static void WriteSnapshot(const base::FilePath& path);
+
+  base::Lock lock_;
+  base::FilePath directory_;
+  bool started_;
+  bool suspended_;
+  base::TimeTicks last_snapshot_time_;
+  int next_snapshot_index_;
+
+  DISALLOW_COPY_AND_ASSIGN(JankTracer);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_JANK_TRACER_H_
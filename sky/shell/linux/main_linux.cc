@@ -11,6 +11,7 @@
 #include "sky/shell/service_provider.h"
 #include "sky/shell/shell.h"
 #include "sky/shell/switches.h"
+#include "sky/shell/testing/startup_benchmark.h"
 #include "sky/shell/testing/testing.h"
 
 int main(int argc, const char* argv[]) {
@@ -24,6 +25,11 @@ int main(int argc, const char* argv[]) {
     return 0;
   }
 
+  // Each run of the benchmark is a process of its own, so this one does not
+  // need a shell.
+  if (command_line.HasSwitch(sky::shell::switches::kStartupBenchmark))
+    return sky::shell::RunStartupBenchmark(command_line);
+
   base::MessageLoop message_loop;
 
   sky::shell::Shell::Init(make_scoped_ptr(
@@ -4,11 +4,34 @@
 
 #include "sky/shell/platform_view.h"
 
+#include "base/command_line.h"
+#include "sky/shell/switches.h"
+
 namespace sky {
 namespace shell {
+namespace {
+
+class PlatformViewLinux : public PlatformView {
+ public:
+  explicit PlatformViewLinux(const Config& config) : PlatformView(config) {
+    // There is no window to draw into. Benchmarks still need their frames
+    // drawn, so the rasterizer draws them offscreen.
+    const base::CommandLine& command_line =
+        *base::CommandLine::ForCurrentProcess();
+    if (command_line.HasSwitch(switches::kBenchmark) ||
+        command_line.HasSwitch(switches::kStartupReport)) {
+      SurfaceWasCreated();
+    }
+  }
+
+ private:
+  DISALLOW_COPY_AND_ASSIGN(PlatformViewLinux);
+};
+
+}  // namespace
 
 PlatformView* PlatformView::Create(const Config& config) {
-  return new PlatformView(config);
+  return new PlatformViewLinux(config);
 }
 
 }  // namespace shell
@@ -0,0 +1,117 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/memory_pressure_coordinator.h"
+
+#include "base/bind.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/thread_task_runner_handle.h"
+#include "base/trace_event/trace_event.h"
+
+namespace sky {
+namespace shell {
+
+MemoryPressureCoordinator::MemoryPressureCoordinator()
+    : task_runner_(base::ThreadTaskRunnerHandle::Get()),
+      listener_(new base::MemoryPressureListener(
+          base::Bind(&MemoryPressureCoordinator::OnMemoryPressure,
+                     base::Unretained(this)))),
+      pending_clients_(0),
+      freed_bytes_(0) {
+}
+
+MemoryPressureCoordinator::~MemoryPressureCoordinator() {
+}
+
+void MemoryPressureCoordinator::AddClient(const char* name, Client* client) {
+  DCHECK(client);
+  Registration registration;
+  registration.name = name;
+  registration.client = client;
+  registration.task_runner = base::ThreadTaskRunnerHandle::Get();
+
+  base::AutoLock lock(lock_);
+  clients_.push_back(registration);
+}
+
+void MemoryPressureCoordinator::RemoveClient(Client* client) {
+  base::AutoLock lock(lock_);
+  for (auto it = clients_.begin(); it != clients_.end(); ++it) {
+    if (it->client == client) {
+      DCHECK(it->task_runner->BelongsToCurrentThread());
+      clients_.erase(it);
+      return;
+    }
+  }
+  NOTREACHED();
+}
+
+void MemoryPressureCoordinator::OnMemoryPressure(Level level) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  TRACE_EVENT1("sky", "MemoryPressureCoordinator::OnMemoryPressure", "level",
+               static_cast<int>(level));
+  if (level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_NONE)
+    return;
+
+  // The coordinator belongs to the shell, which is never destroyed, so the
+  // tasks cannot outlive it.
+  base::AutoLock lock(lock_);
+  for (const Registration& registration : clients_) {
+    ++pending_clients_;
+    registration.task_runner->PostTask(
+        FROM_HERE, base::Bind(&MemoryPressureCoordinator::NotifyClient,
+                              base::Unretained(this), registration.name,
+                              registration.client, level));
+  }
+}
+
+void MemoryPressureCoordinator::NotifyClient(const char* name,
+                                             Client* client,
+                                             Level level) {
+  size_t freed_bytes = 0;
+  bool registered = false;
+  {
+    base::AutoLock lock(lock_);
+    for (const Registration& registration : clients_) {
+      if (registration.client == client) {
+        registered = true;
+        break;
+      }
+    }
+  }
+  // Clients are only removed on this thread, so one that is still
+  // registered stays alive while it frees its memory.
+  if (registered)
+    freed_bytes = client->OnMemoryPressure(level);
+
+  task_runner_->PostTask(
+      FROM_HERE, base::Bind(&MemoryPressureCoordinator::DidNotifyClient,
+                            base::Unretained(this), name, level, freed_bytes));
+}
+
+void MemoryPressureCoordinator::DidNotifyClient(const char* name,
+                                                Level level,
+                                                size_t freed_bytes) {
+  DCHECK(task_runner_->BelongsToCurrentThread());
+  TRACE_EVENT_INSTANT2("sky", "MemoryPressure::Freed",
+                       TRACE_EVENT_SCOPE_THREAD, "client", name, "bytes",
+                       freed_bytes);
+  freed_bytes_ += freed_bytes;
+
+  DCHECK_GT(pending_clients_, 0);
+  if (--pending_clients_)
+    return;
+
+  const bool critical =
+      level == base::MemoryPressureListener::MEMORY_PRESSURE_LEVEL_CRITICAL;
+  VLOG(1) << "Freed " << freed_bytes_ << " bytes for "
+          << (critical ? "critical" : "moderate") << " memory pressure.";
+  TRACE_EVENT_INSTANT1("sky", "MemoryPressure::FreedTotal",
+                       TRACE_EVENT_SCOPE_THREAD, "bytes", freed_bytes_);
+  freed_bytes_ = 0;
+}
+
+}  // namespace shell
+}  // namespace sky
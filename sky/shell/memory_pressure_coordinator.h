@@ -0,0 +1,82 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_MEMORY_PRESSURE_COORDINATOR_H_
+#define SKY_SHELL_MEMORY_PRESSURE_COORDINATOR_H_
+
+#include <stddef.h>
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/memory/memory_pressure_listener.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/single_thread_task_runner.h"
+#include "base/synchronization/lock.h"
+
+namespace sky {
+namespace shell {
+
+// Hands the memory pressure signals of the platform to every cache in the
+// engine, each on the thread that owns it, and traces how many bytes they
+// gave back. Moderate pressure trims caches down to what the next frames
+// are likely to need, critical pressure frees everything that can be
+// recreated on demand.
+class MemoryPressureCoordinator {
+ public:
+  using Level = base::MemoryPressureListener::MemoryPressureLevel;
+
+  class Client {
+   public:
+    // Frees memory as appropriate for |level| and returns the number of
+    // bytes freed, or 0 if that is not known.
+    virtual size_t OnMemoryPressure(Level level) = 0;
+
+   protected:
+    virtual ~Client() {}
+  };
+
+  // Has to be created on a thread with a message loop, which is where the
+  // platform's signals are received and the reports are traced.
+  MemoryPressureCoordinator();
+  ~MemoryPressureCoordinator();
+
+  // |client| is notified on the thread that adds it, which has to have a
+  // message loop and is also the only thread it can be removed on. |name|
+  // identifies the client in traces and has to outlive it.
+  void AddClient(const char* name, Client* client);
+  void RemoveClient(Client* client);
+
+ private:
+  struct Registration {
+    const char* name;
+    Client* client;
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner;
+  };
+
+  void OnMemoryPressure(Level level);
+  // Called on the client's thread.
+  void NotifyClient(const char* name, Client* client, Level level);
+  void DidNotifyClient(const char* name, Level level, size_t freed_bytes);
+
+  scoped_refptr<base::SingleThreadTaskRunner> task_runner_;
+  scoped_ptr<base::MemoryPressureListener> listener_;
+
+  // Clients are added and removed on their own threads.
+  base::Lock lock_;
+  std::vector<Registration> clients_;
+
+  // Only accessed on |task_runner_|. Signals that arrive while clients are
+  // still freeing memory for an earlier one are reported together with it.
+  int pending_clients_;
+  size_t freed_bytes_;
+
+  DISALLOW_COPY_AND_ASSIGN(MemoryPressureCoordinator);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_MEMORY_PRESSURE_COORDINATOR_H_
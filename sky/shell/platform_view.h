@@ -7,6 +7,7 @@
 
 #include "base/macros.h"
 #include "base/memory/weak_ptr.h"
+#include "sky/compositor/texture_registry.h"
 #include "sky/shell/ui_delegate.h"
 
 namespace sky {
@@ -20,6 +21,8 @@ class PlatformView {
 
     base::WeakPtr<UIDelegate> ui_delegate;
     scoped_refptr<base::SingleThreadTaskRunner> ui_task_runner;
+    // Where platform views register the external textures they create.
+    scoped_refptr<compositor::TextureRegistry> texture_registry;
   };
 
   static PlatformView* Create(const Config& config);
@@ -0,0 +1,201 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+// Rasterizes the layer trees captured with --capture-layer-trees over and
+// over and reports how long each frame took, so that compositor changes can
+// be measured against real frames without running the app that made them.
+
+#include <stdio.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/at_exit.h"
+#include "base/command_line.h"
+#include "base/files/file_path.h"
+#include "base/logging.h"
+#include "base/memory/scoped_vector.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/time/time.h"
+#include "skia/ext/refptr.h"
+#include "sky/compositor/layer_serialization.h"
+#include "sky/compositor/layer_tree.h"
+#include "sky/compositor/paint_context.h"
+#include "sky/shell/gpu/ganesh_context.h"
+#include "third_party/skia/include/core/SkCanvas.h"
+#include "third_party/skia/include/core/SkStream.h"
+#include "third_party/skia/include/core/SkSurface.h"
+#include "third_party/skia/include/gpu/GrContext.h"
+#include "ui/gl/gl_bindings.h"
+#include "ui/gl/gl_context.h"
+#include "ui/gl/gl_surface.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const char kHelp[] = "help";
+const char kIterations[] = "iterations";
+
+const int kDefaultIterations = 10;
+
+void PrintUsage() {
+  fprintf(stderr,
+          "Usage: sky_replay [--%s=N] CAPTURE\n"
+          "Rasterizes the layer trees in CAPTURE N times (%d by default) "
+          "after one warm-up pass.\n",
+          kIterations, kDefaultIterations);
+}
+
+double Percentile(std::vector<double> samples, double percentile) {
+  if (samples.empty())
+    return 0;
+  std::sort(samples.begin(), samples.end());
+  size_t index = static_cast<size_t>(percentile / 100 * samples.size());
+  return samples[std::min(index, samples.size() - 1)];
+}
+
+bool ReadCapture(const base::FilePath& path,
+                 ScopedVector<compositor::LayerTree>* layer_trees) {
+  SkFILEStream stream(path.value().c_str());
+  if (!stream.isValid()) {
+    LOG(ERROR) << "Could not open " << path.value();
+    return false;
+  }
+  compositor::LayerReader reader(&stream);
+  while (scoped_ptr<compositor::LayerTree> layer_tree = reader.ReadTree())
+    layer_trees->push_back(layer_tree.release());
+  if (reader.failed()) {
+    LOG(ERROR) << path.value() << " is not a complete layer tree capture.";
+    return false;
+  }
+  return true;
+}
+
+class Replayer {
+ public:
+  Replayer() {}
+
+  bool Init() {
+    if (!gfx::GLSurface::InitializeOneOff())
+      return false;
+    surface_ = gfx::GLSurface::CreateOffscreenGLSurface(
+        gfx::Size(1, 1), gfx::SurfaceConfiguration());
+    if (!surface_)
+      return false;
+    context_ = gfx::GLContext::CreateGLContext(nullptr, surface_.get(),
+                                               gfx::PreferIntegratedGpu);
+    if (!context_ || !context_->MakeCurrent(surface_.get()))
+      return false;
+    ganesh_context_.reset(new GaneshContext(
+        context_, GaneshContext::kDefaultResourceCacheBytes, false));
+    return true;
+  }
+
+  // Returns the time it took to rasterize |layer_tree| and for the GPU to
+  // finish drawing it, in milliseconds.
+  double Raster(compositor::LayerTree* layer_tree) {
+    const SkISize& size = layer_tree->frame_size();
+    if (!target_ || target_->width() != size.width() ||
+        target_->height() != size.height()) {
+      target_ = skia::AdoptRef(SkSurface::NewRenderTarget(
+          ganesh_context_->gr(), SkSurface::kNo_Budgeted,
+          SkImageInfo::MakeN32Premul(size.width(), size.height())));
+      CHECK(target_) << "Could not create a " << size.width() << "x"
+                     << size.height() << " render target.";
+    }
+
+    base::TimeTicks start = base::TimeTicks::Now();
+    SkCanvas* canvas = target_->getCanvas();
+    canvas->clear(SK_ColorBLACK);
+    {
+      auto frame =
+          paint_context_.AcquireFrame(*canvas, ganesh_context_->gr());
+      layer_tree->Raster(frame);
+    }
+    canvas->flush();
+    glFinish();
+    return (base::TimeTicks::Now() - start).InMillisecondsF();
+  }
+
+ private:
+  scoped_refptr<gfx::GLSurface> surface_;
+  scoped_refptr<gfx::GLContext> context_;
+  scoped_ptr<GaneshContext> ganesh_context_;
+  skia::RefPtr<SkSurface> target_;
+  compositor::PaintContext paint_context_;
+
+  DISALLOW_COPY_AND_ASSIGN(Replayer);
+};
+
+int Run(const base::CommandLine& command_line) {
+  if (command_line.HasSwitch(kHelp) || command_line.GetArgs().size() != 1) {
+    PrintUsage();
+    return command_line.HasSwitch(kHelp) ? 0 : 1;
+  }
+
+  int iterations = kDefaultIterations;
+  if (command_line.HasSwitch(kIterations) &&
+      (!base::StringToInt(command_line.GetSwitchValueASCII(kIterations),
+                          &iterations) ||
+       iterations <= 0)) {
+    LOG(ERROR) << "Invalid value for --" << kIterations;
+    return 1;
+  }
+
+  ScopedVector<compositor::LayerTree> layer_trees;
+  if (!ReadCapture(base::FilePath(command_line.GetArgs()[0]), &layer_trees))
+    return 1;
+  if (layer_trees.empty()) {
+    LOG(ERROR) << "The capture contains no frames.";
+    return 1;
+  }
+
+  Replayer replayer;
+  if (!replayer.Init()) {
+    LOG(ERROR) << "Could not create a GL context.";
+    return 1;
+  }
+
+  // The first pass compiles shaders and fills the caches, which the frames
+  // on the device found warm as well.
+  for (compositor::LayerTree* layer_tree : layer_trees)
+    replayer.Raster(layer_tree);
+
+  std::vector<std::vector<double>> frame_times(layer_trees.size());
+  std::vector<double> all_times;
+  for (int i = 0; i < iterations; ++i) {
+    for (size_t j = 0; j < layer_trees.size(); ++j) {
+      double time = replayer.Raster(layer_trees[j]);
+      frame_times[j].push_back(time);
+      all_times.push_back(time);
+    }
+  }
+
+  printf("frame\tsize\tp50_ms\tmax_ms\n");
+  for (size_t j = 0; j < layer_trees.size(); ++j) {
+    const SkISize& size = layer_trees[j]->frame_size();
+    printf("%zu\t%dx%d\t%.3f\t%.3f\n", j, size.width(), size.height(),
+           Percentile(frame_times[j], 50), Percentile(frame_times[j], 100));
+  }
+  printf("\n%zu frames, %d iterations: p50 %.3f ms, p90 %.3f ms, "
+         "p99 %.3f ms, max %.3f ms\n",
+         layer_trees.size(), iterations, Percentile(all_times, 50),
+         Percentile(all_times, 90), Percentile(all_times, 99),
+         Percentile(all_times, 100));
+  return 0;
+}
+
+}  // namespace
+}  // namespace shell
+}  // namespace sky
+
+int main(int argc, const char* argv[]) {
+  base::AtExitManager exit_manager;
+  base::CommandLine::Init(argc, argv);
+  // Tracing and the raster cache post tasks to the current loop.
+  base::MessageLoop message_loop;
+  return sky::shell::Run(*base::CommandLine::ForCurrentProcess());
+}
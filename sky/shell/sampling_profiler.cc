@@ -0,0 +1,369 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/sampling_profiler.h"
+
+#include <algorithm>
+
+#include "base/files/file_util.h"
+#include "base/format_macros.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/strings/string_split.h"
+#include "base/strings/stringprintf.h"
+#include "base/values.h"
+#include "build/build_config.h"
+
+#if defined(OS_LINUX) || defined(OS_ANDROID)
+#include <errno.h>
+#include <pthread.h>
+#include <semaphore.h>
+#include <signal.h>
+#include <time.h>
+#include <ucontext.h>
+
+#include "base/atomicops.h"
+#define SAMPLING_PROFILER_SUPPORTED 1
+#endif
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Profiles are meant to cover a few interactions, not to run unattended.
+// This is a little over two minutes of both threads at the default rate.
+const size_t kMaxSamples = 64 * 1024;
+
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+
+// The Dart VM's profiler owns SIGPROF.
+const int kProfilerSignal = SIGURG;
+
+const size_t kMaxFrames = 64;
+
+// How long to wait for a thread to handle the signal. Threads that are
+// stopped in a debugger, for example, are skipped.
+const long kSignalTimeoutNanoseconds = 100 * 1000 * 1000;
+
+// Only one thread is sampled at a time, so the handler and the sampler
+// thread share a single set of globals. |armed| is set by the sampler thread
+// and claimed by whichever comes first: the handler, or the sampler thread
+// giving up on the signal. That way a handler that runs late never writes to
+// a sample that has been moved on from.
+struct SignalState {
+  base::subtle::Atomic32 armed;
+  uintptr_t stack_begin;
+  uintptr_t stack_end;
+  uintptr_t frames[kMaxFrames];
+  size_t frame_count;
+  sem_t done;
+};
+
+SignalState g_signal_state;
+struct sigaction g_previous_action;
+
+bool GetRegisters(void* context, uintptr_t* pc, uintptr_t* fp, uintptr_t* sp) {
+  const mcontext_t& mcontext = static_cast<ucontext_t*>(context)->uc_mcontext;
+#if defined(ARCH_CPU_X86_64)
+  *pc = mcontext.gregs[REG_RIP];
+  *fp = mcontext.gregs[REG_RBP];
+  *sp = mcontext.gregs[REG_RSP];
+#elif defined(ARCH_CPU_X86)
+  *pc = mcontext.gregs[REG_EIP];
+  *fp = mcontext.gregs[REG_EBP];
+  *sp = mcontext.gregs[REG_ESP];
+#elif defined(ARCH_CPU_ARM64)
+  *pc = mcontext.pc;
+  *fp = mcontext.regs[29];
+  *sp = mcontext.sp;
+#elif defined(ARCH_CPU_ARMEL)
+  // Thumb code keeps its frame pointer in r7 rather than r11, so stacks
+  // through Thumb functions end early.
+  *pc = mcontext.arm_pc;
+  *fp = mcontext.arm_fp;
+  *sp = mcontext.arm_sp;
+#else
+  return false;
+#endif
+  return true;
+}
+
+// Frame records are a pair of words: the caller's frame pointer followed by
+// the return address. Only records on the sampled thread's stack are read,
+// and each has to be further up the stack than the last, so that the walk
+// cannot fault or loop on a frame pointer that is used as a general purpose
+// register.
+void WalkStack(void* context) {
+  uintptr_t pc = 0;
+  uintptr_t fp = 0;
+  uintptr_t sp = 0;
+  if (!GetRegisters(context, &pc, &fp, &sp))
+    return;
+
+  size_t count = 0;
+  g_signal_state.frames[count++] = pc;
+
+  const uintptr_t stack_end = g_signal_state.stack_end;
+  uintptr_t lower_bound = std::max(sp, g_signal_state.stack_begin);
+  while (count < kMaxFrames && fp >= lower_bound &&
+         fp <= stack_end - 2 * sizeof(uintptr_t) &&
+         fp % sizeof(uintptr_t) == 0) {
+    const uintptr_t* record = reinterpret_cast<const uintptr_t*>(fp);
+    const uintptr_t next_fp = record[0];
+    const uintptr_t return_address = record[1];
+    if (!return_address)
+      break;
+    g_signal_state.frames[count++] = return_address;
+    lower_bound = fp + 2 * sizeof(uintptr_t);
+    fp = next_fp;
+  }
+  g_signal_state.frame_count = count;
+}
+
+void HandleProfilerSignal(int signal, siginfo_t* info, void* context) {
+  const int saved_errno = errno;
+  if (base::subtle::Acquire_CompareAndSwap(&g_signal_state.armed, 1, 0) == 1) {
+    WalkStack(context);
+    sem_post(&g_signal_state.done);
+  }
+  errno = saved_errno;
+}
+
+// Returns false if the sampler thread disarmed the signal before the handler
+// ran.
+bool WaitForHandler() {
+  timespec deadline;
+  clock_gettime(CLOCK_REALTIME, &deadline);
+  deadline.tv_nsec += kSignalTimeoutNanoseconds;
+  if (deadline.tv_nsec >= 1000 * 1000 * 1000) {
+    deadline.tv_sec += 1;
+    deadline.tv_nsec -= 1000 * 1000 * 1000;
+  }
+
+  while (sem_timedwait(&g_signal_state.done, &deadline) != 0) {
+    if (errno == EINTR)
+      continue;
+    if (base::subtle::Acquire_CompareAndSwap(&g_signal_state.armed, 1, 0) == 1)
+      return false;
+    // The handler claimed the sample just as the wait timed out, and is about
+    // to post.
+    while (sem_wait(&g_signal_state.done) != 0 && errno == EINTR) {
+    }
+    break;
+  }
+  return true;
+}
+
+#endif  // defined(SAMPLING_PROFILER_SUPPORTED)
+
+}  // namespace
+
+SamplingProfiler::SamplingProfiler()
+    : samples_per_second_(kDefaultSamplesPerSecond),
+      stop_event_(false, false) {
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  if (is_running())
+    Stop(base::FilePath());
+}
+
+void SamplingProfiler::RegisterCurrentThread(const std::string& name) {
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  ThreadInfo thread;
+  thread.name = name;
+  thread.id = base::PlatformThread::CurrentId();
+  thread.handle = static_cast<uintptr_t>(pthread_self());
+  thread.stack_begin = 0;
+  thread.stack_end = 0;
+
+  pthread_attr_t attributes;
+  if (pthread_getattr_np(pthread_self(), &attributes) == 0) {
+    void* stack_address = nullptr;
+    size_t stack_size = 0;
+    if (pthread_attr_getstack(&attributes, &stack_address, &stack_size) == 0) {
+      thread.stack_begin = reinterpret_cast<uintptr_t>(stack_address);
+      thread.stack_end = thread.stack_begin + stack_size;
+    }
+    pthread_attr_destroy(&attributes);
+  }
+  // Without the bounds of the stack only the innermost frame is recorded.
+  if (!thread.stack_end)
+    LOG(WARNING) << "Could not find the stack of the " << name << " thread.";
+
+  base::AutoLock lock(lock_);
+  threads_.push_back(thread);
+#endif
+}
+
+bool SamplingProfiler::Start(int samples_per_second) {
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  if (is_running() || samples_per_second <= 0)
+    return false;
+
+  if (sem_init(&g_signal_state.done, 0, 0) != 0)
+    return false;
+  base::subtle::NoBarrier_Store(&g_signal_state.armed, 0);
+
+  struct sigaction action = {};
+  action.sa_sigaction = &HandleProfilerSignal;
+  action.sa_flags = SA_SIGINFO | SA_RESTART;
+  sigemptyset(&action.sa_mask);
+  if (sigaction(kProfilerSignal, &action, &g_previous_action) != 0) {
+    sem_destroy(&g_signal_state.done);
+    return false;
+  }
+
+  samples_per_second_ = samples_per_second;
+  samples_.clear();
+  stop_event_.Reset();
+  start_time_ = base::TimeTicks::Now();
+  if (!base::PlatformThread::Create(0, this, &sampler_thread_)) {
+    sigaction(kProfilerSignal, &g_previous_action, nullptr);
+    sem_destroy(&g_signal_state.done);
+    return false;
+  }
+  return true;
+#else
+  LOG(ERROR) << "Native profiling is not supported on this platform.";
+  return false;
+#endif
+}
+
+bool SamplingProfiler::Stop(const base::FilePath& path) {
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  if (!is_running())
+    return false;
+
+  stop_event_.Signal();
+  base::PlatformThread::Join(sampler_thread_);
+  sampler_thread_ = base::PlatformThreadHandle();
+  sigaction(kProfilerSignal, &g_previous_action, nullptr);
+  sem_destroy(&g_signal_state.done);
+
+  if (path.empty())
+    return false;
+
+  std::string json;
+  base::JSONWriter::Write(*ToValue(), &json);
+  samples_.clear();
+  if (base::WriteFile(path, json.data(), json.size()) !=
+      static_cast<int>(json.size())) {
+    LOG(ERROR) << "Could not write " << path.value();
+    return false;
+  }
+  return true;
+#else
+  return false;
+#endif
+}
+
+void SamplingProfiler::ThreadMain() {
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  base::PlatformThread::SetName("sky_profiler");
+
+  const base::TimeDelta interval =
+      base::TimeDelta::FromSeconds(1) / samples_per_second_;
+  bool warned = false;
+  while (!stop_event_.TimedWait(interval)) {
+    if (samples_.size() >= kMaxSamples) {
+      if (!warned)
+        LOG(WARNING) << "The profile is full, no more samples are taken.";
+      warned = true;
+      continue;
+    }
+
+    std::vector<ThreadInfo> threads;
+    {
+      base::AutoLock lock(lock_);
+      threads = threads_;
+    }
+    for (size_t i = 0; i < threads.size(); ++i)
+      SampleThread(i, threads[i]);
+  }
+#else
+  NOTREACHED();
+#endif
+}
+
+void SamplingProfiler::SampleThread(size_t thread_index,
+                                    const ThreadInfo& thread) {
+#if defined(SAMPLING_PROFILER_SUPPORTED)
+  g_signal_state.stack_begin = thread.stack_begin;
+  g_signal_state.stack_end = thread.stack_end;
+  g_signal_state.frame_count = 0;
+  base::subtle::Release_Store(&g_signal_state.armed, 1);
+
+  const base::TimeTicks time = base::TimeTicks::Now();
+  if (pthread_kill(static_cast<pthread_t>(thread.handle), kProfilerSignal) !=
+          0 ||
+      !WaitForHandler()) {
+    base::subtle::NoBarrier_Store(&g_signal_state.armed, 0);
+    return;
+  }
+
+  Sample sample;
+  sample.thread_index = thread_index;
+  sample.time = time - start_time_;
+  sample.frames.assign(g_signal_state.frames,
+                       g_signal_state.frames + g_signal_state.frame_count);
+  samples_.push_back(sample);
+#endif
+}
+
+// The profile keeps the addresses as they were sampled, along with the
+// memory map needed to turn them into offsets into the engine's libraries:
+//
+//   {
+//     "samplesPerSecond": 250,
+//     "threads": [{"name": "ui", "id": 1234}, ...],
+//     "samples": [{"thread": 0, "time": 4000, "frames": ["0x7f...", ...]}],
+//     "maps": [<the lines of /proc/self/maps>]
+//   }
+//
+// Sample times are in microseconds since profiling started, and frames are
+// listed from the innermost one out.
+scoped_ptr<base::DictionaryValue> SamplingProfiler::ToValue() const {
+  scoped_ptr<base::DictionaryValue> profile(new base::DictionaryValue());
+  profile->SetInteger("samplesPerSecond", samples_per_second_);
+
+  scoped_ptr<base::ListValue> threads(new base::ListValue());
+  {
+    base::AutoLock lock(lock_);
+    for (const ThreadInfo& thread : threads_) {
+      scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue());
+      value->SetString("name", thread.name);
+      value->SetInteger("id", thread.id);
+      threads->Append(value.Pass());
+    }
+  }
+  profile->Set("threads", threads.Pass());
+
+  scoped_ptr<base::ListValue> samples(new base::ListValue());
+  for (const Sample& sample : samples_) {
+    scoped_ptr<base::DictionaryValue> value(new base::DictionaryValue());
+    value->SetInteger("thread", sample.thread_index);
+    value->SetDouble("time", sample.time.InMicroseconds());
+    scoped_ptr<base::ListValue> frames(new base::ListValue());
+    for (uintptr_t frame : sample.frames)
+      frames->AppendString(base::StringPrintf("0x%" PRIxPTR, frame));
+    value->Set("frames", frames.Pass());
+    samples->Append(value.Pass());
+  }
+  profile->Set("samples", samples.Pass());
+
+  std::string maps;
+  base::ReadFileToString(base::FilePath("/proc/self/maps"), &maps);
+  scoped_ptr<base::ListValue> map_lines(new base::ListValue());
+  for (const std::string& line : base::SplitString(
+           maps, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY)) {
+    map_lines->AppendString(line);
+  }
+  profile->Set("maps", map_lines.Pass());
+
+  return profile;
+}
+
+}  // namespace shell
+}  // namespace sky
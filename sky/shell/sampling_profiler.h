@@ -0,0 +1,102 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_SAMPLING_PROFILER_H_
+#define SKY_SHELL_SAMPLING_PROFILER_H_
+
+#include <stdint.h>
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/synchronization/lock.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/platform_thread.h"
+#include "base/time/time.h"
+
+namespace base {
+class DictionaryValue;
+}
+
+namespace sky {
+namespace shell {
+
+// Samples the native stacks of the threads registered with it, such as the
+// UI and GPU threads, which the Dart profiler does not see into. A sampler
+// thread interrupts each registered thread in turn with a signal, and the
+// handler records the program counter and the return addresses found by
+// following frame pointers. Full stacks therefore need a build with frame
+// pointers (enable_profiling = true); other builds mostly record only the
+// innermost frame.
+//
+// Profiles hold raw addresses along with the memory map of the process, and
+// are symbolized offline with sky/tools/symbolize_profile.py.
+//
+// Only Linux and Android are supported. Elsewhere Start fails.
+class SamplingProfiler : public base::PlatformThread::Delegate {
+ public:
+  static const int kDefaultSamplesPerSecond = 250;
+
+  SamplingProfiler();
+  ~SamplingProfiler() override;
+
+  // Adds the calling thread to the threads that are sampled. Threads have to
+  // outlive the profiler, which is the case for the shell's threads.
+  void RegisterCurrentThread(const std::string& name);
+
+  // Returns false if profiling is not supported or already running.
+  bool Start(int samples_per_second);
+
+  // Stops sampling and writes the profile to |path|, unless it is empty.
+  // Returns false if the profiler was not running or nothing was written.
+  bool Stop(const base::FilePath& path);
+
+  bool is_running() const { return !sampler_thread_.is_null(); }
+
+ private:
+  struct ThreadInfo {
+    std::string name;
+    base::PlatformThreadId id;
+    // A pthread_t, which is all the handler needs to know.
+    uintptr_t handle;
+    // The bounds of the thread's stack, which frame pointers have to point
+    // into to be followed.
+    uintptr_t stack_begin;
+    uintptr_t stack_end;
+  };
+
+  struct Sample {
+    size_t thread_index;
+    base::TimeDelta time;
+    std::vector<uintptr_t> frames;
+  };
+
+  // base::PlatformThread::Delegate:
+  void ThreadMain() override;
+
+  void SampleThread(size_t thread_index, const ThreadInfo& thread);
+  scoped_ptr<base::DictionaryValue> ToValue() const;
+
+  mutable base::Lock lock_;
+  // Guarded by |lock_|.
+  std::vector<ThreadInfo> threads_;
+
+  // Only accessed by the sampler thread while it runs.
+  int samples_per_second_;
+  base::TimeTicks start_time_;
+  std::vector<Sample> samples_;
+
+  base::PlatformThreadHandle sampler_thread_;
+  base::WaitableEvent stop_event_;
+
+  DISALLOW_COPY_AND_ASSIGN(SamplingProfiler);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_SAMPLING_PROFILER_H_
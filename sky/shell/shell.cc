@@ -4,15 +4,22 @@
 
 #include "sky/shell/shell.h"
 
+#include "base/base_paths.h"
 #include "base/bind.h"
+#include "base/command_line.h"
 #include "base/i18n/icu_util.h"
-#include "base/lazy_instance.h"
-#include "base/memory/discardable_memory.h"
-#include "base/memory/discardable_memory_allocator.h"
+#include "base/logging.h"
+#include "base/path_service.h"
 #include "base/single_thread_task_runner.h"
+#include "base/trace_event/memory_dump_manager.h"
 #include "mojo/message_pump/message_pump_mojo.h"
 #include "mojo/edk/embedder/embedder.h"
 #include "mojo/edk/embedder/simple_platform_support.h"
+#include "sky/shell/discardable_memory_allocator.h"
+#include "sky/shell/startup_timeline.h"
+#include "sky/shell/switches.h"
+#include "sky/shell/synthetic_delays.h"
+#include "sky/shell/thread_affinity.h"
 #include "sky/shell/ui/engine.h"
 #include "ui/gl/gl_surface.h"
 
@@ -26,37 +33,36 @@ scoped_ptr<base::MessagePump> CreateMessagePumpMojo() {
   return make_scoped_ptr(new mojo::common::MessagePumpMojo);
 }
 
-class NonDiscardableMemory : public base::DiscardableMemory {
- public:
-  explicit NonDiscardableMemory(size_t size) : data_(new uint8_t[size]) {}
-  bool Lock() override { return false; }
-  void Unlock() override {}
-  void* data() const override { return data_.get(); }
-
- private:
-  scoped_ptr<uint8_t[]> data_;
-};
-
-class NonDiscardableMemoryAllocator : public base::DiscardableMemoryAllocator {
- public:
-  scoped_ptr<base::DiscardableMemory> AllocateLockedDiscardableMemory(
-      size_t size) override {
-    return make_scoped_ptr(new NonDiscardableMemory(size));
-  }
-};
+// Unlocked discardable memory holds decoded images that are not being drawn
+// right now. Beyond this, the least recently used ones are decoded again
+// when they are next needed.
+const size_t kUnlockedDiscardableMemoryBytes = 64 * 1024 * 1024;
+
+const char kJankTracesDirectory[] = "jank_traces";
 
-base::LazyInstance<NonDiscardableMemoryAllocator> g_discardable;
+// Never deleted, since memory it hands out can outlive the shell.
+DiscardableMemoryAllocator* g_discardable = nullptr;
+
+void PinToFastCores(const char* thread_name) {
+  if (!SetCurrentThreadAffinity(CoreClass::kFast))
+    LOG(WARNING) << "Could not pin the " << thread_name << " thread.";
+}
 
 }  // namespace
 
 Shell::Shell(scoped_ptr<ServiceProviderContext> service_provider_context)
-    : service_provider_context_(service_provider_context.Pass()) {
+    : service_provider_context_(service_provider_context.Pass()),
+      task_scheduler_(TaskScheduler::DefaultThreadCount()) {
   DCHECK(!g_shell);
   mojo::embedder::Init(scoped_ptr<mojo::embedder::PlatformSupport>(
       new mojo::embedder::SimplePlatformSupport()));
+  InitSyntheticDelays();
 
   base::Thread::Options options;
   options.message_pump_factory = base::Bind(&CreateMessagePumpMojo);
+  // Both threads work on every frame, so they run ahead of the task
+  // scheduler's workers.
+  options.priority = base::ThreadPriority::DISPLAY;
 
   gpu_thread_.reset(new base::Thread("gpu_thread"));
   gpu_thread_->StartWithOptions(options);
@@ -64,20 +70,65 @@ Shell::Shell(scoped_ptr<ServiceProviderContext> service_provider_context)
   ui_thread_.reset(new base::Thread("ui_thread"));
   ui_thread_->StartWithOptions(options);
 
-  ui_task_runner()->PostTask(FROM_HERE, base::Bind(&Engine::Init));
+  SamplingProfiler* profiler = &tracing_controller_.sampling_profiler();
+  gpu_task_runner()->PostTask(
+      FROM_HERE, base::Bind(&SamplingProfiler::RegisterCurrentThread,
+                            base::Unretained(profiler), "gpu"));
+  ui_task_runner()->PostTask(
+      FROM_HERE, base::Bind(&SamplingProfiler::RegisterCurrentThread,
+                            base::Unretained(profiler), "ui"));
+
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableThreadAffinity)) {
+    gpu_task_runner()->PostTask(FROM_HERE,
+                                base::Bind(&PinToFastCores, "gpu"));
+    ui_task_runner()->PostTask(FROM_HERE, base::Bind(&PinToFastCores, "ui"));
+  }
+
+  // The shell is not published through Shared() until this constructor
+  // returns, so tasks posted from here get what they need bound in.
+  ui_task_runner()->PostTask(
+      FROM_HERE, base::Bind(&Engine::Init,
+                            base::Unretained(&memory_pressure_coordinator_),
+                            base::Unretained(&task_scheduler_)));
+  ui_task_runner()->PostTask(
+      FROM_HERE, base::Bind(&MemoryPressureCoordinator::AddClient,
+                            base::Unretained(&memory_pressure_coordinator_),
+                            "discardable_memory",
+                            base::Unretained(g_discardable)));
+
+  base::FilePath cache_dir;
+  if (!base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kDisableJankTraces) &&
+      PathService::Get(base::DIR_CACHE, &cache_dir)) {
+    tracing_controller_.jank_tracer().Start(
+        cache_dir.AppendASCII(kJankTracesDirectory));
+  }
 }
 
 Shell::~Shell() {
 }
 
 void Shell::Init(scoped_ptr<ServiceProviderContext> service_provider_context) {
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::ShellInitStart);
   CHECK(base::i18n::InitializeICU());
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::ICUInitialized);
 #if !defined(OS_LINUX)
   CHECK(gfx::GLSurface::InitializeOneOff());
 #endif
-  base::DiscardableMemoryAllocator::SetInstance(&g_discardable.Get());
+  g_discardable =
+      new DiscardableMemoryAllocator(kUnlockedDiscardableMemoryBytes);
+  base::DiscardableMemoryAllocator::SetInstance(g_discardable);
+
+  // Memory dumps are taken while the memory-infra category is traced, which
+  // the manager only notices once it is initialized.
+  base::trace_event::MemoryDumpManager::GetInstance()->Initialize();
 
   g_shell = new Shell(service_provider_context.Pass());
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::ShellInitialized);
 }
 
 Shell& Shell::Shared() {
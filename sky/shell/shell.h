@@ -10,7 +10,9 @@
 #include "base/memory/scoped_ptr.h"
 #include "base/message_loop/message_loop.h"
 #include "base/threading/thread.h"
+#include "sky/shell/memory_pressure_coordinator.h"
 #include "sky/shell/service_provider.h"
+#include "sky/shell/task_scheduler.h"
 #include "sky/shell/tracing_controller.h"
 
 namespace sky {
@@ -39,6 +41,13 @@ class Shell {
 
   TracingController& tracing_controller();
 
+  MemoryPressureCoordinator& memory_pressure_coordinator() {
+    return memory_pressure_coordinator_;
+  }
+
+  // Runs the engine's and the shell's worker tasks.
+  TaskScheduler& task_scheduler() { return task_scheduler_; }
+
  private:
   explicit Shell(scoped_ptr<ServiceProviderContext> service_provider_context);
 
@@ -49,6 +58,8 @@ class Shell {
   scoped_ptr<base::Thread> ui_thread_;
   scoped_ptr<ServiceProviderContext> service_provider_context_;
   TracingController tracing_controller_;
+  MemoryPressureCoordinator memory_pressure_coordinator_;
+  TaskScheduler task_scheduler_;
 
   DISALLOW_COPY_AND_ASSIGN(Shell);
 };
@@ -36,18 +36,27 @@ ShellView::~ShellView() {
       base::Bind(&Drop<Engine>, base::Passed(&engine_)));
 }
 
+base::WeakPtr<Rasterizer> ShellView::GetRasterizer() {
+  return rasterizer_->GetWeakPtr();
+}
+
 void ShellView::CreateEngine() {
   Engine::Config config;
   config.service_provider_context = shell_.service_provider_context();
   config.gpu_task_runner = shell_.gpu_task_runner();
   config.gpu_delegate = rasterizer_->GetWeakPtr();
+  config.compositor_statistics = rasterizer_->statistics();
+  config.scroll_offsets = rasterizer_->scroll_offsets();
   engine_.reset(new Engine(config));
+  rasterizer_->set_scroll_content_callback(base::Bind(
+      &Engine::OnScrollContentRequested, engine_->GetWeakPtr()));
 }
 
 void ShellView::CreatePlatformView() {
   PlatformView::Config config;
   config.ui_task_runner = shell_.ui_task_runner();
   config.ui_delegate = engine_->GetWeakPtr();
+  config.texture_registry = rasterizer_->texture_registry();
   view_.reset(PlatformView::Create(config));
 }
 
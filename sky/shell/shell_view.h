@@ -8,6 +8,7 @@
 #include "base/files/file_path.h"
 #include "base/macros.h"
 #include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
 #include "mojo/public/cpp/system/data_pipe.h"
 
 namespace sky {
@@ -24,6 +25,9 @@ class ShellView {
 
   PlatformView* view() const { return view_.get(); }
 
+  // Only to be dereferenced on the GPU thread.
+  base::WeakPtr<Rasterizer> GetRasterizer();
+
   void StartDartTracing();
   void StopDartTracing(mojo::ScopedDataPipeProducerHandle producer);
 
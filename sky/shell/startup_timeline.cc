@@ -0,0 +1,137 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/startup_timeline.h"
+
+#include "base/lazy_instance.h"
+#include "base/location.h"
+#include "base/logging.h"
+#include "base/task_runner.h"
+#include "base/trace_event/trace_event.h"
+#include "build/build_config.h"
+
+#if !defined(OS_IOS)
+#include "base/process/process_info.h"
+#endif
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Leaked, since milestones can be recorded on any thread until the process
+// exits.
+base::LazyInstance<StartupTimeline>::Leaky g_startup_timeline =
+    LAZY_INSTANCE_INITIALIZER;
+
+const char* const kMilestoneNames[] = {
+    "ShellInitStart",
+    "ICUInitialized",
+    "ShellInitialized",
+    "EngineInitialized",
+    "AppRunStart",
+    "SnapshotAvailable",
+    "IsolateCreated",
+    "FirstBeginFrame",
+    "FirstFrameBuilt",
+    "FirstFrameSwapped",
+};
+
+static_assert(arraysize(kMilestoneNames) ==
+                  static_cast<size_t>(StartupTimeline::Milestone::Count),
+              "Every milestone needs a name.");
+
+// The trace ID of the "Startup" span.
+const int kStartupTraceId = 1;
+
+base::TimeTicks GetLaunchTime() {
+  const base::TimeTicks now = base::TimeTicks::Now();
+#if !defined(OS_IOS)
+  const base::Time creation_time = base::CurrentProcessInfo::CreationTime();
+  if (!creation_time.is_null()) {
+    const base::TimeDelta age = base::Time::Now() - creation_time;
+    if (age >= base::TimeDelta())
+      return now - age;
+  }
+#endif
+  // Without a creation time, startup is measured from the first milestone.
+  return now;
+}
+
+}  // namespace
+
+StartupTimeline::StartupTimeline() : launch_time_(GetLaunchTime()) {
+}
+
+StartupTimeline::~StartupTimeline() {
+}
+
+StartupTimeline& StartupTimeline::Shared() {
+  return g_startup_timeline.Get();
+}
+
+const char* StartupTimeline::GetName(Milestone milestone) {
+  return kMilestoneNames[static_cast<int>(milestone)];
+}
+
+void StartupTimeline::Record(Milestone milestone) {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  const int index = static_cast<int>(milestone);
+  const char* name = GetName(milestone);
+  base::Closure first_frame_callback;
+  scoped_refptr<base::TaskRunner> first_frame_task_runner;
+  {
+    base::AutoLock lock(lock_);
+    if (!times_[index].is_null())
+      return;
+    times_[index] = now;
+    milestones_.push_back(std::make_pair(milestone, now - launch_time_));
+    if (milestone == Milestone::FirstFrameSwapped) {
+      first_frame_callback = first_frame_callback_;
+      first_frame_callback_.Reset();
+      first_frame_task_runner.swap(first_frame_task_runner_);
+    }
+  }
+
+  TRACE_EVENT_INSTANT1("sky", "StartupMilestone", TRACE_EVENT_SCOPE_PROCESS,
+                       "milestone", name);
+  // The whole of startup is only known once it is over, so it is traced as
+  // a span after the fact. Tracing has to be enabled at launch to see it.
+  if (milestone == Milestone::FirstFrameSwapped) {
+    TRACE_EVENT_ASYNC_BEGIN_WITH_TIMESTAMP0("sky", "Startup", kStartupTraceId,
+                                            launch_time_.ToInternalValue());
+    for (const auto& reached : GetMilestones()) {
+      TRACE_EVENT_ASYNC_STEP_INTO_WITH_TIMESTAMP0(
+          "sky", "Startup", kStartupTraceId, GetName(reached.first),
+          (launch_time_ + reached.second).ToInternalValue());
+    }
+    TRACE_EVENT_ASYNC_END_WITH_TIMESTAMP0("sky", "Startup", kStartupTraceId,
+                                          now.ToInternalValue());
+  }
+
+  if (!first_frame_callback.is_null())
+    first_frame_task_runner->PostTask(FROM_HERE, first_frame_callback);
+}
+
+StartupTimeline::Milestones StartupTimeline::GetMilestones() {
+  base::AutoLock lock(lock_);
+  return milestones_;
+}
+
+void StartupTimeline::NotifyOnFirstFrame(
+    scoped_refptr<base::TaskRunner> task_runner,
+    const base::Closure& callback) {
+  {
+    base::AutoLock lock(lock_);
+    if (times_[static_cast<int>(Milestone::FirstFrameSwapped)].is_null()) {
+      DCHECK(first_frame_callback_.is_null());
+      first_frame_task_runner_ = task_runner;
+      first_frame_callback_ = callback;
+      return;
+    }
+  }
+  task_runner->PostTask(FROM_HERE, callback);
+}
+
+}  // namespace shell
+}  // namespace sky
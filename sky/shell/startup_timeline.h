@@ -0,0 +1,90 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_STARTUP_TIMELINE_H_
+#define SKY_SHELL_STARTUP_TIMELINE_H_
+
+#include <utility>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/synchronization/lock.h"
+#include "base/time/time.h"
+
+namespace base {
+class TaskRunner;
+template <typename Type>
+struct DefaultLazyInstanceTraits;
+}
+
+namespace sky {
+namespace shell {
+
+// Records when the shell first reaches each phase of startup, measured from
+// the launch of the process, so that the time to the first frame can be
+// broken down. Each milestone is recorded once, the first time it is
+// reached, and is also emitted as a trace event in the "sky" category.
+//
+// Milestones are recorded on whichever thread reaches them.
+class StartupTimeline {
+ public:
+  // In the order they are usually reached.
+  enum class Milestone {
+    ShellInitStart,
+    ICUInitialized,
+    ShellInitialized,
+    // Covers WTF, the font and text code and the Dart VM, which blink
+    // initializes together.
+    EngineInitialized,
+    AppRunStart,
+    SnapshotAvailable,
+    IsolateCreated,
+    FirstBeginFrame,
+    FirstFrameBuilt,
+    FirstFrameSwapped,
+
+    Count,
+  };
+
+  using Milestones = std::vector<std::pair<Milestone, base::TimeDelta>>;
+
+  static StartupTimeline& Shared();
+
+  static const char* GetName(Milestone milestone);
+
+  void Record(Milestone milestone);
+
+  // The milestones reached so far with the time since launch at which they
+  // were reached, in the order they were reached.
+  Milestones GetMilestones();
+
+  // Runs |callback| on |task_runner| once the first frame is on screen, or
+  // right away if it already is.
+  void NotifyOnFirstFrame(scoped_refptr<base::TaskRunner> task_runner,
+                          const base::Closure& callback);
+
+ private:
+  friend struct base::DefaultLazyInstanceTraits<StartupTimeline>;
+
+  StartupTimeline();
+  ~StartupTimeline();
+
+  base::Lock lock_;
+  // Estimated from the creation time of the process, which the system only
+  // reports with a resolution of a few milliseconds.
+  base::TimeTicks launch_time_;
+  base::TimeTicks times_[static_cast<int>(Milestone::Count)];
+  Milestones milestones_;
+  scoped_refptr<base::TaskRunner> first_frame_task_runner_;
+  base::Closure first_frame_callback_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupTimeline);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_STARTUP_TIMELINE_H_
@@ -10,18 +10,74 @@ namespace sky {
 namespace shell {
 namespace switches {
 
+const char kBenchmark[] = "benchmark";
+const char kCaptureFrameCount[] = "capture-frame-count";
+const char kCaptureLayerTrees[] = "capture-layer-trees";
+const char kCompileAll[] = "compile-all";
+const char kCompositorDebug[] = "compositor-debug";
+const char kCountGLCalls[] = "count-gl-calls";
+const char kDisableJankTraces[] = "disable-jank-traces";
+const char kDisableNVPathRendering[] = "disable-nv-path-rendering";
+const char kDisableProgramBinaryCache[] = "disable-program-binary-cache";
+const char kDynamicResolution[] = "dynamic-resolution";
 const char kEnableCheckedMode[] = "enable-checked-mode";
+const char kEnableColorManagement[] = "enable-color-management";
+const char kEnableNativeGestures[] = "enable-native-gestures";
+const char kEnableObservatory[] = "enable-observatory";
+const char kEnableThreadAffinity[] = "enable-thread-affinity";
+const char kGPUResourceCacheMB[] = "gpu-resource-cache-mb";
 const char kHelp[] = "help";
+const char kLibraryCacheDir[] = "library-cache-dir";
+const char kMSAASamples[] = "msaa-samples";
 const char kNonInteractive[] = "non-interactive";
 const char kPackageRoot[] = "package-root";
+const char kPresentationMode[] = "presentation-mode";
 const char kSnapshot[] = "snapshot";
+const char kSnapshotCacheDir[] = "snapshot-cache-dir";
+const char kStartupBenchmark[] = "startup-benchmark";
+const char kStartupReport[] = "startup-report";
+const char kStartupRuns[] = "startup-runs";
+const char kSyntheticDelays[] = "synthetic-delays";
+const char kTraceAllocationSampleBytes[] = "trace-allocation-sample-bytes";
+const char kTraceGPUTime[] = "trace-gpu-time";
+const char kTraceLayerGPUTime[] = "trace-layer-gpu-time";
+const char kWarmUpShaders[] = "warm-up-shaders";
 
 void PrintUsage(const std::string& executable_name) {
   std::cerr << "Usage: " << executable_name
+            << " --" << kBenchmark << "=RESULTS_JSON"
+            << " --" << kCaptureLayerTrees << "=PATH"
+            << " --" << kCaptureFrameCount << "=FRAMES"
+            << " --" << kCompileAll
+            << " --" << kCompositorDebug
+            << "=overdraw,layer-bounds,raster-time,rasterized-images,"
+               "frame-statistics,rasterizer-statistics"
+            << " --" << kCountGLCalls
+            << " --" << kDisableJankTraces
+            << " --" << kDisableNVPathRendering
+            << " --" << kDisableProgramBinaryCache
+            << " --" << kDynamicResolution
             << " --" << kEnableCheckedMode
+            << " --" << kEnableColorManagement
+            << " --" << kEnableNativeGestures
+            << " --" << kEnableObservatory
+            << " --" << kEnableThreadAffinity
+            << " --" << kGPUResourceCacheMB << "=MEGABYTES"
+            << " --" << kLibraryCacheDir << "=DIRECTORY"
+            << " --" << kMSAASamples << "=SAMPLES"
             << " --" << kNonInteractive
             << " --" << kPackageRoot << "=PACKAGE_ROOT"
+            << " --" << kPresentationMode << "=fifo|mailbox|timed"
             << " --" << kSnapshot << "=SNAPSHOT"
+            << " --" << kSnapshotCacheDir << "=DIRECTORY"
+            << " --" << kStartupBenchmark << "=RESULTS_JSON"
+            << " --" << kStartupRuns << "=RUNS"
+            << " --" << kSyntheticDelays
+            << "=NAME;SECONDS[;static|oneshot|alternating],..."
+            << " --" << kTraceAllocationSampleBytes << "=BYTES"
+            << " --" << kTraceGPUTime
+            << " --" << kTraceLayerGPUTime
+            << " --" << kWarmUpShaders
             << " [ MAIN_DART ]" << std::endl;
 }
 
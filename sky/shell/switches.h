@@ -11,11 +11,38 @@ namespace sky {
 namespace shell {
 namespace switches {
 
+extern const char kBenchmark[];
+extern const char kCaptureFrameCount[];
+extern const char kCaptureLayerTrees[];
+extern const char kCompileAll[];
+extern const char kCompositorDebug[];
+extern const char kCountGLCalls[];
+extern const char kDisableJankTraces[];
+extern const char kDisableNVPathRendering[];
+extern const char kDisableProgramBinaryCache[];
+extern const char kDynamicResolution[];
 extern const char kHelp[];
+extern const char kLibraryCacheDir[];
+extern const char kMSAASamples[];
 extern const char kPackageRoot[];
+extern const char kPresentationMode[];
 extern const char kNonInteractive[];
 extern const char kSnapshot[];
+extern const char kSnapshotCacheDir[];
+extern const char kStartupBenchmark[];
+extern const char kStartupReport[];
+extern const char kStartupRuns[];
+extern const char kSyntheticDelays[];
 extern const char kEnableCheckedMode[];
+extern const char kEnableColorManagement[];
+extern const char kEnableNativeGestures[];
+extern const char kEnableObservatory[];
+extern const char kEnableThreadAffinity[];
+extern const char kGPUResourceCacheMB[];
+extern const char kTraceAllocationSampleBytes[];
+extern const char kTraceGPUTime[];
+extern const char kTraceLayerGPUTime[];
+extern const char kWarmUpShaders[];
 
 void PrintUsage(const std::string& executable_name);
 
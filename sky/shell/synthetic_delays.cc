@@ -0,0 +1,73 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/synthetic_delays.h"
+
+#include <vector>
+
+#include "base/command_line.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_split.h"
+#include "base/time/time.h"
+#include "base/trace_event/trace_event_synthetic_delay.h"
+#include "sky/shell/switches.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+std::vector<std::string> CommandLineDelays() {
+  return base::SplitString(
+      base::CommandLine::ForCurrentProcess()->GetSwitchValueASCII(
+          switches::kSyntheticDelays),
+      ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+}
+
+// Parsed the way TraceLog parses the delays of a trace config.
+void ApplyDelay(const std::string& delay) {
+  std::vector<std::string> tokens = base::SplitString(
+      delay, ";", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  double seconds = 0;
+  if (tokens.size() < 2 || !base::StringToDouble(tokens[1], &seconds)) {
+    LOG(ERROR) << "Invalid synthetic delay '" << delay << "'.";
+    return;
+  }
+
+  base::trace_event::TraceEventSyntheticDelay* synthetic_delay =
+      base::trace_event::TraceEventSyntheticDelay::Lookup(tokens[0]);
+  synthetic_delay->SetTargetDuration(
+      base::TimeDelta::FromMicroseconds(seconds * 1e6));
+  for (size_t i = 2; i < tokens.size(); ++i) {
+    if (tokens[i] == "static") {
+      synthetic_delay->SetMode(
+          base::trace_event::TraceEventSyntheticDelay::STATIC);
+    } else if (tokens[i] == "oneshot") {
+      synthetic_delay->SetMode(
+          base::trace_event::TraceEventSyntheticDelay::ONE_SHOT);
+    } else if (tokens[i] == "alternating") {
+      synthetic_delay->SetMode(
+          base::trace_event::TraceEventSyntheticDelay::ALTERNATING);
+    } else {
+      LOG(ERROR) << "Invalid synthetic delay mode '" << tokens[i] << "'.";
+    }
+  }
+}
+
+}  // namespace
+
+void InitSyntheticDelays() {
+  for (const std::string& delay : CommandLineDelays())
+    ApplyDelay(delay);
+}
+
+std::string AddSyntheticDelays(const std::string& category_filter) {
+  std::string result = category_filter;
+  for (const std::string& delay : CommandLineDelays())
+    result += ",DELAY(" + delay + ")";
+  return result;
+}
+
+}  // namespace shell
+}  // namespace sky
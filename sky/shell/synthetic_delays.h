@@ -0,0 +1,38 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_SYNTHETIC_DELAYS_H_
+#define SKY_SHELL_SYNTHETIC_DELAYS_H_
+
+#include <string>
+
+namespace sky {
+namespace shell {
+
+// Synthetic delays stretch stages of the pipeline to take at least a given
+// time, to see how frame scheduling, frame dropping and input coalescing
+// cope with a slow UI or GPU thread. The stages are:
+//
+//   sky.BeginFrame    building a frame in Animator::BeginFrame
+//   sky.Draw          drawing a layer tree in Rasterizer::Draw
+//   sky.ImageDecode   decoding an image on a worker
+//   sky.AssetFetch    reading an asset out of a bundle
+//   sky.MojoDispatch  Dart handling a message, such as a mojo response
+//
+// --synthetic-delays takes comma separated delays in the form trace configs
+// give them, "name;seconds[;static|oneshot|alternating]". Trace configs can
+// also carry them as DELAY(...) categories.
+
+// Sets up the delays given on the command line.
+void InitSyntheticDelays();
+
+// Returns |category_filter| with the delays given on the command line added,
+// for the trace configs the shell starts tracing with. Starting to trace
+// resets the delays to those of the config.
+std::string AddSyntheticDelays(const std::string& category_filter);
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_SYNTHETIC_DELAYS_H_
@@ -0,0 +1,291 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/task_scheduler.h"
+
+#include <algorithm>
+
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
+#include "base/threading/platform_thread.h"
+#include "base/threading/simple_thread.h"
+#include "base/threading/thread_local.h"
+#include "base/trace_event/trace_event.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const int kUserBlocking =
+    static_cast<int>(TaskScheduler::TaskPriority::kUserBlocking);
+const int kBackground =
+    static_cast<int>(TaskScheduler::TaskPriority::kBackground);
+
+bool PopFront(std::deque<base::PendingTask>* tasks, base::PendingTask* task) {
+  if (tasks->empty())
+    return false;
+  *task = tasks->front();
+  tasks->pop_front();
+  return true;
+}
+
+}  // namespace
+
+class TaskScheduler::SchedulerTaskRunner : public base::TaskRunner {
+ public:
+  SchedulerTaskRunner(TaskScheduler* scheduler, TaskPriority priority)
+      : scheduler_(scheduler), priority_(priority) {}
+
+  // base::TaskRunner:
+  bool PostDelayedTask(const tracked_objects::Location& from_here,
+                       const base::Closure& task,
+                       base::TimeDelta delay) override {
+    DCHECK_EQ(delay.InMillisecondsRoundedUp(), 0)
+        << "TaskScheduler does not support delayed tasks";
+    return scheduler_->PostTask(from_here, task, priority_);
+  }
+
+  bool RunsTasksOnCurrentThread() const override {
+    return scheduler_->RunsTasksOnCurrentThread();
+  }
+
+ private:
+  ~SchedulerTaskRunner() override {}
+
+  TaskScheduler* const scheduler_;
+  const TaskPriority priority_;
+
+  DISALLOW_COPY_AND_ASSIGN(SchedulerTaskRunner);
+};
+
+class TaskScheduler::Worker : public base::DelegateSimpleThread::Delegate {
+ public:
+  Worker(TaskScheduler* scheduler, int index)
+      : scheduler_(scheduler),
+        index_(index),
+        thread_(this, base::StringPrintf("sky_worker_%d", index + 1)) {}
+
+  ~Worker() override {}
+
+  // The worker whose thread this is, if any.
+  static Worker* Current() { return current_.Get().Get(); }
+
+  TaskScheduler* scheduler() const { return scheduler_; }
+  int index() const { return index_; }
+
+  void Start() { thread_.Start(); }
+  void Join() { thread_.Join(); }
+
+  // Called on the worker's thread. The worker takes its own tasks newest
+  // first, while they are likely to still be in its core's cache.
+  void PushTask(const base::PendingTask& task, int priority) {
+    base::AutoLock lock(lock_);
+    queues_.tasks[priority].push_back(task);
+  }
+
+  bool PopTask(int priority, base::PendingTask* task) {
+    base::AutoLock lock(lock_);
+    std::deque<base::PendingTask>& tasks = queues_.tasks[priority];
+    if (tasks.empty())
+      return false;
+    *task = tasks.back();
+    tasks.pop_back();
+    return true;
+  }
+
+  // Called on other workers' threads, which take the oldest task.
+  bool StealTask(int priority, base::PendingTask* task) {
+    base::AutoLock lock(lock_);
+    return PopFront(&queues_.tasks[priority], task);
+  }
+
+  // base::DelegateSimpleThread::Delegate:
+  void Run() override {
+    current_.Get().Set(this);
+    // Even user-blocking work yields to the UI and GPU threads, which run at
+    // display priority, since a missed frame is worse than a late image.
+    base::PlatformThread::SetCurrentThreadPriority(
+        base::ThreadPriority::BACKGROUND);
+    base::PendingTask task(FROM_HERE, base::Closure());
+    bool background = false;
+    while (scheduler_->WaitForWork()) {
+      while (scheduler_->TakeTask(this, &task, &background)) {
+        TRACE_EVENT2("sky", "TaskScheduler::RunTask", "src_file",
+                     task.posted_from.file_name(), "src_func",
+                     task.posted_from.function_name());
+        task.task.Run();
+        // Whatever the task bound is released before the next one runs.
+        task.task.Reset();
+        if (background)
+          scheduler_->DidRunBackgroundTask();
+      }
+    }
+    current_.Get().Set(nullptr);
+  }
+
+ private:
+  static base::LazyInstance<base::ThreadLocalPointer<Worker>>::Leaky current_;
+
+  TaskScheduler* const scheduler_;
+  const int index_;
+
+  // Tasks posted by this worker's thread, which other workers steal from.
+  base::Lock lock_;
+  TaskQueues queues_;
+
+  base::DelegateSimpleThread thread_;
+
+  DISALLOW_COPY_AND_ASSIGN(Worker);
+};
+
+base::LazyInstance<base::ThreadLocalPointer<TaskScheduler::Worker>>::Leaky
+    TaskScheduler::Worker::current_ = LAZY_INSTANCE_INITIALIZER;
+
+TaskScheduler::TaskScheduler(int thread_count)
+    : wake_up_(&lock_),
+      sleeping_workers_(0),
+      shutting_down_(0),
+      background_workers_(0),
+      max_background_workers_(std::max(1, thread_count / 2)) {
+  DCHECK_GT(thread_count, 0);
+  for (int i = 0; i < kPriorityCount; ++i) {
+    queued_tasks_[i] = 0;
+    task_runners_[i] =
+        new SchedulerTaskRunner(this, static_cast<TaskPriority>(i));
+  }
+  for (int i = 0; i < thread_count; ++i)
+    workers_.push_back(new Worker(this, i));
+  for (Worker* worker : workers_)
+    worker->Start();
+}
+
+TaskScheduler::~TaskScheduler() {
+  {
+    base::AutoLock lock(lock_);
+    base::subtle::Release_Store(&shutting_down_, 1);
+    wake_up_.Broadcast();
+  }
+  for (Worker* worker : workers_)
+    worker->Join();
+}
+
+int TaskScheduler::DefaultThreadCount() {
+  return std::max(1, base::SysInfo::NumberOfProcessors());
+}
+
+scoped_refptr<base::TaskRunner> TaskScheduler::task_runner(
+    TaskPriority priority) const {
+  return task_runners_[static_cast<int>(priority)];
+}
+
+bool TaskScheduler::PostTask(const tracked_objects::Location& from_here,
+                             const base::Closure& task,
+                             TaskPriority priority) {
+  DCHECK(!task.is_null());
+  const int index = static_cast<int>(priority);
+  base::PendingTask pending_task(from_here, task);
+
+  Worker* worker = Worker::Current();
+  const bool own_worker = worker && worker->scheduler() == this;
+  if (own_worker)
+    worker->PushTask(pending_task, index);
+
+  base::AutoLock lock(lock_);
+  if (base::subtle::NoBarrier_Load(&shutting_down_))
+    return false;
+  if (!own_worker)
+    shared_queues_.tasks[index].push_back(pending_task);
+  // Sleeping workers check the count with |lock_| held, so they either see
+  // the task or are woken up for it.
+  base::subtle::Barrier_AtomicIncrement(&queued_tasks_[index], 1);
+  if (sleeping_workers_)
+    wake_up_.Signal();
+  return true;
+}
+
+bool TaskScheduler::RunsTasksOnCurrentThread() const {
+  Worker* worker = Worker::Current();
+  return worker && worker->scheduler() == this;
+}
+
+bool TaskScheduler::TakeTask(Worker* worker,
+                             base::PendingTask* task,
+                             bool* background) {
+  if (base::subtle::Acquire_Load(&shutting_down_))
+    return false;
+
+  for (int priority = kUserBlocking; priority <= kBackground; ++priority) {
+    if (!base::subtle::Acquire_Load(&queued_tasks_[priority]))
+      continue;
+
+    if (priority == kBackground) {
+      // Claim one of the background slots before looking for a task.
+      base::subtle::Atomic32 running =
+          base::subtle::NoBarrier_Load(&background_workers_);
+      while (true) {
+        if (running >= max_background_workers_)
+          return false;
+        base::subtle::Atomic32 previous =
+            base::subtle::Acquire_CompareAndSwap(&background_workers_,
+                                                 running, running + 1);
+        if (previous == running)
+          break;
+        running = previous;
+      }
+    }
+
+    bool found = worker->PopTask(priority, task);
+    if (!found) {
+      base::AutoLock lock(lock_);
+      found = PopFront(&shared_queues_.tasks[priority], task);
+    }
+    for (size_t i = 1; !found && i < workers_.size(); ++i) {
+      Worker* victim = workers_[(worker->index() + i) % workers_.size()];
+      found = victim->StealTask(priority, task);
+    }
+
+    if (found) {
+      base::subtle::Barrier_AtomicIncrement(&queued_tasks_[priority], -1);
+      *background = priority == kBackground;
+      return true;
+    }
+
+    if (priority == kBackground)
+      base::subtle::Barrier_AtomicIncrement(&background_workers_, -1);
+  }
+  return false;
+}
+
+bool TaskScheduler::WaitForWork() {
+  base::AutoLock lock(lock_);
+  while (true) {
+    if (base::subtle::NoBarrier_Load(&shutting_down_))
+      return false;
+    if (base::subtle::NoBarrier_Load(&queued_tasks_[kUserBlocking]) > 0)
+      return true;
+    if (base::subtle::NoBarrier_Load(&queued_tasks_[kBackground]) > 0 &&
+        base::subtle::NoBarrier_Load(&background_workers_) <
+            max_background_workers_) {
+      return true;
+    }
+    ++sleeping_workers_;
+    wake_up_.Wait();
+    --sleeping_workers_;
+  }
+}
+
+void TaskScheduler::DidRunBackgroundTask() {
+  base::subtle::Barrier_AtomicIncrement(&background_workers_, -1);
+  // A worker may have gone to sleep because every background slot was taken.
+  base::AutoLock lock(lock_);
+  if (sleeping_workers_ &&
+      base::subtle::NoBarrier_Load(&queued_tasks_[kBackground]) > 0) {
+    wake_up_.Signal();
+  }
+}
+
+}  // namespace shell
+}  // namespace sky
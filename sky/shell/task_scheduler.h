@@ -0,0 +1,106 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_TASK_SCHEDULER_H_
+#define SKY_SHELL_TASK_SCHEDULER_H_
+
+#include <deque>
+#include <vector>
+
+#include "base/atomicops.h"
+#include "base/callback.h"
+#include "base/location.h"
+#include "base/macros.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_vector.h"
+#include "base/pending_task.h"
+#include "base/synchronization/condition_variable.h"
+#include "base/synchronization/lock.h"
+#include "base/task_runner.h"
+
+namespace sky {
+namespace shell {
+
+// A fixed set of threads that runs the engine's background work, in place
+// of a thread or pool per subsystem. Each thread keeps the tasks it posts
+// itself in queues of its own, and threads that run out of work take tasks
+// from the others before they go to sleep.
+//
+// Work the user is waiting for runs ahead of background work, and at most
+// half of the threads run background work at any one time, so that there is
+// always a core free for the next decode of an image on screen. All of the
+// threads run at background priority.
+class TaskScheduler {
+ public:
+  enum class TaskPriority {
+    // For example decoding an image that is being drawn.
+    kUserBlocking,
+    // For example writing a cache or downloading an update.
+    kBackground,
+  };
+
+  explicit TaskScheduler(int thread_count);
+  // Waits for the tasks that are running to finish. Tasks that have not
+  // started yet are deleted without running.
+  ~TaskScheduler();
+
+  // One thread per core.
+  static int DefaultThreadCount();
+
+  // Task runners that post to this scheduler with |priority|. They do not
+  // support delays.
+  scoped_refptr<base::TaskRunner> task_runner(TaskPriority priority) const;
+
+  // Returns false if the scheduler is shutting down.
+  bool PostTask(const tracked_objects::Location& from_here,
+                const base::Closure& task,
+                TaskPriority priority);
+
+  // Whether the current thread is one of the scheduler's.
+  bool RunsTasksOnCurrentThread() const;
+
+ private:
+  class SchedulerTaskRunner;
+  class Worker;
+
+  static const int kPriorityCount = 2;
+
+  // A queue for each priority.
+  struct TaskQueues {
+    std::deque<base::PendingTask> tasks[kPriorityCount];
+  };
+
+  // Called by the workers.
+  bool TakeTask(Worker* worker, base::PendingTask* task, bool* background);
+  bool WaitForWork();
+  void DidRunBackgroundTask();
+
+  // Tasks posted from other threads, protected by |lock_|.
+  base::Lock lock_;
+  TaskQueues shared_queues_;
+
+  // Workers sleep on |wake_up_| while no task is queued anywhere.
+  base::ConditionVariable wake_up_;
+  int sleeping_workers_;
+  // Written with |lock_| held, read by the workers between tasks.
+  base::subtle::Atomic32 shutting_down_;
+
+  // Tasks of each priority queued anywhere, including the workers' own
+  // queues.
+  base::subtle::Atomic32 queued_tasks_[kPriorityCount];
+  // Threads running a background task, which never exceeds
+  // |max_background_workers_|.
+  base::subtle::Atomic32 background_workers_;
+  const int max_background_workers_;
+
+  ScopedVector<Worker> workers_;
+  scoped_refptr<base::TaskRunner> task_runners_[kPriorityCount];
+
+  DISALLOW_COPY_AND_ASSIGN(TaskScheduler);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_TASK_SCHEDULER_H_
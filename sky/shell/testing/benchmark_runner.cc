@@ -0,0 +1,246 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/testing/benchmark_runner.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/message_loop/message_loop.h"
+#include "base/task_runner_util.h"
+#include "base/values.h"
+#include "sky/shell/gpu/rasterizer.h"
+#include "sky/shell/platform_view.h"
+#include "sky/shell/shell.h"
+#include "sky/shell/shell_view.h"
+#include "sky/shell/testing/benchmark_stats.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const int kViewportWidth = 800;
+const int kViewportHeight = 600;
+
+// Lets the app load and draw its first frames before anything is measured.
+const int kWarmUpSeconds = 2;
+const int kMeasureSeconds = 10;
+
+// Each swipe drags for |kSwipeMilliseconds| and then leaves the fling to
+// animate for |kFlingMilliseconds| before the next one starts.
+const int kSwipeMilliseconds = 300;
+const int kFlingMilliseconds = 700;
+const int kPointerIntervalMilliseconds = 8;
+const float kSwipeDistance = 400;
+
+// Longer gaps between frames mean the app had nothing to draw rather than
+// that it dropped frames.
+const int kMaxFrameGapMilliseconds = 250;
+
+BenchmarkRunner* g_benchmark_runner = nullptr;
+
+std::vector<compositor::instrumentation::FrameTiming> TakeFrameTimings(
+    base::WeakPtr<Rasterizer> rasterizer) {
+  if (!rasterizer)
+    return std::vector<compositor::instrumentation::FrameTiming>();
+  return rasterizer->TakeFrameTimings();
+}
+
+void StartRecordingFrameTimings(base::WeakPtr<Rasterizer> rasterizer) {
+  if (rasterizer)
+    rasterizer->StartRecordingFrameTimings();
+}
+
+pointer::PointerPtr CreatePointer(pointer::PointerType type, float y) {
+  pointer::PointerPtr pointer = pointer::Pointer::New();
+  pointer->time_stamp =
+      (base::TimeTicks::Now() - base::TimeTicks()).InMilliseconds();
+  pointer->pointer = 0;
+  pointer->type = type;
+  pointer->kind = pointer::POINTER_KIND_TOUCH;
+  pointer->x = kViewportWidth / 2;
+  pointer->y = y;
+  pointer->down = type != pointer::POINTER_TYPE_UP;
+  pointer->primary = true;
+  pointer->pressure = 1.0;
+  pointer->pressure_max = 1.0;
+  return pointer.Pass();
+}
+
+// The number of vsyncs that passed between consecutive frames without a
+// frame of their own.
+int CountDroppedFrames(
+    const std::vector<compositor::instrumentation::FrameTiming>& timings) {
+  const double budget = compositor::instrumentation::FrameBudget()
+                            .InMillisecondsF();
+  int dropped = 0;
+  for (size_t i = 1; i < timings.size(); ++i) {
+    const double gap =
+        (timings[i].frame_time - timings[i - 1].frame_time).InMillisecondsF();
+    if (gap > kMaxFrameGapMilliseconds)
+      continue;
+    dropped += std::max(0, static_cast<int>(std::round(gap / budget)) - 1);
+  }
+  return dropped;
+}
+
+}  // namespace
+
+void BenchmarkRunner::Start(const Config& config) {
+  CHECK(!g_benchmark_runner) << "Only run one benchmark.";
+  // Lives until the process exits.
+  g_benchmark_runner = new BenchmarkRunner(config);
+  g_benchmark_runner->Run();
+}
+
+BenchmarkRunner::BenchmarkRunner(const Config& config)
+    : config_(config),
+      shell_view_(new ShellView(Shell::Shared())),
+      pointer_down_(false),
+      swipe_up_(true),
+      weak_ptr_factory_(this) {
+  shell_view_->view()->ConnectToEngine(GetProxy(&sky_engine_));
+  ViewportMetricsPtr metrics = ViewportMetrics::New();
+  metrics->physical_width = kViewportWidth;
+  metrics->physical_height = kViewportHeight;
+  sky_engine_->OnViewportMetricsChanged(metrics.Pass());
+  // Frames are only scheduled while the activity is running.
+  sky_engine_->OnActivityResumed();
+}
+
+BenchmarkRunner::~BenchmarkRunner() {
+}
+
+void BenchmarkRunner::Run() {
+  if (config_.is_snapshot)
+    sky_engine_->RunFromSnapshot(config_.main);
+  else
+    sky_engine_->RunFromFile(config_.main, config_.package_root);
+
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE, base::Bind(&BenchmarkRunner::StartMeasuring,
+                            weak_ptr_factory_.GetWeakPtr()),
+      base::TimeDelta::FromSeconds(kWarmUpSeconds));
+}
+
+void BenchmarkRunner::StartMeasuring() {
+  Shell::Shared().gpu_task_runner()->PostTask(
+      FROM_HERE,
+      base::Bind(&StartRecordingFrameTimings, shell_view_->GetRasterizer()));
+  measure_start_ = base::TimeTicks::Now();
+  StartSwipe();
+  ScheduleNextPointer();
+}
+
+void BenchmarkRunner::StartSwipe() {
+  gesture_start_ = base::TimeTicks::Now();
+  pointer_down_ = true;
+  sky_engine_->OnPointerPacket(
+      CreatePointerPacket(pointer::POINTER_TYPE_DOWN, 0));
+}
+
+void BenchmarkRunner::DispatchNextPointer() {
+  const base::TimeTicks now = base::TimeTicks::Now();
+  if (now - measure_start_ >= base::TimeDelta::FromSeconds(kMeasureSeconds)) {
+    StopMeasuring();
+    return;
+  }
+
+  const int elapsed = (now - gesture_start_).InMilliseconds();
+  if (pointer_down_) {
+    if (elapsed < kSwipeMilliseconds) {
+      const float progress = static_cast<float>(elapsed) / kSwipeMilliseconds;
+      sky_engine_->OnPointerPacket(
+          CreatePointerPacket(pointer::POINTER_TYPE_MOVE, progress));
+    } else {
+      sky_engine_->OnPointerPacket(
+          CreatePointerPacket(pointer::POINTER_TYPE_UP, 1));
+      pointer_down_ = false;
+    }
+  } else if (elapsed >= kSwipeMilliseconds + kFlingMilliseconds) {
+    swipe_up_ = !swipe_up_;
+    StartSwipe();
+  }
+  ScheduleNextPointer();
+}
+
+void BenchmarkRunner::ScheduleNextPointer() {
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE, base::Bind(&BenchmarkRunner::DispatchNextPointer,
+                            weak_ptr_factory_.GetWeakPtr()),
+      base::TimeDelta::FromMilliseconds(kPointerIntervalMilliseconds));
+}
+
+pointer::PointerPacketPtr BenchmarkRunner::CreatePointerPacket(
+    pointer::PointerType type,
+    float progress) const {
+  const float start = (kViewportHeight + kSwipeDistance) / 2;
+  const float end = (kViewportHeight - kSwipeDistance) / 2;
+  const float y = swipe_up_ ? start + (end - start) * progress
+                            : end + (start - end) * progress;
+  pointer::PointerPacketPtr packet = pointer::PointerPacket::New();
+  packet->pointers = mojo::Array<pointer::PointerPtr>::New(0);
+  packet->pointers.push_back(CreatePointer(type, y));
+  return packet.Pass();
+}
+
+void BenchmarkRunner::StopMeasuring() {
+  // A swipe that is still in progress is left alone. Nothing looks at the
+  // app once the results are written.
+  base::PostTaskAndReplyWithResult(
+      Shell::Shared().gpu_task_runner().get(), FROM_HERE,
+      base::Bind(&TakeFrameTimings, shell_view_->GetRasterizer()),
+      base::Bind(&BenchmarkRunner::DidTakeFrameTimings,
+                 weak_ptr_factory_.GetWeakPtr()));
+}
+
+void BenchmarkRunner::DidTakeFrameTimings(
+    std::vector<compositor::instrumentation::FrameTiming> timings) {
+  std::vector<double> build_times;
+  std::vector<double> raster_times;
+  std::vector<double> latencies;
+  scoped_ptr<base::ListValue> frames(new base::ListValue());
+  for (const auto& timing : timings) {
+    build_times.push_back(timing.BuildTime().InMillisecondsF());
+    raster_times.push_back(timing.RasterTime().InMillisecondsF());
+    latencies.push_back(timing.TotalLatency().InMillisecondsF());
+
+    scoped_ptr<base::DictionaryValue> frame(new base::DictionaryValue());
+    frame->SetDouble("build_ms", build_times.back());
+    frame->SetDouble("raster_ms", raster_times.back());
+    frame->SetDouble("latency_ms", latencies.back());
+    frames->Append(frame.Pass());
+  }
+
+  base::DictionaryValue results;
+  results.SetString("main", config_.main);
+  results.SetInteger("frame_count", timings.size());
+  results.SetInteger("dropped_frames", CountDroppedFrames(timings));
+  results.Set("build_time_ms", SummarizeSamples(build_times));
+  results.Set("raster_time_ms", SummarizeSamples(raster_times));
+  results.Set("latency_ms", SummarizeSamples(latencies));
+  results.Set("frames", frames.Pass());
+
+  std::string json;
+  base::JSONWriter::WriteWithOptions(
+      results, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+  if (base::WriteFile(config_.results_path, json.data(), json.size()) !=
+      static_cast<int>(json.size())) {
+    LOG(ERROR) << "Could not write " << config_.results_path.value();
+    exit(1);
+  }
+
+  if (timings.empty()) {
+    LOG(ERROR) << "No frames were drawn while benchmarking.";
+    exit(1);
+  }
+  exit(0);
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,74 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_TESTING_BENCHMARK_RUNNER_H_
+#define SKY_SHELL_TESTING_BENCHMARK_RUNNER_H_
+
+#include <string>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "sky/compositor/instrumentation.h"
+#include "sky/services/engine/sky_engine.mojom.h"
+#include "sky/services/pointer/pointer.mojom.h"
+
+namespace sky {
+namespace shell {
+class ShellView;
+
+// Runs an app, scrolls it back and forth with synthetic touches for a fixed
+// time, and writes the timings of the frames drawn meanwhile to a JSON file.
+// Exits the process when done, with a failure status if no frame was drawn.
+class BenchmarkRunner {
+ public:
+  struct Config {
+    std::string main;
+    bool is_snapshot = false;
+    std::string package_root;
+    base::FilePath results_path;
+  };
+
+  static void Start(const Config& config);
+
+ private:
+  explicit BenchmarkRunner(const Config& config);
+  ~BenchmarkRunner();
+
+  void Run();
+  void StartMeasuring();
+  void StartSwipe();
+  void DispatchNextPointer();
+  void ScheduleNextPointer();
+  // |progress| is how far along the current swipe the pointer is, from 0 to
+  // 1.
+  pointer::PointerPacketPtr CreatePointerPacket(pointer::PointerType type,
+                                                float progress) const;
+  void StopMeasuring();
+  void DidTakeFrameTimings(
+      std::vector<compositor::instrumentation::FrameTiming> timings);
+
+  const Config config_;
+  scoped_ptr<ShellView> shell_view_;
+  SkyEnginePtr sky_engine_;
+
+  base::TimeTicks measure_start_;
+  base::TimeTicks gesture_start_;
+  bool pointer_down_;
+  // Swipes alternate between up and down so the app never runs out of
+  // content to scroll.
+  bool swipe_up_;
+
+  base::WeakPtrFactory<BenchmarkRunner> weak_ptr_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(BenchmarkRunner);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_TESTING_BENCHMARK_RUNNER_H_
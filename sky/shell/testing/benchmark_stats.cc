@@ -0,0 +1,34 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/testing/benchmark_stats.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace sky {
+namespace shell {
+
+double Percentile(std::vector<double> samples, double percentile) {
+  if (samples.empty())
+    return 0;
+  const double rank = std::ceil(percentile / 100.0 * samples.size());
+  size_t index = rank < 1.0 ? 0 : static_cast<size_t>(rank) - 1;
+  index = std::min(index, samples.size() - 1);
+  std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+  return samples[index];
+}
+
+scoped_ptr<base::DictionaryValue> SummarizeSamples(
+    const std::vector<double>& samples) {
+  scoped_ptr<base::DictionaryValue> summary(new base::DictionaryValue());
+  summary->SetDouble("p50", Percentile(samples, 50));
+  summary->SetDouble("p90", Percentile(samples, 90));
+  summary->SetDouble("p99", Percentile(samples, 99));
+  summary->SetDouble("max", Percentile(samples, 100));
+  return summary.Pass();
+}
+
+}  // namespace shell
+}  // namespace sky
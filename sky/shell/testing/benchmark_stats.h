@@ -0,0 +1,27 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_TESTING_BENCHMARK_STATS_H_
+#define SKY_SHELL_TESTING_BENCHMARK_STATS_H_
+
+#include <vector>
+
+#include "base/memory/scoped_ptr.h"
+#include "base/values.h"
+
+namespace sky {
+namespace shell {
+
+// Same ranking as compositor::instrumentation::FrameTimeHistory, which only
+// keeps the most recent frames.
+double Percentile(std::vector<double> samples, double percentile);
+
+// The p50, p90, p99 and max of |samples|, for benchmark results.
+scoped_ptr<base::DictionaryValue> SummarizeSamples(
+    const std::vector<double>& samples);
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_TESTING_BENCHMARK_STATS_H_
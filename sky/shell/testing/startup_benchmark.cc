@@ -0,0 +1,206 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/testing/startup_benchmark.h"
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/command_line.h"
+#include "base/files/file_util.h"
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
+#include "base/logging.h"
+#include "base/process/launch.h"
+#include "base/process/process.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/thread_task_runner_handle.h"
+#include "base/values.h"
+#include "sky/shell/platform_view.h"
+#include "sky/shell/shell.h"
+#include "sky/shell/shell_view.h"
+#include "sky/shell/startup_timeline.h"
+#include "sky/shell/switches.h"
+#include "sky/shell/testing/benchmark_stats.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const int kDefaultStartupRuns = 10;
+
+// A run that has not drawn its first frame by then is considered hung.
+const int kStartupTimeoutSeconds = 60;
+
+const int kViewportWidth = 800;
+const int kViewportHeight = 600;
+
+StartupReporter* g_startup_reporter = nullptr;
+
+bool WriteJSON(const base::FilePath& path, const base::Value& value) {
+  std::string json;
+  base::JSONWriter::WriteWithOptions(
+      value, base::JSONWriter::OPTIONS_PRETTY_PRINT, &json);
+  if (base::WriteFile(path, json.data(), json.size()) !=
+      static_cast<int>(json.size())) {
+    LOG(ERROR) << "Could not write " << path.value();
+    return false;
+  }
+  return true;
+}
+
+// The command line of a single run: everything this process was given,
+// except that the run reports its milestones instead of benchmarking.
+base::CommandLine GetRunCommandLine(const base::CommandLine& command_line,
+                                    const base::FilePath& report_path) {
+  base::CommandLine run(command_line.GetProgram());
+  for (const auto& entry : command_line.GetSwitches()) {
+    if (entry.first == switches::kStartupBenchmark ||
+        entry.first == switches::kStartupRuns) {
+      continue;
+    }
+    run.AppendSwitchNative(entry.first, entry.second);
+  }
+  run.AppendSwitchPath(switches::kStartupReport, report_path);
+  for (const auto& arg : command_line.GetArgs())
+    run.AppendArgNative(arg);
+  return run;
+}
+
+// Returns the milestones of one run, or null if it failed.
+scoped_ptr<base::DictionaryValue> RunOnce(const base::CommandLine& run,
+                                          const base::FilePath& report_path) {
+  base::DeleteFile(report_path, false);
+
+  base::Process process = base::LaunchProcess(run, base::LaunchOptions());
+  if (!process.IsValid()) {
+    LOG(ERROR) << "Could not launch " << run.GetProgram().value();
+    return nullptr;
+  }
+
+  int exit_code = 0;
+  if (!process.WaitForExitWithTimeout(
+          base::TimeDelta::FromSeconds(kStartupTimeoutSeconds), &exit_code)) {
+    LOG(ERROR) << "The app did not draw a frame within "
+               << kStartupTimeoutSeconds << " seconds.";
+    process.Terminate(1, true);
+    return nullptr;
+  }
+  if (exit_code != 0)
+    return nullptr;
+
+  std::string json;
+  if (!base::ReadFileToString(report_path, &json))
+    return nullptr;
+  scoped_ptr<base::Value> value = base::JSONReader::Read(json);
+  if (!value || !value->IsType(base::Value::TYPE_DICTIONARY))
+    return nullptr;
+  return make_scoped_ptr(static_cast<base::DictionaryValue*>(value.release()));
+}
+
+}  // namespace
+
+int RunStartupBenchmark(const base::CommandLine& command_line) {
+  const base::FilePath results_path =
+      command_line.GetSwitchValuePath(switches::kStartupBenchmark);
+
+  int runs = kDefaultStartupRuns;
+  if (command_line.HasSwitch(switches::kStartupRuns) &&
+      (!base::StringToInt(
+           command_line.GetSwitchValueASCII(switches::kStartupRuns), &runs) ||
+       runs <= 0)) {
+    LOG(ERROR) << "Invalid value for --" << switches::kStartupRuns;
+    return 1;
+  }
+
+  base::FilePath report_path;
+  if (!base::CreateTemporaryFile(&report_path)) {
+    LOG(ERROR) << "Could not create a file for the startup reports.";
+    return 1;
+  }
+  const base::CommandLine run = GetRunCommandLine(command_line, report_path);
+
+  std::map<std::string, std::vector<double>> samples;
+  scoped_ptr<base::ListValue> reports(new base::ListValue());
+  int failed_runs = 0;
+  for (int i = 0; i < runs; ++i) {
+    scoped_ptr<base::DictionaryValue> report = RunOnce(run, report_path);
+    if (!report) {
+      ++failed_runs;
+      continue;
+    }
+    for (base::DictionaryValue::Iterator it(*report); !it.IsAtEnd();
+         it.Advance()) {
+      double milliseconds = 0;
+      if (it.value().GetAsDouble(&milliseconds))
+        samples[it.key()].push_back(milliseconds);
+    }
+    reports->Append(report.Pass());
+  }
+  base::DeleteFile(report_path, false);
+
+  scoped_ptr<base::DictionaryValue> milestones(new base::DictionaryValue());
+  for (const auto& entry : samples)
+    milestones->Set(entry.first, SummarizeSamples(entry.second));
+
+  base::DictionaryValue results;
+  results.SetString("command_line", run.GetCommandLineString());
+  results.SetInteger("runs", runs);
+  results.SetInteger("failed_runs", failed_runs);
+  results.Set("milestones_ms", milestones.Pass());
+  results.Set("reports", reports.Pass());
+  if (!WriteJSON(results_path, results))
+    return 1;
+
+  if (failed_runs == runs) {
+    LOG(ERROR) << "No run drew a frame.";
+    return 1;
+  }
+  return 0;
+}
+
+void StartupReporter::Start(const BenchmarkRunner::Config& config) {
+  CHECK(!g_startup_reporter);
+  // Lives until the process exits.
+  g_startup_reporter = new StartupReporter(config);
+  g_startup_reporter->Run();
+}
+
+StartupReporter::StartupReporter(const BenchmarkRunner::Config& config)
+    : config_(config), shell_view_(new ShellView(Shell::Shared())) {
+  shell_view_->view()->ConnectToEngine(GetProxy(&sky_engine_));
+  ViewportMetricsPtr metrics = ViewportMetrics::New();
+  metrics->physical_width = kViewportWidth;
+  metrics->physical_height = kViewportHeight;
+  sky_engine_->OnViewportMetricsChanged(metrics.Pass());
+  sky_engine_->OnActivityResumed();
+}
+
+StartupReporter::~StartupReporter() {
+}
+
+void StartupReporter::Run() {
+  StartupTimeline::Shared().NotifyOnFirstFrame(
+      base::ThreadTaskRunnerHandle::Get(),
+      base::Bind(&StartupReporter::DidDrawFirstFrame, base::Unretained(this)));
+
+  if (config_.is_snapshot)
+    sky_engine_->RunFromSnapshot(config_.main);
+  else
+    sky_engine_->RunFromFile(config_.main, config_.package_root);
+}
+
+void StartupReporter::DidDrawFirstFrame() {
+  base::DictionaryValue report;
+  for (const auto& milestone : StartupTimeline::Shared().GetMilestones()) {
+    report.SetDouble(StartupTimeline::GetName(milestone.first),
+                     milestone.second.InMillisecondsF());
+  }
+  exit(WriteJSON(config_.results_path, report) ? 0 : 1);
+}
+
+}  // namespace shell
+}  // namespace sky
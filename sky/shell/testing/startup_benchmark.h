@@ -0,0 +1,52 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_TESTING_STARTUP_BENCHMARK_H_
+#define SKY_SHELL_TESTING_STARTUP_BENCHMARK_H_
+
+#include "base/macros.h"
+#include "base/memory/scoped_ptr.h"
+#include "sky/services/engine/sky_engine.mojom.h"
+#include "sky/shell/testing/benchmark_runner.h"
+
+namespace base {
+class CommandLine;
+}
+
+namespace sky {
+namespace shell {
+class ShellView;
+
+// Launches this executable |--startup-runs| times with the same app and
+// writes the distribution of the time from launch to every startup
+// milestone to the file named by |--startup-benchmark|. Every run is a new
+// process, so each one starts the shell, the VM and the app from scratch.
+// Returns the exit status of the benchmark.
+int RunStartupBenchmark(const base::CommandLine& command_line);
+
+// Runs the app in a process launched by RunStartupBenchmark. Once the first
+// frame is on screen, writes the startup milestones to |config.results_path|
+// and exits the process.
+class StartupReporter {
+ public:
+  static void Start(const BenchmarkRunner::Config& config);
+
+ private:
+  explicit StartupReporter(const BenchmarkRunner::Config& config);
+  ~StartupReporter();
+
+  void Run();
+  void DidDrawFirstFrame();
+
+  const BenchmarkRunner::Config config_;
+  scoped_ptr<ShellView> shell_view_;
+  SkyEnginePtr sky_engine_;
+
+  DISALLOW_COPY_AND_ASSIGN(StartupReporter);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_TESTING_STARTUP_BENCHMARK_H_
@@ -4,9 +4,10 @@
 
 #include "sky/shell/testing/testing.h"
 
-#include "sky/engine/public/web/WebRuntimeFeatures.h"
 #include "base/command_line.h"
 #include "sky/shell/switches.h"
+#include "sky/shell/testing/benchmark_runner.h"
+#include "sky/shell/testing/startup_benchmark.h"
 #include "sky/shell/testing/test_runner.h"
 
 namespace sky {
@@ -14,8 +15,30 @@ namespace shell {
 
 void InitForTesting() {
   base::CommandLine& command_line = *base::CommandLine::ForCurrentProcess();
-  blink::WebRuntimeFeatures::enableObservatory(
-      !command_line.HasSwitch(switches::kNonInteractive));
+  const bool startup_report = command_line.HasSwitch(switches::kStartupReport);
+  if (startup_report || command_line.HasSwitch(switches::kBenchmark)) {
+    BenchmarkRunner::Config config;
+    config.results_path = command_line.GetSwitchValuePath(
+        startup_report ? switches::kStartupReport : switches::kBenchmark);
+    config.package_root =
+        command_line.GetSwitchValueASCII(switches::kPackageRoot);
+    if (command_line.HasSwitch(switches::kSnapshot)) {
+      config.main = command_line.GetSwitchValueASCII(switches::kSnapshot);
+      config.is_snapshot = true;
+    } else {
+      auto args = command_line.GetArgs();
+      if (args.empty()) {
+        switches::PrintUsage("sky_shell");
+        exit(1);
+      }
+      config.main = args[0];
+    }
+    if (startup_report)
+      StartupReporter::Start(config);
+    else
+      BenchmarkRunner::Start(config);
+    return;
+  }
 
   // Explicitly boot the shared test runner.
   TestRunner& runner = TestRunner::Shared();
@@ -0,0 +1,105 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/thread_affinity.h"
+
+#include "build/build_config.h"
+
+#if defined(OS_ANDROID) || defined(OS_LINUX)
+#include <sched.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/files/file_path.h"
+#include "base/files/file_util.h"
+#include "base/lazy_instance.h"
+#include "base/logging.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/strings/stringprintf.h"
+#include "base/sys_info.h"
+#endif
+
+namespace sky {
+namespace shell {
+
+#if defined(OS_ANDROID) || defined(OS_LINUX)
+namespace {
+
+// The cores of each class, read from sysfs once.
+class CoreClasses {
+ public:
+  CoreClasses() {
+    const int core_count = base::SysInfo::NumberOfProcessors();
+    std::vector<int64> max_frequencies(core_count, 0);
+    int64 highest = 0;
+    for (int core = 0; core < core_count; ++core) {
+      base::FilePath path(base::StringPrintf(
+          "/sys/devices/system/cpu/cpu%d/cpufreq/cpuinfo_max_freq", core));
+      std::string contents;
+      int64 frequency = 0;
+      if (!base::ReadFileToString(path, &contents) ||
+          !base::StringToInt64(base::TrimWhitespaceASCII(contents,
+                                                         base::TRIM_ALL),
+                               &frequency)) {
+        // Cores that are offline have no cpufreq entry, and guessing their
+        // class could pin a thread to a single core.
+        return;
+      }
+      max_frequencies[core] = frequency;
+      highest = std::max(highest, frequency);
+    }
+
+    CPU_ZERO(&fast_);
+    CPU_ZERO(&efficient_);
+    for (int core = 0; core < core_count; ++core) {
+      if (max_frequencies[core] == highest)
+        CPU_SET(core, &fast_);
+      else
+        CPU_SET(core, &efficient_);
+    }
+    valid_ = CPU_COUNT(&efficient_) > 0;
+  }
+
+  bool valid() const { return valid_; }
+  const cpu_set_t& cores(CoreClass core_class) const {
+    return core_class == CoreClass::kFast ? fast_ : efficient_;
+  }
+
+ private:
+  bool valid_ = false;
+  cpu_set_t fast_;
+  cpu_set_t efficient_;
+
+  DISALLOW_COPY_AND_ASSIGN(CoreClasses);
+};
+
+base::LazyInstance<CoreClasses>::Leaky g_core_classes =
+    LAZY_INSTANCE_INITIALIZER;
+
+}  // namespace
+
+bool SetCurrentThreadAffinity(CoreClass core_class) {
+  const CoreClasses& core_classes = g_core_classes.Get();
+  if (!core_classes.valid())
+    return false;
+  const cpu_set_t& cores = core_classes.cores(core_class);
+  if (sched_setaffinity(0, sizeof(cores), &cores) != 0) {
+    DPLOG(ERROR) << "sched_setaffinity";
+    return false;
+  }
+  return true;
+}
+
+#else
+
+bool SetCurrentThreadAffinity(CoreClass core_class) {
+  return false;
+}
+
+#endif
+
+}  // namespace shell
+}  // namespace sky
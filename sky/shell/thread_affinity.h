@@ -0,0 +1,27 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_THREAD_AFFINITY_H_
+#define SKY_SHELL_THREAD_AFFINITY_H_
+
+namespace sky {
+namespace shell {
+
+// On big.LITTLE devices the cores differ in their maximum clock rate.
+enum class CoreClass {
+  // The cores with the highest maximum clock rate.
+  kFast,
+  // All the other cores.
+  kEfficient,
+};
+
+// Restricts the current thread to the cores of |core_class|. Returns false,
+// leaving the thread free to run anywhere, if the cores cannot be told
+// apart or the platform does not support affinity.
+bool SetCurrentThreadAffinity(CoreClass core_class);
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_THREAD_AFFINITY_H_
@@ -2,25 +2,78 @@
 // Use of this source code is governed by a BSD-style license that can be
 // found in the LICENSE file.
 
+#include "base/json/json_reader.h"
+#include "base/json/json_writer.h"
 #include "base/logging.h"
 #include "base/macros.h"
+#include "base/time/time.h"
+#include "base/values.h"
 #include "base/trace_event/trace_config.h"
 #include "base/trace_event/trace_event.h"
 #include "sky/shell/tracing_controller.h"
 #include "sky/shell/shell.h"
+#include "sky/shell/synthetic_delays.h"
+#include <cmath>
 #include <string>
 
 namespace sky {
 namespace shell {
 
-const char kBaseTraceStart[] = "{\"traceEvents\":[";
-const char kBaseTraceEnd[] = "]}";
-const char kSentinel[] = "\0";
+const char kTraceCategories[] = "*," TRACE_DISABLED_BY_DEFAULT("memory-infra");
 
-TracingController::TracingController() : view_(nullptr) {}
+namespace {
+
+const char kTraceStart[] = "{\"traceEvents\":[";
+const char kTraceEnd[] = "]}";
+
+// Returns what has to be subtracted from the timestamps of the Dart timeline
+// to put them on the TimeTicks clock that base tracing uses. VMs that stamp
+// their events with the wall clock are told apart from ones that already use
+// the monotonic clock by which of the two |sample| is closer to.
+int64 DartClockOffset(double sample) {
+  const int64 ticks_now = base::TimeTicks::Now().ToInternalValue();
+  const int64 wall_now =
+      (base::Time::Now() - base::Time::UnixEpoch()).InMicroseconds();
+  if (std::abs(sample - wall_now) < std::abs(sample - ticks_now))
+    return wall_now - ticks_now;
+  return 0;
+}
+
+// The timeline is either a bare list of events or a trace object holding
+// one.
+base::ListValue* GetDartTraceEvents(base::Value* trace) {
+  base::ListValue* events = nullptr;
+  if (trace->GetAsList(&events))
+    return events;
+  base::DictionaryValue* dictionary = nullptr;
+  if (trace->GetAsDictionary(&dictionary) &&
+      dictionary->GetList("traceEvents", &events)) {
+    return events;
+  }
+  return nullptr;
+}
+
+}  // namespace
+
+TracingController::TracingController()
+    : trace_file_has_events_(false), view_(nullptr) {
+  base::trace_event::MemoryDumpManager::GetInstance()->SetDelegate(this);
+}
 
 TracingController::~TracingController() {}
 
+void TracingController::RequestGlobalMemoryDump(
+    const base::trace_event::MemoryDumpRequestArgs& args,
+    const base::trace_event::MemoryDumpCallback& callback) {
+  // The shell's services all run in this process, so a global dump is just
+  // the dump of this process.
+  CreateProcessDump(args, callback);
+}
+
+bool TracingController::IsCoordinatorProcess() const {
+  return true;
+}
+
 void TracingController::StartTracing() {
   DLOG(INFO) << "Collecting Traces";
 
@@ -42,14 +95,61 @@ void TracingController::OnDataAvailable(const void* data, size_t size) {
     return;
   }
 
-  trace_file_->WriteAtCurrentPos(reinterpret_cast<const char*>(data), size);
+  dart_trace_.append(reinterpret_cast<const char*>(data), size);
 }
 
 void TracingController::OnDataComplete() {
+  if (trace_file_ != nullptr) {
+    WriteDartTraceEvents();
+    trace_file_->WriteAtCurrentPos(kTraceEnd, sizeof(kTraceEnd) - 1);
+  }
+  dart_trace_.clear();
   trace_file_ = nullptr;
   drainer_ = nullptr;
 }
 
+void TracingController::WriteTraceEvents(const std::string& events) {
+  if (events.empty())
+    return;
+  if (trace_file_has_events_)
+    trace_file_->WriteAtCurrentPos(",", 1);
+  trace_file_->WriteAtCurrentPos(events.data(), events.size());
+  trace_file_has_events_ = true;
+}
+
+void TracingController::WriteDartTraceEvents() {
+  if (dart_trace_.empty())
+    return;
+
+  scoped_ptr<base::Value> trace = base::JSONReader::Read(dart_trace_);
+  base::ListValue* events = trace ? GetDartTraceEvents(trace.get()) : nullptr;
+  if (!events) {
+    LOG(ERROR) << "Could not parse the Dart timeline.";
+    return;
+  }
+
+  int64 offset = 0;
+  bool has_offset = false;
+  std::string json;
+  for (base::Value* value : *events) {
+    base::DictionaryValue* event = nullptr;
+    if (!value->GetAsDictionary(&event))
+      continue;
+    double timestamp = 0;
+    if (event->GetDouble("ts", &timestamp)) {
+      if (!has_offset) {
+        offset = DartClockOffset(timestamp);
+        has_offset = true;
+      }
+      event->SetDouble("ts", timestamp - offset);
+    }
+    base::JSONWriter::WriteWithOptions(
+        *event, base::JSONWriter::OPTIONS_OMIT_DOUBLE_TYPE_PRESERVATION,
+        &json);
+    WriteTraceEvents(json);
+  }
+}
+
 void TracingController::StartDartTracing() {
   if (view_ != nullptr) {
     view_->StartDartTracing();
@@ -66,8 +166,10 @@ void TracingController::StopDartTracing() {
 }
 
 void TracingController::StartBaseTracing() {
+  jank_tracer_.Suspend();
   base::trace_event::TraceLog::GetInstance()->SetEnabled(
-      base::trace_event::TraceConfig("*", base::trace_event::RECORD_UNTIL_FULL),
+      base::trace_event::TraceConfig(AddSyntheticDelays(kTraceCategories),
+                                     base::trace_event::RECORD_UNTIL_FULL),
       base::trace_event::TraceLog::RECORDING_MODE);
 }
 
@@ -76,8 +178,8 @@ void TracingController::StopBaseTracing() {
   log->SetDisabled();
 
   if (trace_file_ != nullptr) {
-    trace_file_->WriteAtCurrentPos(kBaseTraceStart,
-                                   sizeof(kBaseTraceStart) - 1);
+    trace_file_->WriteAtCurrentPos(kTraceStart, sizeof(kTraceStart) - 1);
+    trace_file_has_events_ = false;
   }
   log->Flush(base::Bind(&TracingController::OnBaseTraceChunk));
 }
@@ -90,21 +192,13 @@ void TracingController::OnBaseTraceChunk(
   // accessor
   TracingController& controller = Shell::Shared().tracing_controller();
 
-  if (controller.trace_file_ != nullptr) {
-    std::string& str = chunk->data();
-    controller.trace_file_->WriteAtCurrentPos(str.data(), str.size());
-    if (has_more_events) {
-      controller.trace_file_->WriteAtCurrentPos(",", 1);
-    } else {
-      controller.trace_file_->WriteAtCurrentPos(kBaseTraceEnd,
-                                                sizeof(kBaseTraceEnd) - 1);
-      controller.trace_file_->WriteAtCurrentPos(kSentinel,
-                                                sizeof(kSentinel) - 1);
-    }
-  }
+  // The trace is closed once the Dart timeline has been added to it.
+  if (controller.trace_file_ != nullptr)
+    controller.WriteTraceEvents(chunk->data());
 
   if (!has_more_events) {
     controller.StopDartTracing();
+    controller.jank_tracer_.Resume();
   }
 }
 
@@ -8,8 +8,11 @@
 #include "base/files/file.h"
 #include "base/macros.h"
 #include "base/memory/ref_counted_memory.h"
+#include "base/trace_event/memory_dump_manager.h"
 #include "mojo/data_pipe_utils/data_pipe_drainer.h"
 #include "mojo/public/cpp/system/data_pipe.h"
+#include "sky/shell/jank_tracer.h"
+#include "sky/shell/sampling_profiler.h"
 #include "sky/shell/shell_view.h"
 
 #include <memory>
@@ -17,11 +20,23 @@
 namespace sky {
 namespace shell {
 
-class TracingController : public mojo::common::DataPipeDrainer::Client {
+// The categories traced by the shell. Memory dumps are only taken while the
+// memory-infra category is enabled.
+extern const char kTraceCategories[];
+
+class TracingController
+    : public mojo::common::DataPipeDrainer::Client,
+      public base::trace_event::MemoryDumpManagerDelegate {
  public:
   TracingController();
   ~TracingController() override;
 
+  // base::trace_event::MemoryDumpManagerDelegate:
+  void RequestGlobalMemoryDump(
+      const base::trace_event::MemoryDumpRequestArgs& args,
+      const base::trace_event::MemoryDumpCallback& callback) override;
+  bool IsCoordinatorProcess() const override;
+
   void RegisterShellView(ShellView* view);
   void UnregisterShellView(ShellView* view);
 
@@ -30,16 +45,29 @@ class TracingController : public mojo::common::DataPipeDrainer::Client {
   void StartTracing();
 
   // Stop tracing in base as well as the dart isolates attached to shell views
-  // and dump the resulting trace to the specified path. Traces from various
-  // sources are separated by a NULL character in the resulting file and must
-  // be merged before viewing in the trace viewer
+  // and dump the resulting trace to the specified path. The events from both
+  // are written to a single trace, with the Dart timestamps moved to the
+  // clock base tracing uses.
   void StopTracing(const base::FilePath& path);
 
   void SaveFrameToSkPicture(base::FilePath& destination);
 
+  JankTracer& jank_tracer() { return jank_tracer_; }
+
+  // Samples the native stacks of the UI and GPU threads, which traces only
+  // show as opaque slices.
+  SamplingProfiler& sampling_profiler() { return sampling_profiler_; }
+
  private:
+  JankTracer jank_tracer_;
+  SamplingProfiler sampling_profiler_;
   std::unique_ptr<mojo::common::DataPipeDrainer> drainer_;
   std::unique_ptr<base::File> trace_file_;
+  // Whether an event has been written to |trace_file_| yet, so that the next
+  // one knows to start with a separator.
+  bool trace_file_has_events_;
+  // The Dart timeline is parsed once all of it has arrived.
+  std::string dart_trace_;
   // TODO: Currently, only the last shell view is traced. When the shell gains
   // the ability to host multiple shell views, references to each must be stored
   // instead and trace data from each serialized to the output trace.
@@ -51,6 +79,8 @@ class TracingController : public mojo::common::DataPipeDrainer::Client {
   void StopBaseTracing();
   void OnDataAvailable(const void* data, size_t num_bytes) override;
   void OnDataComplete() override;
+  void WriteTraceEvents(const std::string& events);
+  void WriteDartTraceEvents();
   static void OnBaseTraceChunk(
       const scoped_refptr<base::RefCountedString>& chunk,
       bool has_more_events);
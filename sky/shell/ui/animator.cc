@@ -4,22 +4,78 @@
 
 #include "sky/shell/ui/animator.h"
 
+#include <algorithm>
+
 #include "base/bind.h"
 #include "base/message_loop/message_loop.h"
+#include "base/synchronization/lock.h"
 #include "base/trace_event/trace_event.h"
+#include "base/trace_event/trace_event_synthetic_delay.h"
 
 namespace sky {
 namespace shell {
+namespace {
+
+// One frame in flight on the GPU thread and one waiting for it to finish.
+const int kMinPipelineDepth = 2;
+
+// Deeper pipelines do not increase throughput once the GPU thread is the
+// bottleneck, and every extra frame adds its duration to the latency.
+const int kMaxPipelineDepth = 3;
+
+// Idle periods shorter than this are not worth waking Dart up for.
+const int64_t kMinIdleTimeMicroseconds = 1000;
+
+// The subscription to vsyncs is dropped after this many vsyncs that no frame
+// waited for. Keeping it a little longer than one frame means that
+// animations do not resubscribe every frame.
+const int kMaxIdleVSyncs = 2;
+
+}  // namespace
+
+// Holds the latest layer tree until the GPU thread is ready for it. A tree
+// that is replaced before it has been drawn is dropped, so the GPU thread
+// never spends time on a frame that is already stale.
+class Animator::LayerTreeSlot
+    : public base::RefCountedThreadSafe<LayerTreeSlot> {
+ public:
+  LayerTreeSlot() {}
+
+  // Returns true if a tree that was never drawn has been replaced.
+  bool Put(scoped_ptr<compositor::LayerTree> layer_tree) {
+    base::AutoLock lock(lock_);
+    const bool replaced = layer_tree_.get() != nullptr;
+    layer_tree_ = layer_tree.Pass();
+    return replaced;
+  }
+
+  scoped_ptr<compositor::LayerTree> Take() {
+    base::AutoLock lock(lock_);
+    return layer_tree_.Pass();
+  }
 
-const int kPipelineDepth = 3;
+ private:
+  friend class base::RefCountedThreadSafe<LayerTreeSlot>;
+  ~LayerTreeSlot() {}
+
+  base::Lock lock_;
+  scoped_ptr<compositor::LayerTree> layer_tree_;
+
+  DISALLOW_COPY_AND_ASSIGN(LayerTreeSlot);
+};
 
 Animator::Animator(const Engine::Config& config, Engine* engine)
     : config_(config),
       engine_(engine),
+      vsync_listener_binding_(this),
+      awaiting_vsync_(false),
+      idle_vsyncs_(0),
       outstanding_requests_(0),
       did_defer_frame_request_(false),
       engine_requested_frame_(false),
       paused_(false),
+      frame_number_(0),
+      pending_layer_tree_(new LayerTreeSlot()),
       weak_factory_(this) {
 }
 
@@ -34,7 +90,7 @@ void Animator::RequestFrame() {
 
   DCHECK(!did_defer_frame_request_);
   outstanding_requests_++;
-  if (outstanding_requests_ >= kPipelineDepth) {
+  if (outstanding_requests_ >= PipelineDepth()) {
     did_defer_frame_request_ = true;
     return;
   }
@@ -57,38 +113,105 @@ void Animator::Start() {
 
 void Animator::BeginFrame(int64_t time_stamp) {
   TRACE_EVENT_ASYNC_END0("sky", "Frame request pending", this);
+  TRACE_EVENT0("sky", "Animator::BeginFrame");
+  TRACE_EVENT_SYNTHETIC_DELAY("sky.BeginFrame");
   DCHECK(engine_requested_frame_);
   DCHECK(outstanding_requests_ > 0);
-  DCHECK(outstanding_requests_ <= kPipelineDepth) << outstanding_requests_;
+  DCHECK(outstanding_requests_ <= kMaxPipelineDepth) << outstanding_requests_;
 
   engine_requested_frame_ = false;
 
   if (paused_) {
-    OnFrameComplete();
+    OnFrameComplete(base::TimeTicks());
     return;
   }
 
   base::TimeTicks frame_time = time_stamp ?
       base::TimeTicks::FromInternalValue(time_stamp) : base::TimeTicks::Now();
 
-  scoped_ptr<compositor::LayerTree> layer_tree =
-      make_scoped_ptr(engine_->BeginFrame(frame_time).release());
+  const base::TimeTicks build_start = base::TimeTicks::Now();
+  scoped_ptr<compositor::LayerTree> layer_tree = make_scoped_ptr(
+      engine_->BeginFrame(frame_time, scheduler_.Deadline(frame_time))
+          .release());
 
   if (!layer_tree) {
-    OnFrameComplete();
+    OnFrameComplete(base::TimeTicks());
     return;
   }
 
+  layer_tree->set_frame_number(++frame_number_);
+  layer_tree->set_frame_time(frame_time);
+  layer_tree->set_target_time(scheduler_.Deadline(frame_time));
+  layer_tree->set_build_start_time(build_start);
+  layer_tree->set_construction_time(base::TimeTicks::Now() - build_start);
+  scheduler_.DidBuildFrame(layer_tree->construction_time());
+
+  // Ties this frame's UI thread work to its rasterization on the GPU thread.
+  TRACE_EVENT_FLOW_BEGIN0("sky", "Frame", layer_tree->frame_number());
+
+  if (pending_layer_tree_->Put(layer_tree.Pass())) {
+    TRACE_EVENT_INSTANT0("sky", "Dropped stale frame",
+                         TRACE_EVENT_SCOPE_THREAD);
+  }
+
+  // Every frame posts a draw, but a draw only finds a tree if no earlier
+  // draw has already picked up the latest one.
   config_.gpu_task_runner->PostTaskAndReply(
       FROM_HERE,
-      base::Bind(&GPUDelegate::Draw, config_.gpu_delegate,
-                 base::Passed(&layer_tree)),
-      base::Bind(&Animator::OnFrameComplete, weak_factory_.GetWeakPtr()));
+      base::Bind(&Animator::DrawLatestLayerTree, config_.gpu_delegate,
+                 pending_layer_tree_),
+      base::Bind(&Animator::OnFrameComplete, weak_factory_.GetWeakPtr(),
+                 base::TimeTicks::Now()));
+
+  // Whatever is left until the next frame has to be started can be used
+  // for idle work. The task runs after any input that is already queued.
+  const base::TimeTicks idle_deadline =
+      scheduler_.BuildStartTime(frame_time + scheduler_.vsync_interval());
+  base::MessageLoop::current()->PostTask(
+      FROM_HERE, base::Bind(&Animator::NotifyIdle, weak_factory_.GetWeakPtr(),
+                            idle_deadline));
 }
 
-void Animator::OnFrameComplete() {
+void Animator::NotifyIdle(base::TimeTicks deadline) {
+  if (paused_)
+    return;
+  const base::TimeDelta remaining = deadline - base::TimeTicks::Now();
+  if (remaining.InMicroseconds() < kMinIdleTimeMicroseconds)
+    return;
+  TRACE_EVENT1("sky", "Animator::NotifyIdle", "remaining_us",
+               remaining.InMicroseconds());
+  engine_->NotifyIdle(deadline);
+}
+
+// static
+void Animator::DrawLatestLayerTree(base::WeakPtr<GPUDelegate> gpu_delegate,
+                                   scoped_refptr<LayerTreeSlot> slot) {
+  scoped_ptr<compositor::LayerTree> layer_tree = slot->Take();
+  if (layer_tree && gpu_delegate)
+    gpu_delegate->Draw(layer_tree.Pass());
+}
+
+int Animator::PipelineDepth() const {
+  // Only overlap the UI and GPU threads as much as the cost of a frame
+  // requires to keep up with the display.
+  const int64_t frame_cost = (scheduler_.PredictedBuildTime() +
+                              scheduler_.PredictedDrawTime()).InMicroseconds();
+  const int64_t interval = scheduler_.vsync_interval().InMicroseconds();
+  const int frames_in_flight =
+      static_cast<int>((frame_cost + interval - 1) / interval);
+  return std::max(kMinPipelineDepth,
+                  std::min(kMaxPipelineDepth, frames_in_flight + 1));
+}
+
+void Animator::OnFrameComplete(base::TimeTicks draw_requested) {
   DCHECK(outstanding_requests_ > 0);
   --outstanding_requests_;
+
+  if (!draw_requested.is_null()) {
+    scheduler_.DidDrawFrame(base::TimeTicks::Now() - draw_requested);
+    TRACE_COUNTER1("sky", "PipelineDepth", PipelineDepth());
+  }
+
   if (paused_)
     return;
 
@@ -103,10 +226,49 @@ void Animator::OnFrameComplete() {
 bool Animator::AwaitVSync() {
   if (!vsync_provider_)
     return false;
-  vsync_provider_->AwaitVSync(
-      base::Bind(&Animator::BeginFrame, weak_factory_.GetWeakPtr()));
+  awaiting_vsync_ = true;
+  // Vsyncs keep coming while subscribed, so a frame does not have to ask for
+  // its vsync and risk asking too late to get it.
+  if (!vsync_listener_binding_.is_bound()) {
+    vsync::VSyncListenerPtr listener;
+    vsync_listener_binding_.Bind(mojo::GetProxy(&listener));
+    vsync_provider_->Subscribe(listener.Pass());
+  }
   return true;
 }
 
+void Animator::OnVSync(int64_t time_stamp, int64_t interval) {
+  const base::TimeTicks vsync_time =
+      base::TimeTicks::FromInternalValue(time_stamp);
+  if (interval > 0)
+    scheduler_.SetDisplayInterval(base::TimeDelta::FromMicroseconds(interval));
+  scheduler_.DidVSync(vsync_time);
+
+  if (!awaiting_vsync_) {
+    // Unsubscribing is closing the listener.
+    if (++idle_vsyncs_ >= kMaxIdleVSyncs)
+      vsync_listener_binding_.Close();
+    return;
+  }
+  awaiting_vsync_ = false;
+  idle_vsyncs_ = 0;
+
+  // Building the frame as late as possible lets it see the latest input.
+  const base::TimeDelta delay =
+      scheduler_.BuildStartTime(vsync_time) - base::TimeTicks::Now();
+  if (delay <= base::TimeDelta()) {
+    BeginFrame(time_stamp);
+    return;
+  }
+
+  TRACE_EVENT_INSTANT1("sky", "Delaying frame", TRACE_EVENT_SCOPE_THREAD,
+                       "delay_us", delay.InMicroseconds());
+  base::MessageLoop::current()->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&Animator::BeginFrame, weak_factory_.GetWeakPtr(),
+                 time_stamp),
+      delay);
+}
+
 }  // namespace shell
 }  // namespace sky
@@ -5,17 +5,21 @@
 #ifndef SKY_SHELL_UI_ANIMATOR_H_
 #define SKY_SHELL_UI_ANIMATOR_H_
 
+#include "base/memory/ref_counted.h"
 #include "base/memory/weak_ptr.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/bindings/binding.h"
 #include "sky/services/vsync/vsync.mojom.h"
 #include "sky/shell/ui/engine.h"
+#include "sky/shell/ui/frame_scheduler.h"
 
 namespace sky {
 namespace shell {
 
-class Animator {
+class Animator : public vsync::VSyncListener {
  public:
   explicit Animator(const Engine::Config& config, Engine* engine);
-  ~Animator();
+  ~Animator() override;
 
   void RequestFrame();
 
@@ -27,17 +31,42 @@ class Animator {
   }
 
  private:
+  class LayerTreeSlot;
+
+  // vsync::VSyncListener implementation:
+  void OnVSync(int64_t time_stamp, int64_t interval) override;
+
   void BeginFrame(int64_t time_stamp);
-  void OnFrameComplete();
+  void OnFrameComplete(base::TimeTicks draw_requested);
+  void NotifyIdle(base::TimeTicks deadline);
   bool AwaitVSync();
 
+  // The number of frame requests that may be outstanding at once, including
+  // the one waiting for the pipeline to drain.
+  int PipelineDepth() const;
+
+  static void DrawLatestLayerTree(base::WeakPtr<GPUDelegate> gpu_delegate,
+                                  scoped_refptr<LayerTreeSlot> slot);
+
   Engine::Config config_;
   Engine* engine_;
   vsync::VSyncProviderPtr vsync_provider_;
+  // Bound while subscribed to the provider's vsyncs.
+  mojo::Binding<vsync::VSyncListener> vsync_listener_binding_;
+  // Whether a frame is waiting for the next vsync.
+  bool awaiting_vsync_;
+  // Vsyncs in a row that no frame was waiting for.
+  int idle_vsyncs_;
   int outstanding_requests_;
   bool did_defer_frame_request_;
   bool engine_requested_frame_;
   bool paused_;
+  uint64_t frame_number_;
+
+  // The most recent layer tree that the GPU thread has not picked up yet.
+  scoped_refptr<LayerTreeSlot> pending_layer_tree_;
+
+  FrameScheduler scheduler_;
 
   base::WeakPtrFactory<Animator> weak_factory_;
 
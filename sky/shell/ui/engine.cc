@@ -7,12 +7,16 @@
 #include "base/bind.h"
 #include "base/command_line.h"
 #include "base/files/file_path.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/task_runner_util.h"
+#include "base/thread_task_runner_handle.h"
 #include "base/threading/worker_pool.h"
 #include "base/trace_event/trace_event.h"
 #include "mojo/data_pipe_utils/data_pipe_utils.h"
 #include "mojo/public/cpp/application/connect.h"
 #include "services/asset_bundle/asset_unpacker_job.h"
 #include "sky/shell/gpu/picture_serializer.h"
+#include "sky/engine/public/platform/Platform.h"
 #include "sky/engine/public/platform/WebInputEvent.h"
 #include "sky/engine/public/platform/sky_display_metrics.h"
 #include "sky/engine/public/platform/sky_display_metrics.h"
@@ -20,7 +24,10 @@
 #include "sky/engine/public/web/WebRuntimeFeatures.h"
 #include "sky/shell/dart/dart_library_provider_files.h"
 #include "sky/shell/dart/dart_library_provider_network.h"
+#include "sky/shell/dart/script_snapshot_cache.h"
+#include "sky/shell/memory_pressure_coordinator.h"
 #include "sky/shell/service_provider.h"
+#include "sky/shell/startup_timeline.h"
 #include "sky/shell/switches.h"
 #include "sky/shell/ui/animator.h"
 #include "sky/shell/ui/input_event_converter.h"
@@ -38,6 +45,16 @@ const char kSnapshotKey[] = "snapshot_blob.bin";
 void Ignored(bool) {
 }
 
+// Runs on the GPU thread and hands the image back to the UI thread.
+void PostImageToTaskRunner(
+    scoped_refptr<base::SingleThreadTaskRunner> task_runner,
+    scoped_refptr<base::SingleThreadTaskRunner> gpu_task_runner,
+    const blink::SkyViewClient::ImageCallback& callback,
+    RefPtr<SkImage> image) {
+  task_runner->PostTask(FROM_HERE,
+                        base::Bind(callback, image, gpu_task_runner));
+}
+
 mojo::ScopedDataPipeConsumerHandle Fetch(const base::FilePath& path) {
   mojo::DataPipe pipe;
   auto runner = base::WorkerPool::GetTaskRunner(true);
@@ -46,7 +63,43 @@ mojo::ScopedDataPipeConsumerHandle Fetch(const base::FilePath& path) {
   return pipe.consumer_handle.Pass();
 }
 
+void StoreScriptSnapshot(const base::FilePath& cache_dir,
+                         const std::string& name,
+                         const std::vector<uint8_t>& snapshot,
+                         const blink::DartLibraryLoader::SourceDigests& sources) {
+  blink::Platform::current()
+      ->workerTaskRunner(blink::Platform::BackgroundWorkerTask)
+      ->PostTask(FROM_HERE,
+                 base::Bind(&ScriptSnapshotCache::Store,
+                            base::Owned(new ScriptSnapshotCache(cache_dir)),
+                            name, snapshot, sources));
+}
+
+// Purges the engine's process-wide caches on the UI thread, which is the
+// engine's main thread.
+class EngineCaches : public MemoryPressureCoordinator::Client {
+ public:
+  size_t OnMemoryPressure(MemoryPressureCoordinator::Level level) override {
+    return blink::purgeMemory(level);
+  }
+};
+
+// The observatory needs the service isolate, which takes start-up time and
+// memory in every process, so release builds only start it when asked to.
+bool ShouldEnableObservatory(const base::CommandLine& command_line) {
+  if (command_line.HasSwitch(switches::kEnableObservatory))
+    return true;
+  if (command_line.HasSwitch(switches::kNonInteractive))
+    return false;
+#if defined(NDEBUG)
+  return false;
+#else
+  return true;
+#endif
+}
+
 PlatformImpl* g_platform_impl = nullptr;
+EngineCaches* g_engine_caches = nullptr;
 
 }  // namespace
 
@@ -64,6 +117,7 @@ Engine::Engine(const Config& config)
       binding_(this),
       activity_running_(false),
       have_surface_(false),
+      delivering_frame_input_(false),
       weak_factory_(this) {
   mojo::ServiceProviderPtr service_provider =
       CreateServiceProvider(config.service_provider_context);
@@ -75,6 +129,12 @@ Engine::Engine(const Config& config)
   mojo::ConnectToService(service_provider.get(), &vsync_provider);
   animator_->set_vsync_provider(vsync_provider.Pass());
 #endif
+
+  if (base::CommandLine::ForCurrentProcess()->HasSwitch(
+          switches::kEnableNativeGestures)) {
+    gesture_recognizer_.reset(new GestureRecognizer(
+        base::Bind(&Engine::OnGesture, weak_factory_.GetWeakPtr())));
+  }
 }
 
 Engine::~Engine() {
@@ -84,34 +144,80 @@ base::WeakPtr<Engine> Engine::GetWeakPtr() {
   return weak_factory_.GetWeakPtr();
 }
 
-void Engine::Init() {
+void Engine::Init(MemoryPressureCoordinator* memory_pressure_coordinator,
+                  TaskScheduler* task_scheduler) {
   TRACE_EVENT0("sky", "Engine::Init");
 
   base::CommandLine& command_line = *base::CommandLine::ForCurrentProcess();
   blink::WebRuntimeFeatures::enableDartCheckedMode(
       command_line.HasSwitch(switches::kEnableCheckedMode));
+  blink::WebRuntimeFeatures::enableObservatory(
+      ShouldEnableObservatory(command_line));
+  blink::WebRuntimeFeatures::enableDartCompileAll(
+      command_line.HasSwitch(switches::kCompileAll));
+  blink::WebRuntimeFeatures::enableColorManagedImages(
+      command_line.HasSwitch(switches::kEnableColorManagement));
+  // The shell installs a discardable memory allocator that purges.
+  blink::WebRuntimeFeatures::enableDeferredImageDecoding(true);
 
   DCHECK(!g_platform_impl);
-  g_platform_impl = new PlatformImpl();
+  g_platform_impl = new PlatformImpl(task_scheduler);
   blink::initialize(g_platform_impl);
+
+  if (command_line.HasSwitch(switches::kTraceAllocationSampleBytes)) {
+    size_t sample_bytes = 0;
+    if (base::StringToSizeT(command_line.GetSwitchValueASCII(
+                                switches::kTraceAllocationSampleBytes),
+                            &sample_bytes) &&
+        sample_bytes) {
+      blink::startAllocationSampling(sample_bytes);
+    } else {
+      LOG(ERROR) << "Invalid value for --"
+                 << switches::kTraceAllocationSampleBytes;
+    }
+  }
+
+  DCHECK(!g_engine_caches);
+  g_engine_caches = new EngineCaches();
+  memory_pressure_coordinator->AddClient("engine", g_engine_caches);
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::EngineInitialized);
 }
 
 std::unique_ptr<compositor::LayerTree> Engine::BeginFrame(
-    base::TimeTicks frame_time) {
+    base::TimeTicks frame_time,
+    base::TimeTicks deadline) {
   TRACE_EVENT0("sky", "Engine::BeginFrame");
 
   if (!sky_view_)
     return nullptr;
 
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::FirstBeginFrame);
+
+  // The frame callback runs right after this, so frames that the input
+  // handlers schedule would only repeat it.
+  delivering_frame_input_ = true;
+  pointer_moves_.Resample(frame_time);
+  FlushPointerMoves();
+  delivering_frame_input_ = false;
+
   std::unique_ptr<compositor::LayerTree> layer_tree =
-      sky_view_->BeginFrame(frame_time);
+      sky_view_->BeginFrame(frame_time, deadline);
   if (layer_tree) {
     layer_tree->set_frame_size(SkISize::Make(physical_size_.width(),
                                              physical_size_.height()));
+    StartupTimeline::Shared().Record(
+        StartupTimeline::Milestone::FirstFrameBuilt);
   }
   return layer_tree;
 }
 
+void Engine::NotifyIdle(base::TimeTicks deadline) {
+  if (sky_view_)
+    sky_view_->NotifyIdle(deadline);
+}
+
 void Engine::ConnectToEngine(mojo::InterfaceRequest<SkyEngine> request) {
   binding_.Bind(request.Pass());
 }
@@ -152,14 +258,116 @@ void Engine::OnInputEvent(InputEventPtr event) {
   TRACE_EVENT0("sky", "Engine::OnInputEvent");
   scoped_ptr<blink::WebInputEvent> web_event =
       ConvertEvent(event, display_metrics_.device_pixel_ratio);
-  if (!web_event)
+  if (!web_event || !sky_view_)
     return;
-  if (sky_view_)
-    sky_view_->HandleInputEvent(*web_event);
+  if (blink::WebInputEvent::isPointerEventType(web_event->type)) {
+    DispatchPointerEvents(std::vector<blink::WebPointerEvent>(
+        1, static_cast<const blink::WebPointerEvent&>(*web_event)));
+    return;
+  }
+  FlushPointerMoves();
+  sky_view_->HandleInputEvent(*web_event);
 }
 
 void Engine::OnPointerPacket(pointer::PointerPacketPtr packet) {
-  // TODO(abarth): Process pointer events in packets.
+  TRACE_EVENT0("sky", "Engine::OnPointerPacket");
+  if (!sky_view_ || !packet)
+    return;
+  std::vector<blink::WebPointerEvent> events;
+  ConvertPointerPacket(packet, display_metrics_.device_pixel_ratio, &events);
+  DispatchPointerEvents(events);
+}
+
+void Engine::DispatchPointerEvents(
+    const std::vector<blink::WebPointerEvent>& events) {
+  // Without a running animator there is no next frame to wait for.
+  const bool buffer_moves = activity_running_ && have_surface_;
+  bool buffered = false;
+  std::vector<blink::WebPointerEvent> ready;
+  for (const blink::WebPointerEvent& event : events) {
+    if (buffer_moves && event.type == blink::WebInputEvent::PointerMove) {
+      pointer_moves_.AddMove(event);
+      buffered = true;
+      continue;
+    }
+    // Moves that arrived earlier have to be seen before anything else.
+    TakePointerMoves(&ready);
+    pointer_moves_.DidDispatch(event);
+    ready.push_back(event);
+  }
+  if (!ready.empty())
+    DeliverPointerEvents(ready);
+  if (buffered)
+    ScheduleFrame();
+}
+
+void Engine::FlushPointerMoves() {
+  if (pointer_moves_.empty() || !sky_view_)
+    return;
+  TRACE_EVENT0("sky", "Engine::FlushPointerMoves");
+  std::vector<blink::WebPointerEvent> moves;
+  TakePointerMoves(&moves);
+  DeliverPointerEvents(moves);
+}
+
+void Engine::DeliverPointerEvents(
+    const std::vector<blink::WebPointerEvent>& events) {
+  sky_view_->HandlePointerPacket(events);
+  if (gesture_recognizer_)
+    gesture_recognizer_->OnPointerEvents(events);
+}
+
+void Engine::OnGesture(const blink::WebGestureEvent& event) {
+  ForwardScrollGesture(event);
+  if (sky_view_)
+    sky_view_->HandleInputEvent(event);
+}
+
+void Engine::ForwardScrollGesture(const blink::WebGestureEvent& event) {
+  using compositor::ScrollGesture;
+
+  // The compositor works in physical pixels.
+  const float scale = display_metrics_.device_pixel_ratio;
+  ScrollGesture gesture;
+  switch (event.type) {
+    case blink::WebInputEvent::GestureScrollBegin:
+      gesture.type = ScrollGesture::Type::kBegin;
+      break;
+    case blink::WebInputEvent::GestureScrollUpdate:
+      gesture.type = ScrollGesture::Type::kUpdate;
+      gesture.delta.set(event.data.scrollUpdate.deltaX * scale,
+                        event.data.scrollUpdate.deltaY * scale);
+      break;
+    case blink::WebInputEvent::GestureScrollEnd:
+      gesture.type = ScrollGesture::Type::kEnd;
+      break;
+    case blink::WebInputEvent::GestureFlingStart:
+      gesture.type = ScrollGesture::Type::kFling;
+      gesture.velocity.set(event.data.flingStart.velocityX * scale,
+                           event.data.flingStart.velocityY * scale);
+      break;
+    default:
+      return;
+  }
+  gesture.time = base::TimeTicks() +
+                 base::TimeDelta::FromMicroseconds(
+                     static_cast<int64_t>(event.timeStampMS * 1000));
+  gesture.position.set(event.x * scale, event.y * scale);
+  config_.gpu_task_runner->PostTask(
+      FROM_HERE,
+      base::Bind(&GPUDelegate::Scroll, config_.gpu_delegate, gesture));
+}
+
+void Engine::TakePointerMoves(std::vector<blink::WebPointerEvent>* events) {
+  if (pointer_moves_.empty())
+    return;
+  // Apps that take packets get the whole history at no extra cost. The
+  // others would handle every move separately, so they only see the
+  // latest position of each pointer.
+  if (sky_view_->HasPointerPacketCallback())
+    pointer_moves_.TakeAll(events);
+  else
+    pointer_moves_.TakeCoalesced(events);
 }
 
 void Engine::RunFromLibrary(const std::string& name) {
@@ -173,6 +381,8 @@ void Engine::RunFromLibrary(const std::string& name) {
 void Engine::RunFromSnapshotStream(
     const std::string& name,
     mojo::ScopedDataPipeConsumerHandle snapshot) {
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::SnapshotAvailable);
   sky_view_ = blink::SkyView::Create(this);
   sky_view_->CreateView(blink::WebString::fromUTF8(name));
   sky_view_->RunFromSnapshot(blink::WebString::fromUTF8(name), snapshot.Pass());
@@ -180,25 +390,74 @@ void Engine::RunFromSnapshotStream(
 }
 
 void Engine::RunFromNetwork(const mojo::String& url) {
-  dart_library_provider_.reset(
-      new DartLibraryProviderNetwork(network_service_.get()));
+  StartupTimeline::Shared().Record(StartupTimeline::Milestone::AppRunStart);
+  dart_library_provider_.reset(new DartLibraryProviderNetwork(
+      network_service_.get(),
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          switches::kLibraryCacheDir)));
   RunFromLibrary(url);
 }
 
 void Engine::RunFromFile(const mojo::String& main,
                          const mojo::String& package_root) {
+  StartupTimeline::Shared().Record(StartupTimeline::Milestone::AppRunStart);
   std::string package_root_str = package_root;
   dart_library_provider_.reset(
       new DartLibraryProviderFiles(base::FilePath(package_root_str)));
-  RunFromLibrary(main);
+
+  base::FilePath cache_dir =
+      base::CommandLine::ForCurrentProcess()->GetSwitchValuePath(
+          switches::kSnapshotCacheDir);
+  if (cache_dir.empty()) {
+    RunFromLibrary(main);
+    return;
+  }
+
+  std::string main_str = main;
+  base::PostTaskAndReplyWithResult(
+      blink::Platform::current()->workerTaskRunner(
+          blink::Platform::UserBlockingWorkerTask),
+      FROM_HERE,
+      base::Bind(&ScriptSnapshotCache::Find,
+                 base::Owned(new ScriptSnapshotCache(cache_dir)), main_str),
+      base::Bind(&Engine::DidFindScriptSnapshot, weak_factory_.GetWeakPtr(),
+                 main_str, cache_dir));
+}
+
+void Engine::DidFindScriptSnapshot(const std::string& name,
+                                   const base::FilePath& cache_dir,
+                                   const base::FilePath& snapshot_path) {
+  if (!snapshot_path.empty()) {
+    RunFromSnapshotFile(name, snapshot_path);
+    return;
+  }
+
+  sky_view_ = blink::SkyView::Create(this);
+  sky_view_->CreateView(blink::WebString::fromUTF8(name));
+  sky_view_->RunFromLibraryAndSnapshot(
+      blink::WebString::fromUTF8(name), dart_library_provider_.get(),
+      base::Bind(&StoreScriptSnapshot, cache_dir, name));
+  sky_view_->SetDisplayMetrics(display_metrics_);
 }
 
 void Engine::RunFromSnapshot(const mojo::String& path) {
+  StartupTimeline::Shared().Record(StartupTimeline::Milestone::AppRunStart);
   std::string path_str = path;
-  RunFromSnapshotStream(path_str, Fetch(base::FilePath(path_str)));
+  RunFromSnapshotFile(path_str, base::FilePath(path_str));
+}
+
+void Engine::RunFromSnapshotFile(const std::string& name,
+                                 const base::FilePath& path) {
+  StartupTimeline::Shared().Record(
+      StartupTimeline::Milestone::SnapshotAvailable);
+  sky_view_ = blink::SkyView::Create(this);
+  sky_view_->CreateView(blink::WebString::fromUTF8(name));
+  sky_view_->RunFromSnapshotFile(blink::WebString::fromUTF8(name), path);
+  sky_view_->SetDisplayMetrics(display_metrics_);
 }
 
 void Engine::RunFromBundle(const mojo::String& path) {
+  StartupTimeline::Shared().Record(StartupTimeline::Milestone::AppRunStart);
   AssetUnpackerJob* unpacker = new AssetUnpackerJob(
       mojo::GetProxy(&root_bundle_), base::WorkerPool::GetTaskRunner(true));
   std::string path_str = path;
@@ -211,6 +470,9 @@ void Engine::RunFromBundle(const mojo::String& path) {
 void Engine::OnActivityPaused() {
   activity_running_ = false;
   StopAnimator();
+  config_.gpu_task_runner->PostTask(
+      FROM_HERE,
+      base::Bind(&GPUDelegate::OnActivityPaused, config_.gpu_delegate));
 }
 
 void Engine::OnActivityResumed() {
@@ -219,6 +481,7 @@ void Engine::OnActivityResumed() {
 }
 
 void Engine::DidCreateIsolate(Dart_Isolate isolate) {
+  StartupTimeline::Shared().Record(StartupTimeline::Milestone::IsolateCreated);
   Internals::Create(isolate,
                     CreateServiceProvider(config_.service_provider_context),
                     root_bundle_.Pass());
@@ -226,6 +489,7 @@ void Engine::DidCreateIsolate(Dart_Isolate isolate) {
 
 void Engine::StopAnimator() {
   animator_->Stop();
+  FlushPointerMoves();
 }
 
 void Engine::StartAnimatorIfPossible() {
@@ -234,9 +498,38 @@ void Engine::StartAnimatorIfPossible() {
 }
 
 void Engine::ScheduleFrame() {
+  if (delivering_frame_input_)
+    return;
   animator_->RequestFrame();
 }
 
+void Engine::RasterizeToImage(scoped_ptr<compositor::LayerTree> layer_tree,
+                              const ImageCallback& callback) {
+  config_.gpu_task_runner->PostTask(
+      FROM_HERE,
+      base::Bind(&GPUDelegate::RasterizeToImage, config_.gpu_delegate,
+                 base::Passed(&layer_tree),
+                 base::Bind(&PostImageToTaskRunner,
+                            base::ThreadTaskRunnerHandle::Get(),
+                            config_.gpu_task_runner, callback)));
+}
+
+compositor::CompositorStatistics Engine::GetCompositorStatistics() {
+  if (!config_.compositor_statistics)
+    return compositor::CompositorStatistics();
+  return config_.compositor_statistics->Get();
+}
+
+bool Engine::GetScrollOffset(uint32_t scroll_id, SkPoint* offset) {
+  if (!config_.scroll_offsets)
+    return false;
+  return config_.scroll_offsets->Get(scroll_id, offset);
+}
+
+void Engine::OnScrollContentRequested() {
+  ScheduleFrame();
+}
+
 mojo::NavigatorHost* Engine::NavigatorHost() {
   return this;
 }
@@ -23,6 +23,8 @@
 #include "sky/engine/public/sky/sky_view_client.h"
 #include "sky/shell/gpu_delegate.h"
 #include "sky/shell/service_provider.h"
+#include "sky/shell/ui/gesture_recognizer.h"
+#include "sky/shell/ui/pointer_event_buffer.h"
 #include "sky/shell/ui_delegate.h"
 #include "third_party/skia/include/core/SkPicture.h"
 #include "ui/gfx/geometry/size.h"
@@ -31,6 +33,8 @@ namespace sky {
 class PlatformImpl;
 namespace shell {
 class Animator;
+class MemoryPressureCoordinator;
+class TaskScheduler;
 
 class Engine : public UIDelegate,
                public SkyEngine,
@@ -46,6 +50,10 @@ class Engine : public UIDelegate,
 
     base::WeakPtr<GPUDelegate> gpu_delegate;
     scoped_refptr<base::SingleThreadTaskRunner> gpu_task_runner;
+    // Updated by the GPU thread after each frame.
+    scoped_refptr<compositor::CompositorStatisticsStore> compositor_statistics;
+    // Updated by the GPU thread whenever it scrolls a scroll layer.
+    scoped_refptr<compositor::ScrollOffsetStore> scroll_offsets;
   };
 
   explicit Engine(const Config& config);
@@ -53,15 +61,28 @@ class Engine : public UIDelegate,
 
   base::WeakPtr<Engine> GetWeakPtr();
 
-  static void Init();
+  // Has to be called on the UI thread. The engine's caches are registered
+  // with |memory_pressure_coordinator|, and its worker tasks run on
+  // |task_scheduler|.
+  static void Init(MemoryPressureCoordinator* memory_pressure_coordinator,
+                   TaskScheduler* task_scheduler);
 
-  std::unique_ptr<compositor::LayerTree> BeginFrame(base::TimeTicks frame_time);
+  // |deadline| is when the frame is expected to be on screen.
+  std::unique_ptr<compositor::LayerTree> BeginFrame(base::TimeTicks frame_time,
+                                                    base::TimeTicks deadline);
+
+  // Gives Dart a chance to do low priority work until |deadline|.
+  void NotifyIdle(base::TimeTicks deadline);
 
   void StartDartTracing();
   void StopDartTracing(mojo::ScopedDataPipeProducerHandle producer);
 
   void SaveFrameToSkPicture(const base::FilePath& destination);
 
+  // Called when the GPU thread scrolled a scroll layer close to the end of
+  // its content, so that the app builds a frame with more of it.
+  void OnScrollContentRequested();
+
  private:
   // UIDelegate implementation:
   void ConnectToEngine(mojo::InterfaceRequest<SkyEngine> request) override;
@@ -85,6 +106,10 @@ class Engine : public UIDelegate,
   // SkyViewClient methods:
   void ScheduleFrame() override;
   void DidCreateIsolate(Dart_Isolate isolate) override;
+  void RasterizeToImage(scoped_ptr<compositor::LayerTree> layer_tree,
+                        const ImageCallback& callback) override;
+  compositor::CompositorStatistics GetCompositorStatistics() override;
+  bool GetScrollOffset(uint32_t scroll_id, SkPoint* offset) override;
 
   // Services methods:
   mojo::NavigatorHost* NavigatorHost() override;
@@ -98,10 +123,27 @@ class Engine : public UIDelegate,
   void RunFromLibrary(const std::string& name);
   void RunFromSnapshotStream(const std::string& name,
                              mojo::ScopedDataPipeConsumerHandle snapshot);
+  void RunFromSnapshotFile(const std::string& name,
+                           const base::FilePath& path);
+  void DidFindScriptSnapshot(const std::string& name,
+                             const base::FilePath& cache_dir,
+                             const base::FilePath& snapshot_path);
 
   void StopAnimator();
   void StartAnimatorIfPossible();
 
+  // Delivers |events| in order, except that moves are held back until the
+  // next frame while frames are being produced.
+  void DispatchPointerEvents(const std::vector<blink::WebPointerEvent>& events);
+  // Delivers the moves held back by DispatchPointerEvents.
+  void FlushPointerMoves();
+  void TakePointerMoves(std::vector<blink::WebPointerEvent>* events);
+  void DeliverPointerEvents(const std::vector<blink::WebPointerEvent>& events);
+  void OnGesture(const blink::WebGestureEvent& event);
+  // Hands scroll gestures to the GPU thread, which scrolls the scroll layers
+  // under them.
+  void ForwardScrollGesture(const blink::WebGestureEvent& event);
+
   Config config_;
   scoped_ptr<Animator> animator_;
 
@@ -118,6 +160,12 @@ class Engine : public UIDelegate,
   bool activity_running_;
   bool have_surface_;
 
+  PointerEventBuffer pointer_moves_;
+  // Only created with --enable-native-gestures.
+  scoped_ptr<GestureRecognizer> gesture_recognizer_;
+  // Set while the moves are delivered right before a frame is built.
+  bool delivering_frame_input_;
+
   base::WeakPtrFactory<Engine> weak_factory_;
 
   DISALLOW_COPY_AND_ASSIGN(Engine);
@@ -0,0 +1,91 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/ui/frame_scheduler.h"
+
+#include <algorithm>
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Used until enough vsyncs have been seen to measure the interval.
+const int64_t kDefaultVSyncIntervalMicroseconds = 16667;
+
+// Gaps between vsync timestamps outside of this range are the result of
+// skipped or paused frames and say nothing about the display.
+const int64_t kMinVSyncIntervalMicroseconds = 4000;
+const int64_t kMaxVSyncIntervalMicroseconds = 50000;
+
+// Absorbs scheduling delays between deciding to build a frame and actually
+// starting to build it.
+const int64_t kSchedulingSlackMicroseconds = 2000;
+
+// Frame costs are predicted from this percentile of recent frames, so that
+// only the occasional outlier misses its deadline.
+const double kPredictionPercentile = 90;
+
+}  // namespace
+
+FrameScheduler::FrameScheduler() {
+}
+
+FrameScheduler::~FrameScheduler() {
+}
+
+void FrameScheduler::DidVSync(base::TimeTicks vsync_time) {
+  if (!last_vsync_time_.is_null() && vsync_time > last_vsync_time_) {
+    const int64_t interval = (vsync_time - last_vsync_time_).InMicroseconds();
+    if (interval >= kMinVSyncIntervalMicroseconds &&
+        interval <= kMaxVSyncIntervalMicroseconds) {
+      vsync_intervals_.Add(base::TimeDelta::FromMicroseconds(interval));
+    }
+  }
+  last_vsync_time_ = vsync_time;
+}
+
+void FrameScheduler::DidBuildFrame(base::TimeDelta build_time) {
+  build_times_.Add(build_time);
+}
+
+void FrameScheduler::DidDrawFrame(base::TimeDelta draw_time) {
+  draw_times_.Add(draw_time);
+}
+
+base::TimeDelta FrameScheduler::vsync_interval() const {
+  if (display_interval_ > base::TimeDelta())
+    return display_interval_;
+  if (vsync_intervals_.size() == 0) {
+    return base::TimeDelta::FromMicroseconds(
+        kDefaultVSyncIntervalMicroseconds);
+  }
+  // Missed vsyncs only ever make intervals longer, so the median of the
+  // measurements is a good estimate of the display's refresh interval.
+  return vsync_intervals_.Percentile(50);
+}
+
+base::TimeDelta FrameScheduler::PredictedBuildTime() const {
+  return build_times_.Percentile(kPredictionPercentile);
+}
+
+base::TimeDelta FrameScheduler::PredictedDrawTime() const {
+  return draw_times_.Percentile(kPredictionPercentile);
+}
+
+base::TimeTicks FrameScheduler::Deadline(base::TimeTicks vsync_time) const {
+  return vsync_time + vsync_interval();
+}
+
+base::TimeTicks FrameScheduler::BuildStartTime(
+    base::TimeTicks vsync_time) const {
+  const base::TimeDelta frame_cost =
+      PredictedBuildTime() + PredictedDrawTime() +
+      base::TimeDelta::FromMicroseconds(kSchedulingSlackMicroseconds);
+  // Never start before the vsync itself. Frames that do not fit in one
+  // interval start right away and rely on the pipeline to keep up.
+  return std::max(vsync_time, Deadline(vsync_time) - frame_cost);
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,63 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_UI_FRAME_SCHEDULER_H_
+#define SKY_SHELL_UI_FRAME_SCHEDULER_H_
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "sky/compositor/instrumentation.h"
+
+namespace sky {
+namespace shell {
+
+// FrameScheduler predicts how long the next frame will take to build on the
+// UI thread and to draw on the GPU thread from the costs of recent frames.
+// The Animator uses the prediction to start building a frame as late as it
+// can while still meeting the vsync deadline, so that the frame sees the
+// freshest input.
+class FrameScheduler {
+ public:
+  FrameScheduler();
+  ~FrameScheduler();
+
+  void DidVSync(base::TimeTicks vsync_time);
+  // The refresh interval reported by the display, which takes precedence
+  // over the one measured from vsync timestamps.
+  void SetDisplayInterval(base::TimeDelta interval) {
+    display_interval_ = interval;
+  }
+  void DidBuildFrame(base::TimeDelta build_time);
+  void DidDrawFrame(base::TimeDelta draw_time);
+
+  // The interval between vsyncs, as reported by the display or measured from
+  // their timestamps.
+  base::TimeDelta vsync_interval() const;
+
+  // Conservative estimates that most recent frames stayed within.
+  base::TimeDelta PredictedBuildTime() const;
+  base::TimeDelta PredictedDrawTime() const;
+
+  // The time by which the frame started for |vsync_time| has to be on
+  // screen, which is the following vsync.
+  base::TimeTicks Deadline(base::TimeTicks vsync_time) const;
+
+  // The latest time building the frame for |vsync_time| can start and
+  // still be expected to meet its deadline.
+  base::TimeTicks BuildStartTime(base::TimeTicks vsync_time) const;
+
+ private:
+  base::TimeTicks last_vsync_time_;
+  base::TimeDelta display_interval_;
+  compositor::instrumentation::FrameTimeHistory vsync_intervals_;
+  compositor::instrumentation::FrameTimeHistory build_times_;
+  compositor::instrumentation::FrameTimeHistory draw_times_;
+
+  DISALLOW_COPY_AND_ASSIGN(FrameScheduler);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_UI_FRAME_SCHEDULER_H_
@@ -0,0 +1,239 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/ui/gesture_recognizer.h"
+
+#include "base/logging.h"
+#include "ui/events/gesture_detection/gesture_config_helper.h"
+#include "ui/events/gesture_detection/gesture_event_data.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// Matches the fling velocity cap of the gesture detector, in logical pixels
+// per second.
+const float kMaxVelocity = 15000;
+
+ui::GestureProvider::Config CreateProviderConfig() {
+  ui::GestureProvider::Config config = ui::DefaultGestureProviderConfig();
+  // Begin and end gestures need one cancel per pointer, which the platforms
+  // Sky runs on do not send.
+  config.gesture_begin_end_types_enabled = false;
+  return config;
+}
+
+base::TimeTicks EventTime(const blink::WebPointerEvent& event) {
+  return base::TimeTicks() +
+         base::TimeDelta::FromMicroseconds(
+             static_cast<int64_t>(event.timeStampMS * 1000));
+}
+
+bool ConvertGestureType(ui::EventType type, blink::WebInputEvent::Type* out) {
+  switch (type) {
+    case ui::ET_GESTURE_SCROLL_BEGIN:
+      *out = blink::WebInputEvent::GestureScrollBegin;
+      return true;
+    case ui::ET_GESTURE_SCROLL_UPDATE:
+      *out = blink::WebInputEvent::GestureScrollUpdate;
+      return true;
+    case ui::ET_GESTURE_SCROLL_END:
+      *out = blink::WebInputEvent::GestureScrollEnd;
+      return true;
+    case ui::ET_SCROLL_FLING_START:
+      *out = blink::WebInputEvent::GestureFlingStart;
+      return true;
+    case ui::ET_SCROLL_FLING_CANCEL:
+      *out = blink::WebInputEvent::GestureFlingCancel;
+      return true;
+    case ui::ET_GESTURE_SHOW_PRESS:
+      *out = blink::WebInputEvent::GestureShowPress;
+      return true;
+    case ui::ET_GESTURE_TAP:
+      *out = blink::WebInputEvent::GestureTap;
+      return true;
+    case ui::ET_GESTURE_TAP_UNCONFIRMED:
+      *out = blink::WebInputEvent::GestureTapUnconfirmed;
+      return true;
+    case ui::ET_GESTURE_TAP_DOWN:
+      *out = blink::WebInputEvent::GestureTapDown;
+      return true;
+    case ui::ET_GESTURE_TAP_CANCEL:
+      *out = blink::WebInputEvent::GestureTapCancel;
+      return true;
+    case ui::ET_GESTURE_DOUBLE_TAP:
+      *out = blink::WebInputEvent::GestureDoubleTap;
+      return true;
+    case ui::ET_GESTURE_TWO_FINGER_TAP:
+      *out = blink::WebInputEvent::GestureTwoFingerTap;
+      return true;
+    case ui::ET_GESTURE_LONG_PRESS:
+      *out = blink::WebInputEvent::GestureLongPress;
+      return true;
+    case ui::ET_GESTURE_LONG_TAP:
+      *out = blink::WebInputEvent::GestureLongTap;
+      return true;
+    case ui::ET_GESTURE_PINCH_BEGIN:
+      *out = blink::WebInputEvent::GesturePinchBegin;
+      return true;
+    case ui::ET_GESTURE_PINCH_END:
+      *out = blink::WebInputEvent::GesturePinchEnd;
+      return true;
+    case ui::ET_GESTURE_PINCH_UPDATE:
+      *out = blink::WebInputEvent::GesturePinchUpdate;
+      return true;
+    default:
+      return false;
+  }
+}
+
+}  // namespace
+
+GestureRecognizer::GestureRecognizer(const GestureCallback& callback)
+    : callback_(callback), provider_(CreateProviderConfig(), this) {
+  // A double tap would delay every single tap until it times out.
+  provider_.SetDoubleTapSupportForPlatformEnabled(false);
+}
+
+GestureRecognizer::~GestureRecognizer() {
+}
+
+void GestureRecognizer::OnPointerEvents(
+    const std::vector<blink::WebPointerEvent>& events) {
+  for (const blink::WebPointerEvent& event : events) {
+    if (event.kind == blink::WebPointerEvent::Touch)
+      OnTouch(event);
+  }
+}
+
+ui::PointerProperties GestureRecognizer::PropertiesFor(
+    const blink::WebPointerEvent& event) {
+  ui::PointerProperties properties(event.x, event.y);
+  properties.id = event.pointer;
+  properties.tool_type = ui::MotionEvent::TOOL_TYPE_FINGER;
+  properties.pressure = event.pressure;
+  properties.touch_major = event.radiusMajor * 2;
+  properties.touch_minor = event.radiusMinor * 2;
+  properties.orientation = event.orientation;
+  return properties;
+}
+
+void GestureRecognizer::OnTouch(const blink::WebPointerEvent& event) {
+  size_t index = 0;
+  while (index < touches_.size() && touches_[index].pointer != event.pointer)
+    ++index;
+  const bool is_down = index < touches_.size();
+
+  ui::MotionEvent::Action action;
+  switch (event.type) {
+    case blink::WebInputEvent::PointerDown:
+      if (is_down)
+        return;
+      touches_.push_back(event);
+      action = touches_.size() == 1 ? ui::MotionEvent::ACTION_DOWN
+                                    : ui::MotionEvent::ACTION_POINTER_DOWN;
+      break;
+    case blink::WebInputEvent::PointerMove:
+      if (!is_down)
+        return;
+      touches_[index] = event;
+      action = ui::MotionEvent::ACTION_MOVE;
+      break;
+    case blink::WebInputEvent::PointerUp:
+      if (!is_down)
+        return;
+      touches_[index] = event;
+      action = touches_.size() == 1 ? ui::MotionEvent::ACTION_UP
+                                    : ui::MotionEvent::ACTION_POINTER_UP;
+      break;
+    case blink::WebInputEvent::PointerCancel:
+      if (!is_down)
+        return;
+      action = ui::MotionEvent::ACTION_CANCEL;
+      break;
+    default:
+      NOTREACHED();
+      return;
+  }
+
+  // Like Android, every motion event carries all of the touches that are
+  // down, including the one that changed.
+  ui::MotionEventGeneric motion_event(action, EventTime(event),
+                                      PropertiesFor(touches_[0]));
+  for (size_t i = 1; i < touches_.size(); ++i)
+    motion_event.PushPointer(PropertiesFor(touches_[i]));
+  if (action == ui::MotionEvent::ACTION_POINTER_DOWN)
+    motion_event.set_action_index(touches_.size() - 1);
+  else if (action == ui::MotionEvent::ACTION_POINTER_UP)
+    motion_event.set_action_index(index);
+
+  velocity_tracker_.AddMovement(motion_event);
+  provider_.OnTouchEvent(motion_event);
+
+  if (action == ui::MotionEvent::ACTION_CANCEL) {
+    touches_.clear();
+    velocity_tracker_.Clear();
+  } else if (action == ui::MotionEvent::ACTION_UP) {
+    touches_.clear();
+  } else if (action == ui::MotionEvent::ACTION_POINTER_UP) {
+    touches_.erase(touches_.begin() + index);
+  }
+}
+
+void GestureRecognizer::OnGestureEvent(const ui::GestureEventData& gesture) {
+  blink::WebGestureEvent web_event;
+  if (!ConvertGestureType(gesture.type(), &web_event.type))
+    return;
+
+  web_event.timeStampMS = (gesture.time - base::TimeTicks()).InMillisecondsF();
+  web_event.primaryPointer = gesture.motion_event_id;
+  web_event.x = gesture.x;
+  web_event.y = gesture.y;
+
+  const ui::GestureEventDetails& details = gesture.details;
+  switch (gesture.type()) {
+    case ui::ET_GESTURE_SCROLL_BEGIN:
+      web_event.data.scrollBegin.deltaXHint = details.scroll_x_hint();
+      web_event.data.scrollBegin.deltaYHint = details.scroll_y_hint();
+      break;
+    case ui::ET_GESTURE_SCROLL_UPDATE:
+      web_event.data.scrollUpdate.deltaX = details.scroll_x();
+      web_event.data.scrollUpdate.deltaY = details.scroll_y();
+      if (!touches_.empty()) {
+        velocity_tracker_.ComputeCurrentVelocity(1000, kMaxVelocity);
+        web_event.data.scrollUpdate.velocityX =
+            velocity_tracker_.GetXVelocity(touches_[0].pointer);
+        web_event.data.scrollUpdate.velocityY =
+            velocity_tracker_.GetYVelocity(touches_[0].pointer);
+      }
+      break;
+    case ui::ET_SCROLL_FLING_START:
+      web_event.data.flingStart.velocityX = details.velocity_x();
+      web_event.data.flingStart.velocityY = details.velocity_y();
+      break;
+    case ui::ET_GESTURE_TAP:
+    case ui::ET_GESTURE_TAP_UNCONFIRMED:
+    case ui::ET_GESTURE_DOUBLE_TAP:
+      web_event.data.tap.tapCount = details.tap_count();
+      web_event.data.tap.width = details.bounding_box_f().width();
+      web_event.data.tap.height = details.bounding_box_f().height();
+      break;
+    case ui::ET_GESTURE_TWO_FINGER_TAP:
+      web_event.data.twoFingerTap.firstFingerWidth =
+          details.first_finger_width();
+      web_event.data.twoFingerTap.firstFingerHeight =
+          details.first_finger_height();
+      break;
+    case ui::ET_GESTURE_PINCH_UPDATE:
+      web_event.data.pinchUpdate.scale = details.scale();
+      break;
+    default:
+      break;
+  }
+
+  callback_.Run(web_event);
+}
+
+}  // namespace shell
+}  // namespace sky
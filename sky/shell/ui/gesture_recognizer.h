@@ -0,0 +1,55 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_UI_GESTURE_RECOGNIZER_H_
+#define SKY_SHELL_UI_GESTURE_RECOGNIZER_H_
+
+#include <vector>
+
+#include "base/callback.h"
+#include "base/macros.h"
+#include "sky/engine/public/platform/WebInputEvent.h"
+#include "ui/events/gesture_detection/gesture_provider.h"
+#include "ui/events/gesture_detection/motion_event_generic.h"
+#include "ui/events/gesture_detection/velocity_tracker_state.h"
+
+namespace sky {
+namespace shell {
+
+// GestureRecognizer runs touches through ui::GestureProvider, so that apps
+// can listen for taps, scrolls, flings and pinches instead of tracking every
+// pointer in Dart. Long presses and show presses are detected on timers, so
+// gestures can arrive outside of OnPointerEvents.
+class GestureRecognizer : public ui::GestureProviderClient {
+ public:
+  typedef base::Callback<void(const blink::WebGestureEvent&)> GestureCallback;
+
+  explicit GestureRecognizer(const GestureCallback& callback);
+  ~GestureRecognizer() override;
+
+  // Only touches are recognized; other pointers are ignored.
+  void OnPointerEvents(const std::vector<blink::WebPointerEvent>& events);
+
+ private:
+  // ui::GestureProviderClient implementation:
+  void OnGestureEvent(const ui::GestureEventData& gesture) override;
+
+  void OnTouch(const blink::WebPointerEvent& event);
+  ui::PointerProperties PropertiesFor(const blink::WebPointerEvent& event);
+
+  GestureCallback callback_;
+  ui::GestureProvider provider_;
+  // Gives scroll updates the velocity of the finger that drives them. The
+  // provider's detector only reports a velocity when a fling starts.
+  ui::VelocityTrackerState velocity_tracker_;
+  // The touches that are down, in the order they went down.
+  std::vector<blink::WebPointerEvent> touches_;
+
+  DISALLOW_COPY_AND_ASSIGN(GestureRecognizer);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_UI_GESTURE_RECOGNIZER_H_
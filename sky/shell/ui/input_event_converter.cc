@@ -139,4 +139,66 @@ scoped_ptr<blink::WebInputEvent> ConvertEvent(const InputEventPtr& event,
   return scoped_ptr<blink::WebInputEvent>();
 }
 
+void ConvertPointerPacket(const pointer::PointerPacketPtr& packet,
+                          float device_pixel_ratio,
+                          std::vector<blink::WebPointerEvent>* events) {
+  if (!packet->pointers)
+    return;
+
+  events->reserve(events->size() + packet->pointers.size());
+  for (size_t i = 0; i < packet->pointers.size(); ++i) {
+    const pointer::PointerPtr& pointer = packet->pointers[i];
+    blink::WebPointerEvent web_event;
+
+    web_event.timeStampMS = pointer->time_stamp;
+
+    switch (pointer->type) {
+      case pointer::POINTER_TYPE_DOWN:
+        web_event.type = blink::WebInputEvent::PointerDown;
+        break;
+      case pointer::POINTER_TYPE_UP:
+        web_event.type = blink::WebInputEvent::PointerUp;
+        break;
+      case pointer::POINTER_TYPE_MOVE:
+        web_event.type = blink::WebInputEvent::PointerMove;
+        break;
+      case pointer::POINTER_TYPE_CANCEL:
+        web_event.type = blink::WebInputEvent::PointerCancel;
+        break;
+    }
+
+    switch (pointer->kind) {
+      case pointer::POINTER_KIND_TOUCH:
+        web_event.kind = blink::WebPointerEvent::Touch;
+        break;
+      case pointer::POINTER_KIND_MOUSE:
+        web_event.kind = blink::WebPointerEvent::Mouse;
+        break;
+      case pointer::POINTER_KIND_STYLUS:
+      case pointer::POINTER_KIND_INVERTED_STYLUS:
+        web_event.kind = blink::WebPointerEvent::Stylus;
+        break;
+    }
+
+    web_event.pointer = pointer->pointer;
+    web_event.x = pointer->x / device_pixel_ratio;
+    web_event.y = pointer->y / device_pixel_ratio;
+    web_event.buttons = pointer->buttons;
+    web_event.pressure = pointer->pressure;
+    web_event.pressureMin = pointer->pressure_min;
+    web_event.pressureMax = pointer->pressure_max;
+    web_event.distance = pointer->distance;
+    web_event.distanceMin = pointer->distance_min;
+    web_event.distanceMax = pointer->distance_max;
+    web_event.radiusMajor = pointer->radius_major;
+    web_event.radiusMinor = pointer->radius_minor;
+    web_event.radiusMin = pointer->radius_min;
+    web_event.radiusMax = pointer->radius_max;
+    web_event.orientation = pointer->orientation;
+    web_event.tilt = pointer->tilt;
+
+    events->push_back(web_event);
+  }
+}
+
 }  // namespace mojo
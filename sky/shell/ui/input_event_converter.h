@@ -5,17 +5,26 @@
 #ifndef SKY_SHELL_UI_INPUT_EVENT_CONVERTER_H_
 #define SKY_SHELL_UI_INPUT_EVENT_CONVERTER_H_
 
+#include <vector>
+
 #include "base/memory/scoped_ptr.h"
 #include "sky/services/engine/input_event.mojom.h"
+#include "sky/services/pointer/pointer.mojom.h"
 
 namespace blink {
 class WebInputEvent;
+class WebPointerEvent;
 }
 
 namespace sky {
 
 scoped_ptr<blink::WebInputEvent> ConvertEvent(const InputEventPtr& event,
                                               float device_pixel_ratio);
+
+// Appends one event per pointer in |packet| to |events|.
+void ConvertPointerPacket(const pointer::PointerPacketPtr& packet,
+                          float device_pixel_ratio,
+                          std::vector<blink::WebPointerEvent>* events);
 }
 
 #endif  // SKY_SHELL_UI_INPUT_EVENT_CONVERTER_H_
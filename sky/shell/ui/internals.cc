@@ -12,6 +12,7 @@
 #include "sky/engine/tonic/dart_converter.h"
 #include "sky/engine/tonic/dart_error.h"
 #include "sky/engine/tonic/dart_state.h"
+#include "sky/shell/startup_timeline.h"
 
 using namespace blink;
 
@@ -51,7 +52,23 @@ void TakeServiceRegistry(Dart_NativeArguments args) {
   Dart_SetIntegerReturnValue(args, 0);
 }
 
+// Returns the milestones as a flat list of names and microseconds since the
+// launch of the process, which sky_internals.dart turns into a map.
+void GetStartupMilestones(Dart_NativeArguments args) {
+  const StartupTimeline::Milestones milestones =
+      StartupTimeline::Shared().GetMilestones();
+  Dart_Handle list = Dart_NewList(milestones.size() * 2);
+  for (size_t i = 0; i < milestones.size(); ++i) {
+    Dart_ListSetAt(list, i * 2,
+                   ToDart(StartupTimeline::GetName(milestones[i].first)));
+    Dart_ListSetAt(list, i * 2 + 1,
+                   Dart_NewInteger(milestones[i].second.InMicroseconds()));
+  }
+  Dart_SetReturnValue(args, list);
+}
+
 const DartBuiltin::Natives kNativeFunctions[] = {
+    {"getStartupMilestones", GetStartupMilestones, 0},
     {"notifyTestComplete", NotifyTestComplete, 1},
     {"takeRootBundleHandle", TakeRootBundleHandle, 0},
     {"takeServiceRegistry", TakeServiceRegistry, 0},
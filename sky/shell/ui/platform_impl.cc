@@ -4,11 +4,41 @@
 
 #include "sky/shell/ui/platform_impl.h"
 
+#include "base/memory/discardable_memory.h"
+#include "base/memory/discardable_memory_allocator.h"
+#include "sky/engine/public/platform/WebDiscardableMemory.h"
+
 namespace sky {
 namespace shell {
+namespace {
+
+// Lets the engine's purgeable buffers share the shell's discardable memory
+// budget with Skia's lazily decoded images.
+class WebDiscardableMemoryImpl : public blink::WebDiscardableMemory {
+ public:
+  explicit WebDiscardableMemoryImpl(scoped_ptr<base::DiscardableMemory> memory)
+      : memory_(memory.Pass()) {}
+  ~WebDiscardableMemoryImpl() override {}
+
+  // blink::WebDiscardableMemory:
+  bool lock() override { return memory_->Lock(); }
+  void* data() override { return memory_->data(); }
+  void unlock() override { memory_->Unlock(); }
+
+ private:
+  scoped_ptr<base::DiscardableMemory> memory_;
+
+  DISALLOW_COPY_AND_ASSIGN(WebDiscardableMemoryImpl);
+};
 
-PlatformImpl::PlatformImpl()
-    : main_thread_task_runner_(base::MessageLoop::current()->task_runner()) {
+}  // namespace
+
+PlatformImpl::PlatformImpl(TaskScheduler* task_scheduler)
+    : main_thread_task_runner_(base::MessageLoop::current()->task_runner()),
+      user_blocking_task_runner_(task_scheduler->task_runner(
+          TaskScheduler::TaskPriority::kUserBlocking)),
+      background_task_runner_(task_scheduler->task_runner(
+          TaskScheduler::TaskPriority::kBackground)) {
 }
 
 PlatformImpl::~PlatformImpl() {
@@ -22,5 +52,21 @@ base::SingleThreadTaskRunner* PlatformImpl::mainThreadTaskRunner() {
   return main_thread_task_runner_.get();
 }
 
+base::TaskRunner* PlatformImpl::workerTaskRunner(WorkerTaskPriority priority) {
+  if (priority == BackgroundWorkerTask)
+    return background_task_runner_.get();
+  return user_blocking_task_runner_.get();
+}
+
+blink::WebDiscardableMemory* PlatformImpl::allocateAndLockDiscardableMemory(
+    size_t bytes) {
+  scoped_ptr<base::DiscardableMemory> memory =
+      base::DiscardableMemoryAllocator::GetInstance()
+          ->AllocateLockedDiscardableMemory(bytes);
+  if (!memory)
+    return nullptr;
+  return new WebDiscardableMemoryImpl(memory.Pass());
+}
+
 }  // namespace shell
 }  // namespace sky
@@ -7,21 +7,28 @@
 
 #include "base/message_loop/message_loop.h"
 #include "sky/engine/public/platform/Platform.h"
+#include "sky/shell/task_scheduler.h"
 
 namespace sky {
 namespace shell {
 
 class PlatformImpl : public blink::Platform {
  public:
-  explicit PlatformImpl();
+  // Worker tasks are run on |task_scheduler|.
+  explicit PlatformImpl(TaskScheduler* task_scheduler);
   ~PlatformImpl() override;
 
   // blink::Platform methods:
   blink::WebString defaultLocale() override;
   base::SingleThreadTaskRunner* mainThreadTaskRunner() override;
+  base::TaskRunner* workerTaskRunner(WorkerTaskPriority priority) override;
+  blink::WebDiscardableMemory* allocateAndLockDiscardableMemory(
+      size_t bytes) override;
 
  private:
   scoped_refptr<base::SingleThreadTaskRunner> main_thread_task_runner_;
+  scoped_refptr<base::TaskRunner> user_blocking_task_runner_;
+  scoped_refptr<base::TaskRunner> background_task_runner_;
 
   DISALLOW_COPY_AND_ASSIGN(PlatformImpl);
 };
@@ -0,0 +1,136 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/ui/pointer_event_buffer.h"
+
+#include <algorithm>
+
+#include "base/logging.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// The same values as Android's input resampling. Sampling a little in the
+// past means there usually is a sample on either side to interpolate
+// between.
+const double kResampleLatencyMS = 5;
+
+// Extrapolating further than this, or than half the interval between the
+// samples, overshoots when the finger changes direction.
+const double kMaxPredictionMS = 8;
+
+// Samples closer together than this give a poor estimate of the velocity.
+const double kMinSampleIntervalMS = 2;
+
+}  // namespace
+
+PointerEventBuffer::PointerEventBuffer() {
+}
+
+PointerEventBuffer::~PointerEventBuffer() {
+}
+
+void PointerEventBuffer::AddMove(const blink::WebPointerEvent& event) {
+  DCHECK_EQ(event.type, blink::WebInputEvent::PointerMove);
+  moves_.push_back(event);
+
+  PointerSamples* samples = FindSamples(event.pointer);
+  if (!samples) {
+    samples_.push_back(PointerSamples());
+    samples = &samples_.back();
+    samples->pointer = event.pointer;
+    samples->has_previous = false;
+  } else {
+    samples->previous = samples->latest;
+    samples->has_previous = true;
+  }
+  samples->latest = event;
+}
+
+void PointerEventBuffer::DidDispatch(const blink::WebPointerEvent& event) {
+  if (event.type == blink::WebInputEvent::PointerMove)
+    return;
+  for (auto it = samples_.begin(); it != samples_.end(); ++it) {
+    if (it->pointer == event.pointer) {
+      samples_.erase(it);
+      return;
+    }
+  }
+}
+
+void PointerEventBuffer::Resample(base::TimeTicks frame_time) {
+  const double sample_time_ms =
+      (frame_time - base::TimeTicks()).InMillisecondsF() - kResampleLatencyMS;
+
+  // Only the latest move of each pointer is resampled.
+  std::vector<int> seen_pointers;
+  for (auto it = moves_.rbegin(); it != moves_.rend(); ++it) {
+    blink::WebPointerEvent& move = *it;
+    if (std::find(seen_pointers.begin(), seen_pointers.end(), move.pointer) !=
+        seen_pointers.end()) {
+      continue;
+    }
+    seen_pointers.push_back(move.pointer);
+
+    PointerSamples* samples = FindSamples(move.pointer);
+    if (move.kind != blink::WebPointerEvent::Touch || !samples ||
+        !samples->has_previous) {
+      continue;
+    }
+
+    const blink::WebPointerEvent& previous = samples->previous;
+    const blink::WebPointerEvent& latest = samples->latest;
+    const double interval = latest.timeStampMS - previous.timeStampMS;
+    if (interval < kMinSampleIntervalMS ||
+        sample_time_ms <= previous.timeStampMS) {
+      continue;
+    }
+
+    double time = sample_time_ms;
+    if (time > latest.timeStampMS) {
+      time = std::min(time, latest.timeStampMS +
+                                std::min(interval / 2, kMaxPredictionMS));
+    }
+    const float alpha = (time - previous.timeStampMS) / interval;
+    move.x = previous.x + (latest.x - previous.x) * alpha;
+    move.y = previous.y + (latest.y - previous.y) * alpha;
+    move.timeStampMS = time;
+  }
+}
+
+void PointerEventBuffer::TakeAll(std::vector<blink::WebPointerEvent>* events) {
+  events->insert(events->end(), moves_.begin(), moves_.end());
+  moves_.clear();
+}
+
+void PointerEventBuffer::TakeCoalesced(
+    std::vector<blink::WebPointerEvent>* events) {
+  // Only a handful of pointers are ever down at once, so a linear search
+  // for the ones already seen is cheapest.
+  std::vector<int> seen_pointers;
+  const size_t first = events->size();
+  for (auto it = moves_.rbegin(); it != moves_.rend(); ++it) {
+    if (std::find(seen_pointers.begin(), seen_pointers.end(), it->pointer) !=
+        seen_pointers.end()) {
+      continue;
+    }
+    seen_pointers.push_back(it->pointer);
+    events->push_back(*it);
+  }
+  std::reverse(events->begin() + first, events->end());
+  moves_.clear();
+}
+
+PointerEventBuffer::PointerSamples* PointerEventBuffer::FindSamples(
+    int pointer) {
+  for (PointerSamples& samples : samples_) {
+    if (samples.pointer == pointer)
+      return &samples;
+  }
+  return nullptr;
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,73 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_UI_POINTER_EVENT_BUFFER_H_
+#define SKY_SHELL_UI_POINTER_EVENT_BUFFER_H_
+
+#include <vector>
+
+#include "base/macros.h"
+#include "base/time/time.h"
+#include "sky/engine/public/platform/WebInputEvent.h"
+
+namespace sky {
+namespace shell {
+
+// PointerEventBuffer holds pointer moves until the next frame is built, so
+// that the app handles them once per frame rather than once per event, in
+// the spirit of ui::MotionEventBuffer. Every move is kept; the app either
+// gets all of them in one packet or only the latest move of each pointer.
+//
+// Touch screens sample at their own rate, so the positions the app sees
+// would jitter against the display's vsync. Like Android's input
+// resampling, the latest move of each touch can be moved to a point in time
+// just before the frame, interpolated between the last two samples or
+// extrapolated a few milliseconds past them.
+class PointerEventBuffer {
+ public:
+  PointerEventBuffer();
+  ~PointerEventBuffer();
+
+  bool empty() const { return moves_.empty(); }
+
+  void AddMove(const blink::WebPointerEvent& event);
+
+  // Forgets the samples of |event|'s pointer when it goes down, up or is
+  // cancelled, so that they do not bleed into its next gesture.
+  void DidDispatch(const blink::WebPointerEvent& event);
+
+  // Moves the latest buffered move of each touch to where the pointer is
+  // estimated to be at |frame_time|, minus a small latency that keeps the
+  // estimate an interpolation most of the time.
+  void Resample(base::TimeTicks frame_time);
+
+  // Appends every buffered move to |events| in the order they arrived.
+  void TakeAll(std::vector<blink::WebPointerEvent>* events);
+
+  // Appends the latest buffered move of each pointer to |events|, ordered by
+  // when those moves arrived, and drops the rest.
+  void TakeCoalesced(std::vector<blink::WebPointerEvent>* events);
+
+ private:
+  // The last two samples the device reported for a pointer, before any
+  // resampling.
+  struct PointerSamples {
+    int pointer;
+    bool has_previous;
+    blink::WebPointerEvent previous;
+    blink::WebPointerEvent latest;
+  };
+
+  PointerSamples* FindSamples(int pointer);
+
+  std::vector<blink::WebPointerEvent> moves_;
+  std::vector<PointerSamples> samples_;
+
+  DISALLOW_COPY_AND_ASSIGN(PointerEventBuffer);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_UI_POINTER_EVENT_BUFFER_H_
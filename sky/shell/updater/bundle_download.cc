@@ -0,0 +1,494 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/updater/bundle_download.h"
+
+#include <algorithm>
+
+#include "base/bind.h"
+#include "base/files/file.h"
+#include "base/logging.h"
+#include "base/md5.h"
+#include "base/message_loop/message_loop.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+#include "base/task_runner_util.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+// How much of the response is read from the pipe at a time. Small reads keep
+// a throttled download smooth instead of bursty.
+const uint32_t kMaxReadSize = 16 * 1024;
+
+const int kFileBufferSize = 64 * 1024;
+
+// Attempts per Start(), so that a flaky connection gets a few chances before
+// the update check gives up until next time.
+const int kMaxAttempts = 3;
+const int64 kRetryDelaySeconds = 5;
+
+const int kPartialContentStatus = 206;
+const int kRangeNotSatisfiableStatus = 416;
+
+std::string FindHeader(const mojo::URLResponsePtr& response,
+                       const char* name) {
+  for (size_t i = 0; i < response->headers.size(); ++i) {
+    if (base::LowerCaseEqualsASCII(response->headers[i]->name.get(), name))
+      return response->headers[i]->value;
+  }
+  return std::string();
+}
+
+// Parses "bytes <first>-<last>/<total>". |total| is -1 if the server does not
+// know it.
+bool ParseContentRange(const std::string& value, int64* first, int64* total) {
+  const char kPrefix[] = "bytes ";
+  if (!base::StartsWith(value, kPrefix, base::CompareCase::INSENSITIVE_ASCII))
+    return false;
+  std::string range = value.substr(sizeof(kPrefix) - 1);
+  size_t dash = range.find('-');
+  size_t slash = range.find('/');
+  if (dash == std::string::npos || slash == std::string::npos || dash > slash)
+    return false;
+  if (!base::StringToInt64(range.substr(0, dash), first))
+    return false;
+  std::string total_string = range.substr(slash + 1);
+  if (total_string == "*") {
+    *total = -1;
+    return true;
+  }
+  return base::StringToInt64(total_string, total);
+}
+
+}  // namespace
+
+// The file on disk. All of its methods block on file IO and are called on
+// the worker runner, one at a time.
+class BundleDownload::PartialFile
+    : public base::RefCountedThreadSafe<PartialFile> {
+ public:
+  explicit PartialFile(const base::FilePath& path)
+      : path_(path), chunk_size_(0), position_(0) {}
+
+  void SetChunkHashes(int64 chunk_size,
+                      const std::vector<std::string>& chunk_md5s) {
+    chunk_size_ = chunk_size;
+    chunk_md5s_ = chunk_md5s;
+  }
+
+  // Opens the file, cuts it back to the chunks that still check out and
+  // returns its length, or -1 on error.
+  int64 Open() {
+    file_.Initialize(path_, base::File::FLAG_OPEN_ALWAYS |
+                                base::File::FLAG_READ |
+                                base::File::FLAG_WRITE);
+    if (!file_.IsValid()) {
+      LOG(ERROR) << "Opening '" << path_.value() << "' failed.";
+      return -1;
+    }
+    int64 length = file_.GetLength();
+    if (length < 0)
+      return -1;
+
+    if (has_chunk_hashes()) {
+      int64 verified = 0;
+      for (size_t i = 0; i < chunk_md5s_.size() && verified < length; ++i) {
+        // Only the last chunk of a bundle can be shorter than the others.
+        int64 size = std::min(chunk_size_, length - verified);
+        if (size < chunk_size_ && i + 1 < chunk_md5s_.size())
+          break;
+        if (!ChunkMatches(verified, size, chunk_md5s_[i]))
+          break;
+        verified += size;
+      }
+      if (verified < length) {
+        LOG(INFO) << "Resuming download after " << verified << " of "
+                  << length << " bytes that were already written.";
+        length = verified;
+      }
+    }
+
+    if (!file_.SetLength(length) ||
+        file_.Seek(base::File::FROM_BEGIN, length) != length) {
+      return -1;
+    }
+    position_ = length;
+    base::MD5Init(&chunk_md5_);
+    return length;
+  }
+
+  // Throws away what has been written so far.
+  bool Restart() {
+    if (!file_.SetLength(0) || file_.Seek(base::File::FROM_BEGIN, 0) != 0)
+      return false;
+    position_ = 0;
+    base::MD5Init(&chunk_md5_);
+    return true;
+  }
+
+  bool Write(const std::string& data) {
+    if (file_.WriteAtCurrentPos(data.data(), data.size()) !=
+        static_cast<int>(data.size())) {
+      LOG(ERROR) << "Writing '" << path_.value() << "' failed.";
+      return false;
+    }
+    if (!has_chunk_hashes()) {
+      position_ += data.size();
+      return true;
+    }
+
+    size_t consumed = 0;
+    while (consumed < data.size()) {
+      int64 chunk_left = chunk_size_ - position_ % chunk_size_;
+      size_t size =
+          static_cast<size_t>(std::min<int64>(chunk_left, data.size() - consumed));
+      base::MD5Update(&chunk_md5_, base::StringPiece(data.data() + consumed,
+                                                     size));
+      consumed += size;
+      position_ += size;
+      if (position_ % chunk_size_ == 0 && !FinishChunk())
+        return false;
+    }
+    return true;
+  }
+
+  // Checks the last chunk, which does not end on a chunk boundary.
+  bool FinishWriting() {
+    if (!has_chunk_hashes() || position_ % chunk_size_ == 0)
+      return true;
+    return FinishChunk();
+  }
+
+  void Close() { file_.Close(); }
+
+ private:
+  friend class base::RefCountedThreadSafe<PartialFile>;
+  ~PartialFile() {}
+
+  bool has_chunk_hashes() const {
+    return chunk_size_ > 0 && !chunk_md5s_.empty();
+  }
+
+  // Compares the chunk that was just written with its hash and cuts it off
+  // if it does not match.
+  bool FinishChunk() {
+    int64 chunk_start = (position_ - 1) / chunk_size_ * chunk_size_;
+    size_t index = static_cast<size_t>(chunk_start / chunk_size_);
+    base::MD5Digest digest;
+    base::MD5Final(&digest, &chunk_md5_);
+    base::MD5Init(&chunk_md5_);
+    if (index < chunk_md5s_.size() &&
+        base::LowerCaseEqualsASCII(chunk_md5s_[index],
+                                   base::MD5DigestToBase16(digest).c_str())) {
+      return true;
+    }
+    LOG(ERROR) << "Chunk " << index << " of '" << path_.value()
+               << "' does not match the manifest.";
+    file_.SetLength(chunk_start);
+    file_.Seek(base::File::FROM_BEGIN, chunk_start);
+    position_ = chunk_start;
+    return false;
+  }
+
+  bool ChunkMatches(int64 offset, int64 size, const std::string& md5) {
+    char buffer[kFileBufferSize];
+    base::MD5Context context;
+    base::MD5Init(&context);
+    while (size) {
+      int read = static_cast<int>(std::min<int64>(size, sizeof(buffer)));
+      if (file_.Read(offset, buffer, read) != read)
+        return false;
+      base::MD5Update(&context, base::StringPiece(buffer, read));
+      offset += read;
+      size -= read;
+    }
+    base::MD5Digest digest;
+    base::MD5Final(&digest, &context);
+    return base::LowerCaseEqualsASCII(md5,
+                                      base::MD5DigestToBase16(digest).c_str());
+  }
+
+  base::FilePath path_;
+  base::File file_;
+  int64 chunk_size_;
+  std::vector<std::string> chunk_md5s_;
+  int64 position_;
+  base::MD5Context chunk_md5_;
+
+  DISALLOW_COPY_AND_ASSIGN(PartialFile);
+};
+
+BundleDownload::BundleDownload(mojo::NetworkService* network_service,
+                               const GURL& url,
+                               const base::FilePath& path,
+                               scoped_refptr<base::TaskRunner> worker_runner)
+    : network_service_(network_service),
+      url_(url),
+      worker_runner_(worker_runner),
+      main_runner_(base::MessageLoop::current()->task_runner()),
+      file_(new PartialFile(path)),
+      attempts_(0),
+      offset_(0),
+      total_length_(-1),
+      max_bytes_per_second_(0),
+      throttle_bytes_(0),
+      weak_factory_(this) {
+}
+
+BundleDownload::~BundleDownload() {
+  // The file stays on disk so that the next attempt can resume it.
+  worker_runner_->PostTask(FROM_HERE,
+                           base::Bind(&PartialFile::Close, file_));
+}
+
+void BundleDownload::SetChunkHashes(
+    int64 chunk_size,
+    const std::vector<std::string>& chunk_md5s) {
+  worker_runner_->PostTask(FROM_HERE, base::Bind(&PartialFile::SetChunkHashes,
+                                                 file_, chunk_size,
+                                                 chunk_md5s));
+}
+
+void BundleDownload::SetMaxBytesPerSecond(int64 max_bytes_per_second) {
+  max_bytes_per_second_ = max_bytes_per_second;
+  throttle_start_ = base::TimeTicks::Now();
+  throttle_bytes_ = 0;
+}
+
+void BundleDownload::Start(const base::Callback<void(bool)>& callback) {
+  callback_ = callback;
+  base::PostTaskAndReplyWithResult(
+      worker_runner_.get(), FROM_HERE, base::Bind(&PartialFile::Open, file_),
+      base::Bind(&BundleDownload::OnOpened, weak_factory_.GetWeakPtr()));
+}
+
+// static
+bool BundleDownload::FileMatchesMD5(const base::FilePath& path,
+                                    const std::string& md5) {
+  base::File file(path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  if (!file.IsValid())
+    return false;
+  char buffer[kFileBufferSize];
+  base::MD5Context context;
+  base::MD5Init(&context);
+  for (;;) {
+    int read = file.ReadAtCurrentPos(buffer, sizeof(buffer));
+    if (read < 0)
+      return false;
+    if (read == 0)
+      break;
+    base::MD5Update(&context, base::StringPiece(buffer, read));
+  }
+  base::MD5Digest digest;
+  base::MD5Final(&digest, &context);
+  return base::LowerCaseEqualsASCII(md5,
+                                    base::MD5DigestToBase16(digest).c_str());
+}
+
+void BundleDownload::OnOpened(int64 offset) {
+  if (offset < 0) {
+    Finish(false);
+    return;
+  }
+  offset_ = offset;
+  SendRequest();
+}
+
+void BundleDownload::SendRequest() {
+  ++attempts_;
+  total_length_ = -1;
+
+  mojo::URLRequestPtr request = mojo::URLRequest::New();
+  request->url = url_.spec();
+  request->auto_follow_redirects = true;
+  if (offset_ > 0) {
+    mojo::HttpHeaderPtr range = mojo::HttpHeader::New();
+    range->name = "Range";
+    range->value = "bytes=" + base::Int64ToString(offset_) + "-";
+    request->headers.push_back(range.Pass());
+  }
+
+  network_service_->CreateURLLoader(GetProxy(&url_loader_));
+  url_loader_->Start(request.Pass(),
+                     base::Bind(&BundleDownload::OnResponse,
+                                weak_factory_.GetWeakPtr()));
+}
+
+void BundleDownload::OnResponse(mojo::URLResponsePtr response) {
+  if (response->error) {
+    LOG(WARNING) << "Downloading " << url_.spec()
+                 << " failed: " << response->error->description;
+    Retry();
+    return;
+  }
+  body_ = response->body.Pass();
+
+  if (response->status_code == kPartialContentStatus && offset_ > 0) {
+    int64 first = 0;
+    if (!ParseContentRange(FindHeader(response, "content-range"), &first,
+                           &total_length_) ||
+        first != offset_) {
+      LOG(ERROR) << "Download resumed at the wrong offset.";
+      Finish(false);
+      return;
+    }
+    SetMaxBytesPerSecond(max_bytes_per_second_);
+    ReadBodyWhenAllowed();
+    return;
+  }
+
+  if (response->status_code == 200 ||
+      (response->status_code == kRangeNotSatisfiableStatus && offset_ > 0)) {
+    // Either the server sent the whole bundle, or what is on disk does not
+    // belong to the bundle it serves. Both mean starting over, the latter
+    // with a new request.
+    if (response->status_code == 200) {
+      int64 length = 0;
+      if (base::StringToInt64(FindHeader(response, "content-length"), &length))
+        total_length_ = length;
+    } else {
+      body_.reset();
+    }
+    offset_ = 0;
+    base::PostTaskAndReplyWithResult(
+        worker_runner_.get(), FROM_HERE,
+        base::Bind(&PartialFile::Restart, file_),
+        base::Bind(&BundleDownload::OnRestarted, weak_factory_.GetWeakPtr()));
+    return;
+  }
+
+  LOG(ERROR) << "Downloading " << url_.spec()
+             << " failed: Server responded " << response->status_code;
+  Finish(false);
+}
+
+void BundleDownload::OnRestarted(bool success) {
+  if (!success) {
+    Finish(false);
+    return;
+  }
+  if (!body_.is_valid()) {
+    SendRequest();
+    return;
+  }
+  SetMaxBytesPerSecond(max_bytes_per_second_);
+  ReadBodyWhenAllowed();
+}
+
+void BundleDownload::ReadBodyWhenAllowed() {
+  if (max_bytes_per_second_ > 0) {
+    base::TimeTicks allowed_time =
+        throttle_start_ +
+        base::TimeDelta::FromMicroseconds(
+            throttle_bytes_ * base::Time::kMicrosecondsPerSecond /
+            max_bytes_per_second_);
+    base::TimeTicks now = base::TimeTicks::Now();
+    if (allowed_time > now) {
+      main_runner_->PostDelayedTask(
+          FROM_HERE, base::Bind(&BundleDownload::ReadBodyWhenAllowed,
+                                weak_factory_.GetWeakPtr()),
+          allowed_time - now);
+      return;
+    }
+  }
+  OnHandleReady(MOJO_RESULT_OK);
+}
+
+void BundleDownload::OnHandleReady(MojoResult result) {
+  waiter_.reset();
+  if (result == MOJO_RESULT_OK) {
+    const void* buffer = nullptr;
+    uint32_t buffer_size = 0;
+    result = BeginReadDataRaw(body_.get(), &buffer, &buffer_size,
+                              MOJO_READ_DATA_FLAG_NONE);
+    if (result == MOJO_RESULT_OK) {
+      // Copied out of the pipe so that the pipe can go away while the worker
+      // writes it.
+      uint32_t num_bytes = std::min(buffer_size, kMaxReadSize);
+      std::string data(static_cast<const char*>(buffer), num_bytes);
+      EndReadDataRaw(body_.get(), num_bytes);
+      base::PostTaskAndReplyWithResult(
+          worker_runner_.get(), FROM_HERE,
+          base::Bind(&PartialFile::Write, file_, data),
+          base::Bind(&BundleDownload::OnWritten, weak_factory_.GetWeakPtr(),
+                     static_cast<int64>(num_bytes)));
+      return;
+    }
+  }
+  if (result == MOJO_RESULT_SHOULD_WAIT) {
+    waiter_.reset(new mojo::AsyncWaiter(
+        body_.get(), MOJO_HANDLE_SIGNAL_READABLE,
+        base::Bind(&BundleDownload::OnHandleReady,
+                   weak_factory_.GetWeakPtr())));
+    return;
+  }
+  if (result == MOJO_RESULT_FAILED_PRECONDITION) {
+    OnBodyEnded();
+    return;
+  }
+  Retry();
+}
+
+void BundleDownload::OnWritten(int64 num_bytes, bool success) {
+  if (!success) {
+    // A chunk that failed its check has been cut off, so a new request picks
+    // up right before it.
+    body_.reset();
+    base::PostTaskAndReplyWithResult(
+        worker_runner_.get(), FROM_HERE, base::Bind(&PartialFile::Open, file_),
+        base::Bind(&BundleDownload::OnOpened, weak_factory_.GetWeakPtr()));
+    return;
+  }
+  offset_ += num_bytes;
+  throttle_bytes_ += num_bytes;
+  ReadBodyWhenAllowed();
+}
+
+void BundleDownload::OnBodyEnded() {
+  body_.reset();
+  if (total_length_ >= 0 && offset_ < total_length_) {
+    LOG(WARNING) << "Download of " << url_.spec() << " stopped after "
+                 << offset_ << " of " << total_length_ << " bytes.";
+    Retry();
+    return;
+  }
+  base::PostTaskAndReplyWithResult(
+      worker_runner_.get(), FROM_HERE,
+      base::Bind(&PartialFile::FinishWriting, file_),
+      base::Bind(&BundleDownload::Finish, weak_factory_.GetWeakPtr()));
+}
+
+void BundleDownload::Retry() {
+  body_.reset();
+  url_loader_.reset();
+  if (attempts_ >= kMaxAttempts) {
+    Finish(false);
+    return;
+  }
+  main_runner_->PostDelayedTask(
+      FROM_HERE,
+      base::Bind(&BundleDownload::SendRequest, weak_factory_.GetWeakPtr()),
+      base::TimeDelta::FromSeconds(kRetryDelaySeconds * attempts_));
+}
+
+void BundleDownload::Finish(bool success) {
+  body_.reset();
+  url_loader_.reset();
+  worker_runner_->PostTaskAndReply(
+      FROM_HERE, base::Bind(&PartialFile::Close, file_),
+      base::Bind(&BundleDownload::RunCallback, weak_factory_.GetWeakPtr(),
+                 success));
+}
+
+void BundleDownload::RunCallback(bool success) {
+  // The callback is likely to delete the download.
+  base::Callback<void(bool)> callback = callback_;
+  callback.Run(success);
+}
+
+}  // namespace shell
+}  // namespace sky
@@ -0,0 +1,102 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_UPDATER_BUNDLE_DOWNLOAD_H_
+#define SKY_SHELL_UPDATER_BUNDLE_DOWNLOAD_H_
+
+#include <string>
+#include <vector>
+
+#include "base/callback.h"
+#include "base/files/file_path.h"
+#include "base/memory/ref_counted.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/memory/weak_ptr.h"
+#include "base/single_thread_task_runner.h"
+#include "base/task_runner.h"
+#include "base/time/time.h"
+#include "mojo/public/cpp/environment/async_waiter.h"
+#include "mojo/services/network/public/interfaces/network_service.mojom.h"
+#include "url/gurl.h"
+
+namespace sky {
+namespace shell {
+
+// Downloads an app bundle to a file that is kept between attempts. A download
+// that is interrupted, whether by a dropped connection or by the process
+// going away, picks up where it left off with an HTTP range request the next
+// time it is started for the same file.
+//
+// If the manifest lists hashes for fixed size chunks of the bundle, each
+// chunk is checked as it is written, and the part that is already on disk is
+// checked before it is resumed. A bad chunk is cut off so that the next
+// attempt downloads it again.
+class BundleDownload {
+ public:
+  BundleDownload(mojo::NetworkService* network_service,
+                 const GURL& url,
+                 const base::FilePath& path,
+                 scoped_refptr<base::TaskRunner> worker_runner);
+  ~BundleDownload();
+
+  void SetChunkHashes(int64 chunk_size,
+                      const std::vector<std::string>& chunk_md5s);
+
+  // Reads the response no faster than this, which in turn slows the
+  // connection down. Zero means no limit. Can be changed while downloading.
+  void SetMaxBytesPerSecond(int64 max_bytes_per_second);
+
+  // Runs |callback| with true once the whole bundle is at |path|.
+  void Start(const base::Callback<void(bool)>& callback);
+
+  // Returns true if the MD5 of the file at |path| is |md5|, in hex. Blocks on
+  // file IO.
+  static bool FileMatchesMD5(const base::FilePath& path,
+                             const std::string& md5);
+
+ private:
+  class PartialFile;
+
+  void OnOpened(int64 offset);
+  void SendRequest();
+  void OnResponse(mojo::URLResponsePtr response);
+  void OnRestarted(bool success);
+  void OnHandleReady(MojoResult result);
+  void OnWritten(int64 num_bytes, bool success);
+  void ReadBodyWhenAllowed();
+  void OnBodyEnded();
+  void Retry();
+  void Finish(bool success);
+  void RunCallback(bool success);
+
+  mojo::NetworkService* network_service_;
+  GURL url_;
+  scoped_refptr<base::TaskRunner> worker_runner_;
+  scoped_refptr<base::SingleThreadTaskRunner> main_runner_;
+  scoped_refptr<PartialFile> file_;
+  base::Callback<void(bool)> callback_;
+
+  mojo::URLLoaderPtr url_loader_;
+  mojo::ScopedDataPipeConsumerHandle body_;
+  scoped_ptr<mojo::AsyncWaiter> waiter_;
+  int attempts_;
+
+  // How much of the bundle is on disk, and how long the whole bundle is, or
+  // -1 while that is not known.
+  int64 offset_;
+  int64 total_length_;
+
+  int64 max_bytes_per_second_;
+  base::TimeTicks throttle_start_;
+  int64 throttle_bytes_;
+
+  base::WeakPtrFactory<BundleDownload> weak_factory_;
+
+  DISALLOW_COPY_AND_ASSIGN(BundleDownload);
+};
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_UPDATER_BUNDLE_DOWNLOAD_H_
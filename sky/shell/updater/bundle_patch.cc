@@ -0,0 +1,164 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/shell/updater/bundle_patch.h"
+
+#include <string.h>
+
+#include <algorithm>
+
+#include "base/files/file.h"
+#include "base/logging.h"
+#include "base/macros.h"
+#include "base/md5.h"
+#include "base/memory/scoped_ptr.h"
+#include "base/strings/string_piece.h"
+#include "base/strings/string_util.h"
+
+namespace sky {
+namespace shell {
+namespace {
+
+const char kPatchMagic[] = "SKYPATCH";
+const int kPatchMagicLength = 8;
+
+enum PatchOp {
+  kCopyOp = 0,
+  kInsertOp = 1,
+};
+
+const int kChunkSize = 64 * 1024;
+
+bool ReadUint64(base::File* file, uint64_t* value) {
+  unsigned char bytes[8];
+  if (file->ReadAtCurrentPos(reinterpret_cast<char*>(bytes), sizeof(bytes)) !=
+      static_cast<int>(sizeof(bytes))) {
+    return false;
+  }
+  *value = 0;
+  for (int i = sizeof(bytes) - 1; i >= 0; --i)
+    *value = (*value << 8) | bytes[i];
+  return true;
+}
+
+// Writes the new bundle and hashes it as it goes.
+class PatchOutput {
+ public:
+  explicit PatchOutput(const base::FilePath& path)
+      : file_(path, base::File::FLAG_CREATE_ALWAYS | base::File::FLAG_WRITE) {
+    base::MD5Init(&md5_);
+  }
+
+  bool IsValid() const { return file_.IsValid(); }
+
+  bool Write(const char* data, int size) {
+    base::MD5Update(&md5_, base::StringPiece(data, size));
+    return file_.WriteAtCurrentPos(data, size) == size;
+  }
+
+  std::string Finish() {
+    file_.Close();
+    base::MD5Digest digest;
+    base::MD5Final(&digest, &md5_);
+    return base::MD5DigestToBase16(digest);
+  }
+
+ private:
+  base::File file_;
+  base::MD5Context md5_;
+
+  DISALLOW_COPY_AND_ASSIGN(PatchOutput);
+};
+
+bool CopyFromOldBundle(base::File* old_bundle,
+                       uint64_t offset,
+                       uint64_t length,
+                       char* buffer,
+                       PatchOutput* output) {
+  uint64_t old_length = old_bundle->GetLength();
+  if (offset > old_length || length > old_length - offset)
+    return false;
+  while (length) {
+    int size = static_cast<int>(std::min<uint64_t>(length, kChunkSize));
+    if (old_bundle->Read(offset, buffer, size) != size ||
+        !output->Write(buffer, size)) {
+      return false;
+    }
+    offset += size;
+    length -= size;
+  }
+  return true;
+}
+
+bool CopyFromPatch(base::File* patch,
+                   uint64_t length,
+                   char* buffer,
+                   PatchOutput* output) {
+  while (length) {
+    int size = static_cast<int>(std::min<uint64_t>(length, kChunkSize));
+    if (patch->ReadAtCurrentPos(buffer, size) != size ||
+        !output->Write(buffer, size)) {
+      return false;
+    }
+    length -= size;
+  }
+  return true;
+}
+
+}  // namespace
+
+bool ApplyBundlePatch(const base::FilePath& old_bundle_path,
+                      const base::FilePath& patch_path,
+                      const base::FilePath& new_bundle_path,
+                      const std::string& expected_md5) {
+  base::File old_bundle(old_bundle_path,
+                        base::File::FLAG_OPEN | base::File::FLAG_READ);
+  base::File patch(patch_path, base::File::FLAG_OPEN | base::File::FLAG_READ);
+  PatchOutput output(new_bundle_path);
+  if (!old_bundle.IsValid() || !patch.IsValid() || !output.IsValid()) {
+    LOG(ERROR) << "Patching failed opening files.";
+    return false;
+  }
+
+  char magic[kPatchMagicLength];
+  if (patch.ReadAtCurrentPos(magic, kPatchMagicLength) != kPatchMagicLength ||
+      memcmp(magic, kPatchMagic, kPatchMagicLength)) {
+    LOG(ERROR) << "Patching failed: not a bundle patch.";
+    return false;
+  }
+
+  scoped_ptr<char[]> buffer(new char[kChunkSize]);
+  for (;;) {
+    char op;
+    int read = patch.ReadAtCurrentPos(&op, 1);
+    if (read == 0)
+      break;
+
+    bool ok = false;
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    if (read == 1 && op == kCopyOp) {
+      ok = ReadUint64(&patch, &offset) && ReadUint64(&patch, &length) &&
+           CopyFromOldBundle(&old_bundle, offset, length, buffer.get(),
+                             &output);
+    } else if (read == 1 && op == kInsertOp) {
+      ok = ReadUint64(&patch, &length) &&
+           CopyFromPatch(&patch, length, buffer.get(), &output);
+    }
+    if (!ok) {
+      LOG(ERROR) << "Patching failed: malformed patch.";
+      return false;
+    }
+  }
+
+  std::string md5 = output.Finish();
+  if (!base::LowerCaseEqualsASCII(expected_md5, md5.c_str())) {
+    LOG(ERROR) << "Patching failed: result does not match the manifest.";
+    return false;
+  }
+  return true;
+}
+
+}  // namespace shell
+}  // namespace sky
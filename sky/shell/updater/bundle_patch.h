@@ -0,0 +1,36 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_SHELL_UPDATER_BUNDLE_PATCH_H_
+#define SKY_SHELL_UPDATER_BUNDLE_PATCH_H_
+
+#include <string>
+
+#include "base/files/file_path.h"
+
+namespace sky {
+namespace shell {
+
+// A bundle patch rebuilds a new app bundle out of pieces of the installed one
+// and the bytes that changed. It starts with the 8 byte magic "SKYPATCH",
+// followed by operations until the end of the file. Each operation is a
+// one byte opcode followed by little endian 64 bit integers:
+//
+//   0 (copy):   offset, length   copies bytes of the installed bundle.
+//   1 (insert): length, bytes    appends the bytes that follow.
+//
+// Applies |patch| to |old_bundle| and writes the result to |new_bundle|,
+// streaming all three files. Returns true if the patch applied cleanly and
+// the MD5 of the result is |expected_md5|, in hex. A patch made against a
+// different bundle than the one installed fails that check. Blocks on file
+// IO, so it has to run on a worker.
+bool ApplyBundlePatch(const base::FilePath& old_bundle,
+                      const base::FilePath& patch,
+                      const base::FilePath& new_bundle,
+                      const std::string& expected_md5);
+
+}  // namespace shell
+}  // namespace sky
+
+#endif  // SKY_SHELL_UPDATER_BUNDLE_PATCH_H_
@@ -4,6 +4,7 @@
 
 #include "sky/shell/updater/manifest.h"
 
+#include "base/strings/string_number_conversions.h"
 #include "base/strings/string_split.h"
 #include "base/strings/string_util.h"
 
@@ -24,10 +25,25 @@ scoped_ptr<Manifest> Manifest::Parse(const std::string& manifest_data) {
       manifest->update_url_ = GURL(value.as_string());
     } else if (key_value.first == "version") {
       manifest->version_ = base::Version(value.as_string());
+    } else if (key_value.first == "patch_from_version") {
+      manifest->patch_from_version_ = base::Version(value.as_string());
+    } else if (key_value.first == "bundle_md5") {
+      manifest->bundle_md5_ = base::StringToLowerASCII(value.as_string());
+    } else if (key_value.first == "bundle_chunk_size") {
+      base::StringToInt64(value, &manifest->bundle_chunk_size_);
+    } else if (key_value.first == "bundle_chunk_md5s") {
+      manifest->bundle_chunk_md5s_ = base::SplitString(
+          value, ",", base::TRIM_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
     }
   }
   return manifest;
 }
 
+bool Manifest::HasPatchFrom(const base::Version& version) const {
+  // Without a hash there is no way to tell a patched bundle is intact.
+  return patch_from_version_.IsValid() && version.IsValid() &&
+         patch_from_version_.Equals(version) && !bundle_md5_.empty();
+}
+
 }  // namespace shell
 }  // namespace sky
@@ -6,7 +6,9 @@
 #define SKY_SHELL_MANIFEST_H_
 
 #include <string>
+#include <vector>
 
+#include "base/basictypes.h"
 #include "base/memory/scoped_ptr.h"
 #include "base/version.h"
 #include "url/gurl.h"
@@ -23,9 +25,29 @@ struct Manifest {
   const GURL& update_url() const { return update_url_; }
   const base::Version& version() const { return version_; }
 
+  // The version a bundle patch next to the bundle applies to, if there is
+  // one. See bundle_patch.h.
+  const base::Version& patch_from_version() const {
+    return patch_from_version_;
+  }
+  // The MD5 of the bundle in hex, which a patched bundle has to match.
+  const std::string& bundle_md5() const { return bundle_md5_; }
+  // MD5s of consecutive |bundle_chunk_size| byte pieces of the bundle, which
+  // let a download check what it has so far. See bundle_download.h.
+  int64 bundle_chunk_size() const { return bundle_chunk_size_; }
+  const std::vector<std::string>& bundle_chunk_md5s() const {
+    return bundle_chunk_md5s_;
+  }
+
+  bool HasPatchFrom(const base::Version& version) const;
+
  private:
   GURL update_url_;
   base::Version version_;
+  base::Version patch_from_version_;
+  std::string bundle_md5_;
+  int64 bundle_chunk_size_ = 0;
+  std::vector<std::string> bundle_chunk_md5s_;
 };
 
 }  // namespace shell
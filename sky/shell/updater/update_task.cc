@@ -5,6 +5,7 @@
 #include "sky/shell/updater/update_task.h"
 
 #include "base/bind.h"
+#include "base/files/file_enumerator.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/task_runner_util.h"
@@ -14,6 +15,8 @@
 #include "mojo/public/interfaces/application/service_provider.mojom.h"
 #include "mojo/services/network/public/interfaces/network_service.mojom.h"
 #include "sky/shell/shell.h"
+#include "sky/shell/updater/bundle_download.h"
+#include "sky/shell/updater/bundle_patch.h"
 #include "sky/shell/updater/manifest.h"
 
 namespace sky {
@@ -23,6 +26,12 @@ namespace {
 
 const char kManifestFilename[] = "sky.yaml";
 const char kAppBundleFilename[] = "app.skyx";
+const char kAppBundlePatchFilename[] = "app.skyx.patch";
+const char kPartialAppBundleSuffix[] = ".partial";
+
+// Enough to finish a typical update within a few minutes without getting in
+// the way of the app's own traffic.
+const int64 kForegroundBytesPerSecond = 64 * 1024;
 
 // TODO(mpcomplete): make this a utility method?
 static mojo::URLLoaderPtr FetchURL(
@@ -46,6 +55,19 @@ static scoped_ptr<Manifest> ReadManifestFromFile(const base::FilePath& path) {
   return Manifest::Parse(manifest_data);
 }
 
+// Partial downloads of other versions will never be resumed.
+static void DeleteStalePartialDownloads(const base::FilePath& data_dir,
+                                        const base::FilePath& keep) {
+  base::FileEnumerator partials(
+      data_dir, false, base::FileEnumerator::FILES,
+      std::string(kAppBundleFilename) + ".*" + kPartialAppBundleSuffix);
+  for (base::FilePath path = partials.Next(); !path.empty();
+       path = partials.Next()) {
+    if (path != keep)
+      base::DeleteFile(path, false);
+  }
+}
+
 static scoped_ptr<Manifest> ReadManifestFromDataPipe(
     mojo::ScopedDataPipeConsumerHandle source) {
   std::string manifest_data;
@@ -58,6 +80,7 @@ static scoped_ptr<Manifest> ReadManifestFromDataPipe(
 UpdateTask::UpdateTask(const std::string& data_dir)
     : worker_runner_(base::WorkerPool::GetTaskRunner(true)),
       main_runner_(base::MessageLoop::current()->task_runner()),
+      foreground_(false),
       data_dir_(data_dir) {
   mojo::ServiceProviderPtr service_provider =
       CreateServiceProvider(Shell::Shared().service_provider_context());
@@ -65,6 +88,8 @@ UpdateTask::UpdateTask(const std::string& data_dir)
 }
 
 UpdateTask::~UpdateTask() {
+  if (!patch_path_.empty())
+    base::DeleteFile(patch_path_, false);
 }
 
 void UpdateTask::Start() {
@@ -76,6 +101,14 @@ void UpdateTask::Start() {
       base::Bind(&UpdateTask::OnReadLocalManifest, base::Unretained(this)));
 }
 
+void UpdateTask::SetForeground(bool foreground) {
+  foreground_ = foreground;
+  if (bundle_download_) {
+    bundle_download_->SetMaxBytesPerSecond(
+        foreground_ ? kForegroundBytesPerSecond : 0);
+  }
+}
+
 void UpdateTask::OnReadLocalManifest(scoped_ptr<Manifest> manifest) {
   if (!manifest->IsValid()) {
     LOG(ERROR) << "Update failed reading local manifest: invalid.";
@@ -128,11 +161,18 @@ void UpdateTask::OnManifestDownloaded(scoped_ptr<Manifest> manifest) {
 
   // TODO(mpcomplete): replace local manifest with the one inside the bundle.
   // TODO(mpcomplete): check versions again after downloading bundle.
-  DownloadAppBundle(manifest->update_url().Resolve(kAppBundleFilename));
+  new_manifest_ = manifest.Pass();
+  if (new_manifest_->HasPatchFrom(current_manifest_->version())) {
+    DownloadPatch(
+        new_manifest_->update_url().Resolve(kAppBundlePatchFilename));
+    return;
+  }
+  DownloadAppBundle(new_manifest_->update_url().Resolve(kAppBundleFilename));
 }
 
-void UpdateTask::DownloadAppBundle(const GURL& url) {
-  if (!base::CreateTemporaryFile(&temp_path_)) {
+void UpdateTask::DownloadPatch(const GURL& url) {
+  if (!base::CreateTemporaryFile(&patch_path_) ||
+      !base::CreateTemporaryFile(&temp_path_)) {
     LOG(ERROR) << "Update failed when creating temp file.";
     Finish();
     return;
@@ -140,25 +180,102 @@ void UpdateTask::DownloadAppBundle(const GURL& url) {
 
   url_loader_ =
       FetchURL(network_service_.get(), url,
-               base::Bind(&UpdateTask::OnResponse, base::Unretained(this)));
+               base::Bind(&UpdateTask::OnPatchResponse, base::Unretained(this)));
 }
 
-void UpdateTask::OnResponse(mojo::URLResponsePtr response) {
+void UpdateTask::OnPatchResponse(mojo::URLResponsePtr response) {
   mojo::ScopedDataPipeConsumerHandle data;
   if (response->status_code == 200)
     data = response->body.Pass();
   if (!data.is_valid()) {
-    LOG(ERROR) << "Update failed: Server responded " << response->status_code;
-    Finish();
+    LOG(WARNING) << "Fetching patch failed: Server responded "
+                 << response->status_code << ". Fetching full bundle.";
+    OnPatchApplied(false);
     return;
   }
 
   mojo::common::CopyToFile(
-      data.Pass(), temp_path_, worker_runner_.get(),
-      base::Bind(&UpdateTask::OnCopied, base::Unretained(this)));
+      data.Pass(), patch_path_, worker_runner_.get(),
+      base::Bind(&UpdateTask::OnPatchCopied, base::Unretained(this)));
+}
+
+void UpdateTask::OnPatchCopied(bool success) {
+  if (!success) {
+    OnPatchApplied(false);
+    return;
+  }
+
+  base::PostTaskAndReplyWithResult(
+      worker_runner_.get(), FROM_HERE,
+      base::Bind(&ApplyBundlePatch, data_dir_.AppendASCII(kAppBundleFilename),
+                 patch_path_, temp_path_, new_manifest_->bundle_md5()),
+      base::Bind(&UpdateTask::OnPatchApplied, base::Unretained(this)));
+}
+
+void UpdateTask::OnPatchApplied(bool success) {
+  if (success) {
+    InstallAppBundle();
+    return;
+  }
+
+  // The patch is an optimization. Whatever went wrong with it, the whole
+  // bundle can still be downloaded.
+  LOG(WARNING) << "Applying patch failed. Fetching full bundle.";
+  base::DeleteFile(temp_path_, false);
+  DownloadAppBundle(new_manifest_->update_url().Resolve(kAppBundleFilename));
+}
+
+void UpdateTask::DownloadAppBundle(const GURL& url) {
+  // The version is part of the name so that a partial download is only ever
+  // resumed against the same bundle.
+  temp_path_ = data_dir_.AppendASCII(std::string(kAppBundleFilename) + "." +
+                                     new_manifest_->version().GetString() +
+                                     kPartialAppBundleSuffix);
+  worker_runner_->PostTask(FROM_HERE, base::Bind(&DeleteStalePartialDownloads,
+                                                 data_dir_, temp_path_));
+
+  bundle_download_.reset(new BundleDownload(network_service_.get(), url,
+                                            temp_path_, worker_runner_));
+  bundle_download_->SetChunkHashes(new_manifest_->bundle_chunk_size(),
+                                   new_manifest_->bundle_chunk_md5s());
+  SetForeground(foreground_);
+  bundle_download_->Start(
+      base::Bind(&UpdateTask::OnDownloaded, base::Unretained(this)));
+}
+
+void UpdateTask::OnDownloaded(bool success) {
+  bundle_download_.reset();
+  if (!success) {
+    LOG(ERROR) << "Update failed downloading app bundle. It will be resumed "
+               << "by the next update check.";
+    Finish();
+    return;
+  }
+
+  if (new_manifest_->bundle_md5().empty()) {
+    InstallAppBundle();
+    return;
+  }
+  base::PostTaskAndReplyWithResult(
+      worker_runner_.get(), FROM_HERE,
+      base::Bind(&BundleDownload::FileMatchesMD5, temp_path_,
+                 new_manifest_->bundle_md5()),
+      base::Bind(&UpdateTask::OnVerified, base::Unretained(this)));
+}
+
+void UpdateTask::OnVerified(bool success) {
+  if (!success) {
+    LOG(ERROR) << "Update failed: app bundle does not match the manifest.";
+    worker_runner_->PostTask(
+        FROM_HERE, base::Bind(base::IgnoreResult(&base::DeleteFile),
+                              temp_path_, false));
+    Finish();
+    return;
+  }
+  InstallAppBundle();
 }
 
-void UpdateTask::OnCopied(bool success) {
+void UpdateTask::InstallAppBundle() {
   int64 size = 0;
   GetFileSize(temp_path_, &size);
 
@@ -14,13 +14,21 @@
 namespace sky {
 namespace shell {
 
+class BundleDownload;
 struct Manifest;
 
 // This class manages a single update check. The flow is:
 // 1. Read the current manifest from disk.
 // 2. Fetch a new manifest served at the update URL specified in our manifest.
 // 3. Compare versions. If the remote one is newer, continue.
-// 4. Download the new app bundle and replace the current one with it.
+// 4. If the new manifest has a patch from our version, download it and apply
+//    it to the current app bundle. Otherwise, or if patching fails, download
+//    the whole new app bundle.
+// 5. Replace the current app bundle with the new one.
+//
+// Full downloads are kept in the data dir between update checks, so a
+// download that does not finish is resumed by the next check. While the app
+// is in the foreground, downloads are throttled to leave the network to it.
 class UpdateTask {
  public:
   UpdateTask(const std::string& data_dir);
@@ -29,14 +37,21 @@ class UpdateTask {
   void Start();
   virtual void Finish() = 0;
 
+  void SetForeground(bool foreground);
+
  private:
   void OnReadLocalManifest(scoped_ptr<Manifest> manifest);
   void DownloadManifest(const GURL& url);
   void OnManifestResponse(mojo::URLResponsePtr response);
   void OnManifestDownloaded(scoped_ptr<Manifest> manifest);
+  void DownloadPatch(const GURL& url);
+  void OnPatchResponse(mojo::URLResponsePtr response);
+  void OnPatchCopied(bool success);
+  void OnPatchApplied(bool success);
   void DownloadAppBundle(const GURL& url);
-  void OnResponse(mojo::URLResponsePtr response);
-  void OnCopied(bool success);
+  void OnDownloaded(bool success);
+  void OnVerified(bool success);
+  void InstallAppBundle();
   void CallOnFinished();
 
   // Note: All methods are called on the main thread. The worker runner is for
@@ -45,9 +60,13 @@ class UpdateTask {
   scoped_refptr<base::TaskRunner> main_runner_;
   mojo::NetworkServicePtr network_service_;
   mojo::URLLoaderPtr url_loader_;
+  scoped_ptr<BundleDownload> bundle_download_;
+  bool foreground_;
   scoped_ptr<Manifest> current_manifest_;
+  scoped_ptr<Manifest> new_manifest_;
   base::FilePath data_dir_;
   base::FilePath temp_path_;
+  base::FilePath patch_path_;
 };
 
 }  // namespace shell
@@ -14,15 +14,23 @@ def main():
     parser.add_argument('main', type=str)
     parser.add_argument('--package-root', type=str)
     parser.add_argument('--snapshot', type=str)
+    parser.add_argument('--depfile', type=str)
+    parser.add_argument('--build-output', type=str,
+        help='The snapshot relative to the build directory, for the depfile')
     parser.add_argument('-C', type=str,
         help='Switch to this directory before running executable')
     args = parser.parse_args()
-    return subprocess.check_call([
+    command = [
         args.executable,
         args.main,
         '--package-root=%s' % args.package_root,
         '--snapshot=%s' % args.snapshot,
-    ], cwd=args.C)
+    ]
+    if args.depfile:
+        command.append('--depfile=%s' % args.depfile)
+    if args.build_output:
+        command.append('--build-output=%s' % args.build_output)
+    return subprocess.check_call(command, cwd=args.C)
 
 if __name__ == '__main__':
     sys.exit(main())
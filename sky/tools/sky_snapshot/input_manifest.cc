@@ -0,0 +1,91 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/tools/sky_snapshot/input_manifest.h"
+
+#include <vector>
+
+#include "base/files/file_util.h"
+#include "base/strings/string_split.h"
+#include "base/strings/string_util.h"
+#include "sky/tools/sky_snapshot/source_reader.h"
+
+namespace {
+
+// Makefiles separate the files they list with spaces.
+std::string EscapeForDepfile(const std::string& path) {
+  std::string escaped;
+  base::ReplaceChars(path, " ", "\\ ", &escaped);
+  return escaped;
+}
+
+}  // namespace
+
+InputManifest::InputManifest(const std::string& key) : key_(key) {
+}
+
+InputManifest::~InputManifest() {
+}
+
+void InputManifest::AddFile(const std::string& path,
+                            const std::string& digest) {
+  files_[path] = digest;
+}
+
+// The first line is the key, and every other line has the digest of a file
+// followed by its path.
+bool InputManifest::Read(const base::FilePath& path) {
+  std::string contents;
+  if (!base::ReadFileToString(path, &contents))
+    return false;
+  std::vector<std::string> lines = base::SplitString(
+      contents, "\n", base::KEEP_WHITESPACE, base::SPLIT_WANT_NONEMPTY);
+  if (lines.empty() || lines[0] != key_)
+    return false;
+  for (size_t i = 1; i < lines.size(); ++i) {
+    size_t space = lines[i].find(' ');
+    if (space == std::string::npos)
+      return false;
+    files_[lines[i].substr(space + 1)] = lines[i].substr(0, space);
+  }
+  return true;
+}
+
+bool InputManifest::Write(const base::FilePath& path) const {
+  std::string contents = key_ + "\n";
+  for (const auto& file : files_)
+    contents += file.second + " " + file.first + "\n";
+  return base::WriteFile(path, contents.data(), contents.size()) ==
+         static_cast<int>(contents.size());
+}
+
+bool InputManifest::IsUpToDate(SourceReader* reader) const {
+  if (files_.empty())
+    return false;
+  for (const auto& file : files_)
+    reader->Prefetch(file.first);
+  for (const auto& file : files_) {
+    std::string source;
+    std::string digest;
+    if (!reader->Read(file.first, &source, &digest) || digest != file.second)
+      return false;
+  }
+  return true;
+}
+
+bool InputManifest::WriteDepfile(const base::FilePath& path,
+                                 const std::string& target) const {
+  // The build runs from another directory than this tool.
+  std::string contents = EscapeForDepfile(target) + ":";
+  for (const auto& file : files_) {
+    base::FilePath absolute_path =
+        base::MakeAbsoluteFilePath(base::FilePath(file.first));
+    if (absolute_path.empty())
+      return false;
+    contents += " " + EscapeForDepfile(absolute_path.AsUTF8Unsafe());
+  }
+  contents += "\n";
+  return base::WriteFile(path, contents.data(), contents.size()) ==
+         static_cast<int>(contents.size());
+}
@@ -0,0 +1,51 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_TOOLS_SKY_SNAPSHOT_INPUT_MANIFEST_H_
+#define SKY_TOOLS_SKY_SNAPSHOT_INPUT_MANIFEST_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+
+class SourceReader;
+
+// The files a snapshot was made from and the SHA-1 of their contents. It is
+// kept next to the snapshot, so that a later run whose files have the same
+// contents can keep the snapshot instead of loading the program again. The
+// VM cannot save the state of single libraries, so it is the snapshot as a
+// whole that is reused.
+class InputManifest {
+ public:
+  // |key| stands for what the snapshot depends on other than the contents
+  // of its files, such as the main script and the package root.
+  explicit InputManifest(const std::string& key);
+  ~InputManifest();
+
+  void AddFile(const std::string& path, const std::string& digest);
+
+  // Returns false if |path| does not hold a manifest for the same key.
+  bool Read(const base::FilePath& path);
+  bool Write(const base::FilePath& path) const;
+
+  // Whether every file still has the contents it had. The files are read in
+  // parallel with |reader|.
+  bool IsUpToDate(SourceReader* reader) const;
+
+  // Writes a Makefile style dependency file that makes |target| depend on
+  // the files, for build systems to skip the snapshot when none of them has
+  // changed.
+  bool WriteDepfile(const base::FilePath& path,
+                    const std::string& target) const;
+
+ private:
+  const std::string key_;
+  std::map<std::string, std::string> files_;
+
+  DISALLOW_COPY_AND_ASSIGN(InputManifest);
+};
+
+#endif  // SKY_TOOLS_SKY_SNAPSHOT_INPUT_MANIFEST_H_
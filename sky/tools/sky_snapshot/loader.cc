@@ -4,76 +4,59 @@
 
 #include "sky/tools/sky_snapshot/loader.h"
 
+#include <map>
+
 #include "base/command_line.h"
 #include "base/files/file_path.h"
-#include "base/files/file_util.h"
 #include "base/logging.h"
 #include "base/strings/string_util.h"
+#include "sky/tools/sky_snapshot/input_manifest.h"
 #include "sky/tools/sky_snapshot/logging.h"
 #include "sky/tools/sky_snapshot/scope.h"
+#include "sky/tools/sky_snapshot/source_reader.h"
 #include "sky/tools/sky_snapshot/switches.h"
 
 namespace {
 
-std::string Fetch(const std::string& url) {
-  base::FilePath path(url);
-  std::string source;
-  CHECK(base::ReadFileToString(path, &source)) << url;
-  return source;
-}
-
-base::FilePath SimplifyPath(const base::FilePath& path) {
-  std::vector<base::FilePath::StringType> components;
-  path.GetComponents(&components);
-  auto it = components.begin();
-  base::FilePath result(*it++);
-  for (; it != components.end(); it++) {
-    auto& component = *it;
-    if (component == base::FilePath::kCurrentDirectory)
-      continue;
-    if (component == base::FilePath::kParentDirectory)
-      result = result.DirName();
-    else
-      result = result.Append(component);
-  }
-  return result;
-}
-
 class Loader {
  public:
   Loader(const base::FilePath& package_root);
 
-  std::string CanonicalizePackageURL(std::string url);
+  SourceReader& reader() { return reader_; }
+  const std::map<std::string, std::string>& loaded_files() const {
+    return loaded_files_;
+  }
+
+  std::string Fetch(const std::string& url);
   Dart_Handle CanonicalizeURL(Dart_Handle library, Dart_Handle url);
   Dart_Handle Import(Dart_Handle url);
   Dart_Handle Source(Dart_Handle library, Dart_Handle url);
 
  private:
-  base::FilePath package_root_;
+  SourceReader reader_;
+  // The digests of the files the program was loaded from.
+  std::map<std::string, std::string> loaded_files_;
 
   DISALLOW_COPY_AND_ASSIGN(Loader);
 };
 
-Loader::Loader(const base::FilePath& package_root)
-    : package_root_(package_root) {
+Loader::Loader(const base::FilePath& package_root) : reader_(package_root) {
 }
 
-std::string Loader::CanonicalizePackageURL(std::string url) {
-  DCHECK(base::StartsWithASCII(url, "package:", true));
-  base::ReplaceFirstSubstringAfterOffset(&url, 0, "package:", "");
-  return package_root_.Append(url).AsUTF8Unsafe();
+std::string Loader::Fetch(const std::string& url) {
+  std::string source;
+  std::string digest;
+  CHECK(reader_.Read(url, &source, &digest)) << url;
+  loaded_files_[url] = digest;
+  return source;
 }
 
 Dart_Handle Loader::CanonicalizeURL(Dart_Handle library, Dart_Handle url) {
   std::string string = StringFromDart(url);
   if (base::StartsWithASCII(string, "dart:", true))
     return url;
-  if (base::StartsWithASCII(string, "package:", true))
-    return StringToDart(CanonicalizePackageURL(string));
-  base::FilePath base_path(StringFromDart(Dart_LibraryUrl(library)));
-  base::FilePath resolved_path = base_path.DirName().Append(string);
-  base::FilePath normalized_path = SimplifyPath(resolved_path);
-  return StringToDart(normalized_path.AsUTF8Unsafe());
+  return StringToDart(
+      reader_.Resolve(StringFromDart(Dart_LibraryUrl(library)), string));
 }
 
 Dart_Handle Loader::Import(Dart_Handle url) {
@@ -124,6 +107,15 @@ Dart_Handle HandleLibraryTag(Dart_LibraryTag tag,
 }
 
 void LoadScript(const std::string& url) {
-  LogIfError(
-      Dart_LoadScript(StringToDart(url), StringToDart(Fetch(url)), 0, 0));
+  LogIfError(Dart_LoadScript(StringToDart(url),
+                             StringToDart(GetLoader().Fetch(url)), 0, 0));
+}
+
+SourceReader& GetSourceReader() {
+  return GetLoader().reader();
+}
+
+void AddLoadedFiles(InputManifest* manifest) {
+  for (const auto& file : GetLoader().loaded_files())
+    manifest->AddFile(file.first, file.second);
 }
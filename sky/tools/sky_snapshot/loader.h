@@ -9,9 +9,18 @@
 
 #include "dart/runtime/include/dart_api.h"
 
+class InputManifest;
+class SourceReader;
+
 Dart_Handle HandleLibraryTag(Dart_LibraryTag tag,
                              Dart_Handle library,
                              Dart_Handle url);
 void LoadScript(const std::string& url);
 
+// The reader the program's files are read with.
+SourceReader& GetSourceReader();
+
+// Adds the files the program has been loaded from to |manifest|.
+void AddLoadedFiles(InputManifest* manifest);
+
 #endif  // SKY_TOOLS_SKY_SNAPSHOT_LOADER_H_
@@ -10,20 +10,50 @@
 #include "base/files/file_path.h"
 #include "base/files/file_util.h"
 #include "base/logging.h"
+#include "base/path_service.h"
 #include "base/process/memory.h"
 #include "dart/runtime/include/dart_api.h"
+#include "sky/tools/sky_snapshot/input_manifest.h"
 #include "sky/tools/sky_snapshot/loader.h"
 #include "sky/tools/sky_snapshot/logging.h"
 #include "sky/tools/sky_snapshot/scope.h"
+#include "sky/tools/sky_snapshot/source_reader.h"
 #include "sky/tools/sky_snapshot/switches.h"
 #include "sky/tools/sky_snapshot/vm.h"
 
 void Usage() {
   std::cerr << "Usage: sky_packager"
             << " --" << switches::kPackageRoot << " --" << switches::kSnapshot
+            << " [ --" << switches::kDepfile << " --"
+            << switches::kBuildOutput << " ]"
             << " <sky-app>" << std::endl;
 }
 
+// The snapshot also depends on the VM, which is built into this tool.
+void AddExecutable(InputManifest* manifest) {
+  base::FilePath executable;
+  CHECK(PathService::Get(base::FILE_EXE, &executable));
+  std::string source;
+  std::string digest;
+  CHECK(GetSourceReader().Read(executable.AsUTF8Unsafe(), &source, &digest));
+  manifest->AddFile(executable.AsUTF8Unsafe(), digest);
+}
+
+void WriteDepfile(const InputManifest& manifest,
+                  const base::FilePath& snapshot_path) {
+  const base::CommandLine& command_line =
+      *base::CommandLine::ForCurrentProcess();
+  if (!command_line.HasSwitch(switches::kDepfile))
+    return;
+  // The build names the snapshot relative to its own directory.
+  std::string target = snapshot_path.AsUTF8Unsafe();
+  if (command_line.HasSwitch(switches::kBuildOutput))
+    target = command_line.GetSwitchValueASCII(switches::kBuildOutput);
+  base::FilePath depfile_path =
+      command_line.GetSwitchValuePath(switches::kDepfile);
+  CHECK(manifest.WriteDepfile(depfile_path, target));
+}
+
 void WriteSnapshot(base::FilePath path) {
   uint8_t* buffer;
   intptr_t size;
@@ -47,6 +77,28 @@ int main(int argc, const char* argv[]) {
     return 0;
   }
 
+  auto args = command_line.GetArgs();
+  CHECK(args.size() == 1);
+  CHECK(command_line.HasSwitch(switches::kSnapshot)) << "Need --snapshot";
+  base::FilePath snapshot_path =
+      command_line.GetSwitchValuePath(switches::kSnapshot);
+  base::FilePath manifest_path = snapshot_path.AddExtension("inputs");
+  std::string manifest_key =
+      args[0] + " " +
+      command_line.GetSwitchValuePath(switches::kPackageRoot).AsUTF8Unsafe();
+
+  // Builds run this whenever the times of the sources change, which is
+  // often without their contents changing, as when packages are fetched
+  // again.
+  InputManifest previous(manifest_key);
+  if (base::PathExists(snapshot_path) && previous.Read(manifest_path) &&
+      previous.IsUpToDate(&GetSourceReader())) {
+    base::Time now = base::Time::Now();
+    CHECK(base::TouchFile(snapshot_path, now, now));
+    WriteDepfile(previous, snapshot_path);
+    return 0;
+  }
+
   InitDartVM();
   Dart_Isolate isolate = CreateDartIsolate();
   CHECK(isolate);
@@ -54,14 +106,23 @@ int main(int argc, const char* argv[]) {
   DartIsolateScope scope(isolate);
   DartApiScope api_scope;
 
-  auto args = command_line.GetArgs();
-  CHECK(args.size() == 1);
   LoadScript(args[0]);
 
   CHECK(!LogIfError(Dart_FinalizeLoading(true)));
 
-  CHECK(command_line.HasSwitch(switches::kSnapshot)) << "Need --snapshot";
-  WriteSnapshot(command_line.GetSwitchValuePath(switches::kSnapshot));
+  // A manifest left from before must not vouch for a snapshot that failed
+  // to be written.
+  base::DeleteFile(manifest_path, false);
+  WriteSnapshot(snapshot_path);
+
+  InputManifest manifest(manifest_key);
+  AddExecutable(&manifest);
+  AddLoadedFiles(&manifest);
+  // Without a manifest the next run makes the snapshot again, which is
+  // always correct.
+  if (!manifest.Write(manifest_path))
+    LOG(WARNING) << "Could not write " << manifest_path.value();
+  WriteDepfile(manifest, snapshot_path);
 
   return 0;
 }
@@ -0,0 +1,177 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#include "sky/tools/sky_snapshot/source_reader.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <vector>
+
+#include "base/bind.h"
+#include "base/files/file_util.h"
+#include "base/location.h"
+#include "base/sha1.h"
+#include "base/strings/string_number_conversions.h"
+#include "base/strings/string_util.h"
+#include "base/synchronization/waitable_event.h"
+#include "base/threading/worker_pool.h"
+
+namespace {
+
+base::FilePath SimplifyPath(const base::FilePath& path) {
+  std::vector<base::FilePath::StringType> components;
+  path.GetComponents(&components);
+  auto it = components.begin();
+  base::FilePath result(*it++);
+  for (; it != components.end(); it++) {
+    auto& component = *it;
+    if (component == base::FilePath::kCurrentDirectory)
+      continue;
+    if (component == base::FilePath::kParentDirectory)
+      result = result.DirName();
+    else
+      result = result.Append(component);
+  }
+  return result;
+}
+
+bool IsIdentifierChar(char c) {
+  return base::IsAsciiAlpha(c) || base::IsAsciiDigit(c) || c == '_' || c == '$';
+}
+
+// Skips whitespace, comments and the script tag.
+size_t SkipTrivia(const std::string& source, size_t i) {
+  while (i < source.size()) {
+    if (base::IsAsciiWhitespace(source[i])) {
+      ++i;
+    } else if (source.compare(i, 2, "//") == 0 ||
+               (i == 0 && source.compare(i, 2, "#!") == 0)) {
+      i = source.find('\n', i);
+    } else if (source.compare(i, 2, "/*") == 0) {
+      i = source.find("*/", i + 2);
+      if (i != std::string::npos)
+        i += 2;
+    } else {
+      break;
+    }
+  }
+  return std::min(i, source.size());
+}
+
+// Returns the URIs named by the import, export and part directives at the
+// top of |source|. Stops at anything else but a library directive, so a
+// file this does not understand only means that the VM waits for the files
+// it names to be read.
+std::vector<std::string> DirectiveURIs(const std::string& source) {
+  std::vector<std::string> uris;
+  size_t i = 0;
+  while (true) {
+    i = SkipTrivia(source, i);
+    size_t end = i;
+    while (end < source.size() && IsIdentifierChar(source[end]))
+      ++end;
+    std::string keyword = source.substr(i, end - i);
+    if (keyword != "library" && keyword != "import" && keyword != "export" &&
+        keyword != "part")
+      break;
+
+    i = SkipTrivia(source, end);
+    if (keyword != "library" && i < source.size() &&
+        (source[i] == '\'' || source[i] == '"')) {
+      size_t close = source.find(source[i], i + 1);
+      if (close == std::string::npos)
+        break;
+      uris.push_back(source.substr(i + 1, close - i - 1));
+      i = close + 1;
+    }
+
+    // Whatever else the directive says, such as the prefix of an import or
+    // the library a part is of, is skipped.
+    i = source.find(';', i);
+    if (i == std::string::npos)
+      break;
+    ++i;
+  }
+  return uris;
+}
+
+}  // namespace
+
+struct SourceReader::File {
+  File() : done(true, false), ok(false) {}
+
+  base::WaitableEvent done;
+  bool ok;
+  std::string source;
+  std::string digest;
+};
+
+SourceReader::SourceReader(const base::FilePath& package_root)
+    : package_root_(package_root) {
+}
+
+SourceReader::~SourceReader() {
+  for (auto& entry : files_) {
+    entry.second->done.Wait();
+    delete entry.second;
+  }
+}
+
+std::string SourceReader::Resolve(const std::string& library_url,
+                                  const std::string& url) const {
+  if (base::StartsWithASCII(url, "dart:", true))
+    return url;
+  if (base::StartsWithASCII(url, "package:", true))
+    return package_root_.Append(url.substr(strlen("package:"))).AsUTF8Unsafe();
+  base::FilePath base_path(library_url);
+  base::FilePath resolved_path = base_path.DirName().Append(url);
+  return SimplifyPath(resolved_path).AsUTF8Unsafe();
+}
+
+void SourceReader::Prefetch(const std::string& path) {
+  if (base::StartsWithASCII(path, "dart:", true))
+    return;
+  File* file = new File();
+  {
+    base::AutoLock lock(lock_);
+    auto result = files_.insert(std::make_pair(path, file));
+    if (!result.second) {
+      delete file;
+      return;
+    }
+  }
+  base::WorkerPool::PostTask(FROM_HERE,
+                             base::Bind(&SourceReader::ReadFile,
+                                        base::Unretained(this), path, file),
+                             false);
+}
+
+bool SourceReader::Read(const std::string& path,
+                        std::string* source,
+                        std::string* digest) {
+  Prefetch(path);
+  File* file;
+  {
+    base::AutoLock lock(lock_);
+    file = files_[path];
+  }
+  file->done.Wait();
+  if (!file->ok)
+    return false;
+  *source = file->source;
+  *digest = file->digest;
+  return true;
+}
+
+void SourceReader::ReadFile(const std::string& path, File* file) {
+  file->ok = base::ReadFileToString(base::FilePath(path), &file->source);
+  if (file->ok) {
+    std::string hash = base::SHA1HashString(file->source);
+    file->digest = base::HexEncode(hash.data(), hash.size());
+    for (const std::string& uri : DirectiveURIs(file->source))
+      Prefetch(Resolve(path, uri));
+  }
+  file->done.Signal();
+}
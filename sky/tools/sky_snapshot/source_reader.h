@@ -0,0 +1,49 @@
+// Copyright 2015 The Chromium Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file.
+
+#ifndef SKY_TOOLS_SKY_SNAPSHOT_SOURCE_READER_H_
+#define SKY_TOOLS_SKY_SNAPSHOT_SOURCE_READER_H_
+
+#include <map>
+#include <string>
+
+#include "base/basictypes.h"
+#include "base/files/file_path.h"
+#include "base/synchronization/lock.h"
+
+// Reads the sources of a program on worker threads. Once a file has been
+// read, the files named by its import, export and part directives are read
+// too, so most of the package graph has been read by the time the VM asks
+// for it one library at a time.
+class SourceReader {
+ public:
+  explicit SourceReader(const base::FilePath& package_root);
+  ~SourceReader();
+
+  // Returns the path of |url| as named by the library at |library_url|, or
+  // |url| itself for dart: libraries. Can be called on any thread.
+  std::string Resolve(const std::string& library_url,
+                      const std::string& url) const;
+
+  // Starts reading |path| unless it has been read or is being read.
+  void Prefetch(const std::string& path);
+
+  // Waits for |path| to be read and returns its contents and the SHA-1 of
+  // them in hex. Returns false if |path| could not be read.
+  bool Read(const std::string& path, std::string* source, std::string* digest);
+
+ private:
+  struct File;
+
+  void ReadFile(const std::string& path, File* file);
+
+  const base::FilePath package_root_;
+
+  base::Lock lock_;
+  std::map<std::string, File*> files_;
+
+  DISALLOW_COPY_AND_ASSIGN(SourceReader);
+};
+
+#endif  // SKY_TOOLS_SKY_SNAPSHOT_SOURCE_READER_H_
@@ -6,6 +6,8 @@
 
 namespace switches {
 
+const char kBuildOutput[] = "build-output";
+const char kDepfile[] = "depfile";
 const char kHelp[] = "help";
 const char kPackageRoot[] = "package-root";
 const char kSnapshot[] = "snapshot";
@@ -7,6 +7,8 @@
 
 namespace switches {
 
+extern const char kBuildOutput[];
+extern const char kDepfile[];
 extern const char kHelp[];
 extern const char kPackageRoot[];
 extern const char kSnapshot[];
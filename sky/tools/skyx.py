@@ -16,6 +16,7 @@ def main():
     parser = argparse.ArgumentParser(description='Packaging tool for Sky apps')
     parser.add_argument('--package-root', type=str)
     parser.add_argument('--manifest', type=str)
+    parser.add_argument('--prefetch-manifest', type=str)
     parser.add_argument('--asset-base', type=str)
     parser.add_argument('--snapshot', type=str)
     parser.add_argument('-o', '--output-file', type=str)
@@ -33,6 +34,9 @@ def main():
     if args.manifest:
         command += ['--manifest', args.manifest]
 
+    if args.prefetch_manifest:
+        command += ['--prefetch-manifest', args.prefetch_manifest]
+
     subprocess.check_call(command)
 
 if __name__ == '__main__':
@@ -10,6 +10,7 @@ import 'package:args/args.dart';
 import 'package:yaml/yaml.dart';
 
 const String kSnapshotKey = 'snapshot_blob.bin';
+const String kPrefetchManifestKey = 'prefetch_manifest.txt';
 const List<String> kDensities = const ['drawable-xxhdpi'];
 const List<String> kThemes = const ['white', 'black'];
 const List<int> kSizes = const [24];
@@ -94,6 +95,16 @@ Future<ArchiveFile> createFile(String key, String assetBase) async {
   return new ArchiveFile.noCompress(key, content.length, content);
 }
 
+// The prefetch manifest lists the assets an app asks for during startup, one
+// key per line, in the order they were asked for. The asset bundle service
+// reads those assets as soon as the bundle arrives. The list can be taken
+// from the AssetBundleImpl::GetAsStream events in a trace of a startup run.
+Future<ArchiveFile> createPrefetchManifestFile(String prefetchManifestPath) async {
+  File file = new File(prefetchManifestPath);
+  List<int> content = await file.readAsBytes();
+  return new ArchiveFile.noCompress(kPrefetchManifestKey, content.length, content);
+}
+
 Future<ArchiveFile> createSnapshotFile(String snapshotPath) async {
   File file = new File(snapshotPath);
   List<int> content = await file.readAsBytes();
@@ -106,6 +117,7 @@ main(List<String> argv) async {
   parser.addOption('asset-base');
   parser.addOption('manifest');
   parser.addOption('output-file', abbr: 'o');
+  parser.addOption('prefetch-manifest');
   parser.addOption('snapshot');
 
   ArgResults args = parser.parse(argv);
@@ -125,6 +137,10 @@ main(List<String> argv) async {
   if (snapshot != null)
     archive.addFile(await createSnapshotFile(snapshot));
 
+  String prefetchManifest = args['prefetch-manifest'];
+  if (prefetchManifest != null)
+    archive.addFile(await createPrefetchManifestFile(prefetchManifest));
+
   for (Asset asset in assets)
     archive.addFile(await createFile(asset.key, asset.base));
 
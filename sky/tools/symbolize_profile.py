@@ -0,0 +1,172 @@
+#!/usr/bin/env python
+# Copyright 2015 The Chromium Authors. All rights reserved.
+# Use of this source code is governed by a BSD-style license that can be
+# found in the LICENSE file.
+
+"""Symbolizes a profile recorded by sky/shell/sampling_profiler.cc.
+
+The profile holds raw addresses and the memory map of the process they were
+sampled in. Each address is turned into an offset into the library it falls
+in and looked up with addr2line in the unstripped copy of that library, for
+example the one in out/android_Release/lib.unstripped.
+
+The output is one line per distinct stack, in the collapsed format that
+flame graph tools read:
+
+  ui;main;sky::shell::Engine::BeginFrame;... 42
+"""
+
+import argparse
+import bisect
+import collections
+import json
+import logging
+import os
+import re
+import subprocess
+import sys
+
+MAPS_LINE_REGEXP = re.compile(
+    r'^(?P<start>[0-9a-f]+)-(?P<end>[0-9a-f]+)\s+(?P<perms>\S+)\s+'
+    r'(?P<offset>[0-9a-f]+)\s+\S+\s+\d+\s*(?P<path>.*)$')
+
+UNKNOWN_FUNCTION = '??'
+
+
+class Mapping(object):
+    def __init__(self, start, end, offset, path):
+        self.start = start
+        self.end = end
+        self.offset = offset
+        self.path = path
+
+
+def parse_maps(lines):
+    mappings = []
+    for line in lines:
+        match = MAPS_LINE_REGEXP.match(line)
+        if not match or 'x' not in match.group('perms'):
+            continue
+        mappings.append(Mapping(int(match.group('start'), 16),
+                                int(match.group('end'), 16),
+                                int(match.group('offset'), 16),
+                                match.group('path').strip()))
+    mappings.sort(key=lambda mapping: mapping.start)
+    return mappings
+
+
+def find_library(path, symbols_dirs):
+    name = os.path.basename(path)
+    for symbols_dir in symbols_dirs:
+        candidate = os.path.join(symbols_dir, name)
+        if os.path.exists(candidate):
+            return candidate
+    if os.path.exists(path):
+        return path
+    return None
+
+
+class Symbolizer(object):
+    def __init__(self, mappings, symbols_dirs, addr2line):
+        self._mappings = mappings
+        self._starts = [mapping.start for mapping in mappings]
+        self._symbols_dirs = symbols_dirs
+        self._addr2line = addr2line
+        self._names = {}
+
+    def _locate(self, address):
+        index = bisect.bisect_right(self._starts, address) - 1
+        if index < 0:
+            return None
+        mapping = self._mappings[index]
+        if address >= mapping.end or not mapping.path:
+            return None
+        return mapping
+
+    def symbolize(self, addresses):
+        """Looks up all of |addresses| with one addr2line run per library."""
+        offsets_by_library = collections.defaultdict(set)
+        for address in addresses:
+            if address in self._names:
+                continue
+            mapping = self._locate(address)
+            if not mapping:
+                self._names[address] = UNKNOWN_FUNCTION
+                continue
+            offset = address - mapping.start + mapping.offset
+            offsets_by_library[mapping.path].add((address, offset))
+
+        for path, entries in offsets_by_library.iteritems():
+            entries = sorted(entries)
+            library = find_library(path, self._symbols_dirs)
+            names = None
+            if library:
+                names = self._run_addr2line(library,
+                                            [offset for _, offset in entries])
+            else:
+                logging.warning('No symbols for %s', path)
+            for i, (address, offset) in enumerate(entries):
+                name = names[i] if names else UNKNOWN_FUNCTION
+                if name == UNKNOWN_FUNCTION:
+                    name = '%s+0x%x' % (os.path.basename(path), offset)
+                self._names[address] = name
+
+    def _run_addr2line(self, library, offsets):
+        process = subprocess.Popen(
+            [self._addr2line, '-f', '-C', '-e', library],
+            stdin=subprocess.PIPE, stdout=subprocess.PIPE)
+        output, _ = process.communicate(
+            ''.join('0x%x\n' % offset for offset in offsets))
+        if process.returncode != 0:
+            logging.warning('%s failed on %s', self._addr2line, library)
+            return None
+        # addr2line prints the function and then the source location of each
+        # address.
+        lines = output.splitlines()
+        return [lines[2 * i] for i in range(len(offsets))]
+
+    def name(self, address):
+        return self._names[address]
+
+
+def main():
+    logging.basicConfig(level=logging.WARNING)
+    parser = argparse.ArgumentParser(
+        description='Symbolize a native profile recorded by sky_shell.')
+    parser.add_argument('profile', type=str)
+    parser.add_argument('--symbols-dir', action='append', default=[],
+        help='a directory of unstripped libraries, can be given repeatedly')
+    parser.add_argument('--addr2line', type=str, default='addr2line',
+        help='the addr2line for the architecture the profile was recorded on')
+    args = parser.parse_args()
+
+    with open(args.profile) as profile_file:
+        profile = json.load(profile_file)
+
+    threads = [thread['name'] for thread in profile['threads']]
+    stacks = []
+    for sample in profile['samples']:
+        frames = [int(frame, 16) for frame in sample['frames']]
+        # Frames other than the innermost one are return addresses, which
+        # point just past the call.
+        stacks.append((sample['thread'],
+                       frames[:1] + [frame - 1 for frame in frames[1:]]))
+
+    symbolizer = Symbolizer(parse_maps(profile['maps']), args.symbols_dir,
+                            args.addr2line)
+    symbolizer.symbolize(set(frame for _, frames in stacks
+                                   for frame in frames))
+
+    counts = collections.Counter()
+    for thread, frames in stacks:
+        names = [threads[thread]]
+        names.extend(symbolizer.name(frame) for frame in reversed(frames))
+        counts[';'.join(name.replace(';', ':') for name in names)] += 1
+
+    for stack, count in sorted(counts.iteritems()):
+        print '%s %d' % (stack, count)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main())
@@ -359,16 +359,23 @@ class ParticleSystem extends Node {
 
   void paint(PaintingCanvas canvas) {
 
-    List<RSTransform> transforms = [];
-    List<Rect> rects = [];
-    List<Color> colors = [];
+    int numParticles = _particles.length;
+    Float32List transforms = new Float32List(numParticles * 4);
+    Float32List rects = new Float32List(numParticles * 4);
+    Int32List colors = new Int32List(numParticles);
 
     _paint.setTransferMode(transferMode);
 
-    for (_Particle particle in _particles) {
+    Rect rect = texture.frame;
+
+    for (int i = 0; i < numParticles; i++) {
+      _Particle particle = _particles[i];
+
       // Rect
-      Rect rect = texture.frame;
-      rects.add(rect);
+      rects[i * 4] = rect.left;
+      rects[i * 4 + 1] = rect.top;
+      rects[i * 4 + 2] = rect.right;
+      rects[i * 4 + 3] = rect.bottom;
 
       // Transform
       double scos;
@@ -388,8 +395,10 @@ class ParticleSystem extends Node {
       double ay = rect.height / 2;
       double tx = particle.pos[0] + -scos * ax + ssin * ay;
       double ty = particle.pos[1] + -ssin * ax - scos * ay;
-      RSTransform transform = new RSTransform(scos, ssin, tx, ty);
-      transforms.add(transform);
+      transforms[i * 4] = scos;
+      transforms[i * 4 + 1] = ssin;
+      transforms[i * 4 + 2] = tx;
+      transforms[i * 4 + 3] = ty;
 
       // Color
       if (particle.simpleColorSequence != null) {
@@ -398,7 +407,7 @@ class ParticleSystem extends Node {
           particle.simpleColorSequence[1].toInt().clamp(0, 255),
           particle.simpleColorSequence[2].toInt().clamp(0, 255),
           particle.simpleColorSequence[3].toInt().clamp(0, 255));
-        colors.add(particleColor);
+        colors[i] = particleColor.value;
       } else {
         Color particleColor;
         if (particle.colorSequence != null) {
@@ -406,11 +415,11 @@ class ParticleSystem extends Node {
         } else {
           particleColor = colorSequence.colorAtPosition(particle.colorPos);
         }
-        colors.add(particleColor);
+        colors[i] = particleColor.value;
       }
     }
 
-    canvas.drawAtlas(texture.image, transforms, rects, colors,
+    canvas.drawRawAtlas(texture.image, transforms, rects, colors,
       TransferMode.modulate, null, _paint);
   }
 }
@@ -290,6 +290,15 @@ typedef void (*OSMESAproc)();
 // Forward declare EGL types.
 typedef uint64 EGLuint64CHROMIUM;
 
+// Older EGL headers predate these extensions.
+#ifndef EGL_ANDROID_presentation_time
+typedef int64 EGLnsecsANDROID;
+#endif
+
+#ifndef EGL_EXT_buffer_age
+#define EGL_BUFFER_AGE_EXT 0x313D
+#endif
+
 typedef void (*GLDEBUGPROCKHR)(GLenum source, GLenum type, GLuint id,
                                GLenum severity, GLsizei length,
                                const GLchar *message, void *userParam);
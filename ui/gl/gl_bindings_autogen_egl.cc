@@ -76,6 +76,7 @@ void DriverEGL::InitializeStaticBindings() {
   fn.eglMakeCurrentFn =
       reinterpret_cast<eglMakeCurrentProc>(GetGLProcAddress("eglMakeCurrent"));
   fn.eglPostSubBufferNVFn = 0;
+  fn.eglPresentationTimeANDROIDFn = 0;
   fn.eglQueryAPIFn =
       reinterpret_cast<eglQueryAPIProc>(GetGLProcAddress("eglQueryAPI"));
   fn.eglQueryContextFn = reinterpret_cast<eglQueryContextProc>(
@@ -108,6 +109,8 @@ void DriverEGL::InitializeStaticBindings() {
   extensions += " ";
   ALLOW_UNUSED_LOCAL(extensions);
 
+  ext.b_EGL_ANDROID_presentation_time =
+      extensions.find("EGL_ANDROID_presentation_time ") != std::string::npos;
   ext.b_EGL_ANGLE_d3d_share_handle_client_buffer =
       extensions.find("EGL_ANGLE_d3d_share_handle_client_buffer ") !=
       std::string::npos;
@@ -200,6 +203,14 @@ void DriverEGL::InitializeStaticBindings() {
     DCHECK(fn.eglPostSubBufferNVFn);
   }
 
+  debug_fn.eglPresentationTimeANDROIDFn = 0;
+  if (ext.b_EGL_ANDROID_presentation_time) {
+    fn.eglPresentationTimeANDROIDFn =
+        reinterpret_cast<eglPresentationTimeANDROIDProc>(
+            GetGLProcAddress("eglPresentationTimeANDROID"));
+    DCHECK(fn.eglPresentationTimeANDROIDFn);
+  }
+
   debug_fn.eglQuerySurfacePointerANGLEFn = 0;
   if (ext.b_EGL_ANGLE_query_surface_pointer) {
     fn.eglQuerySurfacePointerANGLEFn =
@@ -582,6 +593,18 @@ static EGLBoolean GL_BINDING_CALL Debug_eglPostSubBufferNV(EGLDisplay dpy,
   return result;
 }
 
+static EGLBoolean GL_BINDING_CALL
+Debug_eglPresentationTimeANDROID(EGLDisplay dpy,
+                                 EGLSurface surface,
+                                 EGLnsecsANDROID time) {
+  GL_SERVICE_LOG("eglPresentationTimeANDROID"
+                 << "(" << dpy << ", " << surface << ", " << time << ")");
+  EGLBoolean result =
+      g_driver_egl.debug_fn.eglPresentationTimeANDROIDFn(dpy, surface, time);
+  GL_SERVICE_LOG("GL_RESULT: " << result);
+  return result;
+}
+
 static EGLenum GL_BINDING_CALL Debug_eglQueryAPI(void) {
   GL_SERVICE_LOG("eglQueryAPI"
                  << "("
@@ -859,6 +882,10 @@ void DriverEGL::InitializeDebugBindings() {
     debug_fn.eglPostSubBufferNVFn = fn.eglPostSubBufferNVFn;
     fn.eglPostSubBufferNVFn = Debug_eglPostSubBufferNV;
   }
+  if (!debug_fn.eglPresentationTimeANDROIDFn) {
+    debug_fn.eglPresentationTimeANDROIDFn = fn.eglPresentationTimeANDROIDFn;
+    fn.eglPresentationTimeANDROIDFn = Debug_eglPresentationTimeANDROID;
+  }
   if (!debug_fn.eglQueryAPIFn) {
     debug_fn.eglQueryAPIFn = fn.eglQueryAPIFn;
     fn.eglQueryAPIFn = Debug_eglQueryAPI;
@@ -1109,6 +1136,12 @@ EGLBoolean EGLApiBase::eglPostSubBufferNVFn(EGLDisplay dpy,
   return driver_->fn.eglPostSubBufferNVFn(dpy, surface, x, y, width, height);
 }
 
+EGLBoolean EGLApiBase::eglPresentationTimeANDROIDFn(EGLDisplay dpy,
+                                                    EGLSurface surface,
+                                                    EGLnsecsANDROID time) {
+  return driver_->fn.eglPresentationTimeANDROIDFn(dpy, surface, time);
+}
+
 EGLenum EGLApiBase::eglQueryAPIFn(void) {
   return driver_->fn.eglQueryAPIFn();
 }
@@ -1401,6 +1434,14 @@ EGLBoolean TraceEGLApi::eglPostSubBufferNVFn(EGLDisplay dpy,
   return egl_api_->eglPostSubBufferNVFn(dpy, surface, x, y, width, height);
 }
 
+EGLBoolean TraceEGLApi::eglPresentationTimeANDROIDFn(EGLDisplay dpy,
+                                                     EGLSurface surface,
+                                                     EGLnsecsANDROID time) {
+  TRACE_EVENT_BINARY_EFFICIENT0("gpu",
+                                "TraceGLAPI::eglPresentationTimeANDROID")
+  return egl_api_->eglPresentationTimeANDROIDFn(dpy, surface, time);
+}
+
 EGLenum TraceEGLApi::eglQueryAPIFn(void) {
   TRACE_EVENT_BINARY_EFFICIENT0("gpu", "TraceGLAPI::eglQueryAPI")
   return egl_api_->eglQueryAPIFn();
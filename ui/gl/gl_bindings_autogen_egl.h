@@ -119,6 +119,10 @@ typedef EGLBoolean(GL_BINDING_CALL* eglPostSubBufferNVProc)(EGLDisplay dpy,
                                                             EGLint y,
                                                             EGLint width,
                                                             EGLint height);
+typedef EGLBoolean(GL_BINDING_CALL* eglPresentationTimeANDROIDProc)(
+    EGLDisplay dpy,
+    EGLSurface surface,
+    EGLnsecsANDROID time);
 typedef EGLenum(GL_BINDING_CALL* eglQueryAPIProc)(void);
 typedef EGLBoolean(GL_BINDING_CALL* eglQueryContextProc)(EGLDisplay dpy,
                                                          EGLContext ctx,
@@ -156,6 +160,7 @@ typedef EGLint(GL_BINDING_CALL* eglWaitSyncKHRProc)(EGLDisplay dpy,
                                                     EGLint flags);
 
 struct ExtensionsEGL {
+  bool b_EGL_ANDROID_presentation_time;
   bool b_EGL_ANGLE_d3d_share_handle_client_buffer;
   bool b_EGL_ANGLE_platform_angle;
   bool b_EGL_ANGLE_query_surface_pointer;
@@ -201,6 +206,7 @@ struct ProcsEGL {
   eglInitializeProc eglInitializeFn;
   eglMakeCurrentProc eglMakeCurrentFn;
   eglPostSubBufferNVProc eglPostSubBufferNVFn;
+  eglPresentationTimeANDROIDProc eglPresentationTimeANDROIDFn;
   eglQueryAPIProc eglQueryAPIFn;
   eglQueryContextProc eglQueryContextFn;
   eglQueryStringProc eglQueryStringFn;
@@ -314,6 +320,9 @@ class GL_EXPORT EGLApi {
                                           EGLint y,
                                           EGLint width,
                                           EGLint height) = 0;
+  virtual EGLBoolean eglPresentationTimeANDROIDFn(EGLDisplay dpy,
+                                                  EGLSurface surface,
+                                                  EGLnsecsANDROID time) = 0;
   virtual EGLenum eglQueryAPIFn(void) = 0;
   virtual EGLBoolean eglQueryContextFn(EGLDisplay dpy,
                                        EGLContext ctx,
@@ -389,6 +398,8 @@ class GL_EXPORT EGLApi {
 #define eglInitialize ::gfx::g_current_egl_context->eglInitializeFn
 #define eglMakeCurrent ::gfx::g_current_egl_context->eglMakeCurrentFn
 #define eglPostSubBufferNV ::gfx::g_current_egl_context->eglPostSubBufferNVFn
+#define eglPresentationTimeANDROID \
+  ::gfx::g_current_egl_context->eglPresentationTimeANDROIDFn
 #define eglQueryAPI ::gfx::g_current_egl_context->eglQueryAPIFn
 #define eglQueryContext ::gfx::g_current_egl_context->eglQueryContextFn
 #define eglQueryString ::gfx::g_current_egl_context->eglQueryStringFn
@@ -5,15 +5,183 @@
 
 #include "ui/gl/gl_bindings_skia_in_process.h"
 
+#include "base/lazy_instance.h"
 #include "base/logging.h"
+#include "base/synchronization/lock.h"
+#include "base/threading/thread_local.h"
+#include "skia/ext/refptr.h"
 #include "third_party/skia/include/gpu/gl/GrGLInterface.h"
 #include "ui/gl/gl_bindings.h"
 #include "ui/gl/gl_implementation.h"
 
 namespace gfx {
+namespace {
+
+enum GLCallKind {
+  kOtherCall,
+  kDrawCall,
+  kStateChange,
+  kUpload,
+};
+
+base::LazyInstance<base::ThreadLocalPointer<SkiaGLCallCounts>>::Leaky
+    g_call_counts = LAZY_INSTANCE_INITIALIZER;
+
+// Guards the original entry points the counting functions forward to. The
+// native interface has the same entry points for every context, so they are
+// only written once in practice.
+base::LazyInstance<base::Lock>::Leaky g_install_lock =
+    LAZY_INSTANCE_INITIALIZER;
+
+SkiaGLCallCounts* CurrentCallCounts() {
+  SkiaGLCallCounts* counts = g_call_counts.Pointer()->Get();
+  if (!counts) {
+    // Leaked on purpose, a thread only ever makes one of these.
+    counts = new SkiaGLCallCounts();
+    g_call_counts.Pointer()->Set(counts);
+  }
+  return counts;
+}
+
+void CountGLCall(GLCallKind kind) {
+  SkiaGLCallCounts* counts = CurrentCallCounts();
+  counts->calls++;
+  switch (kind) {
+    case kDrawCall:
+      counts->draws++;
+      break;
+    case kStateChange:
+      counts->state_changes++;
+      break;
+    case kUpload:
+      counts->uploads++;
+      break;
+    case kOtherCall:
+      break;
+  }
+}
+
+// Counts a call and forwards it to |original|. |kId| makes every wrapped
+// function a separate instantiation with its own |original|.
+template <typename Proc, GLCallKind kKind, int kId>
+class CountingGLFunction;
+
+template <GLCallKind kKind, int kId, typename R, typename... Args>
+class CountingGLFunction<R (GR_GL_FUNCTION_TYPE*)(Args...), kKind, kId> {
+ public:
+  typedef R (GR_GL_FUNCTION_TYPE* Proc)(Args...);
+
+  static R GR_GL_FUNCTION_TYPE Call(Args... args) {
+    CountGLCall(kKind);
+    return original(args...);
+  }
+
+  static Proc original;
+};
+
+template <GLCallKind kKind, int kId, typename R, typename... Args>
+typename CountingGLFunction<R (GR_GL_FUNCTION_TYPE*)(Args...), kKind,
+                            kId>::Proc
+    CountingGLFunction<R (GR_GL_FUNCTION_TYPE*)(Args...), kKind,
+                       kId>::original = nullptr;
+
+// Entry points the driver does not have stay null.
+#define COUNT_GL_FUNCTION(name, kind)                                   \
+  do {                                                                  \
+    typedef CountingGLFunction<GrGL##name##Proc, kind, __LINE__> Counting; \
+    if (functions->f##name) {                                           \
+      Counting::original = functions->f##name;                          \
+      functions->f##name = &Counting::Call;                             \
+    }                                                                   \
+  } while (0)
+
+void InstallCountingFunctions(GrGLInterface::Functions* functions) {
+  COUNT_GL_FUNCTION(DrawArrays, kDrawCall);
+  COUNT_GL_FUNCTION(DrawElements, kDrawCall);
+  COUNT_GL_FUNCTION(DrawArraysInstanced, kDrawCall);
+  COUNT_GL_FUNCTION(DrawElementsInstanced, kDrawCall);
+
+  COUNT_GL_FUNCTION(ActiveTexture, kStateChange);
+  COUNT_GL_FUNCTION(BindBuffer, kStateChange);
+  COUNT_GL_FUNCTION(BindFramebuffer, kStateChange);
+  COUNT_GL_FUNCTION(BindRenderbuffer, kStateChange);
+  COUNT_GL_FUNCTION(BindTexture, kStateChange);
+  COUNT_GL_FUNCTION(BindVertexArray, kStateChange);
+  COUNT_GL_FUNCTION(BlendColor, kStateChange);
+  COUNT_GL_FUNCTION(BlendEquation, kStateChange);
+  COUNT_GL_FUNCTION(BlendFunc, kStateChange);
+  COUNT_GL_FUNCTION(ColorMask, kStateChange);
+  COUNT_GL_FUNCTION(Disable, kStateChange);
+  COUNT_GL_FUNCTION(DisableVertexAttribArray, kStateChange);
+  COUNT_GL_FUNCTION(Enable, kStateChange);
+  COUNT_GL_FUNCTION(EnableVertexAttribArray, kStateChange);
+  COUNT_GL_FUNCTION(FrontFace, kStateChange);
+  COUNT_GL_FUNCTION(PixelStorei, kStateChange);
+  COUNT_GL_FUNCTION(Scissor, kStateChange);
+  COUNT_GL_FUNCTION(StencilFunc, kStateChange);
+  COUNT_GL_FUNCTION(StencilFuncSeparate, kStateChange);
+  COUNT_GL_FUNCTION(StencilMask, kStateChange);
+  COUNT_GL_FUNCTION(StencilMaskSeparate, kStateChange);
+  COUNT_GL_FUNCTION(StencilOp, kStateChange);
+  COUNT_GL_FUNCTION(StencilOpSeparate, kStateChange);
+  COUNT_GL_FUNCTION(TexParameteri, kStateChange);
+  COUNT_GL_FUNCTION(UseProgram, kStateChange);
+  COUNT_GL_FUNCTION(VertexAttribPointer, kStateChange);
+  COUNT_GL_FUNCTION(Viewport, kStateChange);
+
+  COUNT_GL_FUNCTION(BufferData, kUpload);
+  COUNT_GL_FUNCTION(BufferSubData, kUpload);
+  COUNT_GL_FUNCTION(CompressedTexImage2D, kUpload);
+  COUNT_GL_FUNCTION(TexImage2D, kUpload);
+  COUNT_GL_FUNCTION(TexSubImage2D, kUpload);
+
+  COUNT_GL_FUNCTION(Clear, kOtherCall);
+  COUNT_GL_FUNCTION(Flush, kOtherCall);
+  COUNT_GL_FUNCTION(Finish, kOtherCall);
+  COUNT_GL_FUNCTION(GetError, kOtherCall);
+  COUNT_GL_FUNCTION(GetIntegerv, kOtherCall);
+  COUNT_GL_FUNCTION(Uniform1f, kOtherCall);
+  COUNT_GL_FUNCTION(Uniform1i, kOtherCall);
+  COUNT_GL_FUNCTION(Uniform2f, kOtherCall);
+  COUNT_GL_FUNCTION(Uniform4f, kOtherCall);
+  COUNT_GL_FUNCTION(Uniform4fv, kOtherCall);
+  COUNT_GL_FUNCTION(UniformMatrix3fv, kOtherCall);
+  COUNT_GL_FUNCTION(UniformMatrix4fv, kOtherCall);
+}
+
+#undef COUNT_GL_FUNCTION
+
+}  // namespace
+
+SkiaGLCallCounts::SkiaGLCallCounts()
+    : calls(0), draws(0), state_changes(0), uploads(0) {
+}
 
 const GrGLInterface* CreateInProcessSkiaGLBinding() {
   return GrGLCreateNativeInterface();
 }
 
+const GrGLInterface* CreateCountingInProcessSkiaGLBinding() {
+  skia::RefPtr<const GrGLInterface> native =
+      skia::AdoptRef(GrGLCreateNativeInterface());
+  if (!native)
+    return nullptr;
+
+  GrGLInterface* interface = GrGLInterface::NewClone(native.get());
+  {
+    base::AutoLock lock(g_install_lock.Get());
+    InstallCountingFunctions(&interface->fFunctions);
+  }
+  // Makes sure the counts exist before the first call.
+  CurrentCallCounts();
+  return interface;
+}
+
+SkiaGLCallCounts TakeSkiaGLCallCounts() {
+  SkiaGLCallCounts* counts = CurrentCallCounts();
+  SkiaGLCallCounts result = *counts;
+  *counts = SkiaGLCallCounts();
+  return result;
+}
+
 }  // namespace gfx
@@ -12,9 +12,36 @@ struct GrGLInterface;
 namespace gfx {
 
 // The GPU back-end for skia requires pointers to GL functions. This function
-// creates a binding for skia-gpu to the in-process GL
+// creates a binding for skia-gpu to the in-process GL. Skia calls the
+// driver's entry points directly, without going through the function tables
+// and the logging and tracing wrappers of gl_bindings.h.
 GL_EXPORT const GrGLInterface* CreateInProcessSkiaGLBinding();
 
+// The number of GL calls skia-gpu made on a thread, see
+// CreateCountingInProcessSkiaGLBinding().
+struct GL_EXPORT SkiaGLCallCounts {
+  SkiaGLCallCounts();
+
+  // Every counted call, including the ones below.
+  int calls;
+  int draws;
+  // Binds, enables, blend, stencil, scissor and viewport changes and the
+  // like.
+  int state_changes;
+  // Texture and buffer uploads.
+  int uploads;
+};
+
+// Same as CreateInProcessSkiaGLBinding(), but draws, state changes, uploads
+// and the other calls skia-gpu makes most are counted until the next call
+// to TakeSkiaGLCallCounts() on the same thread. Counting costs a call and a
+// thread local lookup for every GL call, so this is for measuring only.
+GL_EXPORT const GrGLInterface* CreateCountingInProcessSkiaGLBinding();
+
+// Returns the calls made on this thread through bindings created by
+// CreateCountingInProcessSkiaGLBinding() and starts counting from zero.
+GL_EXPORT SkiaGLCallCounts TakeSkiaGLCallCounts();
+
 }  // namespace gfx
 
 #endif  // UI_GL_GL_BINDINGS_SKIA_IN_PROCESS_H_
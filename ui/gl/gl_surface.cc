@@ -191,6 +191,18 @@ bool GLSurface::SupportsPostSubBuffer() {
   return false;
 }
 
+int GLSurface::GetBufferAge() {
+  return 0;
+}
+
+bool GLSurface::SupportsPresentationTime() {
+  return false;
+}
+
+bool GLSurface::SetPresentationTime(base::TimeTicks time) {
+  return false;
+}
+
 unsigned int GLSurface::GetBackingFrameBufferObject() {
   return 0;
 }
@@ -347,6 +359,18 @@ bool GLSurfaceAdapter::SupportsPostSubBuffer() {
   return surface_->SupportsPostSubBuffer();
 }
 
+int GLSurfaceAdapter::GetBufferAge() {
+  return surface_->GetBufferAge();
+}
+
+bool GLSurfaceAdapter::SupportsPresentationTime() {
+  return surface_->SupportsPresentationTime();
+}
+
+bool GLSurfaceAdapter::SetPresentationTime(base::TimeTicks time) {
+  return surface_->SetPresentationTime(time);
+}
+
 gfx::Size GLSurfaceAdapter::GetSize() {
   return surface_->GetSize();
 }
@@ -9,6 +9,7 @@
 
 #include "base/callback.h"
 #include "base/memory/ref_counted.h"
+#include "base/time/time.h"
 #include "build/build_config.h"
 #include "ui/gfx/geometry/rect.h"
 #include "ui/gfx/geometry/rect_f.h"
@@ -31,6 +32,8 @@ struct SurfaceConfiguration {
   uint8_t alpha_bits = 8;
   uint8_t depth_bits = 0;
   uint8_t stencil_bits = 0;
+  // The number of samples per pixel of a multisampled surface, or zero.
+  uint8_t samples = 0;
 };
 
 // Encapsulates a surface that can be rendered to with GL, hiding platform
@@ -78,6 +81,20 @@ class GL_EXPORT GLSurface : public base::RefCounted<GLSurface> {
   // Returns whether or not the surface supports PostSubBuffer.
   virtual bool SupportsPostSubBuffer();
 
+  // Returns how many swaps ago the current back buffer was last presented,
+  // or 0 if its contents are undefined. A back buffer of age 1 still holds
+  // the previous frame, so only the parts that changed need to be redrawn
+  // before a full swap.
+  virtual int GetBufferAge();
+
+  // Returns whether or not the surface supports SetPresentationTime.
+  virtual bool SupportsPresentationTime();
+
+  // Asks for the frame presented by the next swap to be shown no earlier
+  // than |time|, so that a frame finished early waits its turn in the
+  // compositor's queue instead of displacing the previous one.
+  virtual bool SetPresentationTime(base::TimeTicks time);
+
   // Returns the internal frame buffer object name if the surface is backed by
   // FBO. Otherwise returns 0.
   virtual unsigned int GetBackingFrameBufferObject();
@@ -231,6 +248,9 @@ class GL_EXPORT GLSurfaceAdapter : public GLSurface {
                           int height,
                           const SwapCompletionCallback& callback) override;
   bool SupportsPostSubBuffer() override;
+  int GetBufferAge() override;
+  bool SupportsPresentationTime() override;
+  bool SetPresentationTime(base::TimeTicks time) override;
   gfx::Size GetSize() override;
   void* GetHandle() override;
   unsigned int GetBackingFrameBufferObject() override;
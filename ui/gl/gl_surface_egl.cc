@@ -68,6 +68,8 @@ bool g_egl_create_context_robustness_supported = false;
 bool g_egl_sync_control_supported = false;
 bool g_egl_window_fixed_size_supported = false;
 bool g_egl_surfaceless_context_supported = false;
+bool g_egl_buffer_age_supported = false;
+bool g_egl_presentation_time_supported = false;
 
 class EGLSyncControlVSyncProvider
     : public gfx::SyncControlVSyncProvider {
@@ -157,6 +159,8 @@ void* GetEGLConfig(const EGLNativeWindowType window,
     EGL_RED_SIZE, configuration.red_bits,
     EGL_DEPTH_SIZE, configuration.depth_bits,
     EGL_STENCIL_SIZE, configuration.stencil_bits,
+    EGL_SAMPLE_BUFFERS, configuration.samples ? 1 : 0,
+    EGL_SAMPLES, configuration.samples,
     EGL_RENDERABLE_TYPE, renderable_type,
     EGL_SURFACE_TYPE, (allow_window_bit ?
                         (EGL_WINDOW_BIT | EGL_PBUFFER_BIT) :
@@ -261,6 +265,9 @@ bool GLSurfaceEGL::InitializeOneOff() {
       HasEGLExtension("EGL_CHROMIUM_sync_control");
   g_egl_window_fixed_size_supported =
       HasEGLExtension("EGL_ANGLE_window_fixed_size");
+  g_egl_buffer_age_supported = HasEGLExtension("EGL_EXT_buffer_age");
+  g_egl_presentation_time_supported =
+      HasEGLExtension("EGL_ANDROID_presentation_time");
 
   // We always succeed beyond this point so set g_initialized here to avoid
   // infinite recursion through CreateGLContext and GetDisplay
@@ -531,6 +538,37 @@ bool NativeViewGLSurfaceEGL::PostSubBuffer(
   return true;
 }
 
+int NativeViewGLSurfaceEGL::GetBufferAge() {
+  if (!g_egl_buffer_age_supported)
+    return 0;
+  EGLint age = 0;
+  if (!eglQuerySurface(GetDisplay(), surface_, EGL_BUFFER_AGE_EXT, &age)) {
+    DVLOG(1) << "eglQuerySurface failed with error "
+             << GetLastEGLErrorString();
+    return 0;
+  }
+  return age;
+}
+
+bool NativeViewGLSurfaceEGL::SupportsPresentationTime() {
+  return g_egl_presentation_time_supported;
+}
+
+bool NativeViewGLSurfaceEGL::SetPresentationTime(base::TimeTicks time) {
+  DCHECK(g_egl_presentation_time_supported);
+  // The extension takes nanoseconds on the same monotonic clock that
+  // TimeTicks reads on Android.
+  EGLnsecsANDROID nanoseconds = static_cast<EGLnsecsANDROID>(
+      (time - base::TimeTicks()).InMicroseconds() *
+      base::Time::kNanosecondsPerMicrosecond);
+  if (!eglPresentationTimeANDROID(GetDisplay(), surface_, nanoseconds)) {
+    DVLOG(1) << "eglPresentationTimeANDROID failed with error "
+             << GetLastEGLErrorString();
+    return false;
+  }
+  return true;
+}
+
 VSyncProvider* NativeViewGLSurfaceEGL::GetVSyncProvider() {
   return vsync_provider_.get();
 }
@@ -67,6 +67,9 @@ class GL_EXPORT NativeViewGLSurfaceEGL : public GLSurfaceEGL {
   EGLSurface GetHandle() override;
   bool SupportsPostSubBuffer() override;
   bool PostSubBuffer(int x, int y, int width, int height) override;
+  int GetBufferAge() override;
+  bool SupportsPresentationTime() override;
+  bool SetPresentationTime(base::TimeTicks time) override;
   VSyncProvider* GetVSyncProvider() override;
 
   // Create a NativeViewGLSurfaceEGL with an externally provided VSyncProvider.